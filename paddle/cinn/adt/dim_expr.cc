@@ -104,6 +104,7 @@ std::size_t GetHashValueImpl(const List<DimExpr>& exprs) {
   for (const auto& expr : *exprs) {
     ret = hash_combine(ret, GetHashValue(expr));
   }
+  return ret;
 }
 
 std::size_t GetHashValueImpl(const Sum<DimExpr>& expr) {
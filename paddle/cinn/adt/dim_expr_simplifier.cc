@@ -14,8 +14,13 @@
 
 #include "paddle/cinn/adt/dim_expr_simplifier.h"
 
+#include <algorithm>
+#include <functional>
+#include <mutex>
 #include <numeric>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "paddle/cinn/adt/print_utils/print_dim_expr.h"
 
@@ -791,8 +796,130 @@ DimExpr Simplify(const DimExpr& expr) {
   return ret;
 }
 
+template <template <typename> class Op>
+DimExpr MapListOperands(const Op<DimExpr>& expr,
+                        const std::function<DimExpr(const DimExpr&)>& Map) {
+  const auto& [operands] = expr;
+  List<DimExpr> mapped{};
+  for (const auto& operand : *operands) {
+    mapped->push_back(Map(operand));
+  }
+  return Op<DimExpr>{mapped};
+}
+
+// The expr with each symbol replaced by MapSymbol of it.
+DimExpr MapSymbolicDims(
+    const DimExpr& expr,
+    const std::function<DimExpr(const SymbolicDim&)>& MapSymbol) {
+  const auto Map = [&](const DimExpr& operand) {
+    return MapSymbolicDims(operand, MapSymbol);
+  };
+  if (expr.Has<SymbolicDim>()) {
+    return MapSymbol(expr.Get<SymbolicDim>());
+  } else if (expr.Has<Negative<DimExpr>>()) {
+    const auto& [operand] = expr.Get<Negative<DimExpr>>().tuple();
+    return Negative<DimExpr>{Map(operand)};
+  } else if (expr.Has<Reciprocal<DimExpr>>()) {
+    const auto& [operand] = expr.Get<Reciprocal<DimExpr>>().tuple();
+    return Reciprocal<DimExpr>{Map(operand)};
+  } else if (expr.Has<Sum<DimExpr>>()) {
+    return MapListOperands(expr.Get<Sum<DimExpr>>(), Map);
+  } else if (expr.Has<Product<DimExpr>>()) {
+    return MapListOperands(expr.Get<Product<DimExpr>>(), Map);
+  } else if (expr.Has<BroadcastedDim<DimExpr>>()) {
+    return MapListOperands(expr.Get<BroadcastedDim<DimExpr>>(), Map);
+  }
+  return expr;
+}
+
+struct DimExprHash {
+  std::size_t operator()(const DimExpr& expr) const {
+    return GetHashValue(expr);
+  }
+};
+
+// The simplifications of the exprs whose symbols are renamed to canonical
+// ones in the order of their ids. Simplify tells the symbols apart only by
+// that order, so the exprs of the clones of a program and of the repeated
+// compiles, which differ by the symbols alone, share a simplification.
+class SimplifyCache {
+ public:
+  static SimplifyCache* Instance() {
+    static SimplifyCache cache;
+    return &cache;
+  }
+
+  DimExpr Simplify(const DimExpr& expr) {
+    std::vector<SymbolicDim> symbols;
+    std::unordered_set<SymbolicDim> seen;
+    MapSymbolicDims(expr, [&](const SymbolicDim& symbol) -> DimExpr {
+      if (seen.insert(symbol).second) {
+        symbols.push_back(symbol);
+      }
+      return symbol;
+    });
+    std::sort(symbols.begin(),
+              symbols.end(),
+              [](const SymbolicDim& lhs, const SymbolicDim& rhs) {
+                return lhs.value().unique_id() < rhs.value().unique_id();
+              });
+
+    std::unordered_map<SymbolicDim, DimExpr> to_canonical;
+    std::unordered_map<SymbolicDim, DimExpr> from_canonical;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // the canonical symbols are made in the order of their ids
+      while (canonical_symbols_.size() < symbols.size()) {
+        canonical_symbols_.push_back(SymbolicDim{UniqueId::New()});
+      }
+      for (std::size_t i = 0; i < symbols.size(); ++i) {
+        to_canonical.emplace(symbols[i], canonical_symbols_[i]);
+        from_canonical.emplace(canonical_symbols_[i], symbols[i]);
+      }
+    }
+    DimExpr canonical =
+        MapSymbolicDims(expr, [&](const SymbolicDim& symbol) -> DimExpr {
+          return to_canonical.at(symbol);
+        });
+
+    DimExpr simplified = Lookup(canonical);
+    return MapSymbolicDims(simplified,
+                           [&](const SymbolicDim& symbol) -> DimExpr {
+                             return from_canonical.at(symbol);
+                           });
+  }
+
+ private:
+  static constexpr std::size_t kMaxSize = 1 << 16;
+
+  SimplifyCache() = default;
+
+  DimExpr Lookup(const DimExpr& canonical) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = simplified_.find(canonical);
+      if (it != simplified_.end()) {
+        return it->second;
+      }
+    }
+    DimExpr simplified = ::cinn::adt::Simplify(canonical);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (simplified_.size() >= kMaxSize) {
+      simplified_.clear();
+    }
+    simplified_.emplace(canonical, simplified);
+    return simplified;
+  }
+
+  std::mutex mutex_;
+  std::vector<SymbolicDim> canonical_symbols_;
+  std::unordered_map<DimExpr, DimExpr, DimExprHash> simplified_;
+};
+
 }  // namespace
 
-DimExpr SimplifyDimExpr(const DimExpr& expr) { return Simplify(expr); }
+DimExpr SimplifyDimExpr(const DimExpr& expr) {
+  return SimplifyCache::Instance()->Simplify(expr);
+}
 
 }  // namespace cinn::adt
@@ -133,4 +133,23 @@ TEST(Simplify, NestSymbolicProductSumUnit) {
   ASSERT_TRUE((simplified_dim_expr == sym));
 }
 
+TEST(Simplify, RenamedSymbols) {
+  // a clone has the exprs of the program on other symbols in the same order,
+  // so they share a simplification, which is for the symbols of the clone
+  DimExpr sym0 = MakeSymbolic();
+  DimExpr sym1 = MakeSymbolic();
+  DimExpr clone_sym0 = MakeSymbolic();
+  DimExpr clone_sym1 = MakeSymbolic();
+
+  DimExpr origin = BD(sym1, Product<DimExpr>{List<DimExpr>{DimExpr(1), sym0}});
+  DimExpr clone =
+      BD(clone_sym1, Product<DimExpr>{List<DimExpr>{DimExpr(1), clone_sym0}});
+  DimExpr expected = BroadcastedDim<DimExpr>{List<DimExpr>{sym0, sym1}};
+  DimExpr clone_expected =
+      BroadcastedDim<DimExpr>{List<DimExpr>{clone_sym0, clone_sym1}};
+  ASSERT_EQ(SimplifyDimExpr(origin), expected);
+  ASSERT_EQ(SimplifyDimExpr(clone), clone_expected);
+  ASSERT_EQ(SimplifyDimExpr(origin), expected);
+}
+
 }  // namespace cinn::adt::test
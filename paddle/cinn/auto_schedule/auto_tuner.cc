@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <sstream>
 #include <utility>
 
 #include "paddle/cinn/auto_schedule/database/jsonfile_database.h"
@@ -34,10 +35,38 @@
 #include "paddle/cinn/hlir/framework/op.h"
 #include "paddle/cinn/hlir/framework/visualize_helper.h"
 #include "paddle/cinn/utils/string.h"
+#ifdef CINN_WITH_CUDA
+#include <cuda_runtime_api.h>
+
+#include "paddle/cinn/backends/cuda_util.h"
+#endif
 
 namespace cinn {
 namespace auto_schedule {
 
+namespace {
+
+// the key of the target to tell the tuning records measured on it, which
+// holds the compute capability of the device on NVGPU
+std::string TuningTargetKey(const cinn::common::Target& target) {
+  std::ostringstream os;
+  os << target;
+#ifdef CINN_WITH_CUDA
+  if (target.arch == cinn::common::Target::Arch::NVGPU) {
+    int device_id, major, minor;
+    CUDA_CALL(cudaGetDevice(&device_id));
+    CUDA_CALL(cudaDeviceGetAttribute(
+        &major, cudaDevAttrComputeCapabilityMajor, device_id));
+    CUDA_CALL(cudaDeviceGetAttribute(
+        &minor, cudaDevAttrComputeCapabilityMinor, device_id));
+    os << ",sm_" << major << minor;
+  }
+#endif
+  return os.str();
+}
+
+}  // namespace
+
 AutoTuner::AutoTuner(const cinn::common::Target& target,
                      hlir::framework::Graph* graph)
     : target_(target), graph_(graph) {}
@@ -51,7 +80,11 @@ void AutoTuner::Initialize(const Config& config,
       std::make_unique<ScheduleMeasurer>(builder_.get(), runner_.get());
 
   // initialize database
-  database_ = std::move(Database::Make(config.database_config));
+  DatabaseConfig database_config = config.database_config;
+  if (database_config.target.empty()) {
+    database_config.target = TuningTargetKey(target_);
+  }
+  database_ = std::move(Database::Make(database_config));
 
   // create tasks
   TaskCreator task_creator;
@@ -37,6 +37,8 @@ class ExprCostModel : public XgbCostModel {
   void Update(const std::vector<const ir::ModuleExpr*>& samples,
               const std::vector<float>& labels,
               const cinn::common::Target& target);
+  // whether the model is trained, which predicts NOT_INIT_COST otherwise
+  bool IsTrained() const { return trained_times_.load() > 0; }
 
  private:
   std::atomic<int> trained_times_{0};
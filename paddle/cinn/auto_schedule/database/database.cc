@@ -37,21 +37,25 @@ proto::TuningRecord TuningRecord::ToProto() const {
   record_proto.set_execution_cost(execution_cost);
   record_proto.set_predicted_cost(predicted_cost);
   record_proto.mutable_trace()->CopyFrom(trace);
+  record_proto.set_target(target);
   return record_proto;
 }
 
-Database::Database(int capacity_per_task)
-    : capacity_per_task_(capacity_per_task) {
+Database::Database(int capacity_per_task, const std::string& target)
+    : capacity_per_task_(capacity_per_task), target_(target) {
   CHECK_GT(capacity_per_task_, 0)
       << "capacity_per_task_ should be greater than 0";
 }
 
 std::unique_ptr<Database> Database::Make(const DatabaseConfig& config) {
   if (config.type == DatabaseType::kMemory) {
-    return std::make_unique<Database>(config.capacity_per_task);
+    return std::make_unique<Database>(config.capacity_per_task, config.target);
   } else if (config.type == DatabaseType::kJSONFile) {
-    return std::make_unique<JSONFileDatabase>(
-        config.capacity_per_task, config.record_file_path, true);
+    return std::make_unique<JSONFileDatabase>(config.capacity_per_task,
+                                              config.record_file_path,
+                                              true,
+                                              config.target,
+                                              config.merge_record_file_paths);
   }
 
   LOG(FATAL) << "Unimplemented database type.";
@@ -69,6 +73,12 @@ void Database::Insert(const TuningRecord& record) {
 bool Database::AddRecord(const TuningRecord& record) {
   CHECK(!record.task_key.empty()) << "task_key of TuningRecord can't be empty";
 
+  if (record.target.empty() && !target_.empty()) {
+    TuningRecord target_record = record;
+    target_record.target = target_;
+    Insert(target_record);
+    return Commit(target_record);
+  }
   Insert(record);
   return Commit(record);
 }
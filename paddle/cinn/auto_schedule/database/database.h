@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #pragma once
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "paddle/cinn/auto_schedule/auto_schedule.pb.h"
 #include "paddle/cinn/auto_schedule/search_space/search_state.h"
@@ -32,13 +34,16 @@ struct TuningRecord {
   ir::proto::ScheduleDesc trace;
   // the cost time of the candidate executed during measure
   double execution_cost;  // unit: us
+  // the target the candidate is measured on
+  std::string target;
 
   TuningRecord() = default;
   explicit TuningRecord(const proto::TuningRecord& record)
       : task_key(record.task_key()),
         predicted_cost(record.predicted_cost()),
         trace(record.trace()),
-        execution_cost(record.execution_cost()) {}
+        execution_cost(record.execution_cost()),
+        target(record.target()) {}
   TuningRecord(const std::string& task_key,
                const SearchState& state,
                double execution_cost)
@@ -61,8 +66,16 @@ enum class DatabaseType : int { kMemory, kJSONFile };
 
 struct DatabaseConfig {
   DatabaseType type = DatabaseType::kMemory;
+  // the number of the best records kept for a task, which are also the
+  // samples to train the cost model of the task with
   int capacity_per_task = 2;
   std::string record_file_path = "/tmp/tuning_record.json";
+  // the records files of the other runs or machines to merge, which are
+  // read only
+  std::vector<std::string> merge_record_file_paths;
+  // the target the records are measured on, the records of the other
+  // targets are skipped on loading. Empty means any target.
+  std::string target;
 };
 
 // A database supports insert or lookup historial tuning result with specified
@@ -71,7 +84,7 @@ struct DatabaseConfig {
 // regarded as one using memory as its underlying storage medium.
 class Database {
  public:
-  explicit Database(int capacity_per_task);
+  explicit Database(int capacity_per_task, const std::string& target = "");
   ~Database() = default;
 
   // Create a Database with the specific config
@@ -100,6 +113,8 @@ class Database {
       key2record_;
   // the max number of candidates stored
   const int capacity_per_task_;
+  // the target of the records added
+  const std::string target_;
 };
 
 }  // namespace auto_schedule
@@ -19,6 +19,7 @@
 #include <google/protobuf/util/json_util.h>
 
 #include <fstream>
+#include <unordered_set>
 
 #include "paddle/cinn/auto_schedule/auto_schedule.pb.h"
 #include "paddle/cinn/auto_schedule/task/task_registry.h"
@@ -52,13 +53,31 @@ std::vector<std::string> ReadLinesFromFile(const std::string& file_path,
   return {};
 }
 
-JSONFileDatabase::JSONFileDatabase(int capacity_per_task,
-                                   const std::string& record_file_path,
-                                   bool allow_new_file)
-    : Database(capacity_per_task), record_file_path_(record_file_path) {
+JSONFileDatabase::JSONFileDatabase(
+    int capacity_per_task,
+    const std::string& record_file_path,
+    bool allow_new_file,
+    const std::string& target,
+    const std::vector<std::string>& merge_record_file_paths)
+    : Database(capacity_per_task, target), record_file_path_(record_file_path) {
   VLOG(3) << "Auto schedule will save/load tuning records on file:"
           << record_file_path;
   auto json_lines = ReadLinesFromFile(record_file_path_, allow_new_file);
+  for (const auto& merge_path : merge_record_file_paths) {
+    VLOG(3) << "Auto schedule will merge tuning records from file:"
+            << merge_path;
+    auto merge_lines = ReadLinesFromFile(merge_path, /*allow_new_file=*/false);
+    json_lines.insert(json_lines.end(), merge_lines.begin(), merge_lines.end());
+  }
+  // the merged files may share the records, e.g. be copied from one run
+  std::unordered_set<std::string> visited_lines;
+  std::vector<std::string> unique_lines;
+  for (auto& line : json_lines) {
+    if (visited_lines.insert(line).second) {
+      unique_lines.emplace_back(std::move(line));
+    }
+  }
+  json_lines.swap(unique_lines);
   std::vector<cinn::auto_schedule::proto::TuningRecord> all_records_proto(
       json_lines.size());
 
@@ -77,6 +96,12 @@ JSONFileDatabase::JSONFileDatabase(int capacity_per_task,
 
   for (const auto& record_proto : all_records_proto) {
     std::string task_key = record_proto.task_key();
+    if (!target_.empty() && !record_proto.target().empty() &&
+        record_proto.target() != target_) {
+      VLOG(4) << "Skip a TuningRecord measured on target="
+              << record_proto.target() << " with task_key=" << task_key;
+      continue;
+    }
     if (task_registry->Has(task_key)) {
       VLOG(4) << "Add a measured TuningRecord with task_key=" << task_key;
       Insert(TuningRecord(record_proto));
@@ -29,10 +29,17 @@ class JSONFileDatabase : public Database {
    * \param record_file_path The path of the json file.
    * \param allow_new_file Whether to create new file when the given path is not
    * found.
+   * \param target The target of the records, the loaded records of the other
+   * targets are skipped. Empty means any target.
+   * \param merge_record_file_paths The json files of the other runs or
+   * machines to load the records from as well, they are not written.
    */
-  JSONFileDatabase(int capacity_per_task,
-                   const std::string& record_file_path,
-                   bool allow_new_file);
+  JSONFileDatabase(
+      int capacity_per_task,
+      const std::string& record_file_path,
+      bool allow_new_file,
+      const std::string& target = "",
+      const std::vector<std::string>& merge_record_file_paths = {});
   ~JSONFileDatabase() = default;
 
   // convert a TuningRecord object to string in JSON format
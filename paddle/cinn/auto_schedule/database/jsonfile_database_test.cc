@@ -250,5 +250,39 @@ TEST_F(TestJSONFileDatabase, Reload) {
   }
 }
 
+TEST_F(TestJSONFileDatabase, MergeAndFilterTarget) {
+  std::string merge_file_path = "/tmp/test_merge_record.json";
+  {
+    JSONFileDatabase gpu_db(2, merge_file_path, true, "gpu");
+    gpu_db.AddRecord(TuningRecord(
+        "k1", SearchState(MakeIRSchedule(lowered_funcs, "k1"), 1.0), 1.0));
+    gpu_db.AddRecord(TuningRecord(
+        "k2", SearchState(MakeIRSchedule(lowered_funcs, "k2"), 1.0), 2.0));
+  }
+  {
+    JSONFileDatabase cpu_db(2, record_file_path, true, "cpu");
+    cpu_db.AddRecord(TuningRecord(
+        "k1", SearchState(MakeIRSchedule(lowered_funcs, "k1"), 1.0), 3.0));
+  }
+
+  // the records of the other targets are skipped
+  JSONFileDatabase cpu_db(2, record_file_path, false, "cpu", {merge_file_path});
+  ASSERT_EQ(cpu_db.Size(), 1);
+  EXPECT_EQ(cpu_db.LookUp("k1")[0].target, "cpu");
+
+  // the duplicated records in the merged files are loaded once
+  JSONFileDatabase gpu_db(
+      2, record_file_path, false, "gpu", {merge_file_path, merge_file_path});
+  ASSERT_EQ(gpu_db.Size(), 2);
+  ASSERT_EQ(gpu_db.Count("k1"), 1);
+  EXPECT_EQ(gpu_db.LookUp("k1")[0].execution_cost, 1.0);
+  // the merged files are not written
+  EXPECT_EQ(ReadLinesFromFile(merge_file_path).size(), 2);
+
+  JSONFileDatabase any_db(2, record_file_path, false, "", {merge_file_path});
+  ASSERT_EQ(any_db.Size(), 3);
+  remove(merge_file_path.c_str());
+}
+
 }  // namespace auto_schedule
 }  // namespace cinn
@@ -23,6 +23,7 @@
 #include "paddle/cinn/auto_schedule/cost_model/expr_cost_model.h"
 #include "paddle/cinn/auto_schedule/measure/measure.h"
 #include "paddle/cinn/auto_schedule/search_strategy/evolutionary_search.h"
+#include "paddle/cinn/auto_schedule/task/task_registry.h"
 #include "paddle/cinn/common/target.h"
 #include "paddle/cinn/hlir/framework/op_lowering.h"
 #include "paddle/cinn/hlir/op/external_api_registry.h"
@@ -241,6 +242,9 @@ TaskOptimizer::Result TaskOptimizer::OptimizeByEvolution(
     // if not, we should create new EvolutionarySearch
     evolutionary_search_ = std::make_unique<EvolutionarySearch>(
         *task_, cost_model_, database_, utils::ForkRandomState(&rand_seed_));
+    if (FLAGS_auto_schedule_use_cost_model) {
+      TrainCostModelFromDatabase();
+    }
   }
 
   TaskOptimizer::Result result("Evolution");
@@ -285,6 +289,13 @@ TaskOptimizer::Result TaskOptimizer::OptimizeByEvolution(
       }
     }
     continuous_empty_cnt = 0;  // reset if get valid candidates
+    size_t pruned_cnt = PruneByCostModel(options, &states, &measure_inputs);
+    measured_count += pruned_cnt;
+    if (states.empty()) {
+      VLOG(4) << "All the " << pruned_cnt
+              << " searched states are pruned by the cost model";
+      continue;
+    }
 
     VLOG(4) << "ScheduleMeasurer start with input size="
             << measure_inputs.size();
@@ -379,6 +390,68 @@ std::vector<SearchState> TaskOptimizer::SearchOneRound(
   return states;
 }
 
+void TaskOptimizer::TrainCostModelFromDatabase() {
+  std::vector<TuningRecord> records = database_->LookUp(task_->serialized_key);
+  if (records.empty()) {
+    return;
+  }
+  InitialTaskRegistry* task_registry = InitialTaskRegistry::Global();
+  const auto& init_module = task_registry->Get(task_->serialized_key);
+  std::vector<ir::IRSchedule> schedules;
+  schedules.reserve(records.size());
+  std::vector<const ir::ModuleExpr*> cost_model_samples(records.size());
+  std::vector<float> cost_model_labels(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    schedules.emplace_back(ir::ir_utils::IRCopy(init_module->module_expr),
+                           utils::ForkRandomState(&rand_seed_));
+    ir::ScheduleDesc::ReplayWithProto(records[i].trace, &schedules.back());
+    cost_model_labels[i] = records[i].execution_cost;
+  }
+  for (size_t i = 0; i < records.size(); ++i) {
+    cost_model_samples[i] = &(schedules[i].GetModule());
+  }
+  VLOG(4) << "Train CostModel with " << records.size()
+          << " records in database of task:" << task_->serialized_key;
+  cost_model_.Train(cost_model_samples, cost_model_labels, task_->target);
+}
+
+size_t TaskOptimizer::PruneByCostModel(
+    const TuningOptions& options,
+    std::vector<SearchState>* states,
+    std::vector<MeasureInput>* measure_candidates) {
+  if (options.cost_model_prune_ratio <= 0.0f ||
+      !FLAGS_auto_schedule_use_cost_model || !cost_model_.IsTrained()) {
+    return 0;
+  }
+  auto best_records = database_->GetTopK(task_->serialized_key, 1);
+  if (best_records.empty()) {
+    return 0;
+  }
+  double threshold =
+      best_records[0].execution_cost * (1.0 + options.cost_model_prune_ratio);
+  size_t kept_cnt = 0;
+  for (size_t i = 0; i < states->size(); ++i) {
+    float predicted_cost = states->at(i)->predicted_cost;
+    // the random states picked by eps-greedy are not predicted, keep them to
+    // explore the space the cost model does not know well
+    if (predicted_cost != SearchState::NOT_INIT_COST &&
+        predicted_cost > threshold) {
+      continue;
+    }
+    if (kept_cnt != i) {
+      states->at(kept_cnt) = states->at(i);
+      measure_candidates->at(kept_cnt) = std::move(measure_candidates->at(i));
+    }
+    ++kept_cnt;
+  }
+  size_t pruned_cnt = states->size() - kept_cnt;
+  states->resize(kept_cnt);
+  measure_candidates->resize(kept_cnt);
+  VLOG(4) << "PruneByCostModel pruned " << pruned_cnt
+          << " states predicted slower than " << threshold << "us";
+  return pruned_cnt;
+}
+
 // detect the limit of available shared memory on the current NVGPU with CUDA
 // runtime
 size_t GetGPUSharedMemoryLimit() {
@@ -58,6 +58,16 @@ class TaskOptimizer {
       const TuningOptions& options,
       std::vector<MeasureInput>* measure_candidates);
 
+  // train the cost model with the records of the task in database, which
+  // may be measured in the previous runs
+  void TrainCostModelFromDatabase();
+
+  // prune the states predicted to be slower than the best measured one by
+  // more than options.cost_model_prune_ratio, return the number pruned
+  size_t PruneByCostModel(const TuningOptions& options,
+                          std::vector<SearchState>* states,
+                          std::vector<MeasureInput>* measure_candidates);
+
  private:
   // the max retry times if continuously get empty result
   static constexpr uint32_t kMaxRetryContinuousEmpty_ = 3;
@@ -77,6 +77,12 @@ struct TuningOptions {
   //
   // It explores the cases evolutionary search won't predict precisely
   float evolution_eps_greedy = 0.1f;
+
+  // The candidates predicted by the trained cost model to be slower than the
+  // best measured one of the task by more than this ratio are pruned before
+  // measurement, and counted into num_measure_trials, so that the trials are
+  // spent on the promising candidates. 0 means no pruning.
+  float cost_model_prune_ratio = 0.0f;
 };
 
 // Result of the tuning process
@@ -105,7 +105,8 @@ void detail::CollectBucketStrategyHostFunctionVisitor::ProcessLoweredFunc(
                      ir::CallType::Extern,
                      ir::FunctionRef(),
                      0);
-  buckets_.emplace_back(ir::IfThenElse::Make(predicate, call_extern_api));
+  buckets_.emplace_back(call_extern_api);
+  bucket_predicates_.emplace_back(predicate);
 }
 
 void detail::CollectBucketStrategyHostFunctionVisitor::ProcessArgs(
@@ -172,8 +172,19 @@ struct CollectBucketStrategyHostFunctionVisitor
         ir::Argument(kernel_args_, ir::Argument::IO::kOutput),
         ir::Argument(kernel_args_num_, ir::Argument::IO::kInput),
         ir::Argument(kernel_stream_, ir::Argument::IO::kOutput)};
+    // the buckets are tried in order and only the first matched one is
+    // launched, so the specialized kernels go before the generic one
+    ir::Expr dispatch;
+    for (int i = static_cast<int>(buckets_.size()) - 1; i >= 0; --i) {
+      dispatch = ir::IfThenElse::Make(
+          bucket_predicates_[i],
+          buckets_[i],
+          dispatch.defined() ? ir::Block::Make({dispatch}) : ir::Expr());
+    }
     std::vector<ir::Expr> body_stmts(arg_defs_);
-    body_stmts.insert(body_stmts.end(), buckets_.begin(), buckets_.end());
+    if (dispatch.defined()) {
+      body_stmts.push_back(dispatch);
+    }
     ir::Expr host_func =
         ir::_LoweredFunc_::Make(op->functions[0].as_lowered_func()->name,
                                 arguments,
@@ -193,7 +204,9 @@ struct CollectBucketStrategyHostFunctionVisitor
                                          ir::Expr predicate);
 
  private:
+  // the kernel launches of the buckets and their predicates
   std::vector<ir::Expr> buckets_;
+  std::vector<ir::Expr> bucket_predicates_;
   std::vector<ir::Expr> arg_defs_;
 
   ir::Var kernel_args_;
@@ -21,8 +21,12 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <cstdio>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 
 #include "paddle/cinn/backends/cuda_util.h"
 #include "paddle/cinn/backends/nvrtc/header_generator.h"
@@ -33,17 +37,119 @@
 PD_DECLARE_string(cinn_nvcc_cmd_path);
 PD_DECLARE_bool(nvrtc_compile_to_cubin);
 PD_DECLARE_bool(cinn_nvrtc_cubin_with_fmad);
+PD_DECLARE_string(cinn_compile_cache_dir);
 
 namespace cinn {
 namespace backends {
 namespace nvrtc {
 
+namespace {
+
+// The entries of the compile cache are "<key size><key><data>", the key is
+// compared on loading to rule out the collisions of the file names.
+bool LoadFromCompileCache(const std::string& path,
+                          const std::string& key,
+                          std::string* data) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs) {
+    return false;
+  }
+  uint64_t key_size = 0;
+  ifs.read(reinterpret_cast<char*>(&key_size), sizeof(key_size));
+  if (!ifs || key_size != key.size()) {
+    return false;
+  }
+  std::string saved_key(key_size, '\0');
+  ifs.read(&saved_key[0], key_size);
+  if (!ifs || saved_key != key) {
+    return false;
+  }
+  data->assign(std::istreambuf_iterator<char>(ifs),
+               std::istreambuf_iterator<char>());
+  return !data->empty();
+}
+
+void SaveToCompileCache(const std::string& path,
+                        const std::string& key,
+                        const std::string& data) {
+  const std::string& dir = FLAGS_cinn_compile_cache_dir;
+  if (access(dir.c_str(), 0) == -1 && mkdir(dir.c_str(), 0755) == -1 &&
+      access(dir.c_str(), 0) == -1) {
+    LOG(WARNING) << "Fail to mkdir " << dir << " for the compile cache";
+    return;
+  }
+  // write to a file of our own and rename it, so that the processes sharing
+  // the cache never read a partial entry
+  std::string tmp_path = path + "." + std::to_string(getpid()) + ".tmp";
+  {
+    std::ofstream ofs(tmp_path, std::ios::binary);
+    uint64_t key_size = key.size();
+    ofs.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+    ofs.write(key.data(), key.size());
+    ofs.write(data.data(), data.size());
+    if (!ofs) {
+      LOG(WARNING) << "Fail to write the compile cache " << tmp_path;
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  }
+}
+
+}  // namespace
+
 std::string Compiler::operator()(const std::string& code,
                                  bool include_headers) {
   if (runtime::CanUseNvccCompiler()) {
     return CompileWithNvcc(code);
   }
-  return CompileCudaSource(code, include_headers);
+  if (FLAGS_cinn_compile_cache_dir.empty()) {
+    return CompileCudaSource(code, include_headers);
+  }
+
+  std::string key = CompileCacheKey(code, include_headers);
+  std::string path = FLAGS_cinn_compile_cache_dir + "/" +
+                     std::to_string(std::hash<std::string>()(key)) +
+                     (compile_to_cubin_ ? ".cubin" : ".ptx");
+  std::string data;
+  if (LoadFromCompileCache(path, key, &data)) {
+    VLOG(3) << "Load the compiled kernel from the compile cache " << path;
+    return data;
+  }
+  data = CompileCudaSource(code, include_headers);
+  SaveToCompileCache(path, key, data);
+  return data;
+}
+
+std::string Compiler::CompileCacheKey(const std::string& code,
+                                      bool include_headers) {
+  // the runtime header included by the generated code may change between
+  // releases in the same place
+  static const std::string runtime_header_hash = []() {
+    std::string content;
+    for (auto& dir : Context::Global().runtime_include_dir()) {
+      std::ifstream ifs(dir + "/cinn_cuda_runtime_source.cuh");
+      content.append(std::istreambuf_iterator<char>(ifs),
+                     std::istreambuf_iterator<char>());
+    }
+    return std::to_string(std::hash<std::string>()(content));
+  }();
+
+  int major = 0, minor = 0;
+  cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, 0);
+  cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, 0);
+  int nvrtc_major = 0, nvrtc_minor = 0;
+  nvrtcVersion(&nvrtc_major, &nvrtc_minor);
+
+  std::ostringstream os;
+  os << "sm_" << major << minor << ";cuda_" << CUDA_VERSION << ";nvrtc_"
+     << nvrtc_major << "." << nvrtc_minor << ";cubin_" << compile_to_cubin_
+     << ";fmad_" << FLAGS_cinn_nvrtc_cubin_with_fmad << ";headers_"
+     << include_headers << ";runtime_" << runtime_header_hash << "\n"
+     << code;
+  return os.str();
 }
 
 Compiler::Compiler() {
@@ -67,6 +67,12 @@ class Compiler {
    */
   std::string CompileCudaSource(const std::string& code, bool include_headers);
 
+  /**
+   * Get the key of the compile cache of CUDA source code, which holds all
+   * that the compiled PTX or CUBIN depends on.
+   */
+  std::string CompileCacheKey(const std::string& code, bool include_headers);
+
   /**
    * whether to compile the source code into cubin, only works with cuda version
    * > 11.1
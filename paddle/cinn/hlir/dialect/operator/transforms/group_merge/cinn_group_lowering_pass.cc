@@ -167,17 +167,23 @@ class GroupOpPattern : public pir::OpRewritePattern<cinn::dialect::GroupOp> {
         op_fusion, shape_analysis_);
 
     for (auto group : group_list) {
-      auto ir_compiler = cinn::hlir::framework::PirCompilerManager::Create(
-          *program, target, scope);
       group->shape_analysis = shape_analysis_;
       if (FLAGS_cinn_enable_map_expr) {
         cinn::adt::TryGenerateMapExprFromGroup(group);
       }
-
-      auto fn_ptr_res = ir_compiler->BuildCUDAJITInfo({group});
+    }
+    // the groups are compiled together so that they are lowered and built in
+    // parallel
+    auto ir_compiler = cinn::hlir::framework::PirCompilerManager::Create(
+        *program, target, scope);
+    auto fn_ptr_res = ir_compiler->BuildCUDAJITInfo(group_list);
+
+    for (size_t group_idx = 0; group_idx < group_list.size(); ++group_idx) {
+      const auto& group = group_list[group_idx];
       std::unordered_map<std::string, ::pir::Attribute> op_attrs{
           {cinn::dialect::JitKernelOp::kAttrName,
-           cinn::dialect::CINNKernelInfoAttribute::get(ctx, fn_ptr_res[0])},
+           cinn::dialect::CINNKernelInfoAttribute::get(
+               ctx, fn_ptr_res[group_idx])},
       };
 
       // Generate jit kernel op input and output
@@ -17,6 +17,10 @@
 #include "paddle/cinn/hlir/framework/pir/compilation_task.h"
 #include "paddle/cinn/hlir/framework/op_lowering.h"
 #include "paddle/cinn/ir/module.h"
+#include "paddle/cinn/runtime/flags.h"
+#include "paddle/cinn/utils/timer.h"
+
+PD_DECLARE_bool(cinn_compile_timing_report);
 
 namespace cinn {
 namespace hlir {
@@ -50,8 +54,19 @@ std::shared_ptr<backends::Compiler> GroupCompilationContext::BackendCompiler() {
 }
 
 void CompilationTask::operator()() {
+  utils::Timer timer;
+  timer.Start();
   Lowering();
+  const float lower_ms = timer.Stop();
+  timer.Start();
   CodegenAndJit();
+  const float compile_ms = timer.Stop();
+  if (FLAGS_cinn_compile_timing_report) {
+    LOG(INFO) << "CompilationTask of " << context_->group_->FuncName()
+              << " lowered " << context_->func_size_ << " functions in "
+              << lower_ms << " ms, and compiled them in " << compile_ms
+              << " ms";
+  }
 }
 
 void CompilationTask::Lowering() {
@@ -15,13 +15,21 @@
 #include "paddle/cinn/hlir/framework/pir_compiler.h"
 
 #include <absl/types/variant.h>
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <unordered_set>
 #include "paddle/cinn/hlir/framework/pir/compilation_task.h"
 #include "paddle/cinn/hlir/framework/pir/utils.h"
 #include "paddle/cinn/utils/multi_threading.h"
+#include "paddle/cinn/utils/timer.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
 #include "paddle/pir/core/builtin_type.h"
 
 PD_DECLARE_bool(cinn_bucket_compile);
+PD_DECLARE_int32(cinn_compile_batch_size);
+PD_DECLARE_bool(cinn_compile_timing_report);
+PD_DECLARE_bool(cinn_reuse_group_kernel);
 
 namespace cinn {
 namespace hlir {
@@ -29,7 +37,6 @@ namespace framework {
 
 // TODO(Aurelius84): Clear usless Build Interface.
 std::unique_ptr<Program> PirCompiler::Build() {
-  m_builder_.Clear();
   // NOTE(Aurelius84): Currently only support each op for one group
   std::vector<pir::GroupPtr> groups;
   for (auto& op : *program_.block()) {
@@ -42,8 +49,144 @@ std::unique_ptr<Program> PirCompiler::Build() {
   return std::move(Build(groups));
 }
 
+namespace {
+
+std::unordered_map<::pir::Operation*, int> OpIndices(
+    const std::vector<::pir::Operation*>& ops) {
+  std::unordered_map<::pir::Operation*, int> op_indices;
+  for (int i = 0; i < ops.size(); ++i) {
+    op_indices[ops[i]] = i;
+  }
+  return op_indices;
+}
+
+// The key of the structure of a group, which is the same for the isomorphic
+// groups, whose ops, attributes, types and symbolic shapes are the same with
+// the inputs and the symbols renamed in the order of their first uses. The
+// attributes and the types are uniqued in the IrContext, so are keyed by
+// their storages.
+std::string GroupStructureKey(const pir::GroupPtr& group) {
+  const std::vector<::pir::Operation*> ops = group->CollectOps();
+  const auto op_indices = OpIndices(ops);
+  std::unordered_map<::pir::Value, int> input_indices;
+  std::unordered_map<std::string, int> symbol_indices;
+  std::ostringstream key;
+  auto AppendType = [&](const ::pir::Value& value) {
+    key << value.type().storage();
+    if (group->shape_analysis == nullptr ||
+        !value.type().isa<paddle::dialect::DenseTensorType>()) {
+      return;
+    }
+    for (const auto& sym :
+         group->shape_analysis->GetOrCreateSymbolicDimsForRankedValue(value)) {
+      if (sym.IsDynamic()) {
+        key << ",S"
+            << symbol_indices.emplace(sym.GetSymName(), symbol_indices.size())
+                   .first->second;
+      } else {
+        key << "," << sym.GetDimSize();
+      }
+    }
+  };
+
+  key << static_cast<int>(group->op_pattern_kind) << ";";
+  for (const auto& sub_group : group->fused_sub_groups) {
+    key << sub_group->ops.size() << ",";
+  }
+  for (auto* op : ops) {
+    key << ";" << op->name() << (group->output_ops.count(op) ? "*" : "")
+        << (group->master_ops.count(op) ? "m" : "")
+        << (group->internal_ops.count(op) ? "i" : "") << "(";
+    for (const auto& value : op->operands_source()) {
+      if (!value) {
+        key << "null ";
+        continue;
+      }
+      auto result = value.dyn_cast<::pir::OpResult>();
+      if (result && op_indices.count(result.owner()) > 0) {
+        key << "%" << op_indices.at(result.owner()) << "." << result.index();
+      } else {
+        key << "$"
+            << input_indices.emplace(value, input_indices.size())
+                   .first->second
+            << ":";
+        AppendType(value);
+      }
+      key << " ";
+    }
+    key << ")->(";
+    for (const auto& result : op->results()) {
+      if (result && result.type()) {
+        AppendType(result);
+      }
+      key << " ";
+    }
+    key << "){";
+    const std::map<std::string, ::pir::Attribute> attributes(
+        op->attributes().begin(), op->attributes().end());
+    for (const auto& attribute : attributes) {
+      key << attribute.first << "=" << attribute.second.storage() << " ";
+    }
+    key << "}";
+  }
+  return key.str();
+}
+
+}  // namespace
+
 std::vector<pir::CINNKernelInfo> PirCompiler::BuildCUDAJITInfo(
     const std::vector<pir::GroupPtr>& groups) {
+  if (!FLAGS_cinn_reuse_group_kernel) {
+    return CompileCUDAJITInfo(groups);
+  }
+  auto& manager = PirCompilerManager::Instance();
+  std::vector<std::string> keys;
+  std::vector<pir::GroupPtr> compiled_groups;
+  std::vector<std::string> compiled_keys;
+  std::unordered_set<std::string> compiled_key_set;
+  for (const auto& group : groups) {
+    keys.push_back(GroupStructureKey(group));
+    if (manager.FindGroupKernel(keys.back()) == nullptr &&
+        compiled_key_set.insert(keys.back()).second) {
+      compiled_groups.push_back(group);
+      compiled_keys.push_back(keys.back());
+    }
+  }
+  VLOG(4) << "Compile " << compiled_groups.size() << " of " << groups.size()
+          << " groups, the others reuse the kernels of isomorphic groups";
+
+  std::vector<pir::CINNKernelInfo> compiled_kernel_infos =
+      CompileCUDAJITInfo(compiled_groups);
+  for (int idx = 0; idx < compiled_groups.size(); ++idx) {
+    const auto op_indices = OpIndices(compiled_groups[idx]->CollectOps());
+    PirCompilerManager::GroupKernel kernel;
+    kernel.kernel_info = compiled_kernel_infos[idx];
+    for (const auto& value : compiled_groups[idx]->output_values) {
+      auto result = value.dyn_cast<::pir::OpResult>();
+      kernel.output_positions.emplace_back(op_indices.at(result.owner()),
+                                           result.index());
+    }
+    manager.InsertGroupKernel(compiled_keys[idx], std::move(kernel));
+  }
+
+  // the output values of a group are taken in the order of the kernel
+  // arguments, which are at the same positions in an isomorphic group
+  std::vector<pir::CINNKernelInfo> cinn_kernel_info_vecs;
+  for (int idx = 0; idx < groups.size(); ++idx) {
+    const auto* kernel = manager.FindGroupKernel(keys[idx]);
+    const std::vector<::pir::Operation*> ops = groups[idx]->CollectOps();
+    groups[idx]->output_values.clear();
+    for (const auto& position : kernel->output_positions) {
+      groups[idx]->output_values.push_back(
+          ops[position.first]->result(position.second));
+    }
+    cinn_kernel_info_vecs.push_back(kernel->kernel_info);
+  }
+  return cinn_kernel_info_vecs;
+}
+
+std::vector<pir::CINNKernelInfo> PirCompiler::CompileCUDAJITInfo(
+    const std::vector<pir::GroupPtr>& groups) {
   std::vector<pir::CINNKernelInfo> cinn_kernel_info_vecs(groups.size());
 
   if (FLAGS_cinn_bucket_compile) {
@@ -58,26 +201,12 @@ std::vector<pir::CINNKernelInfo> PirCompiler::BuildCUDAJITInfo(
     utils::parallel_run(
         worker_fn, utils::SequenceDispatcher(0, groups.size()), -1);
   } else {
-    auto op_lowerer = CreateOpLowerer<pir::GroupPtr>(target_);
-
-    std::vector<std::vector<ir::LoweredFunc>> lowered_funcs;
-    for (int i = 0; i < groups.size(); ++i) {
-      lowered_funcs.emplace_back(op_lowerer.Lower(groups[i]));
-    }
-
-    for (auto&& lowered_func : lowered_funcs) {
-      ProcessFunction(lowered_func);
-    }
-    compiler_ = backends::Compiler::Create(target_);
-    auto build_module = m_builder_.Build();
-    compiler_->Build(build_module, "");
-
-    auto fn_ptrs = compiler_->GetFnPtr();
+    CompileGroups(groups);
 
     for (int idx = 0; idx < groups.size(); ++idx) {
       pir::CINNKernelInfo cinn_kernel_info;
       auto fn_name = groups[idx]->FuncName();
-      auto fn_ptr = compiler_->Lookup(fn_name);
+      auto fn_ptr = group_compilers_[idx]->Lookup(fn_name);
       cinn_kernel_info.fn_ptr = fn_ptr;
       cinn_kernel_info.int_args_map = groups[idx]->int_args_map;
 
@@ -102,21 +231,7 @@ std::unique_ptr<Program> PirCompiler::Build(
     utils::parallel_run(
         worker_fn, utils::SequenceDispatcher(0, groups.size()), -1);
   } else {
-    auto op_lowerer = CreateOpLowerer<pir::GroupPtr>(target_);
-
-    std::vector<std::vector<ir::LoweredFunc>> lowered_funcs;
-    for (int i = 0; i < groups.size(); ++i) {
-      lowered_funcs.emplace_back(op_lowerer.Lower(groups[i]));
-    }
-
-    for (auto&& lowered_func : lowered_funcs) {
-      ProcessFunction(lowered_func);
-    }
-
-    compiler_ = backends::Compiler::Create(target_);
-    auto build_module = m_builder_.Build();
-    compiler_->Build(build_module, "");
-
+    CompileGroups(groups);
     instructions = BuildInstructions(groups);
   }
 
@@ -134,8 +249,59 @@ std::unique_ptr<Program> PirCompiler::Build(
   return std::make_unique<Program>(scope_, std::move(instructions));
 }
 
+void PirCompiler::CompileGroups(const std::vector<pir::GroupPtr>& groups) {
+  group_compilers_.clear();
+  utils::Timer timer;
+  timer.Start();
+  std::vector<std::vector<ir::LoweredFunc>> lowered_funcs(groups.size());
+  auto lower_fn = [&](int index) {
+    auto op_lowerer = CreateOpLowerer<pir::GroupPtr>(target_);
+    lowered_funcs[index] = op_lowerer.Lower(groups[index]);
+  };
+  utils::parallel_run(
+      lower_fn, utils::SequenceDispatcher(0, groups.size()), -1);
+  const float lower_ms = timer.Stop();
+
+  timer.Start();
+  const int batch_size = FLAGS_cinn_compile_batch_size > 0
+                             ? FLAGS_cinn_compile_batch_size
+                             : std::max<int>(groups.size(), 1);
+  const int module_num = (groups.size() + batch_size - 1) / batch_size;
+  // the scope is updated by the arguments of the functions in order, which
+  // leaves only the code generation of the modules to run in parallel
+  std::vector<ir::Module> modules;
+  for (int i = 0; i < module_num; ++i) {
+    ir::Module::Builder builder(cinn::common::UniqName("Pir"), target_);
+    const int end = std::min<int>(groups.size(), (i + 1) * batch_size);
+    for (int idx = i * batch_size; idx < end; ++idx) {
+      ProcessFunction(lowered_funcs[idx], &builder);
+    }
+    modules.push_back(builder.Build());
+  }
+  std::vector<std::unique_ptr<backends::Compiler>> compilers(module_num);
+  auto compile_fn = [&](int index) {
+    compilers[index] = backends::Compiler::Create(target_);
+    compilers[index]->Build(modules[index], "");
+  };
+  utils::parallel_run(compile_fn, utils::SequenceDispatcher(0, module_num), -1);
+  const float compile_ms = timer.Stop();
+
+  for (int idx = 0; idx < groups.size(); ++idx) {
+    group_compilers_.push_back(compilers[idx / batch_size].get());
+  }
+  for (auto& compiler : compilers) {
+    compilers_.push_back(std::move(compiler));
+  }
+  if (FLAGS_cinn_compile_timing_report) {
+    LOG(INFO) << "PirCompiler lowered " << groups.size() << " groups in "
+              << lower_ms << " ms, and compiled them in " << module_num
+              << " modules in " << compile_ms << " ms";
+  }
+}
+
 void PirCompiler::ProcessFunction(
-    const std::vector<ir::LoweredFunc>& lowered_funcs) {
+    const std::vector<ir::LoweredFunc>& lowered_funcs,
+    ir::Module::Builder* builder) {
   for (auto&& func : lowered_funcs) {
     for (auto&& arg : func->args) {
       std::string arg_name = arg.name();
@@ -155,7 +321,7 @@ void PirCompiler::ProcessFunction(
         tensor->set_type(arg.buffer_arg()->dtype);
       }
     }
-    m_builder_.AddFunction(func);
+    builder->AddFunction(func);
   }
 }
 
@@ -171,7 +337,7 @@ std::vector<std::unique_ptr<Instruction>> PirCompiler::BuildInstructions(
                                                      groups[idx]->output_names,
                                                      fn_name));
     VLOG(4) << "Lookup kernel name: " << fn_name;
-    auto* fn_ptr = compiler_->Lookup(fn_name);
+    auto* fn_ptr = group_compilers_[idx]->Lookup(fn_name);
     CHECK(fn_ptr);
     instr->SetLoweredFunc(reinterpret_cast<void*>(fn_ptr), fn_name);
     // As some instruction like reduce, will generate more than one kernel.
@@ -15,7 +15,9 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <utility>
 #include "paddle/cinn/common/macros.h"
 #include "paddle/pir/core/program.h"
 
@@ -34,13 +36,12 @@ class PirCompiler final {
   PirCompiler(const ::pir::Program& prog,
               const Target& target,
               const std::shared_ptr<Scope>& scope)
-      : program_(prog),
-        m_builder_("Pir", target),
-        target_(target),
-        scope_(scope) {}
+      : program_(prog), target_(target), scope_(scope) {}
 
   std::unique_ptr<Program> Build();
 
+  // Compiles a group of each structure, an isomorphic group of a compiled
+  // one in the programs, e.g. of a repeated layer, reuses its kernel.
   std::vector<pir::CINNKernelInfo> BuildCUDAJITInfo(
       const std::vector<pir::GroupPtr>& groups);
 
@@ -49,16 +50,25 @@ class PirCompiler final {
  private:
   CINN_DISALLOW_COPY_AND_ASSIGN(PirCompiler);
 
+  std::vector<pir::CINNKernelInfo> CompileCUDAJITInfo(
+      const std::vector<pir::GroupPtr>& groups);
+
   std::vector<ir::LoweredFunc> GetOpFunc(const ::pir::Operation& op, int idx);
 
-  void ProcessFunction(const std::vector<ir::LoweredFunc>& lowered_funcs);
+  void ProcessFunction(const std::vector<ir::LoweredFunc>& lowered_funcs,
+                       ir::Module::Builder* builder);
+
+  // Lowers the groups in parallel, and compiles them in the modules of
+  // FLAGS_cinn_compile_batch_size groups, which are built in parallel too.
+  void CompileGroups(const std::vector<pir::GroupPtr>& groups);
 
   std::vector<std::unique_ptr<Instruction>> BuildInstructions(
       const std::vector<pir::GroupPtr>& groups);
 
   const ::pir::Program& program_;
-  ir::Module::Builder m_builder_;
-  std::unique_ptr<backends::Compiler> compiler_{nullptr};
+  std::vector<std::unique_ptr<backends::Compiler>> compilers_;
+  // group_compilers_[i] is the compiler of the module of the i-th group
+  std::vector<backends::Compiler*> group_compilers_;
   Target target_;
   std::shared_ptr<Scope> scope_;
   std::unordered_map<std::string, std::string> func_names_;
@@ -85,14 +95,35 @@ class PirCompilerManager {
     return compiler;
   }
 
+  // The kernel of the groups of a structure key, whose function is owned by
+  // one of the compilers.
+  struct GroupKernel {
+    pir::CINNKernelInfo kernel_info;
+    // the (op index, result index) of the output values of the group
+    std::vector<std::pair<int, int>> output_positions;
+  };
+
   void insert(const std::shared_ptr<PirCompiler>& compiler) {
     compilers_.push_back(compiler);
   }
 
-  void clear() { compilers_.clear(); }
+  const GroupKernel* FindGroupKernel(const std::string& key) const {
+    auto it = group_kernels_.find(key);
+    return it == group_kernels_.end() ? nullptr : &it->second;
+  }
+
+  void InsertGroupKernel(const std::string& key, GroupKernel&& kernel) {
+    group_kernels_.emplace(key, std::move(kernel));
+  }
+
+  void clear() {
+    group_kernels_.clear();
+    compilers_.clear();
+  }
 
  private:
   std::vector<std::shared_ptr<PirCompiler>> compilers_;
+  std::unordered_map<std::string, GroupKernel> group_kernels_;
 };
 
 }  // namespace framework
@@ -15,6 +15,9 @@
 #include <gtest/gtest.h>
 
 #include "paddle/cinn/frontend/decomposer/test_helper.h"
+#include "paddle/cinn/runtime/flags.h"
+
+PD_DECLARE_int32(cinn_independent_fusion_max_ops);
 
 namespace cinn {
 namespace frontend {
@@ -483,5 +486,60 @@ TEST(FusionMergePass, Reduce_Test_5) {
   CHECK_EQ(graph->fusion_groups.size(), 1);
 }
 
+TEST(GeneralFusionMergePass, Independent_Fusion_0) {
+  int h = 32, w = 32;
+  NetBuilder net_builder("Independent_Fusion_0");
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {h, w}, "A");
+    auto B = net_builder.CreateInput(Float(32), {h, w}, "B");
+    auto C = net_builder.CreateInput(Float(32), {h, w}, "C");
+    auto D = net_builder.CreateInput(Float(32), {h, w}, "D");
+    auto X = net_builder.CreateInput(Float(32), {h / 2, w}, "X");
+    auto Y = net_builder.CreateInput(Float(32), {h / 2, w}, "Y");
+    auto E = net_builder.Add(A, B);
+    auto F = net_builder.Multiply(C, D);
+    auto G = net_builder.Add(X, Y);
+  }
+
+  auto program = net_builder.Build();
+  auto target = cinn::common::DefaultTarget();
+  RunDecomposer(&program, target);
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  CHECK_EQ(graph->fusion_groups.size(), 3);
+  hlir::framework::ApplyPass(graph.get(), "GeneralFusionMergePass");
+  // the groups of E and F share the loop space
+  CHECK_EQ(graph->fusion_groups.size(), 2);
+}
+
+TEST(GeneralFusionMergePass, Independent_Fusion_1) {
+  int h = 32, w = 32;
+  NetBuilder net_builder("Independent_Fusion_1");
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {h, w}, "A");
+    auto B = net_builder.CreateInput(Float(32), {h, w}, "B");
+    auto C = net_builder.CreateInput(Float(32), {h, w}, "C");
+    auto D = net_builder.CreateInput(Float(32), {h, w}, "D");
+    auto E = net_builder.Add(A, B);
+    auto F = net_builder.Multiply(C, D);
+  }
+
+  auto program = net_builder.Build();
+  auto target = cinn::common::DefaultTarget();
+  RunDecomposer(&program, target);
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  CHECK_EQ(graph->fusion_groups.size(), 2);
+  // the groups fused would exceed the budget
+  FLAGS_cinn_independent_fusion_max_ops = 1;
+  hlir::framework::ApplyPass(graph.get(), "GeneralFusionMergePass");
+  FLAGS_cinn_independent_fusion_max_ops = 64;
+  CHECK_EQ(graph->fusion_groups.size(), 2);
+}
+
 }  // namespace frontend
 }  // namespace cinn
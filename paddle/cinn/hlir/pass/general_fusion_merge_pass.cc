@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <map>
+#include <queue>
 #include <unordered_map>
 
 #include "glog/logging.h"
@@ -27,6 +28,8 @@
 #include "paddle/cinn/hlir/pass/general_fusion_merge_pass_utils.h"
 
 PD_DECLARE_bool(enhance_vertical_fusion_with_recompute);
+PD_DECLARE_bool(cinn_fuse_independent_groups);
+PD_DECLARE_int32(cinn_independent_fusion_max_ops);
 
 namespace cinn {
 namespace hlir {
@@ -95,6 +98,10 @@ class GeneralFusionMergePassHelper : public FusionHelperBase {
     }
     while (DoGeneralRecomputeAndVerticalFusion()) {
     }
+    if (FLAGS_cinn_fuse_independent_groups) {
+      while (DoGeneralIndependentFusion()) {
+      }
+    }
   }
 
   bool DoGeneralHorizontalFusion() {
@@ -171,6 +178,89 @@ class GeneralFusionMergePassHelper : public FusionHelperBase {
     return updated;
   }
 
+  // Fuses the groups that do not depend on each other, e.g. the optimizer
+  // math of every parameter, into one kernel if they have the same loop
+  // space, so that they are launched once. The ops of the fused group are
+  // limited by FLAGS_cinn_independent_fusion_max_ops, which bounds the
+  // registers and the arguments of the kernel. One group is fused at a time,
+  // since two of them fused at once may depend on each other through their
+  // members.
+  bool DoGeneralIndependentFusion() {
+    VLOG(3) << "DoGeneralIndependentFusion...!";
+    const size_t max_ops = FLAGS_cinn_independent_fusion_max_ops;
+    // the candidates in the topological order by the numel of the loop space
+    std::map<int64_t, GroupList> numel_to_groups;
+    for (auto& group : fusion_groups_) {
+      if (group->belong_groups.size()) {
+        continue;
+      }
+      if (group->op_pattern_kind != framework::kElementWise &&
+          group->op_pattern_kind != framework::kBroadcast &&
+          group->op_pattern_kind != framework::kInjective) {
+        continue;
+      }
+      if (group->CollectNodes().size() >= max_ops) {
+        continue;
+      }
+      const auto& master = utils::GetMasterNode(api::OpGroup(group));
+      numel_to_groups[master.outputs()[0].shape().numel()].push_back(group);
+    }
+
+    for (auto& numel_groups : numel_to_groups) {
+      const GroupList& groups = numel_groups.second;
+      if (groups.size() <= 1) {
+        continue;
+      }
+      GroupList fused_groups;
+      size_t fused_ops = 0;
+      for (const auto& group : groups) {
+        const size_t num_ops = group->CollectNodes().size();
+        if (fused_ops + num_ops > max_ops) {
+          continue;
+        }
+        bool independent = true;
+        for (const auto& fused : fused_groups) {
+          if (IsDependent(fused, group) || IsDependent(group, fused)) {
+            independent = false;
+            break;
+          }
+        }
+        if (independent) {
+          fused_groups.push_back(group);
+          fused_ops += num_ops;
+        }
+      }
+      if (fused_groups.size() > 1) {
+        VLOG(3) << "Fuse " << fused_groups.size()
+                << " independent groups of " << fused_ops << " ops";
+        HorizontalFuse(fused_groups);
+        UpdateFusionGroup();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Whether dst depends on src through the producers of the groups.
+  bool IsDependent(const GroupPtr& src, const GroupPtr& dst) const {
+    std::queue<GroupPtr> candidates;
+    std::unordered_set<GroupPtr, Hasher, Comparator> visited;
+    candidates.push(dst);
+    while (!candidates.empty()) {
+      GroupPtr candidate = candidates.front();
+      candidates.pop();
+      for (const auto& producer : candidate->producer_groups()) {
+        if (producer == src) {
+          return true;
+        }
+        if (visited.insert(producer).second) {
+          candidates.push(producer);
+        }
+      }
+    }
+    return false;
+  }
+
   void UpdateFusionGroup() {
     VLOG(3) << "UpdateFusionGroup...";
     GroupList fusion_groups;
@@ -14,6 +14,8 @@
 
 #include "paddle/cinn/ir/group_schedule/dy_shape_group_scheduler.h"
 
+#include "paddle/cinn/common/ir_util.h"
+
 namespace cinn {
 namespace ir {
 
@@ -30,15 +32,33 @@ void DynamicShapeGroupScheduler::Schedule() {
   ir_sch_->ComputeInline(block0);
   auto reorder1 = ir_sch_->Reorder("var_1", {1, 0});
 
-  auto loops1 = ir_sch_->GetLoops("var_1");
-  auto splited_loops1 = ir_sch_->DySplit(loops1[1], {-1, 1, 32});
-  ir_sch_->Bind(splited_loops1[1], "blockIdx.x");
-  ir_sch_->Bind(splited_loops1[2], "threadIdx.x");
+  // specialize the kernel on whether the extent of the loop bound to threads
+  // is divisible by the block size, in which case the tail needs no guard.
+  // The buckets are tried in order at launch time, the generic one is last.
+  ir::Expr extent = ir_sch_->GetLoops("var_1")[1].As<ir::For>()->extent;
+  if (const ir::IntImm* static_extent = extent.As<ir::IntImm>()) {
+    ScheduleBucket(Expr(true), static_extent->value % kBlockSize == 0);
+    return;
+  }
+  ScheduleBucket(
+      ir::EQ::Make(
+          ir::Mod::Make(extent,
+                        cinn::common::make_const(extent.type(), kBlockSize)),
+          cinn::common::make_const(extent.type(), 0)),
+      /*divisible=*/true);
+  ScheduleBucket(Expr(true), /*divisible=*/false);
+}
 
-  ir::Expr predicate1 = ir::LE::Make(Expr(1023), Expr(1024));
-  std::unique_ptr<ir::IRSchedule> new_ir_sch1 =
+void DynamicShapeGroupScheduler::ScheduleBucket(const SymbolicPredicate& pred,
+                                                bool divisible) {
+  std::unique_ptr<ir::IRSchedule> new_ir_sch =
       std::make_unique<ir::IRSchedule>(*ir_sch_);
-  ir_schs_.emplace_back(predicate1, std::move(new_ir_sch1));
+  auto loops1 = new_ir_sch->GetLoops("var_1");
+  auto splited_loops1 =
+      new_ir_sch->DySplit(loops1[1], {-1, 1, kBlockSize}, divisible);
+  new_ir_sch->Bind(splited_loops1[1], "blockIdx.x");
+  new_ir_sch->Bind(splited_loops1[2], "threadIdx.x");
+  ir_schs_.emplace_back(pred, std::move(new_ir_sch));
 }
 
 std::vector<std::pair<SymbolicPredicate, ir::Expr>>
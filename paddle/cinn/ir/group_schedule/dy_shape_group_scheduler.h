@@ -35,6 +35,12 @@ class DynamicShapeGroupScheduler : public GroupScheduler {
   std::vector<std::pair<SymbolicPredicate, ir::Expr>> GetIRs() override;
 
  private:
+  // schedule a copy of ir_sch_ into the kernel of the bucket of pred,
+  // divisible tells the extents in the bucket are divisible by kBlockSize
+  void ScheduleBucket(const SymbolicPredicate& pred, bool divisible);
+
+  static constexpr int kBlockSize = 32;
+
   std::vector<std::pair<SymbolicPredicate, std::unique_ptr<ir::IRSchedule>>>
       ir_schs_;
 };
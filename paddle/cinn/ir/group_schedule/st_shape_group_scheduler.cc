@@ -24,6 +24,10 @@
 #include "paddle/cinn/ir/utils/ir_copy.h"
 #include "paddle/cinn/ir/utils/ir_nodes_collector.h"
 #include "paddle/cinn/optim/replace_var_with_expr.h"
+#include "paddle/cinn/runtime/flags.h"
+
+PD_DECLARE_bool(cinn_group_schedule_row_cache);
+PD_DECLARE_bool(cinn_group_schedule_cpu_loops);
 
 namespace cinn {
 namespace ir {
@@ -111,6 +115,27 @@ std::unordered_set<std::string> GetReduceLoopVarNames(ir::Expr block) {
   return reduce_loop_var_names;
 }
 
+// The index of the first load of tensor_name in block, in the order of the
+// read buffers of CacheRead.
+int GetReadTensorIndex(ir::Expr block, const std::string& tensor_name) {
+  std::vector<ir::Expr> loads;
+  ir::ir_utils::CollectIRNodesWithoutTensor(
+      block.As<ir::ScheduleBlockRealize>()
+          ->schedule_block.As<ir::ScheduleBlock>()
+          ->body,
+      [&](const ir::Expr* x) {
+        if (x->As<ir::Load>()) loads.push_back(*x);
+        return x->As<ir::Load>();
+      });
+  for (int i = 0; i < loads.size(); ++i) {
+    if (loads[i].As<ir::Load>()->tensor.as_tensor_ref()->name ==
+        tensor_name) {
+      return i;
+    }
+  }
+  return -1;
+}
+
 std::unordered_set<std::string> GetReduceVarNames(ir::Expr block) {
   ir::ScheduleBlockRealize* schedule_block_realize =
       block.As<ir::ScheduleBlockRealize>();
@@ -134,14 +159,17 @@ void StaticShapeGroupScheduler::Schedule() {
   DoLoopAlignment();
   DoComputeInline();
 #ifdef CINN_WITH_CUDA
+  CacheReduceBroadcastInputs();
   OptimizeReduction();
 #endif
   DoHorizontalLoopFusion();
   DoVerticalLoopFusion();
 #ifdef CINN_WITH_CUDA
   BindCudaAxis();
+  ScheduleRowCaches();
   AllocateStorage();
 #endif
+  ScheduleCPULoops();
 }
 
 void StaticShapeGroupScheduler::MapExprSchedule() {
@@ -1113,6 +1141,280 @@ void StaticShapeGroupScheduler::OptimizeReduction() {
           << ir_sch_->GetModule().GetExprs().front();
 }
 
+// The row cached on chip is at most the size, so that it is kept in the
+// shared memory of a cuda block besides the buffers of the reduce.
+static constexpr int64_t kMaxRowCacheBytes = 32 * 1024;
+// The bytes of a vectorized load of the cached rows.
+static constexpr int kVectorizedLoadBytes = 16;
+
+void StaticShapeGroupScheduler::CacheReduceBroadcastInputs() {
+  if (target_.arch != Target::Arch::NVGPU ||
+      !FLAGS_cinn_group_schedule_row_cache) {
+    return;
+  }
+  VLOG(5) << "[Start CacheReduceBroadcastInputs] func body: "
+          << ir_sch_->GetModule().GetExprs().front();
+
+  // The inputs of the group read by more than one block, where the first
+  // reduce block reading it is recorded.
+  std::unordered_set<std::string> produced_names;
+  std::vector<std::string> input_names;
+  std::unordered_map<std::string, int> num_readers;
+  std::unordered_map<std::string, ir::ScheduleBlockNode*> reduce_readers;
+  auto CollectInputs = [&](ir::ScheduleBlockNode* node) {
+    ir::Expr block = node->Block();
+    produced_names.insert(ir::GetTensor(block)->name);
+    if (IsProhibitScheduleExternCallBlock(block)) {
+      return;
+    }
+    bool is_reduce = !GetReduceVarNames(block).empty();
+    std::unordered_set<std::string> read_names;
+    ir::ir_utils::CollectIRNodesWithoutTensor(
+        block, [&](const ir::Expr* x) {
+          if (x->As<ir::Load>()) {
+            read_names.insert(
+                x->As<ir::Load>()->tensor.as_tensor_ref()->name);
+          }
+          return false;
+        });
+    for (const std::string& name : read_names) {
+      if (num_readers.count(name) == 0) {
+        input_names.push_back(name);
+      }
+      ++num_readers[name];
+      if (is_reduce && reduce_readers.count(name) == 0) {
+        reduce_readers[name] = node;
+      }
+    }
+  };
+  schedule_block_graph_->DFSTopoWalk(CollectInputs);
+
+  for (const std::string& name : input_names) {
+    if (produced_names.count(name) > 0 || num_readers[name] < 2 ||
+        reduce_readers.count(name) == 0) {
+      continue;
+    }
+    ir::ScheduleBlockNode* reduce_node = reduce_readers[name];
+    ir::Expr reduce_block = reduce_node->Block();
+    std::unordered_set<std::string> reduce_loop_var_names =
+        GetReduceLoopVarNames(reduce_block);
+    int64_t row_extent = 1;
+    for (const ir::Expr& loop : ir_sch_->GetLoops(reduce_block)) {
+      if (reduce_loop_var_names.count(loop.As<ir::For>()->loop_var->name) >
+          0) {
+        row_extent *= ir::GetLoopExtent(loop);
+      }
+    }
+    int read_index = GetReadTensorIndex(reduce_block, name);
+    if (read_index < 0) {
+      continue;
+    }
+    ir::Expr read_expr = ir::GetNthAccessExpr(reduce_block, read_index, false);
+    int64_t row_bytes =
+        row_extent *
+        read_expr.As<ir::Load>()->tensor.as_tensor_ref()->type().bytes();
+    if (row_bytes > kMaxRowCacheBytes) {
+      VLOG(6) << "Do not cache the rows of " << name << " of " << row_bytes
+              << " bytes";
+      continue;
+    }
+    ir::Expr cache_block =
+        ir_sch_->CacheRead(reduce_block, read_index, "local");
+    std::string cache_name = ir::GetTensor(cache_block)->name;
+    row_cache_to_reduce_[cache_name] = reduce_node->id();
+    VLOG(6) << "Cache the rows of " << name << " read by " << reduce_node->id()
+            << " to " << cache_name;
+  }
+
+  schedule_block_graph_->Update(*ir_sch_);
+  VLOG(5) << "[After CacheReduceBroadcastInputs] func body: "
+          << ir_sch_->GetModule().GetExprs().front();
+}
+
+void StaticShapeGroupScheduler::ScheduleRowCaches() {
+  if (target_.arch != Target::Arch::NVGPU) return;
+  VLOG(5) << "[Start ScheduleRowCaches] func body: "
+          << ir_sch_->GetModule().GetExprs().front();
+
+  for (const auto& cache_and_reduce : row_cache_to_reduce_) {
+    if (!ir_sch_->HasBlock(cache_and_reduce.first) ||
+        !ir_sch_->HasBlock(cache_and_reduce.second)) {
+      continue;
+    }
+    // The threads of the reduce of the row
+    int num_threads = 0;
+    for (const ir::Expr& loop : ir_sch_->GetLoops(cache_and_reduce.second)) {
+      if (loop.As<ir::For>()->is_gpu_thread_binded()) {
+        num_threads = ir::GetLoopExtent(loop);
+      }
+    }
+    // The row loops are the serial loops under the ones bound to the cuda
+    // block of the row, which are not shared with the other blocks.
+    std::vector<ir::Expr> loops = ir_sch_->GetLoops(cache_and_reduce.first);
+    std::vector<ir::Expr> row_loops;
+    bool under_cuda_block = false;
+    for (const ir::Expr& loop : loops) {
+      const ir::For* for_node = loop.As<ir::For>();
+      if (for_node->is_gpu_thread_binded() ||
+          (for_node->is_gpu_block_binded() && !row_loops.empty())) {
+        under_cuda_block = false;
+        break;
+      }
+      if (for_node->is_gpu_block_binded()) {
+        under_cuda_block = true;
+      } else if (under_cuda_block && for_node->is_serial()) {
+        row_loops.push_back(loop);
+      }
+    }
+    if (num_threads <= 1 || !under_cuda_block || row_loops.empty()) {
+      continue;
+    }
+    ir::Expr row_loop =
+        row_loops.size() > 1 ? ir_sch_->Fuse(row_loops) : row_loops[0];
+    int row_extent = ir::GetLoopExtent(row_loop);
+    int vector_width =
+        kVectorizedLoadBytes /
+        ir::GetTensor(ir_sch_->GetBlock(cache_and_reduce.first))
+            ->type()
+            .bytes();
+    while (vector_width > 1 && row_extent % (num_threads * vector_width) != 0) {
+      vector_width /= 2;
+    }
+    if (row_extent % (num_threads * vector_width) != 0) {
+      continue;
+    }
+    // Every thread loads vector_width consecutive elements every time, and
+    // the threads load the consecutive vectors.
+    if (vector_width > 1) {
+      std::vector<ir::Expr> splited_loops =
+          ir_sch_->Split(row_loop, {-1, num_threads, vector_width});
+      ir_sch_->Bind(splited_loops[1], "threadIdx.x");
+      ir_sch_->Vectorize(splited_loops[2], vector_width);
+    } else {
+      std::vector<ir::Expr> splited_loops =
+          ir_sch_->Split(row_loop, {-1, num_threads});
+      ir_sch_->Bind(splited_loops[1], "threadIdx.x");
+    }
+    VLOG(6) << "Load the rows of " << cache_and_reduce.first << " by "
+            << num_threads << " threads with the vector width "
+            << vector_width;
+  }
+
+  schedule_block_graph_->Update(*ir_sch_);
+  VLOG(5) << "[After ScheduleRowCaches] func body: "
+          << ir_sch_->GetModule().GetExprs().front();
+}
+
+// The native vector width in bits of the host, for which the x86 code is
+// jitted.
+static int HostVectorBits() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  if (__builtin_cpu_supports("avx512f")) return 512;
+  if (__builtin_cpu_supports("avx2")) return 256;
+#endif
+  return 128;
+}
+
+// The loop nests of fewer elements are not parallelized, for which the
+// launch of the threads costs more than it saves.
+static constexpr int64_t kMinParallelElements = 16 * 1024;
+
+void StaticShapeGroupScheduler::ScheduleCPULoops() {
+  if (target_.arch != Target::Arch::X86 ||
+      !FLAGS_cinn_group_schedule_cpu_loops) {
+    return;
+  }
+  VLOG(5) << "[Start ScheduleCPULoops] func body: "
+          << ir_sch_->GetModule().GetExprs().front();
+
+  const int vector_bits = HostVectorBits();
+  // The outermost loops of the scheduled loop nests, each of which is shared
+  // by the blocks fused into it.
+  std::unordered_set<std::string> scheduled_root_loops;
+
+  auto ScheduleFunc = [&](ir::ScheduleBlockNode* node) {
+    if (IsProhibitScheduleExternCallBlock(node->Block())) {
+      return;
+    }
+    std::vector<ir::Expr> loops = ir_sch_->GetLoops(node->id());
+    if (loops.empty() ||
+        !scheduled_root_loops
+             .insert(loops[0].As<ir::For>()->loop_var->name)
+             .second) {
+      return;
+    }
+
+    // The leading serial spatial loops, and the leading loops nested
+    // perfectly.
+    std::unordered_set<std::string> reduce_loop_var_names =
+        GetReduceLoopVarNames(node->Block());
+    int num_spatial = 0;
+    int64_t num_elements = 1;
+    for (; num_spatial < loops.size(); ++num_spatial) {
+      ir::For* for_node = loops[num_spatial].As<ir::For>();
+      if (!for_node->is_serial() || !for_node->extent.is_constant() ||
+          reduce_loop_var_names.count(for_node->loop_var->name) != 0) {
+        break;
+      }
+      num_elements *= ir::GetLoopExtent(loops[num_spatial]);
+    }
+    int num_nested = 1;
+    for (; num_nested < loops.size(); ++num_nested) {
+      ir::Block* body =
+          loops[num_nested - 1].As<ir::For>()->body.As<ir::Block>();
+      if (!body || body->stmts.size() != 1 ||
+          body->stmts[0].get() != loops[num_nested].get()) {
+        break;
+      }
+    }
+
+    // The innermost loop is vectorized if it is spatial and computes the
+    // block only.
+    int vector_width = 0;
+    ir::Block* inner_body = loops.back().As<ir::For>()->body.As<ir::Block>();
+    if (num_spatial == loops.size() && inner_body &&
+        inner_body->stmts.size() == 1 &&
+        inner_body->stmts[0].As<ir::ScheduleBlockRealize>()) {
+      auto stores = ir::ir_utils::CollectIRNodesWithoutTensor(
+          node->Block(), [](const Expr* x) { return x->As<ir::Store>(); });
+      if (!stores.empty()) {
+        const int inner_extent = ir::GetLoopExtent(loops.back());
+        vector_width =
+            vector_bits /
+            stores.begin()->As<ir::Store>()->tensor.as_tensor()->type().bits();
+        while (vector_width > inner_extent) {
+          vector_width /= 2;
+        }
+      }
+    }
+
+    int num_parallel = std::min(num_spatial, num_nested);
+    if (vector_width > 1 && num_parallel == loops.size()) {
+      --num_parallel;
+    }
+    if (num_parallel > 0 && num_elements >= kMinParallelElements) {
+      std::vector<ir::Expr> parallel_loops(loops.begin(),
+                                           loops.begin() + num_parallel);
+      ir::Expr fused = num_parallel > 1 ? ir_sch_->Fuse(parallel_loops)
+                                        : parallel_loops[0];
+      if (ir::GetLoopExtent(fused) > 1) {
+        ir_sch_->Parallel(fused);
+      }
+    }
+    if (vector_width > 1) {
+      ir_sch_->Vectorize(ir_sch_->GetLoops(node->id()).back(), vector_width);
+    }
+    VLOG(6) << "Schedule the loops of " << node->id() << " with "
+            << num_parallel << " loops parallelized and the vector width "
+            << vector_width;
+  };
+
+  schedule_block_graph_->DFSTopoWalk(ScheduleFunc);
+  schedule_block_graph_->Update(*ir_sch_);
+  VLOG(5) << "[After ScheduleCPULoops] func body: "
+          << ir_sch_->GetModule().GetExprs().front();
+}
+
 void StaticShapeGroupScheduler::UpdateBlockOrder() {
   ir::Expr root_block = ir_sch_->GetRootBlock(ir_sch_->GetAllBlocks()[0]);
   ir::BlockOrderConstructor block_order_constructor;
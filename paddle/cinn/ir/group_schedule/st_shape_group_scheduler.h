@@ -79,6 +79,21 @@ class StaticShapeGroupScheduler : public GroupScheduler {
   // Automatically optimize the reductive calculation
   void OptimizeReduction();
 
+  // Cache the rows of the inputs read by both the reduce and the broadcast
+  // stages, e.g. of softmax and the norms, so that a row is loaded from the
+  // global memory once and kept in the registers or the shared memory by
+  // AllocateStorage across the stages, if the row fits.
+  void CacheReduceBroadcastInputs();
+
+  // Distribute the loads of the cached rows over the threads of the reduce
+  // of the row, with vectorized loads.
+  void ScheduleRowCaches();
+
+  // Parallelize the outer spatial loops over the host threads and vectorize
+  // the innermost spatial loop by the native vector width of the host, whose
+  // tail not filling the vector is left to the scalars by VectorizeLoops.
+  void ScheduleCPULoops();
+
   // Evaluate the priority of ScheduleBlockNode.
   // The node where the performance bottleneck is located
   // has a higher priority, while the node with a lower priority
@@ -134,6 +149,9 @@ class StaticShapeGroupScheduler : public GroupScheduler {
   // All feasible conditions.
   std::vector<FeasibleCondition> feasible_conditions_;
 
+  // The cache blocks of the rows, and the reduce blocks reading them.
+  std::map<std::string, std::string> row_cache_to_reduce_;
+
   /**
    * The order of blocks and their control statements,
    * only For, IfThenElse and ScheduleBlock is considered.
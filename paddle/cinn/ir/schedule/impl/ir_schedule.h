@@ -49,6 +49,11 @@ class DyScheduleImpl : public ScheduleBase {
   std::vector<Expr> GetChildBlocks(const Expr& expr) const;
   Expr GetBlock(const std::string& block_name) const;
   std::vector<Expr> Split(const Expr& loop, const std::vector<int>& factors);
+  // divisible tells the extent of loop is divisible by the product of the
+  // factors, so the splited loops need no guard of the tail
+  std::vector<Expr> Split(const Expr& loop,
+                          const std::vector<int>& factors,
+                          bool divisible);
   std::vector<Expr> SamplePerfectTile(
       utils::LinearRandomEngine::StateType* rand_seed,
       const Expr& loop,
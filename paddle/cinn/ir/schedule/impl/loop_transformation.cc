@@ -20,6 +20,12 @@ namespace ir {
 
 std::vector<Expr> DyScheduleImpl::Split(const Expr& loop,
                                         const std::vector<int>& factors) {
+  return Split(loop, factors, /*divisible=*/false);
+}
+
+std::vector<Expr> DyScheduleImpl::Split(const Expr& loop,
+                                        const std::vector<int>& factors,
+                                        bool divisible) {
   CHECK(loop.As<ir::For>())
       << "Expr param of Split must be For node! Please check.";
   auto* for_node = loop.As<ir::For>();
@@ -42,7 +48,8 @@ std::vector<Expr> DyScheduleImpl::Split(const Expr& loop,
   for (auto factor : factors) prod_size = prod_size * Expr(factor);
   std::for_each(factors.begin(), factors.end(), [&](int factor) {
     if (factor == -1) {
-      process_factors.push_back(tot_extent / prod_size + Expr(1));
+      process_factors.push_back(divisible ? tot_extent / prod_size
+                                          : tot_extent / prod_size + Expr(1));
     } else {
       process_factors.push_back(Expr(factor));
     }
@@ -66,7 +73,10 @@ std::vector<Expr> DyScheduleImpl::Split(const Expr& loop,
   std::vector<Expr> splited_loops;
   splited_loops.resize(process_factors.size());
 
-  new_node = IfThenElse::Make(LT::Make(substitute_value, tot_extent), new_node);
+  if (!divisible) {
+    new_node =
+        IfThenElse::Make(LT::Make(substitute_value, tot_extent), new_node);
+  }
 
   for (int i = process_factors.size() - 1; i >= 0; i--) {
     if (!new_node.As<ir::Block>()) new_node = Block::Make({new_node});
@@ -389,8 +389,15 @@ std::vector<Expr> IRSchedule::Split(const Expr& loop,
 }
 
 std::vector<Expr> IRSchedule::DySplit(const Expr& loop,
-                                      const std::vector<int>& factors) {
-  return impl_->Split(loop, factors);
+                                      const std::vector<int>& factors,
+                                      bool divisible) {
+  if (!divisible) {
+    return impl_->Split(loop, factors);
+  }
+  auto* dy_impl = dynamic_cast<DyScheduleImpl*>(impl_.get());
+  CHECK(dy_impl) << "DySplit with a divisible loop is only supported by the "
+                    "dynamic shape schedule.";
+  return dy_impl->Split(loop, factors, divisible);
 }
 
 std::vector<Expr> IRSchedule::Split(const std::string& block_name,
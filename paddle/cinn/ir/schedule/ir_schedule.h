@@ -108,7 +108,19 @@ class IRSchedule {
    */
   std::vector<Expr> Split(const Expr& loop, const std::vector<int>& factors);
 
-  std::vector<Expr> DySplit(const Expr& loop, const std::vector<int>& factors);
+  /**
+   * \brief Split a for loop of dynamic extent into multiple loops, based on
+   * the factors, one of which should be -1.
+   * @param loop The loop to be splited.
+   * @param factors The factors we used to split the loop.
+   * @param divisible Whether the extent of the loop is known to be divisible
+   * by the product of the other factors, in which case the tail is not
+   * guarded. It holds only under a predicate of the bucket, e.g. S % 32 == 0.
+   * @return The splited loops.
+   */
+  std::vector<Expr> DySplit(const Expr& loop,
+                            const std::vector<int>& factors,
+                            bool divisible = false);
 
   /**
    * \brief Split a for loop into multiple loops, based on the factors.
@@ -763,5 +763,36 @@ TEST(GROUP_SCHEDULER, softmax) {
   CheckAccuracy(&net_builder, input_names);
 }
 
+TEST(GROUP_SCHEDULER, rms_norm) {
+  int h = 32, w = 1024;
+  NetBuilder net_builder("rms_norm");
+  std::vector<std::string> input_names = {"A"};
+  // create model
+  auto CreateModel = [&]() {
+    // x, whose rows are read by both the reduce and the broadcast
+    auto A = net_builder.CreateInput(Float(32), {h, w}, "A");
+    // x * x
+    auto B = net_builder.Multiply(A, A);
+    // sum x*x
+    auto C = net_builder.ReduceSum(B, {1});
+    // constant w
+    auto D = net_builder.FillConstant<float>({h}, 1024.0f, "D");
+    // mean x*x
+    auto E = net_builder.Divide(C, D);
+    // eps
+    auto F = net_builder.FillConstant<float>({h}, 1e-6f, "F");
+    // rms
+    auto G = net_builder.Sqrt(net_builder.Add(E, F));
+    auto GG = net_builder.BroadcastTo(G, {h, w}, {0});
+    // x / rms
+    auto H = net_builder.Divide(A, GG);
+  };
+
+  CreateModel();
+  Compile(&net_builder);
+  CreateModel();
+  CheckAccuracy(&net_builder, input_names);
+}
+
 }  // namespace ir
 }  // namespace cinn
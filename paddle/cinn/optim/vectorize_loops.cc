@@ -750,6 +750,12 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
       auto *extent_min = for_extent.As<Min>();
       auto *extent_max = for_extent.As<Max>();
 
+      if (target != cinn::common::DefaultNVGPUTarget() &&
+          PeelScalarTail(node, expr)) {
+        var_intervals.erase(loopvar_name);
+        return;
+      }
+
       vectorizable_ = true;
       IRMutator<>::Visit(&node->body, &node->body);
 
@@ -921,6 +927,43 @@ struct VectorizeLoops_ : public IRMutator<Expr *> {
     return false;
   }
 
+  //! Peel the tail of a vectorized forloop whose constant extent is not a
+  //! multiple of the factor into a serial forloop, so that the rest of it is
+  //! vectorized with the full lanes instead of falling back to the scalars.
+  //! @return Whether the forloop is peeled.
+  bool PeelScalarTail(For *forloop, Expr *expr) {
+    const int factor = forloop->vectorize_info().factor;
+    if (!is_zero(forloop->min) || !forloop->extent.As<IntImm>()) return false;
+    const int extent = forloop->extent.as_int32();
+    if (extent <= factor || extent % factor == 0) return false;
+    const int main_extent = extent / factor * factor;
+
+    Var tail_var(cinn::common::UniqName(forloop->loop_var->name + "_t"));
+    Expr tail_body = ir::ir_utils::IRCopy(forloop->body);
+    cinn::ir::ir_utils::IrReplaceVarBroadcast(
+        &tail_body,
+        forloop->loop_var,
+        Expr(tail_var) + make_const(tail_var->type(), main_extent));
+    Expr tail_loop =
+        For::Make(tail_var,
+                  make_const(forloop->extent->type(), 0),
+                  make_const(forloop->extent->type(), extent - main_extent),
+                  ForType::Serial,
+                  forloop->device_api,
+                  tail_body);
+    forloop->extent = make_const(forloop->extent->type(), main_extent);
+    VLOG(2) << "Peel the tail of " << forloop->loop_var << " from " << extent
+            << " to " << main_extent;
+
+    Expr main_loop = *expr;
+    *expr = Block::Make({main_loop, tail_loop});
+    // the interval of the loop var is narrowed to the main forloop
+    var_intervals.erase(forloop->loop_var->name);
+    IRMutator::Visit(&expr->As<Block>()->stmts[0],
+                     &expr->As<Block>()->stmts[0]);
+    return true;
+  }
+
   //! Split the forloop with size \p factor.
   //! @return The new forloop.
   Expr SplitForLoop(For *forloop, int factor) {
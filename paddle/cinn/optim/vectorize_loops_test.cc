@@ -22,6 +22,7 @@
 #include "paddle/cinn/common/common.h"
 #include "paddle/cinn/common/ir_util.h"
 #include "paddle/cinn/ir/op/ir_operators.h"
+#include "paddle/cinn/ir/utils/ir_nodes_collector.h"
 #include "paddle/cinn/optim/ir_simplify.h"
 #include "paddle/cinn/optim/optimize.h"
 #include "paddle/cinn/optim/transform_polyfor_to_for.h"
@@ -233,6 +234,45 @@ TEST(Vectorize, single_for) {
   LOG(INFO) << "Forloop\n" << forloop;
 }
 
+TEST(Vectorize, peel_scalar_tail) {
+  Placeholder<float> A("A", std::vector<int>{{20}});
+  Placeholder<float> B("B", std::vector<int>{{20}});
+  Placeholder<float> C("C", std::vector<int>{{20}});
+
+  Var loop_var("k0");
+
+  Expr body = Store::Make(ir::Tensor(C),
+                          ir::Add::Make(  //
+                              ir::Load::Make(ir::Tensor(A), {Expr(loop_var)}),
+                              ir::Load::Make(ir::Tensor(B), {Expr(loop_var)})),
+                          {Expr(loop_var)});
+  body = ir::Block::Make({body});
+
+  VectorizeInfo vectorize_info(0, 8);
+  Expr forloop = ir::For::Make(loop_var,
+                               cinn::common::make_const(0),
+                               cinn::common::make_const(20),
+                               ir::ForType::Vectorized,
+                               ir::DeviceAPI::UNK,
+                               body,
+                               vectorize_info);
+
+  VectorizeLoops(&forloop, cinn::common::DefaultHostTarget());
+  LOG(INFO) << "Forloop\n" << forloop;
+
+  // the 16 elements are vectorized by 8 lanes and the 4 left are not
+  auto *block = forloop.As<ir::Block>();
+  ASSERT_TRUE(block);
+  ASSERT_EQ(block->stmts.size(), 2UL);
+  auto ramps = ir::ir_utils::CollectIRNodes(
+      block->stmts[0], [](const Expr *x) { return x->As<ir::Ramp>(); });
+  EXPECT_FALSE(ramps.empty());
+  auto *tail = block->stmts[1].As<ir::For>();
+  ASSERT_TRUE(tail);
+  EXPECT_TRUE(tail->is_serial());
+  EXPECT_EQ(tail->extent.as_int32(), 4);
+}
+
 TEST(Vectorize, cuda_vectorize) {
   Expr M(100);
   Expr N(500);
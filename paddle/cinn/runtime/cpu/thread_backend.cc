@@ -15,6 +15,8 @@
 #include "paddle/cinn/runtime/cpu/thread_backend.h"
 
 #include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
 #include <vector>
 
 #ifdef CINN_USE_OPENMP
@@ -43,6 +45,89 @@ int max_concurrency() {
   return std::max(max_concurrency, 1);
 }
 
+#ifndef CINN_USE_OPENMP
+namespace {
+
+// The workers running the tasks of the parallel lambdas without OpenMP, which
+// are created on the first launch needing them and kept across the launches.
+// The caller runs the task 0 itself and the worker i runs the task i + 1.
+class ParallelLauncher {
+ public:
+  static ParallelLauncher& Global() {
+    static ParallelLauncher launcher;
+    return launcher;
+  }
+
+  ~ParallelLauncher() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void Launch(FCINNParallelLambda flambda, void* datas, int num_task) {
+    std::lock_guard<std::mutex> launch_guard(launch_mutex_);
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      while (static_cast<int>(workers_.size()) < num_task - 1) {
+        int worker_id = workers_.size();
+        workers_.emplace_back([this, worker_id] { WorkerLoop(worker_id); });
+      }
+      flambda_ = flambda;
+      datas_ = datas;
+      num_task_ = num_task;
+      pending_ = num_task - 1;
+      ++generation_;
+    }
+    start_cv_.notify_all();
+    (*flambda)(0, num_task, datas);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_ == 0; });
+  }
+
+ private:
+  void WorkerLoop(int worker_id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // the worker created during a launch joins it
+    uint64_t seen = generation_ - 1;
+    while (true) {
+      start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_) return;
+      seen = generation_;
+      if (worker_id + 1 >= num_task_) continue;
+      FCINNParallelLambda flambda = flambda_;
+      void* datas = datas_;
+      int num_task = num_task_;
+      lock.unlock();
+      (*flambda)(worker_id + 1, num_task, datas);
+      lock.lock();
+      if (--pending_ == 0) {
+        done_cv_.notify_one();
+      }
+    }
+  }
+
+  // serializes the launches of the threads calling it at once
+  std::mutex launch_mutex_;
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  std::vector<std::thread> workers_;
+  FCINNParallelLambda flambda_{nullptr};
+  void* datas_{nullptr};
+  int num_task_{0};
+  int pending_{0};
+  uint64_t generation_{0};
+  bool stop_{false};
+};
+
+}  // namespace
+#endif  // CINN_USE_OPENMP
+
 int cinn_backend_parallel_launch(FCINNParallelLambda flambda,
                                  void* datas,
                                  int num_task) {
@@ -56,7 +141,11 @@ int cinn_backend_parallel_launch(FCINNParallelLambda flambda,
     (*flambda)(thread_num, num_task, datas);
   }
 #else
-  LOG(FATAL) << "CINN host parallel launch need OpenMP! Please check.";
+  if (num_task == 1) {
+    (*flambda)(0, num_task, datas);
+  } else {
+    ParallelLauncher::Global().Launch(flambda, datas, num_task);
+  }
 #endif  // CINN_USE_OPENMP
   return 0;
 }
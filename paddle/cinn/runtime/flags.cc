@@ -65,10 +65,36 @@ PD_DEFINE_bool(cinn_new_group_scheduler,
                BoolFromEnv("FLAGS_cinn_new_group_scheduler", false),
                "Whether to use new group scheduler.");
 
+PD_DEFINE_bool(cinn_group_schedule_row_cache,
+               BoolFromEnv("FLAGS_cinn_group_schedule_row_cache", true),
+               "Whether to keep the rows of the reduce-then-broadcast groups "
+               "on chip across the stages in the new group scheduler.");
+
+PD_DEFINE_bool(cinn_group_schedule_cpu_loops,
+               BoolFromEnv("FLAGS_cinn_group_schedule_cpu_loops", true),
+               "Whether to parallelize and vectorize the loops of the groups "
+               "on x86 in the new group scheduler.");
+
 PD_DEFINE_bool(cinn_bucket_compile,
                BoolFromEnv("FLAGS_cinn_bucket_compile", false),
                "Whether to enable bucket compile for dynamic shape.");
 
+PD_DEFINE_int32(cinn_compile_batch_size,
+                Int32FromEnv("FLAGS_cinn_compile_batch_size", 16),
+                "The number of groups compiled in one module, whose modules "
+                "are compiled in parallel. 0 compiles all the groups in one "
+                "module.");
+
+PD_DEFINE_bool(cinn_compile_timing_report,
+               BoolFromEnv("FLAGS_cinn_compile_timing_report", false),
+               "Whether to log the time of the lowering and the codegen of "
+               "the groups in the pir compiler.");
+
+PD_DEFINE_bool(cinn_reuse_group_kernel,
+               BoolFromEnv("FLAGS_cinn_reuse_group_kernel", true),
+               "Whether to compile the isomorphic groups, e.g. of the "
+               "repeated layers of a model, once and reuse their kernel.");
+
 PD_DEFINE_bool(cinn_use_common_subexpression_elimination,
                BoolFromEnv("FLAGS_cinn_use_common_subexpression_elimination",
                            false),
@@ -173,6 +199,13 @@ PD_DEFINE_string(
     "Specify the directory path of generated source code, which is "
     "used for debug.");
 
+PD_DEFINE_string(
+    cinn_compile_cache_dir,
+    StringFromEnv("FLAGS_cinn_compile_cache_dir", ""),
+    "Specify the directory to cache the compiled CUDA kernels across "
+    "processes. The kernels are keyed by their source code, the device "
+    "arch and the CUDA version. Empty means no cache.");
+
 PD_DEFINE_string(
     cinn_dump_group_lowered_func,
     StringFromEnv("FLAGS_cinn_dump_group_lowered_func", ""),
@@ -214,6 +247,16 @@ PD_DEFINE_bool(
     BoolFromEnv("FLAGS_enhance_vertical_fusion_with_recompute", true),
     "Whether to enhance check logic on vertical fusion with recompute");
 
+PD_DEFINE_bool(cinn_fuse_independent_groups,
+               BoolFromEnv("FLAGS_cinn_fuse_independent_groups", true),
+               "Whether to fuse the independent groups of the same loop space "
+               "into one kernel in the general fusion merge pass.");
+
+PD_DEFINE_int32(cinn_independent_fusion_max_ops,
+                Int32FromEnv("FLAGS_cinn_independent_fusion_max_ops", 64),
+                "The max number of the ops in a group fused from the "
+                "independent groups.");
+
 PD_DEFINE_bool(verbose_function_register,
                BoolFromEnv("FLAGS_verbose_function_register", false),
                "Whether to verbose function regist log. This will only work if "
@@ -114,6 +114,13 @@ class ProcessGroup {
         GetBackendName()));
   }
 
+  // Registers a buffer of the collectives, e.g. of memory::AllocCommShared,
+  // to the communicator, returns false if the backend can not register it.
+  virtual bool RegisterCommBuffer(
+      const std::shared_ptr<phi::Allocation>& allocation UNUSED) {
+    return false;
+  }
+
   // without stream APIs
   virtual std::shared_ptr<ProcessGroup::Task> AllGather(
       phi::DenseTensor* out_tensor UNUSED,
@@ -346,8 +346,13 @@ class AllreduceGlooTask : public ProcessGroupGloo::GlooTask {
 
   void _do_allreduce(std::vector<phi::DenseTensor>& ins,     // NOLINT
                      std::vector<phi::DenseTensor>& outs) {  // NOLINT
-    _comm_context->AllReduce(
-        &(outs[0]), ins[0], static_cast<int>(_reduce_op), _tag);
+    if (ins.size() == 1) {
+      _comm_context->AllReduce(
+          &(outs[0]), ins[0], static_cast<int>(_reduce_op), _tag);
+      return;
+    }
+    // the small tensors, e.g. the metrics, are fused into one allreduce
+    _comm_context->AllReduce(&outs, ins, static_cast<int>(_reduce_op), _tag);
   }
 };
 
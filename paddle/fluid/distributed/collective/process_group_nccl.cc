@@ -13,11 +13,19 @@
 // limitations under the License.
 
 #include "paddle/fluid/distributed/collective/process_group_nccl.h"
+
+#include <limits.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+
 #include "paddle/fluid/distributed/collective/common.h"
 #include "paddle/fluid/platform/cuda_device_guard.h"
 #include "paddle/fluid/platform/device/gpu/nccl_helper.h"
 #include "paddle/phi/api/lib/data_transform.h"
 #include "paddle/phi/api/lib/utils/allocator.h"
+#include "paddle/phi/api/profiler/event_tracing.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/core/distributed/check/nccl_dynamic_check.h"
@@ -36,6 +44,7 @@ PHI_DECLARE_bool(benchmark_nccl);
 PHI_DECLARE_bool(nccl_blocking_wait);
 PHI_DECLARE_bool(use_stream_safe_cuda_allocator);
 PHI_DECLARE_bool(enable_async_trace);
+PHI_DECLARE_int64(nccl_hierarchical_allreduce_threshold);
 
 // set this flag to `true` and recompile to enable dynamic checks
 constexpr bool FLAGS_enable_nccl_dynamic_check = false;
@@ -190,6 +199,29 @@ ncclComm_t ProcessGroupNCCL::NCCLComm(const Place& place) const {
   return iter->second->nccl_comm();
 }
 
+bool ProcessGroupNCCL::RegisterCommBuffer(
+    const std::shared_ptr<phi::Allocation>& allocation) {
+#ifdef PADDLE_WITH_NCCL_MEM_ALLOC
+  auto nccl_allocation =
+      std::dynamic_pointer_cast<memory::allocation::NCCLMemAllocation>(
+          allocation);
+  if (nccl_allocation == nullptr) {
+    return false;
+  }
+  const auto& key = GetKeyFromPlace(allocation->place());
+  const auto& iter = place_to_comm_ctx_.find(key);
+  if (iter != place_to_comm_ctx_.end()) {
+    nccl_allocation->Register(iter->second->nccl_comm());
+  } else {
+    // the communicator is created at the first collective on the place
+    place_to_pending_comm_buffers_[key].push_back(nccl_allocation);
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
 std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::AllGather(
     phi::DenseTensor* out_tensor,
     const phi::DenseTensor& in_tensor,
@@ -233,6 +265,39 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::AllReduce(
     bool use_calc_stream) {
   auto tensor_tmp =
       paddle::experimental::CheckAndTrans2NewContiguousTensor(in_tensor);
+  if (UseHierarchicalAllReduce(tensor_tmp)) {
+    return Collective(
+        [&](phi::distributed::NCCLCommContext* comm_context,
+            gpuStream_t stream) {
+          auto* intra_comm_context = this->GetCommContext(&intra_comm_key_);
+          auto* inter_comm_context = this->GetCommContext(&inter_comm_key_);
+          auto nccl_red_type = ToNCCLRedType(opts.reduce_op);
+          VLOG(3) << "[hierarchical ncclAllReduce] "
+                  << "sendbuff: " << tensor_tmp.data()
+                  << ", recvbuff: " << out_tensor->data()
+                  << ", count: " << tensor_tmp.numel()
+                  << ", redop: " << NCCLRedTypeToString(nccl_red_type)
+                  << ", local_rank: " << local_rank_
+                  << ", local_size: " << local_size_
+                  << ", node_rank: " << node_rank_
+                  << ", node_num: " << node_num_ << GetGroupMessage();
+
+          // The shard of this rank is reduced in place in out_tensor, so that
+          // the reduce scatter and the allgather are both in place when
+          // in_tensor is out_tensor.
+          int64_t shard_numel = tensor_tmp.numel() / local_size_;
+          auto shard = GetPartialTensor(
+              *out_tensor, local_rank_ * shard_numel, shard_numel);
+          intra_comm_context->ReduceScatter(
+              &shard, tensor_tmp, nccl_red_type, stream);
+          inter_comm_context->AllReduce(&shard, shard, nccl_red_type, stream);
+          intra_comm_context->AllGather(out_tensor, shard, stream);
+        },
+        tensor_tmp,
+        CommType::ALLREDUCE,
+        sync_op,
+        use_calc_stream);
+  }
   return Collective(
       [&](phi::distributed::NCCLCommContext* comm_context, gpuStream_t stream) {
         VLOG(3) << "[ncclAllReduce] "
@@ -694,6 +759,129 @@ void ProcessGroupNCCL::GetStoreKey(const std::string& place_key,
   place_to_group_key_[place_key] = *store_key;
 }
 
+void ProcessGroupNCCL::CreateHierarchicalCommContext(const Place& place) {
+  hierarchical_inited_ = true;
+  std::array<char, HOST_NAME_MAX> hostname{};
+  PADDLE_ENFORCE_EQ(
+      ::gethostname(hostname.data(), HOST_NAME_MAX),
+      0,
+      phi::errors::Fatal("Get hostname error for hierarchical allreduce."));
+  std::string host(hostname.data());
+  std::string host_key = "nccl_ids/" + std::to_string(gid_) + "/host/";
+  store_->set(host_key + std::to_string(rank_),
+              std::vector<uint8_t>(host.begin(), host.end()));
+
+  // the hosts of all the ranks in one batch, instead of a round trip each
+  std::vector<std::string> host_keys;
+  for (int rank = 0; rank < size_; ++rank) {
+    host_keys.emplace_back(host_key + std::to_string(rank));
+  }
+  auto hosts = store_->multi_get(host_keys);
+
+  // nodes are ordered by their first rank, and the ranks on a node by rank
+  std::vector<std::string> node_hosts;
+  std::vector<int> node_sizes;
+  for (int rank = 0; rank < size_; ++rank) {
+    std::string rank_host(hosts[rank].begin(), hosts[rank].end());
+    auto iter = std::find(node_hosts.begin(), node_hosts.end(), rank_host);
+    int node = iter - node_hosts.begin();
+    if (iter == node_hosts.end()) {
+      node_hosts.push_back(rank_host);
+      node_sizes.push_back(0);
+    }
+    if (rank == rank_) {
+      node_rank_ = node;
+      local_rank_ = node_sizes[node];
+    }
+    ++node_sizes[node];
+  }
+  node_num_ = static_cast<int>(node_hosts.size());
+  bool same_size =
+      std::all_of(node_sizes.begin(), node_sizes.end(), [&](int node_size) {
+        return node_size == node_sizes[0];
+      });
+  if (node_num_ < 2 || node_sizes[0] < 2 || !same_size) {
+    VLOG(3) << "hierarchical allreduce is disabled for gid: " << gid_
+            << ", node_num: " << node_num_ << ", same local size: "
+            << same_size;
+    return;
+  }
+  local_size_ = node_sizes[0];
+
+  // all the ranks create the intra node communicator first, so that the
+  // inits of the inter node communicators do not wait for each other
+  intra_comm_key_ = "nccl_ids/" + std::to_string(gid_) + "/intra/" +
+                    std::to_string(node_rank_);
+  inter_comm_key_ = "nccl_ids/" + std::to_string(gid_) + "/inter/" +
+                    std::to_string(local_rank_);
+  platform::CUDADeviceGuard cuda_guard(place);
+  phi::distributed::CommContextManager::CreateNCCLCommContext(
+      store_, intra_comm_key_, local_rank_, local_size_);
+  phi::distributed::CommContextManager::CreateNCCLCommContext(
+      store_, inter_comm_key_, node_rank_, node_num_);
+  VLOG(3) << "init hierarchical allreduce for gid: " << gid_
+          << ", local_rank: " << local_rank_ << ", local_size: " << local_size_
+          << ", node_rank: " << node_rank_ << ", node_num: " << node_num_;
+}
+
+bool ProcessGroupNCCL::SplitCommContext(const std::vector<int>& ranks,
+                                        ProcessGroupNCCL* group) {
+#if defined(PADDLE_WITH_NCCL) && NCCL_VERSION_CODE >= 21800
+  auto iter = std::find(ranks.begin(), ranks.end(), rank_);
+  PADDLE_ENFORCE_EQ(
+      iter != ranks.end(),
+      group != nullptr,
+      phi::errors::InvalidArgument("The process group of the new group must "
+                                   "be given on its ranks and only on them."));
+  const auto place = phi::GPUPlace(phi::backends::gpu::GetCurrentDeviceId());
+  const auto& key = GetKeyFromPlace(place);
+  platform::CUDADeviceGuard cuda_guard(place);
+
+  std::string store_key;
+  GetStoreKey(key, CommType::ALLREDUCE, &store_key);
+  if (place_to_comm_ctx_.find(key) == place_to_comm_ctx_.end()) {
+    CreateNCCLEnvCache(place, key, store_key, CommType::ALLREDUCE);
+  }
+  // the versions of the ranks are the same, so that they all return here
+  if (GetCommContext(&store_key)->GetNcclVersion() < 21800) {
+    return false;
+  }
+
+  std::string split_key;
+  int split_rank = -1;
+  if (group != nullptr) {
+    split_rank = static_cast<int>(iter - ranks.begin());
+    group->GetStoreKey(key, CommType::ALLREDUCE, &split_key);
+  }
+  phi::distributed::CommContextManager::SplitNCCLCommContext(
+      store_key, split_key, split_rank, static_cast<int>(ranks.size()));
+  if (group != nullptr &&
+      group->place_to_comm_ctx_.find(key) == group->place_to_comm_ctx_.end()) {
+    // the env cache takes the split communicator of split_key
+    group->CreateNCCLEnvCache(place, key, split_key, CommType::ALLREDUCE);
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool ProcessGroupNCCL::UseHierarchicalAllReduce(
+    const phi::DenseTensor& tensor) {
+  if (FLAGS_nccl_hierarchical_allreduce_threshold <= 0 ||
+      s_group_call_counter > 0) {
+    return false;
+  }
+  int64_t nbytes = tensor.numel() * phi::SizeOf(tensor.dtype());
+  if (nbytes < FLAGS_nccl_hierarchical_allreduce_threshold) {
+    return false;
+  }
+  if (!hierarchical_inited_) {
+    CreateHierarchicalCommContext(tensor.place());
+  }
+  return local_size_ > 0 && tensor.numel() % local_size_ == 0;
+}
+
 void ProcessGroupNCCL::CreateNCCLEnvCache(const Place& place,
                                           const std::string& place_key,
                                           const std::string& store_key,
@@ -782,6 +970,18 @@ void ProcessGroupNCCL::CreateNCCLEnvCache(const Place& place,
   place_to_calc_ctx_.emplace(place_key, calc_ctx);
   place_to_comm_ctx_.emplace(place_key, std::move(comm_ctx));
 
+#ifdef PADDLE_WITH_NCCL_MEM_ALLOC
+  auto buffers_iter = place_to_pending_comm_buffers_.find(place_key);
+  if (buffers_iter != place_to_pending_comm_buffers_.end()) {
+    for (const auto& buffer : buffers_iter->second) {
+      if (auto allocation = buffer.lock()) {
+        allocation->Register(nccl_comm_ctx->GetNcclComm());
+      }
+    }
+    place_to_pending_comm_buffers_.erase(buffers_iter);
+  }
+#endif
+
   for (size_t i = 0; i < s_group_call_counter; ++i) {
     NCCL_CHECK(phi::dynload::ncclGroupStart());
   }
@@ -831,10 +1031,14 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
 
   auto nccl_comm_ctx = this->GetCommContext(&store_key);
 
+  std::string group_key = place_to_group_key_.at(key);
+  phi::RecordEvent comm_event(
+      phi::distributed::CommTraceName("NCCL", group_key, comm_type, comm_seq_),
+      phi::TracerEventType::Communication,
+      1);
   if (!FLAGS_enable_async_trace) {
     fn(nccl_comm_ctx, nccl_stream);
   } else {
-    std::string group_key = place_to_group_key_.at(key);
     auto comm_task =
         std::make_shared<phi::distributed::NCCLCommTask>(place,
                                                          group_key,
@@ -849,6 +1053,8 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
                                                          nccl_stream,
                                                          comm_type,
                                                          pg_timeout_);
+    comm_task->SetBytes(tensor_tmp.numel() *
+                        phi::SizeOf(tensor_tmp.dtype()));
     comm_task->StartRecord();
     fn(nccl_comm_ctx, nccl_stream);
     comm_task->EndRecord();
@@ -857,6 +1063,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
     auto& comm_task_manager = phi::distributed::CommTaskManager::GetInstance();
     comm_task_manager.CommTaskEnqueue(std::move(comm_task));
   }
+  comm_event.End();
 
   if (!use_calc_stream) {
     if (FLAGS_use_stream_safe_cuda_allocator) {
@@ -958,9 +1165,13 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Point2Point(
                                                        nccl_stream,
                                                        comm_type,
                                                        pg_timeout_);
+  comm_task->SetBytes(tensor_tmp.numel() * phi::SizeOf(tensor_tmp.dtype()));
 
   auto nccl_comm_ctx = this->GetCommContext(&store_key);
 
+  phi::RecordEvent comm_event(comm_task->TraceName(),
+                              phi::TracerEventType::Communication,
+                              1);
   if (!FLAGS_enable_async_trace) {
     fn(nccl_comm_ctx, nccl_stream, p2p_target_rank);
   } else {
@@ -972,6 +1183,7 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Point2Point(
     auto& comm_task_manager = phi::distributed::CommTaskManager::GetInstance();
     comm_task_manager.CommTaskEnqueue(std::move(comm_task));
   }
+  comm_event.End();
 
   if (!use_calc_stream) {
     if (FLAGS_use_stream_safe_cuda_allocator) {
@@ -22,6 +22,7 @@
 
 #include "paddle/fluid/distributed/collective/process_group.h"
 #include "paddle/fluid/distributed/collective/process_group_with_stream.h"
+#include "paddle/fluid/memory/allocation/nccl_mem_allocator.h"
 #include "paddle/fluid/platform/device_event.h"
 #include "paddle/phi/backends/gpu/forwards.h"
 #include "paddle/phi/common/place.h"
@@ -177,6 +178,20 @@ class ProcessGroupNCCL final : public ProcessGroupWithStream {
 
   ncclComm_t NCCLComm(const Place& place) const;
 
+  // Registers an allocation of ncclMemAlloc to the communicator of its place,
+  // at once or at the creation of the communicator.
+  bool RegisterCommBuffer(
+      const std::shared_ptr<phi::Allocation>& allocation) override;
+
+  // Creates the communicator of the group of the ranks of this group by
+  // splitting the one of this group, instead of on the first use of the group
+  // through the store. All the ranks of this group call it together, with
+  // the process group of the new group on its ranks and nullptr on the
+  // others. Returns false if the split is not supported, then nothing is
+  // created.
+  bool SplitCommContext(const std::vector<int>& ranks,
+                        ProcessGroupNCCL* group);
+
  private:
   std::shared_ptr<ProcessGroupNCCL::NCCLTask> CreateTask(const Place& place,
                                                          int rank,
@@ -216,6 +231,12 @@ class ProcessGroupNCCL final : public ProcessGroupWithStream {
   phi::distributed::NCCLCommContext* GetCommContext(
       const std::string* key = nullptr);
 
+  // Group the ranks by host and create the intra node and inter node
+  // communicators of the hierarchical allreduce, once.
+  void CreateHierarchicalCommContext(const Place& place);
+
+  bool UseHierarchicalAllReduce(const phi::DenseTensor& tensor);
+
   void EraseTensorHolders() {
     for (const auto& allocation_stream : allocation_stream_pairs) {
       auto holder_ptr = allocation_stream.first.lock();
@@ -241,6 +262,23 @@ class ProcessGroupNCCL final : public ProcessGroupWithStream {
   uint64_t comm_seq_{0};
   std::unordered_map<std::string, uint64_t> p2p_comm_seq_;
   std::unordered_map<std::string, std::string> place_to_group_key_;
+#ifdef PADDLE_WITH_NCCL_MEM_ALLOC
+  // the buffers to register to the communicators once they are created
+  std::unordered_map<
+      std::string,
+      std::vector<std::weak_ptr<memory::allocation::NCCLMemAllocation>>>
+      place_to_pending_comm_buffers_;
+#endif
+
+  // hierarchical allreduce, local_size_ is 0 if the ranks of the group are
+  // not on several nodes with the same number of ranks each
+  bool hierarchical_inited_{false};
+  int local_rank_{0};
+  int local_size_{0};
+  int node_rank_{0};
+  int node_num_{0};
+  std::string intra_comm_key_;
+  std::string inter_comm_key_;
 
   // TODO(sunyilun): attrs below will be removed later
   std::mutex mutex_;
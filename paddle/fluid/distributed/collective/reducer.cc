@@ -13,13 +13,21 @@
 // limitations under the License.
 
 #include "paddle/fluid/distributed/collective/reducer.h"
+
+#include <algorithm>
+#include <numeric>
+
 #include "paddle/phi/api/lib/data_transform.h"
 #include "paddle/phi/backends/device_guard.h"
 #include "paddle/phi/backends/device_manager.h"
 #include "paddle/phi/core/flags.h"
+#include "paddle/phi/kernels/cast_kernel.h"
 
 PD_DECLARE_bool(use_stream_safe_cuda_allocator);
 PHI_DECLARE_string(allocator_strategy);
+PHI_DECLARE_int32(eager_reducer_rebuild_group_steps);
+PHI_DECLARE_string(eager_reducer_comm_dtype);
+PHI_DECLARE_bool(eager_reducer_use_comm_buffer);
 
 namespace paddle {
 namespace distributed {
@@ -367,16 +375,69 @@ void SplitTensorsWithType<platform::XPUDeviceContext>(
 }
 #endif
 
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+// Each float32 tensor is casted into its slice of p_dense_contents directly,
+// so that the concat and the cast take one pass over the gradients.
+template <typename DeviceContext>
+static void CastConcatTensors(
+    const DeviceContext &context,
+    const std::vector<phi::DenseTensor> &dense_tensors_,
+    Tensor *p_dense_contents) {
+  auto *out =
+      std::dynamic_pointer_cast<phi::DenseTensor>(p_dense_contents->impl())
+          .get();
+  int64_t offset = 0;
+  for (const auto &tensor : dense_tensors_) {
+    const auto length = tensor.numel();
+    phi::DenseTensor slice = out->Slice(offset, offset + length);
+    phi::CastKernel<float>(context, tensor, out->dtype(), &slice);
+    offset += length;
+  }
+}
+
+template <typename DeviceContext>
+static void CastSplitTensors(const DeviceContext &context,
+                             Tensor *p_dense_contents,
+                             std::vector<phi::DenseTensor> *p_dense_tensors) {
+  auto *in =
+      std::dynamic_pointer_cast<phi::DenseTensor>(p_dense_contents->impl())
+          .get();
+  int64_t offset = 0;
+  for (auto &tensor : *p_dense_tensors) {
+    const auto length = tensor.numel();
+    phi::DenseTensor slice = in->Slice(offset, offset + length);
+    if (in->dtype() == phi::DataType::FLOAT16) {
+      phi::CastKernel<platform::float16>(
+          context, slice, tensor.dtype(), &tensor);
+    } else {
+      phi::CastKernel<platform::bfloat16>(
+          context, slice, tensor.dtype(), &tensor);
+    }
+    offset += length;
+  }
+}
+#endif
+
 void EagerGroup::ConcatTensors(const platform::Place &place) {
-  dense_contents_ =
-      paddle::experimental::empty(IntArray({all_length_}), dtype_, place);
+  if (comm_buffer_ != nullptr) {
+    dense_contents_.set_impl(std::make_shared<phi::DenseTensor>(
+        comm_buffer_,
+        phi::DenseTensorMeta(comm_dtype_, common::make_ddim({all_length_}))));
+  } else {
+    dense_contents_ = paddle::experimental::empty(
+        IntArray({all_length_}), comm_dtype_, place);
+  }
 
   if (platform::is_gpu_place(place)) {
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
     auto *default_ctx = static_cast<phi::GPUContext *>(
         platform::DeviceContextPool::Instance().Get(place));
-    ConcatTensorsWithType(
-        *default_ctx, dense_tensors_, &dense_contents_, dtype_);
+    if (comm_dtype_ != dtype_) {
+      CastConcatTensors(*default_ctx, dense_tensors_, &dense_contents_);
+    } else {
+      ConcatTensorsWithType(
+          *default_ctx, dense_tensors_, &dense_contents_, dtype_);
+    }
 #else
     PADDLE_THROW(platform::errors::PermissionDenied(
         "Paddle can't concat grad tensors since it's not compiled with NCCL,"
@@ -421,8 +482,12 @@ void EagerGroup::SplitTensors(const platform::DeviceContext &context) {
   if (platform::is_gpu_place(place)) {
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
     auto &gpu_context = static_cast<const phi::GPUContext &>(context);
-    SplitTensorsWithType(
-        gpu_context, &dense_contents_, &dense_tensors_, dtype_);
+    if (comm_dtype_ != dtype_) {
+      CastSplitTensors(gpu_context, &dense_contents_, &dense_tensors_);
+    } else {
+      SplitTensorsWithType(
+          gpu_context, &dense_contents_, &dense_tensors_, dtype_);
+    }
     if (IsStreamSafeAllocator()) {
       auto dense_tensor =
           std::dynamic_pointer_cast<phi::DenseTensor>(dense_contents_.impl());
@@ -487,6 +552,19 @@ EagerReducer::EagerReducer(
 
   nranks_ = process_group_->GetSize();
 
+  if (FLAGS_eager_reducer_comm_dtype == "float16") {
+    comm_dtype_ = phi::DataType::FLOAT16;
+  } else if (FLAGS_eager_reducer_comm_dtype == "bfloat16") {
+    comm_dtype_ = phi::DataType::BFLOAT16;
+  } else {
+    PADDLE_ENFORCE_EQ(FLAGS_eager_reducer_comm_dtype.empty(),
+                      true,
+                      platform::errors::InvalidArgument(
+                          "FLAGS_eager_reducer_comm_dtype should be float16 or "
+                          "bfloat16, but received %s.",
+                          FLAGS_eager_reducer_comm_dtype));
+  }
+
   // initialize groups
   InitializeGroups(group_indices);
 
@@ -513,6 +591,15 @@ EagerReducer::EagerReducer(
   vars_marked_ready_.resize(tensors_.size(), false);
   local_used_vars_.resize(tensors_.size(), 0);
 
+  // the sparse gradients are always in their own groups
+  rebuild_group_steps_ = FLAGS_eager_reducer_rebuild_group_steps;
+  has_rebuilt_group_ =
+      rebuild_group_steps_ <= 0 ||
+      std::all_of(groups_.begin(), groups_.end(), [](const EagerGroup &group) {
+        return group.is_sparse_;
+      });
+  ready_order_sum_.resize(tensors_.size(), 0);
+
   if (find_unused_vars_each_step_) {
     global_used_vars_ = paddle::experimental::empty(
         IntArray({static_cast<int32_t>(tensors_.size())}),
@@ -625,6 +712,13 @@ void EagerReducer::InitializeDenseGroups(
     }
   }
   p_group->all_length_ = all_length;
+  // only the float32 gradients on gpu are casted for the allreduce
+  p_group->comm_dtype_ = p_group->dtype_;
+  if (comm_dtype_ != phi::DataType::UNDEFINED &&
+      p_group->dtype_ == phi::DataType::FLOAT32 &&
+      platform::is_gpu_place(inner_place_)) {
+    p_group->comm_dtype_ = comm_dtype_;
+  }
 }
 
 void EagerReducer::TraverseBackwardGraph(const std::vector<Tensor> &outputs) {
@@ -681,6 +775,7 @@ void EagerReducer::PrepareForBackward(const std::vector<Tensor> &outputs) {
   grad_need_hooks_ = true;
 
   next_group_ = 0;
+  ready_count_ = 0;
   std::for_each(groups_.begin(), groups_.end(), [](EagerGroup &group) {
     group.pending_ = group.tensor_indices_.size();
     group.sparse_contents_ = Tensor();
@@ -770,6 +865,11 @@ void EagerReducer::AddDistHook(size_t var_index) {
 
   local_used_vars_[var_index] = 1;
 
+  // record the ready order to rebuild groups
+  if (NeedRebuildGroup()) {
+    ready_order_sum_[var_index] += ready_count_++;
+  }
+
   if (!has_marked_unused_vars_) {
     has_marked_unused_vars_ = true;
     for (const auto unused_index : unused_vars_) {
@@ -1061,9 +1161,67 @@ void EagerReducer::FinalizeBackward() {
     VLOG(3) << "ProcessUnusedDenseVars is finished.";
   }
 
+  if (NeedRebuildGroup()) {
+    if (ready_count_ != tensors_.size()) {
+      LOG(WARNING) << "Only " << ready_count_ << " of " << tensors_.size()
+                   << " gradients are ready in the step, EagerReducer will "
+                      "not rebuild groups.";
+      has_rebuilt_group_ = true;
+    } else if (++ready_order_steps_ == rebuild_group_steps_) {
+      VLOG(3) << "Start rebuilding the groups";
+      group_indices_ = RebuildGroups();
+      InitializeGroups(group_indices_);
+    }
+  }
+
   VLOG(3) << "In the batch, Reducer is finished.";
 }
 
+std::vector<std::vector<size_t>> EagerReducer::RebuildGroups() {
+  has_rebuilt_group_ = true;
+  // the earlier the gradient is ready on average, the earlier its group is
+  std::vector<int64_t> ready_order(tensors_.size());
+  std::iota(ready_order.begin(), ready_order.end(), 0);
+  std::stable_sort(ready_order.begin(),
+                   ready_order.end(),
+                   [this](int64_t x, int64_t y) {
+                     return ready_order_sum_[x] < ready_order_sum_[y];
+                   });
+  ready_order_sum_.clear();
+
+  // all the ranks should build the same groups, use the order of rank 0
+  const auto *dev_ctx =
+      platform::DeviceContextPool::Instance().Get(inner_place_);
+  Tensor order_tensor = paddle::experimental::empty(
+      IntArray({static_cast<int64_t>(ready_order.size())}),
+      DataType::INT64,
+      inner_place_);
+  auto *order_dense_tensor =
+      std::dynamic_pointer_cast<phi::DenseTensor>(order_tensor.impl()).get();
+  framework::TensorFromVector<int64_t>(
+      ready_order, *dev_ctx, order_dense_tensor);
+  distributed::BroadcastOptions opts;
+  opts.source_rank = 0;
+  std::vector<phi::DenseTensor> in_out = {*order_dense_tensor};
+  process_group_->Broadcast(in_out, in_out, opts)->Synchronize();
+  framework::TensorToVector<int64_t>(in_out[0], *dev_ctx, &ready_order);
+  dev_ctx->Wait();
+  VLOG(3) << "The order of gradient ready: "
+          << string::join_strings(ready_order, ',');
+
+  // the small group of group_size_limits_[0] is at the end of backward
+  std::reverse(ready_order.begin(), ready_order.end());
+  std::vector<Tensor> rebuild_tensors;
+  rebuild_tensors.reserve(ready_order.size());
+  for (const auto index : ready_order) {
+    rebuild_tensors.push_back(tensors_[index]);
+  }
+  auto rebuild_group_indices = Eager_AssignGroupBySize(
+      rebuild_tensors, is_sparse_gradient_, group_size_limits_, ready_order);
+  std::reverse(rebuild_group_indices.begin(), rebuild_group_indices.end());
+  return rebuild_group_indices;
+}
+
 void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
                                           const int curr_group_index) {
   // The overall timeline: concat > div_nranks > allreduce > split
@@ -1072,6 +1230,20 @@ void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
 
   VLOG(3) << "group [" << curr_group_index << "] start fused_allreduce.";
 
+#if defined(PADDLE_WITH_CUDA)
+  if (FLAGS_eager_reducer_use_comm_buffer &&
+      platform::is_gpu_place(inner_place_) && group->comm_buffer_ == nullptr) {
+    group->comm_buffer_ = memory::AllocCommShared(
+        platform::CUDAPlace(inner_place_.GetDeviceId()),
+        group->all_length_ * phi::SizeOf(group->comm_dtype_));
+    if (!process_group_->RegisterCommBuffer(group->comm_buffer_)) {
+      VLOG(3) << "The communicator can not register the buffer of group ["
+              << curr_group_index << "], it is allocated each step.";
+      group->comm_buffer_.reset();
+    }
+  }
+#endif
+
   // concat tensors
   group->ConcatTensors(inner_place_);
 
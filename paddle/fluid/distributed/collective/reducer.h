@@ -65,10 +65,17 @@ class EagerGroup {
 
   // external message of group
   phi::DataType dtype_;
+  // dtype of dense_contents_, the gradients are casted to it in concat and
+  // back to dtype_ in split if it differs from dtype_
+  phi::DataType comm_dtype_;
 
   // help to sync
   std::shared_ptr<ProcessGroup::Task> task;
 
+  // the buffer of dense_contents_ registered to the communicator, which is
+  // kept across the steps, or nullptr to allocate dense_contents_ each step
+  std::shared_ptr<phi::Allocation> comm_buffer_;
+
   // context is used to select the stream for concat
   void ConcatTensors(const platform::Place &);
 
@@ -112,6 +119,7 @@ class EagerReducer {
   void TraverseBackwardGraph(const std::vector<Tensor> &outputs);
   void ProcessUnusedDenseVars();
   bool HasGrad(size_t var_index);
+  std::vector<std::vector<size_t>> RebuildGroups();
 
  private:
   std::vector<Tensor> tensors_;
@@ -139,6 +147,20 @@ class EagerReducer {
   bool find_unused_vars_once_{true};
   bool groups_need_finalize_{false};
   Tensor global_used_vars_;
+
+  // Following variables are to help rebuild groups by the order in which
+  // the gradients are ready, see FLAGS_eager_reducer_rebuild_group_steps
+  inline bool NeedRebuildGroup() {
+    return !has_rebuilt_group_ && !find_unused_vars_each_step_;
+  }
+  bool has_rebuilt_group_{true};
+  int rebuild_group_steps_{0};
+  int ready_order_steps_{0};
+  size_t ready_count_{0};
+  std::vector<int64_t> ready_order_sum_;
+
+  // FLAGS_eager_reducer_comm_dtype, UNDEFINED if it is not set
+  phi::DataType comm_dtype_{phi::DataType::UNDEFINED};
 };
 
 }  //  namespace distributed
@@ -248,6 +248,55 @@ bool Carrier::Send(const InterceptorMessage& msg) {
   return GlobalVal<MessageBus>::Get()->Send(dst_rank, msg);
 }
 
+void Carrier::PutActivations(
+    int64_t src_id,
+    int64_t dst_id,
+    int64_t scope_idx,
+    std::vector<std::pair<std::string, phi::DenseTensor>>&& vars) {
+  std::lock_guard<std::mutex> lock(activations_mutex_);
+  auto& slots = activation_buffers_[std::make_pair(src_id, dst_id)];
+  if (slots.empty()) {
+    // the buffer of the edge is registered on the first put, with a slot for
+    // every micro batch
+    slots.resize(std::max<size_t>(microbatch_scopes_.size(), 1));
+  }
+  if (static_cast<size_t>(scope_idx) >= slots.size()) {
+    slots.resize(scope_idx + 1);
+  }
+  auto& slot = slots[scope_idx];
+  // a downstream not taking the vars, e.g. a sink, leaves them until the
+  // next put of the slot
+  if (slot.filled) {
+    VLOG(3) << "Replace the activations of scope " << scope_idx
+            << " from interceptor " << src_id << " to " << dst_id
+            << " not taken.";
+  }
+  slot.vars = std::move(vars);
+  slot.filled = true;
+}
+
+std::vector<std::pair<std::string, phi::DenseTensor>>
+Carrier::TakeActivations(int64_t src_id, int64_t dst_id, int64_t scope_idx) {
+  std::lock_guard<std::mutex> lock(activations_mutex_);
+  auto iter = activation_buffers_.find(std::make_pair(src_id, dst_id));
+  PADDLE_ENFORCE_EQ(
+      iter != activation_buffers_.end() &&
+          static_cast<size_t>(scope_idx) < iter->second.size() &&
+          iter->second[scope_idx].filled,
+      true,
+      platform::errors::NotFound(
+          "Cannot find the activations of scope %lld from interceptor %lld "
+          "to %lld.",
+          scope_idx,
+          src_id,
+          dst_id));
+  auto& slot = iter->second[scope_idx];
+  auto vars = std::move(slot.vars);
+  slot.vars.clear();
+  slot.filled = false;
+  return vars;
+}
+
 Interceptor* Carrier::SetInterceptor(int64_t interceptor_id,
                                      std::unique_ptr<Interceptor> interceptor) {
   auto iter = interceptor_idx_to_interceptor_.find(interceptor_id);
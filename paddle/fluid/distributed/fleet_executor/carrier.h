@@ -15,11 +15,13 @@
 #pragma once
 
 #include <condition_variable>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/distributed/fleet_executor/interceptor.h"
@@ -31,6 +33,7 @@
 #include "paddle/fluid/platform/errors.h"
 #include "paddle/fluid/platform/macros.h"
 #include "paddle/fluid/platform/place.h"
+#include "paddle/phi/core/dense_tensor.h"
 
 namespace paddle {
 namespace framework {
@@ -89,6 +92,23 @@ class Carrier final {
 
   bool Send(const InterceptorMessage& msg);
 
+  // Whether the interceptor is in this carrier.
+  bool IsLocal(int64_t interceptor_id) const {
+    return GetRank(interceptor_id) == rank_;
+  }
+
+  // The zero copy data path between the interceptors of this carrier. The
+  // upstream puts the vars of a micro batch into the circular buffer of the
+  // edge, whose slots are the micro batches, and the downstream takes them,
+  // sharing the allocations instead of serializing the tensors. Thread-safe.
+  void PutActivations(
+      int64_t src_id,
+      int64_t dst_id,
+      int64_t scope_idx,
+      std::vector<std::pair<std::string, phi::DenseTensor>>&& vars);
+  std::vector<std::pair<std::string, phi::DenseTensor>> TakeActivations(
+      int64_t src_id, int64_t dst_id, int64_t scope_idx);
+
  private:
   DISABLE_COPY_AND_ASSIGN(Carrier);
   Carrier() = delete;
@@ -119,6 +139,15 @@ class Carrier final {
   int thread_num_;
   TaskLoopThreadPool thread_pool_;
   std::unordered_set<int64_t> interceptor_ids_;
+
+  struct ActivationSlot {
+    bool filled{false};
+    std::vector<std::pair<std::string, phi::DenseTensor>> vars;
+  };
+  std::mutex activations_mutex_;
+  // (src_id, dst_id) -> the slots of the micro batches
+  std::map<std::pair<int64_t, int64_t>, std::vector<ActivationSlot>>
+      activation_buffers_;
 };
 
 }  // namespace distributed
@@ -56,6 +56,18 @@ void ComputeInterceptor::DecodeMsgVars(const InterceptorMessage& msg) {
                         microbatch_scopes_.size(),
                         scope_id));
   auto* scope = microbatch_scopes_[scope_id];
+  if (msg.zero_copy()) {
+    auto vars =
+        carrier_->TakeActivations(msg.src_id(), interceptor_id_, scope_id);
+    for (auto& var : vars) {
+      // shares the allocation of the upstream
+      *scope->Var(var.first)->GetMutable<phi::DenseTensor>() =
+          std::move(var.second);
+      VLOG(3) << "Share vars " << var.first << " in scope " << scope_id
+              << " from interceptor " << msg.src_id();
+    }
+    return;
+  }
   platform::DeviceContextPool& pool = platform::DeviceContextPool::Instance();
   for (const auto& var_iter : msg.vars_list()) {
     const std::string& name = var_iter.name();
@@ -71,6 +83,29 @@ void ComputeInterceptor::DecodeMsgVars(const InterceptorMessage& msg) {
   }
 }
 
+std::vector<std::pair<std::string, phi::DenseTensor>>
+ComputeInterceptor::CollectVars() {
+  PADDLE_ENFORCE_LT(cur_scope_id_,
+                    microbatch_scopes_.size(),
+                    platform::errors::InvalidArgument(
+                        "Step out of range. There are %ld "
+                        "microbatch_scopes, but recevice scope index %ld",
+                        microbatch_scopes_.size(),
+                        cur_scope_id_));
+  auto* scope = microbatch_scopes_[cur_scope_id_];
+  std::vector<std::pair<std::string, phi::DenseTensor>> vars;
+  for (auto const& iter : node_->vars_to_dtype()) {
+    const auto& var_name = iter.first;
+    auto* var = scope->FindVar(var_name);
+    PADDLE_ENFORCE(
+        var,
+        platform::errors::NotFound(
+            "Variable %s not exists in scope %ld", var_name, cur_scope_id_));
+    vars.emplace_back(var_name, var->Get<phi::DenseTensor>());
+  }
+  return vars;
+}
+
 InterceptorMessage ComputeInterceptor::PrepareVarsMsg() {
   PADDLE_ENFORCE_LT(cur_scope_id_,
                     microbatch_scopes_.size(),
@@ -229,12 +264,24 @@ void ComputeInterceptor::SendDataReadyToDownStream() {
   InterceptorMessage ready_msg;
   ready_msg.set_start_micro_step(start_micro_step_);
   ready_msg.set_num_micro_step(num_micro_step_);
-  if (need_send_vars) {
+  // the vars are serialized only for the downstreams in the other carriers
+  bool need_serialize_vars = false;
+  for (auto& outs : out_buffs_) {
+    need_serialize_vars =
+        need_serialize_vars || !carrier_->IsLocal(outs.first);
+  }
+  if (need_send_vars && need_serialize_vars) {
     ready_msg = PrepareVarsMsg();
   } else {
     ready_msg.set_message_type(DATA_IS_READY);
     ready_msg.set_scope_idx(cur_scope_id_);
   }
+  InterceptorMessage zero_copy_msg;
+  if (need_send_vars) {
+    zero_copy_msg.set_message_type(DATA_WITH_VARS);
+    zero_copy_msg.set_scope_idx(cur_scope_id_);
+    zero_copy_msg.set_zero_copy(true);
+  }
   for (auto& outs : out_buffs_) {
     auto down_id = outs.first;
     auto max_buff_size = outs.second.first;
@@ -253,7 +300,14 @@ void ComputeInterceptor::SendDataReadyToDownStream() {
     }
     outs.second.second = used_size;
 
-    if (need_send_vars) {
+    if (need_send_vars && carrier_->IsLocal(down_id)) {
+      VLOG(3) << "ComputeInterceptor " << interceptor_id_
+              << " Send zero copy data_with_vars msg to " << down_id
+              << " in scope: " << cur_scope_id_;
+      carrier_->PutActivations(
+          interceptor_id_, down_id, cur_scope_id_, CollectVars());
+      Send(down_id, zero_copy_msg);
+    } else if (need_send_vars) {
       VLOG(3) << "ComputeInterceptor " << interceptor_id_
               << " Send data_with_vars msg to " << down_id
               << " in scope: " << cur_scope_id_;
@@ -15,7 +15,9 @@
 #pragma once
 
 #include <queue>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "paddle/fluid/distributed/fleet_executor/interceptor.h"
 
@@ -48,6 +50,8 @@ class ComputeInterceptor : public Interceptor {
  private:
   void PrepareDeps();
   InterceptorMessage PrepareVarsMsg();
+  // The vars to send in the current scope, sharing their allocations.
+  std::vector<std::pair<std::string, phi::DenseTensor>> CollectVars();
   void DecodeMsgVars(const InterceptorMessage& msg);
 
   bool IsInputReady();
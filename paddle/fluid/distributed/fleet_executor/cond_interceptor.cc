@@ -15,6 +15,7 @@
 #include "paddle/fluid/distributed/fleet_executor/cond_interceptor.h"
 #include <algorithm>
 #include "paddle/common/errors.h"
+#include "paddle/fluid/distributed/fleet_executor/carrier.h"
 #include "paddle/fluid/distributed/fleet_executor/task_node.h"
 #include "paddle/fluid/framework/executor_gc_helper.h"
 #include "paddle/fluid/framework/operator.h"
@@ -165,6 +166,10 @@ void CondInterceptor::Run(const InterceptorMessage& msg) {
     }
   } else if (msg.message_type() == DATA_WITH_VARS) {
     int64_t scope_id = msg.scope_idx();
+    if (msg.zero_copy()) {
+      // the vars are in the scopes of this carrier already
+      carrier_->TakeActivations(msg.src_id(), interceptor_id_, scope_id);
+    }
     PADDLE_ENFORCE_NE(
         scope_id_to_gen_step_.find(scope_id),
         scope_id_to_gen_step_.end(),
@@ -19,6 +19,10 @@
 namespace paddle {
 namespace distributed {
 
+// The instances sampled by a thread at least, smaller batches are sampled
+// by the calling thread.
+constexpr size_t kMinInstancesPerThread = 256;
+
 std::vector<std::vector<uint64_t>> LayerWiseSampler::sample(
     const std::vector<std::vector<uint64_t>>& user_inputs,
     const std::vector<uint64_t>& target_ids,
@@ -29,49 +33,91 @@ std::vector<std::vector<uint64_t>> LayerWiseSampler::sample(
       input_num * layer_counts_sum_,
       std::vector<uint64_t>(user_feature_num + 2));
 
+  // Check the targets here, the enforce can't be thrown from the workers.
+  for (auto id : target_ids) {
+    PADDLE_ENFORCE_NE(tree_->id_codes_map_.find(id),
+                      tree_->id_codes_map_.end(),
+                      paddle::platform::errors::InvalidArgument(
+                          "id = %d doesn't exist in Tree.", id));
+  }
+
+  size_t thread_num = std::min(
+      engines_.size(),
+      std::max(input_num / kMinInstancesPerThread, static_cast<size_t>(1)));
+  if (thread_num <= 1) {
+    SampleInstances(user_inputs,
+                    target_ids,
+                    with_hierarchy,
+                    0,
+                    input_num,
+                    &engines_[0],
+                    &outputs);
+    return outputs;
+  }
+
+  size_t chunk = (input_num + thread_num - 1) / thread_num;
+  std::vector<std::thread> threads;
+  threads.reserve(thread_num);
+  for (size_t t = 0; t < thread_num; ++t) {
+    size_t begin = t * chunk;
+    size_t end = std::min(begin + chunk, input_num);
+    if (begin >= end) break;
+    threads.emplace_back([&, begin, end, t] {
+      SampleInstances(user_inputs,
+                      target_ids,
+                      with_hierarchy,
+                      begin,
+                      end,
+                      &engines_[t],
+                      &outputs);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return outputs;
+}
+
+void LayerWiseSampler::SampleInstances(
+    const std::vector<std::vector<uint64_t>>& user_inputs,
+    const std::vector<uint64_t>& target_ids,
+    bool with_hierarchy,
+    size_t begin,
+    size_t end,
+    std::mt19937_64* engine,
+    std::vector<std::vector<uint64_t>>* outputs) {
+  auto user_feature_num = user_inputs[0].size();
   auto max_layer = tree_->Height();
-  size_t idx = 0;
-  for (size_t i = 0; i < input_num; i++) {
-    auto travel_codes =
-        tree_->GetTravelCodes(target_ids[i], start_sample_layer_);
-    auto travel_path = tree_->GetNodes(travel_codes);
+  std::vector<uint64_t> travel_path;
+  for (size_t i = begin; i < end; i++) {
+    size_t idx = i * layer_counts_sum_;
+    tree_->GetTravelIds(target_ids[i], start_sample_layer_, &travel_path);
     for (size_t j = 0; j < travel_path.size(); j++) {
       // user
-      if (j > 0 && with_hierarchy) {
-        auto ancestor_codes =
-            tree_->GetAncestorCodes(user_inputs[i], max_layer - j - 1);
-        auto hierarchical_user = tree_->GetNodes(ancestor_codes);
-        for (int idx_offset = 0; idx_offset <= layer_counts_[j]; idx_offset++) {
-          for (size_t k = 0; k < user_feature_num; k++) {
-            outputs[idx + idx_offset][k] = hierarchical_user[k].id();
-          }
-        }
-      } else {
-        for (int idx_offset = 0; idx_offset <= layer_counts_[j]; idx_offset++) {
-          for (size_t k = 0; k < user_feature_num; k++) {
-            outputs[idx + idx_offset][k] = user_inputs[i][k];
-          }
+      for (int idx_offset = 0; idx_offset <= layer_counts_[j]; idx_offset++) {
+        auto& row = (*outputs)[idx + idx_offset];
+        for (size_t k = 0; k < user_feature_num; k++) {
+          row[k] = j > 0 && with_hierarchy
+                       ? tree_->GetAncestorId(user_inputs[i][k],
+                                              max_layer - j - 1)
+                       : user_inputs[i][k];
         }
       }
 
       // sampler ++
-      outputs[idx][user_feature_num] = travel_path[j].id();
-      outputs[idx][user_feature_num + 1] = 1.0;
+      (*outputs)[idx][user_feature_num] = travel_path[j];
+      (*outputs)[idx][user_feature_num + 1] = 1.0;
       idx += 1;
       for (int idx_offset = 0; idx_offset < layer_counts_[j]; idx_offset++) {
-        int sample_res = 0;
-        do {
-          sample_res = sampler_vec_[j]->Sample();
-        } while (layer_ids_[j][sample_res].id() == travel_path[j].id());
-        outputs[idx + idx_offset][user_feature_num] =
-            layer_ids_[j][sample_res].id();
-        outputs[idx + idx_offset][user_feature_num + 1] = 0;
+        (*outputs)[idx + idx_offset][user_feature_num] =
+            SampleNegative(j, travel_path[j], engine);
+        (*outputs)[idx + idx_offset][user_feature_num + 1] = 0;
       }
       idx += layer_counts_[j];
     }
   }
-  return outputs;
 }
+
 void LayerWiseSampler::sample_from_dataset(
     const uint16_t sample_slot,
     std::vector<paddle::framework::Record>* src_datas,
@@ -98,22 +144,19 @@ void LayerWiseSampler::sample_from_dataset(
     if (sample_sign) {
       auto target_id =
           data.uint64_feasigns_[sample_feasign_idx].sign().uint64_feasign_;
-      auto travel_codes = tree_->GetTravelCodes(target_id, start_sample_layer_);
-      auto travel_path = tree_->GetNodes(travel_codes);
+      std::vector<uint64_t> travel_path;
+      tree_->GetTravelIds(target_id, start_sample_layer_, &travel_path);
       for (unsigned int j = 0; j < travel_path.size(); j++) {
         paddle::framework::Record instance(data);
         instance.uint64_feasigns_[sample_feasign_idx].sign().uint64_feasign_ =
-            travel_path[j].id();
+            travel_path[j];
         sample_results->push_back(instance);
         for (int idx_offset = 0; idx_offset < layer_counts_[j]; idx_offset++) {
-          int sample_res = 0;
-          do {
-            sample_res = sampler_vec_[j]->Sample();
-          } while (layer_ids_[j][sample_res].id() == travel_path[j].id());
+          auto sample_id = SampleNegative(j, travel_path[j], &engines_[0]);
           paddle::framework::Record instance(data);
           instance.uint64_feasigns_[sample_feasign_idx].sign().uint64_feasign_ =
-              layer_ids_[j][sample_res].id();
-          VLOG(1) << "layer id :" << layer_ids_[j][sample_res].id();
+              sample_id;
+          VLOG(1) << "layer id :" << sample_id;
           // sample_feasign_idx + 1 == label's id
           instance.uint64_feasigns_[sample_feasign_idx + 1]
               .sign()
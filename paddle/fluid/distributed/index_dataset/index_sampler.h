@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #pragma once
+#include <algorithm>
+#include <random>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "paddle/fluid/distributed/index_dataset/index_wrapper.h"
@@ -99,20 +102,34 @@ class LayerWiseSampler : public IndexSampler {
     VLOG(3) << "sample counts sum: " << layer_counts_sum_;
 
     auto max_layer = tree_->Height();
-    sampler_vec_.clear();
-    layer_ids_.clear();
+    layer_node_ids_.clear();
+    layer_offsets_.assign(1, 0);
 
+    // The ids of the sampled layers are flattened from the leaf layer up, so
+    // that the negatives of the j-th layer on the travel path are drawn from
+    // layer_node_ids_[layer_offsets_[j], layer_offsets_[j + 1]).
     auto layer_index = max_layer - 1;
-    size_t idx = 0;
     while (layer_index >= start_sample_layer_) {
-      auto layer_codes = tree_->GetLayerCodes(layer_index);
-      layer_ids_.push_back(tree_->GetNodes(layer_codes));
-      auto sampler_temp =
-          std::make_shared<paddle::operators::math::UniformSampler>(
-              layer_ids_[idx].size() - 1, seed_);
-      sampler_vec_.push_back(sampler_temp);
+      auto layer_ids = tree_->GetLayerIds(layer_index);
+      PADDLE_ENFORCE_GT(layer_ids.size(),
+                        0,
+                        paddle::platform::errors::InvalidArgument(
+                            "There is no node in layer [%d] of the tree.",
+                            layer_index));
+      layer_node_ids_.insert(
+          layer_node_ids_.end(), layer_ids.begin(), layer_ids.end());
+      layer_offsets_.push_back(layer_node_ids_.size());
       layer_index--;
-      idx++;
+    }
+
+    // Each thread of sample owns a random engine, and always samples the
+    // same part of the inputs, so that a fixed seed gives fixed samples.
+    size_t thread_num = std::max(std::thread::hardware_concurrency(), 1U);
+    engines_.clear();
+    for (size_t t = 0; t < thread_num; ++t) {
+      unsigned int engine_seed =
+          seed_ == 0 ? std::random_device()() : seed_ + t;
+      engines_.emplace_back(engine_seed);
     }
   }
   std::vector<std::vector<uint64_t>> sample(
@@ -126,13 +143,38 @@ class LayerWiseSampler : public IndexSampler {
       std::vector<paddle::framework::Record>* sample_results) override;
 
  private:
+  // Sample the instances of [begin, end) with engine, and write the rows of
+  // the i-th instance from outputs[i * layer_counts_sum_].
+  void SampleInstances(const std::vector<std::vector<uint64_t>>& user_inputs,
+                       const std::vector<uint64_t>& target_ids,
+                       bool with_hierarchy,
+                       size_t begin,
+                       size_t end,
+                       std::mt19937_64* engine,
+                       std::vector<std::vector<uint64_t>>* outputs);
+
+  // Sample a node other than positive_id from the j-th layer on the travel
+  // path.
+  uint64_t SampleNegative(size_t j,
+                          uint64_t positive_id,
+                          std::mt19937_64* engine) const {
+    std::uniform_int_distribution<size_t> dist(layer_offsets_[j],
+                                               layer_offsets_[j + 1] - 1);
+    uint64_t res = 0;
+    do {
+      res = layer_node_ids_[dist(*engine)];
+    } while (res == positive_id);
+    return res;
+  }
+
   std::vector<int> layer_counts_;
   int64_t layer_counts_sum_{0};
   std::shared_ptr<TreeIndex> tree_{nullptr};
   int seed_{0};
   int start_sample_layer_{1};
-  std::vector<std::shared_ptr<paddle::operators::math::Sampler>> sampler_vec_;
-  std::vector<std::vector<IndexNode>> layer_ids_;
+  std::vector<uint64_t> layer_node_ids_;
+  std::vector<size_t> layer_offsets_;
+  std::vector<std::mt19937_64> engines_;
 };
 
 }  // end namespace distributed
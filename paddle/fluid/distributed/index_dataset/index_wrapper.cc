@@ -91,6 +91,11 @@ int TreeIndex::Load(const std::string filename) {
   }
   total_nodes_num_ = data_.size();
   max_code_ += 1;
+
+  code_ids_.assign(max_code_, fake_node_.id());
+  for (auto& item : data_) {
+    code_ids_[item.first] = item.second.id();
+  }
   return 0;
 }
 
@@ -188,6 +193,49 @@ std::vector<uint64_t> TreeIndex::GetTravelCodes(uint64_t id, int start_level) {
   return res;
 }
 
+std::vector<uint64_t> TreeIndex::GetLayerIds(int level) {
+  auto codes = GetLayerCodes(level);
+  std::vector<uint64_t> res;
+  res.reserve(codes.size());
+  for (auto code : codes) {
+    res.push_back(GetNodeId(code));
+  }
+  return res;
+}
+
+uint64_t TreeIndex::GetAncestorId(uint64_t id, int level) const {
+  auto it = id_codes_map_.find(id);
+  if (it == id_codes_map_.end()) {
+    return fake_node_.id();
+  }
+  auto code = it->second;
+  int cur_level = meta_.height() - 1;
+  while (level >= 0 && cur_level > level) {
+    code = (code - 1) / meta_.branch();
+    cur_level--;
+  }
+  return GetNodeId(code);
+}
+
+void TreeIndex::GetTravelIds(uint64_t id,
+                             int start_level,
+                             std::vector<uint64_t>* ids) const {
+  ids->clear();
+  auto it = id_codes_map_.find(id);
+  PADDLE_ENFORCE_NE(it,
+                    id_codes_map_.end(),
+                    paddle::platform::errors::InvalidArgument(
+                        "id = %d doesn't exist in Tree.", id));
+  auto code = it->second;
+  int level = meta_.height() - 1;
+
+  while (level >= start_level) {
+    ids->push_back(GetNodeId(code));
+    code = (code - 1) / meta_.branch();
+    level--;
+  }
+}
+
 std::vector<IndexNode> TreeIndex::GetAllLeafs() {
   std::vector<IndexNode> res;
   res.reserve(id_codes_map_.size());
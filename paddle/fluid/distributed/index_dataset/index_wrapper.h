@@ -57,6 +57,18 @@ class TreeIndex : public Index {
   std::vector<uint64_t> GetTravelCodes(uint64_t id, int start_level);
   std::vector<IndexNode> GetAllLeafs();
 
+  // The ids of the nodes are also kept in an array indexed by the code, so
+  // that the samplers look up the ids without copying the IndexNodes. The
+  // invalid codes are mapped to the id of fake_node_.
+  inline uint64_t GetNodeId(uint64_t code) const {
+    return code < code_ids_.size() ? code_ids_[code] : fake_node_.id();
+  }
+  std::vector<uint64_t> GetLayerIds(int level);
+  uint64_t GetAncestorId(uint64_t id, int level) const;
+  void GetTravelIds(uint64_t id,
+                    int start_level,
+                    std::vector<uint64_t>* ids) const;
+
   std::unordered_map<uint64_t, IndexNode> data_;
   std::unordered_map<uint64_t, uint64_t> id_codes_map_;
   uint64_t total_nodes_num_;
@@ -64,6 +76,7 @@ class TreeIndex : public Index {
   uint64_t max_id_;
   uint64_t max_code_;
   IndexNode fake_node_;
+  std::vector<uint64_t> code_ids_;
 };
 
 using TreePtr = std::shared_ptr<TreeIndex>;
@@ -82,6 +82,11 @@ PD_DEFINE_int32(pserver_sparse_table_shard_num,
                 1000,
                 "sparse table shard for save & load");
 
+PD_DEFINE_bool(pserver_push_sparse_by_attachment,
+               true,
+               "send the push sparse data by a zero copy attachment, "
+               "which is not compressed by pserver_communicate_compress_type");
+
 inline size_t get_sparse_shard(uint32_t shard_num,
                                uint32_t server_num,
                                uint64_t key) {
@@ -91,6 +96,21 @@ inline size_t get_sparse_shard(uint32_t shard_num,
   return (key % shard_num) / local_shard_num;
 }
 
+// the push sparse data of size bytes is built in place in a user block of
+// the request attachment, or in the data of the request, which is copied
+// once more by the serialization of protobuf and may be compressed
+inline char *get_push_sparse_buffer(brpc::Controller *cntl,
+                                    PsRequestMessage *request,
+                                    size_t size) {
+  if (FLAGS_pserver_push_sparse_by_attachment &&
+      FLAGS_pserver_communicate_compress_type == 0 && size > 0) {
+    return AppendIOBufUserBlock(&cntl->request_attachment(), size);
+  }
+  auto *push_data = request->mutable_data();
+  push_data->resize(size);
+  return const_cast<char *>(push_data->data());
+}
+
 void DownpourPsClientService::service(
     ::google::protobuf::RpcController *controller,
     const PsRequestMessage *request,
@@ -118,6 +138,7 @@ int32_t BrpcPsClient::StartClientService() {
   brpc::ServerOptions options;
   int start_port = 8500;
   options.num_threads = 24;
+  SetBrpcUseRdma(&options, UseRdma());
 
   if (_server.Start(butil::my_ip_cstr(),
                     brpc::PortRange(start_port, max_port),
@@ -168,6 +189,7 @@ int32_t BrpcPsClient::CreateClient2ClientConnection(
   options.connection_type = "pooled";
   options.connect_timeout_ms = pserver_connect_timeout_ms;
   options.max_retry = max_retry;
+  SetBrpcUseRdma(&options, UseRdma());
 
   std::vector<PSHost> client_list = _env->GetPsClients();
   VLOG(1) << "BrpcPsClient::create_c2c_connection client_list size: "
@@ -299,6 +321,7 @@ int32_t BrpcPsClient::Initialize() {
   options.connection_type = "pooled";
   options.connect_timeout_ms = FLAGS_pserver_connect_timeout_ms;
   options.max_retry = 3;
+  SetBrpcUseRdma(&options, UseRdma());
 
   std::ostringstream os;
   std::string server_ip_port;
@@ -345,6 +368,31 @@ int32_t BrpcPsClient::Initialize() {
       _push_sparse_task_queue_map[table_id] =
           ::paddle::framework::MakeChannel<SparseAsyncTask *>();
       _push_sparse_merge_count_map[table_id] = 0;
+      const auto &cache_param =
+          worker_param.downpour_table_param(i).hot_key_cache_param();
+      if (cache_param.enable()) {
+        auto *accessor = GetTableAccessor(table_id);
+        _hot_key_caches[table_id].reset(new SparseHotKeyCache(
+            cache_param, accessor->GetAccessorInfo().select_size));
+        VLOG(0) << "BrpcPsClient enable hot key cache for table " << table_id
+                << ", capacity: " << cache_param.capacity()
+                << ", max_staleness_ms: " << cache_param.max_staleness_ms()
+                << ", max_staleness_pulls: "
+                << cache_param.max_staleness_pulls();
+      }
+      const auto &compress_param =
+          worker_param.downpour_table_param(i).push_compress_param();
+      if (compress_param.codec() != SparsePushCompressParameter::NONE) {
+        auto *accessor = GetTableAccessor(table_id);
+        _push_codecs[table_id].reset(
+            new SparsePushCodec(compress_param,
+                                accessor->GetAccessorInfo().update_dim,
+                                accessor->PushValueGradIndex()));
+        VLOG(0) << "BrpcPsClient compress push sparse of table " << table_id
+                << " with "
+                << SparsePushCompressParameter::Codec_Name(
+                       compress_param.codec());
+      }
     }
   }
 
@@ -564,11 +612,13 @@ std::future<int32_t> BrpcPsClient::Shrink(uint32_t table_id,
 
 std::future<int32_t> BrpcPsClient::Load(const std::string &epoch,
                                         const std::string &mode) {
+  ClearHotKeyCache(-1);
   return SendCmd(-1, PS_LOAD_ALL_TABLE, {epoch, mode});
 }
 std::future<int32_t> BrpcPsClient::Load(uint32_t table_id,
                                         const std::string &epoch,
                                         const std::string &mode) {
+  ClearHotKeyCache(table_id);
   return SendCmd(table_id, PS_LOAD_ONE_TABLE, {epoch, mode});
 }
 
@@ -666,16 +716,27 @@ std::future<int32_t> BrpcPsClient::GetCacheThreshold(uint32_t table_id,
 }
 
 std::future<int32_t> BrpcPsClient::Clear() {
+  ClearHotKeyCache(-1);
   return SendCmd(-1, PS_CLEAR_ALL_TABLE, {});
 }
 std::future<int32_t> BrpcPsClient::Clear(uint32_t table_id) {
+  ClearHotKeyCache(table_id);
   return SendCmd(table_id, PS_CLEAR_ONE_TABLE, {});
 }
 
 std::future<int32_t> BrpcPsClient::Revert() {
+  ClearHotKeyCache(-1);
   return SendCmd(-1, PS_REVERT, {});
 }
 
+void BrpcPsClient::ClearHotKeyCache(int table_id) {
+  for (auto &cache_itr : _hot_key_caches) {
+    if (table_id == -1 || cache_itr.first == static_cast<uint32_t>(table_id)) {
+      cache_itr.second->Clear();
+    }
+  }
+}
+
 std::future<int32_t> BrpcPsClient::CheckSavePrePatchDone() {
   return SendCmd(-1, PS_CHECK_SAVE_PRE_PATCH_DONE, {});
 }
@@ -711,6 +772,14 @@ void BrpcPsClient::PrintQueueSize() {
     VLOG(0) << "BrpcPsClient::PrintQueueSize: table " << table_id
             << " size: " << queue_size;
   }
+
+  for (auto &cache_itr : _hot_key_caches) {
+    auto *cache = cache_itr.second.get();
+    VLOG(0) << "BrpcPsClient::PrintQueueSize: table " << cache_itr.first
+            << " hot key cache size: " << cache->Size()
+            << " hit: " << cache->HitCount()
+            << " miss: " << cache->MissCount();
+  }
 }
 
 void BrpcPsClient::PrintQueueSizeThread() {
@@ -1038,12 +1107,15 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradient(
     value_ptrs[pserver_idx].push_back(update_values[i]);
   }
 
+  auto *codec = GetPushCodec(table_id);
   for (size_t shard_idx = 0; shard_idx < request_call_num; ++shard_idx) {
     auto kvs = ids[shard_idx];
     auto value_ptr = value_ptrs[shard_idx];
 
     size_t kv_size = kvs.size();
-    uint32_t value_size = accessor->GetAccessorInfo().update_size;
+    uint32_t value_size = codec != nullptr
+                              ? codec->EncodedSize()
+                              : accessor->GetAccessorInfo().update_size;
 
     // 发送RPC请求
     auto *push_request = closure->request(shard_idx);
@@ -1051,14 +1123,22 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradient(
     push_request->set_table_id(table_id);
     push_request->set_client_id(_client_id);
     push_request->add_params((char *)&kv_size, sizeof(uint32_t));  // NOLINT
-    auto *push_data = push_request->mutable_data();
-    push_data->resize(kv_size * (sizeof(uint64_t) + value_size));
-    char *push_data_ptr = const_cast<char *>(push_data->data());
+    if (codec != nullptr) {
+      push_request->add_params(codec->Header());
+    }
+    char *push_data_ptr =
+        get_push_sparse_buffer(closure->cntl(shard_idx),
+                               push_request,
+                               kv_size * (sizeof(uint64_t) + value_size));
     memcpy(push_data_ptr, kvs.data(), kv_size * sizeof(uint64_t));
     push_data_ptr += kv_size * sizeof(uint64_t);
 
     for (size_t i = 0; i < kv_size; ++i) {
-      memcpy(push_data_ptr, value_ptr[i], value_size);
+      if (codec != nullptr) {
+        codec->Encode(kvs[i], value_ptr[i], push_data_ptr);
+      } else {
+        memcpy(push_data_ptr, value_ptr[i], value_size);
+      }
       push_data_ptr += value_size;
     }
     PsService_Stub rpc_stub(GetSparseChannel(shard_idx));
@@ -1159,7 +1239,13 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
     }
   }
 
+  // 命中热点key缓存的key不再发给server
+  auto *hot_key_cache = GetHotKeyCache(table_id);
   for (size_t i = 0; i < num; ++i) {
+    if (hot_key_cache != nullptr &&
+        hot_key_cache->Lookup(keys[i], select_values[i])) {
+      continue;
+    }
     size_t shard_id = get_sparse_shard(shard_num, request_call_num, keys[i]);
     shard_sorted_kvs->at(shard_id).push_back({keys[i], select_values[i]});
   }
@@ -1169,7 +1255,8 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
   size_t value_size = accessor->GetAccessorInfo().select_size;
 
   DownpourBrpcClosure *closure = new DownpourBrpcClosure(
-      request_call_num, [shard_sorted_kvs, value_size](void *done) {
+      request_call_num,
+      [shard_sorted_kvs, value_size, hot_key_cache, accessor](void *done) {
         int ret = 0;
         auto *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
         for (size_t i = 0; i < shard_sorted_kvs->size(); ++i) {
@@ -1199,6 +1286,12 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
                 ret = -1;
                 break;
               }
+              if (hot_key_cache != nullptr) {
+                hot_key_cache->Update(
+                    last_key,
+                    last_value_data,
+                    accessor->PullValueShowClickScore(last_value_data));
+              }
             }
           }
         }
@@ -1410,7 +1503,10 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradientPartial(
     void *done,
     int pserver_idx) {
   auto *accessor = GetTableAccessor(table_id);
-  size_t value_size = accessor->GetAccessorInfo().update_size;
+  auto *codec = GetPushCodec(table_id);
+  size_t value_size = codec != nullptr
+                          ? codec->EncodedSize()
+                          : accessor->GetAccessorInfo().update_size;
   DownpourBrpcClosure *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
   auto promise = std::make_shared<std::promise<int32_t>>();
   closure->add_promise(promise);
@@ -1422,13 +1518,19 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradientPartial(
   push_request->set_table_id(table_id);
   push_request->set_client_id(_client_id);
   push_request->add_params((char *)&num, sizeof(uint32_t));  // NOLINT
-  auto *push_data = push_request->mutable_data();
-  push_data->resize(num * (sizeof(uint64_t) + value_size));
-  char *push_data_ptr = const_cast<char *>(push_data->data());
+  if (codec != nullptr) {
+    push_request->add_params(codec->Header());
+  }
+  char *push_data_ptr = get_push_sparse_buffer(
+      closure->cntl(0), push_request, num * (sizeof(uint64_t) + value_size));
   memcpy(push_data_ptr, keys, num * sizeof(uint64_t));
   push_data_ptr += num * sizeof(uint64_t);
   for (uint32_t i = 0; i < num; ++i) {
-    memcpy(push_data_ptr, update_values[i], value_size);
+    if (codec != nullptr) {
+      codec->Encode(keys[i], update_values[i], push_data_ptr);
+    } else {
+      memcpy(push_data_ptr, update_values[i], value_size);
+    }
     push_data_ptr += value_size;
   }
   PsService_Stub rpc_stub(GetSparseChannel(pserver_idx));
@@ -1858,10 +1960,11 @@ int BrpcPsClient::PushSparseAsyncShardPush(
   push_request->set_client_id(_client_id);
   push_request->add_params(reinterpret_cast<char *>(&merged_kv_count),
                            sizeof(uint32_t));  // NOLINT
-  auto *push_data = push_request->mutable_data();
   int update_size = accessor->GetAccessorInfo().update_size;
-  push_data->resize(merged_kv_count * (sizeof(uint64_t) + update_size));
-  char *push_data_ptr = const_cast<char *>(push_data->data());
+  char *push_data_ptr = get_push_sparse_buffer(
+      closure->cntl(shard_idx),
+      push_request,
+      merged_kv_count * (sizeof(uint64_t) + update_size));
   memcpy(push_data_ptr,
          merged_key_list.data(),
          merged_kv_count * sizeof(uint64_t));
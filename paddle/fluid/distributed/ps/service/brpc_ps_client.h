@@ -27,6 +27,8 @@
 #include "paddle/fluid/distributed/ps/service/brpc_utils.h"
 #include "paddle/fluid/distributed/ps/service/ps_client.h"
 #include "paddle/fluid/distributed/ps/service/sendrecv.pb.h"
+#include "paddle/fluid/distributed/ps/service/sparse_hot_key_cache.h"
+#include "paddle/fluid/distributed/ps/service/sparse_push_codec.h"
 #include "paddle/fluid/framework/channel.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/scope.h"
@@ -336,6 +338,12 @@ class BrpcPsClient : public PSClient {
                                    uint32_t shard_num) {
     return dense_dim_total / shard_num + 1;
   }
+  inline bool UseRdma() const {
+    return _config.server_param()
+        .downpour_server_param()
+        .service_param()
+        .use_rdma();
+  }
 
   std::future<int32_t> SendCmd(uint32_t table_id,
                                int cmd_id,
@@ -360,6 +368,20 @@ class BrpcPsClient : public PSClient {
   std::unordered_map<uint32_t, paddle::framework::Channel<SparseAsyncTask *>>
       _push_sparse_task_queue_map;
   std::unordered_map<uint32_t, uint32_t> _push_sparse_merge_count_map;
+  // 热点key的pull value缓存, 只在Initialize中创建
+  std::unordered_map<uint32_t, std::unique_ptr<SparseHotKeyCache>>
+      _hot_key_caches;
+  SparseHotKeyCache *GetHotKeyCache(size_t table_id) {
+    auto itr = _hot_key_caches.find(table_id);
+    return itr == _hot_key_caches.end() ? nullptr : itr->second.get();
+  }
+  void ClearHotKeyCache(int table_id);
+  // 通信器push sparse梯度的压缩, 只在Initialize中创建
+  std::unordered_map<uint32_t, std::unique_ptr<SparsePushCodec>> _push_codecs;
+  SparsePushCodec *GetPushCodec(size_t table_id) {
+    auto itr = _push_codecs.find(table_id);
+    return itr == _push_codecs.end() ? nullptr : itr->second.get();
+  }
 
   std::thread _print_thread;
 
@@ -18,6 +18,7 @@
 
 #include "butil/object_pool.h"
 #include "paddle/fluid/distributed/common/cost_timer.h"
+#include "paddle/fluid/distributed/ps/service/sparse_push_codec.h"
 #include "paddle/fluid/distributed/ps/table/depends/sparse_utils.h"
 #include "paddle/fluid/distributed/ps/table/table.h"
 #include "paddle/fluid/framework/archive.h"
@@ -82,6 +83,8 @@ uint64_t BrpcPsServer::Start(const std::string &ip, uint32_t port) {
   int num_threads = std::thread::hardware_concurrency();
   auto trainers = _environment->GetTrainers();
   options.num_threads = trainers > num_threads ? trainers : num_threads;
+  SetBrpcUseRdma(&options,
+                 _config.downpour_server_param().service_param().use_rdma());
 
   if (_server.Start(ip_port.c_str(), &options) != 0) {
     VLOG(0) << "BrpcPsServer start failed, ip_port= " << ip_port
@@ -112,6 +115,8 @@ int32_t BrpcPsServer::StartS2S() {
   options.connection_type = FLAGS_pserver_connection_type_s2s;
   options.connect_timeout_ms = FLAGS_pserver_connect_timeout_ms_s2s;
   options.max_retry = 3;
+  SetBrpcUseRdma(&options,
+                 _config.downpour_server_param().service_param().use_rdma());
 
   std::vector<PSHost> pserver_list = _environment->GetPsServers();
   _pserver_channels.resize(pserver_list.size());
@@ -313,20 +318,19 @@ int32_t BrpcPsService::PullDense(Table *table,
   CostTimer timer("pserver_server_pull_dense");
   uint32_t num = *(const uint32_t *)request.params(0).c_str();
 
-  auto res_data = butil::get_object<std::vector<float>>();
-  res_data->resize(num * table->ValueAccesor()->GetAccessorInfo().select_size /
-                   sizeof(float));
+  // the values are pulled into the response attachment in place
+  size_t res_size = num *
+                    table->ValueAccesor()->GetAccessorInfo().select_size /
+                    sizeof(float) * sizeof(float);
+  auto *res_data = reinterpret_cast<float *>(
+      AppendIOBufUserBlock(&cntl->response_attachment(), res_size));
 
   TableContext table_context;
   table_context.value_type = Dense;
-  table_context.pull_context.values = res_data->data();
+  table_context.pull_context.values = res_data;
   table_context.num = num;
   table->Pull(table_context);
 
-  cntl->response_attachment().append(reinterpret_cast<char *>(res_data->data()),
-                                     res_data->size() * sizeof(float));
-  butil::return_object(res_data);
-
   return 0;
 }
 
@@ -525,27 +529,21 @@ int32_t BrpcPsService::PullSparse(Table *table,
   auto dim = table->ValueAccesor()->GetAccessorInfo().select_dim;
 
   thread_local std::string req_buffer;
-  req_buffer.reserve(req_buffer_size);
-
-  const void *data = cntl->request_attachment().fetch(
-      const_cast<char *>(req_buffer.data()), req_buffer_size);
+  const char *data = FetchIOBuf(req_io_buffer, req_buffer_size, &req_buffer);
 
   auto value = PullSparseValue(num, dim);
 
-  value.DeserializeFromBytes(const_cast<void *>(data));
+  value.DeserializeFromBytes(const_cast<char *>(data));
 
-  auto res_data = butil::get_object<std::vector<float>>();
-  res_data->resize(num * dim);
+  // the values are pulled into the response attachment in place
+  auto *res_data = reinterpret_cast<float *>(AppendIOBufUserBlock(
+      &cntl->response_attachment(), num * dim * sizeof(float)));
   TableContext table_context;
   table_context.value_type = Sparse;
   table_context.pull_context.pull_value = value;
-  table_context.pull_context.values = res_data->data();
+  table_context.pull_context.values = res_data;
   table->Pull(table_context);
   // table->PullSparse(res_data->data(), value);
-
-  cntl->response_attachment().append(reinterpret_cast<char *>(res_data->data()),
-                                     res_data->size() * sizeof(float));
-  butil::return_object(res_data);
   return 0;
 }
 
@@ -556,8 +554,16 @@ int32_t BrpcPsService::PushSparse(Table *table,
   platform::RecordEvent record_event(
       "PsService->PushSparse", platform::TracerEventType::Communication, 1);
   CHECK_TABLE_EXIST(table, request, response)
-  auto &push_data = request.data();
-  if (push_data.empty()) {
+  // the data is sent by the request attachment or by the request itself
+  thread_local std::string push_buffer;
+  const char *push_data = request.data().data();
+  size_t push_size = request.data().size();
+  auto &req_io_buffer = cntl->request_attachment();
+  if (push_size == 0 && !req_io_buffer.empty()) {
+    push_size = req_io_buffer.size();
+    push_data = FetchIOBuf(req_io_buffer, push_size, &push_buffer);
+  }
+  if (push_size == 0) {
     // set_response_code(response, 0, "push sparse data is empty");
     return 0;
   }
@@ -576,11 +582,35 @@ int32_t BrpcPsService::PushSparse(Table *table,
   |---keysData---|---valuesData---|
   |---8*{num}B---|----------------|
   */
+  const float *values = (const float *)(push_data + sizeof(uint64_t) * num);
+  // params(1) is the SparsePushCompressParameter of the encoded values
+  thread_local std::vector<float> decode_buffer;
+  if (request.params_size() > 1) {
+    SparsePushCompressParameter compress_param;
+    if (!compress_param.ParseFromString(request.params(1))) {
+      set_response_code(response, -1, "PushSparse compress param error");
+      return 0;
+    }
+    auto accessor = table->ValueAccesor();
+    size_t update_dim = accessor->GetAccessorInfo().update_dim;
+    SparsePushCodec codec(
+        compress_param, update_dim, accessor->PushValueGradIndex());
+    if (push_size != num * (sizeof(uint64_t) + codec.EncodedSize())) {
+      set_response_code(response, -1, "PushSparse encoded data size error");
+      return 0;
+    }
+    decode_buffer.resize(num * update_dim);
+    const char *encoded = push_data + sizeof(uint64_t) * num;
+    for (size_t i = 0; i < num; ++i) {
+      codec.Decode(encoded + i * codec.EncodedSize(),
+                   decode_buffer.data() + i * update_dim);
+    }
+    values = decode_buffer.data();
+  }
   TableContext table_context;
   table_context.value_type = Sparse;
-  table_context.push_context.keys = (const uint64_t *)push_data.data();
-  table_context.push_context.values =
-      (const float *)(push_data.data() + sizeof(uint64_t) * num);
+  table_context.push_context.keys = (const uint64_t *)push_data;
+  table_context.push_context.values = values;
   table_context.num = num;
   // const uint64_t *keys = (const uint64_t *)push_data.data();
   // const float *values = (const float *)(push_data.data() + sizeof(uint64_t) *
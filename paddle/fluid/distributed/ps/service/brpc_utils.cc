@@ -17,8 +17,17 @@ limitations under the License. */
 #include <arpa/inet.h>
 #include <netdb.h>
 
+#ifdef PADDLE_WITH_BRPC_RDMA
+#include <mutex>  // NOLINT
+
+#include "brpc/rdma/rdma_helper.h"
+#endif
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/platform/enforce.h"
+#ifdef PADDLE_WITH_CUDA
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#endif
 
 namespace paddle {
 namespace framework {
@@ -52,6 +61,81 @@ framework::proto::VarType::Type VarMessageToVarType(
   }
 }
 
+#ifdef PADDLE_WITH_CUDA
+namespace {
+
+// The pinned user block keeps the allocation owning it in the header before
+// its data, since the deleter of IOBuf only gets the data.
+constexpr size_t kPinnedHeaderSize = 64;
+
+void DeallocatePinnedBlock(void* data) {
+  auto* holder = *reinterpret_cast<memory::AllocationPtr**>(
+      static_cast<char*>(data) - kPinnedHeaderSize);
+  delete holder;
+}
+
+// Copy the device data of tensor into a pinned block appended to iobuf, so
+// that it is copied once by dma and sent without another host copy.
+void SerializeDeviceTensorData(const phi::DenseTensor& tensor,
+                               const platform::DeviceContext& ctx,
+                               butil::IOBuf* iobuf) {
+  auto data_len = tensor.numel() * phi::SizeOf(tensor.dtype());
+  iobuf->append(reinterpret_cast<const char*>(&data_len), 8);
+  if (data_len == 0) {
+    return;
+  }
+  auto* holder = new memory::AllocationPtr(memory::Alloc(
+      platform::CUDAPinnedPlace(), data_len + kPinnedHeaderSize));
+  char* base = static_cast<char*>((*holder)->ptr());
+  *reinterpret_cast<memory::AllocationPtr**>(base) = holder;
+  char* block = base + kPinnedHeaderSize;
+  auto stream = reinterpret_cast<const phi::GPUContext&>(ctx).stream();
+  memory::Copy(platform::CUDAPinnedPlace(),
+               block,
+               tensor.place(),
+               tensor.data(),
+               data_len,
+               stream);
+  platform::GpuStreamSync(stream);
+  int ret = iobuf->append_user_data(block, data_len, DeallocatePinnedBlock);
+  if (ret != 0) {
+    delete holder;
+  }
+  PADDLE_ENFORCE_EQ(ret,
+                    0,
+                    platform::errors::External(
+                        "Failed to append %d bytes of pinned data to IOBuf.",
+                        data_len));
+}
+
+// Copy the data of a tensor from io_buffer_itr to the device by a pinned
+// staging buffer, which the driver would otherwise stage by itself.
+void DeserializeDeviceTensorData(
+    butil::IOBufBytesIterator& io_buffer_itr,  // NOLINT
+    const platform::DeviceContext& ctx,
+    void* tensor_data,
+    size_t size) {
+  unsigned long data_len;                                 // NOLINT
+  io_buffer_itr.copy_and_forward((void*)(&data_len), 8);  // NOLINT
+  if (data_len == 0) {
+    return;
+  }
+  auto staging = memory::Alloc(platform::CUDAPinnedPlace(), data_len);
+  io_buffer_itr.copy_and_forward(staging->ptr(), data_len);
+  auto stream = reinterpret_cast<const phi::GPUContext&>(ctx).stream();
+  memory::Copy(ctx.GetPlace(),
+               tensor_data,
+               platform::CUDAPinnedPlace(),
+               staging->ptr(),
+               size,
+               stream);
+  // the staging buffer is released to the allocator after the copy
+  platform::GpuStreamSync(stream);
+}
+
+}  // namespace
+#endif
+
 void SerializeToMultiVarMsgAndIOBuf(
     const std::string& message_name,
     const std::vector<std::string>& send_var_name_val,
@@ -116,21 +200,7 @@ void SerializeLodTensor(framework::Variable* var,
     iobuf->append(reinterpret_cast<const char*>(tensor->data()), data_len);
   } else {
 #ifdef PADDLE_WITH_CUDA
-    char* temp_ptr =
-        new char[tensor->numel() * phi::SizeOf(tensor->dtype())];  // NOLINT
-    auto stream = reinterpret_cast<const phi::GPUContext&>(ctx).stream();
-    memory::Copy(
-        platform::CPUPlace(),
-        temp_ptr,
-        tensor->place(),
-        tensor->data(),
-        tensor->numel() * framework::SizeOfType(
-                              framework::TransToProtoVarType(tensor->dtype())),
-        stream);
-    auto data_len = tensor->numel() * phi::SizeOf(tensor->dtype());
-    iobuf->append(reinterpret_cast<const char*>(&data_len), 8);
-    iobuf->append(reinterpret_cast<const char*>(temp_ptr), data_len);
-    delete[] temp_ptr;
+    SerializeDeviceTensorData(*tensor, ctx, iobuf);
 #endif
   }
 }
@@ -163,21 +233,7 @@ void SerializeSelectedRows(framework::Variable* var,
     iobuf->append(reinterpret_cast<const char*>(tensor->data()), data_len);
   } else {
 #ifdef PADDLE_WITH_CUDA
-    char* temp_ptr =
-        new char[tensor->numel() * phi::SizeOf(tensor->dtype())];  // NOLINT
-    auto stream = reinterpret_cast<const phi::GPUContext&>(ctx).stream();
-    memory::Copy(
-        platform::CPUPlace(),
-        temp_ptr,
-        tensor->place(),
-        tensor->data(),
-        tensor->numel() * framework::SizeOfType(
-                              framework::TransToProtoVarType(tensor->dtype())),
-        stream);
-    auto data_len = tensor->numel() * phi::SizeOf(tensor->dtype());
-    iobuf->append(reinterpret_cast<const char*>(&data_len), 8);
-    iobuf->append(reinterpret_cast<const char*>(temp_ptr), data_len);
-    delete[] temp_ptr;
+    SerializeDeviceTensorData(*tensor, ctx, iobuf);
 #endif
   }
 }
@@ -255,19 +311,10 @@ void DeserializeLodTensor(framework::Variable* var,
     io_buffer_itr.copy_and_forward(tensor_data, data_len);
   } else if (platform::is_gpu_place(place)) {
 #ifdef PADDLE_WITH_CUDA
-    unsigned long data_len;  // NOLINT
-    char* temp_ptr =
-        new char[tensor->numel() * phi::SizeOf(tensor->dtype())];  // NOLINT
-    io_buffer_itr.copy_and_forward((void*)(&data_len), 8);         // NOLINT
-    io_buffer_itr.copy_and_forward((void*)temp_ptr, data_len);     // NOLINT
-    auto stream = reinterpret_cast<const phi::GPUContext&>(ctx).stream();
-    memory::Copy(place,
-                 tensor_data,
-                 platform::CPUPlace(),
-                 (void*)temp_ptr,  // NOLINT
-                 tensor->numel() * phi::SizeOf(tensor->dtype()),
-                 stream);
-    delete[] temp_ptr;
+    DeserializeDeviceTensorData(io_buffer_itr,
+                                ctx,
+                                tensor_data,
+                                tensor->numel() * phi::SizeOf(tensor->dtype()));
 #endif
   }
 }
@@ -299,19 +346,10 @@ void DeserializeSelectedRows(
     io_buffer_itr.copy_and_forward(tensor_data, data_len);
   } else if (platform::is_gpu_place(place)) {
 #ifdef PADDLE_WITH_CUDA
-    char* temp_ptr =
-        new char[tensor->numel() * phi::SizeOf(tensor->dtype())];  // NOLINT
-    unsigned long data_len;                                        // NOLINT
-    io_buffer_itr.copy_and_forward((void*)(&data_len), 8);         // NOLINT
-    io_buffer_itr.copy_and_forward(temp_ptr, data_len);
-    auto stream = reinterpret_cast<const phi::GPUContext&>(ctx).stream();
-    memory::Copy(place,
-                 tensor_data,
-                 platform::CPUPlace(),
-                 temp_ptr,
-                 tensor->numel() * phi::SizeOf(tensor->dtype()),
-                 stream);
-    delete[] temp_ptr;
+    DeserializeDeviceTensorData(io_buffer_itr,
+                                ctx,
+                                tensor_data,
+                                tensor->numel() * phi::SizeOf(tensor->dtype()));
 #endif
   }
 }
@@ -343,5 +381,149 @@ std::string GetIntTypeEndpoint(const std::string& ip, const uint32_t& port) {
   return int_ip_port;
 }
 
+#ifdef PADDLE_WITH_BRPC_RDMA
+namespace {
+
+// The user blocks sent by rdma must be registered to the device, and the
+// registration costs more than copying a block of the usual push or pull
+// sizes, so the blocks are registered once and recycled by size classes
+// of the powers of 2. The size class and the lkey of a block are kept in
+// the header before its data, since the deleter of IOBuf only gets the
+// data.
+class RdmaUserBlockPool {
+ public:
+  static RdmaUserBlockPool& Instance() {
+    static RdmaUserBlockPool pool;
+    return pool;
+  }
+
+  char* Allocate(size_t size, uint32_t* lkey) {
+    uint32_t size_class = kMinSizeClass;
+    while ((static_cast<size_t>(1) << size_class) < size) {
+      ++size_class;
+    }
+    char* base = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& blocks = free_blocks_[size_class];
+      if (!blocks.empty()) {
+        base = blocks.back();
+        blocks.pop_back();
+      }
+    }
+    if (base == nullptr) {
+      size_t bytes = kHeaderSize + (static_cast<size_t>(1) << size_class);
+      base = static_cast<char*>(malloc(bytes));
+      PADDLE_ENFORCE_NOT_NULL(
+          base,
+          platform::errors::ResourceExhausted(
+              "Failed to allocate %d bytes for the rdma user block.", bytes));
+      uint32_t block_lkey = brpc::rdma::RegisterMemoryForRdma(base, bytes);
+      if (block_lkey == 0) {
+        free(base);
+      }
+      PADDLE_ENFORCE_NE(block_lkey,
+                        0,
+                        platform::errors::External(
+                            "Failed to register %d bytes for rdma.", bytes));
+      auto* header = reinterpret_cast<BlockHeader*>(base);
+      header->size_class = size_class;
+      header->lkey = block_lkey;
+    }
+    *lkey = reinterpret_cast<BlockHeader*>(base)->lkey;
+    return base + kHeaderSize;
+  }
+
+  static void Deallocate(void* data) {
+    char* base = static_cast<char*>(data) - kHeaderSize;
+    auto& pool = Instance();
+    {
+      std::lock_guard<std::mutex> lock(pool.mutex_);
+      auto& blocks =
+          pool.free_blocks_[reinterpret_cast<BlockHeader*>(base)->size_class];
+      if (blocks.size() < kMaxFreeBlocks) {
+        blocks.push_back(base);
+        return;
+      }
+    }
+    brpc::rdma::DeregisterMemoryForRdma(base);
+    free(base);
+  }
+
+ private:
+  struct BlockHeader {
+    uint32_t size_class;
+    uint32_t lkey;
+  };
+  static constexpr size_t kHeaderSize = 64;
+  static constexpr uint32_t kMinSizeClass = 12;
+  static constexpr size_t kMaxFreeBlocks = 64;
+
+  RdmaUserBlockPool() : free_blocks_(64) {}
+
+  std::mutex mutex_;
+  std::vector<std::vector<char*>> free_blocks_;
+};
+
+}  // namespace
+#endif
+
+char* AppendIOBufUserBlock(butil::IOBuf* iobuf, size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+#ifdef PADDLE_WITH_BRPC_RDMA
+  if (brpc::rdma::IsRdmaAvailable()) {
+    uint32_t lkey = 0;
+    char* block = RdmaUserBlockPool::Instance().Allocate(size, &lkey);
+    int rdma_ret = iobuf->append_user_data_with_meta(
+        block, size, RdmaUserBlockPool::Deallocate, lkey);
+    if (rdma_ret != 0) {
+      RdmaUserBlockPool::Deallocate(block);
+    }
+    PADDLE_ENFORCE_EQ(rdma_ret,
+                      0,
+                      platform::errors::External(
+                          "Failed to append %d bytes of rdma user data to "
+                          "IOBuf.",
+                          size));
+    return block;
+  }
+#endif
+  char* data = static_cast<char*>(malloc(size));
+  PADDLE_ENFORCE_NOT_NULL(
+      data,
+      platform::errors::ResourceExhausted(
+          "Failed to allocate %d bytes for the IOBuf user block.", size));
+  int ret = iobuf->append_user_data(data, size, free);
+  if (ret != 0) {
+    free(data);
+  }
+  PADDLE_ENFORCE_EQ(ret,
+                    0,
+                    platform::errors::External(
+                        "Failed to append %d bytes of user data to IOBuf.",
+                        size));
+  return data;
+}
+
+const char* FetchIOBuf(const butil::IOBuf& iobuf,
+                       size_t size,
+                       std::string* buffer) {
+  PADDLE_ENFORCE_LE(size,
+                    iobuf.size(),
+                    platform::errors::InvalidArgument(
+                        "Fetch %d bytes from an IOBuf of %d bytes.",
+                        size,
+                        iobuf.size()));
+  if (size == 0) {
+    return nullptr;
+  }
+  if (iobuf.backing_block(0).size() < size) {
+    buffer->resize(size);
+  }
+  return static_cast<const char*>(iobuf.fetch(&(*buffer)[0], size));
+}
+
 }  // namespace distributed
 }  // namespace paddle
@@ -94,5 +94,34 @@ void DeserializeSelectedRows(framework::Variable* var,
 
 std::string GetIntTypeEndpoint(const std::string& ip, const uint32_t& port);
 
+// Select the rdma transport on the brpc::ChannelOptions or the
+// brpc::ServerOptions, which is only available with WITH_BRPC_RDMA. brpc
+// checks the other options, e.g. rdma works with baidu_std but not ssl.
+template <typename BrpcOptions>
+void SetBrpcUseRdma(BrpcOptions* options, bool use_rdma) {
+  if (!use_rdma) {
+    return;
+  }
+#ifdef PADDLE_WITH_BRPC_RDMA
+  options->use_rdma = true;
+#else
+  PADDLE_THROW(platform::errors::Unavailable(
+      "The rdma transport of brpc is selected, but paddle is not compiled "
+      "with WITH_BRPC_RDMA."));
+#endif
+}
+
+// Append a malloc'ed block of size bytes to iobuf as a user block and
+// return it, the payload written in place afterwards is sent without being
+// copied into the IOBuf, and the block is freed with the IOBuf. The block
+// is registered to the device when the rdma of brpc is initialized.
+char* AppendIOBufUserBlock(butil::IOBuf* iobuf, size_t size);
+
+// Return the first size bytes of iobuf, which point into the IOBuf when
+// they lie in its first block, or are copied into buffer otherwise.
+const char* FetchIOBuf(const butil::IOBuf& iobuf,
+                       size_t size,
+                       std::string* buffer);
+
 }  // namespace distributed
 }  // namespace paddle
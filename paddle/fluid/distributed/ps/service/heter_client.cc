@@ -21,6 +21,10 @@ namespace paddle {
 namespace distributed {
 PD_DEFINE_int32(heter_world_size, 100, "group size");  // group max size
 PD_DEFINE_int32(switch_send_recv_timeout_s, 600, "switch_send_recv_timeout_s");
+PD_DEFINE_bool(heter_use_rdma,
+               false,
+               "connect the heter services by the rdma of brpc, which needs "
+               "WITH_BRPC_RDMA and does not work with the encryption");
 
 std::shared_ptr<HeterClient> HeterClient::s_instance_ = nullptr;
 std::mutex HeterClient::mtx_;
@@ -79,6 +83,7 @@ void HeterClient::CreateClient2XpuConnection() {
   options.protocol = "baidu_std";
   options.connection_type = "single";
   options.timeout_ms = FLAGS_pserver_timeout_ms;
+  SetBrpcUseRdma(&options, FLAGS_heter_use_rdma);
 
   xpu_channels_.resize(xpu_list_.size());
   for (size_t i = 0; i < xpu_list_.size(); ++i) {
@@ -43,6 +43,7 @@ class Scope;
 namespace paddle {
 namespace distributed {
 PD_DECLARE_int32(pserver_timeout_ms);
+PD_DECLARE_bool(heter_use_rdma);
 using MultiVarMsg = ::paddle::distributed::MultiVariableMessage;
 using VarMsg = ::paddle::distributed::VariableMessage;
 
@@ -91,6 +92,7 @@ class HeterClient {
     options.protocol = "baidu_std";
     options.connection_type = "single";
     options.timeout_ms = FLAGS_pserver_timeout_ms;
+    SetBrpcUseRdma(&options, FLAGS_heter_use_rdma);
     std::vector<std::shared_ptr<brpc::Channel>>* client_channels = nullptr;
     if (peer_role == PEER_ROLE_IS_SWITCH) {
 #ifdef PADDLE_WITH_ARM_BRPC
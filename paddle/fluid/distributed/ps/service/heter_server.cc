@@ -35,6 +35,7 @@ void HeterServer::StartHeterService(bool neeed_encrypt) {
     options.mutable_ssl_options()->default_cert.certificate = "/cert.pem";
     options.mutable_ssl_options()->default_cert.private_key = "/key.pem";
   }
+  SetBrpcUseRdma(&options, FLAGS_heter_use_rdma);
   if (server_.Start(endpoint_.c_str(), &options) != 0) {
     VLOG(0) << "HeterServer start fail. Try again.";
     auto ip_port = ::paddle::string::Split(endpoint_, ':');
@@ -70,6 +71,7 @@ void HeterServer::StartHeterInterService(bool neeed_encrypt) {
     options.mutable_ssl_options()->default_cert.certificate = "/cert.pem";
     options.mutable_ssl_options()->default_cert.private_key = "/key.pem";
   }
+  SetBrpcUseRdma(&options, FLAGS_heter_use_rdma);
   if (server_inter_.Start(endpoint_inter_.c_str(), &options) != 0) {
     VLOG(4) << "switch inter server start fail. Try again.";
     auto ip_port = ::paddle::string::Split(endpoint_inter_, ':');
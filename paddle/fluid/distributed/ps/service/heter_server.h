@@ -60,6 +60,7 @@ namespace distributed {
 PD_DECLARE_int32(pserver_timeout_ms);
 PD_DECLARE_int32(heter_world_size);
 PD_DECLARE_int32(switch_send_recv_timeout_s);
+PD_DECLARE_bool(heter_use_rdma);
 
 using MultiVarMsg = MultiVariableMessage;
 using VarMsg = VariableMessage;
@@ -181,6 +181,18 @@ class PSClient {
     return fut;
   }
 
+  // move the values of keys from ssd to memory before they are pulled
+  virtual std::future<int32_t> PrefetchSparse(int shard_id UNUSED,
+                                              size_t table_id UNUSED,
+                                              const uint64_t *keys UNUSED,
+                                              size_t num UNUSED) {
+    VLOG(0) << "Did not implement";
+    std::promise<int32_t> promise;
+    std::future<int> fut = promise.get_future();
+    promise.set_value(-1);
+    return fut;
+  }
+
   virtual std::future<int32_t> PrintTableStat(uint32_t table_id) = 0;
   virtual std::future<int32_t> SaveCacheTable(uint32_t table_id UNUSED,
                                               uint16_t pass_id UNUSED,
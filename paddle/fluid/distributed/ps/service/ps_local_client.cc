@@ -261,6 +261,15 @@ int32_t PsLocalClient::Initialize() {
   return done();
 }
 
+::std::future<int32_t> PsLocalClient::PrefetchSparse(int shard_id,
+                                                     size_t table_id,
+                                                     const uint64_t* keys,
+                                                     size_t num) {
+  auto* table_ptr = GetTable(table_id);
+  table_ptr->Prefetch(shard_id, keys, num);
+  return done();
+}
+
 ::std::future<int32_t> PsLocalClient::PrintTableStat(uint32_t table_id) {
   auto* table_ptr = GetTable(table_id);
   std::pair<int64_t, int64_t> ret = table_ptr->PrintTableStat();
@@ -87,6 +87,11 @@ class PsLocalClient : public PSClient {
       const std::vector<std::unordered_map<uint64_t, uint32_t>>& keys2rank_vec,
       const uint16_t& dim_id = 0);
 
+  virtual ::std::future<int32_t> PrefetchSparse(int shard_id,
+                                                size_t table_id,
+                                                const uint64_t* keys,
+                                                size_t num);
+
   virtual ::std::future<int32_t> PrintTableStat(uint32_t table_id);
 
   virtual ::std::future<int32_t> SaveCacheTable(uint32_t table_id,
@@ -0,0 +1,139 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/service/sparse_hot_key_cache.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+
+namespace paddle {
+namespace distributed {
+
+static int64_t NowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+SparseHotKeyCache::SparseHotKeyCache(const SparseHotKeyCacheParameter& param,
+                                     size_t value_size)
+    : _param(param), _value_size(value_size) {
+  _shard_capacity = std::max<size_t>(1, _param.capacity() / kShardNum);
+}
+
+bool SparseHotKeyCache::Lookup(uint64_t key, float* value) {
+  auto& shard = GetShard(key);
+  {
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      auto& entry = shard.entries[it->second];
+      if (entry.hits < _param.max_staleness_pulls() &&
+          NowMs() - entry.update_ms <= _param.max_staleness_ms()) {
+        ++entry.hits;
+        entry.referenced = true;
+        memcpy(value,
+               shard.values.data() + it->second * _value_size,
+               _value_size);
+        _hit_count.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+  }
+  _miss_count.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void SparseHotKeyCache::Update(uint64_t key, const float* value, float score) {
+  auto& shard = GetShard(key);
+  std::lock_guard<std::mutex> guard(shard.mutex);
+  auto it = shard.index.find(key);
+  if (score < _param.hot_score_threshold()) {
+    if (it != shard.index.end()) {
+      EraseSlot(&shard, it->second);
+    }
+    return;
+  }
+  size_t slot = 0;
+  if (it != shard.index.end()) {
+    slot = it->second;
+  } else {
+    slot = AcquireSlot(&shard);
+    shard.index[key] = slot;
+  }
+  auto& entry = shard.entries[slot];
+  entry.key = key;
+  entry.update_ms = NowMs();
+  entry.hits = 0;
+  memcpy(shard.values.data() + slot * _value_size, value, _value_size);
+}
+
+size_t SparseHotKeyCache::AcquireSlot(Shard* shard) {
+  if (shard->entries.size() < _shard_capacity) {
+    shard->entries.push_back({0, 0, 0, false});
+    shard->values.resize(shard->entries.size() * _value_size);
+    return shard->entries.size() - 1;
+  }
+  // CLOCK: give the entries hit since the last sweep a second chance
+  while (true) {
+    if (shard->hand >= shard->entries.size()) {
+      shard->hand = 0;
+    }
+    auto& entry = shard->entries[shard->hand];
+    if (entry.referenced) {
+      entry.referenced = false;
+      ++shard->hand;
+      continue;
+    }
+    shard->index.erase(entry.key);
+    return shard->hand++;
+  }
+}
+
+void SparseHotKeyCache::EraseSlot(Shard* shard, size_t slot) {
+  size_t last = shard->entries.size() - 1;
+  shard->index.erase(shard->entries[slot].key);
+  if (slot != last) {
+    shard->entries[slot] = shard->entries[last];
+    memcpy(shard->values.data() + slot * _value_size,
+           shard->values.data() + last * _value_size,
+           _value_size);
+    shard->index[shard->entries[slot].key] = slot;
+  }
+  shard->entries.pop_back();
+  shard->values.resize(shard->entries.size() * _value_size);
+}
+
+void SparseHotKeyCache::Clear() {
+  for (auto& shard : _shards) {
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    shard.index.clear();
+    shard.entries.clear();
+    shard.values.clear();
+    shard.hand = 0;
+  }
+}
+
+size_t SparseHotKeyCache::Size() {
+  size_t size = 0;
+  for (auto& shard : _shards) {
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    size += shard.entries.size();
+  }
+  return size;
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,94 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+
+namespace paddle {
+namespace distributed {
+
+// SparseHotKeyCache keeps the pull values of the hottest keys of one sparse
+// table on the worker, so that PullSparse of those keys does not go to the
+// server every time.
+//
+// A value is admitted when the show_click_score of the pulled value (computed
+// by the table accessor from the server side show/click) reaches
+// hot_score_threshold. A cached value is served at most max_staleness_pulls
+// times and for at most max_staleness_ms after it was pulled, then the key is
+// pulled from the server again and the cached value is refreshed. When the
+// cache is full, an entry is evicted in CLOCK order, so that the keys hit
+// since the last sweep survive.
+class SparseHotKeyCache {
+ public:
+  // value_size is the size in bytes of one pull value
+  SparseHotKeyCache(const SparseHotKeyCacheParameter& param,
+                    size_t value_size);
+
+  // Copy the cached value of key to value and return true, return false if
+  // key is not cached or the cached value is stale.
+  bool Lookup(uint64_t key, float* value);
+  // Cache or refresh the value of key just pulled from the server, the entry
+  // is dropped if score is lower than hot_score_threshold.
+  void Update(uint64_t key, const float* value, float score);
+  // Drop all the cached values, e.g. after the table is loaded or cleared.
+  void Clear();
+
+  size_t Size();
+  uint64_t HitCount() const { return _hit_count.load(); }
+  uint64_t MissCount() const { return _miss_count.load(); }
+
+ private:
+  static constexpr size_t kShardNum = 32;
+  static_assert(kShardNum == (1 << (64 - 59)),
+                "GetShard takes the top 5 bits of the hashed key");
+
+  struct Entry {
+    uint64_t key;
+    int64_t update_ms;
+    uint32_t hits;
+    bool referenced;
+  };
+
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, size_t> index;
+    std::vector<Entry> entries;
+    std::vector<char> values;
+    size_t hand = 0;
+  };
+
+  Shard& GetShard(uint64_t key) {
+    return _shards[(key * 0x9E3779B97F4A7C15ULL) >> 59];
+  }
+  // Return the slot for a new entry in shard, evict one if shard is full.
+  size_t AcquireSlot(Shard* shard);
+  void EraseSlot(Shard* shard, size_t slot);
+
+  SparseHotKeyCacheParameter _param;
+  size_t _value_size;
+  size_t _shard_capacity;
+  Shard _shards[kShardNum];
+  std::atomic<uint64_t> _hit_count{0};
+  std::atomic<uint64_t> _miss_count{0};
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,198 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/service/sparse_push_codec.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+
+namespace paddle {
+namespace distributed {
+
+template <typename T>
+static void EncodeHalf(const float* grad, size_t dim, char* out) {
+  for (size_t i = 0; i < dim; ++i) {
+    T half(grad[i]);
+    memcpy(out + i * sizeof(T), &half, sizeof(T));
+  }
+}
+
+template <typename T>
+static void DecodeHalf(const char* in, size_t dim, float* grad) {
+  for (size_t i = 0; i < dim; ++i) {
+    T half;
+    memcpy(&half, in + i * sizeof(T), sizeof(T));
+    grad[i] = static_cast<float>(half);
+  }
+}
+
+SparsePushCodec::SparsePushCodec(const SparsePushCompressParameter& param,
+                                 size_t update_dim,
+                                 size_t grad_index)
+    : _param(param), _update_dim(update_dim), _grad_index(grad_index) {
+  CHECK_LE(grad_index, update_dim);
+  _header = _param.SerializeAsString();
+  _grad_dim = update_dim - grad_index;
+  _topk = 0;
+  size_t grad_size = 0;
+  switch (_param.codec()) {
+    case SparsePushCompressParameter::FP16:
+    case SparsePushCompressParameter::BF16:
+      grad_size = _grad_dim * sizeof(uint16_t);
+      break;
+    case SparsePushCompressParameter::INT8:
+      grad_size = sizeof(float) + _grad_dim * sizeof(int8_t);
+      break;
+    case SparsePushCompressParameter::TOPK:
+      CHECK_LE(_grad_dim, 65536UL) << "TOPK indices are uint16";
+      if (_grad_dim > 0) {
+        _topk = std::min(
+            _grad_dim,
+            std::max<size_t>(
+                1, std::ceil(_param.topk_ratio() * _grad_dim - 1e-6)));
+      }
+      grad_size = _topk * (sizeof(float) + sizeof(uint16_t));
+      break;
+    default:
+      grad_size = _grad_dim * sizeof(float);
+      break;
+  }
+  _encoded_size = _grad_index * sizeof(float) + grad_size;
+}
+
+void SparsePushCodec::Encode(uint64_t key, const float* value, char* out) {
+  memcpy(out, value, _grad_index * sizeof(float));
+  out += _grad_index * sizeof(float);
+  const float* grad = value + _grad_index;
+  switch (_param.codec()) {
+    case SparsePushCompressParameter::FP16:
+      EncodeHalf<phi::dtype::float16>(grad, _grad_dim, out);
+      break;
+    case SparsePushCompressParameter::BF16:
+      EncodeHalf<phi::dtype::bfloat16>(grad, _grad_dim, out);
+      break;
+    case SparsePushCompressParameter::INT8: {
+      float max_abs = 0;
+      for (size_t i = 0; i < _grad_dim; ++i) {
+        max_abs = std::max(max_abs, std::fabs(grad[i]));
+      }
+      float scale = max_abs / 127;
+      memcpy(out, &scale, sizeof(float));
+      int8_t* quant = reinterpret_cast<int8_t*>(out + sizeof(float));
+      for (size_t i = 0; i < _grad_dim; ++i) {
+        quant[i] =
+            scale > 0 ? static_cast<int8_t>(std::round(grad[i] / scale)) : 0;
+      }
+      break;
+    }
+    case SparsePushCompressParameter::TOPK:
+      EncodeTopK(key, grad, out);
+      break;
+    default:
+      memcpy(out, grad, _grad_dim * sizeof(float));
+      break;
+  }
+}
+
+void SparsePushCodec::EncodeTopK(uint64_t key, const float* grad, char* out) {
+  if (_topk == 0) {
+    return;
+  }
+  thread_local std::vector<float> sum;
+  thread_local std::vector<uint16_t> index;
+  sum.assign(grad, grad + _grad_dim);
+  index.resize(_grad_dim);
+  for (size_t i = 0; i < _grad_dim; ++i) {
+    index[i] = i;
+  }
+
+  std::vector<float>* residual = nullptr;
+  std::unique_lock<std::mutex> lock;
+  if (_param.error_feedback()) {
+    auto& shard = _residual_shards[key % kShardNum];
+    lock = std::unique_lock<std::mutex>(shard.mutex);
+    residual = &shard.residuals[key];
+    if (residual->empty()) {
+      residual->resize(_grad_dim, 0);
+    }
+    for (size_t i = 0; i < _grad_dim; ++i) {
+      sum[i] += (*residual)[i];
+    }
+  }
+
+  std::nth_element(index.begin(),
+                   index.begin() + _topk - 1,
+                   index.end(),
+                   [](uint16_t a, uint16_t b) {
+                     return std::fabs(sum[a]) > std::fabs(sum[b]);
+                   });
+  char* index_out = out + _topk * sizeof(float);
+  for (size_t i = 0; i < _topk; ++i) {
+    memcpy(out + i * sizeof(float), &sum[index[i]], sizeof(float));
+    memcpy(index_out + i * sizeof(uint16_t), &index[i], sizeof(uint16_t));
+  }
+  if (residual != nullptr) {
+    for (size_t i = 0; i < _topk; ++i) {
+      sum[index[i]] = 0;
+    }
+    residual->assign(sum.begin(), sum.end());
+  }
+}
+
+void SparsePushCodec::Decode(const char* in, float* value) const {
+  memcpy(value, in, _grad_index * sizeof(float));
+  in += _grad_index * sizeof(float);
+  float* grad = value + _grad_index;
+  switch (_param.codec()) {
+    case SparsePushCompressParameter::FP16:
+      DecodeHalf<phi::dtype::float16>(in, _grad_dim, grad);
+      break;
+    case SparsePushCompressParameter::BF16:
+      DecodeHalf<phi::dtype::bfloat16>(in, _grad_dim, grad);
+      break;
+    case SparsePushCompressParameter::INT8: {
+      float scale = 0;
+      memcpy(&scale, in, sizeof(float));
+      auto* quant = reinterpret_cast<const int8_t*>(in + sizeof(float));
+      for (size_t i = 0; i < _grad_dim; ++i) {
+        grad[i] = quant[i] * scale;
+      }
+      break;
+    }
+    case SparsePushCompressParameter::TOPK: {
+      memset(grad, 0, _grad_dim * sizeof(float));
+      const char* index_in = in + _topk * sizeof(float);
+      for (size_t i = 0; i < _topk; ++i) {
+        uint16_t index = 0;
+        memcpy(&index, index_in + i * sizeof(uint16_t), sizeof(uint16_t));
+        if (index < _grad_dim) {
+          memcpy(grad + index, in + i * sizeof(float), sizeof(float));
+        }
+      }
+      break;
+    }
+    default:
+      memcpy(grad, in, _grad_dim * sizeof(float));
+      break;
+  }
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,81 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+
+namespace paddle {
+namespace distributed {
+
+// SparsePushCodec compresses the push values of a sparse table sent by the
+// communicator, and decompresses them on the server before the table pushes
+// them to the sgd rule.
+//
+// The first grad_index dims of a push value (slot, show, click ...) are sent
+// as fp32, the gradients after them are encoded by param.codec():
+//   FP16/BF16: one 16 bits float per gradient
+//   INT8:      a fp32 scale max(|g|) / 127 and one int8 per gradient
+//   TOPK:      the k = ceil(topk_ratio * grad_dim) largest gradients by
+//              magnitude, as k fp32 values followed by k uint16 indices
+// With error_feedback, TOPK keeps the dropped gradients of every key on the
+// worker and adds them to the next push of the key.
+//
+// All the encoded values of a codec have the same size, so the server only
+// needs the param sent with the request to locate and decode them.
+class SparsePushCodec {
+ public:
+  SparsePushCodec(const SparsePushCompressParameter& param,
+                  size_t update_dim,
+                  size_t grad_index);
+
+  const SparsePushCompressParameter& Param() const { return _param; }
+  // param serialized, sent as params(1) of the push request
+  const std::string& Header() const { return _header; }
+  // size in bytes of one encoded push value
+  size_t EncodedSize() const { return _encoded_size; }
+
+  // Encode the push value of key to out, which has EncodedSize() bytes.
+  void Encode(uint64_t key, const float* value, char* out);
+  // Decode to value, which has update_dim floats.
+  void Decode(const char* in, float* value) const;
+
+ private:
+  static constexpr size_t kShardNum = 16;
+
+  struct ResidualShard {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, std::vector<float>> residuals;
+  };
+
+  void EncodeTopK(uint64_t key, const float* grad, char* out);
+
+  SparsePushCompressParameter _param;
+  std::string _header;
+  size_t _update_dim;
+  size_t _grad_index;
+  size_t _grad_dim;
+  size_t _topk;
+  size_t _encoded_size;
+  ResidualShard _residual_shards[kShardNum];
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -181,6 +181,13 @@ class ValueAccessor {
   virtual float GetField(float* value UNUSED, const std::string& name UNUSED) {
     return 0.0;
   }
+  // show_click_score of a pull value, used by worker to pick the hot keys
+  virtual float PullValueShowClickScore(float* select_value UNUSED) {
+    return 0.0;
+  }
+  // index of the first gradient in a push value, the dims before it (slot,
+  // show, click ...) are not compressed by SparsePushCodec
+  virtual int PushValueGradIndex() { return 0; }
   virtual robin_hood::unordered_set<float>* GetFilteredSlots() {
     return nullptr;
   }
@@ -36,6 +36,8 @@
 
 PHI_DECLARE_bool(graph_load_in_parallel);
 PHI_DECLARE_bool(graph_get_neighbor_id);
+PHI_DECLARE_bool(graph_compact_edges);
+PHI_DECLARE_bool(graph_compact_edges_quantize_weight);
 PHI_DECLARE_int32(gpugraph_storage_mode);
 PHI_DECLARE_uint64(gpugraph_slot_feasign_max_num);
 PHI_DECLARE_bool(graph_metapath_split_opt);
@@ -740,6 +742,22 @@ void GraphTable::feature_shrink_to_fit() {
   for (size_t i = 0; i < tasks.size(); i++) tasks[i].get();
 }
 
+void GraphTable::compact_edges(int idx) {
+  VLOG(0) << "begin compact edges of edge_type[" << id_to_edge[idx] << "]";
+  std::vector<std::future<size_t>> tasks;
+  for (auto &shard : edge_shards[idx]) {
+    tasks.push_back(
+        load_node_edge_task_pool->enqueue([&shard, this]() -> size_t {
+          return shard->compact_edges(
+              FLAGS_graph_compact_edges_quantize_weight);
+        }));
+  }
+  size_t edge_num = 0;
+  for (size_t i = 0; i < tasks.size(); i++) edge_num += tasks[i].get();
+  VLOG(0) << "end compact " << edge_num << " edges of edge_type["
+          << id_to_edge[idx] << "]";
+}
+
 void GraphTable::merge_feature_shard() {
   VLOG(0) << "begin merge_feature_shard";
   std::vector<std::future<int>> tasks;
@@ -2615,6 +2633,10 @@ int32_t GraphTable::load_edges(const std::string &path,
   }
 #endif
 
+  if (FLAGS_graph_compact_edges) {
+    compact_edges(idx);
+  }
+
   if (!build_sampler_on_cpu) {
     // To reduce memory overhead, CPU samplers won't be created in gpugraph.
     // In order not to affect the sampler function of other scenario,
@@ -2790,7 +2812,7 @@ int32_t GraphTable::random_sample_neighbors(
       LRUResponse response = LRUResponse::blocked;
       if (use_cache) {
         response =
-            scaled_lru->query(i, id_list[i].data(), id_list[i].size(), r);
+            sample_cache->query(i, id_list[i].data(), id_list[i].size(), r);
       }
       size_t index = 0;
       std::vector<SampleResult> sample_res;
@@ -2858,7 +2880,7 @@ int32_t GraphTable::random_sample_neighbors(
         }
       }
       if (!sample_res.empty()) {
-        scaled_lru->insert(
+        sample_cache->insert(
             i, sample_keys.data(), sample_res.data(), sample_keys.size());
       }
       return 0;
@@ -19,6 +19,7 @@
 #include <pthread.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdio>
 #include <ctime>
@@ -140,6 +141,15 @@ class GraphShard {
     }
   }
 
+  size_t compact_edges(bool quantize_weight) {
+    size_t edge_num = 0;
+    for (size_t i = 0; i < bucket.size(); i++) {
+      bucket[i]->compact_edges(quantize_weight);
+      edge_num += bucket[i]->get_neighbor_size();
+    }
+    return edge_num;
+  }
+
   void merge_shard(GraphShard *&shard) {  // NOLINT
     bucket.reserve(bucket.size() + shard->bucket.size());
     for (size_t i = 0; i < shard->bucket.size(); i++) {
@@ -167,6 +177,7 @@ struct SampleKey {
   uint64_t node_key;
   size_t sample_size;
   bool is_weighted;
+  SampleKey() : idx(0), node_key(0), sample_size(0), is_weighted(false) {}
   SampleKey(int _idx,
             uint64_t _node_key,
             size_t _sample_size,
@@ -186,6 +197,7 @@ class SampleResult {
  public:
   size_t actual_size;
   std::shared_ptr<char> buffer;
+  SampleResult() : actual_size(0) {}
   SampleResult(size_t _actual_size, std::shared_ptr<char> &_buffer)  // NOLINT
       : actual_size(_actual_size), buffer(_buffer) {}
   SampleResult(size_t _actual_size, char *_buffer)
@@ -194,251 +206,128 @@ class SampleResult {
   ~SampleResult() {}
 };
 
+// A sharded CLOCK cache of the sample results, one shard per sample task
+// pool. Every shard keeps a fixed slab of entries, a hit only takes the
+// read lock of its shard and touches the atomic reference bit and ttl of
+// the entry, so the hits never serialize each other. An insert takes the
+// write lock and sweeps the clock hand for a victim: a free or expired
+// entry, or the first one whose reference bit is already cleared.
+// A result is served ttl times at most before it is sampled again.
 template <typename K, typename V>
-class LRUNode {
+class SampleClockCache {
  public:
-  LRUNode(K _key, V _data, size_t _ttl) : key(_key), data(_data), ttl(_ttl) {
-    next = pre = NULL;
-  }
-  K key;
-  V data;
-  size_t ttl;
-  // time to live
-  LRUNode<K, V> *pre, *next;
-};
-template <typename K, typename V>
-class ScaledLRU;
-
-template <typename K, typename V>
-class RandomSampleLRU {
- public:
-  explicit RandomSampleLRU(ScaledLRU<K, V> *_father) {
-    father = _father;
-    remove_count = 0;
-    node_size = 0;
-    node_head = node_end = NULL;
-    global_ttl = father->ttl;
-    total_diff = 0;
-  }
-
-  ~RandomSampleLRU() {
-    LRUNode<K, V> *p;
-    while (node_head != NULL) {
-      p = node_head->next;
-      delete node_head;
-      node_head = p;
+  SampleClockCache(size_t shard_num, size_t size_limit, size_t ttl)
+      : shard_num_(shard_num), ttl_(static_cast<int>(ttl)) {
+    shards_.reset(new Shard[shard_num_]);
+    size_t capacity = std::max(static_cast<size_t>(1), size_limit / shard_num);
+    for (size_t i = 0; i < shard_num_; i++) {
+      shards_[i].slab.reset(new Entry[capacity]);
+      shards_[i].capacity = capacity;
+      shards_[i].index.reserve(capacity);
     }
   }
-  LRUResponse query(K *keys,
+
+  LRUResponse query(size_t index,
+                    K *keys,
                     size_t length,
                     std::vector<std::pair<K, V>> &res) {  // NOLINT
-    if (pthread_rwlock_tryrdlock(&father->rwlock) != 0)
-      return LRUResponse::blocked;
-    // pthread_rwlock_rdlock(&father->rwlock);
-    int init_size = node_size - remove_count;
-    process_redundant(length * 3);
-
+    Shard &shard = shards_[index];
+    phi::AutoRDLock lock(&shard.rwlock);
+    size_t hit = 0;
     for (size_t i = 0; i < length; i++) {
-      auto iter = key_map.find(keys[i]);
-      if (iter != key_map.end()) {
-        res.emplace_back(keys[i], iter->second->data);
-        iter->second->ttl--;
-        if (iter->second->ttl == 0) {
-          remove(iter->second);
-          if (remove_count != 0) remove_count--;
-        } else {
-          move_to_tail(iter->second);
-        }
+      auto iter = shard.index.find(keys[i]);
+      if (iter == shard.index.end()) {
+        continue;
       }
+      Entry &entry = shard.slab[iter->second];
+      int left = entry.ttl.load(std::memory_order_relaxed);
+      while (left > 0 && !entry.ttl.compare_exchange_weak(
+                             left, left - 1, std::memory_order_relaxed)) {
+      }
+      // an expired entry waits for the clock hand to take it
+      if (left <= 0) {
+        continue;
+      }
+      if (!entry.referenced.load(std::memory_order_relaxed)) {
+        entry.referenced.store(true, std::memory_order_relaxed);
+      }
+      res.emplace_back(keys[i], entry.data);
+      hit++;
     }
-    total_diff += node_size - remove_count - init_size;
-    if (total_diff >= 500 || total_diff < -500) {
-      father->handle_size_diff(total_diff);
-      total_diff = 0;
-    }
-    pthread_rwlock_unlock(&father->rwlock);
+    hit_count_.fetch_add(hit, std::memory_order_relaxed);
+    miss_count_.fetch_add(length - hit, std::memory_order_relaxed);
     return LRUResponse::ok;
   }
-  LRUResponse insert(K *keys, V *data, size_t length) {
-    if (pthread_rwlock_tryrdlock(&father->rwlock) != 0)
-      return LRUResponse::blocked;
-    // pthread_rwlock_rdlock(&father->rwlock);
-    int init_size = node_size - remove_count;
-    process_redundant(length * 3);
+
+  LRUResponse insert(size_t index, K *keys, V *data, size_t length) {
+    Shard &shard = shards_[index];
+    phi::AutoWRLock lock(&shard.rwlock);
     for (size_t i = 0; i < length; i++) {
-      auto iter = key_map.find(keys[i]);
-      if (iter != key_map.end()) {
-        move_to_tail(iter->second);
-        iter->second->ttl = global_ttl;
-        iter->second->data = data[i];
+      auto iter = shard.index.find(keys[i]);
+      uint32_t slot;
+      if (iter != shard.index.end()) {
+        slot = iter->second;
       } else {
-        LRUNode<K, V> *temp = new LRUNode<K, V>(keys[i], data[i], global_ttl);
-        add_new(temp);
+        slot = evict(&shard);
+        shard.slab[slot].key = keys[i];
+        shard.slab[slot].used = true;
+        shard.slab[slot].referenced.store(false, std::memory_order_relaxed);
+        shard.index[keys[i]] = slot;
       }
+      shard.slab[slot].data = data[i];
+      shard.slab[slot].ttl.store(ttl_, std::memory_order_relaxed);
     }
-    total_diff += node_size - remove_count - init_size;
-    if (total_diff >= 500 || total_diff < -500) {
-      father->handle_size_diff(total_diff);
-      total_diff = 0;
-    }
-
-    pthread_rwlock_unlock(&father->rwlock);
     return LRUResponse::ok;
   }
-  void remove(LRUNode<K, V> *node) {
-    fetch(node);
-    node_size--;
-    key_map.erase(node->key);
-    delete node;
-  }
-
-  void process_redundant(int process_size) {
-    int length = std::min(remove_count, process_size);
-    while (length--) {
-      remove(node_head);
-      remove_count--;
-    }
-  }
-
-  void move_to_tail(LRUNode<K, V> *node) {
-    fetch(node);
-    place_at_tail(node);
-  }
-
-  void add_new(LRUNode<K, V> *node) {
-    node->ttl = global_ttl;
-    place_at_tail(node);
-    node_size++;
-    key_map[node->key] = node;
-  }
-  void place_at_tail(LRUNode<K, V> *node) {
-    if (node_end == NULL) {
-      node_head = node_end = node;
-      node->next = node->pre = NULL;
-    } else {
-      node_end->next = node;
-      node->pre = node_end;
-      node->next = NULL;
-      node_end = node;
-    }
-  }
 
-  void fetch(LRUNode<K, V> *node) {
-    if (node->pre) {
-      node->pre->next = node->next;
-    } else {
-      node_head = node->next;
-    }
-    if (node->next) {
-      node->next->pre = node->pre;
-    } else {
-      node_end = node->pre;
-    }
-  }
+  size_t get_ttl() { return ttl_; }
+  uint64_t hit_count() const { return hit_count_.load(); }
+  uint64_t miss_count() const { return miss_count_.load(); }
+  uint64_t evict_count() const { return evict_count_.load(); }
 
  private:
-  std::unordered_map<K, LRUNode<K, V> *> key_map;
-  ScaledLRU<K, V> *father;
-  size_t global_ttl, size_limit;
-  int node_size, total_diff;
-  LRUNode<K, V> *node_head, *node_end;
-  friend class ScaledLRU<K, V>;
-  int remove_count;
-};
-
-template <typename K, typename V>
-class ScaledLRU {
- public:
-  ScaledLRU(size_t _shard_num, size_t size_limit, size_t _ttl)
-      : size_limit(size_limit), ttl(_ttl) {
-    shard_num = _shard_num;
-    pthread_rwlock_init(&rwlock, NULL);
-    stop = false;
-    thread_pool.reset(new ::ThreadPool(1));
-    global_count = 0;
-    lru_pool = std::vector<RandomSampleLRU<K, V>>(shard_num,
-                                                  RandomSampleLRU<K, V>(this));
-    shrink_job = std::thread([this]() -> void {
-      while (true) {
-        {
-          std::unique_lock<std::mutex> lock(mutex_);
-          cv_.wait_for(lock, std::chrono::milliseconds(20000));
-          if (stop) {
-            return;
-          }
-        }
-        auto status =
-            thread_pool->enqueue([this]() -> int { return Shrink(); });
-        status.wait();
-      }
-    });
-    shrink_job.detach();
-  }
-  ~ScaledLRU() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    stop = true;
-    cv_.notify_one();
-  }
-  LRUResponse query(size_t index,
-                    K *keys,
-                    size_t length,
-                    std::vector<std::pair<K, V>> &res) {  // NOLINT
-    return lru_pool[index].query(keys, length, res);
-  }
-  LRUResponse insert(size_t index, K *keys, V *data, size_t length) {
-    return lru_pool[index].insert(keys, data, length);
-  }
-  int Shrink() {
-    size_t node_size = 0;
-    for (size_t i = 0; i < lru_pool.size(); i++) {
-      node_size += lru_pool[i].node_size - lru_pool[i].remove_count;
-    }
+  struct Entry {
+    K key;
+    V data;
+    std::atomic<int> ttl{0};
+    std::atomic<bool> referenced{false};
+    bool used = false;
+  };
+  struct Shard {
+    phi::RWLock rwlock;
+    std::unique_ptr<Entry[]> slab;
+    size_t capacity = 0;
+    size_t hand = 0;
+    std::unordered_map<K, uint32_t> index;
+  };
 
-    if (node_size <= static_cast<size_t>(1.1 * size_limit) + 1) return 0;
-    if (pthread_rwlock_wrlock(&rwlock) == 0) {
-      global_count = 0;
-      for (size_t i = 0; i < lru_pool.size(); i++) {
-        global_count += lru_pool[i].node_size - lru_pool[i].remove_count;
-      }
-      if (static_cast<size_t>(global_count) > size_limit) {
-        size_t remove = global_count - size_limit;
-        for (size_t i = 0; i < lru_pool.size(); i++) {
-          lru_pool[i].total_diff = 0;
-          lru_pool[i].remove_count +=
-              1.0 * (lru_pool[i].node_size - lru_pool[i].remove_count) /
-              global_count * remove;
-        }
+  // find a slot for a new key under the write lock of the shard
+  uint32_t evict(Shard *shard) {
+    while (true) {
+      uint32_t slot = static_cast<uint32_t>(shard->hand);
+      shard->hand = (shard->hand + 1) % shard->capacity;
+      Entry &entry = shard->slab[slot];
+      if (!entry.used) {
+        return slot;
       }
-      pthread_rwlock_unlock(&rwlock);
-      return 0;
-    }
-    return 0;
-  }
-
-  void handle_size_diff(int diff) {
-    if (diff != 0) {
-      __sync_fetch_and_add(&global_count, diff);
-      if (global_count > static_cast<int>(1.25 * size_limit)) {
-        thread_pool->enqueue([this]() -> int { return Shrink(); });
+      if (entry.ttl.load(std::memory_order_relaxed) > 0 &&
+          entry.referenced.exchange(false, std::memory_order_relaxed)) {
+        continue;
       }
+      shard->index.erase(entry.key);
+      entry.used = false;
+      entry.data = V();
+      evict_count_.fetch_add(1, std::memory_order_relaxed);
+      return slot;
     }
   }
 
-  size_t get_ttl() { return ttl; }
-
- private:
-  pthread_rwlock_t rwlock;
-  size_t shard_num;
-  int global_count;
-  size_t size_limit, total, hit;
-  size_t ttl;
-  bool stop;
-  std::thread shrink_job;
-  std::vector<RandomSampleLRU<K, V>> lru_pool;
-  mutable std::mutex mutex_;
-  std::condition_variable cv_;
-  std::shared_ptr<::ThreadPool> thread_pool;
-  friend class RandomSampleLRU<K, V>;
+  size_t shard_num_;
+  int ttl_;
+  std::unique_ptr<Shard[]> shards_;
+  std::atomic<uint64_t> hit_count_{0};
+  std::atomic<uint64_t> miss_count_{0};
+  std::atomic<uint64_t> evict_count_{0};
 };
 enum GraphTableType { EDGE_TABLE, FEATURE_TABLE, NODE_TABLE };
 class GraphTable : public Table {
@@ -699,6 +588,7 @@ class GraphTable : public Table {
   void clear_feature_shard();
   void clear_node_shard();
   void feature_shrink_to_fit();
+  void compact_edges(int idx);
   void merge_feature_shard();
   void release_graph();
   void release_graph_edge();
@@ -707,7 +597,7 @@ class GraphTable : public Table {
     {
       std::unique_lock<std::mutex> lock(mutex_);
       if (use_cache == false) {
-        scaled_lru.reset(new ScaledLRU<SampleKey, SampleResult>(
+        sample_cache.reset(new SampleClockCache<SampleKey, SampleResult>(
             task_pool_size_, size_limit, ttl));
         use_cache = true;
       }
@@ -825,7 +715,7 @@ class GraphTable : public Table {
   std::vector<std::shared_ptr<::ThreadPool>> _cpu_worker_pool;
   std::vector<std::shared_ptr<std::mt19937_64>> _shards_task_rng_pool;
   std::shared_ptr<::ThreadPool> load_node_edge_task_pool;
-  std::shared_ptr<ScaledLRU<SampleKey, SampleResult>> scaled_lru;
+  std::shared_ptr<SampleClockCache<SampleKey, SampleResult>> sample_cache;
   std::unordered_set<uint64_t> extra_nodes;
   std::unordered_map<uint64_t, size_t> extra_nodes_to_thread_index;
   bool use_cache, use_duplicate_nodes;
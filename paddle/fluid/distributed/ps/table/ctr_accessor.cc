@@ -34,6 +34,13 @@ int CtrCommonAccessor::Initialize() {
   common_feature_value.embed_sgd_dim = _embed_sgd_rule->Dim();
   common_feature_value.embedx_dim = _config.embedx_dim();
   common_feature_value.embedx_sgd_dim = _embedx_sgd_rule->Dim();
+  const auto& quant_param = _config.value_quant_param();
+  _embedx_w_quant.Init(quant_param.embedx_type(), _config.embedx_dim());
+  _embedx_sgd_quant.Init(quant_param.embedx_sgd_type(),
+                         _embedx_sgd_rule->Dim());
+  _embedx_fp32 = _embedx_w_quant.IsFP32() && _embedx_sgd_quant.IsFP32();
+  common_feature_value.embedx_size = _embedx_w_quant.Size();
+  common_feature_value.embedx_sgd_size = _embedx_sgd_quant.Size();
   _show_click_decay_rate = _config.ctr_accessor_param().show_click_decay_rate();
   _ssd_unseenday_threshold =
       _config.ctr_accessor_param().ssd_unseenday_threshold();
@@ -55,8 +62,9 @@ void CtrCommonAccessor::InitAccessorInfo() {
   _accessor_info.select_size = _accessor_info.select_dim * sizeof(float);
   _accessor_info.update_dim = 4 + embedx_dim;
   _accessor_info.update_size = _accessor_info.update_dim * sizeof(float);
-  _accessor_info.mf_size =
-      (embedx_dim + common_feature_value.embedx_sgd_dim) * sizeof(float);
+  _accessor_info.mf_size = (common_feature_value.embedx_size +
+                            common_feature_value.embedx_sgd_size) *
+                           sizeof(float);
 }
 
 bool CtrCommonAccessor::Shrink(float* value) {
@@ -180,9 +188,19 @@ int32_t CtrCommonAccessor::Create(float** values, size_t num) {
     _embed_sgd_rule->InitValue(value + common_feature_value.EmbedWIndex(),
                                value + common_feature_value.EmbedG2SumIndex(),
                                zero_init);
-    _embedx_sgd_rule->InitValue(value + common_feature_value.EmbedxWIndex(),
-                                value + common_feature_value.EmbedxG2SumIndex(),
-                                false);
+    if (_embedx_fp32) {
+      _embedx_sgd_rule->InitValue(
+          value + common_feature_value.EmbedxWIndex(),
+          value + common_feature_value.EmbedxG2SumIndex(),
+          false);
+    } else {
+      _embedx_sgd_rule->InitQuantValue(
+          value + common_feature_value.EmbedxWIndex(),
+          _embedx_w_quant,
+          value + common_feature_value.EmbedxG2SumIndex(),
+          _embedx_sgd_quant,
+          false);
+    }
   }
   return 0;
 }
@@ -213,9 +231,15 @@ int32_t CtrCommonAccessor::Select(float** select_values,
         value[common_feature_value.ClickIndex()];
     select_value[CtrCommonPullValue::EmbedWIndex()] =
         value[common_feature_value.EmbedWIndex()];
-    memcpy(select_value + CtrCommonPullValue::EmbedxWIndex(),
-           value + common_feature_value.EmbedxWIndex(),
-           embedx_dim * sizeof(float));
+    if (_embedx_w_quant.IsFP32()) {
+      memcpy(select_value + CtrCommonPullValue::EmbedxWIndex(),
+             value + common_feature_value.EmbedxWIndex(),
+             embedx_dim * sizeof(float));
+    } else {
+      _embedx_w_quant.Dequantize(value + common_feature_value.EmbedxWIndex(),
+                                 select_value +
+                                     CtrCommonPullValue::EmbedxWIndex());
+    }
   }
   return 0;
 }
@@ -246,6 +270,7 @@ int32_t CtrCommonAccessor::Merge(float** update_values,
 int32_t CtrCommonAccessor::Update(float** update_values,
                                   const float** push_values,
                                   size_t num) {
+  std::vector<float> scales(num);
   for (size_t value_item = 0; value_item < num; ++value_item) {
     float* update_value = update_values[value_item];
     const float* push_value = push_values[value_item];
@@ -265,16 +290,35 @@ int32_t CtrCommonAccessor::Update(float** update_values,
     }
     VLOG(3) << "accessor show scale:" << _show_scale
             << ", push_show:" << push_show;
-    _embed_sgd_rule->UpdateValue(
-        update_value + common_feature_value.EmbedWIndex(),
-        update_value + common_feature_value.EmbedG2SumIndex(),
-        push_value + CtrCommonPushValue::EmbedGIndex(),
-        push_show);
-    _embedx_sgd_rule->UpdateValue(
-        update_value + common_feature_value.EmbedxWIndex(),
-        update_value + common_feature_value.EmbedxG2SumIndex(),
-        push_value + CtrCommonPushValue::EmbedxGIndex(),
-        push_show);
+    scales[value_item] = push_show;
+  }
+  // the sgd rules update all the keys in one call each
+  _embed_sgd_rule->UpdateValueBatch(update_values,
+                                    common_feature_value.EmbedWIndex(),
+                                    common_feature_value.EmbedG2SumIndex(),
+                                    push_values,
+                                    CtrCommonPushValue::EmbedGIndex(),
+                                    scales.data(),
+                                    num);
+  if (_embedx_fp32) {
+    _embedx_sgd_rule->UpdateValueBatch(update_values,
+                                       common_feature_value.EmbedxWIndex(),
+                                       common_feature_value.EmbedxG2SumIndex(),
+                                       push_values,
+                                       CtrCommonPushValue::EmbedxGIndex(),
+                                       scales.data(),
+                                       num);
+  } else {
+    _embedx_sgd_rule->UpdateQuantValueBatch(
+        update_values,
+        common_feature_value.EmbedxWIndex(),
+        _embedx_w_quant,
+        common_feature_value.EmbedxG2SumIndex(),
+        _embedx_sgd_quant,
+        push_values,
+        CtrCommonPushValue::EmbedxGIndex(),
+        scales.data(),
+        num);
   }
   return 0;
 }
@@ -324,21 +368,57 @@ std::string CtrCommonAccessor::ParseToString(const float* v, int param) {
   auto score = ShowClickScore(show, click);
   if (score >= _config.embedx_threshold() &&
       param > common_feature_value.EmbedxWIndex()) {
-    for (auto i = common_feature_value.EmbedxWIndex();
-         i < common_feature_value.Dim();
-         ++i) {
-      os << " " << v[i];
+    if (_embedx_fp32) {
+      for (auto i = common_feature_value.EmbedxWIndex();
+           i < common_feature_value.Dim();
+           ++i) {
+        os << " " << v[i];
+      }
+    } else {
+      // the quantized embedx is saved as fp32
+      thread_local std::vector<float> embedx;
+      embedx.resize(_embedx_w_quant.Dim() + _embedx_sgd_quant.Dim());
+      _embedx_w_quant.Dequantize(v + common_feature_value.EmbedxWIndex(),
+                                 embedx.data());
+      _embedx_sgd_quant.Dequantize(
+          v + common_feature_value.EmbedxG2SumIndex(),
+          embedx.data() + _embedx_w_quant.Dim());
+      for (auto x : embedx) {
+        os << " " << x;
+      }
     }
   }
   return os.str();
 }
 
 int CtrCommonAccessor::ParseFromString(const std::string& str, float* value) {
-  _embedx_sgd_rule->InitValue(value + common_feature_value.EmbedxWIndex(),
-                              value + common_feature_value.EmbedxG2SumIndex());
-  auto ret = paddle::string::str_to_float(str.data(), value);
+  if (_embedx_fp32) {
+    _embedx_sgd_rule->InitValue(
+        value + common_feature_value.EmbedxWIndex(),
+        value + common_feature_value.EmbedxG2SumIndex());
+    auto ret = paddle::string::str_to_float(str.data(), value);
+    CHECK(ret >= 6) << "expect more than 6 real:" << ret;
+    return ret;
+  }
+  // parse the fp32 value, then quantize its embedx
+  size_t embedx_index = common_feature_value.EmbedxWIndex();
+  size_t embedx_dim = _embedx_w_quant.Dim();
+  thread_local std::vector<float> fp32_value;
+  fp32_value.resize(embedx_index + embedx_dim + _embedx_sgd_quant.Dim());
+  _embedx_sgd_rule->InitValue(fp32_value.data() + embedx_index,
+                              fp32_value.data() + embedx_index + embedx_dim);
+  auto ret = paddle::string::str_to_float(str.data(), fp32_value.data());
   CHECK(ret >= 6) << "expect more than 6 real:" << ret;
-  return ret;
+  memcpy(value, fp32_value.data(), embedx_index * sizeof(float));
+  if (ret <= static_cast<int>(embedx_index)) {
+    return ret;
+  }
+  _embedx_w_quant.Quantize(fp32_value.data() + embedx_index,
+                           value + embedx_index);
+  _embedx_sgd_quant.Quantize(
+      fp32_value.data() + embedx_index + embedx_dim,
+      value + common_feature_value.EmbedxG2SumIndex());
+  return common_feature_value.Dim();
 }
 
 }  // namespace distributed
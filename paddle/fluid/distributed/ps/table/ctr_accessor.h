@@ -41,8 +41,10 @@ class CtrCommonAccessor : public ValueAccessor {
        std::vector<float> embedx_w;
        std::<vector>float embedx_g2sum;
        */
+    // embedx_w and embedx_g2sum are stored in embedx_size and
+    // embedx_sgd_size floats by value_quant_param
 
-    int Dim() { return 6 + embed_sgd_dim + embedx_sgd_dim + embedx_dim; }
+    int Dim() { return 6 + embed_sgd_dim + embedx_sgd_size + embedx_size; }
     int DimSize(size_t dim, int embedx_dim) { return sizeof(float); }
     int Size() { return Dim() * sizeof(float); }
     int SlotIndex() { return 0; }
@@ -53,7 +55,7 @@ class CtrCommonAccessor : public ValueAccessor {
     int EmbedWIndex() { return ClickIndex() + 1; }
     int EmbedG2SumIndex() { return EmbedWIndex() + 1; }
     int EmbedxWIndex() { return EmbedG2SumIndex() + embed_sgd_dim; }
-    int EmbedxG2SumIndex() { return EmbedxWIndex() + embedx_dim; }
+    int EmbedxG2SumIndex() { return EmbedxWIndex() + embedx_size; }
 
     float& UnseenDays(float* val) { return val[UnseenDaysIndex()]; }
     float& DeltaScore(float* val) { return val[DeltaScoreIndex()]; }
@@ -68,6 +70,8 @@ class CtrCommonAccessor : public ValueAccessor {
     int embed_sgd_dim;
     int embedx_dim;
     int embedx_sgd_dim;
+    int embedx_size;
+    int embedx_sgd_size;
   };
 
   struct CtrCommonPushValue {
@@ -178,15 +182,30 @@ class CtrCommonAccessor : public ValueAccessor {
   int32_t ParseFromString(const std::string& str, float* v) override;
   virtual bool CreateValue(int type, const float* value);
 
-  // 这个接口目前只用来取show
+  // 取show, 以及淘汰所用的unseen_days和show_click_score
   float GetField(float* value, const std::string& name) override {
-    // CHECK(name == "show");
     if (name == "show") {
       return common_feature_value.Show(value);
     }
+    if (name == "unseen_days") {
+      return common_feature_value.UnseenDays(value);
+    }
+    if (name == "show_click_score") {
+      return ShowClickScore(common_feature_value.Show(value),
+                            common_feature_value.Click(value));
+    }
     return 0.0;
   }
 
+  int PushValueGradIndex() override {
+    return CtrCommonPushValue::EmbedGIndex();
+  }
+
+  float PullValueShowClickScore(float* select_value) override {
+    return ShowClickScore(CtrCommonPullValue::Show(select_value),
+                          CtrCommonPullValue::Click(select_value));
+  }
+
  private:
   // float ShowClickScore(float show, float click);
 
@@ -196,6 +215,10 @@ class CtrCommonAccessor : public ValueAccessor {
   float _show_click_decay_rate;
   int32_t _ssd_unseenday_threshold;
   bool _show_scale = false;
+  // the storage of embedx_w and embedx_g2sum
+  SparseValueQuant _embedx_w_quant;
+  SparseValueQuant _embedx_sgd_quant;
+  bool _embedx_fp32 = true;
 
  public:  // TODO(zhaocaibei123): it should be private, but we make it public
           // for unit test
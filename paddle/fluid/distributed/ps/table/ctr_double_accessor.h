@@ -200,6 +200,11 @@ class CtrDoubleAccessor : public ValueAccessor {
   std::string ParseToString(const float* value, int param) override;
   int32_t ParseFromString(const std::string& str, float* v) override;
   virtual bool CreateValue(int type, const float* value);
+
+  int PushValueGradIndex() override {
+    return CtrDoublePushValue::EmbedGIndex();
+  }
+
   // 这个接口目前只用来取show
   float GetField(float* value, const std::string& name) override {
     CHECK_EQ(name, "show");
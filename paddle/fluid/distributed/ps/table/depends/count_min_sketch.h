@@ -0,0 +1,90 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace paddle {
+namespace distributed {
+
+// Estimates the occurrences of the keys with depth rows of width saturating
+// 8-bit counters, an estimate is never below the real count since the last
+// Decay. It is not thread safe, a sparse table keeps one for every local
+// shard, which is only touched by the task pool of the shard.
+class CountMinSketch {
+ public:
+  CountMinSketch() {}
+  CountMinSketch(uint32_t width, uint32_t depth) { Reset(width, depth); }
+
+  void Reset(uint32_t width, uint32_t depth) {
+    // the width is rounded up to a power of 2 to index by mask
+    _width = 1;
+    while (_width < std::max<uint32_t>(width, 1)) {
+      _width <<= 1;
+    }
+    _depth = std::max<uint32_t>(depth, 1);
+    _counters.assign(static_cast<size_t>(_width) * _depth, 0);
+  }
+
+  // counts the key once and returns its estimated count
+  uint32_t Add(uint64_t key) {
+    uint32_t count = std::numeric_limits<uint8_t>::max();
+    for (uint32_t row = 0; row < _depth; ++row) {
+      uint8_t &counter = _counters[Index(key, row)];
+      if (counter < std::numeric_limits<uint8_t>::max()) {
+        ++counter;
+      }
+      count = std::min<uint32_t>(count, counter);
+    }
+    return count;
+  }
+
+  uint32_t Count(uint64_t key) const {
+    uint32_t count = std::numeric_limits<uint8_t>::max();
+    for (uint32_t row = 0; row < _depth; ++row) {
+      count = std::min<uint32_t>(count, _counters[Index(key, row)]);
+    }
+    return count;
+  }
+
+  // halves all counters, so that the keys have to occur again recently
+  void Decay() {
+    for (auto &counter : _counters) {
+      counter >>= 1;
+    }
+  }
+
+  bool empty() const { return _counters.empty(); }
+
+ private:
+  size_t Index(uint64_t key, uint32_t row) const {
+    // splitmix64 of the key salted by the row
+    uint64_t x = key + 0x9e3779b97f4a7c15ULL * (row + 1);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return static_cast<size_t>(row) * _width + (x & (_width - 1));
+  }
+
+  uint32_t _width = 0;
+  uint32_t _depth = 0;
+  std::vector<uint8_t> _counters;
+};
+
+}  // namespace distributed
+}  // namespace paddle
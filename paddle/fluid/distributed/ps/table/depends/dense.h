@@ -19,6 +19,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -40,6 +41,9 @@ class DenseOptimizer {
                       int begin,
                       int end) = 0;
   virtual void SetGlobalLR(float* lr) { global_learning_rate_ = lr; }
+  // Called with the offsets of the blocks of the param, when the table
+  // updates the blocks independently, one block per Update.
+  virtual void SetBlocks(const std::vector<int>& offsets) {}
 
  protected:
   float* global_learning_rate_;
@@ -164,14 +168,26 @@ class DAdam : public DenseOptimizer {
     blas.SCAL(update_numel, beta2, moment2 + begin);
     blas.VADD(update_numel, moment2 + begin, grad2.data(), moment2 + begin);
 
-    beta1_pow[0] = beta1_pow[0] * beta1;
-    beta2_pow[0] = beta2_pow[0] * beta2;
+    float* cur_beta1_pow = beta1_pow;
+    float* cur_beta2_pow = beta2_pow;
+    auto it = block_beta_pows.find(begin);
+    if (it != block_beta_pows.end()) {
+      cur_beta1_pow = &it->second.first;
+      cur_beta2_pow = &it->second.second;
+    }
+    cur_beta1_pow[0] = cur_beta1_pow[0] * beta1;
+    cur_beta2_pow[0] = cur_beta2_pow[0] * beta2;
+    if (begin == 0) {
+      // the beta pows of the first block are the ones saved
+      beta1_pow[0] = cur_beta1_pow[0];
+      beta2_pow[0] = cur_beta2_pow[0];
+    }
 
     float lr_ = *(global_learning_rate_)*learning_rate[0];
-    lr_ *= sqrt(1 - beta2_pow[0]) / (1 - beta1_pow[0]);
+    lr_ *= sqrt(1 - cur_beta2_pow[0]) / (1 - cur_beta1_pow[0]);
 
     float* tmp_ = tmp.data();
-    float eps_ = epsilon * sqrt(1 - beta2_pow[0]);
+    float eps_ = epsilon * sqrt(1 - cur_beta2_pow[0]);
 
     SQRT<float>(update_numel, moment2 + begin, tmp_);
     ADD<float>(update_numel, tmp_, eps_, tmp_);
@@ -187,8 +203,19 @@ class DAdam : public DenseOptimizer {
   float* moment1;
   float* moment2;
 
+  // the beta pows of every block are kept apart, as the blocks are updated
+  // independently
+  void SetBlocks(const std::vector<int>& offsets) override {
+    block_beta_pows.clear();
+    for (size_t i = 0; i + 1 < offsets.size(); ++i) {
+      block_beta_pows[offsets[i]] = {beta1_pow[0], beta2_pow[0]};
+    }
+  }
+
   float* beta1_pow;
   float* beta2_pow;
+  // begin of a block -> its beta1 pow and beta2 pow
+  std::unordered_map<int, std::pair<float, float>> block_beta_pows;
 
   float beta1;
   float beta2;
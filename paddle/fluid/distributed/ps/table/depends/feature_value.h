@@ -14,10 +14,19 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <mct/hash-map.hpp>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "paddle/fluid/distributed/common/chunk_allocator.h"
 #include "paddle/utils/flags.h"
 
@@ -199,5 +208,557 @@ struct alignas(64) SparseTableShard {
   std::hash<KEY> _hasher;
 };
 
+// FeatureValueSlab allocates the float arrays of SlabFeatureValue from 64KB
+// pages segregated by capacity, so that a sparse table shard does not pay a
+// heap allocation (and its header) for every key. Arrays larger than
+// kMaxSlabFloats come from malloc. It is not thread safe, every shard owns
+// one like it owns its ChunkAllocator.
+class FeatureValueSlab {
+ public:
+  static constexpr uint32_t kFloatsPerClass = 8;
+  static constexpr uint32_t kMaxSlabFloats = 512;
+  static constexpr size_t kPageSize = 64 << 10;
+
+  FeatureValueSlab() : _free_lists(kMaxSlabFloats / kFloatsPerClass, NULL) {}
+  FeatureValueSlab(const FeatureValueSlab&) = delete;
+  ~FeatureValueSlab() {
+    for (void* page : _pages) {
+      free(page);  // NOLINT
+    }
+  }
+
+  // Round n up to the capacity of its size class
+  static uint32_t capacity(uint32_t n) {
+    if (n > kMaxSlabFloats) {
+      return n;
+    }
+    return (n + kFloatsPerClass - 1) / kFloatsPerClass * kFloatsPerClass;
+  }
+
+  // Return an array of capacity(n) floats
+  float* acquire(uint32_t n) {
+    uint32_t cap = capacity(n);
+    if (cap == 0) {
+      return NULL;
+    }
+    if (cap > kMaxSlabFloats) {
+      return static_cast<float*>(malloc(cap * sizeof(float)));  // NOLINT
+    }
+    FreeNode*& head = _free_lists[cap / kFloatsPerClass - 1];
+    if (head == NULL) {
+      carve(cap, &head);
+    }
+    FreeNode* node = head;
+    head = node->next;
+    return reinterpret_cast<float*>(node);
+  }
+
+  void release(float* data, uint32_t cap) {
+    if (data == NULL) {
+      return;
+    }
+    if (cap > kMaxSlabFloats) {
+      free(data);  // NOLINT
+      return;
+    }
+    FreeNode* node = reinterpret_cast<FreeNode*>(data);
+    FreeNode*& head = _free_lists[cap / kFloatsPerClass - 1];
+    node->next = head;
+    head = node;
+  }
+
+ private:
+  struct FreeNode {
+    FreeNode* next;
+  };
+
+  void carve(uint32_t cap, FreeNode** head) {
+    char* page = static_cast<char*>(malloc(kPageSize));  // NOLINT
+    CHECK(page != NULL) << "Fail to allocate FeatureValueSlab page";
+    _pages.push_back(page);
+    size_t bytes = cap * sizeof(float);
+    for (size_t offset = 0; offset + bytes <= kPageSize; offset += bytes) {
+      FreeNode* node = reinterpret_cast<FreeNode*>(page + offset);
+      node->next = *head;
+      *head = node;
+    }
+  }
+
+  std::vector<FreeNode*> _free_lists;
+  std::vector<void*> _pages;
+};
+
+// SlabFeatureValue has the interface of FixedFeatureValue, but keeps its
+// floats in the FeatureValueSlab of its shard.
+class SlabFeatureValue {
+ public:
+  explicit SlabFeatureValue(FeatureValueSlab* slab) : _slab(slab) {}
+  SlabFeatureValue(const SlabFeatureValue& other) : _slab(other._slab) {
+    *this = other;
+  }
+  SlabFeatureValue& operator=(const SlabFeatureValue& other) {
+    if (this != &other) {
+      resize(other._size);
+      if (_size > 0) {
+        memcpy(_data, other._data, _size * sizeof(float));
+      }
+    }
+    return *this;
+  }
+  ~SlabFeatureValue() { _slab->release(_data, _capacity); }
+
+  float* data() { return _data; }
+  size_t size() { return _size; }
+  // New elements are zero-initialized like std::vector<float>::resize
+  void resize(size_t size) {
+    uint32_t n = static_cast<uint32_t>(size);
+    if (n > _capacity) {
+      realloc_data(n);
+    }
+    if (n > _size) {
+      memset(_data + _size, 0, (n - _size) * sizeof(float));
+    }
+    _size = n;
+  }
+  void shrink_to_fit() {
+    if (FeatureValueSlab::capacity(_size) < _capacity) {
+      realloc_data(_size);
+    }
+  }
+
+ private:
+  void realloc_data(uint32_t n) {
+    float* data = _slab->acquire(n);
+    if (_size > 0 && n > 0) {
+      memcpy(data, _data, std::min(_size, n) * sizeof(float));
+    }
+    _slab->release(_data, _capacity);
+    _data = data;
+    _capacity = FeatureValueSlab::capacity(n);
+  }
+
+  float* _data = NULL;
+  uint32_t _size = 0;
+  uint32_t _capacity = 0;
+  FeatureValueSlab* _slab;
+};
+
+// SwissHashMap is an open addressing hash map from KEY to a value pointer in
+// the style of SwissTable. Every slot has a control byte, which is kEmpty,
+// kDeleted or the low 7 bits of the hash. A lookup compares the control bytes
+// of a group of 16 slots with the hash at once by SSE2, and only probes the
+// slots that match. The control bytes of the first group are mirrored after
+// the last slot, so a group can start at any slot.
+template <class KEY>
+class SwissHashMap {
+ public:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  SwissHashMap() = default;
+  SwissHashMap(const SwissHashMap&) = delete;
+  ~SwissHashMap() {
+    free(_ctrl);   // NOLINT
+    free(_slots);  // NOLINT
+  }
+
+  size_t size() const { return _size; }
+  size_t capacity() const { return _capacity; }
+  void max_load_factor(float x) { _max_load_factor = x; }
+
+  const KEY& key(size_t index) const { return _slots[index].key; }
+  void*& value(size_t index) { return _slots[index].value; }
+
+  // Return the index of the first full slot not before index, or npos
+  size_t next(size_t index) const {
+    for (; index < _capacity; ++index) {
+      if (is_full(_ctrl[index])) {
+        return index;
+      }
+    }
+    return npos;
+  }
+
+  size_t find_with_hash(const KEY& key, size_t hash) const {
+    if (_capacity == 0) {
+      return npos;
+    }
+    int8_t h2 = H2(hash);
+    size_t pos = H1(hash) & _mask;
+    for (size_t step = kGroupWidth;; step += kGroupWidth) {
+      uint32_t match = match_byte(_ctrl + pos, h2);
+      while (match != 0) {
+        size_t index = (pos + CountTrailingZeros(match)) & _mask;
+        if (_slots[index].key == key) {
+          return index;
+        }
+        match &= match - 1;
+      }
+      if (match_byte(_ctrl + pos, kEmpty) != 0) {
+        return npos;
+      }
+      pos = (pos + step) & _mask;
+    }
+  }
+
+  // Return the index of key and whether it is newly inserted, the value of a
+  // new slot is NULL
+  std::pair<size_t, bool> insert_with_hash(const KEY& key, size_t hash) {
+    size_t index = find_with_hash(key, hash);
+    if (index != npos) {
+      return {index, false};
+    }
+    if (_growth_left == 0) {
+      rehash(_size * 2 >= _capacity * _max_load_factor ? _capacity * 2
+                                                       : _capacity);
+    }
+    index = find_insert_slot(hash);
+    _growth_left -= _ctrl[index] == kEmpty ? 1 : 0;
+    set_ctrl(index, H2(hash));
+    _slots[index].key = key;
+    _slots[index].value = NULL;
+    ++_size;
+    return {index, true};
+  }
+
+  void erase(size_t index) {
+    // a slot can be marked empty again if the run of non-empty slots around
+    // it is shorter than a group, then no probe has ever seen a full group
+    // containing it
+    size_t before = (index - kGroupWidth) & _mask;
+    uint32_t empty_after = match_byte(_ctrl + index, kEmpty);
+    uint32_t empty_before = match_byte(_ctrl + before, kEmpty);
+    bool was_never_full = empty_after != 0 && empty_before != 0 &&
+                          CountTrailingZeros(empty_after) +
+                                  CountLeadingZeros16(empty_before) <
+                              kGroupWidth;
+    set_ctrl(index, was_never_full ? kEmpty : kDeleted);
+    _growth_left += was_never_full ? 1 : 0;
+    --_size;
+  }
+
+  void clear() {
+    if (_capacity > 0) {
+      memset(_ctrl, kEmpty, _capacity + kGroupWidth);
+      _growth_left = max_size(_capacity);
+    }
+    _size = 0;
+  }
+
+ private:
+  static constexpr size_t kGroupWidth = 16;
+  static constexpr size_t kMinCapacity = 16;
+  static constexpr int8_t kEmpty = -128;
+  static constexpr int8_t kDeleted = -2;
+
+  struct Slot {
+    KEY key;
+    void* value;
+  };
+
+  static bool is_full(int8_t ctrl) { return ctrl >= 0; }
+
+  // std::hash of integers is identity, and keys of a shard usually share
+  // their low bits, so mix the hash (the finalizer of MurmurHash3) first
+  static uint64_t Mix(size_t hash) {
+    uint64_t h = hash;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+  static size_t H1(size_t hash) { return static_cast<size_t>(Mix(hash) >> 7); }
+  static int8_t H2(size_t hash) {
+    return static_cast<int8_t>(Mix(hash) & 0x7F);
+  }
+
+  static uint32_t CountTrailingZeros(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#else
+    uint32_t n = 0;
+    while ((x & 1) == 0) {
+      x >>= 1;
+      ++n;
+    }
+    return n;
+#endif
+  }
+
+  // Number of leading zeros of a non-zero kGroupWidth-bit mask
+  static uint32_t CountLeadingZeros16(uint32_t x) {
+    uint32_t n = 0;
+    for (uint32_t bit = 1u << (kGroupWidth - 1); (x & bit) == 0; bit >>= 1) {
+      ++n;
+    }
+    return n;
+  }
+
+  // Bit i of the result is set if ctrl[i] == byte, i < kGroupWidth
+  static uint32_t match_byte(const int8_t* ctrl, int8_t byte) {
+#if defined(__SSE2__)
+    __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+    return static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(byte), group)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kGroupWidth; ++i) {
+      mask |= static_cast<uint32_t>(ctrl[i] == byte) << i;
+    }
+    return mask;
+#endif
+  }
+
+  // Bit i of the result is set if ctrl[i] is kEmpty or kDeleted
+  static uint32_t match_empty_or_deleted(const int8_t* ctrl) {
+#if defined(__SSE2__)
+    __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+    return static_cast<uint32_t>(_mm_movemask_epi8(group));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kGroupWidth; ++i) {
+      mask |= static_cast<uint32_t>(ctrl[i] < 0) << i;
+    }
+    return mask;
+#endif
+  }
+
+  size_t max_size(size_t capacity) const {
+    size_t n = static_cast<size_t>(capacity * _max_load_factor);
+    return std::min(std::max<size_t>(n, 1), capacity - 1);
+  }
+
+  void set_ctrl(size_t index, int8_t ctrl) {
+    _ctrl[index] = ctrl;
+    if (index < kGroupWidth) {
+      _ctrl[index + _capacity] = ctrl;
+    }
+  }
+
+  size_t find_insert_slot(size_t hash) const {
+    size_t pos = H1(hash) & _mask;
+    for (size_t step = kGroupWidth;; step += kGroupWidth) {
+      uint32_t mask = match_empty_or_deleted(_ctrl + pos);
+      if (mask != 0) {
+        return (pos + CountTrailingZeros(mask)) & _mask;
+      }
+      pos = (pos + step) & _mask;
+    }
+  }
+
+  void rehash(size_t new_capacity) {
+    new_capacity = std::max(new_capacity, kMinCapacity);
+    int8_t* old_ctrl = _ctrl;
+    Slot* old_slots = _slots;
+    size_t old_capacity = _capacity;
+
+    _ctrl = static_cast<int8_t*>(malloc(new_capacity + kGroupWidth));  // NOLINT
+    _slots = static_cast<Slot*>(malloc(new_capacity * sizeof(Slot)));  // NOLINT
+    CHECK(_ctrl != NULL && _slots != NULL) << "Fail to rehash SwissHashMap";
+    memset(_ctrl, kEmpty, new_capacity + kGroupWidth);
+    _capacity = new_capacity;
+    _mask = new_capacity - 1;
+    _growth_left = max_size(new_capacity) - _size;
+
+    for (size_t i = 0; i < old_capacity; ++i) {
+      if (is_full(old_ctrl[i])) {
+        size_t hash = _hasher(old_slots[i].key);
+        size_t index = find_insert_slot(hash);
+        set_ctrl(index, H2(hash));
+        _slots[index] = old_slots[i];
+      }
+    }
+    free(old_ctrl);   // NOLINT
+    free(old_slots);  // NOLINT
+  }
+
+  int8_t* _ctrl = NULL;
+  Slot* _slots = NULL;
+  size_t _capacity = 0;  // always a power of two
+  size_t _mask = 0;
+  size_t _size = 0;
+  size_t _growth_left = 0;
+  float _max_load_factor = 0.875;
+  std::hash<KEY> _hasher;
+};
+
+// SwissSparseTableShard has the interface of SparseTableShard, it keeps the
+// key -> value pointer maps in SwissHashMap, and the values in ChunkAllocator.
+// If VALUE can be constructed from a FeatureValueSlab* (e.g.,
+// SlabFeatureValue), the value data are stored in the slab of the shard too.
+template <class KEY, class VALUE>
+struct alignas(64) SwissSparseTableShard {
+ public:
+  typedef SwissHashMap<KEY> map_type;
+  struct iterator {
+    size_t index;
+    size_t bucket;
+    map_type* buckets;
+    friend bool operator==(const iterator& a, const iterator& b) {
+      return a.index == b.index && a.bucket == b.bucket;
+    }
+    friend bool operator!=(const iterator& a, const iterator& b) {
+      return !(a == b);
+    }
+    const KEY& key() const { return buckets[bucket].key(index); }
+    VALUE& value() const { return *value_ptr(); }
+    VALUE* value_ptr() const {
+      return static_cast<VALUE*>(buckets[bucket].value(index));
+    }
+    iterator& operator++() {
+      index = buckets[bucket].next(index + 1);
+      while (index == map_type::npos &&
+             bucket + 1 < CTR_SPARSE_SHARD_BUCKET_NUM) {
+        index = buckets[++bucket].next(0);
+      }
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator ret = *this;
+      ++*this;
+      return ret;
+    }
+  };
+  struct local_iterator {
+    size_t index;
+    map_type* map;
+    friend bool operator==(const local_iterator& a, const local_iterator& b) {
+      return a.index == b.index;
+    }
+    friend bool operator!=(const local_iterator& a, const local_iterator& b) {
+      return a.index != b.index;
+    }
+    const KEY& key() const { return map->key(index); }
+    VALUE& value() const { return *static_cast<VALUE*>(map->value(index)); }
+    local_iterator& operator++() {
+      index = map->next(index + 1);
+      return *this;
+    }
+    local_iterator operator++(int) {
+      local_iterator ret = *this;
+      ++*this;
+      return ret;
+    }
+  };
+
+  ~SwissSparseTableShard() { clear(); }
+  bool empty() { return _alloc.size() == 0; }
+  size_t size() { return _alloc.size(); }
+  void set_max_load_factor(float x) {
+    for (size_t bucket = 0; bucket < CTR_SPARSE_SHARD_BUCKET_NUM; bucket++) {
+      _buckets[bucket].max_load_factor(x);
+    }
+  }
+  size_t bucket_count() { return CTR_SPARSE_SHARD_BUCKET_NUM; }
+  size_t bucket_size(size_t bucket) { return _buckets[bucket].size(); }
+  void clear() {
+    for (size_t bucket = 0; bucket < CTR_SPARSE_SHARD_BUCKET_NUM; bucket++) {
+      map_type& data = _buckets[bucket];
+      for (size_t i = data.next(0); i != map_type::npos; i = data.next(i + 1)) {
+        _alloc.release(static_cast<VALUE*>(data.value(i)));
+      }
+      data.clear();
+    }
+  }
+  iterator begin() {
+    size_t bucket = 0;
+    size_t index = _buckets[0].next(0);
+    while (index == map_type::npos &&
+           bucket + 1 < CTR_SPARSE_SHARD_BUCKET_NUM) {
+      index = _buckets[++bucket].next(0);
+    }
+    return {index, bucket, _buckets};
+  }
+  iterator end() {
+    return {map_type::npos, CTR_SPARSE_SHARD_BUCKET_NUM - 1, _buckets};
+  }
+  local_iterator begin(size_t bucket) {
+    return {_buckets[bucket].next(0), &_buckets[bucket]};
+  }
+  local_iterator end(size_t bucket) {
+    return {map_type::npos, &_buckets[bucket]};
+  }
+  iterator find(const KEY& key) {
+    size_t hash = _hasher(key);
+    size_t bucket = compute_bucket(hash);
+    size_t index = _buckets[bucket].find_with_hash(key, hash);
+    if (index == map_type::npos) {
+      return end();
+    }
+    return {index, bucket, _buckets};
+  }
+  VALUE& operator[](const KEY& key) { return emplace(key).first.value(); }
+  std::pair<iterator, bool> insert(const KEY& key, const VALUE& val) {
+    return emplace(key, val);
+  }
+  std::pair<iterator, bool> insert(const KEY& key, VALUE&& val) {
+    return emplace(key, std::move(val));
+  }
+  template <class... ARGS>
+  std::pair<iterator, bool> emplace(const KEY& key, ARGS&&... args) {
+    size_t hash = _hasher(key);
+    size_t bucket = compute_bucket(hash);
+    auto res = _buckets[bucket].insert_with_hash(key, hash);
+
+    if (res.second) {
+      _buckets[bucket].value(res.first) =
+          acquire_value(std::forward<ARGS>(args)...);
+    }
+
+    return {{res.first, bucket, _buckets}, res.second};
+  }
+  iterator erase(iterator it) {
+    _alloc.release(it.value_ptr());
+    _buckets[it.bucket].erase(it.index);
+    return ++it;
+  }
+  void quick_erase(iterator it) {
+    _alloc.release(it.value_ptr());
+    _buckets[it.bucket].erase(it.index);
+  }
+  local_iterator erase(size_t bucket, local_iterator it) {
+    _alloc.release(&it.value());
+    _buckets[bucket].erase(it.index);
+    return ++it;
+  }
+  void quick_erase(size_t bucket, local_iterator it) {
+    _alloc.release(&it.value());
+    _buckets[bucket].erase(it.index);
+  }
+  size_t erase(const KEY& key) {
+    auto it = find(key);
+    if (it == end()) {
+      return 0;
+    }
+    quick_erase(it);
+    return 1;
+  }
+  size_t compute_bucket(size_t hash) {
+    if (CTR_SPARSE_SHARD_BUCKET_NUM == 1) {
+      return 0;
+    } else {
+      return hash >> (sizeof(size_t) * 8 - CTR_SPARSE_SHARD_BUCKET_NUM_BITS);
+    }
+  }
+
+ private:
+  template <class... ARGS>
+  VALUE* acquire_value(ARGS&&... args) {
+    if constexpr (sizeof...(ARGS) == 0 &&
+                  std::is_constructible<VALUE, FeatureValueSlab*>::value) {
+      return _alloc.acquire(&_slab);
+    } else {
+      return _alloc.acquire(std::forward<ARGS>(args)...);
+    }
+  }
+
+  map_type _buckets[CTR_SPARSE_SHARD_BUCKET_NUM];
+  // the slab should outlive the values in _alloc
+  FeatureValueSlab _slab;
+  ChunkAllocator<VALUE> _alloc;
+  std::hash<KEY> _hasher;
+};
+
 }  // namespace distributed
 }  // namespace paddle
@@ -0,0 +1,430 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <rocksdb/sst_file_reader.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "paddle/fluid/distributed/ps/table/depends/rocksdb_warpper.h"
+#include "paddle/fluid/distributed/ps/thirdparty/round_robin.h"
+
+namespace paddle {
+namespace distributed {
+
+// MmapSegment is an append-only file mapped into memory. The file is
+// truncated to the full capacity when it is created, so the pages that are
+// never written do not take disk space, and the kernel writes the dirty pages
+// back and reads them in on demand.
+class MmapSegment {
+ public:
+  MmapSegment(const std::string& path, size_t capacity)
+      : _path(path), _capacity(capacity) {
+    _fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    CHECK(_fd >= 0) << "open " << path << " failed: " << strerror(errno);
+    CHECK(ftruncate(_fd, capacity) == 0)
+        << "ftruncate " << path << " failed: " << strerror(errno);
+    void* data =
+        mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    CHECK(data != MAP_FAILED)
+        << "mmap " << path << " failed: " << strerror(errno);
+    // values are looked up by key, readahead only wastes the page cache
+    madvise(data, capacity, MADV_RANDOM);
+    _data = reinterpret_cast<char*>(data);
+  }
+  ~MmapSegment() {
+    munmap(_data, _capacity);
+    close(_fd);
+    unlink(_path.c_str());
+  }
+
+  // return nullptr if the segment has no room for len bytes
+  char* append(size_t len) {
+    if (_capacity - _size < len) {
+      return nullptr;
+    }
+    char* ret = _data + _size;
+    _size += len;
+    return ret;
+  }
+  const char* data() const { return _data; }
+  size_t size() const { return _size; }
+
+ private:
+  std::string _path;
+  size_t _capacity;
+  size_t _size = 0;
+  int _fd;
+  char* _data;
+};
+
+// MmapSegmentIterator walks over a snapshot of the keys of one column in the
+// order of Uint64Comparator. The records stay valid while the iterator is
+// alive, because a column is not compacted when it has iterators.
+class MmapSegmentIterator : public rocksdb::Iterator {
+ public:
+  typedef std::pair<uint64_t, const char*> Record;
+
+  MmapSegmentIterator(std::vector<Record>&& records,
+                      std::atomic<int>* iterator_num)
+      : _records(std::move(records)), _iterator_num(iterator_num) {
+    std::sort(_records.begin(),
+              _records.end(),
+              [](const Record& a, const Record& b) {
+                return a.first < b.first;
+              });
+    _pos = _records.size();
+  }
+  ~MmapSegmentIterator() override { _iterator_num->fetch_sub(1); }
+
+  bool Valid() const override { return _pos < _records.size(); }
+  void SeekToFirst() override { _pos = 0; }
+  void SeekToLast() override {
+    _pos = _records.empty() ? 0 : _records.size() - 1;
+  }
+  void Seek(const rocksdb::Slice& target) override {
+    _pos = std::lower_bound(_records.begin(),
+                            _records.end(),
+                            ToKey(target),
+                            [](const Record& record, uint64_t key) {
+                              return record.first < key;
+                            }) -
+           _records.begin();
+  }
+  void SeekForPrev(const rocksdb::Slice& target) override {
+    size_t pos = std::upper_bound(_records.begin(),
+                                  _records.end(),
+                                  ToKey(target),
+                                  [](uint64_t key, const Record& record) {
+                                    return key < record.first;
+                                  }) -
+                 _records.begin();
+    _pos = pos == 0 ? _records.size() : pos - 1;
+  }
+  void Next() override { ++_pos; }
+  void Prev() override { _pos = _pos == 0 ? _records.size() : _pos - 1; }
+  rocksdb::Slice key() const override {
+    return rocksdb::Slice(_records[_pos].second, sizeof(uint64_t));
+  }
+  rocksdb::Slice value() const override;
+  rocksdb::Status status() const override { return rocksdb::Status::OK(); }
+
+ private:
+  static uint64_t ToKey(const rocksdb::Slice& slice) {
+    uint64_t key = 0;
+    memcpy(&key, slice.data(), std::min(slice.size(), sizeof(uint64_t)));
+    return key;
+  }
+
+  std::vector<Record> _records;
+  std::atomic<int>* _iterator_num;
+  size_t _pos;
+};
+
+// MmapSegmentHandler keeps the values in append-only MmapSegment files and
+// the location of every key in an in-memory index, so a lookup is one hash
+// probe plus at most one page fault, and there is no background compaction
+// that stalls the readers like the LSM tree of RocksDB.
+//
+// Record layout, 8 bytes aligned:
+//   uint64_t key | uint32_t value_len | uint32_t padding | value
+// put appends a new record and del_data only drops the key from the index,
+// flush rewrites a column into new segments when more than half of its bytes
+// are garbage.
+class MmapSegmentHandler : public SSDHandler {
+ public:
+  static constexpr size_t kRecordHeaderSize = 16;
+
+  MmapSegmentHandler() {}
+  ~MmapSegmentHandler() override {}
+
+  static MmapSegmentHandler* GetInstance() {
+    static MmapSegmentHandler handler;
+    return &handler;
+  }
+
+  void set_segment_size(size_t segment_size) {
+    // Location::offset is 32 bits
+    CHECK(segment_size <= (1UL << 32)) << "segment size should be <= 4GB";
+    _segment_size = segment_size;
+  }
+
+  int initialize(const std::string& db_path, const int colnum) override {
+    VLOG(0) << "mmap segment path: " << db_path << " colnum: " << colnum
+            << " segment size: " << _segment_size;
+    _columns.clear();
+    for (int i = 0; i < colnum; i++) {
+      _columns.emplace_back(new Column());
+      auto& column = *_columns.back();
+      column.dir = db_path + "_" + std::to_string(i);
+      std::string rm_cmd = "rm -rf " + column.dir;
+      system(rm_cmd.c_str());
+      CHECK(mkdir(column.dir.c_str(), 0755) == 0)
+          << "mkdir " << column.dir << " failed: " << strerror(errno);
+    }
+    VLOG(0) << "MmapSegmentHandler initialize success, colnum:" << colnum;
+    return 0;
+  }
+
+  int put(int id,
+          const char* key,
+          int key_len,
+          const char* value,
+          int value_len) override {
+    auto& column = *_columns[id];
+    std::lock_guard<std::mutex> guard(column.mutex);
+    Append(&column, ToKey(key, key_len), value, value_len);
+    return 0;
+  }
+
+  int put_batch(int id,
+                std::vector<std::pair<char*, int>>& ssd_keys,    // NOLINT
+                std::vector<std::pair<char*, int>>& ssd_values,  // NOLINT
+                int n) override {
+    auto& column = *_columns[id];
+    std::lock_guard<std::mutex> guard(column.mutex);
+    for (int i = 0; i < n; i++) {
+      Append(&column,
+             ToKey(ssd_keys[i].first, ssd_keys[i].second),
+             ssd_values[i].first,
+             ssd_values[i].second);
+    }
+    return 0;
+  }
+
+  int get(int id,
+          const char* key,
+          int key_len,
+          std::string& value) override {  // NOLINT
+    auto& column = *_columns[id];
+    std::lock_guard<std::mutex> guard(column.mutex);
+    const char* record = Find(column, ToKey(key, key_len));
+    if (record == nullptr) {
+      return 1;
+    }
+    value.assign(RecordValue(record), RecordValueLen(record));
+    return 0;
+  }
+
+  void multi_get(int id,
+                 const size_t num_keys,
+                 const rocksdb::Slice* keys,
+                 rocksdb::PinnableSlice* values,
+                 rocksdb::Status* status,
+                 const bool sorted_input = true) override {
+    auto& column = *_columns[id];
+    std::lock_guard<std::mutex> guard(column.mutex);
+    for (size_t i = 0; i < num_keys; ++i) {
+      const char* record =
+          Find(column, ToKey(keys[i].data(), static_cast<int>(keys[i].size())));
+      if (record == nullptr) {
+        status[i] = rocksdb::Status::NotFound();
+        continue;
+      }
+      // copy the value, the segment may be compacted before values is reset
+      values[i].PinSelf(
+          rocksdb::Slice(RecordValue(record), RecordValueLen(record)));
+      status[i] = rocksdb::Status::OK();
+    }
+  }
+
+  int del_data(int id, const char* key, int key_len) override {
+    auto& column = *_columns[id];
+    std::lock_guard<std::mutex> guard(column.mutex);
+    auto itr = column.index.find(ToKey(key, key_len));
+    if (itr != column.index.end()) {
+      size_t record_size =
+          RecordSize(RecordValueLen(Resolve(column, itr->second)));
+      column.live_bytes -= record_size;
+      column.garbage_bytes += record_size;
+      column.index.erase(itr);
+    }
+    return 0;
+  }
+
+  int flush(int id) override {
+    auto& column = *_columns[id];
+    std::lock_guard<std::mutex> guard(column.mutex);
+    if (column.iterator_num.load() == 0 &&
+        column.garbage_bytes > column.live_bytes &&
+        column.garbage_bytes >= _segment_size) {
+      Compact(&column);
+    }
+    return 0;
+  }
+
+  rocksdb::Iterator* get_iterator(int id) override {
+    auto& column = *_columns[id];
+    std::lock_guard<std::mutex> guard(column.mutex);
+    std::vector<MmapSegmentIterator::Record> records;
+    records.reserve(column.index.size());
+    for (auto& kv : column.index) {
+      records.emplace_back(kv.first, Resolve(column, kv.second));
+    }
+    column.iterator_num.fetch_add(1);
+    return new MmapSegmentIterator(std::move(records), &column.iterator_num);
+  }
+
+  int get_estimate_key_num(uint64_t& num_keys) override {  // NOLINT
+    num_keys = 0;
+    for (auto& column : _columns) {
+      std::lock_guard<std::mutex> guard(column->mutex);
+      num_keys += column->index.size();
+    }
+    return 0;
+  }
+
+  Uint64Comparator* get_comparator() override { return &_comparator; }
+
+  int ingest_externel_file(
+      int id, const std::vector<std::string>& sst_filelist) override {
+    rocksdb::Options options;
+    options.comparator = &_comparator;
+    for (auto& file : sst_filelist) {
+      rocksdb::SstFileReader reader(options);
+      rocksdb::Status s = reader.Open(file);
+      CHECK(s.ok()) << "open sst file " << file << " failed: " << s.ToString();
+      std::unique_ptr<rocksdb::Iterator> it(
+          reader.NewIterator(rocksdb::ReadOptions()));
+      auto& column = *_columns[id];
+      std::lock_guard<std::mutex> guard(column.mutex);
+      for (it->SeekToFirst(); it->Valid(); it->Next()) {
+        Append(&column,
+               ToKey(it->key().data(), static_cast<int>(it->key().size())),
+               it->value().data(),
+               static_cast<int>(it->value().size()));
+      }
+      // the files are moved into the db like IngestExternalFile(move_files)
+      unlink(file.c_str());
+    }
+    return 0;
+  }
+
+  static uint32_t RecordValueLen(const char* record) {
+    return *reinterpret_cast<const uint32_t*>(record + sizeof(uint64_t));
+  }
+  static const char* RecordValue(const char* record) {
+    return record + kRecordHeaderSize;
+  }
+
+ private:
+  struct Location {
+    uint32_t segment;
+    uint32_t offset;
+  };
+  struct Column {
+    std::mutex mutex;
+    std::string dir;
+    std::vector<std::unique_ptr<MmapSegment>> segments;
+    robin_hood::unordered_flat_map<uint64_t, Location> index;
+    size_t live_bytes = 0;
+    size_t garbage_bytes = 0;
+    uint64_t next_segment_id = 0;
+    std::atomic<int> iterator_num{0};
+  };
+
+  static uint64_t ToKey(const char* key, int key_len) {
+    CHECK(key_len == sizeof(uint64_t)) << "key_len should be 8, " << key_len;
+    uint64_t ret = 0;
+    memcpy(&ret, key, sizeof(uint64_t));
+    return ret;
+  }
+  static size_t RecordSize(size_t value_len) {
+    return kRecordHeaderSize + ((value_len + 7) & ~static_cast<size_t>(7));
+  }
+  static const char* Resolve(const Column& column, const Location& loc) {
+    return column.segments[loc.segment]->data() + loc.offset;
+  }
+  const char* Find(const Column& column, uint64_t key) {
+    auto itr = column.index.find(key);
+    return itr == column.index.end() ? nullptr : Resolve(column, itr->second);
+  }
+
+  // append one record to the last segment of column, the caller holds the
+  // lock of column
+  void Append(Column* column, uint64_t key, const char* value, int value_len) {
+    size_t record_size = RecordSize(value_len);
+    CHECK(record_size <= _segment_size)
+        << "value of " << value_len << " bytes is larger than segment";
+    char* record = column->segments.empty()
+                       ? nullptr
+                       : column->segments.back()->append(record_size);
+    if (record == nullptr) {
+      column->segments.emplace_back(new MmapSegment(
+          column->dir + "/" + std::to_string(column->next_segment_id++),
+          _segment_size));
+      record = column->segments.back()->append(record_size);
+    }
+    memcpy(record, &key, sizeof(uint64_t));
+    uint32_t len = value_len;
+    memcpy(record + sizeof(uint64_t), &len, sizeof(uint32_t));
+    memcpy(record + kRecordHeaderSize, value, value_len);
+
+    Location loc;
+    loc.segment = column->segments.size() - 1;
+    loc.offset = record - column->segments.back()->data();
+    auto ret = column->index.insert({key, loc});
+    if (!ret.second) {
+      size_t old_size =
+          RecordSize(RecordValueLen(Resolve(*column, ret.first->second)));
+      column->live_bytes -= old_size;
+      column->garbage_bytes += old_size;
+      ret.first->second = loc;
+    }
+    column->live_bytes += record_size;
+  }
+
+  // rewrite the live records of column into new segments
+  void Compact(Column* column) {
+    VLOG(1) << "compact " << column->dir << " live: " << column->live_bytes
+            << " garbage: " << column->garbage_bytes;
+    std::vector<std::unique_ptr<MmapSegment>> old_segments;
+    old_segments.swap(column->segments);
+    auto old_index = std::move(column->index);
+    column->index = robin_hood::unordered_flat_map<uint64_t, Location>();
+    column->live_bytes = 0;
+    column->garbage_bytes = 0;
+    for (auto& kv : old_index) {
+      const char* record =
+          old_segments[kv.second.segment]->data() + kv.second.offset;
+      Append(column, kv.first, RecordValue(record), RecordValueLen(record));
+    }
+  }
+
+  size_t _segment_size = 256UL << 20;
+  std::vector<std::unique_ptr<Column>> _columns;
+  Uint64Comparator _comparator;
+};
+
+inline rocksdb::Slice MmapSegmentIterator::value() const {
+  const char* record = _records[_pos].second;
+  return rocksdb::Slice(MmapSegmentHandler::RecordValue(record),
+                        MmapSegmentHandler::RecordValueLen(record));
+}
+
+}  // namespace distributed
+}  // namespace paddle
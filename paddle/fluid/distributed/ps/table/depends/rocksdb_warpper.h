@@ -27,6 +27,8 @@
 
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace paddle {
 namespace distributed {
@@ -80,7 +82,46 @@ class RocksDBCtx {
   int cur_index;
 };
 
-class RocksDBHandler {
+// SSDHandler is the interface of the storage of the values that
+// SSDSparseTable moves out of memory, one column per local shard.
+class SSDHandler {
+ public:
+  virtual ~SSDHandler() {}
+
+  virtual int initialize(const std::string& db_path, const int colnum) = 0;
+  virtual int put(int id,
+                  const char* key,
+                  int key_len,
+                  const char* value,
+                  int value_len) = 0;
+  virtual int put_batch(
+      int id,
+      std::vector<std::pair<char*, int>>& ssd_keys,    // NOLINT
+      std::vector<std::pair<char*, int>>& ssd_values,  // NOLINT
+      int n) = 0;
+  // return 1 if key is not found
+  virtual int get(int id,
+                  const char* key,
+                  int key_len,
+                  std::string& value) = 0;  // NOLINT
+  virtual void multi_get(int id,
+                         const size_t num_keys,
+                         const rocksdb::Slice* keys,
+                         rocksdb::PinnableSlice* values,
+                         rocksdb::Status* status,
+                         const bool sorted_input = true) = 0;
+  virtual int del_data(int id, const char* key, int key_len) = 0;
+  virtual int flush(int id) = 0;
+  // the caller owns the returned iterator
+  virtual rocksdb::Iterator* get_iterator(int id) = 0;
+  virtual int get_estimate_key_num(uint64_t& num_keys) = 0;  // NOLINT
+  virtual Uint64Comparator* get_comparator() = 0;
+  // move the sst files written with get_comparator() into column id
+  virtual int ingest_externel_file(
+      int id, const std::vector<std::string>& sst_filelist) = 0;
+};
+
+class RocksDBHandler : public SSDHandler {
  public:
   RocksDBHandler() {}
   ~RocksDBHandler() {}
@@ -90,7 +131,7 @@ class RocksDBHandler {
     return &handler;
   }
 
-  int initialize(const std::string& db_path, const int colnum) {
+  int initialize(const std::string& db_path, const int colnum) override {
     VLOG(0) << "db path: " << db_path << " colnum: " << colnum;
     _dbs.resize(colnum);
     for (int i = 0; i < colnum; i++) {
@@ -157,8 +198,11 @@ class RocksDBHandler {
     return 0;
   }
 
-  int put(
-      int id, const char* key, int key_len, const char* value, int value_len) {
+  int put(int id,
+          const char* key,
+          int key_len,
+          const char* value,
+          int value_len) override {
     rocksdb::WriteOptions options;
     options.disableWAL = true;
     rocksdb::Status s = _dbs[id]->Put(options,
@@ -171,7 +215,7 @@ class RocksDBHandler {
   int put_batch(int id,
                 std::vector<std::pair<char*, int>>& ssd_keys,    // NOLINT
                 std::vector<std::pair<char*, int>>& ssd_values,  // NOLINT
-                int n) {
+                int n) override {
     rocksdb::WriteOptions options;
     options.disableWAL = true;
     rocksdb::WriteBatch batch(n * 128);
@@ -184,7 +228,10 @@ class RocksDBHandler {
     return 0;
   }
 
-  int get(int id, const char* key, int key_len, std::string& value) {  // NOLINT
+  int get(int id,
+          const char* key,
+          int key_len,
+          std::string& value) override {  // NOLINT
     rocksdb::Status s = _dbs[id]->Get(
         rocksdb::ReadOptions(), rocksdb::Slice(key, key_len), &value);
     if (s.IsNotFound()) {
@@ -199,7 +246,7 @@ class RocksDBHandler {
                  const rocksdb::Slice* keys,
                  rocksdb::PinnableSlice* values,
                  rocksdb::Status* status,
-                 const bool sorted_input = true) {
+                 const bool sorted_input = true) override {
     rocksdb::ColumnFamilyHandle* handle = _dbs[id]->DefaultColumnFamily();
     auto read_opt = rocksdb::ReadOptions();
     read_opt.fill_cache = false;
@@ -207,7 +254,7 @@ class RocksDBHandler {
         read_opt, handle, num_keys, keys, values, status, sorted_input);
   }
 
-  int del_data(int id, const char* key, int key_len) {
+  int del_data(int id, const char* key, int key_len) override {
     rocksdb::WriteOptions options;
     options.disableWAL = true;
     rocksdb::Status s = _dbs[id]->Delete(options, rocksdb::Slice(key, key_len));
@@ -215,17 +262,17 @@ class RocksDBHandler {
     return 0;
   }
 
-  int flush(int id) {
+  int flush(int id) override {
     rocksdb::Status s = _dbs[id]->Flush(rocksdb::FlushOptions());
     assert(s.ok());
     return 0;
   }
 
-  rocksdb::Iterator* get_iterator(int id) {
+  rocksdb::Iterator* get_iterator(int id) override {
     return _dbs[id]->NewIterator(rocksdb::ReadOptions());
   }
 
-  int get_estimate_key_num(uint64_t& num_keys) {  // NOLINT
+  int get_estimate_key_num(uint64_t& num_keys) override {  // NOLINT
     num_keys = 0;
     for (size_t i = 0; i < _dbs.size(); i++) {
       uint64_t cur_keys = 0;
@@ -235,10 +282,10 @@ class RocksDBHandler {
     return 0;
   }
 
-  Uint64Comparator* get_comparator() { return &_comparator; }
+  Uint64Comparator* get_comparator() override { return &_comparator; }
 
-  int ingest_externel_file(int id,
-                           const std::vector<std::string>& sst_filelist) {
+  int ingest_externel_file(
+      int id, const std::vector<std::string>& sst_filelist) override {
     rocksdb::IngestExternalFileOptions ifo;
     ifo.move_files = true;
     rocksdb::Status s = _dbs[id]->IngestExternalFile(sst_filelist, ifo);
@@ -13,10 +13,48 @@
 // limitations under the License.
 
 #include "paddle/fluid/distributed/ps/table/graph/graph_edge.h"
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <numeric>
+
+#include "paddle/fluid/platform/enforce.h"
 namespace paddle {
 namespace distributed {
 
+namespace {
+
+size_t varint_size(uint64_t v) {
+  size_t n = 1;
+  while (v >= 0x80) {
+    v >>= 7;
+    ++n;
+  }
+  return n;
+}
+
+uint8_t* put_varint(uint8_t* p, uint64_t v) {
+  while (v >= 0x80) {
+    *p++ = static_cast<uint8_t>(v | 0x80);
+    v >>= 7;
+  }
+  *p++ = static_cast<uint8_t>(v);
+  return p;
+}
+
+uint64_t get_varint(const uint8_t** p) {
+  uint64_t v = 0;
+  int shift = 0;
+  while (**p & 0x80) {
+    v |= static_cast<uint64_t>(*(*p)++ & 0x7f) << shift;
+    shift += 7;
+  }
+  v |= static_cast<uint64_t>(*(*p)++) << shift;
+  return v;
+}
+
+}  // namespace
+
 void GraphEdgeBlob::add_edge(int64_t id, float weight = 1) {
   id_arr.push_back(id);
 }
@@ -25,7 +63,105 @@ void WeightedGraphEdgeBlob::add_edge(int64_t id, float weight = 1) {
   id_arr.push_back(id);
 #ifdef PADDLE_WITH_CUDA
   weight_arr.push_back((half)weight);
+#else
+  weight_arr.push_back(weight);
 #endif
 }
+
+CompactGraphEdgeBlob::CompactGraphEdgeBlob(GraphEdgeBlob* edges,
+                                           bool quantize_weight) {
+  size_ = static_cast<uint32_t>(edges->size());
+  std::vector<uint64_t> ids(size_);
+  std::vector<float> weights;
+  for (uint32_t i = 0; i < size_; ++i) {
+    ids[i] = static_cast<uint64_t>(edges->get_id(i));
+  }
+  // sort the neighbors by id, and the weights along with them
+  std::vector<uint32_t> order(size_);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&ids](uint32_t a, uint32_t b) {
+    return ids[a] < ids[b];
+  });
+  float max_weight = 0;
+  float min_weight = 0;
+  if (edges->is_weighted()) {
+    weights.resize(size_);
+    for (uint32_t i = 0; i < size_; ++i) {
+      weights[i] = static_cast<float>(edges->get_weight(order[i]));
+      max_weight = std::max(max_weight, weights[i]);
+      min_weight = std::min(min_weight, weights[i]);
+    }
+    weight_type_ =
+        quantize_weight && min_weight >= 0 ? kQuantizedWeight : kFloatWeight;
+  }
+  std::vector<uint64_t> sorted_ids(size_);
+  for (uint32_t i = 0; i < size_; ++i) {
+    sorted_ids[i] = ids[order[i]];
+  }
+
+  size_t id_bytes = 0;
+  for (uint32_t i = 0; i < size_; ++i) {
+    id_bytes += varint_size(i % kBlockSize == 0
+                                ? sorted_ids[i]
+                                : sorted_ids[i] - sorted_ids[i - 1]);
+  }
+  size_t bytes = block_num() * sizeof(uint32_t) + weight_bytes() + id_bytes;
+  PADDLE_ENFORCE_LE(
+      bytes,
+      static_cast<size_t>(UINT32_MAX),
+      phi::errors::InvalidArgument(
+          "The neighbors of a node are too many to compact, %d bytes.",
+          bytes));
+  bytes_ = static_cast<uint32_t>(bytes);
+  data_.reset(new uint8_t[bytes_]);
+
+  uint8_t* w = data_.get() + block_num() * sizeof(uint32_t);
+  if (weight_type_ == kFloatWeight) {
+    memcpy(w, weights.data(), weight_bytes());
+  } else if (weight_type_ == kQuantizedWeight) {
+    weight_scale_ = max_weight > 0 ? max_weight / 255 : 1.0;
+    for (uint32_t i = 0; i < size_; ++i) {
+      w[i] = static_cast<uint8_t>(
+          std::min(255.0f, std::round(weights[i] / weight_scale_)));
+    }
+  }
+  uint32_t* restarts = reinterpret_cast<uint32_t*>(data_.get());
+  uint8_t* begin = w + weight_bytes();
+  uint8_t* p = begin;
+  for (uint32_t i = 0; i < size_; ++i) {
+    if (i % kBlockSize == 0) {
+      restarts[i / kBlockSize] = static_cast<uint32_t>(p - begin);
+      p = put_varint(p, sorted_ids[i]);
+    } else {
+      p = put_varint(p, sorted_ids[i] - sorted_ids[i - 1]);
+    }
+  }
+}
+
+void CompactGraphEdgeBlob::add_edge(int64_t id, float weight UNUSED) {
+  PADDLE_THROW(phi::errors::PreconditionNotMet(
+      "Can not add edge %d to the frozen neighbors of a node.", id));
+}
+
+int64_t CompactGraphEdgeBlob::get_id(int idx) {
+  const uint32_t* restarts = reinterpret_cast<const uint32_t*>(data_.get());
+  const uint8_t* p = id_begin() + restarts[idx / kBlockSize];
+  uint64_t id = get_varint(&p);
+  for (int i = idx % kBlockSize; i > 0; --i) {
+    id += get_varint(&p);
+  }
+  return static_cast<int64_t>(id);
+}
+
+float CompactGraphEdgeBlob::decode_weight(int idx) {
+  if (weight_type_ == kQuantizedWeight) {
+    return weight_begin()[idx] * weight_scale_;
+  } else if (weight_type_ == kFloatWeight) {
+    float weight;
+    memcpy(&weight, weight_begin() + idx * sizeof(float), sizeof(float));
+    return weight;
+  }
+  return 1.0;
+}
 }  // namespace distributed
 }  // namespace paddle
@@ -18,6 +18,7 @@
 #endif
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include "paddle/common/macros.h"
 namespace paddle {
@@ -27,14 +28,17 @@ class GraphEdgeBlob {
  public:
   GraphEdgeBlob() {}
   virtual ~GraphEdgeBlob() {}
-  size_t size() { return id_arr.size(); }
+  virtual size_t size() { return id_arr.size(); }
   virtual void add_edge(int64_t id, float weight);
-  int64_t get_id(int idx) { return id_arr[idx]; }
+  virtual int64_t get_id(int idx) { return id_arr[idx]; }
 #ifdef PADDLE_WITH_CUDA
   virtual half get_weight(int idx UNUSED) { return (half)(1.0); }
 #else
   virtual float get_weight(int idx UNUSED) { return 1.0; }
 #endif
+  virtual bool is_weighted() { return false; }
+  // a frozen blob rejects add_edge
+  virtual bool is_frozen() { return false; }
   std::vector<int64_t>& export_id_array() { return id_arr; }
 
  protected:
@@ -46,6 +50,7 @@ class WeightedGraphEdgeBlob : public GraphEdgeBlob {
   WeightedGraphEdgeBlob() {}
   virtual ~WeightedGraphEdgeBlob() {}
   virtual void add_edge(int64_t id, float weight);
+  virtual bool is_weighted() { return true; }
 #ifdef PADDLE_WITH_CUDA
   virtual half get_weight(int idx) { return weight_arr[idx]; }
 #else
@@ -59,5 +64,53 @@ class WeightedGraphEdgeBlob : public GraphEdgeBlob {
   std::vector<float> weight_arr;
 #endif
 };
+
+// The frozen neighbors of a node after loading, in a single buffer of
+//   restarts(u32 * block_num) weights(float or u8 * size) ids(varint)
+// The ids are sorted and delta encoded by varint, and every kBlockSize
+// neighbors restart from a full id, so that get_id decodes at most
+// kBlockSize varints. The weights are quantized to 8 bits by the max
+// weight of the node when quantize_weight is set and no weight is
+// negative, or kept as floats.
+class CompactGraphEdgeBlob : public GraphEdgeBlob {
+ public:
+  static constexpr int kBlockSize = 16;
+
+  CompactGraphEdgeBlob(GraphEdgeBlob* edges, bool quantize_weight);
+  virtual ~CompactGraphEdgeBlob() {}
+  virtual size_t size() { return size_; }
+  virtual void add_edge(int64_t id, float weight);
+  virtual int64_t get_id(int idx);
+#ifdef PADDLE_WITH_CUDA
+  virtual half get_weight(int idx) { return (half)decode_weight(idx); }
+#else
+  virtual float get_weight(int idx) { return decode_weight(idx); }
+#endif
+  virtual bool is_weighted() { return weight_type_ != kNoWeight; }
+  virtual bool is_frozen() { return true; }
+  // the bytes of the buffer
+  size_t bytes() const { return bytes_; }
+
+ private:
+  enum WeightType : uint8_t { kNoWeight, kFloatWeight, kQuantizedWeight };
+
+  float decode_weight(int idx);
+  const uint8_t* weight_begin() const {
+    return data_.get() + block_num() * sizeof(uint32_t);
+  }
+  size_t weight_bytes() const {
+    return weight_type_ == kFloatWeight       ? size_ * sizeof(float)
+           : weight_type_ == kQuantizedWeight ? size_
+                                              : 0;
+  }
+  const uint8_t* id_begin() const { return weight_begin() + weight_bytes(); }
+  size_t block_num() const { return (size_ + kBlockSize - 1) / kBlockSize; }
+
+  uint32_t size_ = 0;
+  uint32_t bytes_ = 0;
+  WeightType weight_type_ = kNoWeight;
+  float weight_scale_ = 1.0;
+  std::unique_ptr<uint8_t[]> data_;
+};
 }  // namespace distributed
 }  // namespace paddle
@@ -65,6 +65,32 @@ void GraphNode::build_edges(bool is_weighted) {
     }
   }
 }
+void GraphNode::reset_edges(GraphEdgeBlob* new_edges) {
+  delete edges;
+  edges = new_edges;
+  if (sampler != nullptr) {
+    sampler->build(edges);
+  }
+}
+void GraphNode::compact_edges(bool quantize_weight) {
+  if (edges == nullptr || edges->is_frozen()) {
+    return;
+  }
+  reset_edges(new CompactGraphEdgeBlob(edges, quantize_weight));
+}
+void GraphNode::thaw_edges() {
+  GraphEdgeBlob* new_edges = nullptr;
+  if (edges->is_weighted()) {
+    new_edges = new WeightedGraphEdgeBlob();
+  } else {
+    new_edges = new GraphEdgeBlob();
+  }
+  for (size_t i = 0; i < edges->size(); ++i) {
+    new_edges->add_edge(edges->get_id(i),
+                        static_cast<float>(edges->get_weight(i)));
+  }
+  reset_edges(new_edges);
+}
 void GraphNode::build_sampler(std::string sample_type) {
   if (sampler != nullptr) {
     return;
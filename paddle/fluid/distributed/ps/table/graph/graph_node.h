@@ -44,6 +44,7 @@ class Node {
   virtual void build_edges(bool is_weighted UNUSED) {}
   virtual void build_sampler(std::string sample_type UNUSED) {}
   virtual void add_edge(uint64_t id UNUSED, float weight UNUSED) {}
+  virtual void compact_edges(bool quantize_weight UNUSED) {}
   virtual std::vector<int> sample_k(
       int k UNUSED, const std::shared_ptr<std::mt19937_64> rng UNUSED) {
     return std::vector<int>();
@@ -98,8 +99,13 @@ class GraphNode : public Node {
   virtual void build_edges(bool is_weighted);
   virtual void build_sampler(std::string sample_type);
   virtual void add_edge(uint64_t id, float weight) {
+    if (edges->is_frozen()) {
+      thaw_edges();
+    }
     edges->add_edge(id, weight);
   }
+  // freeze the loaded neighbors into a CompactGraphEdgeBlob
+  virtual void compact_edges(bool quantize_weight);
   virtual std::vector<int> sample_k(
       int k, const std::shared_ptr<std::mt19937_64> rng) {
     return sampler->sample_k(k, rng);
@@ -113,6 +119,10 @@ class GraphNode : public Node {
   virtual size_t get_neighbor_size() { return edges->size(); }
 
  protected:
+  // replace the edges, the sampler is rebuilt on the new ones
+  void reset_edges(GraphEdgeBlob *new_edges);
+  void thaw_edges();
+
   Sampler *sampler;
   GraphEdgeBlob *edges;
 };
@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/distributed/ps/table/memory_dense_table.h"
 
+#include <algorithm>
+
 #include "paddle/fluid/platform/enforce.h"
 
 namespace paddle {
@@ -51,6 +53,7 @@ int32_t MemoryDenseTable::Initialize() {
 
   InitializeValue();
   InitializeOptimizer();
+  InitializeBlocks();
   return 0;
 }
 
@@ -124,6 +127,45 @@ int32_t MemoryDenseTable::InitializeOptimizer() {
   return 0;
 }
 
+int32_t MemoryDenseTable::InitializeBlocks() {
+  const auto &update_param = _config.dense_update_param();
+  update_mode_ = update_param.mode();
+  if (sync || param_dim_ <= 0 || optimizer_ == nullptr) {
+    update_mode_ = DenseUpdateParameter::POOL;
+  }
+  if (update_mode_ == DenseUpdateParameter::POOL) {
+    return 0;
+  }
+  merge_pushes_ = update_mode_ == DenseUpdateParameter::BLOCK_LOCK &&
+                  update_param.merge_pushes();
+
+  // the blocks are whole cache lines, so that the blocks updated by different
+  // threads do not share a line
+  constexpr int kCacheLineFloats = 64 / sizeof(float);
+  int block_size = std::max(static_cast<int>(update_param.block_size()), 1);
+  block_size = (block_size + kCacheLineFloats - 1) / kCacheLineFloats *
+               kCacheLineFloats;
+  block_offsets_.clear();
+  for (int begin = 0; begin < param_dim_; begin += block_size) {
+    block_offsets_.push_back(begin);
+  }
+  block_offsets_.push_back(param_dim_);
+  blocks_.resize(block_offsets_.size() - 1);
+  for (auto &block : blocks_) {
+    block.reset(new DenseBlock());
+  }
+  if (merge_pushes_) {
+    merged_values_.assign(param_dim_, 0);
+    applied_values_.assign(param_dim_, 0);
+  }
+  optimizer_->SetBlocks(block_offsets_);
+  VLOG(1) << "MemoryDenseTable update mode "
+          << DenseUpdateParameter::Mode_Name(update_mode_) << " with "
+          << blocks_.size() << " blocks of " << block_size
+          << " floats, merge pushes: " << merge_pushes_;
+  return 0;
+}
+
 int32_t MemoryDenseTable::SetGlobalLR(float *lr) {
   _global_lr = lr;
   optimizer_->SetGlobalLR(_global_lr);
@@ -179,6 +221,8 @@ int32_t MemoryDenseTable::PushDense(const float *values, size_t num) {
           return 0;
         });
     task.wait();
+  } else if (update_mode_ != DenseUpdateParameter::POOL) {
+    _PushDenseBlocks(values, num);
   } else {
     _PushDense(values, num);
   }
@@ -212,6 +256,74 @@ int32_t MemoryDenseTable::_PushDense(const float *values, size_t num) {
   return 0;
 }
 
+int32_t MemoryDenseTable::_PushDenseBlocks(const float *values, size_t num) {
+  PADDLE_ENFORCE_GE(
+      num,
+      param_dim_,
+      paddle::platform::errors::InvalidArgument(
+          "update dense numel expected %d, but got %d", param_dim_, num));
+  // the pushes of different trainers run on their own threads, they start
+  // from different blocks to meet less on the same block
+  size_t block_num = blocks_.size();
+  size_t first_block = next_block_.fetch_add(1) % block_num;
+  for (size_t i = 0; i < block_num; ++i) {
+    UpdateBlock((first_block + i) % block_num, values);
+  }
+  VLOG(2) << "debug MemoryDenseTable::_push_dense_blocks done";
+  return 0;
+}
+
+void MemoryDenseTable::UpdateBlock(size_t block_id, const float *values) {
+  DenseBlock *block = blocks_[block_id].get();
+  int begin = block_offsets_[block_id];
+  int end = block_offsets_[block_id + 1];
+  if (update_mode_ == DenseUpdateParameter::HOGWILD) {
+    optimizer_->Update(values, param_dim_, begin, end);
+    return;
+  }
+  if (!merge_pushes_) {
+    std::lock_guard<std::mutex> lock(block->mutex);
+    optimizer_->Update(values, param_dim_, begin, end);
+    return;
+  }
+
+  if (!block->busy.exchange(true, std::memory_order_acquire)) {
+    optimizer_->Update(values, param_dim_, begin, end);
+  } else {
+    // leave the push to the holder of the block, and apply it here only if
+    // the holder was done before it was merged
+    {
+      std::lock_guard<std::mutex> lock(block->merge_mutex);
+      for (int i = begin; i < end; ++i) {
+        merged_values_[i] += values[i];
+      }
+      ++block->merged_num;
+    }
+    if (block->busy.exchange(true, std::memory_order_acquire)) {
+      return;
+    }
+  }
+  // the holder applies the pushes merged while it updated the block, the
+  // block is released under merge_mutex, so that no push is merged after the
+  // last check and left behind
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(block->merge_mutex);
+      if (block->merged_num == 0) {
+        block->busy.store(false, std::memory_order_release);
+        return;
+      }
+      std::copy(merged_values_.begin() + begin,
+                merged_values_.begin() + end,
+                applied_values_.begin() + begin);
+      std::fill(
+          merged_values_.begin() + begin, merged_values_.begin() + end, 0);
+      block->merged_num = 0;
+    }
+    optimizer_->Update(applied_values_.data(), param_dim_, begin, end);
+  }
+}
+
 int32_t MemoryDenseTable::Load(const std::string &path,
                                const std::string &param) {
   if (param_dim_ <= 0) {
@@ -18,7 +18,11 @@
 #include <assert.h>
 #include <pthread.h>
 
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <vector>
 
 #include "Eigen/Dense"
 #include "paddle/fluid/distributed/ps/table/accessor.h"
@@ -66,8 +70,25 @@ class MemoryDenseTable : public Table {
 
  protected:
   int32_t _PushDense(const float* values, size_t num);
+  // Updates the blocks of the param by the pushing thread, see
+  // DenseUpdateParameter.
+  int32_t _PushDenseBlocks(const float* values, size_t num);
 
  private:
+  // A block of param_dim_ that is updated by one push at a time in the
+  // BLOCK_LOCK mode.
+  struct DenseBlock {
+    std::mutex mutex;
+    // held by the push applying the merged pushes
+    std::atomic<bool> busy{false};
+    // guards merged_num and the block of merged_values_
+    std::mutex merge_mutex;
+    int merged_num{0};
+  };
+
+  int32_t InitializeBlocks();
+  void UpdateBlock(size_t block_id, const float* values);
+
   const int task_pool_size_ = 10;
   bool sync = true;
   std::vector<std::shared_ptr<::ThreadPool>> _shards_task_pool;
@@ -81,6 +102,17 @@ class MemoryDenseTable : public Table {
   int total_dim_ = 0;
   int fixed_len_params_dim_ = 0;    // used for save/load
   std::vector<int> param_col_ids_;  // used for save/load
+
+  DenseUpdateParameter::Mode update_mode_{DenseUpdateParameter::POOL};
+  bool merge_pushes_{false};
+  std::vector<int> block_offsets_;
+  std::vector<std::unique_ptr<DenseBlock>> blocks_;
+  // the block a push starts from, so that the concurrent pushes start apart
+  std::atomic<size_t> next_block_{0};
+  // the sums of the pushes waiting for their blocks, and their copies being
+  // applied by the holders of the blocks
+  std::vector<float> merged_values_;
+  std::vector<float> applied_values_;
 };
 
 }  // namespace distributed
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <omp.h>
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <sstream>
 
 #include "glog/logging.h"
@@ -38,6 +40,10 @@ PD_DEFINE_bool(pserver_enable_create_feasign_randomly,
 PD_DEFINE_int32(pserver_table_save_max_retry,
                 3,
                 "pserver_table_save_max_retry");
+PD_DEFINE_bool(pserver_sparse_table_save_delta,
+               false,
+               "track the updated keys of MemorySparseTable, so that "
+               "save_param 6 saves only the rows updated since the last base");
 
 namespace paddle {
 namespace distributed {
@@ -51,10 +57,128 @@ int32_t MemorySparseTable::Initialize() {
   for (auto &shards_task : _shards_task_pool) {
     shards_task.reset(new ::ThreadPool(1));
   }
+  const auto &admission = _config.admission_param();
+  if (admission.enable()) {
+    PADDLE_ENFORCE_LE(admission.min_count(),
+                      255,
+                      paddle::platform::errors::InvalidArgument(
+                          "The min_count of admission_param should be at "
+                          "most 255, but got %d",
+                          admission.min_count()));
+    _admission_sketches.resize(_real_local_shard_num);
+    for (auto &sketch : _admission_sketches) {
+      sketch.Reset(admission.sketch_width(), admission.sketch_depth());
+    }
+  }
+  const auto &eviction = _config.eviction_param();
+  if (eviction.enable() && _real_local_shard_num > 0) {
+#ifdef PADDLE_WITH_HETERPS
+    // the values pulled by PullSparsePtr are held until the end of the pass
+    PADDLE_THROW(paddle::platform::errors::Unimplemented(
+        "The eviction of MemorySparseTable is not supported with HeterPS"));
+#endif
+    // only the CtrCommonAccessor gives the fields of the eviction
+    PADDLE_ENFORCE_EQ(_config.accessor().accessor_class(),
+                      "CtrCommonAccessor",
+                      paddle::platform::errors::Unimplemented(
+                          "The eviction of MemorySparseTable is only "
+                          "supported with CtrCommonAccessor, but got %s",
+                          _config.accessor().accessor_class()));
+    PADDLE_ENFORCE_GT(eviction.interval_ms(),
+                      0,
+                      paddle::platform::errors::InvalidArgument(
+                          "The interval_ms of eviction_param should be "
+                          "greater than 0"));
+    _evict_thread = std::thread(&MemorySparseTable::EvictLoop, this);
+  }
   VLOG(0) << "initalize MemorySparseTable succ";
   return 0;
 }
 
+MemorySparseTable::~MemorySparseTable() {
+  if (_evict_thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(_evict_mutex);
+      _evict_stop = true;
+    }
+    _evict_cv.notify_all();
+    _evict_thread.join();
+  }
+}
+
+void MemorySparseTable::EvictLoop() {
+  const auto interval =
+      std::chrono::milliseconds(_config.eviction_param().interval_ms());
+  int shard_id = 0;
+  std::unique_lock<std::mutex> lock(_evict_mutex);
+  while (!_evict_cv.wait_for(lock, interval, [this] { return _evict_stop; })) {
+    lock.unlock();
+    {
+      // the task pool of the shard orders it with the pulls and pushes
+      std::lock_guard<std::mutex> shard_lock(_evict_shard_mutex);
+      _shards_task_pool[shard_id % _task_pool_size]
+          ->enqueue([this, shard_id]() -> int { return EvictShard(shard_id); })
+          .wait();
+    }
+    shard_id = (shard_id + 1) % _real_local_shard_num;
+    lock.lock();
+  }
+}
+
+int32_t MemorySparseTable::EvictShard(int shard_id) {
+  const auto &eviction = _config.eviction_param();
+  auto &shard = _local_shards[shard_id];
+  size_t evict_size = 0;
+  auto evict = [&](shard_type::iterator it) {
+    MarkDelta(shard_id, it.key());
+    if (_config.enable_revert()) {
+      _local_shards_new[shard_id].erase(it.key());
+    }
+    ++evict_size;
+    return shard.erase(it);
+  };
+  // TTL, the keys unseen for ttl_days
+  if (eviction.ttl_days() > 0) {
+    for (auto it = shard.begin(); it != shard.end();) {
+      if (_value_accesor->GetField(it.value().data(), "unseen_days") >=
+          eviction.ttl_days()) {
+        it = evict(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  // LFU, the keys of the lowest show_click_score over max_keys_per_shard
+  size_t max_keys = eviction.max_keys_per_shard();
+  if (max_keys > 0 && shard.size() > max_keys) {
+    std::vector<float> scores;
+    scores.reserve(shard.size());
+    for (auto it = shard.begin(); it != shard.end(); ++it) {
+      scores.push_back(
+          _value_accesor->GetField(it.value().data(), "show_click_score"));
+    }
+    size_t over_size = shard.size() - max_keys;
+    std::nth_element(
+        scores.begin(), scores.begin() + over_size - 1, scores.end());
+    float threshold = scores[over_size - 1];
+    for (auto it = shard.begin(); it != shard.end() && over_size > 0;) {
+      if (_value_accesor->GetField(it.value().data(), "show_click_score") <=
+          threshold) {
+        it = evict(it);
+        --over_size;
+      } else {
+        ++it;
+      }
+    }
+  }
+  if (!_admission_sketches.empty()) {
+    _admission_sketches[shard_id].Decay();
+  }
+  VLOG(1) << "MemorySparseTable::EvictShard shard_id: " << shard_id
+          << " evict size: " << evict_size << " size: " << shard.size();
+  return 0;
+}
+
 int32_t MemorySparseTable::InitializeValue() {
   _sparse_table_shard_num = static_cast<int>(_config.shard_num());
   _avg_local_shard_num =
@@ -76,6 +200,9 @@ int32_t MemorySparseTable::InitializeValue() {
           << " _task_pool_size:" << _task_pool_size;
 
   _local_shards.reset(new shard_type[_real_local_shard_num]);
+  if (FLAGS_pserver_sparse_table_save_delta) {
+    _delta_keys.resize(_real_local_shard_num);
+  }
 
   if (_config.enable_revert()) {
     // calculate merged shard number based on config param;
@@ -106,6 +233,7 @@ int32_t MemorySparseTable::InitializeValue() {
 
 int32_t MemorySparseTable::Load(const std::string &path,
                                 const std::string &param) {
+  auto evict_pause = PauseEviction();
   std::string table_path = TableDir(path);
   auto file_list = _afs_client.list(table_path);
 
@@ -139,6 +267,56 @@ int32_t MemorySparseTable::Load(const std::string &path,
   size_t feature_value_size =
       _value_accesor->GetAccessorInfo().size / sizeof(float);
 
+  // the deltas saved on the base by every server, each line of a manifest
+  // is "delta_name file_start_idx file_num"
+  std::vector<std::string> delta_files(_real_local_shard_num);
+  if (load_param == 0) {
+    _delta_base_path = path;
+    _delta_name.clear();
+    std::string delta_dir = DeltaDir(path);
+    std::string self_manifest =
+        ::paddle::string::format_string("manifest-%03d", _shard_idx);
+    for (auto &manifest : _afs_client.list(delta_dir)) {
+      if (manifest.find("manifest-") == std::string::npos) {
+        continue;
+      }
+      bool is_self = manifest.size() >= self_manifest.size() &&
+                     manifest.compare(manifest.size() - self_manifest.size(),
+                                      self_manifest.size(),
+                                      self_manifest) == 0;
+      FsChannelConfig manifest_config;
+      manifest_config.path = manifest;
+      int err_no = 0;
+      std::string line_data;
+      auto read_channel = _afs_client.open_r(manifest_config, 0, &err_no);
+      while (read_channel->read_line(line_data) == 0 && !line_data.empty()) {
+        char delta_name[256];
+        size_t start_idx = 0;
+        size_t file_num = 0;
+        if (sscanf(line_data.c_str(),
+                   "%255s %zu %zu",
+                   delta_name,
+                   &start_idx,
+                   &file_num) != 3) {
+          LOG(WARNING) << "MemorySparseTable invalid delta manifest line: "
+                       << line_data << " in " << manifest;
+          continue;
+        }
+        if (is_self) {
+          _delta_name = delta_name;
+        }
+        for (int i = 0; i < _real_local_shard_num; ++i) {
+          size_t file_idx = file_start_idx + i;
+          if (file_idx >= start_idx && file_idx < start_idx + file_num) {
+            delta_files[i] = ::paddle::string::format_string(
+                "%s%s/part-%05d.gz", delta_dir.c_str(), delta_name, file_idx);
+          }
+        }
+      }
+      read_channel->close();
+    }
+  }
+
 #ifdef PADDLE_WITH_HETERPS
   int thread_num = _real_local_shard_num;
 #else
@@ -194,6 +372,9 @@ int32_t MemorySparseTable::Load(const std::string &path,
         exit(-1);
       }
     } while (is_read_failed);
+    if (!delta_files[i].empty()) {
+      LoadDelta(delta_files[i], i);
+    }
   }
   LOG(INFO) << "MemorySparseTable load success, path from "
             << file_list[file_start_idx] << " to "
@@ -300,7 +481,67 @@ int32_t MemorySparseTable::LoadPatch(const std::vector<std::string> &file_list,
   return 0;
 }
 
+int32_t MemorySparseTable::LoadDelta(const std::string &delta_path, int i) {
+  size_t feature_value_size =
+      _value_accesor->GetAccessorInfo().size / sizeof(float);
+  FsChannelConfig channel_config;
+  channel_config.path = delta_path;
+  channel_config.converter = _value_accesor->Converter(0).converter;
+  channel_config.deconverter = _value_accesor->Converter(0).deconverter;
+
+  bool is_read_failed = false;
+  int retry_num = 0;
+  int err_no = 0;
+  int feasign_size = 0;
+  do {
+    is_read_failed = false;
+    err_no = 0;
+    feasign_size = 0;
+    std::string line_data;
+    auto read_channel = _afs_client.open_r(channel_config, 0, &err_no);
+    char *end = NULL;
+    auto &shard = _local_shards[i];
+    try {
+      while (read_channel->read_line(line_data) == 0 && !line_data.empty()) {
+        uint64_t key = std::strtoul(line_data.data(), &end, 10);
+        MarkDelta(i, key);
+        ++feasign_size;
+        // a key without value is erased since the base
+        if (*end == '\0') {
+          shard.erase(key);
+          continue;
+        }
+        auto &value = shard[key];
+        value.resize(feature_value_size);
+        int parse_size = _value_accesor->ParseFromString(++end, value.data());
+        value.resize(parse_size);
+      }
+      read_channel->close();
+      if (err_no == -1) {
+        ++retry_num;
+        is_read_failed = true;
+        LOG(ERROR) << "MemorySparseTable load delta failed after read, "
+                   << "retry it! path:" << delta_path
+                   << " , retry_num=" << retry_num;
+      }
+    } catch (...) {
+      ++retry_num;
+      is_read_failed = true;
+      LOG(ERROR) << "MemorySparseTable load delta failed, retry it! path:"
+                 << delta_path << " , retry_num=" << retry_num;
+    }
+    if (retry_num > FLAGS_pserver_table_save_max_retry) {
+      LOG(ERROR) << "MemorySparseTable load delta failed reach max limit!";
+      exit(-1);
+    }
+  } while (is_read_failed);
+  VLOG(1) << "MemorySparseTable load delta success, path: " << delta_path
+          << " feasign_size: " << feasign_size;
+  return 0;
+}
+
 void MemorySparseTable::Revert() {
+  auto evict_pause = PauseEviction();
   for (int i = 0; i < _real_local_shard_num; ++i) {
     _local_shards_new[i].clear();
   }
@@ -312,6 +553,7 @@ void MemorySparseTable::CheckSavePrePatchDone() {
 
 int32_t MemorySparseTable::Save(const std::string &dirname,
                                 const std::string &param) {
+  auto evict_pause = PauseEviction();
   if (_real_local_shard_num == 0) {
     _local_show_threshold = -1;
     return 0;
@@ -330,6 +572,25 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
     return 0;
   }
 
+  // delta model
+  if (save_param == 6) {
+    return SaveDelta(dirname);
+  }
+
+  // a new base drops the delta of this server saved on the last one
+  if (save_param == 0 && !_delta_keys.empty()) {
+    std::string manifest = ::paddle::string::format_string(
+        "%smanifest-%03d", DeltaDir(dirname).c_str(), _shard_idx);
+    if (_afs_client.exist(manifest)) {
+      _afs_client.remove(manifest);
+    }
+    if (!_delta_name.empty()) {
+      _afs_client.remove_dir(DeltaDir(_delta_base_path) + _delta_name);
+      _delta_name.clear();
+    }
+    _delta_base_path = dirname;
+  }
+
   // cache model
   int64_t tk_size = LocalSize() * _config.sparse_table_cache_rate();
   TopkCalculator tk(_real_local_shard_num, tk_size);
@@ -424,6 +685,9 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
       }
     } while (is_write_failed);
     feasign_size_all += feasign_size;
+    if (save_param == 0 && !_delta_keys.empty()) {
+      _delta_keys[i].clear();
+    }
 #ifndef PADDLE_WITH_GPU_GRAPH
     for (auto it = shard.begin(); it != shard.end(); ++it) {
       _value_accesor->UpdateStatAfterSave(it.value().data(), save_param);
@@ -450,6 +714,7 @@ int32_t MemorySparseTable::Save_v2(const std::string &dirname,
   if (save_filtered_slots == nullptr || (save_filtered_slots->size()) <= 0) {
     return Save(dirname, param);
   }
+  auto evict_pause = PauseEviction();
 
   if (_real_local_shard_num == 0) {
     _local_show_threshold = -1;
@@ -741,6 +1006,159 @@ int32_t MemorySparseTable::SavePatch(const std::string &path, int save_param) {
   return 0;
 }
 
+int32_t MemorySparseTable::SaveDelta(const std::string &dirname) {
+  if (_delta_keys.empty()) {
+    LOG(ERROR) << "MemorySparseTable save delta needs "
+               << "FLAGS_pserver_sparse_table_save_delta";
+    return -1;
+  }
+  if (dirname != _delta_base_path) {
+    LOG(ERROR) << "MemorySparseTable save delta to " << dirname
+               << ", but the base is " << _delta_base_path;
+    return -1;
+  }
+  // copy the rows of every shard on its task pool, so that the copy is
+  // consistent with the pushes, which go on while the copy is written.
+  // A value of size 0 marks a key erased since the base.
+  std::vector<std::vector<uint64_t>> delta_keys(_real_local_shard_num);
+  std::vector<std::vector<uint32_t>> delta_sizes(_real_local_shard_num);
+  std::vector<std::vector<float>> delta_values(_real_local_shard_num);
+  std::vector<std::future<int>> tasks(_real_local_shard_num);
+  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
+    tasks[shard_id] =
+        _shards_task_pool[shard_id % _shards_task_pool.size()]->enqueue(
+            [this, shard_id, &delta_keys, &delta_sizes, &delta_values]()
+                -> int {
+              auto &local_shard = _local_shards[shard_id];
+              auto &keys = delta_keys[shard_id];
+              auto &sizes = delta_sizes[shard_id];
+              auto &values = delta_values[shard_id];
+              keys.reserve(_delta_keys[shard_id].size());
+              sizes.reserve(_delta_keys[shard_id].size());
+              for (auto key : _delta_keys[shard_id]) {
+                keys.push_back(key);
+                auto itr = local_shard.find(key);
+                if (itr == local_shard.end()) {
+                  sizes.push_back(0);
+                  continue;
+                }
+                auto &value = itr.value();
+                sizes.push_back(value.size());
+                values.insert(
+                    values.end(), value.data(), value.data() + value.size());
+              }
+              return 0;
+            });
+  }
+  for (auto &task : tasks) {
+    task.wait();
+  }
+
+  int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+  std::string delta_name = ::paddle::string::format_string(
+      "delta-%03d-%013ld", _shard_idx, static_cast<long>(now_ms));  // NOLINT
+  std::string delta_dir = DeltaDir(dirname);
+  size_t file_start_idx = _avg_local_shard_num * _shard_idx;
+  std::atomic<uint32_t> feasign_size_all{0};
+  int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
+
+  omp_set_num_threads(thread_num);
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    FsChannelConfig channel_config;
+    channel_config.path =
+        ::paddle::string::format_string("%s%s/part-%05d.gz",
+                                        delta_dir.c_str(),
+                                        delta_name.c_str(),
+                                        file_start_idx + i);
+    channel_config.converter = _value_accesor->Converter(0).converter;
+    channel_config.deconverter = _value_accesor->Converter(0).deconverter;
+    auto &keys = delta_keys[i];
+    auto &sizes = delta_sizes[i];
+    bool is_write_failed = false;
+    int retry_num = 0;
+    int err_no = 0;
+    do {
+      err_no = 0;
+      is_write_failed = false;
+      auto write_channel =
+          _afs_client.open_w(channel_config, 1024 * 1024 * 40, &err_no);
+      const float *value = delta_values[i].data();
+      for (size_t j = 0; j < keys.size(); ++j) {
+        std::string line;
+        if (sizes[j] == 0) {
+          line = ::paddle::string::format_string("%lu", keys[j]);
+        } else {
+          line = ::paddle::string::format_string(
+              "%lu %s",
+              keys[j],
+              _value_accesor->ParseToString(value, sizes[j]).c_str());
+          value += sizes[j];
+        }
+        if (0 != write_channel->write_line(line)) {
+          ++retry_num;
+          is_write_failed = true;
+          LOG(ERROR) << "MemorySparseTable save delta failed, retry it! path:"
+                     << channel_config.path << " , retry_num=" << retry_num;
+          break;
+        }
+      }
+      write_channel->close();
+      if (err_no == -1) {
+        ++retry_num;
+        is_write_failed = true;
+        LOG(ERROR)
+            << "MemorySparseTable save delta failed after write, retry it! "
+            << "path:" << channel_config.path << " , retry_num=" << retry_num;
+      }
+      if (is_write_failed) {
+        _afs_client.remove(channel_config.path);
+      }
+      if (retry_num > FLAGS_pserver_table_save_max_retry) {
+        LOG(ERROR) << "MemorySparseTable save delta failed reach max limit!";
+        exit(-1);
+      }
+    } while (is_write_failed);
+    feasign_size_all += keys.size();
+  }
+
+  // the manifest is written after all the parts, so that it refers to a
+  // complete delta only
+  FsChannelConfig manifest_config;
+  manifest_config.path = ::paddle::string::format_string(
+      "%smanifest-%03d", delta_dir.c_str(), _shard_idx);
+  int err_no = 0;
+  {
+    auto write_channel = _afs_client.open_w(manifest_config, 0, &err_no);
+    if (write_channel->write_line(::paddle::string::format_string(
+            "%s %d %d",
+            delta_name.c_str(),
+            static_cast<int>(file_start_idx),
+            _real_local_shard_num)) != 0) {
+      err_no = -1;
+    }
+    write_channel->close();
+  }
+  if (err_no == -1) {
+    LOG(ERROR) << "MemorySparseTable save delta manifest failed, path:"
+               << manifest_config.path;
+    _afs_client.remove_dir(delta_dir + delta_name);
+    return -1;
+  }
+  // the delta is cumulative, so the last one is no longer needed
+  if (!_delta_name.empty()) {
+    _afs_client.remove_dir(delta_dir + _delta_name);
+  }
+  _delta_name = delta_name;
+  LOG(INFO) << "MemorySparseTable save delta success, path:" << delta_dir
+            << delta_name << " from " << file_start_idx << " to "
+            << file_start_idx + _real_local_shard_num - 1
+            << ", feasign size: " << feasign_size_all;
+  return 0;
+}
+
 int64_t MemorySparseTable::CacheShuffle(
     const std::string &path,
     const std::string &param,
@@ -751,6 +1169,7 @@ int64_t MemorySparseTable::CacheShuffle(
         &shuffled_channel,
     const std::vector<Table *> &table_ptrs) {
   LOG(INFO) << "cache shuffle with cache threshold: " << cache_threshold;
+  auto evict_pause = PauseEviction();
   int save_param = atoi(param.c_str());  // batch_model:0  xbox:1
   if (!_config.enable_sparse_table_cache() || cache_threshold < 0) {
     LOG(WARNING)
@@ -862,6 +1281,7 @@ int32_t MemorySparseTable::SaveCache(
   if (_shard_idx >= _config.sparse_table_cache_file_num()) {
     return 0;
   }
+  auto evict_pause = PauseEviction();
   int save_param = atoi(param.c_str());  // batch_model:0  xbox:1
   std::string table_path = ::paddle::string::format_string(
       "%s/%03d_cache/", path.c_str(), _config.table_id());
@@ -1012,7 +1432,9 @@ int32_t MemorySparseTable::PullSparse(float *pull_values,
                 size_t data_size = value_size - mf_value_size;
                 if (itr == local_shard.end()) {
                   // ++missed_keys;
-                  if (FLAGS_pserver_create_value_when_push) {
+                  // the keys are only admitted by push with admission
+                  if (FLAGS_pserver_create_value_when_push ||
+                      !_admission_sketches.empty()) {
                     memset(data_buffer, 0, sizeof(float) * data_size);
                   } else {
                     auto &feature_value = local_shard[key];
@@ -1021,6 +1443,7 @@ int32_t MemorySparseTable::PullSparse(float *pull_values,
                     _value_accesor->Create(&data_buffer_ptr, 1);
                     memcpy(
                         data_ptr, data_buffer_ptr, data_size * sizeof(float));
+                    MarkDelta(shard_id, key);
                   }
                 } else {
                   data_size = itr.value().size();
@@ -1094,6 +1517,8 @@ int32_t MemorySparseTable::PullSparsePtr(int shard_id,  // fake num
                 } else {
                   ret = itr.value_ptr();
                 }
+                // the values are updated by the caller through the pointers
+                MarkDelta(shard_id, key);
                 int pull_data_idx = item.second;
                 pull_values[pull_data_idx] = reinterpret_cast<char *>(ret);
               }
@@ -1139,12 +1564,22 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
           auto &local_shard_new = _local_shards_new[shard_id];
           float data_buffer[value_col];  // NOLINT
           float *data_buffer_ptr = data_buffer;
+          // the values at the full size are updated in place in one batch,
+          // a key stays at the full size, so its updates keep their order
+          std::vector<float *> batch_values;
+          std::vector<const float *> batch_updates;
+          batch_values.reserve(keys.size());
+          batch_updates.reserve(keys.size());
           for (auto &item : keys) {
             uint64_t key = item.first;
             uint64_t push_data_idx = item.second;
             const float *update_data =
                 values + push_data_idx * update_value_col;
             auto itr = local_shard.find(key);
+            if (itr == local_shard.end() && !Admit(shard_id, key)) {
+              continue;
+            }
+            MarkDelta(shard_id, key);
             if (itr == local_shard.end()) {
               if (FLAGS_pserver_enable_create_feasign_randomly &&
                   !_value_accesor->CreateValue(1, update_data)) {
@@ -1164,7 +1599,11 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
             float *value_data = feature_value.data();
             size_t value_size = feature_value.size();
 
-            if (value_size == value_col) {  // 已拓展到最大size, 则就地update
+            if (value_size == value_col && !_config.enable_revert()) {
+              // 已拓展到最大size, 则攒批就地update
+              batch_values.push_back(value_data);
+              batch_updates.push_back(update_data);
+            } else if (value_size == value_col) {
               _value_accesor->Update(&value_data, &update_data, 1);
             } else {
               // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
@@ -1187,6 +1626,10 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                      new_size * sizeof(float));
             }
           }
+          if (!batch_values.empty()) {
+            _value_accesor->Update(
+                batch_values.data(), batch_updates.data(), batch_values.size());
+          }
           return 0;
         });
   }
@@ -1227,11 +1670,19 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
           auto &local_shard = _local_shards[shard_id];
           float data_buffer[value_col];  // NOLINT
           float *data_buffer_ptr = data_buffer;
+          std::vector<float *> batch_values;
+          std::vector<const float *> batch_updates;
+          batch_values.reserve(keys.size());
+          batch_updates.reserve(keys.size());
           for (auto &item : keys) {
             uint64_t key = item.first;
             uint64_t push_data_idx = item.second;
             const float *update_data = values[push_data_idx];
             auto itr = local_shard.find(key);
+            if (itr == local_shard.end() && !Admit(shard_id, key)) {
+              continue;
+            }
+            MarkDelta(shard_id, key);
             if (itr == local_shard.end()) {
               if (FLAGS_pserver_enable_create_feasign_randomly &&
                   !_value_accesor->CreateValue(1, update_data)) {
@@ -1250,7 +1701,8 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
             float *value_data = feature_value.data();
             size_t value_size = feature_value.size();
             if (value_size == value_col) {  // 已拓展到最大size, 则就地update
-              _value_accesor->Update(&value_data, &update_data, 1);
+              batch_values.push_back(value_data);
+              batch_updates.push_back(update_data);
             } else {
               // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
               memcpy(data_buffer_ptr, value_data, value_size * sizeof(float));
@@ -1263,6 +1715,10 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
               memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
             }
           }
+          if (!batch_values.empty()) {
+            _value_accesor->Update(
+                batch_values.data(), batch_updates.data(), batch_values.size());
+          }
           return 0;
         });
   }
@@ -1277,6 +1733,7 @@ int32_t MemorySparseTable::Flush() { return 0; }
 
 int32_t MemorySparseTable::Shrink(const std::string &param) {
   VLOG(0) << "MemorySparseTable::Shrink";
+  auto evict_pause = PauseEviction();
   std::atomic<uint32_t> shrink_size_all{0};
   int thread_num = _real_local_shard_num;
   omp_set_num_threads(thread_num);
@@ -1287,6 +1744,7 @@ int32_t MemorySparseTable::Shrink(const std::string &param) {
     auto &shard = _local_shards[shard_id];
     for (auto it = shard.begin(); it != shard.end();) {
       if (_value_accesor->Shrink(it.value().data())) {
+        MarkDelta(shard_id, it.key());
         it = shard.erase(it);
         ++feasign_size;
       } else {
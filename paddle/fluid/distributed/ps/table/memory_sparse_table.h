@@ -18,16 +18,20 @@
 #include <assert.h>
 #include <pthread.h>
 
+#include <condition_variable>  // NOLINT
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "Eigen/Dense"
 #include "paddle/fluid/distributed/ps/table/accessor.h"
 #include "paddle/fluid/distributed/ps/table/common_table.h"
+#include "paddle/fluid/distributed/ps/table/depends/count_min_sketch.h"
 #include "paddle/fluid/distributed/ps/table/depends/feature_value.h"
 #include "paddle/fluid/string/string_helper.h"
 
@@ -40,7 +44,7 @@ class MemorySparseTable : public Table {
  public:
   typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
   MemorySparseTable() {}
-  virtual ~MemorySparseTable() {}
+  virtual ~MemorySparseTable();
 
   // unused method end
   static int32_t sparse_local_shard_num(uint32_t shard_num,
@@ -118,6 +122,35 @@ class MemorySparseTable : public Table {
   virtual int32_t SavePatch(const std::string& path, int save_param);
   virtual int32_t LoadPatch(const std::vector<std::string>& file_list,
                             int save_param);
+  // save the rows updated since the last base, see _delta_keys
+  virtual int32_t SaveDelta(const std::string& path);
+  // apply the delta of the i-th local shard saved by SaveDelta
+  int32_t LoadDelta(const std::string& delta_path, int i);
+  void MarkDelta(int shard_id, uint64_t key) {
+    if (!_delta_keys.empty()) {
+      _delta_keys[shard_id].insert(key);
+    }
+  }
+  std::string DeltaDir(const std::string& model_dir) {
+    return ::paddle::string::format_string(
+        "%s/%03d_delta/", model_dir.c_str(), _config.table_id());
+  }
+  // whether a push creates the missing key, see _admission_sketches
+  bool Admit(int shard_id, uint64_t key) {
+    return _admission_sketches.empty() ||
+           _admission_sketches[shard_id].Add(key) >=
+               _config.admission_param().min_count();
+  }
+  // evicts the local shards in turn on their task pools, see _evict_thread
+  void EvictLoop();
+  int32_t EvictShard(int shard_id);
+  // holds off the eviction during the operations on the whole table
+  std::unique_lock<std::mutex> PauseEviction() {
+    if (!_evict_thread.joinable()) {
+      return std::unique_lock<std::mutex>();
+    }
+    return std::unique_lock<std::mutex>(_evict_shard_mutex);
+  }
 
   int _task_pool_size = 24;
   int _avg_local_shard_num;
@@ -136,6 +169,26 @@ class MemorySparseTable : public Table {
   std::unique_ptr<shard_type[]> _local_shards_new;
   std::unique_ptr<shard_type[]> _local_shards_patch_model;
   std::thread _save_patch_model_thread;
+
+  // for delta model, the keys created, updated or erased since the last
+  // base of every local shard, which is only touched by the task pool of
+  // the shard. It is empty unless FLAGS_pserver_sparse_table_save_delta.
+  std::vector<std::unordered_set<uint64_t>> _delta_keys;
+  std::string _delta_base_path;
+  // the delta of this server on _delta_base_path
+  std::string _delta_name;
+
+  // for admission, the push counts of the missing keys of every local
+  // shard, which is only touched by the task pool of the shard. It is
+  // empty unless admission_param is enabled.
+  std::vector<CountMinSketch> _admission_sketches;
+  // for eviction, the thread evicts one local shard every interval_ms of
+  // eviction_param, holding _evict_shard_mutex
+  std::thread _evict_thread;
+  std::mutex _evict_mutex;
+  std::condition_variable _evict_cv;
+  bool _evict_stop{false};
+  std::mutex _evict_shard_mutex;
 };
 
 }  // namespace distributed
@@ -166,6 +166,8 @@ class SparseAccessor : public ValueAccessor {
   int32_t ParseFromString(const std::string& str, float* v) override;
   virtual bool CreateValue(int type, const float* value);
 
+  int PushValueGradIndex() override { return SparsePushValue::EmbedGIndex(); }
+
   // 这个接口目前只用来取show
   float GetField(float* value, const std::string& name) override {
     // CHECK(name == "show");
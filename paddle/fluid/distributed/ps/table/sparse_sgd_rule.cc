@@ -14,8 +14,18 @@
 
 #include "paddle/fluid/distributed/ps/table/sparse_sgd_rule.h"
 
+#ifdef PADDLE_WITH_AVX
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #include "glog/logging.h"
 
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
 #include "paddle/utils/flags.h"
 
 PD_DEFINE_bool(enable_show_scale_gradient, true, "enable show scale gradient");
@@ -23,6 +33,192 @@ PD_DEFINE_bool(enable_show_scale_gradient, true, "enable show scale gradient");
 namespace paddle {
 namespace distributed {
 
+namespace {
+
+#ifdef PADDLE_WITH_AVX
+constexpr size_t kAvxStep = 8;
+
+// BoundValue of 8 lanes, max_ps returns min_bound for nan like BoundValue
+inline __m256 BoundValueAvx(__m256 w, __m256 min_bound, __m256 max_bound) {
+  return _mm256_min_ps(_mm256_max_ps(w, min_bound), max_bound);
+}
+
+inline float ReduceSumAvx(__m256 v) {
+  __m128 sum =
+      _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  sum = _mm_hadd_ps(sum, sum);
+  sum = _mm_hadd_ps(sum, sum);
+  return _mm_cvtss_f32(sum);
+}
+#endif
+
+// Runs the update of Rule on every key of the batch. The call is qualified,
+// so it is not dispatched virtually and is inlined into the loop.
+template <typename Rule>
+void UpdateBatchByRule(Rule *rule,
+                       float **values,
+                       size_t w_offset,
+                       size_t sgd_offset,
+                       const float **push_values,
+                       size_t grad_offset,
+                       const float *scales,
+                       size_t num) {
+  for (size_t i = 0; i < num; ++i) {
+    rule->Rule::UpdateValueWork(values[i] + w_offset,
+                                values[i] + sgd_offset,
+                                push_values[i] + grad_offset,
+                                scales[i]);
+  }
+}
+
+template <typename T>
+void QuantizeHalf(const float *in, size_t dim, float *out) {
+  char *half_out = reinterpret_cast<char *>(out);
+  for (size_t i = 0; i < dim; ++i) {
+    T half(in[i]);
+    memcpy(half_out + i * sizeof(T), &half, sizeof(T));
+  }
+}
+
+template <typename T>
+void DequantizeHalf(const float *in, size_t dim, float *out) {
+  const char *half_in = reinterpret_cast<const char *>(in);
+  for (size_t i = 0; i < dim; ++i) {
+    T half;
+    memcpy(&half, half_in + i * sizeof(T), sizeof(T));
+    out[i] = static_cast<float>(half);
+  }
+}
+
+}  // namespace
+
+void SparseValueQuant::Init(SparseValueQuantParameter::Type type,
+                            size_t dim) {
+  _type = type;
+  _dim = dim;
+  switch (_type) {
+    case SparseValueQuantParameter::FP16:
+    case SparseValueQuantParameter::BF16:
+      _size = (dim + 1) / 2;
+      break;
+    case SparseValueQuantParameter::INT8:
+      _size = dim == 0 ? 0 : 1 + (dim + 3) / 4;
+      break;
+    default:
+      _size = dim;
+      break;
+  }
+}
+
+void SparseValueQuant::Quantize(const float *in,
+                                float *out,
+                                bool stochastic) const {
+  if (_size == 0) {
+    return;
+  }
+  // the padding of the last float is zero
+  out[_size - 1] = 0;
+  switch (_type) {
+    case SparseValueQuantParameter::FP16:
+      QuantizeHalf<phi::dtype::float16>(in, _dim, out);
+      break;
+    case SparseValueQuantParameter::BF16:
+      QuantizeHalf<phi::dtype::bfloat16>(in, _dim, out);
+      break;
+    case SparseValueQuantParameter::INT8: {
+      float max_abs = 0;
+      for (size_t i = 0; i < _dim; ++i) {
+        max_abs = std::max(max_abs, std::fabs(in[i]));
+      }
+      float scale = max_abs / 127;
+      out[0] = scale;
+      int8_t *q = reinterpret_cast<int8_t *>(out + 1);
+      for (size_t i = 0; i < _dim; ++i) {
+        float x = scale > 0 ? in[i] / scale : 0;
+        if (stochastic) {
+          x = std::floor(x + local_uniform_real_distribution<float>()(
+                                 local_random_engine()));
+        } else {
+          x = std::round(x);
+        }
+        q[i] = static_cast<int8_t>(std::min(127.0f, std::max(-127.0f, x)));
+      }
+      break;
+    }
+    default:
+      memcpy(out, in, _dim * sizeof(float));
+      break;
+  }
+}
+
+void SparseValueQuant::Dequantize(const float *in, float *out) const {
+  switch (_type) {
+    case SparseValueQuantParameter::FP16:
+      DequantizeHalf<phi::dtype::float16>(in, _dim, out);
+      break;
+    case SparseValueQuantParameter::BF16:
+      DequantizeHalf<phi::dtype::bfloat16>(in, _dim, out);
+      break;
+    case SparseValueQuantParameter::INT8: {
+      if (_dim == 0) {
+        return;
+      }
+      float scale = in[0];
+      const int8_t *q = reinterpret_cast<const int8_t *>(in + 1);
+      for (size_t i = 0; i < _dim; ++i) {
+        out[i] = q[i] * scale;
+      }
+      break;
+    }
+    default:
+      memcpy(out, in, _dim * sizeof(float));
+      break;
+  }
+}
+
+void SparseValueSGDRule::UpdateQuantValueBatch(
+    float **values,
+    size_t w_offset,
+    const SparseValueQuant &w_quant,
+    size_t sgd_offset,
+    const SparseValueQuant &sgd_quant,
+    const float **push_values,
+    size_t grad_offset,
+    const float *scales,
+    size_t num) {
+  // the fp32 rows of the batch, the weights followed by the sgd states
+  size_t w_dim = w_quant.Dim();
+  size_t row_dim = w_dim + sgd_quant.Dim();
+  thread_local std::vector<float> buffer;
+  thread_local std::vector<float *> rows;
+  buffer.resize(num * row_dim);
+  rows.resize(num);
+  for (size_t i = 0; i < num; ++i) {
+    rows[i] = buffer.data() + i * row_dim;
+    w_quant.Dequantize(values[i] + w_offset, rows[i]);
+    sgd_quant.Dequantize(values[i] + sgd_offset, rows[i] + w_dim);
+  }
+  UpdateValueBatch(
+      rows.data(), 0, w_dim, push_values, grad_offset, scales, num);
+  for (size_t i = 0; i < num; ++i) {
+    w_quant.Quantize(rows[i], values[i] + w_offset, true);
+    sgd_quant.Quantize(rows[i] + w_dim, values[i] + sgd_offset, true);
+  }
+}
+
+void SparseValueSGDRule::InitQuantValue(float *value,
+                                        const SparseValueQuant &w_quant,
+                                        float *sgd,
+                                        const SparseValueQuant &sgd_quant,
+                                        bool zero_init) {
+  size_t w_dim = w_quant.Dim();
+  thread_local std::vector<float> buffer;
+  buffer.resize(w_dim + sgd_quant.Dim());
+  InitValue(buffer.data(), buffer.data() + w_dim, zero_init);
+  w_quant.Quantize(buffer.data(), value);
+  sgd_quant.Quantize(buffer.data() + w_dim, sgd);
+}
+
 void SparseNaiveSGDRule::LoadConfig(const SparseCommonSGDRuleParameter &param,
                                     size_t emb_dim) {
   _embedding_dim = emb_dim;
@@ -94,8 +290,29 @@ void SparseAdaGradSGDRule::UpdateValueWork(float *w,
                                            float scale) {
   float &g2sum = sgd[G2SumIndex()];
   double add_g2sum = 0;
+  size_t i = 0;
+
+#ifdef PADDLE_WITH_AVX
+  const float ratio = learning_rate_ *
+                      sqrt(_initial_g2sum / (_initial_g2sum + g2sum)) / scale;
+  const __m256 mm_ratio = _mm256_set1_ps(ratio);
+  const __m256 mm_inv_scale = _mm256_set1_ps(1.0f / scale);
+  const __m256 mm_min_bound = _mm256_set1_ps(_min_bound);
+  const __m256 mm_max_bound = _mm256_set1_ps(_max_bound);
+  __m256 mm_add_g2sum = _mm256_setzero_ps();
+  for (; i + kAvxStep <= _embedding_dim; i += kAvxStep) {
+    const __m256 mm_grad = _mm256_loadu_ps(grad + i);
+    const __m256 mm_w =
+        _mm256_sub_ps(_mm256_loadu_ps(w + i), _mm256_mul_ps(mm_ratio, mm_grad));
+    _mm256_storeu_ps(w + i, BoundValueAvx(mm_w, mm_min_bound, mm_max_bound));
+    const __m256 mm_scaled_grad = _mm256_mul_ps(mm_grad, mm_inv_scale);
+    mm_add_g2sum = _mm256_add_ps(
+        mm_add_g2sum, _mm256_mul_ps(mm_scaled_grad, mm_scaled_grad));
+  }
+  add_g2sum = ReduceSumAvx(mm_add_g2sum);
+#endif
 
-  for (size_t i = 0; i < _embedding_dim; i++) {
+  for (; i < _embedding_dim; i++) {
     double scaled_grad = grad[i] / scale;
     w[i] -= learning_rate_ * scaled_grad *
             sqrt(_initial_g2sum / (_initial_g2sum + g2sum));
@@ -106,6 +323,23 @@ void SparseAdaGradSGDRule::UpdateValueWork(float *w,
   g2sum += add_g2sum / _embedding_dim;
 }
 
+void SparseAdaGradSGDRule::UpdateValueBatch(float **values,
+                                            size_t w_offset,
+                                            size_t sgd_offset,
+                                            const float **push_values,
+                                            size_t grad_offset,
+                                            const float *scales,
+                                            size_t num) {
+  UpdateBatchByRule(this,
+                    values,
+                    w_offset,
+                    sgd_offset,
+                    push_values,
+                    grad_offset,
+                    scales,
+                    num);
+}
+
 void SparseAdaGradSGDRule::InitValueWork(float *value,
                                          float *sgd,
                                          bool zero_init) {
@@ -149,7 +383,33 @@ void StdAdaGradSGDRule::UpdateValueWork(float *w,
                                         float *sgd,
                                         const float *grad,
                                         float scale) {
-  for (size_t i = 0; i < _embedding_dim; i++) {
+  size_t i = 0;
+
+#ifdef PADDLE_WITH_AVX
+  float *g2sum = sgd + G2SumIndex();
+  const __m256 mm_lr = _mm256_set1_ps(learning_rate_);
+  const __m256 mm_initial_g2sum = _mm256_set1_ps(_initial_g2sum);
+  const __m256 mm_inv_scale = _mm256_set1_ps(1.0f / scale);
+  const __m256 mm_min_bound = _mm256_set1_ps(_min_bound);
+  const __m256 mm_max_bound = _mm256_set1_ps(_max_bound);
+  for (; i + kAvxStep <= _embedding_dim; i += kAvxStep) {
+    const __m256 mm_scaled_grad =
+        _mm256_mul_ps(_mm256_loadu_ps(grad + i), mm_inv_scale);
+    const __m256 mm_g2sum = _mm256_loadu_ps(g2sum + i);
+    const __m256 mm_ratio = _mm256_sqrt_ps(_mm256_div_ps(
+        mm_initial_g2sum, _mm256_add_ps(mm_initial_g2sum, mm_g2sum)));
+    const __m256 mm_w = _mm256_sub_ps(
+        _mm256_loadu_ps(w + i),
+        _mm256_mul_ps(_mm256_mul_ps(mm_lr, mm_scaled_grad), mm_ratio));
+    _mm256_storeu_ps(w + i, BoundValueAvx(mm_w, mm_min_bound, mm_max_bound));
+    _mm256_storeu_ps(
+        g2sum + i,
+        _mm256_add_ps(mm_g2sum,
+                      _mm256_mul_ps(mm_scaled_grad, mm_scaled_grad)));
+  }
+#endif
+
+  for (; i < _embedding_dim; i++) {
     float &g2sum = sgd[G2SumIndex() + i];
     double scaled_grad = grad[i] / scale;
     w[i] -= learning_rate_ * scaled_grad *
@@ -159,6 +419,23 @@ void StdAdaGradSGDRule::UpdateValueWork(float *w,
   }
 }
 
+void StdAdaGradSGDRule::UpdateValueBatch(float **values,
+                                         size_t w_offset,
+                                         size_t sgd_offset,
+                                         const float **push_values,
+                                         size_t grad_offset,
+                                         const float *scales,
+                                         size_t num) {
+  UpdateBatchByRule(this,
+                    values,
+                    w_offset,
+                    sgd_offset,
+                    push_values,
+                    grad_offset,
+                    scales,
+                    num);
+}
+
 void StdAdaGradSGDRule::InitValueWork(float *value,
                                       float *sgd,
                                       bool zero_init) {
@@ -214,7 +491,38 @@ void SparseAdamSGDRule::UpdateValueWork(float *w,
   float beta2_pow_ = *beta2_pow;
 
   lr *= sqrt(1 - beta2_pow_) / (1 - beta1_pow_);
-  for (size_t i = 0; i < _embedding_dim; i++) {
+  size_t i = 0;
+
+#ifdef PADDLE_WITH_AVX
+  const __m256 mm_lr = _mm256_set1_ps(lr);
+  const __m256 mm_beta1 = _mm256_set1_ps(_beta1_decay_rate);
+  const __m256 mm_beta2 = _mm256_set1_ps(_beta2_decay_rate);
+  const __m256 mm_one_minus_beta1 = _mm256_set1_ps(1 - _beta1_decay_rate);
+  const __m256 mm_one_minus_beta2 = _mm256_set1_ps(1 - _beta2_decay_rate);
+  const __m256 mm_epsilon = _mm256_set1_ps(_ada_epsilon);
+  const __m256 mm_min_bound = _mm256_set1_ps(_min_bound);
+  const __m256 mm_max_bound = _mm256_set1_ps(_max_bound);
+  for (; i + kAvxStep <= _embedding_dim; i += kAvxStep) {
+    const __m256 mm_g = _mm256_loadu_ps(g + i);
+    const __m256 mm_gsum =
+        _mm256_add_ps(_mm256_mul_ps(mm_beta1, _mm256_loadu_ps(gsum + i)),
+                      _mm256_mul_ps(mm_one_minus_beta1, mm_g));
+    const __m256 mm_g2sum = _mm256_add_ps(
+        _mm256_mul_ps(mm_beta2, _mm256_loadu_ps(g2sum + i)),
+        _mm256_mul_ps(_mm256_mul_ps(mm_one_minus_beta2, mm_g), mm_g));
+    _mm256_storeu_ps(gsum + i, mm_gsum);
+    _mm256_storeu_ps(g2sum + i, mm_g2sum);
+    const __m256 mm_w = _mm256_sub_ps(
+        _mm256_loadu_ps(w + i),
+        _mm256_mul_ps(
+            mm_lr,
+            _mm256_div_ps(
+                mm_gsum, _mm256_add_ps(_mm256_sqrt_ps(mm_g2sum), mm_epsilon))));
+    _mm256_storeu_ps(w + i, BoundValueAvx(mm_w, mm_min_bound, mm_max_bound));
+  }
+#endif
+
+  for (; i < _embedding_dim; i++) {
     // Calculation
     gsum[i] = _beta1_decay_rate * gsum[i] + (1 - _beta1_decay_rate) * g[i];
     g2sum[i] =
@@ -227,6 +535,23 @@ void SparseAdamSGDRule::UpdateValueWork(float *w,
   (*beta2_pow) *= _beta2_decay_rate;
 }
 
+void SparseAdamSGDRule::UpdateValueBatch(float **values,
+                                         size_t w_offset,
+                                         size_t sgd_offset,
+                                         const float **push_values,
+                                         size_t grad_offset,
+                                         const float *scales,
+                                         size_t num) {
+  UpdateBatchByRule(this,
+                    values,
+                    w_offset,
+                    sgd_offset,
+                    push_values,
+                    grad_offset,
+                    scales,
+                    num);
+}
+
 void SparseAdamSGDRule::InitValueWork(float *value,
                                       float *sgd,
                                       bool zero_init) {
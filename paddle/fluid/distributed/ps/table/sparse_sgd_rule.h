@@ -26,6 +26,30 @@
 namespace paddle {
 namespace distributed {
 
+// SparseValueQuant stores dim floats of a value in Size() floats at the
+// precision of type:
+//   FP32:      the floats
+//   FP16/BF16: two 16 bits floats in a float
+//   INT8:      a fp32 scale max(|x|) / 127 followed by four int8 in a float
+class SparseValueQuant {
+ public:
+  void Init(SparseValueQuantParameter::Type type, size_t dim);
+  SparseValueQuantParameter::Type Type() const { return _type; }
+  bool IsFP32() const { return _type == SparseValueQuantParameter::FP32; }
+  size_t Dim() const { return _dim; }
+  size_t Size() const { return _size; }
+  // out has Size() floats, INT8 rounds stochastically with stochastic, so
+  // that the small updates of the weights are kept in expectation
+  void Quantize(const float* in, float* out, bool stochastic = false) const;
+  // out has Dim() floats
+  void Dequantize(const float* in, float* out) const;
+
+ private:
+  SparseValueQuantParameter::Type _type = SparseValueQuantParameter::FP32;
+  size_t _dim = 0;
+  size_t _size = 0;
+};
+
 class SparseValueSGDRule {
  public:
   SparseValueSGDRule() {}
@@ -51,6 +75,40 @@ class SparseValueSGDRule {
                    float scale = 1) {
     UpdateValueWork(w, sgd, push_value, scale);
   }
+  // Updates the values of num keys in one call: the weights and the sgd
+  // states of key i are at values[i] + w_offset and values[i] + sgd_offset,
+  // and its gradients at push_values[i] + grad_offset. The rules override it
+  // to run their update without a virtual call per key.
+  virtual void UpdateValueBatch(float** values,
+                                size_t w_offset,
+                                size_t sgd_offset,
+                                const float** push_values,
+                                size_t grad_offset,
+                                const float* scales,
+                                size_t num) {
+    for (size_t i = 0; i < num; ++i) {
+      UpdateValueWork(values[i] + w_offset,
+                      values[i] + sgd_offset,
+                      push_values[i] + grad_offset,
+                      scales[i]);
+    }
+  }
+  // UpdateValueBatch of the weights and the sgd states stored by w_quant and
+  // sgd_quant, which are dequantized to fp32, updated and quantized again.
+  void UpdateQuantValueBatch(float** values,
+                             size_t w_offset,
+                             const SparseValueQuant& w_quant,
+                             size_t sgd_offset,
+                             const SparseValueQuant& sgd_quant,
+                             const float** push_values,
+                             size_t grad_offset,
+                             const float* scales,
+                             size_t num);
+  void InitQuantValue(float* value,
+                      const SparseValueQuant& w_quant,
+                      float* sgd,
+                      const SparseValueQuant& sgd_quant,
+                      bool zero_init = true);
   template <class T>
   void BoundValue(T& w) {  // NOLINT
     if (!(w >= _min_bound)) {
@@ -97,6 +155,13 @@ class SparseAdaGradSGDRule : public SparseValueSGDRule {
                                float* sgd,
                                const float* push_value,
                                float scale);
+  virtual void UpdateValueBatch(float** values,
+                                size_t w_offset,
+                                size_t sgd_offset,
+                                const float** push_values,
+                                size_t grad_offset,
+                                const float* scales,
+                                size_t num);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return 1; }
   size_t G2SumIndex() { return 0; }
@@ -134,6 +199,13 @@ class StdAdaGradSGDRule : public SparseValueSGDRule {
                                float* sgd,
                                const float* push_value,
                                float scale);
+  virtual void UpdateValueBatch(float** values,
+                                size_t w_offset,
+                                size_t sgd_offset,
+                                const float** push_values,
+                                size_t grad_offset,
+                                const float* scales,
+                                size_t num);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return _embedding_dim; }
   size_t G2SumIndex() { return 0; }
@@ -151,6 +223,13 @@ class SparseAdamSGDRule : public SparseValueSGDRule {
                                float* sgd,
                                const float* push_value,
                                float scale);
+  virtual void UpdateValueBatch(float** values,
+                                size_t w_offset,
+                                size_t sgd_offset,
+                                const float** push_values,
+                                size_t grad_offset,
+                                const float* scales,
+                                size_t num);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return _embedding_dim * 2 + 2; }
   size_t GSumIndex() { return 0; }
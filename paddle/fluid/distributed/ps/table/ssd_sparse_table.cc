@@ -18,6 +18,7 @@
 #include "paddle/fluid/distributed/common/local_random.h"
 #include "paddle/fluid/distributed/common/topk_calculator.h"
 #include "paddle/fluid/framework/archive.h"
+#include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/flags.h"
 #include "paddle/utils/string/string_helper.h"
 PD_DECLARE_bool(pserver_print_missed_key_num_every_push);
@@ -28,13 +29,36 @@ PD_DEFINE_int32(pserver_load_batch_size, 5000, "load batch size for ssd");
 PADDLE_DEFINE_EXPORTED_string(rocksdb_path,
                               "database",
                               "path of sparse table rocksdb file");
+PADDLE_DEFINE_EXPORTED_string(
+    ssd_sparse_table_store,
+    "rocksdb",
+    "storage of the values on ssd of SSDSparseTable, rocksdb or mmap. mmap "
+    "keeps the values in memory-mapped append-only segment files under "
+    "FLAGS_rocksdb_path with an in-memory key index");
+PADDLE_DEFINE_EXPORTED_int64(ssd_mmap_segment_size_mb,
+                             256,
+                             "size of one segment file of the mmap store");
 
 namespace paddle {
 namespace distributed {
 
 int32_t SSDSparseTable::Initialize() {
+  // the keys of SSDSparseTable are also kept in the db
+  PADDLE_ENFORCE_EQ(
+      _config.admission_param().enable() || _config.eviction_param().enable(),
+      false,
+      paddle::platform::errors::Unimplemented(
+          "The admission and eviction are not supported by SSDSparseTable"));
   MemorySparseTable::Initialize();
-  _db = ::paddle::distributed::RocksDBHandler::GetInstance();
+  if (FLAGS_ssd_sparse_table_store == "mmap") {
+    auto* handler = ::paddle::distributed::MmapSegmentHandler::GetInstance();
+    handler->set_segment_size(FLAGS_ssd_mmap_segment_size_mb << 20);
+    _db = handler;
+  } else {
+    CHECK(FLAGS_ssd_sparse_table_store == "rocksdb")
+        << "unknown ssd_sparse_table_store: " << FLAGS_ssd_sparse_table_store;
+    _db = ::paddle::distributed::RocksDBHandler::GetInstance();
+  }
   _db->initialize(FLAGS_rocksdb_path, _real_local_shard_num);
   VLOG(0) << "initalize SSDSparseTable succ";
   VLOG(0) << "SSD FLAGS_pserver_print_missed_key_num_every_push:"
@@ -318,6 +342,57 @@ int32_t SSDSparseTable::PullSparsePtr(int shard_id,
   return 0;
 }
 
+int32_t SSDSparseTable::Prefetch(int shard_id,
+                                 const uint64_t* keys,
+                                 size_t num) {
+  CostTimer timer("pserver_ssd_sparse_prefetch");
+  auto& local_shard = _local_shards[shard_id];
+  const size_t kBatchSize = 1024;
+  std::vector<rocksdb::Slice> batch_keys;
+  std::vector<rocksdb::PinnableSlice> batch_values(kBatchSize);
+  std::vector<rocksdb::Status> status(kBatchSize);
+  batch_keys.reserve(kBatchSize);
+  size_t prefetch_count = 0;
+  for (size_t i = 0; i < num; ++i) {
+    if (local_shard.find(keys[i]) == local_shard.end()) {
+      batch_keys.emplace_back(reinterpret_cast<const char*>(&keys[i]),
+                              sizeof(uint64_t));
+    }
+    if ((batch_keys.size() < kBatchSize && i + 1 < num) ||
+        batch_keys.empty()) {
+      continue;
+    }
+    _db->multi_get(shard_id,
+                   batch_keys.size(),
+                   batch_keys.data(),
+                   batch_values.data(),
+                   status.data());
+    for (size_t idx = 0; idx < batch_keys.size(); ++idx) {
+      uint64_t key =
+          *(reinterpret_cast<const uint64_t*>(batch_keys[idx].data()));
+      // the key may appear twice in the batch
+      if (!status[idx].ok() || local_shard.find(key) != local_shard.end()) {
+        batch_values[idx].Reset();
+        continue;
+      }
+      int data_size = batch_values[idx].size() / sizeof(float);
+      // from ssd to mem
+      auto& feature_value = local_shard[key];
+      feature_value.resize(data_size);
+      memcpy(const_cast<float*>(feature_value.data()),
+             batch_values[idx].data(),
+             data_size * sizeof(float));
+      _db->del_data(shard_id, reinterpret_cast<char*>(&key), sizeof(uint64_t));
+      batch_values[idx].Reset();
+      ++prefetch_count;
+    }
+    batch_keys.clear();
+  }
+  VLOG(1) << "SSDSparseTable prefetch shard " << shard_id << " keys " << num
+          << " from ssd " << prefetch_count;
+  return 0;
+}
+
 int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
                                    const float* values,
                                    size_t num) {
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "paddle/fluid/distributed/ps/table/depends/mmap_segment_handler.h"
 #include "paddle/fluid/distributed/ps/table/depends/rocksdb_warpper.h"
 #include "paddle/fluid/distributed/ps/table/memory_sparse_table.h"
 #include "paddle/utils/flags.h"
@@ -128,8 +129,12 @@ class SSDSparseTable : public MemorySparseTable {
 
   int32_t CacheTable(uint16_t pass_id) override;
 
+  // The caller should make sure that shard_id is not pulled or pushed
+  // concurrently, the keys not on ssd are ignored.
+  int32_t Prefetch(int shard_id, const uint64_t* keys, size_t num) override;
+
  private:
-  RocksDBHandler* _db;
+  SSDHandler* _db;
   int64_t _cache_tk_size;
   double _local_show_threshold{0.0};
   std::vector<paddle::framework::Channel<std::string>> _fs_channel;
@@ -14,6 +14,12 @@
 
 #include "paddle/fluid/distributed/rpc/python_rpc_handler.h"
 
+#include <future>
+
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_int32(rpc_server_thread_num);
+
 namespace paddle {
 namespace distributed {
 constexpr auto kInternalModule = "paddle.distributed.rpc.internal";
@@ -30,6 +36,9 @@ PythonRpcHandler::PythonRpcHandler() {
   py_run_function_ = getFunction(rpc_internal, "_run_py_func");
   py_serialize_ = getFunction(rpc_internal, "_serialize");
   py_deserialize_ = getFunction(rpc_internal, "_deserialize");
+  if (FLAGS_rpc_server_thread_num > 1) {
+    worker_pool_ = std::make_unique<::ThreadPool>(FLAGS_rpc_server_thread_num);
+  }
 }
 
 py::object PythonRpcHandler::RunPythonFunc(const py::object& python_func) {
@@ -48,6 +57,38 @@ py::object PythonRpcHandler::Deserialize(const std::string& obj) {
   return py_deserialize_(py::bytes(obj));
 }
 
+std::string PythonRpcHandler::RunSerializedPythonFunc(
+    const std::string& py_func) {
+  // acquire gil, because native Python objects are used
+  py::gil_scoped_acquire ag;
+  py::object py_func_obj = Deserialize(py_func);
+  py::object res = RunPythonFunc(py_func_obj);
+  return Serialize(res);
+}
+
+std::vector<std::string> PythonRpcHandler::RunSerializedPythonFuncs(
+    const std::vector<std::string>& py_funcs) {
+  std::vector<std::string> results(py_funcs.size());
+  if (worker_pool_ == nullptr || py_funcs.size() == 1) {
+    for (size_t i = 0; i < py_funcs.size(); ++i) {
+      results[i] = RunSerializedPythonFunc(py_funcs[i]);
+    }
+    return results;
+  }
+
+  std::vector<std::future<void>> futures;
+  futures.reserve(py_funcs.size());
+  for (size_t i = 0; i < py_funcs.size(); ++i) {
+    futures.emplace_back(worker_pool_->enqueue([this, &py_funcs, &results, i] {
+      results[i] = RunSerializedPythonFunc(py_funcs[i]);
+    }));
+  }
+  for (auto& fut : futures) {
+    fut.get();
+  }
+  return results;
+}
+
 std::shared_ptr<PythonRpcHandler> PythonRpcHandler::python_rpc_handler_ =
     nullptr;
 std::mutex PythonRpcHandler::lock_;
@@ -14,11 +14,13 @@
 
 #pragma once
 
+#include <ThreadPool.h>
 #include <pybind11/pybind11.h>
 
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "paddle/fluid/platform/macros.h"
 
@@ -41,6 +43,15 @@ class PYBIND11_EXPORT PythonRpcHandler {
   // Deserialize a string into a py::object
   py::object Deserialize(const std::string& obj);
 
+  // Run a serialized Python function and return the serialized result
+  std::string RunSerializedPythonFunc(const std::string& py_func);
+
+  // Run the serialized Python functions of a batch, by the worker pool if
+  // FLAGS_rpc_server_thread_num > 1, and return the serialized results in
+  // order. The GIL must not be held by the caller.
+  std::vector<std::string> RunSerializedPythonFuncs(
+      const std::vector<std::string>& py_funcs);
+
  private:
   DISABLE_COPY_AND_ASSIGN(PythonRpcHandler);
 
@@ -54,6 +65,9 @@ class PYBIND11_EXPORT PythonRpcHandler {
   // Ref to `paddle.distributed.rpc.internal.deserialize`.
   py::object py_deserialize_;
 
+  // Run the functions of a batch concurrently.
+  std::unique_ptr<::ThreadPool> worker_pool_;
+
   // Lock to protect initialization.
   static std::mutex lock_;
 };
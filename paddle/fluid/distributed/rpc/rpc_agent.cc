@@ -14,12 +14,20 @@
 
 #include "paddle/fluid/distributed/rpc/rpc_agent.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_int32(rpc_batch_max_size);
+PHI_DECLARE_int32(rpc_batch_delay_us);
 
 namespace paddle {
 namespace distributed {
@@ -80,12 +88,17 @@ int RpcAgent::StartClient() {
             info.ip_,
             info.port_));
   }
+  pending_rpcs_.resize(channels_.size());
+  if (FLAGS_rpc_batch_max_size > 1 && !flush_thread_.joinable()) {
+    flush_thread_ = std::thread([this] { FlushPendingRpcs(); });
+  }
   VLOG(0) << "Init Channels: " << name_;
   return 0;
 }
 
 int RpcAgent::Stop() {
   VLOG(0) << "Worker: " << name_ << " is going to stop.";
+  StopFlush();
   server_.Stop(kCloseWaitMs);
   server_.Join();
   rpc_agent_instance_ = nullptr;
@@ -104,6 +117,93 @@ void OnRpcDone::Run() {
           << " latency=" << cntl_.latency_us() << "us";
 }
 
+void OnRpcBatchDone::Run() {
+  // delete this after Run
+  std::unique_ptr<OnRpcBatchDone> self_guard(this);
+  if (cntl_.Failed() ||
+      static_cast<size_t>(response_.messages_size()) != promises_.size()) {
+    auto error = std::make_exception_ptr(std::runtime_error(
+        cntl_.Failed() ? cntl_.ErrorText()
+                       : "The number of the rpc responses doesn't match the "
+                         "number of the requests."));
+    for (auto &promise : promises_) {
+      promise->set_exception(error);
+    }
+    return;
+  }
+  for (size_t i = 0; i < promises_.size(); ++i) {
+    promises_[i]->set_value(response_.messages(i));
+  }
+  VLOG(2) << "Received " << promises_.size() << " responses from "
+          << cntl_.remote_side() << " to " << cntl_.local_side()
+          << " latency=" << cntl_.latency_us() << "us";
+}
+
+void RpcAgent::SendBatch(uint32_t id, std::vector<PendingRpc> rpcs) {
+  auto channel = channels_[id];
+  RpcBaseService_Stub stub(channel.get());
+  if (rpcs.size() == 1) {
+    OnRpcDone *done = new OnRpcDone;
+    done->cntl_.set_timeout_ms(rpcs[0].timeout_ms_);
+    done->request_.set_message(std::move(rpcs[0].message_));
+    done->promise_ = rpcs[0].promise_;
+    stub.InvokeRpc(&done->cntl_, &done->request_, &done->response_, done);
+    return;
+  }
+  OnRpcBatchDone *done = new OnRpcBatchDone;
+  int timeout_ms = 0;
+  for (auto &rpc : rpcs) {
+    timeout_ms = std::max(timeout_ms, rpc.timeout_ms_);
+    done->request_.add_messages(std::move(rpc.message_));
+    done->promises_.push_back(rpc.promise_);
+  }
+  done->cntl_.set_timeout_ms(timeout_ms);
+  stub.InvokeRpcBatch(&done->cntl_, &done->request_, &done->response_, done);
+}
+
+void RpcAgent::FlushPendingRpcs() {
+  std::unique_lock<std::mutex> lock(pending_mutex_);
+  while (true) {
+    pending_cv_.wait(lock,
+                     [this] { return stop_flush_ || pending_rpc_num_ > 0; });
+    if (!stop_flush_) {
+      // wait for the following requests to join the batches
+      pending_cv_.wait_for(lock,
+                           std::chrono::microseconds(FLAGS_rpc_batch_delay_us),
+                           [this] { return stop_flush_; });
+    }
+    std::vector<std::pair<uint32_t, std::vector<PendingRpc>>> batches;
+    for (size_t i = 0; i < pending_rpcs_.size(); ++i) {
+      if (!pending_rpcs_[i].empty()) {
+        batches.emplace_back(i, std::move(pending_rpcs_[i]));
+        pending_rpcs_[i].clear();
+      }
+    }
+    pending_rpc_num_ = 0;
+    bool stop = stop_flush_;
+    lock.unlock();
+    for (auto &batch : batches) {
+      SendBatch(batch.first, std::move(batch.second));
+    }
+    if (stop) {
+      return;
+    }
+    lock.lock();
+  }
+}
+
+void RpcAgent::StopFlush() {
+  if (!flush_thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(pending_mutex_);
+    stop_flush_ = true;
+  }
+  pending_cv_.notify_one();
+  flush_thread_.join();
+}
+
 std::future<std::string> RpcAgent::InvokeRpc(const std::string &py_func,
                                              const std::string &to,
                                              int timeout_ms = kTimeoutMs) {
@@ -113,6 +213,28 @@ std::future<std::string> RpcAgent::InvokeRpc(const std::string &py_func,
       name_to_infos_.end(),
       platform::errors::OutOfRange("Worker %s doesn't exist!", to));
   uint32_t id = it->second.id_;
+  if (flush_thread_.joinable()) {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> fut(promise->get_future());
+    std::vector<PendingRpc> rpcs;
+    {
+      std::lock_guard<std::mutex> guard(pending_mutex_);
+      auto &pending = pending_rpcs_[id];
+      pending.push_back({py_func, timeout_ms, promise});
+      ++pending_rpc_num_;
+      // a full batch is sent at once instead of waiting for the flush
+      if (pending.size() >= static_cast<size_t>(FLAGS_rpc_batch_max_size)) {
+        pending_rpc_num_ -= pending.size();
+        rpcs.swap(pending);
+      }
+    }
+    if (rpcs.empty()) {
+      pending_cv_.notify_one();
+    } else {
+      SendBatch(id, std::move(rpcs));
+    }
+    return fut;
+  }
   auto channel = channels_[id];
   // `done` must be allocated on the heap because its life cycle is after
   // calling done.Run().
@@ -14,9 +14,12 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
 #include <future>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <vector>
 
@@ -59,13 +62,32 @@ class OnRpcDone : public google::protobuf::Closure {
   std::shared_ptr<std::promise<std::string>> promise_;
 };
 
+// A request waiting to be sent with the following requests to the same
+// worker.
+struct PendingRpc {
+  std::string message_;
+  int timeout_ms_;
+  std::shared_ptr<std::promise<std::string>> promise_;
+};
+
+class OnRpcBatchDone : public google::protobuf::Closure {
+ public:
+  OnRpcBatchDone() {}
+  // process callback of the responses of a batch
+  void Run();
+  RpcBatchResponse response_;
+  RpcBatchRequest request_;
+  brpc::Controller cntl_;
+  std::vector<std::shared_ptr<std::promise<std::string>>> promises_;
+};
+
 class RpcAgent {
  public:
   static std::shared_ptr<RpcAgent> RpcAgentInstance();
   static void SetAgentInstance(std::shared_ptr<RpcAgent> agent);
   // init RpcAgent instance and get information of all services
   RpcAgent(std::string name, std::vector<WorkerInfo> infos);
-  ~RpcAgent() {}
+  ~RpcAgent() { StopFlush(); }
 
   const WorkerInfo &GetWorkerInfo(const std::string &name) const {
     auto it = name_to_infos_.find(name);
@@ -97,6 +119,13 @@ class RpcAgent {
 
  private:
   DISABLE_COPY_AND_ASSIGN(RpcAgent);
+  // Send the requests to the worker of id in one brpc call.
+  void SendBatch(uint32_t id, std::vector<PendingRpc> rpcs);
+  // Send the pending requests FLAGS_rpc_batch_delay_us after the first one
+  // of them arrives, until Stop.
+  void FlushPendingRpcs();
+  void StopFlush();
+
   static std::shared_ptr<RpcAgent> rpc_agent_instance_;
   brpc::Server server_;
   std::shared_ptr<RpcService> rpc_service_;
@@ -106,6 +135,14 @@ class RpcAgent {
   std::unordered_map<std::string, WorkerInfo> name_to_infos_;
   std::unordered_map<uint32_t, WorkerInfo> id_to_infos_;
   std::vector<WorkerInfo> infos_;
+
+  // The pending requests to each worker, used if FLAGS_rpc_batch_max_size > 1.
+  std::vector<std::vector<PendingRpc>> pending_rpcs_;
+  size_t pending_rpc_num_{0};
+  std::mutex pending_mutex_;
+  std::condition_variable pending_cv_;
+  std::thread flush_thread_;
+  bool stop_flush_{false};
 };
 }  // namespace distributed
 }  // namespace paddle
@@ -17,6 +17,7 @@
 #include <brpc/server.h>
 
 #include <string>
+#include <vector>
 
 #include "paddle/fluid/distributed/rpc/python_rpc_handler.h"
 #include "paddle/fluid/distributed/rpc/rpc.pb.h"
@@ -41,15 +42,29 @@ class RpcService : public RpcBaseService {
             << "] from " << cntl->remote_side() << " to " << cntl->local_side()
             << ": "
             << " (attached=" << cntl->request_attachment() << ")";
-    std::string py_func_str = request->message();
     std::shared_ptr<PythonRpcHandler> python_handler =
         PythonRpcHandler::GetInstance();
-    // acquire gil, because native Python objects are used
-    py::gil_scoped_acquire ag;
-    py::object py_func_obj = python_handler->Deserialize(py_func_str);
-    py::object res = python_handler->RunPythonFunc(py_func_obj);
-    std::string res_str = python_handler->Serialize(res);
-    response->set_message(res_str);
+    response->set_message(
+        python_handler->RunSerializedPythonFunc(request->message()));
+  }
+
+  virtual void InvokeRpcBatch(google::protobuf::RpcController *cntl_base,
+                              const RpcBatchRequest *request,
+                              RpcBatchResponse *response,
+                              google::protobuf::Closure *done) {
+    brpc::ClosureGuard done_guard(done);
+
+    brpc::Controller *cntl = static_cast<brpc::Controller *>(cntl_base);
+    VLOG(2) << "InvokeRpcBatch API: Received " << request->messages_size()
+            << " requests[log_id=" << cntl->log_id() << "] from "
+            << cntl->remote_side() << " to " << cntl->local_side();
+    std::vector<std::string> py_funcs(request->messages().begin(),
+                                      request->messages().end());
+    std::shared_ptr<PythonRpcHandler> python_handler =
+        PythonRpcHandler::GetInstance();
+    for (auto &res : python_handler->RunSerializedPythonFuncs(py_funcs)) {
+      response->add_messages(std::move(res));
+    }
   }
 };
 }  // namespace distributed
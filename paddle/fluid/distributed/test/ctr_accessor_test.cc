@@ -303,5 +303,83 @@ TEST(downpour_feature_value_accessor_test, test_string_related) {
     ASSERT_FLOAT_EQ(value[i], 0);
   }
 }
+
+TEST(downpour_feature_value_accessor_test, test_quant_value) {
+  TableAccessorParameter fp32_parameter = gen_param();
+  fp32_parameter.set_embedx_threshold(0);
+  fp32_parameter.mutable_embedx_sgd_param()->set_name("SparseAdaGradSGDRule");
+  auto* adagrad_param =
+      fp32_parameter.mutable_embedx_sgd_param()->mutable_adagrad();
+  adagrad_param->set_learning_rate(0.1);
+  adagrad_param->set_initial_range(0.3);
+  adagrad_param->set_initial_g2sum(3.0);
+  adagrad_param->add_weight_bounds(-10.0);
+  adagrad_param->add_weight_bounds(10.0);
+  CtrCommonAccessor fp32_acc;
+  ASSERT_EQ(fp32_acc.Configure(fp32_parameter), 0);
+  ASSERT_EQ(fp32_acc.Initialize(), 0);
+  const size_t fp32_dim = fp32_acc.GetAccessorInfo().dim;
+  const size_t select_dim = fp32_acc.GetAccessorInfo().select_dim;
+  const size_t update_dim = fp32_acc.GetAccessorInfo().update_dim;
+
+  std::vector<float> fp32_value(fp32_dim, 0);
+  for (size_t i = fp32_acc.common_feature_value.EmbedWIndex(); i < fp32_dim;
+       ++i) {
+    fp32_value[i] = 0.1 * i;
+  }
+  fp32_acc.common_feature_value.Show(fp32_value.data()) = 10;
+  fp32_acc.common_feature_value.Click(fp32_value.data()) = 2;
+  auto str = fp32_acc.ParseToString(fp32_value.data(), fp32_dim);
+  // show 1, click 0 and the gradients
+  std::vector<float> push_value(update_dim, 0.1);
+  push_value[CtrCommonAccessor::CtrCommonPushValue::ShowIndex()] = 1;
+  push_value[CtrCommonAccessor::CtrCommonPushValue::ClickIndex()] = 0;
+  const float* push_ptr = push_value.data();
+
+  for (auto type : {SparseValueQuantParameter::FP16,
+                    SparseValueQuantParameter::BF16,
+                    SparseValueQuantParameter::INT8}) {
+    TableAccessorParameter parameter = fp32_parameter;
+    parameter.mutable_value_quant_param()->set_embedx_type(type);
+    parameter.mutable_value_quant_param()->set_embedx_sgd_type(type);
+    CtrCommonAccessor acc;
+    ASSERT_EQ(acc.Configure(parameter), 0);
+    ASSERT_EQ(acc.Initialize(), 0);
+    const size_t dim = acc.GetAccessorInfo().dim;
+    ASSERT_LT(dim, fp32_dim);
+
+    // the value loaded from the fp32 save is quantized
+    std::vector<float> value(fp32_dim);
+    ASSERT_EQ(acc.ParseFromString(str, value.data()), static_cast<int>(dim));
+    std::vector<float> expected = fp32_value;
+    for (int step = 0; step < 2; ++step) {
+      std::vector<float> fp32_select(select_dim);
+      std::vector<float> select(select_dim);
+      float* fp32_select_ptr = fp32_select.data();
+      float* select_ptr = select.data();
+      const float* expected_ptr = expected.data();
+      const float* value_ptr = value.data();
+      fp32_acc.Select(&fp32_select_ptr, &expected_ptr, 1);
+      acc.Select(&select_ptr, &value_ptr, 1);
+      for (size_t i = 0; i < select_dim; ++i) {
+        ASSERT_NEAR(fp32_select[i], select[i], 0.02) << "at " << i;
+      }
+      // the same push is applied to both
+      float* expected_update = expected.data();
+      float* value_update = value.data();
+      fp32_acc.Update(&expected_update, &push_ptr, 1);
+      acc.Update(&value_update, &push_ptr, 1);
+    }
+
+    // the quantized value is saved as fp32
+    std::vector<float> saved(fp32_dim);
+    auto quant_str = acc.ParseToString(value.data(), dim);
+    ASSERT_EQ(fp32_acc.ParseFromString(quant_str, saved.data()),
+              static_cast<int>(fp32_dim));
+    for (size_t i = 0; i < fp32_dim; ++i) {
+      ASSERT_NEAR(expected[i], saved[i], 0.03) << "at " << i;
+    }
+  }
+}
 }  // namespace distributed
 }  // namespace paddle
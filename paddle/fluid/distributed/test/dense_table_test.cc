@@ -14,6 +14,7 @@ limitations under the License. */
 
 #include <ThreadPool.h>
 
+#include <memory>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -227,5 +228,86 @@ TEST(MemoryDenseTable, SGD) {
   }
 }
 
+// Pushes the gradients of trainers concurrently to a sgd MemoryDenseTable
+// updated by blocks in mode, and checks the param against the sum of them.
+void CheckSGDBlocks(DenseUpdateParameter::Mode mode,
+                    bool merge_pushes,
+                    int trainers) {
+  const int fea_dim = 1000;
+  const int push_times = 20;
+
+  TableParameter table_config;
+  table_config.set_table_class("MemoryDenseTable");
+  table_config.mutable_dense_update_param()->set_mode(mode);
+  table_config.mutable_dense_update_param()->set_block_size(60);
+  table_config.mutable_dense_update_param()->set_merge_pushes(merge_pushes);
+  FsClientParameter fs_config;
+  std::unique_ptr<Table> table(new MemoryDenseTable());
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CommMergeAccessor");
+  CommonAccessorParameter *common_config = table_config.mutable_common();
+  common_config->set_name("sgd");
+  common_config->set_table_name("sgd_blocks_test_table");
+  common_config->set_trainer_num(trainers);
+  common_config->set_sync(false);
+  common_config->add_params("Param");
+  common_config->add_dims(fea_dim);
+  common_config->add_initializers("gaussian_random&0&0.0&1.0");
+  common_config->add_params("LearningRate");
+  common_config->add_dims(1);
+  common_config->add_initializers("fill_constant&0.01");
+  ASSERT_EQ(table->Initialize(table_config, fs_config), 0);
+
+  std::vector<float> init_values(fea_dim);
+  TableContext pull_context;
+  pull_context.value_type = Dense;
+  pull_context.pull_context.values = init_values.data();
+  pull_context.num = fea_dim;
+  table->Pull(pull_context);
+
+  std::vector<float> total_gradients(fea_dim, 0);
+  std::vector<std::vector<float>> trainer_gradient_values(trainers);
+  for (int i = 0; i < trainers; i++) {
+    for (int k = 0; k < fea_dim; k++) {
+      float grad = (i + 1) * 0.1 + k * 0.001;
+      trainer_gradient_values[i].push_back(grad);
+      total_gradients[k] += grad * push_times;
+    }
+  }
+
+  ::ThreadPool pool(trainers);
+  std::vector<std::future<void>> task_status;
+  for (int i = 0; i < trainers; i++) {
+    auto &push_values = trainer_gradient_values[i];
+    task_status.push_back(pool.enqueue([&table, &push_values, push_times] {
+      for (int t = 0; t < push_times; ++t) {
+        TableContext table_context;
+        table_context.value_type = Dense;
+        table_context.push_context.values = push_values.data();
+        table_context.num = push_values.size();
+        table->Push(table_context);
+      }
+    }));
+  }
+  for (auto &status : task_status) {
+    status.wait();
+  }
+
+  std::vector<float> pull_values(fea_dim);
+  pull_context.pull_context.values = pull_values.data();
+  table->Pull(pull_context);
+  for (int j = 0; j < fea_dim; j++) {
+    auto update_val = init_values[j] - 0.01 * total_gradients[j];
+    ASSERT_NEAR(update_val, pull_values[j], 1e-3) << "j is " << j;
+  }
+}
+
+TEST(MemoryDenseTable, SGDBlocks) {
+  CheckSGDBlocks(DenseUpdateParameter::BLOCK_LOCK, true, 8);
+  CheckSGDBlocks(DenseUpdateParameter::BLOCK_LOCK, false, 8);
+  // the concurrent hogwild pushes may overwrite each other
+  CheckSGDBlocks(DenseUpdateParameter::HOGWILD, false, 1);
+}
+
 }  // namespace distributed
 }  // namespace paddle
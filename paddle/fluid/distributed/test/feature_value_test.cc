@@ -14,6 +14,7 @@ limitations under the License. */
 
 #include "paddle/fluid/distributed/ps/table/depends/feature_value.h"
 
+#include <unordered_map>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -46,5 +47,76 @@ TEST(BENCHMARK, LargeScaleKV) {
   ASSERT_FLOAT_EQ(value_data[3], 0.3);
 }
 
+TEST(SwissSparseTableShard, CompareWithReference) {
+  typedef SwissSparseTableShard<uint64_t, SlabFeatureValue> shard_type;
+  shard_type shard;
+  std::unordered_map<uint64_t, std::vector<float>> reference;
+
+  // keys of a shard share their low bits in MemorySparseTable
+  for (uint64_t i = 0; i < 100000; ++i) {
+    uint64_t key = (i * 7919 % 20000) * 16 + 3;
+    if (i % 5 == 4) {
+      ASSERT_EQ(shard.erase(key), reference.erase(key));
+      continue;
+    }
+    auto& feature_value = shard[key];
+    size_t size = 1 + i % 40;
+    feature_value.resize(size);
+    for (size_t j = 0; j < size; ++j) {
+      feature_value.data()[j] = static_cast<float>(key + j);
+    }
+    reference[key].assign(feature_value.data(), feature_value.data() + size);
+  }
+  ASSERT_EQ(shard.size(), reference.size());
+
+  size_t count = 0;
+  for (auto it = shard.begin(); it != shard.end(); ++it) {
+    auto ref_it = reference.find(it.key());
+    ASSERT_TRUE(ref_it != reference.end());
+    ASSERT_EQ(it.value().size(), ref_it->second.size());
+    ASSERT_EQ(memcmp(it.value().data(),
+                     ref_it->second.data(),
+                     ref_it->second.size() * sizeof(float)),
+              0);
+    ++count;
+  }
+  ASSERT_EQ(count, reference.size());
+
+  // erase while iterating, like the shrink of MemorySparseTable
+  for (auto it = shard.begin(); it != shard.end();) {
+    if (it.key() % 3 == 0) {
+      reference.erase(it.key());
+      it = shard.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ASSERT_EQ(shard.size(), reference.size());
+  for (auto& pair : reference) {
+    ASSERT_TRUE(shard.find(pair.first) != shard.end());
+  }
+}
+
+TEST(SlabFeatureValue, Resize) {
+  FeatureValueSlab slab;
+  SlabFeatureValue value(&slab);
+  value.resize(3);
+  ASSERT_EQ(value.size(), 3UL);
+  ASSERT_FLOAT_EQ(value.data()[2], 0.0);
+  value.data()[0] = 1.0;
+  // grow beyond the size class, the data should be kept
+  value.resize(FeatureValueSlab::kMaxSlabFloats + 1);
+  ASSERT_FLOAT_EQ(value.data()[0], 1.0);
+  ASSERT_FLOAT_EQ(value.data()[FeatureValueSlab::kMaxSlabFloats], 0.0);
+  value.resize(3);
+  value.shrink_to_fit();
+  ASSERT_FLOAT_EQ(value.data()[0], 1.0);
+
+  SlabFeatureValue copied(value);
+  ASSERT_EQ(copied.size(), 3UL);
+  ASSERT_NE(copied.data(), value.data());
+  ASSERT_FLOAT_EQ(copied.data()[0], 1.0);
+}
+
 }  // namespace distributed
 }  // namespace paddle
@@ -225,7 +225,6 @@ void testFeatureNodeSerializeFloat64() {
 //   }
 // }
 
-// void testCache();
 void testGraphToBuffer();
 
 const char* edges[] = {"37\t45\t0.34",
@@ -407,7 +406,6 @@ void RunClient(
 }
 
 void RunBrpcPushSparse() {
-  // testCache();
   setenv("http_proxy", "", 1);
   setenv("https_proxy", "", 1);
   prepare_file(edge_file_name, 1);
@@ -647,59 +645,6 @@ void RunBrpcPushSparse() {
   client1.StopServer();
 }
 
-/*void testCache() {
-  ::paddle::distributed::ScaledLRU<::paddle::distributed::SampleKey,
-                                   ::paddle::distributed::SampleResult>
-      st(1, 2, 4);
-  char* str = new char[7];
-  strcpy(str, "54321");
-  ::paddle::distributed::SampleResult* result =
-      new ::paddle::distributed::SampleResult(5, str);
-  ::paddle::distributed::SampleKey skey = {6, 1, false};
-  std::vector<std::pair<::paddle::distributed::SampleKey,
-                        paddle::distributed::SampleResult>>
-      r;
-  st.query(0, &skey, 1, r);
-  ASSERT_EQ((int)r.size(), 0);
-
-  st.insert(0, &skey, result, 1);
-  for (size_t i = 0; i < st.get_ttl(); i++) {
-    st.query(0, &skey, 1, r);
-    ASSERT_EQ((int)r.size(), 1);
-    char* p = (char*)r[0].second.buffer.get();
-    for (size_t j = 0; j < r[0].second.actual_size; j++)
-      ASSERT_EQ(p[j], str[j]);
-    r.clear();
-  }
-  st.query(0, &skey, 1, r);
-  ASSERT_EQ((int)r.size(), 0);
-  str = new char[10];
-  strcpy(str, "54321678");
-  result = new ::paddle::distributed::SampleResult(strlen(str), str);
-  st.insert(0, &skey, result, 1);
-  for (size_t i = 0; i < st.get_ttl() / 2; i++) {
-    st.query(0, &skey, 1, r);
-    ASSERT_EQ((int)r.size(), 1);
-    char* p = (char*)r[0].second.buffer.get();
-    for (size_t j = 0; j < r[0].second.actual_size; j++)
-      ASSERT_EQ(p[j], str[j]);
-    r.clear();
-  }
-  str = new char[18];
-  strcpy(str, "343332d4321");
-  result = new ::paddle::distributed::SampleResult(strlen(str), str);
-  st.insert(0, &skey, result, 1);
-  for (size_t i = 0; i < st.get_ttl(); i++) {
-    st.query(0, &skey, 1, r);
-    ASSERT_EQ((int)r.size(), 1);
-    char* p = (char*)r[0].second.buffer.get();
-    for (int j = 0; j < (int)r[0].second.actual_size; j++)
-      ASSERT_EQ(p[j], str[j]);
-    r.clear();
-  }
-  st.query(0, &skey, 1, r);
-  ASSERT_EQ((int)r.size(), 0);
-}*/
 void testGraphToBuffer() {
   ::paddle::distributed::GraphNode s, s1;
   s.set_feature_size(1);
@@ -0,0 +1,116 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/table/common_graph_table.h"
+
+namespace paddle {
+namespace distributed {
+
+using Cache = SampleClockCache<SampleKey, SampleResult>;
+
+SampleResult make_result(const char* str) {
+  size_t len = strlen(str) + 1;
+  char* buffer = new char[len];
+  memcpy(buffer, str, len);
+  return SampleResult(len, buffer);
+}
+
+TEST(SampleClockCache, TTL) {
+  Cache cache(1, 2, 4);
+  SampleKey key(0, 6, 1, false);
+  std::vector<std::pair<SampleKey, SampleResult>> r;
+  cache.query(0, &key, 1, r);
+  ASSERT_EQ(r.size(), 0UL);
+
+  SampleResult result = make_result("54321");
+  cache.insert(0, &key, &result, 1);
+  for (size_t i = 0; i < cache.get_ttl(); i++) {
+    cache.query(0, &key, 1, r);
+    ASSERT_EQ(r.size(), 1UL);
+    ASSERT_STREQ(r[0].second.buffer.get(), "54321");
+    r.clear();
+  }
+  // expired after ttl hits
+  cache.query(0, &key, 1, r);
+  ASSERT_EQ(r.size(), 0UL);
+
+  // an insert of the same key refreshes the entry
+  result = make_result("54321678");
+  cache.insert(0, &key, &result, 1);
+  cache.query(0, &key, 1, r);
+  ASSERT_EQ(r.size(), 1UL);
+  ASSERT_STREQ(r[0].second.buffer.get(), "54321678");
+  ASSERT_EQ(cache.hit_count(), 5UL);
+  ASSERT_EQ(cache.miss_count(), 2UL);
+}
+
+TEST(SampleClockCache, SecondChance) {
+  Cache cache(1, 2, 100);
+  SampleKey keys[3] = {SampleKey(0, 1, 1, false),
+                       SampleKey(0, 2, 1, false),
+                       SampleKey(0, 3, 1, false)};
+  SampleResult results[3] = {
+      make_result("1"), make_result("2"), make_result("3")};
+  cache.insert(0, keys, results, 2);
+  std::vector<std::pair<SampleKey, SampleResult>> r;
+  // key 1 is referenced and survives the insert of key 3
+  cache.query(0, &keys[0], 1, r);
+  ASSERT_EQ(r.size(), 1UL);
+  cache.insert(0, &keys[2], &results[2], 1);
+  ASSERT_EQ(cache.evict_count(), 1UL);
+
+  r.clear();
+  cache.query(0, keys, 3, r);
+  ASSERT_EQ(r.size(), 2UL);
+  ASSERT_EQ(r[0].first.node_key, 1UL);
+  ASSERT_EQ(r[1].first.node_key, 3UL);
+}
+
+TEST(SampleClockCache, ConcurrentHits) {
+  const int kThreadNum = 8;
+  const int kTTL = 1000;
+  Cache cache(1, 16, kTTL);
+  SampleKey key(0, 7, 1, false);
+  SampleResult result = make_result("7");
+  cache.insert(0, &key, &result, 1);
+  std::vector<std::thread> threads;
+  std::vector<size_t> hits(kThreadNum, 0);
+  for (int t = 0; t < kThreadNum; t++) {
+    threads.emplace_back([&cache, &key, &hits, t]() {
+      std::vector<std::pair<SampleKey, SampleResult>> r;
+      for (int i = 0; i < kTTL; i++) {
+        cache.query(0, &key, 1, r);
+      }
+      hits[t] = r.size();
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  size_t total = 0;
+  for (auto h : hits) {
+    total += h;
+  }
+  // the result is served exactly ttl times among the threads
+  ASSERT_EQ(total, static_cast<size_t>(kTTL));
+}
+
+}  // namespace distributed
+}  // namespace paddle
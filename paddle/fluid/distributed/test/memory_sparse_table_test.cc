@@ -17,13 +17,20 @@ limitations under the License. */
 #include <ThreadPool.h>
 #include <unistd.h>
 
+#include <chrono>  // NOLINT
+#include <memory>
+#include <random>
 #include <string>
 #include <thread>  // NOLINT
 
 #include "google/protobuf/text_format.h"
 #include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/table/depends/feature_value.h"
 #include "paddle/fluid/distributed/ps/table/table.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
+#include "paddle/fluid/framework/io/fs.h"
+
+PD_DECLARE_bool(pserver_sparse_table_save_delta);
 
 namespace paddle {
 namespace distributed {
@@ -152,5 +159,255 @@ TEST(MemorySparseTable, SGD) {
   }
 }
 
+// Replays the access pattern of PullSparse/PushSparse on one shard: the
+// first pass creates the values, the following passes find and update them.
+template <typename SHARD>
+double RunShardBenchmark(const std::vector<uint64_t> &keys, size_t dim) {
+  SHARD shard;
+  auto start = std::chrono::steady_clock::now();
+  for (auto key : keys) {
+    auto &value = shard[key];
+    if (value.size() == 0) {
+      value.resize(dim);
+    }
+    value.data()[0] += 1.0;
+  }
+  for (int pass = 0; pass < 3; ++pass) {
+    for (auto key : keys) {
+      auto it = shard.find(key);
+      EXPECT_TRUE(it != shard.end());
+      float *data = it.value().data();
+      for (size_t j = 0; j < dim; ++j) {
+        data[j] -= 0.01;
+      }
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  EXPECT_EQ(shard.size(), keys.size());
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+TEST(MemorySparseTable, ShardBenchmark) {
+  const size_t kDim = 11;
+  std::mt19937_64 rng(0);
+  std::vector<uint64_t> keys(200000);
+  for (auto &key : keys) {
+    key = rng();
+  }
+  double mct_ms =
+      RunShardBenchmark<SparseTableShard<uint64_t, FixedFeatureValue>>(keys,
+                                                                       kDim);
+  double swiss_ms =
+      RunShardBenchmark<SwissSparseTableShard<uint64_t, SlabFeatureValue>>(
+          keys, kDim);
+  LOG(INFO) << "SparseTableShard<FixedFeatureValue>: " << mct_ms
+            << " ms, SwissSparseTableShard<SlabFeatureValue>: " << swiss_ms
+            << " ms, " << keys.size() << " keys";
+}
+
+// Times the pushes of the adagrad gradients of the values extended to the
+// full size, which are updated in place by the batched sgd rules.
+TEST(MemorySparseTable, PushBenchmark) {
+  const int emb_dim = 16;
+  TableParameter table_config;
+  table_config.set_table_class("MemorySparseTable");
+  table_config.set_shard_num(10);
+  FsClientParameter fs_config;
+  std::unique_ptr<Table> table(new MemorySparseTable());
+  table->SetShard(0, 1);
+
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(emb_dim + 3);
+  accessor_config->set_embedx_dim(emb_dim);
+  accessor_config->set_embedx_threshold(0);
+  accessor_config->mutable_ctr_accessor_param()->set_nonclk_coeff(0.2);
+  accessor_config->mutable_ctr_accessor_param()->set_click_coeff(1);
+  for (auto *sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseAdaGradSGDRule");
+    auto *adagrad_param = sgd_param->mutable_adagrad();
+    adagrad_param->set_learning_rate(0.1);
+    adagrad_param->set_initial_g2sum(3.0);
+    adagrad_param->set_initial_range(0.3);
+    adagrad_param->add_weight_bounds(-10.0);
+    adagrad_param->add_weight_bounds(10.0);
+  }
+  ASSERT_EQ(table->Initialize(table_config, fs_config), 0);
+
+  const size_t kKeyNum = 100000;
+  const int kPasses = 5;
+  const size_t push_dim = emb_dim + 4;
+  std::mt19937_64 rng(0);
+  std::vector<uint64_t> keys(kKeyNum);
+  for (auto &key : keys) {
+    key = rng();
+  }
+  std::vector<float> push_values(kKeyNum * push_dim);
+  for (size_t i = 0; i < push_values.size(); ++i) {
+    push_values[i] = (i % push_dim) * 0.01;
+  }
+
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.push_context.keys = keys.data();
+  table_context.push_context.values = push_values.data();
+  table_context.num = kKeyNum;
+  // the first push creates and extends the values
+  table->Push(table_context);
+  auto start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < kPasses; ++pass) {
+    table->Push(table_context);
+  }
+  auto end = std::chrono::steady_clock::now();
+  LOG(INFO) << "MemorySparseTable push: "
+            << std::chrono::duration<double, std::milli>(end - start).count() /
+                   kPasses
+            << " ms per pass, " << kKeyNum << " keys of dim " << emb_dim;
+}
+
+TEST(MemorySparseTable, SaveDelta) {
+  FLAGS_pserver_sparse_table_save_delta = true;
+  const int emb_dim = 8;
+  const std::string path = "./memory_sparse_table_delta_test";
+  paddle::framework::fs_remove(path);
+
+  TableParameter table_config;
+  table_config.set_table_class("MemorySparseTable");
+  table_config.set_shard_num(10);
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(11);
+  accessor_config->set_embedx_dim(emb_dim);
+  accessor_config->set_embedx_threshold(5);
+  for (auto *sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseNaiveSGDRule");
+    auto *naive_param = sgd_param->mutable_naive();
+    naive_param->set_learning_rate(0.1);
+    naive_param->set_initial_range(0.3);
+    naive_param->add_weight_bounds(-10.0);
+    naive_param->add_weight_bounds(10.0);
+  }
+  FsClientParameter fs_config;
+
+  auto push = [emb_dim](Table *table, const std::vector<uint64_t> &keys) {
+    std::vector<float> gradients(keys.size() * (emb_dim + 4), 0.5);
+    TableContext table_context;
+    table_context.value_type = Sparse;
+    table_context.push_context.keys = keys.data();
+    table_context.push_context.values = gradients.data();
+    table_context.num = keys.size();
+    ASSERT_EQ(table->Push(table_context), 0);
+  };
+  std::vector<uint64_t> keys = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 20, 21};
+  auto pull = [emb_dim, &keys](Table *table) {
+    std::vector<uint32_t> fres(keys.size(), 1);
+    auto value = PullSparseValue(keys, fres, emb_dim);
+    std::vector<float> values(keys.size() * (emb_dim + 3));
+    TableContext table_context;
+    table_context.value_type = Sparse;
+    table_context.pull_context.pull_value = value;
+    table_context.pull_context.values = values.data();
+    table->Pull(table_context);
+    return values;
+  };
+
+  std::unique_ptr<Table> table(new MemorySparseTable());
+  table->SetShard(0, 1);
+  ASSERT_EQ(table->Initialize(table_config, fs_config), 0);
+  push(table.get(), {0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+  ASSERT_EQ(table->Save(path, "0"), 0);
+  // the rows pushed after the base are saved only by the delta
+  push(table.get(), {3, 4, 20});
+  ASSERT_EQ(table->Save(path, "6"), 0);
+  push(table.get(), {5, 21});
+  ASSERT_EQ(table->Save(path, "6"), 0);
+
+  std::unique_ptr<Table> loaded(new MemorySparseTable());
+  loaded->SetShard(0, 1);
+  ASSERT_EQ(loaded->Initialize(table_config, fs_config), 0);
+  ASSERT_EQ(loaded->Load(path, "0"), 0);
+  auto expected = pull(table.get());
+  auto actual = pull(loaded.get());
+  // the values are saved as text of 6 significant digits
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_NEAR(expected[i], actual[i], 1e-4) << "at " << i;
+  }
+  paddle::framework::fs_remove(path);
+  FLAGS_pserver_sparse_table_save_delta = false;
+}
+
+TEST(MemorySparseTable, AdmissionAndEviction) {
+  const int emb_dim = 8;
+  TableParameter table_config;
+  table_config.set_table_class("MemorySparseTable");
+  table_config.set_shard_num(10);
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(11);
+  accessor_config->set_embedx_dim(emb_dim);
+  accessor_config->set_embedx_threshold(5);
+  for (auto *sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseNaiveSGDRule");
+    auto *naive_param = sgd_param->mutable_naive();
+    naive_param->set_learning_rate(0.1);
+    naive_param->set_initial_range(0.3);
+    naive_param->add_weight_bounds(-10.0);
+    naive_param->add_weight_bounds(10.0);
+  }
+  FsClientParameter fs_config;
+
+  auto push = [emb_dim](Table *table, const std::vector<uint64_t> &keys) {
+    // show 1, click 0
+    std::vector<float> gradients(keys.size() * (emb_dim + 4), 0.1);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      gradients[i * (emb_dim + 4) + 1] = 1.0;
+      gradients[i * (emb_dim + 4) + 2] = 0.0;
+    }
+    TableContext table_context;
+    table_context.value_type = Sparse;
+    table_context.push_context.keys = keys.data();
+    table_context.push_context.values = gradients.data();
+    table_context.num = keys.size();
+    ASSERT_EQ(table->Push(table_context), 0);
+  };
+
+  // a key is created at its second push
+  TableParameter admission_config = table_config;
+  admission_config.mutable_admission_param()->set_enable(true);
+  admission_config.mutable_admission_param()->set_min_count(2);
+  std::unique_ptr<Table> admission_table(new MemorySparseTable());
+  admission_table->SetShard(0, 1);
+  ASSERT_EQ(admission_table->Initialize(admission_config, fs_config), 0);
+  auto *admission_sparse_table =
+      static_cast<MemorySparseTable *>(admission_table.get());
+  push(admission_table.get(), {1, 2, 3});
+  ASSERT_EQ(admission_sparse_table->LocalSize(), 0);
+  push(admission_table.get(), {1, 2, 4});
+  ASSERT_EQ(admission_sparse_table->LocalSize(), 2);
+
+  // the keys 0, 10, 20 are of the local shard 0, which keeps the most
+  // frequent one
+  TableParameter eviction_config = table_config;
+  eviction_config.mutable_eviction_param()->set_enable(true);
+  eviction_config.mutable_eviction_param()->set_interval_ms(1);
+  eviction_config.mutable_eviction_param()->set_max_keys_per_shard(1);
+  std::unique_ptr<Table> eviction_table(new MemorySparseTable());
+  eviction_table->SetShard(0, 1);
+  ASSERT_EQ(eviction_table->Initialize(eviction_config, fs_config), 0);
+  auto *eviction_sparse_table =
+      static_cast<MemorySparseTable *>(eviction_table.get());
+  push(eviction_table.get(), {0, 10, 20, 0, 0, 1});
+  for (int i = 0; i < 1000 && eviction_sparse_table->LocalSize() > 2; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_EQ(eviction_sparse_table->LocalSize(), 2);
+  auto *shard = static_cast<MemorySparseTable::shard_type *>(
+      eviction_table->GetShard(0));
+  ASSERT_TRUE(shard->find(0) != shard->end());
+}
+
 }  // namespace distributed
 }  // namespace paddle
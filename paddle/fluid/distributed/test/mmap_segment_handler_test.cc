@@ -0,0 +1,182 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/table/depends/mmap_segment_handler.h"
+
+#include <rocksdb/env.h>
+#include <rocksdb/sst_file_writer.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace distributed {
+
+static std::string MakeValue(uint64_t key, size_t dim) {
+  std::vector<float> value(dim);
+  for (size_t i = 0; i < dim; ++i) {
+    value[i] = key + i;
+  }
+  return std::string(reinterpret_cast<const char*>(value.data()),
+                     dim * sizeof(float));
+}
+
+TEST(MmapSegmentHandler, PutGetDel) {
+  MmapSegmentHandler handler;
+  handler.set_segment_size(64 << 10);
+  handler.initialize("mmap_segment_handler_test", 2);
+
+  std::unordered_map<uint64_t, std::string> expected;
+  for (uint64_t key = 0; key < 10000; ++key) {
+    auto value = MakeValue(key, 8 + key % 5);
+    handler.put(key % 2,
+                reinterpret_cast<const char*>(&key),
+                sizeof(uint64_t),
+                value.data(),
+                value.size());
+    expected[key] = value;
+  }
+  // overwrite and delete some keys
+  for (uint64_t key = 0; key < 10000; key += 3) {
+    if (key % 2 == 0) {
+      auto value = MakeValue(key * 7, 13);
+      handler.put(key % 2,
+                  reinterpret_cast<const char*>(&key),
+                  sizeof(uint64_t),
+                  value.data(),
+                  value.size());
+      expected[key] = value;
+    } else {
+      handler.del_data(
+          key % 2, reinterpret_cast<const char*>(&key), sizeof(uint64_t));
+      expected.erase(key);
+    }
+  }
+
+  uint64_t num_keys = 0;
+  handler.get_estimate_key_num(num_keys);
+  ASSERT_EQ(num_keys, expected.size());
+  for (uint64_t key = 0; key < 10000; ++key) {
+    std::string value;
+    int ret = handler.get(
+        key % 2, reinterpret_cast<const char*>(&key), sizeof(uint64_t), value);
+    auto itr = expected.find(key);
+    if (itr == expected.end()) {
+      ASSERT_EQ(ret, 1);
+    } else {
+      ASSERT_EQ(ret, 0);
+      ASSERT_EQ(value, itr->second);
+    }
+  }
+
+  std::vector<uint64_t> keys = {0, 3, 4, 6, 9999};
+  std::vector<rocksdb::Slice> slices;
+  for (auto& key : keys) {
+    slices.emplace_back(reinterpret_cast<const char*>(&key), sizeof(uint64_t));
+  }
+  std::vector<rocksdb::PinnableSlice> values(keys.size());
+  std::vector<rocksdb::Status> status(keys.size());
+  handler.multi_get(0, keys.size(), slices.data(), values.data(), status.data());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (keys[i] % 2 == 0) {
+      ASSERT_TRUE(status[i].ok());
+      ASSERT_EQ(values[i].ToString(), expected[keys[i]]);
+    } else {
+      // the keys of column 1 are not in column 0
+      ASSERT_TRUE(status[i].IsNotFound());
+    }
+  }
+}
+
+TEST(MmapSegmentHandler, IteratorAndCompact) {
+  MmapSegmentHandler handler;
+  handler.set_segment_size(64 << 10);
+  handler.initialize("mmap_segment_handler_test", 1);
+
+  for (int round = 0; round < 4; ++round) {
+    for (uint64_t key = 0; key < 1000; ++key) {
+      auto value = MakeValue(key + round, 16);
+      handler.put(0,
+                  reinterpret_cast<const char*>(&key),
+                  sizeof(uint64_t),
+                  value.data(),
+                  value.size());
+    }
+  }
+  // iterators see the keys in order and block the compaction
+  rocksdb::Iterator* it = handler.get_iterator(0);
+  handler.flush(0);
+  uint64_t expected_key = 0;
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    uint64_t key = *(reinterpret_cast<const uint64_t*>(it->key().data()));
+    ASSERT_EQ(key, expected_key);
+    ASSERT_EQ(it->value().ToString(), MakeValue(key + 3, 16));
+    ++expected_key;
+  }
+  ASSERT_EQ(expected_key, 1000UL);
+  uint64_t target = 500;
+  it->Seek(
+      rocksdb::Slice(reinterpret_cast<const char*>(&target), sizeof(uint64_t)));
+  ASSERT_TRUE(it->Valid());
+  ASSERT_EQ(*(reinterpret_cast<const uint64_t*>(it->key().data())), target);
+  delete it;
+
+  handler.flush(0);
+  for (uint64_t key = 0; key < 1000; ++key) {
+    std::string value;
+    ASSERT_EQ(handler.get(0,
+                          reinterpret_cast<const char*>(&key),
+                          sizeof(uint64_t),
+                          value),
+              0);
+    ASSERT_EQ(value, MakeValue(key + 3, 16));
+  }
+}
+
+TEST(MmapSegmentHandler, IngestSstFile) {
+  MmapSegmentHandler handler;
+  handler.initialize("mmap_segment_handler_test", 1);
+
+  rocksdb::Options options;
+  options.comparator = handler.get_comparator();
+  rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), options);
+  std::string filename = "mmap_segment_handler_test.sst";
+  ASSERT_TRUE(writer.Open(filename).ok());
+  for (uint64_t key = 0; key < 100; ++key) {
+    auto value = MakeValue(key, 8);
+    ASSERT_TRUE(writer
+                    .Put(rocksdb::Slice(reinterpret_cast<const char*>(&key),
+                                        sizeof(uint64_t)),
+                         rocksdb::Slice(value))
+                    .ok());
+  }
+  ASSERT_TRUE(writer.Finish().ok());
+  ASSERT_EQ(handler.ingest_externel_file(0, {filename}), 0);
+
+  for (uint64_t key = 0; key < 100; ++key) {
+    std::string value;
+    ASSERT_EQ(handler.get(0,
+                          reinterpret_cast<const char*>(&key),
+                          sizeof(uint64_t),
+                          value),
+              0);
+    ASSERT_EQ(value, MakeValue(key, 8));
+  }
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,111 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/service/sparse_hot_key_cache.h"
+
+#include <unistd.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+
+namespace paddle {
+namespace distributed {
+
+const size_t kDim = 11;
+
+SparseHotKeyCacheParameter gen_param() {
+  SparseHotKeyCacheParameter param;
+  param.set_enable(true);
+  param.set_capacity(64);
+  param.set_max_staleness_ms(100000);
+  param.set_max_staleness_pulls(3);
+  param.set_hot_score_threshold(10);
+  return param;
+}
+
+TEST(SparseHotKeyCache, Admission) {
+  SparseHotKeyCache cache(gen_param(), kDim * sizeof(float));
+  std::vector<float> value(kDim, 1.0);
+  std::vector<float> result(kDim, 0.0);
+
+  // cold key is not cached
+  cache.Update(1, value.data(), 5.0);
+  ASSERT_FALSE(cache.Lookup(1, result.data()));
+
+  cache.Update(2, value.data(), 20.0);
+  ASSERT_TRUE(cache.Lookup(2, result.data()));
+  for (size_t i = 0; i < kDim; ++i) {
+    ASSERT_FLOAT_EQ(result[i], 1.0);
+  }
+  // the key cools down
+  cache.Update(2, value.data(), 1.0);
+  ASSERT_FALSE(cache.Lookup(2, result.data()));
+  ASSERT_EQ(cache.Size(), 0UL);
+  ASSERT_EQ(cache.HitCount(), 1UL);
+  ASSERT_EQ(cache.MissCount(), 2UL);
+}
+
+TEST(SparseHotKeyCache, Staleness) {
+  auto param = gen_param();
+  SparseHotKeyCache cache(param, kDim * sizeof(float));
+  std::vector<float> value(kDim, 1.0);
+  std::vector<float> result(kDim, 0.0);
+
+  cache.Update(1, value.data(), 20.0);
+  for (uint32_t i = 0; i < param.max_staleness_pulls(); ++i) {
+    ASSERT_TRUE(cache.Lookup(1, result.data()));
+  }
+  // served max_staleness_pulls times, need to pull again
+  ASSERT_FALSE(cache.Lookup(1, result.data()));
+  value[0] = 2.0;
+  cache.Update(1, value.data(), 20.0);
+  ASSERT_TRUE(cache.Lookup(1, result.data()));
+  ASSERT_FLOAT_EQ(result[0], 2.0);
+
+  param.set_max_staleness_ms(1);
+  SparseHotKeyCache timed_cache(param, kDim * sizeof(float));
+  timed_cache.Update(1, value.data(), 20.0);
+  usleep(10000);
+  ASSERT_FALSE(timed_cache.Lookup(1, result.data()));
+}
+
+TEST(SparseHotKeyCache, Eviction) {
+  auto param = gen_param();
+  param.set_max_staleness_pulls(1000000);
+  SparseHotKeyCache cache(param, kDim * sizeof(float));
+  std::vector<float> value(kDim, 0.0);
+  std::vector<float> result(kDim, 0.0);
+
+  for (uint64_t key = 0; key < 10000; ++key) {
+    value[0] = key;
+    cache.Update(key, value.data(), 20.0);
+    ASSERT_LE(cache.Size(), param.capacity());
+    // key 0 is hit all the time and never evicted
+    ASSERT_TRUE(cache.Lookup(0, result.data()));
+    ASSERT_FLOAT_EQ(result[0], 0.0);
+  }
+  for (uint64_t key = 0; key < 10000; ++key) {
+    if (cache.Lookup(key, result.data())) {
+      ASSERT_FLOAT_EQ(result[0], key);
+    }
+  }
+  cache.Clear();
+  ASSERT_EQ(cache.Size(), 0UL);
+  ASSERT_FALSE(cache.Lookup(0, result.data()));
+}
+
+}  // namespace distributed
+}  // namespace paddle
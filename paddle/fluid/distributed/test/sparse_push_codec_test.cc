@@ -0,0 +1,115 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/service/sparse_push_codec.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+
+namespace paddle {
+namespace distributed {
+
+// slot, show, click, embed_g, embedx_g[32]
+const size_t kUpdateDim = 36;
+const size_t kGradIndex = 3;
+
+std::vector<float> gen_push_value(std::mt19937* rng) {
+  std::normal_distribution<float> dist(0, 0.01);
+  std::vector<float> value(kUpdateDim);
+  value[0] = 12345;
+  value[1] = 1;
+  value[2] = 0;
+  for (size_t i = kGradIndex; i < kUpdateDim; ++i) {
+    value[i] = dist(*rng);
+  }
+  return value;
+}
+
+SparsePushCodec gen_codec(SparsePushCompressParameter::Codec type) {
+  SparsePushCompressParameter param;
+  param.set_codec(type);
+  return SparsePushCodec(param, kUpdateDim, kGradIndex);
+}
+
+TEST(SparsePushCodec, Quantize) {
+  std::mt19937 rng(0);
+  auto value = gen_push_value(&rng);
+  std::vector<float> decoded(kUpdateDim);
+  std::vector<std::pair<SparsePushCompressParameter::Codec, float>> cases = {
+      {SparsePushCompressParameter::NONE, 0},
+      {SparsePushCompressParameter::FP16, 1e-3},
+      {SparsePushCompressParameter::BF16, 1e-2},
+      {SparsePushCompressParameter::INT8, 1e-2}};
+  for (auto& item : cases) {
+    auto codec = gen_codec(item.first);
+    std::vector<char> encoded(codec.EncodedSize());
+    codec.Encode(1, value.data(), encoded.data());
+    codec.Decode(encoded.data(), decoded.data());
+    float max_abs = 0;
+    for (size_t i = kGradIndex; i < kUpdateDim; ++i) {
+      max_abs = std::max(max_abs, std::fabs(value[i]));
+    }
+    // slot, show and click are not compressed
+    for (size_t i = 0; i < kGradIndex; ++i) {
+      ASSERT_EQ(decoded[i], value[i]);
+    }
+    for (size_t i = kGradIndex; i < kUpdateDim; ++i) {
+      ASSERT_NEAR(decoded[i], value[i], item.second * max_abs);
+    }
+  }
+  ASSERT_EQ(gen_codec(SparsePushCompressParameter::FP16).EncodedSize(),
+            kGradIndex * 4 + (kUpdateDim - kGradIndex) * 2);
+  ASSERT_EQ(gen_codec(SparsePushCompressParameter::INT8).EncodedSize(),
+            kGradIndex * 4 + 4 + (kUpdateDim - kGradIndex));
+}
+
+TEST(SparsePushCodec, TopKErrorFeedback) {
+  SparsePushCompressParameter param;
+  param.set_codec(SparsePushCompressParameter::TOPK);
+  param.set_topk_ratio(0.25);
+  SparsePushCodec codec(param, kUpdateDim, kGradIndex);
+  // ceil(0.25 * 33) = 9 values and indices
+  ASSERT_EQ(codec.EncodedSize(), kGradIndex * 4 + 9 * 6);
+
+  std::mt19937 rng(0);
+  std::vector<float> sent(kUpdateDim, 0);
+  std::vector<float> pushed(kUpdateDim, 0);
+  std::vector<float> decoded(kUpdateDim);
+  std::vector<char> encoded(codec.EncodedSize());
+  const int kRound = 200;
+  for (int round = 0; round < kRound; ++round) {
+    auto value = gen_push_value(&rng);
+    codec.Encode(7, value.data(), encoded.data());
+    codec.Decode(encoded.data(), decoded.data());
+    size_t nonzero = 0;
+    for (size_t i = kGradIndex; i < kUpdateDim; ++i) {
+      pushed[i] += value[i];
+      sent[i] += decoded[i];
+      nonzero += decoded[i] != 0;
+    }
+    ASSERT_LE(nonzero, 9UL);
+  }
+  // the dropped gradients are sent later, so that the sum of sent gradients
+  // follows the sum of pushed gradients
+  for (size_t i = kGradIndex; i < kUpdateDim; ++i) {
+    ASSERT_NEAR(sent[i], pushed[i], 0.1);
+  }
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -16,6 +16,7 @@ limitations under the License. */
 
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
@@ -205,5 +206,81 @@ TEST(downpour_sparse_adam_test, test_init_and_update) {
     ASSERT_FLOAT_EQ(value[i], label[i]) << "i is " << i;
   }
 }
+
+// UpdateValueBatch over the keys should match UpdateValue of every key, with
+// an embedding dim that is not a multiple of the simd width.
+void CheckUpdateValueBatch(SparseValueSGDRule* rule, int embed_dim) {
+  const int kKeyNum = 5;
+  const int value_dim = 1 + embed_dim + rule->Dim();
+  std::vector<float> values(kKeyNum * value_dim);
+  std::vector<float> grads(kKeyNum * (1 + embed_dim));
+  std::vector<float*> value_ptrs(kKeyNum);
+  std::vector<const float*> grad_ptrs(kKeyNum);
+  std::vector<float> scales(kKeyNum);
+  for (int k = 0; k < kKeyNum; ++k) {
+    float* value = values.data() + k * value_dim;
+    rule->InitValue(value + 1, value + 1 + embed_dim, false);
+    for (int i = 0; i < embed_dim; ++i) {
+      grads[k * (1 + embed_dim) + 1 + i] = (k + 1) * 0.1 - i * 0.05;
+    }
+    grad_ptrs[k] = grads.data() + k * (1 + embed_dim);
+    scales[k] = k + 1;
+  }
+  std::vector<float> batch_values(values);
+  for (int k = 0; k < kKeyNum; ++k) {
+    value_ptrs[k] = batch_values.data() + k * value_dim;
+  }
+
+  rule->UpdateValueBatch(value_ptrs.data(),
+                         1,
+                         1 + embed_dim,
+                         grad_ptrs.data(),
+                         1,
+                         scales.data(),
+                         kKeyNum);
+  for (int k = 0; k < kKeyNum; ++k) {
+    float* value = values.data() + k * value_dim;
+    rule->UpdateValue(
+        value + 1, value + 1 + embed_dim, grad_ptrs[k] + 1, scales[k]);
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_FLOAT_EQ(batch_values[i], values[i]) << "i is " << i;
+  }
+}
+
+TEST(sparse_sgd_rule_test, test_update_value_batch) {
+  const int embed_dim = 13;
+  {
+    SparseCommonSGDRuleParameter param;
+    param.set_name("adagrad");
+    auto* adagrad_param = param.mutable_adagrad();
+    adagrad_param->set_learning_rate(0.1);
+    adagrad_param->set_initial_g2sum(0.2);
+    adagrad_param->set_initial_range(0.3);
+    adagrad_param->add_weight_bounds(-10.0);
+    adagrad_param->add_weight_bounds(10.0);
+    SparseAdaGradSGDRule adagrad_rule;
+    adagrad_rule.LoadConfig(param, embed_dim);
+    CheckUpdateValueBatch(&adagrad_rule, embed_dim);
+    StdAdaGradSGDRule std_adagrad_rule;
+    std_adagrad_rule.LoadConfig(param, embed_dim);
+    CheckUpdateValueBatch(&std_adagrad_rule, embed_dim);
+  }
+  {
+    SparseCommonSGDRuleParameter param;
+    param.set_name("adam");
+    auto* adam_param = param.mutable_adam();
+    adam_param->set_learning_rate(0.1);
+    adam_param->set_initial_range(0.3);
+    adam_param->set_beta1_decay_rate(0.9);
+    adam_param->set_beta2_decay_rate(0.999);
+    adam_param->set_ada_epsilon(1e-08);
+    adam_param->add_weight_bounds(-10.0);
+    adam_param->add_weight_bounds(10.0);
+    SparseAdamSGDRule adam_rule;
+    adam_rule.LoadConfig(param, embed_dim);
+    CheckUpdateValueBatch(&adam_rule, embed_dim);
+  }
+}
 }  // namespace distributed
 }  // namespace paddle
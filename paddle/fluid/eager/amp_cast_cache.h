@@ -0,0 +1,119 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <tuple>
+
+#include "paddle/fluid/eager/utils.h"
+#include "paddle/phi/api/include/tensor.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_bool(eager_amp_cast_cache);
+
+namespace egr {
+
+/**
+ * AmpCastCache holds the copies of the leaf tensors, e.g. the parameters,
+ * cast by the eager AMP, so that a parameter used by several ops, e.g. a
+ * shared embedding or the weights of a RNN cell, is cast once in a step.
+ *
+ * A copy is reused until the inplace version or the data of the tensor
+ * changes. Since the optimizers update the parameters in place without
+ * bumping the version, all the copies are released at the end of backward,
+ * and at the exit of auto_cast.
+ * **/
+class AmpCastCache {
+ public:
+  static AmpCastCache& Instance() {
+    static thread_local AmpCastCache cache;
+    return cache;
+  }
+
+  static bool IsEnabled() { return FLAGS_eager_amp_cast_cache; }
+
+  static bool IsCacheable(const paddle::Tensor& tensor) {
+    return tensor.is_dense_tensor() && tensor.initialized() &&
+           EagerUtils::IsLeafTensor(tensor);
+  }
+
+  // Return the copy of input cast to dst_dtype, which is traced for backward
+  // if trace_backward, or an uninitialized tensor if it is not cached.
+  paddle::Tensor Get(const paddle::Tensor& input,
+                     phi::DataType dst_dtype,
+                     bool trace_backward) {
+    auto it = entries_.find(Key(input, dst_dtype, trace_backward));
+    if (it == entries_.end()) {
+      ++misses_;
+      return paddle::Tensor();
+    }
+    const auto& entry = it->second;
+    auto* dense = static_cast<phi::DenseTensor*>(input.impl().get());
+    if (entry.source.lock() != input.impl() || entry.data != dense->data() ||
+        entry.version != dense->InplaceVersionCounter().CurrentVersion()) {
+      entries_.erase(it);
+      ++misses_;
+      return paddle::Tensor();
+    }
+    ++hits_;
+    return entry.casted;
+  }
+
+  void Put(const paddle::Tensor& input,
+           phi::DataType dst_dtype,
+           bool trace_backward,
+           const paddle::Tensor& casted) {
+    auto* dense = static_cast<phi::DenseTensor*>(input.impl().get());
+    entries_[Key(input, dst_dtype, trace_backward)] =
+        Entry{input.impl(),
+              dense->data(),
+              dense->InplaceVersionCounter().CurrentVersion(),
+              casted};
+  }
+
+  void Clear() { entries_.clear(); }
+
+  size_t Size() const { return entries_.size(); }
+
+  int64_t Hits() const { return hits_; }
+
+  int64_t Misses() const { return misses_; }
+
+ private:
+  using CacheKey = std::tuple<const phi::TensorBase*, phi::DataType, bool>;
+
+  struct Entry {
+    std::weak_ptr<phi::TensorBase> source;
+    const void* data;
+    uint32_t version;
+    paddle::Tensor casted;
+  };
+
+  AmpCastCache() = default;
+
+  static CacheKey Key(const paddle::Tensor& input,
+                      phi::DataType dst_dtype,
+                      bool trace_backward) {
+    return CacheKey(input.impl().get(), dst_dtype, trace_backward);
+  }
+
+  std::map<CacheKey, Entry> entries_;
+  int64_t hits_{0};
+  int64_t misses_{0};
+};
+
+}  // namespace egr
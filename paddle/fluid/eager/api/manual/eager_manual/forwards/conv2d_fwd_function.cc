@@ -74,6 +74,17 @@ paddle::Tensor conv2d_ad_func(const paddle::Tensor& input,
         tensors_vector = {{input}, {filter}};
 
     auto op_name = phi::TransToFluidOpName("conv2d");
+    if (egr::DesiredLayout() == phi::DataLayout::UNDEFINED &&
+        paddle::imperative::LayoutAutoTune::Instance().TuneByCost()) {
+      egr::MeasureConv2dLayoutCost(input,
+                                   filter,
+                                   strides,
+                                   paddings,
+                                   padding_algorithm,
+                                   dilations,
+                                   groups,
+                                   data_format);
+    }
     auto transformer = egr::EagerLayoutAutotune<std::string>(
         op_name, tensors_vector, &data_format);
     auto new_input = transformer->TransInTensor("input", input);
@@ -259,6 +259,9 @@ TEST_API {} {}({}) {{
   // Type promotion Logic
 {}
   // Layout autotune
+{}
+  // No grad fast path, skips all the autograd bookkeeping
+  bool trace_backward = egr::Controller::Instance().HasGrad();
 {}
   // Get Input AutoGradMeta
 {}
@@ -267,7 +270,6 @@ TEST_API {} {}({}) {{
  // Before log info
 {}
 
-  bool trace_backward = egr::Controller::Instance().HasGrad();
   bool require_any_grad = egr::EagerUtils::ComputeRequireGrad({});
 
   // Node Declaration
@@ -352,6 +354,23 @@ TEST_API {} {}({}) {{
 }}
 """
 
+FORWARD_NO_GRAD_FAST_PATH_TEMPLATE = """  if (!trace_backward) {{
+    VLOG(5) << \"Running C++ API without autograd: \" << \"{}\";
+    // Forward API Call
+  {}
+    // Log memory infomation
+  {}
+    // Check NaN and Inf if needed
+  {}
+    // Get Outputs
+{}
+    // Bump Inplace Version if needed
+{}
+    VLOG(4) << \"Finish AD API: {}\";
+    return {};
+  }}
+"""
+
 FORWARD_BODY_BEFORE_API_CALL_TEMPLATE = """  if(require_any_grad) {{
 {}
     // Node Construction
@@ -1722,6 +1741,10 @@ class DygraphForwardFunctionGenerator(DygraphFunctionGeneratorBase):
                     )
                 )
 
+        # The no grad fast path calls the api with the original inputs, not
+        # the pre contiguous ones
+        no_grad_forward_call_str = forward_call_str
+
         # Node Creation Pre-Processing
         if not self.is_forward_only:
             # 1. Get Input AutoGradMeta
@@ -1890,6 +1913,18 @@ class DygraphForwardFunctionGenerator(DygraphFunctionGeneratorBase):
 
         log_str = AFTER_LOG_PRINT_TEMPLATE.format(var_str)
 
+        # No grad fast path
+        no_grad_fast_path_str = FORWARD_NO_GRAD_FAST_PATH_TEMPLATE.format(
+            forward_api_name,
+            no_grad_forward_call_str,
+            log_memory_info_str,
+            check_nan_inf_str,
+            get_outputs_str,
+            bump_inplace_version_str,
+            forward_api_name,
+            returns_str,
+        )
+
         # Generate forward_definition_str and forward_declaration_str
         if self.is_forward_only:
             if len(amp_tensors_vector_list) == 0:
@@ -1929,6 +1964,7 @@ class DygraphForwardFunctionGenerator(DygraphFunctionGeneratorBase):
                 amp_logic_str,
                 type_promotion_logic_str,
                 layout_logic_str,
+                no_grad_fast_path_str,
                 inputs_autograd_meta_str,
                 forward_api_name,
                 before_log_str,
@@ -95,7 +95,7 @@ CONVERT_INPUT_TENSORS_TO_DIST_TENSOR_WITHOUT_SINGLE_TENSOR_TEMPLATE = """
     }}
 """
 
-PARSE_PYTHON_C_ARGS_TEMPLATE = """    PyObject* {}_obj = PyTuple_GET_ITEM(args, {});
+PARSE_PYTHON_C_ARGS_TEMPLATE = """    PyObject* {}_obj = args[{}];
     {} {} = {}({}_obj, \"{}\", {});
 """
 
@@ -108,14 +108,17 @@ RETURN_INPLACE_PYOBJECT_TEMPLATE = """
 """
 
 
+# The functions are METH_FASTCALL, which take the positional args as an array
+# instead of a tuple built by the interpreter for each call.
 PYTHON_C_FUNCTION_TEMPLATE = """
-PyObject * eager_api_{}(PyObject *self, PyObject *args, PyObject *kwargs) {{
+PyObject * eager_api_{}(PyObject *self, PyObject *const *args, Py_ssize_t nargs) {{
   {}
   PyThreadState *tstate = nullptr;
   try {{
     VLOG(6) << "Running Eager Final State API: {}";
 
-    VLOG(8) << "args count: " << (PyTuple_Size(args) / 2);
+    VLOG(8) << "args count: " << nargs;
+{}
     // Get EagerTensors from args
 {}
     // Parse Attributes if needed
@@ -177,7 +180,7 @@ FUNCTION_SET_DEVICE_TEMPLATE = """{}
 FUNCTION_NAME_TEMPLATE = "{}{}{}"
 
 
-PYTHON_C_FUNCTION_REG_TEMPLATE = "  {{\"{}{}\", (PyCFunction)(void(*)(void)) {}eager_api_{}, METH_VARARGS | METH_KEYWORDS, \"C++ interface function for {} in dygraph.\"}},\n"
+PYTHON_C_FUNCTION_REG_TEMPLATE = "  {{\"{}{}\", (PyCFunction)(void(*)(void)) {}eager_api_{}, METH_FASTCALL, \"C++ interface function for {} in dygraph.\"}},\n"
 
 
 PYTHON_C_WRAPPER_TEMPLATE = """
@@ -296,7 +299,11 @@ namespace pybind {{
 """
 
 PYTHON_C_FUNCTION_DECLARE_TEMPLATE = """
-PyObject *eager_api_{name}(PyObject *self, PyObject *args, PyObject *kwargs);
+PyObject *eager_api_{name}(PyObject *self, PyObject *const *args, Py_ssize_t nargs);
+"""
+
+CHECK_ARGS_COUNT_TEMPLATE = """    PADDLE_ENFORCE_GE(nargs, {num_args}, paddle::platform::errors::InvalidArgument(
+        "{name}(): expected {num_args} arguments, but got %d.", nargs));
 """
 
 
@@ -516,10 +523,14 @@ class PythonCSingleFunctionGenerator(FunctionGeneratorBase):
         )
 
         # Generate Python-C Function Definetion
+        check_args_count_str = CHECK_ARGS_COUNT_TEMPLATE.format(
+            num_args=num_args, name=forward_api_name
+        )
         self.python_c_function_str = PYTHON_C_FUNCTION_TEMPLATE.format(
             forward_api_name,
             pythonc_record_event_str,
             forward_api_name,
+            check_args_count_str,
             get_eager_tensor_str,
             parse_attributes_str,
             set_device_str,
@@ -577,6 +588,7 @@ class PythonCSingleFunctionGenerator(FunctionGeneratorBase):
                 inplaced_forward_api_name,
                 pythonc_record_event_str,
                 inplaced_forward_api_name,
+                check_args_count_str,
                 get_eager_tensor_str,
                 parse_attributes_str,
                 set_device_str,
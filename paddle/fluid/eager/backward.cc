@@ -14,12 +14,41 @@
 
 #include "paddle/fluid/eager/backward.h"
 
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+#include "paddle/fluid/eager/amp_cast_cache.h"
 #include "paddle/fluid/eager/general_grad.h"
+#include "paddle/fluid/eager/saved_tensors_offload.h"
 #include "paddle/fluid/memory/stats.h"
+#include "paddle/phi/core/flags.h"
+#include "paddle/phi/core/threadpool.h"
 #include "paddle/phi/kernels/autotune/switch_autotune.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#endif
+
+PHI_DECLARE_int32(eager_backward_num_threads);
 
 namespace egr {
 
+namespace {
+
+// Whether the thread runs the grad nodes of a parallel backward. The backward
+// run inside a grad node, e.g. of a PyLayer, is sequential then, so that it
+// does not wait for the pool it is running on.
+thread_local bool in_parallel_backward = false;
+
+struct ParallelNodeState {
+  std::mutex mutex;
+  std::unique_ptr<GradTensorHolder> input_buffer;
+  int in_degree{0};
+};
+
+}  // namespace
+
 std::unordered_map<GradNodeBase*, int> getInDegreeMap(
     const std::deque<GradNodeBase*>& init_queue) {
   // Calculate in_degree for each node
@@ -102,6 +131,183 @@ void DuplicateCheck(const std::vector<paddle::Tensor>& inputs, bool is_input) {
 
 GeneralGrad* GeneralGrad::general_grad_ = new GeneralGrad();
 
+// Run the grad nodes from the startup nodes in queue on a pool of
+// FLAGS_eager_backward_num_threads threads, a node is run as soon as the grads
+// of all its inputs are accumulated. The accumulation into the input buffer of
+// a node is guarded by the mutex of the node.
+void RunBackwardInParallel(
+    const std::deque<GradNodeBase*>& queue,
+    std::unordered_map<GradNodeBase*, std::unique_ptr<GradTensorHolder>>*
+        node_input_buffers_dict,
+    const std::unordered_map<GradNodeBase*, int>& node_in_degree_map,
+    bool retain_graph,
+    const paddle::platform::Place& place) {
+  static phi::ThreadPool pool(FLAGS_eager_backward_num_threads);
+
+  // all the nodes are added before running, so that the map is only read by
+  // the threads
+  std::unordered_map<GradNodeBase*, ParallelNodeState> node_states;
+  for (auto& item : node_in_degree_map) {
+    node_states[item.first].in_degree = item.second;
+  }
+  for (auto& item : *node_input_buffers_dict) {
+    node_states[item.first].input_buffer = std::move(item.second);
+  }
+  node_input_buffers_dict->clear();
+
+  // the thread local states of the tracer the grad nodes run with
+  auto tracer = egr::Controller::Instance().GetCurrentTracer();
+  bool has_grad = tracer->HasGrad();
+  auto amp_level = tracer->GetAmpLevel();
+  std::string amp_dtype = tracer->GetAmpDtype();
+  bool use_promote = tracer->GetUsePromote();
+
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t num_pending = 0;
+  std::exception_ptr error;
+
+  auto run_node = [&](GradNodeBase* node, std::vector<GradNodeBase*>* ready) {
+    paddle::platform::RecordEvent node_record_event(
+        std::string(node->name()),
+        paddle::platform::TracerEventType::Operator,
+        1);
+    auto& state = node_states.at(node);
+    std::unique_ptr<GradTensorHolder> node_input_buffer;
+    {
+      std::lock_guard<std::mutex> guard(state.mutex);
+      node_input_buffer = std::move(state.input_buffer);
+    }
+    PADDLE_ENFORCE_NOT_NULL(
+        node_input_buffer,
+        paddle::platform::errors::Fatal(
+            "Unable to find next node in the GradTensorHolder \n"
+            "Trying to run Node without configuring its GradTensorHolder."));
+    EnforceGradNodeHasInput(node);
+
+    paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>
+        grad_output_tensors = (*node)(node_input_buffer->Buffers(),
+                                      /*create_graph=*/false,
+                                      /*is_new_grad=*/false);
+    if (!retain_graph) {
+      node->ClearTensorWrappers();
+    }
+    node_input_buffer.reset();
+
+    const paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>&
+        metas = node->OutputMeta();
+    PADDLE_ENFORCE(metas.size() == grad_output_tensors.size() || metas.empty(),
+                   paddle::platform::errors::Fatal(
+                       "Number of edges should be either empty ( for leaf node "
+                       ") or the same as number of output grad tensors, but we "
+                       "got edges size is: %d, grad_output size is: %d",
+                       metas.size(),
+                       grad_output_tensors.size()));
+    for (size_t i = 0; i < metas.size(); i++) {
+      for (size_t j = 0; j < metas[i].size(); j++) {
+        const Edge& edge = metas[i][j].GetEdge();
+        if (!edge.IsInitialized()) {
+          continue;
+        }
+        auto edge_rank = edge.GetEdgeRankInfo();
+        auto* next_node = edge.GetMutableGradNode().get();
+        if (!next_node || grad_output_tensors[i].empty()) {
+          continue;
+        }
+        PADDLE_ENFORCE_LT(
+            j,
+            grad_output_tensors[i].size(),
+            paddle::platform::errors::Fatal(
+                "Rank of grad_output_tensors should be less than "
+                "grad_output_tensors[i].size(), which is: %d. This error may "
+                "indicate autoprune or autograd api error. ",
+                grad_output_tensors.size()));
+
+        auto& next_state = node_states.at(next_node);
+        std::lock_guard<std::mutex> guard(next_state.mutex);
+        if (!next_state.input_buffer) {
+          next_state.input_buffer =
+              std::make_unique<GradTensorHolder>(next_node->InputMeta());
+        }
+        next_state.input_buffer->add(edge_rank.first,
+                                     edge_rank.second,
+                                     grad_output_tensors[i][j],
+                                     /*create_graph=*/false);
+        PADDLE_ENFORCE(
+            --next_state.in_degree >= 0,
+            paddle::platform::errors::Fatal(
+                "Detected in-degree value smaller than zero. For Node: %s"
+                "Node's in-degree cannot be negative.",
+                next_node->name()));
+        if (next_state.in_degree == 0) {
+          ready->push_back(next_node);
+        }
+      }
+    }
+    paddle::memory::LogDeviceMemoryStats(place, std::string(node->name()));
+  };
+
+  std::function<void(GradNodeBase*)> schedule = [&](GradNodeBase* node) {
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      ++num_pending;
+    }
+    pool.RunAndGetException([&, node]() {
+      in_parallel_backward = true;
+      egr::Controller::Instance().SetCurrentTracer(tracer);
+      tracer->SetHasGrad(has_grad);
+      tracer->SetAmpLevel(amp_level);
+      tracer->SetAmpDtype(amp_dtype);
+      tracer->SetUsePromote(use_promote);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+      if (paddle::platform::is_gpu_place(place)) {
+        phi::backends::gpu::SetDeviceId(place.GetDeviceId());
+      }
+#endif
+      std::vector<GradNodeBase*> ready;
+      try {
+        bool failed = false;
+        {
+          std::lock_guard<std::mutex> guard(mutex);
+          failed = error != nullptr;
+        }
+        // the nodes after a failed one are not run
+        if (!failed) {
+          run_node(node, &ready);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        ready.clear();
+      }
+      // the ready nodes are pending before this one is done
+      for (auto* next_node : ready) {
+        schedule(next_node);
+      }
+      std::lock_guard<std::mutex> guard(mutex);
+      if (--num_pending == 0) {
+        done.notify_all();
+      }
+    });
+  };
+
+  std::unordered_set<GradNodeBase*> visited;
+  for (auto* node : queue) {
+    if (visited.insert(node).second && node_states.at(node).in_degree == 0) {
+      schedule(node);
+    }
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&]() { return num_pending == 0; });
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 std::vector<paddle::Tensor> RunBackward(
     const std::vector<paddle::Tensor>& tensors,  // output
     const std::vector<paddle::Tensor>& grad_tensors,
@@ -242,6 +448,21 @@ std::vector<paddle::Tensor> RunBackward(
 
   VLOG(5) << "Startup_ops's size is " << queue.size();
 
+  // the saved tensors offloaded the last are used the first
+  SavedTensorsOffloader::Instance().PrefetchLast();
+
+  if (FLAGS_eager_backward_num_threads > 1 && !in_parallel_backward &&
+      !is_general_grad && !create_graph && force_sequential_nodes_set.empty()) {
+    VLOG(3) << "Run Backward with " << FLAGS_eager_backward_num_threads
+            << " threads";
+    RunBackwardInParallel(queue,
+                          &node_input_buffers_dict,
+                          node_in_degree_map,
+                          retain_graph,
+                          place);
+    queue.clear();
+  }
+
   /* --- Topological Visit --- */
   // 1. Pop queue
   // 2. Run node
@@ -433,6 +654,8 @@ void Backward(const std::vector<paddle::Tensor>& tensors,  // outputs
       "backward", paddle::platform::TracerEventType::UserDefined, 1);
   RunBackward(tensors, grad_tensors, retain_graph);
   egr::Controller::Instance().ClearForceSequentialNodes();
+  // the parameters are to be updated in place by the optimizer
+  egr::AmpCastCache::Instance().Clear();
   phi::autotune::AutoTuneStatus::Instance().Update();
 }
 
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "paddle/fluid/eager/amp_cast_cache.h"
 #include "paddle/fluid/eager/api/generated/eager_generated/forwards/dygraph_functions.h"
 
 namespace egr {
@@ -61,6 +62,24 @@ inline paddle::Tensor Cast(const paddle::Tensor& input,
   }
 }
 
+// Cast input by Cast, or reuse the copy cast before if input is a leaf tensor
+// and FLAGS_eager_amp_cast_cache is set.
+inline paddle::Tensor CachedCast(const paddle::Tensor& input,
+                                 const phi::DataType& dst_dtype,
+                                 const bool trace_backward = true) {
+  if (!AmpCastCache::IsEnabled() || !AmpCastCache::IsCacheable(input)) {
+    return Cast(input, dst_dtype, trace_backward);
+  }
+  bool traced = trace_backward && egr::Controller::Instance().HasGrad();
+  auto& cache = AmpCastCache::Instance();
+  auto casted = cache.Get(input, dst_dtype, traced);
+  if (!casted.initialized()) {
+    casted = Cast(input, dst_dtype, trace_backward);
+    cache.Put(input, dst_dtype, traced, casted);
+  }
+  return casted;
+}
+
 inline std::vector<paddle::Tensor> EagerAmpAutoCasts(
     const std::string& inputs_name,
     const std::vector<paddle::Tensor>& inputs,
@@ -73,7 +92,7 @@ inline std::vector<paddle::Tensor> EagerAmpAutoCasts(
   std::vector<paddle::Tensor> inputs_casted;
   for (auto& input : inputs) {
     if (NeedCast(input, dst_dtype)) {
-      inputs_casted.emplace_back(std::move(Cast(input, dst_dtype)));
+      inputs_casted.emplace_back(CachedCast(input, dst_dtype));
     } else {
       inputs_casted.emplace_back(input);
     }
@@ -109,7 +128,7 @@ inline paddle::Tensor EagerAmpAutoCast(const std::string& input_name,
   }
   if (NeedCast(input, dst_dtype)) {
     VLOG(6) << "Input : " << input.impl() << "NeedCast";
-    return Cast(input, dst_dtype, trace_backward);
+    return CachedCast(input, dst_dtype, trace_backward);
   }
   return input;
 }
@@ -14,10 +14,18 @@
 
 #pragma once
 
+#include <functional>
+#include <string>
+#include <vector>
+
 #include "paddle/fluid/eager/api/generated/eager_generated/forwards/dygraph_functions.h"
 #include "paddle/fluid/eager/eager_layout_transformer.h"
 #include "paddle/fluid/imperative/layout_autotune.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/utils/string/string_helper.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/kernels/autotune/gpu_timer.h"
+#endif
 namespace egr {
 inline bool NeedTransLayout(
     const paddle::small_vector<std::vector<paddle::Tensor>,
@@ -33,6 +41,111 @@ inline bool NeedTransLayout(
   return false;
 }
 
+// While the layout autotune by cost measures the first step, count the 4-D
+// inputs of the lightly layout sensitive op, which would be transposed back
+// to the default layout if the layout were tuned.
+inline void CountTransposeBack(
+    const paddle::small_vector<std::vector<paddle::Tensor>,
+                               kSlotSmallVectorSize>& tensors_vector) {
+  auto& tuner = paddle::imperative::LayoutAutoTune::Instance();
+  if (!tuner.IsMeasuring()) {
+    return;
+  }
+  for (const auto& tensors : tensors_vector) {
+    for (const auto& tensor : tensors) {
+      if (tensor.initialized() && tensor.shape().size() == 4) {
+        tuner.AddTransposeBack(tensor.numel());
+      }
+    }
+  }
+}
+
+// Time conv2d on input in the layout of data_format and in the other one, and
+// the transpose of input to the other layout, for the layout autotune by cost.
+// The kernels are run by the APIs, so the algorithms searched by the kernel
+// autotune are cached and shared with the run of the model.
+inline void MeasureConv2dLayoutCost(const paddle::Tensor& input,
+                                    const paddle::Tensor& filter,
+                                    const std::vector<int>& strides,
+                                    const std::vector<int>& paddings,
+                                    const std::string& padding_algorithm,
+                                    const std::vector<int>& dilations,
+                                    int groups,
+                                    const std::string& data_format) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (!input.initialized() || !input.is_gpu() || input.shape().size() != 4 ||
+      (data_format != "NCHW" && data_format != "NHWC")) {
+    return;
+  }
+  auto layout = common::StringToDataLayout(data_format);
+  auto other_layout =
+      layout == phi::DataLayout::NCHW ? phi::DataLayout::NHWC
+                                      : phi::DataLayout::NCHW;
+  std::string key = phi::DataTypeToString(input.dtype()) +
+                    input.dims().to_str() + filter.dims().to_str() +
+                    paddle::string::join_strings(strides, ',') + ";" +
+                    paddle::string::join_strings(paddings, ',') + ";" +
+                    padding_algorithm + ";" +
+                    paddle::string::join_strings(dilations, ',') + ";" +
+                    std::to_string(groups) + data_format;
+  auto& tuner = paddle::imperative::LayoutAutoTune::Instance();
+  if (!tuner.BeginMeasure(key, layout)) {
+    return;
+  }
+
+  constexpr int kRepeat = 3;
+  auto stream = static_cast<phi::GPUContext*>(
+                    phi::DeviceContextPool::Instance().Get(input.place()))
+                    ->stream();
+  phi::GpuTimer timer;
+  auto time = [&](const std::function<void()>& run) {
+    // warm up, e.g. search the algorithms of conv2d
+    run();
+    timer.Start(stream);
+    for (int i = 0; i < kRepeat; ++i) {
+      run();
+    }
+    timer.Stop(stream);
+    return static_cast<double>(timer.ElapsedTime()) / kRepeat;
+  };
+
+  std::vector<int> perm = other_layout == phi::DataLayout::NHWC
+                              ? std::vector<int>{0, 2, 3, 1}
+                              : std::vector<int>{0, 3, 1, 2};
+  paddle::Tensor other_input;
+  paddle::imperative::LayoutCost cost;
+  cost.count = 1;
+  cost.transpose_numel = input.numel();
+  cost.transpose_ms = time(
+      [&]() { other_input = paddle::experimental::transpose(input, perm); });
+  cost.default_ms = time([&]() {
+    paddle::experimental::conv2d(input,
+                                 filter,
+                                 strides,
+                                 paddings,
+                                 padding_algorithm,
+                                 dilations,
+                                 groups,
+                                 data_format);
+  });
+  cost.desired_ms = time([&]() {
+    paddle::experimental::conv2d(other_input,
+                                 filter,
+                                 strides,
+                                 paddings,
+                                 padding_algorithm,
+                                 dilations,
+                                 groups,
+                                 common::DataLayoutToString(other_layout));
+  });
+  VLOG(4) << "LayoutAutoTune measured conv2d " << key << ": "
+          << cost.default_ms << " ms in " << data_format << ", "
+          << cost.desired_ms << " ms in " << other_layout << ", transpose "
+          << cost.transpose_ms << " ms";
+  tuner.AddMeasuredCost("conv2d", cost);
+#endif
+}
+
 inline std::shared_ptr<EagerLayoutTransformer> EagerLayoutAutotune(
     const std::string& op_name,
     const paddle::small_vector<std::vector<paddle::Tensor>,
@@ -69,6 +182,7 @@ inline std::shared_ptr<EagerLayoutTransformer> EagerLayoutAutotune(
   // For lightly op like reduce
   if ((DesiredLayout() == phi::DataLayout::UNDEFINED)) {
     VLOG(4) << "LayoutAutotune was unstarted. Current op :" << op_name;
+    CountTransposeBack(tensors_vector);
     return std::make_shared<EagerLayoutTransformer>(
         op_name, tensors_vector, tensors_vector[0][0].layout());
   }
@@ -95,6 +209,7 @@ inline std::shared_ptr<EagerLayoutTransformer> EagerLayoutAutotune(
   // for pad
   if ((DesiredLayout() == phi::DataLayout::UNDEFINED)) {
     VLOG(4) << "LayoutAutotune was unstarted. Current op :" << op_name;
+    CountTransposeBack(tensors_vector);
     return std::make_shared<EagerLayoutTransformer>(
         op_name, tensors_vector, tensors_vector[0][0].layout());
   }
@@ -114,6 +229,12 @@ inline std::shared_ptr<EagerLayoutTransformer> EagerLayoutAutotune(
     if (op_name != "conv2d") {
       VLOG(4) << "LayoutAutotune was unstarted. Current op :" << op_name;
       return transposer;
+    } else if (paddle::imperative::LayoutAutoTune::Instance().TuneByCost()) {
+      // The desired layout is chosen by MeasureConv2dLayoutCost at the end of
+      // the first step, if the other layout costs less.
+      VLOG(4) << "LayoutAutotune is measuring the costs. Current op :"
+              << op_name;
+      return transposer;
     } else {
       auto data_type = tensors_vector[0][0].dtype();
       bool is_tune_fp32 =
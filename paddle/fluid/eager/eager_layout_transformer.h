@@ -19,13 +19,16 @@
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/tensor_utils.h"
 namespace egr {
-inline paddle::Tensor EagerTraceTransposeOp(const phi::DataLayout layout,
+inline paddle::Tensor EagerTraceTransposeOp(const std::string& op_name,
+                                            const phi::DataLayout layout,
                                             const paddle::Tensor& in) {
   VLOG(4) << "AutoTune Transpose from " << in.layout() << " to " << layout
           << ", tensor's dim size is " << in.shape().size();
   if (in.shape().size() != 4) {
     return in;
   }
+  paddle::imperative::LayoutAutoTune::Instance().RecordTranspose(op_name,
+                                                                 in.numel());
   std::vector<int> axis;
   if (layout == phi::DataLayout::NHWC) {
     axis = {0, 2, 3, 1};
@@ -131,7 +134,7 @@ class EagerLayoutTransformer {
         !(final_layout_ == Layout::UNDEFINED || final_layout_ == in.layout());
     // This is for Agnostic op when layout is differnet
     if (need_trans) {
-      auto out_tensor = EagerTraceTransposeOp(final_layout_, in);
+      auto out_tensor = EagerTraceTransposeOp(op_name_, final_layout_, in);
       phi::DenseTensorUtils::GetMutableMeta(
           static_cast<phi::DenseTensor*>(out_tensor.impl().get()))
           ->layout = final_layout_;
@@ -206,7 +209,7 @@ class EagerHeavilyLayoutSensitiveOpTransformer : public EagerLayoutTransformer {
   paddle::Tensor TransInTensor(const std::string& in_name,
                                const paddle::Tensor& in) {
     if (heavily_input_.count(in_name) != 0 && in.layout() != desired_layout_) {
-      auto out_tensor = EagerTraceTransposeOp(desired_layout_, in);
+      auto out_tensor = EagerTraceTransposeOp(op_name_, desired_layout_, in);
       return out_tensor;
     }
     return in;
@@ -246,6 +249,7 @@ class EagerLightlyLayoutSensitiveOpTransformer : public EagerLayoutTransformer {
   explicit EagerLightlyLayoutSensitiveOpTransformer(
       const std::string& op_name) {
     VLOG(4) << "Lightly op : " << op_name;
+    op_name_ = op_name;
     auto desired_layout = DesiredLayout();
     final_layout_ = common::DataLayoutToString(desired_layout);
   }
@@ -256,7 +260,8 @@ class EagerLightlyLayoutSensitiveOpTransformer : public EagerLayoutTransformer {
     std::string input_layout = common::DataLayoutToString(in.layout());
     auto default_layout = DefaultLayout();
     if (final_layout_ == input_layout && in.shape().size() == 4) {
-      auto out_tensor = EagerTraceTransposeOp(phi::DataLayout::UNDEFINED, in);
+      auto out_tensor =
+          EagerTraceTransposeOp(op_name_, phi::DataLayout::UNDEFINED, in);
       phi::DenseTensorUtils::GetMutableMeta(
           static_cast<phi::DenseTensor*>(out_tensor.impl().get()))
           ->layout = default_layout;
@@ -274,8 +279,8 @@ class EagerLightlyLayoutSensitiveOpTransformer : public EagerLayoutTransformer {
     for (size_t i = 0; i < in.size(); i++) {
       auto in_tensor = in[i];
       if (in_tensor.layout() == desired_layout) {
-        auto out_tensor =
-            EagerTraceTransposeOp(phi::DataLayout::UNDEFINED, in_tensor);
+        auto out_tensor = EagerTraceTransposeOp(
+            op_name_, phi::DataLayout::UNDEFINED, in_tensor);
         phi::DenseTensorUtils::GetMutableMeta(
             static_cast<phi::DenseTensor*>(out_tensor.impl().get()))
             ->layout = default_layout;
@@ -18,14 +18,84 @@
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/var_type.h"
 #include "paddle/fluid/imperative/gradient_accumulator.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/phi/core/compat/convert_utils.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
+#include "paddle/phi/core/kernel_factory.h"
 #include "paddle/phi/core/sparse_coo_tensor.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 
 namespace egr {
 
+namespace {
+
+// The grads deferred at most for a buffer tensor, which bounds the memory
+// held by them.
+constexpr size_t kMaxPendingGrads = 8;
+
+// Whether t can be added to buffer_tensor later by the add_n kernel.
+bool CanDeferAdd(const paddle::Tensor& t, const paddle::Tensor& buffer_tensor) {
+  if (!t.is_dense_tensor() || !buffer_tensor.is_dense_tensor() ||
+      !(t.is_cpu() || t.is_gpu())) {
+    return false;
+  }
+  auto* x = static_cast<phi::DenseTensor*>(t.impl().get());
+  auto* out = static_cast<phi::DenseTensor*>(buffer_tensor.impl().get());
+  return x->dtype() == out->dtype() && x->place() == out->place() &&
+         x->dims() == out->dims() && x->meta().is_contiguous() &&
+         out->meta().is_contiguous();
+}
+
+// Add grads to buffer_tensor in place by one add_n kernel.
+void AddGrads(const std::vector<paddle::Tensor>& grads,
+              paddle::Tensor* buffer_tensor) {
+  auto* out = static_cast<phi::DenseTensor*>(buffer_tensor->impl().get());
+  phi::KernelKey kernel_key(phi::TransToPhiBackend(out->place()),
+                            phi::DataLayout::ALL_LAYOUT,
+                            out->dtype());
+  auto kernel_result = phi::KernelFactory::Instance().SelectKernelOrThrowError(
+      "add_n", kernel_key);
+  if (kernel_result.has_fallback_cpu) {
+    for (auto& grad : grads) {
+      paddle::imperative::TensorAdd<paddle::Tensor>(grad, buffer_tensor);
+    }
+    return;
+  }
+  // the add_n kernel adds to x[0] in place if it shares the holder of out
+  std::vector<const phi::TensorBase*> inputs{out};
+  for (auto& grad : grads) {
+    inputs.push_back(grad.impl().get());
+  }
+  auto* dev_ctx =
+      paddle::platform::DeviceContextPool::Instance().Get(out->place());
+  using kernel_signature = void (*)(const phi::DeviceContext&,
+                                    const std::vector<const phi::TensorBase*>&,
+                                    phi::DenseTensor*);
+  auto* kernel_fn =
+      kernel_result.kernel.GetVariadicKernelFn<kernel_signature>();
+  (*kernel_fn)(*dev_ctx, inputs, out);
+}
+
+}  // namespace
+
+void GradTensorHolder::SumPendingGrads() {
+  for (auto& item : pending_grads_) {
+    AddGrads(item.second, &buffer_[item.first.first][item.first.second]);
+  }
+  pending_grads_.clear();
+}
+
+void GradTensorHolder::SumPendingGrads(size_t slot_id, size_t rank) {
+  auto it = pending_grads_.find({slot_id, rank});
+  if (it != pending_grads_.end()) {
+    AddGrads(it->second, &buffer_[slot_id][rank]);
+    pending_grads_.erase(it);
+  }
+}
+
 void GradTensorHolder::SetBufferSlotRankZeros(size_t slot_id, size_t rank) {
+  pending_grads_.erase({slot_id, rank});
   // Set not grad var to zero and set stop gradient as default value: true
   buffer_[slot_id][rank] =
       paddle::experimental::zeros_like(buffer_[slot_id][rank]);
@@ -56,6 +126,7 @@ void GradTensorHolder::CopyValueFromTensor(size_t slot_id,
           slot_id,
           buffer_[slot_id].size(),
           rank));
+  SumPendingGrads(slot_id, rank);
   if (!fill_one) {
     paddle::Tensor& buffer_tensor = buffer_[slot_id][rank];
     if ((!buffer_tensor.defined() || !buffer_tensor.initialized())) {
@@ -169,6 +240,18 @@ void GradTensorHolder::add(size_t slot_id,
                           "and make sure it creates grads.",
                           t.name()));
 
+    if (!create_graph && CanDeferAdd(t, buffer_tensor)) {
+      // Sum the grads of the buffer tensor by one kernel when it is used,
+      // instead of one kernel for every grad
+      auto& pending_grads = pending_grads_[{slot_id, rank}];
+      pending_grads.push_back(t);
+      if (pending_grads.size() >= kMaxPendingGrads) {
+        SumPendingGrads(slot_id, rank);
+      }
+      return;
+    }
+    SumPendingGrads(slot_id, rank);
+
     if (t.is_dense_tensor()) {
       if (buffer_tensor.is_dense_tensor()) {
         if (create_graph || t.is_custom_device()) {
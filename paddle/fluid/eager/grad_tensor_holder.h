@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <map>
+#include <utility>
+
 #include "paddle/fluid/eager/grad_node_info.h"
 
 namespace egr {
@@ -56,19 +59,30 @@ class GradTensorHolder {
                            bool fill_one = false);
 
   const std::vector<paddle::Tensor>& operator[](const size_t& pos) {
+    SumPendingGrads();
     return buffer_[pos];
   }
 
   paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>&
   Buffers() {
+    SumPendingGrads();
     return buffer_;
   }
 
   void SetBufferSlotRankZeros(size_t slot_id, size_t rank);
 
  private:
+  // Sum the grads deferred into the buffer, by one add_n kernel for every
+  // buffer tensor.
+  void SumPendingGrads();
+  void SumPendingGrads(size_t slot_id, size_t rank);
+
   paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>
       buffer_;
+  // The dense grads added to the dense buffer tensor of (slot_id, rank) and
+  // not summed into it yet.
+  std::map<std::pair<size_t, size_t>, std::vector<paddle::Tensor>>
+      pending_grads_;
 };
 
 }  // namespace egr
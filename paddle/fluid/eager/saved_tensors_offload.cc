@@ -0,0 +1,282 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/eager/saved_tensors_offload.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "glog/logging.h"
+#include "paddle/fluid/platform/enforce.h"
+#if defined(PADDLE_WITH_CUDA)
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/device_context.h"
+#endif
+
+namespace egr {
+
+namespace {
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+#if defined(PADDLE_WITH_CUDA)
+cudaStream_t ComputeStream(const phi::Place& place) {
+  return static_cast<phi::GPUContext*>(
+             paddle::platform::DeviceContextPool::Instance().Get(place))
+      ->stream();
+}
+#endif
+
+}  // namespace
+
+#if defined(PADDLE_WITH_CUDA)
+OffloadedTensor::OffloadedTensor(
+    const phi::DenseTensor& tensor,
+    uint64_t id,
+    std::shared_ptr<paddle::platform::CudaStreamObject> stream)
+    : id_(id),
+      size_(tensor.numel() * phi::SizeOf(tensor.dtype())),
+      place_(tensor.place()),
+      stream_(std::move(stream)) {
+  int device = place_.GetDeviceId();
+  auto& event_pool = paddle::platform::CudaEventResourcePool::Instance();
+  offload_event_ = event_pool.New(device);
+  reload_event_ = event_pool.New(device);
+  host_ = paddle::memory::AllocShared(paddle::platform::CUDAPinnedPlace(),
+                                      size_);
+
+  // copy the data after it is written by the kernels on the compute stream
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventRecord(offload_event_.get(), ComputeStream(place_)));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaStreamWaitEvent(stream_.get(), offload_event_.get(), 0));
+  paddle::memory::Copy(paddle::platform::CUDAPinnedPlace(),
+                       host_->ptr(),
+                       phi::GPUPlace(device),
+                       tensor.data(),
+                       size_,
+                       stream_.get());
+  // the memory of tensor is not reused until the copy is done
+  paddle::memory::RecordStream(tensor.Holder(), stream_.get());
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventRecord(offload_event_.get(), stream_.get()));
+}
+#endif
+
+OffloadedTensor::~OffloadedTensor() {
+#if defined(PADDLE_WITH_CUDA)
+  if (offload_event_) {
+    cudaEventSynchronize(offload_event_.get());
+  }
+  if (device_) {
+    cudaEventSynchronize(reload_event_.get());
+  }
+#endif
+  SavedTensorsOffloader::Instance().OnRelease(*this);
+}
+
+void OffloadedTensor::Prefetch() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  PrefetchLocked();
+}
+
+void OffloadedTensor::PrefetchLocked() {
+#if defined(PADDLE_WITH_CUDA)
+  if (device_) {
+    return;
+  }
+  device_ = paddle::memory::AllocShared(place_, size_);
+  paddle::memory::Copy(phi::GPUPlace(place_.GetDeviceId()),
+                       device_->ptr(),
+                       paddle::platform::CUDAPinnedPlace(),
+                       host_->ptr(),
+                       size_,
+                       stream_.get());
+  paddle::memory::RecordStream(device_, stream_.get());
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventRecord(reload_event_.get(), stream_.get()));
+#endif
+}
+
+std::shared_ptr<phi::Allocation> OffloadedTensor::Reload() {
+#if defined(PADDLE_WITH_CUDA)
+  auto start = std::chrono::steady_clock::now();
+  bool prefetched = false;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (reloaded_) {
+      return device_;
+    }
+    prefetched = device_ != nullptr;
+    PrefetchLocked();
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaStreamWaitEvent(ComputeStream(place_), reload_event_.get(), 0));
+    reloaded_ = true;
+  }
+  SavedTensorsOffloader::Instance().OnReload(
+      *this, prefetched, ElapsedMs(start));
+  return device_;
+#else
+  PADDLE_THROW(paddle::platform::errors::Unavailable(
+      "Offloading the saved tensors requires Paddle compiled with CUDA."));
+#endif
+}
+
+SavedTensorsOffloader& SavedTensorsOffloader::Instance() {
+  // not destructed, since the saved tensors may be released at exit
+  static auto* instance = new SavedTensorsOffloader();
+  return *instance;
+}
+
+void SavedTensorsOffloader::Enable(int64_t min_bytes, int prefetch_depth) {
+  PADDLE_ENFORCE_GE(
+      prefetch_depth,
+      0,
+      paddle::platform::errors::InvalidArgument(
+          "The prefetch depth of offloading the saved tensors should be "
+          "non-negative, but received %d.",
+          prefetch_depth));
+  configs_.push_back({min_bytes, prefetch_depth});
+  prefetch_depth_ = prefetch_depth;
+}
+
+void SavedTensorsOffloader::Disable() {
+  PADDLE_ENFORCE_EQ(configs_.empty(),
+                    false,
+                    paddle::platform::errors::PreconditionNotMet(
+                        "Offloading the saved tensors is not enabled."));
+  configs_.pop_back();
+}
+
+std::shared_ptr<OffloadedTensor> SavedTensorsOffloader::Offload(
+    const phi::DenseTensor& tensor) {
+#if defined(PADDLE_WITH_CUDA)
+  if (configs_.empty() || !tensor.initialized() ||
+      !paddle::platform::is_gpu_place(tensor.place()) ||
+      !tensor.meta().is_contiguous()) {
+    return nullptr;
+  }
+  int64_t size = tensor.numel() * phi::SizeOf(tensor.dtype());
+  if (size == 0 || size < configs_.back().min_bytes) {
+    return nullptr;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  uint64_t id = 0;
+  std::shared_ptr<paddle::platform::CudaStreamObject> stream;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    id = next_id_++;
+    int device = tensor.place().GetDeviceId();
+    auto& device_stream = streams_[device];
+    if (!device_stream) {
+      device_stream =
+          paddle::platform::CudaStreamResourcePool::Instance().New(device);
+    }
+    stream = device_stream;
+  }
+  auto offloaded = std::make_shared<OffloadedTensor>(tensor, id, stream);
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  pending_.emplace(id, offloaded);
+  stats_.offloaded_tensors += 1;
+  stats_.offloaded_bytes += size;
+  stats_.host_bytes += size;
+  stats_.peak_host_bytes = std::max(stats_.peak_host_bytes, stats_.host_bytes);
+  stats_.offload_ms += ElapsedMs(start);
+  VLOG(6) << "Offload the saved tensor " << id << " of " << size
+          << " bytes to the host";
+  return offloaded;
+#else
+  return nullptr;
+#endif
+}
+
+void SavedTensorsOffloader::PrefetchLast() {
+  std::vector<std::shared_ptr<OffloadedTensor>> tensors;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (auto it = pending_.rbegin();
+         it != pending_.rend() &&
+         static_cast<int>(tensors.size()) < prefetch_depth_;
+         ++it) {
+      if (auto tensor = it->second.lock()) {
+        tensors.push_back(tensor);
+      }
+    }
+  }
+  for (auto& tensor : tensors) {
+    tensor->Prefetch();
+  }
+}
+
+void SavedTensorsOffloader::OnReload(const OffloadedTensor& tensor,
+                                     bool prefetched,
+                                     double ms) {
+  // prefetch the tensors saved before, which are used by backward next
+  std::vector<std::shared_ptr<OffloadedTensor>> tensors;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = pending_.find(tensor.id());
+    if (it != pending_.end()) {
+      stats_.host_bytes -= static_cast<int64_t>(tensor.size());
+      auto prev = pending_.erase(it);
+      while (prev != pending_.begin() &&
+             static_cast<int>(tensors.size()) < prefetch_depth_) {
+        --prev;
+        if (auto prev_tensor = prev->second.lock()) {
+          tensors.push_back(prev_tensor);
+        }
+      }
+    }
+    if (prefetched) {
+      stats_.prefetched_bytes += static_cast<int64_t>(tensor.size());
+    } else {
+      stats_.reloaded_on_demand_bytes += static_cast<int64_t>(tensor.size());
+    }
+    stats_.reload_ms += ms;
+  }
+  for (auto& prev_tensor : tensors) {
+    prev_tensor->Prefetch();
+  }
+}
+
+void SavedTensorsOffloader::OnRelease(const OffloadedTensor& tensor) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = pending_.find(tensor.id());
+  if (it != pending_.end()) {
+    stats_.host_bytes -= static_cast<int64_t>(tensor.size());
+    pending_.erase(it);
+  }
+}
+
+SavedTensorsOffloadStats SavedTensorsOffloader::GetStats() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return stats_;
+}
+
+void SavedTensorsOffloader::ResetStats() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  int64_t host_bytes = stats_.host_bytes;
+  stats_ = SavedTensorsOffloadStats();
+  stats_.host_bytes = host_bytes;
+  stats_.peak_host_bytes = host_bytes;
+}
+
+}  // namespace egr
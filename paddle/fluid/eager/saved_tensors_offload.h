@@ -0,0 +1,146 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "paddle/phi/core/dense_tensor.h"
+#if defined(PADDLE_WITH_CUDA)
+#include "paddle/fluid/platform/device/gpu/gpu_resource_pool.h"
+#endif
+
+namespace egr {
+
+struct SavedTensorsOffloadStats {
+  int64_t offloaded_tensors{0};
+  int64_t offloaded_bytes{0};
+  // the bytes offloaded and not reloaded yet, and the peak of them
+  int64_t host_bytes{0};
+  int64_t peak_host_bytes{0};
+  // the bytes reloaded ahead of use, or on use since they are not prefetched
+  int64_t prefetched_bytes{0};
+  int64_t reloaded_on_demand_bytes{0};
+  // the host time spent to launch the copies
+  double offload_ms{0};
+  double reload_ms{0};
+};
+
+/**
+ * OffloadedTensor holds the data of a saved tensor offloaded to the pinned
+ * host memory. The copies between the device and the host run on a side
+ * stream of the device, and are ordered after the kernels on the compute
+ * stream by events.
+ * **/
+class OffloadedTensor {
+ public:
+#if defined(PADDLE_WITH_CUDA)
+  OffloadedTensor(const phi::DenseTensor& tensor,
+                  uint64_t id,
+                  std::shared_ptr<paddle::platform::CudaStreamObject> stream);
+#endif
+
+  // Wait for the copies launched, for the memory they use to be released.
+  ~OffloadedTensor();
+
+  // Launch the copy to the device, unless it was launched already.
+  void Prefetch();
+
+  // Return the holder of the data on the device, which is ready for the
+  // kernels launched on the compute stream after this call.
+  std::shared_ptr<phi::Allocation> Reload();
+
+  uint64_t id() const { return id_; }
+
+  size_t size() const { return size_; }
+
+ private:
+  void PrefetchLocked();
+
+  uint64_t id_{0};
+  size_t size_{0};
+  phi::Place place_;
+#if defined(PADDLE_WITH_CUDA)
+  std::shared_ptr<phi::Allocation> host_;
+  std::shared_ptr<phi::Allocation> device_;
+  std::shared_ptr<paddle::platform::CudaStreamObject> stream_;
+  std::shared_ptr<paddle::platform::CudaEventObject> offload_event_;
+  std::shared_ptr<paddle::platform::CudaEventObject> reload_event_;
+#endif
+  bool reloaded_{false};
+  std::mutex mutex_;
+};
+
+/**
+ * SavedTensorsOffloader offloads the tensors saved by TensorWrapper for
+ * backward to the pinned host memory, while it is enabled, e.g. in the
+ * forward of the layers selected by paddle.autograd.saved_tensors_offload.
+ *
+ * The saved tensors are used by backward in about the reverse order they are
+ * saved in forward, so when a tensor is reloaded, the tensors saved before it
+ * are prefetched, and RunBackward prefetches the last saved ones.
+ * **/
+class SavedTensorsOffloader {
+ public:
+  static SavedTensorsOffloader& Instance();
+
+  // Enable offloading the saved tensors on GPU of at least min_bytes, until
+  // the matching Disable. The calls may be nested.
+  void Enable(int64_t min_bytes, int prefetch_depth);
+  void Disable();
+
+  bool IsEnabled() const { return !configs_.empty(); }
+
+  // Return nullptr if tensor is not to be offloaded, e.g. it is not on GPU
+  // or smaller than min_bytes.
+  std::shared_ptr<OffloadedTensor> Offload(const phi::DenseTensor& tensor);
+
+  // Prefetch the prefetch_depth tensors saved the last.
+  void PrefetchLast();
+
+  SavedTensorsOffloadStats GetStats();
+  void ResetStats();
+
+ private:
+  friend class OffloadedTensor;
+
+  struct Config {
+    int64_t min_bytes;
+    int prefetch_depth;
+  };
+
+  SavedTensorsOffloader() = default;
+
+  void OnReload(const OffloadedTensor& tensor, bool prefetched, double ms);
+  void OnRelease(const OffloadedTensor& tensor);
+
+  std::vector<Config> configs_;
+  // the prefetch depth of the last enabled, for the backward after forward
+  int prefetch_depth_{2};
+
+  std::mutex mutex_;
+  uint64_t next_id_{0};
+#if defined(PADDLE_WITH_CUDA)
+  std::map<int, std::shared_ptr<paddle::platform::CudaStreamObject>> streams_;
+#endif
+  // the offloaded tensors not reloaded yet, in the order they are saved
+  std::map<uint64_t, std::weak_ptr<OffloadedTensor>> pending_;
+  SavedTensorsOffloadStats stats_;
+};
+
+}  // namespace egr
@@ -27,6 +27,7 @@
 #pragma once
 #include "paddle/fluid/eager/autograd_meta.h"
 #include "paddle/fluid/eager/grad_node_info.h"
+#include "paddle/fluid/eager/saved_tensors_offload.h"
 #include "paddle/fluid/eager/utils.h"
 #include "paddle/phi/api/lib/utils/allocator.h"
 #ifndef PADDLE_NO_PYTHON
@@ -89,6 +90,16 @@ class TensorWrapper {
         PADDLE_THROW(paddle::platform::errors::Fatal(
             "Unrecognized tensor type for no_need_buffer feature"));
       }
+    } else if ((offloaded_ = Offload(tensor))) {
+      // Only Copy Meta, the data is reloaded from the host in recover
+      phi::DenseTensor* dense_tensor =
+          static_cast<phi::DenseTensor*>(tensor.impl().get());
+      phi::DenseTensorMeta meta = dense_tensor->meta();
+      meta.offset = 0;
+      auto offloaded_tensor = std::make_shared<phi::DenseTensor>(
+          std::make_shared<phi::Allocation>(nullptr, 0, tensor.place()), meta);
+      offloaded_tensor->ShareInplaceVersionCounterWith(*dense_tensor);
+      intermidiate_tensor_.set_impl(offloaded_tensor);
     } else {
 #ifndef PADDLE_NO_PYTHON
       if (egr::SavedTensorsHooks::GetInstance().IsEnable() &&
@@ -148,6 +159,7 @@ class TensorWrapper {
     intermidiate_tensor_ = other.intermidiate_tensor_;
     weak_grad_node_ = other.weak_grad_node_;
     inplace_version_snapshot_ = other.inplace_version_snapshot_;
+    offloaded_ = other.offloaded_;
     packed_value_ = other.packed_value_;
     unpack_hook_ = other.unpack_hook_;
     if (packed_value_) {
@@ -160,6 +172,7 @@ class TensorWrapper {
     intermidiate_tensor_ = other.intermidiate_tensor_;
     weak_grad_node_ = other.weak_grad_node_;
     inplace_version_snapshot_ = other.inplace_version_snapshot_;
+    offloaded_ = other.offloaded_;
     packed_value_ = other.packed_value_;
     unpack_hook_ = other.unpack_hook_;
     if (packed_value_) {
@@ -176,6 +189,10 @@ class TensorWrapper {
       VLOG(6) << "Return NULL tensor Here. ";
       return paddle::Tensor();
     }
+    if (offloaded_) {
+      static_cast<phi::DenseTensor*>(intermidiate_tensor_.impl().get())
+          ->ResetHolder(offloaded_->Reload());
+    }
 #ifndef PADDLE_NO_PYTHON
     if (packed_value_ && unpack_hook_) {
       auto tensor_unpacked = (*unpack_hook_)(packed_value_);
@@ -223,9 +240,30 @@ class TensorWrapper {
 
   paddle::Tensor get_intermidiate_tensor() { return intermidiate_tensor_; }
 
-  void clear() { intermidiate_tensor_.reset(); }
+  void clear() {
+    intermidiate_tensor_.reset();
+    offloaded_.reset();
+  }
 
  private:
+  static std::shared_ptr<OffloadedTensor> Offload(
+      const paddle::Tensor& tensor) {
+    // the leaf tensors, e.g. the parameters, are held out of the graph, so
+    // offloading them saves no memory
+    if (!SavedTensorsOffloader::Instance().IsEnabled() ||
+        !tensor.is_dense_tensor() || EagerUtils::IsLeafTensor(tensor)) {
+      return nullptr;
+    }
+#ifndef PADDLE_NO_PYTHON
+    // the saved tensors hooks take precedence
+    if (egr::SavedTensorsHooks::GetInstance().IsEnable()) {
+      return nullptr;
+    }
+#endif
+    return SavedTensorsOffloader::Instance().Offload(
+        *static_cast<phi::DenseTensor*>(tensor.impl().get()));
+  }
+
   void check_inplace_version() {
     if (no_need_buffer_) {
       VLOG(7) << "There's no need to check inplace_version because "
@@ -277,6 +315,7 @@ class TensorWrapper {
   paddle::Tensor intermidiate_tensor_;
   std::weak_ptr<egr::GradNodeBase> weak_grad_node_;
   uint32_t inplace_version_snapshot_ = 0;
+  std::shared_ptr<OffloadedTensor> offloaded_;
 #ifndef PADDLE_NO_PYTHON
   std::shared_ptr<egr::PyObjectHolderBase> packed_value_;
   std::shared_ptr<egr::UnPackHookBase> unpack_hook_;
@@ -0,0 +1,343 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/async_checkpointer.h"
+
+#include <cstring>
+#include <functional>
+#include <set>
+#include <sstream>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/combined_params_saver.h"
+#include "paddle/fluid/framework/io/fs.h"
+#include "paddle/fluid/framework/lod_tensor.h"
+#include "paddle/fluid/platform/enforce.h"
+#if defined(PADDLE_WITH_CUDA)
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/device_context.h"
+#endif
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+#if defined(PADDLE_WITH_CUDA)
+cudaStream_t ComputeStream(const phi::Place& place) {
+  return static_cast<phi::GPUContext*>(
+             platform::DeviceContextPool::Instance().Get(place))
+      ->stream();
+}
+#endif
+
+void WriteAll(FILE* fp,
+              const void* data,
+              size_t size,
+              const std::string& path) {
+  PADDLE_ENFORCE_EQ(
+      fwrite(data, 1, size, fp),
+      size,
+      platform::errors::Unavailable("Write the checkpoint %s failed: %s.",
+                                    path,
+                                    strerror(errno)));
+}
+
+// Write the file through a temporary one moved to path once it is complete,
+// so that a file at path is never partially written.
+void WriteFile(const std::string& path,
+               const std::function<void(FILE*, const std::string&)>& write) {
+  std::string tmp_path = path + ".tmp";
+  int err_no = 0;
+  {
+    std::shared_ptr<FILE> fp = fs_open_write(tmp_path, &err_no, "");
+    PADDLE_ENFORCE_NOT_NULL(
+        fp,
+        platform::errors::Unavailable("Cannot open %s to save the checkpoint.",
+                                      tmp_path));
+    write(fp.get(), tmp_path);
+    PADDLE_ENFORCE_EQ(fflush(fp.get()),
+                      0,
+                      platform::errors::Unavailable(
+                          "Write the checkpoint %s failed: %s.",
+                          tmp_path,
+                          strerror(errno)));
+  }
+  PADDLE_ENFORCE_EQ(err_no,
+                    0,
+                    platform::errors::Unavailable(
+                        "Write the checkpoint %s failed with error %d.",
+                        tmp_path,
+                        err_no));
+  if (fs_exists(path)) {
+    fs_remove(path);
+  }
+  fs_mv(tmp_path, path);
+}
+
+std::string ReadFile(const std::string& path) {
+  int err_no = 0;
+  std::string data;
+  {
+    std::shared_ptr<FILE> fp = fs_open_read(path, &err_no, "");
+    PADDLE_ENFORCE_NOT_NULL(
+        fp,
+        platform::errors::Unavailable("Cannot open the checkpoint %s.", path));
+    char buf[1 << 16];
+    size_t n = 0;
+    while ((n = fread(buf, 1, sizeof(buf), fp.get())) > 0) {
+      data.append(buf, n);
+    }
+  }
+  PADDLE_ENFORCE_EQ(err_no,
+                    0,
+                    platform::errors::Unavailable(
+                        "Read the checkpoint %s failed with error %d.",
+                        path,
+                        err_no));
+  return data;
+}
+
+}  // namespace
+
+AsyncCheckpointer::AsyncCheckpointer()
+    : writer_([this] { WriteSnapshots(); }) {}
+
+AsyncCheckpointer::~AsyncCheckpointer() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  writer_.join();
+  if (error_) {
+    try {
+      std::rethrow_exception(error_);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "A checkpoint failed to be written: " << e.what();
+    }
+  }
+}
+
+void AsyncCheckpointer::Save(
+    const std::string& path,
+    const std::vector<std::string>& names,
+    const std::vector<const phi::DenseTensor*>& tensors) {
+  PADDLE_ENFORCE_EQ(names.size(),
+                    tensors.size(),
+                    platform::errors::InvalidArgument(
+                        "The number of names (%d) and tensors (%d) of the "
+                        "checkpoint %s should be the same.",
+                        names.size(),
+                        tensors.size(),
+                        path));
+  Snapshot* snapshot = nullptr;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock,
+             [this] { return !snapshots_[0].busy || !snapshots_[1].busy; });
+    snapshot = snapshots_[0].busy ? &snapshots_[1] : &snapshots_[0];
+    snapshot->busy = true;
+  }
+  try {
+    snapshot->path = path;
+    snapshot->names = names;
+    TakeSnapshot(tensors, snapshot);
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      snapshot->busy = false;
+    }
+    cv_.notify_all();
+    throw;
+  }
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    queue_.push_back(snapshot);
+  }
+  cv_.notify_all();
+}
+
+void AsyncCheckpointer::TakeSnapshot(
+    const std::vector<const phi::DenseTensor*>& tensors, Snapshot* snapshot) {
+  snapshot->tensors.resize(tensors.size());
+#if defined(PADDLE_WITH_CUDA)
+  std::set<int> devices;
+#endif
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const auto& src = *tensors[i];
+    PADDLE_ENFORCE_EQ(
+        src.IsInitialized(),
+        true,
+        platform::errors::InvalidArgument(
+            "The tensor %s to be saved is not initialized.",
+            snapshot->names[i]));
+    auto& dst = snapshot->tensors[i];
+    dst.Resize(src.dims());
+    dst.set_lod(src.lod());
+    size_t size = src.numel() * phi::SizeOf(src.dtype());
+    if (platform::is_gpu_place(src.place())) {
+#if defined(PADDLE_WITH_CUDA)
+      int device = src.place().GetDeviceId();
+      auto& stream = streams_[device];
+      if (!stream) {
+        stream = platform::CudaStreamResourcePool::Instance().New(device);
+      }
+      auto& event = snapshot->events[device];
+      if (!event) {
+        event = platform::CudaEventResourcePool::Instance().New(device);
+      }
+      if (devices.insert(device).second) {
+        // copy the data after it is written by the kernels on the compute
+        // stream
+        PADDLE_ENFORCE_GPU_SUCCESS(
+            cudaEventRecord(event.get(), ComputeStream(src.place())));
+        PADDLE_ENFORCE_GPU_SUCCESS(
+            cudaStreamWaitEvent(stream.get(), event.get(), 0));
+      }
+      void* dst_data =
+          dst.mutable_data(platform::CUDAPinnedPlace(), src.dtype());
+      if (size > 0) {
+        memory::Copy(platform::CUDAPinnedPlace(),
+                     dst_data,
+                     phi::GPUPlace(device),
+                     src.data(),
+                     size,
+                     stream.get());
+        // the memory of src is not reused until the copy is done
+        memory::RecordStream(src.Holder(), stream.get());
+      }
+#else
+      PADDLE_THROW(platform::errors::Unavailable(
+          "Saving the checkpoint of the tensors on GPU requires Paddle "
+          "compiled with CUDA."));
+#endif
+    } else if (platform::is_cpu_place(src.place()) ||
+               platform::is_cuda_pinned_place(src.place())) {
+      void* dst_data = dst.mutable_data(platform::CPUPlace(), src.dtype());
+      if (size > 0) {
+        std::memcpy(dst_data, src.data(), size);
+      }
+    } else {
+      PADDLE_THROW(platform::errors::Unimplemented(
+          "Saving the checkpoint of the tensors on %s is not supported.",
+          src.place()));
+    }
+  }
+#if defined(PADDLE_WITH_CUDA)
+  for (int device : devices) {
+    auto& event = snapshot->events[device];
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaEventRecord(event.get(), streams_[device].get()));
+    // the tensors are updated by the next step after they are copied
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(
+        ComputeStream(phi::GPUPlace(device)), event.get(), 0));
+  }
+#endif
+}
+
+void AsyncCheckpointer::WriteSnapshots() {
+  while (true) {
+    Snapshot* snapshot = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      snapshot = queue_.front();
+    }
+    try {
+      WriteSnapshot(snapshot);
+    } catch (...) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+    }
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      queue_.pop_front();
+      snapshot->busy = false;
+    }
+    cv_.notify_all();
+  }
+}
+
+void AsyncCheckpointer::WriteSnapshot(Snapshot* snapshot) {
+#if defined(PADDLE_WITH_CUDA)
+  for (auto& item : snapshot->events) {
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(item.second.get()));
+  }
+#endif
+  WriteFile(snapshot->path, [&](FILE* fp, const std::string& path) {
+    for (const auto& tensor : snapshot->tensors) {
+      std::string header = SerializeTensorHeader(tensor);
+      WriteAll(fp, header.data(), header.size(), path);
+      WriteAll(fp,
+               tensor.data(),
+               tensor.numel() * phi::SizeOf(tensor.dtype()),
+               path);
+    }
+  });
+  WriteFile(snapshot->path + ".names", [&](FILE* fp, const std::string& path) {
+    for (const auto& name : snapshot->names) {
+      std::string line = name + "\n";
+      WriteAll(fp, line.data(), line.size(), path);
+    }
+  });
+  VLOG(3) << "Save the checkpoint of " << snapshot->tensors.size()
+          << " tensors to " << snapshot->path;
+}
+
+void AsyncCheckpointer::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] { return queue_.empty(); });
+  if (error_) {
+    std::exception_ptr error = error_;
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void AsyncCheckpointer::Load(const std::string& path,
+                             std::vector<std::string>* names,
+                             std::vector<phi::DenseTensor>* tensors) {
+  names->clear();
+  std::istringstream names_is(ReadFile(path + ".names"));
+  for (std::string name; std::getline(names_is, name);) {
+    names->push_back(name);
+  }
+  std::istringstream is(ReadFile(path), std::ios::in | std::ios::binary);
+  tensors->clear();
+  tensors->resize(names->size());
+  for (auto& tensor : *tensors) {
+    DeserializeFromStream(is, &tensor);
+    PADDLE_ENFORCE_EQ(static_cast<bool>(is),
+                      true,
+                      platform::errors::Unavailable(
+                          "The checkpoint %s is truncated.", path));
+  }
+  is.peek();
+  PADDLE_ENFORCE_EQ(is.eof(),
+                    true,
+                    platform::errors::Unavailable(
+                        "The checkpoint %s has more tensors than the %d names.",
+                        path,
+                        names->size()));
+}
+
+}  // namespace framework
+}  // namespace paddle
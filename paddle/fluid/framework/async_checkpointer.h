@@ -0,0 +1,106 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/core/dense_tensor.h"
+#if defined(PADDLE_WITH_CUDA)
+#include "paddle/fluid/platform/device/gpu/gpu_resource_pool.h"
+#endif
+
+namespace paddle {
+namespace framework {
+
+/* AsyncCheckpointer takes the snapshots of tensors, e.g. the parameters and
+the optimizer states of a training step, into the host memory, and writes
+them to the files in the background, so that the training only waits for the
+copies of the tensors.
+
+The tensors on GPU are copied to the pinned memory on a side stream of every
+device, after the kernels queued on its compute stream, which then waits for
+the copies on the device instead of on the host, so that the tensors can be
+updated by the next step as soon as Save returns. There are two snapshots
+held in turn, and Save blocks only when both of them are still being written.
+
+A snapshot is written through fs_open_write, i.e. to the local disk or HDFS
+by the path, in the format of save_combine, with the names of the tensors in
+the text file path + ".names". Both are written to temporary files moved to
+the paths when they are complete.
+*/
+class AsyncCheckpointer {
+ public:
+  AsyncCheckpointer();
+  ~AsyncCheckpointer();
+
+  void Save(const std::string& path,
+            const std::vector<std::string>& names,
+            const std::vector<const phi::DenseTensor*>& tensors);
+
+  // Wait for the snapshots being written, and rethrow the first error of
+  // them since the last wait.
+  void Wait();
+
+  // Load the snapshot at path to tensors on CPU.
+  static void Load(const std::string& path,
+                   std::vector<std::string>* names,
+                   std::vector<phi::DenseTensor>* tensors);
+
+ private:
+  DISABLE_COPY_AND_ASSIGN(AsyncCheckpointer);
+
+  struct Snapshot {
+    std::string path;
+    std::vector<std::string> names;
+    // the host copies of the tensors, whose memory is reused by the later
+    // snapshots in the slot
+    std::vector<phi::DenseTensor> tensors;
+#if defined(PADDLE_WITH_CUDA)
+    // the copies on every device are done after the event
+    std::map<int, std::shared_ptr<platform::CudaEventObject>> events;
+#endif
+    bool busy{false};
+  };
+
+  void TakeSnapshot(const std::vector<const phi::DenseTensor*>& tensors,
+                    Snapshot* snapshot);
+  void WriteSnapshots();
+  void WriteSnapshot(Snapshot* snapshot);
+
+  Snapshot snapshots_[2];
+#if defined(PADDLE_WITH_CUDA)
+  std::map<int, std::shared_ptr<platform::CudaStreamObject>> streams_;
+#endif
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // the snapshots to be written in order
+  std::deque<Snapshot*> queue_;
+  std::exception_ptr error_;
+  bool stop_{false};
+  std::thread writer_;
+};
+
+}  // namespace framework
+}  // namespace paddle
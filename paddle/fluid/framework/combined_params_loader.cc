@@ -0,0 +1,310 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/combined_params_loader.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <future>
+#include <memory>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/convert_utils.h"
+#include "paddle/fluid/framework/data_type.h"
+#include "paddle/fluid/framework/framework.pb.h"
+#include "paddle/fluid/framework/version.h"
+#include "paddle/fluid/platform/enforce.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/fluid/platform/device/gpu/gpu_resource_pool.h"
+#endif
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+constexpr size_t kChunkSize = 16 << 20;  // 16MB
+
+struct Chunk {
+  uint64_t offset;
+  size_t size;
+  char *dst;
+};
+
+template <typename T>
+void ReadValue(std::istream &is, T *value) {
+  is.read(reinterpret_cast<char *>(value), sizeof(T));
+}
+
+// Read the header of a tensor written by SerializeToStream at the position
+// of is, allocate the tensor on place and skip its data. Return the offset of
+// the data in the file.
+uint64_t ReadTensorHeader(std::istream &is,
+                          phi::DenseTensor *tensor,
+                          const platform::Place &place,
+                          const std::string &path) {
+  uint32_t version = 0;
+  ReadValue(is, &version);
+  PADDLE_ENFORCE_EQ(
+      IsTensorVersionSupported(version) && version == 0U,
+      true,
+      platform::errors::InvalidArgument(
+          "Tensor version %u in the params file %s is not supported.",
+          version,
+          path));
+  uint64_t lod_level = 0;
+  ReadValue(is, &lod_level);
+  auto &lod = *tensor->mutable_lod();
+  lod.resize(lod_level);
+  for (uint64_t i = 0; i < lod_level; ++i) {
+    uint64_t size = 0;
+    ReadValue(is, &size);
+    std::vector<size_t> level(size / sizeof(size_t));
+    is.read(reinterpret_cast<char *>(level.data()),
+            static_cast<std::streamsize>(size));
+    lod[i] = level;
+  }
+
+  ReadValue(is, &version);
+  PADDLE_ENFORCE_EQ(
+      version,
+      0U,
+      platform::errors::InvalidArgument(
+          "Tensor version %u in the params file %s is not supported.",
+          version,
+          path));
+  int32_t desc_size = -1;
+  ReadValue(is, &desc_size);
+  PADDLE_ENFORCE_EQ(
+      is.good() && desc_size >= 0,
+      true,
+      platform::errors::Unavailable(
+          "Cannot read the tensor desc in the params file %s.", path));
+  std::string desc_data(desc_size, '\0');
+  is.read(&desc_data[0], desc_size);
+  proto::VarType::TensorDesc desc;
+  PADDLE_ENFORCE_EQ(desc.ParseFromString(desc_data),
+                    true,
+                    platform::errors::InvalidArgument(
+                        "Cannot parse the tensor desc in the params file %s.",
+                        path));
+
+  std::vector<int64_t> dims(desc.dims().begin(), desc.dims().end());
+  tensor->Resize(common::make_ddim(dims));
+  tensor->mutable_data(place, TransToPhiDataType(desc.data_type()));
+  uint64_t offset = static_cast<uint64_t>(is.tellg());
+  size_t size = tensor->numel() * SizeOfType(desc.data_type());
+  is.seekg(static_cast<std::streamoff>(size), std::ios::cur);
+  PADDLE_ENFORCE_EQ(static_cast<bool>(is),
+                    true,
+                    platform::errors::Unavailable(
+                        "The params file %s is truncated, please check "
+                        "whether the model file is complete or damaged.",
+                        path));
+  return offset;
+}
+
+#ifndef _WIN32
+void ReadChunk(int fd, const Chunk &chunk, char *dst, const std::string &path) {
+  size_t done = 0;
+  while (done < chunk.size) {
+    ssize_t n = pread(fd,
+                      dst + done,
+                      chunk.size - done,
+                      static_cast<off_t>(chunk.offset + done));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    PADDLE_ENFORCE_GT(n,
+                      0,
+                      platform::errors::Unavailable(
+                          "Read the params file %s failed: %s.",
+                          path,
+                          n < 0 ? strerror(errno) : "unexpected end of file"));
+    done += static_cast<size_t>(n);
+  }
+}
+
+void LoadChunksToCPU(int fd,
+                     const std::vector<Chunk> &chunks,
+                     std::atomic<size_t> *next,
+                     const std::string &path) {
+  for (size_t i = next->fetch_add(1); i < chunks.size();
+       i = next->fetch_add(1)) {
+    ReadChunk(fd, chunks[i], chunks[i].dst, path);
+  }
+}
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+void LoadChunksToGPU(int fd,
+                     const std::vector<Chunk> &chunks,
+                     std::atomic<size_t> *next,
+                     const platform::CUDAPlace &place,
+                     const std::string &path) {
+  platform::SetDeviceId(place.device);
+  auto stream = platform::CudaStreamResourcePool::Instance().New(place.device);
+  std::shared_ptr<platform::CudaEventObject> events[2];
+  memory::AllocationPtr staging[2];
+  for (int b = 0; b < 2; ++b) {
+    events[b] = platform::CudaEventResourcePool::Instance().New(place.device);
+    staging[b] = memory::Alloc(platform::CUDAPinnedPlace(), kChunkSize);
+  }
+  bool pending[2] = {false, false};
+
+  try {
+    size_t k = 0;
+    for (size_t i = next->fetch_add(1); i < chunks.size();
+         i = next->fetch_add(1), ++k) {
+      int b = static_cast<int>(k % 2);
+      // the staging buffer is reused after the copy from it is done
+      if (pending[b]) {
+#ifdef PADDLE_WITH_HIP
+        PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(events[b].get()));
+#else
+        PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(events[b].get()));
+#endif
+      }
+      char *buf = static_cast<char *>(staging[b]->ptr());
+      ReadChunk(fd, chunks[i], buf, path);
+      platform::GpuMemcpyAsync(chunks[i].dst,
+                               buf,
+                               chunks[i].size,
+                               gpuMemcpyHostToDevice,
+                               stream.get());
+#ifdef PADDLE_WITH_HIP
+      PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(events[b].get(), stream.get()));
+#else
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaEventRecord(events[b].get(), stream.get()));
+#endif
+      pending[b] = true;
+    }
+  } catch (...) {
+    platform::GpuStreamSync(stream.get());
+    throw;
+  }
+  platform::GpuStreamSync(stream.get());
+}
+#endif
+#endif
+
+}  // namespace
+
+bool CanLoadCombinedParamsInParallel(const platform::Place &place) {
+#ifdef _WIN32
+  return false;
+#elif defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  return platform::is_cpu_place(place) || platform::is_gpu_place(place);
+#else
+  return platform::is_cpu_place(place);
+#endif
+}
+
+void LoadCombinedParams(const std::string &path,
+                        const std::vector<phi::DenseTensor *> &tensors,
+                        const platform::Place &place,
+                        int num_threads) {
+  PADDLE_ENFORCE_EQ(CanLoadCombinedParamsInParallel(place),
+                    true,
+                    platform::errors::Unimplemented(
+                        "Loading params in parallel to %s is not supported.",
+                        place));
+#ifndef _WIN32
+  std::ifstream fin(path, std::ios::binary);
+  PADDLE_ENFORCE_EQ(static_cast<bool>(fin),
+                    true,
+                    platform::errors::Unavailable(
+                        "Cannot open the params file %s, please check whether "
+                        "the model file is complete or damaged.",
+                        path));
+  std::vector<Chunk> chunks;
+  for (auto *tensor : tensors) {
+    uint64_t offset = ReadTensorHeader(fin, tensor, place, path);
+    size_t size = tensor->numel() * phi::SizeOf(tensor->dtype());
+    char *dst = static_cast<char *>(tensor->data());
+    for (size_t pos = 0; pos < size; pos += kChunkSize) {
+      chunks.push_back(
+          Chunk{offset + pos, std::min(kChunkSize, size - pos), dst + pos});
+    }
+  }
+  fin.peek();
+  PADDLE_ENFORCE_EQ(fin.eof(),
+                    true,
+                    platform::errors::Unavailable(
+                        "Not allowed to load partial data via "
+                        "load_combine_op, please use load_op instead."));
+
+  int fd = open(path.c_str(), O_RDONLY);
+  PADDLE_ENFORCE_NE(fd,
+                    -1,
+                    platform::errors::Unavailable(
+                        "Cannot open the params file %s: %s.",
+                        path,
+                        strerror(errno)));
+  num_threads = std::max(
+      1, std::min(num_threads, static_cast<int>(chunks.size())));
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    try {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+      if (platform::is_gpu_place(place)) {
+        LoadChunksToGPU(
+            fd, chunks, &next, platform::CUDAPlace(place.GetDeviceId()), path);
+        return;
+      }
+#endif
+      LoadChunksToCPU(fd, chunks, &next, path);
+    } catch (...) {
+      // stop the other threads
+      next.store(chunks.size());
+      throw;
+    }
+  };
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < num_threads; ++i) {
+    futures.emplace_back(std::async(std::launch::async, worker));
+  }
+  std::exception_ptr error;
+  for (auto &future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  ::close(fd);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  VLOG(3) << "Load " << tensors.size() << " params in " << chunks.size()
+          << " chunks with " << num_threads << " threads from " << path;
+#endif
+}
+
+}  // namespace framework
+}  // namespace paddle
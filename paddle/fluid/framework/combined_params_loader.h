@@ -0,0 +1,44 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/platform/place.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace framework {
+
+// Whether LoadCombinedParams supports loading the params to place.
+bool CanLoadCombinedParamsInParallel(const platform::Place &place);
+
+/* Load the tensors serialized one after another by SerializeToStream in the
+combined params file at path, with num_threads threads.
+
+The headers of all the tensors are read first, which allocates the tensors
+on place, then the data of the tensors are split into chunks read by the
+threads concurrently. On GPU, every thread reads its chunks into two pinned
+staging buffers in turn, and copies them to the device asynchronously on a
+stream of its own, so that the reads overlap the copies.
+*/
+void LoadCombinedParams(const std::string &path,
+                        const std::vector<phi::DenseTensor *> &tensors,
+                        const platform::Place &place,
+                        int num_threads);
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,317 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/combined_params_saver.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <memory>
+#include <sstream>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/convert_utils.h"
+#include "paddle/fluid/framework/framework.pb.h"
+#include "paddle/fluid/framework/version.h"
+#include "paddle/fluid/platform/enforce.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/fluid/platform/device/gpu/gpu_resource_pool.h"
+#endif
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+constexpr size_t kChunkSize = 16 << 20;  // 16MB
+
+struct Chunk {
+  uint64_t offset;
+  size_t size;
+  const char *src;
+};
+
+template <typename T>
+void WriteValue(std::ostream &os, const T &value) {
+  os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// Write all but the data of tensor in the format of SerializeToStream.
+void WriteTensorHeader(std::ostream &os, const phi::DenseTensor &tensor) {
+  WriteValue(os, kCurTensorVersion);
+  const auto &lod = tensor.lod();
+  WriteValue(os, static_cast<uint64_t>(lod.size()));
+  for (const auto &level : lod) {
+    uint64_t size = level.size() * sizeof(size_t);
+    WriteValue(os, size);
+    os.write(reinterpret_cast<const char *>(level.data()),
+             static_cast<std::streamsize>(size));
+  }
+
+  WriteValue(os, static_cast<uint32_t>(0));
+  proto::VarType::TensorDesc desc;
+  desc.set_data_type(framework::TransToProtoVarType(tensor.dtype()));
+  auto dims = common::vectorize(tensor.dims());
+  auto *pb_dims = desc.mutable_dims();
+  pb_dims->Resize(static_cast<int>(dims.size()), 0);
+  std::copy(dims.begin(), dims.end(), pb_dims->begin());
+  std::string desc_data = desc.SerializeAsString();
+  WriteValue(os, static_cast<int32_t>(desc_data.size()));
+  os.write(desc_data.data(), static_cast<std::streamsize>(desc_data.size()));
+}
+
+#ifndef _WIN32
+void WriteAt(int fd,
+             const char *src,
+             size_t size,
+             uint64_t offset,
+             const std::string &path) {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t n = pwrite(
+        fd, src + done, size - done, static_cast<off_t>(offset + done));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    PADDLE_ENFORCE_GT(
+        n,
+        0,
+        platform::errors::Unavailable("Write the params file %s failed: %s.",
+                                      path,
+                                      n < 0 ? strerror(errno) : "no space"));
+    done += static_cast<size_t>(n);
+  }
+}
+
+void SaveChunksFromCPU(int fd,
+                       const std::vector<Chunk> &chunks,
+                       std::atomic<size_t> *next,
+                       const std::string &path) {
+  for (size_t i = next->fetch_add(1); i < chunks.size();
+       i = next->fetch_add(1)) {
+    WriteAt(fd, chunks[i].src, chunks[i].size, chunks[i].offset, path);
+  }
+}
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+void SaveChunksFromGPU(int fd,
+                       const std::vector<Chunk> &chunks,
+                       std::atomic<size_t> *next,
+                       const platform::CUDAPlace &place,
+                       const std::string &path) {
+  platform::SetDeviceId(place.device);
+  auto stream = platform::CudaStreamResourcePool::Instance().New(place.device);
+  std::shared_ptr<platform::CudaEventObject> events[2];
+  memory::AllocationPtr staging[2];
+  for (int b = 0; b < 2; ++b) {
+    events[b] = platform::CudaEventResourcePool::Instance().New(place.device);
+    staging[b] = memory::Alloc(platform::CUDAPinnedPlace(), kChunkSize);
+  }
+  // the chunk copied to every staging buffer and not written yet
+  const Chunk *pending[2] = {nullptr, nullptr};
+  auto write_pending = [&](int b) {
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(events[b].get()));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(events[b].get()));
+#endif
+    WriteAt(fd,
+            static_cast<const char *>(staging[b]->ptr()),
+            pending[b]->size,
+            pending[b]->offset,
+            path);
+    pending[b] = nullptr;
+  };
+
+  try {
+    size_t k = 0;
+    for (size_t i = next->fetch_add(1); i < chunks.size();
+         i = next->fetch_add(1), ++k) {
+      int b = static_cast<int>(k % 2);
+      platform::GpuMemcpyAsync(staging[b]->ptr(),
+                               chunks[i].src,
+                               chunks[i].size,
+                               gpuMemcpyDeviceToHost,
+                               stream.get());
+#ifdef PADDLE_WITH_HIP
+      PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(events[b].get(), stream.get()));
+#else
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaEventRecord(events[b].get(), stream.get()));
+#endif
+      pending[b] = &chunks[i];
+      // the previous chunk is written while this one is being copied
+      if (pending[1 - b] != nullptr) {
+        write_pending(1 - b);
+      }
+    }
+    for (int b = 0; b < 2; ++b) {
+      if (pending[b] != nullptr) {
+        write_pending(b);
+      }
+    }
+  } catch (...) {
+    platform::GpuStreamSync(stream.get());
+    throw;
+  }
+}
+#endif
+#endif
+
+}  // namespace
+
+std::string SerializeTensorHeader(const phi::DenseTensor &tensor) {
+  std::ostringstream os;
+  WriteTensorHeader(os, tensor);
+  return os.str();
+}
+
+bool CanSaveCombinedParamsInParallel(const platform::Place &place) {
+#ifdef _WIN32
+  return false;
+#elif defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  return platform::is_cpu_place(place) || platform::is_gpu_place(place);
+#else
+  return platform::is_cpu_place(place);
+#endif
+}
+
+void SaveCombinedParams(const std::string &path,
+                        const std::vector<const phi::DenseTensor *> &tensors,
+                        const platform::Place &place,
+                        int num_threads) {
+  PADDLE_ENFORCE_EQ(CanSaveCombinedParamsInParallel(place),
+                    true,
+                    platform::errors::Unimplemented(
+                        "Saving params in parallel from %s is not supported.",
+                        place));
+#ifndef _WIN32
+  // the headers are written at their offsets once the file is created
+  std::vector<std::pair<uint64_t, std::string>> headers;
+  std::vector<Chunk> chunks;
+  uint64_t offset = 0;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const auto &tensor = *tensors[i];
+    PADDLE_ENFORCE_EQ(tensor.IsInitialized(),
+                      true,
+                      platform::errors::InvalidArgument(
+                          "The Tensor with Index (%d) to be saved is not "
+                          "initialized.",
+                          i));
+    PADDLE_ENFORCE_EQ(tensor.place(),
+                      place,
+                      platform::errors::InvalidArgument(
+                          "The Tensor with Index (%d) to be saved is on %s, "
+                          "not on %s.",
+                          i,
+                          tensor.place(),
+                          place));
+    headers.emplace_back(offset, SerializeTensorHeader(tensor));
+    offset += headers.back().second.size();
+
+    size_t size = tensor.numel() * phi::SizeOf(tensor.dtype());
+    const char *src = static_cast<const char *>(tensor.data());
+    for (size_t pos = 0; pos < size; pos += kChunkSize) {
+      chunks.push_back(
+          Chunk{offset + pos, std::min(kChunkSize, size - pos), src + pos});
+    }
+    offset += size;
+  }
+
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  PADDLE_ENFORCE_NE(fd,
+                    -1,
+                    platform::errors::Unavailable(
+                        "Cannot open %s to save variables: %s.",
+                        path,
+                        strerror(errno)));
+  std::exception_ptr error;
+  try {
+    PADDLE_ENFORCE_EQ(ftruncate(fd, static_cast<off_t>(offset)),
+                      0,
+                      platform::errors::Unavailable(
+                          "Cannot resize the params file %s to %d bytes: %s.",
+                          path,
+                          offset,
+                          strerror(errno)));
+    for (const auto &header : headers) {
+      WriteAt(fd,
+              header.second.data(),
+              header.second.size(),
+              header.first,
+              path);
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  num_threads = std::max(
+      1, std::min(num_threads, static_cast<int>(chunks.size())));
+  std::atomic<size_t> next{error ? chunks.size() : 0};
+  auto worker = [&]() {
+    try {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+      if (platform::is_gpu_place(place)) {
+        SaveChunksFromGPU(
+            fd, chunks, &next, platform::CUDAPlace(place.GetDeviceId()), path);
+        return;
+      }
+#endif
+      SaveChunksFromCPU(fd, chunks, &next, path);
+    } catch (...) {
+      // stop the other threads
+      next.store(chunks.size());
+      throw;
+    }
+  };
+  std::vector<std::future<void>> futures;
+  if (!error) {
+    for (int i = 0; i < num_threads; ++i) {
+      futures.emplace_back(std::async(std::launch::async, worker));
+    }
+  }
+  for (auto &future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (::close(fd) != 0 && !error) {
+    PADDLE_THROW(platform::errors::Unavailable(
+        "Close the params file %s failed: %s.", path, strerror(errno)));
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  VLOG(3) << "Save " << tensors.size() << " params in " << chunks.size()
+          << " chunks with " << num_threads << " threads to " << path;
+#endif
+}
+
+}  // namespace framework
+}  // namespace paddle
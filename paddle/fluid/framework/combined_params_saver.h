@@ -0,0 +1,50 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/platform/place.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace framework {
+
+// Return all but the data of tensor in the format of SerializeToStream, which
+// is followed by the data of it in the file.
+std::string SerializeTensorHeader(const phi::DenseTensor &tensor);
+
+// Whether SaveCombinedParams supports saving the params on place.
+bool CanSaveCombinedParamsInParallel(const platform::Place &place);
+
+/* Save the tensors on place one after another in the format of
+SerializeToStream to the combined params file at path, with num_threads
+threads, which is loaded by load_combine as before.
+
+The headers of all the tensors are written first, which decides the offsets
+of their data in the file, then the data of the tensors are split into chunks
+written by the threads concurrently. On GPU, every thread copies its chunks to
+two pinned staging buffers in turn on a stream of its own, so that the copies
+from the device overlap the writes. The tensors on GPU must be ready, i.e. the
+streams computing them are synchronized before.
+*/
+void SaveCombinedParams(const std::string &path,
+                        const std::vector<const phi::DenseTensor *> &tensors,
+                        const platform::Place &place,
+                        int num_threads);
+
+}  // namespace framework
+}  // namespace paddle
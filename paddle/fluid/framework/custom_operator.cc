@@ -54,20 +54,106 @@ PHI_DECLARE_string(tensor_operants_mode);
 namespace paddle {
 namespace framework {
 
+enum class CustomAttrType {
+  kBool,
+  kInt,
+  kFloat,
+  kInt64,
+  kString,
+  kIntVector,
+  kFloatVector,
+  kInt64Vector,
+  kStringVector,
+};
+
+struct CustomArgDesc {
+  std::string name;
+  bool is_duplicable;
+  bool is_optional;
+};
+
+struct CustomAttrDesc {
+  std::string name;
+  CustomAttrType type;
+};
+
+// The inputs, outputs and attrs of a custom operator parsed from the strings
+// of OpMetaInfo, it is made once at registration, so that the kernel and
+// infershape functions need not parse the strings on every run.
+struct CustomOpSignature {
+  std::vector<CustomArgDesc> inputs;
+  std::vector<CustomArgDesc> outputs;
+  std::vector<CustomAttrDesc> attrs;
+};
+
+static std::vector<CustomArgDesc> ParseCustomArgs(
+    const std::vector<std::string>& names) {
+  std::vector<CustomArgDesc> args;
+  args.reserve(names.size());
+  for (auto& name : names) {
+    args.push_back(
+        {name, detail::IsDuplicableVar(name), detail::IsOptionalVar(name)});
+  }
+  return args;
+}
+
+static CustomAttrType ParseCustomAttrType(const std::string& attr_type_str) {
+  static const std::unordered_map<std::string, CustomAttrType> attr_types = {
+      {"bool", CustomAttrType::kBool},
+      {"int", CustomAttrType::kInt},
+      {"float", CustomAttrType::kFloat},
+      {"int64_t", CustomAttrType::kInt64},
+      {"std::string", CustomAttrType::kString},
+      {"std::vector<int>", CustomAttrType::kIntVector},
+      {"std::vector<float>", CustomAttrType::kFloatVector},
+      {"std::vector<int64_t>", CustomAttrType::kInt64Vector},
+      {"std::vector<std::string>", CustomAttrType::kStringVector}};
+  auto iter = attr_types.find(attr_type_str);
+  PADDLE_ENFORCE_NE(
+      iter,
+      attr_types.end(),
+      platform::errors::Unimplemented(
+          "Unsupported `%s` type value as custom attribute now. "
+          "Supported data types include `bool`, `int`, `float`, "
+          "`int64_t`, `std::string`, `std::vector<int>`, "
+          "`std::vector<float>`, `std::vector<int64_t>`, "
+          "`std::vector<std::string>`, Please check whether "
+          "the attribute data type and data type string are matched.",
+          attr_type_str));
+  return iter->second;
+}
+
+static CustomOpSignature MakeCustomOpSignature(
+    const std::vector<std::string>& inputs,
+    const std::vector<std::string>& outputs,
+    const std::vector<std::string>& attrs) {
+  CustomOpSignature signature;
+  signature.inputs = ParseCustomArgs(inputs);
+  signature.outputs = ParseCustomArgs(outputs);
+  signature.attrs.reserve(attrs.size());
+  for (auto& attr_str : attrs) {
+    auto attr_name_and_type = paddle::ParseAttrStr(attr_str);
+    signature.attrs.push_back(
+        {attr_name_and_type[0], ParseCustomAttrType(attr_name_and_type[1])});
+  }
+  return signature;
+}
+
 // custom op kernel call function define
 static void RunKernelFunc(
     const framework::ExecutionContext& ctx,
     const paddle::KernelFunc& func,
     const std::vector<std::string>& inputs,
     const std::vector<std::string>& outputs,
-    const std::vector<std::string>& attrs,
+    const CustomOpSignature& signature,
     const std::unordered_map<std::string, std::string>& inplace_map) {
   VLOG(3) << "Custom Operator: Start run KernelFunc.";
   // prepare CustomOpKernelContext
   paddle::CustomOpKernelContext kernel_ctx;
-  for (auto& in_name : inputs) {
+  for (auto& input : signature.inputs) {
+    auto& in_name = input.name;
     VLOG(3) << "Custom Operator: input name - " << in_name;
-    if (detail::IsDuplicableVar(in_name)) {  // inputs vector<Tensor>
+    if (input.is_duplicable) {  // inputs vector<Tensor>
       std::vector<paddle::Tensor> custom_vec_in;
       if (ctx.HasInputs(in_name)) {  // general vector<Tensor> inputs
         // return const std::vector<const phi::DenseTensor*>
@@ -97,7 +183,7 @@ static void RunKernelFunc(
         }
       } else {  // optional vector<Tensor> inputs.
         PADDLE_ENFORCE(
-            detail::IsOptionalVar(in_name),
+            input.is_optional,
             phi::errors::NotFound("Your custom operator's KernelFunc cannot "
                                   "find input parameter `%s`",
                                   in_name));
@@ -138,7 +224,7 @@ static void RunKernelFunc(
 #endif
       } else {  // optional Tensor inputs
         PADDLE_ENFORCE(
-            detail::IsOptionalVar(in_name),
+            input.is_optional,
             phi::errors::NotFound("Your custom operator's KernelFunc cannot "
                                   "find input parameter `%s`",
                                   in_name));
@@ -149,47 +235,47 @@ static void RunKernelFunc(
     }
   }
 
-  for (auto& attr_str : attrs) {
-    auto attr_name_and_type = paddle::ParseAttrStr(attr_str);
-    auto attr_name = attr_name_and_type[0];
-    auto attr_type_str = attr_name_and_type[1];
-    if (attr_type_str == "bool") {
-      kernel_ctx.EmplaceBackAttr(ctx.Attr<bool>(attr_name));
-    } else if (attr_type_str == "int") {
-      kernel_ctx.EmplaceBackAttr(ctx.Attr<int>(attr_name));
-    } else if (attr_type_str == "float") {
-      kernel_ctx.EmplaceBackAttr(ctx.Attr<float>(attr_name));
-    } else if (attr_type_str == "int64_t") {
-      kernel_ctx.EmplaceBackAttr(ctx.Attr<int64_t>(attr_name));
-    } else if (attr_type_str == "std::string") {
-      kernel_ctx.EmplaceBackAttr(ctx.Attr<std::string>(attr_name));
-    } else if (attr_type_str == "std::vector<int>") {
-      kernel_ctx.EmplaceBackAttr(ctx.Attr<std::vector<int>>(attr_name));
-    } else if (attr_type_str == "std::vector<float>") {
-      kernel_ctx.EmplaceBackAttr(ctx.Attr<std::vector<float>>(attr_name));
-    } else if (attr_type_str == "std::vector<int64_t>") {
-      kernel_ctx.EmplaceBackAttr(ctx.Attr<std::vector<int64_t>>(attr_name));
-    } else if (attr_type_str == "std::vector<std::string>") {
-      kernel_ctx.EmplaceBackAttr(ctx.Attr<std::vector<std::string>>(attr_name));
-    } else {
-      PADDLE_THROW(platform::errors::Unimplemented(
-          "Unsupported `%s` type value as custom attribute now. "
-          "Supported data types include `bool`, `int`, `float`, "
-          "`int64_t`, `std::string`, `std::vector<int>`, "
-          "`std::vector<float>`, `std::vector<int64_t>`, "
-          "`std::vector<std::string>`, Please check whether "
-          "the attribute data type and data type string are matched.",
-          attr_type_str));
+  for (auto& attr : signature.attrs) {
+    auto& attr_name = attr.name;
+    switch (attr.type) {
+      case CustomAttrType::kBool:
+        kernel_ctx.EmplaceBackAttr(ctx.Attr<bool>(attr_name));
+        break;
+      case CustomAttrType::kInt:
+        kernel_ctx.EmplaceBackAttr(ctx.Attr<int>(attr_name));
+        break;
+      case CustomAttrType::kFloat:
+        kernel_ctx.EmplaceBackAttr(ctx.Attr<float>(attr_name));
+        break;
+      case CustomAttrType::kInt64:
+        kernel_ctx.EmplaceBackAttr(ctx.Attr<int64_t>(attr_name));
+        break;
+      case CustomAttrType::kString:
+        kernel_ctx.EmplaceBackAttr(ctx.Attr<std::string>(attr_name));
+        break;
+      case CustomAttrType::kIntVector:
+        kernel_ctx.EmplaceBackAttr(ctx.Attr<std::vector<int>>(attr_name));
+        break;
+      case CustomAttrType::kFloatVector:
+        kernel_ctx.EmplaceBackAttr(ctx.Attr<std::vector<float>>(attr_name));
+        break;
+      case CustomAttrType::kInt64Vector:
+        kernel_ctx.EmplaceBackAttr(ctx.Attr<std::vector<int64_t>>(attr_name));
+        break;
+      case CustomAttrType::kStringVector:
+        kernel_ctx.EmplaceBackAttr(
+            ctx.Attr<std::vector<std::string>>(attr_name));
+        break;
     }
   }
 
   VLOG(3) << "Custom Operator: push outputs into CustomOpKernelContext.";
   // cache the target tensor pointers
   std::vector<phi::DenseTensor*> true_out_ptrs;
-  for (size_t i = 0; i < outputs.size(); ++i) {
-    auto out_name = outputs[i];
-    if (detail::IsDuplicableVar(
-            out_name)) {  // general/inplace vector<Tensor> outputs
+  for (size_t i = 0; i < signature.outputs.size(); ++i) {
+    auto& output = signature.outputs[i];
+    auto& out_name = output.name;
+    if (output.is_duplicable) {  // general/inplace vector<Tensor> outputs
       PADDLE_ENFORCE(
           !inplace_map.empty() || (i == 0UL && outputs.size() == 1UL),
           phi::errors::PreconditionNotMet(
@@ -199,7 +285,7 @@ static void RunKernelFunc(
       // handle inplace optional outputs = None case
       if (vec_out.empty()) {
         PADDLE_ENFORCE(
-            detail::IsOptionalVar(out_name) && !inplace_map.empty(),
+            output.is_optional && !inplace_map.empty(),
             phi::errors::InvalidArgument(
                 "Custom operator couldn't find custom output for name %s. If "
                 "you "
@@ -236,7 +322,7 @@ static void RunKernelFunc(
       // handle inplace optional outputs = None case
       if (!ctx.HasOutput(out_name)) {
         PADDLE_ENFORCE(
-            detail::IsOptionalVar(out_name) && !inplace_map.empty(),
+            output.is_optional && !inplace_map.empty(),
             phi::errors::InvalidArgument(
                 "Custom operator couldn't find custom output for name %s. If "
                 "you "
@@ -268,7 +354,9 @@ static void RunKernelFunc(
   try {
     VLOG(3) << "Custom Operator: Run ComputeFunc.";
 
-    FLAGS_tensor_operants_mode = "phi";
+    if (FLAGS_tensor_operants_mode != "phi") {
+      FLAGS_tensor_operants_mode = "phi";
+    }
     if (paddle::OperantsManager::Instance().phi_operants.get() == nullptr) {
       paddle::OperantsManager::Instance().phi_operants =
           std::make_unique<paddle::operants::PhiTensorOperants>();
@@ -415,17 +503,16 @@ static void RunDefaultInferShapeFunc(
 static void RunInferShapeFunc(
     framework::InferShapeContext* ctx,
     const paddle::InferShapeFunc& func,
-    const std::vector<std::string>& inputs,
-    const std::vector<std::string>& outputs,
-    const std::vector<std::string>& attrs,
+    const CustomOpSignature& signature,
     const std::unordered_map<std::string, std::string>& inplace_map,
     const std::unordered_map<std::string, std::string>& inplace_reverse_map) {
   std::vector<std::vector<int64_t>> input_shapes;
   std::vector<std::vector<std::vector<int64_t>>> vec_input_shapes;
 
   VLOG(3) << "Custom Operator: InferShape - get input ddim.";
-  for (auto& in_name : inputs) {
-    if (detail::IsDuplicableVar(in_name)) {
+  for (auto& input : signature.inputs) {
+    auto& in_name = input.name;
+    if (input.is_duplicable) {
       std::vector<std::vector<int64_t>> vec_shape;
       if (ctx->HasInputs(in_name)) {  // general inputs
         auto vec_ddim = ctx->GetInputsDim(in_name);
@@ -439,7 +526,7 @@ static void RunInferShapeFunc(
 
       } else {  // optional inputs, `vec_shape` is empty
         PADDLE_ENFORCE(
-            detail::IsOptionalVar(in_name),
+            input.is_optional,
             phi::errors::NotFound("Your custom operator's InferShapeFunc "
                                   "cannot find input parameter `%s`",
                                   in_name));
@@ -453,7 +540,7 @@ static void RunInferShapeFunc(
         input_shapes.emplace_back(common::vectorize(ddim));
       } else {  // optional inputs
         PADDLE_ENFORCE(
-            detail::IsOptionalVar(in_name),
+            input.is_optional,
             phi::errors::NotFound("Your custom operator's InferShapeFunc "
                                   "cannot find input parameter `%s`",
                                   in_name));
@@ -465,67 +552,66 @@ static void RunInferShapeFunc(
   }
 
   std::vector<paddle::any> custom_attrs;
-  for (auto& attr_str : attrs) {
-    auto attr_name_and_type = paddle::ParseAttrStr(attr_str);
-    auto attr_name = attr_name_and_type[0];
-    auto attr_type_str = attr_name_and_type[1];
-    if (attr_type_str == "bool") {
-      custom_attrs.emplace_back(ctx->Attrs().Get<bool>(attr_name));
-    } else if (attr_type_str == "int") {
-      custom_attrs.emplace_back(ctx->Attrs().Get<int>(attr_name));
-    } else if (attr_type_str == "float") {
-      custom_attrs.emplace_back(ctx->Attrs().Get<float>(attr_name));
-    } else if (attr_type_str == "int64_t") {
-      custom_attrs.emplace_back(ctx->Attrs().Get<int64_t>(attr_name));
-    } else if (attr_type_str == "std::string") {
-      custom_attrs.emplace_back(ctx->Attrs().Get<std::string>(attr_name));
-    } else if (attr_type_str == "std::vector<int>") {
-      custom_attrs.emplace_back(ctx->Attrs().Get<std::vector<int>>(attr_name));
-    } else if (attr_type_str == "std::vector<float>") {
-      custom_attrs.emplace_back(
-          ctx->Attrs().Get<std::vector<float>>(attr_name));
-    } else if (attr_type_str == "std::vector<int64_t>") {
-      // NOTE(chenweihang): InferShape can't support std::vector<int64_t>
-      // attr type, because the input type is std::vector<int64_t>, only
-      // can use one rule to parse std::vector<int64_t> parameter
-      continue;
-    } else if (attr_type_str == "std::vector<std::string>") {
-      custom_attrs.emplace_back(
-          ctx->Attrs().Get<std::vector<std::string>>(attr_name));
-    } else {
-      PADDLE_THROW(phi::errors::Unimplemented(
-          "Unsupported `%s` type value as custom attribute now. "
-          "Supported data types include `bool`, `int`, `float`, "
-          "`int64_t`, `std::string`, `std::vector<int>`, "
-          "`std::vector<float>`, `std::vector<int64_t>`, "
-          "`std::vector<std::string>`, Please check whether the attribute data "
-          "type and data type string are matched.",
-          attr_type_str));
+  for (auto& attr : signature.attrs) {
+    auto& attr_name = attr.name;
+    switch (attr.type) {
+      case CustomAttrType::kBool:
+        custom_attrs.emplace_back(ctx->Attrs().Get<bool>(attr_name));
+        break;
+      case CustomAttrType::kInt:
+        custom_attrs.emplace_back(ctx->Attrs().Get<int>(attr_name));
+        break;
+      case CustomAttrType::kFloat:
+        custom_attrs.emplace_back(ctx->Attrs().Get<float>(attr_name));
+        break;
+      case CustomAttrType::kInt64:
+        custom_attrs.emplace_back(ctx->Attrs().Get<int64_t>(attr_name));
+        break;
+      case CustomAttrType::kString:
+        custom_attrs.emplace_back(ctx->Attrs().Get<std::string>(attr_name));
+        break;
+      case CustomAttrType::kIntVector:
+        custom_attrs.emplace_back(
+            ctx->Attrs().Get<std::vector<int>>(attr_name));
+        break;
+      case CustomAttrType::kFloatVector:
+        custom_attrs.emplace_back(
+            ctx->Attrs().Get<std::vector<float>>(attr_name));
+        break;
+      case CustomAttrType::kInt64Vector:
+        // NOTE(chenweihang): InferShape can't support std::vector<int64_t>
+        // attr type, because the input type is std::vector<int64_t>, only
+        // can use one rule to parse std::vector<int64_t> parameter
+        break;
+      case CustomAttrType::kStringVector:
+        custom_attrs.emplace_back(
+            ctx->Attrs().Get<std::vector<std::string>>(attr_name));
+        break;
     }
   }
 
   VLOG(3) << "Custom Operator: InferShape - calc output ddim.";
   auto output_shapes = func(input_shapes, vec_input_shapes, custom_attrs);
   if (inplace_map.empty()) {
-    PADDLE_ENFORCE_EQ(outputs.size(),
+    PADDLE_ENFORCE_EQ(signature.outputs.size(),
                       output_shapes.size(),
                       phi::errors::InvalidArgument(
                           "Your custom operator has set the InferShapeFn. "
                           "However, `Outputs` size = %d does not match the "
                           "returned vector size of InferShapeFn = %d. Please "
                           "check InferShapeFn again.",
-                          outputs.size(),
+                          signature.outputs.size(),
                           output_shapes.size()));
   } else {
     PADDLE_ENFORCE_EQ(
-        outputs.size(),
+        signature.outputs.size(),
         output_shapes.size() + inplace_map.size(),
         phi::errors::InvalidArgument(
             "Your custom operator uses `SetInplaceMap` and sets the "
             "InferShapeFn. However, `Outputs` size = %d does not match the "
             "`InplaceMap size + InferShapeFn output size` = %d. Please check "
             "InplaceMap and InferShapeFn again",
-            outputs.size(),
+            signature.outputs.size(),
             output_shapes.size() + inplace_map.size()));
   }
 
@@ -534,8 +620,9 @@ static void RunInferShapeFunc(
       << inplace_map.size()
       << ", output_shapes.size() = " << output_shapes.size();
   size_t output_shape_idx = 0;
-  for (auto out_name : outputs) {
-    if (detail::IsDuplicableVar(out_name)) {
+  for (auto& output : signature.outputs) {
+    auto& out_name = output.name;
+    if (output.is_duplicable) {
       PADDLE_ENFORCE(
           inplace_reverse_map.find(out_name) != inplace_reverse_map.end(),
           phi::errors::InvalidArgument(
@@ -549,7 +636,7 @@ static void RunInferShapeFunc(
         ctx->SetOutputsDim(out_name, ctx->GetInputsDim(in_name));
       } else {
         PADDLE_ENFORCE(
-            detail::IsOptionalVar(out_name),
+            output.is_optional,
             phi::errors::InvalidArgument(
                 "Custom operator couldn't find custom output name for %s. If "
                 "you are using inplace optional inputs & outputs, please check "
@@ -568,7 +655,7 @@ static void RunInferShapeFunc(
           ctx->ShareDim(inplace_reverse_map.at(out_name), out_name);
         } else {
           PADDLE_ENFORCE(
-              detail::IsOptionalVar(out_name),
+              output.is_optional,
               phi::errors::InvalidArgument(
                   "Custom operator couldn't find custom output name for %s. If "
                   "you are using inplace optional inputs & outputs, please "
@@ -916,11 +1003,13 @@ static void RegisterOperatorKernel(
   OperatorWithKernel::OpKernelFunc op_kernel_func;
   if (kernel_func) {
     VLOG(3) << "Register custom operator " << name << " with kernel func";
+    auto signature = MakeCustomOpSignature(inputs, outputs, attrs);
     op_kernel_func =
-        [kernel_func, inputs, outputs, attrs, inplace_map](  // NOLINT
+        [kernel_func, inputs, outputs, signature, inplace_map](  // NOLINT
             const framework::ExecutionContext& ctx) {
           VLOG(3) << "Custom Operator: run custom kernel func in lambda.";
-          RunKernelFunc(ctx, kernel_func, inputs, outputs, attrs, inplace_map);
+          RunKernelFunc(
+              ctx, kernel_func, inputs, outputs, signature, inplace_map);
         };
   } else {
     VLOG(3) << "Register custom operator " << name
@@ -1031,17 +1120,14 @@ void RegisterOperatorWithMetaInfo(const std::vector<OpMetaInfo>& op_meta_infos,
       RunDefaultInferShapeFunc(ctx, op_inputs, op_outputs, op_inplace_map);
     };
   } else {
-    info.infer_shape_ = [op_inputs,  // NOLINT
-                         op_outputs,
-                         op_attrs,
+    auto op_signature = MakeCustomOpSignature(op_inputs, op_outputs, op_attrs);
+    info.infer_shape_ = [op_signature,  // NOLINT
                          op_inplace_map,
                          op_inplace_reverse_map,
                          infer_shape_func](InferShapeContext* ctx) {
       RunInferShapeFunc(ctx,
                         infer_shape_func,
-                        op_inputs,
-                        op_outputs,
-                        op_attrs,
+                        op_signature,
                         op_inplace_map,
                         op_inplace_reverse_map);
     };
@@ -1216,17 +1302,15 @@ void RegisterOperatorWithMetaInfo(const std::vector<OpMetaInfo>& op_meta_infos,
         }
       };
     } else {
-      grad_info.infer_shape_ = [grad_op_inputs,  // NOLINT
-                                grad_op_outputs,
-                                grad_op_attrs,
+      auto grad_op_signature = MakeCustomOpSignature(
+          grad_op_inputs, grad_op_outputs, grad_op_attrs);
+      grad_info.infer_shape_ = [grad_op_signature,  // NOLINT
                                 grad_op_inplace_map,
                                 grad_op_inplace_reverse_map,
                                 grad_infer_shape_fn](InferShapeContext* ctx) {
         RunInferShapeFunc(ctx,
                           grad_infer_shape_fn,
-                          grad_op_inputs,
-                          grad_op_outputs,
-                          grad_op_attrs,
+                          grad_op_signature,
                           grad_op_inplace_map,
                           grad_op_inplace_reverse_map);
       };
@@ -26,11 +26,13 @@ limitations under the License. */
 #include <sys/stat.h>
 #endif
 #include "io/fs.h"
+#include "paddle/fluid/framework/io/slot_binary_file.h"
 #include "paddle/fluid/platform/monitor.h"
 #include "paddle/fluid/platform/timer.h"
 
 USE_INT_STAT(STAT_total_feasign_num_in_mem);
 PHI_DECLARE_bool(enable_ins_parser_file);
+PHI_DECLARE_int32(data_feed_pack_depth);
 namespace paddle {
 namespace framework {
 
@@ -216,6 +218,17 @@ void DataFeed::SetBatchSize(int batch_size) {
 }
 
 bool DataFeed::PickOneFile(std::string* filename) {
+  if (file_pipeline_ != nullptr) {
+    FileLoadPipeline::LoadedFile file;
+    if (!file_pipeline_->Pop(&file)) {
+      VLOG(3) << "DataFeed::PickOneFile no more file in the pipeline";
+      picked_file_data_ = nullptr;
+      return false;
+    }
+    *filename = file.filename;
+    picked_file_data_ = file.data;
+    return true;
+  }
   PADDLE_ENFORCE_NOT_NULL(
       mutex_for_pick_file_,
       platform::errors::PreconditionNotMet(
@@ -235,6 +248,14 @@ bool DataFeed::PickOneFile(std::string* filename) {
   return true;
 }
 
+std::shared_ptr<FILE> DataFeed::OpenPickedFile(const std::string& filename,
+                                               int* err_no) {
+  if (picked_file_data_ != nullptr) {
+    return FileLoadPipeline::OpenMemory(picked_file_data_);
+  }
+  return fs_open_read(filename, err_no, pipe_command_, true);
+}
+
 void DataFeed::CheckInit() {
   PADDLE_ENFORCE_EQ(
       finish_init_,
@@ -311,7 +332,7 @@ void PrivateQueueDataFeed<T>::ReadThread() {
   std::string filename;
   while (PickOneFile(&filename)) {
     int err_no = 0;
-    fp_ = fs_open_read(filename, &err_no, pipe_command_, true);
+    fp_ = OpenPickedFile(filename, &err_no);
     __fsetlocking(&*fp_, FSETLOCKING_BYCALLER);
     T instance;
     while (ParseOneInstanceFromPipe(&instance)) {
@@ -540,7 +561,7 @@ void InMemoryDataFeed<T>::LoadIntoMemory() {
     } else {
 #endif
       int err_no = 0;
-      this->fp_ = fs_open_read(filename, &err_no, this->pipe_command_, true);
+      this->fp_ = this->OpenPickedFile(filename, &err_no);
 #ifdef PADDLE_WITH_BOX_PS
     }
 #endif
@@ -684,7 +705,7 @@ void MultiSlotDataFeed::ReadThread() {
   std::string filename;
   while (PickOneFile(&filename)) {
     int err_no = 0;
-    fp_ = fs_open_read(filename, &err_no, pipe_command_, true);
+    fp_ = OpenPickedFile(filename, &err_no);
     CHECK(fp_ != nullptr);
     __fsetlocking(&*fp_, FSETLOCKING_BYCALLER);
     std::vector<MultiSlotType> instance;
@@ -2112,6 +2133,7 @@ void SlotRecordInMemoryDataFeed::Init(const DataFeedDesc& data_feed_desc) {
   pipe_command_ = data_feed_desc.pipe_command();
   finish_init_ = true;
   input_type_ = data_feed_desc.input_type();
+  binary_slot_format_ = data_feed_desc.binary_slot_format();
   size_t pos = pipe_command_.find(".so");
   if (pos != std::string::npos) {
     pos = pipe_command_.rfind('|');
@@ -2152,7 +2174,9 @@ void SlotRecordInMemoryDataFeed::InitGraphTrainResource() {
 
 void SlotRecordInMemoryDataFeed::LoadIntoMemory() {
   VLOG(3) << "SlotRecord LoadIntoMemory() begin, thread_id=" << thread_id_;
-  if (!so_parser_name_.empty()) {
+  if (binary_slot_format_) {
+    LoadIntoMemoryByBinary();
+  } else if (!so_parser_name_.empty()) {
     LoadIntoMemoryByLib();
   } else {
     LoadIntoMemoryByCommand();
@@ -2215,7 +2239,7 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByFile() {
             lines);
       } else {
         int err_no = 0;
-        this->fp_ = fs_open_read(filename, &err_no, this->pipe_command_, true);
+        this->fp_ = this->OpenPickedFile(filename, &err_no);
 
         CHECK(this->fp_ != nullptr);
         __fsetlocking(&*(this->fp_), FSETLOCKING_BYCALLER);
@@ -2305,7 +2329,7 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByLine() {
 
     do {
       int err_no = 0;
-      this->fp_ = fs_open_read(filename, &err_no, this->pipe_command_, true);
+      this->fp_ = this->OpenPickedFile(filename, &err_no);
       CHECK(this->fp_ != nullptr);
       __fsetlocking(&*(this->fp_), FSETLOCKING_BYCALLER);
       lines = line_reader.read_file(this->fp_.get(), line_func, lines);
@@ -2354,7 +2378,7 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
 
     do {
       int err_no = 0;
-      this->fp_ = fs_open_read(filename, &err_no, this->pipe_command_, true);
+      this->fp_ = this->OpenPickedFile(filename, &err_no);
       CHECK(this->fp_ != nullptr);
       __fsetlocking(&*(this->fp_), FSETLOCKING_BYCALLER);
 
@@ -2511,6 +2535,164 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
   return (uint64_total_slot_num > 0);
 }
 
+void SlotRecordInMemoryDataFeed::LoadIntoMemoryByBinary() {
+#ifdef _LINUX
+  std::string filename;
+  std::default_random_engine random_engine(std::random_device{}());
+  std::uniform_real_distribution<float> uniform_distribution(0.0f, 1.0f);
+  bool do_sample = std::abs(sample_rate_ - 1.0f) >= 1e-5f;
+  size_t total_ins = 0;
+
+  while (this->PickOneFile(&filename)) {
+    VLOG(3) << "PickOneFile, filename=" << filename
+            << ", thread_id=" << thread_id_;
+    platform::Timer timeline;
+    timeline.Start();
+    int err_no = 0;
+    this->fp_ = this->OpenPickedFile(filename, &err_no);
+    CHECK(this->fp_ != nullptr);
+    __fsetlocking(&*(this->fp_), FSETLOCKING_BYCALLER);
+    SlotBinaryReader reader(this->fp_.get());
+    const auto& header = reader.header();
+    PADDLE_ENFORCE_EQ(
+        !parse_ins_id_ || (header.flags & SlotBinaryFile::kWithInsId),
+        true,
+        platform::errors::InvalidArgument(
+            "The ins_id is parsed, but the file %s is without ins_id.",
+            filename));
+    PADDLE_ENFORCE_EQ(
+        !parse_logkey_ || (header.flags & SlotBinaryFile::kWithLogKey),
+        true,
+        platform::errors::InvalidArgument(
+            "The logkey is parsed, but the file %s is without logkey.",
+            filename));
+
+    // the columns of the used slots, in the order of slot_value_idx
+    std::vector<int> uint64_columns(uint64_use_slot_size_, -1);
+    std::vector<int> float_columns(float_use_slot_size_, -1);
+    std::vector<bool> float_dense(float_use_slot_size_, false);
+    for (auto& info : all_slots_info_) {
+      if (info.used_idx == -1) {
+        continue;
+      }
+      auto it = std::find(
+          header.slot_names.begin(), header.slot_names.end(), info.slot);
+      PADDLE_ENFORCE_EQ(it != header.slot_names.end(),
+                        true,
+                        platform::errors::NotFound(
+                            "The slot %s is not in the file %s.",
+                            info.slot,
+                            filename));
+      int column = static_cast<int>(it - header.slot_names.begin());
+      PADDLE_ENFORCE_EQ(header.slot_types[column],
+                        info.type[0],
+                        platform::errors::InvalidArgument(
+                            "The type of the slot %s in the file %s is '%c', "
+                            "which is not the type %s of the data feed.",
+                            info.slot,
+                            filename,
+                            header.slot_types[column],
+                            info.type));
+      if (info.type[0] == 'f') {
+        float_columns[info.slot_value_idx] = column;
+        float_dense[info.slot_value_idx] =
+            used_slots_info_[info.used_idx].dense;
+      } else {
+        uint64_columns[info.slot_value_idx] = column;
+      }
+    }
+
+    std::vector<SlotRecord> record_vec;
+    SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
+    int offset = 0;
+    size_t sample_ins = 0;
+    while (reader.NextBlock()) {
+      for (int ins = 0; ins < reader.ins_num(); ++ins) {
+        if (do_sample &&
+            uniform_distribution(random_engine) >= sample_rate_) {
+          continue;
+        }
+        SlotRecord& rec = record_vec[offset];
+        size_t len = 0;
+        if (parse_ins_id_) {
+          const char* str = reader.ins_id(ins, &len);
+          rec->ins_id_.assign(str, len);
+        }
+        if (parse_logkey_) {
+          const char* str = reader.logkey(ins, &len);
+          rec->ins_id_.assign(str, len);
+          parser_log_key(
+              rec->ins_id_, &rec->search_id, &rec->cmatch, &rec->rank);
+        }
+
+        auto& uint64_feas = rec->slot_uint64_feasigns_;
+        uint64_feas.slot_offsets.resize(uint64_use_slot_size_ + 1);
+        for (int i = 0; i < uint64_use_slot_size_; ++i) {
+          uint64_feas.slot_offsets[i] =
+              static_cast<uint32_t>(uint64_feas.slot_values.size());
+          const uint64_t* values =
+              reader.uint64_feasigns(uint64_columns[i], ins, &len);
+          uint64_feas.slot_values.insert(
+              uint64_feas.slot_values.end(), values, values + len);
+        }
+        uint64_feas.slot_offsets[uint64_use_slot_size_] =
+            static_cast<uint32_t>(uint64_feas.slot_values.size());
+
+        auto& float_feas = rec->slot_float_feasigns_;
+        float_feas.slot_offsets.resize(float_use_slot_size_ + 1);
+        for (int i = 0; i < float_use_slot_size_; ++i) {
+          float_feas.slot_offsets[i] =
+              static_cast<uint32_t>(float_feas.slot_values.size());
+          const float* values =
+              reader.float_feasigns(float_columns[i], ins, &len);
+          for (size_t j = 0; j < len; ++j) {
+            // zeros of the sparse float slots are dropped as the text parser
+            if (fabs(values[j]) < 1e-6 && !float_dense[i]) {
+              continue;
+            }
+            float_feas.slot_values.push_back(values[j]);
+          }
+        }
+        float_feas.slot_offsets[float_use_slot_size_] =
+            static_cast<uint32_t>(float_feas.slot_values.size());
+
+        if (uint64_feas.slot_values.empty()) {
+          rec->reset();
+          continue;
+        }
+        ++sample_ins;
+        if (++offset >= OBJPOOL_BLOCK_SIZE) {
+          input_channel_->Write(std::move(record_vec));
+          record_vec.clear();
+          SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
+          offset = 0;
+        }
+      }
+    }
+    if (offset > 0) {
+      input_channel_->WriteMove(offset, &record_vec[0]);
+      if (offset < OBJPOOL_BLOCK_SIZE) {
+        SlotRecordPool().put(&record_vec[offset],
+                             (OBJPOOL_BLOCK_SIZE - offset));
+      }
+    } else {
+      SlotRecordPool().put(&record_vec);
+    }
+    record_vec.clear();
+    record_vec.shrink_to_fit();
+    total_ins += reader.total_ins_num();
+    timeline.Pause();
+    VLOG(3) << "LoadIntoMemoryByBinary() read all blocks, file=" << filename
+            << ", ins=" << reader.total_ins_num()
+            << ", sample ins=" << sample_ins
+            << ", cost time=" << timeline.ElapsedSec()
+            << " seconds, thread_id=" << thread_id_;
+  }
+  VLOG(3) << "LoadIntoMemoryByBinary() end, thread_id=" << thread_id_
+          << ", total ins: " << total_ins;
+#endif
+}
+
 void SlotRecordInMemoryDataFeed::AssignFeedVar(const Scope& scope) {
   CheckInit();
 #if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_HETERPS)
@@ -2701,7 +2883,9 @@ bool SlotRecordInMemoryDataFeed::Start() {
   this->finish_start_ = true;
 #if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_HETERPS)
   CHECK(paddle::platform::is_gpu_place(this->place_));
-  for (int i = 0; i < pack_thread_num_ + 1; i++) {
+  // the packs beyond the pack threads hold the ready batches ahead
+  int pack_num = pack_thread_num_ + std::max(FLAGS_data_feed_pack_depth, 1);
+  for (int i = 0; i < pack_num; i++) {
     auto pack = BatchGpuPackMgr().get(this->GetPlace(), used_slots_info_);
     pack_vec_.push_back(pack);
     free_pack_queue_.Push(pack);
@@ -2731,6 +2915,7 @@ bool SlotRecordInMemoryDataFeed::Start() {
         paddle::platform::SetDeviceId(place_.GetDeviceId());
         pack->pack_instance(&records_[offset], batch_size);
         this->BuildSlotBatchGPU(batch_size, pack);
+        pack->record_ready();
         using_pack_queue_.Push(pack);
       }
     }));
@@ -2751,7 +2936,7 @@ int SlotRecordInMemoryDataFeed::Next() {
 #if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_HETERPS)
     while (true) {
       if (last_pack_ != nullptr) {
-        free_pack_queue_.Push(last_pack_);
+        ReleasePack(last_pack_);
         last_pack_ = nullptr;
       }
       if (using_pack_queue_.Size() != 0) {
@@ -2861,11 +3046,13 @@ void SlotRecordInMemoryDataFeed::BuildSlotBatchGPU(const int ins_num,
   size_t float_zero_slot_index = 0;
   size_t uint64_zero_slot_index = 0;
 
-  // copy index
-  CUDA_CHECK(cudaMemcpy(offsets.data(),
-                        d_slot_offsets,
-                        slot_total_num * sizeof(size_t),
-                        cudaMemcpyDeviceToHost));
+  // copy index, the only wait of the pack thread for its stream
+  CUDA_CHECK(cudaMemcpyAsync(offsets.data(),
+                             d_slot_offsets,
+                             slot_total_num * sizeof(size_t),
+                             cudaMemcpyDeviceToHost,
+                             pack->get_stream()));
+  CUDA_CHECK(cudaStreamSynchronize(pack->get_stream()));
   auto* dev_ctx = static_cast<phi::GPUContext*>(
       platform::DeviceContextPool::Instance().Get(this->place_));
   for (int j = 0; j < use_slot_size_; ++j) {
@@ -2938,8 +3125,23 @@ void SlotRecordInMemoryDataFeed::BuildSlotBatchGPU(const int ins_num,
                 pack->get_stream());
 }
 
+cudaStream_t SlotRecordInMemoryDataFeed::ComputeStream() {
+  auto* dev_ctx = static_cast<phi::GPUContext*>(
+      platform::DeviceContextPool::Instance().Get(this->place_));
+  return dev_ctx->stream();
+}
+
+void SlotRecordInMemoryDataFeed::ReleasePack(MiniBatchGpuPack* pack) {
+  // the ops of the batch may be still running on the compute stream
+  pack->record_consumed(ComputeStream());
+  free_pack_queue_.Push(pack);
+}
+
 void SlotRecordInMemoryDataFeed::PackToScope(MiniBatchGpuPack* pack,
                                              const Scope* scope) {
+  // the ops of the batch run after the copies of the pack
+  pack->wait_ready(ComputeStream());
+
   int64_t float_offset = 0;
   int64_t uint64_offset = 0;
   size_t float_zero_slot_index = 0;
@@ -3014,7 +3216,7 @@ void SlotRecordInMemoryDataFeed::PackToScope(MiniBatchGpuPack* pack,
 MiniBatchGpuPack* SlotRecordInMemoryDataFeed::get_pack(
     MiniBatchGpuPack* last_pack) {
   if (last_pack != nullptr) {
-    free_pack_queue_.Push(last_pack);
+    ReleasePack(last_pack);
     return nullptr;
   }
 
@@ -3040,6 +3242,9 @@ MiniBatchGpuPack::MiniBatchGpuPack(const paddle::platform::Place& place,
   place_ = place;
   stream_holder_.reset(new phi::CUDAStream(place));
   stream_ = stream_holder_->raw_stream();
+  CUDA_CHECK(cudaEventCreateWithFlags(&ready_event_, cudaEventDisableTiming));
+  CUDA_CHECK(
+      cudaEventCreateWithFlags(&consumed_event_, cudaEventDisableTiming));
 
   ins_num_ = 0;
   pv_num_ = 0;
@@ -3069,7 +3274,10 @@ MiniBatchGpuPack::MiniBatchGpuPack(const paddle::platform::Place& place,
   uint64_tensor_vec_.resize(used_slot_size_);
 }
 
-MiniBatchGpuPack::~MiniBatchGpuPack() {}
+MiniBatchGpuPack::~MiniBatchGpuPack() {
+  CUDA_CHECK(cudaEventDestroy(ready_event_));
+  CUDA_CHECK(cudaEventDestroy(consumed_event_));
+}
 
 void MiniBatchGpuPack::reset(const paddle::platform::Place& place) {
   place_ = place;
@@ -3237,6 +3445,8 @@ void MiniBatchGpuPack::pack_instance(const SlotRecord* ins_vec, int num) {
 }
 
 void MiniBatchGpuPack::transfer_to_gpu() {
+  // the device buffers are overwritten after the last batch is consumed
+  CUDA_CHECK(cudaStreamWaitEvent(stream_, consumed_event_, 0));
   copy_host2device(&value_.d_uint64_lens, buf_.h_uint64_lens);
   copy_host2device(&value_.d_uint64_keys, buf_.h_uint64_keys);
   copy_host2device(&value_.d_uint64_offset, buf_.h_uint64_offset);
@@ -3244,7 +3454,6 @@ void MiniBatchGpuPack::transfer_to_gpu() {
   copy_host2device(&value_.d_float_lens, buf_.h_float_lens);
   copy_host2device(&value_.d_float_keys, buf_.h_float_keys);
   copy_host2device(&value_.d_float_offset, buf_.h_float_offset);
-  CUDA_CHECK(cudaStreamSynchronize(stream_));
 }
 #endif
 
@@ -37,6 +37,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/channel.h"
 #include "paddle/fluid/framework/data_feed.pb.h"
 #include "paddle/fluid/framework/fleet/fleet_wrapper.h"
+#include "paddle/fluid/framework/io/file_load_pipeline.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/reader.h"
 #include "paddle/fluid/framework/variable.h"
@@ -603,6 +604,20 @@ class MiniBatchGpuPack {
 
   cudaStream_t get_stream() { return stream_; }
 
+  // The pack is built on its own copy stream while a trainer computes the
+  // former batches. The events order the two streams without blocking the
+  // host: the trainer waits for the pack to be ready, and the next batch
+  // packed into it waits for the trainer to finish with the last one.
+  void record_ready(void) {
+    CUDA_CHECK(cudaEventRecord(ready_event_, stream_));
+  }
+  void wait_ready(cudaStream_t stream) {
+    CUDA_CHECK(cudaStreamWaitEvent(stream, ready_event_, 0));
+  }
+  void record_consumed(cudaStream_t stream) {
+    CUDA_CHECK(cudaEventRecord(consumed_event_, stream));
+  }
+
  private:
   void transfer_to_gpu(void);
   void pack_all_data(const SlotRecord* ins_vec, int num);
@@ -629,6 +644,8 @@ class MiniBatchGpuPack {
   paddle::platform::Place place_;
   std::unique_ptr<phi::CUDAStream> stream_holder_;
   cudaStream_t stream_;
+  cudaEvent_t ready_event_;
+  cudaEvent_t consumed_event_;
   BatchGPUValue value_;
   BatchCPUValue buf_;
   int ins_num_ = 0;
@@ -1213,6 +1230,10 @@ class DataFeed {
   }
   virtual void SetFeaNumMutex(std::mutex* mutex) { mutex_for_fea_num_ = mutex; }
   virtual void SetFileListIndex(size_t* file_index) { file_idx_ = file_index; }
+  // pick the files prefetched by the pipeline instead of the filelist
+  virtual void SetFileLoadPipeline(FileLoadPipeline* pipeline) {
+    file_pipeline_ = pipeline;
+  }
   virtual void SetFeaNum(uint64_t* fea_num) { total_fea_num_ = fea_num; }
   virtual const std::vector<std::string>& GetInsIdVec() const {
     return ins_id_vec_;
@@ -1357,11 +1378,17 @@ class DataFeed {
   // This function is used to pick one file from the global filelist(thread
   // safe).
   virtual bool PickOneFile(std::string* filename);
+  // Open the picked file by the pipe command, which is read from the memory
+  // if it is prefetched by the file_pipeline_.
+  std::shared_ptr<FILE> OpenPickedFile(const std::string& filename,
+                                       int* err_no);
   virtual void CopyToFeedTensor(void* dst, const void* src, size_t size);
 
   std::vector<std::string> filelist_;
   size_t* file_idx_;
   std::mutex* mutex_for_pick_file_;
+  FileLoadPipeline* file_pipeline_ = nullptr;
+  std::shared_ptr<std::string> picked_file_data_;
   std::mutex* mutex_for_fea_num_ = nullptr;
   uint64_t* total_fea_num_ = nullptr;
   uint64_t fea_num_ = 0;
@@ -1913,6 +1940,7 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
   virtual void LoadIntoMemoryByLib(void);
   virtual void LoadIntoMemoryByLine(void);
   virtual void LoadIntoMemoryByFile(void);
+  virtual void LoadIntoMemoryByBinary(void);
   void SetInputChannel(void* channel) override {
     input_channel_ = static_cast<ChannelObject<SlotRecord>*>(channel);
   }
@@ -1928,6 +1956,9 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
   }
 #if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_HETERPS)
   void BuildSlotBatchGPU(const int ins_num, MiniBatchGpuPack* pack);
+  // return a consumed pack to the pack threads
+  void ReleasePack(MiniBatchGpuPack* pack);
+  cudaStream_t ComputeStream();
 
   virtual MiniBatchGpuPack* get_pack(MiniBatchGpuPack* last_pack);
 
@@ -1978,6 +2009,7 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
   void DumpSampleNeighbors(std::string dump_path) override;
 
   float sample_rate_ = 1.0f;
+  bool binary_slot_format_ = false;
   int use_slot_size_ = 0;
   int float_use_slot_size_ = 0;
   int uint64_use_slot_size_ = 0;
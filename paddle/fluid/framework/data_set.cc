@@ -42,6 +42,8 @@ PHI_DECLARE_bool(graph_get_neighbor_id);
 PHI_DECLARE_int32(gpugraph_storage_mode);
 PHI_DECLARE_string(graph_edges_split_mode);
 PHI_DECLARE_bool(query_dest_rank_by_multi_node);
+PHI_DECLARE_int32(dataset_load_read_threads);
+PHI_DECLARE_int32(dataset_load_decompress_threads);
 
 namespace paddle {
 namespace framework {
@@ -559,6 +561,7 @@ void DatasetImpl<T>::LoadIntoMemory() {
             << "]";
 #endif
   } else {
+    StartFileLoadPipeline(readers_);
     std::vector<std::thread> load_threads;
     for (int64_t i = 0; i < thread_num_; ++i) {
       load_threads.emplace_back(&paddle::framework::DataFeed::LoadIntoMemory,
@@ -567,6 +570,7 @@ void DatasetImpl<T>::LoadIntoMemory() {
     for (std::thread& t : load_threads) {
       t.join();
     }
+    StopFileLoadPipeline(readers_);
   }
   input_channel_->Close();
   int64_t in_chan_size = input_channel_->Size();
@@ -583,6 +587,7 @@ void DatasetImpl<T>::PreLoadIntoMemory() {
   VLOG(3) << "DatasetImpl<T>::PreLoadIntoMemory() begin";
   if (preload_thread_num_ != 0) {
     CHECK(static_cast<size_t>(preload_thread_num_) == preload_readers_.size());
+    StartFileLoadPipeline(preload_readers_);
     preload_threads_.clear();
     for (int64_t i = 0; i < preload_thread_num_; ++i) {
       preload_threads_.emplace_back(
@@ -591,6 +596,7 @@ void DatasetImpl<T>::PreLoadIntoMemory() {
     }
   } else {
     CHECK(static_cast<size_t>(thread_num_) == readers_.size());
+    StartFileLoadPipeline(readers_);
     preload_threads_.clear();
     for (int64_t i = 0; i < thread_num_; ++i) {
       preload_threads_.emplace_back(
@@ -606,12 +612,58 @@ void DatasetImpl<T>::WaitPreLoadDone() {
   for (std::thread& t : preload_threads_) {
     t.join();
   }
+  StopFileLoadPipeline(preload_thread_num_ != 0 ? preload_readers_ : readers_);
   input_channel_->Close();
   int64_t in_chan_size = input_channel_->Size();
   input_channel_->SetBlockSize(in_chan_size / thread_num_ + 1);
   VLOG(3) << "DatasetImpl<T>::WaitPreLoadDone() end";
 }
 
+template <typename T>
+void DatasetImpl<T>::StartFileLoadPipeline(
+    const std::vector<std::shared_ptr<paddle::framework::DataFeed>>& readers) {
+  if (FLAGS_dataset_load_read_threads <= 0 || filelist_.empty()) {
+    return;
+  }
+  // the files are parsed from the memory, so a pipe command other than cat,
+  // which also covers the so parsers, has to read the files by itself
+  std::string pipe_command =
+      paddle::string::trim_spaces(data_feed_desc_.pipe_command());
+  if ((!pipe_command.empty() && pipe_command != "cat") ||
+      !data_feed_desc_.so_parser_name().empty()) {
+    VLOG(1) << "FileLoadPipeline is disabled by the pipe command ["
+            << pipe_command << "] or the so parser ["
+            << data_feed_desc_.so_parser_name() << "]";
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_for_pick_file_);
+    std::vector<std::string> filelist(filelist_.begin() + file_idx_,
+                                      filelist_.end());
+    file_idx_ = filelist_.size();
+    file_pipeline_ = std::make_unique<FileLoadPipeline>(
+        filelist,
+        FLAGS_dataset_load_read_threads,
+        std::max(FLAGS_dataset_load_decompress_threads, 1),
+        std::max<size_t>(readers.size(), 1));
+  }
+  for (auto& reader : readers) {
+    reader->SetFileLoadPipeline(file_pipeline_.get());
+  }
+}
+
+template <typename T>
+void DatasetImpl<T>::StopFileLoadPipeline(
+    const std::vector<std::shared_ptr<paddle::framework::DataFeed>>& readers) {
+  if (file_pipeline_ == nullptr) {
+    return;
+  }
+  for (auto& reader : readers) {
+    reader->SetFileLoadPipeline(nullptr);
+  }
+  file_pipeline_.reset();
+}
+
 // release memory data
 template <typename T>
 void DatasetImpl<T>::ReleaseMemory() {
@@ -825,6 +877,119 @@ void MultiSlotDataset::TDMSample(const std::string tree_name,
   return;
 }
 
+void MultiSlotDataset::SendInputToTrainers(int local_trainer_id) {
+#ifdef PADDLE_WITH_PSCORE
+  auto fleet_ptr = distributed::FleetWrapper::GetInstance();
+#else
+  auto fleet_ptr = framework::FleetWrapper::GetInstance();
+#endif
+  auto get_client_id = [this, fleet_ptr](const Record& data) -> size_t {
+    if (this->merge_by_insid_) {
+      return XXH64(data.ins_id_.data(), data.ins_id_.length(), 0) %
+             this->trainer_num_;
+    } else if (this->shuffle_by_uid_) {
+      return XXH64(data.uid_.data(), data.uid_.length(), 0) %
+             this->trainer_num_;
+    } else {
+      return fleet_ptr->LocalRandomEngine()() % this->trainer_num_;
+    }
+  };
+
+  std::vector<Record> data;
+  std::vector<Record> local_data;
+  while (this->input_channel_->Read(data)) {
+    std::vector<paddle::framework::BinaryArchive> ars(this->trainer_num_);
+    for (auto& t : data) {
+      auto client_id = get_client_id(t);
+      if (static_cast<int>(client_id) == local_trainer_id) {
+        local_data.push_back(std::move(t));
+      } else {
+        ars[client_id] << t;
+      }
+    }
+    std::vector<std::future<int32_t>> total_status;
+    std::vector<int> send_index(this->trainer_num_);
+    for (int i = 0; i < this->trainer_num_; ++i) {
+      send_index[i] = i;
+    }
+    std::shuffle(
+        send_index.begin(), send_index.end(), fleet_ptr->LocalRandomEngine());
+    for (int index = 0; index < this->trainer_num_; ++index) {
+      int i = send_index[index];
+      if (ars[i].Length() == 0) {
+        continue;
+      }
+      std::string msg(ars[i].Buffer(), ars[i].Length());
+      auto ret = fleet_ptr->SendClientToClientMsg(0, i, msg);
+      total_status.push_back(std::move(ret));
+    }
+    // the local part is merged while the others are in flight
+    if (!local_data.empty()) {
+      WriteToOutputChannel(&local_data);
+      local_data.clear();
+    }
+    for (auto& t : total_status) {
+      t.wait();
+    }
+    ars.clear();
+    ars.shrink_to_fit();
+    data.clear();
+    data.shrink_to_fit();
+    // currently we find bottleneck is server not able to handle large data
+    // in time, so we can remove this sleep and set fleet_send_batch_size to
+    // 1024, and set server thread to 24.
+    if (fleet_send_sleep_seconds_ != 0) {
+      sleep(this->fleet_send_sleep_seconds_);
+    }
+  }
+}
+
+void MultiSlotDataset::WriteToOutputChannel(std::vector<Record>* data) {
+  // not use random because it doesn't perform well here.
+  // to make sure each channel get data equally, we just put data to
+  // channel one by one.
+  // int64_t index = fleet_ptr->LocalRandomEngine()() % channel_num_;
+  int64_t index = 0;
+  {
+    std::unique_lock<std::mutex> lk(global_index_mutex_);
+    index = global_index_++;
+  }
+  index = index % channel_num_;
+  VLOG(3) << "ramdom index=" << index;
+  multi_output_channel_[index]->Write(std::move(*data));
+}
+
+void MultiSlotDataset::LoadIntoMemory() {
+  if (streaming_shuffle_trainer_id_ < 0) {
+    DatasetImpl<Record>::LoadIntoMemory();
+    return;
+  }
+  // The senders partition the data by blocks of fleet_send_batch_size as the
+  // readers parse it, and drain the input channel after the load closes it.
+  VLOG(3) << "MultiSlotDataset::LoadIntoMemory() with streaming global "
+          << "shuffle, trainer_id=" << streaming_shuffle_trainer_id_
+          << ", trainer_num=" << trainer_num_;
+  platform::Timer timeline;
+  timeline.Start();
+  input_channel_->SetBlockSize(fleet_send_batch_size_);
+  auto send_func = [this]() {
+    SendInputToTrainers(streaming_shuffle_trainer_id_);
+  };
+  std::vector<std::thread> send_threads;
+  for (int i = 0; i < thread_num_; ++i) {
+    send_threads.emplace_back(send_func);
+  }
+  DatasetImpl<Record>::LoadIntoMemory();
+  for (std::thread& t : send_threads) {
+    t.join();
+  }
+  input_channel_->Clear();
+  timeline.Pause();
+  VLOG(3) << "MultiSlotDataset::LoadIntoMemory() end, shuffle data size="
+          << GetShuffleDataSize() << ", cost time=" << timeline.ElapsedSec()
+          << " seconds";
+}
+
 void MultiSlotDataset::GlobalShuffle(int thread_num) {
   VLOG(3) << "MultiSlotDataset::GlobalShuffle() begin";
   platform::Timer timeline;
@@ -855,63 +1020,7 @@ void MultiSlotDataset::GlobalShuffle(int thread_num) {
   VLOG(3) << "MultiSlotDataset::GlobalShuffle() input_channel_ size "
           << input_channel_->Size();
 
-  auto get_client_id = [this, fleet_ptr](const Record& data) -> size_t {
-    if (this->merge_by_insid_) {
-      return XXH64(data.ins_id_.data(), data.ins_id_.length(), 0) %
-             this->trainer_num_;
-    } else if (this->shuffle_by_uid_) {
-      return XXH64(data.uid_.data(), data.uid_.length(), 0) %
-             this->trainer_num_;
-    } else {
-      return fleet_ptr->LocalRandomEngine()() % this->trainer_num_;
-    }
-  };
-
-  auto global_shuffle_func = [this, get_client_id]() {
-#ifdef PADDLE_WITH_PSCORE
-    auto fleet_ptr = distributed::FleetWrapper::GetInstance();
-#else
-    auto fleet_ptr = framework::FleetWrapper::GetInstance();
-#endif
-    // auto fleet_ptr = framework::FleetWrapper::GetInstance();
-    std::vector<Record> data;
-    while (this->input_channel_->Read(data)) {
-      std::vector<paddle::framework::BinaryArchive> ars(this->trainer_num_);
-      for (auto& t : data) {
-        auto client_id = get_client_id(t);
-        ars[client_id] << t;
-      }
-      std::vector<std::future<int32_t>> total_status;
-      std::vector<int> send_index(this->trainer_num_);
-      for (int i = 0; i < this->trainer_num_; ++i) {
-        send_index[i] = i;
-      }
-      std::shuffle(
-          send_index.begin(), send_index.end(), fleet_ptr->LocalRandomEngine());
-      for (int index = 0; index < this->trainer_num_; ++index) {
-        int i = send_index[index];
-        if (ars[i].Length() == 0) {
-          continue;
-        }
-        std::string msg(ars[i].Buffer(), ars[i].Length());
-        auto ret = fleet_ptr->SendClientToClientMsg(0, i, msg);
-        total_status.push_back(std::move(ret));
-      }
-      for (auto& t : total_status) {
-        t.wait();
-      }
-      ars.clear();
-      ars.shrink_to_fit();
-      data.clear();
-      data.shrink_to_fit();
-      // currently we find bottleneck is server not able to handle large data
-      // in time, so we can remove this sleep and set fleet_send_batch_size to
-      // 1024, and set server thread to 24.
-      if (fleet_send_sleep_seconds_ != 0) {
-        sleep(this->fleet_send_sleep_seconds_);
-      }
-    }
-  };
+  auto global_shuffle_func = [this]() { SendInputToTrainers(-1); };
 
   std::vector<std::thread> global_shuffle_threads;
   if (thread_num == -1) {
@@ -1277,19 +1386,7 @@ int MultiSlotDataset::ReceiveFromClient(int msg_type,
   }
   CHECK(ar.Cursor() == ar.Finish());
 
-  auto fleet_ptr = framework::FleetWrapper::GetInstance();
-  // not use random because it doesn't perform well here.
-  // to make sure each channel get data equally, we just put data to
-  // channel one by one.
-  // int64_t index = fleet_ptr->LocalRandomEngine()() % channel_num_;
-  int64_t index = 0;
-  {
-    std::unique_lock<std::mutex> lk(global_index_mutex_);
-    index = global_index_++;
-  }
-  index = index % channel_num_;
-  VLOG(3) << "ramdom index=" << index;
-  multi_output_channel_[index]->Write(std::move(data));
+  WriteToOutputChannel(&data);
 
   data.clear();
   data.shrink_to_fit();
@@ -127,6 +127,10 @@ class Dataset {
   virtual void LocalShuffle() = 0;
   // global shuffle data
   virtual void GlobalShuffle(int thread_num = -1) = 0;
+  // send the data to the trainers while it is loaded, which takes the place
+  // of GlobalShuffle, trainer_id is the client id of this trainer and -1
+  // disables it
+  virtual void SetStreamingGlobalShuffle(int trainer_id) = 0;
   virtual void SlotsShuffle(const std::set<std::string>& slots_to_replace) = 0;
   // create readers
   virtual void CreateReaders() = 0;
@@ -308,6 +312,9 @@ class DatasetImpl : public Dataset {
 
   virtual void SetPassId(uint32_t pass_id) { pass_id_ = pass_id; }
   virtual uint32_t GetPassID() { return pass_id_; }
+  virtual void SetStreamingGlobalShuffle(int trainer_id) {
+    streaming_shuffle_trainer_id_ = trainer_id;
+  }
 
  protected:
   virtual int ReceiveFromClient(int msg_type UNUSED,
@@ -316,6 +323,13 @@ class DatasetImpl : public Dataset {
     // TODO(yaoxuefeng) for SlotRecordDataset
     return -1;
   }
+  // prefetch the filelist for the readers by FLAGS_dataset_load_read_threads
+  virtual void StartFileLoadPipeline(
+      const std::vector<std::shared_ptr<paddle::framework::DataFeed>>&
+          readers);
+  virtual void StopFileLoadPipeline(
+      const std::vector<std::shared_ptr<paddle::framework::DataFeed>>&
+          readers);
   std::vector<std::shared_ptr<paddle::framework::DataFeed>> readers_;
   std::vector<std::shared_ptr<paddle::framework::DataFeed>> preload_readers_;
   paddle::framework::Channel<T> input_channel_;
@@ -341,6 +355,7 @@ class DatasetImpl : public Dataset {
   size_t file_idx_;
   uint64_t total_fea_num_;
   std::mutex mutex_for_pick_file_;
+  std::unique_ptr<FileLoadPipeline> file_pipeline_;
   std::mutex mutex_for_fea_num_;
   std::string fs_name_;
   std::string fs_ugi_;
@@ -363,6 +378,7 @@ class DatasetImpl : public Dataset {
   int preload_thread_num_;
   std::mutex global_index_mutex_;
   int64_t global_index_ = 0;
+  int streaming_shuffle_trainer_id_ = -1;
   std::vector<std::shared_ptr<ThreadPool>> consume_task_pool_;
   std::vector<T> input_records_;  // only for paddleboxdatafeed
   std::vector<std::string> use_slots_;
@@ -415,6 +431,7 @@ class MultiSlotDataset : public DatasetImpl<Record> {
       const std::unordered_set<uint16_t>& slots_to_replace,
       std::vector<Record>* result);
   virtual ~MultiSlotDataset() {}
+  virtual void LoadIntoMemory();
   virtual void GlobalShuffle(int thread_num = -1);
   virtual void DynamicAdjustReadersNum(int thread_num);
   virtual void PrepareTrain();
@@ -423,6 +440,11 @@ class MultiSlotDataset : public DatasetImpl<Record> {
   virtual int ReceiveFromClient(int msg_type,
                                 int client_id,
                                 const std::string& msg);
+  // partition the input channel to the trainers until it is closed, the part
+  // of this trainer is written into the output channels without rpc if
+  // local_trainer_id >= 0
+  void SendInputToTrainers(int local_trainer_id);
+  void WriteToOutputChannel(std::vector<Record>* data);
 };
 class SlotRecordDataset : public DatasetImpl<SlotRecord> {
  public:
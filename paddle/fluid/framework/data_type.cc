@@ -23,6 +23,8 @@
 using float16 = paddle::platform::float16;
 using bfloat16 = paddle::platform::bfloat16;
 using pstring = phi::dtype::pstring;
+using float8_e4m3fn = phi::dtype::float8_e4m3fn;
+using float8_e5m2 = phi::dtype::float8_e5m2;
 
 namespace paddle {
 namespace framework {
@@ -62,6 +64,9 @@ static DataTypeMap* InitDataTypeMap() {
   _ForEachDataType_(RegType);
   // Register pstring individually
   RegType(pstring, proto::VarType::PSTRING);
+  // Register the fp8 types individually
+  RegType(float8_e4m3fn, proto::VarType::FP8_E4M3FN);
+  RegType(float8_e5m2, proto::VarType::FP8_E5M2);
 #undef RegType
   return retv;
 }
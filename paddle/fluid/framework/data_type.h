@@ -120,6 +120,9 @@ struct DataTypeTrait<void> {
   }
 
 _ForEachDataType_(DefineDataTypeTrait);
+// The fp8 types are storage only, they are not visited with the others
+DefineDataTypeTrait(::phi::dtype::float8_e4m3fn, proto::VarType::FP8_E4M3FN);
+DefineDataTypeTrait(::phi::dtype::float8_e5m2, proto::VarType::FP8_E5M2);
 
 #undef DefineDataTypeTrait
 
@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #pragma once
+#include <atomic>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -21,7 +23,11 @@
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/imperative/type_defs.h"
 #include "paddle/fluid/imperative/var_helper.h"
+#include "paddle/fluid/memory/allocation/allocator.h"
 #include "paddle/fluid/platform/place.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/platform/device/gpu/gpu_resource_pool.h"
+#endif
 namespace paddle {
 namespace framework {
 namespace details {
@@ -54,6 +60,38 @@ void CheckOpHasNanOrInfInDygraph(const std::string& op_type,
   }
 }
 
+// Accumulates whether the outputs of the ops of a step hold NAN/INF into a
+// flag on the place, see FLAGS_check_nan_inf_async. On the gpu the flag of a
+// step is copied to the host at its end and read at the end of the next step,
+// so the check never waits for the device.
+class NanInfStepChecker {
+ public:
+  explicit NanInfStepChecker(const platform::Place& place);
+
+  // Whether the ops of the step are checked one by one by CheckOpHasNanOrInf,
+  // that is the last checked step found NAN/INF.
+  bool IsFullCheck() const { return full_check_; }
+
+  // Thread safe, the ops of a step may run on many threads.
+  void AccumulateOp(const framework::OperatorBase& op,
+                    const framework::Scope& scope);
+
+  void FinishStep();
+
+ private:
+  platform::Place place_;
+  phi::DenseTensor found_nan_inf_;
+  memory::allocation::AllocationPtr host_found_nan_inf_;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  std::shared_ptr<platform::CudaEventObject> event_;
+#endif
+  // Whether the flag of the last step is being copied to the host.
+  bool pending_{false};
+  bool full_check_{false};
+  int64_t step_{0};
+  std::atomic<int64_t> op_count_{0};
+};
+
 }  // namespace details
 }  // namespace framework
 }  // namespace paddle
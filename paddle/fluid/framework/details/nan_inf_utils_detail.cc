@@ -20,8 +20,15 @@
 #include "paddle/phi/common/amp_type_traits.h"
 
 #include "paddle/fluid/framework/convert_utils.h"
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/memory/memcpy.h"
 #include "paddle/phi/core/flags.h"
 #include "paddle/phi/kernels/funcs/eigen/extensions.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#endif
+
+PHI_DECLARE_int32(check_nan_inf_sample_interval);
 
 namespace paddle {
 namespace framework {
@@ -257,6 +264,15 @@ bool IsSkipOp(const framework::OperatorBase& op) {
   return false;
 }
 
+static bool IsSkipVar(const std::string& op_type, const std::string& vname) {
+  auto iter = op_var_nan_inf_white_list().find(op_type);
+  if (iter == op_var_nan_inf_white_list().end()) return false;
+  for (auto& white_vname : iter->second) {
+    if (vname.find(white_vname) != std::string::npos) return true;
+  }
+  return false;
+}
+
 void CheckOpHasNanOrInf(const framework::OperatorBase& op,
                         const framework::Scope& exec_scope,
                         const platform::Place& place) {
@@ -264,28 +280,138 @@ void CheckOpHasNanOrInf(const framework::OperatorBase& op,
 
   if (IsSkipOp(op)) return;
 
-  if (op_var_nan_inf_white_list().count(op.Type()) == 0) {
-    // NOTE. vname may destruct in the end of this func.
-    for (auto& vname : op.OutputVars(true)) {
-      auto* var = exec_scope.FindVar(vname);
-      if (var == nullptr) continue;
-      CheckVarHasNanOrInf(op.Type(), exec_scope, vname, place);
-    }
+  // NOTE. vname may destruct in the end of this func.
+  for (auto& vname : op.OutputVars(true)) {
+    if (IsSkipVar(op.Type(), vname)) continue;
+    auto* var = exec_scope.FindVar(vname);
+    if (var == nullptr) continue;
+    CheckVarHasNanOrInf(op.Type(), exec_scope, vname, place);
+  }
+}
+
+NanInfStepChecker::NanInfStepChecker(const platform::Place& place)
+    : place_(place) {
+  auto* dev_ctx = platform::DeviceContextPool::Instance().Get(place_);
+  found_nan_inf_.Resize({1});
+  bool* found_nan_inf = dev_ctx->Alloc<bool>(&found_nan_inf_);
+  if (platform::is_gpu_place(place_)) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    auto stream = reinterpret_cast<phi::GPUContext*>(dev_ctx)->stream();
+    platform::GpuMemsetAsync(found_nan_inf, 0, sizeof(bool), stream);
+    host_found_nan_inf_ =
+        memory::Alloc(platform::CUDAPinnedPlace(), sizeof(bool));
+    event_ = platform::CudaEventResourcePool::Instance().New(place_.device);
+#else
+    PADDLE_THROW(platform::errors::PreconditionNotMet(
+        "NanInfStepChecker use gpu place. PaddlePaddle must compile with "
+        "GPU."));
+#endif
   } else {
-    for (auto& vname : op.OutputVars(true)) {
-      bool need_check = true;
-      for (auto& white_vname : op_var_nan_inf_white_list().at(op.Type())) {
-        if (vname.find(white_vname) != std::string::npos) {
-          need_check = false;
-          break;
-        }
-      }
-      if (!need_check) continue;
-      auto* var = exec_scope.FindVar(vname);
-      if (var == nullptr) continue;
-      CheckVarHasNanOrInf(op.Type(), exec_scope, vname, place);
+    PADDLE_ENFORCE_EQ(platform::is_cpu_place(place_),
+                      true,
+                      platform::errors::Unimplemented(
+                          "NanInfStepChecker only supports the cpu and gpu "
+                          "places, but got %s.",
+                          place_));
+    *found_nan_inf = false;
+  }
+}
+
+void NanInfStepChecker::AccumulateOp(const framework::OperatorBase& op,
+                                     const framework::Scope& scope) {
+  std::call_once(white_list_init_flag, InitWhiteListFormEnv);
+
+  // The offset of the sampled ops moves a step by a step, so that the ops of
+  // a program are all sampled in the steps of an interval.
+  const int64_t interval = std::max(FLAGS_check_nan_inf_sample_interval, 1);
+  if ((op_count_++ + step_) % interval != 0) return;
+
+  if (IsSkipOp(op)) return;
+
+  for (auto& vname : op.OutputVars(true)) {
+    if (IsSkipVar(op.Type(), vname)) continue;
+    auto* var = scope.FindVar(vname);
+    if (var == nullptr) continue;
+
+    const phi::DenseTensor* tensor{nullptr};
+    if (var->IsType<phi::DenseTensor>()) {
+      tensor = &var->Get<phi::DenseTensor>();
+    } else if (var->IsType<phi::SelectedRows>()) {
+      tensor = &var->Get<phi::SelectedRows>().value();
+    } else {
+      continue;
+    }
+    if (tensor->memory_size() == 0 || tensor->place() != place_) continue;
+
+    if (platform::is_gpu_place(place_)) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+      TensorNanInfAccumulator<phi::GPUContext> accumulator(*tensor,
+                                                           &found_nan_inf_);
+      VisitDataType(framework::TransToProtoVarType(tensor->dtype()),
+                    accumulator);
+#endif
+    } else {
+      TensorNanInfAccumulator<phi::CPUContext> accumulator(*tensor,
+                                                           &found_nan_inf_);
+      VisitDataType(framework::TransToProtoVarType(tensor->dtype()),
+                    accumulator);
+    }
+  }
+}
+
+void NanInfStepChecker::FinishStep() {
+  bool* found_nan_inf_ptr = found_nan_inf_.data<bool>();
+  bool found_nan_inf = false;
+  int64_t found_step = step_;
+  if (platform::is_gpu_place(place_)) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    auto* host_found_nan_inf =
+        reinterpret_cast<bool*>(host_found_nan_inf_->ptr());
+    if (pending_) {
+      // The copy is issued at the end of the last step, so it is done mostly.
+#ifdef PADDLE_WITH_HIP
+      PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(event_.get()));
+#else
+      PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(event_.get()));
+#endif
+      found_nan_inf = *host_found_nan_inf;
+      found_step = step_ - 1;
     }
+    auto stream = reinterpret_cast<phi::GPUContext*>(
+                      platform::DeviceContextPool::Instance().Get(place_))
+                      ->stream();
+    memory::Copy(platform::CUDAPinnedPlace(),
+                 host_found_nan_inf,
+                 place_,
+                 found_nan_inf_ptr,
+                 sizeof(bool),
+                 stream);
+    platform::GpuMemsetAsync(found_nan_inf_ptr, 0, sizeof(bool), stream);
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event_.get(), stream));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event_.get(), stream));
+#endif
+    pending_ = true;
+#endif
+  } else {
+    found_nan_inf = *found_nan_inf_ptr;
+    *found_nan_inf_ptr = false;
+  }
+
+  // The step found can not run again, so the next step checks every output
+  // of every op to locate the op producing NAN/INF.
+  if (found_nan_inf) {
+    LOG(WARNING) << "Found NAN/INF in the outputs of the ops of step "
+                 << found_step << ", step " << step_ + 1
+                 << " checks every output of every op.";
+  } else if (full_check_) {
+    LOG(WARNING) << "Step " << step_
+                 << " checked every output of every op without NAN/INF.";
   }
+  full_check_ = found_nan_inf;
+  ++step_;
+  op_count_ = 0;
 }
 
 }  // namespace details
@@ -81,6 +81,32 @@ struct TensorCheckerVisitor {
   const platform::Place& place;
 };
 
+template <typename Context>
+struct TensorNanInfAccumulator {
+  TensorNanInfAccumulator(const phi::DenseTensor& t,
+                          phi::DenseTensor* found_nan_inf)
+      : tensor(t), found_nan_inf(found_nan_inf) {}
+
+  template <typename T>
+  void apply(
+      typename std::enable_if<std::is_integral<T>::value>::type* = 0) const {}
+
+  template <typename T>
+  void apply(
+      typename std::enable_if<
+          std::is_floating_point<T>::value ||
+          std::is_same<T, ::paddle::platform::complex<float>>::value ||
+          std::is_same<T, ::paddle::platform::complex<double>>::value>::type* =
+          0) const {
+    auto* dev_ctx = reinterpret_cast<Context*>(
+        platform::DeviceContextPool::Instance().Get(tensor.place()));
+    phi::AccumulateNanInfKernel<T, Context>(*dev_ctx, tensor, found_nan_inf);
+  }
+
+  const phi::DenseTensor& tensor;
+  phi::DenseTensor* found_nan_inf;
+};
+
 template <typename Context>
 void tensor_check(const std::string& op_type,
                   const std::string& var_name,
@@ -841,6 +841,9 @@ class HeterSectionWorker : public DeviceWorker {
   void MiniBatchBarrier();
   void Run();
   void BatchPostProcess();
+  // Tune the number of the microbatches in flight by the measured stage
+  // latencies, used if FLAGS_heter_pipeline_autotune is set.
+  void TuneMicrobatchNum();
   void SetDebug(bool debug) { debug_ = debug; }
   Scope* GetThreadScope() override { return minibatch_scope_; }
 
@@ -879,6 +882,14 @@ class HeterSectionWorker : public DeviceWorker {
   platform::Timer timeline_;
   double total_time_ = 0.0;
   double read_time_ = 0.0;
+  // The microbatches run in a minibatch of the first stage, which is at most
+  // num_microbatches_, the number of the microbatch scopes.
+  int active_microbatches_ = 0;
+  platform::Timer stage_timer_;
+  double stage_forward_time_ = 0.0;
+  double stage_backward_time_ = 0.0;
+  double stage_wait_time_ = 0.0;
+  int tuned_minibatch_num_ = 0;
 };
 #endif
 
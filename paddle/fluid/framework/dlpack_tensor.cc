@@ -15,16 +15,27 @@
 
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/data_type.h"
+#include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/place.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/fluid/platform/device/gpu/gpu_resource_pool.h"
+#endif
 
 namespace paddle {
 namespace framework {
 
 namespace internal {
+// kDLBool of the later versions of DLPack, e.g. for the bool tensors of
+// PyTorch and NumPy
+constexpr uint8_t kDLBoolCode = 6;
+
 template <typename T>
 static ::DLDataType GetDLDataTypeCode() {
   ::DLDataType dtype;
-  if (std::is_same<T, platform::complex<float>>::value ||
+  if (std::is_same<T, bool>::value) {
+    dtype.code = kDLBoolCode;
+  } else if (std::is_same<T, platform::complex<float>>::value ||
       std::is_same<T, platform::complex<double>>::value) {
     dtype.code = kDLComplex;
   } else if (std::is_same<T, platform::bfloat16>::value) {
@@ -119,6 +130,62 @@ struct DLDeviceVisitor {
 #endif
   }
 };
+
+static phi::DataType GetDataTypeFromDLDataType(const ::DLDataType &type) {
+  PADDLE_ENFORCE_EQ(type.lanes,
+                    1,
+                    platform::errors::Unimplemented(
+                        "Vector type is not supported currently."));
+  switch (type.code) {
+    case kDLFloat:
+      if (type.bits == 16) return phi::DataType::FLOAT16;
+      if (type.bits == 32) return phi::DataType::FLOAT32;
+      if (type.bits == 64) return phi::DataType::FLOAT64;
+      break;
+    case kDLBfloat:
+      if (type.bits == 16) return phi::DataType::BFLOAT16;
+      break;
+    case kDLInt:
+      if (type.bits == 8) return phi::DataType::INT8;
+      if (type.bits == 16) return phi::DataType::INT16;
+      if (type.bits == 32) return phi::DataType::INT32;
+      if (type.bits == 64) return phi::DataType::INT64;
+      break;
+    case kDLUInt:
+      if (type.bits == 8) return phi::DataType::UINT8;
+      break;
+    case kDLComplex:
+      if (type.bits == 64) return phi::DataType::COMPLEX64;
+      if (type.bits == 128) return phi::DataType::COMPLEX128;
+      break;
+    case kDLBoolCode:
+      if (type.bits == 8) return phi::DataType::BOOL;
+      break;
+    default:
+      break;
+  }
+  PADDLE_THROW(platform::errors::Unimplemented(
+      "Unsupported DLDataType of code %d and bits %d.", type.code, type.bits));
+}
+
+static platform::Place GetPlaceFromDLDevice(const ::DLDevice &device) {
+  switch (device.device_type) {
+    case kDLCPU:
+      return platform::CPUPlace();
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#ifdef PADDLE_WITH_HIP
+    case kDLROCM:
+#endif
+    case kDLGPU:
+      return platform::CUDAPlace(device.device_id);
+    case kDLCPUPinned:
+      return platform::CUDAPinnedPlace();
+#endif
+    default:
+      PADDLE_THROW(platform::errors::Unimplemented(
+          "Unsupported DLDevice type %d.", device.device_type));
+  }
+}
 }  // namespace internal
 
 struct PaddleDLMTensor {
@@ -173,6 +240,81 @@ DLManagedTensor *toDLPack(const phi::DenseTensor &src) {
   return &(pdDLMTensor->tensor);
 }
 
+void SyncStreamForDLPack(const phi::DenseTensor &tensor, int64_t stream) {
+  if (!platform::is_gpu_place(tensor.place()) || stream == -1) {
+    return;
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  const int device = tensor.place().GetDeviceId();
+  gpuStream_t producer = static_cast<phi::GPUContext *>(
+                             platform::DeviceContextPool::Instance().Get(
+                                 tensor.place()))
+                             ->stream();
+  gpuStream_t consumer = nullptr;
+  if (stream == 2) {
+#ifdef PADDLE_WITH_HIP
+    consumer = hipStreamPerThread;
+#else
+    consumer = cudaStreamPerThread;
+#endif
+  } else if (stream > 2) {
+    consumer = reinterpret_cast<gpuStream_t>(stream);
+  }
+  if (consumer == producer) {
+    return;
+  }
+  platform::CUDADeviceGuard guard(device);
+  // the wait takes the work recorded so far, so the event can be reused once
+  // it is queued
+  auto event = platform::CudaEventResourcePool::Instance().New(device);
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event.get(), producer));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(consumer, event.get(), 0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event.get(), producer));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(consumer, event.get(), 0));
+#endif
+  VLOG(4) << "Stream " << consumer << " waits for stream " << producer
+          << " to consume the DLPack tensor";
+#endif
+}
+
+phi::DenseTensor FromDLPack(DLManagedTensor *src) {
+  const ::DLTensor &dl_tensor = src->dl_tensor;
+  std::vector<int64_t> shape(dl_tensor.shape, dl_tensor.shape + dl_tensor.ndim);
+  auto dims = common::make_ddim(shape);
+  // the strides of nullptr mean the tensor is compact, and the strides of
+  // the dims of size 1 do not matter
+  if (dl_tensor.strides != nullptr && common::product(dims) > 0) {
+    int64_t stride = 1;
+    for (int i = dl_tensor.ndim - 1; i >= 0; --i) {
+      PADDLE_ENFORCE_EQ(
+          shape[i] == 1 || dl_tensor.strides[i] == stride,
+          true,
+          platform::errors::Unimplemented(
+              "Only the compact DLPack tensors are supported, but the stride "
+              "of dim %d is %d instead of %d.",
+              i,
+              dl_tensor.strides[i],
+              stride));
+      stride *= shape[i];
+    }
+  }
+  auto dtype = internal::GetDataTypeFromDLDataType(dl_tensor.dtype);
+  auto place = internal::GetPlaceFromDLDevice(dl_tensor.device);
+  void *data = static_cast<char *>(dl_tensor.data) + dl_tensor.byte_offset;
+  size_t bytes = common::product(dims) * phi::SizeOf(dtype);
+  std::shared_ptr<phi::Allocation> allocation(
+      new phi::Allocation(data, bytes, place),
+      [src](phi::Allocation *allocation) {
+        if (src->deleter != nullptr) {
+          src->deleter(src);
+        }
+        delete allocation;
+      });
+  return phi::DenseTensor(allocation, phi::DenseTensorMeta(dtype, dims));
+}
+
 DLPackTensor::DLPackTensor(const phi::DenseTensor &tensor, LaneType lanes) {
   // init data, data buffer
   t_.data = const_cast<void *>(tensor.data());
@@ -46,5 +46,17 @@ class DLPackTensor {
 
 DLManagedTensor* toDLPack(const phi::DenseTensor& src);
 
+// Make the stream of the consumer of the exported tensor wait for the kernels
+// queued on the stream of the tensor, without synchronizing the device. The
+// stream is the one of __dlpack__(stream=) of the Python array API, i.e. 1
+// or 0 for the legacy default stream, 2 for the per-thread default stream,
+// and the cudaStream_t otherwise, and -1 to skip the synchronization.
+void SyncStreamForDLPack(const phi::DenseTensor& tensor, int64_t stream);
+
+// Share the memory of src with the returned tensor without copying, which
+// takes the ownership of src and calls its deleter when the memory is
+// released.
+phi::DenseTensor FromDLPack(DLManagedTensor* src);
+
 }  // namespace framework
 }  // namespace paddle
@@ -14,10 +14,13 @@
 
 #include "paddle/fluid/framework/executor_cache.h"
 
+#include <algorithm>
+
 #include "paddle/fluid/framework/new_executor/interpretercore.h"
 #include "paddle/fluid/framework/op_info.h"
 #include "paddle/fluid/ir_adaptor/translator/translate.h"
 #include "paddle/fluid/pir/transforms/inplace_pass.h"
+#include "paddle/fluid/pir/transforms/loop_invariant_hoisting_pass.h"
 #include "paddle/fluid/pir/transforms/pd_op_to_kernel_pass.h"
 #include "paddle/phi/core/flags.h"
 #include "paddle/pir/core/program.h"
@@ -26,6 +29,8 @@
 #include "paddle/pir/pass/pass_manager.h"
 
 PHI_DECLARE_bool(pir_apply_inplace_pass);
+PHI_DECLARE_bool(pir_apply_loop_invariant_hoisting_pass);
+PHI_DECLARE_int32(dy2st_interpretercore_cache_capacity);
 PHI_DECLARE_bool(print_ir);
 
 namespace paddle {
@@ -297,6 +302,27 @@ InterpreterCoreInfoCache &InterpreterCoreInfoCache::Instance() {
   return g_info_cache;
 }
 
+void InterpreterCoreInfoCache::EvictForNewCore(int64_t program_id,
+                                               const framework::Scope *scope) {
+  int64_t key = CacheKey(program_id, scope);
+  if (FLAGS_dy2st_interpretercore_cache_capacity <= 0 ||
+      info_map_.count(key)) {
+    return;
+  }
+  while (info_map_.size() >=
+         static_cast<size_t>(FLAGS_dy2st_interpretercore_cache_capacity)) {
+    auto lru = std::min_element(
+        info_map_.begin(), info_map_.end(), [](const auto &a, const auto &b) {
+          return a.second.LastUsedTick() < b.second.LastUsedTick();
+        });
+    VLOG(2) << "Release the interpretercores of the least recently used "
+               "program, "
+            << info_map_.size() << " programs are cached";
+    info_map_.erase(lru);
+    ++evicted_size_;
+  }
+}
+
 std::shared_ptr<InterpreterCore> CreateProgramInterpreterCoreInfoToCache(
     const ProgramDesc &program_desc,
     const platform::Place &place,
@@ -310,6 +336,7 @@ std::shared_ptr<InterpreterCore> CreateProgramInterpreterCoreInfoToCache(
         "The cached info size has exceeded max_cached_size: 256000, "
         "which will cause error. "));
   }
+  interpretercore_info_cache.EvictForNewCore(program_id, scope);
   interpreter::ExecutionConfig execution_config;
   execution_config.create_local_scope = false;
   execution_config.used_for_jit = true;
@@ -338,6 +365,7 @@ std::shared_ptr<InterpreterCore> CreatePirInterpreterCoreInfoToCache(
         "The cached info size has exceeded max_cached_size: 256000, "
         "which will cause error. "));
   }
+  interpretercore_info_cache.EvictForNewCore(program_id, scope);
   interpreter::ExecutionConfig execution_config;
   execution_config.create_local_scope = false;
   execution_config.used_for_jit = true;
@@ -362,6 +390,12 @@ std::unique_ptr<::pir::Program> ApplyIrPass(::pir::Program *program,
                                             phi::Place place) {
   auto ir_res = paddle::dialect::PdOpLowerToKernelPass(program, place);
 
+  if (FLAGS_pir_apply_loop_invariant_hoisting_pass) {
+    ::pir::PassManager pm(::pir::IrContext::Instance(), 3);
+    pm.AddPass(::pir::CreateLoopInvariantHoistingPass());
+    pm.Run(ir_res.get());
+  }
+
   if (FLAGS_pir_apply_inplace_pass) {
     ::pir::PassManager pm(::pir::IrContext::Instance(), 3);
     pm.AddPass(::pir::CreateInplacePass());
@@ -550,6 +584,12 @@ std::unique_ptr<::pir::Program> ConstructBackwardIrProgram(
 
   auto res = paddle::dialect::PdOpLowerToKernelPass(program.get(), place);
 
+  if (FLAGS_pir_apply_loop_invariant_hoisting_pass) {
+    ::pir::PassManager pm(::pir::IrContext::Instance(), 3);
+    pm.AddPass(::pir::CreateLoopInvariantHoistingPass());
+    pm.Run(res.get());
+  }
+
   if (FLAGS_pir_apply_inplace_pass) {
     ::pir::PassManager pm(::pir::IrContext::Instance(), 3);
     pm.AddPass(::pir::CreateInplacePass());
@@ -182,9 +182,14 @@ class InterpreterCoreInfo {
     return is_grad ? backward_info_ : forward_info_;
   }
 
+  void Touch(uint64_t tick) { last_used_tick_ = tick; }
+
+  uint64_t LastUsedTick() const { return last_used_tick_; }
+
  private:
   CacheValue forward_info_;
   CacheValue backward_info_;
+  uint64_t last_used_tick_{0};
 };
 
 class InterpreterCoreInfoCache {
@@ -192,24 +197,23 @@ class InterpreterCoreInfoCache {
   static InterpreterCoreInfoCache& Instance();
 
   bool Has(int64_t program_id, const framework::Scope* scope, bool is_grad) {
-    if (FLAGS_enable_pir_in_executor || FLAGS_enable_pir_with_pt_in_dy2st) {
-      int64_t scope_i = reinterpret_cast<std::uintptr_t>(scope);
-      program_id += 0x9e3779b9 + (program_id << 6) + (scope_i >> 2);
-    }
-    return info_map_.find(program_id) != info_map_.end() &&
-           info_map_[program_id].IsAvailable(is_grad);
+    auto iter = info_map_.find(CacheKey(program_id, scope));
+    return iter != info_map_.end() && iter->second.IsAvailable(is_grad);
   }
 
   InterpreterCoreInfo::CacheValue& GetMutable(int64_t program_id,
                                               const framework::Scope* scope,
                                               bool is_grad) {
-    if (FLAGS_enable_pir_in_executor || FLAGS_enable_pir_with_pt_in_dy2st) {
-      int64_t scope_i = reinterpret_cast<std::uintptr_t>(scope);
-      program_id += 0x9e3779b9 + (program_id << 6) + (scope_i >> 2);
-    }
-    return info_map_[program_id].GetMutable(is_grad);
+    auto& info = info_map_[CacheKey(program_id, scope)];
+    info.Touch(++tick_);
+    return info.GetMutable(is_grad);
   }
 
+  // Release the InterpreterCores of the least recently used programs, so that
+  // the InterpreterCore of program_id can be cached within
+  // FLAGS_dy2st_interpretercore_cache_capacity.
+  void EvictForNewCore(int64_t program_id, const framework::Scope* scope);
+
   void UpdateSkipEagerDeleteVars(int64_t program_id,
                                  const framework::Scope* scope,
                                  bool is_grad,
@@ -227,6 +231,9 @@ class InterpreterCoreInfoCache {
 
   size_t Size() const { return info_map_.size(); }
 
+  // The number of programs whose InterpreterCores are released by eviction.
+  size_t EvictedSize() const { return evicted_size_; }
+
   void Finalize() {
     // NOTE(Aurelius84): DO NOT perform finalize in destructor
     // to avoid problems caused by destructor order of static
@@ -235,7 +242,17 @@ class InterpreterCoreInfoCache {
   }
 
  private:
+  int64_t CacheKey(int64_t program_id, const framework::Scope* scope) const {
+    if (FLAGS_enable_pir_in_executor || FLAGS_enable_pir_with_pt_in_dy2st) {
+      int64_t scope_i = reinterpret_cast<std::uintptr_t>(scope);
+      program_id += 0x9e3779b9 + (program_id << 6) + (scope_i >> 2);
+    }
+    return program_id;
+  }
+
   std::unordered_map<int64_t, InterpreterCoreInfo> info_map_;
+  uint64_t tick_{0};
+  size_t evicted_size_{0};
 };
 
 std::shared_ptr<InterpreterCore> CreateProgramInterpreterCoreInfoToCache(
@@ -19,6 +19,7 @@ limitations under the License. */
 #include <ThreadPool.h>
 
 #include <algorithm>
+#include <future>  // NOLINT
 #include <map>
 #include <unordered_map>
 #include <vector>
@@ -102,6 +103,9 @@ class HeterContext {
   std::vector<std::unordered_map<uint64_t, uint32_t>> keys2rank_map_vec_;
   std::vector<std::shared_ptr<HashTable<uint64_t, uint32_t>>> keys2rank_tables_;
 
+  // PSGPUWrapper::PrefetchSparseKeys
+  std::vector<std::future<void>> prefetch_futures_;
+
   void* sub_graph_feas = NULL;
   void* sub_graph_float_feas = NULL;
   uint32_t shard_num_ = 37;
@@ -151,7 +155,15 @@ class HeterContext {
     multi_mf_dim_ = dim_num;
   }
 
+  void WaitPrefetch() {
+    for (auto& fut : prefetch_futures_) {
+      fut.wait();
+    }
+    prefetch_futures_.clear();
+  }
+
   void Reset() {
+    WaitPrefetch();
     if (!multi_mf_dim_) {
       for (size_t i = 0; i < feature_keys_.size(); ++i) {
         feature_keys_[i].clear();
@@ -0,0 +1,399 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+#ifdef PADDLE_WITH_HETERPS
+#if defined(PADDLE_WITH_CUDA)
+#include <cooperative_groups.h>
+
+#include <algorithm>
+#include <iostream>
+
+#include "paddle/fluid/framework/fleet/heter_ps/cudf/concurrent_unordered_map.cuh.h"
+
+namespace paddle {
+namespace framework {
+
+template <typename Table>
+__global__ void bucket_rehash_kernel(
+    const typename Table::value_type* const old_values,
+    size_t old_size,
+    Table* table) {
+  const size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < old_size) {
+    const typename Table::value_type kv = old_values[i];
+    if (kv.first != Table::get_unused_key()) {
+      auto it = table->insert(kv, typename Table::AssignOp());
+      assert(it != table->end() && "error: rehash fails: table is full");
+    }
+  }
+}
+
+/**
+ * BucketConcurrentMap is a GPU hash table whose slots are grouped into
+ * buckets of kBucketSize slots. A key is probed in its first bucket, then in
+ * its second bucket and the buckets following it, so that the probing keeps
+ * short at the load factors above 0.9, where the linear probing of
+ * concurrent_unordered_map degrades.
+ *
+ * A bucket is probed by a tile of kBucketSize threads at once, one slot per
+ * thread, or by a single thread for the kernels shared with
+ * concurrent_unordered_map. The slots of a bucket are always filled from the
+ * lowest one, so that a probe stops at the first bucket with a free slot.
+ *
+ * Like concurrent_unordered_map, it supports concurrent insert, but not
+ * concurrent insert and probing.
+ * **/
+template <typename Key,
+          typename Element,
+          Key unused_key,
+          typename Hasher = default_hash<Key>>
+class BucketConcurrentMap : public managed {
+ public:
+  static constexpr int kBucketSize = 16;
+  // the load factor at which HashTable grows the table before inserting
+  static constexpr float kMaxLoadFactor = 0.95f;
+
+  using size_type = size_t;
+  using hasher = Hasher;
+  using allocator_type = managed_allocator<thrust::pair<Key, Element>>;
+  using key_type = Key;
+  using value_type = thrust::pair<Key, Element>;
+  using mapped_type = Element;
+  using iterator = cycle_iterator_adapter<value_type*>;
+  using const_iterator = const cycle_iterator_adapter<value_type*>;
+  using Tile = cooperative_groups::thread_block_tile<kBucketSize>;
+
+  struct AssignOp {
+    __host__ __device__ mapped_type operator()(mapped_type new_value,
+                                               mapped_type old_value) {
+      return new_value;
+    }
+  };
+
+  BucketConcurrentMap(const BucketConcurrentMap&) = delete;
+  BucketConcurrentMap& operator=(const BucketConcurrentMap&) = delete;
+  explicit BucketConcurrentMap(cudaStream_t stream,
+                               size_type n,
+                               const mapped_type unused_element)
+      : m_unused_element(unused_element),
+        m_enable_collision_stat(false),
+        m_insert_times(0),
+        m_insert_collisions(0),
+        m_query_times(0),
+        m_query_collisions(0) {
+    allocate(n, stream);
+    CUDA_RT_CALL(cudaStreamSynchronize(stream));
+    CUDA_RT_CALL(cudaGetLastError());
+    m_enable_collision_stat = FLAGS_gpugraph_enable_hbm_table_collision_stat;
+  }
+
+  ~BucketConcurrentMap() {
+    m_allocator.deallocate(m_hashtbl_values, m_hashtbl_size);
+  }
+
+  __host__ __device__ iterator begin() {
+    return iterator(
+        m_hashtbl_values, m_hashtbl_values + m_hashtbl_size, m_hashtbl_values);
+  }
+  __host__ __device__ iterator end() {
+    return iterator(m_hashtbl_values,
+                    m_hashtbl_values + m_hashtbl_size,
+                    m_hashtbl_values + m_hashtbl_size);
+  }
+  __host__ __device__ size_type size() const { return m_hashtbl_size; }
+  __host__ __device__ value_type* data() const { return m_hashtbl_values; }
+
+  __forceinline__ static constexpr __host__ __device__ key_type
+  get_unused_key() {
+    return unused_key;
+  }
+
+  template <typename aggregation_type>
+  __forceinline__ __device__ iterator insert(const value_type& x,
+                                             aggregation_type op,
+                                             uint64_t* local_count = NULL) {
+    const key_type insert_key = x.first;
+    uint32_t first_hash = 0, second_hash = 0;
+    hash(insert_key, &first_hash, &second_hash);
+
+    value_type* slot = m_hashtbl_values + m_hashtbl_size;
+    size_type probe = 0;
+    for (; probe < m_num_buckets && slot == end_slot(); ++probe) {
+      value_type* bucket = bucket_at(first_hash, second_hash, probe);
+      for (int i = 0; i < kBucketSize; ++i) {
+        key_type existing_key = bucket[i].first;
+        if (existing_key == unused_key) {
+          existing_key = atomicCAS(&bucket[i].first, unused_key, insert_key);
+          if (existing_key == unused_key && local_count != NULL) {
+            atomicAdd(local_count, 1);
+          }
+        }
+        if (existing_key == unused_key || existing_key == insert_key) {
+          bucket[i].second = op(x.second, bucket[i].second);
+          slot = bucket + i;
+          break;
+        }
+      }
+    }
+
+    if (m_enable_collision_stat) {
+      atomicAdd(&m_insert_times, 1);
+      atomicAdd(&m_insert_collisions, uint64_t(probe));
+    }
+    return iterator(m_hashtbl_values, m_hashtbl_values + m_hashtbl_size, slot);
+  }
+
+  // Insert x by a tile of kBucketSize threads, all of which get the slot of
+  // x, or the end of the table if it is full.
+  template <typename aggregation_type>
+  __forceinline__ __device__ value_type* insert(const Tile& tile,
+                                                const value_type& x,
+                                                aggregation_type op,
+                                                bool* is_new = nullptr) {
+    const key_type insert_key = x.first;
+    const int lane = tile.thread_rank();
+    uint32_t first_hash = 0, second_hash = 0;
+    hash(insert_key, &first_hash, &second_hash);
+
+    value_type* slot = end_slot();
+    size_type probe = 0;
+    for (; probe < m_num_buckets && slot == end_slot(); ++probe) {
+      value_type* bucket = bucket_at(first_hash, second_hash, probe);
+      while (true) {
+        const key_type existing_key = bucket[lane].first;
+        const uint32_t found = tile.ballot(existing_key == insert_key);
+        if (found) {
+          const int target = __ffs(found) - 1;
+          if (lane == target) {
+            bucket[target].second = op(x.second, bucket[target].second);
+          }
+          if (is_new != nullptr) *is_new = false;
+          slot = bucket + target;
+          break;
+        }
+        const uint32_t empty = tile.ballot(existing_key == unused_key);
+        if (!empty) {
+          break;
+        }
+        const int target = __ffs(empty) - 1;
+        key_type old_key = unused_key;
+        if (lane == target) {
+          old_key = atomicCAS(&bucket[target].first, unused_key, insert_key);
+        }
+        old_key = tile.shfl(old_key, target);
+        if (old_key == unused_key || old_key == insert_key) {
+          if (lane == target) {
+            bucket[target].second = op(x.second, bucket[target].second);
+          }
+          if (is_new != nullptr) *is_new = old_key == unused_key;
+          slot = bucket + target;
+          break;
+        }
+        // the slot is taken by another key, reload the bucket
+      }
+    }
+
+    if (m_enable_collision_stat && lane == 0) {
+      atomicAdd(&m_insert_times, 1);
+      atomicAdd(&m_insert_collisions, uint64_t(probe));
+    }
+    return slot;
+  }
+
+  __forceinline__ __device__ const_iterator find(const key_type& k) {
+    uint32_t first_hash = 0, second_hash = 0;
+    hash(k, &first_hash, &second_hash);
+
+    value_type* slot = end_slot();
+    bool has_free_slot = false;
+    size_type probe = 0;
+    for (; probe < m_num_buckets && slot == end_slot() && !has_free_slot;
+         ++probe) {
+      value_type* bucket = bucket_at(first_hash, second_hash, probe);
+      for (int i = 0; i < kBucketSize; ++i) {
+        const key_type existing_key = bucket[i].first;
+        if (existing_key == k) {
+          slot = bucket + i;
+          break;
+        }
+        if (existing_key == unused_key) {
+          has_free_slot = true;
+          break;
+        }
+      }
+    }
+
+    if (m_enable_collision_stat) {
+      atomicAdd(&m_query_times, 1);
+      atomicAdd(&m_query_collisions, uint64_t(probe));
+    }
+    return const_iterator(
+        m_hashtbl_values, m_hashtbl_values + m_hashtbl_size, slot);
+  }
+
+  // Find k by a tile of kBucketSize threads, all of which get the slot of k,
+  // or the end of the table if k is missing.
+  __forceinline__ __device__ value_type* find(const Tile& tile,
+                                              const key_type& k) {
+    uint32_t first_hash = 0, second_hash = 0;
+    hash(k, &first_hash, &second_hash);
+
+    value_type* slot = end_slot();
+    size_type probe = 0;
+    for (; probe < m_num_buckets; ++probe) {
+      value_type* bucket = bucket_at(first_hash, second_hash, probe);
+      const key_type existing_key = bucket[tile.thread_rank()].first;
+      const uint32_t found = tile.ballot(existing_key == k);
+      if (found) {
+        slot = bucket + __ffs(found) - 1;
+        break;
+      }
+      if (tile.ballot(existing_key == unused_key)) {
+        break;
+      }
+    }
+
+    if (m_enable_collision_stat && tile.thread_rank() == 0) {
+      atomicAdd(&m_query_times, 1);
+      atomicAdd(&m_query_collisions, uint64_t(probe + 1));
+    }
+    return slot;
+  }
+
+  __host__ __device__ value_type* end_slot() const {
+    return m_hashtbl_values + m_hashtbl_size;
+  }
+
+  // Move all the pairs into a table of n slots at least by one kernel. The
+  // values are copied as they are, so the pointers into a value pool remain
+  // valid.
+  void rehash(size_type n, cudaStream_t stream = 0) {
+    auto* rehashed = new BucketConcurrentMap(stream, n, m_unused_element);
+    constexpr int block_size = 256;
+    if (m_hashtbl_size > 0) {
+      bucket_rehash_kernel<<<(m_hashtbl_size - 1) / block_size + 1,
+                             block_size,
+                             0,
+                             stream>>>(
+          m_hashtbl_values, m_hashtbl_size, rehashed);
+    }
+    CUDA_RT_CALL(cudaStreamSynchronize(stream));
+    CUDA_RT_CALL(cudaGetLastError());
+    std::swap(m_hashtbl_values, rehashed->m_hashtbl_values);
+    std::swap(m_hashtbl_size, rehashed->m_hashtbl_size);
+    std::swap(m_num_buckets, rehashed->m_num_buckets);
+    delete rehashed;
+  }
+
+  void clear_async(cudaStream_t stream = 0) {
+    constexpr int block_size = 128;
+    init_hashtbl<<<((m_hashtbl_size - 1) / block_size) + 1,
+                   block_size,
+                   0,
+                   stream>>>(
+        m_hashtbl_values, m_hashtbl_size, unused_key, m_unused_element);
+    if (m_enable_collision_stat) {
+      m_insert_times = 0;
+      m_insert_collisions = 0;
+      m_query_times = 0;
+      m_query_collisions = 0;
+    }
+  }
+
+  void print() {
+    for (size_type i = 0; i < 5; ++i) {
+      std::cout << i << ": " << m_hashtbl_values[i].first << ","
+                << m_hashtbl_values[i].second << std::endl;
+    }
+  }
+
+  int prefetch(const int dev_id, cudaStream_t stream = 0) {
+    CUDA_RT_CALL(cudaMemPrefetchAsync(m_hashtbl_values,
+                                      m_hashtbl_size * sizeof(value_type),
+                                      dev_id,
+                                      stream));
+    CUDA_RT_CALL(cudaMemPrefetchAsync(this, sizeof(*this), dev_id, stream));
+    return 0;
+  }
+
+  __host__ void print_collision(int id) {
+    if (m_enable_collision_stat) {
+      printf(
+          "collision stat for bucket hbm table %d, insert(%lu:%lu:%.2f), "
+          "query(%lu:%lu:%.2f)\n",
+          id,
+          m_insert_times,
+          m_insert_collisions,
+          m_insert_collisions / static_cast<double>(m_insert_times),
+          m_query_times,
+          m_query_collisions,
+          m_query_collisions / static_cast<double>(m_query_times));
+    }
+  }
+
+ private:
+  void allocate(size_type n, cudaStream_t stream) {
+    m_num_buckets = std::max<size_type>((n + kBucketSize - 1) / kBucketSize, 1);
+    m_hashtbl_size = m_num_buckets * kBucketSize;
+    m_hashtbl_values = m_allocator.allocate(m_hashtbl_size);
+    int dev_id = 0;
+    CUDA_RT_CALL(cudaGetDevice(&dev_id));
+    CUDA_RT_CALL(cudaMemPrefetchAsync(
+        m_hashtbl_values, m_hashtbl_size * sizeof(value_type), dev_id, stream));
+    constexpr int block_size = 128;
+    init_hashtbl<<<((m_hashtbl_size - 1) / block_size) + 1,
+                   block_size,
+                   0,
+                   stream>>>(
+        m_hashtbl_values, m_hashtbl_size, unused_key, m_unused_element);
+  }
+
+  __forceinline__ __device__ void hash(const key_type& k,
+                                       uint32_t* first_hash,
+                                       uint32_t* second_hash) const {
+    *first_hash = m_hf(k);
+    *second_hash = m_hf.fmix32(*first_hash ^ 0x9e3779b9);
+  }
+
+  // The probe-th bucket of a key: its first bucket, then its second bucket
+  // and the buckets following it.
+  __forceinline__ __device__ value_type* bucket_at(uint32_t first_hash,
+                                                   uint32_t second_hash,
+                                                   size_type probe) const {
+    const size_type bucket =
+        probe == 0 ? first_hash % m_num_buckets
+                   : (second_hash + probe - 1) % m_num_buckets;
+    return m_hashtbl_values + bucket * kBucketSize;
+  }
+
+  const hasher m_hf;
+  const mapped_type m_unused_element;
+  allocator_type m_allocator;
+
+  size_type m_num_buckets;
+  size_type m_hashtbl_size;
+  value_type* m_hashtbl_values;
+
+  bool m_enable_collision_stat;
+  uint64_t m_insert_times;
+  uint64_t m_insert_collisions;
+  uint64_t m_query_times;
+  uint64_t m_query_collisions;
+};
+
+}  // end namespace framework
+}  // end namespace paddle
+#endif
+#endif
@@ -45,6 +45,11 @@ struct GpuPsCommGraph {
   int64_t neighbor_size;          // the size of neighbor_list
   half *weight_list;  // locate on both side, which length is the same as
                       // neighbor_list
+  // the alias tables of the weights, i.e. the probability to keep the
+  // neighbor and the neighbor index in the node to draw instead, only
+  // locate on device side when FLAGS_graph_weighted_sample_by_alias is set
+  half *alias_prob_list;
+  uint32_t *alias_idx_list;
   bool is_weighted;
   GpuPsCommGraph()
       : node_list(nullptr),
@@ -53,6 +58,8 @@ struct GpuPsCommGraph {
         neighbor_list(nullptr),
         neighbor_size(0),
         weight_list(nullptr),
+        alias_prob_list(nullptr),
+        alias_idx_list(nullptr),
         is_weighted(false) {}
   GpuPsCommGraph(uint64_t *node_list_,
                  int64_t node_size_,
@@ -67,6 +74,8 @@ struct GpuPsCommGraph {
         neighbor_list(neighbor_list_),
         neighbor_size(neighbor_size_),
         weight_list(weight_list_),
+        alias_prob_list(nullptr),
+        alias_idx_list(nullptr),
         is_weighted(is_weighted_) {}
   void init_on_cpu(int64_t neighbor_size_,
                    int64_t node_size_,
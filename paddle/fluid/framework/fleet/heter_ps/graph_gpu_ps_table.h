@@ -130,6 +130,10 @@ class GpuPsGraphTable
   void clear_feature_info(int index);
   void build_graph_from_cpu(const std::vector<GpuPsCommGraph> &cpu_node_list,
                             int idx);
+  // build the alias tables of the weighted edges built on the gpu
+  void build_alias_table_on_single_gpu(const GpuPsCommGraph &g,
+                                       int gpu_id,
+                                       int edge_idx);
   NodeQueryResult graph_node_sample(int gpu_id, int sample_size);
   NeighborSampleResult graph_neighbor_sample_v3(NeighborSampleQuery q,
                                                 bool cpu_switch,
@@ -17,6 +17,7 @@
 #include <thrust/reduce.h>
 #include <thrust/scan.h>
 #include <functional>
+#include <thread>  // NOLINT
 #include "cub/cub.cuh"
 #pragma once
 #ifdef PADDLE_WITH_HETERPS
@@ -32,6 +33,7 @@
 
 PHI_DECLARE_bool(enable_neighbor_list_use_uva);
 PHI_DECLARE_bool(enable_graph_multi_node_sampling);
+PHI_DECLARE_bool(graph_weighted_sample_by_alias);
 
 namespace paddle {
 namespace framework {
@@ -582,6 +584,103 @@ __launch_bounds__(BLOCK_SIZE) __global__
   }
 }
 
+// Draw the neighbors by the alias tables with replacement, one warp per
+// node and one draw per thread.
+template <int WARP_SIZE, int BLOCK_WARPS>
+__global__ void weighted_sample_alias_kernel(GpuPsCommGraph graph,
+                                             GpuPsNodeInfo* node_info_list,
+                                             uint64_t* res,
+                                             int n,
+                                             int sample_len,
+                                             uint64_t random_seed,
+                                             float* weight_array,
+                                             bool return_weight) {
+  int i = blockIdx.x * BLOCK_WARPS + threadIdx.y;
+  if (i >= n) return;
+  int neighbor_len = node_info_list[i].neighbor_size;
+  uint32_t data_offset = node_info_list[i].neighbor_offset;
+  int offset = i * sample_len;
+  uint64_t* data = graph.neighbor_list;
+  half* weight = graph.weight_list;
+  if (neighbor_len <= sample_len) {  // directly copy
+    for (int j = threadIdx.x; j < neighbor_len; j += WARP_SIZE) {
+      res[offset + j] = data[data_offset + j];
+      if (return_weight) {
+        weight_array[offset + j] = static_cast<float>(weight[data_offset + j]);
+      }
+    }
+  } else {
+    RandomNumGen rng(i * WARP_SIZE + threadIdx.x, random_seed);
+    half* prob = graph.alias_prob_list + data_offset;
+    uint32_t* alias = graph.alias_idx_list + data_offset;
+    for (int j = threadIdx.x; j < sample_len; j += WARP_SIZE) {
+      int idx = rng.RandomMod(neighbor_len);
+      if (rng.RandomUniformFloat() >= static_cast<float>(prob[idx])) {
+        idx = alias[idx];
+      }
+      res[offset + j] = data[data_offset + idx];
+      if (return_weight) {
+        weight_array[offset + j] =
+            static_cast<float>(weight[data_offset + idx]);
+      }
+    }
+  }
+}
+
+// Vose's alias method over the weights of every node
+void build_alias_table(const GpuPsCommGraph& g,
+                       int64_t node_start,
+                       int64_t node_end,
+                       half* alias_prob,
+                       uint32_t* alias_idx) {
+  std::vector<float> scaled;
+  std::vector<uint32_t> small, large;
+  for (int64_t i = node_start; i < node_end; i++) {
+    uint32_t len = g.node_info_list[i].neighbor_size;
+    uint32_t offset = g.node_info_list[i].neighbor_offset;
+    if (len == 0) continue;
+    double sum = 0;
+    for (uint32_t j = 0; j < len; j++) {
+      sum += static_cast<float>(g.weight_list[offset + j]);
+    }
+    scaled.resize(len);
+    small.clear();
+    large.clear();
+    for (uint32_t j = 0; j < len; j++) {
+      float w = static_cast<float>(g.weight_list[offset + j]);
+      scaled[j] = sum > 0 ? w * len / sum : 1.0f;
+      if (scaled[j] < 1.0f) {
+        small.push_back(j);
+      } else {
+        large.push_back(j);
+      }
+    }
+    while (!small.empty() && !large.empty()) {
+      uint32_t s = small.back();
+      uint32_t l = large.back();
+      small.pop_back();
+      large.pop_back();
+      alias_prob[offset + s] = __float2half(scaled[s]);
+      alias_idx[offset + s] = l;
+      scaled[l] = (scaled[l] + scaled[s]) - 1.0f;
+      if (scaled[l] < 1.0f) {
+        small.push_back(l);
+      } else {
+        large.push_back(l);
+      }
+    }
+    // the rest are 1 but the rounding errors
+    for (auto j : large) {
+      alias_prob[offset + j] = __float2half(1.0f);
+      alias_idx[offset + j] = j;
+    }
+    for (auto j : small) {
+      alias_prob[offset + j] = __float2half(1.0f);
+      alias_idx[offset + j] = j;
+    }
+  }
+}
+
 // almost the same as walking kernel
 __global__ void unweighted_sample_large_kernel(GpuPsCommGraph graph,
                                                GpuPsNodeInfo* node_info_list,
@@ -810,6 +909,24 @@ void GpuPsGraphTable::weighted_sample(GpuPsCommGraph& graph,
   }
   CUDA_CHECK(cudaStreamSynchronize(cur_stream));
 
+  if (graph.alias_prob_list != nullptr) {
+    constexpr int WARP_SIZE = 32;
+    constexpr int BLOCK_WARPS = 4;
+    const dim3 block(WARP_SIZE, BLOCK_WARPS);
+    const dim3 grid((shard_len + BLOCK_WARPS - 1) / BLOCK_WARPS);
+    weighted_sample_alias_kernel<WARP_SIZE, BLOCK_WARPS>
+        <<<grid, block, 0, cur_stream>>>(graph,
+                                         node_info_list,
+                                         sample_array,
+                                         shard_len,
+                                         sample_size,
+                                         random_seed,
+                                         weight_array,
+                                         return_weight);
+    CUDA_CHECK(cudaStreamSynchronize(cur_stream));
+    return;
+  }
+
   paddle::memory::ThrustAllocator<cudaStream_t> allocator(place, cur_stream);
   if (sample_size > SAMPLE_SIZE_THRESHOLD) {
     // to be optimized
@@ -1607,6 +1724,18 @@ void GpuPsGraphTable::clear_graph_info(int gpu_id, int idx) {
     cudaFree(graph.node_list);
     graph.node_list = nullptr;
   }
+  if (graph.weight_list != NULL) {
+    cudaFree(graph.weight_list);
+    graph.weight_list = nullptr;
+  }
+  if (graph.alias_prob_list != NULL) {
+    cudaFree(graph.alias_prob_list);
+    graph.alias_prob_list = nullptr;
+  }
+  if (graph.alias_idx_list != NULL) {
+    cudaFree(graph.alias_idx_list);
+    graph.alias_idx_list = nullptr;
+  }
 }
 void GpuPsGraphTable::clear_graph_info(int idx) {
   for (int i = 0; i < gpu_num; i++) clear_graph_info(i, idx);
@@ -1920,6 +2049,9 @@ void GpuPsGraphTable::build_graph_on_single_gpu(const GpuPsCommGraph& g,
                                  g.neighbor_size * sizeof(half),
                                  cudaMemcpyHostToDevice,
                                  stream));
+      if (FLAGS_graph_weighted_sample_by_alias) {
+        build_alias_table_on_single_gpu(g, gpu_id, edge_idx);
+      }
     }
 
   } else {
@@ -1933,6 +2065,54 @@ void GpuPsGraphTable::build_graph_on_single_gpu(const GpuPsCommGraph& g,
           << gpu_graph_list_[offset].neighbor_size;
 }
 
+void GpuPsGraphTable::build_alias_table_on_single_gpu(const GpuPsCommGraph& g,
+                                                      int gpu_id,
+                                                      int edge_idx) {
+  platform::Timer timeline;
+  timeline.Start();
+  std::vector<half> h_alias_prob(g.neighbor_size);
+  std::vector<uint32_t> h_alias_idx(g.neighbor_size);
+  int thread_num = std::max(
+      1, std::min(16, static_cast<int>(std::thread::hardware_concurrency())));
+  int64_t step = (g.node_size + thread_num - 1) / thread_num;
+  std::vector<std::thread> threads;
+  for (int64_t start = 0; start < g.node_size; start += step) {
+    threads.emplace_back([&g, &h_alias_prob, &h_alias_idx, start, step]() {
+      build_alias_table(g,
+                        start,
+                        std::min(start + step, g.node_size),
+                        h_alias_prob.data(),
+                        h_alias_idx.data());
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  auto stream = get_local_stream(gpu_id);
+  auto& graph = gpu_graph_list_[get_graph_list_offset(gpu_id, edge_idx)];
+  CUDA_CHECK(
+      cudaMalloc(&graph.alias_prob_list, g.neighbor_size * sizeof(half)));
+  CUDA_CHECK(
+      cudaMalloc(&graph.alias_idx_list, g.neighbor_size * sizeof(uint32_t)));
+  CUDA_CHECK(cudaMemcpyAsync(graph.alias_prob_list,
+                             h_alias_prob.data(),
+                             g.neighbor_size * sizeof(half),
+                             cudaMemcpyHostToDevice,
+                             stream));
+  CUDA_CHECK(cudaMemcpyAsync(graph.alias_idx_list,
+                             h_alias_idx.data(),
+                             g.neighbor_size * sizeof(uint32_t),
+                             cudaMemcpyHostToDevice,
+                             stream));
+  // the host tables are released on return
+  CUDA_CHECK(cudaStreamSynchronize(stream));
+  timeline.Pause();
+  VLOG(0) << "build alias table of " << g.neighbor_size
+          << " edges on gpu " << resource_->dev_id(gpu_id) << ", edge_idx "
+          << edge_idx << ", cost " << timeline.ElapsedSec() << " seconds";
+}
+
 void GpuPsGraphTable::build_graph_from_cpu(
     const std::vector<GpuPsCommGraph>& cpu_graph_list, int edge_idx) {
   VLOG(0) << "in build_graph_from_cpu cpu_graph_list size = "
@@ -31,6 +31,7 @@ limitations under the License. */
 #include "paddle/phi/core/utils/rw_lock.h"
 
 #if defined(PADDLE_WITH_CUDA)
+#include "paddle/fluid/framework/fleet/heter_ps/bucket_hashtable.cuh.h"
 #include "paddle/fluid/framework/fleet/heter_ps/cudf/concurrent_unordered_map.cuh.h"
 #include "paddle/fluid/framework/fleet/heter_ps/mem_pool.h"
 #include "paddle/fluid/platform/device/gpu/gpu_types.h"
@@ -61,6 +62,19 @@ class TableContainer
                                  std::numeric_limits<KeyType>::max()>(
             stream, capacity, ValType()) {}
 };
+
+template <typename KeyType, typename ValType>
+class BucketTableContainer
+    : public BucketConcurrentMap<KeyType,
+                                 ValType,
+                                 std::numeric_limits<KeyType>::max()> {
+ public:
+  BucketTableContainer(size_t capacity, cudaStream_t stream)
+      : BucketConcurrentMap<KeyType,
+                            ValType,
+                            std::numeric_limits<KeyType>::max()>(
+            stream, capacity, ValType()) {}
+};
 #elif defined(PADDLE_WITH_XPU_KP)
 template <typename KeyType, typename ValType>
 class XPUCacheArray {
@@ -217,8 +231,20 @@ class HashTable {
 
 #endif
 
+#if defined(PADDLE_WITH_CUDA)
+  // Move the pairs of the bucket table into a table of capacity slots.
+  void rehash(size_t capacity, cudaStream_t stream = 0);
+
+  int size() {
+    return bucket_container_ ? bucket_container_->size() : container_->size();
+  }
+  thrust::pair<KeyType, ValType>* data() {
+    return bucket_container_ ? bucket_container_->data() : container_->data();
+  }
+#else
   int size() { return container_->size(); }
   thrust::pair<KeyType, ValType>* data() { return container_->data(); }
+#endif
   void set_feature_value_size(size_t pull_feature_value_size,
                               size_t push_grad_value_size) {
     pull_feature_value_size_ = pull_feature_value_size;
@@ -227,6 +253,28 @@ class HashTable {
             << " push value size: " << push_grad_value_size_;
   }
 
+#if defined(PADDLE_WITH_CUDA)
+  int prefetch(const int dev_id, cudaStream_t stream = 0) {
+    return bucket_container_ ? bucket_container_->prefetch(dev_id, stream)
+                             : container_->prefetch(dev_id, stream);
+  }
+
+  void clear(cudaStream_t stream = 0) {
+    inserted_num_ = 0;
+    if (bucket_container_) {
+      bucket_container_->clear_async(stream);
+    } else {
+      container_->clear_async(stream);
+    }
+  }
+
+  void show_collision(int id) {
+    if (bucket_container_) {
+      return bucket_container_->print_collision(id);
+    }
+    return container_->print_collision(id);
+  }
+#else
   int prefetch(const int dev_id, cudaStream_t stream = 0) {
     return container_->prefetch(dev_id, stream);
   }
@@ -234,6 +282,7 @@ class HashTable {
   void clear(cudaStream_t stream = 0) { container_->clear_async(stream); }
 
   void show_collision(int id) { return container_->print_collision(id); }
+#endif
   // infer mode
   void set_mode(bool infer_mode) { infer_mode_ = infer_mode; }
 
@@ -241,7 +290,22 @@ class HashTable {
 
  private:
 #if defined(PADDLE_WITH_CUDA)
-  TableContainer<KeyType, ValType>* container_;
+  // Run func with the container in use, which is the bucket table if
+  // FLAGS_gpugraph_enable_bucket_hbm_table.
+  template <typename Func>
+  void with_container(Func&& func) {
+    if (bucket_container_) {
+      func(bucket_container_);
+    } else {
+      func(container_);
+    }
+  }
+
+  TableContainer<KeyType, ValType>* container_{nullptr};
+  BucketTableContainer<KeyType, ValType>* bucket_container_{nullptr};
+  // the keys inserted into the value pool since the table is cleared, by
+  // which the bucket table grows before it is too full
+  size_t inserted_num_{0};
   cudaStream_t stream_ = 0;
 #elif defined(PADDLE_WITH_XPU_KP)
   XPUCacheArray<KeyType, ValType>* container_;
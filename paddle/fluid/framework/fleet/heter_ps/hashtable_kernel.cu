@@ -17,6 +17,9 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/fleet/heter_ps/hashtable.h"
 #include "paddle/fluid/framework/fleet/heter_ps/optimizer.cuh.h"
+
+PHI_DECLARE_bool(gpugraph_enable_bucket_hbm_table);
+
 namespace paddle {
 namespace framework {
 
@@ -236,6 +239,88 @@ __global__ void dy_mf_update_kernel(Table* table,
   }
 }
 
+// The kernels of the bucket table, where a tile of Table::kBucketSize threads
+// probes the buckets of a key.
+template <typename Table>
+__global__ void bucket_insert_kernel(Table* table,
+                                     const typename Table::key_type* const keys,
+                                     size_t len,
+                                     char* pool,
+                                     size_t feature_value_size,
+                                     int start_index) {
+  ReplaceOp<typename Table::mapped_type> op;
+  thrust::pair<typename Table::key_type, typename Table::mapped_type> kv;
+  auto tile = cooperative_groups::tiled_partition<Table::kBucketSize>(
+      cooperative_groups::this_thread_block());
+
+  const size_t i = (blockIdx.x * blockDim.x + threadIdx.x) / Table::kBucketSize;
+  if (i < len) {
+    kv.first = keys[i];
+    uint64_t offset = uint64_t(start_index + i) * feature_value_size;
+    kv.second = (typename Table::mapped_type)(pool + offset);
+    auto* slot = table->insert(tile, kv, op);
+    if (tile.thread_rank() == 0) {
+      PADDLE_ENFORCE(slot != table->end_slot(),
+                     "error: insert fails: table is full");
+    }
+  }
+}
+
+template <typename Table, typename GPUAccessor>
+__global__ void dy_mf_bucket_search_kernel(
+    Table* table,
+    const typename Table::key_type* const keys,
+    char* vals,
+    size_t len,
+    size_t pull_feature_value_size,
+    GPUAccessor gpu_accessor,
+    bool zero_fill) {
+  auto tile = cooperative_groups::tiled_partition<Table::kBucketSize>(
+      cooperative_groups::this_thread_block());
+  const size_t i = (blockIdx.x * blockDim.x + threadIdx.x) / Table::kBucketSize;
+  if (i < len) {
+    auto* slot = table->find(tile, keys[i]);
+    if (tile.thread_rank() != 0) {
+      return;
+    }
+    float* cur = reinterpret_cast<float*>(vals + i * pull_feature_value_size);
+    if (slot != table->end_slot()) {
+      gpu_accessor.PullValueFill(cur, slot->second);
+    } else if (zero_fill) {
+      gpu_accessor.PullZeroValue(cur);
+    } else {
+      PADDLE_ENFORCE(false, "warning: pull miss key: %lu", keys[i]);
+    }
+  }
+}
+
+template <typename Table, typename Sgd>
+__global__ void dy_mf_bucket_update_kernel(
+    Table* table,
+    const OptimizerConfig& optimizer_config,
+    const typename Table::key_type* const keys,
+    const char* const grads,
+    size_t len,
+    Sgd sgd,
+    size_t grad_value_size) {
+  auto tile = cooperative_groups::tiled_partition<Table::kBucketSize>(
+      cooperative_groups::this_thread_block());
+  const size_t i = (blockIdx.x * blockDim.x + threadIdx.x) / Table::kBucketSize;
+  if (i < len) {
+    auto* slot = table->find(tile, keys[i]);
+    if (tile.thread_rank() != 0) {
+      return;
+    }
+    if (slot != table->end_slot()) {
+      const float* cur =
+          reinterpret_cast<const float*>(grads + i * grad_value_size);
+      sgd.dy_mf_update_value(optimizer_config, slot->second, cur);
+    } else {
+      PADDLE_ENFORCE(false, "warning: push miss key: %lu", keys[i]);
+    }
+  }
+}
+
 template <typename Table>
 __global__ void get_keys_kernel(Table* table,
                                 typename Table::key_type* d_out,
@@ -313,7 +398,12 @@ __global__ void get_key_values_kernel(Table* table,
 template <typename KeyType, typename ValType>
 HashTable<KeyType, ValType>::HashTable(size_t capacity, cudaStream_t stream) {
   stream_ = stream;
-  container_ = new TableContainer<KeyType, ValType>(capacity, stream);
+  if (FLAGS_gpugraph_enable_bucket_hbm_table) {
+    bucket_container_ =
+        new BucketTableContainer<KeyType, ValType>(capacity, stream);
+  } else {
+    container_ = new TableContainer<KeyType, ValType>(capacity, stream);
+  }
   CUDA_RT_CALL(cudaMalloc(reinterpret_cast<void**>(&device_optimizer_config_),
                           sizeof(OptimizerConfig)));
   CUDA_RT_CALL(
@@ -329,9 +419,22 @@ HashTable<KeyType, ValType>::HashTable(size_t capacity, cudaStream_t stream) {
 template <typename KeyType, typename ValType>
 HashTable<KeyType, ValType>::~HashTable() {
   delete container_;
+  delete bucket_container_;
   cudaFree(device_optimizer_config_);
 }
 
+template <typename KeyType, typename ValType>
+void HashTable<KeyType, ValType>::rehash(size_t capacity, cudaStream_t stream) {
+  PADDLE_ENFORCE_NOT_NULL(
+      bucket_container_,
+      phi::errors::Unimplemented("Only the bucket hbm table can be rehashed, "
+                                 "please set "
+                                 "FLAGS_gpugraph_enable_bucket_hbm_table."));
+  VLOG(1) << "rehash bucket hbm table from " << bucket_container_->size()
+          << " to " << capacity << " slots";
+  bucket_container_->rehash(capacity, stream);
+}
+
 template <typename KeyType, typename ValType>
 void HashTable<KeyType, ValType>::set_sparse_sgd(
     const OptimizerConfig& optimizer_config) {
@@ -358,7 +461,7 @@ void HashTable<KeyType, ValType>::set_embedx_sgd(
 
 template <typename KeyType, typename ValType>
 void HashTable<KeyType, ValType>::show() {
-  container_->print();
+  with_container([](auto* table) { table->print(); });
 }
 
 template <typename KeyType, typename ValType>
@@ -371,8 +474,10 @@ void HashTable<KeyType, ValType>::get(const KeyType* d_keys,
     return;
   }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
-  search_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
-      container_, d_keys, d_vals, len);
+  with_container([&](auto* table) {
+    search_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+        table, d_keys, d_vals, len);
+  });
 }
 
 template <typename KeyType, typename ValType>
@@ -385,6 +490,21 @@ void HashTable<KeyType, ValType>::get(const KeyType* d_keys,
   if (len == 0) {
     return;
   }
+  if (bucket_container_) {
+    const int grid_size =
+        (len * BucketTableContainer<KeyType, ValType>::kBucketSize - 1) /
+            BLOCK_SIZE_ +
+        1;
+    dy_mf_bucket_search_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+        bucket_container_,
+        d_keys,
+        d_vals,
+        len,
+        pull_feature_value_size_,
+        fv_accessor,
+        infer_mode_);
+    return;
+  }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
   // infer need zero fill
   if (infer_mode_) {
@@ -406,8 +526,10 @@ void HashTable<KeyType, ValType>::get_ranks(const KeyType* d_keys,
     return;
   }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
-  search_ranks_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
-      container_, d_keys, d_vals, len);
+  with_container([&](auto* table) {
+    search_ranks_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+        table, d_keys, d_vals, len);
+  });
 }
 
 template <typename KeyType, typename ValType>
@@ -421,8 +543,10 @@ void HashTable<KeyType, ValType>::insert(const KeyType* d_keys,
     return;
   }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
-  insert_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
-      container_, d_keys, len, dft_val, global_num);
+  with_container([&](auto* table) {
+    insert_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+        table, d_keys, len, dft_val, global_num);
+  });
 }
 
 template <typename KeyType, typename ValType>
@@ -436,8 +560,10 @@ void HashTable<KeyType, ValType>::insert(const KeyType* d_keys,
     return;
   }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
-  insert_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
-      container_, d_keys, d_vals, len, global_num);
+  with_container([&](auto* table) {
+    insert_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+        table, d_keys, d_vals, len, global_num);
+  });
 }
 
 template <typename KeyType, typename ValType>
@@ -450,8 +576,10 @@ void HashTable<KeyType, ValType>::insert(const KeyType* d_keys,
     return;
   }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
-  insert_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
-      container_, d_keys, d_vals, len);
+  with_container([&](auto* table) {
+    insert_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+        table, d_keys, d_vals, len);
+  });
 }
 
 template <typename KeyType, typename ValType>
@@ -459,12 +587,14 @@ template <typename StreamType>
 void HashTable<KeyType, ValType>::get_keys(KeyType* d_out,
                                            uint64_t* global_cursor,
                                            StreamType stream) {
-  size_t len = container_->size();
+  size_t len = size();
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
   KeyType unuse_key = std::numeric_limits<KeyType>::max();
   size_t shared_mem_size = sizeof(KeyType) * BLOCK_SIZE_;
-  get_keys_kernel<<<grid_size, BLOCK_SIZE_, shared_mem_size, stream>>>(
-      container_, d_out, global_cursor, unuse_key);
+  with_container([&](auto* table) {
+    get_keys_kernel<<<grid_size, BLOCK_SIZE_, shared_mem_size, stream>>>(
+        table, d_out, global_cursor, unuse_key);
+  });
 }
 
 template <typename KeyType, typename ValType>
@@ -474,12 +604,14 @@ void HashTable<KeyType, ValType>::get_key_values(KeyType* d_keys,
                                                  uint64_t* global_cursor,
                                                  StreamType stream) {
   const int BLOCK_SIZE = 128;
-  size_t len = container_->size();
+  size_t len = size();
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
   KeyType unuse_key = std::numeric_limits<KeyType>::max();
   size_t shared_mem_size = (sizeof(KeyType) + sizeof(ValType)) * BLOCK_SIZE_;
-  get_key_values_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
-      container_, d_keys, d_vals, global_cursor, unuse_key);
+  with_container([&](auto* table) {
+    get_key_values_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+        table, d_keys, d_vals, global_cursor, unuse_key);
+  });
 }
 
 template <typename KeyType, typename ValType>
@@ -496,6 +628,29 @@ void HashTable<KeyType, ValType>::insert(const KeyType* d_keys,
   if (pool == NULL) {
     return;
   }
+  if (bucket_container_) {
+    constexpr float kMaxLoadFactor =
+        BucketTableContainer<KeyType, ValType>::kMaxLoadFactor;
+    const size_t need_num = inserted_num_ + len;
+    if (need_num > bucket_container_->size() * kMaxLoadFactor) {
+      rehash(std::max<size_t>(bucket_container_->size() * 2,
+                              need_num / LOAD_FACTOR),
+             stream);
+    }
+    inserted_num_ = need_num;
+    const int grid_size =
+        (len * BucketTableContainer<KeyType, ValType>::kBucketSize - 1) /
+            BLOCK_SIZE_ +
+        1;
+    bucket_insert_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+        bucket_container_,
+        d_keys,
+        len,
+        pool,
+        feature_value_size,
+        start_index);
+    return;
+  }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
   insert_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
       container_, d_keys, len, pool, feature_value_size, start_index);
@@ -504,7 +659,7 @@ void HashTable<KeyType, ValType>::insert(const KeyType* d_keys,
 template <typename KeyType, typename ValType>
 template <typename StreamType>
 void HashTable<KeyType, ValType>::dump_to_cpu(int devid, StreamType stream) {
-  container_->prefetch(cudaCpuDeviceId, stream);
+  prefetch(cudaCpuDeviceId, stream);
 }
 
 template <typename KeyType, typename ValType>
@@ -518,8 +673,10 @@ void HashTable<KeyType, ValType>::update(const KeyType* d_keys,
     return;
   }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
-  update_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
-      container_, *device_optimizer_config_, d_keys, d_grads, len, sgd);
+  with_container([&](auto* table) {
+    update_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+        table, *device_optimizer_config_, d_keys, d_grads, len, sgd);
+  });
 }
 
 template <typename KeyType, typename ValType>
@@ -532,6 +689,21 @@ void HashTable<KeyType, ValType>::update(const KeyType* d_keys,
   if (len == 0) {
     return;
   }
+  if (bucket_container_) {
+    const int grid_size =
+        (len * BucketTableContainer<KeyType, ValType>::kBucketSize - 1) /
+            BLOCK_SIZE_ +
+        1;
+    dy_mf_bucket_update_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+        bucket_container_,
+        *device_optimizer_config_,
+        d_keys,
+        d_grads,
+        len,
+        sgd,
+        push_grad_value_size_);
+    return;
+  }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
   dy_mf_update_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
       container_,
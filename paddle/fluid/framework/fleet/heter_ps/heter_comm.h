@@ -524,6 +524,34 @@ class HeterComm {
                            KeyType* d_keys,
                            float* d_vals,
                            const size_t& len);
+  // single node all2all pull and push, which exchange the shards between
+  // the cards by nccl all2all instead of walk_to_dest and walk_to_src
+  bool use_inner_all2all() const;
+  void pull_sparse_inner_all2all(const int& gpu_id,
+                                 KeyType* d_keys,
+                                 float* d_vals,
+                                 const size_t& len);
+  template <typename Sgd>
+  void push_sparse_inner_all2all(const int& gpu_id,
+                                 KeyType* d_keys,
+                                 float* d_grads,
+                                 const size_t& len,
+                                 Sgd& sgd);  // NOLINT
+  // gather the shard sizes of all the cards, and return the number of keys
+  // received by gpu_id
+  size_t exchange_inner_shard_sizes(const int& gpu_id,
+                                    const int* h_left,
+                                    const int* h_right,
+                                    const cudaStream_t& stream);
+  // launch the all2all on the comm stream without waiting it
+  void send_data_by_inner_all2all(const int& gpu_id,
+                                  const size_t& value_bytes,
+                                  const size_t* h_send_part_sizes,
+                                  const size_t* h_send_part_offsets,
+                                  const size_t* h_recv_part_sizes,
+                                  const size_t* h_recv_part_offsets,
+                                  const char* d_send_buff,
+                                  char* d_rev_buff);
 
   template <typename Sgd>
   void push_normal_sparse(int num,
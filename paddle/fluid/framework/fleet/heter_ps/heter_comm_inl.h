@@ -29,6 +29,7 @@ limitations under the License. */
 
 PHI_DECLARE_double(gpugraph_hbm_table_load_factor);
 PHI_DECLARE_bool(gpugraph_enable_gpu_direct_access);
+PHI_DECLARE_bool(gpugraph_enable_inner_all2all);
 PHI_DECLARE_bool(gpugraph_enable_segment_merge_grads);
 PHI_DECLARE_uint64(gpugraph_merge_grads_segment_size);
 PHI_DECLARE_int32(gpugraph_dedup_pull_push_mode);
@@ -111,7 +112,7 @@ HeterComm<KeyType, ValType, GradType, GPUAccessor>::HeterComm(
       ptr_table->set_feature_value_size(pull_type_size_, grad_type_size_);
       ptr_tables_.push_back(ptr_table);
     }
-    if (multi_node_) {
+    if (multi_node_ || FLAGS_gpugraph_enable_inner_all2all) {
       storage_[i].init(device_num_,
                        resource_->dev_id(i),
                        phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
@@ -193,7 +194,7 @@ HeterComm<KeyType, ValType, GradType, GPUAccessor>::HeterComm(
       ptr_table->set_feature_value_size(pull_type_size_, grad_type_size_);
       ptr_tables_.push_back(ptr_table);
     }
-    if (multi_node_) {
+    if (multi_node_ || FLAGS_gpugraph_enable_inner_all2all) {
       storage_[i].init(device_num_,
                        resource_->dev_id(i),
                        phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
@@ -1811,6 +1812,13 @@ template <typename KeyType,
           typename GPUAccessor>
 void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_sparse(
     int num, KeyType *d_keys, float *d_vals, size_t len) {
+#if defined(PADDLE_WITH_CUDA)
+  if (use_inner_all2all()) {
+    // every card takes part in the all2all, even if it has no keys
+    pull_sparse_inner_all2all(num, d_keys, d_vals, len);
+    return;
+  }
+#endif
   if (len == 0) {
     return;
   }
@@ -1844,6 +1852,8 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::push_sparse(
     Sgd &sgd) {  // NOLINT
   if (multi_node_) {
     push_sparse_all2all(dev_num, d_keys, d_grads, len, sgd);
+  } else if (use_inner_all2all()) {
+    push_sparse_inner_all2all(dev_num, d_keys, d_grads, len, sgd);
   } else {
     push_normal_sparse(dev_num, d_keys, d_grads, len, sgd);
   }
@@ -2374,6 +2384,287 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_one_table(
         (gpu_id == 0));
   }
 }
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+bool HeterComm<KeyType, ValType, GradType, GPUAccessor>::use_inner_all2all()
+    const {
+  return !multi_node_ && FLAGS_gpugraph_enable_inner_all2all &&
+         !nccl_inner_comms_.empty();
+}
+
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+size_t HeterComm<KeyType, ValType, GradType, GPUAccessor>::
+    exchange_inner_shard_sizes(const int &gpu_id,
+                               const int *h_left,
+                               const int *h_right,
+                               const cudaStream_t &stream) {
+  auto &cache = storage_[gpu_id];
+  cache.init_shard(1, device_num_);
+  auto &res = cache.shard_res;
+  size_t *h_send_part_sizes = res.h_local_part_sizes.data();
+  size_t *h_send_part_offsets = res.h_local_part_offsets.data();
+  size_t *h_recv_part_sizes = res.h_remote_part_sizes.data();
+  size_t *h_recv_part_offsets = res.h_remote_part_offsets.data();
+  uint32_t *h_push_fea_sizes = res.h_push_fea_sizes.data();
+
+  int rank_offset = gpu_id * device_num_;
+  h_send_part_offsets[0] = 0;
+  for (int i = 0; i < device_num_; ++i) {
+    h_send_part_sizes[i] = (h_left[i] == -1 || h_right[i] == -1)
+                               ? 0
+                               : h_right[i] - h_left[i] + 1;
+    h_send_part_offsets[i + 1] = h_send_part_offsets[i] + h_send_part_sizes[i];
+    h_push_fea_sizes[rank_offset + i] = h_send_part_sizes[i];
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(&res.d_node_size_ptr[rank_offset],
+                                             &h_push_fea_sizes[rank_offset],
+                                             device_num_ * sizeof(uint32_t),
+                                             cudaMemcpyHostToDevice,
+                                             stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+
+  auto &comm = nccl_inner_comms_[gpu_id];
+  auto nccl_stream = resource_->comm_stream(gpu_id, 0);
+  PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclAllGather(
+      &res.d_node_size_ptr[rank_offset],
+      reinterpret_cast<void *>(res.d_node_size_ptr),
+      device_num_,
+      ncclInt,
+      comm,
+      nccl_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(nccl_stream));
+
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemcpyAsync(h_push_fea_sizes,
+                      res.d_node_size_ptr,
+                      device_num_ * device_num_ * sizeof(uint32_t),
+                      cudaMemcpyDeviceToHost,
+                      stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+
+  h_recv_part_offsets[0] = 0;
+  for (int i = 0; i < device_num_; ++i) {
+    h_recv_part_sizes[i] = h_push_fea_sizes[i * device_num_ + gpu_id];
+    h_recv_part_offsets[i + 1] = h_recv_part_offsets[i] + h_recv_part_sizes[i];
+  }
+  return h_recv_part_offsets[device_num_];
+}
+
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+void HeterComm<KeyType, ValType, GradType, GPUAccessor>::
+    send_data_by_inner_all2all(const int &gpu_id,
+                               const size_t &value_bytes,
+                               const size_t *h_send_part_sizes,
+                               const size_t *h_send_part_offsets,
+                               const size_t *h_recv_part_sizes,
+                               const size_t *h_recv_part_offsets,
+                               const char *d_send_buff,
+                               char *d_rev_buff) {
+  auto &comm = nccl_inner_comms_[gpu_id];
+  auto nccl_stream = resource_->comm_stream(gpu_id, 0);
+  PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclGroupStart());
+  for (int i = 0; i < device_num_; ++i) {
+    // the part of its own is copied by the caller
+    if (i == gpu_id) {
+      continue;
+    }
+    if (h_send_part_sizes[i] > 0) {
+      PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclSend(
+          &d_send_buff[h_send_part_offsets[i] * value_bytes],
+          h_send_part_sizes[i] * value_bytes,
+          ncclInt8,
+          i,
+          comm,
+          nccl_stream));
+    }
+    if (h_recv_part_sizes[i] > 0) {
+      PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclRecv(
+          reinterpret_cast<void *>(
+              &d_rev_buff[h_recv_part_offsets[i] * value_bytes]),
+          h_recv_part_sizes[i] * value_bytes,
+          ncclInt8,
+          i,
+          comm,
+          nccl_stream));
+    }
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclGroupEnd());
+}
+
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+void HeterComm<KeyType, ValType, GradType, GPUAccessor>::
+    pull_sparse_inner_all2all(const int &gpu_id,
+                              KeyType *d_keys,
+                              float *d_vals,
+                              const size_t &len) {
+  int dev_id = resource_->dev_id(gpu_id);
+  DevPlace place = DevPlace(dev_id);
+  AnyDeviceGuard guard(dev_id);
+  auto stream = resource_->local_stream(gpu_id, 0);
+  auto nccl_stream = resource_->comm_stream(gpu_id, 0);
+  auto &loc = storage_[gpu_id];
+  auto &res = loc.shard_res;
+  size_t val_type_size = pull_type_size_;
+  loc.all2all_span_.Resume();
+
+  int h_left[device_num_];   // NOLINT
+  int h_right[device_num_];  // NOLINT
+  std::fill(h_left, h_left + device_num_, -1);
+  std::fill(h_right, h_right + device_num_, -1);
+
+  // merge the keys, and sort the unique keys by shard
+  auto d_sorted_keys = MemoryAlloc(place, len * sizeof(KeyType));
+  auto d_sorted_keys_ptr = reinterpret_cast<KeyType *>(d_sorted_keys->ptr());
+  auto d_merged_keys = MemoryAlloc(place, len * sizeof(KeyType));
+  auto d_merged_keys_ptr = reinterpret_cast<KeyType *>(d_merged_keys->ptr());
+  auto d_restore_idx = MemoryAlloc(place, len * sizeof(uint32_t));
+  auto d_restore_idx_ptr = reinterpret_cast<uint32_t *>(d_restore_idx->ptr());
+  auto d_shard_keys = MemoryAlloc(place, len * sizeof(KeyType));
+  auto d_shard_keys_ptr = reinterpret_cast<KeyType *>(d_shard_keys->ptr());
+  auto d_shard_vals = MemoryAlloc(place, len * val_type_size);
+  auto d_shard_vals_ptr = reinterpret_cast<char *>(d_shard_vals->ptr());
+  auto d_idx = MemoryAlloc(place, len * sizeof(int));
+  auto d_idx_ptr = reinterpret_cast<int *>(d_idx->ptr());
+
+  size_t uniq_len = 0;
+  if (len > 0) {
+    auto d_left = MemoryAlloc(place, device_num_ * sizeof(int));
+    auto d_right = MemoryAlloc(place, device_num_ * sizeof(int));
+    int *d_left_ptr = reinterpret_cast<int *>(d_left->ptr());
+    int *d_right_ptr = reinterpret_cast<int *>(d_right->ptr());
+    cudaMemsetAsync(d_left_ptr, -1, device_num_ * sizeof(int), stream);
+    cudaMemsetAsync(d_right_ptr, -1, device_num_ * sizeof(int), stream);
+
+    uniq_len = merge_keys(gpu_id,
+                          d_keys,
+                          len,
+                          d_sorted_keys_ptr,
+                          d_merged_keys_ptr,
+                          d_restore_idx_ptr,
+                          stream);
+    sync_stream(stream);
+    split_idx_to_shard(d_merged_keys_ptr,
+                       d_idx_ptr,
+                       uniq_len,
+                       d_left_ptr,
+                       d_right_ptr,
+                       gpu_id,
+                       stream);
+    heter_comm_kernel_->fill_shard_key(d_shard_keys_ptr,
+                                       d_merged_keys_ptr,
+                                       d_idx_ptr,
+                                       uniq_len,
+                                       stream,
+                                       dev_id);
+    memory_copy(platform::CPUPlace(),
+                h_left,
+                place,
+                d_left_ptr,
+                device_num_ * sizeof(int),
+                stream);
+    memory_copy(platform::CPUPlace(),
+                h_right,
+                place,
+                d_right_ptr,
+                device_num_ * sizeof(int),
+                stream);
+    sync_stream(stream);
+  }
+
+  loc.node_span_.Resume();
+  size_t recv_len = exchange_inner_shard_sizes(gpu_id, h_left, h_right, stream);
+  const size_t *h_send_part_sizes = res.h_local_part_sizes.data();
+  const size_t *h_send_part_offsets = res.h_local_part_offsets.data();
+  const size_t *h_recv_part_sizes = res.h_remote_part_sizes.data();
+  const size_t *h_recv_part_offsets = res.h_remote_part_offsets.data();
+
+  auto d_recv_keys = MemoryAlloc(place, recv_len * sizeof(KeyType));
+  auto d_recv_keys_ptr = reinterpret_cast<KeyType *>(d_recv_keys->ptr());
+  auto d_recv_vals = MemoryAlloc(place, recv_len * val_type_size);
+  auto d_recv_vals_ptr = reinterpret_cast<char *>(d_recv_vals->ptr());
+  send_data_by_inner_all2all(gpu_id,
+                             sizeof(KeyType),
+                             h_send_part_sizes,
+                             h_send_part_offsets,
+                             h_recv_part_sizes,
+                             h_recv_part_offsets,
+                             reinterpret_cast<const char *>(d_shard_keys_ptr),
+                             reinterpret_cast<char *>(d_recv_keys_ptr));
+  // pull the own shard while the keys of the other cards are on the way
+  size_t own_begin = h_recv_part_offsets[gpu_id];
+  size_t own_end = h_recv_part_offsets[gpu_id + 1];
+  pull_one_table(
+      gpu_id,
+      d_shard_keys_ptr + h_send_part_offsets[gpu_id],
+      reinterpret_cast<float *>(d_recv_vals_ptr + own_begin * val_type_size),
+      h_send_part_sizes[gpu_id],
+      stream);
+  sync_stream(nccl_stream);
+  pull_one_table(gpu_id,
+                 d_recv_keys_ptr,
+                 reinterpret_cast<float *>(d_recv_vals_ptr),
+                 own_begin,
+                 stream);
+  pull_one_table(
+      gpu_id,
+      d_recv_keys_ptr + own_end,
+      reinterpret_cast<float *>(d_recv_vals_ptr + own_end * val_type_size),
+      recv_len - own_end,
+      stream);
+  sync_stream(stream);
+
+  // send the values back by the reverse all2all
+  send_data_by_inner_all2all(gpu_id,
+                             val_type_size,
+                             h_recv_part_sizes,
+                             h_recv_part_offsets,
+                             h_send_part_sizes,
+                             h_send_part_offsets,
+                             d_recv_vals_ptr,
+                             d_shard_vals_ptr);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(
+      d_shard_vals_ptr + h_send_part_offsets[gpu_id] * val_type_size,
+      d_recv_vals_ptr + own_begin * val_type_size,
+      h_send_part_sizes[gpu_id] * val_type_size,
+      cudaMemcpyDeviceToDevice,
+      stream));
+  sync_stream(nccl_stream);
+  sync_stream(stream);
+  loc.node_span_.Pause();
+
+  if (len > 0) {
+    auto d_merged_vals = MemoryAlloc(place, uniq_len * val_type_size);
+    auto d_merged_vals_ptr = reinterpret_cast<float *>(d_merged_vals->ptr());
+    heter_comm_kernel_->dy_mf_fill_dvals(
+        reinterpret_cast<float *>(d_shard_vals_ptr),
+        d_merged_vals_ptr,
+        d_idx_ptr,
+        uniq_len,
+        val_type_size,
+        stream);
+    heter_comm_kernel_->unpack_merged_vals(len,
+                                           d_keys,
+                                           d_merged_vals_ptr,
+                                           d_restore_idx_ptr,
+                                           d_vals,
+                                           val_type_size,
+                                           stream);
+    sync_stream(stream);
+  }
+  loc.all2all_span_.Pause();
+}
+
 template <typename KeyType,
           typename ValType,
           typename GradType,
@@ -3391,6 +3682,145 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::gather_inner_data_p2p(
   }
   PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
 }
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+template <typename Sgd>
+void HeterComm<KeyType, ValType, GradType, GPUAccessor>::
+    push_sparse_inner_all2all(const int &gpu_id,
+                              KeyType *d_keys,
+                              float *d_grads,
+                              const size_t &len,
+                              Sgd &sgd) {  // NOLINT
+  int dev_id = resource_->dev_id(gpu_id);
+  DevPlace place = DevPlace(dev_id);
+  AnyDeviceGuard guard(dev_id);
+  auto stream = resource_->local_stream(gpu_id, 0);
+  auto nccl_stream = resource_->comm_stream(gpu_id, 0);
+  auto &loc = storage_[gpu_id];
+  auto &res = loc.shard_res;
+  size_t grad_value_size = grad_type_size_;
+  loc.all2all_span_.Resume();
+
+  int h_left[device_num_];   // NOLINT
+  int h_right[device_num_];  // NOLINT
+  std::fill(h_left, h_left + device_num_, -1);
+  std::fill(h_right, h_right + device_num_, -1);
+
+  auto d_shard_keys = MemoryAlloc(place, len * sizeof(KeyType));
+  auto d_shard_keys_ptr = reinterpret_cast<KeyType *>(d_shard_keys->ptr());
+  auto d_shard_grads = MemoryAlloc(place, len * grad_value_size);
+  auto d_shard_grads_ptr = reinterpret_cast<char *>(d_shard_grads->ptr());
+
+  if (len > 0) {
+    int uniq_len = len;
+    if (!FLAGS_gpugraph_dedup_pull_push_mode) {
+      size_t segment_len = 0;
+      dynamic_merge_grad(
+          gpu_id, d_keys, d_grads, len, uniq_len, segment_len, false);
+    }
+    auto d_left = MemoryAlloc(place, device_num_ * sizeof(int));
+    auto d_right = MemoryAlloc(place, device_num_ * sizeof(int));
+    int *d_left_ptr = reinterpret_cast<int *>(d_left->ptr());
+    int *d_right_ptr = reinterpret_cast<int *>(d_right->ptr());
+    cudaMemsetAsync(d_left_ptr, -1, device_num_ * sizeof(int), stream);
+    cudaMemsetAsync(d_right_ptr, -1, device_num_ * sizeof(int), stream);
+    auto d_idx = MemoryAlloc(place, uniq_len * sizeof(int));
+    auto d_idx_ptr = reinterpret_cast<int *>(d_idx->ptr());
+
+    split_idx_to_shard(
+        d_keys, d_idx_ptr, uniq_len, d_left_ptr, d_right_ptr, gpu_id, stream);
+    heter_comm_kernel_->dy_mf_fill_shard_grads(
+        d_shard_keys_ptr,
+        d_keys,
+        reinterpret_cast<float *>(d_shard_grads_ptr),
+        d_grads,
+        d_idx_ptr,
+        uniq_len,
+        grad_value_size,
+        stream,
+        gpu_accessor_);
+    memory_copy(platform::CPUPlace(),
+                h_left,
+                place,
+                d_left_ptr,
+                device_num_ * sizeof(int),
+                stream);
+    memory_copy(platform::CPUPlace(),
+                h_right,
+                place,
+                d_right_ptr,
+                device_num_ * sizeof(int),
+                stream);
+    sync_stream(stream);
+  }
+
+  loc.node_span_.Resume();
+  size_t recv_len = exchange_inner_shard_sizes(gpu_id, h_left, h_right, stream);
+  const size_t *h_send_part_sizes = res.h_local_part_sizes.data();
+  const size_t *h_send_part_offsets = res.h_local_part_offsets.data();
+  const size_t *h_recv_part_sizes = res.h_remote_part_sizes.data();
+  const size_t *h_recv_part_offsets = res.h_remote_part_offsets.data();
+
+  auto d_recv_keys = MemoryAlloc(place, recv_len * sizeof(KeyType));
+  auto d_recv_keys_ptr = reinterpret_cast<KeyType *>(d_recv_keys->ptr());
+  auto d_recv_grads = MemoryAlloc(place, recv_len * grad_value_size);
+  auto d_recv_grads_ptr = reinterpret_cast<char *>(d_recv_grads->ptr());
+  send_data_by_inner_all2all(gpu_id,
+                             sizeof(KeyType),
+                             h_send_part_sizes,
+                             h_send_part_offsets,
+                             h_recv_part_sizes,
+                             h_recv_part_offsets,
+                             reinterpret_cast<const char *>(d_shard_keys_ptr),
+                             reinterpret_cast<char *>(d_recv_keys_ptr));
+  send_data_by_inner_all2all(gpu_id,
+                             grad_value_size,
+                             h_send_part_sizes,
+                             h_send_part_offsets,
+                             h_recv_part_sizes,
+                             h_recv_part_offsets,
+                             d_shard_grads_ptr,
+                             d_recv_grads_ptr);
+  size_t own_begin = h_recv_part_offsets[gpu_id];
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemcpyAsync(d_recv_keys_ptr + own_begin,
+                      d_shard_keys_ptr + h_send_part_offsets[gpu_id],
+                      h_send_part_sizes[gpu_id] * sizeof(KeyType),
+                      cudaMemcpyDeviceToDevice,
+                      stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(
+      d_recv_grads_ptr + own_begin * grad_value_size,
+      d_shard_grads_ptr + h_send_part_offsets[gpu_id] * grad_value_size,
+      h_send_part_sizes[gpu_id] * grad_value_size,
+      cudaMemcpyDeviceToDevice,
+      stream));
+  sync_stream(nccl_stream);
+  sync_stream(stream);
+  loc.node_span_.Pause();
+
+  if (recv_len > 0) {
+    // merge the grads of a key pushed by several cards
+    auto d_merged_keys = MemoryAlloc(place, recv_len * sizeof(KeyType));
+    auto d_merged_keys_ptr = reinterpret_cast<KeyType *>(d_merged_keys->ptr());
+    auto d_merged_grads = MemoryAlloc(place, recv_len * grad_value_size);
+    size_t uniq_len = merge_grad(gpu_id,
+                                 recv_len,
+                                 d_recv_keys_ptr,
+                                 d_merged_keys_ptr,
+                                 d_recv_grads_ptr,
+                                 d_merged_grads->ptr(),
+                                 stream);
+    update_one_table(gpu_id,
+                     d_merged_keys_ptr,
+                     reinterpret_cast<GradType *>(d_merged_grads->ptr()),
+                     uniq_len,
+                     sgd);
+  }
+  loc.all2all_span_.Pause();
+}
+
 template <typename KeyType,
           typename ValType,
           typename GradType,
@@ -28,6 +28,9 @@ std::shared_ptr<Metric> Metric::s_instance_ = nullptr;
 
 void BasicAucCalculator::init(int table_size) {
   set_table_size(table_size);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  _gpu_tables.clear();
+#endif
 
   // init CPU memory
   for (auto& item : _table) {
@@ -46,12 +49,21 @@ void BasicAucCalculator::reset() {
   _local_abserr = 0;
   _local_sqrerr = 0;
   _local_pred = 0;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  reset_gpu_tables();
+#endif
 }
 
 void BasicAucCalculator::add_data(const float* d_pred,
                                   const int64_t* d_label,
                                   int batch_size,
                                   const paddle::platform::Place& place) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (platform::is_gpu_place(place)) {
+    add_gpu_data(d_pred, d_label, nullptr, batch_size, place);
+    return;
+  }
+#endif
   thread_local std::vector<float> h_pred;
   thread_local std::vector<int64_t> h_label;
   h_pred.resize(batch_size);
@@ -101,6 +113,12 @@ void BasicAucCalculator::add_mask_data(const float* d_pred,
                                        const int64_t* d_mask,
                                        int batch_size,
                                        const paddle::platform::Place& place) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (platform::is_gpu_place(place)) {
+    add_gpu_data(d_pred, d_label, d_mask, batch_size, place);
+    return;
+  }
+#endif
   thread_local std::vector<float> h_pred;
   thread_local std::vector<int64_t> h_label;
   thread_local std::vector<int64_t> h_mask;
@@ -121,6 +139,9 @@ void BasicAucCalculator::add_mask_data(const float* d_pred,
 }
 
 void BasicAucCalculator::compute() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  merge_gpu_tables();
+#endif
 #if defined(PADDLE_WITH_GLOO)
   double area = 0;
   double fp = 0;
@@ -133,8 +154,10 @@ void BasicAucCalculator::compute() {
   }
 
   if (gloo_wrapper->Size() > 1) {
-    auto neg_table = gloo_wrapper->AllReduce(_table[0], "sum");
-    auto pos_table = gloo_wrapper->AllReduce(_table[1], "sum");
+    auto tables =
+        gloo_wrapper->FusedAllReduce<double>({&_table[0], &_table[1]}, "sum");
+    const auto& neg_table = tables[0];
+    const auto& pos_table = tables[1];
     for (int i = _table_size - 1; i >= 0; i--) {
       double newfp = fp + neg_table[i];
       double newtp = tp + pos_table[i];
@@ -159,16 +182,12 @@ void BasicAucCalculator::compute() {
   }
 
   if (gloo_wrapper->Size() > 1) {
-    // allreduce sum
-    std::vector<double> local_abserr_vec(1, _local_abserr);
-    std::vector<double> local_sqrerr_vec(1, _local_sqrerr);
-    std::vector<double> local_pred_vec(1, _local_pred);
-    auto global_abserr_vec = gloo_wrapper->AllReduce(local_abserr_vec, "sum");
-    auto global_sqrerr_vec = gloo_wrapper->AllReduce(local_sqrerr_vec, "sum");
-    auto global_pred_vec = gloo_wrapper->AllReduce(local_pred_vec, "sum");
-    _mae = global_abserr_vec[0] / (fp + tp);
-    _rmse = sqrt(global_sqrerr_vec[0] / (fp + tp));
-    _predicted_ctr = global_pred_vec[0] / (fp + tp);
+    // allreduce sum of abserr, sqrerr and pred in one collective
+    std::vector<double> local_vec = {_local_abserr, _local_sqrerr, _local_pred};
+    auto global_vec = gloo_wrapper->AllReduce(local_vec, "sum");
+    _mae = global_vec[0] / (fp + tp);
+    _rmse = sqrt(global_vec[1] / (fp + tp));
+    _predicted_ctr = global_vec[2] / (fp + tp);
   } else {
     _mae = _local_abserr / (fp + tp);
     _rmse = sqrt(_local_sqrerr / (fp + tp));
@@ -192,8 +211,10 @@ void BasicAucCalculator::calculate_bucket_error() {
   double error_count = 0;
   auto gloo_wrapper = paddle::framework::GlooWrapper::GetInstance();
   if (gloo_wrapper->Size() > 1) {
-    auto neg_table = gloo_wrapper->AllReduce(_table[0], "sum");
-    auto pos_table = gloo_wrapper->AllReduce(_table[1], "sum");
+    auto tables =
+        gloo_wrapper->FusedAllReduce<double>({&_table[0], &_table[1]}, "sum");
+    const auto& neg_table = tables[0];
+    const auto& pos_table = tables[1];
     for (int i = 0; i < _table_size; i++) {
       double click = pos_table[i];
       double show = neg_table[i] + pos_table[i];
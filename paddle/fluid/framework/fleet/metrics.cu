@@ -0,0 +1,175 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <vector>
+
+#include "paddle/fluid/framework/fleet/metrics.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+
+#if defined(PADDLE_WITH_PSLIB) || defined(PADDLE_WITH_PSCORE)
+namespace paddle {
+namespace framework {
+
+// the stats after the neg and pos tables
+constexpr int kAbsErrIndex = 0;
+constexpr int kSqrErrIndex = 1;
+constexpr int kPredIndex = 2;
+constexpr int kInvalidIndex = 3;
+constexpr int kStatNum = 4;
+
+template <bool kHasMask>
+__global__ void AddAucDataKernel(const float* pred,
+                                 const int64_t* label,
+                                 const int64_t* mask,
+                                 int batch_size,
+                                 int table_size,
+                                 double* table) {
+  double abserr = 0;
+  double sqrerr = 0;
+  double pred_sum = 0;
+  double invalid = 0;
+  for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < batch_size;
+       i += blockDim.x * gridDim.x) {
+    if (kHasMask && !mask[i]) {
+      continue;
+    }
+    double p = pred[i];
+    int64_t l = label[i];
+    if (!(p >= 0.0 && p <= 1.0) || (l != 0 && l != 1)) {
+      invalid += 1;
+      continue;
+    }
+    int pos = min(static_cast<int>(p * table_size), table_size - 1);
+    phi::CudaAtomicAdd(table + l * table_size + pos, 1.0);
+    abserr += fabs(p - l);
+    sqrerr += (p - l) * (p - l);
+    pred_sum += p;
+  }
+  double* stats = table + 2 * table_size;
+  if (pred_sum > 0 || abserr > 0) {
+    phi::CudaAtomicAdd(stats + kAbsErrIndex, abserr);
+    phi::CudaAtomicAdd(stats + kSqrErrIndex, sqrerr);
+    phi::CudaAtomicAdd(stats + kPredIndex, pred_sum);
+  }
+  if (invalid > 0) {
+    phi::CudaAtomicAdd(stats + kInvalidIndex, invalid);
+  }
+}
+
+static gpuStream_t GetStream(const paddle::platform::Place& place) {
+  return static_cast<phi::GPUContext*>(
+             platform::DeviceContextPool::Instance().Get(place))
+      ->stream();
+}
+
+static void ClearGpuTable(double* table, size_t numel, gpuStream_t stream) {
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipMemsetAsync(table, 0, numel * sizeof(double), stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemsetAsync(table, 0, numel * sizeof(double), stream));
+#endif
+}
+
+double* BasicAucCalculator::get_gpu_table(
+    const paddle::platform::Place& place) {
+  std::lock_guard<std::mutex> lock(_table_mutex);
+  auto it = _gpu_tables.find(place.GetDeviceId());
+  if (it == _gpu_tables.end()) {
+    size_t numel = 2 * _table_size + kStatNum;
+    GpuTable gpu_table;
+    gpu_table.place = place;
+    gpu_table.data = memory::Alloc(place, numel * sizeof(double));
+    ClearGpuTable(reinterpret_cast<double*>(gpu_table.data->ptr()),
+                  numel,
+                  GetStream(place));
+    it = _gpu_tables.emplace(place.GetDeviceId(), std::move(gpu_table)).first;
+  }
+  return reinterpret_cast<double*>(it->second.data->ptr());
+}
+
+void BasicAucCalculator::add_gpu_data(const float* d_pred,
+                                      const int64_t* d_label,
+                                      const int64_t* d_mask,
+                                      int batch_size,
+                                      const paddle::platform::Place& place) {
+  if (batch_size <= 0) {
+    return;
+  }
+  double* table = get_gpu_table(place);
+  // the tables take the atomics, a few blocks are enough
+  const int threads = 512;
+  const int blocks = std::min((batch_size + threads - 1) / threads, 256);
+  auto stream = GetStream(place);
+  if (d_mask != nullptr) {
+    AddAucDataKernel<true><<<blocks, threads, 0, stream>>>(
+        d_pred, d_label, d_mask, batch_size, _table_size, table);
+  } else {
+    AddAucDataKernel<false><<<blocks, threads, 0, stream>>>(
+        d_pred, d_label, nullptr, batch_size, _table_size, table);
+  }
+}
+
+void BasicAucCalculator::merge_gpu_tables() {
+  std::lock_guard<std::mutex> lock(_table_mutex);
+  size_t numel = 2 * _table_size + kStatNum;
+  std::vector<double> h_table(numel);
+  for (auto& item : _gpu_tables) {
+    auto& gpu_table = item.second;
+    auto* table = reinterpret_cast<double*>(gpu_table.data->ptr());
+    auto stream = GetStream(gpu_table.place);
+    memory::Copy(phi::CPUPlace(),
+                 h_table.data(),
+                 gpu_table.place,
+                 table,
+                 numel * sizeof(double),
+                 stream);
+    platform::DeviceContextPool::Instance().Get(gpu_table.place)->Wait();
+    ClearGpuTable(table, numel, stream);
+
+    const double* stats = h_table.data() + 2 * _table_size;
+    PADDLE_ENFORCE_EQ(
+        stats[kInvalidIndex],
+        0,
+        platform::errors::PreconditionNotMet(
+            "pred should be in [0, 1] and label must be equal to 0 or 1, but "
+            "%d instances added on %s are not.",
+            static_cast<int64_t>(stats[kInvalidIndex]),
+            gpu_table.place));
+    for (int i = 0; i < _table_size; ++i) {
+      _table[0][i] += h_table[i];
+      _table[1][i] += h_table[_table_size + i];
+    }
+    _local_abserr += stats[kAbsErrIndex];
+    _local_sqrerr += stats[kSqrErrIndex];
+    _local_pred += stats[kPredIndex];
+  }
+}
+
+void BasicAucCalculator::reset_gpu_tables() {
+  std::lock_guard<std::mutex> lock(_table_mutex);
+  size_t numel = 2 * _table_size + kStatNum;
+  for (auto& item : _gpu_tables) {
+    ClearGpuTable(reinterpret_cast<double*>(item.second.data->ptr()),
+                  numel,
+                  GetStream(item.second.place));
+  }
+}
+
+}  // namespace framework
+}  // namespace paddle
+#endif
@@ -34,6 +34,10 @@ limitations under the License. */
 #include "paddle/fluid/platform/timer.h"
 #include "paddle/fluid/string/string_helper.h"
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/memory/memory.h"
+#endif
+
 #if defined(PADDLE_WITH_GLOO)
 #include <gloo/allreduce.h>
 
@@ -83,6 +87,16 @@ class BasicAucCalculator {
                     const int64_t* d_uid,
                     int batch_size,
                     const paddle::platform::Place& place);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // add batch data (and mask, if not null) on the gpu, binned by a kernel on
+  // the stream of the gpu into its own tables without any copy or lock, the
+  // tables of the gpus are merged into the cpu tables by compute()
+  void add_gpu_data(const float* d_pred,
+                    const int64_t* d_label,
+                    const int64_t* d_mask,
+                    int batch_size,
+                    const paddle::platform::Place& place);
+#endif
 
   void compute();
   void computeWuAuc();
@@ -129,6 +143,20 @@ class BasicAucCalculator {
   static constexpr double kRelativeErrorBound = 0.05;
   static constexpr double kMaxSpan = 0.01;
   std::mutex _table_mutex;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // the neg table, the pos table, then abserr, sqrerr, pred and the number
+  // of the invalid instances, in doubles
+  struct GpuTable {
+    paddle::platform::Place place;
+    memory::AllocationPtr data;
+  };
+  double* get_gpu_table(const paddle::platform::Place& place);
+  // adds the tables of the gpus to the cpu tables, and clears them
+  void merge_gpu_tables();
+  void reset_gpu_tables();
+  // device id -> tables, guarded by _table_mutex
+  std::map<int, GpuTable> _gpu_tables;
+#endif
 };
 
 class Metric {
@@ -48,6 +48,7 @@ PHI_DECLARE_int32(gpugraph_dedup_pull_push_mode);
 PHI_DECLARE_int32(gpugraph_storage_mode);
 PHI_DECLARE_bool(query_dest_rank_by_multi_node);
 PHI_DECLARE_string(graph_edges_split_mode);
+PHI_DECLARE_bool(gpups_prefetch_ssd_keys);
 
 namespace paddle {
 namespace framework {
@@ -764,8 +765,36 @@ void PSGPUWrapper::add_slot_feature(std::shared_ptr<HeterContext> gpu_task) {
 #endif
 }
 
+void PSGPUWrapper::PrefetchSparseKeys(
+    std::shared_ptr<HeterContext> gpu_task) {
+#ifdef PADDLE_WITH_PSCORE
+  // one task per shard, PullSparsePtr of a shard does not run concurrently
+  // with its prefetch because BuildPull waits for all of them first
+  HeterContext* task = gpu_task.get();
+  for (int i = 0; i < thread_keys_shard_num_; i++) {
+    task->prefetch_futures_.push_back(
+        std::async(std::launch::async, [this, task, i] {
+          if (multi_mf_dim_) {
+            for (int j = 0; j < multi_mf_dim_; j++) {
+              auto& keys = task->feature_dim_keys_[i][j];
+              fleet_ptr_->worker_ptr_
+                  ->PrefetchSparse(i, table_id_, keys.data(), keys.size())
+                  .wait();
+            }
+          } else {
+            auto& keys = task->feature_keys_[i];
+            fleet_ptr_->worker_ptr_
+                ->PrefetchSparse(i, table_id_, keys.data(), keys.size())
+                .wait();
+          }
+        }));
+  }
+#endif
+}
+
 void PSGPUWrapper::BuildPull(std::shared_ptr<HeterContext> gpu_task) {
   platform::Timer timeline;
+  gpu_task->WaitPrefetch();
 #if defined(PADDLE_WITH_PSCORE) && defined(PADDLE_WITH_GPU_GRAPH)
   if ((slot_num_for_pull_feature_ > 0 || float_slot_num_ > 0) &&
       FLAGS_gpugraph_storage_mode !=
@@ -2004,6 +2033,9 @@ void PSGPUWrapper::AddSparseKeys() {
   VLOG(1) << "passid=" << gpu_task->pass_id_
           << ", thread PreBuildTask end, cost time: " << timer.ElapsedSec()
           << " s";
+  if (FLAGS_gpups_prefetch_ssd_keys) {
+    PrefetchSparseKeys(gpu_task);
+  }
   buildcpu_ready_channel_->Put(gpu_task);
 }
 
@@ -2366,36 +2398,12 @@ void PSGPUWrapper::PullSparse(const paddle::platform::Place& place,
       uint64_t* total_keys = dev.keys_tensor.mutable_data<uint64_t>(
           (total_length * 3) * sizeof(uint64_t), place);
 
-      int* gpu_slot_dims = dev.dims_tensor.mutable_data<int>(
-          slot_dim.size() * sizeof(int), place);
-      uint64_t** gpu_keys = dev.keys_ptr_tensor.mutable_data<uint64_t*>(
-          keys.size() * sizeof(uint64_t*), place);
-
-      int64_t* slot_lens = dev.slot_lens.mutable_data<int64_t>(
-          (slot_num + 1) * sizeof(int64_t), place);
-      cudaMemcpyAsync(gpu_keys,
-                      keys.data(),
-                      keys.size() * sizeof(uint64_t*),
-                      cudaMemcpyHostToDevice,
-                      stream);
-      cudaMemcpyAsync(slot_lens,
-                      slot_lengths_lod.data(),
-                      slot_lengths_lod.size() * sizeof(int64_t),
-                      cudaMemcpyHostToDevice,
-                      stream);
-
-      cudaMemcpyAsync(gpu_slot_dims,
-                      slot_dim.data(),
-                      slot_dim.size() * sizeof(int),
-                      cudaMemcpyHostToDevice,
-                      stream);
-      float** gpu_values = dev.values_ptr_tensor.mutable_data<float*>(
-          values.size() * sizeof(float*), place);
-      cudaMemcpyAsync(gpu_values,
-                      values.data(),
-                      values.size() * sizeof(float*),
-                      cudaMemcpyHostToDevice,
-                      stream);
+      this->CopySlotMetaToDevice(
+          place, stream, keys, values, slot_lengths_lod, slot_dim, &dev);
+      uint64_t** gpu_keys = dev.d_keys_ptr;
+      float** gpu_values = dev.d_values_ptr;
+      int64_t* slot_lens = dev.d_slot_lens;
+      int* gpu_slot_dims = dev.d_slot_dims;
 
       int* key2slot = dev.keys2slot.mutable_data<int>(
           (total_length * 5) * sizeof(int), place);
@@ -2670,7 +2678,7 @@ void PSGPUWrapper::PushSparseGrad(const paddle::platform::Place& place,
                         platform::DeviceContextPool::Instance().Get(place))
                         ->stream();
       uint64_t* total_keys = dev.keys_tensor.data<uint64_t>();
-      int* slot_dims = dev.dims_tensor.data<int>();
+      int* slot_dims = dev.d_slot_dims;
       int slot_num = static_cast<int>(slot_lengths.size());
       if (!dev.d_slot_vector.IsInitialized()) {
         int* buf_slot_vector =
@@ -2682,15 +2690,11 @@ void PSGPUWrapper::PushSparseGrad(const paddle::platform::Place& place,
                         stream);
       }
 
-      const int64_t* slot_lens = dev.slot_lens.data<int64_t>();
+      const int64_t* slot_lens = dev.d_slot_lens;
       const int* d_slot_vector = dev.d_slot_vector.data<int>();
       const int* key2slot = dev.keys2slot.data<int>();
-      float** gpu_values = dev.values_ptr_tensor.data<float*>();
-      cudaMemcpyAsync(gpu_values,
-                      grad_values.data(),
-                      grad_values.size() * sizeof(float*),
-                      cudaMemcpyHostToDevice,
-                      stream);
+      float** gpu_values = dev.d_values_ptr;
+      this->CopyPushValuesToDevice(stream, grad_values, &dev);
 
       uint64_t* d_merged_keys = &total_keys[total_length];
 
@@ -14,6 +14,7 @@ limitations under the License. */
 
 #ifdef PADDLE_WITH_HETERPS
 #include <algorithm>
+#include <cstring>
 #include <ctime>
 #include <memory>
 #include <numeric>
@@ -140,6 +141,74 @@ void PSGPUWrapper::CopyKeys(const paddle::platform::Place& place,
   cudaStreamSynchronize(stream);
 }
 
+void PSGPUWrapper::CopySlotMetaToDevice(
+    const paddle::platform::Place& place,
+    cudaStream_t stream,
+    const std::vector<const uint64_t*>& keys,
+    const std::vector<float*>& values,
+    const std::vector<int64_t>& slot_lengths_lod,
+    const std::vector<int>& slot_dim,
+    PSDeviceData* dev) {
+  auto align = [](size_t bytes) { return (bytes + 7) / 8 * 8; };
+  size_t keys_bytes = keys.size() * sizeof(uint64_t*);
+  size_t values_bytes = values.size() * sizeof(float*);
+  size_t lens_bytes = slot_lengths_lod.size() * sizeof(int64_t);
+  size_t dims_bytes = slot_dim.size() * sizeof(int);
+  size_t total_bytes = align(keys_bytes) + align(values_bytes) +
+                       align(lens_bytes) + dims_bytes;
+
+  // the staging buffer is reused after the last copy from it is done
+  if (dev->meta_copied == nullptr) {
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaEventCreateWithFlags(&dev->meta_copied, cudaEventDisableTiming));
+  } else {
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(dev->meta_copied));
+  }
+  char* host = dev->pinned_meta.mutable_data<char>(
+      total_bytes, platform::CUDAPinnedPlace());
+  char* device = dev->meta_tensor.mutable_data<char>(total_bytes, place);
+  size_t offset = 0;
+  auto pack = [&](const void* src, size_t bytes) {
+    if (bytes > 0) {
+      std::memcpy(host + offset, src, bytes);
+    }
+    char* dst = device + offset;
+    offset += align(bytes);
+    return dst;
+  };
+  dev->d_keys_ptr = reinterpret_cast<uint64_t**>(pack(keys.data(), keys_bytes));
+  dev->values_ptr_offset = offset;
+  dev->values_ptr_num = values.size();
+  dev->d_values_ptr =
+      reinterpret_cast<float**>(pack(values.data(), values_bytes));
+  dev->d_slot_lens =
+      reinterpret_cast<int64_t*>(pack(slot_lengths_lod.data(), lens_bytes));
+  dev->d_slot_dims = reinterpret_cast<int*>(pack(slot_dim.data(), dims_bytes));
+
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(
+      device, host, total_bytes, cudaMemcpyHostToDevice, stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(dev->meta_copied, stream));
+}
+
+void PSGPUWrapper::CopyPushValuesToDevice(
+    cudaStream_t stream,
+    const std::vector<const float*>& grad_values,
+    PSDeviceData* dev) {
+  PADDLE_ENFORCE_LE(grad_values.size(),
+                    dev->values_ptr_num,
+                    platform::errors::InvalidArgument(
+                        "The push has %d slots, but the pull before has %d.",
+                        grad_values.size(),
+                        dev->values_ptr_num));
+  size_t bytes = grad_values.size() * sizeof(float*);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(dev->meta_copied));
+  char* host = dev->pinned_meta.data<char>() + dev->values_ptr_offset;
+  std::memcpy(host, grad_values.data(), bytes);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(
+      dev->d_values_ptr, host, bytes, cudaMemcpyHostToDevice, stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(dev->meta_copied, stream));
+}
+
 void PSGPUWrapper::SetSparseSGD(float nonclk_coeff,
                                 float clk_coeff,
                                 float min_bound,
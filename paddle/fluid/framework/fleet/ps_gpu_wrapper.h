@@ -69,6 +69,7 @@ limitations under the License. */
 #include "paddle/phi/core/flags.h"
 
 PHI_DECLARE_int32(gpugraph_storage_mode);
+PHI_DECLARE_bool(gpugraph_enable_inner_all2all);
 
 namespace paddle {
 namespace framework {
@@ -146,16 +147,36 @@ class PSGPUWrapper {
     std::shared_ptr<memory::Allocation> buf_ = nullptr;
   };
   struct PSDeviceData {
+#ifdef PADDLE_WITH_CUDA
+    ~PSDeviceData() {
+      if (meta_copied != nullptr) {
+        cudaEventDestroy(meta_copied);
+      }
+    }
+#endif
+
     DCacheBuffer keys_tensor;
-    DCacheBuffer dims_tensor;
-    DCacheBuffer keys_ptr_tensor;
-    DCacheBuffer values_ptr_tensor;
     DCacheBuffer pull_push_tensor;
 
-    DCacheBuffer slot_lens;
     DCacheBuffer d_slot_vector;
     DCacheBuffer keys2slot;
 
+    // The key and value pointers, the offsets and the dims of the slots of a
+    // pull are packed in the pinned staging buffer, and copied to meta_tensor
+    // by one copy, instead of one pageable copy for each of them.
+    DCacheBuffer pinned_meta;
+    DCacheBuffer meta_tensor;
+#ifdef PADDLE_WITH_CUDA
+    // recorded after the copy from pinned_meta, which is reused after it
+    cudaEvent_t meta_copied = nullptr;
+#endif
+    uint64_t** d_keys_ptr = nullptr;
+    float** d_values_ptr = nullptr;
+    int64_t* d_slot_lens = nullptr;
+    int* d_slot_dims = nullptr;
+    size_t values_ptr_offset = 0;
+    size_t values_ptr_num = 0;
+
     int64_t total_key_length = 0;
     int64_t dedup_key_length = 0;
   };
@@ -202,6 +223,22 @@ class PSGPUWrapper {
                 int slot_num,
                 int total_len,
                 int* key2slot);
+#ifdef PADDLE_WITH_CUDA
+  // Copy the key and value pointers, the offsets (slot_lengths_lod) and the
+  // dims of the slots of a pull to the device in one copy, and set the device
+  // addresses of them in dev.
+  void CopySlotMetaToDevice(const paddle::platform::Place& place,
+                            cudaStream_t stream,
+                            const std::vector<const uint64_t*>& keys,
+                            const std::vector<float*>& values,
+                            const std::vector<int64_t>& slot_lengths_lod,
+                            const std::vector<int>& slot_dim,
+                            PSDeviceData* dev);
+  // Copy the grad pointers of a push to the value pointers of the pull.
+  void CopyPushValuesToDevice(cudaStream_t stream,
+                              const std::vector<const float*>& grad_values,
+                              PSDeviceData* dev);
+#endif
 
   void divide_to_device(std::shared_ptr<HeterContext> gpu_task);
   void add_slot_feature(std::shared_ptr<HeterContext> gpu_task);
@@ -209,6 +246,9 @@ class PSGPUWrapper {
   void PreBuildTask(std::shared_ptr<HeterContext> gpu_task,
                     Dataset* dataset_for_pull);
   void BuildPull(std::shared_ptr<HeterContext> gpu_task);
+  // start to move the keys of gpu_task from ssd to memory, BuildPull waits
+  // for it
+  void PrefetchSparseKeys(std::shared_ptr<HeterContext> gpu_task);
   void PartitionKey(std::shared_ptr<HeterContext> gpu_task);
   void PrepareGPUTask(std::shared_ptr<HeterContext> gpu_task);
   void LoadIntoMemory(bool is_shuffle);
@@ -342,6 +382,12 @@ class PSGPUWrapper {
         PADDLE_THROW(
             platform::errors::Unavailable("heter ps need compile with GLOO"));
 #endif
+      } else if (FLAGS_gpugraph_enable_inner_all2all) {
+        int dev_size = dev_ids.size();
+        // init inner comm to exchange the shards by all2all
+        inner_comms_.resize(dev_size);
+        platform::dynload::ncclCommInitAll(
+            &(inner_comms_[0]), dev_size, &dev_ids[0]);
       }
 #endif
       heter_devices_ = dev_ids;
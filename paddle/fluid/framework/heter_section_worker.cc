@@ -19,10 +19,21 @@ limitations under the License. */
 #include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/lodtensor_printer.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_bool(heter_pipeline_autotune);
 
 namespace paddle {
 namespace framework {
 
+// The minibatches between two tunings of the microbatches in flight.
+constexpr int kTuneMinibatchInterval = 20;
+// The share of the time the first stage waits for the backward of the later
+// stages, above which a microbatch is added to cover their latency, and
+// below which a microbatch is removed, since fewer keep the stage busy.
+constexpr double kMaxStageWaitRatio = 0.2;
+constexpr double kMinStageWaitRatio = 0.05;
+
 void SetMicroId(paddle::framework::Scope* scope,
                 platform::DeviceContext* dev_ctx,
                 const platform::Place& place,
@@ -201,7 +212,14 @@ void HeterSectionWorker::MiniBatchBarrier() {
   VLOG(4) << "entering MiniBatchBarrier";
   VLOG(4) << "micro_ids_.size(): " << micro_ids_.size();
   while (micro_ids.size() < micro_ids_.size()) {
+    if (FLAGS_heter_pipeline_autotune) {
+      stage_timer_.Start();
+    }
     auto task = (*thread_queue_).Pop();
+    if (FLAGS_heter_pipeline_autotune) {
+      stage_timer_.Pause();
+      stage_wait_time_ += stage_timer_.ElapsedSec();
+    }
     VLOG(4) << "got one task from task que in cpu worker";
     auto message_name = task.first;
     auto micro_id = task.second;
@@ -217,7 +235,14 @@ void HeterSectionWorker::MiniBatchBarrier() {
     micro_ids.insert(micro_id);
     // backward data has been deserialized to micro scope
     // now run backward computation
+    if (FLAGS_heter_pipeline_autotune) {
+      stage_timer_.Start();
+    }
     RunBackward(micro_id);
+    if (FLAGS_heter_pipeline_autotune) {
+      stage_timer_.Pause();
+      stage_backward_time_ += stage_timer_.ElapsedSec();
+    }
     batch_num_++;
     BatchPostProcess();
     VLOG(0) << "one task in cpu worker overed!";
@@ -225,6 +250,30 @@ void HeterSectionWorker::MiniBatchBarrier() {
   micro_ids_.clear();
 }
 
+void HeterSectionWorker::TuneMicrobatchNum() {
+  if (++tuned_minibatch_num_ < kTuneMinibatchInterval) {
+    return;
+  }
+  double total_time =
+      stage_forward_time_ + stage_backward_time_ + stage_wait_time_;
+  double wait_ratio = total_time > 0 ? stage_wait_time_ / total_time : 0.0;
+  VLOG(1) << "worker " << thread_id_ << ": the mean time of a minibatch of "
+          << active_microbatches_ << " microbatches, forward "
+          << stage_forward_time_ / tuned_minibatch_num_ << "s, backward "
+          << stage_backward_time_ / tuned_minibatch_num_ << "s, waiting "
+          << stage_wait_time_ / tuned_minibatch_num_ << "s";
+  if (wait_ratio > kMaxStageWaitRatio &&
+      active_microbatches_ < num_microbatches_) {
+    ++active_microbatches_;
+  } else if (wait_ratio < kMinStageWaitRatio && active_microbatches_ > 1) {
+    --active_microbatches_;
+  }
+  tuned_minibatch_num_ = 0;
+  stage_forward_time_ = 0.0;
+  stage_backward_time_ = 0.0;
+  stage_wait_time_ = 0.0;
+}
+
 void HeterSectionWorker::RunListen() {
   VLOG(4) << ">>> run listen_op";
   listen_op_->Run(*root_scope_, place_);
@@ -380,9 +429,15 @@ void HeterSectionWorker::Run() {
   bool is_first_stage = (pipeline_stage_ == 0);
   bool is_last_stage = (pipeline_stage_ + 1 == num_pipeline_stages_);
   if (is_first_stage) {  // for cpu trainer
+    if (active_microbatches_ <= 0 || !FLAGS_heter_pipeline_autotune) {
+      active_microbatches_ = num_microbatches_;
+    }
     while (!epoch_finish_) {
       // forward
-      for (int i = 0; i < num_microbatches_; i++) {
+      if (FLAGS_heter_pipeline_autotune) {
+        stage_timer_.Start();
+      }
+      for (int i = 0; i < active_microbatches_; i++) {
         VLOG(4) << "Run " << i << " microbatch";
         RunForward(i);
         if (epoch_finish_ == true) {
@@ -390,10 +445,17 @@ void HeterSectionWorker::Run() {
         }
         micro_ids_.push_back(i);
       }
+      if (FLAGS_heter_pipeline_autotune) {
+        stage_timer_.Pause();
+        stage_forward_time_ += stage_timer_.ElapsedSec();
+      }
       // backward
       if (!micro_ids_.empty()) {
         MiniBatchBarrier();
       }
+      if (FLAGS_heter_pipeline_autotune) {
+        TuneMicrobatchNum();
+      }
       VLOG(0) << "one batch run over! micro_ids_size: " << micro_ids_.size();
     }
   } else {  // for heter worker
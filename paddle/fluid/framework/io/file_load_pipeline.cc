@@ -0,0 +1,221 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/io/file_load_pipeline.h"
+
+#include <zlib.h>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/io/fs.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/fluid/platform/timer.h"
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+constexpr size_t kReadChunkSize = 4 * 1024 * 1024;
+
+bool NeedGunzip(const std::string& path) {
+  // the customized download command of hdfs never decompresses the files
+  if (fs_select_internal(path) == 1 && !download_cmd().empty()) {
+    return false;
+  }
+  return path.size() >= 3 && path.compare(path.size() - 3, 3, ".gz") == 0;
+}
+
+std::shared_ptr<std::string> ReadRaw(const std::string& path) {
+  auto data = std::make_shared<std::string>();
+  int err_no = 0;
+  {
+    std::shared_ptr<FILE> fp = fs_open_read_raw(path, &err_no);
+    PADDLE_ENFORCE_NOT_NULL(
+        fp.get(), platform::errors::Unavailable("Failed to open %s.", path));
+    size_t size = 0;
+    do {
+      data->resize(size + kReadChunkSize);
+      size += fread(&(*data)[size], 1, kReadChunkSize, fp.get());
+    } while (size == data->size());
+    data->resize(size);
+  }
+  // the err_no of a pipe is set when it is closed
+  PADDLE_ENFORCE_EQ(err_no,
+                    0,
+                    platform::errors::Unavailable(
+                        "Failed to read %s, err_no %d.", path, err_no));
+  return data;
+}
+
+std::shared_ptr<std::string> Gunzip(const std::string& src) {
+  auto data = std::make_shared<std::string>();
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  // 32 detects the gzip or zlib header automatically
+  PADDLE_ENFORCE_EQ(
+      inflateInit2(&zs, 15 + 32),
+      Z_OK,
+      platform::errors::External("Failed to initialize zlib inflate."));
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(src.data()));
+  zs.avail_in = static_cast<uInt>(src.size());
+  data->resize(src.size() * 4 + kReadChunkSize);
+  size_t size = 0;
+  int ret = Z_OK;
+  while (true) {
+    if (size == data->size()) {
+      data->resize(data->size() * 2);
+    }
+    zs.next_out = reinterpret_cast<Bytef*>(&(*data)[size]);
+    zs.avail_out = static_cast<uInt>(data->size() - size);
+    ret = inflate(&zs, Z_NO_FLUSH);
+    size = data->size() - zs.avail_out;
+    if (ret == Z_STREAM_END) {
+      // a gzip file may be a concatenation of several members
+      if (zs.avail_in == 0 || inflateReset(&zs) != Z_OK) {
+        break;
+      }
+    } else if (ret != Z_OK) {
+      break;
+    }
+  }
+  inflateEnd(&zs);
+  PADDLE_ENFORCE_EQ(
+      ret,
+      Z_STREAM_END,
+      platform::errors::InvalidArgument(
+          "Failed to decompress the gzip data, zlib error %d.", ret));
+  data->resize(size);
+  return data;
+}
+
+}  // namespace
+
+FileLoadPipeline::FileLoadPipeline(const std::vector<std::string>& filelist,
+                                   int read_thread_num,
+                                   int decompress_thread_num,
+                                   size_t capacity)
+    : filelist_(filelist) {
+  PADDLE_ENFORCE_EQ(
+      read_thread_num > 0 && decompress_thread_num > 0 && capacity > 0,
+      true,
+      platform::errors::InvalidArgument(
+          "The thread numbers and the capacity of FileLoadPipeline should be "
+          "positive, but received %d read threads, %d decompress threads and "
+          "capacity %d.",
+          read_thread_num,
+          decompress_thread_num,
+          capacity));
+  read_channel_ = MakeChannel<LoadedFile>(capacity);
+  output_channel_ = MakeChannel<LoadedFile>(capacity);
+  running_read_threads_ = read_thread_num;
+  running_decompress_threads_ = decompress_thread_num;
+  for (int i = 0; i < read_thread_num; ++i) {
+    read_threads_.emplace_back(&FileLoadPipeline::ReadFiles, this);
+  }
+  for (int i = 0; i < decompress_thread_num; ++i) {
+    decompress_threads_.emplace_back(&FileLoadPipeline::DecompressFiles, this);
+  }
+}
+
+FileLoadPipeline::~FileLoadPipeline() { Stop(); }
+
+void FileLoadPipeline::ReadFiles() {
+  while (true) {
+    size_t idx = next_file_++;
+    if (idx >= filelist_.size()) {
+      break;
+    }
+    LoadedFile file;
+    file.filename = filelist_[idx];
+    platform::Timer timeline;
+    timeline.Start();
+    try {
+      file.data = ReadRaw(file.filename);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "FileLoadPipeline failed to read " << file.filename
+                   << ", it is left to the data feed: " << e.what();
+    }
+    timeline.Pause();
+    VLOG(3) << "FileLoadPipeline read " << file.filename << ", size="
+            << (file.data ? file.data->size() : 0)
+            << ", cost time=" << timeline.ElapsedSec() << " seconds";
+    if (!read_channel_->Put(std::move(file))) {
+      break;
+    }
+  }
+  if (--running_read_threads_ == 0) {
+    read_channel_->Close();
+  }
+}
+
+void FileLoadPipeline::DecompressFiles() {
+  LoadedFile file;
+  while (read_channel_->Get(file)) {
+    if (file.data != nullptr && NeedGunzip(file.filename)) {
+      try {
+        file.data = Gunzip(*file.data);
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "FileLoadPipeline failed to decompress "
+                     << file.filename
+                     << ", it is left to the data feed: " << e.what();
+        file.data = nullptr;
+      }
+    }
+    if (!output_channel_->Put(std::move(file))) {
+      break;
+    }
+  }
+  if (--running_decompress_threads_ == 0) {
+    output_channel_->Close();
+  }
+}
+
+bool FileLoadPipeline::Pop(LoadedFile* file) {
+  return output_channel_->Get(*file);
+}
+
+void FileLoadPipeline::Stop() {
+  read_channel_->Close();
+  output_channel_->Close();
+  read_channel_->Clear();
+  for (auto& t : read_threads_) {
+    t.join();
+  }
+  for (auto& t : decompress_threads_) {
+    t.join();
+  }
+  read_threads_.clear();
+  decompress_threads_.clear();
+  output_channel_->Clear();
+}
+
+std::shared_ptr<FILE> FileLoadPipeline::OpenMemory(
+    const std::shared_ptr<std::string>& data) {
+#ifdef _LINUX
+  // fmemopen refuses an empty buffer
+  FILE* fp = data->empty()
+                 ? fopen("/dev/null", "r")
+                 : fmemopen(const_cast<char*>(data->data()), data->size(), "r");
+  PADDLE_ENFORCE_NOT_NULL(
+      fp,
+      platform::errors::Unavailable("Failed to open the memory of a file."));
+  return {fp, [data](FILE* fp) { fclose(fp); }};
+#else
+  PADDLE_THROW(platform::errors::Unimplemented(
+      "FileLoadPipeline is only supported on Linux."));
+#endif
+}
+
+}  // namespace framework
+}  // namespace paddle
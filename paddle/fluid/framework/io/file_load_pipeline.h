@@ -0,0 +1,76 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdio.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "paddle/fluid/framework/channel.h"
+
+namespace paddle {
+namespace framework {
+
+// FileLoadPipeline prefetches the files of a dataset for the parsing
+// threads of the data feeds in two stages:
+//   read:       read_thread_num threads read the stored bytes of the files
+//   decompress: decompress_thread_num threads gunzip them by zlib in memory
+// The stages are connected by bounded channels, so that at most capacity
+// files are held by each stage and a slow parser throttles the reads.
+//
+// A file failed in the pipeline is handed out without data, and is opened
+// by the parser through fs_open_read as before.
+class FileLoadPipeline {
+ public:
+  struct LoadedFile {
+    std::string filename;
+    std::shared_ptr<std::string> data;
+  };
+
+  FileLoadPipeline(const std::vector<std::string>& filelist,
+                   int read_thread_num,
+                   int decompress_thread_num,
+                   size_t capacity);
+  ~FileLoadPipeline();
+
+  // get the next loaded file, return false when all files are taken
+  bool Pop(LoadedFile* file);
+  // stop the stages, the files not taken are dropped
+  void Stop();
+
+  // open the data of a loaded file as a read only FILE
+  static std::shared_ptr<FILE> OpenMemory(
+      const std::shared_ptr<std::string>& data);
+
+ private:
+  void ReadFiles();
+  void DecompressFiles();
+
+  std::vector<std::string> filelist_;
+  std::atomic<size_t> next_file_{0};
+  std::atomic<int> running_read_threads_{0};
+  std::atomic<int> running_decompress_threads_{0};
+  Channel<LoadedFile> read_channel_;
+  Channel<LoadedFile> output_channel_;
+  std::vector<std::thread> read_threads_;
+  std::vector<std::thread> decompress_threads_;
+};
+
+}  // namespace framework
+}  // namespace paddle
@@ -427,6 +427,32 @@ std::shared_ptr<FILE> fs_open_read(const std::string& path,
   return {};
 }
 
+std::shared_ptr<FILE> fs_open_read_raw(const std::string& path,
+                                       int* err_no) {
+  switch (fs_select_internal(path)) {
+    case 0:
+      return fs_open_internal(path, false, "r", localfs_buffer_size());
+
+    case 1: {
+      std::string cmd =
+          download_cmd().empty()
+              ? string::format_string("%s -cat \"%s\"",
+                                      dataset_hdfs_command().c_str(),
+                                      path.c_str())
+              : string::format_string(
+                    "%s \"%s\"", download_cmd().c_str(), path.c_str());
+      return fs_open_internal(cmd, true, "r", hdfs_buffer_size(), err_no);
+    }
+
+    default:
+      PADDLE_THROW(platform::errors::Unimplemented(
+          "Unsupport file system. Now only supports local file system and "
+          "HDFS."));
+  }
+
+  return {};
+}
+
 std::shared_ptr<FILE> fs_open_write(const std::string& path,
                                     int* err_no,
                                     const std::string& converter) {
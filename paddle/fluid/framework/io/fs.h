@@ -99,6 +99,10 @@ extern std::shared_ptr<FILE> fs_open_read(const std::string& path,
                                           const std::string& converter,
                                           bool read_data = false);
 
+// open the file as it is stored, without zcat or hadoop -text
+extern std::shared_ptr<FILE> fs_open_read_raw(const std::string& path,
+                                              int* err_no);
+
 extern std::shared_ptr<FILE> fs_open_write(const std::string& path,
                                            int* err_no,
                                            const std::string& converter);
@@ -0,0 +1,431 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/io/slot_binary_file.h"
+
+#include <zlib.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/io/fs.h"
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+inline size_t Align8(size_t bytes) { return (bytes + 7) & ~size_t(7); }
+
+inline int IdColumnNum(uint32_t flags) {
+  return ((flags & SlotBinaryFile::kWithInsId) ? 1 : 0) +
+         ((flags & SlotBinaryFile::kWithLogKey) ? 1 : 0);
+}
+
+inline size_t SlotWidth(char type) {
+  return type == 'u' ? sizeof(uint64_t) : sizeof(float);
+}
+
+}  // namespace
+
+SlotBinaryWriter::SlotBinaryWriter(std::shared_ptr<FILE> fp,
+                                   const SlotBinaryFile::Header& header,
+                                   int block_ins_num)
+    : fp_(fp), header_(header), block_ins_num_(block_ins_num) {
+  PADDLE_ENFORCE_NOT_NULL(
+      fp_.get(),
+      platform::errors::InvalidArgument("The output file is not opened."));
+  PADDLE_ENFORCE_GT(block_ins_num_,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The number of instances in a block should be "
+                        "positive, but received %d.",
+                        block_ins_num_));
+  PADDLE_ENFORCE_EQ(header_.slot_names.size(),
+                    header_.slot_types.size(),
+                    platform::errors::InvalidArgument(
+                        "Every slot should have a type, but received %d slot "
+                        "names and %d slot types.",
+                        header_.slot_names.size(),
+                        header_.slot_types.size()));
+  for (char type : header_.slot_types) {
+    PADDLE_ENFORCE_EQ(
+        type == 'u' || type == 'f',
+        true,
+        platform::errors::InvalidArgument(
+            "The type of a slot should be 'u' or 'f', but received '%c'.",
+            type));
+  }
+  id_column_num_ = IdColumnNum(header_.flags);
+  columns_.resize(id_column_num_ + header_.slot_names.size());
+  for (auto& column : columns_) {
+    column.offsets.push_back(0);
+  }
+
+  uint32_t slot_num = static_cast<uint32_t>(header_.slot_names.size());
+  Write(&SlotBinaryFile::kMagic, sizeof(uint64_t));
+  Write(&SlotBinaryFile::kVersion, sizeof(uint32_t));
+  Write(&header_.flags, sizeof(uint32_t));
+  Write(&slot_num, sizeof(uint32_t));
+  for (uint32_t i = 0; i < slot_num; ++i) {
+    uint8_t type = static_cast<uint8_t>(header_.slot_types[i]);
+    uint32_t len = static_cast<uint32_t>(header_.slot_names[i].size());
+    Write(&type, sizeof(uint8_t));
+    Write(&len, sizeof(uint32_t));
+    Write(header_.slot_names[i].data(), len);
+  }
+}
+
+SlotBinaryWriter::~SlotBinaryWriter() {
+  if (!closed_) {
+    LOG(WARNING) << "SlotBinaryWriter is destroyed without Close, the last "
+                 << block_ins_ << " instances are dropped";
+  }
+}
+
+void SlotBinaryWriter::AddValues(Column* column,
+                                 const void* values,
+                                 size_t bytes) {
+  PADDLE_ENFORCE_EQ(column->offsets.size(),
+                    static_cast<size_t>(block_ins_ + 1),
+                    platform::errors::PreconditionNotMet(
+                        "A column is added twice in an instance."));
+  column->values.append(reinterpret_cast<const char*>(values), bytes);
+}
+
+void SlotBinaryWriter::AddInsId(const char* str, size_t len) {
+  PADDLE_ENFORCE_NE(header_.flags & SlotBinaryFile::kWithInsId,
+                    0,
+                    platform::errors::PreconditionNotMet(
+                        "The header of the file is without ins_id."));
+  auto& column = columns_[0];
+  AddValues(&column, str, len);
+  column.offsets.push_back(column.offsets.back() +
+                           static_cast<uint32_t>(len));
+}
+
+void SlotBinaryWriter::AddLogKey(const char* str, size_t len) {
+  PADDLE_ENFORCE_NE(header_.flags & SlotBinaryFile::kWithLogKey,
+                    0,
+                    platform::errors::PreconditionNotMet(
+                        "The header of the file is without logkey."));
+  auto& column = columns_[id_column_num_ - 1];
+  AddValues(&column, str, len);
+  column.offsets.push_back(column.offsets.back() +
+                           static_cast<uint32_t>(len));
+}
+
+void SlotBinaryWriter::AddUint64Feasigns(int slot,
+                                         const uint64_t* values,
+                                         size_t num) {
+  PADDLE_ENFORCE_EQ(header_.slot_types[slot],
+                    'u',
+                    platform::errors::InvalidArgument(
+                        "The slot %s is not a uint64 slot.",
+                        header_.slot_names[slot]));
+  auto& column = columns_[id_column_num_ + slot];
+  AddValues(&column, values, num * sizeof(uint64_t));
+  column.offsets.push_back(column.offsets.back() +
+                           static_cast<uint32_t>(num));
+}
+
+void SlotBinaryWriter::AddFloatFeasigns(int slot,
+                                        const float* values,
+                                        size_t num) {
+  PADDLE_ENFORCE_EQ(header_.slot_types[slot],
+                    'f',
+                    platform::errors::InvalidArgument(
+                        "The slot %s is not a float slot.",
+                        header_.slot_names[slot]));
+  auto& column = columns_[id_column_num_ + slot];
+  AddValues(&column, values, num * sizeof(float));
+  column.offsets.push_back(column.offsets.back() +
+                           static_cast<uint32_t>(num));
+}
+
+void SlotBinaryWriter::FinishInstance() {
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    PADDLE_ENFORCE_EQ(columns_[i].offsets.size(),
+                      static_cast<size_t>(block_ins_ + 2),
+                      platform::errors::PreconditionNotMet(
+                          "The column %d is not added in the instance %d.",
+                          i,
+                          total_ins_num_));
+  }
+  ++block_ins_;
+  ++total_ins_num_;
+  if (block_ins_ >= block_ins_num_) {
+    FlushBlock();
+  }
+}
+
+void SlotBinaryWriter::FlushBlock() {
+  if (block_ins_ == 0) {
+    return;
+  }
+  raw_buf_.clear();
+  for (auto& column : columns_) {
+    raw_buf_.append(reinterpret_cast<const char*>(column.offsets.data()),
+                    column.offsets.size() * sizeof(uint32_t));
+    raw_buf_.resize(Align8(raw_buf_.size()), 0);
+    raw_buf_.append(column.values);
+    raw_buf_.resize(Align8(raw_buf_.size()), 0);
+    column.offsets.resize(1);
+    column.values.clear();
+  }
+  uLongf packed_bytes = compressBound(raw_buf_.size());
+  packed_buf_.resize(packed_bytes);
+  int ret = compress2(reinterpret_cast<Bytef*>(&packed_buf_[0]),
+                      &packed_bytes,
+                      reinterpret_cast<const Bytef*>(raw_buf_.data()),
+                      raw_buf_.size(),
+                      Z_BEST_SPEED);
+  PADDLE_ENFORCE_EQ(
+      ret,
+      Z_OK,
+      platform::errors::External("Failed to compress a block, zlib error %d.",
+                                 ret));
+
+  block_index_.emplace_back(file_offset_, block_ins_);
+  uint32_t block_header[3] = {static_cast<uint32_t>(block_ins_),
+                              static_cast<uint32_t>(raw_buf_.size()),
+                              static_cast<uint32_t>(packed_bytes)};
+  Write(block_header, sizeof(block_header));
+  Write(packed_buf_.data(), packed_bytes);
+  block_ins_ = 0;
+}
+
+void SlotBinaryWriter::Close() {
+  if (closed_) {
+    return;
+  }
+  FlushBlock();
+  uint64_t index_offset = file_offset_;
+  uint32_t index_header[2] = {0, static_cast<uint32_t>(block_index_.size())};
+  Write(index_header, sizeof(index_header));
+  for (auto& block : block_index_) {
+    Write(&block.first, sizeof(uint64_t));
+    Write(&block.second, sizeof(uint32_t));
+  }
+  Write(&index_offset, sizeof(uint64_t));
+  Write(&SlotBinaryFile::kMagic, sizeof(uint64_t));
+  fflush(fp_.get());
+  closed_ = true;
+}
+
+void SlotBinaryWriter::Write(const void* data, size_t bytes) {
+  PADDLE_ENFORCE_EQ(
+      fwrite(data, 1, bytes, fp_.get()),
+      bytes,
+      platform::errors::Unavailable("Failed to write the slot binary file."));
+  file_offset_ += bytes;
+}
+
+SlotBinaryReader::SlotBinaryReader(FILE* fp) : fp_(fp) {
+  PADDLE_ENFORCE_NOT_NULL(
+      fp_, platform::errors::InvalidArgument("The input file is not opened."));
+  uint64_t magic = 0;
+  uint32_t version = 0;
+  uint32_t slot_num = 0;
+  Read(&magic, sizeof(uint64_t));
+  PADDLE_ENFORCE_EQ(magic,
+                    SlotBinaryFile::kMagic,
+                    platform::errors::InvalidArgument(
+                        "The input file is not a slot binary file."));
+  Read(&version, sizeof(uint32_t));
+  PADDLE_ENFORCE_EQ(version,
+                    SlotBinaryFile::kVersion,
+                    platform::errors::Unimplemented(
+                        "The version %d of the slot binary file is not "
+                        "supported, the supported version is %d.",
+                        version,
+                        SlotBinaryFile::kVersion));
+  Read(&header_.flags, sizeof(uint32_t));
+  Read(&slot_num, sizeof(uint32_t));
+  header_.slot_names.resize(slot_num);
+  header_.slot_types.resize(slot_num);
+  for (uint32_t i = 0; i < slot_num; ++i) {
+    uint8_t type = 0;
+    uint32_t len = 0;
+    Read(&type, sizeof(uint8_t));
+    Read(&len, sizeof(uint32_t));
+    header_.slot_types[i] = static_cast<char>(type);
+    header_.slot_names[i].resize(len);
+    Read(&header_.slot_names[i][0], len);
+  }
+  id_column_num_ = IdColumnNum(header_.flags);
+  columns_.resize(id_column_num_ + slot_num);
+}
+
+bool SlotBinaryReader::NextBlock() {
+  uint32_t block_ins = 0;
+  Read(&block_ins, sizeof(uint32_t));
+  if (block_ins == 0) {
+    // the block index, which is only checked for the integrity of the file
+    uint32_t block_num = 0;
+    uint64_t index_offset = 0;
+    uint64_t magic = 0;
+    Read(&block_num, sizeof(uint32_t));
+    size_t indexed_ins_num = 0;
+    for (uint32_t i = 0; i < block_num; ++i) {
+      uint64_t offset = 0;
+      uint32_t num = 0;
+      Read(&offset, sizeof(uint64_t));
+      Read(&num, sizeof(uint32_t));
+      indexed_ins_num += num;
+    }
+    Read(&index_offset, sizeof(uint64_t));
+    Read(&magic, sizeof(uint64_t));
+    PADDLE_ENFORCE_EQ(
+        magic == SlotBinaryFile::kMagic && indexed_ins_num == total_ins_num_,
+        true,
+        platform::errors::InvalidArgument(
+            "The block index of the slot binary file is broken."));
+    ins_num_ = 0;
+    return false;
+  }
+
+  uint32_t sizes[2] = {0, 0};
+  Read(sizes, sizeof(sizes));
+  packed_buf_.resize(sizes[1]);
+  Read(&packed_buf_[0], sizes[1]);
+  raw_buf_.resize(Align8(sizes[0]) / sizeof(uint64_t));
+  uLongf raw_bytes = sizes[0];
+  int ret = uncompress(reinterpret_cast<Bytef*>(raw_buf_.data()),
+                       &raw_bytes,
+                       reinterpret_cast<const Bytef*>(packed_buf_.data()),
+                       sizes[1]);
+  PADDLE_ENFORCE_EQ(
+      ret == Z_OK && raw_bytes == sizes[0],
+      true,
+      platform::errors::InvalidArgument(
+          "Failed to decompress a block of %d instances, zlib error %d.",
+          block_ins,
+          ret));
+
+  const char* body = reinterpret_cast<const char*>(raw_buf_.data());
+  size_t pos = 0;
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    size_t width = static_cast<int>(i) < id_column_num_
+                       ? 1
+                       : SlotWidth(header_.slot_types[i - id_column_num_]);
+    auto& column = columns_[i];
+    column.offsets = reinterpret_cast<const uint32_t*>(body + pos);
+    pos += Align8((block_ins + 1) * sizeof(uint32_t));
+    PADDLE_ENFORCE_LE(pos,
+                      raw_bytes,
+                      platform::errors::InvalidArgument(
+                          "The block of the slot binary file is broken."));
+    column.values = body + pos;
+    pos += Align8(column.offsets[block_ins] * width);
+    PADDLE_ENFORCE_LE(pos,
+                      raw_bytes,
+                      platform::errors::InvalidArgument(
+                          "The block of the slot binary file is broken."));
+  }
+  ins_num_ = static_cast<int>(block_ins);
+  total_ins_num_ += block_ins;
+  return true;
+}
+
+void SlotBinaryReader::Read(void* data, size_t bytes) {
+  PADDLE_ENFORCE_EQ(fread(data, 1, bytes, fp_),
+                    bytes,
+                    platform::errors::InvalidArgument(
+                        "The slot binary file is truncated."));
+}
+
+size_t ConvertSlotTextToBinary(const std::string& src_path,
+                               const std::string& dst_path,
+                               const SlotBinaryFile::Header& header,
+                               const std::string& pipe_command,
+                               int block_ins_num) {
+  int err_no = 0;
+  std::shared_ptr<FILE> src = fs_open_read(src_path, &err_no, pipe_command);
+  PADDLE_ENFORCE_NOT_NULL(
+      src.get(),
+      platform::errors::NotFound("Failed to open the file %s.", src_path));
+  std::shared_ptr<FILE> dst = fs_open_write(dst_path, &err_no, "");
+  SlotBinaryWriter writer(dst, header, block_ins_num);
+
+  int id_num = IdColumnNum(header.flags);
+  std::vector<uint64_t> uint64_feasigns;
+  std::vector<float> float_feasigns;
+  string::LineFileReader reader;
+  size_t line_no = 0;
+  while (reader.getline(&*src)) {
+    ++line_no;
+    if (reader.length() == 0) {
+      continue;
+    }
+    char* str = reader.get();
+    char* endptr = str;
+    for (int i = 0; i < id_num; ++i) {
+      int num = static_cast<int>(strtol(str, &endptr, 10));
+      PADDLE_ENFORCE_EQ(num,
+                        1,
+                        platform::errors::InvalidArgument(
+                            "The line %d of %s should start with one ins_id "
+                            "or logkey.",
+                            line_no,
+                            src_path));
+      str = endptr + 1;
+      size_t len = strcspn(str, " ");
+      bool is_ins_id = (i == 0) && (header.flags & SlotBinaryFile::kWithInsId);
+      if (is_ins_id) {
+        writer.AddInsId(str, len);
+      } else {
+        writer.AddLogKey(str, len);
+      }
+      str += len;
+    }
+    for (size_t slot = 0; slot < header.slot_types.size(); ++slot) {
+      int num = static_cast<int>(strtol(str, &endptr, 10));
+      PADDLE_ENFORCE_GT(num,
+                        0,
+                        platform::errors::InvalidArgument(
+                            "The number of ids can not be zero, please check "
+                            "the slot %s in the line %d of %s.",
+                            header.slot_names[slot],
+                            line_no,
+                            src_path));
+      str = endptr;
+      if (header.slot_types[slot] == 'u') {
+        uint64_feasigns.resize(num);
+        for (int j = 0; j < num; ++j) {
+          uint64_feasigns[j] = static_cast<uint64_t>(strtoull(str, &str, 10));
+        }
+        writer.AddUint64Feasigns(
+            static_cast<int>(slot), uint64_feasigns.data(), num);
+      } else {
+        float_feasigns.resize(num);
+        for (int j = 0; j < num; ++j) {
+          float_feasigns[j] = strtof(str, &str);
+        }
+        writer.AddFloatFeasigns(
+            static_cast<int>(slot), float_feasigns.data(), num);
+      }
+    }
+    writer.FinishInstance();
+  }
+  writer.Close();
+  VLOG(3) << "convert " << src_path << " to " << dst_path << ", "
+          << writer.ins_num() << " instances";
+  return writer.ins_num();
+}
+
+}  // namespace framework
+}  // namespace paddle
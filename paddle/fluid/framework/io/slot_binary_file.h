@@ -0,0 +1,164 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace framework {
+
+// The columnar binary file of the slot records, which is loaded by
+// SlotRecordInMemoryDataFeed without any text parsing:
+//
+//   file   := header block* index
+//   header := magic(u64) version(u32) flags(u32) slot_num(u32)
+//             {type(u8) name_len(u32) name}*slot_num
+//   block  := ins_num(u32) raw_bytes(u32) packed_bytes(u32) zlib(body)
+//   body   := [ins_id column] [logkey column] {slot column}*slot_num
+//   column := offsets(u32 * (ins_num + 1)) values
+//   index  := 0(u32) block_num(u32) {file_offset(u64) ins_num(u32)}*block_num
+//             index_offset(u64) magic(u64)
+//
+// The values of a slot are the packed uint64 keys or floats of all the
+// instances of the block, and every column is padded to 8 bytes, so that
+// the decompressed body is read in place. A reader of a pipe stops at the
+// zero ins_num of the index, and a reader of a local file may seek to any
+// block by the index at the tail.
+class SlotBinaryFile {
+ public:
+  static constexpr uint64_t kMagic = 0x314253544f4c5350ULL;  // "PSLOTSB1"
+  static constexpr uint32_t kVersion = 1;
+  static constexpr uint32_t kWithInsId = 1;
+  static constexpr uint32_t kWithLogKey = 2;
+
+  struct Header {
+    uint32_t flags = 0;
+    std::vector<std::string> slot_names;
+    // 'u' for the uint64 slots and 'f' for the float slots
+    std::string slot_types;
+  };
+};
+
+class SlotBinaryWriter {
+ public:
+  SlotBinaryWriter(std::shared_ptr<FILE> fp,
+                   const SlotBinaryFile::Header& header,
+                   int block_ins_num);
+  ~SlotBinaryWriter();
+
+  // the ids, then every slot of the header must be added once per instance
+  void AddInsId(const char* str, size_t len);
+  void AddLogKey(const char* str, size_t len);
+  void AddUint64Feasigns(int slot, const uint64_t* values, size_t num);
+  void AddFloatFeasigns(int slot, const float* values, size_t num);
+  void FinishInstance();
+  // flush the last block and write the block index
+  void Close();
+
+  size_t ins_num() const { return total_ins_num_; }
+
+ private:
+  struct Column {
+    std::vector<uint32_t> offsets;
+    std::string values;
+  };
+  void AddValues(Column* column, const void* values, size_t bytes);
+  void FlushBlock();
+  void Write(const void* data, size_t bytes);
+
+  std::shared_ptr<FILE> fp_;
+  SlotBinaryFile::Header header_;
+  int block_ins_num_;
+  // the ins_id and logkey columns are ahead of the slot columns
+  int id_column_num_ = 0;
+  std::vector<Column> columns_;
+  int block_ins_ = 0;
+  size_t total_ins_num_ = 0;
+  uint64_t file_offset_ = 0;
+  std::vector<std::pair<uint64_t, uint32_t>> block_index_;
+  std::string raw_buf_;
+  std::string packed_buf_;
+  bool closed_ = false;
+};
+
+class SlotBinaryReader {
+ public:
+  explicit SlotBinaryReader(FILE* fp);
+
+  const SlotBinaryFile::Header& header() const { return header_; }
+
+  // decompress the next block, return false at the end of the file
+  bool NextBlock();
+
+  int ins_num() const { return ins_num_; }
+  size_t total_ins_num() const { return total_ins_num_; }
+
+  const char* ins_id(int ins, size_t* len) const {
+    return GetString(0, ins, len);
+  }
+  const char* logkey(int ins, size_t* len) const {
+    return GetString(id_column_num_ - 1, ins, len);
+  }
+  const uint64_t* uint64_feasigns(int slot, int ins, size_t* num) const {
+    return reinterpret_cast<const uint64_t*>(
+        GetValues(id_column_num_ + slot, ins, sizeof(uint64_t), num));
+  }
+  const float* float_feasigns(int slot, int ins, size_t* num) const {
+    return reinterpret_cast<const float*>(
+        GetValues(id_column_num_ + slot, ins, sizeof(float), num));
+  }
+
+ private:
+  struct Column {
+    const uint32_t* offsets;
+    const char* values;
+  };
+  const char* GetString(int column, int ins, size_t* len) const {
+    return GetValues(column, ins, 1, len);
+  }
+  const char* GetValues(int column, int ins, size_t width, size_t* num) const {
+    const Column& col = columns_[column];
+    *num = col.offsets[ins + 1] - col.offsets[ins];
+    return col.values + col.offsets[ins] * width;
+  }
+  void Read(void* data, size_t bytes);
+
+  FILE* fp_;
+  SlotBinaryFile::Header header_;
+  int id_column_num_ = 0;
+  int ins_num_ = 0;
+  size_t total_ins_num_ = 0;
+  std::string packed_buf_;
+  // uint64 words keep the columns of the body aligned
+  std::vector<uint64_t> raw_buf_;
+  std::vector<Column> columns_;
+};
+
+// Convert the MultiSlot text file of the data generator, i.e.
+// "[1 ins_id] [1 logkey] {num feasign*num}*slot_num" per line, into a
+// columnar binary file, return the number of the converted instances.
+size_t ConvertSlotTextToBinary(const std::string& src_path,
+                               const std::string& dst_path,
+                               const SlotBinaryFile::Header& header,
+                               const std::string& pipe_command,
+                               int block_ins_num);
+
+}  // namespace framework
+}  // namespace paddle
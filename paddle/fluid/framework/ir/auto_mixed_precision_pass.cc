@@ -14,6 +14,10 @@
 
 #include "paddle/fluid/framework/ir/auto_mixed_precision_pass.h"
 
+#include <algorithm>
+#include <limits>
+#include <queue>
+
 #include "paddle/common/errors.h"
 #include "paddle/fluid/framework/ir/graph_helper.h"
 #include "paddle/fluid/framework/operator.h"
@@ -107,8 +111,99 @@ inline bool IsFP16AndBFP16(VarType::Type type) {
   return (type == VarType::FP16) || (type == VarType::BF16);
 }
 
+// The minimum s-t cut of a graph of double capacities by Dinic's max flow.
+class MinCutSolver {
+ public:
+  explicit MinCutSolver(int node_num)
+      : adjacency_(node_num), level_(node_num), next_edge_(node_num) {}
+
+  void AddEdge(int from, int to, double capacity) {
+    if (capacity <= 0.) return;
+    adjacency_[from].push_back(static_cast<int>(edges_.size()));
+    edges_.push_back({to, capacity});
+    adjacency_[to].push_back(static_cast<int>(edges_.size()));
+    edges_.push_back({from, 0.});
+  }
+
+  // Returns whether each node is on the side of the source in the cut.
+  std::vector<bool> Solve(int source, int sink) {
+    while (BuildLevels(source, sink)) {
+      std::fill(next_edge_.begin(), next_edge_.end(), 0);
+      while (Augment(source, sink, std::numeric_limits<double>::max()) >
+             kEpsilon) {
+      }
+    }
+    BuildLevels(source, sink);
+    std::vector<bool> source_side(adjacency_.size());
+    for (size_t i = 0; i < adjacency_.size(); ++i) {
+      source_side[i] = level_[i] >= 0;
+    }
+    return source_side;
+  }
+
+ private:
+  struct Edge {
+    int to;
+    double capacity;
+  };
+
+  static constexpr double kEpsilon = 1e-9;
+
+  bool BuildLevels(int source, int sink) {
+    std::fill(level_.begin(), level_.end(), -1);
+    std::queue<int> queue;
+    level_[source] = 0;
+    queue.push(source);
+    while (!queue.empty()) {
+      int node = queue.front();
+      queue.pop();
+      for (int edge_id : adjacency_[node]) {
+        const Edge& edge = edges_[edge_id];
+        if (edge.capacity > kEpsilon && level_[edge.to] < 0) {
+          level_[edge.to] = level_[node] + 1;
+          queue.push(edge.to);
+        }
+      }
+    }
+    return level_[sink] >= 0;
+  }
+
+  double Augment(int node, int sink, double flow) {
+    if (node == sink) return flow;
+    for (auto& i = next_edge_[node]; i < adjacency_[node].size(); ++i) {
+      int edge_id = adjacency_[node][i];
+      Edge& edge = edges_[edge_id];
+      if (edge.capacity <= kEpsilon || level_[edge.to] != level_[node] + 1) {
+        continue;
+      }
+      double pushed = Augment(edge.to, sink, std::min(flow, edge.capacity));
+      if (pushed > kEpsilon) {
+        edge.capacity -= pushed;
+        edges_[edge_id ^ 1].capacity += pushed;
+        return pushed;
+      }
+    }
+    return 0.;
+  }
+
+  std::vector<Edge> edges_;
+  std::vector<std::vector<int>> adjacency_;
+  std::vector<int> level_;
+  std::vector<size_t> next_edge_;
+};
+
 };  // namespace
 
+std::string GetOpProfileKey(const OpDesc& op_desc,
+                            const std::string& op_type) {
+  for (const auto& name : op_desc.OutputArgumentNames()) {
+    if (name != framework::kEmptyVarName) {
+      return op_type + "/" + name;
+    }
+  }
+  return op_type;
+}
+
 void DoInsertCastOp(Graph* graph,
                     Node* var_node,
                     Node* op_node,
@@ -294,6 +389,10 @@ void AutoMixedPrecisionPass::ApplyImpl(Graph* graph) const {
   VLOG(4) << "SetOpUniqueType done";
   GetOpPrecision();
   VLOG(4) << "GetOpPrecision done";
+  if (Has("mixed_precision_op_latency")) {
+    SelectOpPrecisionByLatency();
+    VLOG(4) << "SelectOpPrecisionByLatency done";
+  }
   UpdateOpPrecision();
   VLOG(4) << "UpdateOpPrecision done";
   SetVarPrecision();
@@ -486,6 +585,112 @@ void AutoMixedPrecisionPass::GetOpPrecision() const {
   }
 }
 
+// Every op supporting the low precision is labeled low or fp32, and pays its
+// latency at the label, while every var between two ops of different labels
+// pays its cast. The total is minimized by the minimum cut between the low
+// side, the source, and the fp32 side, the sink, in which the edge of an op
+// from the source is cut at fp32 and the one to the sink at low. The cast of a
+// var consumed by several ops at the other label is counted by each of them
+// though it is inserted once, which makes the islands a little more costly.
+void AutoMixedPrecisionPass::SelectOpPrecisionByLatency() const {
+  const auto& op_latency =
+      Get<OpPrecisionLatencyMap>("mixed_precision_op_latency");
+  std::unordered_map<std::string, double> cast_latency;
+  if (Has("mixed_precision_cast_latency")) {
+    cast_latency = Get<std::unordered_map<std::string, double>>(
+        "mixed_precision_cast_latency");
+  }
+  std::unordered_set<std::string> fp32_ops;
+  if (Has("mixed_precision_fp32_ops")) {
+    fp32_ops = Get<std::unordered_set<std::string>>("mixed_precision_fp32_ops");
+  }
+
+  std::vector<Node*> op_nodes;
+  std::unordered_map<Node*, int> op_index;
+  for (const auto& nodes : all_op_nodes_) {
+    for (auto* op_node : nodes) {
+      op_index[op_node] = static_cast<int>(op_nodes.size());
+      op_nodes.push_back(op_node);
+    }
+  }
+  const int source = static_cast<int>(op_nodes.size());
+  const int sink = source + 1;
+
+  // a capacity never cut, larger than the sum of all the others
+  double infinity = 1.;
+  for (const auto& item : op_latency) {
+    infinity += item.second.fp32 + item.second.low_precision;
+  }
+  for (const auto& item : cast_latency) {
+    infinity += 2 * item.second * op_nodes.size();
+  }
+
+  MinCutSolver solver(sink + 1);
+  std::vector<bool> is_candidate(op_nodes.size(), false);
+  double fp32_latency = 0.;
+  for (size_t i = 0; i < op_nodes.size(); ++i) {
+    auto* op_desc = op_nodes[i]->Op();
+    auto op_type = GetOpOriginalType(op_desc->Type());
+    auto key = GetOpProfileKey(*op_desc, op_type);
+    if (fp32_ops.count(key)) {
+      op_run_low_precision_.erase(op_desc->Type());
+    }
+    bool run_low_precision = op_run_low_precision_.count(op_desc->Type()) > 0;
+    is_candidate[i] = run_low_precision && op_type != "feed" &&
+                      op_type != "fetch" && op_type != "tensorrt_engine";
+    if (!is_candidate[i]) {
+      solver.AddEdge(run_low_precision ? source : static_cast<int>(i),
+                     run_low_precision ? static_cast<int>(i) : sink,
+                     infinity);
+      continue;
+    }
+    auto it = op_latency.find(key);
+    if (it != op_latency.end()) {
+      solver.AddEdge(source, static_cast<int>(i), it->second.fp32);
+      solver.AddEdge(static_cast<int>(i), sink, it->second.low_precision);
+      fp32_latency += it->second.fp32;
+    }
+  }
+
+  for (auto* op_node : op_nodes) {
+    for (auto* var_node : op_node->outputs) {
+      if (!var_node->IsVar() || !VarNodeHasDtype(var_node)) continue;
+      auto* real_var_node = real_vars_.count(var_node->Var()->Name())
+                                ? real_vars_.at(var_node->Var()->Name())
+                                : var_node;
+      if (real_var_node->Var()->Persistable() ||
+          !IsFP32AndFP64(real_var_node->Var()->GetDataType())) {
+        continue;
+      }
+      auto it = cast_latency.find(var_node->Var()->Name());
+      if (it == cast_latency.end()) continue;
+      for (auto* next_op : var_node->outputs) {
+        if (op_index.count(next_op) == 0) continue;
+        solver.AddEdge(op_index[op_node], op_index[next_op], it->second);
+        solver.AddEdge(op_index[next_op], op_index[op_node], it->second);
+      }
+    }
+  }
+
+  auto low_precision_side = solver.Solve(source, sink);
+  int candidate_num = 0;
+  int low_precision_num = 0;
+  for (size_t i = 0; i < op_nodes.size(); ++i) {
+    if (!is_candidate[i]) continue;
+    ++candidate_num;
+    if (low_precision_side[i]) {
+      ++low_precision_num;
+    } else {
+      op_run_low_precision_.erase(op_nodes[i]->Op()->Type());
+      VLOG(4) << op_nodes[i]->Op()->Type()
+              << " is not faster at low precision, keep it at fp32.";
+    }
+  }
+  LOG(INFO) << "Select " << low_precision_num << " of " << candidate_num
+            << " ops supporting low precision by the latencies measured, "
+            << fp32_latency << " us of them at fp32.";
+}
+
 void AutoMixedPrecisionPass::UpdateOpPrecision() const {
   std::unordered_set<std::string> vars_should_not_low_precision;
 
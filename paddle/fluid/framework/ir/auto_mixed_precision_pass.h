@@ -27,6 +27,31 @@ namespace paddle {
 namespace framework {
 namespace ir {
 
+// The latencies in microseconds of an op measured at fp32 and at the low
+// precision on the target device.
+struct OpPrecisionLatency {
+  double fp32{0.};
+  double low_precision{0.};
+};
+
+// op profile key -> the latencies of the op
+using OpPrecisionLatencyMap =
+    std::unordered_map<std::string, OpPrecisionLatency>;
+
+// The key of an op in the latencies measured for the mixed precision, which is
+// its type and its first output, so that it identifies the op across the
+// graphs built from the same program.
+std::string GetOpProfileKey(const OpDesc& op_desc,
+                            const std::string& op_type);
+
+// AutoMixedPrecisionPass runs the ops supporting the low precision at it,
+// except the ones in the black list. If the attr
+// "mixed_precision_op_latency" is set, the latencies of the ops and of the
+// casts of the vars, "mixed_precision_cast_latency", measured on the device
+// decide which of the supporting ops run at the low precision instead: the
+// assignment of the least total latency of the ops and the casts between the
+// fp32 and low precision ones is solved by the minimum cut. The ops whose
+// keys are in "mixed_precision_fp32_ops" are kept at fp32.
 class AutoMixedPrecisionPass : public FusePassBase {
  public:
   using VarType = framework::proto::VarType;
@@ -51,6 +76,8 @@ class AutoMixedPrecisionPass : public FusePassBase {
 
   void GetOpPrecision() const;
 
+  void SelectOpPrecisionByLatency() const;
+
   void UpdateOpPrecision() const;
 
   void InsertCastOp() const;
@@ -0,0 +1,78 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/ir/fc_weight_pack_pass.h"
+
+#include <string>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/ir/graph_helper.h"
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/kernels/funcs/packed_weights_cache.h"
+
+namespace paddle {
+namespace framework {
+namespace ir {
+
+void FCWeightPackPass::ApplyImpl(ir::Graph* graph) const {
+  PADDLE_ENFORCE_NOT_NULL(
+      graph, platform::errors::PreconditionNotMet("graph should not be null."));
+  FusePassBase::Init("fc_weight_pack", graph);
+#ifdef PADDLE_WITH_MKLML
+  auto* scope = param_scope();
+  PADDLE_ENFORCE_NOT_NULL(
+      scope,
+      platform::errors::PreconditionNotMet(
+          "scope must not be null when applying fc_weight_pack_pass."));
+  auto* dev_ctx = static_cast<phi::CPUContext*>(
+      platform::DeviceContextPool::Instance().Get(platform::CPUPlace()));
+
+  int packed_num = 0;
+  for (auto* node : graph->Nodes()) {
+    if (!node->IsOp() || node->Op()->Type() != "fc") continue;
+    auto* op = node->Op();
+    // the onednn fc caches its reordered weights, and the padded weights
+    // are multiplied by the plain gemm
+    if (op->GetAttrIfExists<bool>("use_mkldnn") ||
+        op->GetAttrIfExists<bool>("padding_weights")) {
+      continue;
+    }
+    auto* w_var = scope->FindVar(op->Input("W")[0]);
+    if (w_var == nullptr || !w_var->IsType<phi::DenseTensor>()) continue;
+    const auto& w = w_var->Get<phi::DenseTensor>();
+    if (!w.initialized() || w.dims().size() != 2 ||
+        !platform::is_cpu_place(w.place())) {
+      continue;
+    }
+    if (w.dtype() == phi::DataType::FLOAT32) {
+      phi::funcs::PackedWeightsCache<float>::Instance().Pack(*dev_ctx, w);
+    } else if (w.dtype() == phi::DataType::FLOAT64) {
+      phi::funcs::PackedWeightsCache<double>::Instance().Pack(*dev_ctx, w);
+    } else {
+      continue;
+    }
+    ++packed_num;
+  }
+  AddStatis(packed_num);
+  VLOG(3) << "fc_weight_pack_pass packed " << packed_num << " weights.";
+#endif
+}
+
+}  // namespace ir
+}  // namespace framework
+}  // namespace paddle
+
+REGISTER_PASS(fc_weight_pack_pass, paddle::framework::ir::FCWeightPackPass);
@@ -0,0 +1,249 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/mmap_params.h"
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+
+#include "glog/logging.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/fluid/platform/place.h"
+#include "paddle/phi/core/utils/data_type.h"
+
+#ifndef _WIN32
+#include "paddle/fluid/memory/allocation/mmap_allocator.h"
+#endif
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+const char kMmapParamsMagic[8] = {'P', 'D', 'M', 'M', 'A', 'P', 'P', '\0'};
+const uint32_t kMmapParamsVersion = 0;
+
+struct MmapParamsEntry {
+  phi::DataType dtype;
+  std::vector<int64_t> dims;
+  uint64_t offset;
+  uint64_t size;
+};
+
+template <typename T>
+void AppendValue(std::string* buffer, const T& value) {
+  buffer->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Read the header of the file from the mapped data, with bounds checking.
+class MmapParamsReader {
+ public:
+  MmapParamsReader(const char* data, size_t size, const std::string& path)
+      : data_(data), size_(size), path_(path) {}
+
+  template <typename T>
+  T Read() {
+    T value;
+    std::memcpy(&value, Advance(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  std::string ReadString(size_t length) {
+    return std::string(Advance(length), length);
+  }
+
+ private:
+  const char* Advance(size_t length) {
+    PADDLE_ENFORCE_LE(pos_ + length,
+                      size_,
+                      platform::errors::InvalidArgument(
+                          "The params file %s is truncated.", path_));
+    const char* ptr = data_ + pos_;
+    pos_ += length;
+    return ptr;
+  }
+
+  const char* data_;
+  size_t size_;
+  size_t pos_{0};
+  const std::string& path_;
+};
+
+}  // namespace
+
+bool IsMmapParamsFile(const std::string& path) {
+  std::ifstream fin(path, std::ios::binary);
+  char magic[sizeof(kMmapParamsMagic)];
+  if (!fin.read(magic, sizeof(magic))) {
+    return false;
+  }
+  return std::memcmp(magic, kMmapParamsMagic, sizeof(magic)) == 0;
+}
+
+void SaveMmapParams(const std::string& path,
+                    const std::vector<std::string>& names,
+                    const std::vector<const phi::DenseTensor*>& tensors) {
+  PADDLE_ENFORCE_EQ(names.size(),
+                    tensors.size(),
+                    platform::errors::InvalidArgument(
+                        "The number of names (%d) and tensors (%d) to save "
+                        "should be the same.",
+                        names.size(),
+                        tensors.size()));
+  size_t header_size = sizeof(kMmapParamsMagic) + 2 * sizeof(uint32_t);
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    header_size += sizeof(uint32_t) + names[i].size() + sizeof(int32_t) +
+                   sizeof(uint32_t) + tensors[i]->dims().size() * 8 + 16;
+  }
+
+  std::string header(kMmapParamsMagic, sizeof(kMmapParamsMagic));
+  AppendValue(&header, kMmapParamsVersion);
+  AppendValue(&header, static_cast<uint32_t>(tensors.size()));
+  std::vector<uint64_t> offsets;
+  uint64_t offset = header_size;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    const phi::DenseTensor* tensor = tensors[i];
+    PADDLE_ENFORCE_EQ(
+        tensor->numel() == 0 || platform::is_cpu_place(tensor->place()),
+        true,
+        platform::errors::InvalidArgument(
+            "The tensor %s to save in the mmap format should be on CPU.",
+            names[i]));
+    offset = (offset + kMmapParamsAlignment - 1) / kMmapParamsAlignment *
+             kMmapParamsAlignment;
+    offsets.push_back(offset);
+    uint64_t size = tensor->numel() * phi::SizeOf(tensor->dtype());
+
+    AppendValue(&header, static_cast<uint32_t>(names[i].size()));
+    header.append(names[i]);
+    AppendValue(&header, static_cast<int32_t>(tensor->dtype()));
+    AppendValue(&header, static_cast<uint32_t>(tensor->dims().size()));
+    for (int j = 0; j < tensor->dims().size(); ++j) {
+      AppendValue(&header, static_cast<int64_t>(tensor->dims()[j]));
+    }
+    AppendValue(&header, offset);
+    AppendValue(&header, size);
+    offset += size;
+  }
+
+  std::ofstream fout(path, std::ios::binary);
+  PADDLE_ENFORCE_EQ(static_cast<bool>(fout),
+                    true,
+                    platform::errors::Unavailable(
+                        "Cannot open %s to save the params.", path));
+  fout.write(header.data(), header.size());
+  uint64_t pos = header.size();
+  std::vector<char> padding(kMmapParamsAlignment, 0);
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    fout.write(padding.data(), offsets[i] - pos);
+    uint64_t size = tensors[i]->numel() * phi::SizeOf(tensors[i]->dtype());
+    if (size > 0) {
+      fout.write(static_cast<const char*>(tensors[i]->data()), size);
+    }
+    pos = offsets[i] + size;
+  }
+  PADDLE_ENFORCE_EQ(static_cast<bool>(fout),
+                    true,
+                    platform::errors::Unavailable(
+                        "Failed to write the params to %s.", path));
+  VLOG(3) << "Save " << tensors.size() << " params of " << pos
+          << " bytes in the mmap format to " << path;
+}
+
+void LoadMmapParams(const std::string& path,
+                    const std::vector<std::string>& names,
+                    const std::vector<phi::DenseTensor*>& tensors) {
+#ifdef _WIN32
+  PADDLE_THROW(platform::errors::Unimplemented(
+      "Loading params of the mmap format is not supported on Windows."));
+#else
+  size_t file_size = 0;
+  auto mapping = memory::allocation::MapFileCopyOnWrite(path, &file_size);
+  char* base = static_cast<char*>(mapping.get());
+
+  MmapParamsReader reader(base, file_size, path);
+  PADDLE_ENFORCE_EQ(
+      reader.ReadString(sizeof(kMmapParamsMagic)) ==
+          std::string(kMmapParamsMagic, sizeof(kMmapParamsMagic)),
+      true,
+      platform::errors::InvalidArgument(
+          "The params file %s is not of the mmap format.", path));
+  auto version = reader.Read<uint32_t>();
+  PADDLE_ENFORCE_EQ(version,
+                    kMmapParamsVersion,
+                    platform::errors::InvalidArgument(
+                        "The version %d of the params file %s is not "
+                        "supported.",
+                        version,
+                        path));
+  auto count = reader.Read<uint32_t>();
+  std::unordered_map<std::string, MmapParamsEntry> entries;
+  for (uint32_t i = 0; i < count; ++i) {
+    std::string name = reader.ReadString(reader.Read<uint32_t>());
+    MmapParamsEntry entry;
+    entry.dtype = static_cast<phi::DataType>(reader.Read<int32_t>());
+    entry.dims.resize(reader.Read<uint32_t>());
+    for (auto& dim : entry.dims) {
+      dim = reader.Read<int64_t>();
+    }
+    entry.offset = reader.Read<uint64_t>();
+    entry.size = reader.Read<uint64_t>();
+    PADDLE_ENFORCE_LE(entry.offset + entry.size,
+                      file_size,
+                      platform::errors::InvalidArgument(
+                          "The data of param %s is out of the params file %s.",
+                          name,
+                          path));
+    entries.emplace(std::move(name), std::move(entry));
+  }
+
+  PADDLE_ENFORCE_EQ(names.size(),
+                    tensors.size(),
+                    platform::errors::InvalidArgument(
+                        "The number of names (%d) and tensors (%d) to load "
+                        "should be the same.",
+                        names.size(),
+                        tensors.size()));
+  for (size_t i = 0; i < names.size(); ++i) {
+    auto it = entries.find(names[i]);
+    PADDLE_ENFORCE_NE(it,
+                      entries.end(),
+                      platform::errors::NotFound(
+                          "The param %s is not found in the params file %s.",
+                          names[i],
+                          path));
+    const MmapParamsEntry& entry = it->second;
+    phi::DenseTensor* tensor = tensors[i];
+    tensor->Resize(common::make_ddim(entry.dims));
+    PADDLE_ENFORCE_EQ(
+        tensor->numel() * phi::SizeOf(entry.dtype),
+        entry.size,
+        platform::errors::InvalidArgument(
+            "The data size of param %s in the params file %s does not match "
+            "its shape.",
+            names[i],
+            path));
+    tensor->ResetHolderWithType(
+        std::make_shared<memory::allocation::MemoryMapFileAllocation>(
+            base + entry.offset, entry.size, mapping),
+        entry.dtype);
+  }
+  VLOG(3) << "Map " << names.size() << " params from " << path;
+#endif
+}
+
+}  // namespace framework
+}  // namespace paddle
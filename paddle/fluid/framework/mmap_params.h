@@ -0,0 +1,58 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace framework {
+
+/* The combined params file of the mmap format is mapped by the processes
+loading it instead of being deserialized, and the loaded tensors hold the
+mapped pages directly, so that all the processes serving a model share one
+physical copy of its params. The file is laid out as:
+
+  magic "PDMMAPP\0", version uint32, tensor count uint32,
+  and for every tensor:
+    name size uint32, name, dtype int32, rank uint32, dims int64 * rank,
+    data offset uint64, data size uint64,
+  followed by the data of the tensors, each at an offset aligned to
+  kMmapParamsAlignment.
+
+The pages are mapped copy-on-write, so a param rewritten in place, e.g. by a
+fuse pass, is copied only in the process rewriting it.
+*/
+constexpr size_t kMmapParamsAlignment = 4096;
+
+// Whether the file at path starts with the magic of the mmap format.
+bool IsMmapParamsFile(const std::string& path);
+
+// Save the CPU tensors to a params file of the mmap format.
+void SaveMmapParams(const std::string& path,
+                    const std::vector<std::string>& names,
+                    const std::vector<const phi::DenseTensor*>& tensors);
+
+// Bind every tensor to the mapped data of the tensor of the same name in the
+// params file of the mmap format at path.
+void LoadMmapParams(const std::string& path,
+                    const std::vector<std::string>& names,
+                    const std::vector<phi::DenseTensor*>& tensors);
+
+}  // namespace framework
+}  // namespace paddle
@@ -23,6 +23,7 @@
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/framework/variable_helper.h"
 #include "paddle/fluid/platform/denormal.h"
+#include "paddle/phi/core/flags.h"
 #ifdef PADDLE_WITH_DNNL
 #include "paddle/fluid/platform/mkldnn_helper.h"
 #endif
@@ -36,6 +37,8 @@
 #include "paddle/fluid/operators/lite/lite_engine_op.h"
 #endif
 
+PHI_DECLARE_bool(naive_executor_prepared_run);
+
 namespace paddle {
 namespace framework {
 void NaiveExecutor::Prepare(Scope *scope,
@@ -49,6 +52,22 @@ void NaiveExecutor::Prepare(Scope *scope,
 
   VLOG(3) << "NaiveExecutor init with scope " << scope;
   CreateOps(program_desc, block_id);
+
+  var_slots_.Reset(scope_);
+  for (auto &op : ops_) {
+    op->SetVarSlots(&var_slots_);
+  }
+
+  kernel_ops_.clear();
+  if (FLAGS_naive_executor_prepared_run) {
+    for (auto &op : ops_) {
+      auto *kernel_op = dynamic_cast<OperatorWithKernel *>(op.get());
+      if (kernel_op != nullptr) {
+        kernel_op->EnableCacheRuntimeContext();
+      }
+      kernel_ops_.push_back(kernel_op);
+    }
+  }
 }
 
 void NaiveExecutor::PrepareInterpreterCore(
@@ -92,7 +111,10 @@ void NaiveExecutor::Run() {
 #ifdef PADDLE_WITH_NVTX
   platform::CudaNvtxRangePush("model", platform::NvtxRangeColor::Yellow);
 #endif
-  for (auto &op : ops_) {
+  // resolved again only if the variables of the scopes changed
+  var_slots_.Resolve();
+  for (size_t op_idx = 0; op_idx < ops_.size(); ++op_idx) {
+    auto &op = ops_[op_idx];
     VLOG(4) << std::this_thread::get_id() << " run "
             << op->DebugStringEx(scope_) << " on scope " << scope_;
     op->SetIsCalledByExecutor(false);
@@ -109,7 +131,11 @@ void NaiveExecutor::Run() {
     platform::CudaNvtxRangePush(op->Type() + "|" + op->OutputVars(true).front(),
                                 platform::NvtxRangeColor::Green);
 #endif
-    op->Run(*scope_, place_);
+    // the prepared ops skip the checks of Run after their first run
+    if (kernel_ops_.empty() || kernel_ops_[op_idx] == nullptr ||
+        !kernel_ops_[op_idx]->RunPrepared(*scope_, place_)) {
+      op->Run(*scope_, place_);
+    }
 #ifdef PADDLE_WITH_NVTX
     platform::CudaNvtxRangePop();
 #endif
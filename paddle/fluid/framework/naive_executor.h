@@ -101,7 +101,12 @@ class NaiveExecutor {
   const platform::Place place_;
   // Catch the required resource to avoid recreate.
   std::vector<std::unique_ptr<OperatorBase>> ops_;
+  // kernel_ops_[i] is ops_[i] if it is an OperatorWithKernel, otherwise
+  // nullptr, only used when FLAGS_naive_executor_prepared_run is enabled
+  std::vector<OperatorWithKernel*> kernel_ops_;
   Scope* scope_{nullptr};
+  // the variables of ops_ in scope_ by the slots
+  VariableSlots var_slots_;
 
   std::vector<HookFunc> output_hookfuncs_;
   std::vector<HookFunc> input_hookfuncs_;
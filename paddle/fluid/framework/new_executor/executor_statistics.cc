@@ -14,13 +14,18 @@
 
 #include "paddle/fluid/framework/new_executor/executor_statistics.h"
 
+#include <algorithm>
 #include <fstream>
 #include <functional>
+#include <limits>
 #include <map>
 #include <ostream>
 #include <queue>
 #include <set>
+#include <sstream>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "glog/logging.h"
@@ -34,6 +39,11 @@ PADDLE_DEFINE_EXPORTED_string(static_executor_perfstat_filepath,
                               "FLAGS_static_executor_perfstat_filepath "
                               "enables performance statistics for the static "
                               "graph executor.");
+PADDLE_DEFINE_EXPORTED_string(static_executor_critical_path_filepath,
+                              "",
+                              "FLAGS_static_executor_critical_path_filepath "
+                              "enables the critical path and stream overlap "
+                              "analysis of the profiling data.");
 
 namespace paddle {
 namespace framework {
@@ -619,8 +629,490 @@ void StatisticsEngine::Log(const std::string& filepath) {
   ofs.close();
 }
 
+// The critical path of the steps, which explains the part of the step time
+// that the per-op statistics above do not: the dependencies of the recorded
+// activities are reconstructed as a DAG, where
+//   - the ops of a host thread run in order,
+//   - the activities of a device stream run in order,
+//   - a device activity follows the op that launched it,
+//   - an op calling a synchronous runtime api, e.g. cudaStreamSynchronize or
+//     cudaMemcpy, follows the last device activity ended during the call.
+// The critical path is traced back from the last ended activity by taking the
+// predecessor released last every time, and the part of the path covered by
+// no activity is the idle time waiting for the launches. It is reported with
+// the idle gaps of the streams, the overlap of the compute and the
+// communication, and the intervals the devices wait for the host.
+class CriticalPathAnalyzer {
+ public:
+  explicit CriticalPathAnalyzer(const platform::NodeTrees& trees);
+
+  std::string Report(size_t top_n) const;
+
+ private:
+  using Interval = std::pair<uint64_t, uint64_t>;
+
+  static constexpr size_t kNoOp = static_cast<size_t>(-1);
+
+  struct Activity {
+    std::string name;
+    // the op the activity belongs to, kNoOp for the activities out of ops
+    size_t op_idx;
+    bool on_device;
+    bool is_communication = false;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    // the predecessors and the time they release the activity
+    std::vector<std::pair<size_t, uint64_t>> preds;
+
+    Activity(const std::string& name,
+             size_t op,
+             bool device,
+             uint64_t start,
+             uint64_t end)
+        : name(name),
+          op_idx(op),
+          on_device(device),
+          start_ns(start),
+          end_ns(std::max(start, end)) {}
+  };
+
+  struct PathStat {
+    uint64_t host_time = 0;
+    uint64_t device_time = 0;
+    size_t count = 0;
+  };
+
+  struct StreamStat {
+    uint64_t busy_time = 0;
+    uint64_t idle_time = 0;
+    size_t num_gaps = 0;
+    uint64_t max_gap = 0;
+  };
+
+  static bool IsSynchronous(const std::string& api);
+
+  static bool IsCommunication(const platform::DeviceTraceEventNode& evt);
+
+  static std::vector<Interval> MergeIntervals(std::vector<Interval> intervals);
+
+  static std::vector<Interval> Intersect(const std::vector<Interval>& a,
+                                         const std::vector<Interval>& b);
+
+  static std::vector<Interval> Complement(const std::vector<Interval>& busy,
+                                          const Interval& window);
+
+  static uint64_t Length(const std::vector<Interval>& intervals);
+
+  void TraceCriticalPath();
+
+  void StatStreams(
+      const std::map<std::pair<uint64_t, uint64_t>, std::vector<size_t>>&
+          streams);
+
+  std::vector<Activity> activities_;
+  Interval device_window_{0, 0};
+  // the critical path
+  uint64_t path_length_ = 0;
+  uint64_t path_idle_time_ = 0;
+  std::map<std::string, PathStat> path_stats_;
+  // the streams keyed by (device id, stream id)
+  std::map<std::pair<uint64_t, uint64_t>, StreamStat> stream_stats_;
+  // compute and communication
+  uint64_t compute_time_ = 0;
+  uint64_t communication_time_ = 0;
+  uint64_t overlap_time_ = 0;
+  // the devices idle while the host runs ops
+  uint64_t launch_bound_time_ = 0;
+  size_t num_launch_bound_intervals_ = 0;
+  std::map<std::string, uint64_t> launch_bound_ops_;
+};
+
+bool CriticalPathAnalyzer::IsSynchronous(const std::string& api) {
+  if (api.find("Synchronize") != std::string::npos) {
+    return true;
+  }
+  bool memcpy = api.find("cudaMemcpy") == 0 || api.find("hipMemcpy") == 0;
+  return memcpy && api.find("Async") == std::string::npos;
+}
+
+bool CriticalPathAnalyzer::IsCommunication(
+    const platform::DeviceTraceEventNode& evt) {
+  if (evt.Type() == platform::TracerEventType::Communication) {
+    return true;
+  }
+  std::string name = evt.Name();
+  std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+  return name.find("nccl") != std::string::npos ||
+         name.find("bkcl") != std::string::npos;
+}
+
+std::vector<CriticalPathAnalyzer::Interval>
+CriticalPathAnalyzer::MergeIntervals(std::vector<Interval> intervals) {
+  std::sort(intervals.begin(), intervals.end());
+  std::vector<Interval> merged;
+  for (const auto& interval : intervals) {
+    if (!merged.empty() && interval.first <= merged.back().second) {
+      merged.back().second = std::max(merged.back().second, interval.second);
+    } else {
+      merged.push_back(interval);
+    }
+  }
+  return merged;
+}
+
+std::vector<CriticalPathAnalyzer::Interval> CriticalPathAnalyzer::Intersect(
+    const std::vector<Interval>& a, const std::vector<Interval>& b) {
+  std::vector<Interval> result;
+  size_t i = 0, j = 0;
+  while (i < a.size() && j < b.size()) {
+    uint64_t start = std::max(a[i].first, b[j].first);
+    uint64_t end = std::min(a[i].second, b[j].second);
+    if (start < end) {
+      result.emplace_back(start, end);
+    }
+    if (a[i].second < b[j].second) {
+      ++i;
+    } else {
+      ++j;
+    }
+  }
+  return result;
+}
+
+std::vector<CriticalPathAnalyzer::Interval> CriticalPathAnalyzer::Complement(
+    const std::vector<Interval>& busy, const Interval& window) {
+  std::vector<Interval> gaps;
+  uint64_t cur = window.first;
+  for (const auto& interval : busy) {
+    if (interval.first > cur) {
+      gaps.emplace_back(cur, std::min(interval.first, window.second));
+    }
+    cur = std::max(cur, interval.second);
+    if (cur >= window.second) {
+      break;
+    }
+  }
+  if (cur < window.second) {
+    gaps.emplace_back(cur, window.second);
+  }
+  return gaps;
+}
+
+uint64_t CriticalPathAnalyzer::Length(const std::vector<Interval>& intervals) {
+  uint64_t length = 0;
+  for (const auto& interval : intervals) {
+    length += interval.second - interval.first;
+  }
+  return length;
+}
+
+CriticalPathAnalyzer::CriticalPathAnalyzer(const platform::NodeTrees& trees) {
+  std::map<std::pair<uint64_t, uint64_t>, std::vector<size_t>> streams;
+  // (op, start, end) of the synchronous runtime api calls
+  std::vector<std::tuple<size_t, uint64_t, uint64_t>> syncs;
+  for (const auto& kv : trees.GetNodeTrees()) {
+    std::vector<size_t> thread_ops;
+    // the nodes with the op they run in, and the ops nested in an op, e.g.
+    // the duplicate operator records of InterpreterCore, belong to it
+    std::vector<std::pair<const platform::HostTraceEventNode*, size_t>> stack;
+    stack.emplace_back(kv.second, kNoOp);
+    while (!stack.empty()) {
+      const platform::HostTraceEventNode* node = stack.back().first;
+      size_t op_idx = stack.back().second;
+      stack.pop_back();
+      if (op_idx == kNoOp &&
+          node->Type() == platform::TracerEventType::Operator) {
+        op_idx = activities_.size();
+        activities_.emplace_back(
+            node->Name(), op_idx, false, node->StartNs(), node->EndNs());
+        thread_ops.push_back(op_idx);
+      }
+      for (const auto* runtime : node->GetRuntimeTraceEventNodes()) {
+        for (const auto* device : runtime->GetDeviceTraceEventNodes()) {
+          size_t idx = activities_.size();
+          activities_.emplace_back(
+              device->Name(), op_idx, true, device->StartNs(), device->EndNs());
+          activities_[idx].is_communication = IsCommunication(*device);
+          if (op_idx != kNoOp) {
+            activities_[idx].preds.emplace_back(
+                op_idx, std::min(runtime->EndNs(), device->StartNs()));
+          }
+          streams[{device->DeviceId(), device->StreamId()}].push_back(idx);
+        }
+        if (op_idx != kNoOp && IsSynchronous(runtime->Name())) {
+          syncs.emplace_back(op_idx, runtime->StartNs(), runtime->EndNs());
+        }
+      }
+      for (const auto* child : node->GetChildren()) {
+        stack.emplace_back(child, op_idx);
+      }
+    }
+    std::sort(thread_ops.begin(), thread_ops.end(), [&](size_t a, size_t b) {
+      return activities_[a].start_ns < activities_[b].start_ns;
+    });
+    for (size_t i = 1; i < thread_ops.size(); ++i) {
+      const auto& prev = activities_[thread_ops[i - 1]];
+      activities_[thread_ops[i]].preds.emplace_back(thread_ops[i - 1],
+                                                    prev.end_ns);
+    }
+  }
+
+  // (end, idx) of the device activities
+  std::vector<std::pair<uint64_t, size_t>> device_ends;
+  for (auto& kv : streams) {
+    auto& stream = kv.second;
+    std::sort(stream.begin(), stream.end(), [&](size_t a, size_t b) {
+      return activities_[a].start_ns < activities_[b].start_ns;
+    });
+    for (size_t i = 0; i < stream.size(); ++i) {
+      if (i > 0) {
+        const auto& prev = activities_[stream[i - 1]];
+        activities_[stream[i]].preds.emplace_back(stream[i - 1], prev.end_ns);
+      }
+      device_ends.emplace_back(activities_[stream[i]].end_ns, stream[i]);
+    }
+  }
+  std::sort(device_ends.begin(), device_ends.end());
+  for (const auto& sync : syncs) {
+    auto iter = std::upper_bound(
+        device_ends.begin(),
+        device_ends.end(),
+        std::make_pair(std::get<2>(sync), std::numeric_limits<size_t>::max()));
+    if (iter == device_ends.begin() || (--iter)->first < std::get<1>(sync)) {
+      continue;
+    }
+    activities_[std::get<0>(sync)].preds.emplace_back(iter->second,
+                                                      iter->first);
+  }
+
+  TraceCriticalPath();
+  StatStreams(streams);
+}
+
+void CriticalPathAnalyzer::TraceCriticalPath() {
+  if (activities_.empty()) {
+    return;
+  }
+  size_t cur = 0;
+  for (size_t i = 1; i < activities_.size(); ++i) {
+    if (activities_[i].end_ns > activities_[cur].end_ns) {
+      cur = i;
+    }
+  }
+  std::vector<bool> visited(activities_.size(), false);
+  uint64_t bound = activities_[cur].end_ns;
+  uint64_t path_end = bound;
+  while (true) {
+    visited[cur] = true;
+    const auto& act = activities_[cur];
+    uint64_t end = std::min(act.end_ns, bound);
+    // the predecessor released last, the cycles of a synchronous op waiting
+    // for the activities it launched are cut by the visited ones
+    size_t pred = kNoOp;
+    uint64_t release = 0;
+    for (const auto& p : act.preds) {
+      if (!visited[p.first] && p.second <= end &&
+          (pred == kNoOp || p.second > release)) {
+        pred = p.first;
+        release = p.second;
+      }
+    }
+    uint64_t start = std::min(act.start_ns, end);
+    if (pred != kNoOp && release > start) {
+      start = release;
+    }
+    std::string name =
+        act.op_idx == kNoOp ? "[outside of ops]" : activities_[act.op_idx].name;
+    auto& stat = path_stats_[name];
+    (act.on_device ? stat.device_time : stat.host_time) += end - start;
+    stat.count += 1;
+    if (pred == kNoOp) {
+      path_length_ = path_end - start;
+      break;
+    }
+    uint64_t pred_end = std::min(activities_[pred].end_ns, start);
+    path_idle_time_ += start - pred_end;
+    bound = pred_end;
+    cur = pred;
+  }
+}
+
+void CriticalPathAnalyzer::StatStreams(
+    const std::map<std::pair<uint64_t, uint64_t>, std::vector<size_t>>&
+        streams) {
+  if (streams.empty()) {
+    return;
+  }
+  std::vector<Interval> host, device, compute, communication;
+  for (const auto& act : activities_) {
+    Interval interval{act.start_ns, act.end_ns};
+    if (!act.on_device) {
+      host.push_back(interval);
+      continue;
+    }
+    device.push_back(interval);
+    (act.is_communication ? communication : compute).push_back(interval);
+  }
+  device = MergeIntervals(device);
+  device_window_ = {device.front().first, device.back().second};
+
+  for (const auto& kv : streams) {
+    std::vector<Interval> busy;
+    for (size_t idx : kv.second) {
+      busy.emplace_back(activities_[idx].start_ns, activities_[idx].end_ns);
+    }
+    busy = MergeIntervals(busy);
+    auto& stat = stream_stats_[kv.first];
+    stat.busy_time = Length(busy);
+    for (const auto& gap : Complement(busy, device_window_)) {
+      stat.idle_time += gap.second - gap.first;
+      stat.num_gaps += 1;
+      stat.max_gap = std::max(stat.max_gap, gap.second - gap.first);
+    }
+  }
+
+  compute = MergeIntervals(compute);
+  communication = MergeIntervals(communication);
+  compute_time_ = Length(compute);
+  communication_time_ = Length(communication);
+  overlap_time_ = Length(Intersect(compute, communication));
+
+  auto launch_bound =
+      Intersect(Complement(device, device_window_), MergeIntervals(host));
+  launch_bound_time_ = Length(launch_bound);
+  num_launch_bound_intervals_ = launch_bound.size();
+  for (const auto& act : activities_) {
+    if (act.on_device) {
+      continue;
+    }
+    uint64_t time =
+        Length(Intersect({{act.start_ns, act.end_ns}}, launch_bound));
+    if (time > 0) {
+      launch_bound_ops_[act.name] += time;
+    }
+  }
+}
+
+std::string CriticalPathAnalyzer::Report(size_t top_n) const {
+  auto ms = [](uint64_t ns) { return static_cast<double>(ns) / 1e6; };
+  auto percent = [](uint64_t part, uint64_t whole) {
+    return whole == 0 ? 0.0 : 100.0 * part / whole;
+  };
+  std::ostringstream os;
+  os << "-------------------- Critical Path --------------------\n";
+  os << platform::string_format(
+      std::string("Critical path(ms): %.3f, idle on the path(ms): %.3f\n"),
+      ms(path_length_),
+      ms(path_idle_time_));
+  std::vector<std::pair<std::string, PathStat>> ops(path_stats_.begin(),
+                                                    path_stats_.end());
+  std::sort(ops.begin(), ops.end(), [](const auto& a, const auto& b) {
+    return a.second.host_time + a.second.device_time >
+           b.second.host_time + b.second.device_time;
+  });
+  os << platform::string_format(std::string("%-6s%-40s%-12s%-10s%-12s%-12s\n"),
+                                "Rank",
+                                "Op",
+                                "Total(ms)",
+                                "Ratio(%)",
+                                "Host(ms)",
+                                "Device(ms)");
+  for (size_t i = 0; i < ops.size() && i < top_n; ++i) {
+    const auto& stat = ops[i].second;
+    uint64_t total = stat.host_time + stat.device_time;
+    os << platform::string_format(
+        std::string("%-6zu%-40s%-12.3f%-10.2f%-12.3f%-12.3f\n"),
+        i + 1,
+        ops[i].first.c_str(),
+        ms(total),
+        percent(total, path_length_),
+        ms(stat.host_time),
+        ms(stat.device_time));
+  }
+
+  if (stream_stats_.empty()) {
+    os << "No device activities\n";
+    return os.str();
+  }
+  uint64_t window = device_window_.second - device_window_.first;
+  os << "\n-------------------- Stream Idle --------------------\n";
+  os << platform::string_format(
+      std::string("Device window(ms): %.3f\n"), ms(window));
+  os << platform::string_format(std::string("%-8s%-10s%-12s%-12s%-10s%-8s%s\n"),
+                                "Device",
+                                "Stream",
+                                "Busy(ms)",
+                                "Idle(ms)",
+                                "Idle(%)",
+                                "Gaps",
+                                "Max gap(ms)");
+  for (const auto& kv : stream_stats_) {
+    const auto& stat = kv.second;
+    os << platform::string_format(
+        std::string("%-8llu%-10llu%-12.3f%-12.3f%-10.2f%-8zu%.3f\n"),
+        static_cast<unsigned long long>(kv.first.first),   // NOLINT
+        static_cast<unsigned long long>(kv.first.second),  // NOLINT
+        ms(stat.busy_time),
+        ms(stat.idle_time),
+        percent(stat.idle_time, window),
+        stat.num_gaps,
+        ms(stat.max_gap));
+  }
+
+  os << "\n-------------------- Compute/Communication Overlap "
+        "--------------------\n";
+  os << platform::string_format(
+      std::string("Compute(ms): %.3f, communication(ms): %.3f, "
+                  "overlapped(ms): %.3f, overlap ratio of the "
+                  "communication(%%): %.2f\n"),
+      ms(compute_time_),
+      ms(communication_time_),
+      ms(overlap_time_),
+      percent(overlap_time_, communication_time_));
+
+  os << "\n-------------------- Host Launch Bound --------------------\n";
+  os << platform::string_format(
+      std::string("All the devices idle while the host runs ops(ms): %.3f "
+                  "(%.2f%% of the device window) in %zu intervals\n"),
+      ms(launch_bound_time_),
+      percent(launch_bound_time_, window),
+      num_launch_bound_intervals_);
+  std::vector<std::pair<std::string, uint64_t>> bound_ops(
+      launch_bound_ops_.begin(), launch_bound_ops_.end());
+  std::sort(bound_ops.begin(),
+            bound_ops.end(),
+            [](const auto& a, const auto& b) { return a.second > b.second; });
+  os << platform::string_format(
+      std::string("%-6s%-40s%s\n"), "Rank", "Op", "Launch bound(ms)");
+  for (size_t i = 0; i < bound_ops.size() && i < top_n; ++i) {
+    os << platform::string_format(std::string("%-6zu%-40s%.3f\n"),
+                                  i + 1,
+                                  bound_ops[i].first.c_str(),
+                                  ms(bound_ops[i].second));
+  }
+  return os.str();
+}
+
+std::string AnalyzeCriticalPath(const platform::NodeTrees& trees,
+                                size_t top_n) {
+  return CriticalPathAnalyzer(trees).Report(top_n);
+}
+
 void StaticGraphExecutorPerfStatistics(
     std::shared_ptr<const platform::NodeTrees> profiling_data) {
+  if (!FLAGS_static_executor_critical_path_filepath.empty()) {
+    std::ofstream ofs(FLAGS_static_executor_critical_path_filepath,
+                      std::ofstream::out | std::ofstream::trunc);
+    if (ofs) {
+      ofs << AnalyzeCriticalPath(*profiling_data);
+      LOG(INFO) << "writing the critical path analysis to "
+                << FLAGS_static_executor_critical_path_filepath;
+    } else {
+      LOG(WARNING) << "Unable to open file "
+                   << FLAGS_static_executor_critical_path_filepath
+                   << " for writing data.";
+    }
+  }
   if (FLAGS_static_executor_perfstat_filepath.empty()) {
     VLOG(5) << "StaticGraphExecutorPerfStatistics is disabled";
     return;
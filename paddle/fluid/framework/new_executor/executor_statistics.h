@@ -15,8 +15,10 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include "paddle/fluid/platform/profiler/event_node.h"
+#include "paddle/utils/test_macros.h"
 
 namespace paddle {
 namespace framework {
@@ -24,5 +26,14 @@ namespace framework {
 void StaticGraphExecutorPerfStatistics(
     std::shared_ptr<const platform::NodeTrees> profiling_data);
 
+// Returns the text report of the critical path of the profiling data with
+// the top_n ops on it, the idle gaps of the device streams, the overlap of
+// the compute and the communication, and the intervals the devices wait for
+// the host launches. It is written to
+// FLAGS_static_executor_critical_path_filepath by
+// StaticGraphExecutorPerfStatistics.
+TEST_API std::string AnalyzeCriticalPath(const platform::NodeTrees& trees,
+                                         size_t top_n = 20);
+
 }  // namespace framework
 }  // namespace paddle
@@ -41,11 +41,13 @@ class CinnJitInstruction::FnPtrImpl {
   void Run(const std::vector<phi::DenseTensor*>& kernel_args, void* stream) {
     func_args_.clear();
 
-    // 1. Convert the phi::DenseTensor type to cinn_pod_value_t
+    // 1. Convert the phi::DenseTensor type to cinn_pod_value_t, the buffers
+    // are reused by the runs, since the host stub picking the kernel of the
+    // shapes is launched on every run
+    buffers_.resize(kernel_args.size());
     for (size_t i = 0; i < kernel_args.size(); ++i) {
-      auto* buffer = new cinn_buffer_t();
-      buffer->memory = reinterpret_cast<uint8_t*>(kernel_args[i]->data());
-      func_args_.emplace_back(buffer);
+      buffers_[i].memory = reinterpret_cast<uint8_t*>(kernel_args[i]->data());
+      func_args_.emplace_back(&buffers_[i]);
     }
     // 2. Convert arg's data about shape of Tensor to cinn_pod_value_t
     for (const auto& int_arg_mp : cinn_kernel_info_.int_args_map) {
@@ -64,6 +66,7 @@ class CinnJitInstruction::FnPtrImpl {
  private:
   CINNKernelInfo cinn_kernel_info_;
 
+  std::vector<cinn_buffer_t> buffers_;
   std::vector<cinn_pod_value_t> func_args_;
 };
 
@@ -32,13 +32,55 @@
 #include "paddle/pir/core/builtin_attribute.h"
 #include "paddle/pir/core/operation.h"
 #include "paddle/pir/core/value.h"
+#include "paddle/pir/dialect/control_flow/ir/cf_op.h"
 
 #include "paddle/fluid/framework/new_executor/instruction/instruction_util.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_dialect.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_type.h"
 #include "paddle/fluid/pir/dialect/operator/ir/control_flow_op.h"
 #include "paddle/fluid/pir/dialect/operator/ir/manual_op.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/kernels/expand_kernel.h"
+#include "paddle/phi/kernels/where_kernel.h"
+#endif
+
 namespace paddle {
 namespace framework {
 
+// Whether the ops of the branch can run when it is not taken, that is they
+// have no side effects and only update the buffers of the branch in place.
+static bool IsSpeculatableBranch(pir::Block* block) {
+  for (auto& op : *block) {
+    if (op.isa<pir::YieldOp>() || op.isa<pir::CombineOp>() ||
+        op.isa<pir::SliceOp>() || op.isa<pir::SplitOp>()) {
+      continue;
+    }
+    if (op.num_regions() > 0 || op.HasAttribute("seed") ||
+        op.dialect()->name() != paddle::dialect::KernelDialect::name()) {
+      return false;
+    }
+    auto op_name =
+        op.attributes().at("op_name").dyn_cast<pir::StrAttribute>().AsString();
+    if (!IsSpeculatableOp(op_name)) {
+      return false;
+    }
+    bool is_inplace =
+        op.attributes().count("is_inplace") != 0 &&
+        op.attributes().at("is_inplace").dyn_cast<pir::BoolAttribute>().data();
+    if (is_inplace) {
+      for (size_t i = 0; i < op.num_operands(); ++i) {
+        auto* def_op = op.operand_source(i).defining_op();
+        if (def_op == nullptr || def_op->GetParent() != block) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
 IfInstruction::IfInstruction(size_t id,
                              const platform::Place& place,
                              pir::Operation* op,
@@ -56,6 +98,14 @@ IfInstruction::IfInstruction(size_t id,
 
   auto cond_value = if_op.operand_source(0);
   cond_var_ = value_exec_info->GetVarByValue(cond_value);
+  // NOTE: The cond is only left on the gpu by the lowering when the branches
+  // are cheap enough to both run.
+  auto cond_type =
+      cond_value.type().dyn_cast<paddle::dialect::AllocatedDenseTensorType>();
+  select_on_device_ =
+      cond_type && cond_type.place().GetType() == phi::AllocationType::GPU &&
+      IsSpeculatableBranch(&if_op.true_block()) &&
+      IsSpeculatableBranch(&if_op.false_block());
   for (size_t i = 0; i < if_op.num_results(); ++i) {
     output_vars_.push_back(value_exec_info->GetScope()->GetVar(
         value_exec_info->GetValue2VarName().at(if_op.result(i))));
@@ -183,9 +233,118 @@ void IfInstruction::CopyBranchOutput(const std::vector<std::string>& var_names,
   }
 }
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+template <typename T>
+static void SelectByCond(const phi::GPUContext& ctx,
+                         const phi::DenseTensor& cond,
+                         const phi::DenseTensor& true_out,
+                         const phi::DenseTensor& false_out,
+                         phi::DenseTensor* out) {
+  phi::DenseTensor expanded_cond;
+  if (true_out.numel() == cond.numel()) {
+    expanded_cond.ShareDataWith(cond);
+    expanded_cond.Resize(true_out.dims());
+  } else {
+    phi::ExpandKernel<bool, phi::GPUContext>(
+        ctx,
+        cond,
+        phi::IntArray(common::vectorize(true_out.dims())),
+        &expanded_cond);
+  }
+  phi::DenseTensor selected;
+  selected.Resize(true_out.dims());
+  phi::WhereKernel<T, phi::GPUContext>(
+      ctx, expanded_cond, true_out, false_out, &selected);
+  *out = selected;
+}
+#endif
+
+bool IfInstruction::SelectBranchOutput() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  const auto& cond = cond_var_->Get<phi::DenseTensor>();
+  if (cond.numel() != 1) {
+    return false;
+  }
+  std::vector<const phi::DenseTensor*> true_outs;
+  std::vector<const phi::DenseTensor*> false_outs;
+  for (size_t i = 0; i < true_branch_outputs_.size(); ++i) {
+    auto* true_var =
+        true_branch_inter_->InnerScope()->GetVar(true_branch_outputs_[i]);
+    auto* false_var =
+        false_branch_inter_->InnerScope()->GetVar(false_branch_outputs_[i]);
+    if (!true_var->IsType<phi::DenseTensor>() ||
+        !false_var->IsType<phi::DenseTensor>()) {
+      return false;
+    }
+    const auto& true_out = true_var->Get<phi::DenseTensor>();
+    const auto& false_out = false_var->Get<phi::DenseTensor>();
+    auto dtype = true_out.dtype();
+    if (!true_out.initialized() || !false_out.initialized() ||
+        true_out.dims() != false_out.dims() || dtype != false_out.dtype() ||
+        true_out.place() != cond.place() ||
+        false_out.place() != cond.place() || true_out.numel() == 0 ||
+        !(dtype == phi::DataType::FLOAT32 || dtype == phi::DataType::FLOAT64 ||
+          dtype == phi::DataType::INT32 || dtype == phi::DataType::INT64 ||
+          dtype == phi::DataType::FLOAT16 ||
+          dtype == phi::DataType::BFLOAT16)) {
+      return false;
+    }
+    true_outs.push_back(&true_out);
+    false_outs.push_back(&false_out);
+  }
+
+  const auto& ctx = static_cast<const phi::GPUContext&>(DeviceContext());
+  for (size_t i = 0; i < true_outs.size(); ++i) {
+    auto* out = output_vars_[i]->GetMutable<phi::DenseTensor>();
+    switch (true_outs[i]->dtype()) {
+      case phi::DataType::FLOAT32:
+        SelectByCond<float>(ctx, cond, *true_outs[i], *false_outs[i], out);
+        break;
+      case phi::DataType::FLOAT64:
+        SelectByCond<double>(ctx, cond, *true_outs[i], *false_outs[i], out);
+        break;
+      case phi::DataType::INT32:
+        SelectByCond<int>(ctx, cond, *true_outs[i], *false_outs[i], out);
+        break;
+      case phi::DataType::INT64:
+        SelectByCond<int64_t>(ctx, cond, *true_outs[i], *false_outs[i], out);
+        break;
+      case phi::DataType::FLOAT16:
+        SelectByCond<phi::dtype::float16>(
+            ctx, cond, *true_outs[i], *false_outs[i], out);
+        break;
+      default:
+        SelectByCond<phi::dtype::bfloat16>(
+            ctx, cond, *true_outs[i], *false_outs[i], out);
+        break;
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
 void IfInstruction::Run() {
+  if (select_on_device_) {
+    VLOG(6) << "if instruction runs both the branches";
+    true_branch_inter_->Run({}, false);
+    false_branch_inter_->Run({}, false);
+    if (SelectBranchOutput()) {
+      return;
+    }
+    // The outputs can't be selected on the device, e.g. of different shapes,
+    // so the taken branch is got by the cond on the host.
+    if (GetCondData(cond_var_->Get<phi::DenseTensor>())) {
+      CopyBranchOutput(true_branch_outputs_, true_branch_inter_);
+    } else {
+      CopyBranchOutput(false_branch_outputs_, false_branch_inter_);
+    }
+    return;
+  }
+
   DeviceContext().Wait();
-  if (cond_var_->Get<phi::DenseTensor>().data<bool>()[0]) {
+  if (GetCondData(cond_var_->Get<phi::DenseTensor>())) {
     true_branch_inter_->Run({}, false);
     CopyBranchOutput(true_branch_outputs_, true_branch_inter_);
   } else {
@@ -51,12 +51,20 @@ class IfInstruction : public InstructionBase {
   void CopyBranchOutput(const std::vector<std::string>& var_names,
                         const PirInterpreter* inter);
 
+  // Selects the outputs of the both branches by the cond on the device, false
+  // if they can't be selected, e.g. of different shapes or types.
+  bool SelectBranchOutput();
+
   ::pir::Operation* op_;
 
   std::string cond_name_{"if_instruction"};
 
   Variable* cond_var_;
 
+  // Whether both the branches run and their outputs are selected by the cond
+  // on the device, instead of waiting for the cond on the host.
+  bool select_on_device_{false};
+
   std::vector<Variable*> output_vars_;
 
   PirInterpreter* true_branch_inter_ = nullptr;
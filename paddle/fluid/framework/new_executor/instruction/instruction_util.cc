@@ -17,6 +17,7 @@
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "paddle/fluid/framework/new_executor/new_executor_defs.h"
@@ -350,5 +351,53 @@ bool GetCondData(const phi::DenseTensor& cond) {
   return cpu_cond->data<bool>()[0];
 }
 
+// NOTE: The ops which make a different result in every run, or have effects
+// besides their results.
+static std::unordered_set<std::string> not_speculatable_op_list = {
+    "pd_op.data",
+    "pd_op.feed",
+    "pd_op.fetch",
+    "pd_op.shadow_feed",
+    "pd_op.shadow_output",
+    "pd_op.print",
+    "pd_op.assert",
+    "pd_op.uniform",
+    "pd_op.gaussian",
+    "pd_op.randint",
+    "pd_op.randperm",
+    "pd_op.bernoulli",
+    "pd_op.multinomial",
+    "pd_op.poisson",
+    "pd_op.truncated_gaussian_random",
+    "pd_op.dropout",
+    "pd_op.fused_dropout_add",
+    "pd_op.rrelu",
+    "pd_op.class_center_sample",
+    "pd_op.top_p_sampling",
+};
+
+// The prefixes of the communication ops.
+static std::vector<std::string> not_speculatable_op_prefixes = {
+    "pd_op.c_",
+    "pd_op.send",
+    "pd_op.recv",
+    "pd_op.partial_",
+    "pd_op.global_",
+    "pd_op.barrier",
+    "pd_op.distributed_",
+};
+
+bool IsSpeculatableOp(const std::string& op_name) {
+  if (not_speculatable_op_list.count(op_name) > 0) {
+    return false;
+  }
+  for (auto& prefix : not_speculatable_op_prefixes) {
+    if (op_name.compare(0, prefix.size(), prefix) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace framework
 }  // namespace paddle
@@ -60,5 +60,11 @@ void InsertTuplePushContinerToOuts(
     std::unordered_map<pir::Value, std::vector<int>>* outputs);
 
 bool GetCondData(const phi::DenseTensor& cond);
+
+// Whether the op named op_name can also run when its results are not used,
+// e.g. out of a loop or in the branch not taken, that is it has no effects
+// besides its results and makes the same results from the same inputs.
+bool IsSpeculatableOp(const std::string& op_name);
+
 }  // namespace framework
 }  // namespace paddle
@@ -25,6 +25,7 @@
 #include "paddle/fluid/platform/collective_helper.h"
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/phi/core/infermeta_utils.h"
+#include "paddle/phi/core/kernel_corpus.h"
 #include "paddle/phi/core/meta_tensor.h"
 #include "paddle/phi/core/type_defs.h"
 
@@ -33,6 +34,9 @@
 #include "paddle/pir/core/value.h"
 
 #include "paddle/fluid/framework/new_executor/instruction/instruction_util.h"
+
+PHI_DECLARE_string(kernel_corpus_path);
+
 namespace paddle {
 namespace framework {
 
@@ -116,6 +120,8 @@ PhiKernelInstruction::PhiKernelInstruction(
   auto kernel_result = phi::KernelFactory::Instance().SelectKernelOrThrowError(
       kernel_name, kernel_key);
   phi_kernel_ = new phi::Kernel(kernel_result.kernel);
+  kernel_name_ = kernel_name;
+  kernel_key_ = kernel_key;
   PADDLE_ENFORCE_EQ(
       phi_kernel_->IsValid(), true, "not found kernel for [%s]", kernel_name);
   VLOG(6) << "finish process select kernel";
@@ -166,6 +172,10 @@ void PhiKernelInstruction::Run() {
   VLOG(6) << "Run op " << phi_op_name_ << " infer meta.";
   (*(phi_kernel_))(&(kernel_context_));
   VLOG(6) << "Run op " << phi_op_name_ << " kernel.";
+  if (!FLAGS_kernel_corpus_path.empty()) {
+    phi::RecordKernelCorpus(
+        kernel_name_, kernel_key_, *phi_kernel_, kernel_context_);
+  }
 }
 
 }  // namespace framework
@@ -62,6 +62,10 @@ class PhiKernelInstruction : public InstructionBase {
 
   phi::Kernel* phi_kernel_{nullptr};  // not owned
 
+  std::string kernel_name_;
+
+  phi::KernelKey kernel_key_;
+
   std::string phi_op_name_;
 
   ::pir::Operation* op_{nullptr};  // not owned
@@ -43,6 +43,8 @@ TuplePopInstruction::TuplePopInstruction(size_t id,
     auto outlet_element_value = tuple_pop_op_.outlet_element(i);
     outputs.emplace(outlet_element_value,
                     GetValueIds(outlet_element_value, *value_exe_info_));
+    outlet_element_vars_.push_back(
+        value_exe_info_->GetVarByValue(outlet_element_value));
   }
 
   // NOTE(zhangbo): TuplePop will change the variables corresponding to the
@@ -80,14 +82,11 @@ void TuplePopInstruction::Run() {
   } else {
     std::stack<const Variable*> var_elements =
         PopElements(stack_element_var_array_, tuple_pop_op_.tuple_size());
-    // TODO(zhangbo): Performance optimization: static acquisition of TuplePoop
-    // output variables.
-    for (size_t i = 0; i < tuple_pop_op_.tuple_size(); ++i) {
+    for (size_t i = 0; i < outlet_element_vars_.size(); ++i) {
       auto front_var = var_elements.top();
       var_elements.pop();
       VLOG(6) << "pop back var: " << front_var;
-      auto outlet_element_value = tuple_pop_op_.outlet_element(i);
-      auto grad_var = value_exe_info_->GetVarByValue(outlet_element_value);
+      auto grad_var = outlet_element_vars_[i];
       grad_var->GetMutable<phi::DenseTensor>()->ShareDataWith(
           front_var->Get<phi::DenseTensor>());
 
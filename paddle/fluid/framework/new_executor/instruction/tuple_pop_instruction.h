@@ -15,6 +15,8 @@
 #pragma once
 
 #include <string>
+#include <vector>
+
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
 #include "paddle/fluid/framework/new_executor/new_executor_defs.h"
 #include "paddle/fluid/framework/tensor_ref_array.h"
@@ -52,6 +54,8 @@ class TuplePopInstruction : public InstructionBase {
 
   VariableRefArray* stack_element_var_array_;
 
+  std::vector<Variable*> outlet_element_vars_;  // not owned
+
   ValueExecutionInfo* value_exe_info_;
 };
 
@@ -36,6 +36,10 @@ TuplePushInstruction::TuplePushInstruction(size_t id,
     auto inlet_element_value = tuple_push_op_.inlet_element(i);
     inputs.emplace(inlet_element_value,
                    GetValueIds(inlet_element_value, *value_exe_info_));
+    inlet_element_vars_.push_back(
+        value_exe_info_->GetVarByValue(inlet_element_value));
+    inlet_element_names_.push_back(
+        value_exe_info_->GetVarName(inlet_element_value) + "copied_");
   }
   SetInputs(inputs);
 
@@ -71,16 +75,13 @@ void TuplePushInstruction::Run() {
   if (tuple_push_op_.tuple_size() == 0) {
     stack_element_var_array_->emplace_back(nullptr);
   } else {
-    auto& value_2_var_name = value_exe_info_->GetValue2VarName();
-    // TODO(zhangbo): Performance optimization: static acquisition of TuplePush
-    // input variables and name.
-    for (size_t i = 0; i < tuple_push_op_.tuple_size(); i++) {
-      auto inlet_element_value = tuple_push_op_.inlet_element(i);
-      Variable* var = value_exe_info_->GetVarByValue(inlet_element_value);
-      int stack_size = tuple_push_op_.tuple_size();
-
-      auto var_name = value_2_var_name.at(inlet_element_value);
-      std::string new_name = var_name + "copied_" +
+    // The input variables and the prefixes of the names of their copies are
+    // got once in the constructor, and the copies of the same position of the
+    // stack, e.g. of the same iteration of a loop, are reused by every run.
+    int stack_size = tuple_push_op_.tuple_size();
+    for (size_t i = 0; i < inlet_element_vars_.size(); i++) {
+      Variable* var = inlet_element_vars_[i];
+      std::string new_name = inlet_element_names_[i] +
                              std::to_string(stack_element_var_array_->size());
       auto* copy_var = value_exe_info_->GetScope()->Var(new_name);
       DeepCopyVariable(var, copy_var, value_exe_info_, stack_size);
@@ -15,6 +15,8 @@
 #pragma once
 
 #include <string>
+#include <vector>
+
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
 #include "paddle/fluid/framework/new_executor/new_executor_defs.h"
 #include "paddle/fluid/framework/tensor_ref_array.h"
@@ -48,6 +50,10 @@ class TuplePushInstruction : public InstructionBase {
 
   VariableRefArray* stack_element_var_array_;  // not owned
 
+  std::vector<Variable*> inlet_element_vars_;  // not owned
+
+  std::vector<std::string> inlet_element_names_;
+
   ValueExecutionInfo* value_exe_info_;
 };
 
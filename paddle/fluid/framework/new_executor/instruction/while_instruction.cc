@@ -105,7 +105,7 @@ WhileInstruction::WhileInstruction(size_t id,
        << std::chrono::high_resolution_clock::now().time_since_epoch().count()
        << "body_block_arg_";
     auto var_name = ss.str() + std::to_string(i);
-    body_scope->Var(var_name);
+    block_arg_vars_.push_back(body_scope->Var(var_name));
     body_exe_info->Add(body_block_->arg(i), var_name);
   }
   body_inter_ = std::unique_ptr<PirInterpreter>(new PirInterpreter(
@@ -115,6 +115,13 @@ WhileInstruction::WhileInstruction(size_t id,
   auto body_block_outputs = GetYiedOpInputs(body_block_);
   for (auto value : body_block_outputs) {
     body_outputs_.push_back(body_inter_->GetNameByValue(value));
+    body_output_vars_.push_back(body_inter_->local_scope()->GetVar(
+        body_inter_->GetNameByValue(value)));
+    // Only the values computed by the body are written in every iteration,
+    // the others are the block args or the values outside the loop.
+    body_output_computed_.push_back(value.defining_op() != nullptr &&
+                                    value.defining_op()->GetParent() ==
+                                        body_block_);
     body_skip_gc_names_.push_back(body_inter_->GetNameByValue(value));
     body_skip_gc_names_set.insert(body_inter_->GetNameByValue(value));
   }
@@ -160,16 +167,23 @@ void WhileInstruction::ShareInputsToOutputs() {
 }
 
 void WhileInstruction::CopyOutputsToBlockArgs() {
-  for (size_t i = 0; i < body_block_->args_size(); ++i) {
-    auto block_arg = body_block_->arg(i);
-    auto var_name = body_inter_->GetNameByValue(block_arg);
-    auto* inner_var = body_inter_->local_scope()->GetVar(var_name);
+  bool copied = false;
+  for (size_t i = 0; i < block_arg_vars_.size(); ++i) {
+    auto* inner_var = block_arg_vars_[i];
 
     if (outputs_[i]->IsType<phi::DenseTensor>()) {
       auto& src_tensor = outputs_[i]->Get<phi::DenseTensor>();
       auto* dst_tensor = inner_var->GetMutable<phi::DenseTensor>();
+      // the loop state updated in place by the body is already in the block
+      // arg
+      if (dst_tensor->IsSharedWith(src_tensor) &&
+          dst_tensor->offset() == src_tensor.offset()) {
+        dst_tensor->set_meta(src_tensor.meta());
+        continue;
+      }
       dst_tensor->set_meta(src_tensor.meta());
       framework::TensorCopy(src_tensor, src_tensor.place(), dst_tensor);
+      copied = true;
     } else if (outputs_[i]->IsType<phi::TensorArray>()) {
       auto src_tensor_array = outputs_[i]->Get<phi::TensorArray>();
       auto* dst_tensor_array = inner_var->GetMutable<phi::TensorArray>();
@@ -183,24 +197,25 @@ void WhileInstruction::CopyOutputsToBlockArgs() {
         phi::DenseTensor* tmp_dst_tensor = &dst_tensor_array->at(id);
         tmp_dst_tensor->set_meta(src_tensor.meta());
         framework::TensorCopy(src_tensor, src_tensor.place(), tmp_dst_tensor);
+        copied = true;
       }
     } else {
       PADDLE_THROW(
           phi::errors::Unimplemented("unsupported type %d", inner_var->Type()));
     }
   }
-  DeviceContext().Wait();
+  if (copied) {
+    DeviceContext().Wait();
+  }
 }
 
 void WhileInstruction::ShareDatasToOutputs() {
   cond_var_->GetMutable<phi::DenseTensor>()->ShareDataWith(
-      body_inter_->local_scope()
-          ->GetVar(body_outputs_[0])
-          ->Get<phi::DenseTensor>());
+      body_output_vars_[0]->Get<phi::DenseTensor>());
   for (size_t i = 0; i < outputs_.size(); ++i) {
-    auto& out_var_name = body_outputs_[i + 1];
-    auto* out_var = body_inter_->local_scope()->GetVar(out_var_name);
-    VLOG(6) << "share data from " << out_var_name << " -> " << i << " output";
+    auto* out_var = body_output_vars_[i + 1];
+    VLOG(6) << "share data from " << body_outputs_[i + 1] << " -> " << i
+            << " output";
 
     if (out_var->IsType<phi::DenseTensor>()) {
       outputs_[i]->GetMutable<phi::DenseTensor>()->ShareDataWith(
@@ -216,6 +231,27 @@ void WhileInstruction::ShareDatasToOutputs() {
 
     VLOG(6) << "done";
   }
+
+  // The loop state in a new buffer, which is only held by the yielded value
+  // and the output, is passed to the block arg by pointer instead of the copy
+  // of the next iteration. The yielded value gives the buffer up, so that the
+  // body writes the next state into another buffer instead of the one read by
+  // the block arg.
+  for (size_t i = 0; i < outputs_.size() && i < block_arg_vars_.size(); ++i) {
+    auto* out_var = body_output_vars_[i + 1];
+    if (!body_output_computed_[i + 1] ||
+        !out_var->IsType<phi::DenseTensor>()) {
+      continue;
+    }
+    auto* out_tensor = out_var->GetMutable<phi::DenseTensor>();
+    if (!out_tensor->Holder() || out_tensor->Holder().use_count() != 2 ||
+        !outputs_[i]->Get<phi::DenseTensor>().IsSharedWith(*out_tensor)) {
+      continue;
+    }
+    block_arg_vars_[i]->GetMutable<phi::DenseTensor>()->ShareDataWith(
+        *out_tensor);
+    out_tensor->clear();
+  }
 }
 
 void WhileInstruction::Run() {
@@ -67,7 +67,10 @@ class WhileInstruction : public InstructionBase {
   std::vector<Variable*> outputs_;
 
   std::unique_ptr<PirInterpreter> body_inter_;
+  std::vector<Variable*> block_arg_vars_;
   std::vector<std::string> body_outputs_;
+  std::vector<Variable*> body_output_vars_;
+  std::vector<bool> body_output_computed_;
   std::vector<std::string> body_skip_gc_names_;
 
   ::pir::Block* body_block_;
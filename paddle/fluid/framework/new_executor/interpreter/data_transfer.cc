@@ -42,6 +42,49 @@ bool DataTranferHelper::apply(const phi::KernelKey& kernel_type_for_var,
   bool is_transferred = false;
   auto* src_var_name = &var_name;
 
+  auto transfer_device = [&]() {
+    auto src_place = tensor->place();
+    auto dst_place = phi::TransToPhiPlace(expected_kernel_key.backend());
+
+    auto op = TransferDevice(
+        *src_var_name, new_var_name, src_place, dst_place, var_scope_, scope_);
+    if (op) {
+      RunAndConstructOpFuncNode(
+          op, *src_var_name, *new_var_name, op_func_nodes, static_build);
+    }
+    // update src_var_name
+    src_var_name = new_var_name;
+    is_transferred = true;
+  };
+
+  // 0. device transform first for the copies from the host to the place of
+  // the executor, so that the layout and dtype transforms run on the device
+  // instead of the host, except for the layouts of oneDNN, which are only
+  // transformed on cpu.
+  bool device_transferred = false;
+  if (need_device_transform(
+          kernel_type_for_var, tensor, expected_kernel_key.backend())) {
+    const auto dst_place = phi::TransToPhiPlace(expected_kernel_key.backend());
+    const bool need_dtype =
+        need_dtype_transform(kernel_type_for_var, expected_kernel_key);
+    const bool need_transform_on_device =
+        need_layout_transform(kernel_type_for_var, expected_kernel_key) ||
+        need_dtype;
+    // a narrowing cast is still done on the host to copy the fewer bytes
+    const bool is_narrowing_cast =
+        need_dtype && phi::SizeOf(expected_kernel_key.dtype()) <
+                          phi::SizeOf(kernel_type_for_var.dtype());
+    if (need_transform_on_device && !is_narrowing_cast &&
+        platform::is_cpu_place(tensor->place()) &&
+        !platform::is_cpu_place(place_) &&
+        platform::is_same_place(dst_place, place_) &&
+        kernel_type_for_var.layout() != DataLayout::ONEDNN &&
+        expected_kernel_key.layout() != DataLayout::ONEDNN) {
+      transfer_device();
+      device_transferred = true;
+    }
+  }
+
   // 1. layout transform
   if (need_layout_transform(kernel_type_for_var, expected_kernel_key)) {
     auto op = TransferLayout(*src_var_name,
@@ -79,18 +122,10 @@ bool DataTranferHelper::apply(const phi::KernelKey& kernel_type_for_var,
   }
 
   // 3. device transform
-  phi::Backend expected_backend = expected_kernel_key.backend();
-  if (need_device_transform(kernel_type_for_var, tensor, expected_backend)) {
-    auto src_place = tensor->place();
-    auto dst_place = phi::TransToPhiPlace(expected_backend);
-
-    auto op = TransferDevice(
-        *src_var_name, new_var_name, src_place, dst_place, var_scope_, scope_);
-    if (op) {
-      RunAndConstructOpFuncNode(
-          op, *src_var_name, *new_var_name, op_func_nodes, static_build);
-    }
-    is_transferred = true;
+  if (!device_transferred &&
+      need_device_transform(
+          kernel_type_for_var, tensor, expected_kernel_key.backend())) {
+    transfer_device();
   }
   return is_transferred;
 }
@@ -233,6 +268,8 @@ void DataTranferHelper::RunAndConstructOpFuncNode(
 
   VLOG(3) << "Run " << op_type << " done.";
 
+  var_scope_->RecordDataTransfer(new_var_name, var_name);
+  var_scope_->BumpVarVersion(new_var_name);
   new_op_func_nodes->emplace_back(std::move(new_op_func_node));
 }
 
@@ -250,6 +287,44 @@ bool IsTensorOfVarInitialized(Variable* var) {
   return false;
 }
 
+// The transferred var is reused by the later consumers of the same source and
+// target, unless the source is written again after the transfer, in which
+// case it is transferred again into the same var.
+static bool UseCachedDataTransfer(const std::string& var_name,
+                                  const std::string& new_var_name,
+                                  VariableScope* var_scope,
+                                  framework::Scope* local_scope) {
+  if (var_scope->HasVar(new_var_name) &&
+      IsTensorOfVarInitialized(local_scope->FindVar(new_var_name))) {
+    if (var_scope->IsDataTransferFresh(new_var_name, var_name)) {
+      // already has same var
+      VLOG(4) << "Use cached variable: " << new_var_name;
+      return true;
+    }
+    VLOG(4) << "Transfer " << var_name << " again since it is written after "
+            << "the transfer to " << new_var_name;
+  }
+  return false;
+}
+
+static void CreateDataTransferVar(const std::string& var_name,
+                                  const std::string& new_var_name,
+                                  VariableScope* var_scope,
+                                  framework::Scope* local_scope) {
+  auto* ptr = local_scope->Var(new_var_name);
+  auto var_type = local_scope->FindVar(var_name)->Type();
+  InitializeVariable(ptr, static_cast<proto::VarType::Type>(var_type));
+  if (var_scope->HasVar(new_var_name)) {
+    return;
+  }
+  VLOG(3) << "Create Variable " << new_var_name
+          << " locally, which pointer is " << ptr << "Variable Type "
+          << var_type;
+  var_scope->MutableDataTransferAddedVars().emplace_back(new_var_name,
+                                                         var_type);
+  var_scope->AddVar(new_var_name, nullptr);
+}
+
 std::shared_ptr<OperatorBase> TransferLayout(const std::string& var_name,
                                              std::string* new_var_name,
                                              DataLayout in_layout,
@@ -286,22 +361,10 @@ std::shared_ptr<OperatorBase> TransferLayout(const std::string& var_name,
                   std::to_string(static_cast<int>(in_layout)) + "_" +
                   std::to_string(static_cast<int>(out_layout));
 
-  if (var_scope->HasVar(*new_var_name) &&
-      IsTensorOfVarInitialized(local_scope->FindVar(*new_var_name))) {
-    // already has same var
-    VLOG(4) << "Use cached variable: " << *new_var_name;
+  if (UseCachedDataTransfer(var_name, *new_var_name, var_scope, local_scope)) {
     return nullptr;
   }
-
-  auto* ptr = local_scope->Var(*new_var_name);
-  auto var_type = local_scope->FindVar(var_name)->Type();
-  InitializeVariable(ptr, static_cast<proto::VarType::Type>(var_type));
-  VLOG(3) << "Create Variable " << *new_var_name
-          << " locally, which pointer is " << ptr << "Variable Type "
-          << var_type;
-  var_scope->MutableDataTransferAddedVars().emplace_back(*new_var_name,
-                                                         var_type);
-  var_scope->AddVar(*new_var_name, nullptr);
+  CreateDataTransferVar(var_name, *new_var_name, var_scope, local_scope);
 
   // 2. Construct VariableNameMap
   VariableNameMap in_name_map = {{"X", {var_name}}};
@@ -334,22 +397,10 @@ std::shared_ptr<OperatorBase> TransferDtype(const std::string& var_name,
   *new_var_name = var_name + "_dtype_" +
                   std::to_string(static_cast<int>(in_dtype)) + "_" +
                   std::to_string(static_cast<int>(out_dtype));
-  if (var_scope->HasVar(*new_var_name) &&
-      IsTensorOfVarInitialized(local_scope->FindVar(*new_var_name))) {
-    // already has same var
-    VLOG(4) << "Use cached variable: " << *new_var_name;
+  if (UseCachedDataTransfer(var_name, *new_var_name, var_scope, local_scope)) {
     return nullptr;
   }
-
-  auto* ptr = local_scope->Var(*new_var_name);
-  auto var_type = local_scope->FindVar(var_name)->Type();
-  InitializeVariable(ptr, static_cast<proto::VarType::Type>(var_type));
-  VLOG(3) << "Create Variable " << *new_var_name
-          << " locally, which pointer is " << ptr << "Variable Type "
-          << var_type;
-  var_scope->MutableDataTransferAddedVars().emplace_back(*new_var_name,
-                                                         var_type);
-  var_scope->AddVar(*new_var_name, nullptr);
+  CreateDataTransferVar(var_name, *new_var_name, var_scope, local_scope);
 
   // 2. Construct VariableNameMap
   VariableNameMap in_name_map = {{"X", {var_name}}};
@@ -385,22 +436,10 @@ std::shared_ptr<OperatorBase> TransferDevice(const std::string& var_name,
   *new_var_name = var_name + "_device_" + src_place.DebugString() + "_" +
                   dst_place.DebugString();
 
-  if (var_scope->HasVar(*new_var_name) &&
-      IsTensorOfVarInitialized(local_scope->FindVar(*new_var_name))) {
-    // already has same var
-    VLOG(4) << "Use cached variable: " << *new_var_name;
+  if (UseCachedDataTransfer(var_name, *new_var_name, var_scope, local_scope)) {
     return nullptr;
   }
-
-  auto* ptr = local_scope->Var(*new_var_name);
-  auto var_type = local_scope->FindVar(var_name)->Type();
-  InitializeVariable(ptr, static_cast<proto::VarType::Type>(var_type));
-  VLOG(3) << "Create Variable " << *new_var_name
-          << " locally, which pointer is " << ptr << "Variable Type "
-          << var_type;
-  var_scope->MutableDataTransferAddedVars().emplace_back(*new_var_name,
-                                                         var_type);
-  var_scope->AddVar(*new_var_name, nullptr);
+  CreateDataTransferVar(var_name, *new_var_name, var_scope, local_scope);
 
   // 2. Construct VariableNameMap
   VariableNameMap in_name_map = {{"X", {var_name}}};
@@ -14,11 +14,13 @@
 
 #include "paddle/fluid/framework/new_executor/interpreter/dependency_builder.h"
 
+#include <algorithm>
 #include <queue>
 #include <sstream>
 #include <stack>
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
 #include "paddle/fluid/framework/new_executor/instruction/phi_kernel_instruction.h"
+#include "paddle/fluid/framework/new_executor/interpreter/dependency_cache.h"
 #include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
 #include "paddle/fluid/platform/flags.h"
@@ -73,6 +75,79 @@ const std::string StringizeDownstreamMap(
   return oss.str();
 }
 
+std::vector<size_t> TopologicalSort(
+    const std::map<size_t, std::set<size_t>>& downstream_map, size_t op_num) {
+  std::vector<size_t> in_degree(op_num, 0);
+  for (auto const& pair : downstream_map) {
+    for (size_t next_op : pair.second) {
+      ++in_degree[next_op];
+    }
+  }
+
+  // Kahn's algorithm
+  std::vector<size_t> topo_order;
+  topo_order.reserve(op_num);
+  std::queue<size_t> ready_ops;
+  for (size_t op_idx = 0; op_idx < op_num; ++op_idx) {
+    if (in_degree[op_idx] == 0) {
+      ready_ops.push(op_idx);
+    }
+  }
+  while (!ready_ops.empty()) {
+    size_t op_idx = ready_ops.front();
+    ready_ops.pop();
+    topo_order.push_back(op_idx);
+    auto it = downstream_map.find(op_idx);
+    if (it == downstream_map.end()) {
+      continue;
+    }
+    for (size_t next_op : it->second) {
+      if (--in_degree[next_op] == 0) {
+        ready_ops.push(next_op);
+      }
+    }
+  }
+  PADDLE_ENFORCE_EQ(topo_order.size(),
+                    op_num,
+                    phi::errors::PreconditionNotMet(
+                        "The dependency graph contains a cycle, only %d of %d "
+                        "ops can be sorted topologically.",
+                        topo_order.size(),
+                        op_num));
+  return topo_order;
+}
+
+std::vector<size_t> GetCriticalPathLength(
+    const std::map<size_t, std::set<size_t>>& downstream_map, size_t op_num) {
+  std::vector<size_t> topo_order = TopologicalSort(downstream_map, op_num);
+
+  std::vector<size_t> critical_path_length(op_num, 1);
+  for (auto rit = topo_order.rbegin(); rit != topo_order.rend(); ++rit) {
+    auto it = downstream_map.find(*rit);
+    if (it == downstream_map.end()) {
+      continue;
+    }
+    for (size_t next_op : it->second) {
+      critical_path_length[*rit] = std::max(critical_path_length[*rit],
+                                            critical_path_length[next_op] + 1);
+    }
+  }
+  return critical_path_length;
+}
+
+std::vector<size_t> RankDownstreamOps(
+    const std::set<size_t>& downstream_ops,
+    const std::vector<size_t>& critical_path_length) {
+  std::vector<size_t> ranked_ops(downstream_ops.begin(), downstream_ops.end());
+  std::stable_sort(ranked_ops.begin(),
+                   ranked_ops.end(),
+                   [&critical_path_length](size_t lhs, size_t rhs) {
+                     return critical_path_length[lhs] >
+                            critical_path_length[rhs];
+                   });
+  return ranked_ops;
+}
+
 DependencyBuilder::DependencyBuilder()
     : is_build_(false), instructions_(nullptr) {
   op_downstream_map_ = std::make_shared<std::map<size_t, std::set<size_t>>>();
@@ -90,6 +165,20 @@ const std::map<size_t, std::set<size_t>>& DependencyBuilder::Build(
   instructions_ = &instructions;
   op_num_ = instructions_->size();
 
+  uint64_t fingerprint = 0;
+  std::string cache_path;
+  if (!FLAGS_new_executor_dependency_cache_dir.empty()) {
+    fingerprint = DependencyFingerprint(instructions);
+    cache_path = DependencyCachePath(fingerprint);
+    if (LoadDependencyCache(
+            cache_path, fingerprint, op_num_, op_downstream_map_.get())) {
+      BuildOpHappensBefore(
+          *op_downstream_map_, op_num_, op_happens_before_.get());
+      is_build_ = true;
+      return *op_downstream_map_;
+    }
+  }
+
   ops_before_.assign(op_num_, {});
   ops_behind_.assign(op_num_, {});
   op_happens_before_->assign(op_num_, std::vector<bool>(op_num_, false));
@@ -122,6 +211,10 @@ const std::map<size_t, std::set<size_t>>& DependencyBuilder::Build(
   VLOG(8) << "downstream_map: " << std::endl
           << StringizeDownstreamMap(*op_downstream_map_);
 
+  if (!cache_path.empty()) {
+    SaveDependencyCache(cache_path, fingerprint, op_num_, *op_downstream_map_);
+  }
+
   is_build_ = true;
 
   return *op_downstream_map_;
@@ -26,6 +26,23 @@ namespace framework {
 class InstructionBase;
 namespace interpreter {
 
+// TopologicalSort returns the ops in an order that every op is placed before
+// its downstream ops, a cycle in downstream_map is reported as an error.
+std::vector<size_t> TopologicalSort(
+    const std::map<size_t, std::set<size_t>>& downstream_map, size_t op_num);
+
+// GetCriticalPathLength returns, for every op, the number of ops on the longest
+// dependency chain starting from it (itself included). Ops on long chains
+// should be dispatched earlier to shorten the step latency.
+std::vector<size_t> GetCriticalPathLength(
+    const std::map<size_t, std::set<size_t>>& downstream_map, size_t op_num);
+
+// RankDownstreamOps sorts downstream_ops by descending critical path length,
+// ties are broken by ascending op index to keep the order deterministic.
+std::vector<size_t> RankDownstreamOps(
+    const std::set<size_t>& downstream_ops,
+    const std::vector<size_t>& critical_path_length);
+
 // DependencyBuilder provides some dependency adding function to handle the
 // dependency that cannot be explicitly expresed by a Program. It is a
 // compromise of the incomplete expression ability of the Program. Do not add
@@ -0,0 +1,237 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/dependency_cache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "paddle/fluid/framework/new_executor/interpreter/dependency_builder.h"
+#include "paddle/fluid/platform/flags.h"
+#include "paddle/phi/core/os_info.h"
+
+PADDLE_DEFINE_EXPORTED_string(
+    new_executor_dependency_cache_dir,
+    "",
+    "The directory to persist the dependency analysis results of standalone "
+    "executor, which are reused when the same program is run again to reduce "
+    "the cold start time. Empty means disable the cache.");
+
+PD_DECLARE_bool(add_dependency_for_communication_op);
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+namespace {
+
+constexpr uint32_t kDependencyCacheMagic = 0x43444450;  // "PDDC"
+// Bump the version whenever DependencyBuilder changes the dependencies it
+// builds, so that stale cache files are ignored.
+constexpr uint32_t kDependencyCacheVersion = 1;
+
+class FingerprintBuilder {
+ public:
+  // FNV-1a
+  void Add(uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+      hash_ ^= (value >> (i * 8)) & 0xff;
+      hash_ *= 0x100000001b3ULL;
+    }
+  }
+
+  void Add(const std::string& str) {
+    Add(static_cast<uint64_t>(str.size()));
+    for (char c : str) {
+      hash_ ^= static_cast<uint8_t>(c);
+      hash_ *= 0x100000001b3ULL;
+    }
+  }
+
+  void Add(const std::map<std::string, std::vector<int>>& var_map) {
+    Add(static_cast<uint64_t>(var_map.size()));
+    for (auto const& pair : var_map) {
+      Add(pair.first);
+      Add(static_cast<uint64_t>(pair.second.size()));
+      for (int var_id : pair.second) {
+        Add(static_cast<uint64_t>(var_id));
+      }
+    }
+  }
+
+  uint64_t Get() const { return hash_; }
+
+ private:
+  uint64_t hash_{0xcbf29ce484222325ULL};
+};
+
+template <typename T>
+void WritePod(std::ostream& os, const T& value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadPod(std::istream& is, T* value) {
+  is.read(reinterpret_cast<char*>(value), sizeof(T));
+  return static_cast<bool>(is);
+}
+
+}  // namespace
+
+uint64_t DependencyFingerprint(const std::vector<Instruction>& instructions) {
+  FingerprintBuilder builder;
+  builder.Add(static_cast<uint64_t>(kDependencyCacheVersion));
+  builder.Add(static_cast<uint64_t>(FLAGS_new_executor_sequential_run));
+  builder.Add(static_cast<uint64_t>(FLAGS_add_dependency_for_communication_op));
+  builder.Add(static_cast<uint64_t>(instructions.size()));
+  for (auto const& instr : instructions) {
+    builder.Add(instr.OpBaseValid() ? instr.OpBase()->Type()
+                                    : std::string("artificial"));
+    builder.Add(static_cast<uint64_t>(instr.KernelType()));
+    builder.Add(instr.DeviceContext().GetPlace().DebugString());
+    builder.Add(instr.Inputs());
+    builder.Add(instr.Outputs());
+    builder.Add(static_cast<uint64_t>(instr.InplaceBackMap().size()));
+    for (auto const& pair : instr.InplaceBackMap()) {
+      builder.Add(static_cast<uint64_t>(pair.first));
+      builder.Add(static_cast<uint64_t>(pair.second));
+    }
+  }
+  return builder.Get();
+}
+
+std::string DependencyCachePath(uint64_t fingerprint) {
+  std::ostringstream oss;
+  oss << FLAGS_new_executor_dependency_cache_dir << "/" << std::hex
+      << fingerprint << ".deps";
+  return oss.str();
+}
+
+bool LoadDependencyCache(const std::string& path,
+                         uint64_t fingerprint,
+                         size_t op_num,
+                         std::map<size_t, std::set<size_t>>* downstream_map) {
+  std::ifstream fin(path, std::ios::binary);
+  if (!fin.is_open()) {
+    VLOG(4) << "Dependency cache " << path << " not found";
+    return false;
+  }
+
+  uint32_t magic = 0, version = 0;
+  uint64_t cached_fingerprint = 0, cached_op_num = 0;
+  if (!ReadPod(fin, &magic) || !ReadPod(fin, &version) ||
+      !ReadPod(fin, &cached_fingerprint) || !ReadPod(fin, &cached_op_num) ||
+      magic != kDependencyCacheMagic || version != kDependencyCacheVersion ||
+      cached_fingerprint != fingerprint || cached_op_num != op_num) {
+    LOG(WARNING) << "Dependency cache " << path
+                 << " mismatches the program, ignore it.";
+    return false;
+  }
+
+  std::map<size_t, std::set<size_t>> result;
+  for (size_t op_idx = 0; op_idx < op_num; ++op_idx) {
+    uint64_t downstream_num = 0;
+    if (!ReadPod(fin, &downstream_num)) {
+      LOG(WARNING) << "Dependency cache " << path << " is truncated.";
+      return false;
+    }
+    if (downstream_num == 0) {
+      continue;
+    }
+    std::set<size_t>& downstream_ops = result[op_idx];
+    for (uint64_t i = 0; i < downstream_num; ++i) {
+      uint64_t next_op = 0;
+      if (!ReadPod(fin, &next_op) || next_op >= op_num) {
+        LOG(WARNING) << "Dependency cache " << path << " is corrupted.";
+        return false;
+      }
+      downstream_ops.insert(next_op);
+    }
+  }
+
+  *downstream_map = std::move(result);
+  VLOG(4) << "Load dependency cache from " << path;
+  return true;
+}
+
+void SaveDependencyCache(
+    const std::string& path,
+    uint64_t fingerprint,
+    size_t op_num,
+    const std::map<size_t, std::set<size_t>>& downstream_map) {
+  // write to a temporary file and rename it, so that concurrent processes
+  // never read a partially written cache
+  std::string tmp_path = path + ".tmp." + std::to_string(phi::GetProcessId());
+  {
+    std::ofstream fout(tmp_path, std::ios::binary);
+    if (!fout.is_open()) {
+      LOG(WARNING) << "Cannot open " << tmp_path
+                   << " to save dependency cache.";
+      return;
+    }
+    WritePod(fout, kDependencyCacheMagic);
+    WritePod(fout, kDependencyCacheVersion);
+    WritePod(fout, fingerprint);
+    WritePod(fout, static_cast<uint64_t>(op_num));
+    for (size_t op_idx = 0; op_idx < op_num; ++op_idx) {
+      auto it = downstream_map.find(op_idx);
+      if (it == downstream_map.end()) {
+        WritePod(fout, static_cast<uint64_t>(0));
+        continue;
+      }
+      WritePod(fout, static_cast<uint64_t>(it->second.size()));
+      for (size_t next_op : it->second) {
+        WritePod(fout, static_cast<uint64_t>(next_op));
+      }
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Failed to save dependency cache to " << path;
+    std::remove(tmp_path.c_str());
+    return;
+  }
+  VLOG(4) << "Save dependency cache to " << path;
+}
+
+void BuildOpHappensBefore(
+    const std::map<size_t, std::set<size_t>>& downstream_map,
+    size_t op_num,
+    std::vector<std::vector<bool>>* op_happens_before) {
+  op_happens_before->assign(op_num, std::vector<bool>(op_num, false));
+
+  // visit ops in reversed topological order, so that the closure of all
+  // downstream ops is ready when an op is visited
+  std::vector<size_t> topo_order = TopologicalSort(downstream_map, op_num);
+  for (auto rit = topo_order.rbegin(); rit != topo_order.rend(); ++rit) {
+    auto it = downstream_map.find(*rit);
+    if (it == downstream_map.end()) {
+      continue;
+    }
+    std::vector<bool>& behind = (*op_happens_before)[*rit];
+    for (size_t next_op : it->second) {
+      behind[next_op] = true;
+      const std::vector<bool>& next_behind = (*op_happens_before)[next_op];
+      for (size_t op_idx = 0; op_idx < op_num; ++op_idx) {
+        if (next_behind[op_idx]) {
+          behind[op_idx] = true;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
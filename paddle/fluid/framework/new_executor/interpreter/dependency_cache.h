@@ -0,0 +1,65 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/new_executor/new_executor_defs.h"
+
+PD_DECLARE_string(new_executor_dependency_cache_dir);
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+// The dependency analysis of a program is deterministic given the instruction
+// list, so its result can be persisted to disk and reused by later processes
+// running the same program (e.g., elastic restart). Only the downstream map is
+// stored, the happens-before matrix is recovered from its transitive closure.
+
+// Fingerprint of everything the DependencyBuilder reads from the instructions,
+// together with the flags that change the built dependencies.
+uint64_t DependencyFingerprint(const std::vector<Instruction>& instructions);
+
+// Returns the cache file path of the fingerprint under
+// FLAGS_new_executor_dependency_cache_dir.
+std::string DependencyCachePath(uint64_t fingerprint);
+
+// Returns false if the cache file does not exist or does not match fingerprint
+// and op_num, in which case downstream_map is left untouched.
+bool LoadDependencyCache(const std::string& path,
+                         uint64_t fingerprint,
+                         size_t op_num,
+                         std::map<size_t, std::set<size_t>>* downstream_map);
+
+void SaveDependencyCache(
+    const std::string& path,
+    uint64_t fingerprint,
+    size_t op_num,
+    const std::map<size_t, std::set<size_t>>& downstream_map);
+
+// Build the happens-before matrix, i.e., the transitive closure of
+// downstream_map.
+void BuildOpHappensBefore(
+    const std::map<size_t, std::set<size_t>>& downstream_map,
+    size_t op_num,
+    std::vector<std::vector<bool>>* op_happens_before);
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
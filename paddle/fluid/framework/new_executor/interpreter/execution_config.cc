@@ -128,7 +128,15 @@ void ExecutionConfig::Log(int log_level) {
           << "used_for_control_flow_op = " << used_for_control_flow_op << "\n"
           << "used_for_jit = " << used_for_jit << "\n"
           << "deivce_num_threads = " << device_num_threads << "\n"
-          << "host_num_threads = " << host_num_threads << "\n";
+          << "host_num_threads = " << host_num_threads << "\n"
+          << "numa_node = " << numa_node << "\n"
+          << "num_branch_streams = " << num_branch_streams << "\n";
+
+  log_str << "cpu_affinity = [";
+  for (int cpu : cpu_affinity) {
+    log_str << cpu << " ";
+  }
+  log_str << "]\n";
 
   log_str << "force_root_scope_vars = [";
   for (const std::string& var : force_root_scope_vars) {
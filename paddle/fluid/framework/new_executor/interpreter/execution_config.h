@@ -16,6 +16,7 @@
 
 #include <set>
 #include <string>
+#include <vector>
 
 #include "paddle/fluid/platform/place.h"
 
@@ -34,6 +35,14 @@ struct ExecutionConfig {
   size_t device_num_threads{0};
   size_t host_num_threads{0};
 
+  // the cpus and numa node to bind the threads of the work queues to
+  std::vector<int> cpu_affinity;
+  int numa_node{-1};
+
+  // the streams to overlap the independent branches of the program on, 1 to
+  // run all the kernels on the default stream
+  int num_branch_streams{1};
+
   std::set<std::string> force_root_scope_vars;
   std::set<std::string> jit_input_vars;
   std::set<std::string> skip_gc_vars;
@@ -89,7 +89,11 @@ class SingleStreamGuard {
 };
 
 const std::vector<WorkQueueOptions> ConstructWorkQueueOptions(
-    size_t host_num_threads, size_t device_num_threads, EventsWaiter* waiter) {
+    size_t host_num_threads,
+    size_t device_num_threads,
+    EventsWaiter* waiter,
+    const std::vector<int>& cpu_affinity,
+    int numa_node) {
   std::vector<WorkQueueOptions> group_options;
   // for execute host Kernel
   group_options.emplace_back(/*name*/ "HostTasks",
@@ -107,15 +111,21 @@ const std::vector<WorkQueueOptions> ConstructWorkQueueOptions(
                              /*track_task*/ false,
                              /*detached*/ true,
                              /*events_waiter*/ waiter);
+  for (auto& options : group_options) {
+    options.cpu_affinity = cpu_affinity;
+    options.numa_node = numa_node;
+  }
   return group_options;
 }
 
 AsyncWorkQueue::AsyncWorkQueue(size_t host_num_threads,
                                size_t device_num_threads,
-                               EventsWaiter* waiter)
+                               EventsWaiter* waiter,
+                               const std::vector<int>& cpu_affinity,
+                               int numa_node)
     : host_num_thread_(host_num_threads) {
-  queue_group_ = CreateWorkQueueGroup(
-      ConstructWorkQueueOptions(host_num_threads, device_num_threads, waiter));
+  queue_group_ = CreateWorkQueueGroup(ConstructWorkQueueOptions(
+      host_num_threads, device_num_threads, waiter, cpu_affinity, numa_node));
 }
 
 void AsyncWorkQueue::AddTask(const OpFuncType& op_func_type,
@@ -552,6 +562,21 @@ void HandleOperatorBase(
   op_func_node->dev_ctx_ = dev_ctx;
 }
 
+// Bumps the versions of the vars written by the op, including the ones written
+// back by the inplace data transfers, so that the data transfers of them made
+// before are not reused by the later ops.
+static void BumpOutputVersions(const OpFuncNode& op_func_node,
+                               VariableScope* var_scope) {
+  for (auto& pair : op_func_node.operator_base_->Outputs()) {
+    for (auto& name : pair.second) {
+      var_scope->BumpVarVersion(name);
+    }
+  }
+  for (auto& pair : op_func_node.inplace_back_map) {
+    var_scope->BumpVarVersion(var_scope->GetNameById(pair.second));
+  }
+}
+
 void BuildOpFuncList(const platform::Place& place,
                      const framework::BlockDesc& block,
                      const std::set<std::string>& skip_gc_vars,
@@ -717,6 +742,7 @@ void BuildOpFuncList(const platform::Place& place,
                            static_build,
                            following_ops);
         vec_func_list->emplace_back(op_func_node);
+        BumpOutputVersions(op_func_node, var_scope);
       } else {
         VLOG(4) << "OP is not null";
         auto op_with_kernel = const_cast<framework::OperatorWithKernel*>(
@@ -894,6 +920,7 @@ void BuildOpFuncList(const platform::Place& place,
         // for debug nan/inf
 
         vec_func_list->emplace_back(op_func_node);
+        BumpOutputVersions(op_func_node, var_scope);
 
         if (!op_func_node.inplace_back_map.empty()) {
           auto& m = op_func_node.inplace_back_map;
@@ -49,7 +49,9 @@ class AsyncWorkQueue {
  public:
   AsyncWorkQueue(size_t host_num_threads,
                  size_t deivce_num_threads,
-                 EventsWaiter* waiter);
+                 EventsWaiter* waiter,
+                 const std::vector<int>& cpu_affinity = {},
+                 int numa_node = -1);
 
   // void WaitEmpty() { queue_group_->WaitQueueGroupEmpty(); }
 
@@ -0,0 +1,229 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/static_memory_planner.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+// the alignment of the tensors in the workspace, the same as the one of the
+// cuda allocator
+constexpr size_t kWorkspaceAlignment = 256;
+
+static size_t AlignUp(size_t bytes, size_t alignment) {
+  return (bytes + alignment - 1) / alignment * alignment;
+}
+
+size_t PackTensorOffsets(
+    std::vector<PlannedTensor>* tensors,
+    const std::function<bool(size_t, size_t)>& op_happens_before,
+    size_t alignment) {
+  auto before = [&](const PlannedTensor& a, const PlannedTensor& b) {
+    for (size_t last : a.last_ops) {
+      for (size_t first : b.first_ops) {
+        if (!op_happens_before(last, first)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  };
+
+  std::vector<size_t> order(tensors->size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return (*tensors)[a].bytes > (*tensors)[b].bytes;
+  });
+
+  // the placed tensors in the order of their offsets
+  std::vector<const PlannedTensor*> placed;
+  size_t workspace_size = 0;
+  for (size_t idx : order) {
+    PlannedTensor& tensor = (*tensors)[idx];
+    const size_t bytes = AlignUp(tensor.bytes, alignment);
+
+    size_t best_offset = std::numeric_limits<size_t>::max();
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    size_t prev_end = 0;
+    for (const PlannedTensor* other : placed) {
+      if (before(*other, tensor) || before(tensor, *other)) {
+        continue;
+      }
+      if (other->offset > prev_end) {
+        size_t gap = other->offset - prev_end;
+        if (gap >= bytes && gap < best_gap) {
+          best_offset = prev_end;
+          best_gap = gap;
+        }
+      }
+      prev_end =
+          std::max(prev_end, other->offset + AlignUp(other->bytes, alignment));
+    }
+    tensor.offset =
+        best_offset == std::numeric_limits<size_t>::max() ? prev_end
+                                                          : best_offset;
+    workspace_size = std::max(workspace_size, tensor.offset + bytes);
+
+    auto pos = std::upper_bound(placed.begin(),
+                                placed.end(),
+                                tensor.offset,
+                                [](size_t offset, const PlannedTensor* t) {
+                                  return offset < t->offset;
+                                });
+    placed.insert(pos, &tensor);
+  }
+  return workspace_size;
+}
+
+void StaticMemoryPlanner::Init(
+    const platform::Place& place,
+    const std::map<size_t, std::set<size_t>>& var_accessors,
+    size_t instr_num) {
+  place_ = place;
+  candidates_.clear();
+  instr_vars_.assign(instr_num, {});
+  planned_.clear();
+  views_.clear();
+  workspace_size_ = 0;
+  for (auto& item : var_accessors) {
+    if (item.second.empty()) {
+      continue;
+    }
+    candidates_[item.first].accessors = item.second;
+    for (size_t instr_id : item.second) {
+      instr_vars_[instr_id].push_back(item.first);
+    }
+  }
+  recording_ = !candidates_.empty();
+  VLOG(4) << "Static memory plan candidates: " << candidates_.size();
+}
+
+void StaticMemoryPlanner::Record(const Instruction& instr,
+                                 const VariableScope& var_scope) {
+  std::lock_guard<std::mutex> guard(record_mutex_);
+  for (size_t var_id : instr_vars_[instr.Id()]) {
+    Candidate& candidate = candidates_[var_id];
+    if (candidate.excluded) {
+      continue;
+    }
+    Variable* var = var_scope.VarRef(static_cast<int>(var_id));
+    if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+      candidate.excluded = true;
+      continue;
+    }
+    const auto& holder = var->Get<phi::DenseTensor>().Holder();
+    if (!holder) {
+      continue;
+    }
+    // a holder referred to by others may outlive the lifetime of the var
+    if (holder.use_count() > 1 || holder->place() != place_) {
+      VLOG(6) << "Skip the static memory plan of var "
+              << var_scope.GetNameById(static_cast<int>(var_id))
+              << " after op " << instr.OpBase()->Type();
+      candidate.excluded = true;
+      continue;
+    }
+    candidate.bytes = std::max(candidate.bytes, holder->size());
+  }
+}
+
+void StaticMemoryPlanner::Plan(
+    const std::function<bool(size_t, size_t)>& op_happens_before) {
+  recording_ = false;
+  std::vector<PlannedTensor> tensors;
+  size_t total_bytes = 0;
+  for (auto& item : candidates_) {
+    const Candidate& candidate = item.second;
+    if (candidate.excluded || candidate.bytes == 0) {
+      continue;
+    }
+    PlannedTensor tensor;
+    tensor.var_id = item.first;
+    tensor.bytes = candidate.bytes;
+    for (size_t op : candidate.accessors) {
+      bool is_first = true;
+      bool is_last = true;
+      for (size_t other : candidate.accessors) {
+        is_first = is_first && !op_happens_before(other, op);
+        is_last = is_last && !op_happens_before(op, other);
+      }
+      if (is_first) {
+        tensor.first_ops.insert(op);
+      }
+      if (is_last) {
+        tensor.last_ops.insert(op);
+      }
+    }
+    total_bytes += tensor.bytes;
+    tensors.emplace_back(std::move(tensor));
+  }
+  candidates_.clear();
+  instr_vars_.clear();
+  if (tensors.empty()) {
+    return;
+  }
+
+  workspace_size_ =
+      PackTensorOffsets(&tensors, op_happens_before, kWorkspaceAlignment);
+  std::shared_ptr<phi::Allocation> workspace =
+      memory::AllocShared(place_, workspace_size_);
+  auto* base = static_cast<char*>(workspace->ptr());
+  for (const PlannedTensor& tensor : tensors) {
+    // the views keep the workspace alive
+    views_[tensor.var_id] = std::shared_ptr<phi::Allocation>(
+        new phi::Allocation(base + tensor.offset, tensor.bytes, place_),
+        [workspace](phi::Allocation* view) { delete view; });
+    if (planned_.size() <= tensor.var_id) {
+      planned_.resize(tensor.var_id + 1, false);
+    }
+  }
+  VLOG(1) << "Static memory plan of " << tensors.size()
+          << " tensors on " << place_ << ": workspace " << workspace_size_
+          << " bytes, " << total_bytes << " bytes without reuse";
+}
+
+void StaticMemoryPlanner::Bind(const VariableScope& var_scope) {
+  for (auto it = views_.begin(); it != views_.end();) {
+    const size_t var_id = it->first;
+    Variable* var = var_scope.VarRef(static_cast<int>(var_id));
+    phi::DenseTensor* tensor = nullptr;
+    if (var != nullptr && var->IsType<phi::DenseTensor>()) {
+      tensor = var->GetMutable<phi::DenseTensor>();
+    }
+    if (tensor != nullptr && !tensor->Holder()) {
+      tensor->ResetHolder(it->second);
+    }
+    if (tensor == nullptr || tensor->Holder() != it->second) {
+      VLOG(4) << "Drop var " << var_scope.GetNameById(static_cast<int>(var_id))
+              << " from the static memory plan since its holder is replaced";
+      planned_[var_id] = false;
+      it = views_.erase(it);
+      continue;
+    }
+    planned_[var_id] = true;
+    ++it;
+  }
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
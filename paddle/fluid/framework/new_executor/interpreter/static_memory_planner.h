@@ -0,0 +1,118 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "paddle/fluid/framework/new_executor/new_executor_defs.h"
+#include "paddle/phi/core/allocator.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+// A tensor placed in the workspace, which is alive from the first to the last
+// of the instructions accessing it.
+struct PlannedTensor {
+  size_t var_id;
+  size_t bytes;
+  // the accessing instructions that no other one happens before
+  std::set<size_t> first_ops;
+  // the accessing instructions that happen before no other one
+  std::set<size_t> last_ops;
+  size_t offset{0};
+};
+
+// Assigns the offsets of the tensors in one workspace by the greedy-by-size
+// packing: the tensors are placed from the largest one, each into the
+// smallest gap between the placed tensors whose lifetimes overlap with it, or
+// after all of them if no gap fits. Two lifetimes do not overlap if every last
+// op of one happens before every first op of the other. Returns the size of
+// the workspace.
+size_t PackTensorOffsets(
+    std::vector<PlannedTensor>* tensors,
+    const std::function<bool(size_t, size_t)>& op_happens_before,
+    size_t alignment);
+
+// StaticMemoryPlanner takes over the memory of the intermediate tensors, the
+// ones freed by the garbage collector, from the allocator for the programs of
+// static shapes. The sizes of the tensors are recorded in the first run of the
+// instructions, and every tensor is given a view of one workspace at the
+// offset packed by the lifetimes, which it keeps across the steps instead of
+// being allocated and freed in every step.
+//
+// Only the tensors on the place of the interpreter, all of whose instructions
+// run on its default device context, are planned, so that the order of the
+// instructions on the host is the order on the device. The tensors whose
+// holders are shared with others, e.g. by inplace or by a kernel sharing the
+// buffer, are left to the garbage collector, and so are the ones reallocated
+// by a larger shape in a later step.
+class StaticMemoryPlanner {
+ public:
+  StaticMemoryPlanner() = default;
+
+  // var_accessors[i] is the instructions accessing the buffer of the
+  // candidate var i.
+  void Init(const platform::Place& place,
+            const std::map<size_t, std::set<size_t>>& var_accessors,
+            size_t instr_num);
+
+  bool IsRecording() const { return recording_; }
+
+  bool IsPlanned(size_t var_id) const {
+    return var_id < planned_.size() && planned_[var_id];
+  }
+
+  // Records the sizes of the candidate vars accessed by instr after it runs,
+  // which is thread safe.
+  void Record(const Instruction& instr, const VariableScope& var_scope);
+
+  // Packs the recorded tensors and allocates the workspace, called after the
+  // recorded run.
+  void Plan(const std::function<bool(size_t, size_t)>& op_happens_before);
+
+  // Binds the views to the planned vars before every run, and drops the vars
+  // whose holders are replaced since the last run from the plan.
+  void Bind(const VariableScope& var_scope);
+
+  size_t WorkspaceSize() const { return workspace_size_; }
+
+ private:
+  struct Candidate {
+    std::set<size_t> accessors;
+    size_t bytes{0};
+    bool excluded{false};
+  };
+
+  platform::Place place_;
+  bool recording_{false};
+  std::map<size_t, Candidate> candidates_;
+  // instr_vars_[i] is the candidate vars accessed by the i-th instruction
+  std::vector<std::vector<size_t>> instr_vars_;
+  std::mutex record_mutex_;
+
+  std::vector<bool> planned_;
+  std::map<size_t, std::shared_ptr<phi::Allocation>> views_;
+  size_t workspace_size_{0};
+};
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,136 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/stream_assigner.h"
+
+#include <algorithm>
+#include <set>
+#include <unordered_map>
+
+#include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+StreamAssignment PlanBranchStreams(const std::vector<BranchOp>& ops,
+                                   int num_streams,
+                                   size_t min_branch_ops) {
+  constexpr size_t kNoOp = static_cast<size_t>(-1);
+  const size_t op_num = ops.size();
+
+  StreamAssignment assignment;
+  assignment.stream_of_op.assign(op_num, 0);
+
+  std::unordered_map<int, size_t> writer_of_var;
+  std::vector<size_t> first_consumer(op_num, kNoOp);
+  std::vector<size_t> depth(op_num, 0);
+  std::vector<size_t> branch_of_op(op_num, kNoOp);
+  std::vector<size_t> branch_size;
+  for (size_t i = 0; i < op_num; ++i) {
+    std::set<size_t> producers;
+    for (int var : ops[i].inputs) {
+      auto it = writer_of_var.find(var);
+      if (it != writer_of_var.end() && it->second != i) {
+        producers.insert(it->second);
+      }
+    }
+    for (int var : ops[i].outputs) {
+      writer_of_var[var] = i;
+    }
+
+    for (size_t producer : producers) {
+      depth[i] = std::max(depth[i], depth[producer]);
+    }
+    if (ops[i].movable) {
+      ++depth[i];
+      ++assignment.num_ops;
+      assignment.critical_path_ops =
+          std::max(assignment.critical_path_ops, depth[i]);
+    }
+
+    // the unmovable ops carry the branches through, but are not counted in
+    // them
+    for (size_t producer : producers) {
+      if (first_consumer[producer] != kNoOp) {
+        continue;
+      }
+      first_consumer[producer] = i;
+      if (branch_of_op[i] == kNoOp ||
+          branch_of_op[producer] < branch_of_op[i]) {
+        branch_of_op[i] = branch_of_op[producer];
+      }
+    }
+    if (branch_of_op[i] == kNoOp) {
+      branch_of_op[i] = branch_size.size();
+      branch_size.push_back(0);
+    }
+    if (ops[i].movable) {
+      ++branch_size[branch_of_op[i]];
+    }
+  }
+
+  if (num_streams < 2) {
+    return assignment;
+  }
+  // the first branch is the trunk on the default stream
+  std::vector<int> stream_of_branch(branch_size.size(), 0);
+  for (size_t branch = 1; branch < branch_size.size(); ++branch) {
+    if (branch_size[branch] >= min_branch_ops) {
+      stream_of_branch[branch] =
+          static_cast<int>(assignment.num_branches % (num_streams - 1)) + 1;
+      ++assignment.num_branches;
+    }
+  }
+  for (size_t i = 0; i < op_num; ++i) {
+    if (ops[i].movable) {
+      assignment.stream_of_op[i] = stream_of_branch[branch_of_op[i]];
+    }
+  }
+  return assignment;
+}
+
+StreamAssignment AssignBranchStreams(std::vector<OpFuncNode>* op_func_nodes,
+                                     int num_streams) {
+  std::vector<BranchOp> ops(op_func_nodes->size());
+  for (size_t i = 0; i < op_func_nodes->size(); ++i) {
+    const OpFuncNode& node = op_func_nodes->at(i);
+    for (const auto& item : node.input_index) {
+      ops[i].inputs.insert(
+          ops[i].inputs.end(), item.second.begin(), item.second.end());
+    }
+    for (const auto& item : node.output_index) {
+      ops[i].outputs.insert(
+          ops[i].outputs.end(), item.second.begin(), item.second.end());
+    }
+    const OperatorBase* op = node.operator_base_.get();
+    ops[i].movable = op != nullptr && node.type_ == OpFuncType::kGpuAsync &&
+                     node.execution_stream_ == kDefaultStream &&
+                     op->Type() != kMemcpyD2H && op->Type() != kMemcpyH2D &&
+                     !IsCommunicationOp(op) && !op->HasAttr("sub_block");
+  }
+
+  StreamAssignment assignment = PlanBranchStreams(ops, num_streams);
+  for (size_t i = 0; i < op_func_nodes->size(); ++i) {
+    if (assignment.stream_of_op[i] != 0) {
+      op_func_nodes->at(i).execution_stream_ =
+          "branch_stream_" + std::to_string(assignment.stream_of_op[i]);
+    }
+  }
+  return assignment;
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,75 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/new_executor/new_executor_defs.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+// the data flow of an op to assign the streams to
+struct BranchOp {
+  std::vector<int> inputs;
+  std::vector<int> outputs;
+  // whether the op may leave the default stream
+  bool movable{true};
+};
+
+struct StreamAssignment {
+  // stream of every op, 0 for the default stream
+  std::vector<int> stream_of_op;
+  // the branches moved off the default stream
+  size_t num_branches{0};
+  // the movable ops
+  size_t num_ops{0};
+  // the movable ops on the longest dependency path
+  size_t critical_path_ops{0};
+
+  // The speedup bound of the overlap, i.e. the movable ops over the ones of
+  // them that have to run one after another.
+  double Parallelism() const {
+    return critical_path_ops == 0
+               ? 1.0
+               : static_cast<double>(num_ops) / critical_path_ops;
+  }
+};
+
+// Splits ops, in the order they run, into the branches of the data flow, and
+// places the independent branches round robin on the streams 1 to
+// num_streams - 1 beside the default stream 0. An op continues the branch of
+// its producer if it is the first consumer of the producer, and starts a new
+// branch otherwise; a join continues the branch started earliest, so the
+// trunk of the model stays on the default stream. The branches shorter than
+// min_branch_ops stay on the default stream, since the events synchronizing
+// them would cost more than the overlap.
+StreamAssignment PlanBranchStreams(const std::vector<BranchOp>& ops,
+                                   int num_streams,
+                                   size_t min_branch_ops = 2);
+
+// Plans the streams of the async gpu kernels in op_func_nodes and sets their
+// execution streams, so that the StreamAnalyzer gives them the device
+// contexts of the streams and synchronizes them across the streams by events.
+// The memcpy, communication and control flow ops, and the ops whose execution
+// streams are set already, stay where they are.
+StreamAssignment AssignBranchStreams(std::vector<OpFuncNode>* op_func_nodes,
+                                     int num_streams);
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
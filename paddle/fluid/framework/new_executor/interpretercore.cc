@@ -30,6 +30,17 @@ PADDLE_DEFINE_EXPORTED_bool(
 PADDLE_DEFINE_EXPORTED_bool(new_executor_use_inplace,
                             false,
                             "Use inplace in new executor");
+PADDLE_DEFINE_EXPORTED_bool(
+    new_executor_critical_path_scheduling,
+    false,
+    "Rank ready instructions by the length of their downstream critical path "
+    "so that long dependency chains are dispatched earlier.");
+PADDLE_DEFINE_EXPORTED_bool(
+    new_executor_static_memory_plan,
+    false,
+    "Plan the memory of the intermediate tensors of the programs of static "
+    "shapes into one workspace by their lifetimes after the first run, "
+    "instead of allocating and freeing them in every run.");
 PADDLE_DEFINE_EXPORTED_bool(new_executor_use_local_scope,
                             true,
                             "Use local_scope in new executor(especially used "
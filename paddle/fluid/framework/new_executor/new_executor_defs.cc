@@ -135,6 +135,27 @@ bool VariableScope::GetVarSikpInplace(int id) const {
   return vec_meta_info_[id].sikp_inplace_;
 }
 
+void VariableScope::BumpVarVersion(const std::string& name) {
+  ++var_versions_[name];
+}
+
+size_t VariableScope::VarVersion(const std::string& name) const {
+  auto it = var_versions_.find(name);
+  return it == var_versions_.end() ? 0 : it->second;
+}
+
+void VariableScope::RecordDataTransfer(const std::string& dst,
+                                       const std::string& src) {
+  data_transfer_src_versions_[dst] = VarVersion(src);
+}
+
+bool VariableScope::IsDataTransferFresh(const std::string& dst,
+                                        const std::string& src) const {
+  auto it = data_transfer_src_versions_.find(dst);
+  return it != data_transfer_src_versions_.end() &&
+         it->second == VarVersion(src);
+}
+
 void VariableScope::CheckExist(int id) const {
   PADDLE_ENFORCE_LT(id,
                     name2id_.size(),
@@ -131,6 +131,19 @@ class VariableScope {
 
   bool GetVarSikpInplace(int id) const;
 
+  // The versions of the vars in building the instructions, bumped by every op
+  // writing them, with which a data transfer is reused by the later consumers
+  // of its source only if the source is not written since the transfer.
+  void BumpVarVersion(const std::string& name);
+
+  size_t VarVersion(const std::string& name) const;
+
+  // Records that dst is transferred from the current version of src.
+  void RecordDataTransfer(const std::string& dst, const std::string& src);
+
+  bool IsDataTransferFresh(const std::string& dst,
+                           const std::string& src) const;
+
  private:
   // not owned, better remove it since all vars should be
   // accessed by Scope instead of VariableScope
@@ -146,6 +159,10 @@ class VariableScope {
 
   // var_name -> var_type
   std::vector<std::pair<std::string, int>> data_transfer_added_vars_;
+
+  std::unordered_map<std::string, size_t> var_versions_;
+  // the transferred var -> the version of its source
+  std::unordered_map<std::string, size_t> data_transfer_src_versions_;
 };
 
 struct EventInter {
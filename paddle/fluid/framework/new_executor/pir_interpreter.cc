@@ -125,6 +125,10 @@ PirInterpreter::PirInterpreter(const platform::Place& place,
     SchedulingPriority rhs_scheduling_priority =
         vec_instruction_base_[rhs]->GetSchedulingPriority();
     if (lhs_scheduling_priority == rhs_scheduling_priority) {
+      if (!critical_path_length_.empty() &&
+          critical_path_length_[lhs] != critical_path_length_[rhs]) {
+        return critical_path_length_[lhs] < critical_path_length_[rhs];
+      }
       return lhs < rhs;
     }
     return lhs_scheduling_priority > rhs_scheduling_priority;
@@ -187,6 +191,10 @@ PirInterpreter::PirInterpreter(
     SchedulingPriority rhs_scheduling_priority =
         vec_instruction_base_[rhs]->GetSchedulingPriority();
     if (lhs_scheduling_priority == rhs_scheduling_priority) {
+      if (!critical_path_length_.empty() &&
+          critical_path_length_[lhs] != critical_path_length_[rhs]) {
+        return critical_path_length_[lhs] < critical_path_length_[rhs];
+      }
       return lhs < rhs;
     }
     return lhs_scheduling_priority > rhs_scheduling_priority;
@@ -324,7 +332,9 @@ std::shared_ptr<interpreter::AsyncWorkQueue> PirInterpreter::GetWorkQueue() {
     async_work_queue_ = std::make_shared<interpreter::AsyncWorkQueue>(
         execution_config_.host_num_threads,
         execution_config_.device_num_threads,
-        nullptr);
+        nullptr,
+        execution_config_.cpu_affinity,
+        execution_config_.numa_node);
   }
   return async_work_queue_;
 }
@@ -803,9 +813,21 @@ void PirInterpreter::BuildInstructionDependences() {
   }
   auto downstream_map = ir_dependency_builder_.Build(instructions_ptr);
 
+  if (FLAGS_new_executor_critical_path_scheduling) {
+    critical_path_length_ =
+        interpreter::GetCriticalPathLength(downstream_map, instr_num);
+  }
+
   for (size_t instr_id = 0; instr_id < instr_num; ++instr_id) {
     InstructionBase* cur_instr = vec_instruction_base_[instr_id].get();
-    const std::set<size_t>& next_instr_ids = downstream_map[instr_id];
+    // NOTE: see ProgramInterpreter::BuildOperatorDependences for the ordering
+    // of downstream instructions under critical path scheduling.
+    const std::vector<size_t> next_instr_ids =
+        critical_path_length_.empty()
+            ? std::vector<size_t>(downstream_map[instr_id].begin(),
+                                  downstream_map[instr_id].end())
+            : interpreter::RankDownstreamOps(downstream_map[instr_id],
+                                             critical_path_length_);
 
     if (FLAGS_new_executor_serial_run) {
       for (size_t next_instr_id : next_instr_ids) {
@@ -174,6 +174,11 @@ class PirInterpreter : public InterpreterBaseImpl {
   // need to wait
   std::shared_ptr<std::vector<size_t>> dependecy_count_;
 
+  // critical_path_length_[i] is the number of instructions on the longest
+  // dependency chain starting from the i-th instruction, only built when
+  // FLAGS_new_executor_critical_path_scheduling is enabled
+  std::vector<size_t> critical_path_length_;
+
   std::vector<std::shared_ptr<interpreter::OpDepInfo>> deps_;
   std::vector<std::shared_ptr<interpreter::VarRefInfo>> refs_;
 
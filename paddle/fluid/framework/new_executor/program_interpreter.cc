@@ -18,6 +18,7 @@
 #include "paddle/fluid/framework/details/share_tensor_buffer_functor.h"
 #include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
 #include "paddle/fluid/framework/new_executor/interpreter/static_build.h"
+#include "paddle/fluid/framework/new_executor/interpreter/stream_assigner.h"
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/os_info.h"
@@ -40,6 +41,7 @@
 PHI_DECLARE_bool(dynamic_static_unified_comm);
 #endif
 
+PHI_DECLARE_bool(check_nan_inf_async);
 PD_DECLARE_bool(enable_host_event_recorder_hook);
 PD_DECLARE_bool(log_memory_stats);
 
@@ -85,6 +87,10 @@ ProgramInterpreter::ProgramInterpreter(const platform::Place& place,
     SchedulingPriority rhs_scheduling_priority =
         vec_instruction_[rhs].GetSchedulingPriority();
     if (lhs_scheduling_priority == rhs_scheduling_priority) {
+      if (!critical_path_length_.empty() &&
+          critical_path_length_[lhs] != critical_path_length_[rhs]) {
+        return critical_path_length_[lhs] < critical_path_length_[rhs];
+      }
       return lhs < rhs;
     }
     return lhs_scheduling_priority > rhs_scheduling_priority;
@@ -118,6 +124,16 @@ void ProgramInterpreter::RunImpl() {
 
   interpreter::ResetAtomicGuard guard(&deps_, &refs_);
 
+  const bool record_memory_plan = memory_planner_.IsRecording();
+  if (!record_memory_plan) {
+    memory_planner_.Bind(var_scope_);
+  }
+
+  if (FLAGS_check_nan_inf && FLAGS_check_nan_inf_async && !nan_inf_checker_ &&
+      (platform::is_gpu_place(place_) || platform::is_cpu_place(place_))) {
+    nan_inf_checker_ = std::make_unique<details::NanInfStepChecker>(place_);
+  }
+
   if (is_in_op_profiling_mode_ || execution_config_.used_for_inference ||
       ((execution_config_.used_for_jit || execution_config_.used_for_cinn) &&
        (sync_op_num_ == 0))) {
@@ -132,6 +148,16 @@ void ProgramInterpreter::RunImpl() {
     ExecuteInstructionList(vec_instruction_);
   }
 
+  if (nan_inf_checker_) {
+    nan_inf_checker_->FinishStep();
+  }
+
+  if (record_memory_plan) {
+    memory_planner_.Plan([this](size_t a, size_t b) {
+      return dependency_builder_.OpHappensBefore(a, b);
+    });
+  }
+
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
   if (platform::is_custom_place(place_)) {
     platform::DeviceContextPool::Instance().Get(place_)->Wait();
@@ -378,7 +404,9 @@ ProgramInterpreter::GetWorkQueue() {
     async_work_queue_ = std::make_shared<interpreter::AsyncWorkQueue>(
         execution_config_.host_num_threads,
         execution_config_.device_num_threads,
-        nullptr);
+        nullptr,
+        execution_config_.cpu_affinity,
+        execution_config_.numa_node);
   }
   return async_work_queue_;
 }
@@ -603,9 +631,23 @@ void ProgramInterpreter::BuildOperatorDependences() {
 
   auto downstream_map = dependency_builder_.Build(vec_instruction_);
 
+  if (FLAGS_new_executor_critical_path_scheduling) {
+    critical_path_length_ =
+        interpreter::GetCriticalPathLength(downstream_map, instr_num);
+  }
+
   for (size_t instr_id = 0; instr_id < instr_num; ++instr_id) {
     Instruction& cur_instr = vec_instruction_[instr_id];
-    const std::set<size_t>& next_instr_ids = downstream_map[instr_id];
+    // NOTE: With critical path scheduling, the downstream instruction on the
+    // longest chain is kept in the same thread, and the others are pushed to
+    // the work queue in descending rank, so the first pushed (highest ranked)
+    // task lies at the back of the queue where idle workers steal from.
+    const std::vector<size_t> next_instr_ids =
+        critical_path_length_.empty()
+            ? std::vector<size_t>(downstream_map[instr_id].begin(),
+                                  downstream_map[instr_id].end())
+            : interpreter::RankDownstreamOps(downstream_map[instr_id],
+                                             critical_path_length_);
 
     if (FLAGS_new_executor_serial_run) {
       for (size_t next_instr_id : next_instr_ids) {
@@ -671,6 +713,13 @@ void ProgramInterpreter::Convert(
   auto& vec_meta_info = var_scope_.MutableVecMetaInfo();
   auto nodes = *op_func_nodes;
   auto op_nums = nodes.size();
+  interpreter::StreamAssignment stream_assignment;
+  bool assign_branch_streams = execution_config_.num_branch_streams > 1 &&
+                               platform::is_gpu_place(place_);
+  if (assign_branch_streams) {
+    stream_assignment = interpreter::AssignBranchStreams(
+        &nodes, execution_config_.num_branch_streams);
+  }
   vec_instruction_.clear();
   vec_instruction_.reserve(op_nums);
   for (size_t op_idx = 0; op_idx < op_nums; ++op_idx) {
@@ -716,6 +765,20 @@ void ProgramInterpreter::Convert(
   // prelude-record for the first step here.
   stream_analyzer_.ConstructEvents(&vec_instruction_);
 
+  if (assign_branch_streams) {
+    size_t num_events = 0;
+    for (const auto& instr : vec_instruction_) {
+      num_events += instr.EventToRecord() != nullptr ? 1 : 0;
+    }
+    LOG(INFO) << "Overlap " << stream_assignment.num_branches
+              << " branches on " << execution_config_.num_branch_streams
+              << " streams, " << stream_assignment.num_ops << " gpu ops with "
+              << stream_assignment.critical_path_ops
+              << " on the critical path (parallelism "
+              << stream_assignment.Parallelism() << "), synchronized by "
+              << num_events << " events.";
+  }
+
   // add event for the input var of jit program, since there are async copied
   // from gpu_pinned place to gpu place on compute stream.
   for (size_t i = 0; i < dependecy_count_->size(); ++i) {
@@ -812,6 +875,10 @@ void ProgramInterpreter::Convert(
     }
   }
 
+  if (FLAGS_new_executor_static_memory_plan) {
+    InitStaticMemoryPlanner();
+  }
+
   // shrink, find the downstream op that has no other op in the
   // downstream list happens before it
   // For example,
@@ -877,6 +944,38 @@ void ProgramInterpreter::Convert(
   AnalyseExecuteOrderForTrace();
 }
 
+void ProgramInterpreter::InitStaticMemoryPlanner() {
+  // the plan replaces the garbage collection of the intermediate tensors, and
+  // the cuda graph has its own memory pool
+  if (GetEagerDeletionThreshold() < 0 || FLAGS_new_executor_use_cuda_graph) {
+    return;
+  }
+  const platform::DeviceContext* default_dev_ctx =
+      platform::DeviceContextPool::Instance().Get(place_);
+  // the accessors of the vars in last_live_ops_ before it is shrunk
+  std::map<size_t, std::set<size_t>> var_accessors;
+  for (auto& item : last_live_ops_) {
+    const auto* var_desc = var_scope_.VarDesc(static_cast<int>(item.first));
+    if (item.second.empty() || (var_desc && var_desc->Persistable())) {
+      continue;
+    }
+    bool plannable = true;
+    for (size_t op_idx : item.second) {
+      const Instruction& instr = vec_instruction_[op_idx];
+      const std::string& op_type = instr.OpBase()->Type();
+      if (&instr.DeviceContext() != default_dev_ctx || op_type == "feed" ||
+          op_type == "fetch" || op_type == "fetch_v2") {
+        plannable = false;
+        break;
+      }
+    }
+    if (plannable) {
+      var_accessors.emplace(item.first, item.second);
+    }
+  }
+  memory_planner_.Init(place_, var_accessors, vec_instruction_.size());
+}
+
 void ProgramInterpreter::BuildSkipShareLoDInfo() {
   for (size_t i = 0; i < vec_instruction_.size(); ++i) {
     bool can_skip_lod = true;
@@ -1054,7 +1153,11 @@ void ProgramInterpreter::RunOperator(const Instruction& instr_node) {
   }
 
   // for debug nan/inf
-  if (op_with_kernel != nullptr && FLAGS_check_nan_inf) {
+  if (op_with_kernel != nullptr && FLAGS_check_nan_inf && nan_inf_checker_ &&
+      !nan_inf_checker_->IsFullCheck()) {
+    VLOG(4) << "Accumulate nan/inf";
+    nan_inf_checker_->AccumulateOp(*op, *local_scope);
+  } else if (op_with_kernel != nullptr && FLAGS_check_nan_inf) {
     VLOG(4) << "Check nan/inf";
     try {
       framework::details::CheckOpHasNanOrInf(
@@ -1117,6 +1220,9 @@ void ProgramInterpreter::RunInstruction(const Instruction& instr_node) {
 
     if (!instr_node.IsArtificial()) {
       RunOperator(instr_node);
+      if (UNLIKELY(memory_planner_.IsRecording())) {
+        memory_planner_.Record(instr_node, var_scope_);
+      }
       CheckGC(instr_node);
       if (FLAGS_log_memory_stats) {
         memory::LogDeviceMemoryStats(place_, instr_node.OpBase()->Type());
@@ -1439,7 +1545,8 @@ void ProgramInterpreter::CheckGC(const Instruction& instr) {
     VLOG(4) << "GC:" << var_scope_.GetNameById(static_cast<int>(var_id))
             << ", id:" << var_id << ", ref:" << refs_[var_id]->DynamicRef();
     bool is_ready = refs_[var_id]->CheckAndDecrease();
-    if (is_ready) {
+    // the planned vars keep their views of the workspace across the runs
+    if (is_ready && !memory_planner_.IsPlanned(var_id)) {
       VLOG(6) << "Async delete variable with name : "
               << var_scope.GetNameById(static_cast<int>(var_id));
       gc_->Add(refs_[var_id]->Var(), instr);
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include "paddle/fluid/framework/details/nan_inf_utils.h"
+#include "paddle/fluid/framework/new_executor/interpreter/static_memory_planner.h"
 #include "paddle/fluid/framework/new_executor/interpreter_base_impl.h"
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -125,6 +127,7 @@ class ProgramInterpreter : public InterpreterBaseImpl {
   void BuildSkipShareLoDInfo();
   void UpdateSyncOpNum();
   void AnalyseExecuteOrderForTrace();
+  void InitStaticMemoryPlanner();
 
   // inplace
   void BuildInplace();
@@ -222,6 +225,19 @@ class ProgramInterpreter : public InterpreterBaseImpl {
   // need to wait
   std::shared_ptr<std::vector<size_t>> dependecy_count_;
 
+  // critical_path_length_[i] is the number of instructions on the longest
+  // dependency chain starting from the i-th instruction, only built when
+  // FLAGS_new_executor_critical_path_scheduling is enabled
+  std::vector<size_t> critical_path_length_;
+
+  // plans the memory of the intermediate tensors ahead of the runs, only
+  // used when FLAGS_new_executor_static_memory_plan is enabled
+  interpreter::StaticMemoryPlanner memory_planner_;
+
+  // accumulates the nan/inf of the op outputs of a step, only used when
+  // FLAGS_check_nan_inf_async is enabled
+  std::unique_ptr<details::NanInfStepChecker> nan_inf_checker_;
+
   std::vector<std::shared_ptr<interpreter::OpDepInfo>> deps_;
   std::vector<std::shared_ptr<interpreter::VarRefInfo>> refs_;
 
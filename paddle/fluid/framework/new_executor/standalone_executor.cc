@@ -16,6 +16,7 @@
 #include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
 #include "paddle/fluid/framework/new_executor/program_interpreter.h"
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/platform/monitor.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
 #include "paddle/phi/core/flags.h"
 
@@ -23,6 +24,7 @@
 
 #include "paddle/fluid/ir_adaptor/translator/translate.h"
 #include "paddle/fluid/pir/transforms/inplace_pass.h"
+#include "paddle/fluid/pir/transforms/loop_invariant_hoisting_pass.h"
 #include "paddle/pir/core/program.h"
 #include "paddle/pir/pass/pass.h"
 #include "paddle/pir/pass/pass_manager.h"
@@ -30,6 +32,9 @@
 PHI_DECLARE_bool(enable_pir_in_executor);
 PHI_DECLARE_bool(enable_pir_api);
 PHI_DECLARE_bool(pir_apply_inplace_pass);
+PHI_DECLARE_bool(pir_apply_loop_invariant_hoisting_pass);
+
+USE_HISTOGRAM_STAT(STAT_executor_run_us);
 
 namespace paddle {
 namespace framework {
@@ -106,6 +111,12 @@ StandaloneExecutor::StandaloneExecutor(const platform::Place& place,
       std::shared_ptr<pir::Program> shared_program = std::move(kernel_program);
       plan_.SetIrProgram("job_" + std::to_string(job_idx), shared_program);
 
+      if (FLAGS_pir_apply_loop_invariant_hoisting_pass) {
+        pir::PassManager pm(pir::IrContext::Instance(), 3);
+        pm.AddPass(pir::CreateLoopInvariantHoistingPass());
+        pm.Run(shared_program.get());
+      }
+
       if (FLAGS_pir_apply_inplace_pass) {
         pir::PassManager pm(pir::IrContext::Instance(), 3);
         pm.AddPass(pir::CreateInplacePass());
@@ -158,6 +169,7 @@ paddle::framework::FetchList StandaloneExecutor::Run(
     const bool enable_job_schedule_profiler) {
   platform::RecordEvent record_event(
       "StandaloneExecutor::run", platform::TracerEventType::UserDefined, 1);
+  STAT_RECORD_LATENCY(STAT_executor_run_us);
 
   const auto& jobs = plan_.JobList();
 
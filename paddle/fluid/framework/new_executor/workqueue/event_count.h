@@ -45,14 +45,18 @@
 // What changed by PaddlePaddle
 //   1. Allocate aligned storage for Waiters to get better performance.
 //   2. Replace Eigen utils with std utils.
+//   3. Add optional adaptive spinning before parking a waiter, see
+//      SetMaxSpinCount.
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <condition_variable>
 #include <cstdlib>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 #include "glog/logging.h"
@@ -91,6 +95,18 @@ class EventCount {
     AlignedFree(waiters_);
   }
 
+  // SetMaxSpinCount enables spin-then-park: a committed waiter polls for its
+  // signal up to max_spin_count times before blocking on its condition
+  // variable. The spin budget of each waiter adapts to the wakeup latency, it
+  // is doubled when the signal arrives while spinning and halved otherwise.
+  // Zero (default) means always park immediately.
+  void SetMaxSpinCount(unsigned max_spin_count) {
+    max_spin_count_ = max_spin_count;
+    for (size_t i = 0; i < waiter_num_; ++i) {
+      waiters_[i].spin_count = max_spin_count;
+    }
+  }
+
   Waiter* GetWaiter(size_t waiter_index) {
     assert(waiter_index < waiter_num_);
     return &waiters_[waiter_index];
@@ -115,6 +131,7 @@ class EventCount {
   void CommitWait(Waiter* w) {
     assert((w->epoch & ~kEpochMask) == 0);
     w->state = Waiter::kNotSignaled;
+    w->signaled.store(false, std::memory_order_relaxed);
     const uint64_t me = (w - &waiters_[0]) | w->epoch;
     uint64_t state = state_.load(std::memory_order_seq_cst);
     for (;;) {
@@ -209,6 +226,10 @@ class EventCount {
     std::condition_variable cv;
     uint64_t epoch = 0;
     unsigned state = kNotSignaled;
+    // signaled mirrors state == kSignaled, so that it can be polled without
+    // holding mu while spinning
+    std::atomic<bool> signaled{false};
+    unsigned spin_count = 0;
     enum {
       kNotSignaled,
       kWaiting,
@@ -242,6 +263,8 @@ class EventCount {
   std::atomic<uint64_t> state_;
   Waiter* waiters_{nullptr};
   size_t waiter_num_{0};
+  unsigned max_spin_count_{0};
+  static constexpr unsigned kMinSpinCount = 16;
 
   static void CheckState(uint64_t state, bool waiter UNUSED = false) {
     static_assert(kEpochBits >= 20, "not enough bits to prevent ABA problem");
@@ -255,6 +278,21 @@ class EventCount {
   }
 
   void Park(Waiter* w) {
+    if (max_spin_count_ > 0) {
+      for (unsigned i = 0; i < w->spin_count; ++i) {
+        if (w->signaled.load(std::memory_order_acquire)) {
+          w->spin_count = std::min(w->spin_count * 2, max_spin_count_);
+          break;
+        }
+        if ((i & 63) == 63) {
+          std::this_thread::yield();
+        }
+      }
+      if (!w->signaled.load(std::memory_order_acquire)) {
+        w->spin_count = std::max(w->spin_count / 2,
+                                 std::min(kMinSpinCount, max_spin_count_));
+      }
+    }
     std::unique_lock<std::mutex> lock(w->mu);
     while (w->state != Waiter::kSignaled) {
       w->state = Waiter::kWaiting;
@@ -272,6 +310,7 @@ class EventCount {
         std::unique_lock<std::mutex> lock(w->mu);
         state = w->state;
         w->state = Waiter::kSignaled;
+        w->signaled.store(true, std::memory_order_release);
       }
       // Avoid notifying if it wasn't waiting.
       if (state == Waiter::kWaiting) {
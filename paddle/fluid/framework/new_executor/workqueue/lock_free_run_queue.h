@@ -0,0 +1,202 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// LockFreeRunQueue is a fixed-size, lock-free ring buffer of Work items with
+// the same interface as RunQueue, so that it can be used as the per-thread
+// queue of ThreadPoolTempl.
+//
+// Algorithm outline:
+// It is the bounded MPMC queue by Dmitry Vyukov. Every cell carries a sequence
+// number. A producer claims the cell at enqueue_pos_ by CAS when the sequence
+// equals the position, and publishes it by storing position + 1. A consumer
+// claims the cell at dequeue_pos_ by CAS when the sequence equals
+// position + 1, and releases it by storing position + kSize. Neither remote
+// producers (PushBack) nor thieves (PopBack) are serialized by a lock.
+//
+// Unlike RunQueue, both ends of the queue are FIFO: Push* always appends and
+// Pop* always removes the oldest element. PopFront(n, result) claims up to n
+// consecutive ready cells with a single CAS, which amortizes the contention
+// on dequeue_pos_ when a worker drains a burst of small tasks.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace paddle {
+namespace framework {
+
+template <typename Work, unsigned kSize>
+class LockFreeRunQueue {
+ public:
+  LockFreeRunQueue() : enqueue_pos_(0), dequeue_pos_(0) {
+    static_assert((kSize & (kSize - 1)) == 0,
+                  "need to be a power of two for fast masking");
+    static_assert(kSize >= 2, "need to be at least 2");
+    for (unsigned i = 0; i < kSize; i++) {
+      array_[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  LockFreeRunQueue(const LockFreeRunQueue&) = delete;
+  void operator=(const LockFreeRunQueue&) = delete;
+
+  ~LockFreeRunQueue() { assert(Size() == 0); }
+
+  // PushFront inserts w into the queue.
+  // If queue is full returns w, otherwise returns default-constructed Work.
+  Work PushFront(Work w) { return Push(std::move(w)); }
+
+  // PushBack inserts w into the queue, same as PushFront.
+  Work PushBack(Work w) { return Push(std::move(w)); }
+
+  // PopFront removes and returns the oldest element in the queue.
+  // If the queue was empty returns default-constructed Work.
+  Work PopFront() { return Pop(); }
+
+  // PopBack is the same as PopFront, it can be called by any thread.
+  Work PopBack() { return Pop(); }
+
+  // PopFront removes at most n oldest elements and appends them to result.
+  // Returns number of elements removed.
+  unsigned PopFront(unsigned n, std::vector<Work>* result) {
+    if (n == 0) {
+      return 0;
+    }
+    uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      // count the ready cells starting from pos
+      unsigned ready = 0;
+      for (; ready < n; ++ready) {
+        Elem* e = &array_[(pos + ready) & kMask];
+        uint64_t seq = e->seq.load(std::memory_order_acquire);
+        if (seq != pos + ready + 1) {
+          break;
+        }
+      }
+      if (ready == 0) {
+        uint64_t seq = array_[pos & kMask].seq.load(std::memory_order_acquire);
+        if (static_cast<int64_t>(seq - (pos + 1)) < 0) {
+          return 0;  // empty
+        }
+        // another consumer moved on, reload
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (dequeue_pos_.compare_exchange_weak(
+              pos, pos + ready, std::memory_order_relaxed)) {
+        for (unsigned i = 0; i < ready; ++i) {
+          Elem* e = &array_[(pos + i) & kMask];
+          result->push_back(std::move(e->w));
+          e->seq.store(pos + i + kSize, std::memory_order_release);
+        }
+        return ready;
+      }
+    }
+  }
+
+  // PopBackHalf removes and returns half of the elements in the queue.
+  // Returns number of elements removed.
+  unsigned PopBackHalf(std::vector<Work>* result) {
+    unsigned size = Size();
+    if (size == 0) {
+      return 0;
+    }
+    return PopFront((size + 1) / 2, result);
+  }
+
+  // Size returns current queue size.
+  // Can be called by any thread at any time.
+  unsigned Size() const {
+    uint64_t dequeue_pos = dequeue_pos_.load(std::memory_order_acquire);
+    uint64_t enqueue_pos = enqueue_pos_.load(std::memory_order_acquire);
+    // dequeue_pos may be loaded before a concurrent pop and enqueue_pos after
+    // it, clamp the estimate to the valid range.
+    if (static_cast<int64_t>(enqueue_pos - dequeue_pos) <= 0) {
+      return 0;
+    }
+    uint64_t size = enqueue_pos - dequeue_pos;
+    return size > kSize ? kSize : static_cast<unsigned>(size);
+  }
+
+  // Empty tests whether container is empty.
+  // Can be called by any thread at any time.
+  bool Empty() const { return Size() == 0; }
+
+  // Delete all the elements from the queue.
+  void Flush() {
+    while (!Empty()) {
+      PopFront();
+    }
+  }
+
+ private:
+  static const uint64_t kMask = kSize - 1;
+
+  struct alignas(64) Elem {
+    std::atomic<uint64_t> seq;
+    Work w;
+  };
+
+  Work Push(Work w) {
+    uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      Elem* e = &array_[pos & kMask];
+      uint64_t seq = e->seq.load(std::memory_order_acquire);
+      int64_t diff = static_cast<int64_t>(seq - pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          e->w = std::move(w);
+          e->seq.store(pos + 1, std::memory_order_release);
+          return Work();
+        }
+      } else if (diff < 0) {
+        return w;  // full
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  Work Pop() {
+    uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      Elem* e = &array_[pos & kMask];
+      uint64_t seq = e->seq.load(std::memory_order_acquire);
+      int64_t diff = static_cast<int64_t>(seq - (pos + 1));
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          Work w = std::move(e->w);
+          e->seq.store(pos + kSize, std::memory_order_release);
+          return w;
+        }
+      } else if (diff < 0) {
+        return Work();  // empty
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  alignas(64) std::atomic<uint64_t> enqueue_pos_;
+  alignas(64) std::atomic<uint64_t> dequeue_pos_;
+  Elem array_[kSize];
+};
+
+}  // namespace framework
+}  // namespace paddle
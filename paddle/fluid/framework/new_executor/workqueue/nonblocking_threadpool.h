@@ -15,6 +15,7 @@
 
 #include "glog/logging.h"
 #include "paddle/fluid/framework/new_executor/workqueue/event_count.h"
+#include "paddle/fluid/framework/new_executor/workqueue/lock_free_run_queue.h"
 #include "paddle/fluid/framework/new_executor/workqueue/run_queue.h"
 #include "paddle/fluid/framework/new_executor/workqueue/thread_environment.h"
 #include "paddle/fluid/platform/os_info.h"
@@ -23,17 +24,34 @@
 namespace paddle {
 namespace framework {
 
-template <typename Environment>
-class ThreadPoolTempl {
+// ThreadPoolInterface hides the queue type of ThreadPoolTempl, so that the
+// queue implementation can be selected at runtime by WorkQueueOptions.
+class ThreadPoolInterface {
+ public:
+  virtual ~ThreadPoolInterface() = default;
+
+  virtual void AddTask(std::function<void()> fn) = 0;
+
+  virtual void Cancel() = 0;
+
+  virtual void WaitThreadsExit() = 0;
+
+  virtual size_t NumThreads() const = 0;
+};
+
+template <typename Environment,
+          template <typename, unsigned> class RunQueueTempl = RunQueue>
+class ThreadPoolTempl : public ThreadPoolInterface {
  public:
   typedef typename Environment::Task Task;
-  typedef RunQueue<Task, 1024> Queue;
+  typedef RunQueueTempl<Task, 1024> Queue;
 
   ThreadPoolTempl(const std::string& name,
                   int num_threads,
                   bool allow_spinning,
                   bool always_spinning,
-                  Environment env = Environment())
+                  Environment env = Environment(),
+                  unsigned park_spin_count = 0)
       : env_(env),
         allow_spinning_(allow_spinning),
         always_spinning_(always_spinning),
@@ -54,6 +72,7 @@ class ThreadPoolTempl {
     // repetitions (effectively getting a presudo-random permutation of thread
     // indices).
     assert(num_threads_ >= 1 && num_threads_ < kMaxThreads);
+    ec_.SetMaxSpinCount(park_spin_count);
     all_coprimes_.reserve(num_threads_);
     for (int i = 1; i <= num_threads_; ++i) {
       all_coprimes_.emplace_back();
@@ -66,7 +85,7 @@ class ThreadPoolTempl {
     }
   }
 
-  ~ThreadPoolTempl() {
+  ~ThreadPoolTempl() override {
     done_ = true;
 
     // Now if all threads block without work, they will start exiting.
@@ -102,7 +121,7 @@ class ThreadPoolTempl {
     }
   }
 
-  void AddTask(std::function<void()> fn) {
+  void AddTask(std::function<void()> fn) override {
     AddTaskWithHint(std::move(fn), 0, num_threads_);
   }
 
@@ -146,7 +165,7 @@ class ThreadPoolTempl {
     }
   }
 
-  void Cancel() {
+  void Cancel() override {
     cancelled_ = true;
     done_ = true;
 
@@ -154,13 +173,13 @@ class ThreadPoolTempl {
     ec_.Notify(true);
   }
 
-  void WaitThreadsExit() {
+  void WaitThreadsExit() override {
     for (size_t i = 0; i < thread_data_.size(); ++i) {
       thread_data_[i].thread->WaitExit();
     }
   }
 
-  size_t NumThreads() const { return num_threads_; }
+  size_t NumThreads() const override { return num_threads_; }
 
   int CurrentThreadId() const {
     const PerThread* pt = const_cast<ThreadPoolTempl*>(this)->GetPerThread();
@@ -479,6 +498,8 @@ class ThreadPoolTempl {
 };
 
 using NonblockingThreadPool = ThreadPoolTempl<StlThreadEnvironment>;
+using LockFreeNonblockingThreadPool =
+    ThreadPoolTempl<StlThreadEnvironment, LockFreeRunQueue>;
 
 }  // namespace framework
 }  // namespace paddle
@@ -16,6 +16,11 @@ namespace paddle {
 namespace framework {
 
 struct StlThreadEnvironment {
+  StlThreadEnvironment() = default;
+  // thread_init runs in every thread before the thread function
+  explicit StlThreadEnvironment(std::function<void()> thread_init)
+      : thread_init_(std::move(thread_init)) {}
+
   struct Task {
     std::function<void()> f;
   };
@@ -41,10 +46,19 @@ struct StlThreadEnvironment {
   };
 
   EnvThread* CreateThread(std::function<void()> f) {
-    return new EnvThread(std::move(f));
+    if (thread_init_ == nullptr) {
+      return new EnvThread(std::move(f));
+    }
+    return new EnvThread([init = thread_init_, f = std::move(f)]() {
+      init();
+      f();
+    });
   }
   Task CreateTask(std::function<void()> f) { return Task{std::move(f)}; }
   void ExecuteTask(const Task& t) { t.f(); }
+
+ private:
+  std::function<void()> thread_init_;
 };
 
 }  // namespace framework
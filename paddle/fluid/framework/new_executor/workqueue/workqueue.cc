@@ -8,6 +8,7 @@
 
 #include "paddle/fluid/framework/new_executor/workqueue/nonblocking_threadpool.h"
 #include "paddle/fluid/framework/new_executor/workqueue/workqueue_utils.h"
+#include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
 
@@ -35,6 +36,34 @@ namespace {
 
 using TaskTracker = TaskTracker<EventsWaiter::EventNotifier>;
 
+StlThreadEnvironment CreateThreadEnvironment(const WorkQueueOptions& options) {
+  if (options.cpu_affinity.empty() && options.numa_node == -1) {
+    return StlThreadEnvironment();
+  }
+  return StlThreadEnvironment(
+      [cpu_affinity = options.cpu_affinity, numa_node = options.numa_node]() {
+        platform::BindCurrentThread(cpu_affinity, numa_node);
+      });
+}
+
+ThreadPoolInterface* CreateThreadPool(const WorkQueueOptions& options) {
+  if (options.lock_free_queue) {
+    return new LockFreeNonblockingThreadPool(
+        options.name,
+        static_cast<int>(options.num_threads),
+        options.allow_spinning,
+        options.always_spinning,
+        CreateThreadEnvironment(options),
+        options.park_spin_count);
+  }
+  return new NonblockingThreadPool(options.name,
+                                   static_cast<int>(options.num_threads),
+                                   options.allow_spinning,
+                                   options.always_spinning,
+                                   CreateThreadEnvironment(options),
+                                   options.park_spin_count);
+}
+
 class WorkQueueImpl : public WorkQueue {
  public:
   explicit WorkQueueImpl(const WorkQueueOptions& options) : WorkQueue(options) {
@@ -47,10 +76,7 @@ class WorkQueueImpl : public WorkQueue {
       destruct_notifier_ =
           options.events_waiter->RegisterEvent(kQueueDestructEvent);
     }
-    queue_ = new NonblockingThreadPool(options_.name,
-                                       static_cast<int>(options_.num_threads),
-                                       options_.allow_spinning,
-                                       options_.always_spinning);
+    queue_ = CreateThreadPool(options_);
   }
 
   ~WorkQueueImpl() override {
@@ -83,7 +109,7 @@ class WorkQueueImpl : public WorkQueue {
   size_t NumThreads() const override { return queue_->NumThreads(); }
 
  private:
-  NonblockingThreadPool* queue_{nullptr};
+  ThreadPoolInterface* queue_{nullptr};
   TaskTracker* tracker_{nullptr};
   std::shared_ptr<EventsWaiter::EventNotifier> empty_notifier_;
   std::shared_ptr<EventsWaiter::EventNotifier> destruct_notifier_;
@@ -105,8 +131,7 @@ class WorkQueueGroupImpl : public WorkQueueGroup {
   void Cancel() override;
 
  private:
-  std::vector<NonblockingThreadPool*> queues_;
-  NonblockingThreadPool* queues_storage_;
+  std::vector<ThreadPoolInterface*> queues_;
   TaskTracker* tracker_;
   std::shared_ptr<EventsWaiter::EventNotifier> empty_notifier_;
   std::shared_ptr<EventsWaiter::EventNotifier> destruct_notifier_;
@@ -114,13 +139,9 @@ class WorkQueueGroupImpl : public WorkQueueGroup {
 
 WorkQueueGroupImpl::WorkQueueGroupImpl(
     const std::vector<WorkQueueOptions>& queues_options)
-    : WorkQueueGroup(queues_options),
-      queues_storage_(nullptr),
-      tracker_(nullptr) {
+    : WorkQueueGroup(queues_options), tracker_(nullptr) {
   size_t num_queues = queues_options_.size();
   queues_.resize(num_queues);
-  void* buffer = malloc(sizeof(NonblockingThreadPool) * num_queues);  // NOLINT
-  queues_storage_ = reinterpret_cast<NonblockingThreadPool*>(buffer);
 
   for (size_t idx = 0; idx < num_queues; ++idx) {
     const auto& options = queues_options_[idx];
@@ -139,25 +160,18 @@ WorkQueueGroupImpl::WorkQueueGroupImpl(
       destruct_notifier_ =
           options.events_waiter->RegisterEvent(kQueueDestructEvent);
     }
-    queues_[idx] = new (&queues_storage_[idx])
-        NonblockingThreadPool(options.name,
-                              static_cast<int>(options.num_threads),
-                              options.allow_spinning,
-                              options.always_spinning);
+    queues_[idx] = CreateThreadPool(options);
   }
 }
 
 WorkQueueGroupImpl::~WorkQueueGroupImpl() {
   for (auto queue : queues_) {
-    if (queue) {
-      queue->~NonblockingThreadPool();
-    }
+    delete queue;
   }
   if (tracker_ != nullptr) {
     tracker_->~TaskTracker();
     AlignedFree(tracker_);
   }
-  free(queues_storage_);  // NOLINT
   if (destruct_notifier_) {
     destruct_notifier_->NotifyEvent();
   }
@@ -102,6 +102,17 @@ struct WorkQueueOptions {
   // false and set events_waiter.
   bool detached{true};
   EventsWaiter* events_waiter{nullptr};  // not owned
+  // Use the lock-free LockFreeRunQueue instead of RunQueue as the per-thread
+  // task queue. It avoids the contention of remote producers and thieves on
+  // the spin lock of RunQueue, at the cost of LIFO locality of local tasks.
+  bool lock_free_queue{false};
+  // Worker threads spin up to park_spin_count times before blocking when they
+  // are going to sleep, see EventCount::SetMaxSpinCount. 0 means never spin.
+  unsigned park_spin_count{0};
+  // Worker threads are bound to cpu_affinity if it is nonempty, and allocate
+  // memory from numa_node preferably if it is not -1.
+  std::vector<int> cpu_affinity;
+  int numa_node{-1};
 };
 
 class WorkQueue {
@@ -0,0 +1,128 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Micro benchmark of WorkQueue with RunQueue and LockFreeRunQueue. For every
+// thread number in [1, FLAGS_max_threads] (doubling), it submits
+// FLAGS_tasks_per_thread tiny tasks per worker thread from as many producers
+// and reports the throughput and the percentiles of the latency between
+// AddTask and the start of the task.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/new_executor/workqueue/workqueue.h"
+#include "paddle/fluid/framework/new_executor/workqueue/workqueue_utils.h"
+#include "paddle/utils/flags.h"
+
+PD_DEFINE_int32(max_threads, 128, "The max number of worker threads.");
+PD_DEFINE_int32(tasks_per_thread, 10000, "Tasks submitted per thread.");
+PD_DEFINE_int32(park_spin_count, 0, "Spin count before a worker parks.");
+
+namespace paddle {
+namespace framework {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchResult {
+  double ops_per_sec;
+  double p50_us;
+  double p99_us;
+  double p999_us;
+};
+
+BenchResult RunBench(int num_threads, bool lock_free_queue) {
+  EventsWaiter events_waiter;
+  WorkQueueOptions options(/*name*/ "WorkQueueBenchmark",
+                           /*num_threads*/ num_threads,
+                           /*allow_spinning*/ true,
+                           /*always_spinning*/ false,
+                           /*track_task*/ true,
+                           /*detached*/ true,
+                           &events_waiter);
+  options.lock_free_queue = lock_free_queue;
+  options.park_spin_count = FLAGS_park_spin_count;
+  // CreateMultiThreadedWorkQueue requires more than 1 thread
+  auto work_queue = num_threads == 1 ? CreateSingleThreadedWorkQueue(options)
+                                     : CreateMultiThreadedWorkQueue(options);
+
+  const size_t total_tasks =
+      static_cast<size_t>(num_threads) * FLAGS_tasks_per_thread;
+  std::vector<int64_t> latency_ns(total_tasks);
+
+  auto start = Clock::now();
+  std::vector<std::thread> producers;
+  for (int p = 0; p < num_threads; ++p) {
+    producers.emplace_back([&, p]() {
+      for (int i = 0; i < FLAGS_tasks_per_thread; ++i) {
+        size_t idx = static_cast<size_t>(p) * FLAGS_tasks_per_thread + i;
+        auto submit = Clock::now();
+        work_queue->AddTask([&latency_ns, idx, submit]() {
+          latency_ns[idx] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                Clock::now() - submit)
+                                .count();
+        });
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  events_waiter.WaitEvent();
+  double elapsed_sec =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  work_queue.reset();
+
+  std::sort(latency_ns.begin(), latency_ns.end());
+  auto percentile_us = [&latency_ns](double p) {
+    size_t idx = std::min(latency_ns.size() - 1,
+                          static_cast<size_t>(p * latency_ns.size()));
+    return latency_ns[idx] / 1000.0;
+  };
+  return {total_tasks / elapsed_sec,
+          percentile_us(0.5),
+          percentile_us(0.99),
+          percentile_us(0.999)};
+}
+
+}  // namespace framework
+}  // namespace paddle
+
+int main(int argc, char* argv[]) {
+  paddle::flags::ParseCommandLineFlags(&argc, &argv);
+  google::InitGoogleLogging(argv[0]);
+
+  std::cout << std::left << std::setw(10) << "threads" << std::setw(12)
+            << "queue" << std::setw(16) << "ops/sec" << std::setw(12)
+            << "p50(us)" << std::setw(12) << "p99(us)" << std::setw(12)
+            << "p999(us)" << std::endl;
+  for (int num_threads = 1; num_threads <= FLAGS_max_threads;
+       num_threads *= 2) {
+    for (bool lock_free_queue : {false, true}) {
+      auto result = paddle::framework::RunBench(num_threads, lock_free_queue);
+      std::cout << std::setw(10) << num_threads << std::setw(12)
+                << (lock_free_queue ? "lock_free" : "spin_lock")
+                << std::setw(16) << std::fixed << std::setprecision(0)
+                << result.ops_per_sec << std::setprecision(2) << std::setw(12)
+                << result.p50_us << std::setw(12) << result.p99_us
+                << std::setw(12) << result.p999_us << std::endl;
+    }
+  }
+  return 0;
+}
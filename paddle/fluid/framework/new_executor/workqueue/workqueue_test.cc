@@ -14,11 +14,16 @@
 
 #include "paddle/fluid/framework/new_executor/workqueue/workqueue.h"
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 #include <atomic>
 #include <thread>
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
+#include "paddle/fluid/framework/new_executor/workqueue/lock_free_run_queue.h"
 #include "paddle/fluid/framework/new_executor/workqueue/workqueue_utils.h"
 
 TEST(WorkQueueUtils, TestEventsWaiter) {
@@ -204,3 +209,84 @@ TEST(WorkQueue, TestWorkQueueGroup) {
   queue_group.reset();
   waiter_thread.join();
 }
+
+TEST(WorkQueue, TestLockFreeRunQueue) {
+  using paddle::framework::LockFreeRunQueue;
+  LockFreeRunQueue<int, 8> queue;
+  EXPECT_TRUE(queue.Empty());
+  for (int i = 1; i <= 8; ++i) {
+    EXPECT_EQ(queue.PushBack(i), 0);
+  }
+  // full, the work is returned back
+  EXPECT_EQ(queue.PushFront(9), 9);
+  EXPECT_EQ(queue.Size(), 8u);
+  EXPECT_EQ(queue.PopFront(), 1);
+  EXPECT_EQ(queue.PopBack(), 2);
+
+  std::vector<int> batch;
+  EXPECT_EQ(queue.PopFront(4, &batch), 4u);
+  EXPECT_EQ(batch, std::vector<int>({3, 4, 5, 6}));
+  batch.clear();
+  EXPECT_EQ(queue.PopBackHalf(&batch), 1u);
+  EXPECT_EQ(batch, std::vector<int>({7}));
+  batch.clear();
+  EXPECT_EQ(queue.PopFront(4, &batch), 1u);
+  EXPECT_EQ(batch, std::vector<int>({8}));
+  EXPECT_EQ(queue.PopFront(), 0);
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(WorkQueue, TestLockFreeWorkQueue) {
+  using paddle::framework::CreateMultiThreadedWorkQueue;
+  using paddle::framework::EventsWaiter;
+  using paddle::framework::WorkQueueOptions;
+  std::atomic<unsigned> counter{0};
+  constexpr unsigned kExternalLoopNum = 10000;
+  EventsWaiter events_waiter;
+  WorkQueueOptions options(/*name*/ "LockFreeWorkQueueForTesting",
+                           /*num_threads*/ 10,
+                           /*allow_spinning*/ true,
+                           /*always_spinning*/ false,
+                           /*track_task*/ true,
+                           /*detached*/ true,
+                           &events_waiter);
+  options.lock_free_queue = true;
+  options.park_spin_count = 1000;
+  auto work_queue = CreateMultiThreadedWorkQueue(options);
+  for (unsigned i = 0; i < kExternalLoopNum; ++i) {
+    work_queue->AddTask([&counter]() { ++counter; });
+  }
+  EXPECT_EQ(events_waiter.WaitEvent(), paddle::framework::kQueueEmptyEvent);
+  EXPECT_EQ(counter.load(), kExternalLoopNum);
+  auto handle = work_queue->AddAwaitableTask([]() { return 4321; });
+  EXPECT_EQ(handle.get(), 4321);
+}
+
+#ifdef __linux__
+TEST(WorkQueue, TestCpuAffinity) {
+  using paddle::framework::CreateMultiThreadedWorkQueue;
+  using paddle::framework::WorkQueueOptions;
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  ASSERT_EQ(sched_getaffinity(0, sizeof(mask), &mask), 0);
+  int cpu = 0;
+  while (!CPU_ISSET(cpu, &mask)) {
+    ++cpu;
+  }
+  WorkQueueOptions options(/*name*/ "CpuAffinity",
+                           /*num_threads*/ 2,
+                           /*allow_spinning*/ true,
+                           /*track_task*/ false);
+  options.cpu_affinity = {cpu};
+  auto work_queue = CreateMultiThreadedWorkQueue(options);
+  for (int i = 0; i < 4; ++i) {
+    auto handle = work_queue->AddAwaitableTask([cpu]() {
+      cpu_set_t mask;
+      CPU_ZERO(&mask);
+      sched_getaffinity(0, sizeof(mask), &mask);
+      return CPU_COUNT(&mask) == 1 && CPU_ISSET(cpu, &mask);
+    });
+    EXPECT_TRUE(handle.get());
+  }
+}
+#endif
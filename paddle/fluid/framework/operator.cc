@@ -211,6 +211,25 @@ RuntimeContext::RuntimeContext(const VariableNameMap& innames,
   }
 }
 
+RuntimeContext::RuntimeContext(const VariableSlotMap& inslots,
+                               const VariableSlotMap& outslots,
+                               const VariableSlots& slots) {
+  for (auto& slot_item : inslots) {
+    std::vector<Variable*>& input_vars = inputs[slot_item.first];
+    input_vars.reserve(slot_item.second.size());
+    for (int slot : slot_item.second) {
+      input_vars.push_back(slots.Get(slot));
+    }
+  }
+  for (auto& slot_item : outslots) {
+    std::vector<Variable*>& output_vars = outputs[slot_item.first];
+    output_vars.reserve(slot_item.second.size());
+    for (int slot : slot_item.second) {
+      output_vars.push_back(slots.Get(slot));
+    }
+  }
+}
+
 RuntimeInferShapeContext::RuntimeInferShapeContext(const OperatorBase& op,
                                                    const RuntimeContext& ctx)
     : op_(op), ctx_(ctx) {}
@@ -767,6 +786,23 @@ const std::vector<Variable*>& RuntimeInferShapeContext::OutputVars(
   return it->second;
 }
 
+void OperatorBase::SetVarSlots(VariableSlots* var_slots) {
+  auto add_slots = [var_slots](const VariableNameMap& name_map,
+                               VariableSlotMap* slot_map) {
+    slot_map->clear();
+    for (auto& item : name_map) {
+      std::vector<int>& slots = (*slot_map)[item.first];
+      slots.reserve(item.second.size());
+      for (auto& var_name : item.second) {
+        slots.push_back(var_slots->AddSlot(var_name));
+      }
+    }
+  };
+  add_slots(inputs_, &input_slots_);
+  add_slots(outputs_, &output_slots_);
+  var_slots_ = var_slots;
+}
+
 void OperatorBase::Run(const Scope& scope, const platform::Place& place) {
   try {
     VLOG(4) << place << " " << DebugStringEx(&scope);
@@ -1663,6 +1699,28 @@ void OperatorWithKernel::CheckWhetherPreparePhiData(
   }
 }
 
+bool OperatorWithKernel::RunPrepared(const Scope& scope,
+                                     const platform::Place& place) const {
+  if (!enable_cache_runtime_context_ || !run_phi_kernel_ || impl_ == nullptr ||
+      need_prepare_data_ || need_prepare_phi_data_ || pre_scope_ != &scope ||
+      !platform::is_cpu_place(place) || platform::RecordEvent::IsEnabled()) {
+    return false;
+  }
+  try {
+    // for the sampling profiler, which is cheap if it is off
+    platform::RecordEvent op_type_record_event(
+        Type(), platform::TracerEventType::Operator, 1);
+    if (!all_kernels_must_compute_runtime_shape_ && impl_->NeedInferShape()) {
+      this->Info().infer_shape_(impl_->getRuntimeInferShapeContext());
+    }
+    (*phi_kernel_)(impl_->getKernelContext());
+  } catch (platform::EnforceNotMet& exception) {
+    framework::InsertCallStackInfo(Type(), Attrs(), &exception);
+    throw exception;
+  }
+  return true;
+}
+
 void OperatorWithKernel::RunImpl(const Scope& scope,
                                  const platform::Place& place) const {
   // To reduce the elapsed time of HasAttr, we use bool variable to record the
@@ -1675,8 +1733,14 @@ void OperatorWithKernel::RunImpl(const Scope& scope,
   const Scope* cur_scope = &scope;
   CheckWhetherPreparePhiData(Inputs(), Outputs(), scope);
   if (!enable_cache_runtime_context_) {
-    RuntimeContext ctx(Inputs(), Outputs(), scope);
-    RunImpl(scope, place, &ctx);
+    if (var_slots_ != nullptr && var_slots_->scope() == cur_scope &&
+        var_slots_->IsValid()) {
+      RuntimeContext ctx(input_slots_, output_slots_, *var_slots_);
+      RunImpl(scope, place, &ctx);
+    } else {
+      RuntimeContext ctx(Inputs(), Outputs(), scope);
+      RunImpl(scope, place, &ctx);
+    }
   } else if (run_phi_kernel_ && impl_ != nullptr && !need_prepare_data_ &&
              !need_prepare_phi_data_) {
     if (!all_kernels_must_compute_runtime_shape_ && impl_->NeedInferShape()) {
@@ -137,12 +137,20 @@ phi::DenseTensor* GetMutableLoDTensorOrSelectedRowsValueFromVar(Variable* var);
 class ExecutionContext;
 class OperatorBase;
 
+// The slots of VariableSlots of the inputs or outputs of an op by the names of
+// the arguments.
+using VariableSlotMap = std::map<std::string, std::vector<int>>;
+
 class RuntimeContext {
  public:
   RuntimeContext(const VariableNameMap& innames,
                  const VariableNameMap& outnames,
                  const Scope& scope);
 
+  RuntimeContext(const VariableSlotMap& inslots,
+                 const VariableSlotMap& outslots,
+                 const VariableSlots& slots);
+
   RuntimeContext(const VariableValueMap& invars,
                  const VariableValueMap& outvars)
       : inputs(invars), outputs(outvars) {}
@@ -334,6 +342,11 @@ class TEST_API OperatorBase {
   VariableNameMap& Inputs() { return inputs_; }
   VariableNameMap& Outputs() { return outputs_; }
 
+  // Adds the inputs and outputs to var_slots, by which the op looks them up
+  // instead of by the names when it runs in the scope of var_slots. The
+  // inputs and outputs should not be changed after that.
+  void SetVarSlots(VariableSlots* var_slots);
+
   const OpInfo& Info() const {
     PADDLE_ENFORCE_NOT_NULL(
         info_,
@@ -415,6 +428,11 @@ class TEST_API OperatorBase {
   std::vector<HookFunc> output_hookfuncs_;
   std::vector<HookFunc> input_hookfuncs_;
 
+  // not owned, set by SetVarSlots
+  const VariableSlots* var_slots_{nullptr};
+  VariableSlotMap input_slots_;
+  VariableSlotMap output_slots_;
+
  private:
   void GenerateTemporaryNames();
   void CheckAllInputOutputSet() const;
@@ -792,6 +810,17 @@ class OperatorWithKernel : public OperatorBase {
     all_kernels_must_compute_runtime_shape_ = x;
   }
 
+  // Caches the RuntimeContext, the phi kernel and the KernelContext of the
+  // op in the run, as the attribute kEnableCacheRuntimeContext does.
+  void EnableCacheRuntimeContext() { enable_cache_runtime_context_ = true; }
+
+  // Runs the bound phi kernel with the cached KernelContext on cpu, which
+  // skips the InferShape if the dims of the inputs are unchanged since the
+  // last run. Returns false without running if the op is not prepared by a
+  // cached run in scope, or needs to transform its data, or is profiled, in
+  // which case it should be run by Run.
+  bool RunPrepared(const Scope& scope, const platform::Place& place) const;
+
   void RuntimeInferShape(const Scope& scope,
                          const platform::Place& place,
                          const RuntimeContext& ctx) const override;
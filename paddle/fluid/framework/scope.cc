@@ -168,6 +168,7 @@ void Scope::EraseVars(const std::vector<std::string>& var_names) {
   {
     std::set<std::string> var_set(var_names.begin(), var_names.end());
     SCOPE_VARS_WRITER_LOCK
+    var_epoch_.fetch_add(1, std::memory_order_release);
     for (auto it = vars_.begin(); it != vars_.end();) {
       if (var_set.find(it->first) != var_set.end()) {
         it = vars_.erase(it);
@@ -200,6 +201,7 @@ Variable* Scope::VarInternal(const std::string& name) {
   if (v != nullptr) return v;
   v = new Variable();
   vars_.emplace(name, std::unique_ptr<Variable>(v));
+  var_epoch_.fetch_add(1, std::memory_order_release);
   VLOG(3) << "Create variable " << name;
   return v;
 }
@@ -237,6 +239,7 @@ void Scope::RenameInternal(const std::string& origin_name,
           "The variable with name %s already exists in the scope.", new_name));
   vars_[new_name].reset(origin_it->second.release());
   vars_.erase(origin_it);
+  var_epoch_.fetch_add(1, std::memory_order_release);
 }
 
 Variable* Scope::FindVarInternal(const std::string& name) const {
@@ -257,6 +260,7 @@ Variable* Scope::FindVarLocally(const std::string& name) const {
 
 void Scope::EraseVarsExcept(const std::unordered_set<Variable*>& vars) {
   SCOPE_VARS_WRITER_LOCK
+  var_epoch_.fetch_add(1, std::memory_order_release);
   for (auto iter = vars_.begin(); iter != vars_.end();) {
     if (vars.count(iter->second.get()) != 0) {
       ++iter;
@@ -266,6 +270,61 @@ void Scope::EraseVarsExcept(const std::unordered_set<Variable*>& vars) {
   }
 }
 
+void VariableSlots::Reset(const Scope* scope) {
+  scope_ = scope;
+  name2slot_.clear();
+  names_.clear();
+  vars_.clear();
+  epochs_.clear();
+}
+
+int VariableSlots::AddSlot(const std::string& name) {
+  auto it = name2slot_.find(name);
+  if (it != name2slot_.end()) {
+    return it->second;
+  }
+  int slot = static_cast<int>(names_.size());
+  name2slot_.emplace(name, slot);
+  names_.push_back(name);
+  // resolved by the next Resolve
+  vars_.push_back(nullptr);
+  epochs_.clear();
+  return slot;
+}
+
+void VariableSlots::Resolve() {
+  PADDLE_ENFORCE_NOT_NULL(
+      scope_,
+      platform::errors::PreconditionNotMet(
+          "The scope of the variable slots should be set before resolving."));
+  if (IsValid()) {
+    return;
+  }
+  // the epochs are taken before the lookups, so that a variable created
+  // concurrently makes the slots invalid
+  epochs_.clear();
+  for (const Scope* s = scope_; s != nullptr; s = s->parent()) {
+    epochs_.emplace_back(s, s->VarEpoch());
+  }
+  for (size_t i = 0; i < names_.size(); ++i) {
+    vars_[i] = scope_->FindVar(names_[i]);
+  }
+  VLOG(4) << "Resolve " << names_.size() << " variable slots in scope "
+          << scope_;
+}
+
+bool VariableSlots::IsValid() const {
+  if (epochs_.empty()) {
+    return false;
+  }
+  for (auto& item : epochs_) {
+    if (item.first->VarEpoch() != item.second) {
+      return false;
+    }
+  }
+  return true;
+}
+
 std::string GenScopeTreeDebugInfo(Scope* root) {
   std::stringstream os;
 
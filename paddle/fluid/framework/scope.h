@@ -18,6 +18,7 @@ extern "C" {
 #include <xxhash.h>
 }
 
+#include <atomic>
 #include <list>
 #include <memory>
 #include <string>
@@ -129,6 +130,12 @@ class TEST_API Scope {
 
   void SetCanReused(bool can_reused) { can_reused_ = can_reused; }
 
+  // The epoch of the variables of this scope, which increases once a variable
+  // is created, erased or renamed in it, read without locking the scope.
+  uint64_t VarEpoch() const {
+    return var_epoch_.load(std::memory_order_acquire);
+  }
+
  protected:
   struct KeyHasher {
     std::size_t operator()(const std::string& key) const {
@@ -169,6 +176,8 @@ class TEST_API Scope {
   // only for dygraph_to_static
   bool can_reused_{false};
 
+  mutable std::atomic<uint64_t> var_epoch_{0};
+
   DISABLE_COPY_AND_ASSIGN(Scope);
 
  private:
@@ -178,6 +187,53 @@ class TEST_API Scope {
 
 // Generate some debug string about the inherience structure of scope, quite
 // naive.
+/**
+ * @brief VariableSlots resolves the names of the variables of a program in a
+ * scope once into the slots, the integer handles the ops hold, by which the
+ * variables are read during the execution without hashing the names or
+ * locking the scopes. The slots are resolved again once a variable of the
+ * scope or its ancestors is created, erased or renamed.
+ *
+ * The slots are added and resolved by the executor before running the ops,
+ * and read by the ops concurrently.
+ */
+class TEST_API VariableSlots {
+ public:
+  VariableSlots() = default;
+
+  // Drops all the slots and resolves the new ones in scope.
+  void Reset(const Scope* scope);
+
+  // Returns the slot of name, which is added if it is new.
+  int AddSlot(const std::string& name);
+
+  // Resolves the variables of the slots if the scopes changed since the last
+  // resolution.
+  void Resolve();
+
+  // Whether the variables resolved are still the ones of the names.
+  bool IsValid() const;
+
+  // Returns the variable of slot, which is looked up in the scope if it did
+  // not exist when the slots were resolved.
+  Variable* Get(int slot) const {
+    Variable* var = vars_[slot];
+    return var != nullptr ? var : scope_->FindVar(names_[slot]);
+  }
+
+  const Scope* scope() const { return scope_; }
+
+  size_t size() const { return names_.size(); }
+
+ private:
+  const Scope* scope_{nullptr};
+  std::unordered_map<std::string, int> name2slot_;
+  std::vector<std::string> names_;
+  std::vector<Variable*> vars_;
+  // the epochs of the scope and its ancestors at the last resolution
+  std::vector<std::pair<const Scope*, uint64_t>> epochs_;
+};
+
 TEST_API std::string GenScopeTreeDebugInfo(Scope*);
 
 }  // namespace framework
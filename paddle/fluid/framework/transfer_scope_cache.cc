@@ -47,9 +47,14 @@ Scope* TryCreateTransferScope(const phi::KernelKey& type0,
   global_transfer_scope_key()[scope].insert(infer_cache_key);
 
   auto it = global_transfer_data_cache().find(infer_cache_key);
-  if (it != global_transfer_data_cache().end()) {
-    new_scope = global_transfer_data_cache()[infer_cache_key];
+  // The cached transfer scope may be stale if the kids of scope are dropped
+  // without erasing the caches, so it is only reused when still a kid.
+  if (it != global_transfer_data_cache().end() && scope->HasKid(it->second)) {
+    new_scope = it->second;
   } else {
+    if (it != global_transfer_data_cache().end()) {
+      global_transfer_scope_cache().erase(it->second);
+    }
     new_scope = &scope->NewScope();
     global_transfer_data_cache()[infer_cache_key] = new_scope;
   }
@@ -57,5 +62,20 @@ Scope* TryCreateTransferScope(const phi::KernelKey& type0,
   return new_scope;
 }
 
+void EraseTransferScopeCache(const Scope* scope) {
+  auto key_it = global_transfer_scope_key().find(scope);
+  if (key_it == global_transfer_scope_key().end()) {
+    return;
+  }
+  for (auto key : key_it->second) {
+    auto it = global_transfer_data_cache().find(key);
+    if (it != global_transfer_data_cache().end()) {
+      global_transfer_scope_cache().erase(it->second);
+      global_transfer_data_cache().erase(it);
+    }
+  }
+  global_transfer_scope_key().erase(key_it);
+}
+
 }  // namespace framework
 }  // namespace paddle
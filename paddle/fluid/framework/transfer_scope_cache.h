@@ -44,5 +44,9 @@ Scope* TryCreateTransferScope(const phi::KernelKey& type0,
                               const phi::KernelKey& type1,
                               const Scope* scope);
 
+// Drop the transfer scopes created for the kids of scope from the caches, it
+// should be called before the kids of scope are deleted.
+void EraseTransferScopeCache(const Scope* scope);
+
 }  // namespace framework
 }  // namespace paddle
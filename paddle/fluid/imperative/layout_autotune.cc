@@ -20,6 +20,10 @@
 #include "paddle/fluid/imperative/layout_transformer.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_bool(layout_autotune_by_cost);
+
 namespace paddle {
 namespace imperative {
 
@@ -88,6 +92,92 @@ LayoutAutoTune::LayoutAutoTune() {
           << lightly_layout_sensitive_ops_.size();
 }
 
+bool LayoutAutoTune::TuneByCost() const {
+  return FLAGS_layout_autotune_by_cost;
+}
+
+bool LayoutAutoTune::BeginMeasure(const std::string& key,
+                                  DataLayout default_layout) {
+  if (!measuring_) {
+    measuring_ = true;
+    first_measured_key_ = key;
+    measured_layout_ = default_layout;
+    mixed_layouts_ = false;
+    entry_transpose_ms_ = 0;
+    measured_costs_.clear();
+    transpose_back_numel_ = 0;
+    return true;
+  }
+  if (key == first_measured_key_) {
+    ChooseLayoutByCost();
+    return false;
+  }
+  mixed_layouts_ = mixed_layouts_ || default_layout != measured_layout_;
+  return true;
+}
+
+void LayoutAutoTune::AddMeasuredCost(const std::string& op_type,
+                                     const LayoutCost& cost) {
+  if (measured_costs_.empty()) {
+    entry_transpose_ms_ = cost.transpose_ms;
+  }
+  auto& total = measured_costs_[op_type];
+  total.count += cost.count;
+  total.default_ms += cost.default_ms;
+  total.desired_ms += cost.desired_ms;
+  total.transpose_ms += cost.transpose_ms;
+  total.transpose_numel += cost.transpose_numel;
+}
+
+void LayoutAutoTune::AddTransposeBack(int64_t numel) {
+  if (measuring_) {
+    transpose_back_numel_ += numel;
+  }
+}
+
+void LayoutAutoTune::RecordTranspose(const std::string& op_type,
+                                     int64_t numel) {
+  auto& record = transposes_[op_type];
+  record.first += 1;
+  record.second += numel;
+}
+
+void LayoutAutoTune::ChooseLayoutByCost() {
+  measuring_ = false;
+  double default_ms = 0;
+  double desired_ms = 0;
+  double transpose_ms = 0;
+  int64_t transpose_numel = 0;
+  for (const auto& item : measured_costs_) {
+    default_ms += item.second.default_ms;
+    desired_ms += item.second.desired_ms;
+    transpose_ms += item.second.transpose_ms;
+    transpose_numel += item.second.transpose_numel;
+  }
+  // The input of the model is transposed to the desired layout at the first
+  // conv2d, and the output back at the end. The inputs to the lightly layout
+  // sensitive ops between are transposed back and again to the desired
+  // layout, whose costs are estimated by the transposes measured.
+  double ms_per_numel =
+      transpose_numel > 0 ? transpose_ms / transpose_numel : 0.0;
+  desired_ms += 2 * entry_transpose_ms_ +
+                2 * ms_per_numel * static_cast<double>(transpose_back_numel_);
+
+  auto other_layout = measured_layout_ == DataLayout::NCHW ? DataLayout::NHWC
+                                                           : DataLayout::NCHW;
+  VLOG(3) << "LayoutAutoTune measured " << default_ms << " ms in "
+          << common::DataLayoutToString(measured_layout_) << " and "
+          << desired_ms << " ms in "
+          << common::DataLayoutToString(other_layout)
+          << " with the transposes, mixed layouts: " << mixed_layouts_;
+  if (mixed_layouts_ || measured_costs_.empty() || desired_ms >= default_ms) {
+    egr::Controller::Instance().DisableLayoutAutoTune();
+    return;
+  }
+  SetDesiredLayout(other_layout);
+  SetDefaultLayout(measured_layout_);
+}
+
 template <typename VarType>
 paddle::imperative::NameVarMap<VarType> DealHeavilyLayoutSensitive(
     const std::string& op_type,
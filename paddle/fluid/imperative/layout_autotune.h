@@ -15,7 +15,9 @@
 #pragma once
 #include <glog/logging.h>
 
+#include <map>
 #include <memory>
+#include <string>
 #include <unordered_set>
 
 #include "paddle/common/layout.h"
@@ -28,6 +30,17 @@ class Tracer;
 
 using DataLayout = phi::DataLayout;
 
+// The costs of a layout sensitive op measured in the layout of the model and
+// in the other one, in ms.
+struct LayoutCost {
+  int64_t count{0};
+  double default_ms{0};
+  double desired_ms{0};
+  // transposing one input of the op to the other layout
+  double transpose_ms{0};
+  int64_t transpose_numel{0};
+};
+
 class LayoutAutoTune {
  public:
   static LayoutAutoTune& Instance() {
@@ -55,9 +68,56 @@ class LayoutAutoTune {
 
   void SetDefaultLayout(const DataLayout& layout) { default_layout_ = layout; }
 
+  // Whether to choose the desired layout by the costs of the conv2d ops
+  // measured in the first step of the model, see FLAGS_layout_autotune_by_cost.
+  bool TuneByCost() const;
+
+  // Whether the costs are being measured, i.e. the first step is not over.
+  bool IsMeasuring() const { return measuring_; }
+
+  // Begin measuring the costs of a conv2d in default_layout on the inputs of
+  // key. The first step is over when the conv2d first measured, usually the
+  // stem of the model, is met again, and then the desired layout is chosen,
+  // and false is returned.
+  bool BeginMeasure(const std::string& key, DataLayout default_layout);
+
+  void AddMeasuredCost(const std::string& op_type, const LayoutCost& cost);
+
+  // Count the 4-D inputs to the lightly layout sensitive ops in the first
+  // step, which would be transposed back to the default layout and again to
+  // the desired layout, if the layout were tuned.
+  void AddTransposeBack(int64_t numel);
+
+  // Record a transpose inserted by the layout autotune for op_type.
+  void RecordTranspose(const std::string& op_type, int64_t numel);
+
+  const std::map<std::string, LayoutCost>& MeasuredCosts() const {
+    return measured_costs_;
+  }
+
+  // The number of transposes inserted, and the elements transposed, by op.
+  const std::map<std::string, std::pair<int64_t, int64_t>>& TransposeReport()
+      const {
+    return transposes_;
+  }
+
+  void ClearReport() { transposes_.clear(); }
+
  private:
   LayoutAutoTune();
 
+  void ChooseLayoutByCost();
+
+  bool measuring_{false};
+  std::string first_measured_key_;
+  DataLayout measured_layout_{DataLayout::UNDEFINED};
+  // the model mixes the layouts, which is not tuned
+  bool mixed_layouts_{false};
+  double entry_transpose_ms_{0};
+  std::map<std::string, LayoutCost> measured_costs_;
+  int64_t transpose_back_numel_{0};
+  std::map<std::string, std::pair<int64_t, int64_t>> transposes_;
+
   std::unordered_set<std::string> layout_agnostic_ops_{};
 
   std::unordered_set<std::string> heavily_layout_sensitive_ops_{"batch_norm"};
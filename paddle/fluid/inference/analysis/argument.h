@@ -165,6 +165,9 @@ struct Argument {
   DECL_ARGUMENT_FIELD(model_params_path, ModelParamsPath, std::string);
   DECL_ARGUMENT_FIELD(model_from_memory, ModelFromMemory, bool);
   DECL_ARGUMENT_FIELD(save_optimized_model, SaveOptimizedModel, bool);
+  DECL_ARGUMENT_FIELD(optimized_model_fingerprint,
+                      OptimizedModelFingerprint,
+                      std::string);
   DECL_ARGUMENT_FIELD(optim_cache_dir, OptimCacheDir, std::string);
   DECL_ARGUMENT_FIELD(enable_ir_optim, EnableIrOptim, bool);
 
@@ -224,6 +227,9 @@ struct Argument {
   DECL_ARGUMENT_FIELD(use_cutlass, UseCutlass, bool);
   DECL_ARGUMENT_FIELD(use_fc_padding, UseFcPadding, bool);
   DECL_ARGUMENT_FIELD(gpu_device_id, GPUDeviceId, int);
+  DECL_ARGUMENT_FIELD(shared_gpu_params_import_path,
+                      SharedGpuParamsImportPath,
+                      std::string);
 
   // Usually use for trt dynamic shape.
   // TRT will select the best kernel according to opt shape
@@ -252,6 +258,9 @@ struct Argument {
                       TensorRtUseStaticEngine,
                       bool);
   DECL_ARGUMENT_FIELD(tensorrt_use_calib_mode, TensorRtUseCalibMode, bool);
+  DECL_ARGUMENT_FIELD(tensorrt_int8_scale_table_path,
+                      TensorRtInt8ScaleTablePath,
+                      std::string);
   DECL_ARGUMENT_FIELD(tensorrt_use_cuda_graph, TensorRtUseCudaGraph, bool);
   DECL_ARGUMENT_FIELD(tensorrt_use_varseqlen, TensorRtUseOSS, bool);
   DECL_ARGUMENT_FIELD(tensorrt_with_interleaved, TensorRtWithInterleaved, bool);
@@ -270,6 +279,9 @@ struct Argument {
   DECL_ARGUMENT_FIELD(tensorrt_allow_build_at_runtime,
                       TensorRtAllowBuildAtRuntime,
                       bool);
+  DECL_ARGUMENT_FIELD(tensorrt_build_in_background,
+                      TensorRtBuildInBackground,
+                      bool);
   DECL_ARGUMENT_FIELD(tensorrt_use_inspector, TensorRtUseInspector, bool);
   DECL_ARGUMENT_FIELD(tensorrt_inspector_serialize,
                       TensorRtInspectorSerialize,
@@ -388,6 +400,7 @@ struct Argument {
   // Memory optimized related.
   DECL_ARGUMENT_FIELD(enable_memory_optim, EnableMemoryOptim, bool);
   DECL_ARGUMENT_FIELD(trt_engine_memory_sharing, TrtEngineMemorySharing, bool);
+  DECL_ARGUMENT_FIELD(trt_activation_sharing, TrtActivationSharing, bool);
 
   // Indicate which kind of sort algorithm is used for operators, the memory
   // optimization relays on the sort algorithm.
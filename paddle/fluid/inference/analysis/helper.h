@@ -16,11 +16,14 @@ limitations under the License. */
 
 #include <sys/stat.h>
 
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <fstream>
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>  // NOLINT
 #include <typeindex>
 #include <unordered_map>
 #include <utility>
@@ -231,6 +234,10 @@ static std::string GetTrtEngineSerializedPath(const std::string &model_root,
   return model_root + "/trt_serialized_" + engine_key;
 }
 
+static std::string GetTrtTimingCachePath(const std::string &model_root) {
+  return model_root + "/trt_timing_cache";
+}
+
 static std::string GetTrtEngineSerializedData(
     const std::string &model_opt_cache_dir, const std::string &engine_key) {
   std::string trt_serialized_path =
@@ -247,12 +254,30 @@ static std::string GetTrtEngineSerializedData(
   return "";
 }
 
+// The data is written to a temporary file renamed to trt_serialized_path, so
+// that the file is replaced atomically, e.g. while other predictors load it.
 static void SaveTrtEngineSerializedDataToFile(
     const std::string &trt_serialized_path,
     const std::string &engine_serialized_data) {
-  std::ofstream outfile(trt_serialized_path, std::ios::binary);
+  std::string tmp_path =
+      trt_serialized_path + ".tmp" +
+      std::to_string(
+          std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+          std::chrono::steady_clock::now().time_since_epoch().count());
+  std::ofstream outfile(tmp_path, std::ios::binary);
   outfile << engine_serialized_data;
   outfile.close();
+#ifdef _WIN32
+  // rename does not replace an existing file on windows
+  std::remove(trt_serialized_path.c_str());
+#endif
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(outfile) &&
+          std::rename(tmp_path.c_str(), trt_serialized_path.c_str()) == 0,
+      true,
+      platform::errors::Unavailable(
+          "Failed to save the TRT serialized engine to %s.",
+          trt_serialized_path));
 }
 
 }  // namespace analysis
@@ -169,11 +169,20 @@ void IRPassManager::CreatePasses(Argument *argument,
       pass->Set("program",
                 new framework::ProgramDesc *(&argument->main_program()));
       pass->Set("predictor_id", new int(argument->predictor_id()));
-      bool use_calib_mode = argument->tensorrt_use_calib_mode();
+      // the dynamic ranges in the int8 scale table take the place of the
+      // tensorrt calibration
+      const auto &int8_scale_table_path =
+          argument->tensorrt_int8_scale_table_path();
+      bool use_calib_mode = argument->tensorrt_use_calib_mode() &&
+                            int8_scale_table_path.empty();
       pass->Set("use_calib_mode", new bool(use_calib_mode));
+      pass->Set("trt_int8_scale_table_path",
+                new std::string(int8_scale_table_path));
       pass->Set("trt_precision_mode", new int(trt_precision_mode));
       pass->Set("context_memory_sharing",
                 new bool(argument->trt_engine_memory_sharing()));
+      pass->Set("trt_activation_sharing",
+                new bool(argument->trt_activation_sharing()));
       pass->Set("use_cuda_graph",
                 new bool(argument->tensorrt_use_cuda_graph()));
       bool use_static_engine = argument->tensorrt_use_static_engine();
@@ -237,6 +246,8 @@ void IRPassManager::CreatePasses(Argument *argument,
                 new std::string(argument->tensorrt_shape_range_info_path()));
       pass->Set("trt_allow_build_at_runtime",
                 new bool(argument->tensorrt_allow_build_at_runtime()));
+      pass->Set("trt_build_in_background",
+                new bool(argument->tensorrt_build_in_background()));
       pass->Set(
           "trt_disabled_ops",
           new std::vector<std::string>(argument->tensorrt_disabled_ops()));
@@ -16,8 +16,14 @@
 #include "paddle/fluid/inference/analysis/ir_passes/tensorrt_subgraph_pass.h"
 
 #include <fcntl.h>
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <exception>
+#include <future>
+#include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <unordered_set>
 
@@ -38,6 +44,9 @@
 #include "paddle/fluid/inference/utils/io_utils.h"
 #include "paddle/phi/common/backend.h"
 #include "paddle/phi/common/data_type.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_int32(trt_engine_build_num_threads);
 
 namespace paddle {
 namespace inference {
@@ -121,6 +130,32 @@ bool AllNodesLowerToTrtPostProcess(framework::ir::Graph *graph) {
   }
   return all_nodes_offload_to_trt;
 }
+
+// Sets the thresholds in the int8 scale table of the inputs and the outputs of
+// op as the attrs read by the op converter, unless the quantized model has
+// given them.
+void SetInt8ScaleAttrs(const std::map<std::string, float> &thresholds,
+                       framework::OpDesc *op) {
+  for (const auto &input : op->InputNames()) {
+    const auto &args = op->Input(input);
+    if (args.empty() || op->HasAttr(input)) continue;
+    auto it = thresholds.find(args[0]);
+    if (it != thresholds.end()) {
+      op->SetAttr(input, it->second);
+    }
+  }
+  if (op->HasAttr("out_threshold")) return;
+  const auto &outputs = op->OutputNames();
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    const auto &args = op->Output(outputs[i]);
+    auto attr_name = "out_" + std::to_string(i) + "_threshold";
+    if (args.empty() || op->HasAttr(attr_name)) continue;
+    auto it = thresholds.find(args[0]);
+    if (it != thresholds.end()) {
+      op->SetAttr(attr_name, it->second);
+    }
+  }
+}
 }  // namespace
 
 using framework::ir::Node;
@@ -183,12 +218,18 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
   // fluid.
   std::vector<std::string> repetitive_params;
   std::vector<std::string> engine_names;
+  std::vector<TrtEngineBuildTask> build_tasks;
   for (auto *node : graph->Nodes()) {
     if (node->IsOp() && !framework::ir::Agent(node).subgraph()->empty()) {
-      engine_names.push_back(CreateTensorRTOp(
-          node, graph, graph_param_names, &repetitive_params, use_cuda_graph));
+      engine_names.push_back(CreateTensorRTOp(node,
+                                              graph,
+                                              graph_param_names,
+                                              &repetitive_params,
+                                              use_cuda_graph,
+                                              &build_tasks));
     }
   }
+  BuildTrtEngines(build_tasks);
 
   std::unordered_set<const Node *> nodes2remove;
   for (auto *node : graph->Nodes()) {
@@ -279,7 +320,8 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
     framework::ir::Graph *graph,
     const std::vector<std::string> &graph_params,
     std::vector<std::string> *repetitive_params,
-    bool use_cuda_graph) const {
+    bool use_cuda_graph,
+    std::vector<TrtEngineBuildTask> *build_tasks) const {
   auto *op_desc = node->Op();
   auto &subgraph = *framework::ir::Agent(node).subgraph();
   PADDLE_ENFORCE_EQ(subgraph.empty(),
@@ -306,11 +348,27 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
     }
   }
 
+  // The dynamic ranges of the int8 engine are set by the scale table of the
+  // calibration on the native predictor, which is read by the var names before
+  // the renaming below.
+  std::map<std::string, float> int8_scale_table;
+  auto int8_scale_table_path = Get<std::string>("trt_int8_scale_table_path");
+  if (Get<bool>("enable_int8") && !int8_scale_table_path.empty()) {
+    inference::DeserializeInt8ScaleTable(int8_scale_table_path,
+                                         &int8_scale_table);
+  }
+
   for (auto *node : subgraph) {
     auto *new_block_op = new_block->AppendOp();
     auto *op = block_desc.AppendOp();
     *new_block_op->Proto() = *node->Op()->Proto();
     *op->Proto() = *node->Op()->Proto();
+    if (!int8_scale_table.empty()) {
+      framework::OpDesc scaled_op(*op->Proto(), nullptr);
+      SetInt8ScaleAttrs(int8_scale_table, &scaled_op);
+      scaled_op.Flush();
+      *op->Proto() = *scaled_op.Proto();
+    }
   }
 
   // Then, we will use the input_names_with_id and output_names_with_id to
@@ -595,6 +653,10 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
     // so, we cannot enable engine context memory sharing.
     context_memory_sharing = false;
   }
+  // the context memory allocated on every run can not be captured by the
+  // cuda graph of the engine
+  bool context_memory_per_run = context_memory_sharing && !use_cuda_graph &&
+                                Get<bool>("trt_activation_sharing");
   auto enable_low_precision_io = Get<bool>("enable_low_precision_io");
   auto workspace_size = Get<int64_t>("workspace_size");
   auto gpu_device_id = Get<int>("gpu_device_id");
@@ -617,6 +679,8 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   op_desc->SetAttr("origin_output_rank", renamed_output_rank);
   op_desc->SetAttr("parameters", parameters);
   op_desc->SetAttr("allow_build_at_runtime", allow_build_at_runtime);
+  op_desc->SetAttr("build_in_background",
+                   Get<bool>("trt_build_in_background"));
   op_desc->SetAttr("shape_range_info_path", shape_range_info_path);
   op_desc->SetAttr("with_dynamic_shape", with_dynamic_shape);
   op_desc->SetAttr("enable_low_precision_io", enable_low_precision_io);
@@ -713,6 +777,7 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   op_desc->SetAttr("dla_core", dla_core);
   op_desc->SetAttr("disable_trt_plugin_fp16", disable_trt_plugin_fp16);
   op_desc->SetAttr("context_memory_sharing", context_memory_sharing);
+  op_desc->SetAttr("context_memory_per_run", context_memory_per_run);
   std::string trt_engine_serialized_data;
   op_desc->SetAttr("engine_serialized_data", trt_engine_serialized_data);
 
@@ -799,6 +864,7 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   params.tensorrt_transformer_posid = tensorrt_transformer_posid;
   params.tensorrt_transformer_maskid = tensorrt_transformer_maskid;
   params.context_memory_sharing = context_memory_sharing;
+  params.context_memory_per_run = context_memory_per_run;
   params.use_inspector = use_inspector;
   params.engine_info_path = engine_info_path;
   params.enable_low_precision_io = enable_low_precision_io;
@@ -846,35 +912,152 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   LOG(INFO) << "Prepare TRT engine (Optimize model structure, Select OP "
                "kernel etc). This process may cost a lot of time.";
 
-  framework::BlockDesc block_desc_temp(nullptr, block_desc.Proto());
   std::unordered_set<std::string> parameters_set(parameters.begin(),
                                                  parameters.end());
-  inference::Singleton<inference::tensorrt::OpConverter>::Global()
-      .ConvertBlockToTRTEngine(
-          &block_desc_temp,
-          *scope,
-          std::vector<std::string>(input_names.begin(), input_names.end()),
-          parameters_set,
-          output_mapping,
-          trt_engine);
-
+  std::vector<std::string> engine_inputs(input_names.begin(),
+                                         input_names.end());
+  std::string serialized_path;
   if (use_static_engine) {
-    nvinfer1::IHostMemory *serialized_engine_data = trt_engine->Serialize();
-    trt_engine_serialized_data =
-        std::string((const char *)serialized_engine_data->data(),
-                    serialized_engine_data->size());
-    SaveTrtEngineSerializedDataToFile(
-        GetTrtEngineSerializedPath(Get<std::string>("model_opt_cache_dir"),
-                                   engine_key),
-        trt_engine_serialized_data);
-    LOG(INFO) << "Save TRT Optimized Info to "
-              << GetTrtEngineSerializedPath(
-                     Get<std::string>("model_opt_cache_dir"), engine_key);
+    serialized_path = GetTrtEngineSerializedPath(
+        Get<std::string>("model_opt_cache_dir"), engine_key);
   }
+  // the engines are built by BuildTrtEngines after all the subgraphs are
+  // converted to tensorrt_engine ops
+  build_tasks->push_back(TrtEngineBuildTask{
+      trt_engine,
+      [block_proto = *block_desc.Proto(),
+       scope,
+       engine_inputs,
+       parameters_set,
+       output_mapping,
+       trt_engine,
+       serialized_path]() mutable {
+        framework::BlockDesc block_desc_temp(nullptr, &block_proto);
+        inference::Singleton<inference::tensorrt::OpConverter>::Global()
+            .ConvertBlockToTRTEngine(&block_desc_temp,
+                                     *scope,
+                                     engine_inputs,
+                                     parameters_set,
+                                     output_mapping,
+                                     trt_engine);
+        if (!serialized_path.empty()) {
+          nvinfer1::IHostMemory *serialized_engine_data =
+              trt_engine->Serialize();
+          SaveTrtEngineSerializedDataToFile(
+              serialized_path,
+              std::string((const char *)serialized_engine_data->data(),
+                          serialized_engine_data->size()));
+          LOG(INFO) << "Save TRT Optimized Info to " << serialized_path;
+        }
+      }});
 
   return engine_key + std::to_string(predictor_id);
 }
 
+void TensorRtSubgraphPass::BuildTrtEngines(
+    const std::vector<TrtEngineBuildTask> &build_tasks) const {
+  if (build_tasks.empty()) {
+    return;
+  }
+  int num_threads = std::max(
+      1,
+      std::min(FLAGS_trt_engine_build_num_threads,
+               static_cast<int>(build_tasks.size())));
+  VLOG(3) << "Build " << build_tasks.size() << " TensorRT engines with "
+          << num_threads << " threads";
+
+#if IS_TRT_VERSION_GE(8000)
+  // The builders of a thread share a timing cache, so that the tactics of the
+  // same layers are timed once, and the caches of the threads are combined
+  // after the builds. It is loaded from and saved to the optimization cache
+  // directory with the serialized engines.
+  std::string timing_cache_path;
+  if (Get<bool>("use_static_engine")) {
+    timing_cache_path =
+        GetTrtTimingCachePath(Get<std::string>("model_opt_cache_dir"));
+  }
+  std::string timing_cache_data;
+  if (!timing_cache_path.empty() && FileExists(timing_cache_path)) {
+    std::ifstream infile(timing_cache_path, std::ios::in | std::ios::binary);
+    std::stringstream buffer;
+    buffer << infile.rdbuf();
+    timing_cache_data = buffer.str();
+  }
+  tensorrt::infer_ptr<nvinfer1::IBuilder> builder(
+      tensorrt::createInferBuilder(&tensorrt::NaiveLogger::Global()));
+  tensorrt::infer_ptr<nvinfer1::IBuilderConfig> builder_config(
+      builder->createBuilderConfig());
+  std::vector<tensorrt::infer_ptr<nvinfer1::ITimingCache>> timing_caches;
+  for (int i = 0; i < num_threads; ++i) {
+    timing_caches.emplace_back(builder_config->createTimingCache(
+        timing_cache_data.data(), timing_cache_data.size()));
+    if (timing_caches.back() == nullptr) {
+      LOG(WARNING) << "Fail to load the TensorRT timing cache from "
+                   << timing_cache_path << ", a new one is created.";
+      timing_cache_data.clear();
+      timing_caches.back().reset(builder_config->createTimingCache(nullptr, 0));
+    }
+  }
+#endif
+
+  auto predictor_id = tensorrt::TensorRTEngine::predictor_id_per_thread;
+  std::atomic<size_t> next{0};
+  auto worker = [&](int thread_id) {
+    tensorrt::TensorRTEngine::predictor_id_per_thread = predictor_id;
+    for (size_t i = next.fetch_add(1); i < build_tasks.size();
+         i = next.fetch_add(1)) {
+      try {
+#if IS_TRT_VERSION_GE(8000)
+        build_tasks[i].engine->SetTimingCache(timing_caches[thread_id].get());
+#endif
+        build_tasks[i].build();
+      } catch (...) {
+        // stop the other threads
+        next.store(build_tasks.size());
+        throw;
+      }
+    }
+  };
+  if (num_threads == 1) {
+    worker(0);
+  } else {
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < num_threads; ++i) {
+      futures.emplace_back(std::async(std::launch::async, worker, i));
+    }
+    std::exception_ptr error;
+    for (auto &future : futures) {
+      try {
+        future.get();
+      } catch (...) {
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+#if IS_TRT_VERSION_GE(8000)
+  for (int i = 1; i < num_threads; ++i) {
+    if (timing_caches[0] && timing_caches[i]) {
+      timing_caches[0]->combine(*timing_caches[i], false);
+    }
+  }
+  if (!timing_cache_path.empty() && timing_caches[0] != nullptr) {
+    tensorrt::infer_ptr<nvinfer1::IHostMemory> serialized(
+        timing_caches[0]->serialize());
+    SaveTrtEngineSerializedDataToFile(
+        timing_cache_path,
+        std::string(static_cast<const char *>(serialized->data()),
+                    serialized->size()));
+    LOG(INFO) << "Save TRT timing cache to " << timing_cache_path;
+  }
+#endif
+}
+
 }  // namespace analysis
 }  // namespace inference
 }  // namespace paddle
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -34,8 +35,18 @@ class Node;
 
 namespace paddle {
 namespace inference {
+namespace tensorrt {
+class TensorRTEngine;
+}  // namespace tensorrt
+
 namespace analysis {
 
+// The build of the engine of a subgraph, deferred to be run with the others.
+struct TrtEngineBuildTask {
+  tensorrt::TensorRTEngine *engine;
+  std::function<void()> build;
+};
+
 class TensorRtSubgraphPass : public framework::ir::FusePassBase {
  public:
   void ApplyImpl(framework::ir::Graph *graph) const override;
@@ -45,7 +56,11 @@ class TensorRtSubgraphPass : public framework::ir::FusePassBase {
                                framework::ir::Graph *graph,
                                const std::vector<std::string> &graph_params,
                                std::vector<std::string> *repetitive_params,
-                               bool use_cuda_graph) const;
+                               bool use_cuda_graph,
+                               std::vector<TrtEngineBuildTask> *build_tasks)
+      const;
+  void BuildTrtEngines(
+      const std::vector<TrtEngineBuildTask> &build_tasks) const;
   void CleanIntermediateOutputs(framework::ir::Node *node);
 };
 
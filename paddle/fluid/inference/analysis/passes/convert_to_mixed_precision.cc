@@ -14,6 +14,10 @@
 
 #include "paddle/fluid/inference/analysis/passes/convert_to_mixed_precision.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "paddle/fluid/framework/data_type_transform.h"
 #include "paddle/fluid/framework/executor.h"
 #include "paddle/fluid/framework/ir/auto_mixed_precision_pass.h"
 #include "paddle/fluid/framework/ir/constant_folding_pass.h"
@@ -35,7 +39,9 @@ ConvertToMixedPrecisionPass::ConvertToMixedPrecisionPass(
     phi::Backend backend,
     bool keep_io_types,
     const std::unordered_set<std::string>& black_list,
-    const std::unordered_set<std::string>& white_list)
+    const std::unordered_set<std::string>& white_list,
+    const std::vector<MixedPrecisionFeeds>& calibration_feeds,
+    float accuracy_tolerance)
     : model_file_(model_file),
       params_file_(params_file),
       mixed_model_file_(mixed_model_file),
@@ -44,7 +50,9 @@ ConvertToMixedPrecisionPass::ConvertToMixedPrecisionPass(
       backend_(backend),
       keep_io_types_(keep_io_types),
       black_list_(black_list),
-      white_list_(white_list) {
+      white_list_(white_list),
+      calibration_feeds_(calibration_feeds),
+      accuracy_tolerance_(accuracy_tolerance) {
   switch (backend_) {
     case phi::Backend::GPU:
       PADDLE_ENFORCE(mixed_precision_ == phi::DataType::FLOAT16 ||
@@ -92,6 +100,23 @@ void ConvertToMixedPrecisionPass::Run() {
   framework::ir::ConstantFoldingPass constant_folding_pass;
   constant_folding_pass.Apply(main_graph_.get());
 
+  if (!calibration_feeds_.empty()) {
+    SelectOpPrecisionByProfile();
+  }
+  ApplyAutoMixedPrecision(main_graph_.get(),
+                          !keep_io_types_,
+                          !calibration_feeds_.empty());
+
+  framework::ir::IdentityOpCleanPass identity_op_clean_pass;
+  identity_op_clean_pass.Apply(main_graph_.get());
+
+  SaveMixedModel();
+}
+
+void ConvertToMixedPrecisionPass::ApplyAutoMixedPrecision(
+    framework::ir::Graph* graph,
+    bool enable_low_precision_io,
+    bool by_latency) const {
   framework::ir::AutoMixedPrecisionPass auto_mixed_precision_pass;
   auto_mixed_precision_pass.Set("mixed_precision_mode",
                                 new int{static_cast<int>(mixed_precision_)});
@@ -107,13 +132,142 @@ void ConvertToMixedPrecisionPass::Run() {
   auto_mixed_precision_pass.Set(
       "mixed_white_list", new std::unordered_set<std::string>{white_list_});
   auto_mixed_precision_pass.Set("enable_low_precision_io",
-                                new bool{!keep_io_types_});
-  auto_mixed_precision_pass.Apply(main_graph_.get());
+                                new bool{enable_low_precision_io});
+  if (by_latency) {
+    auto_mixed_precision_pass.Set(
+        "mixed_precision_op_latency",
+        new framework::ir::OpPrecisionLatencyMap{op_latency_});
+    auto_mixed_precision_pass.Set(
+        "mixed_precision_cast_latency",
+        new std::unordered_map<std::string, double>{cast_latency_});
+    auto_mixed_precision_pass.Set(
+        "mixed_precision_fp32_ops",
+        new std::unordered_set<std::string>{fp32_ops_});
+  }
+  auto_mixed_precision_pass.Apply(graph);
+}
 
-  framework::ir::IdentityOpCleanPass identity_op_clean_pass;
-  identity_op_clean_pass.Apply(main_graph_.get());
+void ConvertToMixedPrecisionPass::SelectOpPrecisionByProfile() {
+  phi::Place place;
+  if (backend_ == phi::Backend::GPU) {
+    place = phi::GPUPlace(0);
+  } else if (backend_ == phi::Backend::XPU) {
+    place = phi::XPUPlace(0);
+  } else {
+    PADDLE_THROW(platform::errors::Unimplemented(
+        "The mixed precision by the latencies measured is only supported on "
+        "GPU and XPU, not on %s.",
+        experimental::BackendToString(backend_)));
+  }
 
-  SaveMixedModel();
+  framework::ProgramDesc fp32_program;
+  framework::ir::GraphToProgram(*main_graph_, &fp32_program);
+  MixedPrecisionProfiler profiler(
+      fp32_program,
+      &scope_,
+      place,
+      mixed_precision_,
+      [this](framework::ir::Graph* graph) {
+        ApplyAutoMixedPrecision(graph, true, false);
+      });
+  profiler.Profile(calibration_feeds_[0]);
+  op_latency_ = profiler.op_latency();
+  cast_latency_ = profiler.cast_latency();
+
+  std::vector<std::vector<phi::DenseTensor>> references;
+  for (const auto& feeds : calibration_feeds_) {
+    references.push_back(
+        RunProgramOnFeeds(fp32_program, &scope_, place, feeds));
+  }
+
+  // The ops faster at the low precision, from the least gain, are kept at
+  // fp32 in the rounds of doubled sizes until the outputs are accurate enough.
+  std::vector<std::pair<double, std::string>> gains;
+  for (const auto& item : op_latency_) {
+    double gain = item.second.fp32 - item.second.low_precision;
+    if (gain > 0.) {
+      gains.emplace_back(gain, item.first);
+    }
+  }
+  std::sort(gains.begin(), gains.end());
+  size_t kept_num = 0;
+  while (true) {
+    double error = EvaluateMixedPrecision(fp32_program, place, references);
+    LOG(INFO) << "The max relative error of the mixed precision outputs is "
+              << error << " with " << kept_num << " ops kept at fp32.";
+    if (error <= accuracy_tolerance_) break;
+    if (kept_num == gains.size()) {
+      LOG(WARNING) << "The error of the mixed precision outputs is still "
+                   << error << " after all the ops faster at low precision "
+                   << "are kept at fp32, more ops should be in the black list.";
+      break;
+    }
+    size_t next_num = std::min(gains.size(), std::max<size_t>(1, kept_num * 2));
+    for (; kept_num < next_num; ++kept_num) {
+      fp32_ops_.insert(gains[kept_num].second);
+    }
+  }
+}
+
+double ConvertToMixedPrecisionPass::EvaluateMixedPrecision(
+    const framework::ProgramDesc& fp32_program,
+    const phi::Place& place,
+    const std::vector<std::vector<phi::DenseTensor>>& references) {
+  // the pass converts the weights in its scope, so a copy of them is used
+  framework::Scope trial_scope;
+  for (const auto& name : scope_.LocalVarNames()) {
+    auto* var = scope_.FindLocalVar(name);
+    if (var->IsType<phi::DenseTensor>() &&
+        var->Get<phi::DenseTensor>().IsInitialized()) {
+      framework::TensorCopySync(
+          var->Get<phi::DenseTensor>(),
+          platform::CPUPlace(),
+          trial_scope.Var(name)->GetMutable<phi::DenseTensor>());
+    }
+  }
+  framework::ir::Graph graph(fp32_program);
+  graph.SetNotOwned(framework::ir::kParamScopeAttr, &trial_scope);
+  ApplyAutoMixedPrecision(&graph, !keep_io_types_, true);
+  framework::ProgramDesc mixed_program;
+  framework::ir::GraphToProgram(graph, &mixed_program);
+
+  auto ToFloat = [](const phi::DenseTensor& tensor) {
+    phi::DenseTensor out;
+    framework::TransDataType(tensor, framework::proto::VarType::FP32, &out);
+    return out;
+  };
+  double max_error = 0.;
+  for (size_t i = 0; i < calibration_feeds_.size(); ++i) {
+    MixedPrecisionFeeds feeds;
+    for (const auto& item : calibration_feeds_[i]) {
+      auto* var_desc = mixed_program.Block(0).FindVar(item.first);
+      if (var_desc != nullptr &&
+          var_desc->GetDataType() !=
+              framework::TransToProtoVarType(item.second.dtype())) {
+        framework::TransDataType(
+            item.second, var_desc->GetDataType(), &feeds[item.first]);
+      } else {
+        feeds[item.first] = item.second;
+      }
+    }
+    auto outputs = RunProgramOnFeeds(mixed_program, &trial_scope, place, feeds);
+    for (size_t j = 0; j < outputs.size(); ++j) {
+      auto out = ToFloat(outputs[j]);
+      auto ref = ToFloat(references[i][j]);
+      const float* out_data = out.data<float>();
+      const float* ref_data = ref.data<float>();
+      double diff = 0.;
+      double magnitude = 0.;
+      for (int64_t k = 0; k < ref.numel(); ++k) {
+        diff = std::max(
+            diff, std::fabs(static_cast<double>(out_data[k]) - ref_data[k]));
+        magnitude =
+            std::max(magnitude, std::fabs(static_cast<double>(ref_data[k])));
+      }
+      max_error = std::max(max_error, diff / std::max(magnitude, 1e-6));
+    }
+  }
+  return max_error;
 }
 
 void ConvertToMixedPrecisionPass::SaveMixedModel() {
@@ -229,7 +383,9 @@ void ConvertToMixedPrecision(
     phi::Backend backend,
     bool keep_io_types,
     const std::unordered_set<std::string>& black_list,
-    const std::unordered_set<std::string>& white_list) {
+    const std::unordered_set<std::string>& white_list,
+    const std::vector<MixedPrecisionFeeds>& calibration_feeds,
+    float accuracy_tolerance) {
   ConvertToMixedPrecisionPass pass(model_file,
                                    params_file,
                                    mixed_model_file,
@@ -238,7 +394,9 @@ void ConvertToMixedPrecision(
                                    backend,
                                    keep_io_types,
                                    black_list,
-                                   white_list);
+                                   white_list,
+                                   calibration_feeds,
+                                   accuracy_tolerance);
   pass.Run();
 }
 
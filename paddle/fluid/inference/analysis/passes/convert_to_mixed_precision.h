@@ -16,11 +16,14 @@
 
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "paddle/fluid/framework/block_desc.h"
+#include "paddle/fluid/framework/ir/auto_mixed_precision_pass.h"
 #include "paddle/fluid/framework/ir/graph.h"
 #include "paddle/fluid/framework/program_desc.h"
 #include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/inference/analysis/passes/mixed_precision_profiler.h"
 #include "paddle/phi/common/backend.h"
 #include "paddle/phi/common/data_type.h"
 
@@ -28,6 +31,13 @@ namespace paddle {
 namespace inference {
 namespace analysis {
 
+// ConvertToMixedPrecisionPass converts a fp32 model to the mixed precision.
+// By default every op supporting the low precision is converted, except the
+// ones in the black list. If the calibration inputs are given, the ops are
+// converted by their latencies measured on the device for the shapes of the
+// first input instead, and the converted ops of the least gains are kept at
+// fp32 until the errors of the outputs on all the inputs, relative to the max
+// magnitudes of the fp32 ones, are within accuracy_tolerance.
 class ConvertToMixedPrecisionPass {
  public:
   explicit ConvertToMixedPrecisionPass(
@@ -39,7 +49,9 @@ class ConvertToMixedPrecisionPass {
       phi::Backend backend,
       bool keep_io_types,
       const std::unordered_set<std::string>& black_list,
-      const std::unordered_set<std::string>& white_list);
+      const std::unordered_set<std::string>& white_list,
+      const std::vector<MixedPrecisionFeeds>& calibration_feeds = {},
+      float accuracy_tolerance = 1e-2);
 
   void Run();
 
@@ -47,6 +59,18 @@ class ConvertToMixedPrecisionPass {
   void LoadModel();
   void SaveMixedModel();
 
+  void ApplyAutoMixedPrecision(framework::ir::Graph* graph,
+                               bool enable_low_precision_io,
+                               bool by_latency) const;
+
+  void SelectOpPrecisionByProfile();
+
+  // the max error of the mixed precision outputs on the calibration inputs
+  double EvaluateMixedPrecision(
+      const framework::ProgramDesc& fp32_program,
+      const phi::Place& place,
+      const std::vector<std::vector<phi::DenseTensor>>& references);
+
  private:
   std::string model_file_;
   std::string params_file_;
@@ -57,6 +81,12 @@ class ConvertToMixedPrecisionPass {
   bool keep_io_types_;
   std::unordered_set<std::string> black_list_;
   std::unordered_set<std::string> white_list_;
+  std::vector<MixedPrecisionFeeds> calibration_feeds_;
+  float accuracy_tolerance_;
+
+  framework::ir::OpPrecisionLatencyMap op_latency_;
+  std::unordered_map<std::string, double> cast_latency_;
+  std::unordered_set<std::string> fp32_ops_;
 
   framework::Scope scope_;
   std::unique_ptr<framework::ir::Graph> main_graph_{nullptr};
@@ -78,15 +108,18 @@ void InsertCastOp(
     int* suffix,
     std::unordered_map<framework::ir::Node*, framework::ir::Node*>* visited);
 
-void ConvertToMixedPrecision(const std::string& model_file,
-                             const std::string& params_file,
-                             const std::string& mixed_model_file,
-                             const std::string& mixed_params_file,
-                             phi::DataType mixed_precision,
-                             phi::Backend backend,
-                             bool keep_io_types,
-                             const std::unordered_set<std::string>& black_list,
-                             const std::unordered_set<std::string>& white_list);
+void ConvertToMixedPrecision(
+    const std::string& model_file,
+    const std::string& params_file,
+    const std::string& mixed_model_file,
+    const std::string& mixed_params_file,
+    phi::DataType mixed_precision,
+    phi::Backend backend,
+    bool keep_io_types,
+    const std::unordered_set<std::string>& black_list,
+    const std::unordered_set<std::string>& white_list,
+    const std::vector<MixedPrecisionFeeds>& calibration_feeds = {},
+    float accuracy_tolerance = 1e-2);
 
 }  // namespace analysis
 }  // namespace inference
@@ -15,8 +15,11 @@
 #include "paddle/fluid/inference/analysis/passes/ir_params_sync_among_devices_pass.h"
 
 #include <cstdlib>
+#include <map>
+#include <memory>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/framework/framework.pb.h"
@@ -27,6 +30,10 @@
 #include "paddle/fluid/platform/place.h"
 #include "paddle/phi/core/dense_tensor.h"
 
+#if defined(PADDLE_WITH_CUDA) && !defined(_WIN32)
+#include "paddle/fluid/memory/allocation/cuda_ipc_allocator.h"
+#endif
+
 PD_DEFINE_bool(  // NOLINT
     custom_model_save_cpu,
     false,
@@ -38,6 +45,45 @@ namespace paddle {
 namespace inference {
 namespace analysis {
 
+#if defined(PADDLE_WITH_CUDA) && !defined(_WIN32)
+void IrParamsSyncAmongDevicesPass::ImportSharedGpuParam(
+    const std::string &var_name,
+    const IpcParamInfo &info,
+    const platform::Place &place,
+    phi::DenseTensor *tensor) {
+  PADDLE_ENFORCE_EQ(info.device_id,
+                    place.GetDeviceId(),
+                    platform::errors::InvalidArgument(
+                        "The shared param %s is on GPU %d, but the predictor "
+                        "runs on GPU %d.",
+                        var_name,
+                        info.device_id,
+                        place.GetDeviceId()));
+  auto dtype = static_cast<phi::DataType>(info.dtype);
+  PADDLE_ENFORCE_EQ(
+      dtype == tensor->dtype() &&
+          common::make_ddim(info.dims) == tensor->dims() &&
+          info.size == tensor->numel() * phi::SizeOf(dtype),
+      true,
+      platform::errors::InvalidArgument(
+          "The shared param %s of dims [%s] does not match the param of dims "
+          "[%s] in the predictor, please make sure the predictors share the "
+          "same model and config.",
+          var_name,
+          common::make_ddim(info.dims),
+          tensor->dims()));
+  platform::CUDADeviceGuard guard(info.device_id);
+  auto base_ptr = memory::allocation::GetIpcBasePtr(info.handle);
+  void *ptr = reinterpret_cast<char *>(base_ptr.get()) + info.offset;
+  auto holder = std::make_shared<memory::allocation::CudaIpcAllocation>(
+      ptr, info.size, info.device_id, std::move(base_ptr));
+  auto dims = tensor->dims();
+  tensor->clear();
+  tensor->ResetHolderWithType(holder, dtype);
+  tensor->Resize(dims);
+}
+#endif
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 void IrParamsSyncAmongDevicesPass::CopyParamsToGpu(Argument *argument) {
   // The parameters are on the cpu, therefore, synchronization is not necessary.
@@ -78,6 +124,21 @@ void IrParamsSyncAmongDevicesPass::CopyParamsToGpu(Argument *argument) {
     reserve_cpu_weights = true;
   }
 
+  std::map<std::string, IpcParamInfo> shared_params;
+  if (argument->shared_gpu_params_import_path_valid() &&
+      !argument->shared_gpu_params_import_path().empty()) {
+#if defined(PADDLE_WITH_CUDA) && !defined(_WIN32)
+    DeserializeIpcParams(argument->shared_gpu_params_import_path(),
+                         &shared_params);
+    LOG(INFO) << "Bind " << shared_params.size()
+              << " params to the GPU memory shared by "
+              << argument->shared_gpu_params_import_path();
+#else
+    PADDLE_THROW(platform::errors::Unimplemented(
+        "The GPU params can only be shared by cuda ipc on Linux."));
+#endif
+  }
+
   std::unordered_set<std::string> visited;
   for (auto *node : paddle::framework::ir::TopologySortOperations(graph)) {
     if (!node->IsOp()) continue;
@@ -103,6 +164,13 @@ void IrParamsSyncAmongDevicesPass::CopyParamsToGpu(Argument *argument) {
         auto var_data_type = var_node->Var()->GetDataType();
         VLOG(5) << "var_name is " << var_name << ", data type is "
                 << var_data_type;
+#if defined(PADDLE_WITH_CUDA) && !defined(_WIN32)
+        auto shared_param = shared_params.find(var_name);
+        if (shared_param != shared_params.end()) {
+          ImportSharedGpuParam(var_name, shared_param->second, place, t);
+          continue;
+        }
+#endif
         platform::CPUPlace cpu_place;
         phi::DenseTensor temp_tensor;
         temp_tensor.Resize(t->dims());
@@ -18,6 +18,7 @@
 
 #include "paddle/fluid/framework/ir/fuse_pass_base.h"
 #include "paddle/fluid/inference/analysis/analysis_pass.h"
+#include "paddle/fluid/inference/utils/io_utils.h"
 
 namespace paddle {
 namespace inference {
@@ -36,6 +37,14 @@ class IrParamsSyncAmongDevicesPass : public AnalysisPass {
   void CopyParamsToGpu(Argument *argument);
 #endif
 
+#if defined(PADDLE_WITH_CUDA) && !defined(_WIN32)
+  // Binds the parameter to the GPU memory exported by another process.
+  void ImportSharedGpuParam(const std::string &var_name,
+                            const IpcParamInfo &info,
+                            const platform::Place &place,
+                            phi::DenseTensor *tensor);
+#endif
+
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
   void CopyParamsToCustomDevice(Argument *argument);
 #endif
@@ -120,7 +120,7 @@ void MemoryOptimizePass::CollectLifeCycle(
 }
 
 void MemoryOptimizePass::CollectVarMemorySize(
-    Graph* graph, space_table_t* space_table) const {
+    Graph* graph, space_table_t* space_table, bool reuse_trt_engine_io) const {
   const int fake_batch_size = 1;
 
   auto valid_var = [&](framework::ir::Node* node) -> bool {
@@ -137,6 +137,10 @@ void MemoryOptimizePass::CollectVarMemorySize(
                                         "lod_reset",
                                         "fetch",
                                         "share_data"};
+    // the inputs and outputs of the engines are bound to them on every run
+    if (reuse_trt_engine_io) {
+      invalid_op.erase("tensorrt_engine");
+    }
     for (auto* tmp : node->inputs) {
       CHECK(tmp->IsOp());
       std::string op_type = tmp->Op()->Type();
@@ -274,7 +278,10 @@ void MemoryOptimizePass::RunImpl(Argument* argument) {
   std::unordered_map<std::string, int> cluster_size;
 
   CollectLifeCycle(graph, &lifecycles, sort_kind);
-  CollectVarMemorySize(graph, &space_table);
+  CollectVarMemorySize(graph,
+                       &space_table,
+                       argument->trt_activation_sharing_valid() &&
+                           argument->trt_activation_sharing());
   MakeSimpleReusePlan(lifecycles, space_table, &node2cluster, &cluster_size);
 
   auto* pass_res_info = PassResultInfoForRuntime::Instance();
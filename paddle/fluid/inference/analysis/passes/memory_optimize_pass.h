@@ -58,7 +58,8 @@ class MemoryOptimizePass : public AnalysisPass {
       int sort_kind) const;
 
   void CollectVarMemorySize(framework::ir::Graph *graph,
-                            space_table_t *space_table) const;
+                            space_table_t *space_table,
+                            bool reuse_trt_engine_io) const;
 
  public:
   std::string repr() const override;
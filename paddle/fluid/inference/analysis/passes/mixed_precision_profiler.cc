@@ -0,0 +1,280 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/analysis/passes/mixed_precision_profiler.h"
+
+#include <chrono>  // NOLINT
+#include <map>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/convert_utils.h"
+#include "paddle/fluid/framework/data_type_transform.h"
+#include "paddle/fluid/framework/executor.h"
+#include "paddle/fluid/framework/feed_fetch_method.h"
+#include "paddle/fluid/framework/feed_fetch_type.h"
+#include "paddle/fluid/framework/ir/graph_helper.h"
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle {
+namespace inference {
+namespace analysis {
+
+namespace {
+
+using VarType = framework::proto::VarType;
+
+std::vector<phi::DenseTensor> RunProgramInScope(
+    const framework::ProgramDesc& program,
+    framework::Scope* scope,
+    const phi::Place& place,
+    const MixedPrecisionFeeds& feeds) {
+  const auto& block = program.Block(0);
+  std::map<int, std::string> fetch_cols;
+  for (auto* op : block.AllOps()) {
+    if (op->Type() == framework::kFeedOpType) {
+      const auto& name = op->Output("Out")[0];
+      auto it = feeds.find(name);
+      PADDLE_ENFORCE_NE(it,
+                        feeds.end(),
+                        phi::errors::InvalidArgument(
+                            "The calibration input %s is not given.", name));
+      framework::SetFeedVariable(
+          scope, it->second, "feed", PADDLE_GET_CONST(int, op->GetAttr("col")));
+    } else if (op->Type() == framework::kFetchOpType) {
+      fetch_cols[PADDLE_GET_CONST(int, op->GetAttr("col"))] =
+          op->Input("X")[0];
+    }
+  }
+
+  framework::Executor exe(place);
+  exe.Run(program, scope, 0, false, true, {}, true);
+
+  std::vector<phi::DenseTensor> fetches;
+  for (const auto& item : fetch_cols) {
+    const auto& fetch =
+        framework::GetFetchVariable(*scope, "fetch", item.first);
+    phi::DenseTensor cpu_tensor;
+    framework::TensorCopySync(PADDLE_GET_CONST(phi::DenseTensor, fetch),
+                              phi::CPUPlace(),
+                              &cpu_tensor);
+    fetches.emplace_back(std::move(cpu_tensor));
+  }
+  return fetches;
+}
+
+void CopyVarDesc(const framework::VarDesc& src, framework::VarDesc* dst) {
+  dst->SetType(src.GetType());
+  dst->SetDataType(src.GetDataType());
+  dst->SetShape(src.GetShape());
+  dst->SetLoDLevel(src.GetLoDLevel());
+  dst->SetPersistable(src.Persistable());
+}
+
+}  // namespace
+
+std::vector<phi::DenseTensor> RunProgramOnFeeds(
+    const framework::ProgramDesc& program,
+    framework::Scope* param_scope,
+    const phi::Place& place,
+    const MixedPrecisionFeeds& feeds) {
+  auto* scope = &param_scope->NewScope();
+  auto fetches = RunProgramInScope(program, scope, place, feeds);
+  param_scope->DeleteScope(scope);
+  return fetches;
+}
+
+MixedPrecisionProfiler::MixedPrecisionProfiler(
+    const framework::ProgramDesc& program,
+    framework::Scope* param_scope,
+    const phi::Place& place,
+    phi::DataType low_precision,
+    LowPrecisionConverter convert_to_low_precision,
+    int repeat)
+    : program_(program),
+      param_scope_(param_scope),
+      place_(place),
+      low_precision_(low_precision),
+      convert_to_low_precision_(std::move(convert_to_low_precision)),
+      repeat_(repeat) {}
+
+void MixedPrecisionProfiler::Profile(const MixedPrecisionFeeds& feeds) {
+  // the run on the calibration input keeps the real tensors of all the vars in
+  // record_scope
+  auto* record_scope = &param_scope_->NewScope();
+  RunProgramInScope(program_, record_scope, place_, feeds);
+
+  std::unordered_map<int64_t, double> cast_latency_of_numel;
+  for (auto* op : program_.Block(0).AllOps()) {
+    if (op->Type() == framework::kFeedOpType ||
+        op->Type() == framework::kFetchOpType || op->HasAttr("sub_block")) {
+      continue;
+    }
+    framework::ir::OpPrecisionLatency latency;
+    if (ProfileOp(*op, *record_scope, &latency)) {
+      op_latency_[framework::ir::GetOpProfileKey(*op, op->Type())] = latency;
+      VLOG(3) << "Op " << framework::ir::GetOpProfileKey(*op, op->Type())
+              << " takes " << latency.fp32 << " us at fp32, "
+              << latency.low_precision << " us at "
+              << phi::DataTypeToString(low_precision_);
+    }
+
+    for (const auto& name : op->OutputArgumentNames()) {
+      auto* var_desc = program_.Block(0).FindVar(name);
+      auto* var = record_scope->FindLocalVar(name);
+      if (var_desc == nullptr || var_desc->Persistable() || var == nullptr ||
+          !var->IsType<phi::DenseTensor>() ||
+          !var->Get<phi::DenseTensor>().IsInitialized() ||
+          var->Get<phi::DenseTensor>().dtype() != phi::DataType::FLOAT32) {
+        continue;
+      }
+      int64_t numel = var->Get<phi::DenseTensor>().numel();
+      if (cast_latency_of_numel.count(numel) == 0) {
+        cast_latency_of_numel[numel] = ProfileCast(numel);
+      }
+      cast_latency_[name] = cast_latency_of_numel[numel];
+    }
+  }
+  param_scope_->DeleteScope(record_scope);
+  LOG(INFO) << "Profile " << op_latency_.size() << " ops and "
+            << cast_latency_.size() << " casts for the mixed precision.";
+}
+
+bool MixedPrecisionProfiler::ProfileOp(
+    const framework::OpDesc& op_desc,
+    const framework::Scope& record_scope,
+    framework::ir::OpPrecisionLatency* latency) {
+  framework::ProgramDesc op_program;
+  auto* block = op_program.MutableBlock(0);
+  framework::Scope op_scope;
+  auto input_names = op_desc.InputArgumentNames();
+  for (const auto& name : input_names) {
+    auto* var_desc = program_.Block(0).FindVar(name);
+    auto* var = record_scope.FindVar(name);
+    if (var_desc == nullptr || var == nullptr ||
+        !var->IsType<phi::DenseTensor>() ||
+        !var->Get<phi::DenseTensor>().IsInitialized()) {
+      VLOG(4) << "Skip profiling op " << op_desc.Type() << " since its input "
+              << name << " is not a tensor.";
+      return false;
+    }
+    CopyVarDesc(*var_desc, block->Var(name));
+    framework::TensorCopySync(
+        var->Get<phi::DenseTensor>(),
+        place_,
+        op_scope.Var(name)->GetMutable<phi::DenseTensor>());
+  }
+  for (const auto& name : op_desc.OutputArgumentNames()) {
+    auto* var_desc = program_.Block(0).FindVar(name);
+    if (var_desc == nullptr || var_desc->GetType() != VarType::LOD_TENSOR) {
+      return false;
+    }
+    if (block->FindVar(name) == nullptr) {
+      CopyVarDesc(*var_desc, block->Var(name));
+    }
+  }
+  block->AppendOp()->CopyFrom(op_desc);
+
+  try {
+    latency->fp32 = TimeProgram(op_program, &op_scope);
+
+    // The converted op reads the inputs at the low precision. Its
+    // persistable inputs are converted by the pass on cpu, and then copied to
+    // the device again.
+    for (const auto& name : input_names) {
+      if (program_.Block(0).FindVar(name)->Persistable()) {
+        framework::TensorCopySync(
+            record_scope.FindVar(name)->Get<phi::DenseTensor>(),
+            phi::CPUPlace(),
+            op_scope.FindVar(name)->GetMutable<phi::DenseTensor>());
+      }
+    }
+    framework::ir::Graph graph(op_program);
+    graph.SetNotOwned(framework::ir::kParamScopeAttr, &op_scope);
+    convert_to_low_precision_(&graph);
+    framework::ProgramDesc low_precision_program;
+    framework::ir::GraphToProgram(graph, &low_precision_program);
+    for (const auto& name : input_names) {
+      auto* var_desc = low_precision_program.Block(0).FindVar(name);
+      auto* tensor = op_scope.FindVar(name)->GetMutable<phi::DenseTensor>();
+      phi::DenseTensor converted;
+      if (var_desc != nullptr && var_desc->Persistable()) {
+        framework::TensorCopySync(*tensor, place_, &converted);
+      } else if (var_desc != nullptr &&
+                 var_desc->GetDataType() !=
+                     framework::TransToProtoVarType(tensor->dtype())) {
+        framework::TransDataType(*tensor, var_desc->GetDataType(), &converted);
+      } else {
+        continue;
+      }
+      *tensor = converted;
+    }
+    latency->low_precision = TimeProgram(low_precision_program, &op_scope);
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Failed to profile op " << op_desc.Type()
+                 << " for the mixed precision: " << e.what();
+    return false;
+  }
+  return true;
+}
+
+double MixedPrecisionProfiler::ProfileCast(int64_t numel) {
+  framework::ProgramDesc cast_program;
+  auto* block = cast_program.MutableBlock(0);
+  auto* x = block->Var("x");
+  x->SetType(VarType::LOD_TENSOR);
+  x->SetDataType(VarType::FP32);
+  x->SetShape({numel});
+  auto* out = block->Var("out");
+  out->SetType(VarType::LOD_TENSOR);
+  out->SetDataType(framework::TransToProtoVarType(low_precision_));
+  out->SetShape({numel});
+  auto* op = block->AppendOp();
+  op->SetType("cast");
+  op->SetInput("X", {"x"});
+  op->SetOutput("Out", {"out"});
+  op->SetAttr("in_dtype", static_cast<int>(VarType::FP32));
+  op->SetAttr("out_dtype",
+              static_cast<int>(framework::TransToProtoVarType(low_precision_)));
+
+  framework::Scope cast_scope;
+  auto* tensor = cast_scope.Var("x")->GetMutable<phi::DenseTensor>();
+  tensor->Resize({numel});
+  tensor->mutable_data<float>(place_);
+  return TimeProgram(cast_program, &cast_scope);
+}
+
+double MixedPrecisionProfiler::TimeProgram(
+    const framework::ProgramDesc& program, framework::Scope* scope) {
+  framework::Executor exe(place_);
+  auto ctx = exe.Prepare(program, 0, {}, true);
+  auto* dev_ctx = platform::DeviceContextPool::Instance().Get(place_);
+  // the first run also creates the vars and chooses the algorithms
+  exe.RunPreparedContext(ctx.get(), scope, false, true, false);
+  dev_ctx->Wait();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeat_; ++i) {
+    exe.RunPreparedContext(ctx.get(), scope, false, false, false);
+  }
+  dev_ctx->Wait();
+  std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / repeat_;
+}
+
+}  // namespace analysis
+}  // namespace inference
+}  // namespace paddle
@@ -0,0 +1,96 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/fluid/framework/ir/auto_mixed_precision_pass.h"
+#include "paddle/fluid/framework/ir/graph.h"
+#include "paddle/fluid/framework/program_desc.h"
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace inference {
+namespace analysis {
+
+// feed target name -> the input tensor on cpu
+using MixedPrecisionFeeds = std::unordered_map<std::string, phi::DenseTensor>;
+
+// Runs program on place with the params in param_scope, and returns the fetch
+// targets on cpu in the order of their columns.
+std::vector<phi::DenseTensor> RunProgramOnFeeds(
+    const framework::ProgramDesc& program,
+    framework::Scope* param_scope,
+    const phi::Place& place,
+    const MixedPrecisionFeeds& feeds);
+
+// MixedPrecisionProfiler measures the latencies of the ops of a fp32 program
+// on the device, at fp32 and at the low precision, for the shapes and the data
+// the ops see on a calibration input. Every op of the main block is run alone
+// on copies of its real inputs, once as it is and once converted by
+// convert_to_low_precision, which applies the AutoMixedPrecisionPass of the
+// low precision io; and the cast of every fp32 var is measured by its numel.
+class MixedPrecisionProfiler {
+ public:
+  using LowPrecisionConverter = std::function<void(framework::ir::Graph*)>;
+
+  MixedPrecisionProfiler(const framework::ProgramDesc& program,
+                         framework::Scope* param_scope,
+                         const phi::Place& place,
+                         phi::DataType low_precision,
+                         LowPrecisionConverter convert_to_low_precision,
+                         int repeat = 10);
+
+  void Profile(const MixedPrecisionFeeds& feeds);
+
+  const framework::ir::OpPrecisionLatencyMap& op_latency() const {
+    return op_latency_;
+  }
+
+  // var name -> the latency of casting it to the low precision
+  const std::unordered_map<std::string, double>& cast_latency() const {
+    return cast_latency_;
+  }
+
+ private:
+  bool ProfileOp(const framework::OpDesc& op_desc,
+                 const framework::Scope& record_scope,
+                 framework::ir::OpPrecisionLatency* latency);
+
+  double ProfileCast(int64_t numel);
+
+  // the average latency in microseconds of running program in scope
+  double TimeProgram(const framework::ProgramDesc& program,
+                     framework::Scope* scope);
+
+  const framework::ProgramDesc& program_;
+  framework::Scope* param_scope_;
+  phi::Place place_;
+  phi::DataType low_precision_;
+  LowPrecisionConverter convert_to_low_precision_;
+  int repeat_;
+
+  framework::ir::OpPrecisionLatencyMap op_latency_;
+  std::unordered_map<std::string, double> cast_latency_;
+};
+
+}  // namespace analysis
+}  // namespace inference
+}  // namespace paddle
@@ -94,8 +94,6 @@ void SaveOptimizedModelPass::SaveOptimizedModel(Argument* argument) {
     framework::Executor exe(platform::CPUPlace{});
     exe.Run(save_program, &scope, 0, true, true);
   };
-  // TODO(shentanyue01): Setting hardware and version identification for
-  // optimized models.
   auto SerializeProg = [&](const std::string& path) {
     // All persistable var need to be moved to global block
     auto* global_block = optimized_program_desc.MutableBlock(0);
@@ -119,8 +117,20 @@ void SaveOptimizedModelPass::SaveOptimizedModel(Argument* argument) {
     file.close();
   };
 
+  // The fingerprint of the config, the hardware and the version, checked
+  // before the optimized model is loaded.
+  auto SerializeFingerprint = [&](const std::string& path) {
+    std::string save_fingerprint_path = path + "/" + "_optimized.fingerprint";
+    std::ofstream file(save_fingerprint_path.c_str());
+    file << argument->optimized_model_fingerprint();
+    file.close();
+  };
+
   SerializeProg(model_opt_cache_dir);
   SerializeParams(model_opt_cache_dir);
+  if (argument->optimized_model_fingerprint_valid()) {
+    SerializeFingerprint(model_opt_cache_dir);
+  }
   LOG(INFO) << "Optimized model saved to " << model_opt_cache_dir;
 }
 
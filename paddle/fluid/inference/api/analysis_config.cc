@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -21,6 +22,7 @@
 #include "paddle/fluid/inference/api/paddle_analysis_config.h"
 #include "paddle/fluid/inference/api/paddle_pass_builder.h"
 #include "paddle/fluid/inference/utils/table_printer.h"
+#include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/errors.h"
@@ -140,6 +142,40 @@ void AnalysisConfig::Exp_EnableUseCutlass() {
   Update();
 }
 
+void AnalysisConfig::EnableCudaGraph(const std::vector<int> &batch_buckets) {
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_EQ(use_gpu_,
+                    true,
+                    platform::errors::PreconditionNotMet(
+                        "CUDA Graphs are used on GPU, please call EnableUseGpu "
+                        "before EnableCudaGraph."));
+  PADDLE_ENFORCE_EQ(batch_buckets.empty(),
+                    false,
+                    platform::errors::InvalidArgument(
+                        "The batch buckets of CUDA Graphs should not be "
+                        "empty."));
+  for (int bucket : batch_buckets) {
+    PADDLE_ENFORCE_GT(bucket,
+                      0,
+                      platform::errors::InvalidArgument(
+                          "The batch bucket of CUDA Graphs should be larger "
+                          "than 0, but got %d.",
+                          bucket));
+  }
+  cuda_graph_buckets_ = batch_buckets;
+  std::sort(cuda_graph_buckets_.begin(), cuda_graph_buckets_.end());
+  cuda_graph_buckets_.erase(
+      std::unique(cuda_graph_buckets_.begin(), cuda_graph_buckets_.end()),
+      cuda_graph_buckets_.end());
+  use_cuda_graph_ = true;
+#else
+  LOG(ERROR) << "Please use PaddlePaddle with CUDA to EnableCudaGraph().";
+  use_cuda_graph_ = false;
+#endif
+
+  Update();
+}
+
 void AnalysisConfig::SetExecStream(void *stream) {
   PADDLE_ENFORCE_NOT_NULL(
       stream,
@@ -160,6 +196,12 @@ bool AnalysisConfig::external_stream_enabled() const {
   return use_external_stream_;
 }
 
+void AnalysisConfig::EnablePrivateStream(int priority, bool non_blocking) {
+  use_private_stream_ = true;
+  private_stream_priority_ = priority;
+  private_stream_non_blocking_ = non_blocking;
+}
+
 void AnalysisConfig::DisableGpu() {
   use_gpu_ = false;
 
@@ -432,6 +474,7 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(model_from_memory_);  // the memory model reuses prog_file_ and
                                   // params_file_ fields.
   CP_MEMBER(save_optimized_model_);
+  CP_MEMBER(load_optimized_model_);
   CP_MEMBER(opt_cache_dir_);
   CP_MEMBER(prog_file_);
   CP_MEMBER(params_file_);
@@ -440,8 +483,13 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   // GPU related.
   CP_MEMBER(use_gpu_);
   CP_MEMBER(use_cutlass_);
+  CP_MEMBER(use_cuda_graph_);
+  CP_MEMBER(cuda_graph_buckets_);
   CP_MEMBER(use_external_stream_);
   CP_MEMBER(exec_stream_);
+  CP_MEMBER(use_private_stream_);
+  CP_MEMBER(private_stream_priority_);
+  CP_MEMBER(private_stream_non_blocking_);
   CP_MEMBER(use_cudnn_);
   CP_MEMBER(gpu_device_id_);
   CP_MEMBER(memory_pool_init_size_mb_);
@@ -474,12 +522,21 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(tensorrt_transformer_maskid_);
   CP_MEMBER(trt_tuned_dynamic_shape_);
   CP_MEMBER(trt_allow_build_at_runtime_);
+  CP_MEMBER(trt_build_in_background_);
   CP_MEMBER(collect_shape_range_info_);
   CP_MEMBER(shape_range_info_path_);
+  CP_MEMBER(collect_int8_calibration_);
+  CP_MEMBER(int8_calibration_table_path_);
+  CP_MEMBER(int8_calibration_method_);
+  CP_MEMBER(int8_calibration_percentile_);
+  CP_MEMBER(trt_int8_scale_table_path_);
+  CP_MEMBER(shared_gpu_params_export_path_);
+  CP_MEMBER(shared_gpu_params_import_path_);
   CP_MEMBER(trt_use_inspector_);
   CP_MEMBER(trt_inspector_serialize_);
   CP_MEMBER(trt_use_explicit_quantization_);
   CP_MEMBER(trt_engine_memory_sharing_);
+  CP_MEMBER(trt_activation_sharing_);
   CP_MEMBER(trt_engine_memory_sharing_identifier_);
   CP_MEMBER(trt_optimization_level_);
   CP_MEMBER(trt_ops_run_float_);
@@ -544,6 +601,8 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(specify_input_name_);
 
   CP_MEMBER(cpu_math_library_num_threads_);
+  CP_MEMBER(cpu_affinity_);
+  CP_MEMBER(cpu_numa_node_);
 
   CP_MEMBER(serialized_info_cache_);
 
@@ -577,6 +636,11 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(skip_load_params_);
 
   CP_MEMBER(use_new_executor_);
+  CP_MEMBER(multi_stream_num_);
+  CP_MEMBER(retain_tensor_capacity_);
+  CP_MEMBER(tensor_growth_ratio_);
+  CP_MEMBER(tensor_shrink_ratio_);
+  CP_MEMBER(tensor_shrink_window_);
 
   if (use_gpu_) {
     PADDLE_ENFORCE_EQ(use_xpu_,
@@ -1100,11 +1164,14 @@ std::string AnalysisConfig::SerializeInfoCache() {
   ss << prog_file_;
   ss << params_file_;
   ss << save_optimized_model_;
+  ss << load_optimized_model_;
 
   ss << use_gpu_;
   ss << enable_gpu_mixed_;
   ss << use_external_stream_;
   ss << exec_stream_;
+  ss << use_cuda_graph_;
+  for (int bucket : cuda_graph_buckets_) ss << bucket;
   ss << use_fc_padding_;
   ss << gpu_device_id_;
   ss << memory_pool_init_size_mb_;
@@ -1126,6 +1193,7 @@ std::string AnalysisConfig::SerializeInfoCache() {
 
   ss << enable_memory_optim_;
   ss << trt_engine_memory_sharing_;
+  ss << trt_activation_sharing_;
 
   ss << use_mkldnn_;
   ss << mkldnn_cache_capacity_;
@@ -1150,6 +1218,8 @@ std::string AnalysisConfig::SerializeInfoCache() {
 
   ss << specify_input_name_;
   ss << cpu_math_library_num_threads_;
+  for (int cpu : cpu_affinity_) ss << cpu;
+  ss << cpu_numa_node_;
 
   ss << use_lite_;
   ss << use_xpu_;
@@ -1206,6 +1276,24 @@ void AnalysisConfig::SetCpuMathLibraryNumThreads(
   Update();
 }
 
+void AnalysisConfig::SetCpuAffinity(const std::vector<int> &cpu_ids,
+                                    int numa_node) {
+  cpu_affinity_ = cpu_ids;
+  cpu_numa_node_ = numa_node;
+  if (cpu_affinity_.empty() && numa_node >= 0) {
+    cpu_affinity_ = platform::GetNumaNodeCpus(numa_node);
+    PADDLE_ENFORCE_EQ(
+        cpu_affinity_.empty(),
+        false,
+        platform::errors::InvalidArgument(
+            "No cpu is found on numa node %d, please check the numa node or "
+            "specify the cpus.",
+            numa_node));
+  }
+
+  Update();
+}
+
 float AnalysisConfig::fraction_of_gpu_memory_for_pool() const {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   // Get the GPU memory details and calculate the fraction of memory for the
@@ -1235,10 +1323,55 @@ bool AnalysisConfig::enable_memory_optim() const {
   return enable_memory_optim_;
 }
 
+void AnalysisConfig::EnableTensorCapacityRetention(float growth_ratio,
+                                                   float shrink_ratio,
+                                                   int shrink_window) {
+  PADDLE_ENFORCE_GE(growth_ratio,
+                    1.f,
+                    platform::errors::InvalidArgument(
+                        "The growth_ratio of the tensor capacities should be "
+                        "at least 1, but received %f.",
+                        growth_ratio));
+  PADDLE_ENFORCE_GE(shrink_ratio,
+                    1.f,
+                    platform::errors::InvalidArgument(
+                        "The shrink_ratio of the tensor capacities should be "
+                        "at least 1, but received %f.",
+                        shrink_ratio));
+  PADDLE_ENFORCE_GE(shrink_window,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The shrink_window of the tensor capacities should not "
+                        "be negative, but received %d.",
+                        shrink_window));
+  retain_tensor_capacity_ = true;
+  tensor_growth_ratio_ = growth_ratio;
+  tensor_shrink_ratio_ = shrink_ratio;
+  tensor_shrink_window_ = shrink_window;
+}
+
+void AnalysisConfig::EnableMultiStream(int num_streams) {
+  PADDLE_ENFORCE_GE(num_streams,
+                    1,
+                    platform::errors::InvalidArgument(
+                        "The num_streams to overlap the branches on should be "
+                        "at least 1, but received %d.",
+                        num_streams));
+  multi_stream_num_ = num_streams;
+}
+
 bool AnalysisConfig::trt_engine_memory_sharing() const {
   return trt_engine_memory_sharing_;
 }
 
+void AnalysisConfig::EnableTensorRtActivationSharing(bool x) {
+  trt_activation_sharing_ = x;
+}
+
+bool AnalysisConfig::trt_activation_sharing() const {
+  return trt_activation_sharing_;
+}
+
 void AnalysisConfig::SetModelBuffer(const char *prog_buffer,
                                     size_t prog_buffer_size,
                                     const char *param_buffer,
@@ -1322,6 +1455,14 @@ std::string AnalysisConfig::Summary() {
   // cpu info
   os.InsertRow(
       {"cpu_math_thread", std::to_string(cpu_math_library_num_threads_)});
+  if (!cpu_affinity_.empty()) {
+    std::string cpus;
+    for (int cpu : cpu_affinity_) {
+      cpus += (cpus.empty() ? "" : ",") + std::to_string(cpu);
+    }
+    os.InsertRow({"cpu_affinity", cpus});
+    os.InsertRow({"cpu_numa_node", std::to_string(cpu_numa_node_)});
+  }
   os.InsertRow({"enable_mkldnn", use_mkldnn_ ? "true" : "false"});
   os.InsertRow(
       {"mkldnn_cache_capacity", std::to_string(mkldnn_cache_capacity_)});
@@ -1331,6 +1472,13 @@ std::string AnalysisConfig::Summary() {
   os.InsertRow({"use_gpu", use_gpu_ ? "true" : "false"});
   if (use_gpu_) {
     os.InsertRow({"use_cutlass", use_cutlass_ ? "true" : "false"});
+    if (use_cuda_graph_) {
+      std::string buckets;
+      for (int bucket : cuda_graph_buckets_) {
+        buckets += (buckets.empty() ? "" : ",") + std::to_string(bucket);
+      }
+      os.InsertRow({"cuda_graph_buckets", buckets});
+    }
     os.InsertRow({"gpu_device_id", std::to_string(gpu_device_id_)});
     os.InsertRow({"enable_gpu_mixed", std::to_string(enable_gpu_mixed_)});
     os.InsertRow({"mixed_precision_mode",
@@ -1339,6 +1487,10 @@ std::string AnalysisConfig::Summary() {
                   std::to_string(memory_pool_init_size_mb_) + "MB"});
     os.InsertRow(
         {"use_external_stream", use_external_stream_ ? "true" : "false"});
+    if (use_private_stream_) {
+      os.InsertRow({"private_stream_priority",
+                    std::to_string(private_stream_priority_)});
+    }
     os.InsertRow(
         {"thread_local_stream", thread_local_stream_ ? "true" : "false"});
 
@@ -1372,6 +1524,10 @@ std::string AnalysisConfig::Summary() {
                     trt_use_static_engine_ ? "true" : "false"});
       os.InsertRow(
           {"tensorrt_use_calib_mode", trt_use_calib_mode_ ? "true" : "false"});
+      os.InsertRow({"tensorrt_int8_scale_table",
+                    trt_int8_scale_table_path_.empty()
+                        ? "false"
+                        : trt_int8_scale_table_path_});
       os.InsertRow(
           {"tensorrt_use_cuda_graph", trt_use_cuda_graph_ ? "true" : "false"});
 
@@ -1381,6 +1537,8 @@ std::string AnalysisConfig::Summary() {
       os.InsertRow(
           {"tensorrt_tuned_dynamic_shape",
            trt_tuned_dynamic_shape_ ? shape_range_info_path_ : "false"});
+      os.InsertRow({"tensorrt_build_in_background",
+                    trt_build_in_background_ ? "true" : "false"});
 
       os.InsertRow(
           {"tensorrt_use_varseqlen", trt_use_varseqlen_ ? "true" : "false"});
@@ -1395,6 +1553,8 @@ std::string AnalysisConfig::Summary() {
       }
       os.InsertRow({"trt_engine_memory_sharing",
                     trt_engine_memory_sharing_ ? "true" : "false"});
+      os.InsertRow({"trt_activation_sharing",
+                    trt_activation_sharing_ ? "true" : "false"});
       os.InsertRow({"trt_mark_output", trt_mark_output_ ? "true" : "false"});
 #endif
     }
@@ -1465,13 +1625,33 @@ std::string AnalysisConfig::Summary() {
   // ir info
   os.InsertRow(
       {"save_optimized_model", save_optimized_model_ ? "true" : "false"});
+  os.InsertRow(
+      {"load_optimized_model", load_optimized_model_ ? "true" : "false"});
   os.InsertRow({"ir_optim", enable_ir_optim_ ? "true" : "false"});
   os.InsertRow({"ir_debug", ir_debug_ ? "true" : "false"});
   os.InsertRow({"memory_optim", enable_memory_optim_ ? "true" : "false"});
+  if (multi_stream_num_ > 1) {
+    os.InsertRow({"multi_stream_num", std::to_string(multi_stream_num_)});
+  }
+  os.InsertRow({"retain_tensor_capacity",
+                retain_tensor_capacity_ ? "true" : "false"});
   os.InsertRow({"enable_profile", with_profile_ ? "true" : "false"});
   os.InsertRow({"enable_log", with_glog_info_ ? "true" : "false"});
   os.InsertRow({"collect_shape_range_info",
                 collect_shape_range_info_ ? shape_range_info_path_ : "false"});
+  os.InsertRow({"collect_int8_calibration",
+                collect_int8_calibration_ ? int8_calibration_table_path_
+                                          : "false"});
+  if (use_gpu_) {
+    if (!shared_gpu_params_export_path_.empty()) {
+      os.InsertRow(
+          {"export_shared_gpu_params", shared_gpu_params_export_path_});
+    }
+    if (!shared_gpu_params_import_path_.empty()) {
+      os.InsertRow(
+          {"import_shared_gpu_params", shared_gpu_params_import_path_});
+    }
+  }
 
   return os.PrintTable();
 }
@@ -1557,6 +1737,83 @@ bool AnalysisConfig::shape_range_info_collected() const {
   return collect_shape_range_info_;
 }
 
+void AnalysisConfig::CollectInt8Calibration(
+    const std::string &scale_table_path,
+    const std::string &method,
+    float percentile) {
+  PADDLE_ENFORCE_EQ(scale_table_path.empty(),
+                    false,
+                    platform::errors::InvalidArgument(
+                        "The scale_table_path should not be empty, please "
+                        "re-check the argument."));
+  PADDLE_ENFORCE_EQ(
+      method == "entropy" || method == "percentile" || method == "mse",
+      true,
+      platform::errors::InvalidArgument(
+          "The int8 calibration method should be entropy, percentile or mse, "
+          "but got %s.",
+          method));
+  LOG(INFO) << "In CollectInt8Calibration mode, we will collect the "
+               "histograms of all the float tensors in the compute graph "
+               "and calculate their int8 thresholds by the "
+            << method << " method.";
+  collect_int8_calibration_ = true;
+  int8_calibration_table_path_ = scale_table_path;
+  int8_calibration_method_ = method;
+  int8_calibration_percentile_ = percentile;
+}
+
+bool AnalysisConfig::int8_calibration_collected() const {
+  return collect_int8_calibration_;
+}
+
+const std::string &AnalysisConfig::int8_calibration_table_path() const {
+  return int8_calibration_table_path_;
+}
+
+const std::string &AnalysisConfig::int8_calibration_method() const {
+  return int8_calibration_method_;
+}
+
+float AnalysisConfig::int8_calibration_percentile() const {
+  return int8_calibration_percentile_;
+}
+
+void AnalysisConfig::SetTensorRtInt8ScaleTable(
+    const std::string &scale_table_path) {
+  trt_int8_scale_table_path_ = scale_table_path;
+}
+
+const std::string &AnalysisConfig::tensorrt_int8_scale_table_path() const {
+  return trt_int8_scale_table_path_;
+}
+
+void AnalysisConfig::ExportSharedGpuParams(const std::string &ipc_params_path) {
+  PADDLE_ENFORCE_EQ(ipc_params_path.empty(),
+                    false,
+                    platform::errors::InvalidArgument(
+                        "The ipc_params_path should not be empty, please "
+                        "re-check the argument."));
+  shared_gpu_params_export_path_ = ipc_params_path;
+}
+
+const std::string &AnalysisConfig::shared_gpu_params_export_path() const {
+  return shared_gpu_params_export_path_;
+}
+
+void AnalysisConfig::ImportSharedGpuParams(const std::string &ipc_params_path) {
+  PADDLE_ENFORCE_EQ(ipc_params_path.empty(),
+                    false,
+                    platform::errors::InvalidArgument(
+                        "The ipc_params_path should not be empty, please "
+                        "re-check the argument."));
+  shared_gpu_params_import_path_ = ipc_params_path;
+}
+
+const std::string &AnalysisConfig::shared_gpu_params_import_path() const {
+  return shared_gpu_params_import_path_;
+}
+
 void AnalysisConfig::EnableTunedTensorRtDynamicShape(
     const std::string &shape_range_info_path, bool allow_build_at_runtime) {
   shape_range_info_path_ = shape_range_info_path;
@@ -1572,6 +1829,14 @@ bool AnalysisConfig::trt_allow_build_at_runtime() const {
   return trt_allow_build_at_runtime_;
 }
 
+void AnalysisConfig::EnableTensorRtBuildInBackground() {
+  trt_build_in_background_ = true;
+}
+
+bool AnalysisConfig::trt_build_in_background() const {
+  return trt_build_in_background_;
+}
+
 void AnalysisConfig::Exp_DisableMixedPrecisionOps(
     const std::unordered_set<std::string> &black_list) {
   mixed_black_list_ = black_list;
@@ -21,15 +21,18 @@
 #include <fstream>
 #include <memory>
 #include <set>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "paddle/fluid//platform/device/gpu/gpu_types.h"
+#include "paddle/fluid/framework/executor.h"
 #include "paddle/fluid/framework/feed_fetch_method.h"
 #include "paddle/fluid/framework/feed_fetch_type.h"
 #include "paddle/fluid/framework/ir/fuse_pass_base.h"
 #include "paddle/fluid/framework/ir/pass.h"
+#include "paddle/fluid/framework/mmap_params.h"
 #include "paddle/fluid/framework/naive_executor.h"
 #include "paddle/fluid/framework/op_proto_maker.h"
 #include "paddle/fluid/framework/operator.h"
@@ -47,6 +50,7 @@
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/api/paddle_inference_pass.h"
 #include "paddle/fluid/inference/api/resource_manager.h"
+#include "paddle/fluid/inference/io.h"
 #include "paddle/fluid/inference/utils/io_utils.h"
 #include "paddle/fluid/inference/utils/model_utils.h"
 #include "paddle/fluid/inference/utils/singleton.h"
@@ -54,10 +58,12 @@
 #include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/device_context.h"
+#include "paddle/fluid/platform/monitor.h"
 #include "paddle/fluid/platform/place.h"
 #include "paddle/fluid/platform/profiler.h"
 #include "paddle/phi/api/include/context_pool.h"
 #include "paddle/phi/api/include/tensor.h"
+#include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/common/backend.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/common/place.h"
@@ -98,6 +104,10 @@
 #include "paddle/phi/backends/xpu/xpu_info.h"
 #endif
 
+#if defined(PADDLE_WITH_CUDA) && !defined(_WIN32)
+#include "paddle/fluid/memory/allocation/cuda_ipc_allocator.h"
+#endif
+
 #ifdef PADDLE_WITH_NVTX
 #include "paddle/fluid/platform/device/gpu/cuda/cuda_profiler.h"
 #endif
@@ -116,8 +126,11 @@
 #include "paddle/pir/pass/pass_manager.h"
 
 PHI_DECLARE_bool(enable_pir_in_executor);
+PHI_DECLARE_uint64(inference_batched_copy_max_bytes);
 PHI_DECLARE_bool(pir_apply_inplace_pass);
 
+USE_HISTOGRAM_STAT(STAT_predictor_run_us);
+
 namespace paddle {
 namespace {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -173,6 +186,54 @@ void UpdatePrivateDeviceContext(InferGPUContext *gpu_context,
                      .get());
 }
 #endif
+
+#ifdef PADDLE_WITH_XPU
+// The first and the last ops of the main block, by the order they run, using
+// the holders of the intermediate tensors in scope. The holders of the fetch
+// targets live to the end of the run. The programs with sub blocks are not
+// analyzed, since the ops in the sub blocks may use the holders too.
+std::unordered_map<phi::Allocation *, std::pair<size_t, size_t>>
+CollectHolderLifetimes(const framework::ProgramDesc &program,
+                       const framework::Scope &scope,
+                       const std::vector<std::string> &output_names) {
+  std::unordered_map<phi::Allocation *, std::pair<size_t, size_t>> lifetimes;
+  const auto &ops = program.Block(0).AllOps();
+  for (auto *op : ops) {
+    if (op->HasAttr("sub_block")) {
+      return {};
+    }
+  }
+  auto record = [&](const std::string &name, size_t first_op, size_t last_op) {
+    auto *var = scope.FindVar(name);
+    if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+      return;
+    }
+    auto *holder = var->Get<phi::DenseTensor>().Holder().get();
+    if (holder == nullptr) {
+      return;
+    }
+    auto iter = lifetimes.find(holder);
+    if (iter == lifetimes.end()) {
+      lifetimes.emplace(holder, std::make_pair(first_op, last_op));
+    } else {
+      iter->second.first = std::min(iter->second.first, first_op);
+      iter->second.second = std::max(iter->second.second, last_op);
+    }
+  };
+  for (size_t op_idx = 0; op_idx < ops.size(); ++op_idx) {
+    for (const auto &name : ops[op_idx]->InputArgumentNames()) {
+      record(name, op_idx, op_idx);
+    }
+    for (const auto &name : ops[op_idx]->OutputArgumentNames()) {
+      record(name, op_idx, op_idx);
+    }
+  }
+  for (const auto &name : output_names) {
+    record(name, ops.size(), ops.size());
+  }
+  return lifetimes;
+}
+#endif
 }  // namespace
 
 #ifdef PADDLE_WITH_TENSORRT
@@ -352,7 +413,8 @@ bool PaddleTensorToDenseTensor(const PaddleTensor &pt,
 
 AnalysisPredictor::AnalysisPredictor(const AnalysisConfig &config)
     : config_(config) {
-  if (config_.shape_range_info_collected()) {
+  if (config_.shape_range_info_collected() ||
+      config_.int8_calibration_collected()) {
     config_.SwitchIrOptim(false);
   }
   if (config_.new_executor_enabled()) {
@@ -402,6 +464,8 @@ bool AnalysisPredictor::Init(
 
   // no matter with or without MKLDNN
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+  paddle::platform::SetCpuAffinity(config_.cpu_affinity(),
+                                   config_.cpu_numa_node());
 
   if (!PrepareScope(parent_scope)) {
     return false;
@@ -409,6 +473,10 @@ bool AnalysisPredictor::Init(
 
   InitPlace();
 
+  if (!program && config_.load_optimized_model()) {
+    UseOptimizedModel();
+  }
+
   if (!CreateExecutor()) {
     return false;
   }
@@ -427,11 +495,14 @@ bool AnalysisPredictor::Init(
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   // TODO(inference): Now only gpu with external stream support private
   // device_context.
-  if (config_.use_gpu_ && config_.use_external_stream_) {
+  if (config_.use_gpu_ &&
+      (config_.use_external_stream_ || config_.private_stream_enabled())) {
     private_context_ = true;
   }
   if (private_context_) {
-    if (!status_is_cloned_) {
+    // without an external stream, the predictor and every clone of it get a
+    // new stream from the resource manager
+    if (!status_is_cloned_ && config_.use_external_stream_) {
       predictor_stream_ = config_.GetExecStream();
     }
     // NOTE: If the external_stream equals to global_device_contexts's stream,
@@ -446,6 +517,17 @@ bool AnalysisPredictor::Init(
     }
   }
 #endif
+  if (!status_is_cloned_ && !config_.shared_gpu_params_export_path().empty()) {
+    ExportSharedGpuParams();
+  }
+  if (config_.cuda_graph_enabled()) {
+    if (config_.new_executor_enabled()) {
+      LOG(WARNING) << "CUDA Graphs are not used with the new executor.";
+    } else {
+      cuda_graph_cache_ =
+          std::make_unique<CudaGraphCache>(config_.cuda_graph_buckets());
+    }
+  }
 #if defined(PADDLE_WITH_XPU)
   if (config_.use_xpu_ && !config_.use_lite_) {
     private_context_ = true;
@@ -544,8 +626,11 @@ void AnalysisPredictor::InitPlace() {
 
 void AnalysisPredictor::InitResourceManager(void *stream) {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-  predictor_stream_ =
-      ResourceManager::Instance().InitGPUResource(place_, stream);
+  predictor_stream_ = ResourceManager::Instance().InitGPUResource(
+      place_,
+      stream,
+      config_.private_stream_priority(),
+      config_.private_stream_non_blocking());
 #endif
 }
 
@@ -770,6 +855,9 @@ bool AnalysisPredictor::PrepareExecutor() {
     framework::interpreter::ExecutionConfig execution_config;
     execution_config.create_local_scope = false;
     execution_config.used_for_inference = true;
+    execution_config.cpu_affinity = config_.cpu_affinity();
+    execution_config.numa_node = config_.cpu_numa_node();
+    execution_config.num_branch_streams = config_.multi_stream_num();
     auto input_names = GetInputNames();
     execution_config.skip_gc_vars.insert(input_names.begin(),
                                          input_names.end());
@@ -1195,7 +1283,10 @@ void AnalysisPredictor::MkldnnPostReset() {
 bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
                             std::vector<PaddleTensor> *output_data,
                             int batch_size) {
+  STAT_RECORD_LATENCY(STAT_predictor_run_us);
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+  paddle::platform::SetCpuAffinity(config_.cpu_affinity(),
+                                   config_.cpu_numa_node());
 #ifdef PADDLE_WITH_DNNL
   if (config_.use_mkldnn_) MkldnnPreSet(inputs);
 #endif
@@ -1222,6 +1313,9 @@ bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
   if (config_.shape_range_info_collected()) {
     HookCollectShapeRangeInfo();
   }
+  if (config_.int8_calibration_collected()) {
+    HookCollectInt8Calibration();
+  }
 
   if (config_.new_executor_enabled()) {
     executor_->RunInterpreterCore();
@@ -1236,6 +1330,7 @@ bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
     LOG(ERROR) << "fail to get fetches";
     return false;
   }
+  KeepTensorCapacity();
 
   // All the containers in the scope will be hold in inference, but the
   // operators assume that the container will be reset after each batch.
@@ -1264,11 +1359,14 @@ bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
 
 bool AnalysisPredictor::Run(const std::vector<paddle::Tensor> &inputs,
                             std::vector<paddle::Tensor> *outputs) {
+  STAT_RECORD_LATENCY(STAT_predictor_run_us);
   inference::DisplayMemoryInfo(place_, "before run");
   if (private_context_) {
     paddle::platform::DeviceContextPool::SetDeviceContexts(&device_contexts_);
   }
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+  paddle::platform::SetCpuAffinity(config_.cpu_affinity(),
+                                   config_.cpu_numa_node());
 #ifdef PADDLE_WITH_DNNL
   if (config_.use_mkldnn_) MkldnnPreSet(inputs);
 #endif
@@ -1295,6 +1393,9 @@ bool AnalysisPredictor::Run(const std::vector<paddle::Tensor> &inputs,
   if (config_.shape_range_info_collected()) {
     HookCollectShapeRangeInfo();
   }
+  if (config_.int8_calibration_collected()) {
+    HookCollectInt8Calibration();
+  }
 
   if (config_.new_executor_enabled()) {
     executor_->RunInterpreterCore();
@@ -1311,6 +1412,7 @@ bool AnalysisPredictor::Run(const std::vector<paddle::Tensor> &inputs,
     LOG(ERROR) << "fail to get fetches";
     return false;
   }
+  KeepTensorCapacity();
 
   // Fix TensorArray reuse not cleaned bug.
   tensor_array_batch_cleaner_.CollectTensorArrays(sub_scope_);
@@ -1346,9 +1448,17 @@ bool AnalysisPredictor::SetFeed(const std::vector<PaddleTensor> &inputs,
   // Cache the inputs memory for better concurrency performance.
   feed_tensors_.resize(inputs.size());
 
+  std::vector<bool> batched(inputs.size(), false);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (platform::is_gpu_place(place_) &&
+      FLAGS_inference_batched_copy_max_bytes > 0) {
+    CopyFeedsInBatch(inputs, &batched);
+  }
+#endif
+
   for (size_t i = 0; i < inputs.size(); ++i) {
     phi::DenseTensor *input = &feed_tensors_[i];
-    if (!PaddleTensorToDenseTensor(inputs[i], input, place_)) {
+    if (!batched[i] && !PaddleTensorToDenseTensor(inputs[i], input, place_)) {
       return false;
     }
     int idx = -1;
@@ -1412,20 +1522,89 @@ bool AnalysisPredictor::SetFeed(const std::vector<paddle::Tensor> &inputs,
   return true;
 }
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+memory::BatchedMemcpy *AnalysisPredictor::GetBatchedMemcpy() {
+  if (!batched_memcpy_) {
+    platform::DeviceContextPool &pool = platform::DeviceContextPool::Instance();
+    auto *dev_ctx = static_cast<const phi::GPUContext *>(pool.Get(place_));
+    batched_memcpy_ = std::make_unique<memory::BatchedMemcpy>(
+        platform::CUDAPlace(place_.GetDeviceId()), dev_ctx->stream());
+  }
+  return batched_memcpy_.get();
+}
+
+void AnalysisPredictor::CopyFeedsInBatch(
+    const std::vector<PaddleTensor> &inputs, std::vector<bool> *batched) {
+  std::vector<size_t> ids;
+  std::vector<const void *> srcs;
+  std::vector<size_t> sizes;
+  std::vector<phi::DataType> dtypes;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const PaddleTensor &pt = inputs[i];
+    phi::DataType dtype = phi::DataType::UNDEFINED;
+    if (pt.dtype == PaddleDType::INT64) {
+      dtype = phi::DataType::INT64;
+    } else if (pt.dtype == PaddleDType::FLOAT32) {
+      dtype = phi::DataType::FLOAT32;
+    } else if (pt.dtype == PaddleDType::INT32) {
+      dtype = phi::DataType::INT32;
+    } else if (pt.dtype == PaddleDType::FLOAT16) {
+      dtype = phi::DataType::FLOAT16;
+    } else if (pt.dtype == PaddleDType::BFLOAT16) {
+      dtype = phi::DataType::BFLOAT16;
+    }
+    // the others, including the illegal ones, are left to
+    // PaddleTensorToDenseTensor
+    const size_t bytes = pt.data.length();
+    if (dtype == phi::DataType::UNDEFINED || pt.data.data() == nullptr ||
+        bytes == 0 || bytes > FLAGS_inference_batched_copy_max_bytes ||
+        static_cast<size_t>(common::product(common::make_ddim(pt.shape))) *
+                phi::SizeOf(dtype) !=
+            bytes) {
+      continue;
+    }
+    ids.push_back(i);
+    srcs.push_back(pt.data.data());
+    sizes.push_back(bytes);
+    dtypes.push_back(dtype);
+  }
+  if (ids.size() < 2) {
+    return;
+  }
+
+  auto views = GetBatchedMemcpy()->CopyToDevice(srcs, sizes);
+  for (size_t k = 0; k < ids.size(); ++k) {
+    const PaddleTensor &pt = inputs[ids[k]];
+    phi::DenseTensor *t = &feed_tensors_[ids[k]];
+    t->Resize(common::make_ddim(pt.shape));
+    t->ResetHolderWithType(views[k], dtypes[k]);
+    framework::LoD lod;
+    for (auto &level : pt.lod) {
+      lod.emplace_back(level);
+    }
+    t->set_lod(lod);
+    (*batched)[ids[k]] = true;
+  }
+}
+#endif
+
 template <typename T>
 void AnalysisPredictor::GetFetchOne(const phi::DenseTensor &fetch,
-                                    PaddleTensor *output) {
+                                    PaddleTensor *output,
+                                    bool copy_data) {
   // set shape.
   auto shape = common::vectorize(fetch.dims());
   output->shape.assign(shape.begin(), shape.end());
   // set data.
   int num_elems = inference::VecReduceToInt(shape);
   output->data.Resize(num_elems * sizeof(T));
-  paddle::memory::Copy(platform::CPUPlace(),
-                       output->data.data(),
-                       fetch.place(),
-                       fetch.data<T>(),
-                       num_elems * sizeof(T));
+  if (copy_data) {
+    paddle::memory::Copy(platform::CPUPlace(),
+                         output->data.data(),
+                         fetch.place(),
+                         fetch.data<T>(),
+                         num_elems * sizeof(T));
+  }
   // set lod
   output->lod.clear();
   for (auto &level : fetch.lod()) {
@@ -1437,6 +1616,10 @@ bool AnalysisPredictor::GetFetch(std::vector<PaddleTensor> *outputs,
                                  framework::Scope *scope) {
   VLOG(3) << "Predictor::get_fetch";
   outputs->resize(fetches_.size());
+  // the small fetches on gpu are copied in one batch after the loop
+  std::vector<void *> batch_dsts;
+  std::vector<const void *> batch_srcs;
+  std::vector<size_t> batch_sizes;
   for (size_t i = 0; i < fetches_.size(); ++i) {
     int idx = PADDLE_GET_CONST(int, fetches_[i]->GetAttr("col"));
     PADDLE_ENFORCE_EQ(
@@ -1450,27 +1633,44 @@ bool AnalysisPredictor::GetFetch(std::vector<PaddleTensor> *outputs,
     auto type = framework::TransToProtoVarType(t.dtype());
     auto output = &(outputs->at(i));
     output->name = fetches_[idx]->Input("X")[0];
+    const size_t bytes = t.numel() * phi::SizeOf(t.dtype());
+    bool batched = false;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    batched = platform::is_gpu_place(t.place()) && t.place() == place_ &&
+              bytes > 0 && bytes <= FLAGS_inference_batched_copy_max_bytes;
+#endif
     if (type == framework::proto::VarType::FP32) {
-      GetFetchOne<float>(t, output);
+      GetFetchOne<float>(t, output, !batched);
       output->dtype = PaddleDType::FLOAT32;
     } else if (type == framework::proto::VarType::INT64) {
-      GetFetchOne<int64_t>(t, output);
+      GetFetchOne<int64_t>(t, output, !batched);
       output->dtype = PaddleDType::INT64;
     } else if (type == framework::proto::VarType::INT32) {
-      GetFetchOne<int32_t>(t, output);
+      GetFetchOne<int32_t>(t, output, !batched);
       output->dtype = PaddleDType::INT32;
     } else if (type == framework::proto::VarType::FP16) {
-      GetFetchOne<float16>(t, output);
+      GetFetchOne<float16>(t, output, !batched);
       output->dtype = PaddleDType::FLOAT16;
     } else if (type == framework::proto::VarType::BF16) {
-      GetFetchOne<bfloat16>(t, output);
+      GetFetchOne<bfloat16>(t, output, !batched);
       output->dtype = PaddleDType::BFLOAT16;
     } else {
+      batched = false;
       LOG(ERROR)
           << "unknown type, only support float32, float16, bfloat16, int64 and "
              "int32 now.";
     }
+    if (batched) {
+      batch_dsts.push_back(output->data.data());
+      batch_srcs.push_back(t.data());
+      batch_sizes.push_back(bytes);
+    }
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (!batch_srcs.empty()) {
+    GetBatchedMemcpy()->CopyToHost(batch_dsts, batch_srcs, batch_sizes);
   }
+#endif
   return true;
 }
 
@@ -1494,6 +1694,8 @@ void AnalysisPredictor::PrepareArgument() {
   argument_->SetUseCutlass(config_.use_cutlass_);
   argument_->SetUseFcPadding(config_.use_fc_padding());
   argument_->SetGPUDeviceId(config_.gpu_device_id());
+  argument_->SetSharedGpuParamsImportPath(
+      config_.shared_gpu_params_import_path());
   argument_->SetEnableIrOptim(config_.enable_ir_optim_);
   argument_->SetEnableMemoryOptim(config_.enable_memory_optim());
   argument_->SetModelFromMemory(config_.model_from_memory_);
@@ -1501,6 +1703,9 @@ void AnalysisPredictor::PrepareArgument() {
   argument_->SetPredictorID(predictor_id_);
   argument_->SetRootPredictorID(root_predictor_id_);
   argument_->SetSaveOptimizedModel(config_.save_optimized_model_);
+  if (config_.save_optimized_model_) {
+    argument_->SetOptimizedModelFingerprint(GetOptimizedModelFingerprint());
+  }
   argument_->SetOptimCacheDir(config_.opt_cache_dir_);
   if (!config_.model_dir().empty()) {
     argument_->SetModelDir(config_.model_dir());
@@ -1541,16 +1746,21 @@ void AnalysisPredictor::PrepareArgument() {
     argument_->SetTensorRtDLACore(config_.trt_dla_core_);
     argument_->SetTensorRtUseStaticEngine(config_.trt_use_static_engine_);
     argument_->SetTensorRtUseCalibMode(config_.trt_use_calib_mode_);
+    argument_->SetTensorRtInt8ScaleTablePath(
+        config_.tensorrt_int8_scale_table_path());
     argument_->SetTensorRtUseCudaGraph(config_.trt_use_cuda_graph_);
     argument_->SetCloseTrtPluginFp16(config_.disable_trt_plugin_fp16_);
     argument_->SetTensorRtShapeRangeInfoPath(config_.shape_range_info_path());
     argument_->SetTensorRtAllowBuildAtRuntime(
         config_.trt_allow_build_at_runtime());
+    argument_->SetTensorRtBuildInBackground(config_.trt_build_in_background());
     argument_->SetTensorRtUseInspector(config_.trt_use_inspector_);
     argument_->SetTensorRtInspectorSerialize(config_.trt_inspector_serialize_);
     argument_->SetTensorRtUseExplicitQuantization(
         config_.trt_use_explicit_quantization_);
     argument_->SetTrtEngineMemorySharing(config_.trt_engine_memory_sharing());
+    argument_->SetTrtActivationSharing(config_.trt_activation_sharing() &&
+                                       config_.enable_memory_optim());
     argument_->SetTensorRtOptimizationLevel(config_.trt_optimization_level_);
     argument_->SetTensorRtOpsRunFloat(config_.trt_ops_run_float_);
   }
@@ -2219,6 +2429,7 @@ std::unique_ptr<ZeroCopyTensor> AnalysisPredictor::GetOutputTensor(
 }
 
 bool AnalysisPredictor::ZeroCopyRun() {
+  STAT_RECORD_LATENCY(STAT_predictor_run_us);
   inference::DisplayMemoryInfo(place_, "before run");
 #if defined(PADDLE_WITH_DISTRIBUTE) && defined(PADDLE_WITH_PSCORE)
   if (config_.dist_config().use_dist_model()) {
@@ -2231,6 +2442,8 @@ bool AnalysisPredictor::ZeroCopyRun() {
     paddle::platform::DeviceContextPool::SetDeviceContexts(&device_contexts_);
   }
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+  paddle::platform::SetCpuAffinity(config_.cpu_affinity(),
+                                   config_.cpu_numa_node());
 #ifdef PADDLE_WITH_DNNL
   if (config_.use_mkldnn_) {
     std::vector<std::vector<int>> shape_vector;
@@ -2255,6 +2468,9 @@ bool AnalysisPredictor::ZeroCopyRun() {
   if (config_.shape_range_info_collected()) {
     HookCollectShapeRangeInfo();
   }
+  if (config_.int8_calibration_collected()) {
+    HookCollectInt8Calibration();
+  }
 #ifdef PADDLE_WITH_XPU
   InferXPUContext *infer_xpu_ctx = nullptr;
   if (config_.use_xpu_ && !config_.use_lite_) {
@@ -2282,13 +2498,27 @@ bool AnalysisPredictor::ZeroCopyRun() {
 
   if (config_.new_executor_enabled()) {
     executor_->RunInterpreterCore();
-  } else {
+  } else if (cuda_graph_cache_ == nullptr ||
+             !cuda_graph_cache_->Run(executor_.get(),
+                                     sub_scope_,
+                                     GetInputNames(),
+                                     GetOutputNames(),
+                                     place_)) {
     executor_->Run();
   }
   inference::DisplayMemoryInfo(place_, "after run");
+  KeepTensorCapacity();
 
 #ifdef PADDLE_WITH_XPU
   if (config_.use_xpu_ && !config_.use_lite_ && infer_xpu_ctx != nullptr) {
+    if (config_.xpu_config_.l3_autotune_size > 0 &&
+        !infer_xpu_ctx->L3CachePlanned()) {
+      auto lifetimes = CollectHolderLifetimes(
+          *inference_program_, *sub_scope_, GetOutputNames());
+      if (!lifetimes.empty()) {
+        infer_xpu_ctx->SetL3Lifetimes(lifetimes);
+      }
+    }
     infer_xpu_ctx->L3CacheAutotune();
   }
 #endif
@@ -2480,6 +2710,81 @@ bool AnalysisPredictor::ExpRunWithRuntimeConfig(void *config) {
   return false;
 }
 
+void AnalysisPredictor::HookCollectInt8Calibration() {
+  int8_collected_vars_.clear();
+  if (int8_calibration_collector_) return;
+  int8_calibration_collector_ =
+      std::make_unique<inference::Int8CalibrationCollector>(
+          config_.int8_calibration_method(),
+          config_.int8_calibration_percentile());
+  auto hook = [&](const std::string &op_type,
+                  const std::string &input_name,
+                  const paddle::Tensor &var) -> void {
+    auto *var_desc = inference_program_->Block(0).FindVar(input_name);
+    if (var_desc == nullptr || var_desc->Persistable() ||
+        !int8_collected_vars_.insert(input_name).second) {
+      return;
+    }
+    auto *new_var = sub_scope_->GetVar(input_name);
+    if (!new_var || !new_var->IsType<phi::DenseTensor>()) return;
+    if (config_.use_gpu()) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+      paddle::platform::DeviceContextPool::Instance().Get(place_)->Wait();
+#endif
+    }
+    int8_calibration_collector_->Collect(input_name,
+                                         new_var->Get<phi::DenseTensor>());
+  };
+  RegisterInputHook(hook);
+}
+
+void AnalysisPredictor::StatisticInt8Calibration() {
+  auto thresholds = int8_calibration_collector_->ComputeThresholds();
+  inference::SerializeInt8ScaleTable(config_.int8_calibration_table_path(),
+                                     thresholds);
+  LOG(INFO) << "Save the int8 thresholds of " << thresholds.size()
+            << " tensors by the " << config_.int8_calibration_method()
+            << " calibration to " << config_.int8_calibration_table_path();
+}
+
+void AnalysisPredictor::ExportSharedGpuParams() {
+#if defined(PADDLE_WITH_CUDA) && !defined(_WIN32)
+  PADDLE_ENFORCE_EQ(platform::is_gpu_place(place_),
+                    true,
+                    platform::errors::PreconditionNotMet(
+                        "Only the params of a GPU predictor can be shared."));
+  // the params are copied to the GPU on the stream of the device context
+  paddle::platform::DeviceContextPool::Instance().Get(place_)->Wait();
+  std::map<std::string, inference::IpcParamInfo> params;
+  for (auto &var_name : scope_->LocalVarNames()) {
+    auto *var = scope_->FindLocalVar(var_name);
+    if (var == nullptr || !var->IsType<phi::DenseTensor>()) continue;
+    const auto &tensor = var->Get<phi::DenseTensor>();
+    if (!tensor.IsInitialized() || tensor.numel() == 0 ||
+        !platform::is_gpu_place(tensor.place())) {
+      continue;
+    }
+    inference::IpcParamInfo info;
+    ptrdiff_t offset = 0;
+    info.handle =
+        memory::allocation::GetIpcMemHandle(*tensor.Holder(), &offset);
+    info.device_id = tensor.place().GetDeviceId();
+    info.offset = offset + static_cast<int64_t>(tensor.offset());
+    info.size = tensor.numel() * phi::SizeOf(tensor.dtype());
+    info.dtype = static_cast<int>(tensor.dtype());
+    info.dims = common::vectorize<int64_t>(tensor.dims());
+    params[var_name] = info;
+  }
+  inference::SerializeIpcParams(config_.shared_gpu_params_export_path(),
+                                params);
+  LOG(INFO) << "Export " << params.size() << " GPU params to "
+            << config_.shared_gpu_params_export_path();
+#else
+  PADDLE_THROW(platform::errors::Unimplemented(
+      "The GPU params can only be shared by cuda ipc on Linux."));
+#endif
+}
+
 void AnalysisPredictor::StatisticShapeRangeInfo() {
   std::map<std::string, std::vector<int32_t>> min_shapes;
   std::map<std::string, std::vector<int32_t>> max_shapes;
@@ -2541,6 +2846,78 @@ void AnalysisPredictor::StatisticShapeRangeInfo() {
                                      opt_values);
 }
 
+std::string AnalysisPredictor::GetOptimizedModelFingerprint() {
+  auto FileSize = [](const std::string &path) -> int64_t {
+    std::ifstream fin(path, std::ios::binary | std::ios::ate);
+    return fin ? static_cast<int64_t>(fin.tellg()) : -1;
+  };
+  std::stringstream ss;
+  ss << paddle::get_version() << ";";
+  if (!config_.model_dir().empty()) {
+    ss << FileSize(config_.model_dir() + "/__model__") << ";";
+  } else {
+    ss << FileSize(config_.prog_file()) << ";"
+       << FileSize(config_.params_file()) << ";";
+  }
+
+  ss << place_ << ";";
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (platform::is_gpu_place(place_)) {
+    ss << platform::GetGPUComputeCapability(place_.GetDeviceId()) << ";";
+  }
+#endif
+  if (platform::is_cpu_place(place_)) {
+    ss << phi::backends::cpu::MayIUse(phi::backends::cpu::avx2)
+       << phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f)
+       << phi::backends::cpu::MayIUse(phi::backends::cpu::avx512_bf16) << ";";
+  }
+
+  ss << config_.mkldnn_enabled() << config_.enable_gpu_mixed_
+     << static_cast<int>(config_.mixed_precision_mode_)
+     << config_.enable_low_precision_io_ << ";";
+  for (auto &pass : config_.pass_builder()->AllPasses()) {
+    ss << pass << ";";
+  }
+  return std::to_string(std::hash<std::string>()(ss.str()));
+}
+
+bool AnalysisPredictor::UseOptimizedModel() {
+  if (!config_.ir_optim() || config_.model_from_memory() ||
+      config_.tensorrt_engine_enabled() || config_.lite_engine_enabled()) {
+    VLOG(3) << "The optimized model is not used with this config.";
+    return false;
+  }
+  std::string dir = config_.opt_cache_dir_;
+  if (dir.empty()) {
+    dir = config_.model_dir().empty()
+              ? inference::analysis::GetDirRoot(config_.prog_file())
+              : config_.model_dir();
+  }
+  std::string prog_file = dir + "/_optimized.pdmodel";
+  std::string params_file = dir + "/_optimized.pdiparams";
+  std::string fingerprint_file = dir + "/_optimized.fingerprint";
+  if (!inference::analysis::FileExists(prog_file) ||
+      !inference::analysis::FileExists(params_file) ||
+      !inference::analysis::FileExists(fingerprint_file)) {
+    LOG(INFO) << "No optimized model is found in " << dir;
+    return false;
+  }
+  std::string fingerprint;
+  std::ifstream fin(fingerprint_file);
+  fin >> fingerprint;
+  if (fingerprint != GetOptimizedModelFingerprint()) {
+    LOG(WARNING) << "The optimized model in " << dir
+                 << " was saved with another config, hardware or version, "
+                    "and the model will be optimized again.";
+    return false;
+  }
+  config_.model_dir_.clear();
+  config_.SetModel(prog_file, params_file);
+  config_.SwitchIrOptim(false);
+  LOG(INFO) << "Load the optimized model from " << dir;
+  return true;
+}
+
 bool AnalysisPredictor::LoadProgramDesc() {
   // Initialize the inference program
   std::string filename;
@@ -2653,6 +3030,45 @@ uint64_t AnalysisPredictor::TryShrinkMemory() {
   return paddle::memory::Release(place_);
 }
 
+void AnalysisPredictor::KeepTensorCapacity() {
+  // the new executor frees the intermediate tensors in every run, and the
+  // cuda graphs capture the addresses of them
+  if (!config_.retain_tensor_capacity_ || config_.new_executor_enabled() ||
+      cuda_graph_cache_ != nullptr) {
+    return;
+  }
+  if (!tensor_capacity_keeper_.IsInitialized()) {
+    std::set<std::string> io_names;
+    for (auto &name : GetInputNames()) {
+      io_names.insert(name);
+    }
+    for (auto &name : GetOutputNames()) {
+      io_names.insert(name);
+    }
+    std::vector<std::string> var_names;
+    for (auto *var : inference_program_->Block(0).AllVars()) {
+      const std::string &name = var->Name();
+      if (!IsPersistable(var) && !io_names.count(name) &&
+          name != framework::kFeedOpType && name != framework::kFetchOpType) {
+        var_names.push_back(name);
+      }
+    }
+    tensor_capacity_keeper_.Init(executor_->GetScope(),
+                                 var_names,
+                                 place_,
+                                 config_.tensor_growth_ratio_,
+                                 config_.tensor_shrink_ratio_,
+                                 config_.tensor_shrink_window_);
+  }
+  tensor_capacity_keeper_.AfterRun();
+  const auto &stats = tensor_capacity_keeper_.stats();
+  VLOG(3) << "Tensor capacities after run " << stats.runs << ": "
+          << stats.retained_bytes << " bytes retained, "
+          << stats.growth_events << " growth events of " << stats.grown_bytes
+          << " bytes, " << stats.shrink_events << " shrink events of "
+          << stats.shrunk_bytes << " bytes";
+}
+
 void AnalysisPredictor::ClearIntermediateTensor() {
   PADDLE_ENFORCE_NOT_NULL(inference_program_.get(),
                           platform::errors::PreconditionNotMet(
@@ -2743,14 +3159,7 @@ AnalysisPredictor::~AnalysisPredictor() {  // NOLINT
   }
 #endif
   if (sub_scope_) {
-    if (framework::global_transfer_scope_key().find(sub_scope_) !=
-        framework::global_transfer_scope_key().end()) {
-      auto scope_key_set = framework::global_transfer_scope_key()[sub_scope_];
-      for (auto item : scope_key_set) {
-        framework::global_transfer_data_cache().erase(item);
-      }
-      framework::global_transfer_scope_key().erase(sub_scope_);
-    }
+    framework::EraseTransferScopeCache(sub_scope_);
     scope_->DeleteScope(sub_scope_);
   }
 
@@ -2764,6 +3173,9 @@ AnalysisPredictor::~AnalysisPredictor() {  // NOLINT
   if (config_.shape_range_info_collected()) {
     StatisticShapeRangeInfo();
   }
+  if (int8_calibration_collector_) {
+    StatisticInt8Calibration();
+  }
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   if (predictor_stream_ != nullptr) {
     ResourceManager::Instance().DestroyGPUResource(predictor_stream_);
@@ -3267,6 +3679,75 @@ void ConvertToMixedPrecision(const std::string &model_file,
                                                        white_list);
 }
 
+void ConvertToMixedPrecisionByProfile(
+    const std::string &model_file,
+    const std::string &params_file,
+    const std::string &mixed_model_file,
+    const std::string &mixed_params_file,
+    PrecisionType mixed_precision,
+    paddle_infer::PlaceType backend,
+    const std::vector<std::vector<paddle::PaddleTensor>> &calibration_inputs,
+    float accuracy_tolerance,
+    bool keep_io_types,
+    std::unordered_set<std::string> black_list,
+    std::unordered_set<std::string> white_list) {
+  std::vector<paddle::inference::analysis::MixedPrecisionFeeds>
+      calibration_feeds(calibration_inputs.size());
+  for (size_t i = 0; i < calibration_inputs.size(); ++i) {
+    for (const auto &input : calibration_inputs[i]) {
+      PADDLE_ENFORCE_EQ(
+          paddle::PaddleTensorToDenseTensor(
+              input, &calibration_feeds[i][input.name], phi::CPUPlace()),
+          true,
+          paddle::platform::errors::InvalidArgument(
+              "The calibration input %s is not valid.", input.name));
+    }
+  }
+  paddle::inference::analysis::ConvertToMixedPrecision(
+      model_file,
+      params_file,
+      mixed_model_file,
+      mixed_params_file,
+      paddle::ConvertPrecision(mixed_precision),
+      paddle::ConvertBackend(backend),
+      keep_io_types,
+      black_list,
+      white_list,
+      calibration_feeds,
+      accuracy_tolerance);
+}
+
+void ConvertToMmapParams(const std::string &model_file,
+                         const std::string &params_file,
+                         const std::string &mmap_params_file) {
+  paddle::framework::Scope scope;
+  paddle::platform::CPUPlace place;
+  paddle::framework::Executor exe(place);
+  auto program =
+      paddle::inference::Load(&exe, &scope, model_file, params_file);
+
+  std::vector<std::string> names;
+  for (auto *var : program->Block(0).AllVars()) {
+    if (var->Persistable() &&
+        var->GetType() == paddle::framework::proto::VarType::LOD_TENSOR) {
+      names.push_back(var->Name());
+    }
+  }
+  std::sort(names.begin(), names.end());
+  std::vector<const phi::DenseTensor *> tensors;
+  for (auto &name : names) {
+    auto *var = scope.FindVar(name);
+    PADDLE_ENFORCE_NOT_NULL(
+        var,
+        paddle::platform::errors::NotFound(
+            "The param %s is not found in the params file %s.",
+            name,
+            params_file));
+    tensors.push_back(&var->Get<phi::DenseTensor>());
+  }
+  paddle::framework::SaveMmapParams(mmap_params_file, names, tensors);
+}
+
 }  // namespace paddle_infer
 
 namespace paddle_infer {
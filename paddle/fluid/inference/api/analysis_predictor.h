@@ -18,16 +18,21 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "paddle/fluid/framework/naive_executor.h"
 #include "paddle/fluid/framework/op_compatible_info.h"
 #include "paddle/fluid/inference/analysis/analyzer.h"
 #include "paddle/fluid/inference/api/api_impl.h"
+#include "paddle/fluid/inference/api/cuda_graph_cache.h"
 #include "paddle/fluid/inference/api/details/reset_tensor_array.h"
+#include "paddle/fluid/inference/api/details/tensor_capacity_keeper.h"
 #include "paddle/fluid/inference/api/helper.h"
+#include "paddle/fluid/inference/api/int8_calibration_collector.h"
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/api/resource_manager.h"
+#include "paddle/fluid/memory/batched_memcpy.h"
 #include "paddle/fluid/platform/device/gpu/gpu_types.h"
 #include "paddle/fluid/string/printf.h"
 
@@ -267,6 +272,17 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   uint64_t TryShrinkMemory() override;
 
+  ///
+  /// \brief Get the statistics of the tensor capacities kept across the runs,
+  /// which are only collected if the tensor capacity retention is enabled in
+  /// the config.
+  ///
+  /// \return the statistics of the tensor capacities
+  ///
+  const details::TensorCapacityKeeper::Stats &GetTensorCapacityStats() const {
+    return tensor_capacity_keeper_.stats();
+  }
+
   ///
   /// \brief Get the argument used by predictor
   ///
@@ -414,14 +430,37 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   bool GetFetch(std::vector<paddle::Tensor> *outputs, framework::Scope *scope);
 
+  ///
+  /// \brief Keep the capacities of the intermediate tensors after a run, only
+  /// used if the tensor capacity retention is enabled in the config.
+  ///
+  void KeepTensorCapacity();
+
   ///
   /// \brief Get the output data, only used in GetFetch()
   ///
   /// \param[in] tensor for fetch op
   /// \param[out] output_data output tensor
+  /// \param[in] copy_data whether to copy the data, or only to set the shape,
+  /// the lod and the size of the data of output_data
   ///
   template <typename T>
-  void GetFetchOne(const phi::DenseTensor &fetchs, PaddleTensor *output_data);
+  void GetFetchOne(const phi::DenseTensor &fetchs,
+                   PaddleTensor *output_data,
+                   bool copy_data = true);
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  ///
+  /// \brief Copy the small inputs to gpu in one batch, only used in SetFeed()
+  ///
+  /// \param[in] inputs input tensors
+  /// \param[out] batched whether each of inputs is copied into feed_tensors_
+  ///
+  void CopyFeedsInBatch(const std::vector<PaddleTensor> &inputs,
+                        std::vector<bool> *batched);
+
+  memory::BatchedMemcpy *GetBatchedMemcpy();
+#endif
   ///
   /// \brief PreSet for Mkldnn multi-thread and dynamic shape input.
   ///
@@ -490,8 +529,27 @@ class AnalysisPredictor : public PaddlePredictor {
  private:
   void StatisticShapeRangeInfo();
   void HookCollectShapeRangeInfo();
+  void StatisticInt8Calibration();
+  void HookCollectInt8Calibration();
+  ///
+  /// \brief Export the GPU params in the scope to the ipc params file, for
+  /// the predictors of other processes to bind them.
+  ///
+  void ExportSharedGpuParams();
   void InitPlace();
   void InitDeviceContexts();
+  ///
+  /// \brief The fingerprint of the config and the hardware the optimized
+  /// model depends on.
+  ///
+  std::string GetOptimizedModelFingerprint();
+  ///
+  /// \brief Switch the model to the optimized model saved before with the
+  /// fingerprint of the predictor, and turn ir optim off.
+  ///
+  /// \return Whether the optimized model is used
+  ///
+  bool UseOptimizedModel();
   void InitResourceManager(void *stream);
 
 #if defined(PADDLE_WITH_DISTRIBUTE) && defined(PADDLE_WITH_PSCORE)
@@ -548,6 +606,7 @@ class AnalysisPredictor : public PaddlePredictor {
   std::unique_ptr<Argument> argument_;
   Argument::fusion_statis_t fusion_statis_;
   std::unique_ptr<NaiveExecutor> executor_;
+  std::unique_ptr<CudaGraphCache> cuda_graph_cache_;
   platform::Place place_;
   std::shared_ptr<framework::Scope> scope_;
   framework::Scope *sub_scope_{nullptr};
@@ -575,7 +634,12 @@ class AnalysisPredictor : public PaddlePredictor {
   // Memory buffer for feed inputs. The temporary LoDTensor will cause serious
   // concurrency problems, wrong results and memory leak, so cache them.
   std::vector<phi::DenseTensor> feed_tensors_;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // Copies the small feeds and fetches of SetFeed() and GetFetch() in batches.
+  std::unique_ptr<memory::BatchedMemcpy> batched_memcpy_;
+#endif
   details::TensorArrayBatchCleaner tensor_array_batch_cleaner_;
+  details::TensorCapacityKeeper tensor_capacity_keeper_;
   // A mutex help to make Clone thread safe.
   std::mutex clone_mutex_;
   static int clone_num_;
@@ -594,6 +658,12 @@ class AnalysisPredictor : public PaddlePredictor {
   std::map<std::string, std::vector<std::vector<int32_t>>> shape_info_;
   std::map<std::string, std::vector<std::vector<int32_t>>> shape_tensor_value_;
 
+  std::unique_ptr<inference::Int8CalibrationCollector>
+      int8_calibration_collector_;
+  // the vars collected in the current run, since a var is seen by the input
+  // hook of every op reading it
+  std::unordered_set<std::string> int8_collected_vars_;
+
   bool private_context_{false};
   void *predictor_stream_{nullptr};
   std::map<phi::Place, std::shared_future<std::unique_ptr<phi::DeviceContext>>>
@@ -0,0 +1,173 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/cuda_graph_cache.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "glog/logging.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+
+#ifdef PADDLE_WITH_CUDA
+namespace {
+
+// Copy src to the first rows of dst, unless it is there already, and fill
+// the other rows of dst with zeros.
+void PadRows(const phi::DenseTensor &src,
+             phi::DenseTensor *dst,
+             const phi::GPUContext &dev_ctx) {
+  size_t src_bytes = src.numel() * phi::SizeOf(src.dtype());
+  size_t dst_bytes = dst->numel() * phi::SizeOf(dst->dtype());
+  char *dst_data = static_cast<char *>(dst->data());
+  if (src_bytes > 0 && src.data() != dst_data) {
+    memory::Copy(dst->place(),
+                 dst_data,
+                 src.place(),
+                 src.data(),
+                 src_bytes,
+                 dev_ctx.stream());
+  }
+  if (dst_bytes > src_bytes) {
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemsetAsync(
+        dst_data + src_bytes, 0, dst_bytes - src_bytes, dev_ctx.stream()));
+  }
+}
+
+}  // namespace
+#endif
+
+bool CudaGraphCache::Run(framework::NaiveExecutor *executor,
+                         framework::Scope *scope,
+                         const std::vector<std::string> &input_names,
+                         const std::vector<std::string> &output_names,
+                         const phi::Place &place) {
+#ifdef PADDLE_WITH_CUDA
+  if (!platform::is_gpu_place(place) || input_names.empty()) {
+    return false;
+  }
+  int64_t batch = -1;
+  std::vector<phi::DenseTensor *> inputs;
+  for (auto &name : input_names) {
+    auto *var = scope->FindLocalVar(name);
+    if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+      return false;
+    }
+    auto *tensor = var->GetMutable<phi::DenseTensor>();
+    if (!tensor->IsInitialized() || tensor->dims().size() == 0 ||
+        !tensor->lod().empty() || !platform::is_gpu_place(tensor->place())) {
+      return false;
+    }
+    if (batch < 0) {
+      batch = tensor->dims()[0];
+    } else if (tensor->dims()[0] != batch) {
+      return false;
+    }
+    inputs.push_back(tensor);
+  }
+  auto bucket_it =
+      std::lower_bound(batch_buckets_.begin(), batch_buckets_.end(), batch);
+  if (batch <= 0 || bucket_it == batch_buckets_.end()) {
+    return false;
+  }
+  int64_t bucket = *bucket_it;
+
+  std::string key;
+  for (auto *tensor : inputs) {
+    auto dims = tensor->dims();
+    dims[0] = bucket;
+    key += phi::DataTypeToString(tensor->dtype()) + dims.to_str() + ";";
+  }
+  auto &dev_ctx = *static_cast<phi::GPUContext *>(
+      platform::DeviceContextPool::Instance().Get(place));
+
+  auto graph_it = graphs_.find(key);
+  if (graph_it == graphs_.end()) {
+    for (auto *tensor : inputs) {
+      auto dims = tensor->dims();
+      dims[0] = bucket;
+      phi::DenseTensor padded;
+      padded.Resize(dims);
+      padded.mutable_data(place, tensor->dtype());
+      PadRows(*tensor, &padded, dev_ctx);
+      tensor->ShareDataWith(padded);
+    }
+    // the lazy initializations, e.g. of the workspaces and the algorithms of
+    // cudnn, cannot be captured
+    executor->Run();
+    dev_ctx.Wait();
+
+    Graph graph;
+    {
+      // the capturing graph is global
+      static std::mutex capture_mutex;
+      std::lock_guard<std::mutex> guard(capture_mutex);
+      platform::BeginCUDAGraphCapture(phi::GPUPlace(place.GetDeviceId()),
+                                      cudaStreamCaptureModeThreadLocal);
+      try {
+        executor->Run();
+      } catch (...) {
+        platform::EndCUDAGraphCapture();
+        throw;
+      }
+      graph.graph = platform::EndCUDAGraphCapture();
+    }
+    for (auto &name : scope->LocalVarNames()) {
+      auto *var = scope->FindLocalVar(name);
+      if (var->IsType<phi::DenseTensor>() &&
+          var->Get<phi::DenseTensor>().IsInitialized()) {
+        graph.tensors.emplace(name, var->Get<phi::DenseTensor>());
+      }
+    }
+    VLOG(3) << "Capture the CUDA Graph of " << key << " with "
+            << graph.tensors.size() << " tensors";
+    graph_it = graphs_.emplace(key, std::move(graph)).first;
+  } else {
+    auto &tensors = graph_it->second.tensors;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      PadRows(*inputs[i], &tensors.at(input_names[i]), dev_ctx);
+    }
+    for (auto &item : tensors) {
+      scope->FindLocalVar(item.first)
+          ->GetMutable<phi::DenseTensor>()
+          ->ShareDataWith(item.second);
+    }
+  }
+  graph_it->second.graph->Replay();
+
+  if (batch < bucket) {
+    for (auto &name : output_names) {
+      auto *var = scope->FindVar(name);
+      if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+        continue;
+      }
+      auto *tensor = var->GetMutable<phi::DenseTensor>();
+      auto dims = tensor->dims();
+      if (dims.size() > 0 && dims[0] == bucket) {
+        dims[0] = batch;
+        tensor->Resize(dims);
+      }
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+}  // namespace paddle
@@ -0,0 +1,73 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/fluid/framework/naive_executor.h"
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/platform/cuda_graph_with_memory_pool.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+
+///
+/// \brief CudaGraphCache runs the program of a predictor by the CUDA Graphs
+/// captured from it, one for every batch bucket and the other dims and dtypes
+/// of the inputs.
+///
+/// The inputs are padded with zeros to the bucket along the batch dim. A graph
+/// is captured after a warm-up run on the first run of its bucket, and all the
+/// tensors of the scope captured with it, including the padded inputs, are
+/// held with it, so that its addresses, and the memory pool of the memory
+/// allocated in the capture, stay valid for the replays. Before a replay the
+/// inputs are copied into the held inputs, unless they were written to them
+/// in place, and the held tensors are restored to the scope. The outputs with
+/// the batch dim of the bucket are sliced to the batch after a run.
+///
+class CudaGraphCache {
+ public:
+  explicit CudaGraphCache(const std::vector<int>& batch_buckets)
+      : batch_buckets_(batch_buckets) {}
+
+  ///
+  /// \brief Run the program of executor on the inputs in scope by a graph.
+  ///
+  /// \return false if the inputs do not fit a graph, e.g. the batch is larger
+  /// than all the buckets, or the inputs have LoD, and the program is not run.
+  ///
+  bool Run(framework::NaiveExecutor* executor,
+           framework::Scope* scope,
+           const std::vector<std::string>& input_names,
+           const std::vector<std::string>& output_names,
+           const phi::Place& place);
+
+ private:
+#ifdef PADDLE_WITH_CUDA
+  struct Graph {
+    std::unique_ptr<platform::CUDAGraph> graph;
+    std::unordered_map<std::string, phi::DenseTensor> tensors;
+  };
+
+  std::unordered_map<std::string, Graph> graphs_;
+#endif
+  std::vector<int> batch_buckets_;
+};
+
+}  // namespace paddle
@@ -0,0 +1,123 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/details/tensor_capacity_keeper.h"
+
+#include <algorithm>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace details {
+
+// the alignment of the grown holders, the same as the one of the cuda
+// allocator
+constexpr size_t kCapacityAlignment = 256;
+
+void TensorCapacityKeeper::Init(framework::Scope *scope,
+                                const std::vector<std::string> &var_names,
+                                const phi::Place &place,
+                                float growth_ratio,
+                                float shrink_ratio,
+                                int shrink_window) {
+  place_ = place;
+  growth_ratio_ = growth_ratio;
+  shrink_ratio_ = shrink_ratio;
+  shrink_window_ = shrink_window;
+  tensors_.clear();
+  for (auto &name : var_names) {
+    auto *var = scope->FindVar(name);
+    if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+      continue;
+    }
+    TensorState state;
+    state.name = name;
+    state.tensor = var->GetMutable<phi::DenseTensor>();
+    tensors_.emplace_back(std::move(state));
+  }
+  initialized_ = true;
+  VLOG(3) << "Keep the capacities of " << tensors_.size() << " tensors";
+}
+
+void TensorCapacityKeeper::AfterRun() {
+  ++stats_.runs;
+  // the tensors to be given larger holders
+  std::vector<TensorState *> growing;
+  for (auto &state : tensors_) {
+    phi::DenseTensor *tensor = state.tensor;
+    const auto &holder = tensor->Holder();
+    const size_t used_bytes =
+        holder ? tensor->numel() * phi::SizeOf(tensor->dtype()) : 0;
+    if (holder && holder.get() != state.holder && state.capacity > 0 &&
+        holder->size() > state.capacity) {
+      ++stats_.growth_events;
+      stats_.grown_bytes += holder->size() - state.capacity;
+      VLOG(4) << "Tensor " << state.name << " grows from " << state.capacity
+              << " to " << holder->size() << " bytes";
+      // a holder shared with others, e.g. the feeds and the fetches, is kept
+      if (growth_ratio_ > 1.f && holder.use_count() == 1 &&
+          tensor->meta().offset == 0) {
+        growing.push_back(&state);
+      }
+    }
+
+    state.window_max_bytes = std::max(state.window_max_bytes, used_bytes);
+    if (shrink_window_ > 0 && ++state.window_runs >= shrink_window_) {
+      if (holder && holder.use_count() == 1 &&
+          holder->size() > shrink_ratio_ * state.window_max_bytes) {
+        VLOG(4) << "Tensor " << state.name << " shrinks from "
+                << holder->size() << " bytes, which used at most "
+                << state.window_max_bytes << " bytes in the last "
+                << shrink_window_ << " runs";
+        ++stats_.shrink_events;
+        stats_.shrunk_bytes += holder->size();
+        tensor->clear();
+      }
+      state.window_max_bytes = 0;
+      state.window_runs = 0;
+    }
+  }
+
+  if (!growing.empty()) {
+    // the kernels of the run may still be using the old holders
+    if (!platform::is_cpu_place(place_)) {
+      platform::DeviceContextPool::Instance().Get(place_)->Wait();
+    }
+    for (auto *state : growing) {
+      phi::DenseTensor *tensor = state->tensor;
+      const size_t used_bytes =
+          tensor->numel() * phi::SizeOf(tensor->dtype());
+      const size_t bytes = memory::allocation::AlignedSize(
+          static_cast<size_t>(used_bytes * growth_ratio_), kCapacityAlignment);
+      if (tensor->Holder() && bytes > tensor->Holder()->size()) {
+        tensor->ResetHolder(memory::AllocShared(tensor->place(), bytes));
+      }
+    }
+  }
+
+  stats_.retained_bytes = 0;
+  for (auto &state : tensors_) {
+    const auto &holder = state.tensor->Holder();
+    state.holder = holder.get();
+    state.capacity = holder ? holder->size() : 0;
+    stats_.retained_bytes += state.capacity;
+  }
+}
+
+}  // namespace details
+}  // namespace paddle
@@ -0,0 +1,96 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/common/place.h"
+
+namespace phi {
+class Allocation;
+class DenseTensor;
+}  // namespace phi
+
+namespace paddle {
+namespace framework {
+class Scope;
+}  // namespace framework
+}  // namespace paddle
+
+namespace paddle {
+namespace details {
+
+// Keep the capacities of the intermediate tensors of a predictor across the
+// runs of dynamic shapes, which are otherwise reallocated whenever a request
+// is a little larger than all the ones before it.
+//
+// After every run, a tensor whose memory grew in the run is given a new
+// holder of growth_ratio times the bytes it needs, so that the following
+// requests of slightly larger shapes fit in it. If shrink_window > 0, the
+// memory of a tensor larger than shrink_ratio times the most bytes it needed
+// in the last shrink_window runs is released, to be reallocated by the size
+// of the next run.
+struct TensorCapacityKeeper {
+  struct Stats {
+    uint64_t runs{0};
+    // the reallocations of the tensors larger than their last holders
+    uint64_t growth_events{0};
+    uint64_t grown_bytes{0};
+    uint64_t shrink_events{0};
+    uint64_t shrunk_bytes{0};
+    // the bytes of the holders of the tensors after the last run
+    uint64_t retained_bytes{0};
+  };
+
+  // Keeps the tensors of var_names in scope, which should be called after the
+  // variables are created.
+  void Init(framework::Scope *scope,
+            const std::vector<std::string> &var_names,
+            const phi::Place &place,
+            float growth_ratio,
+            float shrink_ratio,
+            int shrink_window);
+
+  bool IsInitialized() const { return initialized_; }
+
+  // Should be called when `Run` finished.
+  void AfterRun();
+
+  const Stats &stats() const { return stats_; }
+
+ private:
+  struct TensorState {
+    std::string name;
+    phi::DenseTensor *tensor{nullptr};
+    // the holder seen after the last run, only used for identity
+    const phi::Allocation *holder{nullptr};
+    size_t capacity{0};
+    size_t window_max_bytes{0};
+    int window_runs{0};
+  };
+
+  bool initialized_{false};
+  phi::Place place_;
+  float growth_ratio_{1.f};
+  float shrink_ratio_{0.f};
+  int shrink_window_{0};
+  std::vector<TensorState> tensors_;
+  Stats stats_;
+};
+
+}  // namespace details
+}  // namespace paddle
@@ -0,0 +1,82 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/details/tensor_capacity_keeper.h"
+
+#include <gtest/gtest.h>
+
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace details {
+
+static phi::DenseTensor *RunWithShape(phi::DenseTensor *tensor,
+                                      int64_t numel) {
+  tensor->Resize({numel});
+  tensor->mutable_data<float>(phi::CPUPlace());
+  return tensor;
+}
+
+TEST(TensorCapacityKeeper, Growth) {
+  framework::Scope scope;
+  auto *tensor = scope.Var("x")->GetMutable<phi::DenseTensor>();
+  TensorCapacityKeeper keeper;
+  keeper.Init(&scope, {"x"}, phi::CPUPlace(), 1.5f, 4.f, 0);
+
+  RunWithShape(tensor, 1000);
+  keeper.AfterRun();
+  EXPECT_EQ(keeper.stats().growth_events, 0UL);
+
+  // grows to 8000 bytes, and is given 12000 bytes aligned to 256
+  RunWithShape(tensor, 2000);
+  keeper.AfterRun();
+  EXPECT_EQ(keeper.stats().growth_events, 1UL);
+  EXPECT_GE(tensor->Holder()->size(), 12032UL);
+  EXPECT_EQ(keeper.stats().retained_bytes, tensor->Holder()->size());
+
+  // fits in the grown holder
+  const auto *holder = tensor->Holder().get();
+  RunWithShape(tensor, 2900);
+  keeper.AfterRun();
+  EXPECT_EQ(tensor->Holder().get(), holder);
+  EXPECT_EQ(keeper.stats().growth_events, 1UL);
+  EXPECT_EQ(keeper.stats().runs, 3UL);
+}
+
+TEST(TensorCapacityKeeper, Shrink) {
+  framework::Scope scope;
+  auto *tensor = scope.Var("x")->GetMutable<phi::DenseTensor>();
+  TensorCapacityKeeper keeper;
+  keeper.Init(&scope, {"x"}, phi::CPUPlace(), 1.f, 4.f, 2);
+
+  RunWithShape(tensor, 1024);
+  keeper.AfterRun();
+  RunWithShape(tensor, 1024);
+  keeper.AfterRun();
+  EXPECT_EQ(keeper.stats().shrink_events, 0UL);
+
+  // uses 16 bytes of the 4096 bytes in both runs of the window
+  RunWithShape(tensor, 4);
+  keeper.AfterRun();
+  EXPECT_TRUE(tensor->Holder() != nullptr);
+  RunWithShape(tensor, 4);
+  keeper.AfterRun();
+  EXPECT_EQ(keeper.stats().shrink_events, 1UL);
+  EXPECT_TRUE(tensor->Holder() == nullptr);
+  EXPECT_EQ(keeper.stats().retained_bytes, 0UL);
+}
+
+}  // namespace details
+}  // namespace paddle
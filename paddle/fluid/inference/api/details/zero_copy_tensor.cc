@@ -809,10 +809,24 @@ void Tensor::ORTCopyToCpu(T *data) const {
 
   if (place_ == PlaceType::kCPU) {
     std::memcpy(static_cast<void *>(data), value.GetTensorData<void *>(), size);
+  } else if (place_ == PlaceType::kGPU) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    // the outputs of the CUDA EP stay on the device till they are read
+    paddle::memory::Copy(paddle::platform::CPUPlace(),
+                         static_cast<void *>(data),
+                         paddle::platform::CUDAPlace(device_),
+                         value.GetTensorData<void>(),
+                         size,
+                         nullptr);
+#else
+    PADDLE_THROW(paddle::platform::errors::Unavailable(
+        "Can not copy the output from GPU because paddle is not compiled "
+        "with CUDA."));
+#endif
   } else {
     PADDLE_THROW(paddle::platform::errors::Unavailable(
-        "CopyToCpu error.The current ONNXRuntime backend doesn't support "
-        "GPU."));
+        "CopyToCpu error.The current ONNXRuntime backend only supports CPU "
+        "and GPU."));
   }
 }
 
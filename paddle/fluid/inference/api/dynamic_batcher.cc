@@ -0,0 +1,396 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/dynamic_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/fluid/inference/utils/io_utils.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+
+namespace paddle {
+
+namespace {
+
+template <typename Visitor>
+void VisitDataType(PaddleDType dtype, Visitor&& visitor) {
+  switch (dtype) {
+    case PaddleDType::FLOAT32:
+      visitor(float());
+      break;
+    case PaddleDType::FLOAT64:
+      visitor(double());
+      break;
+    case PaddleDType::INT64:
+      visitor(int64_t());
+      break;
+    case PaddleDType::INT32:
+      visitor(int32_t());
+      break;
+    case PaddleDType::UINT8:
+      visitor(uint8_t());
+      break;
+    case PaddleDType::INT8:
+      visitor(int8_t());
+      break;
+    case PaddleDType::FLOAT16:
+      visitor(phi::dtype::float16());
+      break;
+    case PaddleDType::BFLOAT16:
+      visitor(phi::dtype::bfloat16());
+      break;
+    case PaddleDType::BOOL:
+      visitor(bool());
+      break;
+    default:
+      PADDLE_THROW(platform::errors::Unimplemented(
+          "Unsupported data type %d in DynamicBatcher.",
+          static_cast<int>(dtype)));
+  }
+}
+
+size_t SizeOfDataType(PaddleDType dtype) {
+  size_t size = 0;
+  VisitDataType(dtype, [&](auto value) { size = sizeof(value); });
+  return size;
+}
+
+int64_t RowNumel(const std::vector<int>& shape) {
+  int64_t numel = 1;
+  for (size_t i = 1; i < shape.size(); ++i) {
+    numel *= shape[i];
+  }
+  return numel;
+}
+
+double MicrosecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+}  // namespace
+
+DynamicBatcher::DynamicBatcher(const AnalysisConfig& config,
+                               const DynamicBatcherOptions& options)
+    : max_batch_size_(options.max_batch_size),
+      max_queue_delay_(options.max_queue_delay_us) {
+  PADDLE_ENFORCE_GT(max_batch_size_,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The max_batch_size of DynamicBatcher should be "
+                        "greater than 0, but got %d.",
+                        max_batch_size_));
+  AnalysisConfig predictor_config(config);
+  // the inputs and outputs are passed by the zero copy tensors
+  predictor_config.SwitchUseFeedFetchOps(false);
+  predictor_ = CreatePaddlePredictor<AnalysisConfig>(predictor_config);
+  PADDLE_ENFORCE_NOT_NULL(predictor_,
+                          platform::errors::PreconditionNotMet(
+                              "Failed to create the predictor of "
+                              "DynamicBatcher."));
+  input_names_ = predictor_->GetInputNames();
+  output_names_ = predictor_->GetOutputNames();
+  on_host_ = !config.use_gpu() && !config.use_xpu() &&
+             !config.use_custom_device() && !config.use_ipu();
+  if (config.tensorrt_engine_enabled() &&
+      !config.shape_range_info_path().empty()) {
+    LoadShapeRange(config.shape_range_info_path());
+  }
+  VLOG(3) << "DynamicBatcher: max_batch_size " << max_batch_size_
+          << ", min_batch_size " << min_batch_size_;
+
+  worker_ = std::thread([this]() { Loop(); });
+}
+
+DynamicBatcher::~DynamicBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  worker_.join();
+}
+
+void DynamicBatcher::LoadShapeRange(const std::string& path) {
+  std::map<std::string, std::vector<int32_t>> min_shape, max_shape, opt_shape,
+      min_value, max_value, opt_value;
+  inference::DeserializeShapeRangeInfo(path,
+                                       &min_shape,
+                                       &max_shape,
+                                       &opt_shape,
+                                       &min_value,
+                                       &max_value,
+                                       &opt_value);
+  // Every input should be in its range, a batch out of the range of any
+  // input makes the engine rebuilt.
+  for (const auto& name : input_names_) {
+    if (min_shape.count(name) == 0 || min_shape[name].empty() ||
+        max_shape[name].empty()) {
+      continue;
+    }
+    min_batch_size_ = std::max(min_batch_size_, min_shape[name][0]);
+    max_batch_size_ = std::min(max_batch_size_, max_shape[name][0]);
+  }
+  PADDLE_ENFORCE_LE(min_batch_size_,
+                    max_batch_size_,
+                    platform::errors::InvalidArgument(
+                        "The batch size range [%d, %d] of the shape range "
+                        "info %s is empty.",
+                        min_batch_size_,
+                        max_batch_size_,
+                        path));
+}
+
+std::future<DynamicBatcherResult> DynamicBatcher::Submit(
+    std::vector<PaddleTensor> inputs) {
+  PADDLE_ENFORCE_EQ(inputs.size(),
+                    input_names_.size(),
+                    platform::errors::InvalidArgument(
+                        "The predictor has %d inputs, but the request has %d.",
+                        input_names_.size(),
+                        inputs.size()));
+  Request request;
+  request.rows = -1;
+  for (const auto& name : input_names_) {
+    auto it = std::find_if(
+        inputs.begin(), inputs.end(), [&](const PaddleTensor& input) {
+          return input.name == name;
+        });
+    PADDLE_ENFORCE_NE(
+        it,
+        inputs.end(),
+        platform::errors::InvalidArgument(
+            "The input %s is not found in the request.", name));
+    PADDLE_ENFORCE_EQ(
+        it->shape.empty() || !it->lod.empty(),
+        false,
+        platform::errors::InvalidArgument(
+            "The input %s of DynamicBatcher should have the batch dim and no "
+            "lod.",
+            name));
+    if (request.rows == -1) {
+      request.rows = it->shape[0];
+    }
+    PADDLE_ENFORCE_EQ(it->shape[0],
+                      request.rows,
+                      platform::errors::InvalidArgument(
+                          "The batch dims of the inputs of a request should "
+                          "be the same, but got %d of input %s and %d.",
+                          it->shape[0],
+                          name,
+                          request.rows));
+    size_t bytes =
+        it->shape[0] * RowNumel(it->shape) * SizeOfDataType(it->dtype);
+    PADDLE_ENFORCE_EQ(it->data.length(),
+                      bytes,
+                      platform::errors::InvalidArgument(
+                          "The data of input %s has %d bytes, but %d bytes "
+                          "are expected by the shape.",
+                          name,
+                          it->data.length(),
+                          bytes));
+    request.inputs.push_back(std::move(*it));
+  }
+  PADDLE_ENFORCE_EQ(
+      request.rows > 0 && request.rows <= max_batch_size_,
+      true,
+      platform::errors::InvalidArgument(
+          "The rows of a request should be in [1, %d], but got %d.",
+          max_batch_size_,
+          request.rows));
+
+  auto future = request.promise.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    request.enqueue_time = Clock::now();
+    queued_rows_ += request.rows;
+    queue_.push_back(std::move(request));
+    ++stats_.num_requests;
+  }
+  cv_.notify_one();
+  return future;
+}
+
+DynamicBatcherStats DynamicBatcher::GetStats() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  DynamicBatcherStats stats = stats_;
+  stats.queue_size = queue_.size();
+  return stats;
+}
+
+bool DynamicBatcher::Mergeable(const Request& first,
+                               const Request& request) const {
+  for (size_t i = 0; i < first.inputs.size(); ++i) {
+    const auto& lhs = first.inputs[i];
+    const auto& rhs = request.inputs[i];
+    if (lhs.dtype != rhs.dtype || lhs.shape.size() != rhs.shape.size() ||
+        !std::equal(
+            lhs.shape.begin() + 1, lhs.shape.end(), rhs.shape.begin() + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void DynamicBatcher::Loop() {
+  while (true) {
+    std::vector<Request> batch;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      auto deadline = queue_.front().enqueue_time + max_queue_delay_;
+      cv_.wait_until(lock, deadline, [this]() {
+        return stop_ || queued_rows_ >= max_batch_size_;
+      });
+      int rows = 0;
+      while (!queue_.empty() && rows + queue_.front().rows <= max_batch_size_ &&
+             (batch.empty() || Mergeable(batch.front(), queue_.front()))) {
+        Request& request = queue_.front();
+        double queue_time = MicrosecondsSince(request.enqueue_time);
+        stats_.total_queue_time_us += queue_time;
+        stats_.max_queue_time_us =
+            std::max(stats_.max_queue_time_us, queue_time);
+        rows += request.rows;
+        queued_rows_ -= request.rows;
+        batch.push_back(std::move(request));
+        queue_.pop_front();
+      }
+    }
+    RunBatch(&batch);
+  }
+}
+
+void DynamicBatcher::RunBatch(std::vector<Request>* batch) {
+  int rows = 0;
+  for (const auto& request : *batch) {
+    rows += request.rows;
+  }
+  int batch_size = std::max(rows, min_batch_size_);
+  auto start = Clock::now();
+  try {
+    MergeInputs(*batch, batch_size);
+    PADDLE_ENFORCE_EQ(predictor_->ZeroCopyRun(),
+                      true,
+                      platform::errors::Fatal(
+                          "The predictor of DynamicBatcher failed to run."));
+    auto results = ScatterOutputs(*batch, batch_size);
+    for (size_t i = 0; i < batch->size(); ++i) {
+      (*batch)[i].promise.set_value(std::move(results[i]));
+    }
+  } catch (...) {
+    LOG(WARNING) << "DynamicBatcher failed to run a batch of " << rows
+                 << " rows.";
+    for (auto& request : *batch) {
+      request.promise.set_exception(std::current_exception());
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    stats_.num_failed_requests += batch->size();
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mtx_);
+  ++stats_.num_batches;
+  stats_.num_rows += rows;
+  stats_.num_padded_rows += batch_size - rows;
+  stats_.total_run_time_us += MicrosecondsSince(start);
+}
+
+void DynamicBatcher::MergeInputs(const std::vector<Request>& batch,
+                                 int batch_size) {
+  for (size_t i = 0; i < input_names_.size(); ++i) {
+    const PaddleTensor& first = batch.front().inputs[i];
+    std::vector<int> shape = first.shape;
+    shape[0] = batch_size;
+    size_t row_bytes = RowNumel(shape) * SizeOfDataType(first.dtype);
+    auto tensor = predictor_->GetInputTensor(input_names_[i]);
+    tensor->Reshape(shape);
+    VisitDataType(first.dtype, [&](auto value) {
+      using T = decltype(value);
+      // copy into the input tensor directly on host, or into the staging
+      // buffer which is copied to device at once
+      char* dst = nullptr;
+      if (on_host_) {
+        dst = reinterpret_cast<char*>(
+            tensor->mutable_data<T>(paddle_infer::PlaceType::kCPU));
+      } else {
+        staging_.resize(batch_size * row_bytes);
+        dst = staging_.data();
+      }
+      size_t offset = 0;
+      for (const auto& request : batch) {
+        const PaddleBuf& data = request.inputs[i].data;
+        std::memcpy(dst + offset, data.data(), data.length());
+        offset += data.length();
+      }
+      std::memset(dst + offset, 0, batch_size * row_bytes - offset);
+      if (!on_host_) {
+        tensor->CopyFromCpu(reinterpret_cast<const T*>(dst));
+      }
+    });
+  }
+}
+
+std::vector<DynamicBatcherResult> DynamicBatcher::ScatterOutputs(
+    const std::vector<Request>& batch, int batch_size) {
+  auto holder = std::make_shared<std::vector<std::vector<char>>>(
+      output_names_.size());
+  std::vector<DynamicBatcherResult> results(batch.size());
+  for (auto& result : results) {
+    result.holder = holder;
+  }
+  for (size_t i = 0; i < output_names_.size(); ++i) {
+    auto tensor = predictor_->GetOutputTensor(output_names_[i]);
+    std::vector<int> shape = tensor->shape();
+    PaddleDType dtype = tensor->type();
+    size_t row_bytes = RowNumel(shape) * SizeOfDataType(dtype);
+    bool batched = !shape.empty() && shape[0] == batch_size;
+    size_t bytes =
+        shape.empty() ? SizeOfDataType(dtype) : shape[0] * row_bytes;
+    auto& data = (*holder)[i];
+    data.resize(bytes);
+    VisitDataType(dtype, [&](auto value) {
+      using T = decltype(value);
+      tensor->CopyToCpu(reinterpret_cast<T*>(data.data()));
+    });
+
+    size_t offset = 0;
+    for (size_t j = 0; j < batch.size(); ++j) {
+      PaddleTensor output;
+      output.name = output_names_[i];
+      output.dtype = dtype;
+      output.shape = shape;
+      if (batched) {
+        size_t length = batch[j].rows * row_bytes;
+        output.shape[0] = batch[j].rows;
+        output.data.Reset(data.data() + offset, length);
+        offset += length;
+      } else {
+        output.data.Reset(data.data(), bytes);
+      }
+      results[j].outputs.push_back(std::move(output));
+    }
+  }
+  return results;
+}
+
+}  // namespace paddle
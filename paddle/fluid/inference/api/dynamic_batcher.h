@@ -0,0 +1,138 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "paddle/fluid/inference/api/paddle_analysis_config.h"
+#include "paddle/fluid/inference/api/paddle_api.h"
+
+namespace paddle {
+
+struct DynamicBatcherOptions {
+  // The max rows of a merged batch. It is limited to the max batch size of
+  // the shape range info of the TensorRT engine if there is one.
+  int max_batch_size{8};
+  // A batch is run once it has max_batch_size rows, or its first request has
+  // waited for max_queue_delay_us.
+  int64_t max_queue_delay_us{1000};
+};
+
+struct DynamicBatcherStats {
+  uint64_t num_requests{0};
+  uint64_t num_failed_requests{0};
+  uint64_t num_batches{0};
+  uint64_t num_rows{0};
+  // the zero rows padded to reach the min batch size of the shape range
+  uint64_t num_padded_rows{0};
+  // the requests waiting in the queue now
+  size_t queue_size{0};
+  double total_queue_time_us{0};
+  double max_queue_time_us{0};
+  double total_run_time_us{0};
+};
+
+// The outputs of a request. The outputs of a merged batch are copied to host
+// once, and the data of the outputs of every request in the batch are views
+// on them held by holder. An output without the batch dim is shared by all
+// the requests in the batch.
+struct DynamicBatcherResult {
+  std::vector<PaddleTensor> outputs;
+  std::shared_ptr<void> holder;
+};
+
+///
+/// \brief DynamicBatcher merges the requests to a predictor along the batch
+/// dim, which is the first dim of all inputs and outputs.
+///
+/// The requests are queued and run in a worker thread owning the predictor.
+/// The inputs of the requests are copied into the input tensors of the
+/// predictor directly, or into one staging buffer if the predictor runs on
+/// device. When the predictor uses TensorRT with the shape range info, the
+/// merged batch sizes are kept in the range of the batch dim, so that the
+/// engine is not rebuilt at runtime.
+///
+class DynamicBatcher {
+ public:
+  DynamicBatcher(const AnalysisConfig& config,
+                 const DynamicBatcherOptions& options);
+
+  ~DynamicBatcher();
+
+  ///
+  /// \brief Queue a request.
+  ///
+  /// \param inputs Host tensors of all inputs of the predictor, the first dims
+  /// of them are the rows of the request, which should not be larger than
+  /// max_batch_size().
+  /// \return The future of the outputs, which throws the error of the run of
+  /// the batch if it fails.
+  ///
+  std::future<DynamicBatcherResult> Submit(std::vector<PaddleTensor> inputs);
+
+  DynamicBatcherStats GetStats() const;
+
+  int max_batch_size() const { return max_batch_size_; }
+  int min_batch_size() const { return min_batch_size_; }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Request {
+    // in the order of input_names_
+    std::vector<PaddleTensor> inputs;
+    int rows;
+    std::promise<DynamicBatcherResult> promise;
+    Clock::time_point enqueue_time;
+  };
+
+  void LoadShapeRange(const std::string& path);
+  // whether the non-batch dims of the inputs of request are the same as the
+  // ones of first, they are merged only if so
+  bool Mergeable(const Request& first, const Request& request) const;
+  void Loop();
+  void RunBatch(std::vector<Request>* batch);
+  void MergeInputs(const std::vector<Request>& batch, int batch_size);
+  std::vector<DynamicBatcherResult> ScatterOutputs(
+      const std::vector<Request>& batch, int batch_size);
+
+  std::unique_ptr<PaddlePredictor> predictor_;
+  std::vector<std::string> input_names_;
+  std::vector<std::string> output_names_;
+  bool on_host_{true};
+  int max_batch_size_;
+  int min_batch_size_{1};
+  std::chrono::microseconds max_queue_delay_;
+  std::vector<char> staging_;
+
+  std::deque<Request> queue_;
+  int queued_rows_{0};
+  bool stop_{false};
+  DynamicBatcherStats stats_;
+  mutable std::mutex mtx_;
+  std::condition_variable cv_;
+  std::thread worker_;
+};
+
+}  // namespace paddle
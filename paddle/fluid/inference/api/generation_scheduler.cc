@@ -0,0 +1,393 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/generation_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+
+namespace paddle {
+
+namespace {
+
+const char* const kStepInputNames[] = {"input_ids",
+                                       "seq_lens_encoder",
+                                       "seq_lens_decoder",
+                                       "seq_lens_this_time",
+                                       "padding_offsets",
+                                       "cum_offsets",
+                                       "cu_seqlens_q",
+                                       "cu_seqlens_k",
+                                       "block_tables"};
+
+template <typename T>
+void FeedInput(PaddlePredictor* predictor,
+               const std::string& name,
+               const std::vector<int>& shape,
+               const std::vector<T>& data) {
+  auto tensor = predictor->GetInputTensor(name);
+  tensor->Reshape(shape);
+  tensor->CopyFromCpu(data.data());
+}
+
+}  // namespace
+
+GenerationScheduler::GenerationScheduler(
+    const AnalysisConfig& config, const GenerationSchedulerOptions& options)
+    : options_(options),
+      max_blocks_per_seq_((options.max_seq_len + options.block_size - 1) /
+                          options.block_size),
+      block_manager_(options.num_blocks, options.block_size) {
+  PADDLE_ENFORCE_EQ(
+      options_.max_batch_size > 0 && options_.max_num_batched_tokens > 0 &&
+          options_.max_seq_len > 0,
+      true,
+      platform::errors::InvalidArgument(
+          "The max_batch_size, max_num_batched_tokens and max_seq_len of "
+          "GenerationScheduler should be positive, but got %d, %d and %d.",
+          options_.max_batch_size,
+          options_.max_num_batched_tokens,
+          options_.max_seq_len));
+  // a sequence running alone never runs out of blocks
+  PADDLE_ENFORCE_GE(options_.num_blocks,
+                    max_blocks_per_seq_,
+                    platform::errors::InvalidArgument(
+                        "The num_blocks of GenerationScheduler should hold a "
+                        "sequence of max_seq_len, i.e. at least %d, but got "
+                        "%d.",
+                        max_blocks_per_seq_,
+                        options_.num_blocks));
+  AnalysisConfig predictor_config(config);
+  // the inputs and outputs are passed by the zero copy tensors, and the
+  // caches are kept in the input tensors across the steps
+  predictor_config.SwitchUseFeedFetchOps(false);
+  predictor_ = CreatePaddlePredictor<AnalysisConfig>(predictor_config);
+  PADDLE_ENFORCE_NOT_NULL(predictor_,
+                          platform::errors::PreconditionNotMet(
+                              "Failed to create the predictor of "
+                              "GenerationScheduler."));
+  auto input_names = predictor_->GetInputNames();
+  for (const char* name : kStepInputNames) {
+    PADDLE_ENFORCE_NE(
+        std::find(input_names.begin(), input_names.end(), name),
+        input_names.end(),
+        platform::errors::InvalidArgument(
+            "The generation model should have the input %s.", name));
+  }
+  has_top_p_ = std::find(input_names.begin(), input_names.end(), "top_p") !=
+               input_names.end();
+  PADDLE_ENFORCE_EQ(predictor_->GetOutputNames().empty(),
+                    false,
+                    platform::errors::InvalidArgument(
+                        "The generation model should output the ids."));
+  InitCaches(config);
+  VLOG(3) << "GenerationScheduler: max_batch_size " << options_.max_batch_size
+          << ", num_blocks " << options_.num_blocks << ", block_size "
+          << options_.block_size << ", max_blocks_per_seq "
+          << max_blocks_per_seq_;
+
+  worker_ = std::thread([this]() { Loop(); });
+}
+
+GenerationScheduler::~GenerationScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  worker_.join();
+}
+
+void GenerationScheduler::InitCaches(const AnalysisConfig& config) {
+  auto place = paddle_infer::PlaceType::kCPU;
+  if (config.use_gpu()) {
+    place = paddle_infer::PlaceType::kGPU;
+  } else if (config.use_xpu()) {
+    place = paddle_infer::PlaceType::kXPU;
+  } else if (config.use_custom_device()) {
+    place = paddle_infer::PlaceType::kCUSTOM;
+  }
+  std::vector<int> shape{options_.num_blocks,
+                         options_.kv_num_heads,
+                         options_.block_size,
+                         options_.head_dim};
+  int num_caches = 0;
+  for (const auto& name : predictor_->GetInputNames()) {
+    if (name.compare(0, options_.cache_prefix.size(), options_.cache_prefix) !=
+        0) {
+      continue;
+    }
+    // only the blocks written by the ops are read, so they are not zeroed
+    auto tensor = predictor_->GetInputTensor(name);
+    tensor->Reshape(shape);
+    switch (options_.cache_dtype) {
+      case PaddleDType::FLOAT16:
+        tensor->mutable_data<phi::dtype::float16>(place);
+        break;
+      case PaddleDType::BFLOAT16:
+        tensor->mutable_data<phi::dtype::bfloat16>(place);
+        break;
+      case PaddleDType::FLOAT32:
+        tensor->mutable_data<float>(place);
+        break;
+      case PaddleDType::INT8:
+        tensor->mutable_data<int8_t>(place);
+        break;
+      default:
+        PADDLE_THROW(platform::errors::Unimplemented(
+            "Unsupported cache data type %d in GenerationScheduler.",
+            static_cast<int>(options_.cache_dtype)));
+    }
+    ++num_caches;
+  }
+  PADDLE_ENFORCE_GT(num_caches,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The generation model has no cache input with the "
+                        "prefix %s.",
+                        options_.cache_prefix));
+}
+
+std::future<GenerationResult> GenerationScheduler::Submit(
+    GenerationRequest request) {
+  int num_tokens = static_cast<int>(request.prompt_token_ids.size());
+  PADDLE_ENFORCE_EQ(
+      num_tokens > 0 && num_tokens <= options_.max_seq_len,
+      true,
+      platform::errors::InvalidArgument(
+          "The prompt of a request should have [1, %d] tokens, but got %d.",
+          options_.max_seq_len,
+          num_tokens));
+  PADDLE_ENFORCE_GT(request.max_new_tokens,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The max_new_tokens of a request should be greater "
+                        "than 0, but got %d.",
+                        request.max_new_tokens));
+  auto seq = std::make_unique<Sequence>();
+  seq->token_ids = request.prompt_token_ids;
+  seq->request = std::move(request);
+  auto future = seq->promise.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    seq->id = next_seq_id_++;
+    waiting_.push_back(std::move(seq));
+    ++stats_.num_requests;
+  }
+  cv_.notify_one();
+  return future;
+}
+
+GenerationSchedulerStats GenerationScheduler::GetStats() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  GenerationSchedulerStats stats = stats_;
+  stats.num_waiting = waiting_.size();
+  return stats;
+}
+
+void GenerationScheduler::Loop() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      cv_.wait(lock, [this]() {
+        return stop_ || !waiting_.empty() || !running_.empty();
+      });
+      // the queued requests are finished before stop
+      if (waiting_.empty() && running_.empty()) {
+        return;
+      }
+    }
+    try {
+      Schedule();
+      RunStep();
+    } catch (...) {
+      LOG(WARNING) << "GenerationScheduler failed to run a step of "
+                   << running_.size() << " sequences.";
+      for (auto& seq : running_) {
+        block_manager_.FreeSequence(seq->id);
+        seq->promise.set_exception(std::current_exception());
+      }
+      std::lock_guard<std::mutex> lock(mtx_);
+      stats_.num_failed_requests += running_.size();
+      running_.clear();
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    stats_.num_running = running_.size();
+  }
+}
+
+void GenerationScheduler::Schedule() {
+  // make room for the last tokens of the running sequences, the blocks are
+  // never shared, since the sequences are neither forked nor cached, so
+  // nothing is copied on write
+  std::vector<std::pair<int, int>> copies;
+  for (size_t i = 0; i < running_.size(); ++i) {
+    running_[i]->prefill = false;
+    bool preempted = false;
+    while (!block_manager_.AppendTokens(running_[i]->id, 1, &copies)) {
+      preempted = i + 1 == running_.size();
+      Preempt();
+      if (preempted) {
+        break;
+      }
+    }
+    if (preempted) {
+      break;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mtx_);
+  int num_prefill_tokens = 0;
+  while (!waiting_.empty() &&
+         static_cast<int>(running_.size()) < options_.max_batch_size) {
+    auto& seq = waiting_.front();
+    int num_tokens = static_cast<int>(seq->token_ids.size());
+    if (num_prefill_tokens > 0 &&
+        num_prefill_tokens + num_tokens > options_.max_num_batched_tokens) {
+      break;
+    }
+    if (!block_manager_.AddSequence(seq->id, seq->token_ids)) {
+      break;
+    }
+    seq->prefill = true;
+    num_prefill_tokens += num_tokens;
+    running_.push_back(std::move(seq));
+    waiting_.pop_front();
+  }
+}
+
+void GenerationScheduler::Preempt() {
+  auto seq = std::move(running_.back());
+  running_.pop_back();
+  block_manager_.FreeSequence(seq->id);
+  VLOG(3) << "GenerationScheduler preempts the sequence " << seq->id
+          << " of " << seq->token_ids.size() << " tokens.";
+  std::lock_guard<std::mutex> lock(mtx_);
+  // the generated tokens are prefilled with the prompt again
+  waiting_.push_front(std::move(seq));
+  ++stats_.num_preemptions;
+}
+
+void GenerationScheduler::RunStep() {
+  int bsz = static_cast<int>(running_.size());
+  const int max_seq_len = options_.max_seq_len;
+  std::vector<int64_t> seq_ids(bsz);
+  std::vector<int64_t> input_ids;
+  std::vector<int> seq_lens_encoder(bsz), seq_lens_decoder(bsz),
+      seq_lens_this_time(bsz), cum_offsets(bsz), cu_seqlens(bsz + 1, 0);
+  std::vector<int> padding_offsets;
+  std::vector<float> top_p(bsz);
+  int num_prefill_tokens = 0;
+  for (int i = 0; i < bsz; ++i) {
+    const Sequence& seq = *running_[i];
+    seq_ids[i] = seq.id;
+    int num_tokens = 0;
+    if (seq.prefill) {
+      num_tokens = static_cast<int>(seq.token_ids.size());
+      input_ids.insert(
+          input_ids.end(), seq.token_ids.begin(), seq.token_ids.end());
+      seq_lens_encoder[i] = num_tokens;
+      num_prefill_tokens += num_tokens;
+    } else {
+      // the last token is appended to the caches in this step
+      num_tokens = 1;
+      input_ids.push_back(seq.token_ids.back());
+      seq_lens_decoder[i] = block_manager_.NumTokens(seq.id) - 1;
+    }
+    seq_lens_this_time[i] = num_tokens;
+    // the tokens are packed from the [bsz, max_seq_len] padded layout
+    cum_offsets[i] = i * max_seq_len - cu_seqlens[i];
+    padding_offsets.insert(padding_offsets.end(), num_tokens, cum_offsets[i]);
+    cu_seqlens[i + 1] = cu_seqlens[i] + num_tokens;
+    top_p[i] = seq.request.top_p;
+  }
+  std::vector<int> block_tables(bsz * max_blocks_per_seq_);
+  block_manager_.GetBlockTables(
+      seq_ids, max_blocks_per_seq_, block_tables.data());
+
+  int token_num = static_cast<int>(input_ids.size());
+  auto* predictor = predictor_.get();
+  FeedInput(predictor, "input_ids", {token_num}, input_ids);
+  FeedInput(predictor, "seq_lens_encoder", {bsz, 1}, seq_lens_encoder);
+  FeedInput(predictor, "seq_lens_decoder", {bsz, 1}, seq_lens_decoder);
+  FeedInput(predictor, "seq_lens_this_time", {bsz}, seq_lens_this_time);
+  FeedInput(predictor, "padding_offsets", {token_num}, padding_offsets);
+  FeedInput(predictor, "cum_offsets", {bsz}, cum_offsets);
+  FeedInput(predictor, "cu_seqlens_q", {bsz + 1}, cu_seqlens);
+  FeedInput(predictor, "cu_seqlens_k", {bsz + 1}, cu_seqlens);
+  FeedInput(
+      predictor, "block_tables", {bsz, max_blocks_per_seq_}, block_tables);
+  if (has_top_p_) {
+    FeedInput(predictor, "top_p", {bsz, 1}, top_p);
+  }
+  PADDLE_ENFORCE_EQ(predictor_->ZeroCopyRun(),
+                    true,
+                    platform::errors::Fatal(
+                        "The predictor of GenerationScheduler failed to run."));
+
+  auto output = predictor_->GetOutputTensor(predictor_->GetOutputNames()[0]);
+  auto shape = output->shape();
+  int numel = 1;
+  for (int dim : shape) {
+    numel *= dim;
+  }
+  PADDLE_ENFORCE_EQ(
+      output->type() == PaddleDType::INT64 && numel == bsz,
+      true,
+      platform::errors::InvalidArgument(
+          "The output of the generation model should be the int64 ids of "
+          "the %d sequences, but got %d elements of type %d.",
+          bsz,
+          numel,
+          static_cast<int>(output->type())));
+  std::vector<int64_t> next_tokens(bsz);
+  output->CopyToCpu(next_tokens.data());
+
+  std::deque<std::unique_ptr<Sequence>> running;
+  for (int i = 0; i < bsz; ++i) {
+    auto& seq = running_[i];
+    seq->token_ids.push_back(next_tokens[i]);
+    ++seq->num_generated;
+    // the caches have no room for the next token at max_seq_len
+    if (next_tokens[i] == seq->request.eos_token_id ||
+        seq->num_generated >= seq->request.max_new_tokens ||
+        block_manager_.NumTokens(seq->id) >= max_seq_len) {
+      Finish(seq.get());
+    } else {
+      running.push_back(std::move(seq));
+    }
+  }
+  running_ = std::move(running);
+
+  std::lock_guard<std::mutex> lock(mtx_);
+  ++stats_.num_steps;
+  stats_.num_prefill_tokens += num_prefill_tokens;
+  stats_.num_generated_tokens += bsz;
+}
+
+void GenerationScheduler::Finish(Sequence* seq) {
+  block_manager_.FreeSequence(seq->id);
+  GenerationResult result;
+  result.token_ids.assign(
+      seq->token_ids.begin() + seq->request.prompt_token_ids.size(),
+      seq->token_ids.end());
+  seq->promise.set_value(std::move(result));
+}
+
+}  // namespace paddle
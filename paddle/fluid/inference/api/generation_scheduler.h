@@ -0,0 +1,162 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "paddle/fluid/inference/api/paddle_analysis_config.h"
+#include "paddle/fluid/inference/api/paddle_api.h"
+#include "paddle/fluid/inference/api/paddle_infer_contrib.h"
+
+namespace paddle {
+
+struct GenerationSchedulerOptions {
+  // The max sequences decoded in a step.
+  int max_batch_size{32};
+  // The max tokens of the prompts prefilled in a step, a longer prompt is
+  // prefilled alone.
+  int max_num_batched_tokens{2048};
+  // The max_seq_len attr of the block_multi_head_attention ops, which is the
+  // max tokens of a sequence, including the generated ones.
+  int max_seq_len{2048};
+  // The paged key/value caches of the model are
+  // [num_blocks, kv_num_heads, block_size, head_dim].
+  int num_blocks{1024};
+  int block_size{64};
+  int kv_num_heads{32};
+  int head_dim{128};
+  PaddleDType cache_dtype{PaddleDType::FLOAT16};
+  // The inputs of the model whose names start with it are the caches.
+  std::string cache_prefix{"cache_kvs"};
+};
+
+struct GenerationRequest {
+  std::vector<int64_t> prompt_token_ids;
+  int max_new_tokens{128};
+  // fed to the ps of top_p_sampling
+  float top_p{0.f};
+  // the generation stops at it, -1 for none
+  int64_t eos_token_id{-1};
+};
+
+struct GenerationResult {
+  std::vector<int64_t> token_ids;
+};
+
+struct GenerationSchedulerStats {
+  uint64_t num_requests{0};
+  uint64_t num_failed_requests{0};
+  uint64_t num_steps{0};
+  uint64_t num_prefill_tokens{0};
+  uint64_t num_generated_tokens{0};
+  // the running sequences whose blocks are freed to make room for the
+  // others, they are prefilled again later
+  uint64_t num_preemptions{0};
+  size_t num_running{0};
+  size_t num_waiting{0};
+};
+
+///
+/// \brief GenerationScheduler serves a generation model by continuous
+/// batching: the sequences are admitted and retired at every decoding step,
+/// instead of waiting for the longest sequence of a static batch.
+///
+/// The prompts of the admitted sequences and the last tokens of the running
+/// ones are packed into one step of the model, whose inputs are the varlen
+/// inputs of block_multi_head_attention, plus the ps of top_p_sampling:
+///   input_ids          int64 [token_num]
+///   seq_lens_encoder   int32 [bsz, 1], the prompt tokens prefilled
+///   seq_lens_decoder   int32 [bsz, 1], the tokens in the caches before
+///   seq_lens_this_time int32 [bsz]
+///   padding_offsets    int32 [token_num]
+///   cum_offsets        int32 [bsz]
+///   cu_seqlens_q       int32 [bsz + 1]
+///   cu_seqlens_k       int32 [bsz + 1]
+///   block_tables       int32 [bsz, ceil(max_seq_len / block_size)]
+///   top_p              float32 [bsz, 1]
+///   the caches         [num_blocks, kv_num_heads, block_size, head_dim]
+/// and its first output is the int64 [bsz, 1] ids of top_p_sampling. The
+/// caches are allocated once and kept in the predictor, and their blocks
+/// are managed by a KVCacheBlockManager.
+///
+/// When the blocks run out, the sequence admitted last is preempted: its
+/// blocks are freed and it waits to be prefilled again with its generated
+/// tokens.
+///
+class GenerationScheduler {
+ public:
+  GenerationScheduler(const AnalysisConfig& config,
+                      const GenerationSchedulerOptions& options);
+
+  ~GenerationScheduler();
+
+  ///
+  /// \brief Queue a request.
+  ///
+  /// \return The future of the generated tokens, which throws the error of
+  /// the step if it fails.
+  ///
+  std::future<GenerationResult> Submit(GenerationRequest request);
+
+  GenerationSchedulerStats GetStats() const;
+
+ private:
+  struct Sequence {
+    int64_t id;
+    GenerationRequest request;
+    // the prompt and the generated tokens
+    std::vector<int64_t> token_ids;
+    int num_generated{0};
+    // whether the tokens are prefilled in this step
+    bool prefill{true};
+    std::promise<GenerationResult> promise;
+  };
+
+  void InitCaches(const AnalysisConfig& config);
+  void Loop();
+  // admit the waiting sequences to the running ones, and make room for the
+  // tokens of this step
+  void Schedule();
+  void Preempt();
+  void RunStep();
+  void Finish(Sequence* seq);
+
+  std::unique_ptr<PaddlePredictor> predictor_;
+  GenerationSchedulerOptions options_;
+  int max_blocks_per_seq_;
+  bool has_top_p_{false};
+  paddle_infer::contrib::KVCacheBlockManager block_manager_;
+  int64_t next_seq_id_{0};
+
+  // owned by the worker
+  std::deque<std::unique_ptr<Sequence>> running_;
+
+  std::deque<std::unique_ptr<Sequence>> waiting_;
+  bool stop_{false};
+  GenerationSchedulerStats stats_;
+  mutable std::mutex mtx_;
+  std::condition_variable cv_;
+  std::thread worker_;
+};
+
+}  // namespace paddle
@@ -224,15 +224,40 @@ void InferXPUContext::SetFcAutotuneInfo(std::string fc_autotune_file,
   }
 }
 
+void InferXPUContext::SetL3Lifetimes(
+    const std::unordered_map<phi::Allocation*, std::pair<size_t, size_t>>&
+        lifetimes) {
+  for (auto& holder_l3_block : holder_l3_blocks_) {
+    auto iter = lifetimes.find(holder_l3_block.first);
+    if (iter != lifetimes.end()) {
+      holder_l3_block.second->RecordLifetime(iter->second.first,
+                                             iter->second.second);
+    }
+  }
+  with_l3_lifetimes_ = true;
+}
+
 void InferXPUContext::L3CacheAutotune() {
   if (l3_autotune_size_ == 0) return;
   if (holder_map_.empty()) {
-    l3_plan_.RunAutotune(l3_blocks_, l3_size_);
+    if (with_l3_lifetimes_) {
+      // the blocks are packed by their lifetimes in the l3 for autotune
+      l3_plan_.RunLifetimeAutotune(l3_blocks_, l3_autotune_size_, l3_size_);
+    } else {
+      l3_plan_.RunAutotune(l3_blocks_, l3_size_);
+    }
     auto* plan = l3_plan_.plan();
+    if (plan->empty()) {
+      return;
+    }
+    auto* offsets = l3_plan_.offsets();
     int8_t* cur_l3_ptr = reinterpret_cast<int8_t*>(l3_ptr_);
     for (size_t i = 0; i < l3_blocks_.size(); i++) {
       size_t block_size = plan->at(i);
       if (block_size > 0) {
+        if (with_l3_lifetimes_) {
+          cur_l3_ptr = reinterpret_cast<int8_t*>(l3_ptr_) + offsets->at(i);
+        }
         l3_blocks_[i]->Set(cur_l3_ptr, block_size);
         cur_l3_ptr += block_size;
       }
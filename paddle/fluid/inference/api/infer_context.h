@@ -67,6 +67,17 @@ class InferXPUContext : public phi::XPUContext {
                  size_t l3_autotune_size,
                  const phi::Place& place);
 
+  // Sets the lifetimes, i.e. the first and the last ops using them, of the
+  // holders allocated in the recording run, so that L3CacheAutotune lets the
+  // holders living at different times share the l3.
+  void SetL3Lifetimes(
+      const std::unordered_map<phi::Allocation*, std::pair<size_t, size_t>>&
+          lifetimes);
+
+  // whether the l3 blocks are planned, after which the lifetimes are not
+  // needed
+  bool L3CachePlanned() const { return !holder_map_.empty(); }
+
   void L3CacheAutotune();
 
   void SetConvAutotuneInfo(std::string conv_autotune_file,
@@ -90,6 +101,7 @@ class InferXPUContext : public phi::XPUContext {
   mutable std::unordered_map<phi::Allocation*,
                              std::pair<phi::Allocation*, bool>>
       holder_map_;
+  bool with_l3_lifetimes_{false};
   phi::XPUL3Planner l3_plan_;
 };
 #endif
@@ -0,0 +1,379 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/int8_calibration_collector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/convert_utils.h"
+#include "paddle/fluid/framework/data_type_transform.h"
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/fluid/framework/threadpool.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/phi/core/enforce.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/kernels/abs_kernel.h"
+#include "paddle/phi/kernels/histogram_kernel.h"
+#include "paddle/phi/kernels/reduce_max_kernel.h"
+#include "paddle/phi/kernels/scale_kernel.h"
+#endif
+
+namespace paddle {
+namespace inference {
+
+namespace {
+
+// the number of the int8 levels of the absolute values
+constexpr int kNumQuantizedBins = 128;
+
+bool IsFloatTensor(const phi::DenseTensor& tensor) {
+  return tensor.dtype() == phi::DataType::FLOAT32 ||
+         tensor.dtype() == phi::DataType::FLOAT16 ||
+         tensor.dtype() == phi::DataType::BFLOAT16;
+}
+
+// the fp32 copy of tensor on place
+phi::DenseTensor Fp32Of(const phi::DenseTensor& tensor,
+                        const phi::Place& place) {
+  phi::DenseTensor out;
+  if (tensor.dtype() == phi::DataType::FLOAT32) {
+    framework::TensorCopySync(tensor, place, &out);
+  } else if (tensor.place() == place) {
+    framework::TransDataType(tensor, framework::proto::VarType::FP32, &out);
+  } else {
+    phi::DenseTensor copy;
+    framework::TensorCopySync(tensor, place, &copy);
+    framework::TransDataType(copy, framework::proto::VarType::FP32, &out);
+  }
+  return out;
+}
+
+// KL divergence of the reference distribution p and the candidate q, whose
+// bins of zero p are skipped
+double KLDivergence(const std::vector<double>& p,
+                    const std::vector<double>& q) {
+  double p_sum = std::accumulate(p.begin(), p.end(), 0.0);
+  double q_sum = std::accumulate(q.begin(), q.end(), 0.0);
+  double divergence = 0.0;
+  for (size_t i = 0; i < p.size(); ++i) {
+    if (p[i] == 0) continue;
+    if (q[i] == 0) return std::numeric_limits<double>::infinity();
+    double p_i = p[i] / p_sum;
+    divergence += p_i * std::log(p_i / (q[i] / q_sum));
+  }
+  return divergence;
+}
+
+// The TensorRT entropy calibration: the first num_ref bins, with the outliers
+// added to the last one, are the reference, and its quantization to
+// kNumQuantizedBins levels, each spread evenly over the nonzero bins it
+// covers, is the candidate.
+int EntropyThresholdBin(const std::vector<int64_t>& bins) {
+  const int num_bins = static_cast<int>(bins.size());
+  double total = std::accumulate(bins.begin(), bins.end(), 0.0);
+  double outliers = total;
+  for (int i = 0; i < kNumQuantizedBins && i < num_bins; ++i) {
+    outliers -= bins[i];
+  }
+  int best = num_bins;
+  double min_divergence = std::numeric_limits<double>::infinity();
+  for (int num_ref = kNumQuantizedBins; num_ref <= num_bins; ++num_ref) {
+    std::vector<double> p(bins.begin(), bins.begin() + num_ref);
+    p[num_ref - 1] += outliers;
+    if (num_ref < num_bins) outliers -= bins[num_ref];
+
+    std::vector<double> q(num_ref, 0.0);
+    double merged = static_cast<double>(num_ref) / kNumQuantizedBins;
+    for (int j = 0; j < kNumQuantizedBins; ++j) {
+      int start = static_cast<int>(std::floor(j * merged));
+      int end = j == kNumQuantizedBins - 1
+                    ? num_ref
+                    : static_cast<int>(std::floor((j + 1) * merged));
+      double sum = 0.0;
+      int nonzeros = 0;
+      for (int k = start; k < end; ++k) {
+        sum += bins[k];
+        nonzeros += bins[k] != 0;
+      }
+      for (int k = start; k < end && nonzeros > 0; ++k) {
+        q[k] = bins[k] != 0 ? sum / nonzeros : 0.0;
+      }
+    }
+    double divergence = KLDivergence(p, q);
+    if (divergence < min_divergence) {
+      min_divergence = divergence;
+      best = num_ref;
+    }
+  }
+  return best;
+}
+
+int PercentileThresholdBin(const std::vector<int64_t>& bins,
+                           float percentile) {
+  double total = std::accumulate(bins.begin(), bins.end(), 0.0);
+  double target = total * percentile / 100.0;
+  double count = 0.0;
+  for (size_t i = 0; i < bins.size(); ++i) {
+    count += bins[i];
+    if (count >= target) return static_cast<int>(i) + 1;
+  }
+  return static_cast<int>(bins.size());
+}
+
+// The threshold t of the least expected squared error, where the values below
+// t get the rounding error step^2 / 12 of the step t / 127, and the values
+// above t are clipped to t.
+int MseThresholdBin(const std::vector<int64_t>& bins) {
+  const int num_bins = static_cast<int>(bins.size());
+  int best = num_bins;
+  double min_error = std::numeric_limits<double>::infinity();
+  for (int num_kept = 1; num_kept <= num_bins; ++num_kept) {
+    double threshold = num_kept;
+    double step = threshold / 127.0;
+    double error = 0.0;
+    for (int i = 0; i < num_bins; ++i) {
+      double center = i + 0.5;
+      error += bins[i] * (center < threshold
+                              ? step * step / 12.0
+                              : (center - threshold) * (center - threshold));
+    }
+    if (error < min_error) {
+      min_error = error;
+      best = num_kept;
+    }
+  }
+  return best;
+}
+
+}  // namespace
+
+Int8CalibrationCollector::Int8CalibrationCollector(const std::string& method,
+                                                   float percentile,
+                                                   int num_bins)
+    : method_(method), percentile_(percentile), num_bins_(num_bins) {
+  PADDLE_ENFORCE_EQ(
+      method == "entropy" || method == "percentile" || method == "mse",
+      true,
+      phi::errors::InvalidArgument(
+          "The int8 calibration method should be entropy, percentile or mse, "
+          "but got %s.",
+          method));
+  PADDLE_ENFORCE_EQ(percentile > 0.f && percentile <= 100.f,
+                    true,
+                    phi::errors::InvalidArgument(
+                        "The calibration percentile should be in (0, 100], "
+                        "but got %f.",
+                        percentile));
+  PADDLE_ENFORCE_GE(num_bins,
+                    kNumQuantizedBins,
+                    phi::errors::InvalidArgument(
+                        "The calibration histogram should have at least %d "
+                        "bins, but got %d.",
+                        kNumQuantizedBins,
+                        num_bins));
+}
+
+Int8CalibrationCollector::~Int8CalibrationCollector() {
+  for (auto& pending : pending_) {
+    pending.wait();
+  }
+}
+
+Int8CalibrationCollector::Histogram* Int8CalibrationCollector::GetHistogram(
+    const std::string& name) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& hist = histograms_[name];
+  if (!hist) {
+    hist = std::make_unique<Histogram>();
+    hist->bins.resize(num_bins_, 0);
+  }
+  return hist.get();
+}
+
+void Int8CalibrationCollector::Collect(const std::string& name,
+                                       const phi::DenseTensor& tensor) {
+  if (!tensor.initialized() || tensor.numel() == 0 || !IsFloatTensor(tensor)) {
+    return;
+  }
+  auto* hist = GetHistogram(name);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (phi::is_gpu_place(tensor.place())) {
+    CollectOnGpu(tensor, hist);
+    return;
+  }
+#endif
+  // the var is overwritten by the next op, so the values are copied before
+  // the binning is left to the thread pool
+  auto copy =
+      std::make_shared<phi::DenseTensor>(Fp32Of(tensor, phi::CPUPlace()));
+  auto pending = framework::ThreadPool::GetInstance()->Run(
+      [this, copy, hist]() { CollectOnCpu(*copy, hist); });
+  std::lock_guard<std::mutex> guard(mutex_);
+  pending_.emplace_back(std::move(pending));
+}
+
+void Int8CalibrationCollector::ExpandRange(float abs_max,
+                                           Histogram* hist) const {
+  if (hist->range == 0.f) {
+    hist->range = abs_max;
+    return;
+  }
+  while (abs_max > hist->range) {
+    for (int i = 0; i < num_bins_ / 2; ++i) {
+      hist->bins[i] = hist->bins[2 * i] + hist->bins[2 * i + 1];
+    }
+    if (num_bins_ % 2) {
+      hist->bins[num_bins_ / 2] = hist->bins[num_bins_ - 1];
+    }
+    std::fill(hist->bins.begin() + (num_bins_ + 1) / 2, hist->bins.end(), 0);
+    hist->range *= 2.f;
+  }
+}
+
+void Int8CalibrationCollector::CollectOnCpu(const phi::DenseTensor& tensor,
+                                            Histogram* hist) const {
+  const float* data = tensor.data<float>();
+  const int64_t numel = tensor.numel();
+  float abs_max = 0.f;
+  for (int64_t i = 0; i < numel; ++i) {
+    abs_max = std::max(abs_max, std::abs(data[i]));
+  }
+
+  std::lock_guard<std::mutex> guard(hist->mutex);
+  ExpandRange(abs_max, hist);
+  if (hist->range == 0.f) {
+    hist->bins[0] += numel;
+    return;
+  }
+  const float scale = num_bins_ / hist->range;
+  for (int64_t i = 0; i < numel; ++i) {
+    int bin = static_cast<int>(std::abs(data[i]) * scale);
+    ++hist->bins[std::min(bin, num_bins_ - 1)];
+  }
+}
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+void Int8CalibrationCollector::CollectOnGpu(const phi::DenseTensor& tensor,
+                                            Histogram* hist) const {
+  auto* dev_ctx = static_cast<phi::GPUContext*>(
+      platform::DeviceContextPool::Instance().Get(tensor.place()));
+  phi::DenseTensor x = tensor.dtype() == phi::DataType::FLOAT32
+                           ? tensor
+                           : Fp32Of(tensor, tensor.place());
+  phi::DenseTensor abs_x;
+  abs_x.Resize(x.dims());
+  phi::AbsKernel<float, phi::GPUContext>(*dev_ctx, x, &abs_x);
+  phi::DenseTensor abs_max;
+  abs_max.Resize(phi::make_ddim({}));
+  phi::MaxKernel<float, phi::GPUContext>(*dev_ctx, abs_x, {}, false, &abs_max);
+  phi::DenseTensor abs_max_cpu;
+  framework::TensorCopySync(abs_max, phi::CPUPlace(), &abs_max_cpu);
+
+  std::lock_guard<std::mutex> guard(hist->mutex);
+  ExpandRange(abs_max_cpu.data<float>()[0], hist);
+  if (hist->range == 0.f) {
+    hist->bins[0] += tensor.numel();
+    return;
+  }
+  // The values are scaled to the bin indices. The histogram kernel drops the
+  // values above its max, so one more bin takes the values at the range.
+  phi::DenseTensor scaled;
+  scaled.Resize(x.dims());
+  phi::ScaleKernel<float, phi::GPUContext>(
+      *dev_ctx, abs_x, num_bins_ / hist->range, 0.f, true, &scaled);
+  phi::DenseTensor bins;
+  bins.Resize({num_bins_ + 1});
+  phi::HistogramKernel<float, phi::GPUContext>(
+      *dev_ctx, scaled, num_bins_ + 1, 0, num_bins_ + 1, &bins);
+  phi::DenseTensor bins_cpu;
+  framework::TensorCopySync(bins, phi::CPUPlace(), &bins_cpu);
+  const int64_t* counts = bins_cpu.data<int64_t>();
+  for (int i = 0; i < num_bins_; ++i) {
+    hist->bins[i] += counts[i];
+  }
+  hist->bins[num_bins_ - 1] += counts[num_bins_];
+}
+#endif
+
+std::map<std::string, float> Int8CalibrationCollector::ComputeThresholds() {
+  std::vector<std::future<void>> pending;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    pending.swap(pending_);
+  }
+  for (auto& item : pending) {
+    item.get();
+  }
+
+  std::vector<std::pair<std::string, Histogram*>> hists;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (auto& item : histograms_) {
+      hists.emplace_back(item.first, item.second.get());
+    }
+  }
+  // the searches of the thresholds are independent for every tensor
+  std::vector<float> thresholds(hists.size(), 0.f);
+  auto* pool = framework::ThreadPool::GetInstance();
+  std::vector<std::future<void>> searches;
+  for (size_t i = 0; i < hists.size(); ++i) {
+    searches.emplace_back(pool->Run([&, i]() {
+      auto* hist = hists[i].second;
+      thresholds[i] =
+          ComputeThreshold(hist->bins, hist->range, method_, percentile_);
+    }));
+  }
+  for (auto& search : searches) {
+    search.get();
+  }
+
+  std::map<std::string, float> table;
+  for (size_t i = 0; i < hists.size(); ++i) {
+    if (thresholds[i] > 0.f) {
+      table[hists[i].first] = thresholds[i];
+      VLOG(3) << "The int8 threshold of " << hists[i].first << " is "
+              << thresholds[i] << " of the range " << hists[i].second->range;
+    }
+  }
+  return table;
+}
+
+float Int8CalibrationCollector::ComputeThreshold(
+    const std::vector<int64_t>& bins,
+    float range,
+    const std::string& method,
+    float percentile) {
+  if (range == 0.f || bins.empty()) return 0.f;
+  int bin;
+  if (method == "entropy") {
+    bin = static_cast<int>(bins.size()) < kNumQuantizedBins
+              ? static_cast<int>(bins.size())
+              : EntropyThresholdBin(bins);
+  } else if (method == "percentile") {
+    bin = PercentileThresholdBin(bins, percentile);
+  } else {
+    bin = MseThresholdBin(bins);
+  }
+  return range * bin / bins.size();
+}
+
+}  // namespace inference
+}  // namespace paddle
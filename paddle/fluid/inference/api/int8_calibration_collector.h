@@ -0,0 +1,97 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/utils/test_macros.h"
+
+namespace paddle {
+namespace inference {
+
+// Int8CalibrationCollector gathers the histograms of the absolute values of
+// the float tensors that a native predictor computes over a calibration set,
+// in a single run, and chooses from them the int8 threshold (the dynamic
+// range) of every tensor by one of the methods:
+//  - "entropy": the threshold minimizing the KL divergence between the
+//    distribution of the values and of their int8 quantization;
+//  - "percentile": the given percentile of the absolute values;
+//  - "mse": the threshold minimizing the mean squared error of the
+//    quantization and the clipping.
+// The range of a histogram is set by the first batch, and doubled by merging
+// the bins pairwise whenever a later batch exceeds it, so that the statistics
+// do not need a second run over the calibration set. The tensors on the gpu
+// are reduced to their histograms by kernels on the stream of the device, and
+// the tensors on the cpu are copied and binned in parallel on the thread pool,
+// so the calibration takes about the time of the inference.
+class Int8CalibrationCollector {
+ public:
+  TEST_API explicit Int8CalibrationCollector(const std::string& method,
+                                             float percentile = 99.99f,
+                                             int num_bins = 2048);
+
+  ~Int8CalibrationCollector();
+
+  // Adds the values of tensor to the histogram of the var name. The tensors
+  // of the types other than the floats are skipped.
+  TEST_API void Collect(const std::string& name,
+                        const phi::DenseTensor& tensor);
+
+  // var name -> threshold, after all the collected tensors are binned
+  TEST_API std::map<std::string, float> ComputeThresholds();
+
+  // Threshold of the histogram bins over [0, range] by method.
+  TEST_API static float ComputeThreshold(const std::vector<int64_t>& bins,
+                                         float range,
+                                         const std::string& method,
+                                         float percentile);
+
+ private:
+  struct Histogram {
+    std::mutex mutex;
+    float range{0.f};
+    std::vector<int64_t> bins;
+  };
+
+  Histogram* GetHistogram(const std::string& name);
+
+  // Widens the range of hist to cover abs_max, hist->mutex is held.
+  void ExpandRange(float abs_max, Histogram* hist) const;
+
+  void CollectOnCpu(const phi::DenseTensor& tensor, Histogram* hist) const;
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  void CollectOnGpu(const phi::DenseTensor& tensor, Histogram* hist) const;
+#endif
+
+  std::string method_;
+  float percentile_;
+  int num_bins_;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::unique_ptr<Histogram>> histograms_;
+  std::vector<std::future<void>> pending_;
+};
+
+}  // namespace inference
+}  // namespace paddle
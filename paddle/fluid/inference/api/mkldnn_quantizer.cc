@@ -29,6 +29,7 @@
 #include "paddle/fluid/framework/type_defs.h"
 #include "paddle/fluid/inference/analysis/analyzer.h"
 #include "paddle/fluid/inference/api/analysis_predictor.h"
+#include "paddle/fluid/inference/utils/io_utils.h"
 #include "paddle/fluid/platform/mkldnn_helper.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/utils/string/pretty_log.h"
@@ -183,6 +184,10 @@ void AnalysisPredictor::MkldnnQuantizer::CalculateScalesForOpOutputs(
 
 bool AnalysisPredictor::MkldnnQuantizer::CalculateScales() {
   PrettyLogH1("--- Calculating scales for quantization");
+  if (!qconfig_->scale_table_path().empty()) {
+    inference::DeserializeInt8ScaleTable(qconfig_->scale_table_path(),
+                                         &thresholds_);
+  }
   std::map<std::string, std::map<std::string, phi::DenseTensor>> gathered_data;
   for (const auto* op : predictor_.inference_program_->Block(0).AllOps()) {
     if (platform::HasOpINT8DataType(op)) {
@@ -213,6 +218,17 @@ void AnalysisPredictor::MkldnnQuantizer::CalculateSingleScale(
                         op_type_name,
                         conn_name));
 
+  // the threshold calibrated over the whole calibration set is taken for the
+  // algorithms of the per tensor scale
+  auto threshold = thresholds_.find(var_name);
+  if ((rule == ScaleAlgo::MAX || rule == ScaleAlgo::KL) &&
+      threshold != thresholds_.end()) {
+    phi::DenseTensor scale_tensor = CreateScaleTensor();
+    scale_tensor.data<double>()[0] = 1.0 / threshold->second;
+    scales_[var_name] = std::make_pair(is_unsigned, scale_tensor);
+    return;
+  }
+
   switch (rule) {
     case ScaleAlgo::MAX:
       scales_[var_name] = GetMaxScalingFactor(var_tensor, is_unsigned);
@@ -120,6 +120,8 @@ class AnalysisPredictor::MkldnnQuantizer {
 
   // A map: variable name -> scale
   VarQuantScale scales_;
+  // A map: variable name -> threshold, from the scale table of the config
+  std::map<std::string, float> thresholds_;
 };
 
 }  // namespace paddle
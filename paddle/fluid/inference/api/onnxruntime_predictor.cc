@@ -32,6 +32,7 @@
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/api/paddle_inference_pass.h"
 #include "paddle/fluid/inference/utils/io_utils.h"
+#include "paddle/fluid/memory/malloc.h"
 #include "paddle/fluid/memory/memcpy.h"
 #include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
@@ -60,6 +61,25 @@ paddle_infer::DataType ConvertONNXType(ONNXTensorElementDataType type) {
   }
 }
 
+size_t SizeOfONNXType(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
 bool CheckConvertToONNX(const AnalysisConfig &config) {
   if (!config.model_dir().empty()) {
     LOG(ERROR) << "Paddle2ONNX not support model_dir config";
@@ -87,9 +107,8 @@ bool CheckConvertToONNX(const AnalysisConfig &config) {
 }
 
 bool ONNXRuntimePredictor::InitBinding() {
-  // Now ONNXRuntime only support CPU
-  const char *device_name = config_.use_gpu() ? "Cuda" : "Cpu";
-  if (config_.use_gpu()) {
+  const char *device_name = use_gpu_ ? "Cuda" : "Cpu";
+  if (use_gpu_) {
     place_ = paddle::platform::CUDAPlace(config_.gpu_device_id());
   } else {
     place_ = paddle::platform::CPUPlace();
@@ -164,6 +183,20 @@ bool ONNXRuntimePredictor::Init() {
     session_options.SetGraphOptimizationLevel(
         GraphOptimizationLevel::ORT_ENABLE_ALL);
   }
+  use_gpu_ = false;
+  if (config_.use_gpu()) {
+    // The bound inputs and outputs stay on the GPU only if the session runs
+    // on the CUDA EP, which the CPU package of ONNXRuntime does not have.
+    try {
+      OrtCUDAProviderOptions cuda_options;
+      cuda_options.device_id = config_.gpu_device_id();
+      session_options.AppendExecutionProvider_CUDA(cuda_options);
+      use_gpu_ = true;
+    } catch (const Ort::Exception &e) {
+      LOG(WARNING) << "ONNXRuntime CUDA EP is unavailable, run on CPU: "
+                   << e.what();
+    }
+  }
   // Turn optimization off first, and then turn it on when it's stable
   // session_options.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
   // session_options.EnableCpuMemArena();
@@ -333,25 +366,102 @@ bool ONNXRuntimePredictor::Run(const std::vector<PaddleTensor> &inputs,
   return false;
 }
 
-bool ONNXRuntimePredictor::ZeroCopyRun() {
-  try {
-    const char *device_name = platform::is_cpu_place(place_) ? "Cpu" : "Cuda";
-    std::vector<Ort::Value> inputs;
-    inputs.reserve(input_desc_.size());
-    for (auto desc : input_desc_) {
-      inputs.push_back(GetOrtValue(desc, device_name));
-      binding_->BindInput(desc.name.c_str(), inputs.back());
+bool ONNXRuntimePredictor::BindInputs(const char *device_name) {
+  size_t n_inputs = input_desc_.size();
+  bool shape_changed = bound_input_shapes_.size() != n_inputs;
+  bool data_changed = shape_changed;
+  bound_input_shapes_.resize(n_inputs);
+  bound_input_ptrs_.resize(n_inputs);
+  for (size_t i = 0; i < n_inputs; ++i) {
+    auto *tensor =
+        scope_->FindVar(input_desc_[i].name)->GetMutable<phi::DenseTensor>();
+    std::vector<int64_t> shape = common::vectorize<int64_t>(tensor->dims());
+    const void *ptr = tensor->IsInitialized() ? tensor->data() : nullptr;
+    if (shape != bound_input_shapes_[i]) {
+      bound_input_shapes_[i] = shape;
+      shape_changed = true;
     }
-    for (auto output : output_desc_) {
+    if (ptr != bound_input_ptrs_[i]) {
+      bound_input_ptrs_[i] = ptr;
+      data_changed = true;
+    }
+  }
+  if (shape_changed || data_changed) {
+    binding_->ClearBoundInputs();
+    bound_inputs_.clear();
+    bound_inputs_.reserve(n_inputs);
+    for (auto &desc : input_desc_) {
+      bound_inputs_.push_back(GetOrtValue(desc, device_name));
+      binding_->BindInput(desc.name.c_str(), bound_inputs_.back());
+    }
+  }
+  return shape_changed;
+}
+
+void ONNXRuntimePredictor::BindOutputs(const char *device_name,
+                                       bool shape_changed) {
+  if (shape_changed) {
+    // ORT allocates the outputs of the new shapes, they are known after the run
+    binding_->ClearBoundOutputs();
+    bound_outputs_.clear();
+    output_buffers_.clear();
+    for (auto &output : output_desc_) {
       Ort::MemoryInfo out_memory_info(device_name,
                                       OrtDeviceAllocator,
                                       place_.GetDeviceId(),
                                       OrtMemTypeDefault);
       binding_->BindOutput(output.name.c_str(), out_memory_info);
     }
+    outputs_bound_ = false;
+    return;
+  }
+  if (outputs_bound_) {
+    return;
+  }
+  // The outputs of the last run are bound to the buffers of the paddle
+  // allocator, so that the runs of the same shapes reuse them.
+  std::vector<Ort::Value> last_outputs = binding_->GetOutputValues();
+  std::vector<std::shared_ptr<phi::Allocation>> buffers;
+  std::vector<Ort::Value> outputs;
+  Ort::MemoryInfo memory_info(
+      device_name, OrtDeviceAllocator, place_.GetDeviceId(), OrtMemTypeDefault);
+  for (size_t i = 0; i < output_desc_.size(); ++i) {
+    auto info = last_outputs[i].GetTensorTypeAndShapeInfo();
+    std::vector<int64_t> shape = info.GetShape();
+    size_t size =
+        info.GetElementCount() * SizeOfONNXType(output_desc_[i].dtype);
+    if (size == 0) {
+      // the outputs of an empty output stay allocated by ORT
+      outputs_bound_ = true;
+      return;
+    }
+    buffers.push_back(memory::AllocShared(place_, size));
+    outputs.push_back(Ort::Value::CreateTensor(memory_info,
+                                               buffers.back()->ptr(),
+                                               size,
+                                               shape.data(),
+                                               shape.size(),
+                                               output_desc_[i].dtype));
+  }
+  binding_->ClearBoundOutputs();
+  for (size_t i = 0; i < output_desc_.size(); ++i) {
+    binding_->BindOutput(output_desc_[i].name.c_str(), outputs[i]);
+  }
+  bound_outputs_ = std::move(outputs);
+  output_buffers_ = std::move(buffers);
+  outputs_bound_ = true;
+}
+
+bool ONNXRuntimePredictor::ZeroCopyRun() {
+  try {
+    const char *device_name = platform::is_cpu_place(place_) ? "Cpu" : "Cuda";
+    bool shape_changed = BindInputs(device_name);
+    BindOutputs(device_name, shape_changed);
     session_->Run({}, *(binding_.get()));
   } catch (const std::exception &e) {
     LOG(ERROR) << e.what();
+    // the inputs and the outputs are bound again in the next run
+    bound_input_shapes_.clear();
     return false;
   }
 
@@ -361,6 +471,7 @@ bool ONNXRuntimePredictor::ZeroCopyRun() {
 std::unique_ptr<PaddlePredictor> ONNXRuntimePredictor::Clone(void *stream) {
   std::lock_guard<std::mutex> lk(clone_mutex_);
   auto *x = new ONNXRuntimePredictor(config_, env_, session_);
+  x->use_gpu_ = use_gpu_;
   x->InitBinding();
   return std::unique_ptr<PaddlePredictor>(x);
 }
@@ -372,6 +483,9 @@ uint64_t ONNXRuntimePredictor::TryShrinkMemory() {
 ONNXRuntimePredictor::~ONNXRuntimePredictor() {
   binding_->ClearBoundInputs();
   binding_->ClearBoundOutputs();
+  bound_inputs_.clear();
+  bound_outputs_.clear();
+  output_buffers_.clear();
 
   memory::Release(place_);
 }
@@ -28,6 +28,7 @@
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/platform/device/gpu/gpu_types.h"
 #include "paddle/fluid/string/printf.h"
+#include "paddle/phi/core/allocator.h"
 #include "paddle2onnx/converter.h"
 
 #ifdef PADDLE_WITH_TESTING
@@ -223,6 +224,25 @@ class ONNXRuntimePredictor : public PaddlePredictor {
   ///
   Ort::Value GetOrtValue(const ONNXDesc &desc, const char *device_name);
 
+  ///
+  /// \brief bind the input tensors if their shapes or buffers changed.
+  ///
+  /// \param[in] device_name "Cpu" or "Cuda" of device
+  ///
+  /// \return Whether the input shapes changed
+  ///
+  bool BindInputs(const char *device_name);
+
+  ///
+  /// \brief bind the outputs to be allocated by ORT if the input shapes
+  /// changed, or else to the reused buffers of the paddle allocator.
+  ///
+  /// \param[in] device_name "Cpu" or "Cuda" of device
+  ///
+  /// \param[in] shape_changed Whether the input shapes changed
+  ///
+  void BindOutputs(const char *device_name, bool shape_changed);
+
  private:
   // ONNXRuntime
   std::shared_ptr<Ort::Env> env_;
@@ -232,8 +252,17 @@ class ONNXRuntimePredictor : public PaddlePredictor {
   AnalysisConfig config_;
   std::mutex clone_mutex_;
   platform::Place place_;
+  bool use_gpu_{false};
   std::vector<ONNXDesc> input_desc_;
   std::vector<ONNXDesc> output_desc_;
+  // the shapes and the buffers of the bound inputs
+  std::vector<std::vector<int64_t>> bound_input_shapes_;
+  std::vector<const void *> bound_input_ptrs_;
+  std::vector<Ort::Value> bound_inputs_;
+  // the outputs bound to the buffers of the paddle allocator
+  std::vector<std::shared_ptr<phi::Allocation>> output_buffers_;
+  std::vector<Ort::Value> bound_outputs_;
+  bool outputs_bound_{false};
   int predictor_id_;
 
 // Some more detailed tests, they are made the friends of the predictor, so that
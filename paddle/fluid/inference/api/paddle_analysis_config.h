@@ -283,6 +283,23 @@ struct PD_INFER_DECL AnalysisConfig {
     save_optimized_model_ = save_optimized_model;
   }
   ///
+  /// \brief Load the optimized model saved by EnableSaveOptimModel from the
+  /// optimization cache directory, or the directory of the model, and skip
+  /// the ir optimization, if it was saved with the same config, hardware and
+  /// version. Otherwise the model is optimized as usual.
+  ///
+  /// \param load_optimized_model whether to enable load optimized model.
+  ///
+  void EnableLoadOptimModel(bool load_optimized_model) {
+    load_optimized_model_ = load_optimized_model;
+  }
+  ///
+  /// \brief A boolean state telling whether to load the optimized model.
+  ///
+  /// \return bool Whether to load the optimized model.
+  ///
+  bool load_optimized_model() const { return load_optimized_model_; }
+  ///
   /// \brief Set the path of optimization cache directory.
   ///
   /// \param opt_cache_dir the path of optimization cache directory.
@@ -495,6 +512,34 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   void Exp_EnableUseCutlass();
   ///
+  /// \brief Run the program on GPU by the CUDA Graphs captured from it, so
+  /// that the kernels of a run are launched at once. The batch dim, which is
+  /// the first dim of all inputs, is padded to the smallest bucket not less
+  /// than it, and a graph is captured for every bucket and the other dims of
+  /// the inputs on the first run of them. A batch larger than all buckets is
+  /// run without graphs. It works for ZeroCopyRun of the program without
+  /// host syncs, and not with the new executor. The stream of the predictor
+  /// should not be used by others in the capture, e.g. it is set by
+  /// SetExecStream when predictors run in multiple threads.
+  ///
+  /// \param batch_buckets The batch sizes to pad the inputs to.
+  ///
+  void EnableCudaGraph(const std::vector<int>& batch_buckets);
+  ///
+  /// \brief A boolean state telling whether CUDA Graphs are used.
+  ///
+  /// \return bool Whether CUDA Graphs are used.
+  ///
+  bool cuda_graph_enabled() const { return use_cuda_graph_; }
+  ///
+  /// \brief The batch sizes the inputs are padded to for CUDA Graphs.
+  ///
+  /// \return const std::vector<int>& The sorted batch buckets.
+  ///
+  const std::vector<int>& cuda_graph_buckets() const {
+    return cuda_graph_buckets_;
+  }
+  ///
   ///
   /// \brief A boolean state telling whether the XPU is turned on.
   ///
@@ -715,6 +760,24 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool trt_engine_memory_sharing() const;
   ///
+  /// \brief Share the activation memory of the TensorRT engines with the
+  /// other ops, when the memory optimization and the TensorRT engine memory
+  /// sharing are enabled. The inputs and outputs of the engines join the
+  /// reuse plan of memory_optimize_pass, which is made by the lifetimes of
+  /// the tensors in the execution order, and the context memory of an engine
+  /// is allocated from the memory pool of the stream only while the engine
+  /// runs, so that it is reused by the other engines and ops at other times.
+  /// It is not used with the CUDA Graph of TensorRT.
+  ///
+  /// \param x Whether to share the activation memory of the engines.
+  ///
+  void EnableTensorRtActivationSharing(bool x = true);
+  ///
+  /// \brief A boolean state telling whether the activation memory of the
+  /// TensorRT engines is shared with the other ops.
+  ///
+  bool trt_activation_sharing() const;
+  ///
   /// \brief  Get the TensorRT engine precision.
   ///
   /// \return Precision Get the TensorRT engine precision.
@@ -765,6 +828,22 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool trt_allow_build_at_runtime() const;
 
+  ///
+  /// \brief Build the trt engines at runtime on background threads, when
+  /// building them at runtime is allowed. The subgraph of an engine runs by
+  /// Paddle while the engine is built with an extra optimization profile
+  /// for the input shapes out of the range of its profiles, and the engine is
+  /// swapped with the built one, and the serialized one updated if it is
+  /// used, on the first run after it is built.
+  ///
+  void EnableTensorRtBuildInBackground();
+
+  ///
+  /// \brief A boolean state telling whether to build trt engines at runtime
+  /// on background threads.
+  ///
+  bool trt_build_in_background() const;
+
   ///
   /// \brief Set execution stream. If not set a stream will be created
   /// internally.
@@ -784,6 +863,34 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool external_stream_enabled() const;
 
+  ///
+  /// \brief Give the predictor, and each of its clones, a gpu stream of its
+  /// own, with its own cuBLAS/cuDNN handles and workspace, while the clones
+  /// still share the weights. So the clones serving concurrent requests on
+  /// one gpu do not serialize on the stream and the handles of the global
+  /// device context. It takes effect when SetExecStream is not set.
+  ///
+  /// \param priority The priority of the streams, the lower value the higher
+  /// priority, e.g. -1 for the latency critical tenants. It is clamped to the
+  /// range of the device.
+  /// \param non_blocking Whether the streams do not synchronize with the
+  /// legacy default stream, which keeps the independent clients, e.g. of
+  /// MPS, from waiting on each other.
+  ///
+  void EnablePrivateStream(int priority = 0, bool non_blocking = true);
+
+  ///
+  /// \brief A boolean state telling whether the predictor and its clones own
+  /// private streams.
+  ///
+  bool private_stream_enabled() const { return use_private_stream_; }
+
+  int private_stream_priority() const { return private_stream_priority_; }
+
+  bool private_stream_non_blocking() const {
+    return private_stream_non_blocking_;
+  }
+
   ///
   /// \brief Collect shape info of all tensors in compute graph.
   ///
@@ -805,6 +912,83 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool shape_range_info_collected() const;
 
+  ///
+  /// \brief Collect the int8 thresholds of all the float tensors in the
+  /// compute graph over the calibration inputs run by the predictor, and save
+  /// them to a scale table when the predictor is destroyed.
+  ///
+  /// \param scale_table_path the path to save the scale table.
+  /// \param method the calibration method, "entropy", "percentile" or "mse".
+  /// \param percentile the percentile of the absolute values taken as the
+  /// threshold by the percentile method.
+  ///
+  void CollectInt8Calibration(const std::string& scale_table_path,
+                              const std::string& method = "entropy",
+                              float percentile = 99.99f);
+
+  ///
+  /// \brief A boolean state telling whether to collect the int8 thresholds.
+  ///
+  bool int8_calibration_collected() const;
+
+  ///
+  /// \brief The path to save the scale table in CollectInt8Calibration mode.
+  ///
+  const std::string& int8_calibration_table_path() const;
+
+  ///
+  /// \brief The calibration method in CollectInt8Calibration mode.
+  ///
+  const std::string& int8_calibration_method() const;
+
+  ///
+  /// \brief The percentile of the percentile calibration method.
+  ///
+  float int8_calibration_percentile() const;
+
+  ///
+  /// \brief Export the GPU parameters of the predictor to the ipc params file
+  /// once it is created, so that the predictors of other processes bind their
+  /// parameters to the same GPU memory by ImportSharedGpuParams. The
+  /// exporting process has to outlive the importing ones.
+  ///
+  /// \param ipc_params_path the path to save the ipc params file.
+  ///
+  void ExportSharedGpuParams(const std::string& ipc_params_path);
+
+  ///
+  /// \brief The path to save the ipc params file of the GPU parameters.
+  ///
+  const std::string& shared_gpu_params_export_path() const;
+
+  ///
+  /// \brief Bind the GPU parameters to the memory exported by another process
+  /// in the ipc params file instead of copying them to the GPU, the parameters
+  /// are shared read only. A parameter not in the file is copied as usual.
+  ///
+  /// \param ipc_params_path the path to the ipc params file.
+  ///
+  void ImportSharedGpuParams(const std::string& ipc_params_path);
+
+  ///
+  /// \brief The path to the ipc params file of the shared GPU parameters.
+  ///
+  const std::string& shared_gpu_params_import_path() const;
+
+  ///
+  /// \brief Set the dynamic ranges of the tensors in the int8 Paddle-TRT
+  /// engines by a scale table saved in CollectInt8Calibration mode, instead of
+  /// the TensorRT calibration.
+  ///
+  /// \param scale_table_path the path to the scale table.
+  ///
+  void SetTensorRtInt8ScaleTable(const std::string& scale_table_path);
+
+  ///
+  /// \brief The path to the scale table of the int8 Paddle-TRT engines.
+  ///
+  const std::string& tensorrt_int8_scale_table_path() const;
+
   ///
   /// \brief Prevent ops running in Paddle-TRT
   /// NOTE: just experimental, not an official stable API, easy to be broken.
@@ -881,6 +1065,54 @@ struct PD_INFER_DECL AnalysisConfig {
 
   bool new_executor_enabled() const { return use_new_executor_; }
 
+  ///
+  /// \brief Overlap the independent branches of the program, e.g. the towers
+  /// of a two-tower model or the heads of a detector, on num_streams gpu
+  /// streams. The branches are found from the data flow of the program and
+  /// synchronized by events. It takes effect with the new executor on gpu.
+  ///
+  /// \param num_streams The streams to run the kernels on, including the
+  /// default stream.
+  ///
+  void EnableMultiStream(int num_streams = 4);
+
+  ///
+  /// \brief A boolean state telling whether the branches are overlapped on
+  /// multiple streams.
+  ///
+  /// \return bool Whether the branches are overlapped on multiple streams.
+  ///
+  bool multi_stream_enabled() const { return multi_stream_num_ > 1; }
+
+  ///
+  /// \brief The streams the branches are overlapped on.
+  ///
+  /// \return int The streams, including the default stream.
+  ///
+  int multi_stream_num() const { return multi_stream_num_; }
+
+  ///
+  /// \brief Keep the capacities of the intermediate tensors across the runs
+  /// of dynamic shapes. A tensor whose memory grows in a run is given
+  /// growth_ratio times the memory it needs, so that the following slightly
+  /// larger requests do not reallocate it. If shrink_window > 0, the memory of
+  /// a tensor larger than shrink_ratio times what it needs in each of the last
+  /// shrink_window runs is released. It does not take effect with the new
+  /// executor, which frees the intermediate tensors in every run.
+  ///
+  /// \param growth_ratio The ratio of the memory given to a growing tensor.
+  /// \param shrink_ratio The ratio of the unused memory to release.
+  /// \param shrink_window The runs to check before releasing, 0 to never
+  /// release the memory.
+  ///
+  void EnableTensorCapacityRetention(float growth_ratio = 1.5f,
+                                     float shrink_ratio = 4.f,
+                                     int shrink_window = 0);
+
+  bool tensor_capacity_retention_enabled() const {
+    return retain_tensor_capacity_;
+  }
+
   void EnableDlnne(
       int min_subgraph_size = 3,
       int max_batch_size = 1,
@@ -972,6 +1204,31 @@ struct PD_INFER_DECL AnalysisConfig {
     return cpu_math_library_num_threads_;
   }
 
+  ///
+  /// \brief Bind the threads of the predictor to cpus, and allocate the memory
+  /// of the predictor, including the weights, from a numa node. The cpu math
+  /// library threads are bound one to a cpu, and the work queue threads of the
+  /// new executor are bound to all the cpus.
+  ///
+  /// \param cpu_ids The cpus to bind to, all the cpus of numa_node if it is
+  /// empty.
+  /// \param numa_node The numa node to allocate memory from, -1 means the
+  /// memory is not bound.
+  ///
+  void SetCpuAffinity(const std::vector<int>& cpu_ids, int numa_node = -1);
+  ///
+  /// \brief The cpus the threads of the predictor are bound to.
+  ///
+  /// \return const std::vector<int>& The cpus, empty if not bound.
+  ///
+  const std::vector<int>& cpu_affinity() const { return cpu_affinity_; }
+  ///
+  /// \brief The numa node the memory of the predictor is allocated from.
+  ///
+  /// \return int The numa node, -1 if not bound.
+  ///
+  int cpu_numa_node() const { return cpu_numa_node_; }
+
   ///
   /// \brief Transform the AnalysisConfig to NativeConfig.
   ///
@@ -1218,6 +1475,8 @@ struct PD_INFER_DECL AnalysisConfig {
   // GPU related.
   bool use_gpu_{false};
   bool use_cutlass_{false};
+  bool use_cuda_graph_{false};
+  std::vector<int> cuda_graph_buckets_;
   int gpu_device_id_{0};
   uint64_t memory_pool_init_size_mb_{100};  // initial size is 100MB.
   bool enable_gpu_mixed_{false};
@@ -1226,6 +1485,9 @@ struct PD_INFER_DECL AnalysisConfig {
   bool use_cudnn_{false};
   bool use_external_stream_{false};
   void* exec_stream_{nullptr};
+  bool use_private_stream_{false};
+  int private_stream_priority_{0};
+  bool private_stream_non_blocking_{true};
 
   // CustomDevice related
   bool use_custom_device_{false};
@@ -1273,6 +1535,7 @@ struct PD_INFER_DECL AnalysisConfig {
   std::vector<std::string> trt_disabled_ops_{};
   bool disable_trt_plugin_fp16_{false};
   bool trt_allow_build_at_runtime_{false};
+  bool trt_build_in_background_{false};
   // tune to get dynamic_shape info.
   bool trt_tuned_dynamic_shape_{false};
   bool trt_use_inspector_{false};
@@ -1286,6 +1549,20 @@ struct PD_INFER_DECL AnalysisConfig {
   bool collect_shape_range_info_{false};
   std::string shape_range_info_path_;
 
+  // In CollectInt8Calibration mode, we will collect the histograms of all the
+  // float tensors in the compute graph, and save their int8 thresholds by
+  // int8_calibration_method_ in int8_calibration_table_path_.
+  bool collect_int8_calibration_{false};
+  std::string int8_calibration_table_path_;
+  std::string int8_calibration_method_{"entropy"};
+  float int8_calibration_percentile_{99.99f};
+  std::string trt_int8_scale_table_path_;
+
+  // The GPU parameters are exported to or imported from the ipc params file
+  // to share one copy of them among the processes on a GPU.
+  std::string shared_gpu_params_export_path_;
+  std::string shared_gpu_params_import_path_;
+
   // dlnne related.
   bool use_dlnne_{false};
   int dlnne_min_subgraph_size_{3};
@@ -1300,6 +1577,7 @@ struct PD_INFER_DECL AnalysisConfig {
   // memory reuse related.
   bool enable_memory_optim_{false};
   bool trt_engine_memory_sharing_{true};
+  bool trt_activation_sharing_{false};
   int trt_engine_memory_sharing_identifier_{0};
 
   std::unordered_set<std::string> trt_ops_run_float_;
@@ -1317,10 +1595,18 @@ struct PD_INFER_DECL AnalysisConfig {
   bool ir_debug_{false};
 
   bool use_new_executor_{false};
+  int multi_stream_num_{1};
+
+  bool retain_tensor_capacity_{false};
+  float tensor_growth_ratio_{1.5f};
+  float tensor_shrink_ratio_{4.f};
+  int tensor_shrink_window_{0};
 
   bool specify_input_name_{false};
 
   int cpu_math_library_num_threads_{1};
+  std::vector<int> cpu_affinity_;
+  int cpu_numa_node_{-1};
 
   bool with_profile_{false};
 
@@ -1401,6 +1687,7 @@ struct PD_INFER_DECL AnalysisConfig {
   // So we release the memory when the predictor is set up.
   mutable bool is_valid_{true};
   bool save_optimized_model_{false};
+  bool load_optimized_model_{false};
   std::string opt_cache_dir_;
   friend class paddle_infer::experimental::InternalUtils;
 
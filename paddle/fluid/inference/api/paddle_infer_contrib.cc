@@ -14,6 +14,10 @@
 
 #include "paddle/fluid/inference/api/paddle_infer_contrib.h"
 
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/memory/memcpy.h"
 #include "paddle/fluid/platform/device_context.h"
@@ -290,5 +294,381 @@ bool Status::operator!=(const Status& x) const noexcept {
   return !(*this == x);
 }
 
+namespace {
+
+size_t HashTokens(size_t hash, const int64_t* token_ids, int num_tokens) {
+  for (int i = 0; i < num_tokens; ++i) {
+    hash ^= std::hash<int64_t>()(token_ids[i]) + 0x9e3779b9 + (hash << 6) +
+            (hash >> 2);
+  }
+  return hash;
+}
+
+}  // namespace
+
+struct KVCacheBlockManager::Impl {
+  struct Block {
+    int ref_count{0};
+    // a cached block is found by the hash of its tokens chained with the
+    // hash of the blocks before it
+    bool cached{false};
+    size_t hash{0};
+    size_t prev_hash{0};
+    std::vector<int64_t> token_ids;
+    // a cached block used by no sequence is kept in evictable
+    bool evictable{false};
+    std::list<int>::iterator lru_pos;
+  };
+
+  struct PendingBlock {
+    int block_id;
+    size_t hash;
+    size_t prev_hash;
+    std::vector<int64_t> token_ids;
+  };
+
+  struct Sequence {
+    std::vector<int> blocks;
+    int num_tokens{0};
+    // the full blocks of the prompt cached by MarkComputed
+    std::vector<PendingBlock> pending;
+  };
+
+  Sequence& GetSequence(int64_t seq_id) {
+    auto it = sequences.find(seq_id);
+    PADDLE_ENFORCE_NE(it,
+                      sequences.end(),
+                      paddle::platform::errors::NotFound(
+                          "The sequence %d is not in KVCacheBlockManager.",
+                          seq_id));
+    return it->second;
+  }
+
+  int NumFreeBlocks() const {
+    return static_cast<int>(free_blocks.size() + evictable.size());
+  }
+
+  // take a free block, or evict the least recently used cached block
+  int Allocate() {
+    int block_id = -1;
+    if (!free_blocks.empty()) {
+      block_id = free_blocks.back();
+      free_blocks.pop_back();
+    } else {
+      PADDLE_ENFORCE_EQ(evictable.empty(),
+                        false,
+                        paddle::platform::errors::ResourceExhausted(
+                            "All the %d blocks of KVCacheBlockManager are "
+                            "used.",
+                            blocks.size()));
+      block_id = evictable.front();
+      evictable.pop_front();
+      auto& block = blocks[block_id];
+      cached_blocks.erase(block.hash);
+      block = Block();
+    }
+    blocks[block_id].ref_count = 1;
+    return block_id;
+  }
+
+  void Acquire(int block_id) {
+    auto& block = blocks[block_id];
+    if (block.evictable) {
+      evictable.erase(block.lru_pos);
+      block.evictable = false;
+    }
+    ++block.ref_count;
+  }
+
+  void Release(int block_id) {
+    auto& block = blocks[block_id];
+    PADDLE_ENFORCE_GT(block.ref_count,
+                      0,
+                      paddle::platform::errors::PreconditionNotMet(
+                          "The block %d of KVCacheBlockManager is released "
+                          "more than allocated.",
+                          block_id));
+    if (--block.ref_count > 0) {
+      return;
+    }
+    if (block.cached) {
+      block.lru_pos = evictable.insert(evictable.end(), block_id);
+      block.evictable = true;
+    } else {
+      free_blocks.push_back(block_id);
+    }
+  }
+
+  int block_size;
+  std::vector<Block> blocks;
+  std::vector<int> free_blocks;
+  // the least recently used first
+  std::list<int> evictable;
+  std::unordered_map<size_t, int> cached_blocks;
+  std::unordered_map<int64_t, Sequence> sequences;
+};
+
+KVCacheBlockManager::KVCacheBlockManager(int num_blocks, int block_size)
+    : impl_(new Impl) {
+  PADDLE_ENFORCE_EQ(
+      num_blocks > 0 && block_size > 0,
+      true,
+      paddle::platform::errors::InvalidArgument(
+          "The num_blocks and block_size of KVCacheBlockManager should be "
+          "positive, but received num_blocks %d and block_size %d.",
+          num_blocks,
+          block_size));
+  impl_->block_size = block_size;
+  impl_->blocks.resize(num_blocks);
+  // the blocks are allocated from 0
+  for (int i = num_blocks - 1; i >= 0; --i) {
+    impl_->free_blocks.push_back(i);
+  }
+}
+
+KVCacheBlockManager::~KVCacheBlockManager() = default;
+
+int KVCacheBlockManager::block_size() const { return impl_->block_size; }
+
+int KVCacheBlockManager::num_blocks() const {
+  return static_cast<int>(impl_->blocks.size());
+}
+
+int KVCacheBlockManager::NumFreeBlocks() const {
+  return impl_->NumFreeBlocks();
+}
+
+bool KVCacheBlockManager::AddSequence(int64_t seq_id,
+                                      const std::vector<int64_t>& token_ids,
+                                      int* num_cached_tokens) {
+  PADDLE_ENFORCE_EQ(impl_->sequences.count(seq_id),
+                    0,
+                    paddle::platform::errors::AlreadyExists(
+                        "The sequence %d is in KVCacheBlockManager already.",
+                        seq_id));
+  PADDLE_ENFORCE_GT(token_ids.size(),
+                    0,
+                    paddle::platform::errors::InvalidArgument(
+                        "The prompt of the sequence %d is empty.", seq_id));
+  int block_size = impl_->block_size;
+  int num_tokens = static_cast<int>(token_ids.size());
+  int num_needed = (num_tokens + block_size - 1) / block_size;
+  // the last token is always computed to get the logits of the prompt
+  int num_full = (num_tokens - 1) / block_size;
+
+  std::vector<size_t> hashes(num_full);
+  size_t hash = 0;
+  for (int i = 0; i < num_full; ++i) {
+    hash = HashTokens(hash, token_ids.data() + i * block_size, block_size);
+    hashes[i] = hash;
+  }
+  std::vector<int> shared;
+  int num_reused = 0;
+  for (int i = 0; i < num_full; ++i) {
+    auto it = impl_->cached_blocks.find(hashes[i]);
+    if (it == impl_->cached_blocks.end()) {
+      break;
+    }
+    const auto& block = impl_->blocks[it->second];
+    if (block.prev_hash != (i == 0 ? 0 : hashes[i - 1]) ||
+        !std::equal(block.token_ids.begin(),
+                    block.token_ids.end(),
+                    token_ids.begin() + i * block_size)) {
+      break;
+    }
+    shared.push_back(it->second);
+    num_reused += block.evictable ? 1 : 0;
+  }
+  int num_shared = static_cast<int>(shared.size());
+  if (num_needed - num_shared > impl_->NumFreeBlocks() - num_reused) {
+    return false;
+  }
+
+  auto& seq = impl_->sequences[seq_id];
+  seq.num_tokens = num_tokens;
+  for (int block_id : shared) {
+    impl_->Acquire(block_id);
+    seq.blocks.push_back(block_id);
+  }
+  for (int i = num_shared; i < num_needed; ++i) {
+    int block_id = impl_->Allocate();
+    seq.blocks.push_back(block_id);
+    if (i < num_full) {
+      auto begin = token_ids.begin() + i * block_size;
+      seq.pending.push_back({block_id,
+                             hashes[i],
+                             i == 0 ? 0 : hashes[i - 1],
+                             std::vector<int64_t>(begin, begin + block_size)});
+    }
+  }
+  if (num_cached_tokens != nullptr) {
+    *num_cached_tokens = num_shared * block_size;
+  }
+  return true;
+}
+
+void KVCacheBlockManager::MarkComputed(int64_t seq_id) {
+  auto& seq = impl_->GetSequence(seq_id);
+  for (auto& pending : seq.pending) {
+    // the same prefix may be cached by another sequence computed meanwhile
+    if (impl_->cached_blocks.count(pending.hash)) {
+      continue;
+    }
+    auto& block = impl_->blocks[pending.block_id];
+    block.cached = true;
+    block.hash = pending.hash;
+    block.prev_hash = pending.prev_hash;
+    block.token_ids = std::move(pending.token_ids);
+    impl_->cached_blocks[pending.hash] = pending.block_id;
+  }
+  seq.pending.clear();
+}
+
+void KVCacheBlockManager::ForkSequence(int64_t parent_id, int64_t child_id) {
+  PADDLE_ENFORCE_EQ(impl_->sequences.count(child_id),
+                    0,
+                    paddle::platform::errors::AlreadyExists(
+                        "The sequence %d is in KVCacheBlockManager already.",
+                        child_id));
+  const auto& parent = impl_->GetSequence(parent_id);
+  Impl::Sequence child;
+  child.blocks = parent.blocks;
+  child.num_tokens = parent.num_tokens;
+  for (int block_id : child.blocks) {
+    impl_->Acquire(block_id);
+  }
+  impl_->sequences.emplace(child_id, std::move(child));
+}
+
+void KVCacheBlockManager::ReorderBeams(const std::vector<int64_t>& seq_ids,
+                                       const std::vector<int>& parent_idx) {
+  PADDLE_ENFORCE_EQ(
+      seq_ids.size(),
+      parent_idx.size(),
+      paddle::platform::errors::InvalidArgument(
+          "The parent_idx of ReorderBeams should be as many as the seq_ids "
+          "%d, but received %d.",
+          seq_ids.size(),
+          parent_idx.size()));
+  const int num_beams = static_cast<int>(seq_ids.size());
+  std::vector<Impl::Sequence> parents(num_beams);
+  for (int i = 0; i < num_beams; ++i) {
+    PADDLE_ENFORCE_EQ(
+        parent_idx[i] >= 0 && parent_idx[i] < num_beams,
+        true,
+        paddle::platform::errors::InvalidArgument(
+            "The parent_idx of ReorderBeams should be in [0, %d), but "
+            "received %d.",
+            num_beams,
+            parent_idx[i]));
+    const auto& parent = impl_->GetSequence(seq_ids[parent_idx[i]]);
+    parents[i].blocks = parent.blocks;
+    parents[i].num_tokens = parent.num_tokens;
+  }
+  // the new blocks are acquired before the old ones are released, so that
+  // the blocks kept by some beam are never freed
+  for (int i = 0; i < num_beams; ++i) {
+    for (int block_id : parents[i].blocks) {
+      impl_->Acquire(block_id);
+    }
+  }
+  for (int i = 0; i < num_beams; ++i) {
+    auto& seq = impl_->GetSequence(seq_ids[i]);
+    for (int block_id : seq.blocks) {
+      impl_->Release(block_id);
+    }
+    seq = std::move(parents[i]);
+  }
+}
+
+bool KVCacheBlockManager::AppendTokens(
+    int64_t seq_id, int num_tokens, std::vector<std::pair<int, int>>* copies) {
+  PADDLE_ENFORCE_NOT_NULL(copies,
+                          paddle::platform::errors::InvalidArgument(
+                              "The copies of AppendTokens should not be "
+                              "nullptr."));
+  PADDLE_ENFORCE_GE(num_tokens,
+                    0,
+                    paddle::platform::errors::InvalidArgument(
+                        "The tokens appended should not be negative, but "
+                        "received %d.",
+                        num_tokens));
+  auto& seq = impl_->GetSequence(seq_id);
+  if (num_tokens == 0) {
+    return true;
+  }
+  int block_size = impl_->block_size;
+  int num_needed = (seq.num_tokens + num_tokens + block_size - 1) / block_size -
+                   static_cast<int>(seq.blocks.size());
+  // the last block is partially filled and shared with another sequence
+  bool copy_on_write = seq.num_tokens % block_size != 0 &&
+                       impl_->blocks[seq.blocks.back()].ref_count > 1;
+  if (num_needed + (copy_on_write ? 1 : 0) > impl_->NumFreeBlocks()) {
+    return false;
+  }
+  if (copy_on_write) {
+    int src = seq.blocks.back();
+    int dst = impl_->Allocate();
+    impl_->Release(src);
+    seq.blocks.back() = dst;
+    copies->emplace_back(src, dst);
+  }
+  for (int i = 0; i < num_needed; ++i) {
+    seq.blocks.push_back(impl_->Allocate());
+  }
+  seq.num_tokens += num_tokens;
+  return true;
+}
+
+void KVCacheBlockManager::FreeSequence(int64_t seq_id) {
+  auto& seq = impl_->GetSequence(seq_id);
+  // the last blocks of a prefix are evicted before the first ones
+  for (auto it = seq.blocks.rbegin(); it != seq.blocks.rend(); ++it) {
+    impl_->Release(*it);
+  }
+  impl_->sequences.erase(seq_id);
+}
+
+bool KVCacheBlockManager::HasSequence(int64_t seq_id) const {
+  return impl_->sequences.count(seq_id) > 0;
+}
+
+int KVCacheBlockManager::NumTokens(int64_t seq_id) const {
+  return impl_->GetSequence(seq_id).num_tokens;
+}
+
+const std::vector<int>& KVCacheBlockManager::BlockTable(int64_t seq_id) const {
+  return impl_->GetSequence(seq_id).blocks;
+}
+
+void KVCacheBlockManager::GetBlockTables(const std::vector<int64_t>& seq_ids,
+                                         int max_blocks_per_seq,
+                                         int* block_tables) const {
+  for (size_t i = 0; i < seq_ids.size(); ++i) {
+    const auto& blocks = impl_->GetSequence(seq_ids[i]).blocks;
+    PADDLE_ENFORCE_LE(
+        blocks.size(),
+        static_cast<size_t>(max_blocks_per_seq),
+        paddle::platform::errors::OutOfRange(
+            "The sequence %d has %d blocks, more than max_blocks_per_seq %d.",
+            seq_ids[i],
+            blocks.size(),
+            max_blocks_per_seq));
+    int* row = block_tables + i * max_blocks_per_seq;
+    std::copy(blocks.begin(), blocks.end(), row);
+    std::fill(row + blocks.size(), row + max_blocks_per_seq, -1);
+  }
+}
+
+void KVCacheBlockManager::GetBlockTables(const std::vector<int64_t>& seq_ids,
+                                         int max_blocks_per_seq,
+                                         Tensor* block_tables) const {
+  std::vector<int> data(seq_ids.size() * max_blocks_per_seq);
+  GetBlockTables(seq_ids, max_blocks_per_seq, data.data());
+  block_tables->Reshape(
+      {static_cast<int>(seq_ids.size()), max_blocks_per_seq});
+  block_tables->CopyFromCpu(data.data());
+}
+
 }  // namespace contrib
 }  // namespace paddle_infer
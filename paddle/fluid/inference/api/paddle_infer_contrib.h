@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "paddle_inference_api.h"  // NOLINT
 
 namespace paddle_infer {
@@ -109,6 +113,116 @@ class Status {
   std::shared_ptr<Impl> impl_;
 };
 
+///
+/// \brief The paged key/value caches of the block_multi_head_attention op
+/// of a predictor are split into num_blocks blocks of block_size tokens,
+/// i.e. the caches are [num_blocks, num_head, block_size, head_dim]. The
+/// KVCacheBlockManager allocates the blocks to the sequences of a serving
+/// scheduler, and gives the block tables fed to the op.
+///
+/// The blocks are shared by reference counts:
+///   * A forked sequence, e.g. a beam or a parallel sample, shares all the
+///     blocks of its parent. The last block is copied on write when one of
+///     them appends tokens to it.
+///   * The full blocks of the prompts are cached by their token ids once the
+///     sequence is marked computed, and a new sequence with the same prefix
+///     shares them instead of computing them again. A cached block is kept
+///     after all its sequences are freed, and it is evicted in the LRU order
+///     when no free block is left.
+///
+/// It is not thread safe, it is meant to be driven by one scheduler thread.
+///
+class KVCacheBlockManager {
+ public:
+  KVCacheBlockManager(int num_blocks, int block_size);
+  ~KVCacheBlockManager();
+
+  KVCacheBlockManager(const KVCacheBlockManager&) = delete;
+  KVCacheBlockManager& operator=(const KVCacheBlockManager&) = delete;
+
+  int block_size() const;
+  int num_blocks() const;
+  ///
+  /// \brief The blocks which can be allocated now, including the cached ones
+  /// not used by any sequence.
+  ///
+  int NumFreeBlocks() const;
+
+  ///
+  /// \brief Add a new sequence of the prompt token_ids.
+  ///
+  /// \param num_cached_tokens The leading tokens whose keys and values are in
+  /// the shared cached blocks already, so that the prefill only computes the
+  /// rest. The last token of the prompt is never cached. Can be nullptr.
+  /// \return false if there are not enough free blocks, then nothing is
+  /// allocated, and the sequence should wait or other ones be freed.
+  ///
+  bool AddSequence(int64_t seq_id,
+                   const std::vector<int64_t>& token_ids,
+                   int* num_cached_tokens = nullptr);
+
+  ///
+  /// \brief Cache the full blocks of the prompt of the sequence to be shared
+  /// by the later sequences, it should be called after the prefill writes
+  /// them.
+  ///
+  void MarkComputed(int64_t seq_id);
+
+  ///
+  /// \brief Add a sequence child sharing all the blocks of parent.
+  ///
+  void ForkSequence(int64_t parent_id, int64_t child_id);
+
+  ///
+  /// \brief Reorder the beams seq_ids after a step of beam search, the beam
+  /// seq_ids[i] takes the blocks and tokens of the beam
+  /// seq_ids[parent_idx[i]], e.g. the parent_idx of fused_beam_search_step.
+  /// The block tables are swapped by reference, no cache is copied, and the
+  /// last blocks shared by several beams are copied on write by the next
+  /// AppendTokens.
+  ///
+  void ReorderBeams(const std::vector<int64_t>& seq_ids,
+                    const std::vector<int>& parent_idx);
+
+  ///
+  /// \brief Allocate the blocks for num_tokens more tokens of the sequence.
+  ///
+  /// \param copies The (src, dst) blocks to be copied in the caches before the
+  /// tokens are written, when the last block shared with another sequence is
+  /// copied on write.
+  /// \return false if there are not enough free blocks, then nothing is
+  /// allocated.
+  ///
+  bool AppendTokens(int64_t seq_id,
+                    int num_tokens,
+                    std::vector<std::pair<int, int>>* copies);
+
+  ///
+  /// \brief Free the blocks of the sequence, e.g. when it finishes or it is
+  /// preempted.
+  ///
+  void FreeSequence(int64_t seq_id);
+
+  bool HasSequence(int64_t seq_id) const;
+  int NumTokens(int64_t seq_id) const;
+  const std::vector<int>& BlockTable(int64_t seq_id) const;
+
+  ///
+  /// \brief Fill the int32 block_tables [seq_ids.size(), max_blocks_per_seq]
+  /// of block_multi_head_attention, the unused entries are -1.
+  ///
+  void GetBlockTables(const std::vector<int64_t>& seq_ids,
+                      int max_blocks_per_seq,
+                      int* block_tables) const;
+  void GetBlockTables(const std::vector<int64_t>& seq_ids,
+                      int max_blocks_per_seq,
+                      Tensor* block_tables) const;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
 ///
 /// \brief A wrapper used to provide exception safety.
 ///
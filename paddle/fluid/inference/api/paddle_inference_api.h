@@ -248,6 +248,47 @@ PD_INFER_DECL void ConvertToMixedPrecision(
     std::unordered_set<std::string> black_list = {},
     std::unordered_set<std::string> white_list = {});
 
+///
+/// \brief Convert a fp32 model to the mixed precision by the latencies of its
+/// ops measured on the device instead of the lists of ops. Every op is run at
+/// fp32 and at the low precision on the tensors it sees on the first
+/// calibration input, and the ops are converted where the gains outweigh the
+/// casts around them. The converted ops of the least gains are kept at fp32
+/// until the max errors of the outputs on all the calibration inputs, relative
+/// to the max magnitudes of the fp32 outputs, are within accuracy_tolerance.
+///
+/// \param calibration_inputs The inputs of the model, each of which is the
+/// PaddleTensors named by the feed targets.
+/// \param accuracy_tolerance The max relative error of the outputs.
+///
+PD_INFER_DECL void ConvertToMixedPrecisionByProfile(
+    const std::string& model_file,
+    const std::string& params_file,
+    const std::string& mixed_model_file,
+    const std::string& mixed_params_file,
+    PrecisionType mixed_precision,
+    PlaceType backend,
+    const std::vector<std::vector<paddle::PaddleTensor>>& calibration_inputs,
+    float accuracy_tolerance = 1e-2,
+    bool keep_io_types = true,
+    std::unordered_set<std::string> black_list = {},
+    std::unordered_set<std::string> white_list = {});
+
+///
+/// \brief Convert the combined params of a model to the mmap format. The
+/// predictors loading the converted params map them instead of reading them,
+/// so that the predictors of the model in all processes share one copy of the
+/// params in memory.
+///
+/// \param model_file The model file.
+/// \param params_file The combined params file of the model.
+/// \param mmap_params_file The params file of the mmap format to save, which
+/// is used as the params file of the model afterwards.
+///
+PD_INFER_DECL void ConvertToMmapParams(const std::string& model_file,
+                                       const std::string& params_file,
+                                       const std::string& mmap_params_file);
+
 namespace services {
 ///
 /// \class PredictorPool
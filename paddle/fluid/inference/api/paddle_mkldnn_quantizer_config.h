@@ -190,6 +190,26 @@ struct PD_INFER_DECL MkldnnQuantizerConfig {
   ///
   ScaleAlgo default_scale_algo() const { return default_scale_algo_; }
 
+  ///
+  /// \brief Set the int8 scale table
+  ///
+  /// Take the thresholds of the tensors from a scale table saved by
+  /// AnalysisConfig::CollectInt8Calibration, in place of the statistics of the
+  /// warm-up batch by the MAX and KL algorithms.
+  ///
+  /// \param[in] scale_table_path the path to the scale table
+  ///
+  void SetScaleTable(const std::string& scale_table_path) {
+    scale_table_path_ = scale_table_path;
+  }
+
+  ///
+  /// \brief Get the path to the int8 scale table
+  ///
+  /// \return the path to the scale table
+  ///
+  const std::string& scale_table_path() const { return scale_table_path_; }
+
  protected:
   std::map<std::string, std::map<std::string, ScaleAlgo>> rules_;
   std::unordered_set<std::string> enabled_op_types_;
@@ -197,6 +217,7 @@ struct PD_INFER_DECL MkldnnQuantizerConfig {
   std::shared_ptr<std::vector<PaddleTensor>> warmup_data_;
   int warmup_bs_{1};
   ScaleAlgo default_scale_algo_{ScaleAlgo::MAX};
+  std::string scale_table_path_;
 };
 
 }  // namespace paddle
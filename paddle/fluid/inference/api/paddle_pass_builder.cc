@@ -261,6 +261,10 @@ const std::vector<std::string> CpuBasicPasses{
     "conv_transpose_eltwiseadd_bn_fuse_pass",  //
     "is_test_pass",                            //
     "constant_folding_pass",
+#ifdef PADDLE_WITH_MKLML
+    // the weights are final once the other passes ran
+    "fc_weight_pack_pass",
+#endif
 };
 
 GpuPassStrategy::GpuPassStrategy() : PassStrategy({}) {
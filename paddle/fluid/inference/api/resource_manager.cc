@@ -133,8 +133,13 @@ void CPUContextResource::InitCPUResource() {
 CPUContextResource::CPUContextResource() { InitCPUResource(); }
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-GPUContextResource::GPUContextResource(const phi::Place& place, void* stream)
-    : place_(place) {
+GPUContextResource::GPUContextResource(const phi::Place& place,
+                                       void* stream,
+                                       int stream_priority,
+                                       bool non_blocking)
+    : place_(place),
+      stream_priority_(stream_priority),
+      non_blocking_(non_blocking) {
   InitGPUResource(stream);
 }
 
@@ -144,7 +149,18 @@ void GPUContextResource::InitGPUResource(void* stream) {
   phi::backends::gpu::GPUDeviceGuard guard(place_.device);
   if (stream == nullptr) {
     owned_stream_ = true;
-    phi::InitStream(&stream_);
+    // the priorities out of the range of the device are clamped by the driver
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(hipStreamCreateWithPriority(
+        &stream_,
+        non_blocking_ ? hipStreamNonBlocking : hipStreamDefault,
+        stream_priority_));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamCreateWithPriority(
+        &stream_,
+        non_blocking_ ? cudaStreamNonBlocking : cudaStreamDefault,
+        stream_priority_));
+#endif
   } else {
     owned_stream_ = false;
     stream_ = reinterpret_cast<gpuStream_t>(stream);
@@ -381,14 +397,17 @@ CPUContextResource* ResourceManager::GetCPUResource() const {
 }
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-void* ResourceManager::InitGPUResource(const phi::Place& place, void* stream) {
+void* ResourceManager::InitGPUResource(const phi::Place& place,
+                                       void* stream,
+                                       int stream_priority,
+                                       bool non_blocking) {
   std::lock_guard<std::mutex> lock_gurad(gpu_mutex_);
   if (gpu_resources_.count(stream)) {
     Increase(stream);
     return stream;
   } else {
-    std::unique_ptr<GPUContextResource> resource{
-        new GPUContextResource(place, stream)};
+    std::unique_ptr<GPUContextResource> resource{new GPUContextResource(
+        place, stream, stream_priority, non_blocking)};
     gpuStream_t s = resource->GetStream();
     ref_count_[s] = 1;
     gpu_resources_.emplace(s, std::move(resource));
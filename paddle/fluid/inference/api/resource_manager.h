@@ -53,7 +53,12 @@ class CPUContextResource {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 class GPUContextResource {
  public:
-  explicit GPUContextResource(const phi::Place& place, void* stream);
+  // Owns a new stream of stream_priority, which does not synchronize with the
+  // legacy default stream if non_blocking, if stream is nullptr.
+  GPUContextResource(const phi::Place& place,
+                     void* stream,
+                     int stream_priority = 0,
+                     bool non_blocking = false);
   TEST_API ~GPUContextResource();
   phi::Place Place() const;
 
@@ -110,6 +115,8 @@ class GPUContextResource {
   std::array<int, 3> max_grid_dim_size_;
 
   bool owned_stream_{true};
+  int stream_priority_{0};
+  bool non_blocking_{false};
   gpuStream_t stream_;
   std::unique_ptr<Eigen::GpuDevice> gpu_eigen_device_;
   std::unique_ptr<internal::EigenGpuStreamDevice> eigen_stream_;
@@ -142,7 +149,12 @@ class ResourceManager {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   // GPU Resource
  public:
-  void* InitGPUResource(const phi::Place& place, void* stream);
+  // Returns the stream of the resource, which is a new stream of
+  // stream_priority if stream is nullptr.
+  void* InitGPUResource(const phi::Place& place,
+                        void* stream,
+                        int stream_priority = 0,
+                        bool non_blocking = false);
   void DestroyGPUResource(void* stream);
   TEST_API GPUContextResource* GetGPUResource(void* stream) const;
   TEST_API int RefCount(void* stream) const;
@@ -79,4 +79,8 @@ PD_ENUM(PD_DataType){
     PD_DATA_INT64,
     PD_DATA_UINT8,
     PD_DATA_INT8,
+    PD_DATA_FLOAT16,
+    PD_DATA_BOOL,
+    PD_DATA_FLOAT64,
+    PD_DATA_BFLOAT16,
 };
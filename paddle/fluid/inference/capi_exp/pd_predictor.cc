@@ -14,6 +14,16 @@
 
 #include "paddle/fluid/inference/capi_exp/pd_predictor.h"
 
+#include <memory>
+#include <thread>  // NOLINT
+
+#ifdef PADDLE_WITH_CUDA
+#include <cuda_runtime.h>
+#endif
+#ifdef PADDLE_WITH_HIP
+#include <hip/hip_runtime.h>
+#endif
+
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/capi_exp/pd_config.h"
 #include "paddle/fluid/inference/capi_exp/pd_types.h"
@@ -29,6 +39,31 @@
           "The pointer of paddle predictor shouldn't be nullptr")); \
   auto& predictor = pd_predictor->predictor
 
+namespace {
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+struct PD_RunCallback {
+  PD_PredictorRunCallback callback;
+  void* user_data;
+};
+
+#ifdef PADDLE_WITH_HIP
+void InvokeRunCallback(hipStream_t stream, hipError_t status, void* data) {
+  auto* run_callback = static_cast<PD_RunCallback*>(data);
+  run_callback->callback(status == hipSuccess, run_callback->user_data);
+  delete run_callback;
+}
+#else
+void CUDART_CB InvokeRunCallback(void* data) {
+  auto* run_callback = static_cast<PD_RunCallback*>(data);
+  run_callback->callback(TRUE, run_callback->user_data);
+  delete run_callback;
+}
+#endif
+#endif
+
+}  // namespace
+
 extern "C" {
 __pd_give PD_Predictor* PD_PredictorCreate(__pd_take PD_Config* pd_config) {
   PADDLE_ENFORCE_NOT_NULL(
@@ -143,6 +178,69 @@ PD_Bool PD_PredictorRun(__pd_keep PD_Predictor* pd_predictor) {
   return predictor->Run();  // NOLINT
 }
 
+PD_Bool PD_PredictorRunWithExternalStream(__pd_keep PD_Predictor* pd_predictor,
+                                          void* stream) {
+  CHECK_AND_CONVERT_PD_PREDICTOR;
+#if defined(PADDLE_WITH_CUDA)
+  return paddle_infer::experimental::InternalUtils::RunWithExternalStream(
+      predictor.get(), static_cast<cudaStream_t>(stream));
+#elif defined(PADDLE_WITH_HIP)
+  return paddle_infer::experimental::InternalUtils::RunWithExternalStream(
+      predictor.get(), static_cast<hipStream_t>(stream));
+#else
+  PADDLE_THROW(paddle::platform::errors::Unavailable(
+      "PD_PredictorRunWithExternalStream needs Paddle compiled with GPU."));
+  return FALSE;
+#endif
+}
+
+void PD_PredictorRunAsync(__pd_keep PD_Predictor* pd_predictor,
+                          void* stream,
+                          PD_PredictorRunCallback callback,
+                          void* user_data) {
+  CHECK_AND_CONVERT_PD_PREDICTOR;
+  PADDLE_ENFORCE_NOT_NULL(
+      callback,
+      paddle::platform::errors::InvalidArgument(
+          "The callback of PD_PredictorRunAsync shouldn't be nullptr"));
+  if (stream == nullptr) {
+    // the thread shares the predictor, so that it outlives the run
+    std::shared_ptr<paddle_infer::Predictor> shared_predictor = predictor;
+    std::thread([shared_predictor, callback, user_data]() {
+      bool success = false;
+      try {
+        success = shared_predictor->Run();
+        paddle_infer::experimental::InternalUtils::SyncStream(
+            shared_predictor.get());
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "PD_PredictorRunAsync failed: " << e.what();
+      }
+      callback(success, user_data);
+    }).detach();
+    return;
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (!PD_PredictorRunWithExternalStream(pd_predictor, stream)) {
+    callback(FALSE, user_data);
+    return;
+  }
+  auto* run_callback = new PD_RunCallback{callback, user_data};
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipStreamAddCallback(static_cast<hipStream_t>(stream),
+                           InvokeRunCallback,
+                           run_callback,
+                           0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaLaunchHostFunc(
+      static_cast<cudaStream_t>(stream), InvokeRunCallback, run_callback));
+#endif
+#else
+  PADDLE_THROW(paddle::platform::errors::Unavailable(
+      "PD_PredictorRunAsync on a stream needs Paddle compiled with GPU."));
+#endif
+}
+
 void PD_PredictorClearIntermediateTensor(__pd_keep PD_Predictor* pd_predictor) {
   CHECK_AND_CONVERT_PD_PREDICTOR;
   predictor->ClearIntermediateTensor();
@@ -32,6 +32,15 @@ typedef struct PD_Tensor PD_Tensor;
 typedef struct PD_OneDimArrayCstr PD_OneDimArrayCstr;
 typedef struct PD_IOInfos PD_IOInfos;
 
+///
+/// \brief The callback of PD_PredictorRunAsync, which is called once the
+/// outputs of the run are ready.
+///
+/// \param[in] success Whether the run executed successfully
+/// \param[in] user_data the user_data passed to PD_PredictorRunAsync
+///
+typedef void (*PD_PredictorRunCallback)(PD_Bool success, void* user_data);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -131,6 +140,39 @@ PADDLE_CAPI_EXPORT extern __pd_give PD_Tensor* PD_PredictorGetOutputHandle(
 PADDLE_CAPI_EXPORT extern PD_Bool PD_PredictorRun(
     __pd_keep PD_Predictor* pd_predictor);
 
+///
+/// \brief Run the prediction engine on an external stream.
+/// The kernels are queued on stream and the function returns without waiting
+/// for them, so the outputs are ready once the work on stream completes. The
+/// exec stream of the config should be set by PD_ConfigSetExecStream.
+///
+/// \param[in] pd_predictor predictor
+/// \param[in] stream the cudaStream_t or hipStream_t to run on
+/// \return Whether the function executed successfully
+///
+PADDLE_CAPI_EXPORT extern PD_Bool PD_PredictorRunWithExternalStream(
+    __pd_keep PD_Predictor* pd_predictor, void* stream);
+
+///
+/// \brief Run the prediction engine asynchronously.
+/// If stream is not NULL, the run is queued on stream as by
+/// PD_PredictorRunWithExternalStream, and callback is called by the driver
+/// once the work on stream completes, so it should not call the cuda API.
+/// Otherwise the run takes a thread of its own, and callback is called on it
+/// after the run. The inputs, the outputs and the predictor should not be
+/// touched until callback is called.
+///
+/// \param[in] pd_predictor predictor
+/// \param[in] stream the cudaStream_t or hipStream_t to run on, or NULL
+/// \param[in] callback the function called when the outputs are ready
+/// \param[in] user_data the data passed to callback
+///
+PADDLE_CAPI_EXPORT extern void PD_PredictorRunAsync(
+    __pd_keep PD_Predictor* pd_predictor,
+    void* stream,
+    PD_PredictorRunCallback callback,
+    void* user_data);
+
 /// \brief Clear the intermediate tensors of the predictor
 ///
 /// \param[in] pd_predictor predictor
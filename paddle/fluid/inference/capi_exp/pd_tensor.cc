@@ -20,6 +20,8 @@
 #include "paddle/fluid/inference/capi_exp/types_internal.h"
 #include "paddle/fluid/inference/capi_exp/utils_internal.h"
 #include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
 
 #define CHECK_AND_CONVERT_PD_TENSOR                              \
   PADDLE_ENFORCE_NOT_NULL(                                       \
@@ -92,8 +94,67 @@ REPEAT_ALL_DATA_TYPE(PD_TENSOR_COPY_FROM_CPU_IMPL)
 REPEAT_ALL_DATA_TYPE(PD_TENSOR_COPY_TO_CPU_IMPL)
 #undef PD_TENSOR_COPY_TO_CPU_IMPL
 
+#define PD_TENSOR_SHARE_EXTERNAL_DATA_IMPL(type, Type)                        \
+  void PD_TensorShareExternalData##Type(__pd_keep PD_Tensor* pd_tensor,       \
+                                        type* data,                           \
+                                        size_t shape_size,                    \
+                                        int32_t* shape,                       \
+                                        PD_PlaceType place) {                 \
+    CHECK_AND_CONVERT_PD_TENSOR;                                              \
+    std::vector<int> shapes(shape, shape + shape_size);                       \
+    tensor->ShareExternalData<type>(                                          \
+        data, shapes, paddle_infer::CvtToCxxPlaceType(place));                \
+  }
+REPEAT_ALL_DATA_TYPE(PD_TENSOR_SHARE_EXTERNAL_DATA_IMPL)
+#undef PD_TENSOR_SHARE_EXTERNAL_DATA_IMPL
+
 #undef REPEAT_ALL_DATA_TYPE
 
+void PD_TensorShareExternalData(__pd_keep PD_Tensor* pd_tensor,
+                                void* data,
+                                size_t shape_size,
+                                int32_t* shape,
+                                PD_DataType data_type,
+                                PD_PlaceType place) {
+  CHECK_AND_CONVERT_PD_TENSOR;
+  std::vector<int> shapes(shape, shape + shape_size);
+  auto cxx_place = paddle_infer::CvtToCxxPlaceType(place);
+  switch (data_type) {
+    case PD_DATA_FLOAT32:
+      tensor->ShareExternalData(static_cast<float*>(data), shapes, cxx_place);
+      break;
+    case PD_DATA_INT32:
+      tensor->ShareExternalData(static_cast<int32_t*>(data), shapes, cxx_place);
+      break;
+    case PD_DATA_INT64:
+      tensor->ShareExternalData(static_cast<int64_t*>(data), shapes, cxx_place);
+      break;
+    case PD_DATA_UINT8:
+      tensor->ShareExternalData(static_cast<uint8_t*>(data), shapes, cxx_place);
+      break;
+    case PD_DATA_INT8:
+      tensor->ShareExternalData(static_cast<int8_t*>(data), shapes, cxx_place);
+      break;
+    case PD_DATA_FLOAT16:
+      tensor->ShareExternalData(
+          static_cast<phi::dtype::float16*>(data), shapes, cxx_place);
+      break;
+    case PD_DATA_BOOL:
+      tensor->ShareExternalData(static_cast<bool*>(data), shapes, cxx_place);
+      break;
+    case PD_DATA_FLOAT64:
+      tensor->ShareExternalData(static_cast<double*>(data), shapes, cxx_place);
+      break;
+    case PD_DATA_BFLOAT16:
+      tensor->ShareExternalData(
+          static_cast<phi::dtype::bfloat16*>(data), shapes, cxx_place);
+      break;
+    default:
+      PADDLE_THROW(paddle::platform::errors::InvalidArgument(
+          "Unsupport paddle data type %d.", data_type));
+  }
+}
+
 __pd_give PD_OneDimArrayInt32* PD_TensorGetShape(
     __pd_keep PD_Tensor* pd_tensor) {
   CHECK_AND_CONVERT_PD_TENSOR;
@@ -246,6 +246,97 @@ PADDLE_CAPI_EXPORT extern void PD_TensorCopyToCpuUint8(
 PADDLE_CAPI_EXPORT extern void PD_TensorCopyToCpuInt8(
     __pd_keep PD_Tensor* pd_tensor, int8_t* data);
 ///
+/// \brief Share the external memory with the tensor without a copy.
+/// It's usually used to bind the user buffers to the input and the output
+/// tensors. The memory should be kept alive by the caller until the run of the
+/// predictor with it completes.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, which the tensor will share.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of data.
+/// \param[in] place The place of data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataFloat(
+    __pd_keep PD_Tensor* pd_tensor,
+    float* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the external memory with the tensor without a copy.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, which the tensor will share.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of data.
+/// \param[in] place The place of data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt64(
+    __pd_keep PD_Tensor* pd_tensor,
+    int64_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the external memory with the tensor without a copy.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, which the tensor will share.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of data.
+/// \param[in] place The place of data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt32(
+    __pd_keep PD_Tensor* pd_tensor,
+    int32_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the external memory with the tensor without a copy.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, which the tensor will share.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of data.
+/// \param[in] place The place of data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataUint8(
+    __pd_keep PD_Tensor* pd_tensor,
+    uint8_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the external memory with the tensor without a copy.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, which the tensor will share.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of data.
+/// \param[in] place The place of data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt8(
+    __pd_keep PD_Tensor* pd_tensor,
+    int8_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the external memory of any data type with the tensor without
+/// a copy, e.g. the float16, bfloat16, float64 and bool buffers which have no
+/// C types.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, which the tensor will share.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of data.
+/// \param[in] data_type The data type of data.
+/// \param[in] place The place of data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalData(
+    __pd_keep PD_Tensor* pd_tensor,
+    void* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_DataType data_type,
+    PD_PlaceType place);
+///
 /// \brief Get the tensor shape
 /// \param[in] pd_tensor tensor.
 /// \return The tensor shape.
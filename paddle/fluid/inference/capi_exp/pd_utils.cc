@@ -258,6 +258,14 @@ DataType CvtToCxxDatatype(PD_DataType data_type) {
       return DataType::UINT8;
     case PD_DATA_INT8:
       return DataType::INT8;
+    case PD_DATA_FLOAT16:
+      return DataType::FLOAT16;
+    case PD_DATA_BOOL:
+      return DataType::BOOL;
+    case PD_DATA_FLOAT64:
+      return DataType::FLOAT64;
+    case PD_DATA_BFLOAT16:
+      return DataType::BFLOAT16;
     default:
       PADDLE_THROW(paddle::platform::errors::InvalidArgument(
           "Unsupport paddle data type %d.", data_type));
@@ -275,6 +283,16 @@ PD_DataType CvtFromCxxDatatype(DataType data_type) {
       return PD_DATA_INT32;
     case DataType::UINT8:
       return PD_DATA_UINT8;
+    case DataType::INT8:
+      return PD_DATA_INT8;
+    case DataType::FLOAT16:
+      return PD_DATA_FLOAT16;
+    case DataType::BOOL:
+      return PD_DATA_BOOL;
+    case DataType::FLOAT64:
+      return PD_DATA_FLOAT64;
+    case DataType::BFLOAT16:
+      return PD_DATA_BFLOAT16;
     default:
       return PD_DATA_UNK;
   }
@@ -145,6 +145,17 @@ func (p *Predictor) Run() {
 	C.PD_PredictorRun(p.c)
 }
 
+///
+/// \brief Run the prediction engine on an external stream, without waiting
+/// for the device. The outputs are ready once the work on stream completes.
+///
+/// \param[in] stream the cudaStream_t or hipStream_t to run on
+/// \return Whether the function executed successfully
+///
+func (p *Predictor) RunWithExternalStream(stream unsafe.Pointer) bool {
+	return cvtPDBoolToGo(C.PD_PredictorRunWithExternalStream(p.c, stream))
+}
+
 ///
 /// \brief Clear the intermediate tensors of the predictor
 ///
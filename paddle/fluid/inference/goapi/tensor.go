@@ -29,12 +29,16 @@ import (
 type DataType C.PD_DataType
 
 const (
-	Unk     DataType = C.PD_DATA_UNK
-	Float32 DataType = C.PD_DATA_FLOAT32
-	Int32   DataType = C.PD_DATA_INT32
-	Int64   DataType = C.PD_DATA_INT64
-	Uint8   DataType = C.PD_DATA_UINT8
-	Int8    DataType = C.PD_DATA_INT8
+	Unk      DataType = C.PD_DATA_UNK
+	Float32  DataType = C.PD_DATA_FLOAT32
+	Int32    DataType = C.PD_DATA_INT32
+	Int64    DataType = C.PD_DATA_INT64
+	Uint8    DataType = C.PD_DATA_UINT8
+	Int8     DataType = C.PD_DATA_INT8
+	Float16  DataType = C.PD_DATA_FLOAT16
+	Bool     DataType = C.PD_DATA_BOOL
+	Float64  DataType = C.PD_DATA_FLOAT64
+	Bfloat16 DataType = C.PD_DATA_BFLOAT16
 )
 
 type PlaceType C.PD_PlaceType
@@ -212,6 +216,22 @@ func (t *Tensor) CopyToCpu(value interface{}) {
 	}
 }
 
+///
+/// \brief Share the external memory with the tensor without a copy.
+/// It's usually used to bind the user buffers to the input and the output
+/// tensors. The memory, e.g. allocated by C or on the device, should be kept
+/// alive until the run of the predictor with it completes, so it should not be
+/// the memory of Go.
+///
+/// \param[in] data The pointer of the data, which the tensor will share.
+/// \param[in] shape The shape of data.
+/// \param[in] dtype The data type of data.
+/// \param[in] place The place of data.
+///
+func (t *Tensor) ShareExternalData(data unsafe.Pointer, shape []int32, dtype DataType, place PlaceType) {
+	C.PD_TensorShareExternalData(t.c, data, C.size_t(len(shape)), (*C.int32_t)(unsafe.Pointer(&shape[0])), C.PD_DataType(dtype), C.PD_PlaceType(place))
+}
+
 var types = []struct {
 	typ      reflect.Type
 	dataType C.PD_DataType
@@ -17,6 +17,7 @@ limitations under the License. */
 #include <NvInfer.h>
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <string>
 
 #include "NvInferRuntimeCommon.h"
@@ -74,8 +75,8 @@ void TensorRTEngine::InitNetwork() {
   }
 
   infer_builder_config_.reset(infer_builder_->createBuilderConfig());
-  optim_profiles_.resize(max_profile_num_);
-  for (int i = 0; i < max_profile_num_; i++)
+  optim_profiles_.resize(max_profile_num_ + params_.extra_profiles.size());
+  for (size_t i = 0; i < optim_profiles_.size(); i++)
     optim_profiles_[i] = infer_builder_->createOptimizationProfile();
 }
 
@@ -118,14 +119,25 @@ void TensorRTEngine::Execute(int batch_size,
                              cudaStream_t stream) {
   FreshDeviceId();
   auto infer_context = context();
+  // freed after the enqueue, and reused by the later work of the stream
+  phi::Allocator::AllocationPtr context_memory_holder;
   if (params_.context_memory_sharing) {
     void *context_memory{nullptr};
-    context_memory =
-        inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
-            .GetContextMemory(
-                predictor_id_per_thread,
-                phi::GPUPlace(device_id()),
-                phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+    if (params_.context_memory_per_run && !startup_with_cudagraph_ &&
+        !cudagraph_inited_) {
+      context_memory_holder =
+          memory::Alloc(phi::GPUPlace(device_id()),
+                        infer_engine_->getDeviceMemorySize(),
+                        phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+      context_memory = context_memory_holder->ptr();
+    } else {
+      context_memory =
+          inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
+              .GetContextMemory(
+                  predictor_id_per_thread,
+                  phi::GPUPlace(device_id()),
+                  phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+    }
     infer_context->setDeviceMemory(context_memory);
   }
 
@@ -299,39 +311,60 @@ void TensorRTEngine::FreezeNetwork() {
 
   if (with_dynamic_shape()) {
     LOG(INFO) << "Run Paddle-TRT Dynamic Shape mode.";
-    for (int i = 0; i < max_profile_num_; i++) {
+    PADDLE_ENFORCE_EQ(
+        max_profile_num_ == 1 || params_.extra_profiles.empty(),
+        true,
+        platform::errors::InvalidArgument(
+            "The extra optimization profiles can not be used with the "
+            "profiles of the predictor clones."));
+    for (size_t i = 0; i < optim_profiles_.size(); i++) {
+      // the profiles after the max_profile_num_ ones of the clones are the
+      // extra ones, which take the ranges of the first one for the inputs
+      // they do not have
+      const ConstructionParams::ShapeProfile *extra =
+          static_cast<int>(i) < max_profile_num_
+              ? nullptr
+              : &params_.extra_profiles[i - max_profile_num_];
       for (auto &input : min_input_shape()) {
+        auto min_shape = input.second;
+        auto max_shape = max_input_shape()[input.first];
+        auto opt_shape = optim_input_shape()[input.first];
+        if (extra && extra->min_input_shape.count(input.first)) {
+          min_shape = extra->min_input_shape.at(input.first);
+          max_shape = extra->max_input_shape.at(input.first);
+          opt_shape = extra->optim_input_shape.at(input.first);
+        }
 #if IS_TRT_VERSION_LT(7100)
         // trt6/trt7011 will check all_of input > 0
-        if (!(std::all_of(input.second.begin(),
-                          input.second.end(),
+        if (!(std::all_of(min_shape.begin(),
+                          min_shape.end(),
                           [](int x) { return x > 0; }) &&
-              std::all_of(max_input_shape()[input.first].begin(),
-                          max_input_shape()[input.first].end(),
+              std::all_of(max_shape.begin(),
+                          max_shape.end(),
                           [](int x) { return x > 0; }) &&
-              std::all_of(optim_input_shape()[input.first].begin(),
-                          optim_input_shape()[input.first].end(),
+              std::all_of(opt_shape.begin(),
+                          opt_shape.end(),
                           [](int x) { return x > 0; }))) {
           continue;
         }
 #endif
-        VLOG(4) << "TRT dynamic_shape set " << input.first
-                << " min: " << Vec2Str(input.second)
-                << ", max: " << Vec2Str(max_input_shape()[input.first])
-                << ", opt: " << Vec2Str(optim_input_shape()[input.first]);
+        VLOG(4) << "TRT dynamic_shape set " << input.first << " of profile "
+                << i << " min: " << Vec2Str(min_shape)
+                << ", max: " << Vec2Str(max_shape)
+                << ", opt: " << Vec2Str(opt_shape);
 
         optim_profiles_[i]->setDimensions(
             input.first.c_str(),
             nvinfer1::OptProfileSelector::kMIN,
-            Vec2TRT_Dims(input.second, input.first, true));
+            Vec2TRT_Dims(min_shape, input.first, true));
         optim_profiles_[i]->setDimensions(
             input.first.c_str(),
             nvinfer1::OptProfileSelector::kMAX,
-            Vec2TRT_Dims(max_input_shape()[input.first], input.first, true));
+            Vec2TRT_Dims(max_shape, input.first, true));
         optim_profiles_[i]->setDimensions(
             input.first.c_str(),
             nvinfer1::OptProfileSelector::kOPT,
-            Vec2TRT_Dims(optim_input_shape()[input.first], input.first, true));
+            Vec2TRT_Dims(opt_shape, input.first, true));
       }
 
       for (int input_id = 0; input_id < network()->getNbInputs(); input_id++) {
@@ -398,6 +431,13 @@ void TensorRTEngine::FreezeNetwork() {
   infer_engine_.reset(infer_builder_->buildEngineWithConfig(
       *network(), *infer_builder_config_));
 #else
+  if (timing_cache_) {
+    if (!infer_builder_config_->setTimingCache(*timing_cache_, false)) {
+      LOG(WARNING) << "The TensorRT timing cache does not match the device, "
+                      "so it is not used.";
+    }
+    timing_cache_ = nullptr;
+  }
   ihost_memory_.reset(infer_builder_->buildSerializedNetwork(
       *network(), *infer_builder_config_));
   infer_runtime_.reset(createInferRuntime(&logger_));
@@ -412,13 +452,14 @@ void TensorRTEngine::FreezeNetwork() {
           "you configurations related to paddle-TensorRT."));
 
   binding_num_ = infer_engine_->getNbBindings();
+  nb_profiles_ = infer_engine_->getNbOptimizationProfiles();
   // reset status for dynamic shape clone
   if (max_profile_num_ > 1) {
     infer_context_.clear();
     cur_profile_num_ = 0;
   }
   // for engine context memory sharing
-  if (params_.context_memory_sharing) {
+  if (params_.context_memory_sharing && !defer_context_memory_update_) {
     inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
         .UpdateContextMemorySize(infer_engine_->getDeviceMemorySize(),
                                  predictor_id_per_thread);
@@ -632,8 +673,9 @@ void TensorRTEngine::Deserialize(const std::string &engine_serialized_data) {
           "consistent."));
 
   binding_num_ = infer_engine_->getNbBindings();
+  nb_profiles_ = infer_engine_->getNbOptimizationProfiles();
   // for engine context memory sharing
-  if (params_.context_memory_sharing) {
+  if (params_.context_memory_sharing && !defer_context_memory_update_) {
     inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
         .UpdateContextMemorySize(infer_engine_->getDeviceMemorySize(),
                                  predictor_id_per_thread);
@@ -643,6 +685,183 @@ void TensorRTEngine::Deserialize(const std::string &engine_serialized_data) {
   }
 }
 
+int TensorRTEngine::FindProfile(const ShapeMapType &runtime_input_shape,
+                                const ShapeMapType &runtime_shape_tensor) {
+  PADDLE_ENFORCE_NOT_NULL(
+      infer_engine_,
+      platform::errors::InvalidArgument(
+          "You should build engine first and then find the profile."));
+  int bindings_per_profile = binding_num_ / nb_profiles_;
+  auto fits = [](const std::vector<int> &shape,
+                 const int32_t *min_values,
+                 const int32_t *max_values) {
+    for (size_t i = 0; i < shape.size(); ++i) {
+      if (shape[i] < min_values[i] || shape[i] > max_values[i]) {
+        return false;
+      }
+    }
+    return true;
+  };
+  for (int profile = 0; profile < nb_profiles_; ++profile) {
+    bool fit = true;
+    for (auto it = runtime_input_shape.begin();
+         fit && it != runtime_input_shape.end();
+         ++it) {
+      int index = infer_engine_->getBindingIndex(it->first.c_str());
+      if (index < 0) continue;
+      index += bindings_per_profile * profile;
+      auto shape = it->second;
+      // 0-D tensors are 1-D in the engine
+      if (shape.empty()) {
+        shape.push_back(1);
+      }
+      auto min_dims = infer_engine_->getProfileDimensions(
+          index, profile, nvinfer1::OptProfileSelector::kMIN);
+      auto max_dims = infer_engine_->getProfileDimensions(
+          index, profile, nvinfer1::OptProfileSelector::kMAX);
+      fit = min_dims.nbDims == static_cast<int>(shape.size()) &&
+            fits(shape, min_dims.d, max_dims.d);
+      auto values = runtime_shape_tensor.find(it->first);
+      if (fit && values != runtime_shape_tensor.end() &&
+          infer_engine_->isShapeBinding(index)) {
+        fit = fits(values->second,
+                   infer_engine_->getProfileShapeValues(
+                       index, profile, nvinfer1::OptProfileSelector::kMIN),
+                   infer_engine_->getProfileShapeValues(
+                       index, profile, nvinfer1::OptProfileSelector::kMAX));
+      }
+    }
+    if (fit) {
+      return profile;
+    }
+  }
+  return -1;
+}
+
+void TensorRTEngine::SetProfile(int profile, cudaStream_t stream) {
+  PADDLE_ENFORCE_EQ(
+      max_profile_num_,
+      1,
+      platform::errors::InvalidArgument(
+          "The profile of a predictor clone can not be changed."));
+  PADDLE_ENFORCE_EQ(
+      profile >= 0 && profile < nb_profiles_,
+      true,
+      platform::errors::InvalidArgument(
+          "The profile %d is out of the %d profiles of the engine.",
+          profile,
+          nb_profiles_));
+  auto *infer_context = context();
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (profile_index_[predictor_id_per_thread] == profile) {
+    return;
+  }
+#if IS_TRT_VERSION_GE(8000)
+  bool success = infer_context->setOptimizationProfileAsync(profile, stream);
+#else
+  bool success = infer_context->setOptimizationProfile(profile);
+#endif
+  PADDLE_ENFORCE_EQ(success,
+                    true,
+                    platform::errors::Fatal(
+                        "Failed to set the optimization profile %d of the "
+                        "TensorRT execution context.",
+                        profile));
+  profile_index_[predictor_id_per_thread] = profile;
+}
+
+void TensorRTEngine::AddShapeProfile(const ShapeMapType &runtime_input_shape,
+                                     const ShapeMapType &runtime_shape_tensor,
+                                     ConstructionParams *params) {
+  ConstructionParams::ShapeProfile profile;
+  for (const auto &it : runtime_input_shape) {
+    const auto &name = it.first;
+    auto shape = it.second;
+    // Make 0-D tensor to 1-D tensor.
+    if (shape.empty()) {
+      shape.push_back(1);
+    }
+    if (!params->min_input_shape.count(name)) {
+      params->min_input_shape[name] = shape;
+      params->max_input_shape[name] = shape;
+      params->optim_input_shape[name] = shape;
+    }
+    PADDLE_ENFORCE_EQ(params->min_input_shape[name].size(),
+                      shape.size(),
+                      platform::errors::InvalidArgument(
+                          "TRT dynamic_shape min_input_shape %s size not "
+                          "equal, the min_input_shape[%s].size()=%d, but the "
+                          "runtime_input_shape[%s].size()=%d.",
+                          name,
+                          name,
+                          params->min_input_shape[name].size(),
+                          name,
+                          shape.size()));
+    // the range covered by all the profiles
+    auto lower = params->min_input_shape[name];
+    auto upper = params->max_input_shape[name];
+    for (const auto &extra : params->extra_profiles) {
+      if (!extra.min_input_shape.count(name)) continue;
+      for (size_t i = 0; i < shape.size(); ++i) {
+        lower[i] = std::min(lower[i], extra.min_input_shape.at(name)[i]);
+        upper[i] = std::max(upper[i], extra.max_input_shape.at(name)[i]);
+      }
+    }
+    // the new profile spans, on the dims out of the range, from the runtime
+    // shape to the range, and on the other dims the whole range
+    std::vector<int> min_shape(lower);
+    std::vector<int> max_shape(upper);
+    for (size_t i = 0; i < shape.size(); ++i) {
+      if (shape[i] < lower[i]) {
+        min_shape[i] = shape[i];
+        max_shape[i] = lower[i];
+      } else if (shape[i] > upper[i]) {
+        min_shape[i] = upper[i];
+        max_shape[i] = shape[i];
+      }
+    }
+    profile.min_input_shape[name] = min_shape;
+    profile.max_input_shape[name] = max_shape;
+    profile.optim_input_shape[name] = shape;
+  }
+  // the values of the shape tensors have the same range in all the profiles
+  for (const auto &it : runtime_shape_tensor) {
+    const auto &name = it.first;
+    if (!params->min_shape_tensor.count(name)) {
+      params->min_shape_tensor[name] = it.second;
+      params->max_shape_tensor[name] = it.second;
+      params->optim_shape_tensor[name] = it.second;
+      continue;
+    }
+    auto &min_values = params->min_shape_tensor[name];
+    auto &max_values = params->max_shape_tensor[name];
+    PADDLE_ENFORCE_EQ(min_values.size(),
+                      it.second.size(),
+                      platform::errors::InvalidArgument(
+                          "TRT dynamic_shape min_shape_tensor %s size not "
+                          "equal, the min_shape_tensor[%s].size()=%d, but the "
+                          "runtime_shape_tensor[%s].size()=%d.",
+                          name,
+                          name,
+                          min_values.size(),
+                          name,
+                          it.second.size()));
+    for (size_t i = 0; i < it.second.size(); ++i) {
+      min_values[i] = std::min(min_values[i], it.second[i]);
+      max_values[i] = std::max(max_values[i], it.second[i]);
+    }
+  }
+  params->extra_profiles.push_back(std::move(profile));
+}
+
+void TensorRTEngine::UpdateContextMemorySize() {
+  if (params_.context_memory_sharing && infer_engine_) {
+    inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
+        .UpdateContextMemorySize(infer_engine_->getDeviceMemorySize(),
+                                 predictor_id_per_thread);
+  }
+}
+
 // Note: Only for support plugin.
 TensorRTEngine::Weight TensorRTEngine::GetFp16TrtWeight(
     const std::string &name, const phi::DenseTensor &weight_tensor) {
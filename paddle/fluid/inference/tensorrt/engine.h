@@ -138,6 +138,10 @@ class TensorRTEngine {
 
     // Use for engine context memory sharing.
     bool context_memory_sharing{false};
+    // Allocate the shared context memory from the memory pool of the stream
+    // on every run instead of keeping it, so that it is reused by the other
+    // engines and ops between the runs of the engine.
+    bool context_memory_per_run{false};
 
     int device_id{0};
 
@@ -153,6 +157,17 @@ class TensorRTEngine {
     ShapeMapType max_shape_tensor;
     ShapeMapType optim_shape_tensor;
 
+    // The input shape ranges of the optimization profiles added after the
+    // one of min/max/optim_input_shape. All the profiles share the ranges of
+    // the shape tensors, and the ranges of the first profile are taken for
+    // the inputs an extra profile does not have.
+    struct ShapeProfile {
+      ShapeMapType min_input_shape;
+      ShapeMapType max_input_shape;
+      ShapeMapType optim_input_shape;
+    };
+    std::vector<ShapeProfile> extra_profiles;
+
     bool use_inspector{false};
     std::string engine_info_path{""};
 
@@ -235,9 +250,28 @@ class TensorRTEngine {
   nvinfer1::IExecutionContext* context();
 
   int GetBindingsOffset() {
-    return (binding_num_ / max_profile_num_) * GetProfileIndex();
+    return (binding_num_ / nb_profiles_) * GetProfileIndex();
   }
 
+  // Return the index of the first optimization profile of the engine that
+  // covers the runtime input shapes and shape tensor values, or -1 if none.
+  int FindProfile(const ShapeMapType& runtime_input_shape,
+                  const ShapeMapType& runtime_shape_tensor);
+
+  // Select the profile for the execution context of the current predictor.
+  // Not for the engines of the predictor clones, each of which has a profile.
+  void SetProfile(int profile, cudaStream_t stream);
+
+  // Append to params an extra profile for the runtime shapes. It spans, on
+  // the dims the runtime shapes are out of the range of all the profiles,
+  // from the runtime shapes to the range, and the shape tensor ranges are
+  // widened to the runtime values.
+  static void AddShapeProfile(const ShapeMapType& runtime_input_shape,
+                              const ShapeMapType& runtime_shape_tensor,
+                              ConstructionParams* params);
+
+  const ConstructionParams& params() const { return params_; }
+
   int GetNbBindings() { return binding_num_; }
 
   void ResetContext() {
@@ -323,6 +357,10 @@ class TensorRTEngine {
     trt_ops_run_float_ = ops;
   }
 
+  const std::unordered_set<std::string>& GetRunFloat() const {
+    return trt_ops_run_float_;
+  }
+
   bool OpIsRunFloat(const std::string& op) const {
     return trt_ops_run_float_.count(op) > 0;
   }
@@ -527,6 +565,26 @@ class TensorRTEngine {
 
   void SetProfileNum(int num) { max_profile_num_ = num; }
 
+  int GetProfileNum() const { return max_profile_num_; }
+
+#if IS_TRT_VERSION_GE(8000)
+  // Use the timing cache, which may be shared by the builders of several
+  // engines, in the next FreezeNetwork. It is not kept after that, so that
+  // the cache only has to outlive the build.
+  void SetTimingCache(nvinfer1::ITimingCache* timing_cache) {
+    timing_cache_ = timing_cache;
+  }
+#endif
+
+  // Not to update the shared context memory size when the engine is built,
+  // e.g. on a background thread while the contexts of the predictor run, but
+  // by UpdateContextMemorySize later.
+  void SetDeferContextMemoryUpdate(bool defer) {
+    defer_context_memory_update_ = defer;
+  }
+
+  void UpdateContextMemorySize();
+
   void SetScope(const framework::Scope* scope) { scope_ = scope; }
 
   void SetAllNodesLowerToTrt(bool all_nodes_offload_to_trt) {
@@ -551,7 +609,7 @@ class TensorRTEngine {
   int device_id() { return params_.device_id; }
 
   int GetProfileIndex() {
-    if (max_profile_num_ > 1) {
+    if (max_profile_num_ > 1 || nb_profiles_ > 1) {
       std::unique_lock<std::mutex> lock(mutex_);
       return profile_index_[predictor_id_per_thread];
     } else {
@@ -571,6 +629,7 @@ class TensorRTEngine {
 
   int max_profile_num_{1};
   int cur_profile_num_{0};
+  bool defer_context_memory_update_{false};
   std::unordered_map<PredictorID, int> profile_index_;
 
   nvinfer1::ILogger& logger_;
@@ -606,7 +665,11 @@ class TensorRTEngine {
 
 #if IS_TRT_VERSION_GE(6000)
   int binding_num_;
+  int nb_profiles_{1};
   infer_ptr<nvinfer1::IBuilderConfig> infer_builder_config_;
+#if IS_TRT_VERSION_GE(8000)
+  nvinfer1::ITimingCache* timing_cache_{nullptr};
+#endif
   std::vector<nvinfer1::IOptimizationProfile*> optim_profiles_;
   std::vector<std::unique_ptr<plugin::DynamicPluginTensorRT>> owned_pluginv2_;
 #endif
@@ -668,6 +731,15 @@ class TRTEngineManager {
     return engines_[name].get();
   }
 
+  // Replace the engine of name by engine, e.g. one rebuilt with more
+  // optimization profiles. The old engine should not be running.
+  TensorRTEngine* Replace(const std::string& name,
+                          std::unique_ptr<TensorRTEngine> engine) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    engines_[name] = std::move(engine);
+    return engines_[name].get();
+  }
+
   void DeleteAll() {
     std::lock_guard<std::mutex> lock(mutex_);
     for (auto& item : engines_) {
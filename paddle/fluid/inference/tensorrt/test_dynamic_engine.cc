@@ -1008,6 +1008,43 @@ TEST_F(TensorRTDynamicShapeGNTest, test_trt_dynamic_shape_groupnorm) {
 }
 */
 #endif
+
+TEST(TensorRTDynamicEngineProfileTest, test_extra_profile) {
+  TensorRTEngine::ConstructionParams params;
+  params.max_batch_size = 16;
+  params.max_workspace_size = 1 << 10;
+  params.with_dynamic_shape = true;
+  params.min_input_shape = {{"input", {1, 32}}};
+  params.max_input_shape = {{"input", {8, 32}}};
+  params.optim_input_shape = {{"input", {8, 32}}};
+
+  TensorRTEngine::AddShapeProfile({{"input", {16, 32}}}, {}, &params);
+  ASSERT_EQ(params.extra_profiles.size(), 1UL);
+  ASSERT_EQ(params.extra_profiles[0].min_input_shape["input"],
+            std::vector<int>({8, 32}));
+  ASSERT_EQ(params.extra_profiles[0].max_input_shape["input"],
+            std::vector<int>({16, 32}));
+  // the new profile starts from the range of all the profiles
+  TensorRTEngine::AddShapeProfile({{"input", {24, 32}}}, {}, &params);
+  ASSERT_EQ(params.extra_profiles[1].min_input_shape["input"],
+            std::vector<int>({16, 32}));
+
+  TensorRTEngine engine(params, NaiveLogger::Global());
+  engine.InitNetwork();
+  auto *x = engine.DeclareInput(
+      "input", nvinfer1::DataType::kFLOAT, nvinfer1::Dims2{-1, 32});
+  auto *layer =
+      engine.network()->addActivation(*x, nvinfer1::ActivationType::kRELU);
+  engine.DeclareOutput(layer, 0, "y");
+  engine.FreezeNetwork();
+  ASSERT_EQ(engine.engine()->getNbOptimizationProfiles(), 3);
+
+  ASSERT_EQ(engine.FindProfile({{"input", {4, 32}}}, {}), 0);
+  ASSERT_EQ(engine.FindProfile({{"input", {12, 32}}}, {}), 1);
+  ASSERT_EQ(engine.FindProfile({{"input", {20, 32}}}, {}), 2);
+  ASSERT_EQ(engine.FindProfile({{"input", {32, 32}}}, {}), -1);
+}
+
 }  // namespace tensorrt
 }  // namespace inference
 }  // namespace paddle
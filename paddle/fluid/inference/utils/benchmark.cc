@@ -14,6 +14,9 @@
 
 #include "paddle/fluid/inference/utils/benchmark.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <fstream>
 
 #include "paddle/fluid/platform/enforce.h"
@@ -21,6 +24,48 @@
 namespace paddle {
 namespace inference {
 
+namespace {
+
+// The number of key in a flat json object of SerializeToJson, false if
+// missing.
+bool FindJsonNumber(const std::string &json,
+                    const std::string &key,
+                    double *value) {
+  auto pos = json.find("\"" + key + "\"");
+  if (pos == std::string::npos) {
+    return false;
+  }
+  pos = json.find(':', pos + key.size() + 2);
+  if (pos == std::string::npos) {
+    return false;
+  }
+  const char *begin = json.c_str() + pos + 1;
+  char *end = nullptr;
+  *value = std::strtod(begin, &end);
+  return end != begin;
+}
+
+}  // namespace
+
+float Benchmark::LatencyPercentile(float percent) const {
+  PADDLE_ENFORCE_EQ(
+      percent > 0 && percent <= 100,
+      true,
+      platform::errors::InvalidArgument(
+          "The percent of a latency percentile should be in (0, 100], but "
+          "received %f.",
+          percent));
+  if (latencies_.empty()) {
+    return latency_;
+  }
+  std::vector<float> latencies(latencies_);
+  size_t rank = static_cast<size_t>(
+      std::ceil(percent / 100.0 * static_cast<double>(latencies.size())));
+  auto nth = latencies.begin() + std::max<size_t>(rank, 1) - 1;
+  std::nth_element(latencies.begin(), nth, latencies.end());
+  return *nth;
+}
+
 std::string Benchmark::SerializeToString() const {
   std::stringstream ss;
   ss << "-----------------------------------------------------\n";
@@ -50,5 +95,70 @@ void Benchmark::PersistToFile(const std::string &path) const {
   file.close();
 }
 
+std::string Benchmark::SerializeToJson() const {
+  std::stringstream ss;
+  ss << "{\n";
+  ss << "  \"name\": \"" << name_ << "\",\n";
+  ss << "  \"batch_size\": " << batch_size_ << ",\n";
+  ss << "  \"num_threads\": " << num_threads_ << ",\n";
+  ss << "  \"use_gpu\": " << (use_gpu_ ? "true" : "false") << ",\n";
+  ss << "  \"latency\": " << latency_ << ",\n";
+  ss << "  \"latency_p50\": " << LatencyPercentile(50) << ",\n";
+  ss << "  \"latency_p90\": " << LatencyPercentile(90) << ",\n";
+  ss << "  \"latency_p99\": " << LatencyPercentile(99) << ",\n";
+  ss << "  \"throughput\": " << throughput_ << ",\n";
+  ss << "  \"gpu_memory\": " << gpu_memory_ << ",\n";
+  ss << "  \"profile_path\": \"" << profile_path_ << "\"\n";
+  ss << "}\n";
+  return ss.str();
+}
+
+void Benchmark::PersistToJsonFile(const std::string &path) const {
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  PADDLE_ENFORCE_EQ(
+      file.is_open(),
+      true,
+      platform::errors::Unavailable("Can not open %s to add benchmark.", path));
+  file << SerializeToJson();
+  file.flush();
+  file.close();
+}
+
+std::vector<std::string> Benchmark::CheckRegression(
+    const std::string &baseline_json,
+    float default_threshold,
+    const std::map<std::string, float> &thresholds) const {
+  // the metrics, only a higher throughput is better
+  const std::vector<std::pair<std::string, double>> metrics = {
+      {"latency", latency_},
+      {"latency_p50", LatencyPercentile(50)},
+      {"latency_p90", LatencyPercentile(90)},
+      {"latency_p99", LatencyPercentile(99)},
+      {"throughput", throughput_},
+      {"gpu_memory", static_cast<double>(gpu_memory_)}};
+
+  std::vector<std::string> regressions;
+  for (auto &metric : metrics) {
+    double baseline = 0;
+    if (!FindJsonNumber(baseline_json, metric.first, &baseline) ||
+        baseline <= 0) {
+      continue;
+    }
+    auto it = thresholds.find(metric.first);
+    double threshold = it == thresholds.end() ? default_threshold : it->second;
+    double ratio = metric.first == "throughput"
+                       ? (baseline - metric.second) / baseline
+                       : (metric.second - baseline) / baseline;
+    if (ratio > threshold) {
+      std::stringstream ss;
+      ss << metric.first << " regresses from " << baseline << " to "
+         << metric.second << ", by " << ratio * 100 << "% over the threshold "
+         << threshold * 100 << "%";
+      regressions.push_back(ss.str());
+    }
+  }
+  return regressions;
+}
+
 }  // namespace inference
 }  // namespace paddle
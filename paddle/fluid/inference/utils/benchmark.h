@@ -15,7 +15,9 @@
 #pragma once
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "paddle/utils/test_macros.h"
 
@@ -38,17 +40,53 @@ struct TEST_API Benchmark {
   float latency() const { return latency_; }
   void SetLatency(float x) { latency_ = x; }
 
+  // Records the latency of a request in ms, the percentiles are over them.
+  void AddLatency(float x) { latencies_.push_back(x); }
+  // The nearest rank percentile of the recorded latencies, or the latency
+  // if none is recorded, percent in (0, 100].
+  float LatencyPercentile(float percent) const;
+
+  // Requests per second.
+  float throughput() const { return throughput_; }
+  void SetThroughput(float x) { throughput_ = x; }
+
+  // The peak allocated bytes of the gpu.
+  int64_t gpu_memory() const { return gpu_memory_; }
+  void SetGpuMemory(int64_t x) { gpu_memory_ = x; }
+
+  // The per op breakdown written by the profiler.
+  const std::string& profile_path() const { return profile_path_; }
+  void SetProfilePath(const std::string& path) { profile_path_ = path; }
+
   const std::string& name() const { return name_; }
   void SetName(const std::string& name) { name_ = name; }
 
   std::string SerializeToString() const;
   void PersistToFile(const std::string& path) const;
 
+  // A flat json object of the metrics, latency, latency_p50, latency_p90,
+  // latency_p99, throughput and gpu_memory.
+  std::string SerializeToJson() const;
+  void PersistToJsonFile(const std::string& path) const;
+
+  // Compares the metrics to the ones of a baseline json of SerializeToJson.
+  // A metric regresses when it is worse than the baseline by more than its
+  // threshold in thresholds, or default_threshold, as a ratio of the
+  // baseline. Returns the regressions, empty for none.
+  std::vector<std::string> CheckRegression(
+      const std::string& baseline_json,
+      float default_threshold,
+      const std::map<std::string, float>& thresholds = {}) const;
+
  private:
   bool use_gpu_{false};
   int batch_size_{0};
-  float latency_;
+  float latency_{0};
   int num_threads_{1};
+  float throughput_{0};
+  int64_t gpu_memory_{0};
+  std::vector<float> latencies_;
+  std::string profile_path_;
   std::string name_;
 };
 
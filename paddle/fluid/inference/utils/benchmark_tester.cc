@@ -38,3 +38,44 @@ TEST(Benchmark, PersistToFile) {
   benchmark.PersistToFile("2.log");
   benchmark.PersistToFile("3.log");
 }
+
+TEST(Benchmark, LatencyPercentile) {
+  Benchmark benchmark;
+  benchmark.SetLatency(5);
+  ASSERT_FLOAT_EQ(benchmark.LatencyPercentile(99), 5);
+  for (int i = 100; i >= 1; --i) {
+    benchmark.AddLatency(i);
+  }
+  ASSERT_FLOAT_EQ(benchmark.LatencyPercentile(50), 50);
+  ASSERT_FLOAT_EQ(benchmark.LatencyPercentile(90), 90);
+  ASSERT_FLOAT_EQ(benchmark.LatencyPercentile(99), 99);
+  ASSERT_FLOAT_EQ(benchmark.LatencyPercentile(100), 100);
+  ASSERT_FLOAT_EQ(benchmark.LatencyPercentile(0.1), 1);
+}
+
+TEST(Benchmark, CheckRegression) {
+  Benchmark baseline;
+  baseline.SetName("key0");
+  baseline.SetLatency(10);
+  baseline.SetThroughput(100);
+  baseline.SetGpuMemory(1000);
+  baseline.PersistToJsonFile("baseline.json");
+  LOG(INFO) << "benchmark:\n" << baseline.SerializeToJson();
+
+  Benchmark benchmark;
+  benchmark.SetLatency(10.5);
+  benchmark.SetThroughput(95);
+  benchmark.SetGpuMemory(1000);
+  ASSERT_TRUE(
+      benchmark.CheckRegression(baseline.SerializeToJson(), 0.1).empty());
+
+  benchmark.SetThroughput(80);
+  ASSERT_EQ(benchmark.CheckRegression(baseline.SerializeToJson(), 0.1).size(),
+            1UL);
+
+  // the latency and its percentiles without the samples
+  auto regressions = benchmark.CheckRegression(
+      baseline.SerializeToJson(), 0.1, {{"latency_p99", 0.01}});
+  ASSERT_EQ(regressions.size(), 2UL);
+  ASSERT_EQ(regressions[0].find("latency_p99"), 0UL);
+}
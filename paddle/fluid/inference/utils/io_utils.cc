@@ -16,6 +16,9 @@
 
 #include <fcntl.h>
 
+#include <cctype>
+#include <limits>
+#include <sstream>
 #include <utility>
 
 #include "google/protobuf/io/zero_copy_stream_impl.h"
@@ -344,5 +347,116 @@ void UpdateShapeRangeInfo(
   inference::SerializeShapeRangeInfo(path, shape_range_infos);
 }
 
+
+void SerializeInt8ScaleTable(const std::string &path,
+                             const std::map<std::string, float> &thresholds) {
+  std::ofstream fout(path);
+  PADDLE_ENFORCE_EQ(
+      fout.is_open(),
+      true,
+      platform::errors::InvalidArgument("Cannot open %s to write", path));
+  fout.precision(std::numeric_limits<float>::max_digits10);
+  for (const auto &it : thresholds) {
+    fout << it.first << " " << it.second << "\n";
+  }
+  fout.close();
+}
+
+void DeserializeInt8ScaleTable(const std::string &path,
+                               std::map<std::string, float> *thresholds) {
+  bool is_present = analysis::FileExists(path);
+  PADDLE_ENFORCE_EQ(
+      is_present,
+      true,
+      platform::errors::InvalidArgument("Cannot open %s to read", path));
+  std::ifstream fin(path);
+  std::string line;
+  while (std::getline(fin, line)) {
+    std::istringstream is(line);
+    std::string name;
+    float threshold;
+    if (!(is >> name)) continue;
+    PADDLE_ENFORCE_EQ(static_cast<bool>(is >> threshold) && threshold > 0.f,
+                      true,
+                      platform::errors::InvalidArgument(
+                          "The int8 scale table %s has an invalid line: %s",
+                          path,
+                          line));
+    (*thresholds)[name] = threshold;
+  }
+  fin.close();
+}
+
+void SerializeIpcParams(const std::string &path,
+                        const std::map<std::string, IpcParamInfo> &params) {
+  std::ofstream fout(path);
+  PADDLE_ENFORCE_EQ(
+      fout.is_open(),
+      true,
+      platform::errors::InvalidArgument("Cannot open %s to write", path));
+  static const char kHex[] = "0123456789abcdef";
+  for (const auto &it : params) {
+    const IpcParamInfo &info = it.second;
+    std::string handle;
+    handle.reserve(info.handle.size() * 2);
+    for (unsigned char c : info.handle) {
+      handle.push_back(kHex[c >> 4]);
+      handle.push_back(kHex[c & 0xf]);
+    }
+    fout << it.first << " " << info.device_id << " " << handle << " "
+         << info.offset << " " << info.size << " " << info.dtype << " "
+         << info.dims.size();
+    for (auto dim : info.dims) {
+      fout << " " << dim;
+    }
+    fout << "\n";
+  }
+  fout.close();
+}
+
+void DeserializeIpcParams(const std::string &path,
+                          std::map<std::string, IpcParamInfo> *params) {
+  bool is_present = analysis::FileExists(path);
+  PADDLE_ENFORCE_EQ(
+      is_present,
+      true,
+      platform::errors::InvalidArgument("Cannot open %s to read", path));
+  std::ifstream fin(path);
+  std::string line;
+  while (std::getline(fin, line)) {
+    std::istringstream is(line);
+    std::string name;
+    if (!(is >> name)) continue;
+    IpcParamInfo info;
+    std::string handle;
+    size_t rank = 0;
+    bool valid = static_cast<bool>(is >> info.device_id >> handle >>
+                                   info.offset >> info.size >> info.dtype >>
+                                   rank) &&
+                 handle.size() % 2 == 0;
+    for (size_t i = 0; valid && i < rank; ++i) {
+      int64_t dim = 0;
+      valid = static_cast<bool>(is >> dim);
+      info.dims.push_back(dim);
+    }
+    for (size_t i = 0; valid && i < handle.size(); i += 2) {
+      valid = std::isxdigit(static_cast<unsigned char>(handle[i])) &&
+              std::isxdigit(static_cast<unsigned char>(handle[i + 1]));
+      if (valid) {
+        info.handle.push_back(static_cast<char>(
+            std::stoi(handle.substr(i, 2), nullptr, 16)));
+      }
+    }
+    PADDLE_ENFORCE_EQ(valid,
+                      true,
+                      platform::errors::InvalidArgument(
+                          "The ipc params file %s has an invalid line: %s",
+                          path,
+                          line));
+    (*params)[name] = info;
+  }
+  fin.close();
+}
+
 }  // namespace inference
 }  // namespace paddle
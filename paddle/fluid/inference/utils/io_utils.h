@@ -70,5 +70,38 @@ TEST_API void UpdateShapeRangeInfo(
     const std::map<std::string, std::vector<int32_t>>& opt_value,
     const std::vector<std::string>& names,
     const std::vector<std::string>& tensor_names);
+
+// The int8 scale table keeps a line of "var_name threshold" for every tensor,
+// where threshold is the dynamic range of the tensor, i.e. the tensor is
+// quantized to int8 by the scale 127 / threshold.
+TEST_API void SerializeInt8ScaleTable(
+    const std::string& path, const std::map<std::string, float>& thresholds);
+TEST_API void DeserializeInt8ScaleTable(
+    const std::string& path, std::map<std::string, float>* thresholds);
+
+// A GPU parameter exported by a process through the cuda ipc handle of the
+// memory holding it, offset is the offset of the parameter in that memory.
+struct IpcParamInfo {
+  std::string handle;
+  int device_id{0};
+  int64_t offset{0};
+  size_t size{0};
+  int dtype{0};
+  std::vector<int64_t> dims;
+
+  bool operator==(const IpcParamInfo& other) const {
+    return handle == other.handle && device_id == other.device_id &&
+           offset == other.offset && size == other.size &&
+           dtype == other.dtype && dims == other.dims;
+  }
+};
+
+// The ipc params file keeps a line of
+// "var_name device_id handle offset size dtype rank dims..." for every
+// parameter, where handle is the hex of its cuda ipc handle.
+TEST_API void SerializeIpcParams(
+    const std::string& path, const std::map<std::string, IpcParamInfo>& params);
+TEST_API void DeserializeIpcParams(
+    const std::string& path, std::map<std::string, IpcParamInfo>* params);
 }  // namespace inference
 }  // namespace paddle
@@ -31,10 +31,11 @@ std::unique_ptr<Program> TranslateLegacyProgramToProgram(
     const LegacyProgramDesc& legacy_program) {
   pir::IrContext* ctx = pir::IrContext::Instance();
   ctx->GetOrRegisterDialect<dialect::OperatorDialect>();
-  auto program = std::make_unique<Program>(ctx);
+  auto program = std::make_unique<Program>(ctx, /*use_arena=*/true);
   translator::ProgramTranslator program_translator(&legacy_program,
                                                    program.get());
   VLOG(6) << "begin to translate";
+  pir::OperationArena::Guard guard(program->arena());
   program_translator.Translate();
   VLOG(6) << "translate done";
   return program;
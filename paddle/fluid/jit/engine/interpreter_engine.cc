@@ -30,36 +30,64 @@ namespace jit {
 InterpreterEngine::InterpreterEngine(
     const std::shared_ptr<FunctionInfo> &info,
     const std::shared_ptr<VariableMap> &params_dict,
-    const phi::Place &place)
-    : info_(info), params_dict_(params_dict), place_(place) {
+    const phi::Place &place,
+    const std::shared_ptr<framework::Scope> &params_scope)
+    : InterpreterEngine(info, params_dict, place, params_scope, nullptr) {}
+
+InterpreterEngine::InterpreterEngine(
+    const std::shared_ptr<FunctionInfo> &info,
+    const std::shared_ptr<VariableMap> &params_dict,
+    const phi::Place &place,
+    const std::shared_ptr<framework::Scope> &params_scope,
+    const std::shared_ptr<framework::ProgramDesc> &converted_prog)
+    : info_(info),
+      params_dict_(params_dict),
+      params_scope_(params_scope),
+      scope_(&params_scope->NewScope()),
+      place_(place),
+      converted_prog_(converted_prog) {
   info_->RemoveDescFeedFetch();
   PADDLE_ENFORCE_GT(
       static_cast<int64_t>(info_->ProgramDesc().Block(0).OpSize()),
       0,
       platform::errors::PreconditionNotMet(
           "There is no operator in ProgramDesc."));
-  utils::ShareParamsIntoScope(info_->ParamNames(), params_dict_, &scope_);
-  VLOG(6) << framework::GenScopeTreeDebugInfo(&scope_);
-  CreateInterpreterCore();
+  VLOG(6) << framework::GenScopeTreeDebugInfo(params_scope_.get());
 }
 
-void InterpreterEngine::CreateInterpreterCore() {
-  auto &program_desc = info_->ProgramDesc();
+InterpreterEngine::~InterpreterEngine() noexcept {
+  // the InterpreterCore holds the vars of scope_
+  inner_interpreter_.reset();
+  params_scope_->DeleteScope(scope_);
+}
 
-  // apply inference pass
-  framework::ir::Graph graph{program_desc};
-  auto pass =
-      framework::ir::PassRegistry::Instance().Get("delete_dropout_op_x_pass");
-  pass->Apply(&graph);
+void InterpreterEngine::ConvertProgram() {
+  std::call_once(convert_flag_, [this] {
+    if (converted_prog_) {
+      return;
+    }
+    auto &program_desc = info_->ProgramDesc();
+
+    // apply inference pass
+    framework::ir::Graph graph{program_desc};
+    auto pass =
+        framework::ir::PassRegistry::Instance().Get("delete_dropout_op_x_pass");
+    pass->Apply(&graph);
 #ifdef PADDLE_WITH_DNNL
-  auto mkldnn_pass =
-      framework::ir::PassRegistry::Instance().Get("mkldnn_placement_pass");
-  mkldnn_pass->Set("mkldnn_enabled_op_types",
-                   new std::unordered_set<std::string>({}));
-  mkldnn_pass->Apply(&graph);
+    auto mkldnn_pass =
+        framework::ir::PassRegistry::Instance().Get("mkldnn_placement_pass");
+    mkldnn_pass->Set("mkldnn_enabled_op_types",
+                     new std::unordered_set<std::string>({}));
+    mkldnn_pass->Apply(&graph);
 #endif
 
-  GraphToProgram(graph, &converted_prog_, nullptr);
+    converted_prog_ = std::make_shared<framework::ProgramDesc>();
+    GraphToProgram(graph, converted_prog_.get(), nullptr);
+  });
+}
+
+void InterpreterEngine::CreateInterpreterCore() {
+  ConvertProgram();
 
   framework::interpreter::ExecutionConfig execution_config;
   execution_config.create_local_scope = false;
@@ -71,7 +99,7 @@ void InterpreterEngine::CreateInterpreterCore() {
   execution_config.skip_gc_vars.insert(out_names.begin(), out_names.end());
 
   inner_interpreter_ = std::make_shared<InterpreterCore>(
-      place_, converted_prog_.Block(0), &scope_, execution_config);
+      place_, converted_prog_->Block(0), scope_, execution_config);
 }
 
 std::vector<Tensor> InterpreterEngine::operator()(
@@ -82,7 +110,8 @@ std::vector<Tensor> InterpreterEngine::operator()(
 
 std::vector<DenseTensor> InterpreterEngine::operator()(
     const std::vector<DenseTensor> &inputs) {
-  utils::ShareIntoScope(info_->InputArgNames(), inputs, &scope_);
+  std::call_once(prepare_flag_, [this] { CreateInterpreterCore(); });
+  utils::ShareIntoScope(info_->InputArgNames(), inputs, scope_);
 
   // the latter can be moved to python side.
   auto &feed_names = info_->InputArgNames();
@@ -90,8 +119,8 @@ std::vector<DenseTensor> InterpreterEngine::operator()(
   paddle::framework::FetchList outs = inner_interpreter_->Run(feed_names);
 
   std::vector<DenseTensor> outputs;
-  utils::FetchOuts(info_->OutputArgNames(), scope_, &outputs);
-  scope_.DropKids();
+  utils::FetchOuts(info_->OutputArgNames(), *scope_, &outputs);
+  scope_->DropKids();
 
   return outputs;
 }
@@ -101,7 +130,10 @@ const std::shared_ptr<FunctionInfo> &InterpreterEngine::Info() const {
 }
 
 std::unique_ptr<BaseEngine> InterpreterEngine::Clone(void *stream) {
-  auto *x = new InterpreterEngine(info_, params_dict_, place_);
+  // the clone shares the params and the converted program
+  ConvertProgram();
+  auto *x = new InterpreterEngine(
+      info_, params_dict_, place_, params_scope_, converted_prog_);
   return std::unique_ptr<BaseEngine>(x);
 }
 
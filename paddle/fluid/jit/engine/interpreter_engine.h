@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <vector>
 
 #include "paddle/fluid/framework/program_desc.h"
@@ -35,11 +36,22 @@ using InterpreterCore = framework::InterpreterCore;
 
 class InterpreterEngine : public BaseEngine {
  public:
+  // The params are looked up in params_scope, which is shared by all the
+  // functions of a Layer, and the InterpreterCore is created on the first
+  // call.
   InterpreterEngine(const std::shared_ptr<FunctionInfo> &info,
                     const std::shared_ptr<VariableMap> &params_dict,
-                    const phi::Place &place);
+                    const phi::Place &place,
+                    const std::shared_ptr<framework::Scope> &params_scope);
 
-  ~InterpreterEngine() noexcept {}
+  InterpreterEngine(
+      const std::shared_ptr<FunctionInfo> &info,
+      const std::shared_ptr<VariableMap> &params_dict,
+      const phi::Place &place,
+      const std::shared_ptr<framework::Scope> &params_scope,
+      const std::shared_ptr<framework::ProgramDesc> &converted_prog);
+
+  ~InterpreterEngine() noexcept;
 
   void CreateInterpreterCore();
 
@@ -53,12 +65,19 @@ class InterpreterEngine : public BaseEngine {
   std::unique_ptr<BaseEngine> Clone(void *stream = nullptr) override;
 
  private:
+  // Applies the inference passes once, the clones reuse the result.
+  void ConvertProgram();
+
   std::shared_ptr<FunctionInfo> info_;
   std::shared_ptr<VariableMap> params_dict_;
-  framework::Scope scope_;
+  std::shared_ptr<framework::Scope> params_scope_;
+  // the kid of params_scope_ for the inputs and the temporary vars
+  framework::Scope *scope_;
   phi::Place place_;
+  std::once_flag convert_flag_;
+  std::once_flag prepare_flag_;
   std::shared_ptr<framework::InterpreterCore> inner_interpreter_;
-  framework::ProgramDesc converted_prog_;
+  std::shared_ptr<framework::ProgramDesc> converted_prog_;
 };
 
 }  // namespace jit
@@ -25,33 +25,43 @@ namespace jit {
 PredictorEngine::PredictorEngine(
     const std::shared_ptr<FunctionInfo> &info,
     const std::shared_ptr<VariableMap> &params_dict,
-    const phi::Place &place)
+    const phi::Place &place,
+    const std::shared_ptr<framework::Scope> &params_scope)
     : info_(info),
       params_dict_(params_dict),
-      scope_(new framework::Scope()),
+      scope_(params_scope),
       place_(place) {
-  utils::ShareParamsIntoScope(info_->ParamNames(), params_dict_, scope_.get());
   VLOG(6) << framework::GenScopeTreeDebugInfo(scope_.get());
+}
 
-  // TODO(Aurelius84): Expose AnalysisConfig to user.
-  AnalysisConfig config;
-  config.SetProgFile(info->ProgramFilePath());
-  if (platform::is_gpu_place(place_)) {
-    config.EnableUseGpu(100, place_.GetDeviceId());
-  } else if (platform::is_cpu_place(place_)) {
-    config.DisableGpu();
-    config.EnableMKLDNN();
-    config.EnableMkldnnInt8();
-    config.SetMkldnnCacheCapacity(0);
-  }
-  config.SetSkipLoadParams(true);
-  config.SetApplyOptim(true);
-  config.SwitchIrOptim(true);
+void PredictorEngine::CreatePredictor() {
+  std::call_once(prepare_flag_, [this] {
+    if (predictor_) {
+      return;
+    }
+    // TODO(Aurelius84): Expose AnalysisConfig to user.
+    AnalysisConfig config;
+    config.SetProgFile(info_->ProgramFilePath());
+    if (platform::is_gpu_place(place_)) {
+      config.EnableUseGpu(100, place_.GetDeviceId());
+    } else if (platform::is_cpu_place(place_)) {
+      config.DisableGpu();
+      config.EnableMKLDNN();
+      config.EnableMkldnnInt8();
+      config.SetMkldnnCacheCapacity(0);
+    }
+    config.SetSkipLoadParams(true);
+    config.SetApplyOptim(true);
+    config.SwitchIrOptim(true);
 
-  predictor_.reset(new AnalysisPredictor(config));
+    predictor_.reset(new AnalysisPredictor(config));
 
-  predictor_->Init(
-      scope_, std::make_shared<framework::ProgramDesc>(info_->ProgramDesc()));
+    // the predictor runs in a kid of the shared scope, so that the params
+    // are not copied for every function
+    predictor_->Init(
+        scope_,
+        std::make_shared<framework::ProgramDesc>(info_->ProgramDesc()));
+  });
 }
 
 PredictorEngine::PredictorEngine(
@@ -66,6 +76,7 @@ PredictorEngine::PredictorEngine(
           predictor)) {}
 
 std::unique_ptr<BaseEngine> PredictorEngine::Clone(void *stream) {
+  CreatePredictor();
   auto *x = new PredictorEngine(
       info_, scope_, place_, std::move(predictor_->Clone(stream)));
   return std::unique_ptr<BaseEngine>(x);
@@ -73,6 +84,7 @@ std::unique_ptr<BaseEngine> PredictorEngine::Clone(void *stream) {
 
 std::vector<Tensor> PredictorEngine::operator()(
     const std::vector<Tensor> &inputs) {
+  CreatePredictor();
   std::vector<Tensor> outputs;
   predictor_->Run(inputs, &outputs);
 
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "paddle/fluid/jit/engine/base_engine.h"
 #include "paddle/fluid/jit/function_schema.h"
 #include "paddle/fluid/jit/function_utils.h"
@@ -30,9 +32,12 @@ namespace jit {
 
 class PredictorEngine : public BaseEngine {
  public:
+  // The params are looked up in params_scope, which is shared by all the
+  // functions of a Layer, and the predictor is created on the first call.
   PredictorEngine(const std::shared_ptr<FunctionInfo> &info,
                   const std::shared_ptr<VariableMap> &params_dict,
-                  const phi::Place &place);
+                  const phi::Place &place,
+                  const std::shared_ptr<framework::Scope> &params_scope);
 
   PredictorEngine(const std::shared_ptr<FunctionInfo> &info,
                   const std::shared_ptr<framework::Scope> &scope,
@@ -49,10 +54,15 @@ class PredictorEngine : public BaseEngine {
   std::unique_ptr<BaseEngine> Clone(void *stream = nullptr) override;
 
  private:
+  // Optimizes the program and creates the predictor only once, the clones
+  // reuse the optimized program of it.
+  void CreatePredictor();
+
   std::shared_ptr<FunctionInfo> info_;
   std::shared_ptr<VariableMap> params_dict_;
   std::shared_ptr<framework::Scope> scope_;
   phi::Place place_;
+  std::once_flag prepare_flag_;
   std::shared_ptr<AnalysisPredictor> predictor_;
 };
 
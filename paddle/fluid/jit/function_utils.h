@@ -57,10 +57,12 @@ void ShareParamsIntoScope(const std::vector<std::string> &param_names,
 void RemoveFeedFetch(framework::ProgramDesc *program_desc);
 
 template <typename T>
-std::shared_ptr<T> MakeEngine(const std::shared_ptr<FunctionInfo> &info,
-                              const std::shared_ptr<VariableMap> &params_dict,
-                              const phi::Place &place) {
-  return std::make_shared<T>(info, params_dict, place);
+std::shared_ptr<T> MakeEngine(
+    const std::shared_ptr<FunctionInfo> &info,
+    const std::shared_ptr<VariableMap> &params_dict,
+    const phi::Place &place,
+    const std::shared_ptr<framework::Scope> &params_scope) {
+  return std::make_shared<T>(info, params_dict, place, params_scope);
 }
 
 }  // namespace utils
@@ -16,6 +16,7 @@
 
 #include <set>
 
+#include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/framework/var_desc.h"
 #include "paddle/fluid/framework/variable.h"
 #include "paddle/fluid/platform/device_context.h"
@@ -68,6 +69,13 @@ Layer Deserializer::operator()(const std::string& path,
     VLOG(3) << "Read Property Success!";
   }
 
+  // all the functions share the params in one scope
+  auto params_scope = std::make_shared<framework::Scope>();
+  utils::ShareParamsIntoScope(
+      std::vector<std::string>(param_names_set.begin(), param_names_set.end()),
+      params_dict,
+      params_scope.get());
+
   Layer layer = Layer(params_dict, attrs_dict, info_map, place);
 
   for (auto& map_item : info_map) {
@@ -78,11 +86,13 @@ Layer Deserializer::operator()(const std::string& path,
     if (FLAGS_jit_engine_type == "New") {
       layer.SetEngine(
           func_name,
-          utils::MakeEngine<InterpreterEngine>(info, params_dict, place));
+          utils::MakeEngine<InterpreterEngine>(
+              info, params_dict, place, params_scope));
     } else if (FLAGS_jit_engine_type == "Predictor") {
       layer.SetEngine(
           info->FunctionName(),
-          utils::MakeEngine<PredictorEngine>(info, params_dict, place));
+          utils::MakeEngine<PredictorEngine>(
+              info, params_dict, place, params_scope));
     } else {
       PD_THROW("Invalid JitLayer engine type.");
     }
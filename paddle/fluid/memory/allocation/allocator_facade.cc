@@ -23,6 +23,7 @@
 #include "paddle/fluid/memory/allocation/naive_best_fit_allocator.h"
 #include "paddle/fluid/memory/allocation/retry_allocator.h"
 #include "paddle/fluid/memory/allocation/stat_allocator.h"
+#include "paddle/fluid/memory/allocation/thread_cache_cpu_allocator.h"
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/place.h"
@@ -32,6 +33,7 @@
 
 #include "paddle/fluid/memory/allocation/cuda_allocator.h"
 #include "paddle/fluid/memory/allocation/cuda_managed_allocator.h"
+#include "paddle/fluid/memory/allocation/nccl_mem_allocator.h"
 #include "paddle/fluid/memory/allocation/pinned_allocator.h"
 #include "paddle/fluid/memory/allocation/stream_safe_cuda_allocator.h"
 #include "paddle/fluid/memory/allocation/thread_local_allocator.h"
@@ -47,6 +49,10 @@
 #include "paddle/fluid/memory/allocation/virtual_memory_auto_growth_best_fit_allocator.h"
 #include "paddle/fluid/platform/dynload/cuda_driver.h"
 #endif
+
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+#include "paddle/fluid/memory/allocation/cuda_malloc_async_allocator.h"
+#endif
 #endif
 
 #ifdef PADDLE_WITH_XPU
@@ -95,6 +101,13 @@ PADDLE_DEFINE_EXPORTED_bool(use_cuda_managed_memory,
                             "managed memory, only available for auto_growth "
                             "strategy");
 
+PADDLE_DEFINE_EXPORTED_bool(
+    use_thread_cache_cpu_allocator,
+    false,
+    "Whether to use ThreadCacheCPUAllocator for CPUPlace, which serves small "
+    "allocations from per-thread size-class caches and scales better than "
+    "CPUAllocator when many threads allocate concurrently");
+
 PHI_DECLARE_string(allocator_strategy);
 PHI_DECLARE_uint64(auto_growth_chunk_size_in_mb);
 PHI_DECLARE_bool(use_auto_growth_pinned_allocator);
@@ -303,6 +316,26 @@ class AllocatorFacadePrivate {
         break;
       }
 
+      case AllocatorStrategy::kCUDAMallocAsync: {
+        InitNaiveBestFitCPUAllocator();
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+        for (int dev_id = 0; dev_id < platform::GetGPUDeviceCount(); ++dev_id) {
+          InitCUDAMallocAsyncAllocator(platform::CUDAPlace(dev_id));
+        }
+        InitNaiveBestFitCUDAPinnedAllocator();
+        // The stream-ordered pool is multi-stream safe by itself, treat it as
+        // a StreamSafeCUDAAllocator so that allocations for non-default
+        // streams go to cuda_allocators_
+        is_stream_safe_cuda_allocator_used_ = true;
+#elif defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+        PADDLE_THROW(platform::errors::Unavailable(
+            "The cuda_malloc_async allocator strategy requires CUDA 11.2 or "
+            "higher, please use FLAGS_allocator_strategy=\"auto_growth\" "
+            "instead."));
+#endif
+        break;
+      }
+
       default: {
         PADDLE_THROW(platform::errors::InvalidArgument(
             "Unsupported allocator strategy: %d", static_cast<int>(strategy_)));
@@ -410,13 +443,52 @@ class AllocatorFacadePrivate {
     return iter->second;
   }
 
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+  const std::shared_ptr<CUDAMallocAsyncAllocator>&
+  GetDefaultCUDAMallocAsyncAllocator(const platform::CUDAPlace& place) const {
+    const auto iter = default_cuda_malloc_async_allocators_.find(place);
+    PADDLE_ENFORCE_NE(
+        iter,
+        default_cuda_malloc_async_allocators_.end(),
+        platform::errors::NotFound(
+            "No CUDAMallocAsyncAllocator found for the place, %s", place));
+    return iter->second;
+  }
+#endif
+
   gpuStream_t GetDefaultStream(const platform::CUDAPlace& place) const {
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+    if (strategy_ == AllocatorStrategy::kCUDAMallocAsync) {
+      return GetDefaultCUDAMallocAsyncAllocator(place)->GetDefaultStream();
+    }
+#endif
     const std::shared_ptr<StreamSafeCUDAAllocator>& allocator =
         GetDefaultStreamSafeCUDAAllocator(place);
     return allocator->GetDefaultStream();
   }
 
   void SetDefaultStream(const platform::CUDAPlace& place, gpuStream_t stream) {
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+    if (strategy_ == AllocatorStrategy::kCUDAMallocAsync) {
+      const std::shared_ptr<CUDAMallocAsyncAllocator>& allocator =
+          GetDefaultCUDAMallocAsyncAllocator(place);
+      PADDLE_ENFORCE_EQ(
+          allocator->GetDefaultStream(),
+          nullptr,
+          platform::errors::Unavailable(
+              "The default stream for CUDAMallocAsyncAllocator(%p) in %s has "
+              "been set to %p, not allow to change it to %p.",
+              allocator.get(),
+              place,
+              allocator->GetDefaultStream(),
+              stream));
+      allocator->SetDefaultStream(stream);
+      VLOG(8) << "Set default stream to " << stream
+              << " for CUDAMallocAsyncAllocator(" << allocator.get()
+              << ") in " << place;
+      return;
+    }
+#endif
     const std::shared_ptr<StreamSafeCUDAAllocator>& allocator =
         GetDefaultStreamSafeCUDAAllocator(place);
 
@@ -443,9 +515,17 @@ class AllocatorFacadePrivate {
         std::dynamic_pointer_cast<StreamSafeCUDAAllocation>(allocation);
     if (stream_safe_cuda_allocation != nullptr) {
       stream_safe_cuda_allocation->RecordStream(stream);
-    } else {
-      VLOG(6) << "RecordStream for a non-StreamSafeCUDAAllocation";
+      return;
+    }
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+    std::shared_ptr<CUDAMallocAsyncAllocation> async_allocation =
+        std::dynamic_pointer_cast<CUDAMallocAsyncAllocation>(allocation);
+    if (async_allocation != nullptr) {
+      async_allocation->RecordStream(stream);
+      return;
     }
+#endif
+    VLOG(6) << "RecordStream for a non-StreamSafeCUDAAllocation";
   }
 
   void EraseStream(std::shared_ptr<phi::Allocation> allocation,
@@ -454,9 +534,17 @@ class AllocatorFacadePrivate {
         std::dynamic_pointer_cast<StreamSafeCUDAAllocation>(allocation);
     if (stream_safe_cuda_allocation != nullptr) {
       stream_safe_cuda_allocation->EraseStream(stream);
-    } else {
-      VLOG(6) << "EraseStream for a non-StreamSafeCUDAAllocation";
+      return;
+    }
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+    std::shared_ptr<CUDAMallocAsyncAllocation> async_allocation =
+        std::dynamic_pointer_cast<CUDAMallocAsyncAllocation>(allocation);
+    if (async_allocation != nullptr) {
+      async_allocation->EraseStream(stream);
+      return;
     }
+#endif
+    VLOG(6) << "EraseStream for a non-StreamSafeCUDAAllocation";
   }
 
   gpuStream_t GetStream(
@@ -467,6 +555,13 @@ class AllocatorFacadePrivate {
     if (stream_safe_cuda_allocation != nullptr) {
       return stream_safe_cuda_allocation->GetOwningStream();
     }
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+    const std::shared_ptr<CUDAMallocAsyncAllocation> async_allocation =
+        std::dynamic_pointer_cast<CUDAMallocAsyncAllocation>(allocation);
+    if (async_allocation != nullptr) {
+      return async_allocation->GetOwningStream();
+    }
+#endif
 
     VLOG(6) << "GetStream for a non-StreamSafeCUDAAllocation";
     return static_cast<phi::GPUContext*>(
@@ -726,7 +821,12 @@ class AllocatorFacadePrivate {
     allocators_[platform::CPUPlace()] =
         std::make_shared<NaiveBestFitAllocator>(platform::CPUPlace());
 #else
-    allocators_[platform::CPUPlace()] = std::make_shared<CPUAllocator>();
+    if (FLAGS_use_thread_cache_cpu_allocator) {
+      allocators_[platform::CPUPlace()] =
+          std::make_shared<ThreadCacheCPUAllocator>();
+    } else {
+      allocators_[platform::CPUPlace()] = std::make_shared<CPUAllocator>();
+    }
 #endif
   }
 
@@ -783,6 +883,21 @@ class AllocatorFacadePrivate {
   }
 
   void InitStreamSafeCUDAAllocator(platform::CUDAPlace p, gpuStream_t stream) {
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+    if (strategy_ == AllocatorStrategy::kCUDAMallocAsync) {
+      if (LIKELY(!HasCUDAAllocator(p, stream))) {
+        VLOG(8) << "Init CUDAMallocAsyncAllocator for stream " << stream
+                << " in place " << p;
+        cuda_allocators_[p][stream] =
+            std::make_shared<CUDAMallocAsyncAllocator>(p, stream);
+        if (FLAGS_gpu_allocator_retry_time > 0) {
+          WrapCUDARetryAllocator(p, stream, FLAGS_gpu_allocator_retry_time);
+        }
+        WrapStatAllocator(p, stream);
+      }
+      return;
+    }
+#endif
     PADDLE_ENFORCE_EQ(
         strategy_,
         AllocatorStrategy::kAutoGrowth,
@@ -800,6 +915,15 @@ class AllocatorFacadePrivate {
     }
   }
 
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+  void InitCUDAMallocAsyncAllocator(platform::CUDAPlace p) {
+    auto allocator = std::make_shared<CUDAMallocAsyncAllocator>(
+        p, /* default_stream = */ nullptr);
+    allocators_[p] = allocator;
+    default_cuda_malloc_async_allocators_[p] = allocator;
+  }
+#endif
+
   void InitAutoGrowthCUDAAllocator(platform::CUDAPlace p, gpuStream_t stream) {
     auto chunk_size = FLAGS_auto_growth_chunk_size_in_mb << 20;
     VLOG(4) << "FLAGS_auto_growth_chunk_size_in_mb is "
@@ -1187,7 +1311,8 @@ class AllocatorFacadePrivate {
             << FLAGS_auto_growth_chunk_size_in_mb;
 
     auto custom_allocator =
-        std::make_shared<paddle::memory::allocation::CustomAllocator>(p);
+        std::make_shared<paddle::memory::allocation::CustomAllocator>(p,
+                                                                      stream);
     auto alignment = phi::DeviceManager::GetMinChunkSize(p);
     custom_device_allocators_[p][stream] =
         std::make_shared<AutoGrowthBestFitAllocator>(
@@ -1359,6 +1484,12 @@ class AllocatorFacadePrivate {
   // a standalone CUDA allocator to support multi-stream GC in new executor
   std::map<platform::Place, std::shared_ptr<StreamSafeCUDAAllocator>>
       default_stream_safe_cuda_allocators_;
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11020
+  // the default stream allocators of cuda_malloc_async strategy, kept to
+  // change their default stream from outside like the map above
+  std::map<platform::Place, std::shared_ptr<CUDAMallocAsyncAllocator>>
+      default_cuda_malloc_async_allocators_;
+#endif
   CUDAAllocatorMap cuda_allocators_;
   std::shared_timed_mutex cuda_allocator_mutex_;
 #endif
@@ -1578,6 +1709,50 @@ void AllocatorFacade::SetDefaultStream(const platform::CUDAPlace& place,
   }
 }
 
+std::shared_ptr<phi::Allocation> AllocatorFacade::AllocCommShared(
+    const platform::CUDAPlace& place, size_t size) {
+#ifdef PADDLE_WITH_NCCL_MEM_ALLOC
+  static std::mutex mutex;
+  static std::map<int, std::shared_ptr<NCCLMemAllocator>> allocators;
+  std::shared_ptr<NCCLMemAllocator> allocator;
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto& device_allocator = allocators[place.device];
+    if (device_allocator == nullptr) {
+      device_allocator = std::make_shared<NCCLMemAllocator>(place);
+    }
+    allocator = device_allocator;
+  }
+  return allocator->Allocate(size);
+#else
+  return AllocShared(place, size);
+#endif
+}
+
+std::shared_ptr<phi::Allocation> AllocatorFacade::AllocGrowableShared(
+    const platform::CUDAPlace& place, size_t size, size_t max_size) {
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 10020
+  CUdevice device;
+  int val;
+  try {
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        paddle::platform::dynload::cuDeviceGet(&device, place.GetDeviceId()));
+
+    PADDLE_ENFORCE_GPU_SUCCESS(paddle::platform::dynload::cuDeviceGetAttribute(
+        &val,
+        CU_DEVICE_ATTRIBUTE_VIRTUAL_ADDRESS_MANAGEMENT_SUPPORTED,
+        device));
+  } catch (...) {
+    val = 0;
+  }
+
+  if (val > 0) {
+    return CUDAGrowableAllocation::Create(place, size, max_size);
+  }
+#endif
+  return AllocShared(place, size);
+}
+
 #ifdef PADDLE_WITH_CUDA
 void AllocatorFacade::PrepareMemoryPoolForCUDAGraph(int64_t id) {
   PADDLE_ENFORCE_EQ(GetAllocatorStrategy(),
@@ -91,6 +91,16 @@ class AllocatorFacade {
                                                  gpuStream_t stream);
   gpuStream_t GetStream(const std::shared_ptr<Allocation>& allocation) const;
   void SetDefaultStream(const platform::CUDAPlace& place, gpuStream_t stream);
+  // Allocate a buffer of the collectives, which is by ncclMemAlloc and may be
+  // registered to the nccl communicators if nccl supports it, or an ordinary
+  // allocation otherwise.
+  std::shared_ptr<Allocation> AllocCommShared(const platform::CUDAPlace& place,
+                                              size_t size);
+  // Allocate a buffer which reserves the virtual address space of max_size
+  // and can be extended in place by phi::Allocation::Extend, or an ordinary
+  // allocation if the device does not support the virtual memory management.
+  std::shared_ptr<Allocation> AllocGrowableShared(
+      const platform::CUDAPlace& place, size_t size, size_t max_size);
 #endif
 
 #ifdef PADDLE_WITH_CUDA
@@ -16,6 +16,8 @@
 
 #include <algorithm>
 #include <mutex>  // NOLINT
+#include <set>
+#include <sstream>
 
 #include "paddle/fluid/memory/allocation/aligned_allocator.h"
 #include "paddle/fluid/platform/flags.h"
@@ -37,6 +39,15 @@ PADDLE_DEFINE_EXPORTED_READONLY_bool(
     "chunk would be freed when out of memory occurs. This flag "
     "only works when FLAGS_allocator_strategy=auto_growth.");
 
+PADDLE_DEFINE_EXPORTED_bool(
+    auto_growth_compact_idle_chunks,
+    false,
+    "Whether to merge the idle chunks into a single chunk when all the "
+    "allocations of an allocator are freed (e.g., at the end of a step). "
+    "It reduces fragmentation across chunks for dynamic-shape workloads "
+    "at the cost of re-allocating the chunk. This flag only works when "
+    "FLAGS_allocator_strategy=auto_growth.");
+
 PADDLE_DEFINE_EXPORTED_READONLY_bool(print_allocator_trace_info,
                                      false,
                                      "print trace memory info");
@@ -45,6 +56,47 @@ namespace paddle {
 namespace memory {
 namespace allocation {
 
+double FragmentationInfo::FragmentationRatio() const {
+  if (free_size == 0) {
+    return 0.0;
+  }
+  return 1.0 - static_cast<double>(largest_free_block) /
+                   static_cast<double>(free_size);
+}
+
+std::string FragmentationInfo::ToString() const {
+  std::stringstream ss;
+  ss << "reserved: " << reserved_size << ", free: " << free_size
+     << ", largest free block: " << largest_free_block
+     << ", fragmentation: " << FragmentationRatio()
+     << ", chunks: " << chunks.size() << "\nfree block histogram:";
+  for (size_t i = 0; i < free_block_histogram.size(); ++i) {
+    if (free_block_histogram[i] > 0) {
+      ss << " [2^" << i << ", 2^" << i + 1 << "): " << free_block_histogram[i];
+    }
+  }
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    const ChunkFragmentationInfo &chunk = chunks[i];
+    ss << "\nchunk " << i << ": size " << chunk.chunk_size << ", free "
+       << chunk.free_size << ", largest free block "
+       << chunk.largest_free_block << ", blocks " << chunk.num_blocks
+       << ", free blocks " << chunk.num_free_blocks;
+  }
+  return ss.str();
+}
+
+// All the living AutoGrowthBestFitAllocators, for GetAllFragmentationInfo.
+// They are never destroyed since allocators may be destroyed during exit.
+static std::mutex &AllocatorRegistryMutex() {
+  static std::mutex *mtx = new std::mutex();
+  return *mtx;
+}
+
+static std::set<AutoGrowthBestFitAllocator *> &AllocatorRegistry() {
+  static auto *registry = new std::set<AutoGrowthBestFitAllocator *>();
+  return *registry;
+}
+
 AutoGrowthBestFitAllocator::AutoGrowthBestFitAllocator(
     const std::shared_ptr<Allocator> &underlying_allocator,
     size_t alignment,
@@ -58,7 +110,16 @@ AutoGrowthBestFitAllocator::AutoGrowthBestFitAllocator(
   total_alloc_size_ = 0;
   total_free_times_ = 0;
   total_free_size_ = 0;
+  num_used_blocks_ = 0;
   VLOG(4) << "chunk_size_:" << chunk_size_;
+
+  std::lock_guard<std::mutex> guard(AllocatorRegistryMutex());
+  AllocatorRegistry().insert(this);
+}
+
+AutoGrowthBestFitAllocator::~AutoGrowthBestFitAllocator() {
+  std::lock_guard<std::mutex> guard(AllocatorRegistryMutex());
+  AllocatorRegistry().erase(this);
 }
 
 phi::Allocation *AutoGrowthBestFitAllocator::AllocateImpl(
@@ -103,8 +164,20 @@ phi::Allocation *AutoGrowthBestFitAllocator::AllocateImpl(
     } catch (BadAlloc &ex) {
       if (FLAGS_free_when_no_cache_hit) throw ex;
       FreeIdleChunks();
-      chunks_.emplace_back(static_unique_ptr_cast<Allocation>(
-          underlying_allocator_->Allocate(realloc_size)));
+      try {
+        chunks_.emplace_back(static_unique_ptr_cast<Allocation>(
+            underlying_allocator_->Allocate(realloc_size)));
+      } catch (BadAlloc &retry_ex) {
+        FragmentationInfo info = GetFragmentationInfoImpl();
+        if (info.free_size >= size) {
+          LOG(WARNING) << "Fail to allocate " << size
+                       << " bytes while the allocator caches "
+                       << info.free_size
+                       << " free bytes, the memory is fragmented:\n"
+                       << info.ToString();
+        }
+        throw retry_ex;
+      }
     }
 
     auto *chunk = &(*chunks_.rbegin());
@@ -124,6 +197,7 @@ phi::Allocation *AutoGrowthBestFitAllocator::AllocateImpl(
   }
   ++total_alloc_times_;
   total_alloc_size_ += size;
+  ++num_used_blocks_;
   VLOG(10) << "Alloc " << block_it->size_ << " bytes, ptr = " << block_it->ptr_;
   return new BlockAllocation(block_it);
 }
@@ -140,6 +214,7 @@ void AutoGrowthBestFitAllocator::FreeImpl(phi::Allocation *allocation) {
 
   total_free_times_ += 1;
   total_free_size_ += block_it->size_;
+  --num_used_blocks_;
 
   block_it->is_free_ = true;
 
@@ -171,6 +246,8 @@ void AutoGrowthBestFitAllocator::FreeImpl(phi::Allocation *allocation) {
 
   if (FLAGS_free_idle_chunk) {
     FreeIdleChunks();
+  } else if (FLAGS_auto_growth_compact_idle_chunks && num_used_blocks_ == 0) {
+    CompactIdleChunksImpl();
   }
 }
 
@@ -198,6 +275,99 @@ uint64_t AutoGrowthBestFitAllocator::FreeIdleChunks() {
   return bytes;
 }
 
+size_t AutoGrowthBestFitAllocator::CompactIdleChunks() {
+  std::lock_guard<SpinLock> guard(spinlock_);
+  return CompactIdleChunksImpl();
+}
+
+size_t AutoGrowthBestFitAllocator::CompactIdleChunksImpl() {
+  if (!allow_free_idle_chunk_) {
+    return 0;
+  }
+  size_t num_idle_chunks = 0;
+  for (auto &chunk : chunks_) {
+    if (chunk.blocks_.size() == 1 && chunk.blocks_.begin()->is_free_) {
+      ++num_idle_chunks;
+    }
+  }
+  if (num_idle_chunks < 2) {
+    return 0;
+  }
+
+  size_t idle_bytes = FreeIdleChunks();
+  try {
+    chunks_.emplace_back(static_unique_ptr_cast<Allocation>(
+        underlying_allocator_->Allocate(idle_bytes)));
+  } catch (BadAlloc &ex) {
+    // the released memory has been taken by others, keep it released
+    VLOG(2) << "Fail to allocate merged chunk of size " << idle_bytes;
+    return num_idle_chunks;
+  }
+
+  auto *chunk = &(*chunks_.rbegin());
+  uint8_t *p = reinterpret_cast<uint8_t *>(chunk->allocation_->ptr());
+  chunk->blocks_.emplace_back(p, chunk->allocation_->size(), true, chunk);
+  free_blocks_.emplace(std::make_pair(chunk->allocation_->size(), p),
+                       --(chunk->blocks_.end()));
+  VLOG(2) << "Merge " << num_idle_chunks << " idle chunks into one chunk of "
+          << chunk->allocation_->size() << " bytes";
+  return num_idle_chunks;
+}
+
+FragmentationInfo AutoGrowthBestFitAllocator::GetFragmentationInfo() {
+  std::lock_guard<SpinLock> guard(spinlock_);
+  return GetFragmentationInfoImpl();
+}
+
+FragmentationInfo AutoGrowthBestFitAllocator::GetFragmentationInfoImpl()
+    const {
+  FragmentationInfo info;
+  for (auto &chunk : chunks_) {
+    ChunkFragmentationInfo chunk_info;
+    chunk_info.chunk_size = chunk.allocation_->size();
+    chunk_info.num_blocks = chunk.blocks_.size();
+    for (auto &block : chunk.blocks_) {
+      if (!block.is_free_) {
+        continue;
+      }
+      ++chunk_info.num_free_blocks;
+      chunk_info.free_size += block.size_;
+      chunk_info.largest_free_block =
+          std::max(chunk_info.largest_free_block, block.size_);
+
+      size_t bucket = 0;
+      while ((block.size_ >> (bucket + 1)) > 0) {
+        ++bucket;
+      }
+      if (info.free_block_histogram.size() <= bucket) {
+        info.free_block_histogram.resize(bucket + 1, 0);
+      }
+      ++info.free_block_histogram[bucket];
+    }
+    info.reserved_size += chunk_info.chunk_size;
+    info.free_size += chunk_info.free_size;
+    info.largest_free_block =
+        std::max(info.largest_free_block, chunk_info.largest_free_block);
+    info.chunks.emplace_back(chunk_info);
+  }
+  return info;
+}
+
+std::vector<FragmentationInfo>
+AutoGrowthBestFitAllocator::GetAllFragmentationInfo(
+    const platform::Place &place) {
+  std::vector<FragmentationInfo> infos;
+  std::lock_guard<std::mutex> registry_guard(AllocatorRegistryMutex());
+  for (AutoGrowthBestFitAllocator *allocator : AllocatorRegistry()) {
+    std::lock_guard<SpinLock> guard(allocator->spinlock_);
+    if (!allocator->chunks_.empty() &&
+        allocator->chunks_.begin()->allocation_->place() == place) {
+      infos.emplace_back(allocator->GetFragmentationInfoImpl());
+    }
+  }
+  return infos;
+}
+
 void AutoGrowthBestFitAllocator::Trace() const {
   size_t cur_idle_bytes = 0;
   auto it = free_blocks_.begin();
@@ -217,7 +387,9 @@ void AutoGrowthBestFitAllocator::Trace() const {
           << "m alloc_times:" << total_alloc_times_
           << " free_times:" << total_free_times_
           << " free_blocks_num:" << free_blocks_.size()
-          << " curr_chunks_num:" << chunks_.size();
+          << " curr_chunks_num:" << chunks_.size()
+          << " fragmentation:"
+          << GetFragmentationInfoImpl().FragmentationRatio();
 }
 
 }  // namespace allocation
@@ -18,7 +18,9 @@
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "paddle/fluid/memory/allocation/allocator.h"
 #include "paddle/fluid/memory/allocation/spin_lock.h"
@@ -27,6 +29,32 @@ namespace paddle {
 namespace memory {
 namespace allocation {
 
+// The free memory layout of one chunk of AutoGrowthBestFitAllocator
+struct ChunkFragmentationInfo {
+  size_t chunk_size{0};
+  size_t free_size{0};
+  size_t largest_free_block{0};
+  size_t num_blocks{0};
+  size_t num_free_blocks{0};
+};
+
+// The free memory layout of an AutoGrowthBestFitAllocator, which tells whether
+// an OOM is caused by fragmentation, i.e., there is enough free memory but no
+// contiguous block is large enough.
+struct FragmentationInfo {
+  size_t reserved_size{0};
+  size_t free_size{0};
+  size_t largest_free_block{0};
+  // free_block_histogram[i] is the number of free blocks whose size is in
+  // [2^i, 2^(i+1))
+  std::vector<size_t> free_block_histogram;
+  std::vector<ChunkFragmentationInfo> chunks;
+
+  // 1 - largest_free_block / free_size, 0 means no fragmentation
+  double FragmentationRatio() const;
+  std::string ToString() const;
+};
+
 class AutoGrowthBestFitAllocator : public Allocator {
  public:
   AutoGrowthBestFitAllocator(
@@ -35,8 +63,21 @@ class AutoGrowthBestFitAllocator : public Allocator {
       size_t chunk_size = 0,
       bool allow_free_idle_chunk = true);
 
+  ~AutoGrowthBestFitAllocator() override;
+
   bool IsAllocThreadSafe() const override { return true; }
 
+  FragmentationInfo GetFragmentationInfo();
+
+  // Replace the idle chunks by a single chunk of the same total size, so that
+  // the cached memory becomes contiguous. Return the number of chunks merged.
+  size_t CompactIdleChunks();
+
+  // Return the fragmentation info of all the AutoGrowthBestFitAllocators that
+  // hold memory in place
+  static std::vector<FragmentationInfo> GetAllFragmentationInfo(
+      const platform::Place &place);
+
  protected:
   phi::Allocation *AllocateImpl(size_t size) override;
 
@@ -49,6 +90,8 @@ class AutoGrowthBestFitAllocator : public Allocator {
 
  private:
   uint64_t FreeIdleChunks();
+  size_t CompactIdleChunksImpl();
+  FragmentationInfo GetFragmentationInfoImpl() const;
   void Trace() const;
 
   template <typename T>
@@ -99,6 +142,7 @@ class AutoGrowthBestFitAllocator : public Allocator {
   size_t total_alloc_size_;
   size_t total_free_times_;
   size_t total_free_size_;
+  size_t num_used_blocks_;
 
   SpinLock spinlock_;
 };
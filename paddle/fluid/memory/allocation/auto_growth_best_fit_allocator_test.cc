@@ -15,12 +15,14 @@
 #include "paddle/fluid/memory/allocation/auto_growth_best_fit_allocator.h"
 
 #include <cstdlib>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "paddle/fluid/memory/allocation/aligned_allocator.h"
 
 PD_DECLARE_bool(free_idle_chunk);
 PD_DECLARE_bool(free_when_no_cache_hit);
+PD_DECLARE_bool(auto_growth_compact_idle_chunks);
 
 namespace paddle {
 namespace memory {
@@ -158,6 +160,61 @@ static void TestFreeWhenNoCacheHit(bool free_when_no_cache_hit) {
             allocate_size[2] + alignment);
 }
 
+static void TestFragmentationInfo(bool compact_idle_chunks) {
+  FLAGS_free_idle_chunk = false;
+  FLAGS_free_when_no_cache_hit = false;
+  FLAGS_auto_growth_compact_idle_chunks = compact_idle_chunks;
+  auto recorded_allocator = std::make_shared<RecordedAllocator>();
+
+  // use the recorded allocator directly so that the chunk sizes are exact
+  size_t alignment = 256;
+  size_t chunk_size = 4096;
+  auto ag_allocator = std::make_shared<AutoGrowthBestFitAllocator>(
+      recorded_allocator, alignment, chunk_size);
+
+  // fill two chunks, and then free every other block
+  std::vector<AllocationPtr> allocations;
+  for (size_t i = 0; i < 2 * chunk_size / 1024; ++i) {
+    allocations.emplace_back(ag_allocator->Allocate(1024));
+  }
+  for (size_t i = 0; i < allocations.size(); i += 2) {
+    allocations[i].reset();
+  }
+
+  FragmentationInfo info = ag_allocator->GetFragmentationInfo();
+  ASSERT_EQ(info.chunks.size(), 2UL);
+  ASSERT_EQ(info.reserved_size, 2 * chunk_size);
+  ASSERT_EQ(info.free_size, chunk_size);
+  ASSERT_EQ(info.largest_free_block, 1024UL);
+  ASSERT_EQ(info.free_block_histogram.size(), 11UL);
+  ASSERT_EQ(info.free_block_histogram[10], 4UL);
+  ASSERT_GT(info.FragmentationRatio(), 0.5);
+  ASSERT_GE(
+      AutoGrowthBestFitAllocator::GetAllFragmentationInfo(platform::CPUPlace())
+          .size(),
+      1UL);
+
+  allocations.clear();
+  info = ag_allocator->GetFragmentationInfo();
+  if (compact_idle_chunks) {
+    // the two idle chunks are merged when the allocator becomes idle
+    ASSERT_EQ(info.chunks.size(), 1UL);
+    ASSERT_EQ(info.largest_free_block, 2 * chunk_size);
+  } else {
+    ASSERT_EQ(info.chunks.size(), 2UL);
+    ASSERT_EQ(info.largest_free_block, chunk_size);
+    ASSERT_EQ(ag_allocator->CompactIdleChunks(), 2UL);
+    ASSERT_EQ(ag_allocator->GetFragmentationInfo().chunks.size(), 1UL);
+  }
+  ASSERT_FLOAT_EQ(ag_allocator->GetFragmentationInfo().FragmentationRatio(),
+                  0.0);
+
+  // the merged chunk can serve a request larger than the original chunks
+  auto allocation = ag_allocator->Allocate(2 * chunk_size);
+  ASSERT_EQ(recorded_allocator->AllocatedSize(), 2 * chunk_size);
+  FLAGS_auto_growth_compact_idle_chunks = false;
+}
+
 TEST(test_auto_growth_allocator, test_free_idle_chunk) {
   for (auto free_idle_chunk : {false, true}) {
     for (auto free_when_no_cache_hit : {false, true}) {
@@ -171,6 +228,11 @@ TEST(test_auto_growth_allocator, test_free_when_no_cache_hit) {
   TestFreeWhenNoCacheHit(true);
 }
 
+TEST(test_auto_growth_allocator, test_fragmentation_info) {
+  TestFragmentationInfo(false);
+  TestFragmentationInfo(true);
+}
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
@@ -68,6 +68,28 @@ std::shared_ptr<void> GetIpcBasePtr(std::string handle) {
   return sp;
 }
 
+std::string GetIpcMemHandle(const phi::Allocation &allocation,
+                            ptrdiff_t *offset) {
+  auto *holder = dynamic_cast<const Allocation *>(&allocation);
+  PADDLE_ENFORCE_NOT_NULL(holder,
+                          platform::errors::InvalidArgument(
+                              "The allocation to share by cuda ipc should be "
+                              "allocated by the allocator facade."));
+  PADDLE_ENFORCE_EQ(platform::is_gpu_place(holder->place()),
+                    true,
+                    platform::errors::InvalidArgument(
+                        "Only the allocation on GPU can be shared by cuda ipc, "
+                        "but got %s.",
+                        holder->place()));
+  void *base_ptr = holder->base_ptr();
+  *offset = reinterpret_cast<char *>(holder->ptr()) -
+            reinterpret_cast<char *>(base_ptr);
+  platform::CUDADeviceGuard guard(holder->place().GetDeviceId());
+  cudaIpcMemHandle_t handle;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaIpcGetMemHandle(&handle, base_ptr));
+  return std::string(reinterpret_cast<char *>(&handle), CUDA_IPC_HANDLE_SIZE);
+}
+
 CudaIpcAllocation::~CudaIpcAllocation() {
   shared_ptr_.reset();
   VLOG(6) << "tensor deleted cudaIpcCloseMemHandle for ptr:"
@@ -32,6 +32,11 @@ namespace allocation {
 
 std::shared_ptr<void> GetIpcBasePtr(std::string handle);
 
+// Returns the ipc handle of the memory directly requested from the system
+// that holds the allocation, and the offset of the allocation in it.
+std::string GetIpcMemHandle(const phi::Allocation &allocation,
+                            ptrdiff_t *offset);
+
 class CudaIpcAllocation : public Allocation {
  public:
   explicit CudaIpcAllocation(void *ptr,
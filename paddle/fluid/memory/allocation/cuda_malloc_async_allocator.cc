@@ -0,0 +1,192 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/cuda_malloc_async_allocator.h"
+
+#include <limits>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include "paddle/fluid/platform/cuda_device_guard.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/fluid/platform/flags.h"
+#include "paddle/phi/backends/gpu/cuda/cuda_graph.h"
+
+PADDLE_DEFINE_EXPORTED_int64(
+    cuda_malloc_async_release_threshold_mb,
+    -1,
+    "The amount of reserved memory in MB that the stream-ordered memory pool "
+    "holds before trying to release memory back to the OS when a stream is "
+    "synchronized. -1 means never release (recommended for training).");
+PADDLE_DEFINE_EXPORTED_bool(
+    cuda_malloc_async_enable_peer_access,
+    true,
+    "Whether to make the stream-ordered memory pool of a GPU accessible by "
+    "its peer GPUs, only used when FLAGS_allocator_strategy = "
+    "cuda_malloc_async.");
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+void CUDAMallocAsyncAllocation::RecordStream(gpuStream_t stream) {
+  if (stream == owning_stream_) {
+    return;
+  }
+  std::lock_guard<SpinLock> lock_guard(recorded_streams_lock_);
+  recorded_streams_.insert(stream);
+}
+
+void CUDAMallocAsyncAllocation::EraseStream(gpuStream_t stream) {
+  std::lock_guard<SpinLock> lock_guard(recorded_streams_lock_);
+  recorded_streams_.erase(stream);
+}
+
+void CUDAMallocAsyncAllocation::SyncRecordedStreams() {
+  std::lock_guard<SpinLock> lock_guard(recorded_streams_lock_);
+  for (gpuStream_t stream : recorded_streams_) {
+    cudaEvent_t event;
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event, stream));
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(owning_stream_, event, 0));
+    // the event is released by driver after the wait is done
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventDestroy(event));
+  }
+  recorded_streams_.clear();
+}
+
+CUDAMallocAsyncAllocator::CUDAMallocAsyncAllocator(
+    const platform::CUDAPlace& place, gpuStream_t default_stream)
+    : place_(place), default_stream_(default_stream) {
+  InitMemPool();
+}
+
+void CUDAMallocAsyncAllocator::InitMemPool() {
+  static std::mutex mtx;
+  static std::set<int> initialized_devices;
+
+  int dev_id = place_.GetDeviceId();
+  platform::CUDADeviceGuard guard(dev_id);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaDeviceGetDefaultMemPool(&mem_pool_, dev_id));
+
+  std::lock_guard<std::mutex> lock_guard(mtx);
+  if (initialized_devices.insert(dev_id).second) {
+    int pool_supported = 0;
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaDeviceGetAttribute(
+        &pool_supported, cudaDevAttrMemoryPoolsSupported, dev_id));
+    PADDLE_ENFORCE_EQ(
+        pool_supported,
+        1,
+        platform::errors::Unavailable(
+            "GPU %d does not support stream-ordered memory pool, please use "
+            "another FLAGS_allocator_strategy.",
+            dev_id));
+
+    uint64_t threshold =
+        FLAGS_cuda_malloc_async_release_threshold_mb < 0
+            ? std::numeric_limits<uint64_t>::max()
+            : static_cast<uint64_t>(
+                  FLAGS_cuda_malloc_async_release_threshold_mb)
+                  << 20;
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemPoolSetAttribute(
+        mem_pool_, cudaMemPoolAttrReleaseThreshold, &threshold));
+
+    if (FLAGS_cuda_malloc_async_enable_peer_access) {
+      int device_count = platform::GetGPUDeviceCount();
+      for (int peer_id = 0; peer_id < device_count; ++peer_id) {
+        if (peer_id == dev_id) {
+          continue;
+        }
+        int can_access = 0;
+        PADDLE_ENFORCE_GPU_SUCCESS(
+            cudaDeviceCanAccessPeer(&can_access, peer_id, dev_id));
+        if (!can_access) {
+          continue;
+        }
+        cudaMemAccessDesc desc = {};
+        desc.location.type = cudaMemLocationTypeDevice;
+        desc.location.id = peer_id;
+        desc.flags = cudaMemAccessFlagsProtReadWrite;
+        PADDLE_ENFORCE_GPU_SUCCESS(cudaMemPoolSetAccess(mem_pool_, &desc, 1));
+        VLOG(4) << "Enable peer access of GPU " << peer_id
+                << " to the memory pool of GPU " << dev_id;
+      }
+    }
+    VLOG(4) << "Init stream-ordered memory pool of GPU " << dev_id
+            << " with release threshold " << threshold;
+  }
+}
+
+phi::Allocation* CUDAMallocAsyncAllocator::AllocateImpl(size_t size) {
+  platform::CUDADeviceGuard guard(place_.GetDeviceId());
+  void* ptr = nullptr;
+  auto result = cudaMallocAsync(&ptr, size, default_stream_);
+  if (UNLIKELY(result == cudaErrorMemoryAllocation &&
+               !phi::backends::gpu::CUDAGraph::IsThisThreadCapturing())) {
+    // release the cached blocks of all streams and retry
+    (void)cudaGetLastError();
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaDeviceSynchronize());
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemPoolTrimTo(mem_pool_, 0));
+    result = cudaMallocAsync(&ptr, size, default_stream_);
+  }
+  if (LIKELY(result == cudaSuccess)) {
+    return new CUDAMallocAsyncAllocation(
+        ptr, size, platform::Place(place_), default_stream_);
+  }
+  (void)cudaGetLastError();
+
+  size_t avail = 0, total = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemGetInfo(&avail, &total));
+  PADDLE_THROW_BAD_ALLOC(platform::errors::ResourceExhausted(
+      "\n\nOut of memory error on GPU %d. "
+      "Cannot allocate %s memory on GPU %d from the stream-ordered memory "
+      "pool, available memory is only %s.\n\n"
+      "Please check whether there is any other process using GPU %d.\n"
+      "1. If yes, please stop them, or start PaddlePaddle on another GPU.\n"
+      "2. If no, please decrease the batch size of your model.\n",
+      place_.device,
+      string::HumanReadableSize(size),
+      place_.device,
+      string::HumanReadableSize(avail),
+      place_.device));
+}
+
+void CUDAMallocAsyncAllocator::FreeImpl(phi::Allocation* allocation) {
+  auto* async_allocation = static_cast<CUDAMallocAsyncAllocation*>(allocation);
+  platform::CUDADeviceGuard guard(place_.GetDeviceId());
+  async_allocation->SyncRecordedStreams();
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaFreeAsync(
+      async_allocation->ptr(), async_allocation->GetOwningStream()));
+  delete allocation;
+}
+
+uint64_t CUDAMallocAsyncAllocator::ReleaseImpl(const platform::Place& place) {
+  platform::CUDADeviceGuard guard(place_.GetDeviceId());
+  size_t reserved = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemPoolGetAttribute(
+      mem_pool_, cudaMemPoolAttrReservedMemCurrent, &reserved));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(default_stream_));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemPoolTrimTo(mem_pool_, 0));
+  size_t reserved_after = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemPoolGetAttribute(
+      mem_pool_, cudaMemPoolAttrReservedMemCurrent, &reserved_after));
+  return reserved > reserved_after ? reserved - reserved_after : 0;
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,83 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <set>
+
+#include "paddle/fluid/memory/allocation/allocator.h"
+#include "paddle/fluid/memory/allocation/spin_lock.h"
+#include "paddle/fluid/platform/place.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// CUDAMallocAsyncAllocation is freed by cudaFreeAsync on its owning stream.
+// Other streams that use it are recorded, and the owning stream waits for them
+// before the free is enqueued, so no event query is needed on the host.
+class CUDAMallocAsyncAllocation : public Allocation {
+ public:
+  CUDAMallocAsyncAllocation(void* ptr,
+                            size_t size,
+                            platform::Place place,
+                            gpuStream_t owning_stream)
+      : Allocation(ptr, size, place), owning_stream_(owning_stream) {}
+
+  void RecordStream(gpuStream_t stream);
+  void EraseStream(gpuStream_t stream);
+  gpuStream_t GetOwningStream() const { return owning_stream_; }
+
+  // Make the owning stream wait for all the recorded streams
+  void SyncRecordedStreams();
+
+ private:
+  gpuStream_t owning_stream_;
+  std::set<gpuStream_t> recorded_streams_;
+  SpinLock recorded_streams_lock_;
+};
+
+// CUDAMallocAsyncAllocator allocates from the stream-ordered memory pool of the
+// device (cudaMallocAsync/cudaFreeAsync, requires CUDA 11.2). The driver keeps
+// freed blocks in the pool and reuses them on the same stream without any
+// synchronization, and the pool is shared by all the streams of the device.
+class CUDAMallocAsyncAllocator : public Allocator {
+ public:
+  CUDAMallocAsyncAllocator(const platform::CUDAPlace& place,
+                           gpuStream_t default_stream);
+
+  bool IsAllocThreadSafe() const override { return true; }
+  gpuStream_t GetDefaultStream() const { return default_stream_; }
+  void SetDefaultStream(gpuStream_t stream) { default_stream_ = stream; }
+
+ protected:
+  phi::Allocation* AllocateImpl(size_t size) override;
+  void FreeImpl(phi::Allocation* allocation) override;
+  uint64_t ReleaseImpl(const platform::Place& place) override;
+
+ private:
+  // Set the release threshold and peer access of the device pool, only done
+  // once per device
+  void InitMemPool();
+
+  platform::CUDAPlace place_;
+  gpuStream_t default_stream_;
+  cudaMemPool_t mem_pool_{nullptr};
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -17,7 +17,10 @@
 #include <cuda_runtime.h>
 #endif
 
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "paddle/fluid/memory/allocation/cuda_virtual_mem_allocator.h"
 #include "paddle/fluid/platform/enforce.h"
@@ -33,23 +36,24 @@ namespace paddle {
 namespace memory {
 namespace allocation {
 
-CUDAVirtualMemAllocator::CUDAVirtualMemAllocator(
-    const platform::CUDAPlace& place)
-    : place_(place) {
-  CUmemAllocationProp prop = {};
+namespace {
 
-  // Setup the properties common for all the chunks
-  // The allocations will be device pinned memory.
-  // This property structure describes the physical location where the memory
-  // will be allocated via cuMemCreate allong with additional properties In this
-  // case, the allocation will be pinnded device memory local to a given device.
+// The allocations will be device pinned memory.
+// This property structure describes the physical location where the memory
+// will be allocated via cuMemCreate allong with additional properties In this
+// case, the allocation will be pinnded device memory local to a given device.
+CUmemAllocationProp GetAllocationProp(const platform::CUDAPlace& place) {
+  CUmemAllocationProp prop = {};
   prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
   prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
   prop.location.id = place.device;  // NOLINT
-  prop_ = prop;
+  return prop;
+}
 
-  // Prepare the access descriptor array indicating where and how the backings
-  // should be visible.
+// Prepare the access descriptor array indicating where and how the backings
+// should be visible.
+std::vector<CUmemAccessDesc> GetAccessDescs(const platform::CUDAPlace& place) {
+  std::vector<CUmemAccessDesc> access_descs;
   for (int dev_id = 0; dev_id < platform::GetGPUDeviceCount(); ++dev_id) {
     if (place.device != dev_id) {
       int capable = 0;
@@ -68,20 +72,35 @@ CUDAVirtualMemAllocator::CUDAVirtualMemAllocator(
 
     // Specify both read and write access.
     access_desc.flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
-    access_desc_.push_back(access_desc);
+    access_descs.push_back(access_desc);
   }
+  return access_descs;
+}
 
-  // Get the minimum granularity needed for all devices
-  // (the max of the minimum granularity of each participating device)
-  granularity_ = 0;
+// Get the minimum granularity needed for all devices
+// (the max of the minimum granularity of each participating device)
+size_t GetGranularity(CUmemAllocationProp prop) {
+  size_t max_granularity = 0;
   for (int dev_id = 0; dev_id < platform::GetGPUDeviceCount(); ++dev_id) {
     size_t granularity;
     prop.location.id = dev_id;
     PADDLE_ENFORCE_GPU_SUCCESS(
         paddle::platform::dynload::cuMemGetAllocationGranularity(
             &granularity, &prop, CU_MEM_ALLOC_GRANULARITY_MINIMUM));
-    granularity_ = std::max(granularity, granularity_);
+    max_granularity = std::max(granularity, max_granularity);
   }
+  return max_granularity;
+}
+
+}  // namespace
+
+CUDAVirtualMemAllocator::CUDAVirtualMemAllocator(
+    const platform::CUDAPlace& place)
+    : place_(place) {
+  // Setup the properties common for all the chunks
+  prop_ = GetAllocationProp(place);
+  access_desc_ = GetAccessDescs(place);
+  granularity_ = GetGranularity(prop_);
 
   size_t actual_avail, actual_total;
   paddle::platform::CUDADeviceGuard guard(place.device);
@@ -228,6 +247,140 @@ phi::Allocation* CUDAVirtualMemAllocator::AllocateImpl(size_t size) {
       reinterpret_cast<void*>(ptr), size, platform::Place(place_));
 }
 
+std::unique_ptr<CUDAGrowableAllocation> CUDAGrowableAllocation::Create(
+    const platform::CUDAPlace& place, size_t size, size_t max_size) {
+  PADDLE_ENFORCE_LE(
+      size,
+      max_size,
+      platform::errors::InvalidArgument(
+          "The initial size (%d) of a growable allocation should not be "
+          "greater than its max size (%d).",
+          size,
+          max_size));
+  auto prop = GetAllocationProp(place);
+  auto access_desc = GetAccessDescs(place);
+  size_t granularity = GetGranularity(prop);
+  size_t virtual_mem_size =
+      AlignedSize(std::max<size_t>(max_size, 1), granularity);
+
+  paddle::platform::CUDADeviceGuard guard(place.device);
+  CUdeviceptr virtual_mem_base;
+  PADDLE_ENFORCE_GPU_SUCCESS(paddle::platform::dynload::cuMemAddressReserve(
+      &virtual_mem_base, virtual_mem_size, 0, 0, 0));
+
+  std::unique_ptr<CUDAGrowableAllocation> allocation(
+      new CUDAGrowableAllocation(place,
+                                 virtual_mem_base,
+                                 virtual_mem_size,
+                                 granularity,
+                                 prop,
+                                 std::move(access_desc)));
+  allocation->Extend(size);
+  return allocation;
+}
+
+CUDAGrowableAllocation::CUDAGrowableAllocation(
+    const platform::CUDAPlace& place,
+    CUdeviceptr virtual_mem_base,
+    size_t virtual_mem_size,
+    size_t granularity,
+    const CUmemAllocationProp& prop,
+    std::vector<CUmemAccessDesc> access_desc)
+    : Allocation(reinterpret_cast<void*>(virtual_mem_base),
+                 0,
+                 platform::Place(place)),
+      device_place_(place),
+      virtual_mem_base_(virtual_mem_base),
+      virtual_mem_size_(virtual_mem_size),
+      granularity_(granularity),
+      prop_(prop),
+      access_desc_(std::move(access_desc)) {}
+
+CUDAGrowableAllocation::~CUDAGrowableAllocation() {
+  paddle::platform::CUDADeviceGuard guard(device_place_.device);
+  // The cuda driver may be deinitialized when the process exits, then the
+  // memory has been released by the driver.
+  auto result = CUDA_SUCCESS;
+  if (size_ > 0) {
+    result = paddle::platform::dynload::cuMemUnmap(virtual_mem_base_, size_);
+  }
+  if (result == CUDA_ERROR_DEINITIALIZED) {
+    return;
+  }
+  // A destructor should not throw, so the failures are only logged.
+  if (result != CUDA_SUCCESS) {
+    LOG(WARNING) << "Failed to unmap a growable allocation on GPU "
+                 << device_place_.device << ", error " << result;
+  }
+  for (auto& chunk : chunks_) {
+    result = platform::RecordedGpuMemRelease(
+        chunk.first, chunk.second, device_place_.device);
+    if (result != CUDA_SUCCESS) {
+      LOG(WARNING) << "Failed to release a chunk of a growable allocation on "
+                   << "GPU " << device_place_.device << ", error " << result;
+    }
+  }
+  result = paddle::platform::dynload::cuMemAddressFree(virtual_mem_base_,
+                                                       virtual_mem_size_);
+  if (result != CUDA_SUCCESS) {
+    LOG(WARNING) << "Failed to free the address range of a growable "
+                 << "allocation on GPU " << device_place_.device << ", error "
+                 << result;
+  }
+}
+
+bool CUDAGrowableAllocation::Extend(size_t size) {
+  if (size <= size_) {
+    return true;
+  }
+  if (size > virtual_mem_size_) {
+    return false;
+  }
+
+  size_t chunk_size = AlignedSize(size - size_, granularity_);
+  CUdeviceptr ptr = virtual_mem_base_ + size_;
+  CUmemGenericAllocationHandle handle;
+
+  paddle::platform::CUDADeviceGuard guard(device_place_.device);
+
+  // Create physical memory backing the extended part.
+  auto result = platform::RecordedGpuMemCreate(
+      &handle, chunk_size, &prop_, 0, device_place_.device);
+  if (result == CUDA_ERROR_OUT_OF_MEMORY) {
+    size_t actual_avail, actual_total;
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemGetInfo(&actual_avail, &actual_total));
+    PADDLE_THROW_BAD_ALLOC(platform::errors::ResourceExhausted(
+        "\n\nOut of memory error on GPU %d. "
+        "Cannot extend a growable allocation by %s memory on GPU %d, "
+        "available memory is only %s.\n\n",
+        device_place_.device,
+        string::HumanReadableSize(chunk_size),
+        device_place_.device,
+        string::HumanReadableSize(actual_avail)));
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(result);
+
+  // Map the chunk right after the mapped range, so that the range grows and
+  // its address is kept.
+  result = paddle::platform::dynload::cuMemMap(ptr, chunk_size, 0, handle, 0);
+  if (result != CUDA_SUCCESS) {
+    platform::RecordedGpuMemRelease(handle, chunk_size, device_place_.device);
+    PADDLE_ENFORCE_GPU_SUCCESS(result);
+  }
+
+  result = paddle::platform::dynload::cuMemSetAccess(
+      ptr, chunk_size, access_desc_.data(), access_desc_.size());
+  if (result != CUDA_SUCCESS) {
+    paddle::platform::dynload::cuMemUnmap(ptr, chunk_size);
+    platform::RecordedGpuMemRelease(handle, chunk_size, device_place_.device);
+    PADDLE_ENFORCE_GPU_SUCCESS(result);
+  }
+
+  chunks_.emplace_back(handle, chunk_size);
+  size_ += chunk_size;
+  return true;
+}
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
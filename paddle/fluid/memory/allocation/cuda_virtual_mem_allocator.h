@@ -20,7 +20,9 @@
 #include "paddle/fluid/platform/cuda_device_guard.h"
 #endif
 
+#include <memory>
 #include <mutex>  // NOLINT
+#include <vector>
 
 #include "paddle/fluid/memory/allocation/allocator.h"
 #include "paddle/fluid/platform/place.h"
@@ -57,6 +59,42 @@ class CUDAVirtualMemAllocator : public Allocator {
       virtual_2_physical_map_;
 };
 
+// An allocation which reserves the virtual address space of max_size at
+// first, and maps the physical memory only when it is extended, so that a
+// growing tensor keeps its address and content without any copy. It is not
+// thread safe.
+class CUDAGrowableAllocation : public Allocation {
+ public:
+  static std::unique_ptr<CUDAGrowableAllocation> Create(
+      const platform::CUDAPlace& place, size_t size, size_t max_size);
+
+  ~CUDAGrowableAllocation() override;
+
+  bool Extend(size_t size) override;
+
+  size_t max_size() const { return virtual_mem_size_; }
+
+ private:
+  CUDAGrowableAllocation(const platform::CUDAPlace& place,
+                         CUdeviceptr virtual_mem_base,
+                         size_t virtual_mem_size,
+                         size_t granularity,
+                         const CUmemAllocationProp& prop,
+                         std::vector<CUmemAccessDesc> access_desc);
+
+  platform::CUDAPlace device_place_;
+
+  CUdeviceptr virtual_mem_base_;
+  size_t virtual_mem_size_;
+  size_t granularity_;
+
+  CUmemAllocationProp prop_;
+  std::vector<CUmemAccessDesc> access_desc_;
+
+  // the physical chunks mapped one after another from virtual_mem_base_
+  std::vector<std::pair<CUmemGenericAllocationHandle, size_t>> chunks_;
+};
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
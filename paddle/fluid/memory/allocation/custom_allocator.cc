@@ -30,8 +30,14 @@ void CustomAllocator::FreeImpl(phi::Allocation* allocation) {
                                          "freed in incorrect device. "
                                          "This may be a bug"));
   if (phi::DeviceManager::HasDeviceType(place_.GetDeviceType())) {
-    phi::DeviceManager::GetDeviceWithPlace(place_)->MemoryDeallocate(
-        allocation->ptr(), allocation->size());
+    auto* device = phi::DeviceManager::GetDeviceWithPlace(place_);
+    if (device->IsStreamOrderedAllocatorSupported()) {
+      phi::stream::Stream stream(place_, stream_);
+      device->MemoryDeallocateAsync(
+          allocation->ptr(), allocation->size(), &stream);
+    } else {
+      device->MemoryDeallocate(allocation->ptr(), allocation->size());
+    }
   }
   delete allocation;
 }
@@ -39,8 +45,14 @@ void CustomAllocator::FreeImpl(phi::Allocation* allocation) {
 phi::Allocation* CustomAllocator::AllocateImpl(size_t size) {
   std::call_once(once_flag_, [this] { phi::DeviceManager::SetDevice(place_); });
 
-  void* ptr =
-      phi::DeviceManager::GetDeviceWithPlace(place_)->MemoryAllocate(size);
+  auto* device = phi::DeviceManager::GetDeviceWithPlace(place_);
+  void* ptr = nullptr;
+  if (device->IsStreamOrderedAllocatorSupported()) {
+    phi::stream::Stream stream(place_, stream_);
+    ptr = device->MemoryAllocateAsync(size, &stream);
+  } else {
+    ptr = device->MemoryAllocate(size);
+  }
   if (LIKELY(ptr)) {
     return new Allocation(ptr, size, place_);
   }
@@ -17,15 +17,20 @@
 
 #include "paddle/fluid/memory/allocation/allocator.h"
 #include "paddle/fluid/platform/place.h"
+#include "paddle/phi/backends/stream.h"
 
 namespace paddle {
 namespace memory {
 namespace allocation {
 
+// Allocates the device memory of a custom device. If the plugin allocates in
+// stream order, the memory is allocated and freed on stream, which is the
+// default stream of the device when it is null.
 class CustomAllocator : public Allocator {
  public:
-  explicit CustomAllocator(const platform::CustomPlace& place)
-      : place_(place) {}
+  explicit CustomAllocator(const platform::CustomPlace& place,
+                           phi::stream::stream_t stream = nullptr)
+      : place_(place), stream_(stream) {}
 
   bool IsAllocThreadSafe() const override;
 
@@ -35,6 +40,7 @@ class CustomAllocator : public Allocator {
 
  private:
   platform::Place place_;
+  phi::stream::stream_t stream_;
   std::once_flag once_flag_;
 };
 
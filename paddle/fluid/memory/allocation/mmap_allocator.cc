@@ -18,17 +18,26 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <cstdlib>
 
+#include <algorithm>
 #include <atomic>
 #include <random>
 #include <string>
+#include <unordered_map>
+
+#ifdef PADDLE_WITH_CUDA
+#include <cuda_runtime.h>
+#endif
 
 #include "glog/logging.h"
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/phi/core/flags.h"
 
 PHI_DECLARE_bool(use_shm_cache);
+PHI_DECLARE_int64(shm_arena_size_mb);
+PHI_DECLARE_bool(shm_arena_pin_memory);
 
 namespace paddle {
 namespace memory {
@@ -120,6 +129,9 @@ AllocateRefcountedMemoryMapAllocation(std::string filename,
                                       int flags,
                                       size_t size,
                                       int buffer_id) {
+  if (buffer_id == -1 && filename.find('@') != std::string::npos) {
+    return RebuildMemoryMapArenaAllocation(filename, flags, size);
+  }
   int fd = -1;
   void *base_ptr = nullptr;
   if (buffer_id == -1) {
@@ -220,6 +232,218 @@ void RefcountedMemoryMapAllocation::close() {
   }
 }
 
+MemoryMapArenaAllocation::MemoryMapArenaAllocation(
+    void *ptr,
+    size_t size,
+    std::string ipc_name,
+    int flags,
+    std::shared_ptr<void> arena_mapping)
+    : RefcountedMemoryMapAllocation(ptr, size, ipc_name, flags, -1),
+      arena_mapping_(std::move(arena_mapping)) {}
+
+void MemoryMapArenaAllocation::close() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  CountInfo *info = reinterpret_cast<CountInfo *>(map_ptr_);
+  --info->refcount;
+  arena_mapping_.reset();
+}
+
+namespace {
+
+struct ArenaMapping {
+  std::shared_ptr<void> mapping;
+  size_t size;
+};
+
+std::mutex arena_mappings_mtx;
+// the arenas mapped by this process, keyed by the ipc name of the arena
+std::unordered_map<std::string, ArenaMapping> arena_mappings;
+
+std::shared_ptr<void> MakeArenaMapping(const std::string &ipc_name,
+                                       void *ptr,
+                                       size_t size,
+                                       bool pinned) {
+  return std::shared_ptr<void>(ptr, [ipc_name, size, pinned](void *ptr) {
+#ifdef PADDLE_WITH_CUDA
+    if (pinned) {
+      cudaHostUnregister(ptr);
+    }
+#endif
+    if (munmap(ptr, size) == -1) {
+      LOG(WARNING) << "could not unmap the shm arena " << ipc_name << ": "
+                   << strerror(errno);
+    }
+    VLOG(4) << "Unmap a shm arena: " << ipc_name;
+  });
+}
+
+// Unmap the arenas without alive slots whose producer has unlinked them.
+void ReleaseUnlinkedArenaMappings() {
+  for (auto it = arena_mappings.begin(); it != arena_mappings.end();) {
+    if (it->second.mapping.use_count() == 1) {
+      int fd = shm_open(it->first.c_str(), O_RDONLY, 0600);
+      if (fd == -1 && errno == ENOENT) {
+        it = arena_mappings.erase(it);
+        continue;
+      }
+      if (fd != -1) {
+        ::close(fd);
+      }
+    }
+    ++it;
+  }
+}
+
+ArenaMapping MapArena(const std::string &ipc_name) {
+  std::lock_guard<std::mutex> guard(arena_mappings_mtx);
+  auto it = arena_mappings.find(ipc_name);
+  if (it != arena_mappings.end()) {
+    return it->second;
+  }
+  ReleaseUnlinkedArenaMappings();
+
+  int fd = shm_open(ipc_name.c_str(), O_RDWR, 0600);
+  PADDLE_ENFORCE_NE(fd,
+                    -1,
+                    platform::errors::Unavailable(
+                        "File descriptor %s open failed", ipc_name.c_str()));
+  struct stat file_stat;
+  PADDLE_ENFORCE_EQ(fstat(fd, &file_stat),
+                    0,
+                    platform::errors::Unavailable(
+                        "Get the size of shm arena %s failed", ipc_name));
+  size_t size = static_cast<size_t>(file_stat.st_size);
+  void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  PADDLE_ENFORCE_NE(ptr,
+                    MAP_FAILED,
+                    platform::errors::Unavailable(
+                        "Memory map failed when rebuild shm arena %s.",
+                        ipc_name));
+  bool pinned = false;
+#ifdef PADDLE_WITH_CUDA
+  if (FLAGS_shm_arena_pin_memory) {
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaHostRegister(ptr, size, cudaHostRegisterDefault));
+    pinned = true;
+  }
+#endif
+  VLOG(4) << "Map a shm arena: " << ipc_name << ", size: " << size;
+  ArenaMapping arena{MakeArenaMapping(ipc_name, ptr, size, pinned), size};
+  arena_mappings.emplace(ipc_name, arena);
+  return arena;
+}
+
+}  // namespace
+
+MemoryMapArena *MemoryMapArena::Instance() {
+  static std::mutex mtx;
+  static MemoryMapArena *arena = nullptr;
+  static pid_t pid = -1;
+  if (FLAGS_shm_arena_size_mb <= 0) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> guard(mtx);
+  // A forked DataLoader worker should not share the arena of its parent.
+  if (arena == nullptr || pid != getpid()) {
+    arena = new MemoryMapArena(static_cast<size_t>(FLAGS_shm_arena_size_mb)
+                               << 20);
+    pid = getpid();
+  }
+  return arena;
+}
+
+MemoryMapArena::MemoryMapArena(size_t size)
+    : ipc_name_(GetIPCName() + "_arena"), size_(size) {
+  void *ptr = nullptr;
+  int fd = -1;
+  AllocateMemoryMap(
+      ipc_name_, MAPPED_SHAREDMEM | MAPPED_EXCLUSIVE, size_, &ptr, &fd);
+  mapping_ = MakeArenaMapping(ipc_name_, ptr, size_, false);
+  std::lock_guard<std::mutex> guard(arena_mappings_mtx);
+  arena_mappings.emplace(ipc_name_, ArenaMapping{mapping_, size_});
+  VLOG(4) << "Create a shm arena: " << ipc_name_ << ", size: " << size_;
+}
+
+void MemoryMapArena::Reclaim() {
+  char *base_ptr = static_cast<char *>(mapping_.get());
+  while (!slots_.empty() &&
+         reinterpret_cast<CountInfo *>(base_ptr + slots_.front().first)
+                 ->refcount == 0) {
+    slots_.pop_front();
+  }
+  if (slots_.empty()) {
+    tail_ = 0;
+  }
+}
+
+std::shared_ptr<MemoryMapArenaAllocation> MemoryMapArena::Allocate(
+    size_t size) {
+  // the CountInfo of the slot takes mmap_alignment bytes before the data
+  size_t length =
+      mmap_alignment + (size + mmap_alignment - 1) / mmap_alignment *
+                           mmap_alignment;
+  std::lock_guard<std::mutex> guard(mtx_);
+  Reclaim();
+  size_t offset = tail_;
+  if (!slots_.empty()) {
+    size_t head = slots_.front().first;
+    if (tail_ > head) {
+      // [head, tail_) is alive, try [tail_, size_) and then [0, head)
+      if (tail_ + length > size_) {
+        offset = 0;
+        if (length > head) {
+          return nullptr;
+        }
+      }
+    } else if (tail_ + length > head) {
+      return nullptr;
+    }
+  }
+  if (offset + length > size_) {
+    return nullptr;
+  }
+  slots_.emplace_back(offset, length);
+  tail_ = offset + length;
+
+  void *ptr = static_cast<char *>(mapping_.get()) + offset + mmap_alignment;
+  VLOG(6) << "Allocate a slot of shm arena " << ipc_name_ << " at " << offset
+          << ", size: " << size;
+  return std::make_shared<MemoryMapArenaAllocation>(
+      ptr,
+      size,
+      ipc_name_ + "@" + std::to_string(offset),
+      MAPPED_SHAREDMEM | MAPPED_EXCLUSIVE,
+      mapping_);
+}
+
+std::shared_ptr<MemoryMapArenaAllocation> RebuildMemoryMapArenaAllocation(
+    const std::string &ipc_name, int flags, size_t size) {
+  size_t pos = ipc_name.rfind('@');
+  PADDLE_ENFORCE_NE(pos,
+                    std::string::npos,
+                    platform::errors::InvalidArgument(
+                        "%s is not the ipc name of a shm arena slot.",
+                        ipc_name));
+  size_t offset = std::stoull(ipc_name.substr(pos + 1));
+  ArenaMapping arena = MapArena(ipc_name.substr(0, pos));
+  PADDLE_ENFORCE_LE(offset + mmap_alignment + size,
+                    arena.size,
+                    platform::errors::InvalidArgument(
+                        "The slot %s of size %d is out of the shm arena of "
+                        "size %d.",
+                        ipc_name,
+                        size,
+                        arena.size));
+  void *ptr = static_cast<char *>(arena.mapping.get()) + offset +
+              mmap_alignment;
+  return std::make_shared<MemoryMapArenaAllocation>(
+      ptr, size, ipc_name, flags & ~MAPPED_EXCLUSIVE, arena.mapping);
+}
+
 MemoryMapWriterAllocation::~MemoryMapWriterAllocation() {
   if (munmap(this->ptr(), this->size()) == -1) {
     platform::errors::Unavailable("could not unmap the shared memory file %s",
@@ -298,6 +522,46 @@ std::shared_ptr<MemoryMapReaderAllocation> RebuildMemoryMapReaderAllocation(
   return std::make_shared<MemoryMapReaderAllocation>(ptr, size, ipc_name);
 }
 
+std::shared_ptr<void> MapFileCopyOnWrite(const std::string &path,
+                                         size_t *size) {
+  int fd = open(path.c_str(), O_RDONLY);
+  PADDLE_ENFORCE_NE(
+      fd,
+      -1,
+      platform::errors::Unavailable("Open file %s failed: %s.",
+                                    path,
+                                    strerror(errno)));
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    ::close(fd);
+    PADDLE_THROW(platform::errors::Unavailable(
+        "Get the status of file %s failed: %s.", path, strerror(errno)));
+  }
+  size_t file_size = static_cast<size_t>(file_stat.st_size);
+  void *ptr = mmap(nullptr,
+                   std::max<size_t>(file_size, 1),
+                   PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE,
+                   fd,
+                   0);
+  ::close(fd);
+  PADDLE_ENFORCE_NE(
+      ptr,
+      MAP_FAILED,
+      platform::errors::Unavailable(
+          "Memory map file %s failed: %s.", path, strerror(errno)));
+  std::shared_ptr<void> mapping(ptr, [path, file_size](void *data) {
+    if (munmap(data, std::max<size_t>(file_size, 1)) == -1) {
+      LOG(WARNING) << "could not unmap the file " << path << ": "
+                   << strerror(errno);
+    }
+    VLOG(4) << "Unmap file: " << path;
+  });
+  VLOG(4) << "Map file: " << path << ", size: " << file_size;
+  *size = file_size;
+  return mapping;
+}
+
 MemoryMapFdSet &MemoryMapFdSet::Instance() {  // NOLINT
   static MemoryMapFdSet set;
   return set;
@@ -17,11 +17,13 @@
 #ifndef _WIN32
 
 #include <atomic>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "paddle/fluid/memory/allocation/allocator.h"
 
@@ -96,6 +98,25 @@ class RefcountedMemoryMapAllocation : public MemoryMapAllocation {
 void AllocateMemoryMap(
     std::string filename, int flags, size_t size, void **base_ptr_, int *fd_);
 
+// A slot of a MemoryMapArena. Same as RefcountedMemoryMapAllocation, the
+// CountInfo of the slot is at mmap_alignment bytes before ptr, but close only
+// decreases the refcount and keeps the arena mapped. The arena holds the
+// mapping until all the slots on it are closed.
+class MemoryMapArenaAllocation : public RefcountedMemoryMapAllocation {
+ public:
+  MemoryMapArenaAllocation(void *ptr,
+                           size_t size,
+                           std::string ipc_name,
+                           int flags,
+                           std::shared_ptr<void> arena_mapping);
+
+  void close() override;
+  ~MemoryMapArenaAllocation() override { close(); }
+
+ private:
+  std::shared_ptr<void> arena_mapping_;
+};
+
 std::shared_ptr<RefcountedMemoryMapAllocation>
 AllocateRefcountedMemoryMapAllocation(std::string filename,
                                       int flags,
@@ -140,6 +161,27 @@ std::shared_ptr<MemoryMapWriterAllocation> AllocateMemoryMapWriterAllocation(
 std::shared_ptr<MemoryMapReaderAllocation> RebuildMemoryMapReaderAllocation(
     const std::string &ipc_name, size_t size);
 
+// A view on a file mapped by MapFileCopyOnWrite, e.g. the data of a param in
+// a params file of the mmap format. mapping keeps the file mapped.
+class MemoryMapFileAllocation : public Allocation {
+ public:
+  MemoryMapFileAllocation(void *ptr,
+                          size_t size,
+                          std::shared_ptr<void> mapping)
+      : Allocation(ptr, size, platform::CPUPlace()),
+        mapping_(std::move(mapping)) {}
+
+ private:
+  std::shared_ptr<void> mapping_;
+};
+
+// Map the file at path by MAP_PRIVATE, so that the clean pages of it are the
+// pages of the page cache shared by all the mappings of the file, and a write
+// only copies the pages written to the mapping writing them. size is set to
+// the size of the file.
+std::shared_ptr<void> MapFileCopyOnWrite(const std::string &path,
+                                         size_t *size);
+
 class MemoryMapFdSet {
  public:
   static MemoryMapFdSet &Instance();  // NOLINT
@@ -159,6 +201,47 @@ class MemoryMapFdSet {
   std::mutex mtx_;
 };
 
+/* MemoryMapArena is a shm file of FLAGS_shm_arena_size_mb pre-allocated by
+a process sharing tensors, e.g. a DataLoader worker. The shared tensors are
+placed in slots of the arena allocated as a ring, and the ipc name of a slot is
+"<arena name>@<offset>". The process rebuilding the tensors maps the whole
+arena once, so that neither side calls shm_open, mmap or munmap per tensor.
+
+A slot is alive until its refcount drops to 0, and the slots are reclaimed in
+the order they are allocated, which is the order the tensors are consumed from
+the DataLoader queue. Allocate returns nullptr if the free space of the ring is
+not enough, and the caller falls back to a shm file for the tensor.
+*/
+class MemoryMapArena {
+ public:
+  // nullptr if FLAGS_shm_arena_size_mb is 0
+  static MemoryMapArena *Instance();
+
+  explicit MemoryMapArena(size_t size);
+
+  std::shared_ptr<MemoryMapArenaAllocation> Allocate(size_t size);
+
+  inline const std::string &ipc_name() const { return ipc_name_; }
+
+  size_t size() const { return size_; }
+
+ private:
+  void Reclaim();
+
+  std::string ipc_name_;
+  std::shared_ptr<void> mapping_;
+  size_t size_ = 0;
+  // the next free offset, and the offset and length of the alive slots
+  size_t tail_ = 0;
+  std::deque<std::pair<size_t, size_t>> slots_;
+  std::mutex mtx_;
+};
+
+// Rebuild the slot of a MemoryMapArena from its ipc name, the arena is mapped
+// only for the first slot on it.
+std::shared_ptr<MemoryMapArenaAllocation> RebuildMemoryMapArenaAllocation(
+    const std::string &ipc_name, int flags, size_t size);
+
 class MemoryMapInfo {
  public:
   explicit MemoryMapInfo(int flags,
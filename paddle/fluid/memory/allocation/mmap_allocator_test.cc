@@ -16,6 +16,8 @@
 
 #include "paddle/fluid/memory/allocation/mmap_allocator.h"
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 namespace paddle {
@@ -46,6 +48,43 @@ TEST(MemoryMapAllocation, test_allocation_base) {
   }
 }
 
+TEST(MemoryMapArena, test_slot_reuse) {
+  const size_t data_size = 1024;
+  // 4 slots of the data and the CountInfo before it
+  MemoryMapArena arena(4 * (data_size + mmap_alignment));
+  std::vector<std::shared_ptr<MemoryMapArenaAllocation>> slots;
+  for (int i = 0; i < 4; ++i) {
+    slots.push_back(arena.Allocate(data_size));
+    ASSERT_NE(slots.back(), nullptr);
+  }
+  ASSERT_EQ(arena.Allocate(data_size), nullptr);
+
+  // rebuild the first slot from its ipc name
+  void *first_ptr = slots[0]->ptr();
+  static_cast<int32_t *>(first_ptr)[0] = 7;
+  auto rebuilt = AllocateRefcountedMemoryMapAllocation(
+      slots[0]->ipc_name(), MAPPED_SHAREDMEM | MAPPED_NOCREATE, data_size);
+  ASSERT_EQ(static_cast<int32_t *>(rebuilt->ptr())[0], 7);
+
+  // the slot is reused after all the holders are released
+  slots[0].reset();
+  ASSERT_EQ(arena.Allocate(data_size), nullptr);
+  rebuilt.reset();
+  slots[0] = arena.Allocate(data_size);
+  ASSERT_NE(slots[0], nullptr);
+  ASSERT_EQ(slots[0]->ptr(), first_ptr);
+
+  // the slots are reclaimed in the order they are allocated
+  slots[2].reset();
+  ASSERT_EQ(arena.Allocate(data_size), nullptr);
+  slots[1].reset();
+  slots[1] = arena.Allocate(data_size);
+  slots[2] = arena.Allocate(data_size);
+  ASSERT_NE(slots[1], nullptr);
+  ASSERT_NE(slots[2], nullptr);
+  ASSERT_EQ(arena.Allocate(data_size), nullptr);
+}
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
@@ -0,0 +1,81 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/nccl_mem_allocator.h"
+
+#ifdef PADDLE_WITH_NCCL_MEM_ALLOC
+#include "paddle/fluid/platform/cuda_device_guard.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/backends/dynload/nccl.h"
+#endif
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+#ifdef PADDLE_WITH_NCCL_MEM_ALLOC
+void NCCLMemAllocation::Register(ncclComm_t comm) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& handle : handles_) {
+    if (handle.first == comm) {
+      return;
+    }
+  }
+  void* handle = nullptr;
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::dynload::ncclCommRegister(comm, ptr(), size(), &handle));
+  handles_.emplace_back(comm, handle);
+}
+
+void NCCLMemAllocation::Deregister() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& handle : handles_) {
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        phi::dynload::ncclCommDeregister(handle.first, handle.second));
+  }
+  handles_.clear();
+}
+
+void NCCLMemAllocator::FreeImpl(phi::Allocation* allocation) {
+  PADDLE_ENFORCE_EQ(
+      allocation->place(),
+      place_,
+      platform::errors::PermissionDenied(
+          "GPU memory is freed in incorrect device. This may be a bug"));
+  auto* nccl_allocation = static_cast<NCCLMemAllocation*>(allocation);
+  nccl_allocation->Deregister();
+  platform::CUDADeviceGuard guard(place_.device);
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::ncclMemFree(allocation->ptr()));
+  delete nccl_allocation;
+}
+
+phi::Allocation* NCCLMemAllocator::AllocateImpl(size_t size) {
+  platform::CUDADeviceGuard guard(place_.device);
+  void* ptr = nullptr;
+  auto result = phi::dynload::ncclMemAlloc(&ptr, size);
+  if (LIKELY(result == ncclSuccess)) {
+    return new NCCLMemAllocation(ptr, size, platform::Place(place_));
+  }
+  PADDLE_THROW_BAD_ALLOC(platform::errors::ResourceExhausted(
+      "\n\nOut of memory error on GPU %d. Cannot allocate %s memory of the "
+      "collectives by ncclMemAlloc, which returns %s.\n",
+      place_.device,
+      string::HumanReadableSize(size),
+      phi::dynload::ncclGetErrorString(result)));
+}
+#endif
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
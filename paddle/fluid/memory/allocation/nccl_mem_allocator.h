@@ -0,0 +1,76 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#ifdef PADDLE_WITH_NCCL
+#include <nccl.h>
+#endif
+
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "paddle/fluid/memory/allocation/allocator.h"
+#include "paddle/fluid/platform/place.h"
+
+#if defined(PADDLE_WITH_NCCL) && NCCL_VERSION_CODE >= 21900
+#define PADDLE_WITH_NCCL_MEM_ALLOC
+#endif
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+#ifdef PADDLE_WITH_NCCL_MEM_ALLOC
+// An allocation of ncclMemAlloc, which may be registered to the nccl
+// communicators, so that the collectives on it take the zero copy
+// algorithms, e.g. NVLS. It is deregistered from them when freed, so a
+// communicator must outlive the allocations registered to it.
+class NCCLMemAllocation : public Allocation {
+ public:
+  NCCLMemAllocation(void* ptr, size_t size, const platform::Place& place)
+      : Allocation(ptr, size, place) {}
+
+  // Registers the allocation to comm unless it is registered.
+  void Register(ncclComm_t comm);
+
+  void Deregister();
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::pair<ncclComm_t, void*>> handles_;
+};
+
+// Allocates the buffers of the collectives by ncclMemAlloc, which meets the
+// alignment and the granularity of the buffer registration.
+class NCCLMemAllocator : public Allocator {
+ public:
+  explicit NCCLMemAllocator(const platform::CUDAPlace& place)
+      : place_(place) {}
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+ protected:
+  void FreeImpl(phi::Allocation* allocation) override;
+  phi::Allocation* AllocateImpl(size_t size) override;
+
+ private:
+  platform::CUDAPlace place_;
+};
+#endif
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -49,6 +49,77 @@ phi::Allocation *CPUPinnedAllocator::AllocateImpl(size_t size) {
                            platform::TracerMemEventType::ReservedAllocate);
   return new Allocation(ptr, size, platform::CUDAPinnedPlace());
 }
+
+// the smallest and the largest size classes of the staging buffers
+constexpr size_t kMinSizeClass = 4 << 10;
+constexpr size_t kMaxSizeClass = 64 << 20;
+constexpr size_t kMaxCachedStagingBytes = 256 << 20;
+
+SizeClassPinnedAllocator::SizeClassPinnedAllocator(
+    std::shared_ptr<Allocator> underlying_allocator, size_t max_cached_bytes)
+    : underlying_allocator_(std::move(underlying_allocator)),
+      max_cached_bytes_(max_cached_bytes) {
+  PADDLE_ENFORCE_NOT_NULL(
+      underlying_allocator_,
+      platform::errors::InvalidArgument(
+          "Underlying allocator of SizeClassPinnedAllocator is NULL"));
+}
+
+SizeClassPinnedAllocator::~SizeClassPinnedAllocator() {
+  std::lock_guard<std::mutex> guard(mtx_);
+  free_lists_.clear();
+}
+
+size_t SizeClassPinnedAllocator::SizeClass(size_t size) {
+  if (size > kMaxSizeClass) {
+    return size;
+  }
+  size_t size_class = kMinSizeClass;
+  while (size_class < size) {
+    size_class <<= 1;
+  }
+  return size_class;
+}
+
+std::shared_ptr<SizeClassPinnedAllocator>
+SizeClassPinnedAllocator::StagingPool() {
+  // leaked on purpose, since the pinned buffers can not be freed after the
+  // runtime is unloaded at exit
+  static auto *pool = new std::shared_ptr<SizeClassPinnedAllocator>(
+      std::make_shared<SizeClassPinnedAllocator>(
+          std::make_shared<CPUPinnedAllocator>(), kMaxCachedStagingBytes));
+  return *pool;
+}
+
+void SizeClassPinnedAllocator::FreeImpl(phi::Allocation *allocation) {
+  AllocationPtr holder(allocation, Allocator::AllocationDeleter);
+  const size_t size = allocation->size();
+  if (size > kMaxSizeClass) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mtx_);
+  if (cached_bytes_ + size > max_cached_bytes_) {
+    return;
+  }
+  cached_bytes_ += size;
+  free_lists_[size].emplace_back(std::move(holder));
+}
+
+phi::Allocation *SizeClassPinnedAllocator::AllocateImpl(size_t size) {
+  const size_t size_class = SizeClass(size);
+  {
+    std::lock_guard<std::mutex> guard(mtx_);
+    auto it = free_lists_.find(size_class);
+    if (it != free_lists_.end() && !it->second.empty()) {
+      AllocationPtr result(std::move(it->second.back()));
+      it->second.pop_back();
+      cached_bytes_ -= size_class;
+      return result.release();
+    }
+  }
+  return underlying_allocator_->Allocate(size_class).release();
+}
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
@@ -13,6 +13,11 @@
 // limitations under the License.
 
 #pragma once
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include "paddle/fluid/memory/allocation/allocator.h"
 
 namespace paddle {
@@ -29,6 +34,40 @@ class CPUPinnedAllocator : public Allocator {
   phi::Allocation *AllocateImpl(size_t size) override;
 };
 
+// Allocator caching the pinned buffers in power-of-two size classes, which
+// serves the staging buffers of the copies between the host and the devices
+// without calling `cudaHostAlloc`, which may synchronize the device, in every
+// copy. The freed buffers are kept in the free lists of their classes up to
+// max_cached_bytes in total, and the ones larger than the largest class are
+// not cached.
+class SizeClassPinnedAllocator : public Allocator {
+ public:
+  SizeClassPinnedAllocator(std::shared_ptr<Allocator> underlying_allocator,
+                           size_t max_cached_bytes);
+
+  ~SizeClassPinnedAllocator() override;
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  // The size of the class serving size, or size itself if it is larger than
+  // the largest class.
+  static size_t SizeClass(size_t size);
+
+  // The pool of the staging buffers shared by the process.
+  static std::shared_ptr<SizeClassPinnedAllocator> StagingPool();
+
+ protected:
+  void FreeImpl(phi::Allocation *allocation) override;
+  phi::Allocation *AllocateImpl(size_t size) override;
+
+ private:
+  std::shared_ptr<Allocator> underlying_allocator_;
+  size_t max_cached_bytes_;
+  size_t cached_bytes_{0};
+  std::mutex mtx_;
+  std::map<size_t, std::vector<AllocationPtr>> free_lists_;
+};
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
@@ -46,9 +46,8 @@ void StreamSafeCustomDeviceAllocation::RecordStream(
   auto it = outstanding_event_map_.find(stream);
   if (it == outstanding_event_map_.end()) {
     outstanding_event_map_.insert(
-        {stream, std::make_shared<phi::event::Event>()});
-    outstanding_event_map_[stream]->Init(place());
-    VLOG(9) << "Create a new event "
+        {stream, phi::DeviceManager::GetPooledEvent(place())});
+    VLOG(9) << "Get a pooled event "
             << outstanding_event_map_[stream]->raw_event();
     auto stream_wrapper = phi::stream::Stream(place(), stream);
     VLOG(8) << "Record event " << outstanding_event_map_[stream]->raw_event()
@@ -60,7 +59,7 @@ void StreamSafeCustomDeviceAllocation::RecordStream(
 void StreamSafeCustomDeviceAllocation::MarkAsWillBeFreed() {
   std::lock_guard<SpinLock> lock_guard(outstanding_event_map_lock_);
   if (!will_be_freed_) {
-    will_be_freed_ = false;
+    will_be_freed_ = true;
     VLOG(8) << "ptr: " << ptr() << " will be freed";
     if (phi::DeviceManager::HasDeviceType(place_.GetDeviceType()) &&
         outstanding_event_map_.find(owning_stream_) ==
@@ -68,9 +67,8 @@ void StreamSafeCustomDeviceAllocation::MarkAsWillBeFreed() {
       std::call_once(once_flag_,
                      [this] { phi::DeviceManager::SetDevice(place_); });
       outstanding_event_map_.insert(
-          {owning_stream_, std::make_shared<phi::event::Event>()});
-      outstanding_event_map_[owning_stream_]->Init(place_);
-      VLOG(9) << "Create a new event "
+          {owning_stream_, phi::DeviceManager::GetPooledEvent(place_)});
+      VLOG(9) << "Get a pooled event "
               << outstanding_event_map_[owning_stream_]->raw_event();
       auto stream_wrapper = phi::stream::Stream(place_, owning_stream_);
       VLOG(8) << "Record event "
@@ -95,8 +93,7 @@ bool StreamSafeCustomDeviceAllocation::CanBeFreed() {
               << " is not completed";
       return false;
     }
-    VLOG(8) << "Destroy event " << event->raw_event();
-    event->Destroy();
+    VLOG(8) << "Recycle event " << event->raw_event();
     it = outstanding_event_map_.erase(it);
   }
   outstanding_event_map_.clear();
@@ -119,7 +116,9 @@ StreamSafeCustomDeviceAllocator::StreamSafeCustomDeviceAllocator(
     phi::stream::stream_t default_stream)
     : underlying_allocator_(std::move(underlying_allocator)),
       place_(std::move(place)),
-      default_stream_(std::move(default_stream)) {
+      default_stream_(std::move(default_stream)),
+      stream_ordered_(phi::DeviceManager::IsStreamOrderedAllocatorSupported(
+          place_)) {
   std::lock_guard<SpinLock> lock_guard(allocator_map_lock_);
   allocator_map_[place_].emplace_back(this);
 }
@@ -190,7 +189,13 @@ void StreamSafeCustomDeviceAllocator::FreeImpl(phi::Allocation* allocation) {
                               phi::DeviceContextPool::Instance().Get(place_))
                               ->stream());
   }
-  stream_safe_cuda_allocation->MarkAsWillBeFreed();
+  // The memory used only on the stream of this allocator is reused in the
+  // order of the stream if the device allocates in stream order, as on gpu,
+  // so it is freed without an event.
+  if (!stream_ordered_ || default_stream_ == nullptr ||
+      stream_safe_cuda_allocation->GetOwningStream() != default_stream_) {
+    stream_safe_cuda_allocation->MarkAsWillBeFreed();
+  }
   if (stream_safe_cuda_allocation->CanBeFreed()) {
     VLOG(9) << "Directly delete allocation";
     delete stream_safe_cuda_allocation;
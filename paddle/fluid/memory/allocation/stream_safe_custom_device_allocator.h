@@ -83,6 +83,8 @@ class StreamSafeCustomDeviceAllocator
   std::shared_ptr<Allocator> underlying_allocator_;
   platform::CustomPlace place_;
   phi::stream::stream_t default_stream_;
+  // whether the device allocates and frees memory in stream order
+  bool stream_ordered_;
   std::list<StreamSafeCustomDeviceAllocation *> unfreed_allocations_;
   SpinLock unfreed_allocation_lock_;
 };
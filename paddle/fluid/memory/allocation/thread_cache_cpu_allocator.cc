@@ -0,0 +1,553 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/thread_cache_cpu_allocator.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "paddle/fluid/memory/allocation/cpu_allocator.h"
+#include "paddle/fluid/memory/stats.h"
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+namespace {
+
+constexpr size_t kSpanSize = 2 << 20;
+constexpr size_t kMaxThreadCacheBytes = 4 << 20;
+constexpr size_t kBatchBytes = 64 << 10;
+
+// SpanHeader is placed at the beginning of every span, so that the span (and
+// its arena) of an object can be found by masking the object address.
+struct SpanHeader {
+  uint32_t arena;
+  uint32_t size_class;
+  size_t carved;  // number of objects carved from the span so far
+};
+
+static_assert(sizeof(SpanHeader) <= ThreadCacheCPUAllocator::kAlignment,
+              "SpanHeader should fit in the first kAlignment bytes of a span");
+
+inline SpanHeader* SpanOf(void* ptr) {
+  return reinterpret_cast<SpanHeader*>(reinterpret_cast<uintptr_t>(ptr) &
+                                       ~(kSpanSize - 1));
+}
+
+// Number of objects moved between a thread cache and a central free list at
+// a time
+inline size_t BatchSize(size_t size_class) {
+  size_t n = kBatchBytes / ThreadCacheCPUAllocator::ClassSize(size_class);
+  return std::min<size_t>(std::max<size_t>(n, 2), 32);
+}
+
+#ifdef __linux__
+// Parse the cpulist format of sysfs, e.g. "0-15,32-47"
+std::vector<int> ParseCpuList(const std::string& str) {
+  std::vector<int> cpus;
+  size_t pos = 0;
+  while (pos < str.size()) {
+    size_t end = str.find(',', pos);
+    if (end == std::string::npos) {
+      end = str.size();
+    }
+    std::string range = str.substr(pos, end - pos);
+    size_t dash = range.find('-');
+    try {
+      if (dash == std::string::npos) {
+        cpus.push_back(std::stoi(range));
+      } else {
+        int first = std::stoi(range.substr(0, dash));
+        int last = std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) {
+          cpus.push_back(cpu);
+        }
+      }
+    } catch (...) {
+      // ignore the malformed item
+    }
+    pos = end + 1;
+  }
+  return cpus;
+}
+#endif
+
+// The mapping from cpu to the arena of its NUMA node. There is only one arena
+// when the NUMA topology is unknown.
+class NumaTopology {
+ public:
+  static const NumaTopology& Instance() {
+    static NumaTopology topology;
+    return topology;
+  }
+
+  size_t NumArenas() const { return num_arenas_; }
+
+  size_t ArenaOfCurrentThread() const {
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    if (cpu >= 0 && static_cast<size_t>(cpu) < cpu_to_arena_.size()) {
+      return cpu_to_arena_[cpu];
+    }
+#endif
+    return 0;
+  }
+
+ private:
+  NumaTopology() {
+#ifdef __linux__
+    std::ifstream possible("/sys/devices/system/node/possible");
+    std::string nodes;
+    if (possible && std::getline(possible, nodes)) {
+      for (int node : ParseCpuList(nodes)) {
+        std::ifstream cpulist("/sys/devices/system/node/node" +
+                              std::to_string(node) + "/cpulist");
+        std::string cpus;
+        if (!cpulist || !std::getline(cpulist, cpus)) {
+          continue;
+        }
+        std::vector<int> node_cpus = ParseCpuList(cpus);
+        if (node_cpus.empty()) {
+          continue;  // memory-only node
+        }
+        for (int cpu : node_cpus) {
+          if (static_cast<size_t>(cpu) >= cpu_to_arena_.size()) {
+            cpu_to_arena_.resize(cpu + 1, 0);
+          }
+          cpu_to_arena_[cpu] = num_arenas_;
+        }
+        ++num_arenas_;
+      }
+    }
+#endif
+    if (num_arenas_ == 0) {
+      num_arenas_ = 1;
+      cpu_to_arena_.clear();
+    }
+    VLOG(4) << "ThreadCacheCPUAllocator uses " << num_arenas_ << " arena(s)";
+  }
+
+  size_t num_arenas_{0};
+  std::vector<size_t> cpu_to_arena_;
+};
+
+}  // namespace
+
+// ThreadCacheHeap holds the central free lists of all the arenas and owns
+// all the spans.
+class ThreadCacheHeap {
+ public:
+  ThreadCacheHeap()
+      : id_(NextId()),
+        num_arenas_(NumaTopology::Instance().NumArenas()),
+        central_lists_(new CentralFreeList[num_arenas_ *
+                                           ThreadCacheCPUAllocator::
+                                               kNumSizeClasses]) {}
+
+  ~ThreadCacheHeap() {
+    size_t num_lists =
+        num_arenas_ * ThreadCacheCPUAllocator::kNumSizeClasses;
+    for (size_t i = 0; i < num_lists; ++i) {
+      for (SpanHeader* span : central_lists_[i].spans) {
+        FreeSpan(span);
+      }
+    }
+  }
+
+  uint64_t id() const { return id_; }
+
+  // Move n objects of size_class from the central free list of arena to
+  // objects, new spans are allocated if there is not enough free objects
+  void FetchBatch(size_t arena,
+                  size_t size_class,
+                  size_t n,
+                  std::vector<void*>* objects) {
+    CentralFreeList& list = GetCentralList(arena, size_class);
+    size_t obj_size = ThreadCacheCPUAllocator::ClassSize(size_class);
+    std::lock_guard<std::mutex> guard(list.mtx);
+    size_t num_free = std::min(n, list.objects.size());
+    objects->insert(
+        objects->end(), list.objects.end() - num_free, list.objects.end());
+    list.objects.resize(list.objects.size() - num_free);
+
+    for (n -= num_free; n > 0; --n) {
+      if (list.cursor == nullptr || list.cursor + obj_size > list.end) {
+        NewSpan(arena, size_class, &list);
+      }
+      objects->push_back(list.cursor);
+      list.cursor += obj_size;
+      ++list.current->carved;
+    }
+  }
+
+  // Return n objects of size_class to the central free lists of their arenas
+  void ReleaseBatch(size_t size_class, void* const* objects, size_t n) {
+    size_t i = 0;
+    while (i < n) {
+      uint32_t arena = SpanOf(objects[i])->arena;
+      CentralFreeList& list = GetCentralList(arena, size_class);
+      std::lock_guard<std::mutex> guard(list.mtx);
+      for (; i < n && SpanOf(objects[i])->arena == arena; ++i) {
+        list.objects.push_back(objects[i]);
+      }
+    }
+  }
+
+  // Free the spans whose objects are all in the central free lists, return
+  // the released bytes
+  uint64_t ReleaseFreeSpans() {
+    uint64_t released = 0;
+    size_t num_lists =
+        num_arenas_ * ThreadCacheCPUAllocator::kNumSizeClasses;
+    for (size_t i = 0; i < num_lists; ++i) {
+      CentralFreeList& list = central_lists_[i];
+      std::lock_guard<std::mutex> guard(list.mtx);
+      if (list.spans.empty()) {
+        continue;
+      }
+
+      std::unordered_map<SpanHeader*, size_t> free_count;
+      for (void* obj : list.objects) {
+        ++free_count[SpanOf(obj)];
+      }
+
+      std::unordered_set<SpanHeader*> released_spans;
+      std::vector<SpanHeader*> remaining_spans;
+      for (SpanHeader* span : list.spans) {
+        auto iter = free_count.find(span);
+        size_t count = iter == free_count.end() ? 0 : iter->second;
+        if (count == span->carved) {
+          released_spans.insert(span);
+        } else {
+          remaining_spans.push_back(span);
+        }
+      }
+      if (released_spans.empty()) {
+        continue;
+      }
+
+      std::vector<void*> remaining_objects;
+      for (void* obj : list.objects) {
+        if (released_spans.count(SpanOf(obj)) == 0) {
+          remaining_objects.push_back(obj);
+        }
+      }
+      list.objects.swap(remaining_objects);
+      list.spans.swap(remaining_spans);
+      if (released_spans.count(list.current)) {
+        list.current = nullptr;
+        list.cursor = nullptr;
+        list.end = nullptr;
+      }
+      for (SpanHeader* span : released_spans) {
+        FreeSpan(span);
+        released += kSpanSize;
+      }
+    }
+    VLOG(10) << "ThreadCacheCPUAllocator releases " << released << " bytes";
+    return released;
+  }
+
+ private:
+  struct CentralFreeList {
+    std::mutex mtx;
+    std::vector<void*> objects;
+    std::vector<SpanHeader*> spans;
+    // the span being carved
+    SpanHeader* current{nullptr};
+    char* cursor{nullptr};
+    char* end{nullptr};
+  };
+
+  static uint64_t NextId() {
+    static std::atomic<uint64_t> id{0};
+    return ++id;
+  }
+
+  CentralFreeList& GetCentralList(size_t arena, size_t size_class) {
+    return central_lists_[arena * ThreadCacheCPUAllocator::kNumSizeClasses +
+                          size_class];
+  }
+
+  void NewSpan(size_t arena, size_t size_class, CentralFreeList* list) {
+    void* ptr = nullptr;
+#ifdef _WIN32
+    ptr = _aligned_malloc(kSpanSize, kSpanSize);
+    int error = ptr ? 0 : errno;
+#else
+    int error = posix_memalign(&ptr, kSpanSize, kSpanSize);
+#endif
+    if (UNLIKELY(error != 0 || ptr == nullptr)) {
+      PADDLE_THROW_BAD_ALLOC(platform::errors::ResourceExhausted(
+          "Fail to alloc a span of %ld bytes for size class %d in "
+          "ThreadCacheCPUAllocator, error code is %d.",
+          kSpanSize,
+          size_class,
+          error));
+    }
+    HOST_MEMORY_STAT_UPDATE(Reserved, 0, kSpanSize);
+
+    SpanHeader* span = static_cast<SpanHeader*>(ptr);
+    span->arena = static_cast<uint32_t>(arena);
+    span->size_class = static_cast<uint32_t>(size_class);
+    span->carved = 0;
+    list->spans.push_back(span);
+    list->current = span;
+    list->cursor =
+        static_cast<char*>(ptr) + ThreadCacheCPUAllocator::kAlignment;
+    list->end = static_cast<char*>(ptr) + kSpanSize;
+  }
+
+  static void FreeSpan(SpanHeader* span) {
+#ifdef _WIN32
+    _aligned_free(span);
+#else
+    free(span);  // NOLINT
+#endif
+    HOST_MEMORY_STAT_UPDATE(Reserved, 0, -kSpanSize);
+  }
+
+  uint64_t id_;
+  size_t num_arenas_;
+  std::unique_ptr<CentralFreeList[]> central_lists_;
+};
+
+namespace {
+
+// ThreadCache caches the objects of every size class for one thread and one
+// ThreadCacheHeap, it is only accessed by its owner thread.
+class ThreadCache {
+ public:
+  explicit ThreadCache(ThreadCacheHeap* heap)
+      : heap_(heap), arena_(NumaTopology::Instance().ArenaOfCurrentThread()) {}
+
+  void* Allocate(size_t size_class) {
+    std::vector<void*>& list = lists_[size_class];
+    if (UNLIKELY(list.empty())) {
+      heap_->FetchBatch(arena_, size_class, BatchSize(size_class), &list);
+      cached_bytes_ +=
+          list.size() * ThreadCacheCPUAllocator::ClassSize(size_class);
+    }
+    void* ptr = list.back();
+    list.pop_back();
+    cached_bytes_ -= ThreadCacheCPUAllocator::ClassSize(size_class);
+    return ptr;
+  }
+
+  void Deallocate(void* ptr, size_t size_class) {
+    std::vector<void*>& list = lists_[size_class];
+    list.push_back(ptr);
+    cached_bytes_ += ThreadCacheCPUAllocator::ClassSize(size_class);
+    size_t batch_size = BatchSize(size_class);
+    if (UNLIKELY(list.size() > 2 * batch_size)) {
+      ReleaseToCentral(size_class, batch_size);
+    }
+    if (UNLIKELY(cached_bytes_ > kMaxThreadCacheBytes)) {
+      Scavenge();
+    }
+  }
+
+  // Return all the cached objects to the central free lists
+  void Flush() {
+    for (size_t i = 0; i < lists_.size(); ++i) {
+      ReleaseToCentral(i, lists_[i].size());
+    }
+  }
+
+ private:
+  // Return the n coldest objects of size_class to the central free list
+  void ReleaseToCentral(size_t size_class, size_t n) {
+    std::vector<void*>& list = lists_[size_class];
+    n = std::min(n, list.size());
+    if (n == 0) {
+      return;
+    }
+    heap_->ReleaseBatch(size_class, list.data(), n);
+    list.erase(list.begin(), list.begin() + n);
+    cached_bytes_ -= n * ThreadCacheCPUAllocator::ClassSize(size_class);
+  }
+
+  // Halve every list when the thread cache grows too large
+  void Scavenge() {
+    for (size_t i = 0; i < lists_.size(); ++i) {
+      ReleaseToCentral(i, (lists_[i].size() + 1) / 2);
+    }
+  }
+
+  ThreadCacheHeap* heap_;
+  size_t arena_;
+  size_t cached_bytes_{0};
+  std::array<std::vector<void*>, ThreadCacheCPUAllocator::kNumSizeClasses>
+      lists_;
+};
+
+enum class RegistryState { kNotCreated, kAlive, kDestroyed };
+thread_local RegistryState registry_state = RegistryState::kNotCreated;
+
+// ThreadCacheRegistry holds the thread caches of the current thread, and
+// returns them to their heaps when the thread exits.
+class ThreadCacheRegistry {
+ public:
+  ThreadCacheRegistry() { registry_state = RegistryState::kAlive; }
+
+  ~ThreadCacheRegistry() {
+    for (auto& item : caches_) {
+      std::shared_ptr<ThreadCacheHeap> heap = item.second.first.lock();
+      if (heap) {
+        item.second.second->Flush();
+      }
+    }
+    registry_state = RegistryState::kDestroyed;
+  }
+
+  ThreadCache* Get(const std::shared_ptr<ThreadCacheHeap>& heap) {
+    if (LIKELY(heap->id() == last_id_)) {
+      return last_cache_;
+    }
+
+    auto iter = caches_.find(heap->id());
+    if (iter == caches_.end()) {
+      // drop the caches of the destroyed heaps
+      for (auto it = caches_.begin(); it != caches_.end();) {
+        it = it->second.first.expired() ? caches_.erase(it) : std::next(it);
+      }
+      iter = caches_
+                 .emplace(heap->id(),
+                          std::make_pair(std::weak_ptr<ThreadCacheHeap>(heap),
+                                         std::make_unique<ThreadCache>(
+                                             heap.get())))
+                 .first;
+    }
+    last_id_ = heap->id();
+    last_cache_ = iter->second.second.get();
+    return last_cache_;
+  }
+
+ private:
+  std::unordered_map<
+      uint64_t,
+      std::pair<std::weak_ptr<ThreadCacheHeap>, std::unique_ptr<ThreadCache>>>
+      caches_;
+  uint64_t last_id_{0};
+  ThreadCache* last_cache_{nullptr};
+};
+
+// Return nullptr if called during the thread exits after the registry has
+// been destroyed
+ThreadCache* GetThreadCache(const std::shared_ptr<ThreadCacheHeap>& heap) {
+  if (UNLIKELY(registry_state == RegistryState::kDestroyed)) {
+    return nullptr;
+  }
+  static thread_local ThreadCacheRegistry registry;
+  return registry.Get(heap);
+}
+
+}  // namespace
+
+size_t ThreadCacheCPUAllocator::SizeClass(size_t size) {
+  // 16 classes of multiples of 64 bytes up to 1KB, then 4 classes per power
+  // of two up to kMaxSmallSize
+  if (size <= 1024) {
+    return size == 0 ? 0 : (size - 1) / 64;
+  }
+  size_t exp = 10;
+  while ((size - 1) >> (exp + 1)) {
+    ++exp;
+  }
+  size_t step = static_cast<size_t>(1) << (exp - 2);
+  size_t k = (size - (static_cast<size_t>(1) << exp) + step - 1) / step;
+  return 16 + (exp - 10) * 4 + (k - 1);
+}
+
+size_t ThreadCacheCPUAllocator::ClassSize(size_t size_class) {
+  if (size_class < 16) {
+    return (size_class + 1) * 64;
+  }
+  size_t exp = (size_class - 16) / 4 + 10;
+  size_t k = (size_class - 16) % 4 + 1;
+  return (static_cast<size_t>(1) << exp) +
+         k * (static_cast<size_t>(1) << (exp - 2));
+}
+
+ThreadCacheCPUAllocator::ThreadCacheCPUAllocator()
+    : heap_(std::make_shared<ThreadCacheHeap>()),
+      large_allocator_(std::make_shared<CPUAllocator>()) {}
+
+ThreadCacheCPUAllocator::~ThreadCacheCPUAllocator() = default;
+
+phi::Allocation* ThreadCacheCPUAllocator::AllocateImpl(size_t size) {
+  if (size == 0 || size > kMaxSmallSize) {
+    return large_allocator_->Allocate(size).release();
+  }
+
+  size_t size_class = SizeClass(size);
+  void* ptr = nullptr;
+  ThreadCache* cache = GetThreadCache(heap_);
+  if (LIKELY(cache != nullptr)) {
+    ptr = cache->Allocate(size_class);
+  } else {
+    std::vector<void*> objects;
+    heap_->FetchBatch(NumaTopology::Instance().ArenaOfCurrentThread(),
+                      size_class,
+                      1,
+                      &objects);
+    ptr = objects[0];
+  }
+  return new Allocation(ptr, size, platform::CPUPlace());
+}
+
+void ThreadCacheCPUAllocator::FreeImpl(phi::Allocation* allocation) {
+  size_t size = allocation->size();
+  if (size == 0 || size > kMaxSmallSize) {
+    large_allocator_->Free(allocation);
+    return;
+  }
+
+  size_t size_class = SizeClass(size);
+  void* ptr = allocation->ptr();
+  ThreadCache* cache = GetThreadCache(heap_);
+  if (LIKELY(cache != nullptr)) {
+    cache->Deallocate(ptr, size_class);
+  } else {
+    heap_->ReleaseBatch(size_class, &ptr, 1);
+  }
+  delete allocation;
+}
+
+uint64_t ThreadCacheCPUAllocator::ReleaseImpl(const platform::Place& place) {
+  ThreadCache* cache = GetThreadCache(heap_);
+  if (cache != nullptr) {
+    cache->Flush();
+  }
+  return heap_->ReleaseFreeSpans();
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
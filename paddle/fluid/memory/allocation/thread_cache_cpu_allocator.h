@@ -0,0 +1,71 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "paddle/fluid/memory/allocation/allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+class ThreadCacheHeap;
+
+// ThreadCacheCPUAllocator is a size-class segregated allocator for CPUPlace
+// in the style of tcmalloc, so that the allocation cost does not grow with the
+// number of threads that allocate concurrently.
+//
+// Small requests (<= kMaxSmallSize) are rounded up to one of kNumSizeClasses
+// size classes and served from a per-thread cache without any lock. When a
+// thread cache runs out of (or holds too many) objects of a size class, a
+// batch of objects is moved from (or to) the central free list of that size
+// class with one lock acquisition. The central free lists carve objects from
+// 2MB spans, and there is one set of central free lists (an arena) per NUMA
+// node, a thread always allocates from the arena of the node it first runs on.
+// Large requests are forwarded to CPUAllocator.
+//
+// All the returned pointers are aligned to kAlignment bytes.
+class ThreadCacheCPUAllocator : public Allocator {
+ public:
+  static constexpr size_t kAlignment = 64;
+  static constexpr size_t kMaxSmallSize = 256 << 10;
+  static constexpr size_t kNumSizeClasses = 48;
+
+  ThreadCacheCPUAllocator();
+  ~ThreadCacheCPUAllocator() override;
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  // Return the index of the smallest size class that can hold size bytes,
+  // size should be in (0, kMaxSmallSize]
+  static size_t SizeClass(size_t size);
+  // Return the object size of the size class
+  static size_t ClassSize(size_t size_class);
+
+ protected:
+  phi::Allocation* AllocateImpl(size_t size) override;
+  void FreeImpl(phi::Allocation* allocation) override;
+  uint64_t ReleaseImpl(const platform::Place& place) override;
+
+ private:
+  std::shared_ptr<ThreadCacheHeap> heap_;
+  std::shared_ptr<Allocator> large_allocator_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,98 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/thread_cache_cpu_allocator.h"
+
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+TEST(ThreadCacheCPUAllocator, SizeClass) {
+  using Allocator = ThreadCacheCPUAllocator;
+  for (size_t size = 1; size <= Allocator::kMaxSmallSize; ++size) {
+    size_t size_class = Allocator::SizeClass(size);
+    ASSERT_LT(size_class, Allocator::kNumSizeClasses);
+    ASSERT_GE(Allocator::ClassSize(size_class), size);
+    ASSERT_EQ(Allocator::ClassSize(size_class) % Allocator::kAlignment, 0UL);
+    if (size_class > 0) {
+      ASSERT_LT(Allocator::ClassSize(size_class - 1), size);
+    }
+  }
+  EXPECT_EQ(Allocator::ClassSize(Allocator::kNumSizeClasses - 1),
+            Allocator::kMaxSmallSize);
+}
+
+TEST(ThreadCacheCPUAllocator, ReuseInSameThread) {
+  ThreadCacheCPUAllocator allocator;
+  void* ptr = nullptr;
+  {
+    auto allocation = allocator.Allocate(100);
+    ptr = allocation->ptr();
+    EXPECT_EQ(allocation->size(), 100UL);
+    EXPECT_EQ(
+        reinterpret_cast<uintptr_t>(ptr) % ThreadCacheCPUAllocator::kAlignment,
+        0UL);
+  }
+  // the freed object is cached by current thread and returned at once
+  auto allocation = allocator.Allocate(128);
+  EXPECT_EQ(allocation->ptr(), ptr);
+
+  auto large_allocation =
+      allocator.Allocate(ThreadCacheCPUAllocator::kMaxSmallSize + 1);
+  EXPECT_NE(large_allocation->ptr(), nullptr);
+}
+
+TEST(ThreadCacheCPUAllocator, MultiThread) {
+  ThreadCacheCPUAllocator allocator;
+  const int kThreadNum = 8;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back([&allocator, t] {
+      std::mt19937 rng(t);
+      std::vector<AllocationPtr> allocations;
+      for (int i = 0; i < 10000; ++i) {
+        if (allocations.size() < 64 || rng() % 2 == 0) {
+          size_t size = 1 + rng() % 8192;
+          allocations.emplace_back(allocator.Allocate(size));
+          memset(allocations.back()->ptr(), t, size);
+        } else {
+          size_t idx = rng() % allocations.size();
+          auto* data = static_cast<unsigned char*>(allocations[idx]->ptr());
+          EXPECT_EQ(data[0], static_cast<unsigned char>(t));
+          EXPECT_EQ(data[allocations[idx]->size() - 1],
+                    static_cast<unsigned char>(t));
+          std::swap(allocations[idx], allocations.back());
+          allocations.pop_back();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // all the thread caches have been returned when the threads exit
+  EXPECT_GT(allocator.Release(platform::CPUPlace()), 0UL);
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,131 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/batched_memcpy.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+
+#include <algorithm>
+#include <cstring>
+
+#include "paddle/fluid/memory/allocation/pinned_allocator.h"
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/profiler/event_tracing.h"
+
+namespace paddle {
+namespace memory {
+
+// the alignment of the slices, the same as the one of the cuda allocator
+constexpr size_t kSliceAlignment = 256;
+#ifdef PADDLE_WITH_HIP
+constexpr unsigned int kStagingEventFlags = hipEventDisableTiming;
+#else
+constexpr unsigned int kStagingEventFlags = cudaEventDisableTiming;
+#endif
+
+BatchedMemcpy::BatchedMemcpy(const platform::CUDAPlace& place,
+                             gpuStream_t stream)
+    : place_(place), stream_(stream), staging_event_(kStagingEventFlags) {}
+
+std::vector<size_t> BatchedMemcpy::PrepareStaging(
+    const std::vector<size_t>& sizes) {
+  std::vector<size_t> offsets(sizes.size());
+  size_t total = 0;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    offsets[i] = total;
+    total += allocation::AlignedSize(sizes[i], kSliceAlignment);
+  }
+  if (staging_in_flight_) {
+    staging_event_.Synchronize();
+    staging_in_flight_ = false;
+  }
+  if (!staging_ || staging_->size() < total) {
+    staging_.reset();
+    staging_ = allocation::SizeClassPinnedAllocator::StagingPool()->Allocate(
+        std::max<size_t>(total, 1));
+  }
+  return offsets;
+}
+
+std::vector<std::shared_ptr<phi::Allocation>> BatchedMemcpy::CopyToDevice(
+    const std::vector<const void*>& srcs, const std::vector<size_t>& sizes) {
+  platform::RecordEvent record_event(
+      "BatchedMemcpy::CopyToDevice", platform::TracerEventType::UserDefined, 2);
+  std::vector<std::shared_ptr<phi::Allocation>> views;
+  if (srcs.empty()) {
+    return views;
+  }
+  std::vector<size_t> offsets = PrepareStaging(sizes);
+  auto* staging = static_cast<char*>(staging_->ptr());
+  for (size_t i = 0; i < srcs.size(); ++i) {
+    std::memcpy(staging + offsets[i], srcs[i], sizes[i]);
+  }
+  const size_t total = offsets.back() + sizes.back();
+
+  std::shared_ptr<phi::Allocation> buffer = AllocShared(
+      place_, total, phi::Stream(reinterpret_cast<phi::StreamId>(stream_)));
+  Copy(place_,
+       buffer->ptr(),
+       platform::CUDAPinnedPlace(),
+       staging,
+       total,
+       stream_);
+  staging_event_.Record(stream_);
+  staging_in_flight_ = true;
+
+  auto* base = static_cast<char*>(buffer->ptr());
+  views.reserve(srcs.size());
+  for (size_t i = 0; i < srcs.size(); ++i) {
+    // the views keep the device buffer alive
+    views.emplace_back(
+        new phi::Allocation(base + offsets[i], sizes[i], place_),
+        [buffer](phi::Allocation* view) { delete view; });
+  }
+  VLOG(4) << "Copied " << srcs.size() << " buffers of " << total
+          << " bytes to " << place_ << " in one batch";
+  return views;
+}
+
+void BatchedMemcpy::CopyToHost(const std::vector<void*>& dsts,
+                               const std::vector<const void*>& srcs,
+                               const std::vector<size_t>& sizes) {
+  platform::RecordEvent record_event(
+      "BatchedMemcpy::CopyToHost", platform::TracerEventType::UserDefined, 2);
+  if (srcs.empty()) {
+    return;
+  }
+  std::vector<size_t> offsets = PrepareStaging(sizes);
+  auto* staging = static_cast<char*>(staging_->ptr());
+  for (size_t i = 0; i < srcs.size(); ++i) {
+    Copy(platform::CUDAPinnedPlace(),
+         staging + offsets[i],
+         place_,
+         srcs[i],
+         sizes[i],
+         stream_);
+  }
+  staging_event_.Record(stream_);
+  staging_event_.Synchronize();
+  for (size_t i = 0; i < dsts.size(); ++i) {
+    std::memcpy(dsts[i], staging + offsets[i], sizes[i]);
+  }
+  VLOG(4) << "Copied " << srcs.size() << " buffers from " << place_
+          << " with one synchronization";
+}
+
+}  // namespace memory
+}  // namespace paddle
+
+#endif
@@ -0,0 +1,72 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+
+#include <memory>
+#include <vector>
+
+#include "paddle/fluid/memory/allocation/allocator.h"
+#include "paddle/fluid/platform/event.h"
+#include "paddle/fluid/platform/place.h"
+
+namespace paddle {
+namespace memory {
+
+// BatchedMemcpy packs the copies of many small buffers between the host and a
+// device on one stream into one pinned staging buffer from
+// SizeClassPinnedAllocator::StagingPool(), instead of the copies from the
+// pageable memory, each of which is staged and synchronized by the driver.
+//
+// The host buffers copied to the device are packed into the staging buffer on
+// the host and copied into one device buffer by one memcpy, of which every
+// buffer is given a view. The device buffers copied to the host are copied
+// asynchronously into the slices of the staging buffer, and unpacked on the
+// host after one synchronization of the stream.
+//
+// The staging buffer is kept for the next batch, which waits for the copy of
+// the last batch to finish before overwriting it.
+class BatchedMemcpy {
+ public:
+  BatchedMemcpy(const platform::CUDAPlace& place, gpuStream_t stream);
+
+  // Copies srcs[i] of sizes[i] bytes on the host to the device, and returns
+  // the views of the device buffer holding them in the order of srcs.
+  std::vector<std::shared_ptr<phi::Allocation>> CopyToDevice(
+      const std::vector<const void*>& srcs, const std::vector<size_t>& sizes);
+
+  // Copies srcs[i] of sizes[i] bytes on the device to dsts[i] on the host,
+  // which returns after all the copies finish.
+  void CopyToHost(const std::vector<void*>& dsts,
+                  const std::vector<const void*>& srcs,
+                  const std::vector<size_t>& sizes);
+
+ private:
+  // Returns the offsets of the slices of sizes in the staging buffer, which
+  // is resized to hold them after the copy of the last batch finishes.
+  std::vector<size_t> PrepareStaging(const std::vector<size_t>& sizes);
+
+  platform::CUDAPlace place_;
+  gpuStream_t stream_;
+  AllocationPtr staging_;
+  bool staging_in_flight_{false};
+  platform::CudaEvent staging_event_;
+};
+
+}  // namespace memory
+}  // namespace paddle
+
+#endif
@@ -0,0 +1,81 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda_runtime.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/fluid/platform/place.h"
+
+namespace paddle {
+namespace memory {
+
+__global__ void add_kernel(int* x, int n) {
+  int thread_num = gridDim.x * blockDim.x;
+  int thread_id = blockIdx.x * blockDim.x + threadIdx.x;
+  for (int i = thread_id; i < n; i += thread_num) {
+    x[i] += 1;
+  }
+}
+
+TEST(CUDAMallocAsyncTest, AllocOnMultiStreams) {
+  platform::CUDAPlace place(0);
+  const int n_data = 1024;
+  const int n_stream = 4;
+  std::vector<cudaStream_t> streams(n_stream);
+  std::vector<std::shared_ptr<Allocation>> allocations;
+  for (int i = 0; i < n_stream; ++i) {
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamCreate(&streams[i]));
+    phi::Stream stream(reinterpret_cast<phi::StreamId>(streams[i]));
+    allocations.emplace_back(AllocShared(place, n_data * sizeof(int), stream));
+    EXPECT_TRUE(InSameStream(allocations[i], stream));
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemsetAsync(
+        allocations[i]->ptr(), 0, n_data * sizeof(int), streams[i]));
+  }
+
+  // use the allocation of stream 0 on all the streams before freeing it
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(streams[0]));
+  int* data = static_cast<int*>(allocations[0]->ptr());
+  for (int i = 1; i < n_stream; ++i) {
+    add_kernel<<<1, 64, 0, streams[i]>>>(data, n_data);
+    RecordStream(allocations[0], streams[i]);
+  }
+  allocations.clear();
+
+  for (int i = 0; i < n_stream; ++i) {
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(streams[i]));
+    EXPECT_GE(Release(place, streams[i]), 0UL);
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamDestroy(streams[i]));
+  }
+}
+
+TEST(CUDAMallocAsyncTest, ReuseFreedMemory) {
+  platform::CUDAPlace place(0);
+  const size_t size = 64 << 20;
+  void* first_ptr = nullptr;
+  {
+    AllocationPtr allocation = Alloc(place, size);
+    first_ptr = allocation->ptr();
+  }
+  // the freed block stays in the pool and is reused by the next allocation of
+  // the same stream
+  AllocationPtr allocation = Alloc(place, size);
+  EXPECT_EQ(allocation->ptr(), first_ptr);
+}
+
+}  // namespace memory
+}  // namespace paddle
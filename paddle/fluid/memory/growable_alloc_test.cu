@@ -0,0 +1,58 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cuda_runtime.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/fluid/platform/place.h"
+
+namespace paddle {
+namespace memory {
+
+TEST(GrowableAllocation, ExtendInPlace) {
+  platform::CUDAPlace place(0);
+  const size_t init_size = 1 << 10;
+  const size_t max_size = 64 << 20;
+  auto allocation = AllocGrowableShared(place, init_size, max_size);
+  ASSERT_GE(allocation->size(), init_size);
+  void* ptr = allocation->ptr();
+
+  std::vector<char> host(init_size, 7);
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemcpy(ptr, host.data(), init_size, cudaMemcpyHostToDevice));
+
+  // Without the virtual memory management the allocation can not be
+  // extended, then the caller should allocate a new one.
+  if (!allocation->Extend(max_size / 2)) {
+    return;
+  }
+  EXPECT_EQ(allocation->ptr(), ptr);
+  EXPECT_GE(allocation->size(), max_size / 2);
+  EXPECT_FALSE(allocation->Extend(max_size * 2));
+
+  // The extended part is accessible and the content is kept.
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemset(
+      static_cast<char*>(ptr) + init_size, 1, max_size / 2 - init_size));
+  std::vector<char> result(init_size, 0);
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemcpy(result.data(), ptr, init_size, cudaMemcpyDeviceToHost));
+  EXPECT_EQ(result, host);
+}
+
+}  // namespace memory
+}  // namespace paddle
@@ -76,6 +76,17 @@ gpuStream_t GetStream(const std::shared_ptr<Allocation>& allocation) {
   return allocation::AllocatorFacade::Instance().GetStream(allocation);
 }
 
+std::shared_ptr<Allocation> AllocCommShared(const platform::CUDAPlace& place,
+                                            size_t size) {
+  return allocation::AllocatorFacade::Instance().AllocCommShared(place, size);
+}
+
+std::shared_ptr<Allocation> AllocGrowableShared(
+    const platform::CUDAPlace& place, size_t size, size_t max_size) {
+  return allocation::AllocatorFacade::Instance().AllocGrowableShared(
+      place, size, max_size);
+}
+
 #endif
 
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
@@ -57,6 +57,14 @@ void RecordStream(std::shared_ptr<Allocation> allocation, gpuStream_t stream);
 void EraseStream(std::shared_ptr<Allocation> allocation, gpuStream_t stream);
 
 gpuStream_t GetStream(const std::shared_ptr<Allocation>& allocation);
+
+// A buffer of the collectives, see AllocatorFacade::AllocCommShared
+extern std::shared_ptr<Allocation> AllocCommShared(
+    const platform::CUDAPlace& place, size_t size);
+
+// A buffer extensible in place, see AllocatorFacade::AllocGrowableShared
+extern std::shared_ptr<Allocation> AllocGrowableShared(
+    const platform::CUDAPlace& place, size_t size, size_t max_size);
 #endif
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
 void RecordStream(std::shared_ptr<Allocation> allocation,
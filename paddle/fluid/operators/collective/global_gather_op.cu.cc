@@ -129,18 +129,21 @@ struct GlobalGatherFunctor<phi::GPUContext, T> {
       fwd_count += cpu_local_count_data[i];
     }
     framework::DDim out_dims = common::make_ddim({fwd_count, in_feat});
-    int64_t* expert_ptr = new int64_t[n_expert * nranks];
-    expert_ptr[0] = 0;
     auto tot_experts = n_expert * nranks;
+    std::vector<int64_t> expert_ptr(tot_experts, 0);
     for (auto i = 1; i < tot_experts; ++i) {
       expert_ptr[i] = expert_ptr[i - 1] + cpu_local_count_data[i - 1];
     }
-    auto send_ptr = 0;
+    int64_t send_ptr = 0;
     out->mutable_data<T>(out_dims, place);
 
+    // All the sends and recvs of all the experts go into one group, so that
+    // NCCL runs them as a single variable-size all-to-all instead of one
+    // round trip per expert. The order of the messages per peer is kept, which
+    // is what matches the sends to the recvs.
     if (comm_ctx) {
+      comm_ctx->GroupStart();
       for (auto i = 0; i < n_expert; ++i) {
-        comm_ctx->GroupStart();
         for (auto j = 0; j < nranks; ++j) {
           int idx = i + j * n_expert;
           if (cpu_global_count_data[idx]) {
@@ -159,13 +162,13 @@ struct GlobalGatherFunctor<phi::GPUContext, T> {
                 &recv_buf, cpu_local_count_data[idx] * in_feat, j, stream);
           }
         }
-        comm_ctx->GroupEnd();
       }
+      comm_ctx->GroupEnd();
     } else {
       auto send_buf = x->data<T>();
       auto recv_buf = out->data<T>();
+      PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclGroupStart());
       for (auto i = 0; i < n_expert; ++i) {
-        PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclGroupStart());
         for (auto j = 0; j < nranks; ++j) {
           int idx = i + j * n_expert;
           if (cpu_global_count_data[idx]) {
@@ -188,8 +191,8 @@ struct GlobalGatherFunctor<phi::GPUContext, T> {
                 stream));
           }
         }
-        PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclGroupEnd());
       }
+      PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclGroupEnd());
     }
 #else
     PADDLE_THROW(
@@ -269,17 +272,16 @@ struct GlobalGatherProcessGroupFunctor<phi::GPUContext, T> {
       fwd_count += cpu_local_count_data[i];
     }
     framework::DDim out_dims = common::make_ddim({fwd_count, in_feat});
-    int64_t* expert_ptr = new int64_t[n_expert * nranks];
-    expert_ptr[0] = 0;
     auto tot_experts = n_expert * nranks;
+    std::vector<int64_t> expert_ptr(tot_experts, 0);
     for (auto i = 1; i < tot_experts; ++i) {
       expert_ptr[i] = expert_ptr[i - 1] + cpu_local_count_data[i - 1];
     }
-    auto send_ptr = 0;
+    int64_t send_ptr = 0;
     out->mutable_data<T>(out_dims, place);
 
+    distributed::ProcessGroupNCCL::GroupStart();
     for (auto i = 0; i < n_expert; ++i) {
-      distributed::ProcessGroupNCCL::GroupStart();
       for (auto j = 0; j < nranks; ++j) {
         int idx = i + j * n_expert;
         if (cpu_global_count_data[idx]) {
@@ -299,8 +301,8 @@ struct GlobalGatherProcessGroupFunctor<phi::GPUContext, T> {
                    /*sync_op*/ true);
         }
       }
-      distributed::ProcessGroupNCCL::GroupEnd();
     }
+    distributed::ProcessGroupNCCL::GroupEnd();
 
 #ifdef PADDLE_WITH_CUDA
     PADDLE_ENFORCE_GPU_SUCCESS(cudaDeviceSynchronize());
@@ -134,19 +134,22 @@ struct GlobalScatterFunctor<phi::GPUContext, T> {
       fwd_count += cpu_global_count_data[i];
     }
     framework::DDim out_dims = common::make_ddim({fwd_count, in_feat});
-    int64_t* expert_ptr = new int64_t[n_expert * nranks];
-    expert_ptr[0] = 0;
     auto tot_experts = n_expert * nranks;
+    std::vector<int64_t> expert_ptr(tot_experts, 0);
     for (auto i = 1; i < tot_experts; ++i) {
       expert_ptr[i] = expert_ptr[i - 1] + cpu_local_count_data[i - 1];
     }
 
-    auto recv_ptr = 0;
+    int64_t recv_ptr = 0;
     out->mutable_data<T>(out_dims, place);
 
+    // All the sends and recvs of all the experts go into one group, so that
+    // NCCL runs them as a single variable-size all-to-all instead of one
+    // round trip per expert. The order of the messages per peer is kept, which
+    // is what matches the sends to the recvs.
     if (comm_ctx) {
+      comm_ctx->GroupStart();
       for (auto i = 0; i < n_expert; ++i) {
-        comm_ctx->GroupStart();
         for (auto j = 0; j < nranks; ++j) {
           int idx = i + j * n_expert;
           if (cpu_local_count_data[idx]) {
@@ -166,14 +169,14 @@ struct GlobalScatterFunctor<phi::GPUContext, T> {
             recv_ptr += cpu_global_count_data[idx];
           }
         }
-        comm_ctx->GroupEnd();
       }
+      comm_ctx->GroupEnd();
     } else {
       auto send_buf = x->data<T>();
       auto recv_buf = out->data<T>();
 
+      PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclGroupStart());
       for (auto i = 0; i < n_expert; ++i) {
-        PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclGroupStart());
         for (auto j = 0; j < nranks; ++j) {
           int idx = i + j * n_expert;
           if (cpu_local_count_data[idx]) {
@@ -196,8 +199,8 @@ struct GlobalScatterFunctor<phi::GPUContext, T> {
             recv_ptr += cpu_global_count_data[idx];
           }
         }
-        PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclGroupEnd());
       }
+      PADDLE_ENFORCE_GPU_SUCCESS(platform::dynload::ncclGroupEnd());
     }
 
 #else
@@ -275,18 +278,17 @@ struct GlobalScatterProcessGroupFunctor<phi::GPUContext, T> {
       fwd_count += cpu_global_count_data[i];
     }
     framework::DDim out_dims = common::make_ddim({fwd_count, in_feat});
-    int64_t* expert_ptr = new int64_t[n_expert * nranks];
-    expert_ptr[0] = 0;
     auto tot_experts = n_expert * nranks;
+    std::vector<int64_t> expert_ptr(tot_experts, 0);
     for (auto i = 1; i < tot_experts; ++i) {
       expert_ptr[i] = expert_ptr[i - 1] + cpu_local_count_data[i - 1];
     }
 
-    auto recv_ptr = 0;
+    int64_t recv_ptr = 0;
     out->mutable_data<T>(out_dims, place);
 
+    distributed::ProcessGroupNCCL::GroupStart();
     for (auto i = 0; i < n_expert; ++i) {
-      distributed::ProcessGroupNCCL::GroupStart();
       for (auto j = 0; j < nranks; ++j) {
         int idx = i + j * n_expert;
         if (cpu_local_count_data[idx]) {
@@ -306,8 +308,8 @@ struct GlobalScatterProcessGroupFunctor<phi::GPUContext, T> {
           recv_ptr += cpu_global_count_data[idx];
         }
       }
-      distributed::ProcessGroupNCCL::GroupEnd();
     }
+    distributed::ProcessGroupNCCL::GroupEnd();
 
 #ifdef PADDLE_WITH_CUDA
     PADDLE_ENFORCE_GPU_SUCCESS(cudaDeviceSynchronize());
@@ -179,6 +179,11 @@ class FusedSeqpoolCVMOpMaker : public framework::OpProtoAndCheckerMaker {
         .SetDefault(0.0);
     AddAttr<bool>("use_cvm", "bool, use cvm or not").SetDefault(true);
     AddAttr<int>("cvm_offset", "(int, default 2)").SetDefault(2);
+    AddAttr<int>("quant_ratio",
+                 "(int, default 0) The ratio to quantize the embedx by, as "
+                 "round(embedx * quant_ratio) / quant_ratio, before the "
+                 "pooling, 0 for no quantization.")
+        .SetDefault(0);
 
     AddComment(R"DOC(
 Fuse multiple pairs of Sequence Pool and CVM Operator.
@@ -17,78 +17,141 @@
 #include "paddle/fluid/operators/fused/fused_seqpool_cvm_op.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/device/gpu/gpu_launch_config.h"
-#include "paddle/phi/core/mixed_vector.h"
 
 namespace paddle {
 namespace operators {
 
-template <typename T>
-using Vector = phi::Vector<T>;
-
 #define CUDA_KERNEL_LOOP(i, n)                                  \
   for (auto i = blockIdx.x * blockDim.x + threadIdx.x; i < (n); \
        i += blockDim.x * gridDim.x)
 
-// normal
+// Copies the groups of the per slot pointers and the lods of all the slots,
+// packed into [slot_num * (batch_size + 1)], to a device allocation, so that a
+// step does not copy the lod of every slot on its own.
 template <typename T>
-__global__ void FusedSeqpoolKernelNormal(const size_t N,
-                                         T **input_values,
-                                         T **seqpool_output_values,
-                                         size_t **lods_values,
-                                         const int batch_size,
-                                         const int embedding_size,
-                                         const float pad_value) {
-  CUDA_KERNEL_LOOP(i, N) {
-    int key = i / embedding_size;
-    int offset = i % embedding_size;
-    int x = key / batch_size;  // slot id
-    int y = key % batch_size;  // ins id
-    auto &start = *(lods_values[x] + y);
-    auto &end = *(lods_values[x] + y + 1);
+static std::shared_ptr<memory::Allocation> CopySlotsToDevice(
+    const framework::ExecutionContext &ctx,
+    const std::vector<std::vector<const T *>> &ptrs,
+    const std::vector<size_t> &lods,
+    std::vector<T **> *gpu_ptrs,
+    size_t **gpu_lods) {
+  auto stream = ctx.template device_context<phi::GPUContext>().stream();
+  std::vector<const T *> packed_ptrs;
+  for (auto &slot_ptrs : ptrs) {
+    packed_ptrs.insert(packed_ptrs.end(), slot_ptrs.begin(), slot_ptrs.end());
+  }
+  size_t ptrs_bytes = packed_ptrs.size() * sizeof(const T *);
+  auto temp_ptr = memory::AllocShared(
+      ctx.GetPlace(), ptrs_bytes + lods.size() * sizeof(size_t));
+  T **gpu_packed_ptrs = reinterpret_cast<T **>(temp_ptr->ptr());
+  *gpu_lods = reinterpret_cast<size_t *>(gpu_packed_ptrs + packed_ptrs.size());
+#ifdef PADDLE_WITH_HIP
+  platform::GpuMemcpyAsync(gpu_packed_ptrs,
+                           packed_ptrs.data(),
+                           ptrs_bytes,
+                           hipMemcpyHostToDevice,
+                           stream);
+  platform::GpuMemcpyAsync(*gpu_lods,
+                           lods.data(),
+                           lods.size() * sizeof(size_t),
+                           hipMemcpyHostToDevice,
+                           stream);
+#else
+  platform::GpuMemcpyAsync(gpu_packed_ptrs,
+                           packed_ptrs.data(),
+                           ptrs_bytes,
+                           cudaMemcpyHostToDevice,
+                           stream);
+  platform::GpuMemcpyAsync(*gpu_lods,
+                           lods.data(),
+                           lods.size() * sizeof(size_t),
+                           cudaMemcpyHostToDevice,
+                           stream);
+#endif
+  gpu_ptrs->clear();
+  for (auto &slot_ptrs : ptrs) {
+    gpu_ptrs->push_back(gpu_packed_ptrs);
+    gpu_packed_ptrs += slot_ptrs.size();
+  }
+  return temp_ptr;
+}
 
-    T val = static_cast<T>(pad_value);
-    for (auto k = start; k < end; ++k) {
-      val += *(input_values[x] + k * embedding_size + offset);
+// The sum pooling of the offset of the embedding of an ins of a slot, with the
+// embedx quantized by quant_ratio when it is positive.
+template <typename T>
+__device__ T SeqpoolSum(const T *input_values,
+                        const size_t *lods,
+                        const int y,
+                        const int embedding_size,
+                        const int offset,
+                        const float pad_value,
+                        const bool quant,
+                        const int quant_ratio) {
+  T val = static_cast<T>(pad_value);
+  for (auto k = lods[y]; k < lods[y + 1]; ++k) {
+    T x = *(input_values + k * embedding_size + offset);
+    if (quant) {
+      x = static_cast<int>(x * quant_ratio + 0.5) / static_cast<T>(quant_ratio);
     }
-    *(seqpool_output_values[x] + y * embedding_size + offset) = val;
+    val += x;
   }
+  return val;
 }
 
-// join need show click input
+// join need show click input, the pooling and the cvm of all the slots
 template <typename T>
-__global__ void FusedCVMKernelWithCVM(const size_t N,
-                                      T **output_values,
-                                      T **seqpool_output_values,
-                                      const int batch_size,
-                                      const int embedding_size,
-                                      const int cvm_offset) {
+__global__ void FusedSeqpoolCVMKernelWithCVM(const size_t N,
+                                             T **input_values,
+                                             T **output_values,
+                                             const size_t *lods_values,
+                                             const int batch_size,
+                                             const int embedding_size,
+                                             const float pad_value,
+                                             const int cvm_offset,
+                                             const int quant_ratio) {
   CUDA_KERNEL_LOOP(i, N) {
     int key = i / embedding_size;
     int offset = i % embedding_size;
     int x = key / batch_size;  // slot id
     int y = key % batch_size;  // ins id
-    if (offset == 0) {         // show
-      *(output_values[x] + y * embedding_size) =
-          log(*(seqpool_output_values[x] + y * embedding_size) + 1);
+    const size_t *lods = lods_values + x * (batch_size + 1);
+    bool quant = quant_ratio > 0 && offset >= cvm_offset;
+    T val = SeqpoolSum(input_values[x],
+                       lods,
+                       y,
+                       embedding_size,
+                       offset,
+                       pad_value,
+                       quant,
+                       quant_ratio);
+    if (offset == 0) {  // show
+      val = log(val + 1);
     } else if (offset == 1) {  // click
-      *(output_values[x] + y * embedding_size + offset) =
-          log(*(seqpool_output_values[x] + y * embedding_size + 1) + 1) -
-          log(*(seqpool_output_values[x] + y * embedding_size) + 1);
-    } else {
-      *(output_values[x] + y * embedding_size + offset) =
-          *(seqpool_output_values[x] + y * embedding_size + offset);
+      T show = SeqpoolSum(input_values[x],
+                          lods,
+                          y,
+                          embedding_size,
+                          0,
+                          pad_value,
+                          false,
+                          quant_ratio);
+      val = log(val + 1) - log(show + 1);
     }
+    *(output_values[x] + y * embedding_size + offset) = val;
   }
 }
 
 // update not need show click input
 template <typename T>
-__global__ void FusedCVMKernelNoCVM(const size_t N,
-                                    T **output_values,
-                                    T **seqpool_output_values,
-                                    const int batch_size,
-                                    const int no_cvm_embedding_size,
-                                    const int cvm_offset) {
+__global__ void FusedSeqpoolCVMKernelNoCVM(const size_t N,
+                                           T **input_values,
+                                           T **output_values,
+                                           const size_t *lods_values,
+                                           const int batch_size,
+                                           const int no_cvm_embedding_size,
+                                           const float pad_value,
+                                           const int cvm_offset,
+                                           const int quant_ratio) {
   CUDA_KERNEL_LOOP(i, N) {
     int key = i / no_cvm_embedding_size;
     int offset = i % no_cvm_embedding_size;
@@ -96,129 +159,78 @@ __global__ void FusedCVMKernelNoCVM(const size_t N,
     int y = key % batch_size;  // ins id
     // no cvm
     *(output_values[x] + y * no_cvm_embedding_size + offset) =
-        *(seqpool_output_values[x] + y * (no_cvm_embedding_size + cvm_offset) +
-          offset + cvm_offset);
+        SeqpoolSum(input_values[x],
+                   lods_values + x * (batch_size + 1),
+                   y,
+                   no_cvm_embedding_size + cvm_offset,
+                   offset + cvm_offset,
+                   pad_value,
+                   quant_ratio > 0,
+                   quant_ratio);
   }
 }
 
 template <typename T>
-void FusedSeqpoolCVM(const framework::ExecutionContext
-                         &ctx,  // const paddle::platform::Place &place,
+void FusedSeqpoolCVM(const framework::ExecutionContext &ctx,
                      const std::vector<const T *> &input_data,
                      const std::vector<T *> &output_data,
-                     const std::vector<T *> &seqpool_output_data,
-                     std::vector<const size_t *> lods,
+                     const std::vector<size_t> &lods,
                      const int batch_size,
                      const int slot_num,
                      const int embedding_size,
                      const float padding_value,
                      const bool use_cvm,
-                     const int cvm_offset) {
+                     const int cvm_offset,
+                     const int quant_ratio) {
   auto stream = ctx.template device_context<phi::GPUContext>().stream();
   auto &dev_ctx = ctx.template device_context<phi::GPUContext>();
-  size_t total_ptr_len = input_data.size() + output_data.size() +
-                         seqpool_output_data.size() + lods.size();
-  auto temp_ptr =
-      memory::AllocShared(ctx.GetPlace(), total_ptr_len * sizeof(void *));
-  void *ptr = temp_ptr->ptr();
-
-#ifdef PADDLE_WITH_HIP
-  T **gpu_input_values = reinterpret_cast<T **>(temp_ptr->ptr());
-  platform::GpuMemcpyAsync(gpu_input_values,
-                           input_data.data(),
-                           input_data.size() * sizeof(T *),
-                           hipMemcpyHostToDevice,
-                           stream);
-  T **gpu_output_values =
-      reinterpret_cast<T **>(&gpu_input_values[input_data.size()]);
-  platform::GpuMemcpyAsync(gpu_output_values,
-                           output_data.data(),
-                           output_data.size() * sizeof(T *),
-                           hipMemcpyHostToDevice,
-                           stream);
-  T **gpu_seqpool_output_values =
-      reinterpret_cast<T **>(&gpu_output_values[output_data.size()]);
-  platform::GpuMemcpyAsync(gpu_seqpool_output_values,
-                           seqpool_output_data.data(),
-                           seqpool_output_data.size() * sizeof(T *),
-                           hipMemcpyHostToDevice,
-                           stream);
-  size_t **lods_values = reinterpret_cast<size_t **>(
-      &gpu_seqpool_output_values[seqpool_output_data.size()]);
-  platform::GpuMemcpyAsync(lods_values,
-                           lods.data(),
-                           lods.size() * sizeof(size_t *),
-                           hipMemcpyHostToDevice,
-                           stream);
-#else
-  T **gpu_input_values = reinterpret_cast<T **>(temp_ptr->ptr());
-  platform::GpuMemcpyAsync(gpu_input_values,
-                           input_data.data(),
-                           input_data.size() * sizeof(T *),
-                           cudaMemcpyHostToDevice,
-                           stream);
-  T **gpu_output_values =
-      reinterpret_cast<T **>(&gpu_input_values[input_data.size()]);
-  platform::GpuMemcpyAsync(gpu_output_values,
-                           output_data.data(),
-                           output_data.size() * sizeof(T *),
-                           cudaMemcpyHostToDevice,
-                           stream);
-  T **gpu_seqpool_output_values =
-      reinterpret_cast<T **>(&gpu_output_values[output_data.size()]);
-  platform::GpuMemcpyAsync(gpu_seqpool_output_values,
-                           seqpool_output_data.data(),
-                           seqpool_output_data.size() * sizeof(T *),
-                           cudaMemcpyHostToDevice,
-                           stream);
-  size_t **lods_values = reinterpret_cast<size_t **>(
-      &gpu_seqpool_output_values[seqpool_output_data.size()]);
-  platform::GpuMemcpyAsync(lods_values,
-                           lods.data(),
-                           lods.size() * sizeof(size_t *),
-                           cudaMemcpyHostToDevice,
-                           stream);
-#endif
-
-  size_t N = static_cast<size_t>(batch_size * slot_num * embedding_size);
-  platform::GpuLaunchConfig config = platform::GetGpuLaunchConfig1D(dev_ctx, N);
-  // first sum pool
-  FusedSeqpoolKernelNormal<<<config.block_per_grid.x,
-                             config.thread_per_block.x,
-                             0,
-                             stream>>>(N,
-                                       gpu_input_values,
-                                       gpu_seqpool_output_values,
-                                       lods_values,
-                                       batch_size,
-                                       embedding_size,
-                                       padding_value);
-  // second log
+  std::vector<T **> gpu_ptrs;
+  size_t *lods_values = nullptr;
+  auto temp_ptr = CopySlotsToDevice<T>(
+      ctx,
+      {input_data,
+       std::vector<const T *>(output_data.begin(), output_data.end())},
+      lods,
+      &gpu_ptrs,
+      &lods_values);
+  T **gpu_input_values = gpu_ptrs[0];
+  T **gpu_output_values = gpu_ptrs[1];
+
+  // the sum pool and the log of all the slots in a launch
   if (use_cvm) {
-    FusedCVMKernelWithCVM<<<config.block_per_grid.x,
-                            config.thread_per_block.x,
-                            0,
-                            stream>>>(N,
-                                      gpu_output_values,
-                                      gpu_seqpool_output_values,
-                                      batch_size,
-                                      embedding_size,
-                                      cvm_offset);
+    size_t N = static_cast<size_t>(batch_size * slot_num * embedding_size);
+    platform::GpuLaunchConfig config =
+        platform::GetGpuLaunchConfig1D(dev_ctx, N);
+    FusedSeqpoolCVMKernelWithCVM<<<config.block_per_grid.x,
+                                   config.thread_per_block.x,
+                                   0,
+                                   stream>>>(N,
+                                             gpu_input_values,
+                                             gpu_output_values,
+                                             lods_values,
+                                             batch_size,
+                                             embedding_size,
+                                             padding_value,
+                                             cvm_offset,
+                                             quant_ratio);
   } else {
     // not need show click input
-    N = static_cast<size_t>(batch_size * slot_num *
-                            (embedding_size - cvm_offset));
+    size_t N = static_cast<size_t>(batch_size * slot_num *
+                                   (embedding_size - cvm_offset));
     platform::GpuLaunchConfig config =
         platform::GetGpuLaunchConfig1D(dev_ctx, N);
-    FusedCVMKernelNoCVM<<<config.block_per_grid.x,
-                          config.thread_per_block.x,
-                          0,
-                          stream>>>(N,
-                                    gpu_output_values,
-                                    gpu_seqpool_output_values,
-                                    batch_size,
-                                    (embedding_size - cvm_offset),
-                                    cvm_offset);
+    FusedSeqpoolCVMKernelNoCVM<<<config.block_per_grid.x,
+                                 config.thread_per_block.x,
+                                 0,
+                                 stream>>>(N,
+                                           gpu_input_values,
+                                           gpu_output_values,
+                                           lods_values,
+                                           batch_size,
+                                           (embedding_size - cvm_offset),
+                                           padding_value,
+                                           cvm_offset,
+                                           quant_ratio);
   }
 }
 
@@ -228,7 +240,7 @@ __global__ void FusedSeqpoolCVMGradKernelWithCVM(const size_t N,
                                                  T **out_grads_values,
                                                  T **in_grads_values,
                                                  T **cvm_values,
-                                                 size_t **lods_values,
+                                                 const size_t *lods_values,
                                                  const int batch_size,
                                                  const int embedding_size,
                                                  const int cvm_offset) {
@@ -242,8 +254,8 @@ __global__ void FusedSeqpoolCVMGradKernelWithCVM(const size_t N,
                  ? *(cvm_values[x] + y * cvm_offset + offset)
                  : *(out_grads_values[x] + y * embedding_size + offset);
 
-    auto &start = *(lods_values[x] + y);
-    auto &end = *(lods_values[x] + y + 1);
+    auto &start = *(lods_values + x * (batch_size + 1) + y);
+    auto &end = *(lods_values + x * (batch_size + 1) + y + 1);
     for (auto k = start; k < end; ++k) {
       *(in_grads_values[x] + k * embedding_size + offset) = val;
     }
@@ -256,7 +268,7 @@ __global__ void FusedSeqpoolCVMGradKernelWithShow(const size_t N,
                                                   T **out_grads_values,
                                                   T **in_grads_values,
                                                   T **cvm_values,
-                                                  size_t **lods_values,
+                                                  const size_t *lods_values,
                                                   const int batch_size,
                                                   const int embedding_size,
                                                   const int cvm_offset) {
@@ -271,8 +283,8 @@ __global__ void FusedSeqpoolCVMGradKernelWithShow(const size_t N,
             ? *(cvm_values[x] + y * cvm_offset + offset)
             : *(out_grads_values[x] + y * (embedding_size - 1) + offset - 1);
 
-    auto &start = *(lods_values[x] + y);
-    auto &end = *(lods_values[x] + y + 1);
+    auto &start = *(lods_values + x * (batch_size + 1) + y);
+    auto &end = *(lods_values + x * (batch_size + 1) + y + 1);
     for (auto k = start; k < end; ++k) {
       *(in_grads_values[x] + k * embedding_size + offset) = val;
     }
@@ -285,7 +297,7 @@ __global__ void FusedSeqpoolCVMGradKernelNoCVM(const size_t N,
                                                T **out_grads_values,
                                                T **in_grads_values,
                                                T **cvm_values,
-                                               size_t **lods_values,
+                                               const size_t *lods_values,
                                                const int batch_size,
                                                const int embedding_size,
                                                const int cvm_offset) {
@@ -300,8 +312,8 @@ __global__ void FusedSeqpoolCVMGradKernelNoCVM(const size_t N,
                  : *(out_grads_values[x] + y * (embedding_size - cvm_offset) +
                      offset - cvm_offset);
 
-    auto &start = *(lods_values[x] + y);
-    auto &end = *(lods_values[x] + y + 1);
+    auto &start = *(lods_values + x * (batch_size + 1) + y);
+    auto &end = *(lods_values + x * (batch_size + 1) + y + 1);
     for (auto k = start; k < end; ++k) {
       *(in_grads_values[x] + k * embedding_size + offset) = val;
     }
@@ -313,7 +325,7 @@ void FusedSeqpoolCVMGrad(const framework::ExecutionContext &ctx,
                          const std::vector<const T *> &out_grads_data,
                          const std::vector<T *> &in_grads_data,
                          const std::vector<const T *> &cvm_data,
-                         const std::vector<const size_t *> &lods,
+                         const std::vector<size_t> &lods,
                          const int batch_size,
                          const int slot_num,
                          const int embedding_size,
@@ -321,73 +333,19 @@ void FusedSeqpoolCVMGrad(const framework::ExecutionContext &ctx,
                          const int cvm_offset) {
   auto stream = ctx.template device_context<phi::GPUContext>().stream();
   auto &dev_ctx = ctx.template device_context<phi::GPUContext>();
-  size_t total_ptr_len = out_grads_data.size() + in_grads_data.size() +
-                         cvm_data.size() + lods.size();
-  auto temp_ptr =
-      memory::AllocShared(ctx.GetPlace(), total_ptr_len * sizeof(void *));
-#ifdef PADDLE_WITH_HIP
-  T **gpu_out_grads_values = reinterpret_cast<T **>(temp_ptr->ptr());
-  platform::GpuMemcpyAsync(gpu_out_grads_values,
-                           out_grads_data.data(),
-                           out_grads_data.size() * sizeof(T *),
-                           hipMemcpyHostToDevice,
-                           stream);
-
-  T **gpu_in_grads_values =
-      reinterpret_cast<T **>(&gpu_out_grads_values[out_grads_data.size()]);
-  platform::GpuMemcpyAsync(gpu_in_grads_values,
-                           in_grads_data.data(),
-                           in_grads_data.size() * sizeof(T *),
-                           hipMemcpyHostToDevice,
-                           stream);
-
-  T **gpu_cvm_values =
-      reinterpret_cast<T **>(&gpu_in_grads_values[in_grads_data.size()]);
-  platform::GpuMemcpyAsync(gpu_cvm_values,
-                           cvm_data.data(),
-                           cvm_data.size() * sizeof(T *),
-                           hipMemcpyHostToDevice,
-                           stream);
-
-  size_t **lods_values =
-      reinterpret_cast<size_t **>(&gpu_cvm_values[cvm_data.size()]);
-  platform::GpuMemcpyAsync(lods_values,
-                           lods.data(),
-                           lods.size() * sizeof(size_t *),
-                           hipMemcpyHostToDevice,
-                           stream);
-#else
-  T **gpu_out_grads_values = reinterpret_cast<T **>(temp_ptr->ptr());
-  platform::GpuMemcpyAsync(gpu_out_grads_values,
-                           out_grads_data.data(),
-                           out_grads_data.size() * sizeof(T *),
-                           cudaMemcpyHostToDevice,
-                           stream);
-
-  T **gpu_in_grads_values =
-      reinterpret_cast<T **>(&gpu_out_grads_values[out_grads_data.size()]);
-  platform::GpuMemcpyAsync(gpu_in_grads_values,
-                           in_grads_data.data(),
-                           in_grads_data.size() * sizeof(T *),
-                           cudaMemcpyHostToDevice,
-                           stream);
-
-  T **gpu_cvm_values =
-      reinterpret_cast<T **>(&gpu_in_grads_values[in_grads_data.size()]);
-  platform::GpuMemcpyAsync(gpu_cvm_values,
-                           cvm_data.data(),
-                           cvm_data.size() * sizeof(T *),
-                           cudaMemcpyHostToDevice,
-                           stream);
-
-  size_t **lods_values =
-      reinterpret_cast<size_t **>(&gpu_cvm_values[cvm_data.size()]);
-  platform::GpuMemcpyAsync(lods_values,
-                           lods.data(),
-                           lods.size() * sizeof(size_t *),
-                           cudaMemcpyHostToDevice,
-                           stream);
-#endif
+  std::vector<T **> gpu_ptrs;
+  size_t *lods_values = nullptr;
+  auto temp_ptr = CopySlotsToDevice<T>(
+      ctx,
+      {out_grads_data,
+       std::vector<const T *>(in_grads_data.begin(), in_grads_data.end()),
+       cvm_data},
+      lods,
+      &gpu_ptrs,
+      &lods_values);
+  T **gpu_out_grads_values = gpu_ptrs[0];
+  T **gpu_in_grads_values = gpu_ptrs[1];
+  T **gpu_cvm_values = gpu_ptrs[2];
 
   size_t N = static_cast<size_t>(batch_size * slot_num * embedding_size);
   auto config = platform::GetGpuLaunchConfig1D(dev_ctx, N);
@@ -428,32 +386,28 @@ class FusedSeqpoolCVMCUDAKernel : public framework::OpKernel<T> {
     auto outputs = ctx.MultiOutput<phi::DenseTensor>("Out");
     auto &dev_ctx = ctx.template device_context<phi::GPUContext>();
     const auto slot_size = inputs.size();
-    std::vector<const float *> input_data(slot_size);
-    std::vector<const size_t *> lods_data(slot_size);
+    std::vector<const T *> input_data(slot_size);
     std::vector<T *> output_data(slot_size);
 
-    std::vector<phi::DenseTensor> seqpool_outputs(slot_size);
-    std::vector<T *> seqpool_output_data(slot_size);
-
     auto padding_value = ctx.Attr<float>("pad_value");
     auto use_cvm = ctx.Attr<bool>("use_cvm");
     const int cvm_offset = ctx.Attr<int>("cvm_offset");
+    const int quant_ratio = ctx.Attr<int>("quant_ratio");
 
     int embedding_size = inputs[0]->numel() / inputs[0]->dims()[0];
     int batch_size = -1;
-    std::vector<phi::MixVector<size_t> *> mix_lods_v(slot_size);
+    // the lods of all the slots, packed by slot
+    std::vector<size_t> lods;
 
     for (size_t i = 0; i < slot_size; ++i) {
       const auto *input = inputs[i];
 
-      Vector<size_t> lods;
       if (input->lod().size() != 0) {
-        auto lod = input->lod();
-        lods = lod[0];
+        auto &lod = input->lod()[0];
+        lods.insert(lods.end(), lod.begin(), lod.end());
       } else {
-        lods.push_back(0);
-        for (int i = 0; i < input->dims()[0]; i++) {
-          lods.push_back(i + 1);
+        for (int i = 0; i <= input->dims()[0]; i++) {
+          lods.push_back(i);
         }
       }
       int cur_batch_size =
@@ -480,28 +434,19 @@ class FusedSeqpoolCVMCUDAKernel : public framework::OpKernel<T> {
       }
       output_data[i] = reinterpret_cast<T *>(
           dev_ctx.Alloc<T>(output, output->numel() * sizeof(T)));
-      mix_lods_v[i] = new phi::MixVector<size_t>(&lods);
-      lods_data[i] = mix_lods_v[i]->CUDAData(ctx.GetPlace());
-      seqpool_outputs[i].Resize({batch_size, embedding_size});
-      seqpool_output_data[i] = reinterpret_cast<T *>(dev_ctx.Alloc<T>(
-          &seqpool_outputs[i], seqpool_outputs[i].numel() * sizeof(T)));
     }
 
     FusedSeqpoolCVM(ctx,
                     input_data,
                     output_data,
-                    seqpool_output_data,
-                    lods_data,
+                    lods,
                     batch_size,
                     slot_size,
                     embedding_size,
                     padding_value,
                     use_cvm,
-                    cvm_offset);
-
-    for (int i = 0; i < slot_size; i++) {
-      delete mix_lods_v[i];
-    }
+                    cvm_offset,
+                    quant_ratio);
   }
 };
 
@@ -523,23 +468,21 @@ class FusedSeqpoolCVMGradCUDAKernel : public framework::OpKernel<T> {
     std::vector<const T *> out_grads_data(slot_size);
     std::vector<T *> in_grads_data(slot_size);
     std::vector<const T *> cvm_data(slot_size);
-    std::vector<const size_t *> lods_data(slot_size);
 
     int embedding_size = in_grads[0]->numel() / in_grads[0]->dims()[0];
     int batch_size = -1;
-    std::vector<phi::MixVector<size_t> *> mix_lods_v(slot_size);
+    // the lods of all the slots, packed by slot
+    std::vector<size_t> lods;
 
     for (size_t i = 0; i < slot_size; ++i) {
       auto *in_grad = in_grads[i];
 
-      Vector<size_t> lods;
       if (in_grad->lod().size() != 0) {
-        auto lod = in_grad->lod();
-        lods = lod[0];
+        auto &lod = in_grad->lod()[0];
+        lods.insert(lods.end(), lod.begin(), lod.end());
       } else {
-        lods.push_back(0);
-        for (int i = 0; i < in_grad->dims()[0]; i++) {
-          lods.push_back(i + 1);
+        for (int i = 0; i <= in_grad->dims()[0]; i++) {
+          lods.push_back(i);
         }
       }
 
@@ -563,24 +506,18 @@ class FusedSeqpoolCVMGradCUDAKernel : public framework::OpKernel<T> {
 
       in_grads_data[i] = reinterpret_cast<T *>(
           dev_ctx.Alloc<T>(in_grad, in_grad->numel() * sizeof(T)));
-      mix_lods_v[i] = new phi::MixVector<size_t>(&lods);
-      lods_data[i] = mix_lods_v[i]->CUDAData(ctx.GetPlace());
       cvm_data[i] = reinterpret_cast<const T *>(cvm->data<T>());
     }
     FusedSeqpoolCVMGrad(ctx,
                         out_grads_data,
                         in_grads_data,
                         cvm_data,
-                        lods_data,
+                        lods,
                         batch_size,
                         slot_size,
                         embedding_size,
                         use_cvm,
                         cvm_offset);
-
-    for (int i = 0; i < slot_size; i++) {
-      delete mix_lods_v[i];
-    }
   }
 };
 
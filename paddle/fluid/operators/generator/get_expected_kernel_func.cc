@@ -316,6 +316,14 @@ phi::KernelKey GetUpdateLossScalingExpectedKernelType(
 phi::KernelKey GetMatrixNmsExpectedKernelType(
     const framework::ExecutionContext& ctx,
     const framework::OperatorWithKernel* op_ptr) {
+  // The matrix nms of the whole batch runs on the cuda device, and on the cpu
+  // otherwise.
+#if defined(PADDLE_WITH_CUDA)
+  if (platform::is_gpu_place(ctx.GetPlace())) {
+    return phi::KernelKey(op_ptr->IndicateVarDataType(ctx, "Scores"),
+                          ctx.GetPlace());
+  }
+#endif
   return phi::KernelKey(op_ptr->IndicateVarDataType(ctx, "Scores"),
                         platform::CPUPlace());
 }
@@ -84,7 +84,12 @@ class LiteEngineOp : public framework::OperatorBase {
       paddle::lite_api::Tensor dst_t = *(engine_->GetInput(i));
       VLOG(3) << "== fluid -> lite (" << in_names_[i] << " -> "
               << engine_->GetInputNames()[i] << ")";
-      inference::lite::utils::TensorCopy(&dst_t, &src_t, *ctx, zero_copy_);
+      // The lite engine only reads the inputs in Run, and the copy keeps the
+      // place of the input as well, so the CPU inputs are always shared. The
+      // outputs are reused by the engine in the next Run, they are shared
+      // only with zero_copy.
+      bool share_input = zero_copy_ || platform::is_cpu_place(src_t.place());
+      inference::lite::utils::TensorCopy(&dst_t, &src_t, *ctx, share_input);
     }
     VLOG(3) << "lite engine run";
     engine_->Run();
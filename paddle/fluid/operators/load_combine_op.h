@@ -18,13 +18,18 @@ limitations under the License. */
 #include <string>
 #include <vector>
 
+#include "paddle/fluid/framework/combined_params_loader.h"
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/data_type_transform.h"
+#include "paddle/fluid/framework/mmap_params.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/string_array.h"
 #include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/platform/device_context.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_int32(load_combine_num_threads);
 
 namespace paddle {
 namespace operators {
@@ -44,7 +49,13 @@ class LoadCombineOpKernel : public framework::OpKernel<T> {
                           "The number of variables to be loaded is %d, expect "
                           "it to be greater than 0.",
                           out_var_names.size()));
-    if (!model_from_memory) {
+    if (!model_from_memory && framework::IsMmapParamsFile(filename)) {
+      LoadParamsFromMmapFile(ctx, place, filename, load_as_fp16, out_var_names);
+    } else if (!model_from_memory && FLAGS_load_combine_num_threads > 1 &&
+               framework::CanLoadCombinedParamsInParallel(place) &&
+               !HasVocab(ctx)) {
+      LoadParamsInParallel(ctx, place, filename, load_as_fp16, out_var_names);
+    } else if (!model_from_memory) {
       std::ifstream fin(filename, std::ios::binary);
       PADDLE_ENFORCE_EQ(
           static_cast<bool>(fin),
@@ -116,26 +127,8 @@ class LoadCombineOpKernel : public framework::OpKernel<T> {
         // Get data from fin to tensor
         paddle::framework::DeserializeFromStream(*buffer, tensor, dev_ctx);
 
-        auto in_dtype = tensor->dtype();
-        auto out_dtype = load_as_fp16 ? phi::DataType::FLOAT16 : in_dtype;
-
-        if (in_dtype != out_dtype) {
-          // convert to float16 tensor
-          auto in_kernel_type =
-              phi::KernelKey(place, phi::DataLayout::ALL_LAYOUT, in_dtype);
-          auto out_kernel_type =
-              phi::KernelKey(place, phi::DataLayout::ALL_LAYOUT, out_dtype);
-          phi::DenseTensor fp16_tensor;
-          // copy LoD info to the new tensor
-          fp16_tensor.set_lod(tensor->lod());
-          framework::TransDataType(
-              in_kernel_type, out_kernel_type, *tensor, &fp16_tensor);
-
-          // reset output tensor
-          out_vars[i]->Clear();
-          tensor = out_vars[i]->GetMutable<phi::DenseTensor>();
-          tensor->set_lod(fp16_tensor.lod());
-          tensor->ShareDataWith(fp16_tensor);
+        if (load_as_fp16) {
+          CastToFp16(place, out_vars[i]);
         }
       }
     }
@@ -146,6 +139,104 @@ class LoadCombineOpKernel : public framework::OpKernel<T> {
                           "Not allowed to load partial data via "
                           "load_combine_op, please use load_op instead."));
   }
+
+  bool HasVocab(const framework::ExecutionContext &context) const {
+    for (auto *var : context.MultiOutputVar("Out")) {
+      if (var != nullptr && var->IsType<framework::Vocab>()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void LoadParamsInParallel(
+      const framework::ExecutionContext &context,
+      const platform::Place &place,
+      const std::string &filename,
+      bool load_as_fp16,
+      const std::vector<std::string> &out_var_names) const {
+    auto out_vars = context.MultiOutputVar("Out");
+    std::vector<phi::DenseTensor *> tensors;
+    for (size_t i = 0; i < out_var_names.size(); i++) {
+      PADDLE_ENFORCE_NOT_NULL(
+          out_vars[i],
+          platform::errors::InvalidArgument(
+              "The variable %s to be loaded cannot be found.",
+              out_var_names[i]));
+      tensors.push_back(out_vars[i]->GetMutable<phi::DenseTensor>());
+    }
+    framework::LoadCombinedParams(
+        filename, tensors, place, FLAGS_load_combine_num_threads);
+    if (load_as_fp16) {
+      for (auto *out_var : out_vars) {
+        CastToFp16(place, out_var);
+      }
+    }
+  }
+
+  // The params of the mmap format are bound to the mapped file on CPU, and
+  // copied to place if it is not CPU.
+  void LoadParamsFromMmapFile(
+      const framework::ExecutionContext &context,
+      const platform::Place &place,
+      const std::string &filename,
+      bool load_as_fp16,
+      const std::vector<std::string> &out_var_names) const {
+    auto out_vars = context.MultiOutputVar("Out");
+    std::vector<phi::DenseTensor *> tensors;
+    for (size_t i = 0; i < out_var_names.size(); i++) {
+      PADDLE_ENFORCE_NOT_NULL(
+          out_vars[i],
+          platform::errors::InvalidArgument(
+              "The variable %s to be loaded cannot be found.",
+              out_var_names[i]));
+      PADDLE_ENFORCE_EQ(out_vars[i]->IsType<framework::Vocab>(),
+                        false,
+                        platform::errors::Unimplemented(
+                            "The vocab %s cannot be loaded from the params "
+                            "file of the mmap format.",
+                            out_var_names[i]));
+      tensors.push_back(out_vars[i]->GetMutable<phi::DenseTensor>());
+    }
+    framework::LoadMmapParams(filename, out_var_names, tensors);
+
+    for (size_t i = 0; i < out_var_names.size(); i++) {
+      if (!platform::is_cpu_place(place)) {
+        phi::DenseTensor device_tensor;
+        framework::TensorCopySync(*tensors[i], place, &device_tensor);
+        tensors[i]->ShareDataWith(device_tensor);
+      }
+      if (load_as_fp16) {
+        CastToFp16(place, out_vars[i]);
+      }
+    }
+  }
+
+  void CastToFp16(const platform::Place &place,
+                  framework::Variable *out_var) const {
+    auto *tensor = out_var->GetMutable<phi::DenseTensor>();
+    auto in_dtype = tensor->dtype();
+    auto out_dtype = phi::DataType::FLOAT16;
+    if (in_dtype == out_dtype) {
+      return;
+    }
+    // convert to float16 tensor
+    auto in_kernel_type =
+        phi::KernelKey(place, phi::DataLayout::ALL_LAYOUT, in_dtype);
+    auto out_kernel_type =
+        phi::KernelKey(place, phi::DataLayout::ALL_LAYOUT, out_dtype);
+    phi::DenseTensor fp16_tensor;
+    // copy LoD info to the new tensor
+    fp16_tensor.set_lod(tensor->lod());
+    framework::TransDataType(
+        in_kernel_type, out_kernel_type, *tensor, &fp16_tensor);
+
+    // reset output tensor
+    out_var->Clear();
+    tensor = out_var->GetMutable<phi::DenseTensor>();
+    tensor->set_lod(fp16_tensor.lod());
+    tensor->ShareDataWith(fp16_tensor);
+  }
 };
 
 }  // namespace operators
@@ -12,7 +12,264 @@
   See the License for the specific language governing permissions and
   limitations under the License. */
 
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <tuple>
+#include <unordered_map>
+
 #include "paddle/fluid/operators/pscore/distributed_lookup_table_op.h"
+#include "paddle/phi/core/flags.h"
+#include "paddle/phi/kernels/funcs/gather.cu.h"
+#include "paddle/phi/kernels/funcs/scatter.cu.h"
+
+PHI_DECLARE_int64(ps_gpu_embedding_cache_capacity);
+PHI_DECLARE_int32(ps_gpu_embedding_cache_max_staleness_pulls);
+
+namespace paddle {
+namespace operators {
+
+// GPUEmbeddingCache keeps the rows of at most capacity keys of a sparse table
+// in the GPU memory. A lookup pulls only the missing and the stale rows from
+// the pservers, scatters them to the free or the least recently used slots,
+// and gathers the rows of all the ids on the GPU. A cached row serves at most
+// FLAGS_ps_gpu_embedding_cache_max_staleness_pulls lookups, then it is pulled
+// again, so that it follows the pushes of the trainers.
+class GPUEmbeddingCache {
+ public:
+  GPUEmbeddingCache(const phi::GPUContext &dev_ctx,
+                    int64_t capacity,
+                    int64_t emb_dim)
+      : _capacity(capacity), _emb_dim(emb_dim) {
+    // the last row is the zero row of the padding id
+    _rows.Resize(common::make_ddim({capacity + 1, emb_dim}));
+    dev_ctx.Alloc<float>(&_rows);
+    phi::funcs::SetConstant<phi::GPUContext, float>()(
+        dev_ctx, &_rows, static_cast<float>(0));
+    _free_slots.reserve(capacity);
+    for (int64_t slot = capacity - 1; slot >= 0; --slot) {
+      _free_slots.push_back(slot);
+    }
+  }
+
+  int64_t Capacity() const { return _capacity; }
+  int64_t EmbDim() const { return _emb_dim; }
+  std::mutex &Mutex() { return _mutex; }
+
+  // Looks up the rows of the ids on the cpu to out on the GPU, returns false
+  // without a change if the ids have more distinct keys than the capacity.
+  bool Lookup(const phi::GPUContext &dev_ctx,
+              uint64_t table_id,
+              uint64_t padding_id,
+              bool is_training,
+              const phi::DenseTensor &cpu_ids,
+              phi::DenseTensor *out) {
+    const int64_t *ids = cpu_ids.data<int64_t>();
+    int64_t num = cpu_ids.numel();
+    std::unordered_map<uint64_t, int64_t> batch_slots;
+    for (int64_t i = 0; i < num; ++i) {
+      uint64_t key = static_cast<uint64_t>(ids[i]);
+      if (key != padding_id) {
+        batch_slots.emplace(key, -1);
+      }
+    }
+    if (static_cast<int64_t>(batch_slots.size()) > _capacity) {
+      return false;
+    }
+
+    ++_step;
+    uint32_t max_hits = static_cast<uint32_t>(
+        std::max(FLAGS_ps_gpu_embedding_cache_max_staleness_pulls, 1));
+    std::vector<int64_t> pull_keys;
+    std::vector<int64_t> pull_slots;
+    std::vector<uint64_t> new_keys;
+    // the cached keys are touched first, so that they are at the front of
+    // _lru before the new keys evict from its back
+    for (auto &item : batch_slots) {
+      auto it = _index.find(item.first);
+      if (it == _index.end()) {
+        new_keys.push_back(item.first);
+        continue;
+      }
+      Entry &entry = it->second;
+      _lru.splice(_lru.begin(), _lru, entry.lru);
+      entry.step = _step;
+      if (entry.hits >= max_hits) {
+        entry.hits = 0;
+        pull_keys.push_back(static_cast<int64_t>(item.first));
+        pull_slots.push_back(entry.slot);
+      }
+      ++entry.hits;
+      item.second = entry.slot;
+    }
+    for (auto key : new_keys) {
+      int64_t slot = 0;
+      if (!_free_slots.empty()) {
+        slot = _free_slots.back();
+        _free_slots.pop_back();
+      } else {
+        auto evicted = _index.find(_lru.back());
+        slot = evicted->second.slot;
+        _index.erase(evicted);
+        _lru.pop_back();
+      }
+      _lru.push_front(key);
+      _index[key] = Entry{slot, 1, _step, _lru.begin()};
+      pull_keys.push_back(static_cast<int64_t>(key));
+      pull_slots.push_back(slot);
+      batch_slots[key] = slot;
+    }
+
+    if (!pull_keys.empty()) {
+      Pull(dev_ctx, table_id, padding_id, is_training, pull_keys, pull_slots);
+    }
+
+    phi::DenseTensor cpu_slots;
+    cpu_slots.Resize(common::make_ddim({num}));
+    int64_t *slots = cpu_slots.mutable_data<int64_t>(platform::CPUPlace());
+    for (int64_t i = 0; i < num; ++i) {
+      uint64_t key = static_cast<uint64_t>(ids[i]);
+      slots[i] = key == padding_id ? _capacity : batch_slots[key];
+    }
+    phi::DenseTensor gpu_slots;
+    framework::TensorCopy(cpu_slots, dev_ctx.GetPlace(), dev_ctx, &gpu_slots);
+    out->Resize(common::make_ddim({num, _emb_dim}));
+    out->set_lod(cpu_ids.lod());
+    dev_ctx.Alloc<float>(out);
+    phi::funcs::GPUGather<float, int64_t>(dev_ctx, _rows, gpu_slots, out);
+    return true;
+  }
+
+ private:
+  struct Entry {
+    int64_t slot;
+    uint32_t hits;
+    uint64_t step;
+    std::list<uint64_t>::iterator lru;
+  };
+
+  // pulls the rows of keys from the pservers to their slots
+  void Pull(const phi::GPUContext &dev_ctx,
+            uint64_t table_id,
+            uint64_t padding_id,
+            bool is_training,
+            const std::vector<int64_t> &keys,
+            const std::vector<int64_t> &slots) {
+    int64_t num = static_cast<int64_t>(keys.size());
+    phi::DenseTensor cpu_keys;
+    cpu_keys.Resize(common::make_ddim({num, 1}));
+    std::copy(keys.begin(),
+              keys.end(),
+              cpu_keys.mutable_data<int64_t>(platform::CPUPlace()));
+    phi::DenseTensor cpu_rows;
+    cpu_rows.Resize(common::make_ddim({num, _emb_dim}));
+    std::vector<const phi::DenseTensor *> inputs = {&cpu_keys};
+    std::vector<phi::DenseTensor *> outputs = {&cpu_rows};
+    distributed::FleetWrapper::GetInstance()->PullSparseToTensorSync(
+        table_id,
+        _emb_dim,
+        padding_id,
+        platform::CPUPlace(),
+        is_training,
+        &inputs,
+        &outputs);
+
+    phi::DenseTensor cpu_slots;
+    cpu_slots.Resize(common::make_ddim({num}));
+    std::copy(slots.begin(),
+              slots.end(),
+              cpu_slots.mutable_data<int64_t>(platform::CPUPlace()));
+    phi::DenseTensor gpu_rows;
+    phi::DenseTensor gpu_slots;
+    framework::TensorCopy(cpu_rows, dev_ctx.GetPlace(), dev_ctx, &gpu_rows);
+    framework::TensorCopy(cpu_slots, dev_ctx.GetPlace(), dev_ctx, &gpu_slots);
+    phi::funcs::GPUScatterAssign<float, int64_t>(
+        dev_ctx, gpu_rows, gpu_slots, &_rows);
+  }
+
+  int64_t _capacity;
+  int64_t _emb_dim;
+  uint64_t _step = 0;
+  std::mutex _mutex;
+  phi::DenseTensor _rows;
+  std::vector<int64_t> _free_slots;
+  // the keys from the most to the least recently used
+  std::list<uint64_t> _lru;
+  std::unordered_map<uint64_t, Entry> _index;
+};
+
+template <typename T, typename DeviceContext>
+class DistributedLookupTableCUDAKernel
+    : public DistributedLookupTableKernel<T, DeviceContext> {
+ public:
+  void Compute(const framework::ExecutionContext &context) const override {
+    int64_t capacity = FLAGS_ps_gpu_embedding_cache_capacity;
+    auto inputs = context.MultiInput<phi::DenseTensor>("Ids");
+    auto outputs = context.MultiOutput<phi::DenseTensor>("Outputs");
+    if (capacity <= 0 || inputs.size() != outputs.size()) {
+      DistributedLookupTableKernel<T, DeviceContext>::Compute(context);
+      return;
+    }
+
+    auto padding_idx = static_cast<uint64_t>(
+        context.Attr<int64_t>("padding_idx"));
+    auto table_id = static_cast<uint64_t>(context.Attr<int>("table_id"));
+    bool is_test = context.Attr<bool>("is_test");
+    int64_t emb_dim = GetLookupTableEmbDim(context);
+    auto &dev_ctx = context.template device_context<phi::GPUContext>();
+    auto *cache = GetCache(dev_ctx, table_id, capacity, emb_dim);
+
+    std::lock_guard<std::mutex> lock(cache->Mutex());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      phi::DenseTensor cpu_ids;
+      framework::TensorCopySync(*inputs[i], platform::CPUPlace(), &cpu_ids);
+      if (cache->Lookup(
+              dev_ctx, table_id, padding_idx, !is_test, cpu_ids, outputs[i])) {
+        continue;
+      }
+      // the ids do not fit in the cache, they are pulled to the cpu
+      phi::DenseTensor cpu_out;
+      cpu_out.Resize(common::make_ddim({cpu_ids.numel(), emb_dim}));
+      std::vector<const phi::DenseTensor *> cpu_inputs = {&cpu_ids};
+      std::vector<phi::DenseTensor *> cpu_outputs = {&cpu_out};
+      distributed::FleetWrapper::GetInstance()->PullSparseToTensorSync(
+          table_id,
+          emb_dim,
+          padding_idx,
+          platform::CPUPlace(),
+          !is_test,
+          &cpu_inputs,
+          &cpu_outputs);
+      framework::TensorCopy(cpu_out, context.GetPlace(), dev_ctx, outputs[i]);
+    }
+    ResizeLookupTableV2Outputs(context, emb_dim);
+  }
+
+ private:
+  // a cache of the table for every stream, so that the slots of the rows
+  // are not reused while another stream gathers them
+  static GPUEmbeddingCache *GetCache(const phi::GPUContext &dev_ctx,
+                                     uint64_t table_id,
+                                     int64_t capacity,
+                                     int64_t emb_dim) {
+    using CacheKey = std::tuple<uint64_t, int, const void *>;
+    static std::mutex mutex;
+    static std::map<CacheKey, std::unique_ptr<GPUEmbeddingCache>> caches;
+    std::lock_guard<std::mutex> lock(mutex);
+    CacheKey key{table_id,
+                 dev_ctx.GetPlace().GetDeviceId(),
+                 static_cast<const void *>(dev_ctx.stream())};
+    auto &cache = caches[key];
+    if (!cache || cache->Capacity() != capacity || cache->EmbDim() != emb_dim) {
+      cache = std::make_unique<GPUEmbeddingCache>(dev_ctx, capacity, emb_dim);
+    }
+    return cache.get();
+  }
+};
+
+}  // namespace operators
+}  // namespace paddle
 
 namespace ops = paddle::operators;
 namespace plat = paddle::platform;
@@ -20,5 +277,5 @@ namespace plat = paddle::platform;
 PD_REGISTER_STRUCT_KERNEL(distributed_lookup_table,
                           GPU,
                           ALL_LAYOUT,
-                          ops::DistributedLookupTableKernel,
+                          ops::DistributedLookupTableCUDAKernel,
                           float) {}
@@ -23,6 +23,42 @@
 namespace paddle {
 namespace operators {
 
+inline int64_t GetLookupTableEmbDim(
+    const framework::ExecutionContext &context) {
+  auto *var = context.InputVar("W");
+  if (var->IsType<phi::DenseTensor>()) {
+    return var->Get<phi::DenseTensor>().dims()[1];
+  } else if (var->IsType<phi::SelectedRows>()) {
+    return var->Get<phi::SelectedRows>().value().dims()[1];
+  }
+  PADDLE_THROW(platform::errors::InvalidArgument(
+      "Expected type of `W` must be Tensor, SelectedRows.But got "
+      "unsupport type: %s.",
+      framework::ToTypeName(var->Type())));
+}
+
+// lookup_table_v2 looks up the ids of [N, L] to the outputs of
+// [N, L, emb_dim]
+inline void ResizeLookupTableV2Outputs(
+    const framework::ExecutionContext &context, int64_t emb_dim) {
+  auto lookup_table_version =
+      context.Attr<std::string>("lookup_table_version");
+  auto id_vars = context.MultiInputVar("Ids");
+  auto out_vars = context.MultiOutputVar("Outputs");
+
+  if (lookup_table_version == "lookup_table_v2") {
+    for (size_t i = 0; i < id_vars.size(); ++i) {
+      auto *id_tensor = id_vars[i]->GetMutable<phi::DenseTensor>();
+      auto *out_tensor = out_vars[i]->GetMutable<phi::DenseTensor>();
+
+      auto id_dims = common::vectorize<int64_t>(id_tensor->dims());
+      out_tensor->Resize(common::make_ddim({static_cast<int64_t>(id_dims[0]),
+                                            static_cast<int64_t>(id_dims[1]),
+                                            static_cast<int64_t>(emb_dim)}));
+    }
+  }
+}
+
 template <typename T, typename DeviceContext>
 class DistributedLookupTableKernel : public framework::OpKernel<T> {
  public:
@@ -30,20 +66,7 @@ class DistributedLookupTableKernel : public framework::OpKernel<T> {
     auto padding_idx = context.Attr<int64_t>("padding_idx");
     auto table_id = context.Attr<int>("table_id");
     bool is_test = context.Attr<bool>("is_test");
-
-    auto *var = context.InputVar("W");
-    int64_t emb_dim = 0;
-
-    if (var->IsType<phi::DenseTensor>()) {
-      emb_dim = var->Get<phi::DenseTensor>().dims()[1];
-    } else if (var->IsType<phi::SelectedRows>()) {
-      emb_dim = var->Get<phi::SelectedRows>().value().dims()[1];
-    } else {
-      PADDLE_THROW(platform::errors::InvalidArgument(
-          "Expected type of `W` must be Tensor, SelectedRows.But got "
-          "unsupport type: %s.",
-          framework::ToTypeName(var->Type())));
-    }
+    int64_t emb_dim = GetLookupTableEmbDim(context);
 
     auto inputs = context.MultiInput<phi::DenseTensor>("Ids");
     auto outputs = context.MultiOutput<phi::DenseTensor>("Outputs");
@@ -109,22 +132,7 @@ class DistributedLookupTableKernel : public framework::OpKernel<T> {
       }
     }
 
-    auto lookup_table_version =
-        context.Attr<std::string>("lookup_table_version");
-    auto id_vars = context.MultiInputVar("Ids");
-    auto out_vars = context.MultiOutputVar("Outputs");
-
-    if (lookup_table_version == "lookup_table_v2") {
-      for (size_t i = 0; i < id_vars.size(); ++i) {
-        auto *id_tensor = id_vars[i]->GetMutable<phi::DenseTensor>();
-        auto *out_tensor = out_vars[i]->GetMutable<phi::DenseTensor>();
-
-        auto id_dims = common::vectorize<int64_t>(id_tensor->dims());
-        out_tensor->Resize(common::make_ddim({static_cast<int64_t>(id_dims[0]),
-                                              static_cast<int64_t>(id_dims[1]),
-                                              static_cast<int64_t>(emb_dim)}));
-      }
-    }
+    ResizeLookupTableV2Outputs(context, emb_dim);
   }
 };
 
@@ -16,12 +16,14 @@ limitations under the License. */
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <fstream>
 #include <numeric>
 #include <sstream>
 #include <string>
 #include <unordered_map>
 
+#include "paddle/fluid/framework/combined_params_saver.h"
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/data_type_transform.h"
@@ -32,6 +34,9 @@ limitations under the License. */
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/phi/backends/dynload/port.h"
 #include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_int32(save_combine_num_threads);
 
 namespace paddle {
 namespace operators {
@@ -81,27 +86,55 @@ void SaveCombineTensorKernel(const Context& dev_ctx,
         overwrite));
   }
 
-  std::ostringstream ss;
   PADDLE_ENFORCE_GT(x.size(),
                     0UL,
                     phi::errors::InvalidArgument(
                         "The number of variables to be saved is %d, expect "
                         "it to be greater than 0.",
                         x.size()));
-
   for (size_t i = 0; i < x.size(); i++) {
-    auto& tensor = *(x[i]);
     PADDLE_ENFORCE_EQ(
-        tensor.IsInitialized(),
+        x[i]->IsInitialized(),
         true,
         phi::errors::InvalidArgument(
             "The Tensor with Index (%d) to be saved is not initialized.", i));
+  }
+
+  auto place = dev_ctx.GetPlace();
+  if (!save_to_memory && !save_as_fp16 && FLAGS_save_combine_num_threads > 1 &&
+      framework::CanSaveCombinedParamsInParallel(place) &&
+      std::all_of(x.begin(), x.end(), [&](const phi::DenseTensor* tensor) {
+        return tensor->place() == place;
+      })) {
+    MkDirRecursively(DirName(file_path).c_str());
+    // the threads copy the tensors from the device on streams of their own
+    dev_ctx.Wait();
+    framework::SaveCombinedParams(
+        file_path, x, place, FLAGS_save_combine_num_threads);
+    return;
+  }
+
+  std::ofstream fout;
+  std::ostringstream ss;
+  if (!save_to_memory) {
+    // the tensors are written to the file directly instead of through a copy
+    // of the whole file in memory
+    MkDirRecursively(DirName(file_path).c_str());
+    fout.open(file_path, std::ios::binary);
+    PADDLE_ENFORCE_EQ(static_cast<bool>(fout),
+                      true,
+                      phi::errors::Unavailable(
+                          "Cannot open %s to save variables.", file_path));
+  }
+  std::ostream& os = save_to_memory ? static_cast<std::ostream&>(ss) : fout;
+
+  for (size_t i = 0; i < x.size(); i++) {
+    auto& tensor = *(x[i]);
     // Serialize tensors one by one
     // Check types to see if a fp16 transformation is required
     auto in_dtype = tensor.dtype();
     auto out_dtype = save_as_fp16 ? phi::DataType::FLOAT16 : in_dtype;
     if (in_dtype != out_dtype) {
-      auto place = dev_ctx.GetPlace();
       auto in_kernel_type =
           phi::KernelKey(place, phi::DataLayout::ALL_LAYOUT, in_dtype);
       auto out_kernel_type =
@@ -110,13 +143,21 @@ void SaveCombineTensorKernel(const Context& dev_ctx,
       framework::TransDataType(in_kernel_type, out_kernel_type, tensor, &out);
       // copy LoD info to the new tensor
       out.set_lod(tensor.lod());
-      framework::SerializeToStream(ss, out, dev_ctx);
+      framework::SerializeToStream(os, out, dev_ctx);
     } else {
-      framework::SerializeToStream(ss, tensor, dev_ctx);
+      framework::SerializeToStream(os, tensor, dev_ctx);
     }
   }
 
-  SaveToMemory(file_path, ss, save_to_memory, y);
+  if (save_to_memory) {
+    SaveToMemory(file_path, ss, save_to_memory, y);
+  } else {
+    fout.close();
+    PADDLE_ENFORCE_EQ(static_cast<bool>(fout),
+                      true,
+                      phi::errors::Unavailable(
+                          "Failed to save variables to %s.", file_path));
+  }
 }
 
 template <typename T, typename Context>
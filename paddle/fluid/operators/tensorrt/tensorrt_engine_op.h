@@ -15,7 +15,10 @@
 #pragma once
 
 #ifdef PADDLE_WITH_CUDA
+#include <chrono>  // NOLINT
 #include <cstdint>
+#include <future>  // NOLINT
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -170,6 +173,11 @@ class TensorRTEngineOp : public framework::OperatorBase {
   int predictor_id_;
   int device_id_;
   bool allow_build_at_runtime_{false};
+  // Build the engine with an extra profile for the shapes out of its
+  // profiles on a background thread, running the subgraph by paddle in the
+  // meantime, instead of rebuilding it with a widened profile in place.
+  bool build_in_background_{false};
+  mutable std::future<std::unique_ptr<TensorRTEngine>> building_engine_;
   bool with_dynamic_shape_{false};
   std::string shape_range_info_path_;
   std::string model_opt_cache_dir_;
@@ -195,6 +203,9 @@ class TensorRTEngineOp : public framework::OperatorBase {
     predictor_id_ = Attr<int>("predictor_id");
     shape_range_info_path_ = Attr<std::string>("shape_range_info_path");
     allow_build_at_runtime_ = Attr<bool>("allow_build_at_runtime");
+    if (HasAttr("build_in_background")) {
+      build_in_background_ = Attr<bool>("build_in_background");
+    }
     with_dynamic_shape_ = Attr<bool>("with_dynamic_shape");
     use_static_engine_ = Attr<bool>("use_static_engine");
     if (use_static_engine_) {
@@ -262,6 +273,93 @@ class TensorRTEngineOp : public framework::OperatorBase {
     auto &current_scope = scope.NewScope();
     auto ctx = executor.Prepare(*program, block->ID());
     executor.RunPreparedContext(ctx.get(), &current_scope, false, true, true);
+    scope.DeleteScope(&current_scope);
+  }
+
+  const framework::Scope &RootScope(const framework::Scope &scope) const {
+    auto *anc = &scope;
+    while (anc->parent()) {
+      anc = anc->parent();
+    }
+    return *anc;
+  }
+
+  void SaveSerializedEngine(TensorRTEngine *engine) const {
+    nvinfer1::IHostMemory *serialized_engine_data = engine->Serialize();
+    std::string trt_engine_serialized_data =
+        std::string((const char *)serialized_engine_data->data(),
+                    serialized_engine_data->size());
+    inference::analysis::SaveTrtEngineSerializedDataToFile(
+        inference::analysis::GetTrtEngineSerializedPath(model_opt_cache_dir_,
+                                                        engine_key_),
+        trt_engine_serialized_data);
+    LOG(INFO) << "Save TRT Optimized Info to "
+              << inference::analysis::GetTrtEngineSerializedPath(
+                     model_opt_cache_dir_, engine_key_);
+  }
+
+  // Build an engine with the profiles of trt_engine and one for the runtime
+  // shapes on a background thread.
+  void BuildEngineInBackground(
+      const framework::Scope &scope,
+      const platform::Place &dev_place,
+      TensorRTEngine *trt_engine,
+      const std::map<std::string, std::vector<int32_t>> &runtime_input_shape,
+      const std::map<std::string, std::vector<int32_t>> &runtime_shape_tensor)
+      const {
+    auto params = trt_engine->params();
+    TensorRTEngine::AddShapeProfile(
+        runtime_input_shape, runtime_shape_tensor, &params);
+    auto run_float = trt_engine->GetRunFloat();
+    auto predictor_id = TensorRTEngine::predictor_id_per_thread;
+    const framework::Scope *root = &RootScope(scope);
+    LOG(INFO) << "Build TRT engine " << engine_key_
+              << " with an extra profile in background, the subgraph runs "
+                 "by paddle until it is built.";
+    building_engine_ = std::async(
+        std::launch::async,
+        [this, params, run_float, predictor_id, root, dev_place]() {
+          TensorRTEngine::predictor_id_per_thread = predictor_id;
+          platform::SetDeviceId(dev_place.device);
+          auto engine = std::make_unique<TensorRTEngine>(params);
+          engine->SetRunFloat(run_float);
+          // the context memory shared with the running contexts is updated
+          // on the swap
+          engine->SetDeferContextMemoryUpdate(true);
+          PrepareTRTEngine(*root, engine.get());
+          if (use_static_engine_) {
+            SaveSerializedEngine(engine.get());
+          }
+          return engine;
+        });
+  }
+
+  // Swap the engine of the op with the one built in background, if it is
+  // built.
+  void SwapBuiltEngine(const platform::Place &dev_place) const {
+    if (!building_engine_.valid() ||
+        building_engine_.wait_for(std::chrono::seconds(0)) !=
+            std::future_status::ready) {
+      return;
+    }
+    std::unique_ptr<TensorRTEngine> engine;
+    try {
+      engine = building_engine_.get();
+    } catch (const std::exception &e) {
+      LOG(WARNING) << "Failed to build TRT engine " << engine_key_
+                   << " in background: " << e.what();
+      return;
+    }
+    // the old engine may still run on the stream
+    platform::DeviceContextPool::Instance().Get(dev_place)->Wait();
+    trt_engine_ =
+        inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
+            .Replace(engine_key_ + std::to_string(predictor_id_),
+                     std::move(engine));
+    trt_engine_->UpdateContextMemorySize();
+    LOG(INFO) << "Swap TRT engine " << engine_key_ << " with the one of "
+              << trt_engine_->engine()->getNbOptimizationProfiles()
+              << " profiles built in background.";
   }
 
   void RunImpl(const framework::Scope &scope,
@@ -270,6 +368,9 @@ class TensorRTEngineOp : public framework::OperatorBase {
       RunCalibration(scope, dev_place);
       return;
     }
+    if (build_in_background_) {
+      SwapBuiltEngine(dev_place);
+    }
     auto *trt_engine = GetEngine(scope, dev_place);
     if (trt_engine->with_dynamic_shape()) {
       // get runtime input shapes and shape tensors.
@@ -371,6 +472,24 @@ class TensorRTEngineOp : public framework::OperatorBase {
                                    min_input_shape[x],
                                    max_input_shape[x]);
         }
+      } else if (build_in_background_ && trt_engine->engine() &&
+                 trt_engine->GetProfileNum() == 1) {
+        int profile =
+            trt_engine->FindProfile(runtime_input_shape, runtime_shape_tensor);
+        if (profile < 0) {
+          if (!building_engine_.valid()) {
+            BuildEngineInBackground(scope,
+                                    dev_place,
+                                    trt_engine,
+                                    runtime_input_shape,
+                                    runtime_shape_tensor);
+          }
+          RunNativeImpl(scope, dev_place);
+          return;
+        }
+        auto *dev_ctx = static_cast<phi::GPUContext *>(
+            platform::DeviceContextPool::Instance().Get(dev_place));
+        trt_engine->SetProfile(profile, dev_ctx->stream());
       } else {
         // compare runtime_input_shape and trt_engine dynamic shapes.
         std::vector<std::string> shape_changed_name;
@@ -386,14 +505,7 @@ class TensorRTEngineOp : public framework::OperatorBase {
             trt_engine->ResetContext();
             trt_engine->ClearTensorMap();
           }
-          auto *anc = scope.parent();
-          while (anc && anc->parent()) {
-            anc = anc->parent();
-          }
-          if (anc == nullptr) {
-            anc = &scope;
-          }
-          PrepareTRTEngine(*anc, trt_engine);
+          PrepareTRTEngine(RootScope(scope), trt_engine);
           // update shape_range_info_pbtxt
           if (!shape_range_info_path_.empty()) {
             inference::UpdateShapeRangeInfo(shape_range_info_path_,
@@ -408,18 +520,7 @@ class TensorRTEngineOp : public framework::OperatorBase {
           }
 
           if (use_static_engine_) {
-            nvinfer1::IHostMemory *serialized_engine_data =
-                trt_engine->Serialize();
-            std::string trt_engine_serialized_data =
-                std::string((const char *)serialized_engine_data->data(),
-                            serialized_engine_data->size());
-            inference::analysis::SaveTrtEngineSerializedDataToFile(
-                inference::analysis::GetTrtEngineSerializedPath(
-                    model_opt_cache_dir_, engine_key_),
-                trt_engine_serialized_data);
-            LOG(INFO) << "Save TRT Optimized Info to "
-                      << inference::analysis::GetTrtEngineSerializedPath(
-                             model_opt_cache_dir_, engine_key_);
+            SaveSerializedEngine(trt_engine);
           }
         }
       }
@@ -838,6 +939,9 @@ class TensorRTEngineOp : public framework::OperatorBase {
       if (HasAttr("context_memory_sharing")) {
         params.context_memory_sharing = Attr<bool>("context_memory_sharing");
       }
+      if (HasAttr("context_memory_per_run")) {
+        params.context_memory_per_run = Attr<bool>("context_memory_per_run");
+      }
       if (HasAttr("use_dla")) {
         params.use_dla = Attr<bool>("use_dla");
       }
@@ -22,6 +22,7 @@ CPP_FILE_TEMPLATE = """
 
 #include "paddle/fluid/pybind/static_op_function.h"
 #include "paddle/fluid/pybind/eager_op_function.h"
+#include "paddle/fluid/pybind/eager_utils.h"
 #include "paddle/fluid/pybind/manual_static_op_function.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/fluid/eager/api/utils/global_utils.h"
@@ -55,7 +56,7 @@ static PyObject *{name}(PyObject *self, PyObject *args, PyObject *kwargs) {{
     return static_api_{name}(self, args, kwargs);
   }} else {{
     VLOG(6) << "Call eager_api_{name}";
-    return eager_api_{name}(self, args, kwargs);
+    return eager_api_{name}(self, TupleItems(args), PyTuple_GET_SIZE(args));
   }}
 }}"""
 
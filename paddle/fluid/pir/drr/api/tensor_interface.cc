@@ -30,5 +30,7 @@ bool DtypeInterface::operator==(const DtypeInterface& other) const {
   return *dtype_ == *other.dtype_;
 }
 
+pir::Type DtypeInterface::get() const { return dtype_->get(); }
+
 }  // namespace drr
 }  // namespace pir
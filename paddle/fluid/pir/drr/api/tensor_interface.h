@@ -16,6 +16,8 @@
 
 #include <cstdint>
 
+#include "paddle/pir/core/type.h"
+
 namespace pir {
 namespace drr {
 
@@ -43,6 +45,9 @@ class DtypeInterface final {
  public:
   bool operator==(const DtypeInterface& other) const;
 
+  // The element type of the tensor, e.g. pir::Float16Type.
+  pir::Type get() const;
+
  private:
   explicit DtypeInterface(const IrDtype* dtype) : dtype_(dtype) {}
 
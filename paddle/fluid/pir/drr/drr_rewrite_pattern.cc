@@ -17,9 +17,82 @@
 namespace pir {
 namespace drr {
 
+void DrrRewritePattern::CompileSourcePattern(pir::IrContext* context) {
+  anchor_ = source_pattern_graph_->AnchorNode();
+  output_op_set_ = source_pattern_graph_->OutputNodes();
+  for (const auto& op_call : source_pattern_graph_->owned_op_call()) {
+    pir::OpInfo op_info = context->GetRegisteredOpInfo(op_call->name());
+    if (op_info) {
+      op_infos_[op_call.get()] = op_info;
+    }
+  }
+
+  // the producers of the anchor breadth first, each by its first path
+  std::unordered_map<const OpCall*, std::vector<uint32_t>> paths{
+      {anchor_, {}}};
+  std::queue<const OpCall*> q;
+  q.push(anchor_);
+  while (!q.empty()) {
+    const OpCall* drr_op = q.front();
+    q.pop();
+    const auto& inputs = drr_op->inputs();
+    for (uint32_t i = 0; i < inputs.size(); ++i) {
+      const OpCall* producer = inputs[i]->producer();
+      if (producer == nullptr || paths.count(producer)) {
+        continue;
+      }
+      std::vector<uint32_t> path = paths.at(drr_op);
+      path.push_back(i);
+      producer_checks_.push_back(
+          ProducerCheck{path, producer, inputs[i]->consumers().size()});
+      paths.emplace(producer, std::move(path));
+      q.push(producer);
+    }
+  }
+}
+
+bool DrrRewritePattern::IsSameOp(const OpCall* drr_op,
+                                 const pir::Operation* ir_op) const {
+  auto it = op_infos_.find(drr_op);
+  if (it != op_infos_.end()) {
+    return ir_op->info() == it->second;
+  }
+  return drr_op->name() == ir_op->info().name();
+}
+
+bool DrrRewritePattern::AnchorPrefilter(pir::Operation* op) const {
+  if (!IsSameOp(anchor_, op) ||
+      anchor_->inputs().size() != op->num_operands() ||
+      anchor_->outputs().size() != op->num_results()) {
+    return false;
+  }
+  for (const auto& check : producer_checks_) {
+    pir::Operation* ir_op = op;
+    pir::Value value;
+    for (uint32_t index : check.path) {
+      value = ir_op->operand_source(index);
+      auto op_result = value ? value.dyn_cast<pir::OpResult>() : nullptr;
+      if (!op_result) {
+        return false;
+      }
+      ir_op = op_result.owner();
+    }
+    if (value.use_count() != check.use_count ||
+        !IsSameOp(check.drr_op, ir_op) ||
+        check.drr_op->inputs().size() != ir_op->num_operands() ||
+        check.drr_op->outputs().size() != ir_op->num_results()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool DrrRewritePattern::MatchAndRewrite(
     pir::Operation* op,
     PatternRewriter& rewriter) const {  // NOLINT
+  if (!AnchorPrefilter(op)) {
+    return false;
+  }
   std::shared_ptr<MatchContextImpl> src_match_ctx =
       std::make_shared<MatchContextImpl>();
   if (PatternGraphMatch(op, src_match_ctx.get())) {
@@ -33,10 +106,9 @@ bool DrrRewritePattern::MatchAndRewrite(
 bool DrrRewritePattern::PatternGraphMatch(
     pir::Operation* op, MatchContextImpl* source_pattern_match_ctx) const {
   VLOG(6) << "PatternGraphMatch Start: op(" << op->name() << ")";
-  const OpCall* anchor = source_pattern_graph_->AnchorNode();
   std::unordered_map<const OpCall*, std::unordered_set<pir::Operation*>>
       bind_map =
-          FindCandidateIrOutputOp(op, anchor, *(source_pattern_graph_.get()));
+          FindCandidateIrOutputOp(op, anchor_, *(source_pattern_graph_.get()));
   if (bind_map.empty()) {
     return false;
   }
@@ -92,9 +164,7 @@ DrrRewritePattern::FindCandidateIrOutputOp(
     pir::Operation* op,
     const OpCall* anchor,
     const SourcePatternGraph& source_pattern_graph) const {
-  // get source pattern output op
-  std::unordered_set<const OpCall*> drr_output_op_set =
-      source_pattern_graph.OutputNodes();
+  const std::unordered_set<const OpCall*>& drr_output_op_set = output_op_set_;
   std::unordered_map<const OpCall*, std::unordered_set<pir::Operation*>>
       output_op_bind_map{{anchor, {op}}};
   if (drr_output_op_set.size() == 1) {
@@ -118,7 +188,7 @@ void DrrRewritePattern::DfsVisitor(
         output_op_bind_map) const {
   VLOG(6) << "DfsVisitor Start: drr op(" << drr_op->name() << ")"
           << "ir op(" << ir_op->name() << ")";
-  if (drr_op->name() != ir_op->name()) {
+  if (!IsSameOp(drr_op, ir_op)) {
     return;
   }
   // check op input's size
@@ -147,7 +217,7 @@ void DrrRewritePattern::DfsVisitor(
              it != ir_input_tensor.use_end();
              ++it) {
           auto* ir_bro_op = it.owner();
-          if (drr_bro_op->name() == ir_bro_op->name()) {
+          if (IsSameOp(drr_bro_op, ir_bro_op)) {
             drr_visited_ops->insert(drr_bro_op);
             DfsVisitor(drr_bro_op,
                        ir_bro_op,
@@ -195,7 +265,7 @@ void DrrRewritePattern::DfsVisitor(
            it != ir_output_value.use_end();
            ++it) {
         auto* ir_child_op = it.owner();
-        if (drr_child_op->name() == ir_child_op->name()) {
+        if (IsSameOp(drr_child_op, ir_child_op)) {
           if (drr_visited_ops->count(drr_child_op)) {
             continue;
           }
@@ -238,7 +308,7 @@ bool DrrRewritePattern::MatchFromOutputToInput(
     auto* ir_node = ir_q.front();
     drr_q.pop();
     ir_q.pop();
-    if (drr_node->name() != ir_node->name()) {
+    if (!IsSameOp(drr_node, ir_node)) {
       matched = false;
       VLOG(8) << "Match failed: drr_node(" << drr_node->name()
               << ") != pir_node(" << ir_node->name() << ").";
@@ -55,12 +55,31 @@ class DrrRewritePattern : public pir::RewritePattern {
         phi::errors::InvalidArgument("Source pattern graph is empty."
                                      "Suggested fix: Please check the DRR "
                                      "source pattern definition code."));
+    CompileSourcePattern(context);
   }
 
   bool MatchAndRewrite(pir::Operation* op,
                        PatternRewriter& rewriter) const override;  // // NOLINT
 
  private:
+  // An op of the source pattern reached from the anchor by the operand
+  // indices of path, through a value of use_count uses.
+  struct ProducerCheck {
+    std::vector<uint32_t> path;
+    const OpCall* drr_op;
+    size_t use_count;
+  };
+
+  // Resolves the op infos of the source pattern and the producer checks of
+  // the anchor, once for all the matches.
+  void CompileSourcePattern(pir::IrContext* context);
+
+  bool IsSameOp(const OpCall* drr_op, const pir::Operation* ir_op) const;
+
+  // The checks every match of op implies, which reject most of the ops
+  // before the match allocates anything.
+  bool AnchorPrefilter(pir::Operation* op) const;
+
   bool PatternGraphMatch(pir::Operation* op,
                          MatchContextImpl* source_pattern_match_ctx) const;
 
@@ -110,6 +129,12 @@ class DrrRewritePattern : public pir::RewritePattern {
   const std::shared_ptr<SourcePatternGraph> source_pattern_graph_;
   const std::vector<Constraint> constraints_;
   const std::shared_ptr<ResultPatternGraph> result_pattern_graph_;
+
+  // compiled by CompileSourcePattern
+  const OpCall* anchor_{nullptr};
+  std::unordered_set<const OpCall*> output_op_set_;
+  std::unordered_map<const OpCall*, pir::OpInfo> op_infos_;
+  std::vector<ProducerCheck> producer_checks_;
 };
 
 }  // namespace drr
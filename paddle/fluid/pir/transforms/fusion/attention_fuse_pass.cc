@@ -14,7 +14,10 @@
 
 #include "paddle/fluid/pir/transforms/fusion/attention_fuse_pass.h"
 
+#include <cmath>
+
 #include "paddle/fluid/pir/drr/api/drr_pattern_base.h"
+#include "paddle/pir/core/builtin_type.h"
 #include "paddle/pir/pass/pass.h"
 #include "paddle/pir/pass/pass_registry.h"
 #include "paddle/pir/pattern_rewrite/pattern_rewrite_driver.h"
@@ -214,6 +217,165 @@ class MultiHeadMatmulFusePattern
   }
 };
 
+// Fuses the scaled dot-product attention composed by
+// paddle.nn.functional.scaled_dot_product_attention without flash-attention,
+// on q, k and v of [batch_size, seq_len, num_heads, head_dim], into
+// flash_attn, which never materializes the attention weights of
+// [batch_size, num_heads, seq_len_q, seq_len_k]. The causal variant masks the
+// weights by fused_softmax_mask_upper_triangle, and the masked one adds
+// attn_mask to them before the softmax.
+template <bool kCausal, bool kWithMask>
+class FlashAttnFusePattern : public pir::drr::DrrPatternBase<
+                                 FlashAttnFusePattern<kCausal, kWithMask>> {
+  static_assert(!(kCausal && kWithMask),
+                "flash_attn can not take attn_mask when causal is true.");
+
+ public:
+  void operator()(pir::drr::DrrPatternContext *ctx) const override {
+    //
+    // Source Pattern.
+    //
+    pir::drr::SourcePattern src = ctx->SourcePattern();
+    const auto &transpose_q =
+        src.Op("pd_op.transpose", {{"perm", src.Attr("transpose_q_perm")}});
+    src.Tensor("transpose_q_out") = transpose_q(src.Tensor("q"));
+    const auto &transpose_k =
+        src.Op("pd_op.transpose", {{"perm", src.Attr("transpose_k_perm")}});
+    src.Tensor("transpose_k_out") = transpose_k(src.Tensor("k"));
+    const auto &transpose_v =
+        src.Op("pd_op.transpose", {{"perm", src.Attr("transpose_v_perm")}});
+    src.Tensor("transpose_v_out") = transpose_v(src.Tensor("v"));
+
+    const auto &full_scale =
+        src.Op("pd_op.full", {{"value", src.Attr("scale_value")}});
+    const auto &scale =
+        src.Op("pd_op.scale", {{"bias", src.Attr("scale_bias")}});
+    src.Tensor("scale_out") =
+        scale(src.Tensor("transpose_q_out"), full_scale());
+    const auto &matmul_qk =
+        src.Op("pd_op.matmul",
+               {{"transpose_x", src.Attr("matmul_qk_transpose_x")},
+                {"transpose_y", src.Attr("matmul_qk_transpose_y")}});
+    src.Tensor("matmul_qk_out") =
+        matmul_qk(src.Tensor("scale_out"), src.Tensor("transpose_k_out"));
+
+    std::string softmax_in = "matmul_qk_out";
+    if (kWithMask) {
+      const auto &add_mask = src.Op("pd_op.add");
+      src.Tensor("add_mask_out") =
+          add_mask(src.Tensor("matmul_qk_out"), src.Tensor("attn_mask"));
+      softmax_in = "add_mask_out";
+    }
+    if (kCausal) {
+      const auto &softmax = src.Op("pd_op.fused_softmax_mask_upper_triangle");
+      src.Tensor("softmax_out") = softmax(src.Tensor(softmax_in));
+    } else {
+      const auto &softmax =
+          src.Op("pd_op.softmax", {{"axis", src.Attr("softmax_axis")}});
+      src.Tensor("softmax_out") = softmax(src.Tensor(softmax_in));
+    }
+
+    const auto &matmul_pv =
+        src.Op("pd_op.matmul",
+               {{"transpose_x", src.Attr("matmul_pv_transpose_x")},
+                {"transpose_y", src.Attr("matmul_pv_transpose_y")}});
+    src.Tensor("matmul_pv_out") =
+        matmul_pv(src.Tensor("softmax_out"), src.Tensor("transpose_v_out"));
+    const auto &transpose_out =
+        src.Op("pd_op.transpose", {{"perm", src.Attr("transpose_out_perm")}});
+    src.Tensor("out") = transpose_out(src.Tensor("matmul_pv_out"));
+
+    //
+    // Constraints.
+    //
+    src.RequireNativeCall([](const pir::drr::MatchContext &match_ctx) -> bool {
+      const std::vector<int> perm = {0, 2, 1, 3};
+      for (const char *name : {"transpose_q_perm",
+                               "transpose_k_perm",
+                               "transpose_v_perm",
+                               "transpose_out_perm"}) {
+        if (match_ctx.Attr<std::vector<int>>(name) != perm) return false;
+      }
+      if (match_ctx.Attr<bool>("matmul_qk_transpose_x") ||
+          !match_ctx.Attr<bool>("matmul_qk_transpose_y")) {
+        return false;
+      }
+      if (match_ctx.Attr<bool>("matmul_pv_transpose_x") ||
+          match_ctx.Attr<bool>("matmul_pv_transpose_y")) {
+        return false;
+      }
+      if (!kCausal) {
+        const auto &softmax_axis = match_ctx.Attr<int>("softmax_axis");
+        if (softmax_axis != -1 && softmax_axis != 3) return false;
+      }
+
+      // flash_attn supports float16 and bfloat16 of head_dim up to 256
+      const pir::Type q_dtype = match_ctx.Tensor("q").Dtype().get();
+      if (!q_dtype.isa<pir::Float16Type>() &&
+          !q_dtype.isa<pir::BFloat16Type>()) {
+        return false;
+      }
+      const auto &q_shape = match_ctx.Tensor("q").Shape();
+      const auto &k_shape = match_ctx.Tensor("k").Shape();
+      if (q_shape.size() != 4 || !(k_shape == match_ctx.Tensor("v").Shape())) {
+        return false;
+      }
+      const int64_t head_dim = q_shape.at(3);
+      if (head_dim <= 0 || head_dim > 256 || head_dim % 8 != 0) return false;
+      // the upper triangle is masked from the top-left corner
+      if (kCausal && q_shape.at(1) != k_shape.at(1)) return false;
+      if (kWithMask &&
+          (match_ctx.Tensor("attn_mask").Shape().size() != 4 ||
+           !(match_ctx.Tensor("attn_mask").Dtype() ==
+             match_ctx.Tensor("q").Dtype()))) {
+        return false;
+      }
+
+      // flash_attn scales q by 1 / sqrt(head_dim)
+      const float scale = match_ctx.Attr<float>("scale_value");
+      const float expected_scale = 1.0f / std::sqrt(head_dim);
+      return match_ctx.Attr<float>("scale_bias") == 0.0f &&
+             std::abs(scale - expected_scale) <= 1e-6f * expected_scale;
+    });
+
+    //
+    // Result Pattern.
+    //
+    pir::drr::ResultPattern res = src.ResultPattern();
+    const auto &flash_attn = res.Op(
+        "pd_op.flash_attn",
+        {{"dropout",
+          res.Attr([](const pir::drr::MatchContext &match_ctx) -> float {
+            return 0.0f;
+          })},
+         {"causal",
+          res.Attr([](const pir::drr::MatchContext &match_ctx) -> bool {
+            return kCausal;
+          })},
+         {"return_softmax",
+          res.Attr([](const pir::drr::MatchContext &match_ctx) -> bool {
+            return false;
+          })},
+         {"is_test",
+          res.Attr([](const pir::drr::MatchContext &match_ctx) -> bool {
+            return false;
+          })},
+         {"rng_name",
+          res.Attr([](const pir::drr::MatchContext &match_ctx) -> std::string {
+            return "";
+          })}});
+    flash_attn({&res.Tensor("q"),
+                &res.Tensor("k"),
+                &res.Tensor("v"),
+                &res.NoneTensor(),
+                kWithMask ? &res.Tensor("attn_mask") : &res.NoneTensor()},
+               {&res.Tensor("out"),
+                &res.NoneTensor(),
+                &res.NoneTensor(),
+                &res.NoneTensor()});
+  }
+};
+
 class AttentionFusePass : public pir::PatternRewritePass {
  public:
   AttentionFusePass() : pir::PatternRewritePass("attention_fuse_pass", 2) {}
@@ -221,6 +383,9 @@ class AttentionFusePass : public pir::PatternRewritePass {
   pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
     pir::RewritePatternSet ps(context);
     ps.Add(MultiHeadMatmulFusePattern().Build(context));
+    ps.Add(FlashAttnFusePattern<false, false>().Build(context));
+    ps.Add(FlashAttnFusePattern<true, false>().Build(context));
+    ps.Add(FlashAttnFusePattern<false, true>().Build(context));
     // Add other attention variant fuse pattern.
 
     return ps;
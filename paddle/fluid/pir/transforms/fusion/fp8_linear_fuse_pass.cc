@@ -0,0 +1,106 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/fusion/fp8_linear_fuse_pass.h"
+#include "paddle/fluid/pir/drr/api/drr_pattern_base.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/fluid/platform/place.h"
+#include "paddle/pir/pass/pass.h"
+#include "paddle/pir/pass/pass_registry.h"
+#include "paddle/pir/pattern_rewrite/pattern_rewrite_driver.h"
+
+namespace {
+
+inline int getSMVersion() {
+  int sm_version = 80;
+#if defined(PADDLE_WITH_CUDA)
+  sm_version = paddle::platform::GetGPUComputeCapability(
+      paddle::platform::GetCurrentDeviceId());
+#endif
+  return sm_version;
+}
+
+// matmul + add -> fp8_linear, which computes the gemm by the fp8 tensor cores.
+// The programs have no amax histories, so the fused op scales x and w by
+// their amax of each run, the current scaling. The pass is for the programs
+// of float16 or bfloat16, and is not applied by default.
+class Fp8LinearFusePattern
+    : public pir::drr::DrrPatternBase<Fp8LinearFusePattern> {
+ public:
+  void operator()(pir::drr::DrrPatternContext *ctx) const override {
+    pir::drr::SourcePattern src = ctx->SourcePattern();
+    const auto &matmul =
+        src.Op("pd_op.matmul",
+               {{"transpose_x", src.Attr("matmul_transpose_x")},
+                {"transpose_y", src.Attr("matmul_transpose_y")}});
+    src.Tensor("matmul_out") = matmul(src.Tensor("x"), src.Tensor("w"));
+    const auto &add = src.Op("pd_op.add");
+    src.Tensor("add_out") = add(src.Tensor("matmul_out"), src.Tensor("bias"));
+
+    src.RequireNativeCall([](const pir::drr::MatchContext &match_ctx) -> bool {
+      if (match_ctx.Attr<bool>("matmul_transpose_x") ||
+          match_ctx.Attr<bool>("matmul_transpose_y")) {
+        return false;
+      }
+      const auto &w_shape = match_ctx.Tensor("w").Shape();
+      if (!(w_shape.size() == 2 &&
+            match_ctx.Tensor("x").Shape().size() >= 2 &&
+            match_ctx.Tensor("bias").Shape().size() == 1)) {
+        return false;
+      }
+      // the fp8 gemm of cuBLASLt requires k and n to be multiples of 16
+      return w_shape.at(0) > 0 && w_shape.at(0) % 16 == 0 &&
+             w_shape.at(1) > 0 && w_shape.at(1) % 16 == 0;
+    });
+
+    pir::drr::ResultPattern res = src.ResultPattern();
+    const auto &margin_attr = res.Attr(
+        [](const pir::drr::MatchContext &match_ctx) -> float { return 0.f; });
+    const auto &fp8_linear =
+        res.Op("pd_op.fp8_linear", {{"margin", margin_attr}});
+    fp8_linear({&res.Tensor("x"),
+                &res.Tensor("w"),
+                &res.Tensor("bias"),
+                &res.NoneTensor(),
+                &res.NoneTensor()},
+               {&res.Tensor("add_out"), &res.NoneTensor(), &res.NoneTensor()});
+  }
+};
+
+class Fp8LinearFusePass : public pir::PatternRewritePass {
+ public:
+  Fp8LinearFusePass() : pir::PatternRewritePass("fp8_linear_fuse_pass", 4) {}
+
+  pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
+    pir::RewritePatternSet ps(context);
+    ps.Add(Fp8LinearFusePattern().Build(context));
+    return ps;
+  }
+
+  bool CanApplyOn(pir::Operation *op) const override {
+    // the fp8 tensor cores are of sm89 and later
+    if (getSMVersion() < 89) return false;
+    return op->num_regions() > 0;
+  }
+};
+
+}  // namespace
+
+namespace pir {
+std::unique_ptr<Pass> CreateFp8LinearFusePass() {
+  return std::make_unique<Fp8LinearFusePass>();
+}
+}  // namespace pir
+
+REGISTER_IR_PASS(fp8_linear_fuse_pass, Fp8LinearFusePass);
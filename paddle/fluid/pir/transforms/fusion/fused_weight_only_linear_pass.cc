@@ -16,10 +16,14 @@
 #include "paddle/fluid/pir/drr/api/drr_pattern_base.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/place.h"
+#include "paddle/phi/core/flags.h"
 #include "paddle/pir/pass/pass.h"
 #include "paddle/pir/pass/pass_registry.h"
 #include "paddle/pir/pattern_rewrite/pattern_rewrite_driver.h"
 
+PHI_DECLARE_string(fused_weight_only_linear_weight_dtype);
+PHI_DECLARE_int32(fused_weight_only_linear_group_size);
+
 namespace {
 
 inline int getSMVersion() {
@@ -31,6 +35,78 @@ inline int getSMVersion() {
   return sm_version;
 }
 
+bool MatchWeightOnlyLinear(const pir::drr::MatchContext &match_ctx) {
+  bool matmul_trans_x = match_ctx.Attr<bool>("matmul_transpose_x");
+  bool matmul_trans_y = match_ctx.Attr<bool>("matmul_transpose_y");
+  if (matmul_trans_x || matmul_trans_y) return false;
+
+  if (!(match_ctx.Tensor("w").Shape().size() == 2 &&
+        match_ctx.Tensor("x").Shape().size() >= 2 &&
+        match_ctx.Tensor("bias").Shape().size() == 1)) {
+    return false;
+  }
+
+  // the grouped scales divide the rows of w
+  int group_size = FLAGS_fused_weight_only_linear_group_size;
+  if (group_size > 0 && match_ctx.Tensor("w").Shape().at(0) % group_size) {
+    return false;
+  }
+  return true;
+}
+
+// Quantizes w by weight_quantize, and replaces the matched ops by a
+// weight_only_linear with the activation, whose output is out.
+void BuildWeightOnlyLinear(pir::drr::ResultPattern *res,
+                           const std::string &activation,
+                           const std::string &out) {
+  // quantize weight
+  const auto &weight_quantize_algo_attr =
+      res->Attr([](const pir::drr::MatchContext &match_ctx) -> std::any {
+        return "weight_only_" + FLAGS_fused_weight_only_linear_weight_dtype;
+      });
+  // int arch = getSMVersion();
+  const auto &weight_quantize_arch_attr =
+      res->Attr([&](const pir::drr::MatchContext &match_ctx) -> std::any {
+        return 80;
+      });
+  const auto &group_size_attr = res->Attr(
+      [](const pir::drr::MatchContext &match_ctx) -> int {
+        return FLAGS_fused_weight_only_linear_group_size;
+      });
+
+  const auto &weight_quantize =
+      res->Op("pd_op.weight_quantize",
+              {{"algo", weight_quantize_algo_attr},
+               {"arch", weight_quantize_arch_attr},
+               {"group_size", group_size_attr}});
+  weight_quantize({&res->Tensor("w")},
+                  {&res->Tensor("quanted_weight_tensor"),
+                   &res->Tensor("weight_scale_tensor")});
+
+  const auto &weight_dtype_attr =
+      res->Attr([](const pir::drr::MatchContext &match_ctx) -> std::any {
+        return FLAGS_fused_weight_only_linear_weight_dtype;
+      });
+
+  const auto &weight_only_linear_arch_attr = res->Attr(
+      [&](const pir::drr::MatchContext &match_ctx) -> int { return 80; });
+  const auto &activation_attr = res->Attr(
+      [activation](const pir::drr::MatchContext &match_ctx) -> std::any {
+        return activation;
+      });
+  const auto &weight_only_linear =
+      res->Op("pd_op.weight_only_linear",
+              {{"weight_dtype", weight_dtype_attr},
+               {"arch", weight_only_linear_arch_attr},
+               {"group_size", group_size_attr},
+               {"activation", activation_attr}});
+  weight_only_linear({&res->Tensor("x"),
+                      &res->Tensor("quanted_weight_tensor"),
+                      &res->Tensor("bias"),
+                      &res->Tensor("weight_scale_tensor")},
+                     {&res->Tensor(out)});
+}
+
 class FusedWeightOnlyLinearPattern
     : public pir::drr::DrrPatternBase<FusedWeightOnlyLinearPattern> {
  public:
@@ -51,58 +127,62 @@ class FusedWeightOnlyLinearPattern
     //
     // Constraints.
     //
-    src.RequireNativeCall([](const pir::drr::MatchContext &match_ctx) -> bool {
-      bool matmul_trans_x = match_ctx.Attr<bool>("matmul_transpose_x");
-      bool matmul_trans_y = match_ctx.Attr<bool>("matmul_transpose_y");
-      if (matmul_trans_x || matmul_trans_y) return false;
-
-      if (!(match_ctx.Tensor("w").Shape().size() == 2 &&
-            match_ctx.Tensor("x").Shape().size() >= 2 &&
-            match_ctx.Tensor("bias").Shape().size() == 1)) {
-        return false;
-      }
-
-      return true;
-    });
+    src.RequireNativeCall(MatchWeightOnlyLinear);
     //
     // Result Pattern.
     //
     pir::drr::ResultPattern res = src.ResultPattern();
+    BuildWeightOnlyLinear(&res, "none", "add_out");
+  }
+};
+
+// The activation is fused into the epilogue of weight_only_linear.
+class FusedWeightOnlyLinearGeluPattern
+    : public pir::drr::DrrPatternBase<FusedWeightOnlyLinearGeluPattern> {
+ public:
+  void operator()(pir::drr::DrrPatternContext *ctx) const override {
+    pir::drr::SourcePattern src = ctx->SourcePattern();
+    const auto &matmul =
+        src.Op("pd_op.matmul",
+               {{"transpose_x", src.Attr("matmul_transpose_x")},
+                {"transpose_y", src.Attr("matmul_transpose_y")}});
+    src.Tensor("matmul_out") = matmul(src.Tensor("x"), src.Tensor("w"));
+    const auto &add = src.Op("pd_op.add");
+    src.Tensor("add_out") = add(src.Tensor("matmul_out"), src.Tensor("bias"));
+    const auto &gelu =
+        src.Op("pd_op.gelu", {{"approximate", src.Attr("approximate")}});
+    src.Tensor("act_out") = gelu(src.Tensor("add_out"));
+
+    src.RequireNativeCall([](const pir::drr::MatchContext &match_ctx) -> bool {
+      // the epilogue computes the gelu by erf
+      if (match_ctx.Attr<bool>("approximate")) return false;
+      return MatchWeightOnlyLinear(match_ctx);
+    });
+
+    pir::drr::ResultPattern res = src.ResultPattern();
+    BuildWeightOnlyLinear(&res, "gelu", "act_out");
+  }
+};
 
-    // quantize weight
-    const auto &weight_only_int8_attr =
-        res.Attr([](const pir::drr::MatchContext &match_ctx) -> std::any {
-          return "weight_only_int8";
-        });
-    // int arch = getSMVersion();
-    const auto &weight_quantize_arch_attr =
-        res.Attr([&](const pir::drr::MatchContext &match_ctx) -> std::any {
-          return 80;
-        });
-
-    const auto &weight_quantize = res.Op(
-        "pd_op.weight_quantize",
-        {{"algo", weight_only_int8_attr}, {"arch", weight_quantize_arch_attr}});
-    weight_quantize({&res.Tensor("w")},
-                    {&res.Tensor("quanted_weight_tensor"),
-                     &res.Tensor("weight_scale_tensor")});
-
-    const auto &weight_dtype_attr =
-        res.Attr([](const pir::drr::MatchContext &match_ctx) -> std::any {
-          return "int8";
-        });
-
-    const auto &weight_only_linear_arch_attr = res.Attr(
-        [&](const pir::drr::MatchContext &match_ctx) -> int { return 80; });
-    const auto &weight_only_linear =
-        res.Op("pd_op.weight_only_linear",
-               {{"weight_dtype", weight_dtype_attr},
-                {"arch", weight_only_linear_arch_attr}});
-    weight_only_linear({&res.Tensor("x"),
-                        &res.Tensor("quanted_weight_tensor"),
-                        &res.Tensor("bias"),
-                        &res.Tensor("weight_scale_tensor")},
-                       {&res.Tensor("add_out")});
+class FusedWeightOnlyLinearSiluPattern
+    : public pir::drr::DrrPatternBase<FusedWeightOnlyLinearSiluPattern> {
+ public:
+  void operator()(pir::drr::DrrPatternContext *ctx) const override {
+    pir::drr::SourcePattern src = ctx->SourcePattern();
+    const auto &matmul =
+        src.Op("pd_op.matmul",
+               {{"transpose_x", src.Attr("matmul_transpose_x")},
+                {"transpose_y", src.Attr("matmul_transpose_y")}});
+    src.Tensor("matmul_out") = matmul(src.Tensor("x"), src.Tensor("w"));
+    const auto &add = src.Op("pd_op.add");
+    src.Tensor("add_out") = add(src.Tensor("matmul_out"), src.Tensor("bias"));
+    const auto &silu = src.Op("pd_op.silu");
+    src.Tensor("act_out") = silu(src.Tensor("add_out"));
+
+    src.RequireNativeCall(MatchWeightOnlyLinear);
+
+    pir::drr::ResultPattern res = src.ResultPattern();
+    BuildWeightOnlyLinear(&res, "silu", "act_out");
   }
 };
 
@@ -113,6 +193,10 @@ class FusedWeightOnlyLinearPass : public pir::PatternRewritePass {
 
   pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
     pir::RewritePatternSet ps(context);
+    // the activation patterns are matched first, so that their matmul and add
+    // are not fused alone
+    ps.Add(FusedWeightOnlyLinearGeluPattern().Build(context, 2));
+    ps.Add(FusedWeightOnlyLinearSiluPattern().Build(context, 2));
     ps.Add(FusedWeightOnlyLinearPattern().Build(context));
     return ps;
   }
@@ -0,0 +1,309 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/fusion/norm_quant_fuse_pass.h"
+
+#include <cmath>
+
+#include "paddle/fluid/pir/drr/api/drr_pattern_base.h"
+#include "paddle/pir/core/builtin_type.h"
+#include "paddle/pir/pass/pass.h"
+#include "paddle/pir/pass/pass_registry.h"
+#include "paddle/pir/pattern_rewrite/pattern_rewrite_driver.h"
+
+namespace {
+
+// round + clip + cast to int8 of quant_in, the int8 quantization written by
+// the ops, whose output is quant_out.
+void BuildQuantSourcePattern(pir::drr::SourcePattern *src,
+                             const std::string &quant_in) {
+  const auto &round = src->Op("pd_op.round");
+  src->Tensor("round_out") = round(src->Tensor(quant_in));
+  const auto &full_min =
+      src->Op("pd_op.full", {{"value", src->Attr("clip_min")}});
+  const auto &full_max =
+      src->Op("pd_op.full", {{"value", src->Attr("clip_max")}});
+  const auto &clip = src->Op("pd_op.clip");
+  src->Tensor("clip_out") =
+      clip(src->Tensor("round_out"), full_min(), full_max());
+  const auto &cast = src->Op("pd_op.cast");
+  src->Tensor("quant_out") = cast(src->Tensor("clip_out"));
+}
+
+bool MatchQuant(const pir::drr::MatchContext &match_ctx) {
+  // the clipped values are in the range of int8
+  const float clip_min = match_ctx.Attr<float>("clip_min");
+  const float clip_max = match_ctx.Attr<float>("clip_max");
+  return match_ctx.Tensor("quant_out").Dtype().get().isa<pir::Int8Type>() &&
+         clip_max > 0.0f && clip_max <= 127.0f && clip_min >= -128.0f &&
+         clip_min < clip_max;
+}
+
+bool NearlyEqual(float a, float b) {
+  return std::abs(a - b) <= 1e-6f * std::abs(b);
+}
+
+// rms_norm or fused_bias_residual_layernorm + the static quantization of its
+// output, round(clip(out * s)) to int8, -> the norm with quant_scale, which
+// quantizes by round(clip(quant_max_bound * quant_scale * out)).
+template <bool kLayerNorm>
+class NormStaticQuantFusePattern
+    : public pir::drr::DrrPatternBase<NormStaticQuantFusePattern<kLayerNorm>> {
+ public:
+  void operator()(pir::drr::DrrPatternContext *ctx) const override {
+    //
+    // Source Pattern.
+    //
+    pir::drr::SourcePattern src = ctx->SourcePattern();
+    pir::drr::Attribute epsilon = src.Attr("epsilon");
+    pir::drr::Attribute begin_norm_axis = src.Attr("begin_norm_axis");
+    pir::drr::Attribute quant_scale = src.Attr("quant_scale");
+    if (kLayerNorm) {
+      const auto &norm =
+          src.Op("pd_op.fused_bias_residual_layernorm",
+                 {{"epsilon", epsilon},
+                  {"residual_alpha", src.Attr("residual_alpha")},
+                  {"begin_norm_axis", begin_norm_axis},
+                  {"quant_scale", quant_scale}});
+      norm({&src.Tensor("x"),
+            &src.Tensor("bias"),
+            &src.Tensor("residual"),
+            &src.Tensor("norm_weight"),
+            &src.Tensor("norm_bias")},
+           {&src.Tensor("norm_out"),
+            &src.Tensor("residual_out"),
+            &src.Tensor("mean"),
+            &src.Tensor("variance")});
+    } else {
+      const auto &norm = src.Op("pd_op.rms_norm",
+                                {{"epsilon", epsilon},
+                                 {"begin_norm_axis", begin_norm_axis},
+                                 {"quant_scale", quant_scale}});
+      norm({&src.Tensor("x"),
+            &src.Tensor("bias"),
+            &src.Tensor("residual"),
+            &src.Tensor("norm_weight"),
+            &src.Tensor("norm_bias")},
+           {&src.Tensor("norm_out"), &src.Tensor("residual_out")});
+    }
+    const auto &full_scale =
+        src.Op("pd_op.full", {{"value", src.Attr("scale_value")}});
+    const auto &scale =
+        src.Op("pd_op.scale", {{"bias", src.Attr("scale_bias")}});
+    src.Tensor("scale_out") = scale(src.Tensor("norm_out"), full_scale());
+    BuildQuantSourcePattern(&src, "scale_out");
+
+    //
+    // Constraints.
+    //
+    src.RequireNativeCall([](const pir::drr::MatchContext &match_ctx) -> bool {
+      // the norm is not quantized yet
+      if (match_ctx.Attr<float>("quant_scale") > 0.0f) return false;
+      // the int8 output of the fused layernorm takes the affine
+      if (kLayerNorm && !match_ctx.Tensor("norm_weight").Dtype().get()) {
+        return false;
+      }
+      return match_ctx.Attr<float>("scale_bias") == 0.0f &&
+             match_ctx.Attr<float>("scale_value") > 0.0f &&
+             MatchQuant(match_ctx);
+    });
+
+    //
+    // Result Pattern.
+    //
+    pir::drr::ResultPattern res = src.ResultPattern();
+    const auto &quant_scale_attr =
+        res.Attr([](const pir::drr::MatchContext &match_ctx) -> float {
+          return match_ctx.Attr<float>("scale_value") /
+                 match_ctx.Attr<float>("clip_max");
+        });
+    // pd_op.round rounds half away from zero
+    const auto &quant_round_type_attr = res.Attr(
+        [](const pir::drr::MatchContext &match_ctx) -> int { return 1; });
+    const auto &quant_max_bound_attr =
+        res.Attr([](const pir::drr::MatchContext &match_ctx) -> float {
+          return match_ctx.Attr<float>("clip_max");
+        });
+    const auto &quant_min_bound_attr =
+        res.Attr([](const pir::drr::MatchContext &match_ctx) -> float {
+          return match_ctx.Attr<float>("clip_min");
+        });
+    if (kLayerNorm) {
+      const auto &norm =
+          res.Op("pd_op.fused_bias_residual_layernorm",
+                 {{"epsilon", epsilon},
+                  {"residual_alpha", src.Attr("residual_alpha")},
+                  {"begin_norm_axis", begin_norm_axis},
+                  {"quant_scale", quant_scale_attr},
+                  {"quant_round_type", quant_round_type_attr},
+                  {"quant_max_bound", quant_max_bound_attr},
+                  {"quant_min_bound", quant_min_bound_attr}});
+      norm({&res.Tensor("x"),
+            &res.Tensor("bias"),
+            &res.Tensor("residual"),
+            &res.Tensor("norm_weight"),
+            &res.Tensor("norm_bias")},
+           {&res.Tensor("quant_out"),
+            &res.Tensor("residual_out"),
+            &res.Tensor("mean"),
+            &res.Tensor("variance")});
+    } else {
+      const auto &norm =
+          res.Op("pd_op.rms_norm",
+                 {{"epsilon", epsilon},
+                  {"begin_norm_axis", begin_norm_axis},
+                  {"quant_scale", quant_scale_attr},
+                  {"quant_round_type", quant_round_type_attr},
+                  {"quant_max_bound", quant_max_bound_attr},
+                  {"quant_min_bound", quant_min_bound_attr}});
+      norm({&res.Tensor("x"),
+            &res.Tensor("bias"),
+            &res.Tensor("residual"),
+            &res.Tensor("norm_weight"),
+            &res.Tensor("norm_bias")},
+           {&res.Tensor("quant_out"), &res.Tensor("residual_out")});
+    }
+  }
+};
+
+// rms_norm + the per token quantization of its output -> fused_rms_norm_quant.
+// The rows are quantized by their abs max on the last axis, written as
+//   abs_max = max(abs(out), axis=-1, keepdim=True)
+//   quant_out = round(clip(out * 127 / abs_max)) to int8
+//   dequant_scale = abs_max / 127
+// where 127 is the max of the clip.
+class RmsNormPerTokenQuantFusePattern
+    : public pir::drr::DrrPatternBase<RmsNormPerTokenQuantFusePattern> {
+ public:
+  void operator()(pir::drr::DrrPatternContext *ctx) const override {
+    //
+    // Source Pattern.
+    //
+    pir::drr::SourcePattern src = ctx->SourcePattern();
+    const auto &norm =
+        src.Op("pd_op.rms_norm",
+               {{"epsilon", src.Attr("epsilon")},
+                {"begin_norm_axis", src.Attr("begin_norm_axis")},
+                {"quant_scale", src.Attr("quant_scale")}});
+    norm({&src.Tensor("x"),
+          &src.Tensor("bias"),
+          &src.Tensor("residual"),
+          &src.Tensor("norm_weight"),
+          &src.Tensor("norm_bias")},
+         {&src.Tensor("norm_out"), &src.Tensor("residual_out")});
+
+    const auto &abs = src.Op("pd_op.abs");
+    src.Tensor("abs_out") = abs(src.Tensor("norm_out"));
+    const auto &max_axis =
+        src.Op("pd_op.full_int_array", {{"value", src.Attr("max_axis")}});
+    const auto &max =
+        src.Op("pd_op.max", {{"keepdim", src.Attr("max_keepdim")}});
+    src.Tensor("abs_max") = max(src.Tensor("abs_out"), max_axis());
+
+    const auto &full_scale =
+        src.Op("pd_op.full", {{"value", src.Attr("scale_value")}});
+    const auto &scale =
+        src.Op("pd_op.scale", {{"bias", src.Attr("scale_bias")}});
+    src.Tensor("scale_out") = scale(src.Tensor("norm_out"), full_scale());
+    const auto &divide = src.Op("pd_op.divide");
+    src.Tensor("divide_out") =
+        divide(src.Tensor("scale_out"), src.Tensor("abs_max"));
+    BuildQuantSourcePattern(&src, "divide_out");
+
+    const auto &full_dequant_scale =
+        src.Op("pd_op.full", {{"value", src.Attr("dequant_scale_value")}});
+    const auto &dequant_scale =
+        src.Op("pd_op.scale", {{"bias", src.Attr("dequant_scale_bias")}});
+    src.Tensor("dequant_scale") =
+        dequant_scale(src.Tensor("abs_max"), full_dequant_scale());
+
+    //
+    // Constraints.
+    //
+    src.RequireNativeCall([](const pir::drr::MatchContext &match_ctx) -> bool {
+      if (match_ctx.Attr<float>("quant_scale") > 0.0f) return false;
+      if (!MatchQuant(match_ctx)) return false;
+      // the abs max is of the rows normalized on the last axis
+      const int rank = match_ctx.Tensor("norm_out").Shape().size();
+      const auto &max_axis = match_ctx.Attr<std::vector<int64_t>>("max_axis");
+      if (rank < 1 || match_ctx.Attr<int>("begin_norm_axis") != rank - 1 ||
+          max_axis.size() != 1 || !match_ctx.Attr<bool>("max_keepdim") ||
+          (max_axis[0] != -1 && max_axis[0] != rank - 1)) {
+        return false;
+      }
+      const float clip_max = match_ctx.Attr<float>("clip_max");
+      return match_ctx.Attr<float>("scale_bias") == 0.0f &&
+             match_ctx.Attr<float>("dequant_scale_bias") == 0.0f &&
+             NearlyEqual(match_ctx.Attr<float>("scale_value"), clip_max) &&
+             NearlyEqual(match_ctx.Attr<float>("dequant_scale_value"),
+                         1.0f / clip_max);
+    });
+
+    //
+    // Result Pattern.
+    //
+    pir::drr::ResultPattern res = src.ResultPattern();
+    const auto &fused_norm = res.Op(
+        "pd_op.fused_rms_norm_quant",
+        {{"epsilon", src.Attr("epsilon")},
+         {"begin_norm_axis", src.Attr("begin_norm_axis")},
+         {"quant_round_type",
+          res.Attr([](const pir::drr::MatchContext &match_ctx) -> int {
+            return 1;
+          })},
+         {"quant_max_bound",
+          res.Attr([](const pir::drr::MatchContext &match_ctx) -> float {
+            return match_ctx.Attr<float>("clip_max");
+          })},
+         {"quant_min_bound",
+          res.Attr([](const pir::drr::MatchContext &match_ctx) -> float {
+            return match_ctx.Attr<float>("clip_min");
+          })}});
+    fused_norm({&res.Tensor("x"),
+                &res.Tensor("bias"),
+                &res.Tensor("residual"),
+                &res.Tensor("norm_weight"),
+                &res.Tensor("norm_bias")},
+               {&res.Tensor("quant_out"),
+                &res.Tensor("residual_out"),
+                &res.Tensor("dequant_scale")});
+  }
+};
+
+// Fuses the int8 quantization of the activations after the norms, which the
+// quantized inference runs before every quantized matmul of a transformer
+// block, into the norms, so that the normalized activations are written once
+// in int8 with the residual in the same pass.
+class NormQuantFusePass : public pir::PatternRewritePass {
+ public:
+  NormQuantFusePass() : pir::PatternRewritePass("norm_quant_fuse_pass", 2) {}
+
+  pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
+    pir::RewritePatternSet ps(context);
+    ps.Add(RmsNormPerTokenQuantFusePattern().Build(context));
+    ps.Add(NormStaticQuantFusePattern<false>().Build(context));
+    ps.Add(NormStaticQuantFusePattern<true>().Build(context));
+    return ps;
+  }
+};
+
+}  // namespace
+
+namespace pir {
+std::unique_ptr<Pass> CreateNormQuantFusePass() {
+  return std::make_unique<NormQuantFusePass>();
+}
+}  // namespace pir
+
+REGISTER_IR_PASS(norm_quant_fuse_pass, NormQuantFusePass);
@@ -15,7 +15,9 @@
 #include <numeric>
 #include <regex>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "paddle/fluid/pir/dialect/kernel/ir/kernel_attribute.h"
 #include "paddle/fluid/pir/dialect/kernel/ir/kernel_dialect.h"
@@ -31,6 +33,7 @@
 #include "paddle/phi/core/flags.h"
 #include "paddle/pir/core/builtin_op.h"
 #include "paddle/pir/core/operation.h"
+#include "paddle/pir/dialect/control_flow/ir/cf_op.h"
 #include "paddle/pir/pass/pass.h"
 #include "paddle/pir/pass/pass_registry.h"
 
@@ -46,6 +49,77 @@ static std::unordered_set<std::string> relaxing_op_list = {
     paddle::dialect::AddGradOp::name(),
 };
 
+// NOTE(zhangbo): The ops whose kernels only make views of their first inputs,
+// which share the buffers with them. The other view kernels, e.g. the strided
+// ones of reshape and slice, are not selected by the pir executor.
+static std::unordered_set<std::string> view_op_list = {
+    "pd_op.as_strided",
+    "pd_op.view_shape",
+    "pd_op.view_dtype",
+    "pd_op.tensor_unfold",
+    "pd_op.share_data",
+};
+
+// The alias classes of the values sharing one buffer, e.g. the views and
+// their inputs, the outputs of the inplace ops and their inputs, and the
+// results of the control flow ops and the values yielded to them.
+class ValueAliases {
+ public:
+  void Union(pir::Value a, pir::Value b) {
+    if (!a || !b) {
+      return;
+    }
+    pir::Value root_a = Find(a);
+    pir::Value root_b = Find(b);
+    if (root_a == root_b) {
+      return;
+    }
+    if (MutableMembers(root_a).size() < MutableMembers(root_b).size()) {
+      std::swap(root_a, root_b);
+    }
+    auto& members_a = MutableMembers(root_a);
+    auto& members_b = MutableMembers(root_b);
+    parent_[root_b] = root_a;
+    members_a.insert(members_a.end(), members_b.begin(), members_b.end());
+    members_.erase(root_b);
+  }
+
+  // The values sharing the buffer with value, including itself.
+  std::vector<pir::Value> Members(pir::Value value) {
+    auto it = members_.find(Find(value));
+    if (it == members_.end()) {
+      return {value};
+    }
+    return it->second;
+  }
+
+ private:
+  pir::Value Find(pir::Value value) {
+    pir::Value root = value;
+    for (auto it = parent_.find(root); it != parent_.end();
+         it = parent_.find(root)) {
+      root = it->second;
+    }
+    while (value != root) {
+      pir::Value& parent = parent_[value];
+      value = parent;
+      parent = root;
+    }
+    return root;
+  }
+
+  std::vector<pir::Value>& MutableMembers(pir::Value root) {
+    auto& members = members_[root];
+    if (members.empty()) {
+      members.push_back(root);
+    }
+    return members;
+  }
+
+  std::unordered_map<pir::Value, pir::Value> parent_;
+  std::unordered_map<pir::Value, std::vector<pir::Value>> members_;
+};
+
 // NOTE(zhangbo): Which kind of value can be deleted?
 // (1) Value's type needs to be AllocatedDenseTensorType or
 // AllocatedSelectedRowsType; (2) Value's is not persisable.
@@ -204,9 +278,57 @@ static std::unordered_set<pir::Value> GetSkipDeletionValues(pir::Block* block) {
       continue;
     }
   }
+  for (auto& op : *block) {
+    std::vector<pir::Block*> sub_blocks;
+    if (op.isa<paddle::dialect::IfOp>()) {
+      auto if_op = op.dyn_cast<paddle::dialect::IfOp>();
+      sub_blocks = {&if_op.true_block(), &if_op.false_block()};
+    } else if (op.isa<paddle::dialect::WhileOp>()) {
+      sub_blocks = {&op.dyn_cast<paddle::dialect::WhileOp>().body()};
+    }
+    for (auto* sub_block : sub_blocks) {
+      auto sub_skip_dels = GetSkipDeletionValues(sub_block);
+      skip_dels.insert(sub_skip_dels.begin(), sub_skip_dels.end());
+    }
+  }
   return skip_dels;
 }
 
+static void GetExternalValues(pir::Block* block,
+                              std::unordered_set<pir::Value>* defined,
+                              std::unordered_set<pir::Value>* externals) {
+  for (size_t i = 0; i < block->args_size(); ++i) {
+    defined->insert(block->arg(i));
+  }
+  for (auto& op : *block) {
+    for (size_t i = 0; i < op.num_operands(); ++i) {
+      auto input = op.operand_source(i);
+      if (input && defined->count(input) == 0) {
+        externals->insert(input);
+      }
+    }
+    if (op.isa<paddle::dialect::IfOp>()) {
+      auto if_op = op.dyn_cast<paddle::dialect::IfOp>();
+      GetExternalValues(&if_op.true_block(), defined, externals);
+      GetExternalValues(&if_op.false_block(), defined, externals);
+    } else if (op.isa<paddle::dialect::WhileOp>()) {
+      GetExternalValues(
+          &op.dyn_cast<paddle::dialect::WhileOp>().body(), defined, externals);
+    }
+    for (auto& result : op.results()) {
+      defined->insert(result);
+    }
+  }
+}
+
+// Returns the values used in block or its nested blocks but defined outside.
+static std::unordered_set<pir::Value> GetExternalValues(pir::Block* block) {
+  std::unordered_set<pir::Value> defined;
+  std::unordered_set<pir::Value> externals;
+  GetExternalValues(block, &defined, &externals);
+  return externals;
+}
+
 // NOTE(zhangbo): For inplace Pass, currently only the kernel_dialect operator
 // is supported. Therefore, this function only returns the values in the
 // kernel_dialect operator that can be eager deleted.
@@ -253,40 +375,182 @@ static void GetEagerDelValueOfOp(
       GetEagerDelValueOfOp(&if_op.false_block(), skip_dels, del_value_2_op);
       VLOG(8) << "GetEagerDelValueOfOp for IfOp false block";
     }
+
+    if (op.isa<paddle::dialect::WhileOp>()) {
+      auto while_op = op.dyn_cast<paddle::dialect::WhileOp>();
+      GetEagerDelValueOfOp(&while_op.body(), skip_dels, del_value_2_op);
+      VLOG(8) << "GetEagerDelValueOfOp for WhileOp body block";
+      // NOTE(zhangbo): The values from outside of the loop are used by every
+      // iteration, so that they are alive until the end of the while op.
+      for (auto value : GetExternalValues(&while_op.body())) {
+        if (del_value_2_op->count(value) > 0) {
+          (*del_value_2_op)[value] = &op;
+        }
+      }
+    }
   }
 }
 
-static std::unordered_map<pir::Operation*, std::unordered_set<pir::Value>>
-GetEagerDeletionValues(pir::Block* block) {
-  std::unordered_set<pir::Value> skip_dels = GetSkipDeletionValues(block);
-
+// The analysis shared by the blocks of a program, of which the inplace ops
+// are decided in the program order.
+struct InplaceContext {
+  std::unordered_set<pir::Value> skip_dels;
   std::unordered_map<pir::Value, pir::Operation*> del_value_2_op;
-  GetEagerDelValueOfOp(block, skip_dels, &del_value_2_op);
-
   std::unordered_map<pir::Operation*, std::unordered_set<pir::Value>>
       eager_dels;
-  for (auto& kv : del_value_2_op) {
-    eager_dels[kv.second].insert(kv.first);
+  // the positions of the ops in the post order, where the ops of a block run
+  // before the control flow op owning it
+  std::unordered_map<pir::Operation*, size_t> op_pos;
+  ValueAliases aliases;
+  std::unordered_set<std::string> blacklist;
+
+  std::unordered_set<pir::Value> visited_values;
+  std::unordered_set<pir::Value> reused_input_values;
+  std::unordered_set<pir::Value> reused_output_values;
+};
+
+// Unions the results of the inplace op with the inputs whose buffers they
+// reuse or view.
+static void UnionInplaceResults(pir::Operation* op,
+                                const std::string& op_name,
+                                ValueAliases* aliases) {
+  pir::OpInfo op_info =
+      pir::IrContext::Instance()->GetRegisteredOpInfo(op_name);
+  if (!op_info) {
+    return;
+  }
+  auto info_interface =
+      op_info.GetInterfaceImpl<paddle::dialect::OpYamlInfoInterface>();
+  if (!info_interface) {
+    return;
   }
+  paddle::dialect::OpYamlInfoParser info_parser(
+      info_interface->get_op_info_(), paddle::dialect::IsLegacyOp(op_name));
+  const auto& output_names = info_parser.OutputNames();
+  for (size_t i = 0; i < output_names.size() && i < op->num_results(); ++i) {
+    std::string input_name;
+    if (info_parser.HasInplace(output_names[i])) {
+      input_name = info_parser.InplaceName(output_names[i]);
+    } else if (info_parser.HasView(output_names[i])) {
+      input_name = info_parser.ViewName(output_names[i]);
+    } else {
+      continue;
+    }
+    auto it = info_parser.InputName2Id().find(input_name);
+    if (it != info_parser.InputName2Id().end() &&
+        it->second < op->num_operands()) {
+      aliases->Union(op->result(i), op->operand_source(it->second));
+    }
+  }
+}
 
-  return eager_dels;
+static void UnionYieldedValues(pir::Block* block,
+                               pir::Operation* op,
+                               size_t yield_offset,
+                               ValueAliases* aliases) {
+  if (block->empty() || !block->back().isa<pir::YieldOp>()) {
+    return;
+  }
+  auto& yield_op = block->back();
+  for (size_t i = 0;
+       i < op->num_results() && i + yield_offset < yield_op.num_operands();
+       ++i) {
+    aliases->Union(op->result(i), yield_op.operand_source(i + yield_offset));
+  }
 }
 
-static std::unordered_map<pir::Operation*, std::string> GetInplaceOps(
-    pir::Block* block) {
-  const auto eager_dels = GetEagerDeletionValues(block);
+static void AnalyseBlock(pir::Block* block, InplaceContext* ctx) {
+  for (auto& op : *block) {
+    if (op.isa<paddle::dialect::IfOp>()) {
+      auto if_op = op.dyn_cast<paddle::dialect::IfOp>();
+      for (auto* sub_block : {&if_op.true_block(), &if_op.false_block()}) {
+        AnalyseBlock(sub_block, ctx);
+        UnionYieldedValues(sub_block, &op, 0, &ctx->aliases);
+      }
+    } else if (op.isa<paddle::dialect::WhileOp>()) {
+      // NOTE(zhangbo): The results of the while op share the buffers with its
+      // inputs before the loop, and with the values yielded by the body of
+      // the last iteration, while the block arguments of the body are copied
+      // from them in every iteration.
+      auto while_op = op.dyn_cast<paddle::dialect::WhileOp>();
+      AnalyseBlock(&while_op.body(), ctx);
+      UnionYieldedValues(&while_op.body(), &op, 1, &ctx->aliases);
+      if (!while_op.body().empty() &&
+          while_op.body().back().isa<pir::YieldOp>()) {
+        ctx->aliases.Union(op.operand_source(0),
+                           while_op.body().back().operand_source(0));
+      }
+      for (size_t i = 0; i < op.num_results() && i + 1 < op.num_operands();
+           ++i) {
+        ctx->aliases.Union(op.result(i), op.operand_source(i + 1));
+      }
+    } else if (op.dialect()->name().compare(
+                   paddle::dialect::KernelDialect::name()) == 0) {
+      auto op_name = op.attributes()
+                         .at("op_name")
+                         .dyn_cast<pir::StrAttribute>()
+                         .AsString();
+      if (view_op_list.count(op_name) > 0 && op.num_operands() > 0) {
+        for (auto& result : op.results()) {
+          ctx->aliases.Union(result, op.operand_source(0));
+        }
+      } else if (op.attributes().count("is_inplace") != 0 &&
+                 op.attributes()
+                     .at("is_inplace")
+                     .dyn_cast<pir::BoolAttribute>()
+                     .data()) {
+        UnionInplaceResults(&op, op_name, &ctx->aliases);
+      }
+    }
+    size_t pos = ctx->op_pos.size();
+    ctx->op_pos[&op] = pos;
+  }
+}
 
-  std::unordered_map<pir::Operation*, std::string> inplace_ops;
+// Whether the buffer of input is no longer used after op by the other values
+// sharing it, so that op can write its output into the buffer.
+static bool IsBufferDeadAfter(InplaceContext* ctx,
+                              pir::Value input,
+                              pir::Operation* op) {
+  const size_t op_pos = ctx->op_pos.at(op);
+  for (auto alias : ctx->aliases.Members(input)) {
+    if (alias == input) {
+      continue;
+    }
+    auto it = ctx->del_value_2_op.find(alias);
+    if (ctx->skip_dels.count(alias) > 0 || !CanBeDeleted(alias) ||
+        it == ctx->del_value_2_op.end() ||
+        ctx->op_pos.at(it->second) >= op_pos) {
+      VLOG(8) << " -- the buffer is still used by its alias after the op";
+      return false;
+    }
+  }
+  return true;
+}
 
-  std::unordered_set<pir::Value> visited_values;
-  std::unordered_set<pir::Value> reused_input_values;
-  std::unordered_set<pir::Value> reused_output_values;
+static void GetInplaceOpsOfBlock(
+    pir::Block* block,
+    InplaceContext* ctx,
+    std::unordered_map<pir::Operation*, std::string>* inplace_ops) {
+  const auto& eager_dels = ctx->eager_dels;
+  auto& visited_values = ctx->visited_values;
+  auto& reused_input_values = ctx->reused_input_values;
+  auto& reused_output_values = ctx->reused_output_values;
 
   for (auto& op : *block) {
     for (size_t i = 0; i < op.num_operands(); ++i) {
       visited_values.insert(op.operand_source(i));
     }
 
+    if (op.isa<paddle::dialect::IfOp>()) {
+      auto if_op = op.dyn_cast<paddle::dialect::IfOp>();
+      GetInplaceOpsOfBlock(&if_op.true_block(), ctx, inplace_ops);
+      GetInplaceOpsOfBlock(&if_op.false_block(), ctx, inplace_ops);
+    } else if (op.isa<paddle::dialect::WhileOp>()) {
+      GetInplaceOpsOfBlock(
+          &op.dyn_cast<paddle::dialect::WhileOp>().body(), ctx, inplace_ops);
+    }
+
     if (op.dialect()->name().compare(paddle::dialect::KernelDialect::name()) !=
         0) {
       VLOG(6) << op.name()
@@ -334,16 +598,7 @@ static std::unordered_map<pir::Operation*, std::string> GetInplaceOps(
     pir::OpInfo upper_inplace_op_info =
         pir::IrContext::Instance()->GetRegisteredOpInfo(upper_op_name + "_");
 
-    std::regex reg(",");
-    std::unordered_set<std::string> elems{
-        std::sregex_token_iterator(FLAGS_ir_inplace_kernel_blacklist.begin(),
-                                   FLAGS_ir_inplace_kernel_blacklist.end(),
-                                   reg,
-                                   -1),
-        std::sregex_token_iterator()};
-    elems.erase("");
-
-    if (elems.count(upper_op_name)) {
+    if (ctx->blacklist.count(upper_op_name)) {
       VLOG(6) << upper_op_name
               << "'s value can't delete or doesn't have inplace op, so that "
                  "can't do inplace.";
@@ -391,7 +646,8 @@ static std::unordered_map<pir::Operation*, std::string> GetInplaceOps(
           (visited_values.count(op.result(out_slot)) > 0) ||
           (!CanBeDeleted(op.result(out_slot))) ||
           (reused_input_values.count(op.operand_source(in_slot)) > 0) ||
-          (reused_output_values.count(op.result(out_slot)) > 0)) {
+          (reused_output_values.count(op.result(out_slot)) > 0) ||
+          (!IsBufferDeadAfter(ctx, op.operand_source(in_slot), &op))) {
         can_do_inplace = false;
         VLOG(6) << upper_op_name
                 << "'s value has been visited or reused by other inplace op, "
@@ -418,11 +674,12 @@ static std::unordered_map<pir::Operation*, std::string> GetInplaceOps(
       }
     }
     if (can_do_inplace) {
-      inplace_ops[&op] = upper_op_name + "_";
+      (*inplace_ops)[&op] = upper_op_name + "_";
       for (auto& kv : inplace_out_2_in) {
         reused_input_values.insert(op.operand_source(kv.second));
         reused_output_values.insert(op.result(kv.first));
       }
+      UnionInplaceResults(&op, upper_op_name + "_", &ctx->aliases);
       VLOG(6) << upper_op_name
               << " will change to inplace version op: " << upper_op_name + "_";
     }
@@ -431,6 +688,33 @@ static std::unordered_map<pir::Operation*, std::string> GetInplaceOps(
       visited_values.insert(result);
     }
   }
+}
+
+// NOTE(zhangbo): The ops in the blocks of the control flow ops are analysed as
+// well. A value from outside of a loop can't be reused by the ops in its body,
+// while a block argument of the body, which holds the loop state copied from
+// the last iteration, can, so that the state is updated in place.
+static std::unordered_map<pir::Operation*, std::string> GetInplaceOps(
+    pir::Block* block) {
+  InplaceContext ctx;
+  ctx.skip_dels = GetSkipDeletionValues(block);
+  GetEagerDelValueOfOp(block, ctx.skip_dels, &ctx.del_value_2_op);
+  for (auto& kv : ctx.del_value_2_op) {
+    ctx.eager_dels[kv.second].insert(kv.first);
+  }
+  AnalyseBlock(block, &ctx);
+
+  std::regex reg(",");
+  ctx.blacklist = std::unordered_set<std::string>{
+      std::sregex_token_iterator(FLAGS_ir_inplace_kernel_blacklist.begin(),
+                                 FLAGS_ir_inplace_kernel_blacklist.end(),
+                                 reg,
+                                 -1),
+      std::sregex_token_iterator()};
+  ctx.blacklist.erase("");
+
+  std::unordered_map<pir::Operation*, std::string> inplace_ops;
+  GetInplaceOpsOfBlock(block, &ctx, &inplace_ops);
   if (!FLAGS_ir_inplace_kernel_blacklist.empty()) {
     for (auto i : inplace_ops) {
       std::cout << i.second << std::endl;
@@ -457,9 +741,10 @@ class InplacePass : public pir::Pass {
                      .at("op_name")
                      .dyn_cast<pir::StrAttribute>()
                      .AsString();
+      pir::Block* op_block = kv.first->GetParent();
       pir::Block::Iterator insert_pos =
-          std::find(block.begin(), block.end(), *kv.first);
-      IR_ENFORCE(insert_pos != block.end(),
+          std::find(op_block->begin(), op_block->end(), *kv.first);
+      IR_ENFORCE(insert_pos != op_block->end(),
                  "Operator %s not found in block.",
                  kv.first->name());
 
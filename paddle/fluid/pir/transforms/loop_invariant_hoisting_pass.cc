@@ -0,0 +1,196 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/loop_invariant_hoisting_pass.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "paddle/fluid/framework/new_executor/instruction/instruction_util.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/control_flow_op.h"
+#include "paddle/pir/core/builtin_attribute.h"
+#include "paddle/pir/core/builtin_op.h"
+#include "paddle/pir/core/op_trait.h"
+#include "paddle/pir/core/operation.h"
+#include "paddle/pir/pass/pass.h"
+#include "paddle/pir/pass/pass_registry.h"
+
+namespace {
+
+// The views and the inplace ops share the buffers of their inputs, so an
+// invariant used by them may be updated in the loop.
+static std::unordered_set<std::string> view_op_list = {
+    "pd_op.as_strided",
+    "pd_op.view_shape",
+    "pd_op.view_dtype",
+    "pd_op.tensor_unfold",
+    "pd_op.share_data",
+};
+
+static bool IsKernelOp(const pir::Operation& op) {
+  return op.dialect()->name().compare(
+             paddle::dialect::KernelDialect::name()) == 0;
+}
+
+static std::string KernelOpName(const pir::Operation& op) {
+  return op.attributes().at("op_name").dyn_cast<pir::StrAttribute>().AsString();
+}
+
+static bool IsInplaceOp(const pir::Operation& op) {
+  return op.attributes().count("is_inplace") != 0 &&
+         op.attributes().at("is_inplace").dyn_cast<pir::BoolAttribute>().data();
+}
+
+static bool IsDefinedInBlock(pir::Value value, const pir::Block* block) {
+  pir::Block* owner = nullptr;
+  if (auto arg = value.dyn_cast<pir::BlockArgument>()) {
+    owner = arg.owner();
+  } else if (value.defining_op()) {
+    owner = value.defining_op()->GetParent();
+  }
+  while (owner != nullptr) {
+    if (owner == block) {
+      return true;
+    }
+    auto* parent_op = owner->GetParentOp();
+    owner = parent_op ? parent_op->GetParent() : nullptr;
+  }
+  return false;
+}
+
+static bool CanBeHoisted(const pir::Operation& op) {
+  if (op.num_regions() > 0 || op.num_results() == 0 ||
+      op.HasTrait<pir::SideEffectTrait>()) {
+    return false;
+  }
+  if (op.isa<pir::CombineOp>() || op.isa<pir::SliceOp>() ||
+      op.isa<pir::SplitOp>() || op.isa<pir::ConstantOp>()) {
+    return true;
+  }
+  if (!IsKernelOp(op) || IsInplaceOp(op)) {
+    return false;
+  }
+  const std::string op_name = KernelOpName(op);
+  return view_op_list.count(op_name) == 0 && !op.HasAttribute("seed") &&
+         paddle::framework::IsSpeculatableOp(op_name);
+}
+
+// Whether the results of the op are only read in the loop, that is they are
+// not viewed or updated in place by the users.
+static bool IsResultsReadOnly(pir::Operation* op) {
+  for (auto result : op->results()) {
+    for (auto it = result.use_begin(); it != result.use_end(); ++it) {
+      pir::Operation* user = it->owner();
+      if (!IsKernelOp(*user)) {
+        continue;
+      }
+      if (IsInplaceOp(*user) || view_op_list.count(KernelOpName(*user)) > 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static int64_t HoistBlock(pir::Block* block);
+
+// Moves the invariants of the body, in the order of the body, in front of the
+// while op. An op is invariant when its inputs are defined outside the body,
+// including the results of the invariants moved before it.
+static int64_t HoistWhileBody(pir::Operation* while_op) {
+  auto& body = while_op->dyn_cast<paddle::dialect::WhileOp>().body();
+  int64_t num_hoisted = HoistBlock(&body);
+
+  std::vector<pir::Operation*> invariants;
+  std::unordered_set<pir::Operation*> invariant_set;
+  for (auto& op : body) {
+    if (!CanBeHoisted(op) || !IsResultsReadOnly(&op)) {
+      continue;
+    }
+    bool is_invariant = true;
+    for (uint32_t i = 0; i < op.num_operands(); ++i) {
+      auto value = op.operand_source(i);
+      if (value && IsDefinedInBlock(value, &body) &&
+          invariant_set.count(value.defining_op()) == 0) {
+        is_invariant = false;
+        break;
+      }
+    }
+    if (is_invariant) {
+      invariants.push_back(&op);
+      invariant_set.insert(&op);
+    }
+  }
+
+  pir::Block* parent_block = while_op->GetParent();
+  auto while_pos =
+      std::find(parent_block->begin(), parent_block->end(), *while_op);
+  for (auto* op : invariants) {
+    op->MoveTo(parent_block, while_pos);
+  }
+  return num_hoisted + static_cast<int64_t>(invariants.size());
+}
+
+static int64_t HoistBlock(pir::Block* block) {
+  int64_t num_hoisted = 0;
+  std::vector<pir::Operation*> control_flow_ops;
+  for (auto& op : *block) {
+    if (op.isa<paddle::dialect::WhileOp>() || op.isa<paddle::dialect::IfOp>()) {
+      control_flow_ops.push_back(&op);
+    }
+  }
+  for (auto* op : control_flow_ops) {
+    if (op->isa<paddle::dialect::WhileOp>()) {
+      num_hoisted += HoistWhileBody(op);
+    } else {
+      // The ops of the branches only run on the condition, so only the loops
+      // in them are hoisted.
+      auto if_op = op->dyn_cast<paddle::dialect::IfOp>();
+      num_hoisted += HoistBlock(&if_op.true_block());
+      num_hoisted += HoistBlock(&if_op.false_block());
+    }
+  }
+  return num_hoisted;
+}
+
+class LoopInvariantHoistingPass : public pir::Pass {
+ public:
+  LoopInvariantHoistingPass() : pir::Pass("loop_invariant_hoisting_pass", 1) {}
+
+  void Run(pir::Operation* op) override {
+    auto module_op = op->dyn_cast<pir::ModuleOp>();
+    IR_ENFORCE(module_op,
+               "loop_invariant_hoisting_pass should run on module op.");
+    PrintStatistics(HoistBlock(&module_op.block()));
+  }
+
+  bool CanApplyOn(pir::Operation* op) const override {
+    return op->isa<::pir::ModuleOp>() && op->num_regions() > 0;
+  }
+};
+
+}  // namespace
+
+namespace pir {
+
+std::unique_ptr<Pass> CreateLoopInvariantHoistingPass() {
+  return std::make_unique<LoopInvariantHoistingPass>();
+}
+
+}  // namespace pir
+
+REGISTER_IR_PASS(loop_invariant_hoisting_pass, LoopInvariantHoistingPass);
@@ -16,6 +16,7 @@
 
 #include <iostream>
 
+#include "paddle/fluid/framework/new_executor/instruction/instruction_util.h"
 #include "paddle/fluid/framework/op_kernel_type.h"
 #include "paddle/fluid/pir/dialect/kernel/ir/kernel_attribute.h"
 #include "paddle/fluid/pir/dialect/kernel/ir/kernel_dialect.h"
@@ -45,6 +46,7 @@
 #include "paddle/utils/flags.h"
 
 PHI_DECLARE_bool(print_ir);
+PHI_DECLARE_int32(pir_if_select_on_device_max_ops);
 namespace paddle {
 namespace dialect {
 
@@ -860,6 +862,33 @@ phi::KernelKey GetKernelKey(
   return res;
 }
 
+// Whether the branches of the if op are cheap enough to both run, and have no
+// side effects, so that the condition can stay on the device and select their
+// outputs there.
+static bool CanSelectIfOnDevice(IfOp if_op) {
+  for (auto* block : {&if_op.true_block(), &if_op.false_block()}) {
+    int num_ops = 0;
+    for (auto& op : *block) {
+      if (op.isa<pir::YieldOp>()) {
+        continue;
+      }
+      if (op.num_regions() > 0 || op.HasTrait<InplaceTrait>() ||
+          op.HasAttribute("seed") ||
+          (op.dialect()->name() != OperatorDialect::name() &&
+           !op.isa<pir::CombineOp>() && !op.isa<pir::SliceOp>() &&
+           !op.isa<pir::SplitOp>()) ||
+          !framework::IsSpeculatableOp(op.name())) {
+        return false;
+      }
+      ++num_ops;
+    }
+    if (num_ops > FLAGS_pir_if_select_on_device_max_ops) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void HandleForIfOp(
     const phi::Place& place,
     pir::Operation* op_item,
@@ -876,11 +905,14 @@ void HandleForIfOp(
           "[%d]'s input of [%s] op MUST in map pair", 0, op_item->name()));
   auto new_cond = map_value_pair->at(old_cond);
 
-  // NOTE(zhangbo): IfOp's input cond should be a cpu type.
+  // NOTE(zhangbo): IfOp's input cond should be a cpu type, unless the outputs
+  // of its branches are selected on the device.
   AllocatedDenseTensorType new_cond_type =
       new_cond.type().dyn_cast<AllocatedDenseTensorType>();
   if (new_cond_type) {
-    if (new_cond_type.place().GetType() == phi::AllocationType::GPU) {
+    if (new_cond_type.place().GetType() == phi::AllocationType::GPU &&
+        !(FLAGS_pir_if_select_on_device_max_ops > 0 &&
+          CanSelectIfOnDevice(op_item->dyn_cast<IfOp>()))) {
       auto out_type = AllocatedDenseTensorType::get(
           ctx, phi::CPUPlace(), old_cond.type().dyn_cast<DenseTensorType>());
       phi::KernelKey kernel_key(
@@ -14,6 +14,18 @@ limitations under the License. */
 
 #include "paddle/fluid/platform/cpu_helper.h"
 
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "glog/logging.h"
+
 #ifdef PADDLE_WITH_MKLML
 #include <omp.h>
 
@@ -52,5 +64,82 @@ void SetNumThreads(int num_threads) {
 #endif
 }
 
+std::vector<int> GetNumaNodeCpus(int numa_node) {
+  std::vector<int> cpu_ids;
+  // the cpulist is like "0-15,32-47"
+  std::ifstream fin("/sys/devices/system/node/node" +
+                    std::to_string(numa_node) + "/cpulist");
+  std::string range;
+  while (std::getline(fin, range, ',')) {
+    int begin = 0, end = 0;
+    char dash = 0;
+    std::istringstream is(range);
+    is >> begin;
+    end = begin;
+    if (is >> dash >> end && dash != '-') {
+      end = begin;
+    }
+    for (int cpu = begin; cpu <= end; ++cpu) {
+      cpu_ids.push_back(cpu);
+    }
+  }
+  return cpu_ids;
+}
+
+void BindCurrentThread(const std::vector<int>& cpu_ids, int numa_node) {
+#ifdef __linux__
+  if (!cpu_ids.empty()) {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int cpu : cpu_ids) {
+      if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &mask);
+      }
+    }
+    if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+      LOG(WARNING) << "Failed to set the cpu affinity of thread "
+                   << syscall(SYS_gettid);
+    }
+  }
+  if (numa_node >= 0) {
+    // MPOL_PREFERRED of numaif.h, falls back to the other nodes when the
+    // memory of numa_node is exhausted
+    const int kPreferred = 1;
+    const int kMaxNode = 1024;
+    std::vector<uint64_t> nodemask(kMaxNode / 64, 0);
+    nodemask[numa_node / 64] |= 1ULL << (numa_node % 64);
+    if (syscall(SYS_set_mempolicy, kPreferred, nodemask.data(), kMaxNode) !=
+        0) {
+      LOG(WARNING) << "Failed to set the memory policy of thread "
+                   << syscall(SYS_gettid) << " to numa node " << numa_node;
+    }
+  }
+#else
+  VLOG(3) << "Binding threads to cpus is only supported on linux.";
+#endif
+}
+
+void SetCpuAffinity(const std::vector<int>& cpu_ids, int numa_node) {
+  thread_local std::vector<int> bound_cpu_ids;
+  thread_local int bound_numa_node = -1;
+  if (cpu_ids.empty() ||
+      (cpu_ids == bound_cpu_ids && numa_node == bound_numa_node)) {
+    return;
+  }
+  bound_cpu_ids = cpu_ids;
+  bound_numa_node = numa_node;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel
+  {
+    int thread_id = omp_get_thread_num();
+    BindCurrentThread({cpu_ids[thread_id % cpu_ids.size()]}, numa_node);
+  }
+#else
+  BindCurrentThread({cpu_ids[0]}, numa_node);
+#endif
+  VLOG(3) << "Bind the cpu math library threads to " << cpu_ids.size()
+          << " cpus, numa node " << numa_node;
+}
+
 }  // namespace platform
 }  // namespace paddle
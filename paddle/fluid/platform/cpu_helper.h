@@ -16,11 +16,25 @@ limitations under the License. */
 
 #include <stddef.h>
 
+#include <vector>
+
 namespace paddle {
 namespace platform {
 
 //! Set the number of threads in use.
 void SetNumThreads(int num_threads);
 
+//! Get the cpus of a numa node, empty if the node is not found.
+std::vector<int> GetNumaNodeCpus(int numa_node);
+
+//! Bind the calling thread to cpu_ids, and allocate the memory of it from
+//! numa_node preferably if numa_node is not -1.
+void BindCurrentThread(const std::vector<int>& cpu_ids, int numa_node = -1);
+
+//! Bind the threads of cpu math library in use one to a cpu of cpu_ids, the
+//! calling thread takes the first cpu. Nothing is done if the calling thread
+//! has been bound to the same cpus by this function.
+void SetCpuAffinity(const std::vector<int>& cpu_ids, int numa_node = -1);
+
 }  // namespace platform
 }  // namespace paddle
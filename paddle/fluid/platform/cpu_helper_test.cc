@@ -14,9 +14,33 @@ limitations under the License. */
 
 #include "paddle/fluid/platform/cpu_helper.h"
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 #include "gtest/gtest.h"
 
 TEST(CpuHelper, SetNumThread) {
   paddle::platform::SetNumThreads(1);
   paddle::platform::SetNumThreads(4);
 }
+
+#ifdef __linux__
+TEST(CpuHelper, BindCurrentThread) {
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  ASSERT_EQ(sched_getaffinity(0, sizeof(mask), &mask), 0);
+  int cpu = 0;
+  while (!CPU_ISSET(cpu, &mask)) {
+    ++cpu;
+  }
+  paddle::platform::BindCurrentThread({cpu});
+  CPU_ZERO(&mask);
+  ASSERT_EQ(sched_getaffinity(0, sizeof(mask), &mask), 0);
+  ASSERT_EQ(CPU_COUNT(&mask), 1);
+  ASSERT_TRUE(CPU_ISSET(cpu, &mask));
+
+  // the cpus of a node not existing are empty
+  ASSERT_TRUE(paddle::platform::GetNumaNodeCpus(100000).empty());
+}
+#endif
@@ -170,6 +170,58 @@ void TestTensorUtils(const paddle::platform::Place& place) {
 #endif
 }
 
+void TestBatchedMemoryCopy(const paddle::platform::Place& place) {
+  std::cout << "TestBatchedMemoryCopy on " << place << std::endl;
+  if (paddle::platform::is_custom_place(place) == false) {
+    return;
+  }
+  auto device = phi::DeviceManager::GetDeviceWithPlace(place);
+  std::array<int, 3> src0 = {1, 2, 3};
+  std::array<int, 2> src1 = {4, 5};
+  std::array<int, 3> dst0 = {0, 0, 0};
+  std::array<int, 2> dst1 = {0, 0};
+  void* dev_ptrs[] = {device->MemoryAllocate(sizeof(src0)),
+                      device->MemoryAllocate(sizeof(src1))};
+  const void* src_ptrs[] = {src0.data(), src1.data()};
+  void* dst_ptrs[] = {dst0.data(), dst1.data()};
+  const void* const_dev_ptrs[] = {dev_ptrs[0], dev_ptrs[1]};
+  size_t sizes[] = {sizeof(src0), sizeof(src1)};
+
+  // the fake device never reads its stream handles
+  int stream_handle = 0;
+  phi::stream::Stream stream(place, &stream_handle);
+  device->MemoryCopyH2DBatch(dev_ptrs, src_ptrs, sizes, 2, &stream);
+  device->MemoryCopyD2HBatch(dst_ptrs, const_dev_ptrs, sizes, 2, &stream);
+  EXPECT_EQ(dst0, src0);
+  EXPECT_EQ(dst1, src1);
+
+  // without a stream, the copies are done one by one
+  dst0.fill(0);
+  device->MemoryCopyD2HBatch(dst_ptrs, const_dev_ptrs, sizes, 1);
+  EXPECT_EQ(dst0, src0);
+
+  device->MemoryDeallocate(dev_ptrs[0], sizeof(src0));
+  device->MemoryDeallocate(dev_ptrs[1], sizeof(src1));
+}
+
+void TestPooledEvent(const paddle::platform::Place& place) {
+  std::cout << "TestPooledEvent on " << place << std::endl;
+  if (paddle::platform::is_custom_place(place) == false) {
+    return;
+  }
+  EXPECT_TRUE(phi::DeviceManager::IsStreamOrderedAllocatorSupported(place));
+  phi::event::event_t raw_event = nullptr;
+  {
+    auto event = phi::DeviceManager::GetPooledEvent(place);
+    raw_event = event->raw_event();
+    EXPECT_NE(raw_event, nullptr);
+  }
+  auto event = phi::DeviceManager::GetPooledEvent(place);
+  EXPECT_EQ(event->raw_event(), raw_event);
+  auto another_event = phi::DeviceManager::GetPooledEvent(place);
+  EXPECT_NE(another_event->raw_event(), raw_event);
+}
+
 void TestCustomCCL(const paddle::platform::Place& place) {
   std::cout << "TestCustomCCL on " << place << std::endl;
   if (paddle::platform::is_custom_place(place) == false) {
@@ -255,6 +307,8 @@ TEST(CustomDevice, Tensor) {
     TestTensorMutableData(place);
     TestTensorShareDataWith(place);
     TestTensorUtils(place);
+    TestBatchedMemoryCopy(place);
+    TestPooledEvent(place);
     TestCustomCCL(place);
   }
 }
@@ -30,7 +30,15 @@ namespace dynload {
   __macro(nvjpegJpegStateCreate);         \
   __macro(nvjpegGetImageInfo);            \
   __macro(nvjpegJpegStateDestroy);        \
-  __macro(nvjpegDecode);
+  __macro(nvjpegDecode);                  \
+  __macro(nvjpegCreateEx);                \
+  __macro(nvjpegDestroy);                 \
+  __macro(nvjpegDecodeBatchedInitialize); \
+  __macro(nvjpegDecodeBatched);           \
+  __macro(nvjpegDecodeBatchedSupported);  \
+  __macro(nvjpegJpegStreamCreate);        \
+  __macro(nvjpegJpegStreamParse);         \
+  __macro(nvjpegJpegStreamDestroy);
 
 NVJPEG_RAND_ROUTINE_EACH(PLATFORM_DECLARE_DYNAMIC_LOAD_NVJPEG_WRAP);
 
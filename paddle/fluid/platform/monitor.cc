@@ -36,3 +36,7 @@ DEFINE_INT_STATUS(STAT_gpu12_mem_size)
 DEFINE_INT_STATUS(STAT_gpu13_mem_size)
 DEFINE_INT_STATUS(STAT_gpu14_mem_size)
 DEFINE_INT_STATUS(STAT_gpu15_mem_size)
+
+// the latencies in microseconds
+DEFINE_HISTOGRAM_STATUS(STAT_executor_run_us)
+DEFINE_HISTOGRAM_STATUS(STAT_predictor_run_us)
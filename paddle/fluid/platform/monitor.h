@@ -16,7 +16,9 @@
 
 #include <stdio.h>
 
+#include <array>
 #include <atomic>
+#include <chrono>  // NOLINT
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
@@ -70,6 +72,27 @@ class StatValue : public MonitorRegistrar {
   }
 };
 
+// The counters and gauges of int64_t are updated by atomics instead of lock,
+// since they are on the hot paths of the executors and tables.
+template <>
+class StatValue<int64_t> : public MonitorRegistrar {
+  std::atomic<int64_t> v_{0};
+
+ public:
+  explicit StatValue(const std::string& n);
+  int64_t increase(int64_t inc) {
+    return v_.fetch_add(inc, std::memory_order_relaxed) + inc;
+  }
+  int64_t decrease(int64_t inc) {
+    return v_.fetch_sub(inc, std::memory_order_relaxed) - inc;
+  }
+  int64_t reset(int64_t value = 0) {
+    v_.store(value, std::memory_order_relaxed);
+    return value;
+  }
+  int64_t get() { return v_.load(std::memory_order_relaxed); }
+};
+
 template <typename T>
 struct ExportedStatValue {
   std::string key;
@@ -127,6 +150,148 @@ class StatRegistry {
   std::unordered_map<std::string, StatValue<T>*> stats_;
 };
 
+inline StatValue<int64_t>::StatValue(const std::string& n) {
+  StatRegistry<int64_t>::Instance().add(n, this);
+}
+
+struct ExportedStatHistogram {
+  std::string key;
+  int64_t count;
+  int64_t sum;
+  // buckets[0] counts the values <= 0, and buckets[i] counts the values in
+  // [2^(i-1), 2^i), the last one counts all the larger values.
+  std::vector<int64_t> buckets;
+};
+
+// A histogram of the values by power of 2 buckets, e.g. the latencies in
+// microseconds. It is lock free, and the threads observe into different
+// shards to avoid contending on the same cache line.
+class StatHistogram : public MonitorRegistrar {
+ public:
+  static constexpr size_t kBucketNum = 32;
+  static constexpr size_t kShardNum = 8;
+
+  explicit StatHistogram(const std::string& n);
+
+  void observe(int64_t value) {
+    size_t bucket = 0;
+    for (int64_t v = value; v > 0 && bucket + 1 < kBucketNum; v >>= 1) {
+      ++bucket;
+    }
+    auto& shard = shards_[ShardIndex()];
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+    shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void reset() {
+    for (auto& shard : shards_) {
+      shard.count.store(0, std::memory_order_relaxed);
+      shard.sum.store(0, std::memory_order_relaxed);
+      for (auto& bucket : shard.buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // sums up the shards, the result may miss the concurrent observations
+  void get(ExportedStatHistogram* exported) {
+    exported->count = 0;
+    exported->sum = 0;
+    exported->buckets.assign(kBucketNum, 0);
+    for (auto& shard : shards_) {
+      exported->count += shard.count.load(std::memory_order_relaxed);
+      exported->sum += shard.sum.load(std::memory_order_relaxed);
+      for (size_t i = 0; i < kBucketNum; ++i) {
+        exported->buckets[i] +=
+            shard.buckets[i].load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+ private:
+  struct alignas(64) Shard {
+    std::atomic<int64_t> count{0};
+    std::atomic<int64_t> sum{0};
+    std::array<std::atomic<int64_t>, kBucketNum> buckets{};
+  };
+
+  static size_t ShardIndex() {
+    static std::atomic<size_t> next_index{0};
+    thread_local size_t index =
+        next_index.fetch_add(1, std::memory_order_relaxed) % kShardNum;
+    return index;
+  }
+
+  std::array<Shard, kShardNum> shards_;
+};
+
+class StatHistogramRegistry {
+ public:
+  static StatHistogramRegistry& Instance() {
+    static StatHistogramRegistry r;
+    return r;
+  }
+  StatHistogram* get(const std::string& name) {
+    std::lock_guard<std::mutex> lg(mutex_);
+    auto it = stats_.find(name);
+    if (it != stats_.end()) {
+      return it->second;
+    } else {
+      return nullptr;
+    }
+  }
+  int add(const std::string& name, StatHistogram* stat) {
+    std::lock_guard<std::mutex> lg(mutex_);
+    auto it = stats_.find(name);
+    if (it != stats_.end()) {
+      return -1;
+    }
+    stats_.insert(std::make_pair(name, stat));
+    return 0;
+  }
+
+  std::vector<ExportedStatHistogram> publish(bool reset = false) {
+    std::lock_guard<std::mutex> lg(mutex_);
+    std::vector<ExportedStatHistogram> exported(stats_.size());
+    int i = 0;
+    for (const auto& kv : stats_) {
+      auto& out = exported.at(i++);
+      out.key = kv.first;
+      kv.second->get(&out);
+      if (reset) {
+        kv.second->reset();
+      }
+    }
+    return exported;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, StatHistogram*> stats_;
+};
+
+inline StatHistogram::StatHistogram(const std::string& n) {
+  StatHistogramRegistry::Instance().add(n, this);
+}
+
+// Observes the microseconds from its construction to destruction.
+class StatLatencyRecorder {
+ public:
+  explicit StatLatencyRecorder(StatHistogram* histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+  ~StatLatencyRecorder() {
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    histogram_->observe(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+            .count());
+  }
+
+ private:
+  StatHistogram* histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
 }  // namespace platform
 }  // namespace paddle
 
@@ -147,6 +312,10 @@ class StatRegistry {
 #define STAT_RESET(item, t) _##item.reset(t)
 #define STAT_GET(item) _##item.get()
 
+#define STAT_OBSERVE(item, t) _##item.observe(t)
+#define STAT_RECORD_LATENCY(item) \
+  paddle::platform::StatLatencyRecorder stat_latency_recorder_##item(&_##item)
+
 #define DEFINE_FLOAT_STATUS(item)                    \
   paddle::platform::StatValue<float> _##item(#item); \
   int TouchStatRegistrar_##item() {                  \
@@ -161,6 +330,13 @@ class StatRegistry {
     return 0;                                          \
   }
 
+#define DEFINE_HISTOGRAM_STATUS(item)             \
+  paddle::platform::StatHistogram _##item(#item); \
+  int TouchStatRegistrar_##item() {               \
+    _##item.Touch();                              \
+    return 0;                                     \
+  }
+
 #define USE_STAT(item)                    \
   extern int TouchStatRegistrar_##item(); \
   UNUSED static int use_stat_##item = TouchStatRegistrar_##item()
@@ -173,6 +349,10 @@ class StatRegistry {
   extern paddle::platform::StatValue<float> _##item; \
   USE_STAT(item)
 
+#define USE_HISTOGRAM_STAT(item)                  \
+  extern paddle::platform::StatHistogram _##item; \
+  USE_STAT(item)
+
 #define USE_GPU_MEM_STAT             \
   USE_INT_STAT(STAT_gpu0_mem_size);  \
   USE_INT_STAT(STAT_gpu1_mem_size);  \
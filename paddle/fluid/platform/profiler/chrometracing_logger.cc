@@ -117,6 +117,12 @@ void ChromeTracingLogger::LogMemTraceEventNode(
   if (!output_file_stream_) {
     return;
   }
+  // the lifetime of an allocation freed in the profiling range
+  std::string free_ts;
+  if (mem_node.FreeNs() != 0) {
+    free_ts = string_format(std::string(",\n      \"free_ts\": %lld"),
+                            nsToUs(mem_node.FreeNs()));
+  }
   output_file_stream_ << string_format(
       std::string(
           R"JSON(
@@ -131,7 +137,8 @@ void ChromeTracingLogger::LogMemTraceEventNode(
       "current_allocated": %llu,
       "current_reserved": %llu,
       "peak_allocated": %llu,
-      "peak_reserved": %llu
+      "peak_reserved": %llu,
+      "alloc_op": "%s"%s
     }
   },
   )JSON"),
@@ -145,7 +152,9 @@ void ChromeTracingLogger::LogMemTraceEventNode(
       mem_node.CurrentAllocated(),
       mem_node.CurrentReserved(),
       mem_node.PeakAllocated(),
-      mem_node.PeakReserved());
+      mem_node.PeakReserved(),
+      mem_node.AllocOpName().c_str(),
+      free_ts.c_str());
   pid_tid_set_.insert({mem_node.ProcessId(), mem_node.ThreadId()});
 }
 
@@ -17,6 +17,8 @@ limitations under the License. */
 #include <deque>
 #include <set>
 #include <stack>
+#include <tuple>
+#include <utility>
 
 #include "paddle/fluid/platform/profiler/utils.h"
 
@@ -185,6 +187,63 @@ void NodeTrees::BuildTrees(
                               thread2mem_event_nodes[item],
                               thread2op_supplement_event_nodes[item]);
   }
+  AttributeMemNodes();
+}
+
+void NodeTrees::AttributeMemNodes() {
+  // tag the mem nodes with the nearest operator above them, which allocates
+  // or frees the memory
+  std::vector<MemTraceEventNode*> mem_nodes;
+  for (auto& item : thread_event_trees_map_) {
+    auto stack = std::stack<std::pair<HostTraceEventNode*, std::string>>();
+    stack.push(std::make_pair(item.second, std::string()));
+    while (!stack.empty()) {
+      auto current_node = stack.top().first;
+      std::string op_name = std::move(stack.top().second);
+      stack.pop();
+      if (current_node->Type() == TracerEventType::Operator) {
+        op_name = current_node->Name();
+      }
+      for (auto mem_node : current_node->GetMemTraceEventNodes()) {
+        mem_node->SetAllocOpName(op_name);
+        mem_nodes.push_back(mem_node);
+      }
+      for (auto child : current_node->GetChildren()) {
+        stack.push(std::make_pair(child, op_name));
+      }
+    }
+  }
+  // pair the allocations with their frees in time by the place and the
+  // address, so that a free is attributed to the op of its allocation and
+  // the lifetime of every allocation is known
+  std::stable_sort(mem_nodes.begin(),
+                   mem_nodes.end(),
+                   [](MemTraceEventNode* node1, MemTraceEventNode* node2) {
+                     return node1->TimeStampNs() < node2->TimeStampNs();
+                   });
+  std::map<std::tuple<std::string, uint64_t, bool>, MemTraceEventNode*>
+      allocations;
+  for (auto mem_node : mem_nodes) {
+    const TracerMemEventType type = mem_node->Type();
+    const bool reserved = type == TracerMemEventType::ReservedAllocate ||
+                          type == TracerMemEventType::ReservedFree;
+    auto key = std::make_tuple(mem_node->Place(), mem_node->Addr(), reserved);
+    if (type == TracerMemEventType::Allocate ||
+        type == TracerMemEventType::ReservedAllocate) {
+      allocations[key] = mem_node;
+    } else if (type == TracerMemEventType::Free ||
+               type == TracerMemEventType::ReservedFree) {
+      auto iter = allocations.find(key);
+      if (iter == allocations.end()) {
+        // allocated before the profiling range
+        mem_node->SetAllocOpName(std::string());
+        continue;
+      }
+      iter->second->SetFreeNs(mem_node->TimeStampNs());
+      mem_node->SetAllocOpName(iter->second->AllocOpName());
+      allocations.erase(iter);
+    }
+  }
 }
 
 HostTraceEventNode* NodeTrees::BuildTreeRelationship(
@@ -49,6 +49,16 @@ class MemTraceEventNode {
   uint64_t CurrentReserved() const { return mem_event_.current_reserved; }
   uint64_t PeakAllocated() const { return mem_event_.peak_allocated; }
   uint64_t PeakReserved() const { return mem_event_.peak_reserved; }
+  // the op allocating the memory of this allocation or free, which is empty
+  // if the memory is not allocated by an op in the profiling range
+  const std::string& AllocOpName() const { return alloc_op_name_; }
+  // the timestamp this allocation is freed, 0 if it is not freed in the
+  // profiling range
+  uint64_t FreeNs() const { return free_ns_; }
+
+  // setter
+  void SetAllocOpName(const std::string& name) { alloc_op_name_ = name; }
+  void SetFreeNs(uint64_t free_ns) { free_ns_ = free_ns; }
 
   // member function
   void LogMe(BaseLogger* logger) { logger->LogMemTraceEventNode(*this); }
@@ -56,6 +66,8 @@ class MemTraceEventNode {
  private:
   // data
   MemTraceEvent mem_event_;
+  std::string alloc_op_name_;
+  uint64_t free_ns_{0};
 };
 
 class OperatorSupplementEventNode {
@@ -277,7 +289,9 @@ class NodeTrees {
 
   explicit NodeTrees(
       const std::map<uint64_t, HostTraceEventNode*>& thread_event_trees_map)
-      : thread_event_trees_map_(thread_event_trees_map) {}
+      : thread_event_trees_map_(thread_event_trees_map) {
+    AttributeMemNodes();
+  }
 
   // destructor
   ~NodeTrees();
@@ -305,6 +319,7 @@ class NodeTrees {
       std::vector<CudaRuntimeTraceEventNode*> runtime_event_nodes,
       std::vector<MemTraceEventNode*> mem_event_nodes,
       std::vector<OperatorSupplementEventNode*> op_supplement_event_nodes);
+  void AttributeMemNodes();
 };
 
 }  // namespace platform
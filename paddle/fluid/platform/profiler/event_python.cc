@@ -115,6 +115,8 @@ HostPythonNode* ProfilerResult::CopyTree(HostTraceEventNode* root) {
     mem_python_node->current_reserved = memnode->CurrentReserved();
     mem_python_node->peak_allocated = memnode->PeakAllocated();
     mem_python_node->peak_reserved = memnode->PeakReserved();
+    mem_python_node->alloc_op = memnode->AllocOpName();
+    mem_python_node->free_ns = memnode->FreeNs();
     host_python_node->mem_node_ptrs.push_back(mem_python_node);
   }
   // copy OperatorSupplementEventNode's information if exists
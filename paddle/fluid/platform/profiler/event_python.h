@@ -97,6 +97,11 @@ struct MemPythonNode {
   uint64_t peak_allocated;
   // peak  reserved memory
   uint64_t peak_reserved;
+  // the op allocating the memory, empty if it is not allocated by an op in
+  // the profiling range
+  std::string alloc_op;
+  // timestamp the allocation is freed, 0 if it is not freed in the range
+  uint64_t free_ns = 0;
 };
 
 struct HostPythonNode {
@@ -155,6 +160,10 @@ class ProfilerResult {
     return extra_info_.GetExtraInfo();
   }
 
+  void AddExtraInfo(const std::string& key, const std::string& value) {
+    extra_info_.AddExtraInfo(key, std::string("%s"), value.c_str());
+  }
+
   void Save(const std::string& file_name,
             const std::string format = std::string("json"));
 
@@ -174,6 +174,81 @@ TEST(NodeTreesTest, LogMe_case0) {
   logger.LogExtraInfo(std::unordered_map<std::string, std::string>());
 }
 
+TEST(NodeTreesTest, AttributeMemNodes) {
+  std::list<HostTraceEvent> host_events;
+  std::list<RuntimeTraceEvent> runtime_events;
+  std::list<DeviceTraceEvent> device_events;
+  std::list<MemTraceEvent> mem_events;
+  std::list<OperatorSupplementEvent> op_supplement_events;
+  host_events.emplace_back(
+      std::string("op1"), TracerEventType::Operator, 11000, 20000, 10, 10);
+  host_events.emplace_back(std::string("op1::compute"),
+                           TracerEventType::OperatorInner,
+                           12000,
+                           19000,
+                           10,
+                           10);
+  host_events.emplace_back(
+      std::string("op2"), TracerEventType::Operator, 21000, 30000, 10, 11);
+  // allocated in op1::compute of thread 10 and freed in op2 of thread 11
+  mem_events.emplace_back(12500,
+                          0x1000,
+                          TracerMemEventType::Allocate,
+                          10,
+                          10,
+                          50,
+                          "GPU:0",
+                          50,
+                          50,
+                          50,
+                          50);
+  mem_events.emplace_back(22000,
+                          0x1000,
+                          TracerMemEventType::Free,
+                          10,
+                          11,
+                          -50,
+                          "GPU:0",
+                          0,
+                          50,
+                          50,
+                          50);
+  // freed but allocated before the profiling range
+  mem_events.emplace_back(23000,
+                          0x2000,
+                          TracerMemEventType::Free,
+                          10,
+                          11,
+                          -20,
+                          "GPU:0",
+                          0,
+                          50,
+                          50,
+                          50);
+  NodeTrees tree(host_events,
+                 runtime_events,
+                 device_events,
+                 mem_events,
+                 op_supplement_events);
+  int num_mem_nodes = 0;
+  tree.HandleTrees([&](HostTraceEventNode* node) {},
+                   [&](CudaRuntimeTraceEventNode* node) {},
+                   [&](DeviceTraceEventNode* node) {},
+                   [&](MemTraceEventNode* node) {
+                     ++num_mem_nodes;
+                     if (node->Addr() == 0x1000) {
+                       EXPECT_EQ(node->AllocOpName(), "op1");
+                     } else {
+                       EXPECT_EQ(node->AllocOpName(), "");
+                     }
+                     if (node->Type() == TracerMemEventType::Allocate) {
+                       EXPECT_EQ(node->FreeNs(), 22000u);
+                     }
+                   },
+                   [&](OperatorSupplementEventNode* node) {});
+  EXPECT_EQ(num_mem_nodes, 3);
+}
+
 TEST(NodeTreesTest, LogMe_case1) {
   std::list<HostTraceEvent> host_events;
   std::list<RuntimeTraceEvent> runtime_events;
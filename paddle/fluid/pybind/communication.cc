@@ -32,6 +32,10 @@ limitations under the License. */
 #include "paddle/phi/core/distributed/store/store_utils.h"
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 
+#if defined(PADDLE_WITH_RCCL) || defined(PADDLE_WITH_NCCL)
+#include "paddle/phi/core/distributed/comm_task_manager.h"
+#endif
+
 namespace py = pybind11;
 
 namespace paddle {
@@ -84,6 +88,15 @@ void BindCommContextManager(py::module *m) {
               py::call_guard<py::gil_scoped_release>())
 #endif
           .def("set_store", &phi::distributed::CommContextManager::SetStore);
+
+#if defined(PADDLE_WITH_RCCL) || defined(PADDLE_WITH_NCCL)
+  m->def(
+      "get_comm_stats",
+      []() {
+        return phi::distributed::CommTaskManager::GetInstance().GetCommStats();
+      },
+      py::call_guard<py::gil_scoped_release>());
+#endif
 }
 
 using TCPStore = phi::distributed::TCPStore;
@@ -114,6 +127,36 @@ void BindTCPStore(py::module *m) {
                        },
                        py::arg("key"),
                        py::call_guard<py::gil_scoped_release>())
+                   .def(
+                       "multi_set",
+                       [](phi::distributed::Store &self,
+                          const std::vector<std::string> &keys,
+                          const std::vector<std::string> &values) {
+                         std::vector<std::vector<uint8_t>> data;
+                         data.reserve(values.size());
+                         for (const auto &value : values) {
+                           data.emplace_back(value.begin(), value.end());
+                         }
+                         self.multi_set(keys, data);
+                       },
+                       py::arg("keys"),
+                       py::arg("values"),
+                       py::call_guard<py::gil_scoped_release>())
+                   .def(
+                       "multi_get",
+                       [](phi::distributed::Store &self,
+                          const std::vector<std::string> &keys) {
+                         auto data = self.multi_get(keys);
+                         py::gil_scoped_acquire acquire;
+                         py::list values;
+                         for (const auto &value : data) {
+                           values.append(py::bytes(
+                               std::string(value.begin(), value.end())));
+                         }
+                         return values;
+                       },
+                       py::arg("keys"),
+                       py::call_guard<py::gil_scoped_release>())
                    .def("add",
                         &phi::distributed::Store::add,
                         py::call_guard<py::gil_scoped_release>())
@@ -32,6 +32,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/data_feed.pb.h"
 #include "paddle/fluid/framework/data_set.h"
 #include "paddle/fluid/framework/dataset_factory.h"
+#include "paddle/fluid/framework/io/slot_binary_file.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/inference/io.h"
 #include "paddle/fluid/platform/place.h"
@@ -286,6 +287,9 @@ void BindDataset(py::module *m) {
       .def("global_shuffle",
            &framework::Dataset::GlobalShuffle,
            py::call_guard<py::gil_scoped_release>())
+      .def("set_streaming_global_shuffle",
+           &framework::Dataset::SetStreamingGlobalShuffle,
+           py::call_guard<py::gil_scoped_release>())
       .def("get_memory_data_size",
            &framework::Dataset::GetMemoryDataSize,
            py::call_guard<py::gil_scoped_release>())
@@ -395,6 +399,30 @@ void BindDataset(py::module *m) {
                     bool>())
       .def("_start", &IterableDatasetWrapper::Start)
       .def("_next", &IterableDatasetWrapper::Next);
+
+  m->def(
+      "convert_slot_text_to_binary",
+      [](const std::string &src_path,
+         const std::string &dst_path,
+         const std::vector<std::string> &slot_names,
+         const std::string &slot_types,
+         bool parse_ins_id,
+         bool parse_logkey,
+         const std::string &pipe_command,
+         int block_ins_num) {
+        framework::SlotBinaryFile::Header header;
+        header.slot_names = slot_names;
+        header.slot_types = slot_types;
+        if (parse_ins_id) {
+          header.flags |= framework::SlotBinaryFile::kWithInsId;
+        }
+        if (parse_logkey) {
+          header.flags |= framework::SlotBinaryFile::kWithLogKey;
+        }
+        return framework::ConvertSlotTextToBinary(
+            src_path, dst_path, header, pipe_command, block_ins_num);
+      },
+      py::call_guard<py::gil_scoped_release>());
 }
 
 }  // namespace pybind
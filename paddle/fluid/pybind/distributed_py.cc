@@ -1236,6 +1236,16 @@ void BindDistributed(py::module *m) {
                   py::arg("group_id") = 0,
                   py::arg("timeout") = 30 * 60 * 1000,
                   py::call_guard<py::gil_scoped_release>())
+      .def(
+          "split_comm",
+          [](distributed::ProcessGroupNCCL &self,
+             const std::vector<int> &ranks,
+             const std::shared_ptr<distributed::ProcessGroupNCCL> &group) {
+            return self.SplitCommContext(ranks, group.get());
+          },
+          py::arg("ranks"),
+          py::arg("group") = nullptr,
+          py::call_guard<py::gil_scoped_release>())
       .def_static("group_start", distributed::ProcessGroupNCCL::GroupStart)
       .def_static("group_end", distributed::ProcessGroupNCCL::GroupEnd);
 
@@ -26,10 +26,12 @@ typedef SSIZE_T ssize_t;
 #include <vector>
 
 #include "paddle/fluid/eager/accumulation/accumulation_node.h"
+#include "paddle/fluid/eager/amp_cast_cache.h"
 #include "paddle/fluid/eager/api/all.h"
 #include "paddle/fluid/eager/autograd_meta.h"
 #include "paddle/fluid/eager/backward.h"
 #include "paddle/fluid/eager/custom_operator/custom_operator_node.h"
+#include "paddle/fluid/eager/saved_tensors_offload.h"
 #include "paddle/fluid/eager/utils.h"
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/custom_operator.h"
@@ -974,6 +976,57 @@ static PyObject* eager_api_reset_saved_tensors_hooks(PyObject* self,
   EAGER_CATCH_AND_THROW_RETURN_NULL
 }
 
+static PyObject* eager_api_enable_saved_tensors_offload(PyObject* self,
+                                                        PyObject* args,
+                                                        PyObject* kwargs) {
+  EAGER_TRY
+  auto min_bytes = CastPyArg2AttrLong(PyTuple_GET_ITEM(args, 0), 0);
+  auto prefetch_depth = CastPyArg2AttrInt(PyTuple_GET_ITEM(args, 1), 1);
+  egr::SavedTensorsOffloader::Instance().Enable(min_bytes, prefetch_depth);
+  RETURN_PY_NONE
+  EAGER_CATCH_AND_THROW_RETURN_NULL
+}
+
+static PyObject* eager_api_disable_saved_tensors_offload(PyObject* self,
+                                                         PyObject* args,
+                                                         PyObject* kwargs) {
+  EAGER_TRY
+  egr::SavedTensorsOffloader::Instance().Disable();
+  RETURN_PY_NONE
+  EAGER_CATCH_AND_THROW_RETURN_NULL
+}
+
+static PyObject* eager_api_saved_tensors_offload_stats(PyObject* self,
+                                                       PyObject* args,
+                                                       PyObject* kwargs) {
+  EAGER_TRY
+  auto stats = egr::SavedTensorsOffloader::Instance().GetStats();
+  PyObject* dict = PyDict_New();
+  auto set_item = [dict](const char* key, PyObject* value) {
+    PyDict_SetItemString(dict, key, value);
+    Py_DECREF(value);
+  };
+  set_item("offloaded_tensors", ToPyObject(stats.offloaded_tensors));
+  set_item("offloaded_bytes", ToPyObject(stats.offloaded_bytes));
+  set_item("host_bytes", ToPyObject(stats.host_bytes));
+  set_item("peak_host_bytes", ToPyObject(stats.peak_host_bytes));
+  set_item("prefetched_bytes", ToPyObject(stats.prefetched_bytes));
+  set_item("reloaded_on_demand_bytes",
+           ToPyObject(stats.reloaded_on_demand_bytes));
+  set_item("offload_ms", ToPyObject(stats.offload_ms));
+  set_item("reload_ms", ToPyObject(stats.reload_ms));
+  return dict;
+  EAGER_CATCH_AND_THROW_RETURN_NULL
+}
+
+static PyObject* eager_api_reset_saved_tensors_offload_stats(
+    PyObject* self, PyObject* args, PyObject* kwargs) {
+  EAGER_TRY
+  egr::SavedTensorsOffloader::Instance().ResetStats();
+  RETURN_PY_NONE
+  EAGER_CATCH_AND_THROW_RETURN_NULL
+}
+
 #if defined(PADDLE_WITH_CUDA)
 static PyObject* eager_api_async_read(PyObject* self,
                                       PyObject* args,
@@ -1350,6 +1403,32 @@ static PyObject* eager_api_set_master_grads(PyObject* self,
   EAGER_CATCH_AND_THROW_RETURN_NULL
 }
 
+static PyObject* eager_api_clear_amp_cast_cache(PyObject* self,
+                                                PyObject* args,
+                                                PyObject* kwargs) {
+  EAGER_TRY
+  egr::AmpCastCache::Instance().Clear();
+  RETURN_PY_NONE
+  EAGER_CATCH_AND_THROW_RETURN_NULL
+}
+
+static PyObject* eager_api_amp_cast_cache_stats(PyObject* self,
+                                                PyObject* args,
+                                                PyObject* kwargs) {
+  EAGER_TRY
+  auto& cache = egr::AmpCastCache::Instance();
+  PyObject* dict = PyDict_New();
+  auto set_item = [dict](const char* key, PyObject* value) {
+    PyDict_SetItemString(dict, key, value);
+    Py_DECREF(value);
+  };
+  set_item("size", ToPyObject(static_cast<int64_t>(cache.Size())));
+  set_item("hits", ToPyObject(cache.Hits()));
+  set_item("misses", ToPyObject(cache.Misses()));
+  return dict;
+  EAGER_CATCH_AND_THROW_RETURN_NULL
+}
+
 PyMethodDef variable_functions[] = {  // NOLINT
     // TODO(jiabin): Remove scale when we have final state tests
     {"scale",
@@ -1418,11 +1497,35 @@ PyMethodDef variable_functions[] = {  // NOLINT
      (PyCFunction)(void (*)())eager_api_reset_saved_tensors_hooks,
      METH_VARARGS | METH_KEYWORDS,
      nullptr},
+    {"enable_saved_tensors_offload",
+     (PyCFunction)(void (*)())eager_api_enable_saved_tensors_offload,
+     METH_VARARGS | METH_KEYWORDS,
+     nullptr},
+    {"disable_saved_tensors_offload",
+     (PyCFunction)(void (*)())eager_api_disable_saved_tensors_offload,
+     METH_VARARGS | METH_KEYWORDS,
+     nullptr},
+    {"saved_tensors_offload_stats",
+     (PyCFunction)(void (*)())eager_api_saved_tensors_offload_stats,
+     METH_VARARGS | METH_KEYWORDS,
+     nullptr},
+    {"reset_saved_tensors_offload_stats",
+     (PyCFunction)(void (*)())eager_api_reset_saved_tensors_offload_stats,
+     METH_VARARGS | METH_KEYWORDS,
+     nullptr},
     /**amp functions**/
     {"set_master_grads",
      (PyCFunction)(void (*)())eager_api_set_master_grads,
      METH_VARARGS | METH_KEYWORDS,
      nullptr},
+    {"clear_amp_cast_cache",
+     (PyCFunction)(void (*)())eager_api_clear_amp_cast_cache,
+     METH_VARARGS | METH_KEYWORDS,
+     nullptr},
+    {"amp_cast_cache_stats",
+     (PyCFunction)(void (*)())eager_api_amp_cast_cache_stats,
+     METH_VARARGS | METH_KEYWORDS,
+     nullptr},
 /**sparse functions**/
 #if defined(PADDLE_WITH_CUDA)
     {"async_read",
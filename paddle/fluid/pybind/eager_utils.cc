@@ -85,6 +85,10 @@ int TensorDtype2NumpyDtype(phi::DataType dtype) {
       return pybind11::detail::npy_api::NPY_INT8_;
     case phi::DataType::UINT8:
       return pybind11::detail::npy_api::NPY_UINT8_;
+    // numpy does not support fp8, the bits are returned
+    case phi::DataType::FLOAT8_E4M3FN:
+    case phi::DataType::FLOAT8_E5M2:
+      return pybind11::detail::npy_api::NPY_UINT8_;
     case phi::DataType::INT16:
       return pybind11::detail::npy_api::NPY_INT16_;
     case phi::DataType::INT32:
@@ -919,6 +923,12 @@ PyObject* ToPyObject(const std::string& value) {
 PyObject* ToPyObject(const paddle::Tensor& value,
                      PyObject* args,
                      const std::map<ssize_t, ssize_t>& inplace_var_idx_map) {
+  return ToPyObject(value, TupleItems(args), inplace_var_idx_map);
+}
+
+PyObject* ToPyObject(const paddle::Tensor& value,
+                     PyObject* const* args,
+                     const std::map<ssize_t, ssize_t>& inplace_var_idx_map) {
   if (!inplace_var_idx_map.empty() && inplace_var_idx_map.count(0)) {
     return ToPyObject(args, inplace_var_idx_map.at(0));
   } else {
@@ -927,12 +937,16 @@ PyObject* ToPyObject(const paddle::Tensor& value,
 }
 
 PyObject* ToPyObject(PyObject* args, ssize_t arg_idx) {
+  return ToPyObject(TupleItems(args), arg_idx);
+}
+
+PyObject* ToPyObject(PyObject* const* args, ssize_t arg_idx) {
   // For inplace op, directly return the input PyObject of the inplace tensor.
   // [Parameter]
-  // args: Input PyObject.
+  // args: Input PyObjects.
   // arg_idx: Index of inplace PyObject in input args. Used to find the input
   // inplace PyObject.
-  PyObject* obj = PyTuple_GET_ITEM(args, arg_idx);
+  PyObject* obj = args[arg_idx];
   Py_INCREF(obj);
   return obj;
 }
@@ -1256,11 +1270,11 @@ PyObject* ToPyObject(const paddle::framework::Vocab& value) {
 paddle::optional<paddle::Tensor> GetOptionalTensorFromArgs(
     const std::string& op_type,
     const std::string& arg_name,
-    PyObject* args,
+    PyObject* const* args,
     ssize_t arg_idx,
     bool dispensable,
     const phi::distributed::ProcessMesh* mesh) {
-  PyObject* obj = PyTuple_GET_ITEM(args, arg_idx);
+  PyObject* obj = args[arg_idx];
 
   if (PyTuple_Check(obj)) {
     obj = PyTuple_GET_ITEM(obj, 0);
@@ -1306,6 +1320,10 @@ static paddle::Tensor& GetTensorFromPyObject(const std::string& op_type,
                                              PyObject* obj,
                                              ssize_t arg_idx,
                                              bool dispensable) {
+  // the common case of an exact Tensor skips the checks below
+  if (obj != nullptr && Py_TYPE(obj) == p_tensor_type) {
+    return reinterpret_cast<TensorObject*>(obj)->tensor;
+  }
   if (PyTuple_Check(obj)) {
     obj = PyTuple_GET_ITEM(obj, 0);
   }
@@ -1339,21 +1357,21 @@ static paddle::Tensor& GetTensorFromPyObject(const std::string& op_type,
 // we use an uninitialized Tensor to represent dispensable Tensor
 paddle::Tensor& GetTensorFromArgs(const std::string& op_type,
                                   const std::string& arg_name,
-                                  PyObject* args,
+                                  PyObject* const* args,
                                   ssize_t arg_idx,
                                   bool dispensable) {
-  PyObject* obj = PyTuple_GET_ITEM(args, arg_idx);
-  return GetTensorFromPyObject(op_type, arg_name, obj, arg_idx, dispensable);
+  return GetTensorFromPyObject(
+      op_type, arg_name, args[arg_idx], arg_idx, dispensable);
 }
 
 std::vector<paddle::Tensor> GetTensorListFromArgs(
     const std::string& op_type,
     const std::string& arg_name,
-    PyObject* args,
+    PyObject* const* args,
     ssize_t arg_idx,
     bool dispensable,
     const phi::distributed::ProcessMesh* mesh) {
-  PyObject* list = PyTuple_GET_ITEM(args, arg_idx);
+  PyObject* list = args[arg_idx];
 
   if (list == nullptr) {
     if (!dispensable) {
@@ -1457,11 +1475,11 @@ std::vector<paddle::Tensor> GetTensorListFromArgs(
 paddle::optional<std::vector<paddle::Tensor>> GetOptionalTensorListFromArgs(
     const std::string& op_type,
     const std::string& arg_name,
-    PyObject* args,
+    PyObject* const* args,
     ssize_t arg_idx,
     bool dispensable,
     const phi::distributed::ProcessMesh* mesh) {
-  PyObject* list = PyTuple_GET_ITEM(args, arg_idx);
+  PyObject* list = args[arg_idx];
 
   if (list == nullptr || list == Py_None) {
     if (!dispensable) {
@@ -1560,6 +1578,48 @@ paddle::optional<std::vector<paddle::Tensor>> GetOptionalTensorListFromArgs(
   return result;
 }
 
+paddle::optional<paddle::Tensor> GetOptionalTensorFromArgs(
+    const std::string& op_type,
+    const std::string& arg_name,
+    PyObject* args,
+    ssize_t arg_idx,
+    bool dispensable,
+    const phi::distributed::ProcessMesh* mesh) {
+  return GetOptionalTensorFromArgs(
+      op_type, arg_name, TupleItems(args), arg_idx, dispensable, mesh);
+}
+
+paddle::Tensor& GetTensorFromArgs(const std::string& op_type,
+                                  const std::string& arg_name,
+                                  PyObject* args,
+                                  ssize_t arg_idx,
+                                  bool dispensable) {
+  return GetTensorFromArgs(
+      op_type, arg_name, TupleItems(args), arg_idx, dispensable);
+}
+
+std::vector<paddle::Tensor> GetTensorListFromArgs(
+    const std::string& op_type,
+    const std::string& arg_name,
+    PyObject* args,
+    ssize_t arg_idx,
+    bool dispensable,
+    const phi::distributed::ProcessMesh* mesh) {
+  return GetTensorListFromArgs(
+      op_type, arg_name, TupleItems(args), arg_idx, dispensable, mesh);
+}
+
+paddle::optional<std::vector<paddle::Tensor>> GetOptionalTensorListFromArgs(
+    const std::string& op_type,
+    const std::string& arg_name,
+    PyObject* args,
+    ssize_t arg_idx,
+    bool dispensable,
+    const phi::distributed::ProcessMesh* mesh) {
+  return GetOptionalTensorListFromArgs(
+      op_type, arg_name, TupleItems(args), arg_idx, dispensable, mesh);
+}
+
 paddle::Tensor* GetTensorPtrFromArgs(const std::string& op_type,
                                      const std::string& arg_name,
                                      PyObject* args,
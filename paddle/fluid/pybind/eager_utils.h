@@ -115,6 +115,11 @@ std::shared_ptr<jit::Function> CastPyArg2JitFunction(PyObject* obj,
                                                      ssize_t arg_pos);
 void SetPythonStack();
 
+// The items of the tuple args, as a METH_FASTCALL function gets its args.
+inline PyObject* const* TupleItems(PyObject* args) {
+  return reinterpret_cast<PyTupleObject*>(args)->ob_item;
+}
+
 PyObject* ToPyObject(int value);
 PyObject* ToPyObject(uint32_t value);
 PyObject* ToPyObject(bool value);
@@ -127,7 +132,11 @@ PyObject* ToPyObject(const std::string& value);
 PyObject* ToPyObject(const paddle::Tensor& value,
                      PyObject* args,
                      const std::map<ssize_t, ssize_t>& inplace_var_idx_map);
+PyObject* ToPyObject(const paddle::Tensor& value,
+                     PyObject* const* args,
+                     const std::map<ssize_t, ssize_t>& inplace_var_idx_map);
 PyObject* ToPyObject(PyObject* args, ssize_t arg_idx);
+PyObject* ToPyObject(PyObject* const* args, ssize_t arg_idx);
 PyObject* ToPyObject(const std::vector<bool>& value);
 PyObject* ToPyObject(const std::vector<int>& value);
 PyObject* ToPyObject(const std::vector<int64_t>& value);
@@ -242,7 +251,7 @@ struct TupleTensorResult {
 
   static void Run(const Tuple& out,
                   PyObject* result,
-                  PyObject* args,
+                  PyObject* const* args,
                   const std::map<ssize_t, ssize_t>& inplace_var_idx_map) {
     TupleTensorResult<Tuple, N - 1>::Run(
         out, result, args, inplace_var_idx_map);
@@ -263,7 +272,7 @@ struct TupleTensorResult<Tuple, 1> {
 
   static void Run(const Tuple& out,
                   PyObject* result,
-                  PyObject* args,
+                  PyObject* const* args,
                   const std::map<ssize_t, ssize_t>& inplace_var_idx_map) {
     if (!inplace_var_idx_map.empty() && inplace_var_idx_map.count(0)) {
       PyTuple_SET_ITEM(result, 0, ToPyObject(args, inplace_var_idx_map.at(0)));
@@ -285,12 +294,12 @@ PyObject* ToPyObject(const std::tuple<Args...>& out) {
 
 template <typename... Args>
 PyObject* ToPyObject(const std::tuple<Args...>& out,
-                     PyObject* args,
+                     PyObject* const* args,
                      const std::map<ssize_t, ssize_t>& inplace_var_idx_map) {
   // For inplace op, directly return the input PyObject of the inplace tensor.
   // [Parameter]
   // out: Outputs tuple after executing op.
-  // args: Input PyObject.
+  // args: Input PyObjects.
   // inplace_var_idx_map: Index of Tensors in inplace_map, e.g. {{value_idx,
   // arg_idx}}.
   // - value_idx: Index of inplace tensor in outputs tuple. Used to find the
@@ -306,6 +315,13 @@ PyObject* ToPyObject(const std::tuple<Args...>& out,
   return result;
 }
 
+template <typename... Args>
+PyObject* ToPyObject(const std::tuple<Args...>& out,
+                     PyObject* args,
+                     const std::map<ssize_t, ssize_t>& inplace_var_idx_map) {
+  return ToPyObject(out, TupleItems(args), inplace_var_idx_map);
+}
+
 paddle::experimental::Scalar CastPyArg2Scalar(PyObject* obj,
                                               const std::string& op_type,
                                               ssize_t arg_pos);
@@ -343,6 +359,8 @@ phi::distributed::ProcessMesh CastPyArg2ProcessMesh(PyObject* obj,
 phi::distributed::Placements CastPyArg2VectorOfPlacement(PyObject* obj,
                                                          ssize_t arg_pos);
 
+// The tensors of the args tuple, or of the args array of a METH_FASTCALL
+// function
 paddle::optional<paddle::Tensor> GetOptionalTensorFromArgs(
     const std::string& op_type,
     const std::string& arg_name,
@@ -350,12 +368,24 @@ paddle::optional<paddle::Tensor> GetOptionalTensorFromArgs(
     ssize_t arg_idx,
     bool dispensable = false,
     const phi::distributed::ProcessMesh* mesh = nullptr);
+paddle::optional<paddle::Tensor> GetOptionalTensorFromArgs(
+    const std::string& op_type,
+    const std::string& arg_name,
+    PyObject* const* args,
+    ssize_t arg_idx,
+    bool dispensable = false,
+    const phi::distributed::ProcessMesh* mesh = nullptr);
 
 paddle::Tensor& GetTensorFromArgs(const std::string& op_type,
                                   const std::string& arg_name,
                                   PyObject* args,
                                   ssize_t arg_idx,
                                   bool dispensable = false);
+paddle::Tensor& GetTensorFromArgs(const std::string& op_type,
+                                  const std::string& arg_name,
+                                  PyObject* const* args,
+                                  ssize_t arg_idx,
+                                  bool dispensable = false);
 
 paddle::optional<std::vector<paddle::Tensor>> GetOptionalTensorListFromArgs(
     const std::string& op_type,
@@ -364,6 +394,13 @@ paddle::optional<std::vector<paddle::Tensor>> GetOptionalTensorListFromArgs(
     ssize_t arg_idx,
     bool dispensable = false,
     const phi::distributed::ProcessMesh* mesh = nullptr);
+paddle::optional<std::vector<paddle::Tensor>> GetOptionalTensorListFromArgs(
+    const std::string& op_type,
+    const std::string& arg_name,
+    PyObject* const* args,
+    ssize_t arg_idx,
+    bool dispensable = false,
+    const phi::distributed::ProcessMesh* mesh = nullptr);
 
 std::vector<paddle::Tensor> GetTensorListFromArgs(
     const std::string& op_type,
@@ -372,6 +409,13 @@ std::vector<paddle::Tensor> GetTensorListFromArgs(
     ssize_t arg_idx,
     bool dispensable = false,
     const phi::distributed::ProcessMesh* mesh = nullptr);
+std::vector<paddle::Tensor> GetTensorListFromArgs(
+    const std::string& op_type,
+    const std::string& arg_name,
+    PyObject* const* args,
+    ssize_t arg_idx,
+    bool dispensable = false,
+    const phi::distributed::ProcessMesh* mesh = nullptr);
 
 paddle::Tensor* GetTensorPtrFromArgs(const std::string& op_type,
                                      const std::string& arg_name,
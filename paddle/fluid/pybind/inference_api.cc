@@ -551,6 +551,24 @@ void BindInferenceApi(py::module *m) {
          py::arg("keep_io_types") = true,
          py::arg("black_list") = std::unordered_set<std::string>(),
          py::arg("white_list") = std::unordered_set<std::string>());
+  m->def("convert_to_mixed_precision_by_profile_bind",
+         &paddle_infer::ConvertToMixedPrecisionByProfile,
+         py::arg("model_file"),
+         py::arg("params_file"),
+         py::arg("mixed_model_file"),
+         py::arg("mixed_params_file"),
+         py::arg("mixed_precision"),
+         py::arg("backend"),
+         py::arg("calibration_inputs"),
+         py::arg("accuracy_tolerance") = 1e-2,
+         py::arg("keep_io_types") = true,
+         py::arg("black_list") = std::unordered_set<std::string>(),
+         py::arg("white_list") = std::unordered_set<std::string>());
+  m->def("convert_to_mmap_params",
+         &paddle_infer::ConvertToMmapParams,
+         py::arg("model_file"),
+         py::arg("params_file"),
+         py::arg("mmap_params_file"));
 }
 
 namespace {
@@ -781,6 +799,11 @@ void BindAnalysisConfig(py::module *m) {
            py::arg("device_id") = 0,
            py::arg("precision_mode") = AnalysisConfig::Precision::kFloat32)
       .def("exp_enable_use_cutlass", &AnalysisConfig::Exp_EnableUseCutlass)
+      .def("enable_cuda_graph",
+           &AnalysisConfig::EnableCudaGraph,
+           py::arg("batch_buckets"))
+      .def("cuda_graph_enabled", &AnalysisConfig::cuda_graph_enabled)
+      .def("cuda_graph_buckets", &AnalysisConfig::cuda_graph_buckets)
       .def("exp_disable_mixed_precision_ops",
            &AnalysisConfig::Exp_DisableMixedPrecisionOps)
       .def("exp_enable_mixed_precision_ops",
@@ -791,6 +814,11 @@ void BindAnalysisConfig(py::module *m) {
              self.SetExecStream(stream.raw_stream());
            })
 #endif
+      .def("enable_private_stream",
+           &AnalysisConfig::EnablePrivateStream,
+           py::arg("priority") = 0,
+           py::arg("non_blocking") = true)
+      .def("private_stream_enabled", &AnalysisConfig::private_stream_enabled)
       .def("enable_xpu",
            &AnalysisConfig::EnableXpu,
            py::arg("l3_size") = 16 * 1024 * 1024,
@@ -858,12 +886,28 @@ void BindAnalysisConfig(py::module *m) {
       .def("enable_new_executor",
            &AnalysisConfig::EnableNewExecutor,
            py::arg("x") = true)
+      .def("enable_multi_stream",
+           &AnalysisConfig::EnableMultiStream,
+           py::arg("num_streams") = 4)
+      .def("multi_stream_enabled", &AnalysisConfig::multi_stream_enabled)
+      .def("multi_stream_num", &AnalysisConfig::multi_stream_num)
+      .def("enable_tensor_capacity_retention",
+           &AnalysisConfig::EnableTensorCapacityRetention,
+           py::arg("growth_ratio") = 1.5f,
+           py::arg("shrink_ratio") = 4.f,
+           py::arg("shrink_window") = 0)
+      .def("tensor_capacity_retention_enabled",
+           &AnalysisConfig::tensor_capacity_retention_enabled)
       .def("enable_profile", &AnalysisConfig::EnableProfile)
       .def("disable_glog_info", &AnalysisConfig::DisableGlogInfo)
       .def("glog_info_disabled", &AnalysisConfig::glog_info_disabled)
       .def("enable_save_optim_model",
            &AnalysisConfig::EnableSaveOptimModel,
            py::arg("save_optimized_model") = false)
+      .def("enable_load_optim_model",
+           &AnalysisConfig::EnableLoadOptimModel,
+           py::arg("load_optimized_model") = false)
+      .def("load_optimized_model", &AnalysisConfig::load_optimized_model)
       .def("set_optim_cache_dir", &AnalysisConfig::SetOptimCacheDir)
       .def("switch_use_feed_fetch_ops",
            &AnalysisConfig::SwitchUseFeedFetchOps,
@@ -890,6 +934,10 @@ void BindAnalysisConfig(py::module *m) {
            &AnalysisConfig::EnableTensorRTMemoryOptim,
            py::arg("engine_memory_sharing") = true,
            py::arg("sharing_identifier") = 0)
+      .def("enable_tensorrt_activation_sharing",
+           &AnalysisConfig::EnableTensorRtActivationSharing,
+           py::arg("x") = true)
+      .def("trt_activation_sharing", &AnalysisConfig::trt_activation_sharing)
       .def("tensorrt_precision_mode", &AnalysisConfig::tensorrt_precision_mode)
       .def("set_trt_dynamic_shape_info",
            &AnalysisConfig::SetTRTDynamicShapeInfo,
@@ -912,6 +960,29 @@ void BindAnalysisConfig(py::module *m) {
       .def("shape_range_info_path", &AnalysisConfig::shape_range_info_path)
       .def("shape_range_info_collected",
            &AnalysisConfig::shape_range_info_collected)
+      .def("collect_int8_calibration",
+           &AnalysisConfig::CollectInt8Calibration,
+           py::arg("scale_table_path"),
+           py::arg("method") = "entropy",
+           py::arg("percentile") = 99.99f)
+      .def("int8_calibration_collected",
+           &AnalysisConfig::int8_calibration_collected)
+      .def("int8_calibration_table_path",
+           &AnalysisConfig::int8_calibration_table_path)
+      .def("set_tensorrt_int8_scale_table",
+           &AnalysisConfig::SetTensorRtInt8ScaleTable)
+      .def("tensorrt_int8_scale_table_path",
+           &AnalysisConfig::tensorrt_int8_scale_table_path)
+      .def("export_shared_gpu_params",
+           &AnalysisConfig::ExportSharedGpuParams,
+           py::arg("ipc_params_path"))
+      .def("shared_gpu_params_export_path",
+           &AnalysisConfig::shared_gpu_params_export_path)
+      .def("import_shared_gpu_params",
+           &AnalysisConfig::ImportSharedGpuParams,
+           py::arg("ipc_params_path"))
+      .def("shared_gpu_params_import_path",
+           &AnalysisConfig::shared_gpu_params_import_path)
       .def("enable_tuned_tensorrt_dynamic_shape",
            &AnalysisConfig::EnableTunedTensorRtDynamicShape,
            py::arg("shape_range_info_path") = "",
@@ -920,6 +991,10 @@ void BindAnalysisConfig(py::module *m) {
            &AnalysisConfig::tuned_tensorrt_dynamic_shape)
       .def("trt_allow_build_at_runtime",
            &AnalysisConfig::trt_allow_build_at_runtime)
+      .def("enable_tensorrt_build_in_background",
+           &AnalysisConfig::EnableTensorRtBuildInBackground)
+      .def("trt_build_in_background",
+           &AnalysisConfig::trt_build_in_background)
       .def("exp_disable_tensorrt_ops", &AnalysisConfig::Exp_DisableTensorRtOPs)
       .def("enable_tensorrt_dla",
            &AnalysisConfig::EnableTensorRtDLA,
@@ -969,6 +1044,12 @@ void BindAnalysisConfig(py::module *m) {
            &AnalysisConfig::SetCpuMathLibraryNumThreads)
       .def("cpu_math_library_num_threads",
            &AnalysisConfig::cpu_math_library_num_threads)
+      .def("set_cpu_affinity",
+           &AnalysisConfig::SetCpuAffinity,
+           py::arg("cpu_ids"),
+           py::arg("numa_node") = -1)
+      .def("cpu_affinity", &AnalysisConfig::cpu_affinity)
+      .def("cpu_numa_node", &AnalysisConfig::cpu_numa_node)
       .def("to_native_config", &AnalysisConfig::ToNativeConfig)
       .def("enable_quantizer", &AnalysisConfig::EnableMkldnnQuantizer)
       .def("enable_mkldnn_bfloat16", &AnalysisConfig::EnableMkldnnBfloat16)
@@ -1102,7 +1183,8 @@ void BindMkldnnQuantizerConfig(py::module *m) {
              return;
            })
       .def("set_quant_batch_size", &MkldnnQuantizerConfig::SetWarmupBatchSize)
-      .def("set_enabled_op_types", &MkldnnQuantizerConfig::SetEnabledOpTypes);
+      .def("set_enabled_op_types", &MkldnnQuantizerConfig::SetEnabledOpTypes)
+      .def("set_scale_table", &MkldnnQuantizerConfig::SetScaleTable);
 }
 #endif
 
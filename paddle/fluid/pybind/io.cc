@@ -14,6 +14,7 @@ limitations under the License. */
 
 #include "paddle/fluid/pybind/io.h"
 
+#include "paddle/fluid/framework/async_checkpointer.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/selected_rows_utils.h"
 #include "paddle/fluid/platform/enforce.h"
@@ -114,6 +115,28 @@ void BindIO(pybind11::module *m) {
                                   std::ios::in | std::ios::binary);
            paddle::framework::DeserializeFromStream(fin, &selected_rows);
          });
+
+  py::class_<paddle::framework::AsyncCheckpointer>(*m, "AsyncCheckpointer")
+      .def(py::init<>())
+      .def("save",
+           [](paddle::framework::AsyncCheckpointer &self,
+              const std::string &path,
+              const std::vector<std::string> &names,
+              const std::vector<phi::DenseTensor *> &tensors) {
+             std::vector<const phi::DenseTensor *> inputs(tensors.begin(),
+                                                          tensors.end());
+             self.Save(path, names, inputs);
+           },
+           py::call_guard<py::gil_scoped_release>())
+      .def("wait",
+           &paddle::framework::AsyncCheckpointer::Wait,
+           py::call_guard<py::gil_scoped_release>())
+      .def_static("load", [](const std::string &path) {
+        std::vector<std::string> names;
+        std::vector<phi::DenseTensor> tensors;
+        paddle::framework::AsyncCheckpointer::Load(path, &names, &tensors);
+        return std::make_pair(names, tensors);
+      });
 }
 }  // namespace pybind
 }  // namespace paddle
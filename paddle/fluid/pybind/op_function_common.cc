@@ -225,7 +225,9 @@ void CastPyArg2AttrFloat(PyObject* obj,
 double CastPyArg2Double(PyObject* obj,
                         const std::string& op_type,
                         ssize_t arg_pos) {
-  if (PyObject_CheckFloatOrToFloat(&obj)) {
+  if (PyFloat_CheckExact(obj)) {
+    return PyFloat_AS_DOUBLE(obj);
+  } else if (PyObject_CheckFloatOrToFloat(&obj)) {
     return PyFloat_AsDouble(obj);  // NOLINT
   } else {
     PADDLE_THROW(platform::errors::InvalidArgument(
@@ -15,6 +15,7 @@
 #include "paddle/fluid/pybind/pir.h"
 #include <Python.h>
 #include <algorithm>
+#include <functional>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -39,10 +40,13 @@
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
 #include "paddle/fluid/pir/dialect/operator/utils/utils.h"
 #include "paddle/fluid/pir/transforms/dead_code_elimination_pass.h"
+#include "paddle/fluid/pir/transforms/fusion/fp8_linear_fuse_pass.h"
 #include "paddle/fluid/pir/transforms/fusion/fused_dropout_add_pass.h"
 #include "paddle/fluid/pir/transforms/fusion/fused_linear_param_grad_add_pass.h"
 #include "paddle/fluid/pir/transforms/fusion/fused_weight_only_linear_pass.h"
+#include "paddle/fluid/pir/transforms/fusion/norm_quant_fuse_pass.h"
 #include "paddle/fluid/pir/transforms/inplace_pass.h"
+#include "paddle/fluid/pir/transforms/loop_invariant_hoisting_pass.h"
 #include "paddle/fluid/pir/transforms/replace_fetch_with_shadow_output_pass.h"
 #include "paddle/fluid/pir/transforms/shape_optimization_pass.h"
 #include "paddle/fluid/pybind/control_flow_api.h"
@@ -98,7 +102,10 @@ USE_PIR_PASS(attention_fuse_pass);
 USE_PIR_PASS(fused_gemm_epilogue_pass);
 USE_PIR_PASS(fused_dropout_add_pass);
 USE_PIR_PASS(fused_weight_only_linear_pass);
+USE_PIR_PASS(fp8_linear_fuse_pass);
+USE_PIR_PASS(norm_quant_fuse_pass);
 USE_PIR_PASS(fused_linear_param_grad_add_pass);
+USE_PIR_PASS(loop_invariant_hoisting_pass);
 USE_PIR_PASS(inplace_pass);
 USE_PIR_PASS(replace_fetch_with_shadow_output_pass);
 USE_PIR_PASS(conv2d_bn_fuse_pass);
@@ -106,6 +113,7 @@ USE_PIR_PASS(conv2d_add_fuse_pass);
 USE_PIR_PASS(conv2d_add_act_fuse_pass);
 
 PHI_DECLARE_bool(print_ir);
+PHI_DECLARE_bool(prim_recompute_intermediates);
 
 namespace paddle {
 namespace pybind {
@@ -946,6 +954,115 @@ AnalysisMiddleVariable(const Program &program,
   return std::make_pair(middle_values, backward_inputs);
 }
 
+// The primitive ops that are cheap enough to be recomputed in backward, and
+// fused into its groups by CINN, instead of keeping their results alive.
+const std::unordered_set<std::string> kRecomputableOps = {
+    "pd_op.abs",
+    "pd_op.add",
+    "pd_op.cast",
+    "pd_op.cos",
+    "pd_op.divide",
+    "pd_op.elementwise_pow",
+    "pd_op.erf",
+    "pd_op.exp",
+    "pd_op.expand",
+    "pd_op.full",
+    "pd_op.full_like",
+    "pd_op.log",
+    "pd_op.maximum",
+    "pd_op.minimum",
+    "pd_op.multiply",
+    "pd_op.pow",
+    "pd_op.reshape",
+    "pd_op.rsqrt",
+    "pd_op.scale",
+    "pd_op.sign",
+    "pd_op.sin",
+    "pd_op.sqrt",
+    "pd_op.subtract",
+    "pd_op.tanh",
+};
+
+// the longest chain of the ops recomputed for a middle value
+constexpr int kMaxRecomputeDepth = 4;
+
+// Drops the middle values that backward can recompute from the values it
+// gets anyway by a short chain of kRecomputableOps, and returns the forward
+// ops of the chains. The values the chains start from are added to
+// backward_inputs.
+std::unordered_set<Operation *> AnalysisRecomputeOps(
+    const Program &program,
+    const std::vector<pir::Value> &forward_in_out_values,
+    const std::vector<int> &forward_range,
+    std::vector<pir::Value> *middle_values,
+    std::unordered_set<pir::Value> *backward_inputs) {
+  std::unordered_set<Operation *> forward_ops;
+  range_block_do(program.block(), forward_range, [&forward_ops](Operation *op) {
+    forward_ops.insert(op);
+  });
+  auto is_recomputable_op = [&forward_ops](Operation *op) {
+    return op != nullptr && forward_ops.count(op) && op->num_results() == 1 &&
+           kRecomputableOps.count(op->name());
+  };
+
+  // the values backward gets from forward
+  std::unordered_set<pir::Value> saved(forward_in_out_values.begin(),
+                                       forward_in_out_values.end());
+  for (const auto &v : *middle_values) {
+    if (!is_recomputable_op(v.defining_op())) {
+      saved.insert(v);
+    }
+  }
+
+  std::unordered_set<Operation *> recompute_ops;
+  std::function<bool(const pir::Value &,
+                     int,
+                     std::unordered_set<Operation *> *,
+                     std::unordered_set<pir::Value> *)>
+      collect = [&](const pir::Value &v,
+                    int depth,
+                    std::unordered_set<Operation *> *ops,
+                    std::unordered_set<pir::Value> *leaves) {
+        if (saved.count(v)) {
+          leaves->insert(v);
+          return true;
+        }
+        auto *op = v.defining_op();
+        if (depth >= kMaxRecomputeDepth || !is_recomputable_op(op)) {
+          return false;
+        }
+        if (recompute_ops.count(op) || ops->count(op)) {
+          return true;
+        }
+        for (auto &operand : op->operands()) {
+          if (operand.source().impl() == nullptr ||
+              !collect(operand.source(), depth + 1, ops, leaves)) {
+            return false;
+          }
+        }
+        ops->insert(op);
+        return true;
+      };
+
+  std::vector<pir::Value> kept_values;
+  for (const auto &v : *middle_values) {
+    std::unordered_set<Operation *> ops;
+    std::unordered_set<pir::Value> leaves;
+    if (saved.count(v) || !collect(v, 0, &ops, &leaves)) {
+      saved.insert(v);
+      kept_values.push_back(v);
+      continue;
+    }
+    recompute_ops.insert(ops.begin(), ops.end());
+    backward_inputs->insert(leaves.begin(), leaves.end());
+  }
+  VLOG(4) << "Recompute " << middle_values->size() - kept_values.size()
+          << " of " << middle_values->size() << " middle values by "
+          << recompute_ops.size() << " ops in backward.";
+  *middle_values = std::move(kept_values);
+  return recompute_ops;
+}
+
 void mapping_value(const std::vector<pir::Value> &origin,
                    const std::unordered_map<pir::Value, pir::Value> &value_map,
                    std::vector<pir::Value> &out) {  // NOLINT
@@ -1140,6 +1257,14 @@ SplitedResult SplitForwardBackward(
   std::unordered_map<pir::Value, pir::Value> backward_value_map;
   pir::Builder backward_builder = pir::Builder(ctx, backward_program->block());
   bool has_backward = (backward_range[1] > backward_range[0]);
+  std::unordered_set<Operation *> recompute_ops;
+  if (FLAGS_prim_recompute_intermediates && has_backward) {
+    recompute_ops = AnalysisRecomputeOps(program,
+                                         forward_in_out_values,
+                                         forward_range,
+                                         &middle_values,
+                                         &backward_inputs);
+  }
 
   // forward program construct.
   VLOG(4) << "start create forward program.";
@@ -1265,7 +1390,17 @@ SplitedResult SplitForwardBackward(
   std::for_each(
       forward_outputs.begin(), forward_outputs.end(), create_output_fn_forward);
 
-  // Step2. copy backward ops .
+  // Step2. copy the recomputed forward ops and backward ops.
+  VLOG(4) << "start copy recomputed forward ops";
+  range_block_do(
+      program.block(),
+      forward_range,
+      [&recompute_ops, &backward_value_map, &backward_program](Operation *op) {
+        if (recompute_ops.count(op)) {
+          auto *cloned_op = BuildOpFrom(op, backward_value_map);
+          backward_program->block()->push_back(cloned_op);
+        }
+      });
   VLOG(4) << "start copy backward ops";
   range_block_do(program.block(),
                  backward_range,
@@ -1573,7 +1708,11 @@ void ApplyPirPass(Program &forward_program) {  // NOLINT
 #endif
 }
 void BindIrPass(pybind11::module *m) {
-  m->def("apply_pir_pass", ApplyPirPass);
+  // the passes may compile the program for long, e.g. on the background
+  // thread of the async compilation of CINN
+  m->def("apply_pir_pass",
+         ApplyPirPass,
+         py::call_guard<py::gil_scoped_release>());
 
   py::class_<Pass, std::shared_ptr<Pass>> pass(*m,
                                                "Pass",
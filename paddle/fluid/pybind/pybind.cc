@@ -99,6 +99,7 @@ limitations under the License. */
 #include "paddle/fluid/platform/profiler/event_python.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
 #include "paddle/fluid/platform/profiler/profiler.h"
+#include "paddle/phi/api/profiler/sampling_profiler.h"
 #include "paddle/fluid/pybind/auto_parallel_py.h"
 #include "paddle/fluid/pybind/bind_cost_model.h"
 #include "paddle/fluid/pybind/bind_fleet_executor.h"
@@ -188,6 +189,10 @@ limitations under the License. */
 #include "paddle/fluid/framework/paddle2cinn/cinn_compiler.h"
 #endif
 
+#ifdef PADDLE_WITH_DNNL
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
+#endif
+
 #if defined(PADDLE_WITH_RPC)
 #include "paddle/fluid/pybind/rpc.h"
 #endif
@@ -976,18 +981,9 @@ PYBIND11_MODULE(libpaddle, m) {
             "Note that a DLPack tensor can be consumed only once."));
 
     PyCapsule_SetName(dltensor->ptr(), "used_dltensor");
-    DLTensor dl = dmt->dl_tensor;
-    phi::DenseTensor tensor;
-
-    if (dl.device.device_type == kDLCPU) {
-      paddle::framework::TensorFromDLPack(dmt, &tensor);
-    }
-#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-    if (dl.device.device_type == kDLGPU) {
-      paddle::framework::TensorFromDLPack(dmt, &tensor);
-    }
-#endif
-    return tensor;
+    // the tensor shares the memory of the capsule, which is released by the
+    // deleter of it
+    return paddle::framework::FromDLPack(dmt);
   });
 
   m.def("_create_loaded_parameter",
@@ -2121,6 +2117,20 @@ All parameter, weight, gradient are variables in Paddle.
   m.def("supports_bfloat16_fast_performance", SupportsBfloat16FastPerformance);
   m.def("supports_int8", SupportsInt8);
   m.def("supports_vnni", SupportsVNNI);
+#ifdef PADDLE_WITH_DNNL
+  m.def("get_onednn_primitive_cache_stats", []() {
+    auto stats = phi::OneDNNPrimitiveCache::Instance().GetStats();
+    py::dict result;
+    result["hits"] = stats.hits;
+    result["misses"] = stats.misses;
+    result["evictions"] = stats.evictions;
+    result["size"] = stats.size;
+    result["capacity"] = stats.capacity;
+    return result;
+  });
+  m.def("clear_onednn_primitive_cache",
+        []() { phi::OneDNNPrimitiveCache::Instance().Clear(); });
+#endif
   m.def("op_supported_infos", imperative::OpSupportedInfos);
   m.def("is_compiled_with_brpc", IsCompiledWithBrpc);
   m.def("is_compiled_with_dist", IsCompiledWithDIST);
@@ -2151,6 +2161,22 @@ All parameter, weight, gradient are variables in Paddle.
     }
     return stats_map;
   });
+  m.def(
+      "get_histogram_stats",
+      [](bool reset) {
+        auto histogram_stats =
+            paddle::platform::StatHistogramRegistry::Instance().publish(reset);
+        py::dict stats_map;
+        for (const auto &stat : histogram_stats) {
+          py::dict histogram;
+          histogram["count"] = stat.count;
+          histogram["sum"] = stat.sum;
+          histogram["buckets"] = stat.buckets;
+          stats_map[stat.key.c_str()] = histogram;
+        }
+        return stats_map;
+      },
+      py::arg("reset") = false);
   m.def("device_memory_stat_current_value",
         memory::DeviceMemoryStatCurrentValue);
   m.def("device_memory_stat_peak_value", memory::DeviceMemoryStatPeakValue);
@@ -2511,6 +2537,7 @@ All parameter, weight, gradient are variables in Paddle.
            py::return_value_policy::automatic_reference)
       .def("save", &paddle::platform::ProfilerResult::Save)
       .def("get_extra_info", &paddle::platform::ProfilerResult::GetExtraInfo)
+      .def("add_extra_info", &paddle::platform::ProfilerResult::AddExtraInfo)
       .def("get_version", &paddle::platform::ProfilerResult::GetVersion)
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
       .def("get_span_indx", &paddle::platform::ProfilerResult::GetSpanIndx)
@@ -2538,7 +2565,9 @@ All parameter, weight, gradient are variables in Paddle.
       .def_readwrite("peak_allocated",
                      &paddle::platform::MemPythonNode::peak_allocated)
       .def_readwrite("peak_reserved",
-                     &paddle::platform::MemPythonNode::peak_reserved);
+                     &paddle::platform::MemPythonNode::peak_reserved)
+      .def_readwrite("alloc_op", &paddle::platform::MemPythonNode::alloc_op)
+      .def_readwrite("free_ns", &paddle::platform::MemPythonNode::free_ns);
 
   py::class_<paddle::platform::DevicePythonNode>(m, "DevicePythonNode")
       .def(py::init<>())
@@ -2668,6 +2697,10 @@ All parameter, weight, gradient are variables in Paddle.
   m.def("disable_memory_recorder", &paddle::platform::DisableMemoryRecorder);
   m.def("enable_op_info_recorder", &phi::EnableOpInfoRecorder);
   m.def("disable_op_info_recorder", &phi::DisableOpInfoRecorder);
+  m.def("sampling_profiler_summary",
+        []() { return phi::SamplingProfiler::GetInstance().Summary(); });
+  m.def("reset_sampling_profiler",
+        []() { phi::SamplingProfiler::GetInstance().Reset(); });
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   m.def("set_cublas_switch", phi::SetAllowTF32Cublas);
@@ -2901,6 +2934,38 @@ All parameter, weight, gradient are variables in Paddle.
 
   m.def("use_layout_autotune",
         [] { return egr::Controller::Instance().UseLayoutAutoTune(); });
+
+  m.def("layout_autotune_report", [] {
+    auto &tuner = paddle::imperative::LayoutAutoTune::Instance();
+    py::dict res;
+    res["desired_layout"] =
+        common::DataLayoutToString(tuner.GetDesiredLayout());
+    res["default_layout"] =
+        common::DataLayoutToString(tuner.GetDefaultLayout());
+    py::dict costs;
+    for (const auto &item : tuner.MeasuredCosts()) {
+      py::dict cost;
+      cost["count"] = item.second.count;
+      cost["default_ms"] = item.second.default_ms;
+      cost["desired_ms"] = item.second.desired_ms;
+      cost["transpose_ms"] = item.second.transpose_ms;
+      costs[item.first.c_str()] = cost;
+    }
+    res["measured_costs"] = costs;
+    py::dict transposes;
+    for (const auto &item : tuner.TransposeReport()) {
+      py::dict record;
+      record["count"] = item.second.first;
+      record["numel"] = item.second.second;
+      transposes[item.first.c_str()] = record;
+    }
+    res["transposes"] = transposes;
+    return res;
+  });
+
+  m.def("clear_layout_autotune_report", [] {
+    paddle::imperative::LayoutAutoTune::Instance().ClearReport();
+  });
   // Add the api for nan op debug
   m.def("set_nan_inf_stack_limit",
         &paddle::framework::details::SetNanInfStackLimit);
@@ -2940,6 +3005,8 @@ All parameter, weight, gradient are variables in Paddle.
       .value("COMPLEX128", phi::DataType::COMPLEX128)
       .value("FLOAT16", phi::DataType::FLOAT16)
       .value("BFLOAT16", phi::DataType::BFLOAT16)
+      .value("FLOAT8_E4M3FN", phi::DataType::FLOAT8_E4M3FN)
+      .value("FLOAT8_E5M2", phi::DataType::FLOAT8_E5M2)
       .export_values();
 
 #if defined(PADDLE_WITH_PSLIB) && !defined(PADDLE_WITH_HETERPS)
@@ -423,20 +423,24 @@ void BindTensor(pybind11::module &m) {  // NOLINT
                     >>> print(t.shape())
                     [5, 30]
            )DOC")
-      .def("_to_dlpack",
-           [](phi::DenseTensor &self) {
-             DLManagedTensor *dmt = framework::toDLPack(self);
-             auto capsule = pybind11::capsule(
-                 static_cast<void *>(dmt), "dltensor", [](PyObject *ptr) {
-                   if (!PyCapsule_IsValid(ptr, "dltensor")) {
-                     return;
-                   }
-                   DLManagedTensor *dmt = static_cast<DLManagedTensor *>(
-                       PyCapsule_GetPointer(ptr, "dltensor"));
-                   dmt->deleter(dmt);
-                 });
-             return capsule;
-           })
+      .def(
+          "_to_dlpack",
+          [](phi::DenseTensor &self, int64_t stream) {
+            // the consumer stream waits for the tensor on the device
+            framework::SyncStreamForDLPack(self, stream);
+            DLManagedTensor *dmt = framework::toDLPack(self);
+            auto capsule = pybind11::capsule(
+                static_cast<void *>(dmt), "dltensor", [](PyObject *ptr) {
+                  if (!PyCapsule_IsValid(ptr, "dltensor")) {
+                    return;
+                  }
+                  DLManagedTensor *dmt = static_cast<DLManagedTensor *>(
+                      PyCapsule_GetPointer(ptr, "dltensor"));
+                  dmt->deleter(dmt);
+                });
+            return capsule;
+          },
+          py::arg("stream") = -1)
       .def("_set_float_element", TensorSetElement<float>)
       .def("_get_float_element", TensorGetElement<float>)
       .def("_set_double_element", TensorSetElement<double>)
@@ -888,19 +892,29 @@ void BindTensor(pybind11::module &m) {  // NOLINT
                    framework::SizeOfType(
                        framework::TransToProtoVarType(self.type()));
 
-               int flags = memory::allocation::MAPPED_SHAREDMEM |
-                           memory::allocation::MAPPED_EXCLUSIVE;
-               std::string handle = memory::allocation::GetIPCName();
-               int find_id = -1;
-               if (FLAGS_use_shm_cache) {
-                 find_id = memory::allocation::MemoryMapAllocationPool::Instance().FindFromCache(flags, data_size); // NOLINT
+               std::shared_ptr<
+                   memory::allocation::RefcountedMemoryMapAllocation>
+                   shared_holder;
+               auto *arena = memory::allocation::MemoryMapArena::Instance();
+               if (arena != nullptr) {
+                 shared_holder = arena->Allocate(data_size);
                }
-               if (find_id != -1) {
-                 handle = memory::allocation::MemoryMapAllocationPool::Instance().GetById(find_id).file_name_; // NOLINT
+               // Fall back to a shm file if the arena is full or disabled.
+               if (shared_holder == nullptr) {
+                 int flags = memory::allocation::MAPPED_SHAREDMEM |
+                             memory::allocation::MAPPED_EXCLUSIVE;
+                 std::string handle = memory::allocation::GetIPCName();
+                 int find_id = -1;
+                 if (FLAGS_use_shm_cache) {
+                   find_id = memory::allocation::MemoryMapAllocationPool::Instance().FindFromCache(flags, data_size); // NOLINT
+                 }
+                 if (find_id != -1) {
+                   handle = memory::allocation::MemoryMapAllocationPool::Instance().GetById(find_id).file_name_; // NOLINT
+                 }
+                 shared_holder =
+                     memory::allocation::AllocateRefcountedMemoryMapAllocation(
+                         handle, flags, data_size, find_id);
                }
-               auto shared_holder =
-                   memory::allocation::AllocateRefcountedMemoryMapAllocation(
-                       handle, flags, data_size, find_id);
 
                // copy data & reset holder
                if (platform::is_cuda_pinned_place(holder->place())) {
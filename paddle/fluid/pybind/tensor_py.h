@@ -21,6 +21,7 @@ limitations under the License. */
 #endif
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -379,11 +380,20 @@ void TensorSetElement(phi::DenseTensor *self, size_t offset, T elem) {
 }
 
 template <typename T, typename P>
-void SetTensorFromPyArrayT(
-    phi::DenseTensor *self,
-    const py::array_t<T, py::array::c_style | py::array::forcecast> &array,
-    const P &place,
-    bool zero_copy) {
+void SetTensorFromPyArrayT(phi::DenseTensor *self,
+                           const py::array &src,
+                           const P &place,
+                           bool zero_copy) {
+  // a c contiguous array of T, which is a private copy of src unless src is
+  // one already
+  py::array_t<T, py::array::c_style | py::array::forcecast> array(src);
+  // no one else sees the private copy, so it is aliased rather than copied
+  // once more
+  if (array.ptr() != src.ptr() &&
+      reinterpret_cast<uintptr_t>(array.data()) % alignof(T) == 0) {
+    zero_copy = true;
+  }
+
   std::vector<int64_t> dims;
   dims.reserve(array.ndim());
   for (decltype(array.ndim()) i = 0; i < array.ndim(); ++i) {
@@ -463,6 +473,12 @@ void SetTensorFromPyArrayT(
       // we need set_device(dev_id) first.
       platform::CUDADeviceGuard guard(place.device);
       auto dst = self->mutable_data<T>(place);
+      // array outlives the copy, which runs from the numpy buffer without
+      // holding the GIL
+      std::unique_ptr<py::gil_scoped_release> release;
+      if (PyGILState_Check()) {
+        release = std::make_unique<py::gil_scoped_release>();
+      }
 #ifdef PADDLE_WITH_HIP
       paddle::platform::GpuMemcpySync(
           dst, array.data(), array.nbytes(), hipMemcpyHostToDevice);
@@ -293,6 +293,8 @@ phi::TensorBase* SetStringsKernelOutput(Tensor* out, TensorType type) {
         out->set_impl(strings_tensor);
       }
       return out->impl().get();
+    } else if (type == TensorType::DENSE_TENSOR && out->impl() == nullptr) {
+      out->set_impl(std::make_shared<phi::DenseTensor>());
     }
   }
   return out->impl().get();
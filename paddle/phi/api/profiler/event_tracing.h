@@ -92,6 +92,8 @@ class TEST_API RecordEvent {
   TracerEventType type_{TracerEventType::UserDefined};
   std::string* attr_{nullptr};
   bool finished_{false};
+  // the name of the event sampled by the SamplingProfiler
+  std::string* sampled_name_{nullptr};
 };
 
 }  // namespace phi
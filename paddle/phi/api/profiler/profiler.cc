@@ -27,6 +27,7 @@ limitations under the License. */
 #include "paddle/phi/api/profiler/host_event_recorder.h"
 #include "paddle/phi/api/profiler/host_tracer.h"
 #include "paddle/phi/api/profiler/profiler_helper.h"
+#include "paddle/phi/api/profiler/sampling_profiler.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/core/os_info.h"
 #ifdef PADDLE_WITH_CUDA
@@ -108,6 +109,10 @@ RecordEvent::RecordEvent(const char *name,
   }
 #endif
 #endif
+  if (UNLIKELY(SamplingProfiler::ShouldSample(type))) {
+    sampled_name_ = new std::string(name);
+    start_ns_ = PosixInNsec();
+  }
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
   }
@@ -142,6 +147,10 @@ RecordEvent::RecordEvent(const std::string &name,
   }
 #endif
 #endif
+  if (UNLIKELY(SamplingProfiler::ShouldSample(type))) {
+    sampled_name_ = new std::string(name);
+    start_ns_ = PosixInNsec();
+  }
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
   }
@@ -175,6 +184,10 @@ RecordEvent::RecordEvent(const std::string &name,
   }
 #endif
 #endif
+  if (UNLIKELY(SamplingProfiler::ShouldSample(type))) {
+    sampled_name_ = new std::string(name);
+    start_ns_ = PosixInNsec();
+  }
 
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
@@ -224,6 +237,12 @@ void RecordEvent::End() {
   }
 #endif
 #endif
+  if (UNLIKELY(sampled_name_ != nullptr)) {
+    SamplingProfiler::GetInstance().Record(
+        *sampled_name_, start_ns_, PosixInNsec());
+    delete sampled_name_;
+    sampled_name_ = nullptr;
+  }
   if (LIKELY(FLAGS_enable_host_event_recorder_hook && is_enabled_)) {
     uint64_t end_ns = PosixInNsec();
     if (LIKELY(shallow_copy_name_ != nullptr)) {
@@ -0,0 +1,197 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/api/profiler/sampling_profiler.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "glog/logging.h"
+#include "paddle/phi/common/thread_data_registry.h"
+
+PHI_DEFINE_EXPORTED_int32(
+    sampling_profiler_rate,
+    0,
+    "Sample one in the rate op events of every thread into the latency "
+    "histograms of the ops, 0 disables the sampling.");
+
+PHI_DEFINE_EXPORTED_string(
+    sampling_profiler_export_path,
+    "",
+    "The file the Prometheus text of the sampled latency histograms is "
+    "exported to periodically, no export if empty.");
+
+PHI_DEFINE_EXPORTED_int32(
+    sampling_profiler_export_interval,
+    60,
+    "The interval in seconds the sampled latency histograms are exported.");
+
+namespace phi {
+
+SamplingProfiler& SamplingProfiler::GetInstance() {
+  static SamplingProfiler instance;
+  return instance;
+}
+
+SamplingProfiler::~SamplingProfiler() {
+  {
+    std::lock_guard<std::mutex> guard(export_mutex_);
+    stop_export_ = true;
+  }
+  export_cv_.notify_all();
+  if (export_thread_.joinable()) {
+    export_thread_.join();
+  }
+}
+
+SamplingProfiler::Ring* SamplingProfiler::GetThreadLocalRing() {
+  // The registry and rings_ both hold the ring, so that the samples of the
+  // exited threads are still collected.
+  using RingRegistry = phi::ThreadDataRegistry<std::shared_ptr<Ring>>;
+  auto* ring = RingRegistry::GetInstance().GetMutableCurrentThreadData();
+  if (UNLIKELY(ring->get() == nullptr)) {
+    *ring = std::make_shared<Ring>();
+    std::lock_guard<std::mutex> guard(rings_mutex_);
+    rings_.push_back(*ring);
+  }
+  return ring->get();
+}
+
+void SamplingProfiler::Record(const std::string& name,
+                              uint64_t start_ns,
+                              uint64_t end_ns) {
+  if (!FLAGS_sampling_profiler_export_path.empty()) {
+    std::call_once(export_once_, [this] { StartExportThread(); });
+  }
+  Ring* ring = GetThreadLocalRing();
+  const uint64_t head = ring->head.load(std::memory_order_relaxed);
+  if (head - ring->tail.load(std::memory_order_acquire) >= kRingSize) {
+    num_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Sample& sample = ring->samples[head % kRingSize];
+  const size_t len = std::min<size_t>(name.size(), kMaxNameLen);
+  std::memcpy(sample.name, name.data(), len);
+  sample.name[len] = '\0';
+  sample.duration_ns = end_ns > start_ns ? end_ns - start_ns : 0;
+  ring->head.store(head + 1, std::memory_order_release);
+}
+
+void SamplingProfiler::Collect() {
+  std::vector<std::shared_ptr<Ring>> rings;
+  {
+    std::lock_guard<std::mutex> guard(rings_mutex_);
+    rings = rings_;
+  }
+  std::lock_guard<std::mutex> guard(histograms_mutex_);
+  for (auto& ring : rings) {
+    const uint64_t head = ring->head.load(std::memory_order_acquire);
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    for (; tail < head; ++tail) {
+      const Sample& sample = ring->samples[tail % kRingSize];
+      Histogram& hist = histograms_[sample.name];
+      // the bucket of 2^(i-1) us < duration <= 2^i us
+      const uint64_t us = (sample.duration_ns + 999) / 1000;
+      int bucket = 0;
+      while (bucket < kNumBuckets - 1 && (uint64_t(1) << bucket) < us) {
+        ++bucket;
+      }
+      ++hist.buckets[bucket];
+      ++hist.count;
+      hist.sum_ns += sample.duration_ns;
+    }
+    ring->tail.store(tail, std::memory_order_release);
+  }
+}
+
+std::string SamplingProfiler::Summary() {
+  Collect();
+  std::ostringstream os;
+  os << "# HELP paddle_op_latency_seconds The latency of the sampled ops.\n"
+     << "# TYPE paddle_op_latency_seconds histogram\n";
+  {
+    std::lock_guard<std::mutex> guard(histograms_mutex_);
+    for (auto& pair : histograms_) {
+      const std::string label = "op=\"" + pair.first + "\"";
+      const Histogram& hist = pair.second;
+      uint64_t cumulative = 0;
+      for (int i = 0; i < kNumBuckets; ++i) {
+        cumulative += hist.buckets[i];
+        os << "paddle_op_latency_seconds_bucket{" << label << ",le=\"";
+        if (i == kNumBuckets - 1) {
+          os << "+Inf";
+        } else {
+          os << static_cast<double>(uint64_t(1) << i) * 1e-6;
+        }
+        os << "\"} " << cumulative << "\n";
+      }
+      os << "paddle_op_latency_seconds_sum{" << label << "} "
+         << static_cast<double>(hist.sum_ns) * 1e-9 << "\n"
+         << "paddle_op_latency_seconds_count{" << label << "} " << hist.count
+         << "\n";
+    }
+  }
+  os << "# HELP paddle_op_sample_rate One in the rate ops is sampled.\n"
+     << "# TYPE paddle_op_sample_rate gauge\n"
+     << "paddle_op_sample_rate " << FLAGS_sampling_profiler_rate << "\n"
+     << "# HELP paddle_op_dropped_samples_total The samples dropped while "
+        "the rings are full.\n"
+     << "# TYPE paddle_op_dropped_samples_total counter\n"
+     << "paddle_op_dropped_samples_total "
+     << num_dropped_.load(std::memory_order_relaxed) << "\n";
+  return os.str();
+}
+
+void SamplingProfiler::Reset() {
+  Collect();
+  std::lock_guard<std::mutex> guard(histograms_mutex_);
+  histograms_.clear();
+  num_dropped_.store(0, std::memory_order_relaxed);
+}
+
+void SamplingProfiler::Export(const std::string& path) {
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream ofs(tmp_path, std::ios::out | std::ios::trunc);
+    if (!ofs.is_open()) {
+      LOG(WARNING) << "Failed to open " << tmp_path
+                   << " to export the sampled latency histograms.";
+      return;
+    }
+    ofs << Summary();
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Failed to rename " << tmp_path << " to " << path << ".";
+  }
+}
+
+void SamplingProfiler::StartExportThread() {
+  export_thread_ = std::thread([this] {
+    std::unique_lock<std::mutex> lock(export_mutex_);
+    while (!stop_export_) {
+      const int interval = FLAGS_sampling_profiler_export_interval;
+      export_cv_.wait_for(lock, std::chrono::seconds(std::max(interval, 1)));
+      const std::string path = FLAGS_sampling_profiler_export_path;
+      if (!path.empty()) {
+        Export(path);
+      }
+    }
+  });
+}
+
+}  // namespace phi
@@ -0,0 +1,126 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/api/profiler/trace_event.h"
+#include "paddle/phi/core/flags.h"
+#include "paddle/utils/test_macros.h"
+
+PHI_DECLARE_int32(sampling_profiler_rate);
+
+namespace phi {
+
+// The always-on profiling of the ops by sampling. One in
+// FLAGS_sampling_profiler_rate op events of every thread is timed into the
+// lock-free ring of the thread, and the rings are drained into the latency
+// histograms of the ops, whose summary is exported in the Prometheus text
+// format to FLAGS_sampling_profiler_export_path every
+// FLAGS_sampling_profiler_export_interval seconds. It is cheap enough to be
+// left on in production, while the full traces are still taken by the
+// Profiler for the steps on demand.
+class TEST_API SamplingProfiler {
+ public:
+  // The upper bounds of the buckets of the histograms are 2^i us, i in
+  // [0, kNumBuckets - 1), the last bucket is +Inf.
+  static constexpr int kNumBuckets = 22;
+  // The slots of the ring of a thread, the samples are dropped while the ring
+  // is full.
+  static constexpr int kRingSize = 1024;
+  static constexpr int kMaxNameLen = 63;
+
+  static SamplingProfiler& GetInstance();
+
+  // Whether this event of the calling thread is sampled, which is one load
+  // of the flag if the sampling is off.
+  static bool ShouldSample(const TracerEventType type) {
+    const int rate = FLAGS_sampling_profiler_rate;
+    if (LIKELY(rate <= 0) || type != TracerEventType::Operator) {
+      return false;
+    }
+    thread_local uint64_t num_events = 0;
+    return ++num_events % rate == 0;
+  }
+
+  // Pushes the sample to the ring of the calling thread, thread-safe.
+  void Record(const std::string& name, uint64_t start_ns, uint64_t end_ns);
+
+  // Drains the rings into the histograms.
+  void Collect();
+
+  // The Prometheus text of the histograms after a Collect.
+  std::string Summary();
+
+  // Clears the histograms and the samples in the rings.
+  void Reset();
+
+  // Writes the Summary to path by a rename, so that the readers never see a
+  // partial file.
+  void Export(const std::string& path);
+
+  ~SamplingProfiler();
+
+ private:
+  struct Sample {
+    char name[kMaxNameLen + 1];
+    uint64_t duration_ns;
+  };
+
+  // Single producer of the thread and single consumer of Collect.
+  struct Ring {
+    std::array<Sample, kRingSize> samples;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+  };
+
+  struct Histogram {
+    std::array<uint64_t, kNumBuckets> buckets{};
+    uint64_t count{0};
+    uint64_t sum_ns{0};
+  };
+
+  SamplingProfiler() = default;
+  DISABLE_COPY_AND_ASSIGN(SamplingProfiler);
+
+  Ring* GetThreadLocalRing();
+  void StartExportThread();
+
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<Ring>> rings_;
+  std::atomic<uint64_t> num_dropped_{0};
+
+  // guarded by histograms_mutex_, and Collect is serialized by it
+  std::mutex histograms_mutex_;
+  std::map<std::string, Histogram> histograms_;
+
+  std::once_flag export_once_;
+  std::mutex export_mutex_;
+  std::condition_variable export_cv_;
+  bool stop_export_{false};
+  std::thread export_thread_;
+};
+
+}  // namespace phi
@@ -187,8 +187,18 @@ class StringsAPI(ForwardAPI):
             else:
                 kernel_args = kernel_args + str(param) + ", "
 
-        for out_type in self.outputs['types']:
-            kernel_args_type_list.append(out_trans_map[out_type])
+        for out_name, out_type in zip(
+            self.outputs['names'], self.outputs['types']
+        ):
+            kernel_out_type = out_trans_map[out_type]
+            if (
+                self.get_kernel_tensor_out_type(out_name)
+                == 'TensorType::DENSE_TENSOR'
+            ):
+                kernel_out_type = kernel_out_type.replace(
+                    'StringTensor', 'DenseTensor'
+                )
+            kernel_args_type_list.append(kernel_out_type)
 
         # set kernel_signature
         kernel_signature = "void(*)(" + ", ".join(kernel_args_type_list) + ")"
@@ -333,6 +343,7 @@ def source_include(header_file_path):
 #include "paddle/phi/api/lib/api_gen_utils.h"
 #include "paddle/phi/core/kernel_context.h"
 #include "paddle/phi/core/string_tensor.h"
+#include "paddle/phi/infermeta/strings/binary.h"
 #include "paddle/phi/infermeta/strings/nullary.h"
 #include "paddle/phi/infermeta/strings/unary.h"
 #include "paddle/phi/api/lib/kernel_dispatch.h"
@@ -447,6 +447,97 @@ class CustomDevice : public DeviceInterface {
     }
   }
 
+  bool IsStreamOrderedAllocatorSupported(size_t dev_id) override {
+    return pimpl_->async_device_memory_allocate &&
+           pimpl_->async_device_memory_deallocate;
+  }
+
+  void* MemoryAllocateAsync(size_t dev_id,
+                            size_t size,
+                            const stream::Stream* stream) override {
+    void* ptr = nullptr;
+    const auto device = &devices_pool[dev_id];
+
+    if (!IsStreamOrderedAllocatorSupported(dev_id)) {
+      PADDLE_THROW(phi::errors::Unavailable(
+          "MemoryAllocateAsync is not supported on %s.", Type()));
+    } else {
+      C_Stream c_stream =
+          stream ? reinterpret_cast<C_Stream>(stream->raw_stream()) : nullptr;
+      PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(
+          pimpl_->async_device_memory_allocate(device, c_stream, &ptr, size));
+    }
+    return ptr;
+  }
+
+  void MemoryDeallocateAsync(size_t dev_id,
+                             void* ptr,
+                             size_t size,
+                             const stream::Stream* stream) override {
+    const auto device = &devices_pool[dev_id];
+
+    if (!IsStreamOrderedAllocatorSupported(dev_id)) {
+      PADDLE_THROW(phi::errors::Unavailable(
+          "MemoryDeallocateAsync is not supported on %s.", Type()));
+    } else {
+      C_Stream c_stream =
+          stream ? reinterpret_cast<C_Stream>(stream->raw_stream()) : nullptr;
+      PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(
+          pimpl_->async_device_memory_deallocate(device, c_stream, ptr, size));
+    }
+  }
+
+  void MemoryCopyH2DBatch(size_t dev_id,
+                          void** dst,
+                          const void** src,
+                          const size_t* sizes,
+                          size_t count,
+                          const stream::Stream* stream = nullptr) override {
+    if (stream && stream->raw_stream() && pimpl_->async_memory_copy_h2d_batch) {
+      const auto device = &devices_pool[dev_id];
+      C_Stream c_stream = reinterpret_cast<C_Stream>(stream->raw_stream());
+      PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(pimpl_->async_memory_copy_h2d_batch(
+          device, c_stream, dst, src, sizes, count));
+    } else {
+      DeviceInterface::MemoryCopyH2DBatch(
+          dev_id, dst, src, sizes, count, stream);
+    }
+  }
+
+  void MemoryCopyD2HBatch(size_t dev_id,
+                          void** dst,
+                          const void** src,
+                          const size_t* sizes,
+                          size_t count,
+                          const stream::Stream* stream = nullptr) override {
+    if (stream && stream->raw_stream() && pimpl_->async_memory_copy_d2h_batch) {
+      const auto device = &devices_pool[dev_id];
+      C_Stream c_stream = reinterpret_cast<C_Stream>(stream->raw_stream());
+      PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(pimpl_->async_memory_copy_d2h_batch(
+          device, c_stream, dst, src, sizes, count));
+    } else {
+      DeviceInterface::MemoryCopyD2HBatch(
+          dev_id, dst, src, sizes, count, stream);
+    }
+  }
+
+  void MemoryCopyD2DBatch(size_t dev_id,
+                          void** dst,
+                          const void** src,
+                          const size_t* sizes,
+                          size_t count,
+                          const stream::Stream* stream = nullptr) override {
+    if (stream && stream->raw_stream() && pimpl_->async_memory_copy_d2d_batch) {
+      const auto device = &devices_pool[dev_id];
+      C_Stream c_stream = reinterpret_cast<C_Stream>(stream->raw_stream());
+      PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(pimpl_->async_memory_copy_d2d_batch(
+          device, c_stream, dst, src, sizes, count));
+    } else {
+      DeviceInterface::MemoryCopyD2DBatch(
+          dev_id, dst, src, sizes, count, stream);
+    }
+  }
+
   void MemoryStats(size_t dev_id, size_t* total, size_t* free) override {
     if (pimpl_->device_memory_stats) {
       const auto device = &devices_pool[dev_id];
@@ -1015,6 +1106,11 @@ bool ValidCustomCustomRuntimeParams(const CustomRuntimeParams* params) {
   CHECK_INTERFACE(async_memory_copy_d2h, false);
   CHECK_INTERFACE(async_memory_copy_d2d, false);
   CHECK_INTERFACE(async_memory_copy_p2p, false);
+  CHECK_INTERFACE(async_device_memory_allocate, false);
+  CHECK_INTERFACE(async_device_memory_deallocate, false);
+  CHECK_INTERFACE(async_memory_copy_h2d_batch, false);
+  CHECK_INTERFACE(async_memory_copy_d2h_batch, false);
+  CHECK_INTERFACE(async_memory_copy_d2d_batch, false);
 
   CHECK_INTERFACE(get_device_count, true);
   CHECK_INTERFACE(get_device_list, true);
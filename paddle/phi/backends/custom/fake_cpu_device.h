@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #pragma once
+#include <cstdint>
+
 #include "paddle/phi/backends/device_ext.h"
 
 constexpr size_t global_total_memory = 1024 * 1024UL;
@@ -77,6 +79,32 @@ C_Status Deallocate(const C_Device device, void *ptr, size_t size) {
   return C_SUCCESS;
 }
 
+C_Status AsyncAllocate(const C_Device device,
+                       C_Stream stream,
+                       void **ptr,
+                       size_t size) {
+  return Allocate(device, ptr, size);
+}
+
+C_Status AsyncDeallocate(const C_Device device,
+                         C_Stream stream,
+                         void *ptr,
+                         size_t size) {
+  return Deallocate(device, ptr, size);
+}
+
+C_Status AsyncMemCpyBatch(const C_Device device,
+                          C_Stream stream,
+                          void **dst,
+                          const void **src,
+                          const size_t *sizes,
+                          size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    memcpy(dst[i], src[i], sizes[i]);
+  }
+  return C_SUCCESS;
+}
+
 C_Status CreateStream(const C_Device device, C_Stream *stream) {
   return C_SUCCESS;
 }
@@ -86,6 +114,8 @@ C_Status DestroyStream(const C_Device device, C_Stream stream) {
 }
 
 C_Status CreateEvent(const C_Device device, C_Event *event) {
+  static uintptr_t event_id = 0;
+  *event = reinterpret_cast<C_Event>(++event_id);
   return C_SUCCESS;
 }
 
@@ -268,6 +298,11 @@ void InitFakeCPUDevice(CustomRuntimeParams *params) {
   params->interface->device_memory_deallocate = Deallocate;
   params->interface->host_memory_deallocate = Deallocate;
   params->interface->unified_memory_deallocate = Deallocate;
+  params->interface->async_device_memory_allocate = AsyncAllocate;
+  params->interface->async_device_memory_deallocate = AsyncDeallocate;
+  params->interface->async_memory_copy_h2d_batch = AsyncMemCpyBatch;
+  params->interface->async_memory_copy_d2h_batch = AsyncMemCpyBatch;
+  params->interface->async_memory_copy_d2d_batch = AsyncMemCpyBatch;
 
   params->interface->get_device_count = GetDevicesCount;
   params->interface->get_device_list = GetDevicesList;
@@ -196,6 +196,57 @@ void DeviceInterface::MemorySet(size_t dev_id,
   INTERFACE_UNIMPLEMENT;
 }
 
+bool DeviceInterface::IsStreamOrderedAllocatorSupported(size_t dev_id) {
+  return false;
+}
+
+void* DeviceInterface::MemoryAllocateAsync(size_t dev_id,
+                                           size_t size,
+                                           const stream::Stream* stream) {
+  INTERFACE_UNIMPLEMENT;
+  return nullptr;
+}
+
+void DeviceInterface::MemoryDeallocateAsync(size_t dev_id,
+                                            void* ptr,
+                                            size_t size,
+                                            const stream::Stream* stream) {
+  INTERFACE_UNIMPLEMENT;
+}
+
+void DeviceInterface::MemoryCopyH2DBatch(size_t dev_id,
+                                         void** dst,
+                                         const void** src,
+                                         const size_t* sizes,
+                                         size_t count,
+                                         const stream::Stream* stream) {
+  for (size_t i = 0; i < count; ++i) {
+    MemoryCopyH2D(dev_id, dst[i], src[i], sizes[i], stream);
+  }
+}
+
+void DeviceInterface::MemoryCopyD2HBatch(size_t dev_id,
+                                         void** dst,
+                                         const void** src,
+                                         const size_t* sizes,
+                                         size_t count,
+                                         const stream::Stream* stream) {
+  for (size_t i = 0; i < count; ++i) {
+    MemoryCopyD2H(dev_id, dst[i], src[i], sizes[i], stream);
+  }
+}
+
+void DeviceInterface::MemoryCopyD2DBatch(size_t dev_id,
+                                         void** dst,
+                                         const void** src,
+                                         const size_t* sizes,
+                                         size_t count,
+                                         const stream::Stream* stream) {
+  for (size_t i = 0; i < count; ++i) {
+    MemoryCopyD2D(dev_id, dst[i], src[i], sizes[i], stream);
+  }
+}
+
 void DeviceInterface::MemoryStats(size_t dev_id, size_t* total, size_t* free) {
   INTERFACE_UNIMPLEMENT;
 }
@@ -154,6 +154,41 @@ class DeviceInterface {  // Driver / Runtime
 
   virtual void MemorySet(size_t dev_id, void* ptr, uint8_t value, size_t size);
 
+  // ! Whether the device memory can be allocated and freed in stream order.
+  virtual bool IsStreamOrderedAllocatorSupported(size_t dev_id);
+
+  virtual void* MemoryAllocateAsync(size_t dev_id,
+                                    size_t size,
+                                    const stream::Stream* stream);
+
+  virtual void MemoryDeallocateAsync(size_t dev_id,
+                                     void* ptr,
+                                     size_t size,
+                                     const stream::Stream* stream);
+
+  // ! Copies sizes[i] bytes from src[i] to dst[i], one copy after another
+  // by default.
+  virtual void MemoryCopyH2DBatch(size_t dev_id,
+                                  void** dst,
+                                  const void** src,
+                                  const size_t* sizes,
+                                  size_t count,
+                                  const stream::Stream* stream = nullptr);
+
+  virtual void MemoryCopyD2HBatch(size_t dev_id,
+                                  void** dst,
+                                  const void** src,
+                                  const size_t* sizes,
+                                  size_t count,
+                                  const stream::Stream* stream = nullptr);
+
+  virtual void MemoryCopyD2DBatch(size_t dev_id,
+                                  void** dst,
+                                  const void** src,
+                                  const size_t* sizes,
+                                  size_t count,
+                                  const stream::Stream* stream = nullptr);
+
   virtual void MemoryStats(size_t dev_id, size_t* total, size_t* free);
 
   virtual size_t GetMinChunkSize(size_t dev_id);
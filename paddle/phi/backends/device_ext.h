@@ -446,7 +446,90 @@ struct C_DeviceInterface {
                                     const void* src,
                                     size_t size);
 
-  void* reserved_mem_api[8];
+  /**
+   * @brief Stream ordered device memory allocate, optional. The memory may be
+   * used by the work enqueued to stream after the call, and the default
+   * stream of the device is given as a null stream.
+   *
+   * @param[C_Device]   device     Core fill it with a physical id
+   * @param[C_Stream]   stream
+   * @param[void**]     ptr        Plugin fill it
+   * @param[size_t]     size
+   */
+  C_Status (*async_device_memory_allocate)(const C_Device device,
+                                           C_Stream stream,
+                                           void** ptr,
+                                           size_t size);
+
+  /**
+   * @brief Stream ordered device memory deallocate, optional. The memory is
+   * released after the work enqueued to stream before the call, so that it is
+   * freed without an event. It is used only together with
+   * async_device_memory_allocate.
+   *
+   * @param[C_Device]   device     Core fill it with a physical id
+   * @param[C_Stream]   stream
+   * @param[void*]      ptr
+   * @param[size_t]     size
+   */
+  C_Status (*async_device_memory_deallocate)(const C_Device device,
+                                             C_Stream stream,
+                                             void* ptr,
+                                             size_t size);
+
+  /**
+   * @brief Batched asynchonrize memory copy from host to device, optional.
+   * Copies sizes[i] bytes from src[i] to dst[i] for i in [0, count).
+   *
+   * @param[C_Device]   device     Core fill it with a physical id
+   * @param[C_Stream]   stream
+   * @param[void**]     dst
+   * @param[void**]     src
+   * @param[size_t*]    sizes
+   * @param[size_t]     count
+   */
+  C_Status (*async_memory_copy_h2d_batch)(const C_Device device,
+                                          C_Stream stream,
+                                          void** dst,
+                                          const void** src,
+                                          const size_t* sizes,
+                                          size_t count);
+
+  /**
+   * @brief Batched asynchonrize memory copy from device to host, optional
+   *
+   * @param[C_Device]   device     Core fill it with a physical id
+   * @param[C_Stream]   stream
+   * @param[void**]     dst
+   * @param[void**]     src
+   * @param[size_t*]    sizes
+   * @param[size_t]     count
+   */
+  C_Status (*async_memory_copy_d2h_batch)(const C_Device device,
+                                          C_Stream stream,
+                                          void** dst,
+                                          const void** src,
+                                          const size_t* sizes,
+                                          size_t count);
+
+  /**
+   * @brief Batched asynchonrize memory copy from device to device, optional
+   *
+   * @param[C_Device]   device     Core fill it with a physical id
+   * @param[C_Stream]   stream
+   * @param[void**]     dst
+   * @param[void**]     src
+   * @param[size_t*]    sizes
+   * @param[size_t]     count
+   */
+  C_Status (*async_memory_copy_d2d_batch)(const C_Device device,
+                                          C_Stream stream,
+                                          void** dst,
+                                          const void** src,
+                                          const size_t* sizes,
+                                          size_t count);
+
+  void* reserved_mem_api[3];
 
   //////////////
   // info api //
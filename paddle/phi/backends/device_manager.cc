@@ -22,6 +22,8 @@
 #endif
 
 #include <functional>
+#include <map>
+#include <mutex>
 #include <regex>
 
 #include "glog/logging.h"
@@ -170,6 +172,49 @@ void Device::MemorySet(void* ptr, uint8_t value, size_t size) {
   impl_->MemorySet(dev_id_, ptr, value, size);
 }
 
+bool Device::IsStreamOrderedAllocatorSupported() {
+  return impl_->IsStreamOrderedAllocatorSupported(dev_id_);
+}
+
+void* Device::MemoryAllocateAsync(size_t size, const stream::Stream* stream) {
+  CheckInitialized();
+  return impl_->MemoryAllocateAsync(dev_id_, size, stream);
+}
+
+void Device::MemoryDeallocateAsync(void* ptr,
+                                   size_t size,
+                                   const stream::Stream* stream) {
+  CheckInitialized();
+  impl_->MemoryDeallocateAsync(dev_id_, ptr, size, stream);
+}
+
+void Device::MemoryCopyH2DBatch(void** dst,
+                                const void** src,
+                                const size_t* sizes,
+                                size_t count,
+                                const stream::Stream* stream) {
+  CheckInitialized();
+  impl_->MemoryCopyH2DBatch(dev_id_, dst, src, sizes, count, stream);
+}
+
+void Device::MemoryCopyD2HBatch(void** dst,
+                                const void** src,
+                                const size_t* sizes,
+                                size_t count,
+                                const stream::Stream* stream) {
+  CheckInitialized();
+  impl_->MemoryCopyD2HBatch(dev_id_, dst, src, sizes, count, stream);
+}
+
+void Device::MemoryCopyD2DBatch(void** dst,
+                                const void** src,
+                                const size_t* sizes,
+                                size_t count,
+                                const stream::Stream* stream) {
+  CheckInitialized();
+  impl_->MemoryCopyD2DBatch(dev_id_, dst, src, sizes, count, stream);
+}
+
 template <typename T>
 void Device::BlasAXPBY(const stream::Stream& stream,
                        size_t numel,
@@ -249,6 +294,13 @@ std::string Device::Type() { return impl_->Type(); }
 
 static phi::RWLock _global_device_manager_rw_lock;
 
+// The idle events of every place. It is never destructed, since the events
+// may be returned after the exit of main by the allocations released then.
+static std::mutex _global_event_pool_mutex;
+static auto* _global_event_pool =
+    new std::map<Place, std::vector<std::unique_ptr<event::Event>>>();
+static constexpr size_t kMaxPooledEventsPerPlace = 1024;
+
 bool DeviceManager::Register(std::unique_ptr<DeviceInterface> device_impl) {
   phi::AutoWRLock lock(&_global_device_manager_rw_lock);
   VLOG(4) << "Register Device - " << device_impl->Type();
@@ -474,6 +526,45 @@ void DeviceManager::MemoryStats(const Place& place,
   dev_impl->MemoryStats(device_id, total, free);
 }
 
+bool DeviceManager::IsStreamOrderedAllocatorSupported(const Place& place) {
+  auto device_type = place.GetDeviceType();
+  auto device_id = place.GetDeviceId();
+  auto dev_impl = GetDeviceInterfaceWithType(device_type);
+  return dev_impl->IsStreamOrderedAllocatorSupported(device_id);
+}
+
+std::shared_ptr<event::Event> DeviceManager::GetPooledEvent(
+    const Place& place) {
+  std::unique_ptr<event::Event> event;
+  {
+    std::lock_guard<std::mutex> lock(_global_event_pool_mutex);
+    auto& events = (*_global_event_pool)[place];
+    if (!events.empty()) {
+      event = std::move(events.back());
+      events.pop_back();
+    }
+  }
+  if (!event) {
+    event = std::make_unique<event::Event>();
+    event->Init(place, event::Event::Flag::DisableTiming);
+    VLOG(9) << "Create a new pooled event " << event->raw_event() << " of "
+            << place;
+  }
+  return std::shared_ptr<event::Event>(
+      event.release(), [place](event::Event* event) {
+        std::unique_ptr<event::Event> holder(event);
+        // the events destroyed by Release are not reused
+        if (holder->raw_event() == nullptr) {
+          return;
+        }
+        std::lock_guard<std::mutex> lock(_global_event_pool_mutex);
+        auto& events = (*_global_event_pool)[place];
+        if (events.size() < kMaxPooledEventsPerPlace) {
+          events.emplace_back(std::move(holder));
+        }
+      });
+}
+
 size_t DeviceManager::GetDeviceCount(const std::string& device_type) {
   auto dev_impl = GetDeviceInterfaceWithType(device_type);
   return dev_impl->GetDeviceCount();
@@ -699,6 +790,10 @@ DeviceManager& DeviceManager::Instance() {
 void DeviceManager::Release() {
   event::Event::ReleaseAll();
   stream::Stream::ReleaseAll();
+  {
+    std::lock_guard<std::mutex> lock(_global_event_pool_mutex);
+    _global_event_pool->clear();
+  }
   Instance().device_map_.clear();
   Instance().device_impl_map_.clear();
 }
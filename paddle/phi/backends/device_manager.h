@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 
 #include "paddle/phi/common/data_type.h"
@@ -112,6 +113,32 @@ class Device final {
 
   void MemorySet(void* ptr, uint8_t value, size_t size);
 
+  bool IsStreamOrderedAllocatorSupported();
+
+  void* MemoryAllocateAsync(size_t size, const stream::Stream* stream);
+
+  void MemoryDeallocateAsync(void* ptr,
+                             size_t size,
+                             const stream::Stream* stream);
+
+  void MemoryCopyH2DBatch(void** dst,
+                          const void** src,
+                          const size_t* sizes,
+                          size_t count,
+                          const stream::Stream* stream = nullptr);
+
+  void MemoryCopyD2HBatch(void** dst,
+                          const void** src,
+                          const size_t* sizes,
+                          size_t count,
+                          const stream::Stream* stream = nullptr);
+
+  void MemoryCopyD2DBatch(void** dst,
+                          const void** src,
+                          const size_t* sizes,
+                          size_t count,
+                          const stream::Stream* stream = nullptr);
+
   // Blas
   // ! y = alpha * x + beta * y
   template <typename T>
@@ -170,6 +197,13 @@ class DeviceManager {
 
   static void MemoryStats(const Place& place, size_t* total, size_t* free);
 
+  static bool IsStreamOrderedAllocatorSupported(const Place& place);
+
+  // ! Gets an event of place from the pool of the created events, instead of
+  // creating one. The event returns to the pool when the last reference to it
+  // is released, so it should be completed by then.
+  static std::shared_ptr<event::Event> GetPooledEvent(const Place& place);
+
   static size_t GetDeviceCount(const std::string& device_type);
 
   static std::vector<size_t> GetDeviceList(const std::string& device_type);
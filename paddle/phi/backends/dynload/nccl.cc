@@ -40,5 +40,13 @@ NCCL_RAND_ROUTINE_EACH_AFTER_2703(DEFINE_WRAP)
 NCCL_RAND_ROUTINE_EACH_AFTER_21100(DEFINE_WRAP)
 #endif
 
+#if NCCL_VERSION_CODE >= 21800
+NCCL_RAND_ROUTINE_EACH_AFTER_21800(DEFINE_WRAP)
+#endif
+
+#if NCCL_VERSION_CODE >= 21900
+NCCL_RAND_ROUTINE_EACH_AFTER_21900(DEFINE_WRAP)
+#endif
+
 }  // namespace dynload
 }  // namespace phi
@@ -85,5 +85,19 @@ NCCL_RAND_ROUTINE_EACH_AFTER_2703(DECLARE_DYNAMIC_LOAD_NCCL_WRAP)
 NCCL_RAND_ROUTINE_EACH_AFTER_21100(DECLARE_DYNAMIC_LOAD_NCCL_WRAP)
 #endif
 
+#if NCCL_VERSION_CODE >= 21800
+#define NCCL_RAND_ROUTINE_EACH_AFTER_21800(__macro) __macro(ncclCommSplit);
+NCCL_RAND_ROUTINE_EACH_AFTER_21800(DECLARE_DYNAMIC_LOAD_NCCL_WRAP)
+#endif
+
+#if NCCL_VERSION_CODE >= 21900
+#define NCCL_RAND_ROUTINE_EACH_AFTER_21900(__macro) \
+  __macro(ncclMemAlloc);                            \
+  __macro(ncclMemFree);                             \
+  __macro(ncclCommRegister);                        \
+  __macro(ncclCommDeregister);
+NCCL_RAND_ROUTINE_EACH_AFTER_21900(DECLARE_DYNAMIC_LOAD_NCCL_WRAP)
+#endif
+
 }  // namespace dynload
 }  // namespace phi
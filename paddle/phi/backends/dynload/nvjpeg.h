@@ -42,7 +42,15 @@ extern void *nvjpeg_dso_handle;
   __macro(nvjpegJpegStateCreate);         \
   __macro(nvjpegGetImageInfo);            \
   __macro(nvjpegJpegStateDestroy);        \
-  __macro(nvjpegDecode);
+  __macro(nvjpegDecode);                  \
+  __macro(nvjpegCreateEx);                \
+  __macro(nvjpegDestroy);                 \
+  __macro(nvjpegDecodeBatchedInitialize); \
+  __macro(nvjpegDecodeBatched);           \
+  __macro(nvjpegDecodeBatchedSupported);  \
+  __macro(nvjpegJpegStreamCreate);        \
+  __macro(nvjpegJpegStreamParse);         \
+  __macro(nvjpegJpegStreamDestroy);
 
 NVJPEG_RAND_ROUTINE_EACH(DECLARE_DYNAMIC_LOAD_NVJPEG_WRAP);
 
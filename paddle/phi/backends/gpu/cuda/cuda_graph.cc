@@ -109,6 +109,8 @@ void CUDAGraph::Reset() {
   }
   exec_graphs_.clear();
 #endif
+  // the states of the callbacks may be allocated from the memory pool
+  pre_replay_callbacks_.clear();
   // callback should be called in reverse order because the latter added
   // callback may rely on the former added callback.
   for (auto iter = callbacks_.rbegin(); iter != callbacks_.rend(); ++iter) {
@@ -124,6 +126,9 @@ void CUDAGraph::Replay() {
                     false,
                     phi::errors::PermissionDenied(
                         "Cannot replay the CUDA Graph after reset is called."));
+  for (auto &callback : pre_replay_callbacks_) {
+    callback(stream_);
+  }
   size_t n = exec_graphs_.size();
   for (size_t i = 0; i < n; ++i) {
     if (!is_first_run_) {
@@ -266,6 +266,14 @@ class CUDAGraph {
     capturing_graph_->AddResetCallback(std::move(callback));
   }
 
+  // Adds a callback called on the stream of the graph before every replay,
+  // e.g. to refresh the device states the kernels captured read.
+  static void AddPreReplayCallbackDuringCapturing(
+      std::function<void(cudaStream_t)> callback) {
+    std::lock_guard<std::mutex> guard(capturing_graph_->func_mtx_);
+    capturing_graph_->pre_replay_callbacks_.emplace_back(std::move(callback));
+  }
+
   // No need to add CUDA_VERSION macro because capturing_graph_ would
   // always be nullptr (constructor throws error)
   static bool IsCapturing() { return capturing_graph_ != nullptr; }
@@ -326,6 +334,7 @@ class CUDAGraph {
   // we collect all callbacks as a sequence of 'prehooks', i.e. these functions
   // are called prior to the execution of the cudagraph.
   std::vector<std::vector<cudaGraphExecuterSetter_t>> pre_hooks_;
+  std::vector<std::function<void(cudaStream_t)>> pre_replay_callbacks_;
   std::mutex func_mtx_;
 
   bool is_first_run_{true};
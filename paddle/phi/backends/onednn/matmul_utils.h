@@ -15,6 +15,9 @@
 #pragma once
 
 #include "paddle/phi/backends/onednn/onednn_reuse.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_bool(onednn_matmul_runtime_m);
 
 namespace phi {
 namespace funcs {
@@ -89,16 +92,50 @@ class MatmulOneDNNHandler : public OneDNNHandlerNoCachingT<XT, dnnl::matmul> {
       out_strides[i] = out_ddims[i + 1] * out_strides[i + 1];
     }
 
-    auto x_md = memory::desc(x_dims, OneDNNGetDataType<XT>(), x_strides);
-    auto y_md = memory::desc(y_dims, OneDNNGetDataType<YT>(), y_strides);
-    auto out_md = memory::desc(out_ddims, OneDNNGetDataType<OT>(), out_strides);
+    x_md_ = memory::desc(x_dims, OneDNNGetDataType<XT>(), x_strides);
+    y_md_ = memory::desc(y_dims, OneDNNGetDataType<YT>(), y_strides);
+    out_md_ = memory::desc(out_ddims, OneDNNGetDataType<OT>(), out_strides);
 
-    this->AcquireForwardPrimitiveDescriptor(x_md, y_md, out_md);
+    if (!OneDNNPrimitiveCache::Enabled()) {
+      this->AcquireForwardPrimitiveDescriptor(x_md_, y_md_, out_md_);
+      return;
+    }
+    if (!FLAGS_onednn_matmul_runtime_m) {
+      this->AcquireCachedForwardPrimitiveDescriptor(
+          CreatePrimitiveKey(x_dims, x_strides, y_dims, y_strides, out_ddims),
+          x_md_,
+          y_md_,
+          out_md_);
+      return;
+    }
+    // All the M share one bucket: the primitive takes M, and so the strides
+    // of the batches and of the transposed x, at execution from the memories.
+    const memory::dim kRuntime = DNNL_RUNTIME_DIM_VAL;
+    x_dims[H_idx] = kRuntime;
+    out_ddims[H_idx] = kRuntime;
+    if (trans_x) x_strides[W_idx] = kRuntime;
+    for (int i = MB_idx; i >= 0; --i) {
+      x_strides[i] = kRuntime;
+      out_strides[i] = kRuntime;
+    }
+    this->AcquireCachedForwardPrimitiveDescriptor(
+        CreatePrimitiveKey(x_dims, x_strides, y_dims, y_strides, out_ddims),
+        memory::desc(x_dims, OneDNNGetDataType<XT>(), x_strides),
+        y_md_,
+        memory::desc(out_ddims, OneDNNGetDataType<OT>(), out_strides));
+  }
+
+  // The memories are created from the descs of the actual shapes, which
+  // differ from the ones of the primitive if M is a runtime dim.
+  std::shared_ptr<memory> AcquireSrcMemory(const DenseTensor* input) {
+    const XT* input_data = input->data<XT>();
+    return this->AcquireMemoryFromPrimitive(x_md_,
+                                            to_void_cast<XT>(input_data));
   }
 
   std::shared_ptr<memory> AcquireWeightsMemory(const DenseTensor* input) {
     const YT* input_data = input->data<YT>();
-    return this->AcquireMemoryFromPrimitive(this->fwd_pd_->weights_desc(),
+    return this->AcquireMemoryFromPrimitive(y_md_,
                                             to_void_cast<YT>(input_data));
   }
 
@@ -112,8 +149,41 @@ class MatmulOneDNNHandler : public OneDNNHandlerNoCachingT<XT, dnnl::matmul> {
     // and it triggers an assertion.  So as there is no 'any' format here we can
     // leave default size of DenseTensor as computed in ComputeInferShape
     OT* ptr = dev_ctx.template Alloc<OT>(output);
-    return this->AcquireMemoryFromPrimitive(this->fwd_pd_->dst_desc(), ptr);
+    return this->AcquireMemoryFromPrimitive(out_md_, ptr);
+  }
+
+ private:
+  static std::string CreatePrimitiveKey(
+      const std::vector<int64_t>& x_dims,
+      const std::vector<int64_t>& x_strides,
+      const std::vector<int64_t>& y_dims,
+      const std::vector<int64_t>& y_strides,
+      const std::vector<int64_t>& out_dims) {
+    std::string key = "matmul";
+    auto append = [&key](const std::vector<int64_t>& values) {
+      key += '|';
+      for (int64_t value : values) {
+        key += std::to_string(value);
+        key += ',';
+      }
+    };
+    append(x_dims);
+    append(x_strides);
+    append(y_dims);
+    append(y_strides);
+    append(out_dims);
+    key += '|';
+    AppendKey(&key, OneDNNGetDataType<XT>());
+    key += ',';
+    AppendKey(&key, OneDNNGetDataType<YT>());
+    key += ',';
+    AppendKey(&key, OneDNNGetDataType<OT>());
+    return key;
   }
+
+  memory::desc x_md_;
+  memory::desc y_md_;
+  memory::desc out_md_;
 };
 
 template <typename T>
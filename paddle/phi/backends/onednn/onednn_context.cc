@@ -25,8 +25,15 @@
 
 namespace phi {
 
+// All the threads share one engine, so that the primitives created by one of
+// them, e.g. in the global primitive cache, can run on the streams of others.
+static const dnnl::engine& GlobalCPUEngine() {
+  static dnnl::engine engine(dnnl::engine::kind::cpu, 0);
+  return engine;
+}
+
 OneDNNContextThreadLocals::Body::Body()
-    : cur_engine(dnnl::engine::kind::cpu, 0), cur_stream(cur_engine) {
+    : cur_engine(GlobalCPUEngine()), cur_stream(cur_engine) {
   cur_mkldnn_session_id = kMKLDNNSessionID_Default;
   cur_input_shape_str = "";
   cur_input_shape_cache_capacity = 1;
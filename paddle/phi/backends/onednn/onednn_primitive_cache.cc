@@ -0,0 +1,91 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifdef PADDLE_WITH_DNNL
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
+
+#include <algorithm>
+
+#include "glog/logging.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_int32(onednn_primitive_cache_capacity);
+
+namespace phi {
+
+OneDNNPrimitiveCache& OneDNNPrimitiveCache::Instance() {
+  static OneDNNPrimitiveCache cache;
+  return cache;
+}
+
+bool OneDNNPrimitiveCache::Enabled() {
+  return FLAGS_onednn_primitive_cache_capacity > 0;
+}
+
+std::shared_ptr<void> OneDNNPrimitiveCache::Get(const std::string& key) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++stats_.misses;
+    VLOG(4) << "oneDNN primitive cache miss: " << key;
+    return nullptr;
+  }
+  ++stats_.hits;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->second;
+}
+
+std::shared_ptr<void> OneDNNPrimitiveCache::Insert(
+    const std::string& key, std::shared_ptr<void> value) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+  }
+  const size_t capacity =
+      static_cast<size_t>(std::max(FLAGS_onednn_primitive_cache_capacity, 0));
+  while (!lru_.empty() && lru_.size() >= capacity) {
+    entries_.erase(lru_.back().first);
+    lru_.pop_back();
+    ++stats_.evictions;
+  }
+  if (capacity == 0) {
+    return value;
+  }
+  lru_.emplace_front(key, std::move(value));
+  entries_[key] = lru_.begin();
+  VLOG(3) << "oneDNN primitive cache: " << lru_.size() << " entries, "
+          << stats_.hits << " hits, " << stats_.misses << " misses, "
+          << stats_.evictions << " evictions";
+  return lru_.front().second;
+}
+
+OneDNNPrimitiveCache::Stats OneDNNPrimitiveCache::GetStats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  Stats stats = stats_;
+  stats.size = lru_.size();
+  stats.capacity =
+      static_cast<size_t>(std::max(FLAGS_onednn_primitive_cache_capacity, 0));
+  return stats;
+}
+
+void OneDNNPrimitiveCache::Clear() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  lru_.clear();
+  entries_.clear();
+  stats_ = Stats();
+}
+
+}  // namespace phi
+#endif
@@ -0,0 +1,90 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#ifdef PADDLE_WITH_DNNL
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "paddle/common/macros.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+
+// The process-wide cache of the oneDNN primitives, keyed by the op, its
+// attributes and the shape bucket of its inputs. Unlike the blob map of
+// OneDNNContext, which is kept per session and input shape and cleared with
+// the executor, it is shared by all the threads and so by all the predictors
+// cloned from one, so that a shape seen by any of them skips the creation of
+// the primitive descriptor. It keeps at most
+// FLAGS_onednn_primitive_cache_capacity entries by evicting the least
+// recently used one.
+class OneDNNPrimitiveCache {
+ public:
+  struct Stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+    size_t size{0};
+    size_t capacity{0};
+  };
+
+  TEST_API static OneDNNPrimitiveCache& Instance();
+
+  TEST_API static bool Enabled();
+
+  // Returns the entry of key, or creates it by creator on a miss. The creator
+  // runs without the lock, so that the creation of a primitive does not block
+  // the lookups of the others; if two threads miss the same key, the entry of
+  // the first one is kept.
+  template <typename T, typename Creator>
+  std::shared_ptr<T> GetOrCreate(const std::string& key, Creator&& creator) {
+    auto entry = std::static_pointer_cast<T>(Get(key));
+    if (entry) {
+      return entry;
+    }
+    entry = creator();
+    return std::static_pointer_cast<T>(Insert(key, entry));
+  }
+
+  TEST_API std::shared_ptr<void> Get(const std::string& key);
+
+  // Inserts value unless key exists, and returns the entry of key.
+  TEST_API std::shared_ptr<void> Insert(const std::string& key,
+                                        std::shared_ptr<void> value);
+
+  TEST_API Stats GetStats() const;
+
+  TEST_API void Clear();
+
+ private:
+  OneDNNPrimitiveCache() = default;
+  DISABLE_COPY_AND_ASSIGN(OneDNNPrimitiveCache);
+
+  using LruList = std::list<std::pair<std::string, std::shared_ptr<void>>>;
+
+  mutable std::mutex mutex_;
+  // the most recently used entry is at the front
+  LruList lru_;
+  std::unordered_map<std::string, LruList::iterator> entries_;
+  Stats stats_;
+};
+
+}  // namespace phi
+#endif
@@ -24,6 +24,7 @@ limitations under the License. */
 
 #include "paddle/phi/backends/onednn/onednn_context.h"
 #include "paddle/phi/backends/onednn/onednn_helper.h"
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/common/int_array.h"
 #include "paddle/phi/common/place.h"
@@ -531,6 +532,9 @@ class OneDNNHandlerNoCachingT {
   }
 
   std::shared_ptr<TForward> AcquireForwardPrimitive() {
+    if (fwd_p_) {
+      return fwd_p_;
+    }
     return std::make_shared<TForward>(*fwd_pd_);
   }
 
@@ -615,6 +619,32 @@ class OneDNNHandlerNoCachingT {
     CreateForwardPrimitiveDescriptor(first_arg, std::forward<Args>(args)...);
   }
 
+  // The same as AcquireForwardPrimitiveDescriptor, but takes the descriptor
+  // and the primitive from the global primitive cache, where key has to
+  // identify all the arguments of the descriptor. The primitive is created
+  // along with the descriptor on a miss and reused by AcquireForwardPrimitive.
+  template <typename Arg, typename... Args>
+  void AcquireCachedForwardPrimitiveDescriptor(const std::string& key,
+                                               Arg&& first_arg,
+                                               Args&&... args) {
+    if (!OneDNNPrimitiveCache::Enabled()) {
+      AcquireForwardPrimitiveDescriptor(std::forward<Arg>(first_arg),
+                                        std::forward<Args>(args)...);
+      return;
+    }
+    auto entry =
+        OneDNNPrimitiveCache::Instance().GetOrCreate<CachedForwardPrimitive>(
+            key, [&]() {
+              CreateForwardPrimitiveDescriptor(first_arg, args...);
+              auto created = std::make_shared<CachedForwardPrimitive>();
+              created->pd = fwd_pd_;
+              created->primitive = std::make_shared<TForward>(*fwd_pd_);
+              return created;
+            });
+    fwd_pd_ = entry->pd;
+    fwd_p_ = entry->primitive;
+  }
+
   // Using sfinae to specialise variadic function. Workaround for not having
   // if constexpr in C++ 11.
   template <class First, class... Args>
@@ -710,11 +740,18 @@ class OneDNNHandlerNoCachingT {
     return target_memory_p;
   }
 
+  struct CachedForwardPrimitive {
+    std::shared_ptr<typename TForward::primitive_desc> pd;
+    std::shared_ptr<TForward> primitive;
+  };
+
   dnnl::engine engine_;
   Place place_;
   std::shared_ptr<typename TForward::primitive_desc> fwd_pd_;
   std::shared_ptr<typename TBackward::primitive_desc> bwd_pd_;
   std::shared_ptr<typename TBackward_params::primitive_desc> bwd_w_pd_;
+  // the forward primitive taken from the global primitive cache
+  std::shared_ptr<TForward> fwd_p_;
 };
 
 template <typename T>
@@ -150,4 +150,126 @@ void XPUL3Planner::RunAutotune(
   VLOG(3) << "AutoTune XPU L3 Cache Block End.";
 }
 
+void XPUL3Planner::RunLifetimeAutotune(
+    const std::vector<XPUL3CacheBlock*>& l3_block_dict,
+    size_t l3_size,
+    size_t l3_total_size) {
+  if (l3_block_dict.size() == 0 || l3_size <= 0 || !plan_.empty()) {
+    return;
+  }
+  VLOG(3) << "AutoTune XPU L3 Cache Block by Lifetime Start.";
+  constexpr size_t kAlignment = 64;
+  struct Candidate {
+    size_t block_idx;
+    size_t first_op;
+    size_t last_op;
+    // the distinct sizes of the block fitting in l3, ascending, and the bytes
+    // hit in l3 with each of them
+    std::vector<size_t> sizes;
+    std::vector<size_t> scores;
+  };
+  std::vector<Candidate> candidates;
+  total_bytes_ = 0;
+  for (size_t block_idx = 0; block_idx < l3_block_dict.size(); block_idx++) {
+    XPUL3CacheBlock* cur_block = l3_block_dict[block_idx];
+    std::vector<size_t> history = cur_block->history_;
+    std::sort(history.begin(), history.end());
+    Candidate candidate;
+    candidate.block_idx = block_idx;
+    candidate.first_op = cur_block->has_lifetime() ? cur_block->first_op() : 0;
+    candidate.last_op = cur_block->has_lifetime()
+                            ? cur_block->last_op()
+                            : std::numeric_limits<size_t>::max();
+    size_t score = 0;
+    for (size_t i = 0; i < history.size(); i++) {
+      total_bytes_ += history[i];
+      size_t aligned_size =
+          (history[i] + kAlignment - 1) / kAlignment * kAlignment;
+      if (aligned_size > l3_size || aligned_size == 0) {
+        continue;
+      }
+      score += history[i];
+      if (i == history.size() - 1 || history[i + 1] != history[i]) {
+        candidate.sizes.push_back(aligned_size);
+        candidate.scores.push_back(score);
+      }
+    }
+    if (!candidate.sizes.empty()) {
+      candidates.push_back(candidate);
+    }
+  }
+  std::sort(candidates.begin(),
+            candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+              double a_density =
+                  static_cast<double>(a.scores.back()) / a.sizes.back();
+              double b_density =
+                  static_cast<double>(b.scores.back()) / b.sizes.back();
+              if (a_density != b_density) {
+                return a_density > b_density;
+              }
+              return a.scores.back() > b.scores.back();
+            });
+
+  struct PlacedBlock {
+    size_t offset;
+    size_t size;
+    size_t first_op;
+    size_t last_op;
+  };
+  std::vector<PlacedBlock> placed_blocks;
+  plan_.assign(l3_block_dict.size() + 1, 0);
+  offsets_.assign(l3_block_dict.size(), 0);
+  l3_hit_bytes_ = 0;
+  size_t block_l3_size = 0;
+  for (const auto& candidate : candidates) {
+    // the placed blocks living at the same time, by their offsets
+    std::vector<PlacedBlock> live_blocks;
+    for (const auto& placed : placed_blocks) {
+      if (placed.first_op <= candidate.last_op &&
+          candidate.first_op <= placed.last_op) {
+        live_blocks.push_back(placed);
+      }
+    }
+    std::sort(live_blocks.begin(),
+              live_blocks.end(),
+              [](const PlacedBlock& a, const PlacedBlock& b) {
+                return a.offset < b.offset;
+              });
+    for (size_t k = candidate.sizes.size(); k > 0; k--) {
+      size_t size = candidate.sizes[k - 1];
+      size_t offset = 0;
+      for (const auto& live : live_blocks) {
+        if (offset + size <= live.offset) {
+          break;
+        }
+        offset = std::max(offset, live.offset + live.size);
+      }
+      if (offset + size > l3_size) {
+        continue;
+      }
+      placed_blocks.push_back(
+          {offset, size, candidate.first_op, candidate.last_op});
+      plan_[candidate.block_idx] = size;
+      offsets_[candidate.block_idx] = offset;
+      l3_hit_bytes_ += candidate.scores[k - 1];
+      block_l3_size = std::max(block_l3_size, offset + size);
+      VLOG(3) << "BLOCK IDX is " << candidate.block_idx
+              << ", Acquired L3 Size is " << size << " at offset " << offset;
+      break;
+    }
+  }
+  plan_[l3_block_dict.size()] =
+      (std::max(l3_total_size, block_l3_size) - block_l3_size) / kAlignment *
+      kAlignment;
+  LOG(INFO) << "XPU L3 planner places " << placed_blocks.size() << " of "
+            << l3_block_dict.size() << " tensors in " << block_l3_size
+            << " bytes of L3, the L3 hits are " << l3_hit_bytes_ << " of "
+            << total_bytes_ << " bytes per run ("
+            << (total_bytes_ == 0 ? 0.0
+                                  : 100.0 * l3_hit_bytes_ / total_bytes_)
+            << "%), and XDNN Ctx L3 Size is " << plan_.back();
+  VLOG(3) << "AutoTune XPU L3 Cache Block by Lifetime End.";
+}
+
 }  // namespace phi
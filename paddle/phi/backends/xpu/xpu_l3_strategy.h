@@ -14,6 +14,7 @@ limitations under the License. */
 
 #pragma once
 #include <algorithm>
+#include <limits>
 #include <numeric>
 #include <vector>
 
@@ -25,15 +26,28 @@ struct XPUL3CacheBlock {
     addr_ = nullptr;
     size_ = 0;
     history_.clear();
+    first_op_ = std::numeric_limits<size_t>::max();
+    last_op_ = 0;
   }
   void Set(void* addr, size_t size);
   void Record(size_t size) { history_.push_back(size); }
+  // Extends the lifetime of the block to the ops first_op to last_op of the
+  // program, by their order. A block without lifetime lives through the run.
+  void RecordLifetime(size_t first_op, size_t last_op) {
+    first_op_ = std::min(first_op_, first_op);
+    last_op_ = std::max(last_op_, last_op);
+  }
+  bool has_lifetime() const { return first_op_ <= last_op_; }
+  size_t first_op() const { return first_op_; }
+  size_t last_op() const { return last_op_; }
   void* data() { return addr_; }
   size_t size() { return size_; }
 
  private:
   void* addr_{nullptr};
   size_t size_{0};
+  size_t first_op_{std::numeric_limits<size_t>::max()};
+  size_t last_op_{0};
 
  public:
   std::vector<size_t> history_;
@@ -44,10 +58,30 @@ class XPUL3Planner {
   void RunAutotune(const std::vector<XPUL3CacheBlock*>& l3_block_dict,
                    size_t l3_size);
 
+  // Plans the blocks across the whole program by their lifetimes: the blocks
+  // whose lifetimes do not overlap share the same l3, so more of the
+  // intermediates stay in l3 across the op boundaries. The blocks are placed
+  // by the l3 hits per byte, each at the first offset that does not overlap
+  // the placed blocks living at the same time, with the largest of its sizes
+  // that fits in l3_size. plan() holds the sizes of the blocks and the l3 left
+  // for the xdnn ctx of l3_total_size, and offsets() the offsets of the
+  // blocks.
+  void RunLifetimeAutotune(const std::vector<XPUL3CacheBlock*>& l3_block_dict,
+                           size_t l3_size,
+                           size_t l3_total_size);
+
   std::vector<size_t>* plan() { return &plan_; }
+  std::vector<size_t>* offsets() { return &offsets_; }
+
+  // the bytes of the allocations planned in l3 in a run, and of all of them
+  size_t l3_hit_bytes() const { return l3_hit_bytes_; }
+  size_t total_bytes() const { return total_bytes_; }
 
  private:
   std::vector<size_t> plan_;
+  std::vector<size_t> offsets_;
+  size_t l3_hit_bytes_{0};
+  size_t total_bytes_{0};
 };
 
 }  // namespace phi
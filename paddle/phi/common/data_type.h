@@ -17,6 +17,7 @@ limitations under the License. */
 #include "paddle/common/exception.h"
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/common/complex.h"
+#include "paddle/phi/common/float8.h"
 #include "paddle/phi/common/float16.h"
 
 namespace phi {
@@ -31,6 +32,8 @@ using complex64 = ::phi::dtype::complex<float>;
 using complex128 = ::phi::dtype::complex<double>;
 using float16 = ::phi::dtype::float16;
 using bfloat16 = ::phi::dtype::bfloat16;
+using float8_e4m3fn = ::phi::dtype::float8_e4m3fn;
+using float8_e5m2 = ::phi::dtype::float8_e5m2;
 using pstring = ::phi::dtype::pstring;
 
 // The enum value are consistent with jit/property.proto
@@ -69,6 +72,12 @@ enum class DataType {
   // This format has 1 sign bit, 8 exponent bits, and 7 mantissa bits.
   BFLOAT16,
 
+  // The 8 bits floating-point formats, see paddle/phi/common/float8.h.
+  // This format has 1 sign bit, 4 exponent bits, and 3 mantissa bits.
+  FLOAT8_E4M3FN,
+  // This format has 1 sign bit, 5 exponent bits, and 2 mantissa bits.
+  FLOAT8_E5M2,
+
   NUM_DATA_TYPES,
   // See Note [ Why we need ALL in basic kernel key member? ]
   ALL_DTYPE = UNDEFINED,
@@ -79,6 +88,8 @@ inline size_t SizeOf(DataType data_type) {
     case DataType::BOOL:
     case DataType::UINT8:
     case DataType::INT8:
+    case DataType::FLOAT8_E4M3FN:
+    case DataType::FLOAT8_E5M2:
       return 1;
     case DataType::BFLOAT16:
     case DataType::FLOAT16:
@@ -108,23 +119,25 @@ inline size_t SizeOf(DataType data_type) {
   return 0;
 }
 
-#define PD_FOR_EACH_DATA_TYPE(_)      \
-  _(bool, DataType::BOOL)             \
-  _(int8_t, DataType::INT8)           \
-  _(uint8_t, DataType::UINT8)         \
-  _(int16_t, DataType::INT16)         \
-  _(uint16_t, DataType::UINT16)       \
-  _(int32_t, DataType::INT32)         \
-  _(uint32_t, DataType::UINT32)       \
-  _(int64_t, DataType::INT64)         \
-  _(uint64_t, DataType::UINT64)       \
-  _(bfloat16, DataType::BFLOAT16)     \
-  _(float16, DataType::FLOAT16)       \
-  _(float, DataType::FLOAT32)         \
-  _(double, DataType::FLOAT64)        \
-  _(complex64, DataType::COMPLEX64)   \
-  _(complex128, DataType::COMPLEX128) \
-  _(pstring, DataType::PSTRING)
+#define PD_FOR_EACH_DATA_TYPE(_)            \
+  _(bool, DataType::BOOL)                   \
+  _(int8_t, DataType::INT8)                 \
+  _(uint8_t, DataType::UINT8)               \
+  _(int16_t, DataType::INT16)               \
+  _(uint16_t, DataType::UINT16)             \
+  _(int32_t, DataType::INT32)               \
+  _(uint32_t, DataType::UINT32)             \
+  _(int64_t, DataType::INT64)               \
+  _(uint64_t, DataType::UINT64)             \
+  _(bfloat16, DataType::BFLOAT16)           \
+  _(float16, DataType::FLOAT16)             \
+  _(float, DataType::FLOAT32)               \
+  _(double, DataType::FLOAT64)              \
+  _(complex64, DataType::COMPLEX64)         \
+  _(complex128, DataType::COMPLEX128)       \
+  _(pstring, DataType::PSTRING)             \
+  _(float8_e4m3fn, DataType::FLOAT8_E4M3FN) \
+  _(float8_e5m2, DataType::FLOAT8_E5M2)
 
 template <DataType T>
 struct DataTypeToCppType;
@@ -205,6 +218,12 @@ inline std::ostream& operator<<(std::ostream& os, DataType dtype) {
     case DataType::PSTRING:
       os << "pstring";
       break;
+    case DataType::FLOAT8_E4M3FN:
+      os << "float8_e4m3fn";
+      break;
+    case DataType::FLOAT8_E5M2:
+      os << "float8_e5m2";
+      break;
     default:
       PD_THROW("Invalid enum data type `", static_cast<int>(dtype), "`.");
   }
@@ -247,6 +266,10 @@ inline std::string DataTypeToString(const DataType& dtype) {
       return "complex128";
     case DataType::PSTRING:
       return "pstring";
+    case DataType::FLOAT8_E4M3FN:
+      return "float8_e4m3fn";
+    case DataType::FLOAT8_E5M2:
+      return "float8_e5m2";
     default:
       PD_THROW("Invalid enum data type `", static_cast<int>(dtype), "`.");
   }
@@ -261,6 +284,8 @@ using bfloat16 = phi::bfloat16;
 using complex64 = phi::complex64;
 using complex128 = phi::complex128;
 using float16 = phi::float16;
+using float8_e4m3fn = phi::float8_e4m3fn;
+using float8_e5m2 = phi::float8_e5m2;
 using pstring = phi::pstring;
 
 }  // namespace paddle
@@ -0,0 +1,372 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include "paddle/phi/core/hostdevice.h"
+
+#ifdef PADDLE_WITH_CUDA
+#include <cuda.h>
+#endif
+
+#if defined(__CUDACC__) && CUDA_VERSION >= 11080
+#define PADDLE_CUDA_FP8
+#include <cuda_fp8.h>
+#endif
+
+namespace phi {
+namespace dtype {
+
+// The 8 bits floating-point formats of "FP8 Formats for Deep Learning":
+//   float8_e4m3fn: 1 sign bit, 4 exponent bits and 3 mantissa bits, the max
+//                  is 448, there is no infinity and S.1111.111 is the NaN.
+//   float8_e5m2:   1 sign bit, 5 exponent bits and 2 mantissa bits, the max
+//                  is 57344, it follows the IEEE754 rules of the inf and NaN.
+// A float is rounded to the nearest even and saturated to the max, which is
+// the way they are used in training, and the NaN is kept.
+namespace detail {
+
+HOSTDEVICE inline uint32_t Float8BitsOf(float val) {
+#if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__)
+  return __float_as_uint(val);
+#else
+  uint32_t bits;
+  std::memcpy(&bits, &val, sizeof(bits));
+  return bits;
+#endif
+}
+
+HOSTDEVICE inline float Float8FloatOf(uint32_t bits) {
+#if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__)
+  return __uint_as_float(bits);
+#else
+  float val;
+  std::memcpy(&val, &bits, sizeof(val));
+  return val;
+#endif
+}
+
+template <int kExpBits, int kManBits, uint8_t kMaxCode>
+HOSTDEVICE inline uint8_t FloatToFloat8(float val) {
+  constexpr int kBias = (1 << (kExpBits - 1)) - 1;
+  constexpr int kMinExp = 1 - kBias;
+  uint32_t bits = Float8BitsOf(val);
+  const uint8_t sign = static_cast<uint8_t>((bits >> 24) & 0x80);
+  bits &= 0x7fffffff;
+  if (bits > 0x7f800000) {
+    return sign | 0x7f;
+  }
+  if (bits == 0) {
+    return sign;
+  }
+  int exp = static_cast<int>(bits >> 23) - 127;
+  uint32_t man = bits & 0x7fffff;
+  if (exp == -127) {
+    exp = -126;
+  } else {
+    man |= 0x800000;
+  }
+  // the fp8 code of a normal is (exp + bias) << kManBits | man, and the one
+  // of a subnormal is man in the units of 2 ^ (kMinExp - kManBits)
+  int shift = 23 - kManBits;
+  uint32_t code;
+  if (exp < kMinExp) {
+    shift += kMinExp - exp;
+    if (shift > 24) {
+      return sign;
+    }
+    code = man >> shift;
+  } else {
+    code = (static_cast<uint32_t>(exp + kBias) << kManBits) |
+           ((man & 0x7fffff) >> shift);
+  }
+  const uint32_t rem = man & ((1u << shift) - 1);
+  const uint32_t half = 1u << (shift - 1);
+  if (rem > half || (rem == half && (code & 1))) {
+    ++code;
+  }
+  return sign | static_cast<uint8_t>(code > kMaxCode ? kMaxCode : code);
+}
+
+template <int kExpBits, int kManBits, bool kFiniteOnly>
+HOSTDEVICE inline float Float8ToFloat(uint8_t x) {
+  constexpr int kBias = (1 << (kExpBits - 1)) - 1;
+  constexpr uint32_t kExpMask = (1u << kExpBits) - 1;
+  const uint32_t sign = static_cast<uint32_t>(x & 0x80) << 24;
+  const uint32_t exp = (x >> kManBits) & kExpMask;
+  const uint32_t man = x & ((1u << kManBits) - 1);
+  if (kFiniteOnly ? (x & 0x7f) == 0x7f : exp == kExpMask) {
+    return Float8FloatOf(sign |
+                         ((man || kFiniteOnly) ? 0x7fc00000 : 0x7f800000));
+  }
+  if (exp == 0) {
+    const float sub = static_cast<float>(man) *
+                      Float8FloatOf((127 + 1 - kBias - kManBits) << 23);
+    return sign ? -sub : sub;
+  }
+  return Float8FloatOf(sign | ((exp + 127 - kBias) << 23) |
+                       (man << (23 - kManBits)));
+}
+
+}  // namespace detail
+
+struct float8_e4m3fn {
+ public:
+  uint8_t x;
+
+  // Constructors
+  float8_e4m3fn() = default;
+  float8_e4m3fn(const float8_e4m3fn& o) = default;
+  float8_e4m3fn& operator=(const float8_e4m3fn& o) = default;
+  float8_e4m3fn(float8_e4m3fn&& o) = default;
+  float8_e4m3fn& operator=(float8_e4m3fn&& o) = default;
+  ~float8_e4m3fn() = default;
+
+  HOSTDEVICE inline explicit float8_e4m3fn(float val) {
+#if defined(PADDLE_CUDA_FP8) && defined(__CUDA_ARCH__)
+    x = __nv_cvt_float_to_fp8(val, __NV_SATFINITE, __NV_E4M3);
+#else
+    x = detail::FloatToFloat8<4, 3, 0x7e>(val);
+#endif
+  }
+
+  template <class T>
+  HOSTDEVICE inline explicit float8_e4m3fn(const T& val)
+      : x(float8_e4m3fn(static_cast<float>(val)).x) {}
+
+  // Conversion operators
+  HOSTDEVICE inline operator float() const {
+    return detail::Float8ToFloat<4, 3, true>(x);
+  }
+
+  HOSTDEVICE inline explicit operator bool() const { return (x & 0x7f) != 0; }
+
+  HOSTDEVICE inline explicit operator double() const {
+    return static_cast<double>(static_cast<float>(*this));
+  }
+};
+
+struct float8_e5m2 {
+ public:
+  uint8_t x;
+
+  // Constructors
+  float8_e5m2() = default;
+  float8_e5m2(const float8_e5m2& o) = default;
+  float8_e5m2& operator=(const float8_e5m2& o) = default;
+  float8_e5m2(float8_e5m2&& o) = default;
+  float8_e5m2& operator=(float8_e5m2&& o) = default;
+  ~float8_e5m2() = default;
+
+  HOSTDEVICE inline explicit float8_e5m2(float val) {
+#if defined(PADDLE_CUDA_FP8) && defined(__CUDA_ARCH__)
+    x = __nv_cvt_float_to_fp8(val, __NV_SATFINITE, __NV_E5M2);
+#else
+    x = detail::FloatToFloat8<5, 2, 0x7b>(val);
+#endif
+  }
+
+  template <class T>
+  HOSTDEVICE inline explicit float8_e5m2(const T& val)
+      : x(float8_e5m2(static_cast<float>(val)).x) {}
+
+  // Conversion operators
+  HOSTDEVICE inline operator float() const {
+    return detail::Float8ToFloat<5, 2, false>(x);
+  }
+
+  HOSTDEVICE inline explicit operator bool() const { return (x & 0x7f) != 0; }
+
+  HOSTDEVICE inline explicit operator double() const {
+    return static_cast<double>(static_cast<float>(*this));
+  }
+};
+
+HOSTDEVICE inline float8_e4m3fn raw_uint8_to_float8_e4m3fn(uint8_t a) {
+  float8_e4m3fn res;
+  res.x = a;
+  return res;
+}
+
+HOSTDEVICE inline float8_e5m2 raw_uint8_to_float8_e5m2(uint8_t a) {
+  float8_e5m2 res;
+  res.x = a;
+  return res;
+}
+
+// The fp8 types are storage only, the arithmetic is done in float by the
+// implicit conversion.
+#define PD_DEFINE_FLOAT8_FUNCTIONS(fp8_type)                                \
+  HOSTDEVICE inline bool operator==(const fp8_type& a, const fp8_type& b) { \
+    return static_cast<float>(a) == static_cast<float>(b);                  \
+  }                                                                         \
+  HOSTDEVICE inline bool operator!=(const fp8_type& a, const fp8_type& b) { \
+    return static_cast<float>(a) != static_cast<float>(b);                  \
+  }                                                                         \
+  HOSTDEVICE inline bool(isfinite)(const fp8_type& a) {                     \
+    return !((isnan)(a)) && !((isinf)(a));                                  \
+  }                                                                         \
+  inline std::ostream& operator<<(std::ostream& os, const fp8_type& a) {    \
+    os << static_cast<float>(a);                                            \
+    return os;                                                              \
+  }
+
+HOSTDEVICE inline bool(isnan)(const float8_e4m3fn& a) {
+  return (a.x & 0x7f) == 0x7f;
+}
+
+HOSTDEVICE inline bool(isinf)(const float8_e4m3fn& a) { return false; }
+
+HOSTDEVICE inline bool(isnan)(const float8_e5m2& a) {
+  return (a.x & 0x7f) > 0x7c;
+}
+
+HOSTDEVICE inline bool(isinf)(const float8_e5m2& a) {
+  return (a.x & 0x7f) == 0x7c;
+}
+
+PD_DEFINE_FLOAT8_FUNCTIONS(float8_e4m3fn)
+PD_DEFINE_FLOAT8_FUNCTIONS(float8_e5m2)
+
+#undef PD_DEFINE_FLOAT8_FUNCTIONS
+
+}  // namespace dtype
+}  // namespace phi
+
+namespace std {
+
+template <>
+struct numeric_limits<phi::dtype::float8_e4m3fn> {
+  static const bool is_specialized = true;
+  static const bool is_signed = true;
+  static const bool is_integer = false;
+  static const bool is_exact = false;
+  static const bool has_infinity = false;
+  static const bool has_quiet_NaN = true;
+  static const bool has_signaling_NaN = false;
+  static const float_denorm_style has_denorm = denorm_present;
+  static const bool has_denorm_loss = false;
+  static const std::float_round_style round_style = std::round_to_nearest;
+  static const bool is_iec559 = false;
+  static const bool is_bounded = true;
+  static const bool is_modulo = false;
+  static const int digits = 4;
+  static const int digits10 = 0;
+  static const int max_digits10 = 3;
+  static const int radix = 2;
+  static const int min_exponent = -5;
+  static const int min_exponent10 = -1;
+  static const int max_exponent = 9;
+  static const int max_exponent10 = 2;
+  static const bool traps = false;
+  static const bool tinyness_before = false;
+
+  HOSTDEVICE static phi::dtype::float8_e4m3fn(min)() {
+    return phi::dtype::raw_uint8_to_float8_e4m3fn(0x08);
+  }
+  HOSTDEVICE static phi::dtype::float8_e4m3fn lowest() {
+    return phi::dtype::raw_uint8_to_float8_e4m3fn(0xfe);
+  }
+  HOSTDEVICE static phi::dtype::float8_e4m3fn(max)() {
+    return phi::dtype::raw_uint8_to_float8_e4m3fn(0x7e);
+  }
+  HOSTDEVICE static phi::dtype::float8_e4m3fn epsilon() {
+    return phi::dtype::raw_uint8_to_float8_e4m3fn(0x20);
+  }
+  HOSTDEVICE static phi::dtype::float8_e4m3fn round_error() {
+    return phi::dtype::raw_uint8_to_float8_e4m3fn(0x30);
+  }
+  HOSTDEVICE static phi::dtype::float8_e4m3fn quiet_NaN() {
+    return phi::dtype::raw_uint8_to_float8_e4m3fn(0x7f);
+  }
+  HOSTDEVICE static phi::dtype::float8_e4m3fn denorm_min() {
+    return phi::dtype::raw_uint8_to_float8_e4m3fn(0x01);
+  }
+};
+
+template <>
+struct numeric_limits<phi::dtype::float8_e5m2> {
+  static const bool is_specialized = true;
+  static const bool is_signed = true;
+  static const bool is_integer = false;
+  static const bool is_exact = false;
+  static const bool has_infinity = true;
+  static const bool has_quiet_NaN = true;
+  static const bool has_signaling_NaN = false;
+  static const float_denorm_style has_denorm = denorm_present;
+  static const bool has_denorm_loss = false;
+  static const std::float_round_style round_style = std::round_to_nearest;
+  static const bool is_iec559 = false;
+  static const bool is_bounded = true;
+  static const bool is_modulo = false;
+  static const int digits = 3;
+  static const int digits10 = 0;
+  static const int max_digits10 = 2;
+  static const int radix = 2;
+  static const int min_exponent = -13;
+  static const int min_exponent10 = -4;
+  static const int max_exponent = 16;
+  static const int max_exponent10 = 4;
+  static const bool traps = false;
+  static const bool tinyness_before = false;
+
+  HOSTDEVICE static phi::dtype::float8_e5m2(min)() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x04);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2 lowest() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0xfb);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2(max)() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x7b);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2 epsilon() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x34);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2 round_error() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x38);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2 infinity() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x7c);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2 quiet_NaN() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x7e);
+  }
+  HOSTDEVICE static phi::dtype::float8_e5m2 denorm_min() {
+    return phi::dtype::raw_uint8_to_float8_e5m2(0x01);
+  }
+};
+
+inline bool isnan(const phi::dtype::float8_e4m3fn& a) {
+  return phi::dtype::isnan(a);
+}
+
+inline bool isinf(const phi::dtype::float8_e4m3fn& a) {
+  return phi::dtype::isinf(a);
+}
+
+inline bool isnan(const phi::dtype::float8_e5m2& a) {
+  return phi::dtype::isnan(a);
+}
+
+inline bool isinf(const phi::dtype::float8_e5m2& a) {
+  return phi::dtype::isinf(a);
+}
+
+}  // namespace std
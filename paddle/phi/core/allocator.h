@@ -78,6 +78,11 @@ class Allocation {
   const Place& place() const noexcept { return place_; }
   DeleterFnPtr deleter() const noexcept { return deleter_; }
 
+  // Extends the buffer in place to hold at least size bytes, the pointer and
+  // the content are kept. Returns false if it can not, then the caller should
+  // allocate a new buffer instead.
+  virtual bool Extend(size_t size) { return size <= size_; }
+
  protected:
   friend void swap(Allocation& a, Allocation& b) noexcept;
   void* ptr_{nullptr};
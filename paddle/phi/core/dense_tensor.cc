@@ -140,7 +140,9 @@ void* DenseTensor::AllocateFrom(Allocator* allocator,
   // NOTE(paddle-dev): In case of the allocator of storage_ is different with
   // the incoming allocator, we will re-alloc data using the incoming
   // allocator. See DeviceContext.Alloc in core/device_context.cc.
-  if (!holder_ || holder_->size() < bytes + meta_.offset) {
+  // A growable holder is extended in place, which keeps the data.
+  if (!holder_ || (holder_->size() < bytes + meta_.offset &&
+                   !holder_->Extend(bytes + meta_.offset))) {
     meta_.offset = 0;
     VLOG(10) << "Allocate data with bytes: " << bytes;
     auto holder = allocator->Allocate(bytes);
@@ -287,6 +289,8 @@ DATA_MEMBER_FUNC_INSTANTIATION(float);
 DATA_MEMBER_FUNC_INSTANTIATION(double);
 DATA_MEMBER_FUNC_INSTANTIATION(::phi::dtype::complex<float>);
 DATA_MEMBER_FUNC_INSTANTIATION(::phi::dtype::complex<double>);
+DATA_MEMBER_FUNC_INSTANTIATION(::phi::dtype::float8_e4m3fn);
+DATA_MEMBER_FUNC_INSTANTIATION(::phi::dtype::float8_e5m2);
 
 #undef DATA_MEMBER_FUNC_INSTANTIATION
 
@@ -113,7 +113,8 @@ void* DenseTensor::mutable_data(const Place& place,
 
   /* some versions of paddle::variant don't have operator!= */
   if (holder_ == nullptr || !(holder_->place() == place) ||
-      holder_->size() < size + meta_.offset) {
+      (holder_->size() < size + meta_.offset &&
+       !holder_->Extend(size + meta_.offset))) {
     holder_.reset();
     holder_ = memory_utils::AllocShared(place, size);
     meta_.offset = 0;
@@ -216,6 +217,8 @@ LEGACY_DATA_MEMBER_FUNC_INSTANTIATION(float)
 LEGACY_DATA_MEMBER_FUNC_INSTANTIATION(double)
 LEGACY_DATA_MEMBER_FUNC_INSTANTIATION(::phi::dtype::complex<float>)
 LEGACY_DATA_MEMBER_FUNC_INSTANTIATION(::phi::dtype::complex<double>)
+LEGACY_DATA_MEMBER_FUNC_INSTANTIATION(::phi::dtype::float8_e4m3fn)
+LEGACY_DATA_MEMBER_FUNC_INSTANTIATION(::phi::dtype::float8_e5m2)
 
 #undef LEGACY_DATA_MEMBER_FUNC_INSTANTIATION
 
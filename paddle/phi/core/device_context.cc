@@ -433,6 +433,8 @@ DEVICE_CONTEXT_MEMBER_FUNC_INSTANTIATION(::phi::float16)
 DEVICE_CONTEXT_MEMBER_FUNC_INSTANTIATION(::phi::complex64)
 DEVICE_CONTEXT_MEMBER_FUNC_INSTANTIATION(::phi::complex128)
 DEVICE_CONTEXT_MEMBER_FUNC_INSTANTIATION(::phi::pstring)
+DEVICE_CONTEXT_MEMBER_FUNC_INSTANTIATION(::phi::float8_e4m3fn)
+DEVICE_CONTEXT_MEMBER_FUNC_INSTANTIATION(::phi::float8_e5m2)
 
 #undef DEVICE_CONTEXT_MEMBER_FUNC_INSTANTIATION
 
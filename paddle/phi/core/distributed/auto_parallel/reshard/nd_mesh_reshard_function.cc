@@ -14,6 +14,11 @@
 
 #include "paddle/phi/core/distributed/auto_parallel/reshard/nd_mesh_reshard_function.h"
 
+#include <algorithm>
+#include <map>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
 #include "glog/logging.h"
 #include "paddle/phi/common/int_array.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
@@ -25,21 +30,39 @@
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_utils.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/s_to_r_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/same_status_reshard_function.h"
+#include "paddle/phi/core/distributed/auto_parallel/utils.h"
 #include "paddle/phi/core/distributed/store/store_utils.h"
+#include "paddle/phi/kernels/all_gather_kernel.h"
+#include "paddle/phi/kernels/concat_kernel.h"
+#include "paddle/phi/kernels/split_kernel.h"
 
 namespace phi {
 namespace distributed {
 
 namespace {
-ProcessMesh GetSubProcessMesh(const ProcessMesh& mesh, int64_t axis) {
-  int64_t shape_of_axis = mesh.dim_size(axis);
-  std::vector<int64_t> shape = {shape_of_axis};
-  std::vector<std::string> dim_names = {mesh.dim_names()[axis]};
+// Return the 1-D process mesh of the processes whose coordinates differ from
+// the current rank only on the given mesh axes, ordered row-major over the
+// axes. For example, the process mesh is [[0, 1], [2, 3]] and the current rank
+// is 1, then the sub mesh on axis 0 is [1, 3], and on axes {0, 1} is
+// [0, 1, 2, 3].
+ProcessMesh GetSubProcessMesh(const ProcessMesh& mesh,
+                              const std::vector<int64_t>& axes) {
   std::vector<int64_t> coord = GetCurRankCoordInMesh(mesh);
+  int64_t sub_mesh_size = 1;
+  std::string dim_name;
+  for (auto axis : axes) {
+    sub_mesh_size *= mesh.dim_size(axis);
+    dim_name += dim_name.empty() ? mesh.dim_names()[axis]
+                                 : "_" + mesh.dim_names()[axis];
+  }
 
   std::vector<int64_t> process_ids;
-  for (int64_t i = 0; i < shape_of_axis; ++i) {
-    coord[axis] = i;
+  for (int64_t i = 0; i < sub_mesh_size; ++i) {
+    int64_t index = i;
+    for (int64_t j = static_cast<int64_t>(axes.size() - 1); j >= 0; --j) {
+      coord[axes[j]] = index % mesh.dim_size(axes[j]);
+      index /= mesh.dim_size(axes[j]);
+    }
     int64_t rank = coord.back();
     for (int64_t j = static_cast<int64_t>(coord.size() - 2); j >= 0; --j) {
       rank += coord[j] * mesh.dim_size(j + 1);
@@ -47,10 +70,14 @@ ProcessMesh GetSubProcessMesh(const ProcessMesh& mesh, int64_t axis) {
     process_ids.emplace_back(mesh.process_ids()[rank]);
   }
 
-  ProcessMesh out_mesh(shape, process_ids, dim_names);
+  ProcessMesh out_mesh({sub_mesh_size}, process_ids, {dim_name});
   return out_mesh;
 }
 
+ProcessMesh GetSubProcessMesh(const ProcessMesh& mesh, int64_t axis) {
+  return GetSubProcessMesh(mesh, std::vector<int64_t>{axis});
+}
+
 // Given the input two dist_attr, traversing from high-dimension axis to
 // low-dimension. Find and return the first different axis which is shard status
 // between these two. For example, the input two dims_mapping are [-1, 0, -1,
@@ -72,202 +99,341 @@ int64_t FindFirstDiffShardAxis(const TensorDistAttr& in_dist_attr,
   return axis;
 }
 
-}  // namespace
-
-bool SameNdMeshReshardFunction::IsSuitable(
-    const DistTensor& in, const TensorDistAttr& out_dist_attr) {
-  RESHARD_SHORTCUT_IF_FALSE(in.dist_attr().process_mesh() ==
-                            out_dist_attr.process_mesh());
-  RESHARD_SHORTCUT_IF_FALSE(out_dist_attr.process_mesh().ndim() > 1);
-
-  // check the input and output dims_mapping is not equal
-  RESHARD_SHORTCUT_IF_FALSE(in.dist_attr() != out_dist_attr);
-
-  return true;
-}
-
-void SameNdMeshReshardFunction::Eval(phi::DeviceContext* dev_ctx,
-                                     const DistTensor& in,
-                                     const TensorDistAttr& out_dist_attr,
-                                     DistTensor* out) {
-  VLOG(3) << "Call SameNdMeshReshardFunction Eval";
-  const auto& in_dist_attr = in.dist_attr();
+// One 1-D reshard of the nd mesh reshard. The local value is reshard from
+// in_one_dim_dist_attr to out_one_dim_dist_attr on the sub mesh, then the
+// dist attr of the result is reset to real_out_dist_attr.
+struct NdMeshReshardStep {
+  enum Type { kPToR, kSToR, kRToP, kPToS, kRToS, kFusedSToR };
+
+  Type type;
+  TensorDistAttr in_one_dim_dist_attr;
+  TensorDistAttr out_one_dim_dist_attr;
+  TensorDistAttr real_out_dist_attr;
+  // Only for kFusedSToR, which gathers all the shards of several mesh axes
+  // by one all_gather on sub_mesh. The (mesh axis size, tensor axis) pairs
+  // are ordered by mesh axis.
+  ProcessMesh sub_mesh;
+  std::vector<std::pair<int64_t, int64_t>> fused_axes;
+};
+
+using NdMeshReshardPlan = std::vector<NdMeshReshardStep>;
+
+// The steps only depend on the dist attrs, the global shape and the current
+// rank, so that they are planned once and replayed for every reshard between
+// the same dist attrs.
+NdMeshReshardPlan BuildNdMeshReshardPlan(const DDim& dims,
+                                         const TensorDistAttr& in_dist_attr,
+                                         const TensorDistAttr& out_dist_attr) {
   const auto& process_mesh = out_dist_attr.process_mesh();
-
+  const auto tensor_shape = common::vectorize(dims);
   int64_t first_diff_axis = FindFirstDiffShardAxis(in_dist_attr, out_dist_attr);
 
-  // Backup out_dist_attr to to avoid overwriting the out's dist attr
-  auto out_dist_attr_orig = out_dist_attr;
+  NdMeshReshardPlan plan;
+  TensorDistAttr cur_dist_attr(in_dist_attr);
 
-  SetValue(out, in.value());
-  SetDistProps(out, in.dims(), in_dist_attr);
-
-  // 1. change all the partial status to replicated status if needed
+  // 1. change all the partial status to replicated status if needed, the
+  // mesh axes with the same reduce type are reduced by one all_reduce
   if (in_dist_attr.is_partial()) {
-    // Copy in_dist_attr.partial_status to avoid overwriting the value of
-    // input when the output and input are the same value
-    const auto in_partial_status = in_dist_attr.partial_status();
-    const auto& out_partial_status = out_dist_attr_orig.partial_status();
-    for (const auto& kv : in_partial_status) {
+    const auto& out_partial_status = out_dist_attr.partial_status();
+    std::map<ReduceType, std::vector<int64_t>> reduce_axes;
+    for (const auto& kv : in_dist_attr.partial_status()) {
       if (out_partial_status.count(kv.first) != 0 ||
-          out_dist_attr_orig.is_shard(kv.first)) {
+          out_dist_attr.is_shard(kv.first)) {
         continue;
       }
-      VLOG(3) << "Step1: partial axis " << kv.first;
+      reduce_axes[kv.second].emplace_back(kv.first);
+    }
+    for (auto& kv : reduce_axes) {
+      std::sort(kv.second.begin(), kv.second.end());
+      VLOG(3) << "Step1: partial axes "
+              << auto_parallel::str_join(kv.second);
+      NdMeshReshardStep step;
+      step.type = NdMeshReshardStep::kPToR;
       // 1.1 Calculate the dist_attr after this transform
-      TensorDistAttr real_out_dist_attr(out->dist_attr());
-      real_out_dist_attr.clean_partial_dims({kv.first});
+      cur_dist_attr.clean_partial_dims(kv.second);
+      step.real_out_dist_attr = cur_dist_attr;
 
-      // 1.2 Calculate the process_mesh on specific axis
-      ProcessMesh sub_mesh = GetSubProcessMesh(process_mesh, kv.first);
+      // 1.2 Calculate the process_mesh on specific axes
+      ProcessMesh sub_mesh = GetSubProcessMesh(process_mesh, kv.second);
 
       // 1.3 Calculate the input one dim dist attr
-      TensorDistAttr in_one_dim_dist_attr(common::vectorize(in.dims()));
-      in_one_dim_dist_attr.set_process_mesh(sub_mesh);
-      in_one_dim_dist_attr.set_partial_status(std::vector<int64_t>{0},
-                                              kv.second);
+      step.in_one_dim_dist_attr = TensorDistAttr(tensor_shape);
+      step.in_one_dim_dist_attr.set_process_mesh(sub_mesh);
+      step.in_one_dim_dist_attr.set_partial_status(std::vector<int64_t>{0},
+                                                   kv.first);
 
       // 1.4 Calculate the output one dim dist attr
-      TensorDistAttr out_one_dim_dist_attr(common::vectorize(in.dims()));
-      out_one_dim_dist_attr.set_process_mesh(sub_mesh);
-
-      // 1.5 Change from partial to replicated
-      SetDistProps(out, in_one_dim_dist_attr);
-
-      DistTensor tmp_result;
-      PToRReshardFunction func;
-      func.Eval(dev_ctx, *out, out_one_dim_dist_attr, &tmp_result);
-
-      // 1.6 Reset to the right dist attr
-      SetValue(out, tmp_result.value());
-      SetDistProps(out, real_out_dist_attr);
+      step.out_one_dim_dist_attr = TensorDistAttr(tensor_shape);
+      step.out_one_dim_dist_attr.set_process_mesh(sub_mesh);
+      plan.emplace_back(std::move(step));
     }
   }
 
-  // 2. change all the shard status to replicated status
+  // 2. change all the shard status to replicated status, the evenly sharded
+  // axes are gathered by one all_gather
+  std::vector<std::pair<int64_t, int64_t>> shard_axes;
+  bool can_fuse = true;
   for (int64_t i = first_diff_axis; i >= 0; --i) {
-    int64_t in_mesh_axis = out->dist_attr().dims_mapping()[i];
+    int64_t in_mesh_axis = cur_dist_attr.dims_mapping()[i];
     if (in_mesh_axis != -1) {
+      shard_axes.emplace_back(in_mesh_axis, i);
+      can_fuse = can_fuse && tensor_shape[i] > 0 &&
+                 tensor_shape[i] % process_mesh.dim_size(in_mesh_axis) == 0;
+    }
+  }
+  if (shard_axes.size() > 1 && can_fuse) {
+    std::sort(shard_axes.begin(), shard_axes.end());
+    NdMeshReshardStep step;
+    step.type = NdMeshReshardStep::kFusedSToR;
+    std::vector<int64_t> mesh_axes;
+    std::vector<int64_t> real_dims_mapping = cur_dist_attr.dims_mapping();
+    for (const auto& axes : shard_axes) {
+      mesh_axes.emplace_back(axes.first);
+      real_dims_mapping[axes.second] = -1;
+      step.fused_axes.emplace_back(process_mesh.dim_size(axes.first),
+                                   axes.second);
+    }
+    VLOG(3) << "Step2: fused in_mesh axes "
+            << auto_parallel::str_join(mesh_axes);
+    cur_dist_attr.set_dims_mapping(real_dims_mapping);
+    step.real_out_dist_attr = cur_dist_attr;
+    step.sub_mesh = GetSubProcessMesh(process_mesh, mesh_axes);
+    plan.emplace_back(std::move(step));
+  } else {
+    for (const auto& axes : shard_axes) {
+      int64_t in_mesh_axis = axes.first;
+      int64_t i = axes.second;
       VLOG(3) << "Step2: in_mesh axis " << in_mesh_axis;
+      NdMeshReshardStep step;
+      step.type = NdMeshReshardStep::kSToR;
       // 2.1 Calculate the dist_attr after this transform
-      TensorDistAttr real_out_dist_attr(out->dist_attr());
-      std::vector<int64_t> real_dims_mapping =
-          real_out_dist_attr.dims_mapping();
+      std::vector<int64_t> real_dims_mapping = cur_dist_attr.dims_mapping();
       real_dims_mapping[i] = -1;
-      real_out_dist_attr.set_dims_mapping(real_dims_mapping);
+      cur_dist_attr.set_dims_mapping(real_dims_mapping);
+      step.real_out_dist_attr = cur_dist_attr;
 
       // 2.2 Calculate the process_mesh on specific axis
       ProcessMesh sub_mesh = GetSubProcessMesh(process_mesh, in_mesh_axis);
 
       // 2.3 Calculate the input one dim dist attr
-      TensorDistAttr in_one_dim_dist_attr(common::vectorize(in.dims()));
-      in_one_dim_dist_attr.set_process_mesh(sub_mesh);
+      step.in_one_dim_dist_attr = TensorDistAttr(tensor_shape);
+      step.in_one_dim_dist_attr.set_process_mesh(sub_mesh);
       std::vector<int64_t> in_one_dims_mapping =
-          in_one_dim_dist_attr.dims_mapping();
+          step.in_one_dim_dist_attr.dims_mapping();
       in_one_dims_mapping[i] = 0;
-      in_one_dim_dist_attr.set_dims_mapping(in_one_dims_mapping);
+      step.in_one_dim_dist_attr.set_dims_mapping(in_one_dims_mapping);
 
       // 2.4 Calculate the output one dim dist attr
-      TensorDistAttr out_one_dim_dist_attr(common::vectorize(in.dims()));
-      out_one_dim_dist_attr.set_process_mesh(sub_mesh);
-
-      // 2.5 Change from shard to replicated
-      SetDistProps(out, in_one_dim_dist_attr);
-      DistTensor tmp_result;
-      SToRReshardFunction func;
-      func.Eval(dev_ctx, *out, out_one_dim_dist_attr, &tmp_result);
-
-      // 2.6 Reset to the right dist attr
-      SetValue(out, tmp_result.value());
-      SetDistProps(out, real_out_dist_attr);
+      step.out_one_dim_dist_attr = TensorDistAttr(tensor_shape);
+      step.out_one_dim_dist_attr.set_process_mesh(sub_mesh);
+      plan.emplace_back(std::move(step));
     }
   }
 
   // 3. Change replicated to partial
-  if (out_dist_attr_orig.is_partial()) {
-    const auto& in_partial_status = out->dist_attr().partial_status();
-    const auto& out_partial_status = out_dist_attr_orig.partial_status();
-    for (const auto& kv : out_partial_status) {
+  if (out_dist_attr.is_partial()) {
+    const auto in_partial_status = cur_dist_attr.partial_status();
+    for (const auto& kv : out_dist_attr.partial_status()) {
       if (in_partial_status.count(kv.first) != 0) {
         continue;
       }
       VLOG(3) << "Step3: Partial status mesh axis " << kv.first;
+      NdMeshReshardStep step;
+      step.type = NdMeshReshardStep::kRToP;
       // 3.1 Calculate the dist_attr after this transform
-      TensorDistAttr real_out_dist_attr(out->dist_attr());
-      real_out_dist_attr.set_partial_status(std::vector<int64_t>{kv.first});
+      cur_dist_attr.set_partial_status(std::vector<int64_t>{kv.first});
+      step.real_out_dist_attr = cur_dist_attr;
 
       // 3.2 Calculate the process_mesh on specific axis
       ProcessMesh sub_mesh = GetSubProcessMesh(process_mesh, kv.first);
 
       // 3.3 Calculate the input one dim dist attr
-      TensorDistAttr in_one_dim_dist_attr(common::vectorize(in.dims()));
-      in_one_dim_dist_attr.set_process_mesh(sub_mesh);
+      step.in_one_dim_dist_attr = TensorDistAttr(tensor_shape);
+      step.in_one_dim_dist_attr.set_process_mesh(sub_mesh);
 
       // 3.4 Calculate the output one dim dist attr
-      TensorDistAttr out_one_dim_dist_attr(common::vectorize(in.dims()));
-      out_one_dim_dist_attr.set_process_mesh(sub_mesh);
-      out_one_dim_dist_attr.set_partial_status(std::vector<int64_t>{0});
-
-      // 3.5 Change from partial to replicated
-      DistTensor tmp_result;
-      SetDistProps(out, in_one_dim_dist_attr);
-      RToPReshardFunction func;
-      func.Eval(dev_ctx, *out, out_one_dim_dist_attr, &tmp_result);
-
-      // 3.6 Reset to the right dist attr
-      SetValue(out, tmp_result.value());
-      SetDistProps(out, real_out_dist_attr);
+      step.out_one_dim_dist_attr = TensorDistAttr(tensor_shape);
+      step.out_one_dim_dist_attr.set_process_mesh(sub_mesh);
+      step.out_one_dim_dist_attr.set_partial_status(std::vector<int64_t>{0});
+      plan.emplace_back(std::move(step));
     }
   }
 
   // 4. Change replicated/partial to shard
   for (int64_t i = first_diff_axis; i >= 0; --i) {
-    int64_t out_mesh_axis = out_dist_attr_orig.dims_mapping()[i];
+    int64_t out_mesh_axis = out_dist_attr.dims_mapping()[i];
     if (out_mesh_axis != -1) {
-      const auto& in_partial_status = out->dist_attr().partial_status();
-      bool is_partial = in_partial_status.count(out_mesh_axis) != 0;
+      bool is_partial = cur_dist_attr.is_partial(out_mesh_axis);
 
       VLOG(3) << "Step4: out_mesh axis : " << out_mesh_axis
               << "; paratial state :" << is_partial;
+      NdMeshReshardStep step;
+      step.type =
+          is_partial ? NdMeshReshardStep::kPToS : NdMeshReshardStep::kRToS;
       // 4.1 Calculate the dist_attr after this transform
-      TensorDistAttr real_out_dist_attr(out->dist_attr());
-      std::vector<int64_t> real_dims_mapping =
-          real_out_dist_attr.dims_mapping();
+      std::vector<int64_t> real_dims_mapping = cur_dist_attr.dims_mapping();
       real_dims_mapping[i] = out_mesh_axis;
-      real_out_dist_attr.set_dims_mapping(real_dims_mapping);
-      if (real_out_dist_attr.is_partial(out_mesh_axis)) {
-        real_out_dist_attr.clean_partial_dims({out_mesh_axis});
+      cur_dist_attr.set_dims_mapping(real_dims_mapping);
+      if (is_partial) {
+        cur_dist_attr.clean_partial_dims({out_mesh_axis});
       }
+      step.real_out_dist_attr = cur_dist_attr;
 
       // 4.2 Calculate the process_mesh on specific axis
       ProcessMesh sub_mesh = GetSubProcessMesh(process_mesh, out_mesh_axis);
 
       // 4.3 Calculate the input one dim dist attr
-      TensorDistAttr in_one_dim_dist_attr(common::vectorize(in.dims()));
-      in_one_dim_dist_attr.set_process_mesh(sub_mesh);
+      step.in_one_dim_dist_attr = TensorDistAttr(tensor_shape);
+      step.in_one_dim_dist_attr.set_process_mesh(sub_mesh);
 
       // 4.4 Calculate the output one dim dist attr
-      TensorDistAttr out_one_dim_dist_attr(common::vectorize(in.dims()));
-      out_one_dim_dist_attr.set_process_mesh(sub_mesh);
+      step.out_one_dim_dist_attr = TensorDistAttr(tensor_shape);
+      step.out_one_dim_dist_attr.set_process_mesh(sub_mesh);
       std::vector<int64_t> out_one_dims_mapping =
-          out_one_dim_dist_attr.dims_mapping();
+          step.out_one_dim_dist_attr.dims_mapping();
       out_one_dims_mapping[i] = 0;
-      out_one_dim_dist_attr.set_dims_mapping(out_one_dims_mapping);
+      step.out_one_dim_dist_attr.set_dims_mapping(out_one_dims_mapping);
+      plan.emplace_back(std::move(step));
+    }
+  }
+  return plan;
+}
 
-      // 4.5 Change from replicated to shard
-      DistTensor tmp_result;
-      SetDistProps(out, in_one_dim_dist_attr);
-      if (is_partial) {
+const NdMeshReshardPlan& GetOrBuildNdMeshReshardPlan(
+    const DDim& dims,
+    const TensorDistAttr& in_dist_attr,
+    const TensorDistAttr& out_dist_attr) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::unique_ptr<NdMeshReshardPlan>>
+      plans;
+  std::string key = in_dist_attr.to_string() + "->" +
+                    out_dist_attr.to_string() + ":" +
+                    auto_parallel::str_join(common::vectorize(dims));
+  std::lock_guard<std::mutex> guard(mutex);
+  auto& plan = plans[key];
+  if (plan == nullptr) {
+    plan = std::make_unique<NdMeshReshardPlan>(
+        BuildNdMeshReshardPlan(dims, in_dist_attr, out_dist_attr));
+  }
+  return *plan;
+}
+
+// All gather the local value on the sub mesh of several mesh axes. The
+// result of all_gather is concated on axis 0 in the row-major order of the
+// mesh axes, so that it is split to pieces, and the pieces of the last mesh
+// axis are concated on its tensor axis first.
+void FusedSToR(DeviceContext* dev_ctx,
+               const DenseTensor& in,
+               const NdMeshReshardStep& step,
+               DenseTensor* out) {
+  const auto& process_ids = step.sub_mesh.process_ids();
+  auto dtype = in.dtype();
+  int64_t num_of_process = static_cast<int64_t>(process_ids.size());
+
+  DenseTensor gathered;
+  RESHARD_FUNCTOR_WITH_COMM(dev_ctx,
+                            AllGather,
+                            dtype,
+                            process_ids,
+                            in,
+                            num_of_process,
+                            &gathered);
+
+  IntArray sections(std::vector<int64_t>(num_of_process, in.dims()[0]));
+  std::vector<DenseTensor> pieces;
+  RESHARD_FUNCTOR(dev_ctx, Split, dtype, gathered, sections, 0, &pieces);
+
+  for (auto iter = step.fused_axes.rbegin(); iter != step.fused_axes.rend();
+       ++iter) {
+    int64_t group_size = iter->first;
+    int64_t tensor_axis = iter->second;
+    std::vector<DenseTensor> concated(pieces.size() / group_size);
+    for (size_t group = 0; group < concated.size(); ++group) {
+      std::vector<const DenseTensor*> concat_input_vec;
+      for (int64_t j = 0; j < group_size; ++j) {
+        concat_input_vec.emplace_back(&pieces[group * group_size + j]);
+      }
+      RESHARD_FUNCTOR(dev_ctx,
+                      Concat,
+                      dtype,
+                      concat_input_vec,
+                      tensor_axis,
+                      &concated[group]);
+    }
+    pieces = std::move(concated);
+  }
+  *out = std::move(pieces[0]);
+}
+
+}  // namespace
+
+bool SameNdMeshReshardFunction::IsSuitable(
+    const DistTensor& in, const TensorDistAttr& out_dist_attr) {
+  RESHARD_SHORTCUT_IF_FALSE(in.dist_attr().process_mesh() ==
+                            out_dist_attr.process_mesh());
+  RESHARD_SHORTCUT_IF_FALSE(out_dist_attr.process_mesh().ndim() > 1);
+
+  // check the input and output dims_mapping is not equal
+  RESHARD_SHORTCUT_IF_FALSE(in.dist_attr() != out_dist_attr);
+
+  return true;
+}
+
+void SameNdMeshReshardFunction::Eval(phi::DeviceContext* dev_ctx,
+                                     const DistTensor& in,
+                                     const TensorDistAttr& out_dist_attr,
+                                     DistTensor* out) {
+  VLOG(3) << "Call SameNdMeshReshardFunction Eval";
+  const auto& in_dist_attr = in.dist_attr();
+  // The plan is got before the dist attr of out is overwritten below, which
+  // may be the input or output dist attr when they are the same value
+  const auto& plan =
+      GetOrBuildNdMeshReshardPlan(in.dims(), in_dist_attr, out_dist_attr);
+
+  SetValue(out, in.value());
+  SetDistProps(out, in.dims(), in_dist_attr);
+
+  for (const auto& step : plan) {
+    DistTensor tmp_result;
+    if (step.type == NdMeshReshardStep::kFusedSToR) {
+      DenseTensor gathered;
+      FusedSToR(dev_ctx, out->value(), step, &gathered);
+      SetValue(out, gathered);
+      SetDistProps(out, step.real_out_dist_attr);
+      continue;
+    }
+
+    SetDistProps(out, step.in_one_dim_dist_attr);
+    switch (step.type) {
+      case NdMeshReshardStep::kPToR: {
+        PToRReshardFunction func;
+        func.Eval(dev_ctx, *out, step.out_one_dim_dist_attr, &tmp_result);
+        break;
+      }
+      case NdMeshReshardStep::kSToR: {
+        SToRReshardFunction func;
+        func.Eval(dev_ctx, *out, step.out_one_dim_dist_attr, &tmp_result);
+        break;
+      }
+      case NdMeshReshardStep::kRToP: {
+        RToPReshardFunction func;
+        func.Eval(dev_ctx, *out, step.out_one_dim_dist_attr, &tmp_result);
+        break;
+      }
+      case NdMeshReshardStep::kPToS: {
         PToSReshardFunction func;
-        func.Eval(dev_ctx, *out, out_one_dim_dist_attr, &tmp_result);
-      } else {
+        func.Eval(dev_ctx, *out, step.out_one_dim_dist_attr, &tmp_result);
+        break;
+      }
+      default: {
         RToSReshardFunction func;
-        func.Eval(dev_ctx, *out, out_one_dim_dist_attr, &tmp_result);
+        func.Eval(dev_ctx, *out, step.out_one_dim_dist_attr, &tmp_result);
+        break;
       }
-      // 4.6 Reset to the right dist attr
-      SetValue(out, tmp_result.value());
-      SetDistProps(out, real_out_dist_attr);
     }
+    // Reset to the right dist attr
+    SetValue(out, tmp_result.value());
+    SetDistProps(out, step.real_out_dist_attr);
   }
 }
 
@@ -0,0 +1,541 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/core/distributed/auto_parallel/spmd_planner.h"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <set>
+#include <sstream>
+
+#include "glog/logging.h"
+#include "paddle/phi/core/distributed/auto_parallel/utils.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+namespace distributed {
+
+using auto_parallel::str_join;
+
+namespace {
+
+// 10 GB/s, 10 us and 10 TFLOPS if the device mesh has no capability
+constexpr double kDefaultBandwidth = 1e10;
+constexpr double kDefaultLatency = 10.0;
+constexpr double kDefaultFlops = 1e13;
+
+// The seeds of all the inputs are crossed if there are no more than it,
+// or each input is seeded alone with the other inputs replicated.
+constexpr size_t kMaxCrossedSeeds = 256;
+
+int64_t ShardedTensorAxis(const TensorDistAttr& dist_attr, int64_t mesh_dim) {
+  const auto& dims_mapping = dist_attr.dims_mapping();
+  for (size_t i = 0; i < dims_mapping.size(); ++i) {
+    if (dims_mapping[i] == mesh_dim) {
+      return static_cast<int64_t>(i);
+    }
+  }
+  return -1;
+}
+
+bool SamePlacement(const TensorDistAttr& lhs, const TensorDistAttr& rhs) {
+  return lhs.dims_mapping() == rhs.dims_mapping() &&
+         lhs.partial_status() == rhs.partial_status();
+}
+
+std::string PlacementString(const TensorDistAttr& dist_attr) {
+  std::string str = "[" + str_join(dist_attr.dims_mapping()) + "]";
+  if (dist_attr.is_partial()) {
+    str += " " + dist_attr.partial_status_string();
+  }
+  return str;
+}
+
+std::string PlacementsString(const std::vector<TensorDistAttr>& dist_attrs) {
+  std::vector<std::string> strs;
+  for (const auto& dist_attr : dist_attrs) {
+    strs.emplace_back(PlacementString(dist_attr));
+  }
+  return "(" + str_join(strs, ", ") + ")";
+}
+
+// All the dims mappings of shape on mesh, in which every mesh dim evenly
+// shards at most one tensor axis, and every tensor axis is sharded by at
+// most one mesh dim.
+void EnumerateDimsMappings(const std::vector<int64_t>& shape,
+                           const ProcessMesh& mesh,
+                           int64_t mesh_dim,
+                           std::vector<int64_t>* dims_mapping,
+                           std::vector<std::vector<int64_t>>* dims_mappings) {
+  if (mesh_dim == mesh.ndim()) {
+    dims_mappings->emplace_back(*dims_mapping);
+    return;
+  }
+  EnumerateDimsMappings(shape, mesh, mesh_dim + 1, dims_mapping, dims_mappings);
+  for (size_t i = 0; i < shape.size(); ++i) {
+    if ((*dims_mapping)[i] != -1 || shape[i] <= 0 ||
+        shape[i] % mesh.dim_size(mesh_dim) != 0) {
+      continue;
+    }
+    (*dims_mapping)[i] = mesh_dim;
+    EnumerateDimsMappings(
+        shape, mesh, mesh_dim + 1, dims_mapping, dims_mappings);
+    (*dims_mapping)[i] = -1;
+  }
+}
+
+}  // namespace
+
+SpmdCostModel::SpmdCostModel(const ProcessMesh& mesh,
+                             const std::vector<double>& bandwidths,
+                             const std::vector<double>& latencies,
+                             double flops)
+    : mesh_(mesh),
+      bandwidths_(bandwidths),
+      latencies_(latencies),
+      flops_(flops) {
+  PADDLE_ENFORCE_EQ(
+      bandwidths_.size() == static_cast<size_t>(mesh_.ndim()) &&
+          latencies_.size() == static_cast<size_t>(mesh_.ndim()),
+      true,
+      phi::errors::InvalidArgument(
+          "The bandwidths and latencies should be set for all the %d mesh "
+          "dims, but got %d and %d.",
+          mesh_.ndim(),
+          bandwidths_.size(),
+          latencies_.size()));
+  PADDLE_ENFORCE_GT(
+      flops_,
+      0,
+      phi::errors::InvalidArgument("The flops should be greater than 0."));
+}
+
+SpmdCostModel SpmdCostModel::FromDeviceMesh(
+    const ProcessMesh& mesh, const auto_parallel::DeviceMesh& device_mesh) {
+  std::vector<double> bandwidths(mesh.ndim(), kDefaultBandwidth);
+  std::vector<double> latencies(mesh.ndim(), kDefaultLatency);
+  double flops = kDefaultFlops;
+  if (mesh.empty()) {
+    return SpmdCostModel(mesh, bandwidths, latencies, flops);
+  }
+
+  int64_t first = mesh.process_ids()[0];
+  auto device_iter = device_mesh.devices().find(first);
+  if (device_iter != device_mesh.devices().end() &&
+      device_iter->second.capability().single_precision_flops > 0) {
+    flops = device_iter->second.capability().single_precision_flops;
+  }
+  int64_t stride = 1;
+  for (int64_t dim = mesh.ndim() - 1; dim >= 0; --dim) {
+    if (mesh.dim_size(dim) > 1) {
+      int64_t neighbour = mesh.process_ids()[stride];
+      auto links_iter = device_mesh.links().find(first);
+      if (links_iter != device_mesh.links().end()) {
+        auto link_iter = links_iter->second.find(neighbour);
+        if (link_iter != links_iter->second.end()) {
+          const auto& capability = link_iter->second.capability();
+          if (capability.bandwidth > 0) {
+            bandwidths[dim] = static_cast<double>(capability.bandwidth);
+          }
+          latencies[dim] = static_cast<double>(capability.latency);
+        }
+      }
+    }
+    stride *= mesh.dim_size(dim);
+  }
+  return SpmdCostModel(mesh, bandwidths, latencies, flops);
+}
+
+double SpmdCostModel::CollectiveCost(int64_t mesh_dim,
+                                     double bytes,
+                                     double steps) const {
+  return steps *
+         (latencies_[mesh_dim] + bytes / bandwidths_[mesh_dim] * 1e6) * scale_;
+}
+
+double SpmdCostModel::ReshardCost(const std::vector<int64_t>& shape,
+                                  int64_t elem_size,
+                                  const TensorDistAttr& src,
+                                  const TensorDistAttr& dst) const {
+  if (SamePlacement(src, dst)) {
+    return 0.0;
+  }
+  double bytes = static_cast<double>(elem_size);
+  for (auto dim : shape) {
+    bytes *= static_cast<double>(std::max<int64_t>(dim, 1));
+  }
+  for (int64_t dim = 0; dim < mesh_.ndim(); ++dim) {
+    if (ShardedTensorAxis(src, dim) != -1) {
+      bytes /= static_cast<double>(mesh_.dim_size(dim));
+    }
+  }
+
+  double cost = 0.0;
+  // 1. partial to replicated by all_reduce, or to shard by reduce_scatter
+  for (int64_t dim = 0; dim < mesh_.ndim(); ++dim) {
+    double n = static_cast<double>(mesh_.dim_size(dim));
+    if (n == 1 || !src.is_partial(dim) || dst.is_partial(dim)) {
+      continue;
+    }
+    if (ShardedTensorAxis(src, dim) == -1 &&
+        ShardedTensorAxis(dst, dim) != -1) {
+      cost += CollectiveCost(dim, bytes / n, n - 1);
+      bytes /= n;
+    } else {
+      cost += CollectiveCost(dim, bytes / n, 2 * (n - 1));
+    }
+  }
+  // 2. shard to replicated by all_gather, or to shard another tensor axis by
+  // all_to_all
+  for (int64_t dim = 0; dim < mesh_.ndim(); ++dim) {
+    double n = static_cast<double>(mesh_.dim_size(dim));
+    int64_t src_axis = ShardedTensorAxis(src, dim);
+    int64_t dst_axis = ShardedTensorAxis(dst, dim);
+    if (n == 1 || src_axis == -1 || src_axis == dst_axis) {
+      continue;
+    }
+    if (dst_axis != -1) {
+      cost += CollectiveCost(dim, bytes / n, n - 1);
+    } else {
+      cost += CollectiveCost(dim, bytes, n - 1);
+      bytes *= n;
+    }
+  }
+  // 3. replicated to shard or partial is local
+  return cost;
+}
+
+double SpmdCostModel::ComputeCost(
+    double flops, const std::vector<TensorDistAttr>& outputs) const {
+  double split = 1.0;
+  for (int64_t dim = 0; dim < mesh_.ndim(); ++dim) {
+    bool split_on_dim = std::any_of(
+        outputs.begin(), outputs.end(), [&](const TensorDistAttr& output) {
+          return ShardedTensorAxis(output, dim) != -1 ||
+                 output.is_partial(dim);
+        });
+    if (split_on_dim) {
+      split *= static_cast<double>(mesh_.dim_size(dim));
+    }
+  }
+  return flops / split / flops_ * 1e6 * scale_;
+}
+
+int64_t SpmdPlanner::AddNode(
+    const std::string& name,
+    const std::vector<Input>& inputs,
+    const std::vector<std::vector<int64_t>>& output_shapes,
+    double flops,
+    const InferFn& infer_fn,
+    int64_t elem_size) {
+  int64_t id = static_cast<int64_t>(nodes_.size());
+  for (const auto& input : inputs) {
+    PADDLE_ENFORCE_LT(
+        input.producer,
+        id,
+        phi::errors::InvalidArgument(
+            "The producer %d of node %s should be added before it.",
+            input.producer,
+            name));
+    if (input.producer >= 0) {
+      PADDLE_ENFORCE_LT(
+          input.output_index,
+          static_cast<int64_t>(nodes_[input.producer].output_shapes.size()),
+          phi::errors::InvalidArgument(
+              "The node %s has no output %d.",
+              nodes_[input.producer].name,
+              input.output_index));
+    }
+  }
+  Node node;
+  node.name = name;
+  node.inputs = inputs;
+  node.output_shapes = output_shapes;
+  node.flops = flops;
+  node.elem_size = elem_size;
+  EnumerateCandidates(&node, infer_fn);
+  VLOG(4) << "SpmdPlanner: node " << id << " " << name << " has "
+          << node.candidates.size() << " candidates";
+  nodes_.emplace_back(std::move(node));
+  return id;
+}
+
+void SpmdPlanner::EnumerateCandidates(Node* node, const InferFn& infer_fn) {
+  const auto& mesh = cost_model_.process_mesh();
+  std::vector<std::vector<TensorDistAttr>> seeds(node->inputs.size());
+  std::vector<TensorDistAttr> replicated;
+  size_t num_crossed = 1;
+  for (size_t i = 0; i < node->inputs.size(); ++i) {
+    const auto& shape = node->inputs[i].shape;
+    std::vector<int64_t> dims_mapping(shape.size(), -1);
+    std::vector<std::vector<int64_t>> dims_mappings;
+    EnumerateDimsMappings(shape, mesh, 0, &dims_mapping, &dims_mappings);
+    for (const auto& mapping : dims_mappings) {
+      TensorDistAttr seed(shape);
+      seed.set_process_mesh(mesh);
+      seed.set_dims_mapping(mapping);
+      seeds[i].emplace_back(seed);
+    }
+    // the first mapping has all tensor axes replicated
+    replicated.emplace_back(seeds[i][0]);
+    num_crossed *= seeds[i].size();
+  }
+
+  std::vector<std::vector<TensorDistAttr>> seed_inputs;
+  if (num_crossed <= kMaxCrossedSeeds) {
+    std::vector<size_t> index(seeds.size(), 0);
+    for (size_t k = 0; k < num_crossed; ++k) {
+      std::vector<TensorDistAttr> seed_input;
+      for (size_t i = 0; i < seeds.size(); ++i) {
+        seed_input.emplace_back(seeds[i][index[i]]);
+      }
+      seed_inputs.emplace_back(std::move(seed_input));
+      for (size_t i = 0; i < seeds.size(); ++i) {
+        if (++index[i] < seeds[i].size()) {
+          break;
+        }
+        index[i] = 0;
+      }
+    }
+  } else {
+    seed_inputs.emplace_back(replicated);
+    for (size_t i = 0; i < seeds.size(); ++i) {
+      for (size_t j = 1; j < seeds[i].size(); ++j) {
+        auto seed_input = replicated;
+        seed_input[i] = seeds[i][j];
+        seed_inputs.emplace_back(std::move(seed_input));
+      }
+    }
+  }
+
+  std::set<std::string> visited;
+  for (const auto& seed_input : seed_inputs) {
+    std::vector<DistMetaTensor> metas;
+    for (size_t i = 0; i < seed_input.size(); ++i) {
+      metas.emplace_back(common::make_ddim(node->inputs[i].shape),
+                         seed_input[i]);
+    }
+    SpmdInfo spmd_info;
+    try {
+      spmd_info = infer_fn(metas);
+    } catch (const std::exception& e) {
+      VLOG(6) << "SpmdPlanner: skip the seed " << PlacementsString(seed_input)
+              << " of " << node->name << ": " << e.what();
+      continue;
+    }
+
+    Candidate candidate;
+    bool is_tensor = true;
+    for (const auto& arg : spmd_info.first) {
+      is_tensor = is_tensor && paddle::holds_alternative<TensorDistAttr>(arg);
+      if (is_tensor) {
+        candidate.inputs.emplace_back(paddle::get<0>(arg));
+      }
+    }
+    for (const auto& arg : spmd_info.second) {
+      is_tensor = is_tensor && paddle::holds_alternative<TensorDistAttr>(arg);
+      if (is_tensor) {
+        candidate.outputs.emplace_back(paddle::get<0>(arg));
+      }
+    }
+    if (!is_tensor || candidate.inputs.size() != node->inputs.size() ||
+        candidate.outputs.size() != node->output_shapes.size()) {
+      continue;
+    }
+    std::string key = PlacementsString(candidate.inputs) + "->" +
+                      PlacementsString(candidate.outputs);
+    if (visited.insert(key).second) {
+      node->candidates.emplace_back(std::move(candidate));
+    }
+  }
+
+  if (node->candidates.empty()) {
+    // the op runs replicated if its rule infers none of the seeds
+    Candidate candidate;
+    candidate.inputs = replicated;
+    for (const auto& shape : node->output_shapes) {
+      TensorDistAttr output(shape);
+      output.set_process_mesh(mesh);
+      candidate.outputs.emplace_back(output);
+    }
+    node->candidates.emplace_back(std::move(candidate));
+  }
+}
+
+double SpmdPlanner::InputReshardCost(const Node& node,
+                                     size_t input_index,
+                                     const Candidate& candidate,
+                                     int64_t producer_candidate) const {
+  const auto& input = node.inputs[input_index];
+  const TensorDistAttr* src = &input.dist_attr;
+  if (input.producer >= 0) {
+    src = &nodes_[input.producer]
+               .candidates[producer_candidate]
+               .outputs[input.output_index];
+  } else if (src->process_mesh().empty()) {
+    // an input of the graph without dist attr is placed freely
+    return 0.0;
+  }
+  return cost_model_.ReshardCost(
+      input.shape, node.elem_size, *src, candidate.inputs[input_index]);
+}
+
+double SpmdPlanner::Plan() {
+  for (auto& node : nodes_) {
+    node.chosen = -1;
+    node.costs.assign(node.candidates.size(), 0.0);
+    for (size_t c = 0; c < node.candidates.size(); ++c) {
+      auto& candidate = node.candidates[c];
+      candidate.compute_cost =
+          cost_model_.ComputeCost(node.flops, candidate.outputs);
+      double cost = candidate.compute_cost;
+      for (size_t i = 0; i < node.inputs.size(); ++i) {
+        const auto& input = node.inputs[i];
+        if (input.producer < 0) {
+          cost += InputReshardCost(node, i, candidate, -1);
+          continue;
+        }
+        const auto& producer = nodes_[input.producer];
+        double best = std::numeric_limits<double>::max();
+        for (size_t p = 0; p < producer.candidates.size(); ++p) {
+          best = std::min(best,
+                          producer.costs[p] +
+                              InputReshardCost(node, i, candidate, p));
+        }
+        cost += best;
+      }
+      node.costs[c] = cost;
+    }
+  }
+
+  // A producer takes the candidate that is the cheapest for its consumer
+  // which is the last in the topological order.
+  for (auto node = nodes_.rbegin(); node != nodes_.rend(); ++node) {
+    if (node->chosen < 0) {
+      node->chosen = std::min_element(node->costs.begin(), node->costs.end()) -
+                     node->costs.begin();
+    }
+    const auto& candidate = node->candidates[node->chosen];
+    for (size_t i = 0; i < node->inputs.size(); ++i) {
+      const auto& input = node->inputs[i];
+      if (input.producer < 0 || nodes_[input.producer].chosen >= 0) {
+        continue;
+      }
+      auto& producer = nodes_[input.producer];
+      double best = std::numeric_limits<double>::max();
+      for (size_t p = 0; p < producer.candidates.size(); ++p) {
+        double cost =
+            producer.costs[p] + InputReshardCost(*node, i, candidate, p);
+        if (cost < best) {
+          best = cost;
+          producer.chosen = static_cast<int64_t>(p);
+        }
+      }
+    }
+  }
+
+  double total = 0.0;
+  for (auto& node : nodes_) {
+    node.predicted = PredictedCost(node);
+    total += node.predicted;
+  }
+  VLOG(3) << "SpmdPlanner: the predicted cost of " << nodes_.size()
+          << " nodes is " << total << " us";
+  return total;
+}
+
+double SpmdPlanner::PredictedCost(const Node& node) const {
+  const auto& candidate = node.candidates[node.chosen];
+  double cost = candidate.compute_cost;
+  for (size_t i = 0; i < node.inputs.size(); ++i) {
+    int64_t producer = node.inputs[i].producer;
+    cost += InputReshardCost(
+        node, i, candidate, producer < 0 ? -1 : nodes_[producer].chosen);
+  }
+  return cost;
+}
+
+const SpmdPlanner::Candidate& SpmdPlanner::Chosen(int64_t node) const {
+  const auto& planned = nodes_.at(node);
+  PADDLE_ENFORCE_GE(planned.chosen,
+                    0,
+                    phi::errors::PreconditionNotMet(
+                        "Call Plan before getting the chosen candidate."));
+  return planned.candidates[planned.chosen];
+}
+
+void SpmdPlanner::SetMeasuredTime(int64_t node, double time) {
+  nodes_.at(node).measured = time;
+  double measured = 0.0;
+  double predicted = 0.0;
+  for (const auto& planned : nodes_) {
+    if (planned.measured >= 0 && planned.chosen >= 0) {
+      measured += planned.measured;
+      predicted += planned.predicted;
+    }
+  }
+  if (measured <= 0 || predicted <= 0) {
+    return;
+  }
+  double ratio = measured / predicted;
+  cost_model_.set_scale(cost_model_.scale() * ratio);
+  for (auto& planned : nodes_) {
+    planned.predicted *= ratio;
+    for (size_t c = 0; c < planned.candidates.size(); ++c) {
+      planned.candidates[c].compute_cost *= ratio;
+      planned.costs[c] *= ratio;
+    }
+  }
+  VLOG(3) << "SpmdPlanner: calibrate the scale of the cost model to "
+          << cost_model_.scale();
+}
+
+std::string SpmdPlanner::Explain() const {
+  std::ostringstream os;
+  double predicted = 0.0;
+  double measured = 0.0;
+  bool has_measured = false;
+  for (size_t id = 0; id < nodes_.size(); ++id) {
+    const auto& node = nodes_[id];
+    os << "node " << id << " " << node.name << ": ";
+    if (node.chosen < 0) {
+      os << "not planned\n";
+      continue;
+    }
+    const auto& candidate = node.candidates[node.chosen];
+    os << PlacementsString(candidate.inputs) << " -> "
+       << PlacementsString(candidate.outputs) << ", "
+       << node.candidates.size() << " candidates, compute "
+       << candidate.compute_cost << " us, reshard "
+       << node.predicted - candidate.compute_cost << " us, predicted "
+       << node.predicted << " us";
+    predicted += node.predicted;
+    if (node.measured >= 0) {
+      os << ", measured " << node.measured << " us";
+      measured += node.measured;
+      has_measured = true;
+    }
+    os << "\n";
+  }
+  os << "total: predicted " << predicted << " us";
+  if (has_measured) {
+    os << ", measured " << measured << " us";
+  }
+  os << ", cost model scale " << cost_model_.scale() << "\n";
+  return os.str();
+}
+
+}  // namespace distributed
+}  // namespace phi
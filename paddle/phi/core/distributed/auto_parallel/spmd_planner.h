@@ -0,0 +1,166 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/core/distributed/auto_parallel/device_mesh.h"
+#include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
+#include "paddle/phi/core/distributed/auto_parallel/dist_meta_tensor.h"
+#include "paddle/phi/core/distributed/auto_parallel/process_mesh.h"
+#include "paddle/phi/core/distributed/type_defs.h"
+
+namespace phi {
+namespace distributed {
+
+// SpmdCostModel prices the reshard of a tensor between two dist attrs and the
+// compute of an op on the process mesh, in microseconds. Every mesh dim has
+// its own alpha-beta model of the ring collectives on it:
+//   all_reduce:      2 (n - 1) (latency + bytes / n / bandwidth)
+//   all_gather:      (n - 1) (latency + bytes / bandwidth), bytes is local
+//   reduce_scatter:  (n - 1) (latency + bytes / n / bandwidth)
+//   all_to_all:      (n - 1) (latency + bytes / n / bandwidth)
+// The compute of an op is its flops divided by the devices it is split on.
+// Both are multiplied by a scale calibrated by measured step times.
+class SpmdCostModel {
+ public:
+  // bandwidths in bytes/s and latencies in us of every mesh dim, flops of
+  // one device in flop/s
+  SpmdCostModel(const ProcessMesh& mesh,
+                const std::vector<double>& bandwidths,
+                const std::vector<double>& latencies,
+                double flops);
+
+  // Take the link between the first process and its neighbour on every mesh
+  // dim, and the flops of the first device, the process ids of mesh are the
+  // global device ids of device_mesh.
+  static SpmdCostModel FromDeviceMesh(
+      const ProcessMesh& mesh, const auto_parallel::DeviceMesh& device_mesh);
+
+  const ProcessMesh& process_mesh() const { return mesh_; }
+
+  double ReshardCost(const std::vector<int64_t>& shape,
+                     int64_t elem_size,
+                     const TensorDistAttr& src,
+                     const TensorDistAttr& dst) const;
+
+  // outputs are the out dist attrs of the op, the mesh dims sharding or
+  // partial on any of them split the compute
+  double ComputeCost(double flops,
+                     const std::vector<TensorDistAttr>& outputs) const;
+
+  double scale() const { return scale_; }
+  void set_scale(double scale) { scale_ = scale; }
+
+ private:
+  double CollectiveCost(int64_t mesh_dim, double bytes, double steps) const;
+
+  ProcessMesh mesh_;
+  std::vector<double> bandwidths_;
+  std::vector<double> latencies_;
+  double flops_;
+  double scale_{1.0};
+};
+
+// SpmdPlanner picks the dist attrs of the ops of a graph. The candidates of an
+// op are inferred by its spmd rule from the placements enumerated for its
+// inputs. The planner prices the compute of every candidate and the reshards
+// from the candidates of the producers, and picks the cheapest assignment by
+// dynamic programming in the topological order of the graph.
+//
+// The dynamic programming is exact when the graph is a tree. When an output
+// is used by several ops, the cost of its producer is counted for every
+// consumer, and the producer takes the candidate chosen for its last
+// consumer.
+class SpmdPlanner {
+ public:
+  using InferFn =
+      std::function<SpmdInfo(const std::vector<DistMetaTensor>& inputs)>;
+
+  // An input of a node is the output_index-th output of the producer node,
+  // or an input of the graph with dist_attr if producer is -1.
+  struct Input {
+    int64_t producer{-1};
+    int64_t output_index{0};
+    std::vector<int64_t> shape;
+    TensorDistAttr dist_attr;
+  };
+
+  struct Candidate {
+    std::vector<TensorDistAttr> inputs;
+    std::vector<TensorDistAttr> outputs;
+    double compute_cost{0.0};
+  };
+
+  explicit SpmdPlanner(const SpmdCostModel& cost_model)
+      : cost_model_(cost_model) {}
+
+  // The producers of inputs should be added before, flops is the compute of
+  // the op without any split. Return the id of the node.
+  int64_t AddNode(const std::string& name,
+                  const std::vector<Input>& inputs,
+                  const std::vector<std::vector<int64_t>>& output_shapes,
+                  double flops,
+                  const InferFn& infer_fn,
+                  int64_t elem_size = 4);
+
+  // Return the predicted cost in us of the chosen assignment.
+  double Plan();
+
+  const Candidate& Chosen(int64_t node) const;
+  const std::vector<Candidate>& Candidates(int64_t node) const {
+    return nodes_.at(node).candidates;
+  }
+
+  // Record the measured time in us of node, and calibrate the scale of the
+  // cost model by the measured and predicted time of all recorded nodes.
+  void SetMeasuredTime(int64_t node, double time);
+
+  // One line of the chosen dist attrs and the predicted and measured time of
+  // every node, and the total of them.
+  std::string Explain() const;
+
+ private:
+  struct Node {
+    std::string name;
+    std::vector<Input> inputs;
+    std::vector<std::vector<int64_t>> output_shapes;
+    double flops;
+    int64_t elem_size;
+    std::vector<Candidate> candidates;
+    std::vector<double> costs;
+    int64_t chosen{-1};
+    double predicted{0.0};
+    double measured{-1.0};
+  };
+
+  void EnumerateCandidates(Node* node, const InferFn& infer_fn);
+  // the reshard cost of the input of node when it uses candidate, and the
+  // producer uses producer_candidate
+  double InputReshardCost(const Node& node,
+                          size_t input_index,
+                          const Candidate& candidate,
+                          int64_t producer_candidate) const;
+  double PredictedCost(const Node& node) const;
+
+  SpmdCostModel cost_model_;
+  std::vector<Node> nodes_;
+};
+
+}  // namespace distributed
+}  // namespace phi
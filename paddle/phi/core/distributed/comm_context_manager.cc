@@ -56,6 +56,28 @@ void CommContextManager::SetDeviceId(int dev_id) {
 }
 
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+static void SetNCCLDevContext(int device_id,
+                              NCCLCommContext* nccl_comm_context) {
+  if (device_id == -1) {
+    return;
+  }
+  std::unique_ptr<phi::GPUContext> dev_ctx(
+      new phi::GPUContext(phi::GPUPlace(device_id)));
+  dev_ctx->SetAllocator(
+      phi::memory_utils::GetAllocator(device_id, dev_ctx->stream()));
+  dev_ctx->SetHostAllocator(phi::memory_utils::GetHostAllocator());
+  dev_ctx->SetZeroAllocator(phi::memory_utils::GetZeroAllocator(device_id));
+  dev_ctx->SetHostZeroAllocator(phi::memory_utils::GetHostZeroAllocator());
+  dev_ctx->SetPinnedAllocator(phi::memory_utils::GetPinnedAllocator());
+  dev_ctx->PartialInitWithAllocator();
+  auto compute_event = phi::memory_utils::GetCudaEvent(device_id);
+  auto comm_event = phi::memory_utils::GetCudaEvent(device_id);
+
+  nccl_comm_context->SetDevContext(std::move(dev_ctx));
+  nccl_comm_context->SetComputeEvent(std::move(compute_event));
+  nccl_comm_context->SetCommEvent(std::move(comm_event));
+}
+
 void CommContextManager::CreateNCCLCommContext(
     const std::shared_ptr<Store>& store,
     const std::string& unique_comm_key,
@@ -93,30 +115,54 @@ void CommContextManager::CreateNCCLCommContext(
           << ", nccl_id: " << SerializeNCCLUniqueId(nccl_id);
   auto nccl_comm_context =
       std::make_unique<NCCLCommContext>(rank, size, nccl_id);
-  if (CommContextManager::device_id != -1) {
-    std::unique_ptr<phi::GPUContext> dev_ctx(
-        new phi::GPUContext(phi::GPUPlace(CommContextManager::device_id)));
-    dev_ctx->SetAllocator(phi::memory_utils::GetAllocator(
-        CommContextManager::device_id, dev_ctx->stream()));
-    dev_ctx->SetHostAllocator(phi::memory_utils::GetHostAllocator());
-    dev_ctx->SetZeroAllocator(
-        phi::memory_utils::GetZeroAllocator(CommContextManager::device_id));
-    dev_ctx->SetHostZeroAllocator(phi::memory_utils::GetHostZeroAllocator());
-    dev_ctx->SetPinnedAllocator(phi::memory_utils::GetPinnedAllocator());
-    dev_ctx->PartialInitWithAllocator();
-    auto compute_event =
-        phi::memory_utils::GetCudaEvent(CommContextManager::device_id);
-    auto comm_event =
-        phi::memory_utils::GetCudaEvent(CommContextManager::device_id);
-
-    nccl_comm_context->SetDevContext(std::move(dev_ctx));
-    nccl_comm_context->SetComputeEvent(std::move(compute_event));
-    nccl_comm_context->SetCommEvent(std::move(comm_event));
-  }
+  SetNCCLDevContext(CommContextManager::device_id, nccl_comm_context.get());
 
   comm_context_manager.SetStore(store);
   comm_context_manager.Emplace(unique_comm_key, std::move(nccl_comm_context));
 }
+
+void CommContextManager::SplitNCCLCommContext(
+    const std::string& parent_comm_key,
+    const std::string& unique_comm_key,
+    int rank,
+    int size) {
+#if defined(PADDLE_WITH_NCCL) && NCCL_VERSION_CODE >= 21800
+  auto& comm_context_manager = CommContextManager::GetInstance();
+  PADDLE_ENFORCE_EQ(
+      comm_context_manager.Has(parent_comm_key),
+      true,
+      phi::errors::NotFound("The parent communicator %s to split is not "
+                            "created.",
+                            parent_comm_key));
+  auto* parent = static_cast<NCCLCommContext*>(
+      comm_context_manager.Get(parent_comm_key));
+  // the new communicator shares the resources of the parent, so that an idle
+  // one costs little memory
+  ncclConfig_t config = NCCL_CONFIG_INITIALIZER;
+  config.splitShare = 1;
+  ncclComm_t nccl_comm = nullptr;
+  const int color = rank >= 0 ? 0 : NCCL_SPLIT_NOCOLOR;
+  NCCL_CHECK(phi::dynload::ncclCommSplit(
+      parent->GetNcclComm(), color, rank, &nccl_comm, &config));
+  if (rank < 0) {
+    return;
+  }
+  if (comm_context_manager.Has(unique_comm_key)) {
+    NCCL_CHECK(phi::dynload::ncclCommDestroy(nccl_comm));
+    return;
+  }
+  VLOG(3) << "split NCCLCommContext rank: " << rank << ", size: " << size
+          << ", unique_comm_key: " << unique_comm_key
+          << " from: " << parent_comm_key;
+  auto nccl_comm_context =
+      std::make_unique<NCCLCommContext>(rank, size, nccl_comm);
+  SetNCCLDevContext(CommContextManager::device_id, nccl_comm_context.get());
+  comm_context_manager.Emplace(unique_comm_key, std::move(nccl_comm_context));
+#else
+  PADDLE_THROW(phi::errors::Unavailable(
+      "ncclCommSplit needs NCCL 2.18 or later, and is not supported by RCCL."));
+#endif
+}
 #endif
 
 #if defined(PADDLE_WITH_GLOO)
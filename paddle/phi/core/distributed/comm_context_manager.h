@@ -78,6 +78,15 @@ class CommContextManager {
                                     int size,
                                     const std::string& hash_key = "",
                                     const P2POption* opt = nullptr);
+
+  // Creates the communicator of unique_comm_key by ncclCommSplit from the one
+  // of parent_comm_key, without a rendezvous through the store. All the ranks
+  // of the parent call it together, the ranks not in the new communicator
+  // with rank -1. It needs NCCL 2.18 or later.
+  static void SplitNCCLCommContext(const std::string& parent_comm_key,
+                                   const std::string& unique_comm_key,
+                                   int rank,
+                                   int size);
 #endif
 
 #if defined(PADDLE_WITH_GLOO)
@@ -33,6 +33,18 @@ namespace phi {
 namespace distributed {
 
 class Store;
+
+// The name of the host trace event of a communication, which tags it with
+// its group and its sequence id in the group, so that the traces of the
+// ranks are matched by the communications when they are merged.
+inline std::string CommTraceName(const std::string& backend,
+                                 const std::string& group_key,
+                                 CommType comm_type,
+                                 uint64_t seq) {
+  return backend + "::" + CommTypeToString(comm_type) +
+         "#group_key:" + group_key + ",seq:" + std::to_string(seq);
+}
+
 class CommTask {
  public:
   CommTask(const std::string& backend = "",
@@ -71,6 +83,10 @@ class CommTask {
            ",gid:" + std::to_string(gid_) + ",seq:" + std::to_string(seq_);
   }
 
+  std::string TraceName() {
+    return CommTraceName(backend_, group_key_, comm_type_, seq_);
+  }
+
   std::string GroupKey() { return group_key_; }
   std::string GetBackend() { return backend_; }
   phi::Place GetPlace() { return place_; }
@@ -79,6 +95,8 @@ class CommTask {
   int GetSize() { return size_; }
   int GetGid() { return gid_; }
   int64_t GetNumel() { return numel_; }
+  int64_t GetBytes() { return bytes_; }
+  void SetBytes(int64_t bytes) { bytes_ = bytes; }
   uint64_t GetSeq() { return seq_; }
   CommType GetCommType() { return comm_type_; }
   bool GetTraceUpdated() { return start_trace_updated_; }
@@ -149,6 +167,13 @@ class CommTask {
         phi::errors::Unimplemented("%s is not implemented.", __func__));
     return;
   }
+  // The milliseconds the completed task ran on the device, negative if it is
+  // not timed.
+  virtual float GetElapsedMillis() {
+    PADDLE_THROW(
+        phi::errors::Unimplemented("%s is not implemented.", __func__));
+    return -1.0f;
+  }
 
  protected:
   std::string backend_;
@@ -160,6 +185,7 @@ class CommTask {
   int gid_;
   uint64_t seq_{0};
   int64_t numel_;
+  int64_t bytes_{0};
   ncclComm_t nccl_comm_;
   gpuStream_t nccl_stream_;
   CommType comm_type_;
@@ -22,8 +22,10 @@
 
 #include "paddle/phi/core/distributed/comm_context_manager.h"
 
+#include <algorithm>
 #include <future>
 #include <memory>
+#include <sstream>
 #include <string>
 
 #include "gflags/gflags.h"
@@ -31,12 +33,17 @@
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/core/distributed/store/store.h"
 #include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/flags.h"
 
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
 #include "paddle/phi/core/distributed/comm_task_manager.h"
 #include "paddle/phi/core/distributed/nccl_comm_context.h"
 #endif
 
+PHI_DECLARE_int32(comm_stats_interval);
+PHI_DECLARE_double(comm_straggler_ratio);
+PHI_DECLARE_int32(comm_straggler_patience);
+
 namespace phi {
 namespace distributed {
 
@@ -61,6 +68,57 @@ std::unordered_map<std::string, std::shared_ptr<CommTask>>
     CommTaskManager::group_last_comm_task_;
 std::chrono::time_point<std::chrono::steady_clock>
     CommTaskManager::last_update_time_ = std::chrono::steady_clock::now();
+const size_t CommTaskManager::kMaxCommRecords = 1024;
+
+namespace {
+
+// The factor of the bus bandwidth to bytes / time, as the nccl-tests compute
+// it, so that the collectives of the different sizes are comparable. The
+// bytes of the allgather are of the input of a rank.
+double BusBandwidthFactor(CommType comm_type, int size) {
+  if (size <= 1) {
+    return 1.0;
+  }
+  switch (comm_type) {
+    case CommType::ALLREDUCE:
+      return 2.0 * (size - 1) / size;
+    case CommType::ALLGATHER:
+      return static_cast<double>(size - 1);
+    case CommType::REDUCE_SCATTER:
+    case CommType::ALLTOALL:
+      return static_cast<double>(size - 1) / size;
+    default:
+      return 1.0;
+  }
+}
+
+// Counts the consecutive intervals every key is below the ratio of the median
+// bandwidth, and returns the keys slow for the patience intervals.
+template <typename Key>
+std::vector<Key> UpdateSlowCounts(const std::map<Key, double>& busbws,
+                                  std::map<Key, int>* slow_counts) {
+  std::vector<Key> slow_keys;
+  if (busbws.size() < 2) {
+    return slow_keys;
+  }
+  std::vector<double> values;
+  for (auto& iter : busbws) {
+    values.push_back(iter.second);
+  }
+  std::nth_element(
+      values.begin(), values.begin() + values.size() / 2, values.end());
+  const double median = values[values.size() / 2];
+  for (auto& iter : busbws) {
+    int& count = (*slow_counts)[iter.first];
+    count = iter.second < FLAGS_comm_straggler_ratio * median ? count + 1 : 0;
+    if (count >= FLAGS_comm_straggler_patience) {
+      slow_keys.push_back(iter.first);
+    }
+  }
+  return slow_keys;
+}
+
+}  // namespace
 
 CommTaskManager::CommTaskManager() {
   terminated_.store(false);
@@ -182,6 +240,7 @@ void CommTaskManager::CommTaskLoop() {
       } else {
         if (task->IsStarted()) {
           if (task->IsCompleted()) {
+            RecordCommStats(task);
             CommTaskClearEnqueue(task);
             iter = comm_task_list_.erase(iter);
           } else {
@@ -226,6 +285,14 @@ void CommTaskManager::CommTaskLoop() {
     } else {
       done = false;
     }
+
+    if (FLAGS_comm_stats_interval > 0 && !terminated_.load() &&
+        std::chrono::steady_clock::now() - last_exchange_time_ >=
+            std::chrono::seconds(FLAGS_comm_stats_interval)) {
+      // the enqueue of the tasks is not blocked by the store
+      lock.unlock();
+      ExchangeCommStats();
+    }
   }
 }
 
@@ -276,5 +343,164 @@ bool CommTaskManager::IsTimeout() {
   return std::chrono::duration_cast<std::chrono::milliseconds>(
              current_timepoint - last_update_time_) >= timeout_;
 }
+
+void CommTaskManager::RecordCommStats(std::shared_ptr<CommTask> task) {
+  if (FLAGS_comm_stats_interval <= 0) {
+    return;
+  }
+  // the events of the tasks created before the flag is set are not timed
+  const float elapsed_ms = task->GetElapsedMillis();
+  if (elapsed_ms <= 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(comm_stats_mutex_);
+  if (!comm_stats_store_) {
+    comm_stats_store_ = task->GetStore();
+  }
+  GroupCommStat& stat = group_comm_stats_[task->GroupKey()];
+  stat.global_rank = task->GetGlobalRank();
+  stat.rank = task->GetRank();
+  stat.size = task->GetSize();
+  stat.is_p2p = stat.is_p2p || IsP2POP(task->GetCommType());
+  stat.count += 1;
+  stat.bytes += task->GetBytes();
+  stat.time_ms += elapsed_ms;
+  stat.interval_bus_bytes +=
+      task->GetBytes() * BusBandwidthFactor(task->GetCommType(), stat.size);
+  stat.interval_time_ms += elapsed_ms;
+
+  const int64_t enqueue_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          task->GetStartTime().time_since_epoch())
+          .count();
+  comm_records_.push_back({task->GroupKey(),
+                           task->GetCommType(),
+                           task->GetBytes(),
+                           enqueue_ms,
+                           elapsed_ms});
+  if (comm_records_.size() > kMaxCommRecords) {
+    comm_records_.pop_front();
+  }
+}
+
+void CommTaskManager::ExchangeCommStats() {
+  std::lock_guard<std::mutex> lock(comm_stats_mutex_);
+  last_exchange_time_ = std::chrono::steady_clock::now();
+  if (!comm_stats_store_) {
+    return;
+  }
+  const int patience = FLAGS_comm_straggler_patience;
+  // the p2p group_key of this rank -> the bus bandwidth of the link
+  std::map<std::string, double> link_busbws;
+  for (auto& iter : group_comm_stats_) {
+    const std::string& group_key = iter.first;
+    GroupCommStat& stat = iter.second;
+    if (stat.interval_time_ms <= 0) {
+      continue;
+    }
+    // bytes / ms / 1e6 is GB/s
+    stat.busbw = stat.interval_bus_bytes / stat.interval_time_ms / 1e6;
+    stat.interval_bus_bytes = 0.0;
+    stat.interval_time_ms = 0.0;
+    if (stat.is_p2p) {
+      link_busbws[group_key] = stat.busbw;
+      continue;
+    }
+
+    const std::string prefix = "comm_stats/" + group_key + "/";
+    const std::string value =
+        std::to_string(stat.global_rank) + " " + std::to_string(stat.busbw);
+    comm_stats_store_->set(prefix + std::to_string(stat.rank),
+                           std::vector<uint8_t>(value.begin(), value.end()));
+    // a peer not published in this interval yet is of its last one, which
+    // only delays the counts of the consistent slowness by an interval
+    stat.peer_busbws.clear();
+    for (int rank = 0; rank < stat.size; ++rank) {
+      const std::string key = prefix + std::to_string(rank);
+      if (!comm_stats_store_->check(key)) {
+        continue;
+      }
+      const std::vector<uint8_t> data = comm_stats_store_->get(key);
+      std::istringstream is(std::string(data.begin(), data.end()));
+      int global_rank = 0;
+      double busbw = 0.0;
+      if (is >> global_rank >> busbw) {
+        stat.peer_busbws[global_rank] = busbw;
+      }
+    }
+    stat.slow_ranks = UpdateSlowCounts(stat.peer_busbws, &stat.slow_counts);
+    for (int global_rank : stat.slow_ranks) {
+      // warned once by the first rank of the group as it is found
+      if (stat.rank == 0 && stat.slow_counts[global_rank] == patience) {
+        LOG(WARNING) << "Find slow rank " << global_rank << " in group "
+                     << group_key << ", its bus bandwidth "
+                     << stat.peer_busbws[global_rank] << " GB/s is below "
+                     << FLAGS_comm_straggler_ratio
+                     << " of the median of the group for " << patience
+                     << " intervals.";
+      }
+    }
+  }
+
+  // the links of this rank are compared to each other, so that a slow nic or
+  // cable stands out of the links of the same kind
+  const std::vector<std::string> slow_links =
+      UpdateSlowCounts(link_busbws, &link_slow_counts_);
+  for (auto& iter : link_busbws) {
+    group_comm_stats_[iter.first].slow_link = false;
+  }
+  for (const std::string& group_key : slow_links) {
+    group_comm_stats_[group_key].slow_link = true;
+    if (link_slow_counts_[group_key] == patience) {
+      LOG(WARNING) << "Find slow link " << group_key << " of rank "
+                   << group_comm_stats_[group_key].global_rank
+                   << ", its bus bandwidth " << link_busbws[group_key]
+                   << " GB/s is below " << FLAGS_comm_straggler_ratio
+                   << " of the median of the links for " << patience
+                   << " intervals.";
+    }
+  }
+}
+
+std::string CommTaskManager::GetCommStats() {
+  std::lock_guard<std::mutex> lock(comm_stats_mutex_);
+  std::ostringstream os;
+  os << "{\"groups\":{";
+  bool first = true;
+  for (auto& iter : group_comm_stats_) {
+    const GroupCommStat& stat = iter.second;
+    os << (first ? "" : ",") << "\"" << iter.first << "\":{"
+       << "\"global_rank\":" << stat.global_rank << ",\"rank\":" << stat.rank
+       << ",\"size\":" << stat.size
+       << ",\"p2p\":" << (stat.is_p2p ? "true" : "false")
+       << ",\"count\":" << stat.count << ",\"bytes\":" << stat.bytes
+       << ",\"time_ms\":" << stat.time_ms
+       << ",\"busbw_gbps\":" << stat.busbw << ",\"peer_busbw_gbps\":{";
+    bool first_peer = true;
+    for (auto& peer : stat.peer_busbws) {
+      os << (first_peer ? "" : ",") << "\"" << peer.first
+         << "\":" << peer.second;
+      first_peer = false;
+    }
+    os << "},\"slow_ranks\":[";
+    for (size_t i = 0; i < stat.slow_ranks.size(); ++i) {
+      os << (i == 0 ? "" : ",") << stat.slow_ranks[i];
+    }
+    os << "],\"slow_link\":" << (stat.slow_link ? "true" : "false") << "}";
+    first = false;
+  }
+  os << "},\"records\":[";
+  first = true;
+  for (const CommRecord& record : comm_records_) {
+    os << (first ? "" : ",") << "{\"group_key\":\"" << record.group_key
+       << "\",\"op\":\"" << CommTypeToString(record.comm_type)
+       << "\",\"bytes\":" << record.bytes
+       << ",\"enqueue_ms\":" << record.enqueue_ms
+       << ",\"elapsed_ms\":" << record.elapsed_ms << "}";
+    first = false;
+  }
+  os << "]}";
+  return os.str();
+}
 }  // namespace distributed
 }  // namespace phi
@@ -16,12 +16,15 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <iostream>
 #include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "paddle/common/macros.h"
 #include "paddle/phi/core/distributed/comm_context.h"
@@ -51,10 +54,49 @@ class CommTaskManager {
   void UpdateLastCommTask(std::shared_ptr<CommTask> comm_task);
   void SetTimeout(int64_t timeout);
 
+  // The bus bandwidth stats of the groups and the recent communications in
+  // json, with the ranks and the links found slow.
+  std::string GetCommStats();
+
  private:
+  // A communication completed on the device.
+  struct CommRecord {
+    std::string group_key;
+    CommType comm_type;
+    int64_t bytes;
+    // the steady clock milliseconds it was enqueued
+    int64_t enqueue_ms;
+    float elapsed_ms;
+  };
+
+  struct GroupCommStat {
+    int global_rank{0};
+    int rank{0};
+    int size{0};
+    bool is_p2p{false};
+    int64_t count{0};
+    int64_t bytes{0};
+    double time_ms{0.0};
+    // the bus bytes and the device time since the last exchange
+    double interval_bus_bytes{0.0};
+    double interval_time_ms{0.0};
+    // the bus bandwidth in GB/s of this rank in the last interval
+    double busbw{0.0};
+    // the global ranks of the group -> their bus bandwidth in the last
+    // interval, and the consecutive intervals they are slow
+    std::map<int, double> peer_busbws;
+    std::map<int, int> slow_counts;
+    std::vector<int> slow_ranks;
+    bool slow_link{false};
+  };
+
   void CommTaskLoop();
   void CommTaskClearLoop();
   bool IsTimeout();
+  void RecordCommStats(std::shared_ptr<CommTask> task);
+  // Publishes the bus bandwidth of this rank to the store, and compares the
+  // ranks of the groups and the p2p links of this rank with their medians.
+  void ExchangeCommStats();
 
   static std::thread comm_task_loop_thread_;
   static std::thread comm_task_clear_loop_thread_;
@@ -83,6 +125,17 @@ class CommTaskManager {
   static std::chrono::time_point<std::chrono::steady_clock> last_update_time_;
   std::chrono::milliseconds timeout_;
   bool logged_ = false;
+
+  static const size_t kMaxCommRecords;
+  std::mutex comm_stats_mutex_;
+  std::deque<CommRecord> comm_records_;
+  // group_key -> stat
+  std::map<std::string, GroupCommStat> group_comm_stats_;
+  // the p2p group_key -> the consecutive intervals the link is slow
+  std::map<std::string, int> link_slow_counts_;
+  std::shared_ptr<Store> comm_stats_store_;
+  std::chrono::time_point<std::chrono::steady_clock> last_exchange_time_ =
+      std::chrono::steady_clock::now();
 };
 
 }  // namespace distributed
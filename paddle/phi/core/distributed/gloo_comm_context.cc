@@ -21,17 +21,36 @@
 #include <gloo/broadcast.h>
 #include <gloo/gather.h>
 #include <gloo/reduce.h>
+#include <gloo/rendezvous/prefix_store.h>
 #include <gloo/scatter.h>
 #include <gloo/types.h>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
+#include <unordered_set>
+
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/distributed/check/static_check.h"
 #include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_bool(gloo_performance_mode);
+PHI_DECLARE_int64(gloo_shm_buffer_size);
 
 namespace phi {
 namespace distributed {
 
+namespace {
+constexpr char kPerformanceModePrefix[] = "performance_mode";
+}  // namespace
+
 GlooCommContext::GlooCommContext(
     int rank,
     int size,
@@ -40,6 +59,75 @@ GlooCommContext::GlooCommContext(
     : CommContext(rank, size) {
   gloo_context_ = std::make_shared<gloo::rendezvous::Context>(rank, size);
   gloo_context_->connectFullMesh(*store, device);
+#ifndef _WIN32
+  if (FLAGS_gloo_performance_mode && size > 1) {
+    InitPerformanceMode(store, device);
+  }
+#endif
+}
+
+void GlooCommContext::InitPerformanceMode(
+    const std::shared_ptr<gloo::rendezvous::Store>& store,
+    std::shared_ptr<gloo::transport::Device> device) {
+#ifndef _WIN32
+  const std::string prefix(kPerformanceModePrefix);
+  std::array<char, HOST_NAME_MAX> hostname{};
+  PADDLE_ENFORCE_EQ(
+      ::gethostname(hostname.data(), HOST_NAME_MAX),
+      0,
+      phi::errors::Fatal("Get hostname error for the performance mode."));
+  const std::string host(hostname.data());
+  store->set(prefix + "/host/" + std::to_string(rank_),
+             std::vector<char>(host.begin(), host.end()));
+
+  std::vector<std::string> host_keys;
+  for (int i = 0; i < size_; ++i) {
+    host_keys.push_back(prefix + "/host/" + std::to_string(i));
+  }
+  store->wait(host_keys, gloo_context_->getTimeout());
+  // the ranks on this host, and the first rank of every host as its leader
+  std::vector<int> local_ranks;
+  std::vector<int> leaders;
+  std::unordered_set<std::string> seen_hosts;
+  for (int i = 0; i < size_; ++i) {
+    auto value = store->get(host_keys[i]);
+    const std::string peer_host(value.begin(), value.end());
+    if (seen_hosts.insert(peer_host).second) {
+      leaders.push_back(i);
+    }
+    if (peer_host == host) {
+      local_ranks.push_back(i);
+    }
+  }
+  num_hosts_ = static_cast<int>(leaders.size());
+  if (num_hosts_ == size_) {
+    VLOG(3) << "No host has more than one rank, the performance mode of "
+               "gloo is off.";
+    return;
+  }
+
+  const int local_rank = static_cast<int>(
+      std::find(local_ranks.begin(), local_ranks.end(), rank_) -
+      local_ranks.begin());
+  shm_comm_ = std::make_unique<GlooShmComm>(
+      store,
+      prefix + "/shm/" + std::to_string(local_ranks[0]),
+      local_rank,
+      static_cast<int>(local_ranks.size()),
+      static_cast<size_t>(FLAGS_gloo_shm_buffer_size),
+      gloo_context_->getTimeout());
+  if (num_hosts_ > 1 && local_rank == 0) {
+    const int leader_rank = static_cast<int>(
+        std::find(leaders.begin(), leaders.end(), rank_) - leaders.begin());
+    gloo::rendezvous::PrefixStore leader_store(prefix + "/leaders", *store);
+    leader_context_ =
+        std::make_shared<gloo::rendezvous::Context>(leader_rank, num_hosts_);
+    leader_context_->connectFullMesh(leader_store, device);
+  }
+  VLOG(3) << "The performance mode of gloo is on, rank " << rank_
+          << " is local rank " << local_rank << " of " << local_ranks.size()
+          << " on host " << host << ", hosts: " << num_hosts_;
+#endif
 }
 
 void GlooCommContext::Broadcast(phi::DenseTensor* out_tensor,
@@ -77,17 +165,98 @@ void GlooCommContext::AllGather(phi::DenseTensor* out_tensor,
   gloo::allgather(opts);
 }
 
+template <typename T>
+void GlooCommContext::AllReduceImpl(
+    void* out, const void* in, size_t count, int reduce_type, uint32_t tag) {
+  if (shm_comm_) {
+    GlooShmComm::CrossHostFunc cross_host;
+    if (num_hosts_ > 1) {
+      // only called on the leaders
+      cross_host = [this, reduce_type, tag](void* data, size_t n) {
+        gloo::AllreduceOptions opts(leader_context_);
+        opts.setTag(tag);
+        opts.setOutput(static_cast<T*>(data), n);
+        SetReduceFunc<T>(&opts, reduce_type);
+        gloo::allreduce(opts);
+      };
+    }
+    shm_comm_->AllReduce(
+        out, in, count, sizeof(T), GetReduceFunc<T>(reduce_type), cross_host);
+    return;
+  }
+  gloo::AllreduceOptions opts(gloo_context_);
+  opts.setTag(tag);
+  if (in != out) {
+    // gloo only support mutable data input
+    opts.setInput(static_cast<T*>(const_cast<void*>(in)), count);
+  }
+  opts.setOutput(static_cast<T*>(out), count);
+  SetReduceFunc<T>(&opts, reduce_type);
+  gloo::allreduce(opts);
+}
+
 void GlooCommContext::AllReduce(phi::DenseTensor* out_tensor,
                                 const phi::DenseTensor& in_tensor,
                                 int reduce_type,
                                 uint32_t tag) {
-  gloo::AllreduceOptions opts(gloo_context_);
-  opts.setTag(tag);
   const auto& dtype = in_tensor.dtype();
-  GENERATE_FUNC(dtype, SetInput, &opts, in_tensor);
-  GENERATE_FUNC(dtype, SetOutput, &opts, out_tensor);
-  GENERATE_FUNC(dtype, SetReduceFunc, &opts, reduce_type);
-  gloo::allreduce(opts);
+  const auto count = static_cast<size_t>(in_tensor.numel());
+  GENERATE_FUNC(dtype,
+                AllReduceImpl,
+                out_tensor->data(),
+                in_tensor.data(),
+                count,
+                reduce_type,
+                tag);
+}
+
+void GlooCommContext::AllReduce(std::vector<phi::DenseTensor>* out_tensors,
+                                const std::vector<phi::DenseTensor>& in_tensors,
+                                int reduce_type,
+                                uint32_t tag) {
+  PADDLE_ENFORCE_EQ(
+      out_tensors->size(),
+      in_tensors.size(),
+      phi::errors::InvalidArgument(
+          "The number of the output tensors (%d) of the allreduce should be "
+          "the same as the input tensors (%d).",
+          out_tensors->size(),
+          in_tensors.size()));
+  size_t begin = 0;
+  while (begin < in_tensors.size()) {
+    // the consecutive tensors of the same dtype are fused
+    const auto dtype = in_tensors[begin].dtype();
+    size_t end = begin;
+    size_t count = 0;
+    while (end < in_tensors.size() && in_tensors[end].dtype() == dtype) {
+      count += static_cast<size_t>(in_tensors[end].numel());
+      ++end;
+    }
+    if (end - begin == 1) {
+      AllReduce(&(*out_tensors)[begin], in_tensors[begin], reduce_type, tag);
+      begin = end;
+      continue;
+    }
+
+    const size_t elem_size = phi::SizeOf(dtype);
+    std::vector<char> buffer(count * elem_size);
+    size_t offset = 0;
+    for (size_t i = begin; i < end; ++i) {
+      const size_t bytes = in_tensors[i].numel() * elem_size;
+      std::memcpy(buffer.data() + offset, in_tensors[i].data(), bytes);
+      offset += bytes;
+    }
+    void* data = buffer.data();
+    GENERATE_FUNC(dtype, AllReduceImpl, data, data, count, reduce_type, tag);
+    offset = 0;
+    for (size_t i = begin; i < end; ++i) {
+      auto* out_tensor = &(*out_tensors)[i];
+      const size_t bytes = out_tensor->numel() * elem_size;
+      std::memcpy(out_tensor->data(), buffer.data() + offset, bytes);
+      offset += bytes;
+    }
+    begin = end;
+  }
 }
 
 void GlooCommContext::Reduce(phi::DenseTensor* out_tensor,
@@ -18,9 +18,11 @@
 #include <gloo/transport/tcp/device.h>
 
 #include <memory>
+#include <vector>
 
 #include "paddle/common/macros.h"
 #include "paddle/phi/core/distributed/comm_context.h"
+#include "paddle/phi/core/distributed/gloo_shm_comm.h"
 
 namespace phi {
 class DenseTensor;
@@ -43,6 +45,13 @@ class GlooCommContext final : public CommContext {
                  int reduce_type,
                  uint32_t tag = 0);
 
+  // Allreduces the tensors of the same dtype in one collective by packing
+  // them into one buffer, which saves the latency of the small tensors.
+  void AllReduce(std::vector<phi::DenseTensor>* out_tensors,
+                 const std::vector<phi::DenseTensor>& in_tensors,
+                 int reduce_type,
+                 uint32_t tag = 0);
+
   void Reduce(phi::DenseTensor* out_tensor,
               const phi::DenseTensor& in_tensor,
               int reduce_type,
@@ -73,7 +82,26 @@ class GlooCommContext final : public CommContext {
  private:
   DISABLE_COPY_AND_ASSIGN(GlooCommContext);
 
+  // The performance mode of FLAGS_gloo_performance_mode, the ranks on a
+  // host allreduce through the shared memory, and one rank of every host,
+  // the first one, allreduces with the other hosts through leader_context_.
+  void InitPerformanceMode(
+      const std::shared_ptr<gloo::rendezvous::Store>& store,
+      std::shared_ptr<gloo::transport::Device> device);
+
+  template <typename T>
+  void AllReduceImpl(void* out,
+                     const void* in,
+                     size_t count,
+                     int reduce_type,
+                     uint32_t tag);
+
   std::shared_ptr<gloo::rendezvous::Context> gloo_context_;
+
+  std::unique_ptr<GlooShmComm> shm_comm_;
+  // only on the leaders if there are more than one host
+  std::shared_ptr<gloo::rendezvous::Context> leader_context_;
+  int num_hosts_{1};
 };
 
 }  // namespace distributed
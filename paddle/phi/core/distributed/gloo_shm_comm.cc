@@ -0,0 +1,242 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/gloo_shm_comm.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+namespace distributed {
+
+namespace {
+
+constexpr size_t kCacheLineSize = 64;
+// the spins on the barrier before yielding the cpu
+constexpr int kBarrierSpins = 1024;
+
+size_t AlignUp(size_t bytes) {
+  return (bytes + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize;
+}
+
+#ifndef _WIN32
+std::string NewShmName() {
+  static std::atomic<uint64_t> counter{0};
+  return "/paddle_gloo_" + std::to_string(::getpid()) + "_" +
+         std::to_string(counter.fetch_add(1));
+}
+#endif
+
+}  // namespace
+
+GlooShmComm::GlooShmComm(const std::shared_ptr<gloo::rendezvous::Store>& store,
+                         const std::string& prefix,
+                         int local_rank,
+                         int local_size,
+                         size_t slot_bytes,
+                         std::chrono::milliseconds timeout)
+    : local_rank_(local_rank),
+      local_size_(local_size),
+      slot_bytes_(AlignUp(std::max<size_t>(slot_bytes, kCacheLineSize))),
+      timeout_(timeout) {
+#ifdef _WIN32
+  PADDLE_THROW(phi::errors::Unimplemented(
+      "The shared memory of gloo is not supported on Windows."));
+#else
+  mapped_bytes_ = kCacheLineSize + slot_bytes_ * local_size_;
+  const std::string name_key = prefix + "/name";
+  std::string name;
+  int fd = -1;
+  if (local_rank_ == 0) {
+    name = NewShmName();
+    fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    PADDLE_ENFORCE_NE(
+        fd,
+        -1,
+        phi::errors::External("Failed to create the shared memory %s: %s.",
+                              name,
+                              std::strerror(errno)));
+    PADDLE_ENFORCE_EQ(
+        ::ftruncate(fd, static_cast<off_t>(mapped_bytes_)),
+        0,
+        phi::errors::External("Failed to resize the shared memory %s: %s.",
+                              name,
+                              std::strerror(errno)));
+  } else {
+    store->wait({name_key}, timeout_);
+    auto value = store->get(name_key);
+    name = std::string(value.begin(), value.end());
+    fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+    PADDLE_ENFORCE_NE(
+        fd,
+        -1,
+        phi::errors::External("Failed to open the shared memory %s: %s.",
+                              name,
+                              std::strerror(errno)));
+  }
+  mapped_ = ::mmap(
+      nullptr, mapped_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  PADDLE_ENFORCE_NE(
+      mapped_,
+      MAP_FAILED,
+      phi::errors::External("Failed to map the shared memory %s: %s.",
+                            name,
+                            std::strerror(errno)));
+  header_ = static_cast<Header*>(mapped_);
+
+  if (local_rank_ == 0) {
+    new (header_) Header();
+    header_->arrived.store(0);
+    header_->generation.store(0);
+    store->set(name_key, std::vector<char>(name.begin(), name.end()));
+    // the name is unlinked once all the local ranks mapped it, so that it is
+    // released with the last of them whenever they exit
+    std::vector<std::string> opened_keys;
+    for (int i = 1; i < local_size_; ++i) {
+      opened_keys.push_back(prefix + "/opened/" + std::to_string(i));
+    }
+    if (!opened_keys.empty()) {
+      store->wait(opened_keys, timeout_);
+    }
+    ::shm_unlink(name.c_str());
+  } else {
+    store->set(prefix + "/opened/" + std::to_string(local_rank_),
+               std::vector<char>(1, '1'));
+  }
+  VLOG(3) << "Mapped the shared memory " << name << " of " << mapped_bytes_
+          << " bytes, local rank: " << local_rank_
+          << ", local size: " << local_size_;
+#endif
+}
+
+GlooShmComm::~GlooShmComm() {
+#ifndef _WIN32
+  if (mapped_ != nullptr && mapped_ != MAP_FAILED) {
+    ::munmap(mapped_, mapped_bytes_);
+  }
+#endif
+}
+
+char* GlooShmComm::Slot(int local_rank) const {
+  return static_cast<char*>(mapped_) + kCacheLineSize +
+         slot_bytes_ * local_rank;
+}
+
+void GlooShmComm::Barrier() {
+  const uint64_t generation =
+      header_->generation.load(std::memory_order_acquire);
+  if (header_->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+      static_cast<uint64_t>(local_size_)) {
+    header_->arrived.store(0, std::memory_order_relaxed);
+    header_->generation.fetch_add(1, std::memory_order_release);
+    return;
+  }
+  const auto deadline = std::chrono::steady_clock::now() + timeout_;
+  for (int spin = 1;
+       header_->generation.load(std::memory_order_acquire) == generation;
+       ++spin) {
+    if (spin < kBarrierSpins) {
+      continue;
+    }
+    std::this_thread::yield();
+    if (spin % kBarrierSpins == 0 &&
+        std::chrono::steady_clock::now() > deadline) {
+      PADDLE_THROW(phi::errors::ExecutionTimeout(
+          "Local rank %d timed out after %d ms waiting for the other ranks "
+          "on the shared memory barrier.",
+          local_rank_,
+          static_cast<int64_t>(timeout_.count())));
+    }
+  }
+}
+
+void GlooShmComm::AllReduce(void* out,
+                            const void* in,
+                            size_t count,
+                            size_t elem_size,
+                            ReduceFunc reduce_func,
+                            const CrossHostFunc& cross_host) {
+  const size_t chunk_count = slot_bytes_ / elem_size;
+  auto* out_bytes = static_cast<char*>(out);
+  const auto* in_bytes = static_cast<const char*>(in);
+  // the elements of [part * i, part * (i + 1)) are reduced by local rank i
+  auto part_range = [this](size_t n, int i) {
+    const size_t part = (n + local_size_ - 1) / local_size_;
+    const size_t begin = std::min(n, part * i);
+    return std::make_pair(begin, std::min(n, begin + part) - begin);
+  };
+  auto gather = [&](char* dst, size_t n) {
+    for (int i = 0; i < local_size_; ++i) {
+      const auto range = part_range(n, i);
+      std::memcpy(dst + range.first * elem_size,
+                  Slot(i) + range.first * elem_size,
+                  range.second * elem_size);
+    }
+  };
+
+  for (size_t offset = 0; offset < count; offset += chunk_count) {
+    const size_t n = std::min(chunk_count, count - offset);
+    char* result = out_bytes + offset * elem_size;
+    std::memcpy(
+        Slot(local_rank_), in_bytes + offset * elem_size, n * elem_size);
+    Barrier();
+
+    const auto range = part_range(n, local_rank_);
+    if (range.second > 0) {
+      char* mine = Slot(local_rank_) + range.first * elem_size;
+      for (int i = 0; i < local_size_; ++i) {
+        if (i != local_rank_) {
+          reduce_func(mine,
+                      mine,
+                      Slot(i) + range.first * elem_size,
+                      range.second);
+        }
+      }
+    }
+    Barrier();
+
+    if (cross_host) {
+      if (local_rank_ == 0) {
+        gather(result, n);
+        cross_host(result, n);
+        std::memcpy(Slot(0), result, n * elem_size);
+      }
+      Barrier();
+      if (local_rank_ != 0) {
+        std::memcpy(result, Slot(0), n * elem_size);
+      }
+    } else {
+      gather(result, n);
+    }
+    // the slots are reused by the next chunk
+    Barrier();
+  }
+}
+
+}  // namespace distributed
+}  // namespace phi
@@ -0,0 +1,92 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <gloo/rendezvous/store.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "paddle/common/macros.h"
+
+namespace phi {
+namespace distributed {
+
+// The allreduce of the ranks on one host through the shared memory, which
+// the performance mode of gloo takes instead of the tcp loopback. Every rank
+// copies its input into its slot, reduces 1 / local_size of the elements
+// over the slots, and the local rank 0, the leader, allreduces the result
+// with the leaders of the other hosts by cross_host before all the ranks copy
+// it out. The inputs larger than a slot are allreduced in chunks of it.
+class GlooShmComm {
+ public:
+  using ReduceFunc = void (*)(void*, const void*, const void*, size_t);
+  // allreduces count elements of data in place across the hosts
+  using CrossHostFunc = std::function<void(void* data, size_t count)>;
+
+  // The leader creates the shared memory, whose name is passed to the other
+  // local ranks through the store under prefix, which is unique for every
+  // host.
+  GlooShmComm(const std::shared_ptr<gloo::rendezvous::Store>& store,
+              const std::string& prefix,
+              int local_rank,
+              int local_size,
+              size_t slot_bytes,
+              std::chrono::milliseconds timeout);
+
+  ~GlooShmComm();
+
+  // All the local ranks call it together, with the same cross_host being
+  // empty if there is only one host.
+  void AllReduce(void* out,
+                 const void* in,
+                 size_t count,
+                 size_t elem_size,
+                 ReduceFunc reduce_func,
+                 const CrossHostFunc& cross_host);
+
+  int local_rank() const { return local_rank_; }
+
+  int local_size() const { return local_size_; }
+
+ private:
+  DISABLE_COPY_AND_ASSIGN(GlooShmComm);
+
+  struct Header {
+    std::atomic<uint64_t> arrived;
+    std::atomic<uint64_t> generation;
+  };
+
+  // The sense-reversing barrier of the local ranks on the header.
+  void Barrier();
+
+  char* Slot(int local_rank) const;
+
+  int local_rank_;
+  int local_size_;
+  size_t slot_bytes_;
+  std::chrono::milliseconds timeout_;
+  size_t mapped_bytes_{0};
+  void* mapped_{nullptr};
+  Header* header_{nullptr};
+};
+
+}  // namespace distributed
+}  // namespace phi
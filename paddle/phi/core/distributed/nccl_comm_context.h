@@ -40,6 +40,8 @@ namespace distributed {
 class NCCLCommContext final : public CommContext {
  public:
   NCCLCommContext(int rank, int size, ncclUniqueId nccl_id);
+  // Takes the communicator created elsewhere, e.g. split from another one.
+  NCCLCommContext(int rank, int size, ncclComm_t nccl_comm);
   ~NCCLCommContext() override = default;
 
   int GetNcclVersion();
@@ -19,8 +19,11 @@
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/core/distributed/comm_context_manager.h"
 #include "paddle/phi/core/distributed/nccl_tools.h"
+#include "paddle/phi/core/flags.h"
 #include "paddle/phi/core/utils/data_type.h"
 
+PHI_DECLARE_int32(comm_stats_interval);
+
 namespace phi {
 namespace distributed {
 
@@ -55,6 +58,14 @@ NCCLCommTask::NCCLCommTask(const phi::Place& place,
   end_event_created_ = false;
   start_time_ = std::chrono::steady_clock::now();
   timeout_ = std::chrono::milliseconds(timeout);
+  // the events are timed for the bandwidth stats of CommTaskManager
+  if (FLAGS_comm_stats_interval > 0) {
+#ifdef PADDLE_WITH_CUDA
+    cuda_event_flags_ = cudaEventDefault;
+#else  // PADDLE_WITH_HIP
+    hip_event_flags_ = hipEventDefault;
+#endif
+  }
 }
 
 void NCCLCommTask::StartRecord() {
@@ -118,6 +129,27 @@ void NCCLCommTask::ClearRecord() {
 }
 #endif
 
+float NCCLCommTask::GetElapsedMillis() {
+  float elapsed_ms = -1.0f;
+#ifdef PADDLE_WITH_CUDA
+  bool timed = !(cuda_event_flags_ & cudaEventDisableTiming);
+#else  // PADDLE_WITH_HIP
+  bool timed = !(hip_event_flags_ & hipEventDisableTiming);
+#endif
+  if (!timed || !start_event_created_ || !end_event_created_) {
+    return elapsed_ms;
+  }
+  backends::gpu::GPUDeviceGuard guard(place_.device);
+#ifdef PADDLE_WITH_CUDA
+  CUDA_CHECK(
+      cudaEventElapsedTime(&elapsed_ms, nccl_start_event_, nccl_end_event_));
+#else  // PADDLE_WITH_HIP
+  HIP_CHECK(
+      hipEventElapsedTime(&elapsed_ms, nccl_start_event_, nccl_end_event_));
+#endif
+  return elapsed_ms;
+}
+
 bool NCCLCommTask::CudaEventQuery(gpuEvent_t event) {
 #ifdef PADDLE_WITH_CUDA
   cudaError_t ret = cudaEventQuery(event);
@@ -32,6 +32,12 @@ class Store {
   virtual bool check(const std::string& key);
   virtual void wait(const std::string& key);
   virtual void set(const std::string& key, const std::vector<uint8_t>& value);
+  // The batched get and set of the keys, which are the gets and the sets one
+  // by one unless the subclass batches them in fewer round trips.
+  virtual std::vector<std::vector<uint8_t>> multi_get(
+      const std::vector<std::string>& keys);
+  virtual void multi_set(const std::vector<std::string>& keys,
+                         const std::vector<std::vector<uint8_t>>& values);
 
   virtual int timeout() { return _timeout; }
 
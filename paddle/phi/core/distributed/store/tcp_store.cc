@@ -14,6 +14,7 @@
 
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <thread>
@@ -85,6 +86,21 @@ void MasterDaemon::_do_set(SocketType socket) {
   _notify_waiting_sockets(key);
 }
 
+void MasterDaemon::_do_multi_set(SocketType socket) {
+  auto num_keys = tcputils::receive_value<size_t>(socket);
+  VLOG(8) << "MasterDaemon::_do_multi_set " << num_keys << " keys "
+          << GetSockName(socket);
+  std::vector<std::string> keys;
+  keys.reserve(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    keys.emplace_back(tcputils::receive_string(socket));
+    _store[keys.back()] = tcputils::receive_vector<uint8_t>(socket);
+  }
+  for (const auto& key : keys) {
+    _notify_waiting_sockets(key);
+  }
+}
+
 void MasterDaemon::_notify_waiting_sockets(const std::string& key) {
   if (_waiting_sockets.find(key) != _waiting_sockets.end()) {
     for (auto waiting_socket : _waiting_sockets.at(key)) {
@@ -110,6 +126,25 @@ void MasterDaemon::_do_get(SocketType socket) {
   tcputils::send_vector<uint8_t>(socket, value);
 }
 
+void MasterDaemon::_do_multi_get(SocketType socket) {
+  auto num_keys = tcputils::receive_value<size_t>(socket);
+  VLOG(8) << "MasterDaemon::_do_multi_get " << num_keys << " keys "
+          << GetSockName(socket);
+  std::vector<std::string> keys;
+  keys.reserve(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    keys.emplace_back(tcputils::receive_string(socket));
+  }
+  for (const auto& key : keys) {
+    auto iter = _store.find(key);
+    PADDLE_ENFORCE_NE(
+        iter,
+        _store.end(),
+        phi::errors::InvalidArgument("Key %s not found in TCPStore.", key));
+    tcputils::send_vector<uint8_t>(socket, iter->second);
+  }
+}
+
 void MasterDaemon::_do_check(SocketType socket) {
   std::string key = tcputils::receive_string(socket);
   VLOG(4) << "MasterDaemon::_do_check key(" << key << ") "
@@ -212,6 +247,12 @@ void MasterDaemon::ProcessCommands(std::vector<struct pollfd>* p_fds) {
         case Command::WAIT:
           _do_wait(fds[i].fd);
           break;
+        case Command::MULTI_GET:
+          _do_multi_get(fds[i].fd);
+          break;
+        case Command::MULTI_SET:
+          _do_multi_set(fds[i].fd);
+          break;
         default:
           VLOG(8) << "Unknown command: " << static_cast<int>(command)
                   << " from addr info:" << GetSockName(fds[i].fd);
@@ -332,6 +373,10 @@ void TCPClient::send_command_for_key(Command type, const std::string& key) {
   tcputils::send_string(_socket, key);
 }
 
+void TCPClient::send_string(const std::string& value) {
+  tcputils::send_string(_socket, value);
+}
+
 template <typename T>
 void TCPClient::send_value(const T& value) {
   tcputils::send_bytes<T>(_socket, &value, 1);
@@ -418,6 +463,7 @@ void TCPStore::waitWorkers() {
 
 int64_t TCPStore::add(const std::string& key, int64_t value) {
   VLOG(7) << "TCPStore add.";
+  std::lock_guard<std::mutex> lock(_mutex);
   _client->send_command_for_key(Command::ADD, _key_prefix + key);
   _client->send_value<std::int64_t>(value);
   return _client->receive_value<std::int64_t>();
@@ -425,18 +471,21 @@ int64_t TCPStore::add(const std::string& key, int64_t value) {
 
 void TCPStore::set(const std::string& key, const std::vector<uint8_t>& value) {
   VLOG(7) << "TCPStore set.";
+  std::lock_guard<std::mutex> lock(_mutex);
   _client->send_command_for_key(Command::SET, _key_prefix + key);
   _client->send_vector<uint8_t>(value);
 }
 
 std::vector<uint8_t> TCPStore::get(const std::string& key) {
   wait(key);
+  std::lock_guard<std::mutex> lock(_mutex);
   _client->send_command_for_key(Command::GET, _key_prefix + key);
   VLOG(7) << "TCPStore get.";
   return _client->receive_vector<uint8_t>();
 }
 
 bool TCPStore::check(const std::string& key) {
+  std::lock_guard<std::mutex> lock(_mutex);
   _client->send_command_for_key(Command::CHECK, _key_prefix + key);
   VLOG(3) << "TCPStore check.";
   auto response = _client->receive_value<ReplyType>();
@@ -450,6 +499,7 @@ bool TCPStore::check(const std::string& key) {
 void TCPStore::wait(const std::string& key) {
   ReplyType reply;  // NOLINT
   VLOG(7) << "TCPStore wait.";
+  std::lock_guard<std::mutex> lock(_mutex);
   _client->send_command_for_key(Command::WAIT, _key_prefix + key);
   reply = _client->receive_value<ReplyType>();
   PADDLE_ENFORCE_EQ(
@@ -458,6 +508,59 @@ void TCPStore::wait(const std::string& key) {
       phi::errors::InvalidArgument("Stop_waiting response is expected"));
 }
 
+std::vector<std::vector<uint8_t>> TCPStore::multi_get(
+    const std::vector<std::string>& keys) {
+  VLOG(7) << "TCPStore multi_get " << keys.size() << " keys.";
+  // the waits are pipelined in chunks, so that the replies never fill the
+  // socket buffers while the requests are still sent
+  constexpr size_t kWaitChunk = 1024;
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (size_t begin = 0; begin < keys.size(); begin += kWaitChunk) {
+    const size_t end = std::min(keys.size(), begin + kWaitChunk);
+    for (size_t i = begin; i < end; ++i) {
+      _client->send_command_for_key(Command::WAIT, _key_prefix + keys[i]);
+    }
+    // the replies are all STOP_WAIT, in the order the keys are set
+    for (size_t i = begin; i < end; ++i) {
+      auto reply = _client->receive_value<ReplyType>();
+      PADDLE_ENFORCE_EQ(
+          reply == ReplyType::STOP_WAIT,
+          true,
+          phi::errors::InvalidArgument("Stop_waiting response is expected"));
+    }
+  }
+  _client->send_command_for_key(Command::MULTI_GET, "");
+  _client->send_value<size_t>(keys.size());
+  for (const auto& key : keys) {
+    _client->send_string(_key_prefix + key);
+  }
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    values.emplace_back(_client->receive_vector<uint8_t>());
+  }
+  return values;
+}
+
+void TCPStore::multi_set(const std::vector<std::string>& keys,
+                         const std::vector<std::vector<uint8_t>>& values) {
+  VLOG(7) << "TCPStore multi_set " << keys.size() << " keys.";
+  PADDLE_ENFORCE_EQ(
+      keys.size(),
+      values.size(),
+      phi::errors::InvalidArgument("The sizes of the keys (%d) and the values "
+                                   "(%d) of multi_set must be the same.",
+                                   keys.size(),
+                                   values.size()));
+  std::lock_guard<std::mutex> lock(_mutex);
+  _client->send_command_for_key(Command::MULTI_SET, "");
+  _client->send_value<size_t>(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    _client->send_string(_key_prefix + keys[i]);
+    _client->send_vector<uint8_t>(values[i]);
+  }
+}
+
 TCPStore::~TCPStore() { VLOG(7) << "TCPStore destructure"; }
 
 }  // namespace distributed
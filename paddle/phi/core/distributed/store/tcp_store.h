@@ -38,7 +38,7 @@ namespace phi {
 namespace distributed {
 
 enum class ReplyType { WAITING, STOP_WAIT, READY, NOT_READY };
-enum class Command { ADD, GET, CHECK, SET, WAIT, STOP };
+enum class Command { ADD, GET, CHECK, SET, WAIT, STOP, MULTI_GET, MULTI_SET };
 
 namespace detail {
 
@@ -61,6 +61,8 @@ class MasterDaemon {
   void _do_get(SocketType socket);
   void _do_check(SocketType socket);
   void _do_set(SocketType socket);
+  void _do_multi_get(SocketType socket);
+  void _do_multi_set(SocketType socket);
   void _notify_waiting_sockets(const std::string&);
   SocketType _listen_socket;
   std::vector<SocketType> _sockets;
@@ -99,6 +101,7 @@ class TCPClient {
                                             uint16_t port);
   ~TCPClient() { tcputils::close_socket(_socket); }
   void send_command_for_key(Command type, const std::string& key);
+  void send_string(const std::string& value);
 
   template <typename T>
   void send_value(const T& value);
@@ -134,6 +137,12 @@ class TCPStore : public Store {
   bool check(const std::string& key) override;
   void wait(const std::string& key) override;
   void set(const std::string& key, const std::vector<uint8_t>& value) override;
+  // The waits of the keys are pipelined before one MULTI_GET, so that it
+  // takes a few round trips however many keys there are.
+  std::vector<std::vector<uint8_t>> multi_get(
+      const std::vector<std::string>& keys) override;
+  void multi_set(const std::vector<std::string>& keys,
+                 const std::vector<std::vector<uint8_t>>& values) override;
 
  private:
   void waitWorkers();
@@ -145,6 +154,9 @@ class TCPStore : public Store {
 
   bool _is_master;
   int _num_workers;
+  // the commands of the threads, e.g. the comm stats of CommTaskManager, are
+  // serialized on the one connection of the client
+  std::mutex _mutex;
 };
 
 }  // namespace distributed
@@ -104,6 +104,39 @@ PHI_DEFINE_EXPORTED_int32(
     0,
     "Setting the check and print level when FLAGS_check_nan_inf is set.");
 
+/**
+ * Operator related FLAG
+ * Name: FLAGS_check_nan_inf_async
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Used to debug. When FLAGS_check_nan_inf is set, the new executor
+ * accumulates whether the outputs of the ops hold NAN/INF into a flag on the
+ * device instead of checking every output with a sync, and checks the flag of
+ * a step at the end of the next step. When the flag is set, the next step
+ * checks every output of every op to locate the first op producing NAN/INF.
+ */
+PHI_DEFINE_EXPORTED_bool(
+    check_nan_inf_async,
+    false,
+    "Accumulating the NAN/INF of the op outputs into a flag on the device, "
+    "checked once a step, when FLAGS_check_nan_inf is set.");
+
+/**
+ * Operator related FLAG
+ * Name: FLAGS_check_nan_inf_sample_interval
+ * Since Version: 2.6.0
+ * Value Range: int32, default=1
+ * Example:
+ * Note: Used to debug. With FLAGS_check_nan_inf_async, only the outputs of
+ * every N-th op of a step are accumulated into the flag, 1 for all the ops.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    check_nan_inf_sample_interval,
+    1,
+    "The interval of the ops accumulated when FLAGS_check_nan_inf_async "
+    "is set.");
+
 /**
  * Operator related FLAG
  * Name: FLAGS_check_nan_inf
@@ -118,6 +151,23 @@ PHI_DEFINE_EXPORTED_bool(
     "Checking whether operator produce NAN/INF or not. It will be "
     "extremely slow so please use this flag wisely.");
 
+/**
+ * Operator related FLAG
+ * Name: FLAGS_graph_send_recv_sorted_reduce
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Whether the gpu kernels of send_u_recv and send_ue_recv sort the
+ * edges by dst and reduce the messages of an out row in a fixed order, instead
+ * of adding them to the out rows by atomics. It is deterministic and faster
+ * on the skewed graphs whose hub nodes serialize the atomics, at the cost of
+ * the sort.
+ */
+PHI_DEFINE_EXPORTED_bool(graph_send_recv_sorted_reduce,
+                         false,
+                         "Whether send_u_recv and send_ue_recv reduce the "
+                         "messages of the edges sorted by dst.");
+
 // NOTE(zhiqiu): better to share the flags, otherwise we will have too many
 // flags.
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -241,7 +291,10 @@ PHI_DEFINE_EXPORTED_bool(
  * Note: whether to use deterministic algorithm in embedding op.
  *       If it is 1, it will use the optimized deterministic CUDA kernel in
  *       embedding op. If it is 2, it will use the legacy deterministic
- *       CUDA kernel in embedding op.
+ *       CUDA kernel in embedding op. If it is 3, it will sort the ids and
+ *       sum the gradients of every id without atomics, which is faster for
+ *       the skewed ids, and the sparse gradient has the rows of the unique
+ *       ids.
  */
 PHI_DEFINE_EXPORTED_int64(
     embedding_deterministic,
@@ -250,6 +303,23 @@ PHI_DEFINE_EXPORTED_int64(
     "operator. The deterministic algorithm may be slower. If "
     "it is larger than 0, the algorithm is deterministic.");
 
+/**
+ * CUDA related FLAG
+ * Name: FLAGS_sparse_conv_implicit_gemm
+ * Since Version: 2.6
+ * Value Range: bool, default=true
+ * Example:
+ * Note: whether the sparse conv fuses the gather, the gemm and the scatter of
+ *       the rulebook into one kernel for each kernel offset. The out values
+ *       are accumulated by atomics, so the order of the sum is
+ *       non-deterministic. If false, the deterministic gather, gemm and
+ *       scatter are used.
+ */
+PHI_DEFINE_EXPORTED_bool(sparse_conv_implicit_gemm,
+                         true,
+                         "Whether to fuse the gather, gemm and scatter of the "
+                         "sparse conv into an implicit gemm.");
+
 /**
  * CUDNN related FLAG
  * Name: FLAGS_conv_workspace_size_limit
@@ -299,6 +369,22 @@ PHI_DEFINE_EXPORTED_int64(cudnn_exhaustive_search_times,
                           "Exhaustive search times for cuDNN convolution, "
                           "default is -1, not exhaustive search");
 
+/**
+ * FFT related FLAG
+ * Name: FLAGS_fft_plan_cache_max_size
+ * Since Version: 3.0.0
+ * Value Range: int64, default=1024
+ * Example:
+ * Note: The max number of the cuFFT or hipFFT plans cached for every device
+ *       and stream, the least recently used plans are destroyed beyond it.
+ *       The plans do not hold the workspace, which is allocated by the
+ *       allocator for every execution.
+ */
+PHI_DEFINE_EXPORTED_int64(fft_plan_cache_max_size,
+                          1024,
+                          "The max number of the FFT plans cached for every "
+                          "device and stream.");
+
 /**
  * CUDNN related FLAG
  * Name: FLAGS_cudnn_batchnorm_spatial_persistent
@@ -392,6 +478,88 @@ PHI_DEFINE_EXPORTED_int32(dist_threadpool_size,
                           0,
                           "number of threads used for distributed executed.");
 
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_eager_reducer_rebuild_group_steps
+ * Since Version: 2.6.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_eager_reducer_rebuild_group_steps=5
+ * Note: If it is greater than 0, EagerReducer records the order in which the
+ *       gradients are ready in the first N steps, and rebuilds the groups
+ *       by the average order after them, so that a group is full as soon as
+ *       possible in backward. It does not work with find_unused_parameters.
+ */
+PHI_DEFINE_EXPORTED_int32(eager_reducer_rebuild_group_steps,
+                          0,
+                          "rebuild the groups of EagerReducer after N steps.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_eager_reducer_comm_dtype
+ * Since Version: 2.6.0
+ * Value Range: string, {"", "float16", "bfloat16"}, default=""
+ * Example: FLAGS_eager_reducer_comm_dtype=bfloat16
+ * Note: If it is set, EagerReducer casts the float32 gradients to this dtype
+ *       when they are concated into the group buffer and allreduces the
+ *       buffer in it, then casts them back when the buffer is split.
+ */
+PHI_DEFINE_EXPORTED_string(eager_reducer_comm_dtype,
+                           "",
+                           "dtype of the allreduce of float32 gradients in "
+                           "EagerReducer, float16 or bfloat16.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_eager_reducer_use_comm_buffer
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_eager_reducer_use_comm_buffer=true
+ * Note: If it is true, the group buffers of EagerReducer on the gpu are
+ *       allocated once by ncclMemAlloc and registered to the communicator,
+ *       so that their allreduce takes the zero copy algorithms of nccl, e.g.
+ *       NVLS. It needs nccl 2.19 or later.
+ */
+PHI_DEFINE_EXPORTED_bool(eager_reducer_use_comm_buffer,
+                         false,
+                         "Whether to allreduce the gradients of EagerReducer "
+                         "in the buffers registered to nccl.");
+
+/**
+ * Backward related FLAG
+ * Name: FLAGS_eager_backward_num_threads
+ * Since Version: 2.6.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_eager_backward_num_threads=4
+ * Note: If it is greater than 1, the backward of eager mode runs the grad
+ *       nodes ready at the same time, e.g. of the independent branches, on
+ *       a pool of so many threads, which is created on the first backward.
+ *       The nodes of a device keep the order of their dependencies on its
+ *       stream, since a node is launched after all its inputs. The backward
+ *       of paddle.grad, with create_graph or with force sequential nodes is
+ *       still sequential. The hooks of the grads may run on the threads
+ *       concurrently.
+ */
+PHI_DEFINE_EXPORTED_int32(eager_backward_num_threads,
+                          0,
+                          "number of threads to run the grad nodes of the "
+                          "eager backward.");
+
+/**
+ * AMP related FLAG
+ * Name: FLAGS_eager_amp_cast_cache
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_eager_amp_cast_cache=true
+ * Note: If True, the eager AMP casts a leaf tensor, e.g. a parameter, used by
+ *       several ops once, and reuses the copy until the inplace version of
+ *       the tensor changes. The copies are released at the end of backward
+ *       and at the exit of auto_cast.
+ */
+PHI_DEFINE_EXPORTED_bool(eager_amp_cast_cache,
+                         false,
+                         "Whether to reuse the casts of the leaf tensors by "
+                         "the eager AMP.");
+
 /**
  * Garbage collector related FLAG
  * Name: FLAGS_eager_delete_tensor_gb
@@ -465,8 +633,8 @@ PHI_DEFINE_EXPORTED_double(
  * Allocator related FLAG
  * Name: FLAGS_allocator_strategy
  * Since Version: 1.2
- * Value Range: string, {naive_best_fit, auto_growth, thread_local},
- * default=auto_growth
+ * Value Range: string, {naive_best_fit, auto_growth, thread_local,
+ * cuda_malloc_async}, default=auto_growth
  * Example:
  * Note: For selecting allocator policy of PaddlePaddle.
  */
@@ -484,7 +652,10 @@ PHI_DEFINE_EXPORTED_string(
     "size of models may be larger). auto_growth strategy would allocate "
     "GPU memory on demand, which allows users to start several Paddle jobs "
     "on the same GPU card but may lead to more memory fragmentation "
-    "(i.e., maximum batch size of models may be smaller).");
+    "(i.e., maximum batch size of models may be smaller). "
+    "cuda_malloc_async means the stream-ordered memory pool of CUDA driver "
+    "(requires CUDA 11.2), which lets the driver reuse freed GPU memory "
+    "across streams.");
 
 /**
  * Memory related FLAG
@@ -681,6 +852,39 @@ PHI_DEFINE_EXPORTED_bool(
  */
 PHI_DEFINE_EXPORTED_bool(use_mkldnn, false, "Use MKLDNN to run");
 
+#ifdef PADDLE_WITH_DNNL
+/**
+ * MKLDNN related FLAG
+ * Name: onednn_primitive_cache_capacity
+ * Since Version: 3.0.0
+ * Value Range: int32, default=1024
+ * Example: FLAGS_onednn_primitive_cache_capacity=4096
+ * Note: The max number of the primitives in the global oneDNN primitive
+ * cache, which is shared by all the threads and predictors of the process.
+ * The least recently used ones are evicted beyond it, and 0 disables it.
+ */
+PHI_DEFINE_EXPORTED_int32(onednn_primitive_cache_capacity,
+                          1024,
+                          "The capacity of the global oneDNN primitive cache, "
+                          "0 to disable it.");
+
+/**
+ * MKLDNN related FLAG
+ * Name: onednn_matmul_runtime_m
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_onednn_matmul_runtime_m=true
+ * Note: If true, the oneDNN matmul primitives are created with the rows of x
+ * as a runtime dim, so that all the batch sizes of a matmul share one bucket
+ * of the primitive cache instead of creating one primitive for every batch
+ * size, at the cost of the kernels specialized for the shape.
+ */
+PHI_DEFINE_EXPORTED_bool(onednn_matmul_runtime_m,
+                         false,
+                         "Create the oneDNN matmul primitives with the rows of "
+                         "x as a runtime dim.");
+#endif
+
 /**
  * Debug related FLAG
  * Name: FLAGS_call_stack_level
@@ -865,6 +1069,21 @@ PHI_DEFINE_EXPORTED_bool(enable_neighbor_list_use_uva,
                          false,
                          "It controls whether store neighbor_list with UVA");
 
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_graph_weighted_sample_by_alias
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Control whether build the alias tables of the weighted edges when the
+ *       gpu graph is loaded, and draw the weighted neighbor samples with
+ *       replacement by them in O(1) each
+ */
+PHI_DEFINE_EXPORTED_bool(graph_weighted_sample_by_alias,
+                         false,
+                         "It controls whether sample the weighted neighbors "
+                         "with replacement by the alias tables.");
+
 /**
  * Distributed related FLAG
  * Name: FLAGS_graph_neighbor_size_percent
@@ -906,6 +1125,34 @@ PHI_DEFINE_EXPORTED_bool(
     false,
     "It controls get all neighbor id when running sub part graph.");
 
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_graph_compact_edges
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Control whether freeze the loaded edges of GraphTable into sorted
+ *       and varint delta encoded neighbor lists to save the server memory
+ */
+PHI_DEFINE_EXPORTED_bool(graph_compact_edges,
+                         false,
+                         "It controls whether compact the loaded edges of "
+                         "graph table.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_graph_compact_edges_quantize_weight
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Control whether quantize the weights of the compacted edges to 8 bits
+ *       by the max weight of every node
+ */
+PHI_DEFINE_EXPORTED_bool(graph_compact_edges_quantize_weight,
+                         false,
+                         "It controls whether quantize the weights of the "
+                         "compacted edges to 8 bits.");
+
 /**
  * Distributed related FLAG
  * Name: enable_exit_when_partial_worker
@@ -946,6 +1193,19 @@ PHI_DEFINE_EXPORTED_int32(gpugraph_storage_mode,
                           1,
                           "gpugraph storage mode, default 1");
 
+/**
+ * Distributed related FLAG
+ * Name: gpups_prefetch_ssd_keys
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: move the keys of the next pass from ssd to memory right after they
+ * are collected, so that BuildPull does not wait for the ssd reads.
+ */
+PHI_DEFINE_EXPORTED_bool(gpups_prefetch_ssd_keys,
+                         false,
+                         "prefetch the keys of the next pass from ssd");
+
 /**
  * KP kernel related FLAG
  * Name: FLAGS_run_kp_kernel
@@ -1069,6 +1329,20 @@ PHI_DEFINE_EXPORTED_string(cinn_subgraph_graphviz_dir,
                            "Specify the directory path of dot file of "
                            "graph, which is used for debug.");
 
+/*
+ * CINN related FLAG
+ * Name: FLAGS_cinn_compile_async
+ * Since Version: 2.6
+ * Value Range: bool, default=false
+ * Example: FLAGS_cinn_compile_async=true would compile the infer programs of
+ * @to_static by CINN on a background thread, and run them without CINN until
+ * the compilation finishes.
+ */
+PHI_DEFINE_EXPORTED_bool(cinn_compile_async,
+                         false,
+                         "Whether to compile the programs by CINN in the "
+                         "background, running them without CINN meanwhile.");
+
 #endif
 
 /*
@@ -1095,6 +1369,37 @@ PHI_DEFINE_EXPORTED_uint64(executor_log_deps_every_microseconds,
                            0,
                            "Enable new executor log deps every n microseconds");
 
+/*
+ * Executor related FLAG
+ * Name: FLAGS_naive_executor_prepared_run
+ * Since Version: 2.6
+ * Value Range: bool, default=false
+ * Example: FLAGS_naive_executor_prepared_run=true would make the
+ * NaiveExecutor cache the runtime contexts of all the ops, and run the ops
+ * on cpu by their bound phi kernels and cached KernelContexts after the first
+ * run, skipping the InferShape while the dims of the inputs are unchanged.
+ */
+PHI_DEFINE_EXPORTED_bool(naive_executor_prepared_run,
+                         false,
+                         "Run the ops of NaiveExecutor on cpu by their bound "
+                         "phi kernels and cached KernelContexts.");
+
+/*
+ * Inference related FLAG
+ * Name: FLAGS_inference_batched_copy_max_bytes
+ * Since Version: 2.6
+ * Value Range: uint64, default=0
+ * Example: FLAGS_inference_batched_copy_max_bytes=1048576 would make the
+ * AnalysisPredictor on gpu copy the feeds and the fetches of at most 1MB in
+ * one batch through a pinned staging buffer, instead of one copy for each.
+ * 0 disables the batched copies.
+ */
+PHI_DEFINE_EXPORTED_uint64(inference_batched_copy_max_bytes,
+                           0,
+                           "The max bytes of the feeds and the fetches on gpu "
+                           "copied in one batch by the predictor, 0 to "
+                           "disable it.");
+
 PD_DEFINE_int32(record_pool_max_size,
                 2000000,
                 "SlotRecordDataset slot record pool max size");
@@ -1110,6 +1415,22 @@ PD_DEFINE_bool(enable_slotrecord_reset_shrink,  // NOLINT
 PD_DEFINE_bool(enable_ins_parser_file,  // NOLINT
                false,
                "enable parser ins file, default false");
+PHI_DEFINE_EXPORTED_int32(
+    dataset_load_read_threads,
+    0,
+    "the number of threads reading the files of InMemoryDataset ahead of "
+    "the parsers, 0 disables the load pipeline, default 0");
+PHI_DEFINE_EXPORTED_int32(
+    dataset_load_decompress_threads,
+    4,
+    "the number of threads decompressing the gzip files of InMemoryDataset "
+    "in the load pipeline, default 4");
+PHI_DEFINE_EXPORTED_int32(
+    data_feed_pack_depth,
+    1,
+    "the number of the gpu packs of a SlotRecordInMemoryDataFeed beyond its "
+    "pack threads, i.e. the packed minibatches waiting ahead of the trainer "
+    "when all the pack threads are busy, default 1");
 PHI_DEFINE_EXPORTED_bool(
     gpugraph_enable_hbm_table_collision_stat,
     false,
@@ -1122,10 +1443,20 @@ PHI_DEFINE_EXPORTED_bool(
 PHI_DEFINE_EXPORTED_double(gpugraph_hbm_table_load_factor,
                            0.75,
                            "the load factor of hbm table, default 0.75");
+PHI_DEFINE_EXPORTED_bool(
+    gpugraph_enable_bucket_hbm_table,
+    false,
+    "use the bucketized hbm table probed by the threads of a warp, which "
+    "keeps fast at the load factor above 0.9, default false");
 PHI_DEFINE_EXPORTED_bool(
     gpugraph_enable_gpu_direct_access,
     false,
     "enable direct access between multi gpu cards, default false");
+PHI_DEFINE_EXPORTED_bool(
+    gpugraph_enable_inner_all2all,
+    false,
+    "exchange the sparse shards between the gpu cards of a node by one nccl "
+    "all2all instead of the peer copies, default false");
 PHI_DEFINE_EXPORTED_bool(
     gpugraph_enable_segment_merge_grads,
     false,
@@ -1200,6 +1531,26 @@ PHI_DEFINE_EXPORTED_bool(benchmark_nccl,
                          "enable nccl debug mode to synchronize nccl comm");
 #endif
 
+/**
+ * ProcessGroupNCCL related FLAG
+ * Name: FLAGS_nccl_hierarchical_allreduce_threshold
+ * Since Version: 2.6.0
+ * Value Range: int64, default=0
+ * Example: FLAGS_nccl_hierarchical_allreduce_threshold=67108864
+ * Note: If it is greater than 0, the allreduce of a tensor of at least this
+ *       many bytes in a group spanning several nodes is done in two levels:
+ *       a reduce scatter in the node, an allreduce of the shard between the
+ *       ranks of the same local rank on all nodes, and an allgather in the
+ *       node. 0 means the hierarchical allreduce is disabled.
+ */
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+PHI_DEFINE_EXPORTED_int64(nccl_hierarchical_allreduce_threshold,
+                          0,
+                          "allreduce tensors of at least this many bytes by "
+                          "the intra and inter node communicators, 0 means "
+                          "disabled.");
+#endif
+
 /**
  * Autotune related FLAG
  * Name: FLAGS_use_autotune
@@ -1209,6 +1560,40 @@ PHI_DEFINE_EXPORTED_bool(benchmark_nccl,
  */
 PHI_DEFINE_EXPORTED_bool(use_autotune, false, "Whether enable autotune.");
 
+/**
+ * Autotune related FLAG
+ * Name: FLAGS_autotune_cache_file
+ * Since Version: 2.6.0
+ * Value Range: string, default=""
+ * Example: FLAGS_autotune_cache_file=/path/to/autotune_cache
+ * Note: If set, the algorithms tuned on the same GPU model with the same
+ * driver, CUDA and cuDNN versions are loaded from the file at startup, so
+ * that they are not searched again, and the algorithms tuned by the process
+ * are merged into the file at exit. The file can be shared by the processes
+ * of a job on one machine, and by the machines of different GPUs.
+ */
+PHI_DEFINE_EXPORTED_string(autotune_cache_file,
+                           "",
+                           "The file to load the autotune cache from at "
+                           "startup and to merge the autotune cache into at "
+                           "exit, empty means the cache is not persisted.");
+
+/**
+ * Layout autotune related FLAG
+ * Name: FLAGS_layout_autotune_by_cost
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If True, the layout autotune times the conv2d ops of the first step
+ * of the model in both NCHW and NHWC, together with the transposes between
+ * them, and tunes the layout only if the other layout costs less in total.
+ * Otherwise the layout is chosen by the data type of the first conv2d.
+ */
+PHI_DEFINE_EXPORTED_bool(layout_autotune_by_cost,
+                         false,
+                         "Whether to choose the layout of layout autotune by "
+                         "the measured costs of the conv2d ops.");
+
 /**
  * Conv Search cache max number related FLAG
  * Name: FLAGS_search_cache_max_number
@@ -1297,6 +1682,20 @@ PHI_DEFINE_EXPORTED_bool(trt_ibuilder_cache,
                          false,
                          "Add a persistent ibuilder.");
 
+/**
+ * Inference related FLAG
+ * Name: trt_engine_build_num_threads
+ * Since Version: 2.6.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_trt_engine_build_num_threads=4
+ * Note: The number of threads to build the TensorRT engines of the subgraphs
+ * of a model concurrently in tensorrt_subgraph_pass.
+ */
+PHI_DEFINE_EXPORTED_int32(trt_engine_build_num_threads,
+                          1,
+                          "The number of threads to build the TensorRT "
+                          "engines of the subgraphs.");
+
 /**
  * mmap_allocator related FLAG
  * Name: use_shm_cache
@@ -1310,6 +1709,71 @@ PHI_DEFINE_EXPORTED_bool(use_shm_cache,
                          false,
                          "Use shm cache in mmap_allocator.");
 
+/**
+ * mmap_allocator related FLAG
+ * Name: shm_arena_size_mb
+ * Since Version: 2.6.0
+ * Value Range: int64, default=0
+ * Example:
+ * Note: If larger than 0, _share_filename places tensors in the slots of a
+ * shm arena of this size in MB pre-allocated by every process. The arena is
+ * a ring of refcounted slots, a slot is reused after all the holders of it are
+ * released, so that shm_open, mmap and munmap are not called per tensor.
+ * Tensors that do not fit in the free space fall back to a shm file each.
+ */
+PHI_DEFINE_EXPORTED_int64(shm_arena_size_mb,
+                          0,
+                          "Size in MB of the shm arena of mmap_allocator.");
+
+/**
+ * mmap_allocator related FLAG
+ * Name: shm_arena_pin_memory
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If True, the process rebuilding tensors from a shm arena registers
+ * the mapping of the arena as page-locked memory by cudaHostRegister, so that
+ * the tensors are copied to GPU without staging.
+ */
+PHI_DEFINE_EXPORTED_bool(shm_arena_pin_memory,
+                         false,
+                         "Register the mapped shm arena as pinned memory.");
+
+/**
+ * load_combine_op related FLAG
+ * Name: load_combine_num_threads
+ * Since Version: 2.6.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_load_combine_num_threads=8
+ * Note: If larger than 1, load_combine reads the headers of all the params in
+ * the combined params file first, then reads the data of them in chunks with
+ * this number of threads. On GPU, every thread stages its chunks in pinned
+ * memory and copies them to the device asynchronously, so that the reads from
+ * disk overlap the copies to the device.
+ */
+PHI_DEFINE_EXPORTED_int32(load_combine_num_threads,
+                          1,
+                          "The number of threads of load_combine to read the "
+                          "combined params file.");
+
+/**
+ * save_combine_op related FLAG
+ * Name: save_combine_num_threads
+ * Since Version: 2.6.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_save_combine_num_threads=8
+ * Note: If larger than 1, save_combine writes the headers of all the params
+ * to the combined params file first, then writes the data of them in chunks
+ * with this number of threads, straight from the tensors instead of through
+ * an in-memory copy of the whole file. On GPU, every thread stages its chunks
+ * in pinned memory, so that the copies from the device overlap the writes.
+ * The file is the same as the one saved by a single thread.
+ */
+PHI_DEFINE_EXPORTED_int32(save_combine_num_threads,
+                          1,
+                          "The number of threads of save_combine to write the "
+                          "combined params file.");
+
 /**
  * Tensor operants related FLAG
  * Name: tensor_operants_mode
@@ -1352,6 +1816,125 @@ PHI_DEFINE_EXPORTED_bool(enable_pir_with_pt_in_dy2st,
                          true,
                          "Enable new IR in executor");
 
+/**
+ * Distributed related FLAG
+ * Name: heter_pipeline_autotune
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If True, the first stage of the heter pipeline trainer measures the
+ * time of its forward, backward and waiting for the later stages, and tunes
+ * the number of microbatches of a minibatch between 1 and num_microbatches
+ * by them.
+ */
+PHI_DEFINE_EXPORTED_bool(heter_pipeline_autotune,
+                         false,
+                         "Tune the number of microbatches of the heter "
+                         "pipeline by the measured stage latencies.");
+
+/**
+ * Distributed related FLAG
+ * Name: ps_gpu_embedding_cache_capacity
+ * Since Version: 2.6.0
+ * Value Range: int64, default=0
+ * Example:
+ * Note: The number of rows of a sparse table cached in the GPU memory by the
+ * distributed_lookup_table op on a GPU, so that the hit rows are not pulled
+ * from the pservers and copied to the GPU again. 0 means no cache.
+ */
+PHI_DEFINE_EXPORTED_int64(ps_gpu_embedding_cache_capacity,
+                          0,
+                          "The number of rows of a sparse table cached in "
+                          "the GPU memory by distributed_lookup_table.");
+
+/**
+ * Distributed related FLAG
+ * Name: ps_gpu_embedding_cache_max_staleness_pulls
+ * Since Version: 2.6.0
+ * Value Range: int32, default=16
+ * Example:
+ * Note: The number of lookups a row cached by
+ * FLAGS_ps_gpu_embedding_cache_capacity serves at most, then it is pulled
+ * from the pservers again, so that the pushes of the trainers reach it.
+ */
+PHI_DEFINE_EXPORTED_int32(ps_gpu_embedding_cache_max_staleness_pulls,
+                          16,
+                          "The number of lookups a row cached in the GPU "
+                          "memory serves at most before it is pulled again.");
+
+/**
+ * Distributed related FLAG
+ * Name: rpc_batch_max_size
+ * Since Version: 2.6.0
+ * Value Range: int32, default=1
+ * Example:
+ * Note: The number of the rpc requests to the same worker which are sent in
+ * one brpc call at most. 1 means every request is sent by itself.
+ */
+PHI_DEFINE_EXPORTED_int32(rpc_batch_max_size,
+                          1,
+                          "The number of the rpc requests to the same worker "
+                          "which are sent in one brpc call at most.");
+
+/**
+ * Distributed related FLAG
+ * Name: rpc_batch_delay_us
+ * Since Version: 2.6.0
+ * Value Range: int32, default=100
+ * Example:
+ * Note: The time in microseconds that a rpc request waits for the following
+ * requests to the same worker at most when rpc_batch_max_size > 1.
+ */
+PHI_DEFINE_EXPORTED_int32(rpc_batch_delay_us,
+                          100,
+                          "The time in microseconds that a rpc request waits "
+                          "to be batched at most.");
+
+/**
+ * Distributed related FLAG
+ * Name: rpc_server_thread_num
+ * Since Version: 2.6.0
+ * Value Range: int32, default=1
+ * Example:
+ * Note: The number of threads of a rpc worker which run the functions of a
+ * batch of requests. The functions hold the GIL, so only the functions which
+ * release it, e.g. by running paddle operators, run concurrently.
+ */
+PHI_DEFINE_EXPORTED_int32(rpc_server_thread_num,
+                          1,
+                          "The number of threads of a rpc worker which run "
+                          "the functions of a batch of requests.");
+
+/**
+ * Executor FLAG
+ * Name: executor_cache_capacity
+ * Since Version: 2.6.0
+ * Value Range: int32, default=8
+ * Example:
+ * Note: The number of prepared programs, contexts and scopes cached by a
+ * static Executor for each kind of cache at most. If exceeded, the least
+ * recently used one is released.
+ */
+PHI_DEFINE_EXPORTED_int32(executor_cache_capacity,
+                          8,
+                          "The number of prepared programs cached by a "
+                          "static Executor at most.");
+
+/**
+ * Dy2st FLAG
+ * Name: dy2st_interpretercore_cache_capacity
+ * Since Version: 2.6.0
+ * Value Range: int32, default=0
+ * Example:
+ * Note: The number of programs whose InterpreterCores are cached for dy2st
+ * at most. If exceeded, the InterpreterCores of the least recently used
+ * program are released. 0 means unlimited.
+ */
+PHI_DEFINE_EXPORTED_int32(dy2st_interpretercore_cache_capacity,
+                          0,
+                          "The number of programs whose InterpreterCores are "
+                          "cached for dy2st at most, 0 means unlimited.");
+
 /**
  * Using PIR API in Python
  * Name: enable_pir_api
@@ -1388,6 +1971,37 @@ PHI_DEFINE_EXPORTED_bool(pir_apply_inplace_pass,
                          "Whether to apply inplace pass on lowering "
                          "::pir::Program to Kernel Dialect");
 
+/**
+ * Apply loop invariant hoisting pass to new IR FLAG
+ * Name: pir_apply_loop_invariant_hoisting_pass
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If True, the ops of the while bodies whose inputs are all defined
+ * outside the loop are moved in front of the while ops, and run once even if
+ * the loop runs no iteration.
+ */
+PHI_DEFINE_EXPORTED_bool(pir_apply_loop_invariant_hoisting_pass,
+                         false,
+                         "Whether to move the loop invariants out of the "
+                         "while bodies of the Kernel Dialect program");
+
+/**
+ * Select the outputs of an if op on the device FLAG
+ * Name: pir_if_select_on_device_max_ops
+ * Since Version: 2.6.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_pir_if_select_on_device_max_ops=8
+ * Note: If the branches of an if op with a condition on the gpu both have at
+ * most this number of ops, and the ops have no side effects, both branches
+ * run and their outputs are selected by the condition on the device instead
+ * of copying it to the host. 0 means never.
+ */
+PHI_DEFINE_EXPORTED_int32(pir_if_select_on_device_max_ops,
+                          0,
+                          "The max number of the ops of the branches of an if "
+                          "op selected on the device, 0 means never.");
+
 PHI_DEFINE_EXPORTED_string(
     ir_inplace_kernel_blacklist,
     "",
@@ -1405,6 +2019,48 @@ PHI_DEFINE_EXPORTED_string(
     "",
     "Specify the directory of saving PIR sugraph from @to_static.");
 
+/**
+ * The weight dtype of fused_weight_only_linear_pass
+ * Name: fused_weight_only_linear_weight_dtype
+ * Since Version: 2.6.0
+ * Value Range: str, "int8" or "int4", default="int8"
+ * Example:
+ */
+PHI_DEFINE_EXPORTED_string(fused_weight_only_linear_weight_dtype,
+                           "int8",
+                           "The weight dtype of the weight_only_linear ops "
+                           "emitted by fused_weight_only_linear_pass.");
+
+/**
+ * The group size of fused_weight_only_linear_pass
+ * Name: fused_weight_only_linear_group_size
+ * Since Version: 2.6.0
+ * Value Range: int32, -1, 64 or 128, default=-1
+ * Example:
+ * Note: -1 quantizes the weights per channel, otherwise a scale is kept for
+ * every group_size rows of a channel, which keeps the accuracy of int4.
+ */
+PHI_DEFINE_EXPORTED_int32(fused_weight_only_linear_group_size,
+                          -1,
+                          "The group size of the weight_only_linear ops "
+                          "emitted by fused_weight_only_linear_pass.");
+
+/**
+ * The kernel corpus of the kernel benchmark
+ * Name: kernel_corpus_path
+ * Since Version: 2.6.0
+ * Value Range: str, default=""
+ * Example: "/workspace/resnet50.corpus"
+ * Note: Every distinct call of a phi kernel run by the pir executor, that is
+ * its kernel key, the dtypes and dims of its tensors and the attributes, is
+ * appended to the file as a line of the corpus, which phi_kernel_benchmark
+ * replays.
+ */
+PHI_DEFINE_EXPORTED_string(kernel_corpus_path,
+                           "",
+                           "The file to record the kernel calls into for "
+                           "phi_kernel_benchmark, empty to not record.");
+
 PHI_DEFINE_EXPORTED_bool(enable_record_memory, false, "Enable memory recorder");
 
 PHI_DEFINE_EXPORTED_bool(
@@ -1428,6 +2084,22 @@ PHI_DEFINE_EXPORTED_int32(
 
 PHI_DEFINE_EXPORTED_bool(print_ir, false, "Whether print ir debug str.");
 
+/**
+ * Prim related FLAG
+ * Name: FLAGS_prim_recompute_intermediates
+ * Since Version: 2.6
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If true, the cheap primitive ops of the forward program, like the
+ * elementwise ops the composite rules decompose into, are recomputed in the
+ * backward program from the values it keeps anyway, instead of keeping their
+ * results alive from the forward program.
+ */
+PHI_DEFINE_EXPORTED_bool(prim_recompute_intermediates,
+                         false,
+                         "Whether recompute the cheap primitive intermediates "
+                         "in backward instead of keeping them.");
+
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL) || \
     defined(PADDLE_WITH_XPU_BKCL)
 /**
@@ -1460,6 +2132,56 @@ PHI_DEFINE_EXPORTED_bool(enable_async_trace,
 
 PHI_DEFINE_EXPORTED_int32(async_trace_count, 5, "collective async trace count");
 
+/**
+ * ProcessGroupNCCL related FLAG
+ * Name: comm_stats_interval
+ * Since Version:
+ * Value Range: int32, default=0
+ * Example:
+ * Note: With FLAGS_enable_async_trace, the bus bandwidth of the collectives
+ * is exchanged between the ranks of the groups every comm_stats_interval
+ * seconds, to find the ranks and the links slower than the others. 0
+ * disables it.
+ */
+PHI_DEFINE_EXPORTED_int32(comm_stats_interval,
+                          0,
+                          "the interval in seconds the comm stats are "
+                          "exchanged between the ranks, 0 disables them");
+
+PHI_DEFINE_EXPORTED_double(
+    comm_straggler_ratio,
+    0.8,
+    "a rank or a link is slow in an interval if its bus bandwidth is below "
+    "the ratio of the median of the group");
+
+PHI_DEFINE_EXPORTED_int32(
+    comm_straggler_patience,
+    3,
+    "a rank or a link is flagged after it is slow in the consecutive "
+    "intervals of the number");
+
+/**
+ * ProcessGroupGloo related FLAG
+ * Name: gloo_performance_mode
+ * Since Version:
+ * Value Range: bool, default=false
+ * Example:
+ * Note: The allreduce of gloo goes through the shared memory between the
+ * ranks of a host instead of the tcp loopback, and only the first rank of
+ * every host allreduces through the network. Every rank maps
+ * gloo_shm_buffer_size bytes of the shared memory of its host.
+ */
+PHI_DEFINE_EXPORTED_bool(gloo_performance_mode,
+                         false,
+                         "allreduce through the shared memory between the "
+                         "ranks of a host in gloo");
+
+PHI_DEFINE_EXPORTED_int64(
+    gloo_shm_buffer_size,
+    4 * 1024 * 1024,
+    "the bytes of the shared memory of every rank in the performance mode of "
+    "gloo, the larger tensors are allreduced in chunks of it");
+
 PHI_DEFINE_EXPORTED_bool(
     use_auto_growth_pinned_allocator,
     false,
@@ -0,0 +1,452 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/core/kernel_corpus.h"
+
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <unordered_set>
+
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_string(kernel_corpus_path);
+
+namespace phi {
+
+namespace {
+
+const std::vector<DataType>& CorpusDataTypes() {
+  static const std::vector<DataType> dtypes = {DataType::BOOL,
+                                               DataType::INT8,
+                                               DataType::UINT8,
+                                               DataType::INT16,
+                                               DataType::UINT16,
+                                               DataType::INT32,
+                                               DataType::UINT32,
+                                               DataType::INT64,
+                                               DataType::UINT64,
+                                               DataType::BFLOAT16,
+                                               DataType::FLOAT16,
+                                               DataType::FLOAT32,
+                                               DataType::FLOAT64,
+                                               DataType::COMPLEX64,
+                                               DataType::COMPLEX128,
+                                               DataType::FLOAT8_E4M3FN,
+                                               DataType::FLOAT8_E5M2};
+  return dtypes;
+}
+
+std::string DataTypeToken(DataType dtype) {
+  return dtype == DataType::UNDEFINED ? "undefined" : DataTypeToString(dtype);
+}
+
+DataType ParseDataType(const std::string& str) {
+  if (str == "undefined") {
+    return DataType::UNDEFINED;
+  }
+  for (auto dtype : CorpusDataTypes()) {
+    if (DataTypeToString(dtype) == str) {
+      return dtype;
+    }
+  }
+  PADDLE_THROW(
+      phi::errors::InvalidArgument("Unknown data type %s in the corpus.", str));
+}
+
+// the tokens which StringToDataLayout parses back
+std::string LayoutToken(DataLayout layout) {
+  switch (layout) {
+    case DataLayout::ANY:
+      return "ANYLAYOUT";
+    case DataLayout::ONEDNN:
+      return "MKLDNNLAYOUT";
+    default:
+      return common::DataLayoutToString(layout);
+  }
+}
+
+// the tokens which StringToBackend parses back
+std::string BackendToken(Backend backend) {
+  switch (backend) {
+    case Backend::UNDEFINED:
+      return "Undefined";
+    case Backend::ONEDNN:
+      return "OneDNN";
+    case Backend::CUSTOM:
+      return "Custom";
+    default:
+      return paddle::experimental::BackendToString(backend);
+  }
+}
+
+std::vector<std::string> Split(const std::string& str, char sep) {
+  std::vector<std::string> pieces;
+  std::stringstream ss(str);
+  std::string piece;
+  while (std::getline(ss, piece, sep)) {
+    pieces.push_back(piece);
+  }
+  return pieces;
+}
+
+std::vector<std::string> SplitSpaces(const std::string& str) {
+  std::vector<std::string> tokens;
+  std::stringstream ss(str);
+  std::string token;
+  while (ss >> token) {
+    tokens.push_back(token);
+  }
+  return tokens;
+}
+
+// The items of a list in brackets.
+std::vector<std::string> ParseList(const std::string& str) {
+  PADDLE_ENFORCE_EQ(
+      str.size() >= 2 && str.front() == '[' && str.back() == ']',
+      true,
+      phi::errors::InvalidArgument("%s is not a list in the corpus.", str));
+  return Split(str.substr(1, str.size() - 2), ',');
+}
+
+std::string ParseString(const std::string& str) {
+  PADDLE_ENFORCE_EQ(
+      str.size() >= 2 && str.front() == '"' && str.back() == '"',
+      true,
+      phi::errors::InvalidArgument("%s is not a string in the corpus.", str));
+  return str.substr(1, str.size() - 2);
+}
+
+bool ParseBool(const std::string& str) {
+  PADDLE_ENFORCE_EQ(
+      str == "true" || str == "false",
+      true,
+      phi::errors::InvalidArgument("%s is not a bool in the corpus.", str));
+  return str == "true";
+}
+
+std::string SerializeTensor(const KernelCorpusTensor& tensor) {
+  if (!tensor.defined) {
+    return "-";
+  }
+  std::stringstream ss;
+  ss << DataTypeToken(tensor.dtype) << '[';
+  for (size_t i = 0; i < tensor.dims.size(); ++i) {
+    ss << (i > 0 ? "," : "") << tensor.dims[i];
+  }
+  ss << ']';
+  return ss.str();
+}
+
+KernelCorpusTensor ParseTensor(const std::string& str) {
+  KernelCorpusTensor tensor;
+  if (str == "-") {
+    return tensor;
+  }
+  auto pos = str.find('[');
+  PADDLE_ENFORCE_NE(
+      pos,
+      std::string::npos,
+      phi::errors::InvalidArgument("%s is not a tensor in the corpus.", str));
+  tensor.defined = true;
+  tensor.dtype = ParseDataType(str.substr(0, pos));
+  for (auto& dim : ParseList(str.substr(pos))) {
+    tensor.dims.push_back(std::stoll(dim));
+  }
+  return tensor;
+}
+
+// Writes an attribute of a kernel context, returns false for the ones the
+// corpus can not hold.
+struct AttributeWriter {
+  std::ostream* os;
+
+  bool operator()(bool value) const {
+    *os << (value ? "true" : "false");
+    return true;
+  }
+  bool operator()(int value) const {
+    *os << value;
+    return true;
+  }
+  bool operator()(int64_t value) const {
+    *os << value;
+    return true;
+  }
+  bool operator()(float value) const {
+    *os << value;
+    return true;
+  }
+  bool operator()(double value) const {
+    *os << value;
+    return true;
+  }
+  bool operator()(const std::string& value) const {
+    for (char c : value) {
+      if (std::isspace(static_cast<unsigned char>(c)) || c == '|' ||
+          c == '"' || c == ',') {
+        return false;
+      }
+    }
+    *os << '"' << value << '"';
+    return true;
+  }
+  bool operator()(const Scalar& value) const {
+    if (value.dtype() == DataType::COMPLEX64 ||
+        value.dtype() == DataType::COMPLEX128) {
+      return false;
+    }
+    *os << value.to<double>();
+    return true;
+  }
+  bool operator()(const IntArray& value) const {
+    return (*this)(value.GetData());
+  }
+  bool operator()(DataType value) const {
+    *os << DataTypeToken(value);
+    return true;
+  }
+  bool operator()(DataLayout value) const {
+    *os << LayoutToken(value);
+    return true;
+  }
+  bool operator()(const Place& value) const {
+    // replayed on the place of the kernel
+    *os << "place";
+    return true;
+  }
+  bool operator()(const TensorRef& value) const { return false; }
+  bool operator()(const std::vector<TensorRef>& value) const { return false; }
+
+  template <typename T>
+  bool operator()(const std::vector<T>& values) const {
+    *os << '[';
+    for (size_t i = 0; i < values.size(); ++i) {
+      *os << (i > 0 ? "," : "");
+      if (!(*this)(static_cast<T>(values[i]))) {
+        return false;
+      }
+    }
+    *os << ']';
+    return true;
+  }
+};
+
+template <typename T, typename Fn>
+std::vector<T> ParseListOf(const std::string& str, Fn&& parse) {
+  std::vector<T> values;
+  for (auto& item : ParseList(str)) {
+    values.push_back(parse(item));
+  }
+  return values;
+}
+
+}  // namespace
+
+std::string SerializeKernelCorpusEntry(const KernelCorpusEntry& entry) {
+  std::stringstream ss;
+  ss << entry.kernel_name << ' ' << BackendToken(entry.kernel_key.backend())
+     << ' ' << LayoutToken(entry.kernel_key.layout()) << ' '
+     << DataTypeToken(entry.kernel_key.dtype()) << " |";
+  for (auto& input : entry.inputs) {
+    ss << ' ' << SerializeTensor(input);
+  }
+  ss << " |";
+  for (auto& output : entry.outputs) {
+    ss << ' ' << SerializeTensor(output);
+  }
+  ss << " |";
+  for (auto& attr : entry.attrs) {
+    ss << ' ' << attr;
+  }
+  return ss.str();
+}
+
+KernelCorpusEntry ParseKernelCorpusEntry(const std::string& line) {
+  auto fields = Split(line, '|');
+  PADDLE_ENFORCE_GE(
+      fields.size(),
+      3UL,
+      phi::errors::InvalidArgument(
+          "A line of the kernel corpus should be kernel_name backend layout "
+          "dtype | inputs | outputs | attributes, but received %s.",
+          line));
+  auto key = SplitSpaces(fields[0]);
+  PADDLE_ENFORCE_EQ(key.size(),
+                    4UL,
+                    phi::errors::InvalidArgument(
+                        "The kernel of a line of the kernel corpus should be "
+                        "kernel_name backend layout dtype, but received %s.",
+                        fields[0]));
+
+  KernelCorpusEntry entry;
+  entry.kernel_name = key[0];
+  entry.kernel_key =
+      KernelKey(paddle::experimental::StringToBackend(key[1].c_str()),
+                common::StringToDataLayout(key[2]),
+                ParseDataType(key[3]));
+  for (auto& input : SplitSpaces(fields[1])) {
+    entry.inputs.push_back(ParseTensor(input));
+  }
+  for (auto& output : SplitSpaces(fields[2])) {
+    entry.outputs.push_back(ParseTensor(output));
+  }
+  if (fields.size() > 3) {
+    entry.attrs = SplitSpaces(fields[3]);
+  }
+  return entry;
+}
+
+bool MakeKernelCorpusEntry(const std::string& kernel_name,
+                           const KernelKey& kernel_key,
+                           const Kernel& kernel,
+                           const KernelContext& ctx,
+                           KernelCorpusEntry* entry) {
+  const auto& args_def = kernel.args_def();
+  if (args_def.input_defs().size() != ctx.InputsSize() ||
+      args_def.output_defs().size() != ctx.OutputsSize() ||
+      args_def.attribute_defs().size() != ctx.AttrsSize()) {
+    return false;
+  }
+  auto make_tensor = [](const TensorBase* tensor, KernelCorpusTensor* out) {
+    if (tensor == nullptr || !tensor->initialized()) {
+      return true;
+    }
+    if (!DenseTensor::classof(tensor)) {
+      return false;
+    }
+    out->defined = true;
+    out->dtype = tensor->dtype();
+    out->dims = common::vectorize(tensor->dims());
+    return true;
+  };
+
+  entry->kernel_name = kernel_name;
+  entry->kernel_key = kernel_key;
+  auto& mutable_ctx = const_cast<KernelContext&>(ctx);
+  entry->inputs.resize(ctx.InputsSize());
+  for (size_t i = 0; i < ctx.InputsSize(); ++i) {
+    const auto& type_index = args_def.input_defs()[i].type_index;
+    if ((type_index != std::type_index(typeid(const DenseTensor&)) &&
+         type_index !=
+             std::type_index(typeid(const paddle::optional<DenseTensor>&))) ||
+        !make_tensor(mutable_ctx.InputsBetween<TensorBase>(i, i + 1)[0],
+                     &entry->inputs[i])) {
+      return false;
+    }
+  }
+  entry->outputs.resize(ctx.OutputsSize());
+  for (size_t i = 0; i < ctx.OutputsSize(); ++i) {
+    if (args_def.output_defs()[i].type_index !=
+            std::type_index(typeid(DenseTensor*)) ||
+        !make_tensor(mutable_ctx.MutableOutputAt(i), &entry->outputs[i])) {
+      return false;
+    }
+  }
+  entry->attrs.resize(ctx.AttrsSize());
+  for (size_t i = 0; i < ctx.AttrsSize(); ++i) {
+    std::stringstream ss;
+    ss.precision(std::numeric_limits<double>::max_digits10);
+    if (!paddle::visit(AttributeWriter{&ss}, ctx.AttrAt(i))) {
+      return false;
+    }
+    entry->attrs[i] = ss.str();
+  }
+  return true;
+}
+
+Attribute ParseKernelCorpusAttribute(const std::string& str,
+                                     AttributeType type,
+                                     const Place& place) {
+  auto to_int = [](const std::string& s) { return std::stoi(s); };
+  auto to_int64 = [](const std::string& s) {
+    return static_cast<int64_t>(std::stoll(s));
+  };
+  auto to_float = [](const std::string& s) { return std::stof(s); };
+  auto to_double = [](const std::string& s) { return std::stod(s); };
+  switch (type) {
+    case AttributeType::BOOL:
+      return ParseBool(str);
+    case AttributeType::INT32:
+      return to_int(str);
+    case AttributeType::INT64:
+      return to_int64(str);
+    case AttributeType::FLOAT32:
+      return to_float(str);
+    case AttributeType::FLOAT64:
+      return to_double(str);
+    case AttributeType::STRING:
+      return ParseString(str);
+    case AttributeType::BOOLS:
+      return ParseListOf<bool>(str, ParseBool);
+    case AttributeType::INT32S:
+      return ParseListOf<int>(str, to_int);
+    case AttributeType::INT64S:
+      return ParseListOf<int64_t>(str, to_int64);
+    case AttributeType::FLOAT32S:
+      return ParseListOf<float>(str, to_float);
+    case AttributeType::FLOAT64S:
+      return ParseListOf<double>(str, to_double);
+    case AttributeType::STRINGS:
+      return ParseListOf<std::string>(str, ParseString);
+    case AttributeType::SCALAR:
+      return Scalar(to_double(str));
+    case AttributeType::SCALARS:
+      return ParseListOf<Scalar>(
+          str, [&](const std::string& s) { return Scalar(to_double(s)); });
+    case AttributeType::INT_ARRAY:
+      return IntArray(ParseListOf<int64_t>(str, to_int64));
+    case AttributeType::DATA_TYPE:
+      return ParseDataType(str);
+    case AttributeType::DATA_LAYOUT:
+      return common::StringToDataLayout(str);
+    case AttributeType::PLACE:
+      return place;
+    default:
+      PADDLE_THROW(phi::errors::Unimplemented(
+          "The attribute type %d is not supported by the kernel corpus.",
+          static_cast<int>(type)));
+  }
+}
+
+void RecordKernelCorpus(const std::string& kernel_name,
+                        const KernelKey& kernel_key,
+                        const Kernel& kernel,
+                        const KernelContext& ctx) {
+  KernelCorpusEntry entry;
+  if (!MakeKernelCorpusEntry(kernel_name, kernel_key, kernel, ctx, &entry)) {
+    VLOG(4) << "The kernel corpus can not record the call of " << kernel_name;
+    return;
+  }
+  auto line = SerializeKernelCorpusEntry(entry);
+
+  static std::mutex mutex;
+  static std::unordered_set<std::string> recorded;
+  std::lock_guard<std::mutex> guard(mutex);
+  if (!recorded.insert(line).second) {
+    return;
+  }
+  std::ofstream file(FLAGS_kernel_corpus_path, std::ios::app);
+  PADDLE_ENFORCE_EQ(file.is_open(),
+                    true,
+                    phi::errors::Unavailable("Can not open %s to record the "
+                                             "kernel corpus.",
+                                             FLAGS_kernel_corpus_path));
+  file << line << '\n';
+}
+
+}  // namespace phi
@@ -0,0 +1,74 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "paddle/phi/core/attribute.h"
+#include "paddle/phi/core/kernel_context.h"
+#include "paddle/phi/core/kernel_factory.h"
+
+namespace phi {
+
+// A tensor of a kernel call, undefined for a missing optional input.
+struct KernelCorpusTensor {
+  bool defined{false};
+  DataType dtype{DataType::UNDEFINED};
+  std::vector<int64_t> dims;
+};
+
+/**
+ * A kernel call of the kernel corpus replayed by phi_kernel_benchmark, which
+ * is a line of
+ *
+ *   kernel_name backend layout dtype | inputs | outputs | attributes
+ *
+ * e.g. "sum GPU NCHW float32 | float32[32,1024] | float32[32] | [1] float32
+ * false", where a missing optional input is "-" and the attributes are in
+ * the order of the kernel arguments, with the lists in brackets.
+ */
+struct KernelCorpusEntry {
+  std::string kernel_name;
+  KernelKey kernel_key;
+  std::vector<KernelCorpusTensor> inputs;
+  std::vector<KernelCorpusTensor> outputs;
+  std::vector<std::string> attrs;
+};
+
+std::string SerializeKernelCorpusEntry(const KernelCorpusEntry& entry);
+
+KernelCorpusEntry ParseKernelCorpusEntry(const std::string& line);
+
+// The entry of a kernel call, false if the corpus can not hold it, that is a
+// tensor is not a DenseTensor or a list, or an attribute is a tensor.
+bool MakeKernelCorpusEntry(const std::string& kernel_name,
+                           const KernelKey& kernel_key,
+                           const Kernel& kernel,
+                           const KernelContext& ctx,
+                           KernelCorpusEntry* entry);
+
+// The attribute of type in str, where a place is the place of the kernel.
+Attribute ParseKernelCorpusAttribute(const std::string& str,
+                                     AttributeType type,
+                                     const Place& place);
+
+// Appends the kernel call to FLAGS_kernel_corpus_path unless it is there.
+void RecordKernelCorpus(const std::string& kernel_name,
+                        const KernelKey& kernel_key,
+                        const Kernel& kernel,
+                        const KernelContext& ctx);
+
+}  // namespace phi
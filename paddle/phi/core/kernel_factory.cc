@@ -61,7 +61,47 @@ KernelFactory& KernelFactory::Instance() {
   return g_op_kernel_factory;
 }
 
+void KernelFactory::AddPendingKernel(PendingKernel&& kernel) {
+  std::lock_guard<std::mutex> guard(pending_mutex_);
+  if (materialized_.load(std::memory_order_relaxed)) {
+    ConstructKernel(kernel);
+    generation_.fetch_add(1, std::memory_order_release);
+  } else {
+    pending_kernels_.emplace_back(std::move(kernel));
+  }
+}
+
+void KernelFactory::ConstructPendingKernels() {
+  std::lock_guard<std::mutex> guard(pending_mutex_);
+  if (materialized_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  VLOG(3) << "Construct the " << pending_kernels_.size()
+          << " registered kernels.";
+  // in the order of the registrations, the later one of a kernel key wins
+  for (const auto& pending : pending_kernels_) {
+    ConstructKernel(pending);
+  }
+  std::vector<PendingKernel>().swap(pending_kernels_);
+  generation_.fetch_add(1, std::memory_order_release);
+  materialized_.store(true, std::memory_order_release);
+}
+
+void KernelFactory::ConstructKernel(const PendingKernel& pending) {
+  KernelKey kernel_key(
+      paddle::experimental::StringToBackend(pending.backend.c_str()),
+      pending.layout,
+      pending.dtype);
+  Kernel kernel(pending.kernel_fn, pending.variadic_kernel_fn);
+  if (kernel.GetKernelRegisteredType() == KernelRegisteredType::FUNCTION) {
+    pending.args_parse_fn(kernel_key, kernel.mutable_args_def());
+  }
+  pending.args_def_fn(kernel_key, &kernel);
+  kernels_[pending.kernel_name][kernel_key] = kernel;
+}
+
 bool KernelFactory::HasCompatiblePhiKernel(const std::string& op_type) const {
+  MaterializeKernels();
   if (deprecated_op_names.find(op_type) == deprecated_op_names.end()) {
     if (phi::OpUtilsMap::Instance().Contains(op_type) ||
         (kernels_.find(op_type) != kernels_.end())) {
@@ -72,6 +112,7 @@ bool KernelFactory::HasCompatiblePhiKernel(const std::string& op_type) const {
 }
 
 bool KernelFactory::HasStructuredKernel(const std::string& op_type) const {
+  MaterializeKernels();
   auto phi_kernel_name = phi::OpUtilsMap::Instance().GetBaseKernelName(op_type);
   auto kernel_iter = kernels_.find(phi_kernel_name);
   if (deprecated_op_names.find(op_type) == deprecated_op_names.end() &&
@@ -88,6 +129,7 @@ bool KernelFactory::HasStructuredKernel(const std::string& op_type) const {
 
 const Kernel& KernelFactory::SelectKernel(const std::string& kernel_name,
                                           const KernelKey& kernel_key) const {
+  MaterializeKernels();
   auto iter = kernels_.find(kernel_name);
   if (iter == kernels_.end()) {
     return empty_kernel;
@@ -119,6 +161,7 @@ const Kernel& KernelFactory::SelectKernel(const std::string& kernel_name,
 
 const Kernel& KernelFactory::SelectKernelWithGPUDNN(
     const std::string& kernel_name, const KernelKey& const_kernel_key) const {
+  MaterializeKernels();
   auto iter = kernels_.find(kernel_name);
   if (iter == kernels_.end()) {
     return empty_kernel;
@@ -162,6 +205,7 @@ const Kernel& KernelFactory::SelectKernelWithGPUDNN(
 
 KernelKeyMap KernelFactory::SelectKernelMap(
     const std::string& kernel_name) const {
+  MaterializeKernels();
   auto iter = kernels_.find(kernel_name);
   if (iter == kernels_.end()) {
     return KernelKeyMap();
@@ -171,6 +215,7 @@ KernelKeyMap KernelFactory::SelectKernelMap(
 
 bool KernelFactory::HasKernel(const std::string& kernel_name,
                               const KernelKey& kernel_key) const {
+  MaterializeKernels();
   auto iter = kernels_.find(kernel_name);
   PADDLE_ENFORCE_NE(
       iter,
@@ -217,6 +262,7 @@ KernelResult KernelFactory::SelectKernelOrThrowError(
     const std::string& kernel_name,
     const KernelKey& const_kernel_key,
     bool use_strided_kernel) const {
+  MaterializeKernels();
   auto iter = kernels_.find(kernel_name);
 
   PADDLE_ENFORCE_NE(
@@ -343,8 +389,59 @@ KernelResult KernelFactory::SelectKernelOrThrowError(
   return {kernel_iter->second, false, false};
 }
 
+namespace {
+
+// The flags which the selection of SelectKernelOrThrowError depends on.
+uint32_t KernelSelectionFlags(bool use_strided_kernel) {
+  uint32_t flags = 0;
+  flags |= (FLAGS_use_stride_kernel && use_strided_kernel) ? 1U : 0U;
+  flags |= FLAGS_enable_api_kernel_fallback ? 2U : 0U;
+#if defined(PADDLE_WITH_XPU_KP)
+  flags |= FLAGS_run_kp_kernel ? 4U : 0U;
+#endif
+  return flags;
+}
+
+}  // namespace
+
+KernelResult KernelSelectionCache::SelectKernelOrThrowError(
+    const KernelKey& kernel_key, bool use_strided_kernel) {
+  auto& factory = KernelFactory::Instance();
+  // the kernels held may be moved by the changes of the kernels
+  uint64_t generation = factory.generation();
+  if (generation != generation_) {
+    generation_ = generation;
+    size_ = 0;
+    next_ = 0;
+  }
+  uint32_t flags = KernelSelectionFlags(use_strided_kernel);
+  for (size_t i = 0; i < size_; ++i) {
+    const Entry& entry = entries_[i];
+    if (entry.kernel_key == kernel_key && entry.flags == flags) {
+      return {*entry.kernel, entry.has_fallback_cpu, entry.is_stride_kernel};
+    }
+  }
+
+  auto result = factory.SelectKernelOrThrowError(
+      kernel_name_, kernel_key, use_strided_kernel);
+  Entry* entry = nullptr;
+  if (size_ < kCapacity) {
+    entry = &entries_[size_++];
+  } else {
+    entry = &entries_[next_];
+    next_ = (next_ + 1) % kCapacity;
+  }
+  entry->kernel_key = kernel_key;
+  entry->flags = flags;
+  entry->kernel = &result.kernel;
+  entry->has_fallback_cpu = result.has_fallback_cpu;
+  entry->is_stride_kernel = result.is_stride_kernel;
+  return result;
+}
+
 const KernelArgsDef& KernelFactory::GetFirstKernelArgsDef(
     const std::string& kernel_name) const {
+  MaterializeKernels();
   auto iter = kernels_.find(kernel_name);
   PADDLE_ENFORCE_NE(
       iter,
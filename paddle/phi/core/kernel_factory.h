@@ -14,10 +14,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <ostream>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include "paddle/common/layout.h"
 #include "paddle/phi/common/backend.h"
 #include "paddle/phi/common/data_type.h"
@@ -305,6 +308,23 @@ struct KernelResult {
   bool is_stride_kernel = false;
 };
 
+/**
+ * Note: PendingKernel is a kernel registered by PD_REGISTER_KERNEL, which is
+ *       only recorded in the static initialization and constructed at the
+ *       first lookup of the kernels, since parsing the arguments of the
+ *       thousands of kernels dominates the startup of the library.
+ */
+struct PendingKernel {
+  const char* kernel_name;  // a literal of the registration macros
+  std::string backend;      // may be the name of a plugged custom device
+  DataLayout layout;
+  DataType dtype;
+  KernelArgsParseFn args_parse_fn;
+  KernelArgsDefFn args_def_fn;
+  KernelFn kernel_fn;
+  void* variadic_kernel_fn;
+};
+
 /**
  * Note: Each Computation need a basic kernel map that named by kernel_name.
  *       Such as for scale op, KernelMap contains a `scale` kernel map,
@@ -315,7 +335,22 @@ class KernelFactory {
  public:
   static KernelFactory& Instance();
 
-  KernelNameMap& kernels() { return kernels_; }
+  KernelNameMap& kernels() {
+    MaterializeKernels();
+    // the kernels may be changed through the map returned
+    generation_.fetch_add(1, std::memory_order_release);
+    return kernels_;
+  }
+
+  // Records a kernel to construct at the first lookup of the kernels, or
+  // constructs it if the kernels are looked up already.
+  void AddPendingKernel(PendingKernel&& kernel);
+
+  // The generation of the kernels, which is changed whenever the kernels may
+  // be changed, e.g. by registering the kernels of a custom device.
+  uint64_t generation() const {
+    return generation_.load(std::memory_order_acquire);
+  }
 
   bool HasCompatiblePhiKernel(const std::string& op_type) const;
 
@@ -349,12 +384,66 @@ class KernelFactory {
  private:
   KernelFactory() = default;
 
+  // Constructs the pending kernels at once before the first lookup rather
+  // than by the kernel name, since the lookups run concurrently without a
+  // lock and expect the kernels not to change under them.
+  void MaterializeKernels() const {
+    if (!materialized_.load(std::memory_order_acquire)) {
+      const_cast<KernelFactory*>(this)->ConstructPendingKernels();
+    }
+  }
+
+  void ConstructPendingKernels();
+
+  void ConstructKernel(const PendingKernel& pending);
+
   KernelNameMap kernels_;
 
+  std::mutex pending_mutex_;
+  std::vector<PendingKernel> pending_kernels_;
+  std::atomic<bool> materialized_{false};
+
+  std::atomic<uint64_t> generation_{0};
+
   // Get the low precision kernel list of current module.
   std::map<const std::string, OpCount> low_precision_kernels_;
 };
 
+/**
+ * Note: KernelSelectionCache is the inline cache of the kernels selected for
+ *       a call site of SelectKernelOrThrowError, e.g. a generated API, so
+ *       that the calls with the kernel keys seen before skip the lookups by
+ *       the kernel name and the kernel key. It holds the results of a few
+ *       kernel keys, and drops them when the generation of the kernels or the
+ *       flags of the kernel selection change. It is not thread-safe, and is
+ *       supposed to be a thread_local object of the call site.
+ */
+class KernelSelectionCache {
+ public:
+  explicit KernelSelectionCache(const char* kernel_name)
+      : kernel_name_(kernel_name) {}
+
+  KernelResult SelectKernelOrThrowError(const KernelKey& kernel_key,
+                                        bool use_strided_kernel = false);
+
+ private:
+  static constexpr size_t kCapacity = 4;
+
+  struct Entry {
+    KernelKey kernel_key;
+    uint32_t flags{0};
+    const Kernel* kernel{nullptr};
+    bool has_fallback_cpu{false};
+    bool is_stride_kernel{false};
+  };
+
+  const char* kernel_name_;
+  uint64_t generation_{0};
+  size_t size_{0};
+  size_t next_{0};
+  Entry entries_[kCapacity];
+};
+
 inline std::ostream& operator<<(std::ostream& os, const KernelKey& kernel_key) {
   os << "(" << kernel_key.backend() << ", " << kernel_key.layout() << ", "
      << kernel_key.dtype() << ")";
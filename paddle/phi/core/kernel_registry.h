@@ -136,6 +136,19 @@ struct KernelRegistrar {
                        KernelArgsDefFn args_def_fn,
                        KernelFn kernel_fn,
                        void* variadic_kernel_fn) {
+    if (reg_type == RegType::INNER) {
+      // constructed at the first lookup of the kernels
+      KernelFactory::Instance().AddPendingKernel(
+          PendingKernel{kernel_name_cstr,
+                        backend_cstr,
+                        layout,
+                        dtype,
+                        args_parse_fn,
+                        args_def_fn,
+                        std::move(kernel_fn),
+                        variadic_kernel_fn});
+      return;
+    }
     std::string kernel_name(kernel_name_cstr);
     KernelKey kernel_key(
         paddle::experimental::StringToBackend(backend_cstr), layout, dtype);
@@ -144,12 +157,8 @@ struct KernelRegistrar {
       args_parse_fn(kernel_key, kernel.mutable_args_def());
     }
     args_def_fn(kernel_key, &kernel);
-    if (reg_type == RegType::INNER) {
-      KernelFactory::Instance().kernels()[kernel_name][kernel_key] = kernel;
-    } else {
-      CustomKernelMap::Instance().RegisterCustomKernel(
-          kernel_name, kernel_key, kernel);
-    }
+    CustomKernelMap::Instance().RegisterCustomKernel(
+        kernel_name, kernel_key, kernel);
   }
 };
 
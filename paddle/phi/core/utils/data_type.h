@@ -131,7 +131,9 @@ enum ProtoDataType {
   BF16 = 22,
   COMPLEX64 = 23,
   COMPLEX128 = 24,
-  PSTRING = 29
+  PSTRING = 29,
+  FP8_E4M3FN = 32,
+  FP8_E5M2 = 33
 };
 
 inline DataType TransToPhiDataType(const int& dtype) {
@@ -164,6 +166,10 @@ inline DataType TransToPhiDataType(const int& dtype) {
       return DataType::BOOL;
     case ProtoDataType::PSTRING:
       return DataType::PSTRING;
+    case ProtoDataType::FP8_E4M3FN:
+      return DataType::FLOAT8_E4M3FN;
+    case ProtoDataType::FP8_E5M2:
+      return DataType::FLOAT8_E5M2;
     case ProtoDataType::RAW:
       return DataType::ALL_DTYPE;
     default:
@@ -201,6 +207,10 @@ inline int TransToProtoVarType(const DataType& dtype) {
       return ProtoDataType::BOOL;
     case DataType::PSTRING:
       return ProtoDataType::PSTRING;
+    case DataType::FLOAT8_E4M3FN:
+      return ProtoDataType::FP8_E4M3FN;
+    case DataType::FLOAT8_E5M2:
+      return ProtoDataType::FP8_E5M2;
     case DataType::UNDEFINED:
       return ProtoDataType::RAW;
     default:
@@ -1166,12 +1166,21 @@ void WeightOnlyLinearGradInferMeta(const MetaTensor& x,
                                    const MetaTensor& out_grad,
                                    const std::string& weight_dtype,
                                    const int32_t arch,
+                                   const int32_t group_size,
+                                   const std::string& activation,
                                    MetaTensor* x_grad) {
   PADDLE_ENFORCE_EQ(
       ((arch == 80) || (arch == 86)),
       true,
       phi::errors::InvalidArgument(
           "Currently weightonly linear grad only support arch = 80 or 86. "));
+  PADDLE_ENFORCE_EQ(
+      activation,
+      "none",
+      phi::errors::Unimplemented(
+          "Weightonly linear grad doesn't support the fused activation, but "
+          "got [%s].",
+          activation));
   x_grad->set_dims(x.dims());
   x_grad->set_dtype(x.dtype());
 }
@@ -1383,6 +1383,60 @@ void FillDiagonalTensorInferMeta(const MetaTensor& x,
   out->set_dtype(x.dtype());
 }
 
+static void CheckFp8Scale(const MetaTensor& scale, const char* op_type) {
+  PADDLE_ENFORCE_EQ(
+      scale.dtype(),
+      DataType::FLOAT32,
+      phi::errors::InvalidArgument(
+          "The scale of %s must be float32, but got %s.",
+          op_type,
+          scale.dtype()));
+  PADDLE_ENFORCE_EQ(
+      common::product(scale.dims()),
+      1,
+      phi::errors::InvalidArgument(
+          "The scale of %s must have one element, but got shape [%s].",
+          op_type,
+          scale.dims()));
+}
+
+void Fp8DequantizeInferMeta(const MetaTensor& x,
+                            const MetaTensor& scale,
+                            DataType out_dtype,
+                            MetaTensor* out) {
+  CheckFp8Scale(scale, "fp8_dequantize");
+  PADDLE_ENFORCE_EQ(
+      out_dtype == DataType::FLOAT32 || out_dtype == DataType::FLOAT16 ||
+          out_dtype == DataType::BFLOAT16,
+      true,
+      phi::errors::InvalidArgument("The out_dtype of fp8_dequantize must be "
+                                   "float32, float16 or bfloat16, but got %s.",
+                                   out_dtype));
+  out->set_dims(x.dims());
+  out->set_dtype(out_dtype);
+  out->share_lod(x);
+}
+
+void Fp8QuantizeInferMeta(const MetaTensor& x,
+                          const MetaTensor& scale,
+                          DataType out_dtype,
+                          MetaTensor* out,
+                          MetaTensor* amax) {
+  CheckFp8Scale(scale, "fp8_quantize");
+  PADDLE_ENFORCE_EQ(
+      out_dtype == DataType::FLOAT8_E4M3FN ||
+          out_dtype == DataType::FLOAT8_E5M2,
+      true,
+      phi::errors::InvalidArgument("The out_dtype of fp8_quantize must be "
+                                   "float8_e4m3fn or float8_e5m2, but got %s.",
+                                   out_dtype));
+  out->set_dims(x.dims());
+  out->set_dtype(out_dtype);
+  out->share_lod(x);
+  amax->set_dims(common::make_ddim({1}));
+  amax->set_dtype(DataType::FLOAT32);
+}
+
 void FusedDropoutAddInferMeta(const MetaTensor& x,
                               const MetaTensor& y,
                               MetaTensor* out,
@@ -3285,12 +3339,41 @@ void WeightDequantizeInferMeta(const MetaTensor& x,
                                const MetaTensor& scale,
                                const std::string& algo,
                                DataType out_dtype,
+                               const int32_t group_size,
                                MetaTensor* out) {
   PADDLE_ENFORCE_EQ(x.dims().size(),
                     2UL,
                     phi::errors::InvalidArgument(
                         "The x tensor of dequantize op must be 2D, but got[%d]",
                         x.dims().size()));
+  if (group_size > 0) {
+    // the grouped scale is [k / group_size, n]
+    PADDLE_ENFORCE_EQ(
+        group_size == 64 || group_size == 128,
+        true,
+        phi::errors::InvalidArgument(
+            "The group_size of dequantize op must be 64 or 128, but got[%d]",
+            group_size));
+    PADDLE_ENFORCE_EQ(
+        scale.dims().size(),
+        2UL,
+        phi::errors::InvalidArgument(
+            "The grouped scale tensor of dequantize op must be 2D, but got[%d]",
+            scale.dims().size()));
+    int64_t n = algo == "weight_only_int4" ? x.dims()[0] * 2 : x.dims()[0];
+    int64_t k = x.dims()[1];
+    PADDLE_ENFORCE_EQ(
+        scale.dims()[0] * group_size == k && scale.dims()[1] == n,
+        true,
+        phi::errors::InvalidArgument(
+            "The grouped scale tensor's shape must be [%d, %d], but got [%s]",
+            k / group_size,
+            n,
+            scale.dims()));
+    out->set_dims(common::make_ddim({k, n}));
+    out->set_dtype(out_dtype);
+    return;
+  }
   PADDLE_ENFORCE_EQ(
       scale.dims().size(),
       1UL,
@@ -238,6 +238,17 @@ void FillDiagonalTensorInferMeta(const MetaTensor& x,
                                  int dim2,
                                  MetaTensor* out);
 
+void Fp8DequantizeInferMeta(const MetaTensor& x,
+                            const MetaTensor& scale,
+                            DataType out_dtype,
+                            MetaTensor* out);
+
+void Fp8QuantizeInferMeta(const MetaTensor& x,
+                          const MetaTensor& scale,
+                          DataType out_dtype,
+                          MetaTensor* out,
+                          MetaTensor* amax);
+
 void FusedDropoutAddInferMeta(const MetaTensor& x,
                               const MetaTensor& y,
                               MetaTensor* out,
@@ -514,6 +525,7 @@ void WeightDequantizeInferMeta(const MetaTensor& x,
                                const MetaTensor& scale,
                                const std::string& algo,
                                DataType out_dtype,
+                               const int32_t group_size,
                                MetaTensor* out);
 
 }  // namespace phi
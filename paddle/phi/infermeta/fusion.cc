@@ -3525,4 +3525,322 @@ void VariableLengthMemoryEfficientAttentionInferMeta(
   out->set_layout(query.layout());
 }
 
+void Fp8LinearInferMeta(const MetaTensor& x,
+                        const MetaTensor& weight,
+                        const MetaTensor& bias,
+                        const MetaTensor& x_amax_history,
+                        const MetaTensor& weight_amax_history,
+                        float margin,
+                        MetaTensor* out,
+                        MetaTensor* x_amax_history_out,
+                        MetaTensor* weight_amax_history_out,
+                        MetaConfig config) {
+  const auto& x_dims = x.dims();
+  const auto& w_dims = weight.dims();
+  PADDLE_ENFORCE_GE(
+      x_dims.size(),
+      2,
+      phi::errors::InvalidArgument(
+          "The rank of Input(x) of fp8_linear must be at least 2, but got %d.",
+          x_dims.size()));
+  PADDLE_ENFORCE_EQ(
+      w_dims.size(),
+      2,
+      phi::errors::InvalidArgument(
+          "The Input(weight) of fp8_linear must be 2D, but got shape [%s].",
+          w_dims));
+  PADDLE_ENFORCE_EQ(
+      x.dtype() == DataType::FLOAT16 || x.dtype() == DataType::BFLOAT16,
+      true,
+      phi::errors::InvalidArgument(
+          "The Input(x) of fp8_linear must be float16 or bfloat16, but got %s.",
+          x.dtype()));
+  PADDLE_ENFORCE_EQ(
+      weight.dtype(),
+      x.dtype(),
+      phi::errors::InvalidArgument(
+          "The Input(weight) of fp8_linear must be %s as Input(x), but got %s.",
+          x.dtype(),
+          weight.dtype()));
+
+  const int64_t k = w_dims[0];
+  const int64_t n = w_dims[1];
+  if (config.is_runtime || (x_dims[x_dims.size() - 1] > 0 && k > 0)) {
+    PADDLE_ENFORCE_EQ(
+        x_dims[x_dims.size() - 1],
+        k,
+        phi::errors::InvalidArgument(
+            "The last dim of Input(x) of fp8_linear must be equal to the "
+            "first dim of Input(weight), but got %d and %d.",
+            x_dims[x_dims.size() - 1],
+            k));
+  }
+  // the fp8 gemm of cuBLASLt requires the leading dims aligned to 16
+  if (k > 0 && n > 0) {
+    PADDLE_ENFORCE_EQ(
+        k % 16 == 0 && n % 16 == 0,
+        true,
+        phi::errors::InvalidArgument(
+            "The shape of Input(weight) of fp8_linear must be multiples of "
+            "16, but got [%s].",
+            w_dims));
+  }
+  if (bias) {
+    PADDLE_ENFORCE_EQ(
+        bias.dims().size() == 1 && (n < 0 || bias.dims()[0] == n),
+        true,
+        phi::errors::InvalidArgument(
+            "The Input(bias) of fp8_linear must be [%d], but got [%s].",
+            n,
+            bias.dims()));
+  }
+
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(x_amax_history),
+      static_cast<bool>(weight_amax_history),
+      phi::errors::InvalidArgument(
+          "The amax histories of fp8_linear must be both given for the "
+          "delayed scaling, or both absent for the current scaling."));
+  if (x_amax_history) {
+    for (const MetaTensor* history : {&x_amax_history, &weight_amax_history}) {
+      PADDLE_ENFORCE_EQ(
+          history->dtype() == DataType::FLOAT32 && history->dims().size() == 1,
+          true,
+          phi::errors::InvalidArgument(
+              "The amax histories of fp8_linear must be 1D float32 tensors, "
+              "but got %s [%s].",
+              history->dtype(),
+              history->dims()));
+    }
+    x_amax_history_out->share_meta(x_amax_history);
+    weight_amax_history_out->share_meta(weight_amax_history);
+  }
+
+  auto out_dims = x_dims;
+  out_dims[out_dims.size() - 1] = n;
+  out->set_dims(out_dims);
+  out->set_dtype(x.dtype());
+  out->share_lod(x);
+}
+
+void Fp8LinearGradInferMeta(const MetaTensor& x,
+                            const MetaTensor& weight,
+                            const MetaTensor& bias,
+                            const MetaTensor& out_grad,
+                            MetaTensor* x_grad,
+                            MetaTensor* weight_grad,
+                            MetaTensor* bias_grad) {
+  if (x_grad) {
+    x_grad->share_meta(x);
+  }
+  if (weight_grad) {
+    weight_grad->share_meta(weight);
+  }
+  if (bias_grad && bias) {
+    bias_grad->share_meta(bias);
+  }
+}
+
+void FusedGroupedGemmInferMeta(const MetaTensor& x,
+                               const MetaTensor& weight,
+                               const MetaTensor& bias,
+                               const MetaTensor& expert_offsets,
+                               const std::string& act_type,
+                               MetaTensor* out,
+                               MetaConfig config) {
+  const auto& x_dims = x.dims();
+  const auto& w_dims = weight.dims();
+  PADDLE_ENFORCE_EQ(
+      x_dims.size(),
+      2,
+      phi::errors::InvalidArgument(
+          "The Input(x) of fused_grouped_gemm must be 2D, but got shape [%s].",
+          x_dims));
+  PADDLE_ENFORCE_EQ(w_dims.size(),
+                    3,
+                    phi::errors::InvalidArgument(
+                        "The Input(weight) of fused_grouped_gemm must be 3D "
+                        "[num_experts, k, n], but got shape [%s].",
+                        w_dims));
+  PADDLE_ENFORCE_EQ(
+      x.dtype() == DataType::FLOAT32 || x.dtype() == DataType::FLOAT16,
+      true,
+      phi::errors::InvalidArgument("The Input(x) of fused_grouped_gemm must "
+                                   "be float32 or float16, but got %s.",
+                                   x.dtype()));
+  PADDLE_ENFORCE_EQ(weight.dtype(),
+                    x.dtype(),
+                    phi::errors::InvalidArgument(
+                        "The Input(weight) of fused_grouped_gemm must be %s "
+                        "as Input(x), but got %s.",
+                        x.dtype(),
+                        weight.dtype()));
+  PADDLE_ENFORCE_EQ(expert_offsets.dtype(),
+                    DataType::INT64,
+                    phi::errors::InvalidArgument(
+                        "The Input(expert_offsets) of fused_grouped_gemm must "
+                        "be int64, but got %s.",
+                        expert_offsets.dtype()));
+  PADDLE_ENFORCE_EQ(
+      act_type == "none" || act_type == "relu" || act_type == "gelu",
+      true,
+      phi::errors::InvalidArgument("The act_type of fused_grouped_gemm must "
+                                   "be none, relu or gelu, but got %s.",
+                                   act_type));
+
+  const int64_t num_experts = w_dims[0];
+  const int64_t n = w_dims[2];
+  if (config.is_runtime || (x_dims[1] > 0 && w_dims[1] > 0)) {
+    PADDLE_ENFORCE_EQ(
+        x_dims[1],
+        w_dims[1],
+        phi::errors::InvalidArgument(
+            "The last dim of Input(x) of fused_grouped_gemm must be equal to "
+            "the dim 1 of Input(weight), but got %d and %d.",
+            x_dims[1],
+            w_dims[1]));
+  }
+  if (config.is_runtime || num_experts > 0) {
+    PADDLE_ENFORCE_EQ(
+        expert_offsets.dims(),
+        common::make_ddim({num_experts}),
+        phi::errors::InvalidArgument(
+            "The Input(expert_offsets) of fused_grouped_gemm must be of shape "
+            "[%d], but got [%s].",
+            num_experts,
+            expert_offsets.dims()));
+  }
+  if (bias) {
+    PADDLE_ENFORCE_EQ(
+        bias.dims(),
+        common::make_ddim({num_experts, n}),
+        phi::errors::InvalidArgument(
+            "The Input(bias) of fused_grouped_gemm must be of shape "
+            "[%d, %d], but got [%s].",
+            num_experts,
+            n,
+            bias.dims()));
+  }
+
+  out->set_dims(common::make_ddim({x_dims[0], n}));
+  out->set_dtype(x.dtype());
+  out->set_layout(x.layout());
+}
+
+void FusedGroupedGemmGradInferMeta(const MetaTensor& x,
+                                   const MetaTensor& weight,
+                                   const MetaTensor& bias,
+                                   const MetaTensor& expert_offsets,
+                                   const MetaTensor& out,
+                                   const MetaTensor& out_grad,
+                                   const std::string& act_type,
+                                   MetaTensor* x_grad,
+                                   MetaTensor* weight_grad,
+                                   MetaTensor* bias_grad) {
+  if (x_grad) {
+    x_grad->share_meta(x);
+  }
+  if (weight_grad) {
+    weight_grad->share_meta(weight);
+  }
+  if (bias_grad && bias) {
+    bias_grad->share_meta(bias);
+  }
+}
+
+void FusedBeamSearchStepInferMeta(const MetaTensor& logits,
+                                  const MetaTensor& cum_scores,
+                                  const MetaTensor& seq_lens,
+                                  const MetaTensor& finished,
+                                  int end_id,
+                                  float length_penalty,
+                                  MetaTensor* next_tokens,
+                                  MetaTensor* parent_idx,
+                                  MetaTensor* next_cum_scores,
+                                  MetaTensor* next_seq_lens,
+                                  MetaTensor* next_finished,
+                                  MetaConfig config) {
+  const auto& logits_dims = logits.dims();
+  const auto& beam_dims = cum_scores.dims();
+  PADDLE_ENFORCE_EQ(logits_dims.size(),
+                    2,
+                    phi::errors::InvalidArgument(
+                        "The Input(logits) of fused_beam_search_step must be "
+                        "2D [batch_size * beam_size, vocab_size], but got "
+                        "shape [%s].",
+                        logits_dims));
+  PADDLE_ENFORCE_EQ(beam_dims.size(),
+                    2,
+                    phi::errors::InvalidArgument(
+                        "The Input(cum_scores) of fused_beam_search_step must "
+                        "be 2D [batch_size, beam_size], but got shape [%s].",
+                        beam_dims));
+  PADDLE_ENFORCE_EQ(cum_scores.dtype(),
+                    DataType::FLOAT32,
+                    phi::errors::InvalidArgument(
+                        "The Input(cum_scores) of fused_beam_search_step must "
+                        "be float32, but got %s.",
+                        cum_scores.dtype()));
+  PADDLE_ENFORCE_EQ(seq_lens.dtype(),
+                    DataType::INT32,
+                    phi::errors::InvalidArgument(
+                        "The Input(seq_lens) of fused_beam_search_step must "
+                        "be int32, but got %s.",
+                        seq_lens.dtype()));
+  PADDLE_ENFORCE_EQ(finished.dtype(),
+                    DataType::BOOL,
+                    phi::errors::InvalidArgument(
+                        "The Input(finished) of fused_beam_search_step must "
+                        "be bool, but got %s.",
+                        finished.dtype()));
+  PADDLE_ENFORCE_EQ(
+      seq_lens.dims() == beam_dims && finished.dims() == beam_dims,
+      true,
+      phi::errors::InvalidArgument(
+          "The Input(seq_lens) and Input(finished) of "
+          "fused_beam_search_step must be of the shape [%s] of "
+          "Input(cum_scores), but got [%s] and [%s].",
+          beam_dims,
+          seq_lens.dims(),
+          finished.dims()));
+
+  const int64_t beam_size = beam_dims[1];
+  if (beam_size > 0) {
+    PADDLE_ENFORCE_LE(beam_size,
+                      32,
+                      phi::errors::InvalidArgument(
+                          "The beam_size of fused_beam_search_step must be no "
+                          "more than 32, but got %d.",
+                          beam_size));
+  }
+  if (config.is_runtime || (beam_dims[0] > 0 && beam_size > 0 &&
+                            logits_dims[0] > 0 && logits_dims[1] > 0)) {
+    PADDLE_ENFORCE_EQ(logits_dims[0],
+                      beam_dims[0] * beam_size,
+                      phi::errors::InvalidArgument(
+                          "The rows of Input(logits) of fused_beam_search_step "
+                          "must be batch_size * beam_size = %d, but got %d.",
+                          beam_dims[0] * beam_size,
+                          logits_dims[0]));
+    PADDLE_ENFORCE_GE(logits_dims[1],
+                      beam_size,
+                      phi::errors::InvalidArgument(
+                          "The vocab_size of fused_beam_search_step must be no "
+                          "less than the beam_size %d, but got %d.",
+                          beam_size,
+                          logits_dims[1]));
+  }
+
+  next_tokens->set_dims(beam_dims);
+  next_tokens->set_dtype(DataType::INT64);
+  parent_idx->set_dims(beam_dims);
+  parent_idx->set_dtype(DataType::INT32);
+  next_cum_scores->set_dims(beam_dims);
+  next_cum_scores->set_dtype(DataType::FLOAT32);
+  next_seq_lens->set_dims(beam_dims);
+  next_seq_lens->set_dtype(DataType::INT32);
+  next_finished->set_dims(beam_dims);
+  next_finished->set_dtype(DataType::BOOL);
+}
+
 }  // namespace phi
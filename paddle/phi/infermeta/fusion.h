@@ -801,4 +801,55 @@ void VariableLengthMemoryEfficientAttentionInferMeta(
     int pre_cache_length,
     MetaTensor* out);
 
+void Fp8LinearInferMeta(const MetaTensor& x,
+                        const MetaTensor& weight,
+                        const MetaTensor& bias,
+                        const MetaTensor& x_amax_history,
+                        const MetaTensor& weight_amax_history,
+                        float margin,
+                        MetaTensor* out,
+                        MetaTensor* x_amax_history_out,
+                        MetaTensor* weight_amax_history_out,
+                        MetaConfig config = MetaConfig());
+
+void Fp8LinearGradInferMeta(const MetaTensor& x,
+                            const MetaTensor& weight,
+                            const MetaTensor& bias,
+                            const MetaTensor& out_grad,
+                            MetaTensor* x_grad,
+                            MetaTensor* weight_grad,
+                            MetaTensor* bias_grad);
+
+void FusedGroupedGemmInferMeta(const MetaTensor& x,
+                               const MetaTensor& weight,
+                               const MetaTensor& bias,
+                               const MetaTensor& expert_offsets,
+                               const std::string& act_type,
+                               MetaTensor* out,
+                               MetaConfig config = MetaConfig());
+
+void FusedGroupedGemmGradInferMeta(const MetaTensor& x,
+                                   const MetaTensor& weight,
+                                   const MetaTensor& bias,
+                                   const MetaTensor& expert_offsets,
+                                   const MetaTensor& out,
+                                   const MetaTensor& out_grad,
+                                   const std::string& act_type,
+                                   MetaTensor* x_grad,
+                                   MetaTensor* weight_grad,
+                                   MetaTensor* bias_grad);
+
+void FusedBeamSearchStepInferMeta(const MetaTensor& logits,
+                                  const MetaTensor& cum_scores,
+                                  const MetaTensor& seq_lens,
+                                  const MetaTensor& finished,
+                                  int end_id,
+                                  float length_penalty,
+                                  MetaTensor* next_tokens,
+                                  MetaTensor* parent_idx,
+                                  MetaTensor* next_cum_scores,
+                                  MetaTensor* next_seq_lens,
+                                  MetaTensor* next_finished,
+                                  MetaConfig config = MetaConfig());
+
 }  // namespace phi
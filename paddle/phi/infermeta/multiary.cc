@@ -1193,6 +1193,73 @@ inline int ConvOutputSize(
   return output_size;
 }
 
+void DecodeJpegBatchInferMeta(const MetaTensor& x,
+                              const MetaTensor& offsets,
+                              const MetaTensor& boxes,
+                              const MetaTensor& flip,
+                              const std::vector<int>& size,
+                              const std::vector<float>& mean,
+                              const std::vector<float>& std,
+                              const std::string& mode,
+                              MetaTensor* out) {
+  PADDLE_ENFORCE_EQ(x.dims().size(),
+                    1,
+                    phi::errors::InvalidArgument(
+                        "The input of decode_jpeg_batch should be the 1-D "
+                        "bytes of the images, but got the shape [%s].",
+                        x.dims()));
+  PADDLE_ENFORCE_EQ(offsets.dims().size(),
+                    1,
+                    phi::errors::InvalidArgument(
+                        "The offsets of decode_jpeg_batch should be 1-D, but "
+                        "got the shape [%s].",
+                        offsets.dims()));
+  PADDLE_ENFORCE_EQ(size.size(),
+                    2,
+                    phi::errors::InvalidArgument(
+                        "The size of decode_jpeg_batch should be [height, "
+                        "width], but got %d values.",
+                        size.size()));
+  PADDLE_ENFORCE_EQ(
+      mode == "rgb" || mode == "gray",
+      true,
+      phi::errors::InvalidArgument(
+          "The mode of decode_jpeg_batch should be rgb or gray, but got %s.",
+          mode));
+  const int64_t channels = mode == "rgb" ? 3 : 1;
+  PADDLE_ENFORCE_EQ(
+      mean.size() == std.size() &&
+          (mean.empty() || static_cast<int64_t>(mean.size()) == channels),
+      true,
+      phi::errors::InvalidArgument(
+          "The mean and std of decode_jpeg_batch should both be empty or of "
+          "the %d channels, but got %d and %d values.",
+          channels,
+          mean.size(),
+          std.size()));
+  const int64_t batch_size = offsets.dims()[0];
+  if (boxes) {
+    PADDLE_ENFORCE_EQ(boxes.dims(),
+                      common::make_ddim({batch_size, 4}),
+                      phi::errors::InvalidArgument(
+                          "The boxes of decode_jpeg_batch should be of the "
+                          "shape [%d, 4], but got [%s].",
+                          batch_size,
+                          boxes.dims()));
+  }
+  if (flip) {
+    PADDLE_ENFORCE_EQ(flip.dims(),
+                      common::make_ddim({batch_size}),
+                      phi::errors::InvalidArgument(
+                          "The flip of decode_jpeg_batch should be of the "
+                          "shape [%d], but got [%s].",
+                          batch_size,
+                          flip.dims()));
+  }
+  out->set_dims(common::make_ddim({batch_size, channels, size[0], size[1]}));
+  out->set_dtype(DataType::FLOAT32);
+}
+
 void DeformableConvInferMeta(const MetaTensor& x,
                              const MetaTensor& offset,
                              const MetaTensor& filter,
@@ -1821,6 +1888,73 @@ void FusedLinearParamGradAddInferMeta(const MetaTensor& x,
   }
 }
 
+void FusedRmsNormQuantInferMeta(const MetaTensor& x,
+                                const MetaTensor& bias,
+                                const MetaTensor& residual,
+                                const MetaTensor& norm_weight,
+                                const MetaTensor& norm_bias,
+                                const float epsilon,
+                                const int begin_norm_axis,
+                                const int quant_round_type,
+                                const float quant_max_bound,
+                                const float quant_min_bound,
+                                MetaTensor* out,
+                                MetaTensor* residual_out,
+                                MetaTensor* out_scale) {
+  std::vector<int64_t> x_dims_vec = common::vectorize(x.dims());
+  auto x_dims_size = x_dims_vec.size();
+  PADDLE_ENFORCE_EQ(
+      begin_norm_axis >= 0 &&
+          static_cast<size_t>(begin_norm_axis) < x_dims_size,
+      true,
+      phi::errors::InvalidArgument(
+          "The begin_norm_axis must be in [0, %d), but received %d.",
+          x_dims_size,
+          begin_norm_axis));
+
+  size_t normalized_dims = 1;
+  for (size_t i = begin_norm_axis; i < x_dims_size; ++i) {
+    normalized_dims *= x_dims_vec[i];
+  }
+
+  PADDLE_ENFORCE_EQ(normalized_dims,
+                    norm_weight.dims()[0],
+                    phi::errors::InvalidArgument(
+                        "The normalized size of Input(X) must equal to be"
+                        "the size of Weight, but received"
+                        "normalized size of Input(X) is [%d], received size"
+                        "of Weight is [%d]",
+                        normalized_dims,
+                        norm_weight.dims()[0]));
+  PADDLE_ENFORCE_GT(quant_max_bound,
+                    0.0f,
+                    phi::errors::InvalidArgument(
+                        "The quant_max_bound must be positive, but received "
+                        "%f.",
+                        quant_max_bound));
+
+  auto out_dims = common::make_ddim(x_dims_vec);
+
+  out->set_dims(out_dims);
+  out->set_dtype(phi::DataType::INT8);
+  out->set_layout(x.layout());
+  out->share_lod(x);
+
+  residual_out->set_dims(out_dims);
+  residual_out->set_dtype(x.dtype());
+  residual_out->set_layout(x.layout());
+  residual_out->share_lod(x);
+
+  // the scales are kept on the normalized axes to broadcast with out
+  std::vector<int64_t> scale_dims_vec(x_dims_vec);
+  for (size_t i = begin_norm_axis; i < x_dims_size; ++i) {
+    scale_dims_vec[i] = 1;
+  }
+  out_scale->set_dims(common::make_ddim(scale_dims_vec));
+  out_scale->set_dtype(phi::DataType::FLOAT32);
+  out_scale->set_layout(x.layout());
+}
+
 void FusionGroupInferMeta(const std::vector<const MetaTensor*>& ins,
                           const std::vector<int>& outs_dtype,
                           const std::vector<int>& inputs_dtype,
@@ -2893,6 +3027,36 @@ void MergedMomentumInferMeta(
     std::vector<MetaTensor*> velocity_out,
     std::vector<MetaTensor*> master_param_out) {}
 
+void MergedSquaredL2NormInferMeta(const std::vector<const MetaTensor*>& x,
+                                  MetaTensor* out) {
+  PADDLE_ENFORCE_GT(
+      x.size(),
+      0,
+      phi::errors::InvalidArgument(
+          "The size of Input(x) of merged_squared_l2_norm should be greater "
+          "than 0, but received %d.",
+          x.size()));
+  auto dtype = x[0]->dtype();
+  for (size_t i = 1; i < x.size(); ++i) {
+    PADDLE_ENFORCE_EQ(
+        x[i]->dtype(),
+        dtype,
+        phi::errors::InvalidArgument(
+            "The dtypes of Input(x) of merged_squared_l2_norm should be the "
+            "same, but x[0] is %s and x[%d] is %s.",
+            dtype,
+            i,
+            x[i]->dtype()));
+  }
+  out->set_dims(common::make_ddim({}));
+  // the sum of squares of low precision tensors overflows easily
+  if (dtype == phi::DataType::FLOAT16 || dtype == phi::DataType::BFLOAT16) {
+    out->set_dtype(phi::DataType::FLOAT32);
+  } else {
+    out->set_dtype(dtype);
+  }
+}
+
 void MemoryEfficientAttentionInferMeta(const MetaTensor& query,
                                        const MetaTensor& key,
                                        const MetaTensor& value,
@@ -3899,21 +4063,53 @@ void WeightOnlyLinearInferMeta(const MetaTensor& x,
                                const MetaTensor& weight_scale,
                                const std::string& weight_dtype,
                                const int32_t arch,
+                               const int32_t group_size,
+                               const std::string& activation,
                                MetaTensor* out) {
   auto x_dims = x.dims();
   auto w_dims = weight.dims();
-  auto n = weight_scale.dims()[0];
   PADDLE_ENFORCE(
       weight_dtype == "int8" || weight_dtype == "int4",
       errors::InvalidArgument("quant_method must be 'int8' or 'int4'."));
+  PADDLE_ENFORCE(activation == "none" || activation == "gelu" ||
+                     activation == "relu" || activation == "silu",
+                 errors::InvalidArgument(
+                     "activation must be 'none', 'gelu', 'relu' or 'silu'."));
   PADDLE_ENFORCE_EQ(
       w_dims.size(),
       2UL,
       errors::InvalidArgument("The input(weight) must be a 2D Tensor."));
-  PADDLE_ENFORCE_EQ(
-      weight_scale.dims().size(),
-      1UL,
-      errors::InvalidArgument("The input(weight_scale) must be a 1D Tensor."));
+  int64_t n = 0;
+  if (group_size > 0) {
+    // the grouped weight_scale is [k / group_size, n]
+    PADDLE_ENFORCE_EQ(
+        group_size == 64 || group_size == 128,
+        true,
+        errors::InvalidArgument("group_size must be 64 or 128, but got [%d].",
+                                group_size));
+    PADDLE_ENFORCE_EQ(
+        weight_scale.dims().size(),
+        2UL,
+        errors::InvalidArgument(
+            "The grouped input(weight_scale) must be a 2D Tensor."));
+    PADDLE_ENFORCE_EQ(
+        weight_scale.dims()[0] * group_size,
+        w_dims[1],
+        errors::InvalidArgument(
+            "Input(WeightScale) dim[0] * group_size should be equal to "
+            "Input(Weight) dim[1], but received %d * %d != %d.",
+            weight_scale.dims()[0],
+            group_size,
+            w_dims[1]));
+    n = weight_scale.dims()[1];
+  } else {
+    PADDLE_ENFORCE_EQ(
+        weight_scale.dims().size(),
+        1UL,
+        errors::InvalidArgument(
+            "The input(weight_scale) must be a 1D Tensor."));
+    n = weight_scale.dims()[0];
+  }
   PADDLE_ENFORCE_EQ(
       w_dims[0] % 16,
       0,
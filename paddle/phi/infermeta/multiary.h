@@ -268,6 +268,16 @@ void DecayedAdagradInferMeta(const MetaTensor& param,
                              MetaTensor* param_out,
                              MetaTensor* moment_out);
 
+void DecodeJpegBatchInferMeta(const MetaTensor& x,
+                              const MetaTensor& offsets,
+                              const MetaTensor& boxes,
+                              const MetaTensor& flip,
+                              const std::vector<int>& size,
+                              const std::vector<float>& mean,
+                              const std::vector<float>& std,
+                              const std::string& mode,
+                              MetaTensor* out);
+
 void DeformableConvInferMeta(const MetaTensor& x,
                              const MetaTensor& offset,
                              const MetaTensor& filter,
@@ -360,6 +370,20 @@ void FusedLinearParamGradAddInferMeta(const MetaTensor& x,
                                       MetaTensor* dweight_out,
                                       MetaTensor* dbias_out);
 
+void FusedRmsNormQuantInferMeta(const MetaTensor& x,
+                                const MetaTensor& bias,
+                                const MetaTensor& residual,
+                                const MetaTensor& norm_weight,
+                                const MetaTensor& norm_bias,
+                                const float epsilon,
+                                const int begin_norm_axis,
+                                const int quant_round_type,
+                                const float quant_max_bound,
+                                const float quant_min_bound,
+                                MetaTensor* out,
+                                MetaTensor* residual_out,
+                                MetaTensor* out_scale);
+
 void FusionGroupInferMeta(const std::vector<const MetaTensor*>& ins,
                           const std::vector<int>& outs_dtype,
                           const std::vector<int>& inputs_dtype,
@@ -526,6 +550,9 @@ void MergedMomentumInferMeta(
     std::vector<MetaTensor*> velocity_out,
     std::vector<MetaTensor*> master_param_out);
 
+void MergedSquaredL2NormInferMeta(const std::vector<const MetaTensor*>& x,
+                                  MetaTensor* out);
+
 void MemoryEfficientAttentionInferMeta(const MetaTensor& query,
                                        const MetaTensor& key,
                                        const MetaTensor& value,
@@ -707,6 +734,8 @@ void WeightOnlyLinearInferMeta(const MetaTensor& x,
                                const MetaTensor& weight_scale,
                                const std::string& weight_dtype,
                                const int32_t arch,
+                               const int32_t group_size,
+                               const std::string& activation,
                                MetaTensor* out);
 
 void WeightedSampleNeighborsInferMeta(const MetaTensor& row,
@@ -0,0 +1,50 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/infermeta/strings/binary.h"
+
+#include <vector>
+
+#include "paddle/common/ddim.h"
+
+namespace phi {
+namespace strings {
+
+void WordpieceTokenizeInferMeta(const MetaTensor& x,
+                                const MetaTensor& vocab,
+                                int max_seq_len,
+                                MetaTensor* input_ids,
+                                MetaTensor* seq_lens) {
+  PADDLE_ENFORCE_GT(max_seq_len,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The max_seq_len of wordpiece_tokenize should be "
+                        "greater than 0, but received %d.",
+                        max_seq_len));
+  PADDLE_ENFORCE_EQ(vocab.dims().size(),
+                    1,
+                    phi::errors::InvalidArgument(
+                        "The vocab of wordpiece_tokenize should be a 1-D "
+                        "StringTensor, but received a %d-D one.",
+                        vocab.dims().size()));
+  auto x_dims = common::vectorize(x.dims());
+  seq_lens->set_dims(x.dims());
+  seq_lens->set_dtype(DataType::INT32);
+  x_dims.push_back(max_seq_len);
+  input_ids->set_dims(common::make_ddim(x_dims));
+  input_ids->set_dtype(DataType::INT64);
+}
+
+}  // namespace strings
+}  // namespace phi
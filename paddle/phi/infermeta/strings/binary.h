@@ -0,0 +1,30 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include "paddle/phi/core/infermeta_utils.h"
+#include "paddle/phi/core/meta_tensor.h"
+
+namespace phi {
+namespace strings {
+// Common InferMeta Functions of StringTensor for binary operators:
+void WordpieceTokenizeInferMeta(const MetaTensor& x,
+                                const MetaTensor& vocab,
+                                int max_seq_len,
+                                MetaTensor* input_ids,
+                                MetaTensor* seq_lens);
+
+}  // namespace strings
+}  // namespace phi
@@ -1367,6 +1367,58 @@ void SpectralNormInferMeta(const MetaTensor& weight,
   }
 }
 
+void TopKTopPSamplingInferMeta(const MetaTensor& x,
+                               const MetaTensor& top_p,
+                               const MetaTensor& pre_ids,
+                               float temperature,
+                               int top_k,
+                               float min_p,
+                               float repetition_penalty,
+                               int seed,
+                               MetaTensor* out,
+                               MetaTensor* ids) {
+  auto x_dims = x.dims();
+  PADDLE_ENFORCE_EQ(x_dims.size(),
+                    2,
+                    phi::errors::InvalidArgument(
+                        "The logits of top_k_top_p_sampling should be "
+                        "[bsz, vocab_size], but received %s.",
+                        x_dims));
+  PADDLE_ENFORCE_EQ(
+      top_p.dims()[0],
+      x_dims[0],
+      phi::errors::InvalidArgument(
+          "The top_p.dims[0] must be equal to x.dims[0], but received "
+          "top_p.dims[0] = %d and x.dims[0] = %d.",
+          top_p.dims()[0],
+          x_dims[0]));
+  if (pre_ids) {
+    PADDLE_ENFORCE_EQ(
+        pre_ids.dims().size() == 2 && pre_ids.dims()[0] == x_dims[0],
+        true,
+        phi::errors::InvalidArgument(
+            "The pre_ids of top_k_top_p_sampling should be [bsz, len], but "
+            "received %s.",
+            pre_ids.dims()));
+  }
+  PADDLE_ENFORCE_GT(temperature,
+                    0.f,
+                    phi::errors::InvalidArgument(
+                        "The temperature should be greater than 0, but "
+                        "received %f.",
+                        temperature));
+  PADDLE_ENFORCE_GT(repetition_penalty,
+                    0.f,
+                    phi::errors::InvalidArgument(
+                        "The repetition_penalty should be greater than 0, "
+                        "but received %f.",
+                        repetition_penalty));
+  ids->set_dims(common::make_ddim({x_dims[0], 1}));
+  ids->set_dtype(DataType::INT64);
+  out->set_dims(common::make_ddim({x_dims[0], 1}));
+  out->set_dtype(x.dtype());
+}
+
 void ViterbiDecodeInferMeta(const MetaTensor& input,
                             const MetaTensor& transition,
                             const MetaTensor& length,
@@ -217,6 +217,17 @@ void SpectralNormInferMeta(const MetaTensor& weight,
                            MetaTensor* out,
                            MetaConfig config = MetaConfig());
 
+void TopKTopPSamplingInferMeta(const MetaTensor& x,
+                               const MetaTensor& top_p,
+                               const MetaTensor& pre_ids,
+                               float temperature,
+                               int top_k,
+                               float min_p,
+                               float repetition_penalty,
+                               int seed,
+                               MetaTensor* out,
+                               MetaTensor* ids);
+
 void ViterbiDecodeInferMeta(const MetaTensor& input,
                             const MetaTensor& transition,
                             const MetaTensor& length,
@@ -5192,6 +5192,7 @@ void UnStackInferMeta(const MetaTensor& x,
 void WeightQuantizeInferMeta(const MetaTensor& x,
                              const std::string& algo,
                              const int32_t arch,
+                             const int32_t group_size,
                              MetaTensor* out,
                              MetaTensor* scale) {
   PADDLE_ENFORCE_EQ(
@@ -5219,6 +5220,26 @@ void WeightQuantizeInferMeta(const MetaTensor& x,
           "The second dimension of input must be divisible by 16, but got[%d]",
           x_dims[1]));
   std::vector<int64_t> dim_scale({x_dims[1]});
+  if (group_size > 0) {
+    PADDLE_ENFORCE_EQ(
+        group_size == 64 || group_size == 128,
+        true,
+        phi::errors::InvalidArgument(
+            "The group_size of quant op must be 64 or 128, but got[%d]",
+            group_size));
+    PADDLE_ENFORCE_NE(
+        algo,
+        "llm.int8",
+        phi::errors::InvalidArgument(
+            "The algo llm.int8 doesn't support the group-wise quantization."));
+    PADDLE_ENFORCE_EQ(
+        x_dims[0] % group_size,
+        0,
+        phi::errors::InvalidArgument("The first dimension of input must be "
+                                     "divisible by group_size, but got[%d]",
+                                     x_dims[0]));
+    dim_scale = std::vector<int64_t>({x_dims[0] / group_size, x_dims[1]});
+  }
   std::vector<int64_t> dim_out;
   if (algo == "weight_only_int8" || algo == "llm.int8") {
     dim_out = std::vector<int64_t>({x_dims[1], x_dims[0]});
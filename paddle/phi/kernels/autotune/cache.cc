@@ -14,9 +14,23 @@
 
 #include "paddle/phi/kernels/autotune/cache.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iomanip>
+#include <map>
+#include <sstream>
 
 #include "glog/logging.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#endif
 
 namespace phi {
 namespace autotune {
@@ -37,6 +51,8 @@ std::string AlgorithmTypeString(int64_t algo_type) {
   } else if (algo_type ==
              static_cast<int64_t>(AlgorithmType::kConvBackwardFilter)) {
     return "conv_backward_filter";
+  } else if (algo_type == static_cast<int64_t>(AlgorithmType::kReduce)) {
+    return "reduce";
   }
 #ifdef PADDLE_WITH_CUDNN_FRONTEND
   if (algo_type == static_cast<int64_t>(AlgorithmType::kConvForwardV8)) {
@@ -67,6 +83,237 @@ std::string AlgorithmTypeString(int64_t algo_type) {
   return std::to_string(algo_type);
 }
 
+namespace {
+
+// Each line of the cache file is "<key> = <value>", where the key is
+//   <device> algo <type> <config key>
+//   <device> matmul <config key>
+//   <device> conv <type> <x_dims> <w_dims> <strides> <paddings> <dilations>
+//       <dtype> <groups> <data_layout>
+// and the value of conv is "<algo> <workspace_size> <exhaustive_search>".
+constexpr char kCacheFileHeader[] = "# paddle autotune cache v1";
+constexpr char kKeyValueSeparator[] = " = ";
+
+template <typename T>
+std::string JoinDims(const std::vector<T>& dims) {
+  if (dims.empty()) {
+    return "-";
+  }
+  std::ostringstream os;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    os << (i == 0 ? "" : ",") << dims[i];
+  }
+  return os.str();
+}
+
+template <typename T>
+bool SplitDims(const std::string& str, std::vector<T>* dims) {
+  dims->clear();
+  if (str == "-") {
+    return true;
+  }
+  std::istringstream is(str);
+  std::string item;
+  while (std::getline(is, item, ',')) {
+    char* end = nullptr;
+    dims->push_back(static_cast<T>(std::strtoll(item.c_str(), &end, 10)));
+    if (item.empty() || *end != '\0') {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Read the lines of the cache file as key -> value, a missing file is empty.
+std::map<std::string, std::string> ReadCacheFile(const std::string& path) {
+  std::map<std::string, std::string> lines;
+  std::ifstream fin(path);
+  std::string line;
+  while (std::getline(fin, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    size_t pos = line.find(kKeyValueSeparator);
+    if (pos == std::string::npos) {
+      LOG(WARNING) << "Invalid line of autotune cache file " << path << ": "
+                   << line;
+      continue;
+    }
+    lines[line.substr(0, pos)] =
+        line.substr(pos + std::strlen(kKeyValueSeparator));
+  }
+  return lines;
+}
+
+}  // namespace
+
+const std::string& AutoTuneCache::DeviceKey() {
+  if (device_key_.empty()) {
+    std::ostringstream os;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    int id = phi::backends::gpu::GetCurrentDeviceId();
+    std::string name = phi::backends::gpu::GetDeviceProperties(id).name;
+    std::replace(name.begin(), name.end(), ' ', '_');
+    os << name << "/sm" << phi::backends::gpu::GetGPUComputeCapability(id)
+       << "/driver" << phi::backends::gpu::GetGPUDriverVersion(id)
+       << "/runtime" << phi::backends::gpu::GetGPURuntimeVersion(id)
+       << "/dnn" << phi::backends::gpu::DnnVersion();
+#else
+    os << "cpu";
+#endif
+    device_key_ = os.str();
+  }
+  return device_key_;
+}
+
+int64_t AutoTuneCache::Load(const std::string& path) {
+  const std::string& device = DeviceKey();
+  int64_t num = 0;
+  for (auto& line : ReadCacheFile(path)) {
+    std::istringstream key(line.first);
+    std::istringstream value(line.second);
+    std::string line_device, kind;
+    key >> line_device >> kind;
+    if (line_device != device) {
+      continue;
+    }
+    bool valid = false;
+    if (kind == "algo" || kind == "matmul") {
+      int64_t algo_type = static_cast<int64_t>(AlgorithmType::kMatmul);
+      if (kind == "algo") {
+        key >> algo_type;
+      }
+      size_t config = 0;
+      int64_t algo = 0;
+      valid = static_cast<bool>(key >> config) &&
+              static_cast<bool>(value >> algo);
+      if (valid && kind == "matmul") {
+        matmul_auto_tune_map_.Set(config, algo);
+      } else if (valid && auto_tune_map_.count(algo_type) > 0) {
+        auto_tune_map_[algo_type].Set(config, algo);
+      }
+    } else if (kind == "conv") {
+      int64_t algo_type = 0;
+      std::string x_dims, w_dims, strides, paddings, dilations;
+      int dtype = 0;
+      ConvCacheKey conv_key;
+      ConvAutoTuneResult result;
+      valid = static_cast<bool>(key >> algo_type >> x_dims >> w_dims >>
+                                strides >> paddings >> dilations >> dtype >>
+                                conv_key.groups >> conv_key.data_layout) &&
+              static_cast<bool>(value >> result.algo >>
+                                result.workspace_size >>
+                                result.exhaustive_search) &&
+              SplitDims(x_dims, &conv_key.x_dims) &&
+              SplitDims(w_dims, &conv_key.w_dims) &&
+              SplitDims(strides, &conv_key.strides) &&
+              SplitDims(paddings, &conv_key.paddings) &&
+              SplitDims(dilations, &conv_key.dilations);
+      conv_key.dtype = static_cast<phi::DataType>(dtype);
+      auto it = conv_auto_tune_map_.find(algo_type);
+      // the cache is cleared once it grows over the max number
+      if (valid && it != conv_auto_tune_map_.end() &&
+          it->second.Size() < FLAGS_search_cache_max_number) {
+        it->second.Set(conv_key, result);
+      }
+    }
+    if (!valid) {
+      LOG(WARNING) << "Invalid line of autotune cache file " << path << ": "
+                   << line.first << kKeyValueSeparator << line.second;
+      continue;
+    }
+    ++num;
+  }
+  VLOG(3) << "Load " << num << " autotune algorithms of " << device
+          << " from " << path;
+  return num;
+}
+
+void AutoTuneCache::Save(const std::string& path) {
+  const std::string& device = DeviceKey();
+  std::map<std::string, std::string> lines;
+  for (auto& v : auto_tune_map_) {
+    for (auto& entry : v.second.Entries()) {
+      std::ostringstream key;
+      key << device << " algo " << v.first << " " << entry.first;
+      lines[key.str()] = std::to_string(entry.second);
+    }
+  }
+  for (auto& entry : matmul_auto_tune_map_.Entries()) {
+    std::ostringstream key;
+    key << device << " matmul " << entry.first;
+    lines[key.str()] = std::to_string(entry.second);
+  }
+  for (auto& v : conv_auto_tune_map_) {
+    for (auto& entry : v.second.Entries()) {
+      const ConvCacheKey& conv_key = entry.first;
+      std::ostringstream key, value;
+      key << device << " conv " << v.first << " " << JoinDims(conv_key.x_dims)
+          << " " << JoinDims(conv_key.w_dims) << " "
+          << JoinDims(conv_key.strides) << " " << JoinDims(conv_key.paddings)
+          << " " << JoinDims(conv_key.dilations) << " "
+          << static_cast<int>(conv_key.dtype) << " " << conv_key.groups << " "
+          << conv_key.data_layout;
+      value << entry.second.algo << " " << entry.second.workspace_size << " "
+            << entry.second.exhaustive_search;
+      lines[key.str()] = value.str();
+    }
+  }
+  if (lines.empty()) {
+    return;
+  }
+
+#ifndef _WIN32
+  // the processes sharing the file merge into it one by one
+  std::string lock_path = path + ".lock";
+  int lock_fd = open(lock_path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (lock_fd < 0 || flock(lock_fd, LOCK_EX) != 0) {
+    LOG(WARNING) << "Failed to lock " << lock_path
+                 << ", the autotune cache is not saved.";
+    if (lock_fd >= 0) {
+      close(lock_fd);
+    }
+    return;
+  }
+  std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+#else
+  std::string tmp_path = path + ".tmp";
+#endif
+  // the algorithms tuned by this process take the place of the loaded ones
+  auto merged = ReadCacheFile(path);
+  for (auto& line : lines) {
+    merged[line.first] = line.second;
+  }
+  bool saved = false;
+  {
+    std::ofstream fout(tmp_path, std::ios::trunc);
+    fout << kCacheFileHeader << "\n";
+    for (auto& line : merged) {
+      fout << line.first << kKeyValueSeparator << line.second << "\n";
+    }
+    fout.close();
+    saved = static_cast<bool>(fout);
+  }
+  // the file is replaced by rename, so that a reader never sees a part of it
+  if (saved) {
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    saved = std::rename(tmp_path.c_str(), path.c_str()) == 0;
+  }
+  if (!saved) {
+    std::remove(tmp_path.c_str());
+    LOG(WARNING) << "Failed to save the autotune cache to " << path;
+  } else {
+    VLOG(3) << "Save " << lines.size() << " autotune algorithms of " << device
+            << " to " << path << ", " << merged.size() << " in total";
+  }
+#ifndef _WIN32
+  flock(lock_fd, LOCK_UN);
+  close(lock_fd);
+#endif
+}
+
 void AutoTuneCache::UpdateStatus() {
   int64_t size = 0;
   int64_t cache_hits = 0;
@@ -15,13 +15,18 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdlib>
 #include <numeric>
+#include <string>
 
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/kernels/autotune/cache_base.h"
 #ifdef PADDLE_WITH_CUDNN_FRONTEND
 #include "paddle/phi/kernels/autotune/cache_cudnn_frontend.h"
 #endif
+
+PHI_DECLARE_string(autotune_cache_file);
+
 namespace phi {
 namespace autotune {
 
@@ -49,19 +54,20 @@ enum class AlgorithmType {
   kGatherGemmScatterFP32NN = 7,
   kGatherGemmScatterFP32TN = 8,
   kGatherGemmScatterFP32NT = 9,
+  kReduce = 10,
 #if !defined(PADDLE_WITH_CUDNN_FRONTEND)
-  kAlgorithmCount = 10
+  kAlgorithmCount = 11
 #else
-  kConvForwardV8 = 10,
-  kConvBackwardDataV8 = 11,
-  kConvBackwardFilterV8 = 12,
-  kScaleBiasReluConvBNstats = 13,
-  kBNFinalize = 14,
-  kScaleBiasAddRelu = 15,
-  kDgradDreluBnBwdWeight = 16,
-  kDbnApply = 17,
-  kBnActWgrad = 18,
-  kAlgorithmCount = 19
+  kConvForwardV8 = 11,
+  kConvBackwardDataV8 = 12,
+  kConvBackwardFilterV8 = 13,
+  kScaleBiasReluConvBNstats = 14,
+  kBNFinalize = 15,
+  kScaleBiasAddRelu = 16,
+  kDgradDreluBnBwdWeight = 17,
+  kDbnApply = 18,
+  kBnActWgrad = 19,
+  kAlgorithmCount = 20
 #endif
 };
 
@@ -96,6 +102,9 @@ class AutoTuneCache {
  public:
   static AutoTuneCache& Instance() {
     static AutoTuneCache autotune_cache;
+    // registered after the construction, so that the cache is saved before
+    // it is destructed at exit
+    static int save_at_exit UNUSED = std::atexit(SaveAtExit);
     return autotune_cache;
   }
 
@@ -149,6 +158,15 @@ class AutoTuneCache {
 
   void UpdateStatus();
 
+  // Load the algorithms tuned on the GPU of this process from the file, the
+  // number of loaded algorithms is returned. The matmul algorithms of
+  // cuBLASLt and the plans of cuDNN frontend are not persisted.
+  int64_t Load(const std::string& path);
+
+  // Merge the cached algorithms into the file, the algorithms of another GPU
+  // or another process in the file are kept.
+  void Save(const std::string& path);
+
   // The number of total config cached
   int64_t Size() const { return total_size_; }
 
@@ -171,8 +189,21 @@ class AutoTuneCache {
     for (int i = 1; i < static_cast<int>(AlgorithmType::kAlgorithmCount); ++i) {
       Register(static_cast<AlgorithmType>(i));
     }
+    if (!FLAGS_autotune_cache_file.empty()) {
+      Load(FLAGS_autotune_cache_file);
+    }
   }
 
+  static void SaveAtExit() {
+    if (!FLAGS_autotune_cache_file.empty()) {
+      Instance().Save(FLAGS_autotune_cache_file);
+    }
+  }
+
+  // The GPU model, driver, runtime and dnn versions the algorithms are
+  // tuned with.
+  const std::string& DeviceKey();
+
   void Register(const AlgorithmType& algo_type) {
     std::lock_guard<std::mutex> lock(*autotune_cache_mutex_);
     if (algo_type == AlgorithmType::kConvForward ||
@@ -208,6 +239,7 @@ class AutoTuneCache {
   CudnnV8AlgorithmsTypeMap cudnn_v8_auto_tune_map_;
 #endif
   std::shared_ptr<std::mutex> autotune_cache_mutex_;
+  std::string device_key_;
   int64_t total_cache_hits_{0};
   int64_t total_cache_misses_{0};
   int64_t total_size_{0};
@@ -179,6 +179,13 @@ class AlgorithmsCache {
 
   int64_t Size() const { return hash_.size(); }
 
+  // A copy of the cached algorithms, e.g. to save them to a file.
+  std::vector<std::pair<KeyT, AlgorithmT>> Entries() const {
+    std::lock_guard<std::mutex> lock(*cache_mutex_);
+    return std::vector<std::pair<KeyT, AlgorithmT>>(hash_.begin(),
+                                                    hash_.end());
+  }
+
  protected:
   std::unordered_map<KeyT, AlgorithmT, HashT, KeyEqualT> hash_;
   std::shared_ptr<std::mutex> cache_mutex_;
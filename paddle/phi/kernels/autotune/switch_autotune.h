@@ -85,6 +85,10 @@ class AutoTuneStatus {
     previous_misses_ = 0;
     step_hit_rates_.clear();
     AutoTuneCache::Instance().Clean();
+    // keep the algorithms tuned by the former processes
+    if (!FLAGS_autotune_cache_file.empty()) {
+      AutoTuneCache::Instance().Load(FLAGS_autotune_cache_file);
+    }
   }
 
   bool use_autotune_{false};
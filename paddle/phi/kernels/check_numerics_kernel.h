@@ -29,4 +29,12 @@ void CheckNumericsKernel(const Context& ctx,
                          DenseTensor* stats,
                          DenseTensor* values);
 
+// Sets found_nan_inf, a bool tensor of [1], to true when the tensor holds
+// NAN/INF and leaves it as is otherwise, so that the nan/inf of many tensors
+// accumulates into it without a sync.
+template <typename T, typename Context>
+void AccumulateNanInfKernel(const Context& ctx,
+                            const DenseTensor& tensor,
+                            DenseTensor* found_nan_inf);
+
 }  // namespace phi
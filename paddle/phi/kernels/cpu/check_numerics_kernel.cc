@@ -50,6 +50,20 @@ void CheckNumericsKernel(const Context& ctx,
                                    values_ptr);
 }
 
+template <typename T, typename Context>
+void AccumulateNanInfKernel(const Context& ctx UNUSED,
+                            const DenseTensor& tensor,
+                            DenseTensor* found_nan_inf) {
+  const T* value = tensor.data<T>();
+  bool* found_nan_inf_ptr = found_nan_inf->data<bool>();
+  for (int64_t i = 0; i < tensor.numel(); ++i) {
+    if (std::isnan(value[i]) || std::isinf(value[i])) {
+      *found_nan_inf_ptr = true;
+      return;
+    }
+  }
+}
+
 }  // namespace phi
 
 PD_REGISTER_KERNEL(check_numerics,
@@ -62,3 +76,14 @@ PD_REGISTER_KERNEL(check_numerics,
                    phi::dtype::bfloat16,
                    phi::dtype::complex<float>,
                    phi::dtype::complex<double>) {}
+
+PD_REGISTER_KERNEL(accumulate_nan_inf,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::AccumulateNanInfKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16,
+                   phi::dtype::complex<float>,
+                   phi::dtype::complex<double>) {}
@@ -16,10 +16,88 @@
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/fast_conv2d.h"
 #include "paddle/phi/kernels/impl/conv_kernel_impl.h"
 
 namespace phi {
 
+// Computes the conv2d by Winograd or the direct depthwise conv if the shapes
+// fit them, returns false to fall back to im2col + gemm.
+template <typename T, typename Context>
+bool FastConv2dKernel(const Context& dev_ctx,
+                      const DenseTensor& input,
+                      const DenseTensor& filter,
+                      const std::vector<int>& strides,
+                      const std::vector<int>& paddings_t,
+                      const std::string& padding_algorithm,
+                      int groups,
+                      const std::vector<int>& dilations_t,
+                      const std::string& data_format,
+                      DenseTensor* out) {
+  if (input.numel() == 0 || out->numel() == 0) {
+    return false;
+  }
+  const bool channel_last = (data_format == "NHWC");
+  const DDim& in_dims = input.dims();
+  const DDim& out_dims = out->dims();
+  DDim in_nchw_dims =
+      channel_last ? DDim({in_dims[0], in_dims[3], in_dims[1], in_dims[2]})
+                   : in_dims;
+  DDim out_nchw_dims =
+      channel_last
+          ? DDim({out_dims[0], out_dims[3], out_dims[1], out_dims[2]})
+          : out_dims;
+
+  std::vector<int> paddings = paddings_t;
+  std::vector<int> dilations = dilations_t;
+  DDim in_data_dims = slice_ddim(in_nchw_dims, 2, in_nchw_dims.size());
+  DDim filter_data_dims = slice_ddim(filter.dims(), 2, filter.dims().size());
+  std::vector<int> ksize = common::vectorize<int>(filter_data_dims);
+  UpdatePaddingAndDilation(
+      &paddings, &dilations, padding_algorithm, in_data_dims, strides, ksize);
+
+  auto algo = funcs::SelectCPUConv2dAlgo(
+      in_nchw_dims, filter.dims(), out_nchw_dims, strides, dilations, groups);
+  if (algo == funcs::CPUConv2dAlgo::kIm2ColGemm) {
+    return false;
+  }
+
+  dev_ctx.template Alloc<T>(out);
+  DenseTensor transformed_input(input.type());
+  DenseTensor transformed_output(out->type());
+  if (channel_last) {
+    ResizeToChannelFirst<Context, T>(dev_ctx, &input, &transformed_input);
+    TransToChannelFirst<Context, T>(dev_ctx, &input, &transformed_input);
+    ResizeToChannelFirst<Context, T>(dev_ctx, out, &transformed_output);
+  } else {
+    transformed_input = input;
+    transformed_output = *out;
+  }
+
+  if (algo == funcs::CPUConv2dAlgo::kDepthwiseDirect) {
+    funcs::DepthwiseConv2dDirect<T>(dev_ctx,
+                                    transformed_input,
+                                    filter,
+                                    strides,
+                                    paddings,
+                                    dilations,
+                                    &transformed_output);
+  } else {
+    funcs::WinogradConv2d<T>(
+        dev_ctx,
+        transformed_input,
+        filter,
+        paddings,
+        algo == funcs::CPUConv2dAlgo::kWinogradF4x4 ? 4 : 2,
+        &transformed_output);
+  }
+
+  if (channel_last) {
+    TransToChannelLast<Context, T>(dev_ctx, &transformed_output, out);
+  }
+  return true;
+}
+
 template <typename T, typename Context>
 void ConvKernel(const Context& dev_ctx,
                 const DenseTensor& input,
@@ -31,6 +109,18 @@ void ConvKernel(const Context& dev_ctx,
                 int groups,
                 const std::string& data_format,
                 DenseTensor* out) {
+  if (FastConv2dKernel<T>(dev_ctx,
+                          input,
+                          filter,
+                          strides,
+                          paddings,
+                          padding_algorithm,
+                          groups,
+                          dilations,
+                          data_format,
+                          out)) {
+    return;
+  }
   ConvKernelImpl<T>(dev_ctx,
                     input,
                     filter,
@@ -54,6 +144,18 @@ void DepthwiseConvKernel(const Context& dev_ctx,
                          const std::vector<int>& dilations,
                          const std::string& data_format,
                          DenseTensor* out) {
+  if (FastConv2dKernel<T>(dev_ctx,
+                          input,
+                          filter,
+                          strides,
+                          paddings,
+                          padding_algorithm,
+                          groups,
+                          dilations,
+                          data_format,
+                          out)) {
+    return;
+  }
   ConvKernelImpl<T>(dev_ctx,
                     input,
                     filter,
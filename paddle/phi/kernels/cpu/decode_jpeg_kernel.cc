@@ -26,7 +26,25 @@ void DecodeJpegKernel(const Context& dev_ctx,
                       DenseTensor* out) {
   PADDLE_THROW(errors::Unimplemented("DecodeJpeg op only supports GPU now."));
 }
+
+template <typename T, typename Context>
+void DecodeJpegBatchKernel(const Context& dev_ctx,
+                           const DenseTensor& x,
+                           const DenseTensor& offsets,
+                           const paddle::optional<DenseTensor>& boxes,
+                           const paddle::optional<DenseTensor>& flip,
+                           const std::vector<int>& size,
+                           const std::vector<float>& mean,
+                           const std::vector<float>& std,
+                           const std::string& mode,
+                           DenseTensor* out) {
+  PADDLE_THROW(
+      errors::Unimplemented("DecodeJpegBatch op only supports GPU now."));
+}
 }  // namespace phi
 
 PD_REGISTER_KERNEL(
     decode_jpeg, CPU, ALL_LAYOUT, phi::DecodeJpegKernel, uint8_t) {}
+
+PD_REGISTER_KERNEL(
+    decode_jpeg_batch, CPU, ALL_LAYOUT, phi::DecodeJpegBatchKernel, uint8_t) {}
@@ -0,0 +1,59 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/fp8_dequantize_kernel.h"
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+namespace phi {
+
+template <typename T, typename OutT>
+static void Fp8DequantizeImpl(const CPUContext& dev_ctx,
+                              const DenseTensor& x,
+                              const float scale_inv,
+                              DenseTensor* out) {
+  const T* x_data = x.data<T>();
+  OutT* out_data = dev_ctx.template Alloc<OutT>(out);
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    out_data[i] = static_cast<OutT>(static_cast<float>(x_data[i]) * scale_inv);
+  }
+}
+
+template <typename T, typename Context>
+void Fp8DequantizeKernel(const Context& dev_ctx,
+                         const DenseTensor& x,
+                         const DenseTensor& scale,
+                         DataType out_dtype,
+                         DenseTensor* out) {
+  const float scale_inv = 1.f / scale.data<float>()[0];
+  if (out_dtype == DataType::FLOAT32) {
+    Fp8DequantizeImpl<T, float>(dev_ctx, x, scale_inv, out);
+  } else if (out_dtype == DataType::FLOAT16) {
+    Fp8DequantizeImpl<T, phi::dtype::float16>(dev_ctx, x, scale_inv, out);
+  } else {
+    Fp8DequantizeImpl<T, phi::dtype::bfloat16>(dev_ctx, x, scale_inv, out);
+  }
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fp8_dequantize,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::Fp8DequantizeKernel,
+                   phi::dtype::float8_e4m3fn,
+                   phi::dtype::float8_e5m2) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::UNDEFINED);
+}
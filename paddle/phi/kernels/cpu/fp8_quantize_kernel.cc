@@ -0,0 +1,71 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/fp8_quantize_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+namespace phi {
+
+template <typename T, typename FP8>
+static void Fp8QuantizeImpl(const CPUContext& dev_ctx,
+                            const DenseTensor& x,
+                            const float scale,
+                            DenseTensor* out,
+                            float* amax) {
+  const T* x_data = x.data<T>();
+  FP8* out_data = dev_ctx.template Alloc<FP8>(out);
+  float max_value = 0.f;
+  for (int64_t i = 0; i < x.numel(); ++i) {
+    const float v = static_cast<float>(x_data[i]);
+    max_value = std::max(max_value, std::abs(v));
+    out_data[i] = FP8(v * scale);
+  }
+  *amax = max_value;
+}
+
+template <typename T, typename Context>
+void Fp8QuantizeKernel(const Context& dev_ctx,
+                       const DenseTensor& x,
+                       const DenseTensor& scale,
+                       DataType out_dtype,
+                       DenseTensor* out,
+                       DenseTensor* amax) {
+  const float scale_value = scale.data<float>()[0];
+  float* amax_data = dev_ctx.template Alloc<float>(amax);
+  if (out_dtype == DataType::FLOAT8_E4M3FN) {
+    Fp8QuantizeImpl<T, phi::dtype::float8_e4m3fn>(
+        dev_ctx, x, scale_value, out, amax_data);
+  } else {
+    Fp8QuantizeImpl<T, phi::dtype::float8_e5m2>(
+        dev_ctx, x, scale_value, out, amax_data);
+  }
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fp8_quantize,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::Fp8QuantizeKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::UNDEFINED);
+  kernel->OutputAt(1).SetDataType(phi::DataType::FLOAT32);
+}
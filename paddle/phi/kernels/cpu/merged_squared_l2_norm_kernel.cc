@@ -0,0 +1,53 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/merged_squared_l2_norm_kernel.h"
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+namespace phi {
+
+template <typename T, typename Context>
+void MergedSquaredL2NormKernel(const Context& dev_ctx,
+                               const std::vector<const DenseTensor*>& x,
+                               DenseTensor* out) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  MT sum = static_cast<MT>(0);
+  for (const auto* t : x) {
+    const T* data = t->data<T>();
+    for (int64_t i = 0; i < t->numel(); ++i) {
+      MT value = static_cast<MT>(data[i]);
+      sum += value * value;
+    }
+  }
+  *dev_ctx.template Alloc<MT>(out) = sum;
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(merged_squared_l2_norm,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::MergedSquaredL2NormKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  if (kernel_key.dtype() == phi::DataType::FLOAT16 ||
+      kernel_key.dtype() == phi::DataType::BFLOAT16) {
+    kernel->OutputAt(0).SetDataType(phi::DataType::FLOAT32);
+  }
+}
@@ -14,6 +14,8 @@
 
 #include "paddle/phi/kernels/rnn_kernel.h"
 
+#include <algorithm>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
@@ -843,20 +845,46 @@ void RnnKernel(const Context& dev_ctx,
 
   // init the output and allocate the memory
   dev_ctx.template Alloc<T>(out);
+
+  // The steps beyond the longest sequence are the padding of all the
+  // sequences, which only output zeros and keep the states, so they are
+  // skipped in the inference.
+  const DenseTensor* input = &x;
+  DenseTensor* output = out;
+  DenseTensor trimmed_x, trimmed_out;
+  if (is_test && sequence_length) {
+    const auto seq_len_vec =
+        phi::GetVectorFromTensor<int>(sequence_length.get_ptr());
+    const int64_t time_step = x.dims()[0];
+    const int64_t max_len =
+        seq_len_vec.empty()
+            ? time_step
+            : *std::max_element(seq_len_vec.begin(), seq_len_vec.end());
+    if (max_len > 0 && max_len < time_step) {
+      trimmed_x = x.Slice(0, max_len);
+      trimmed_out = out->Slice(0, max_len);
+      DenseTensor padding_out = out->Slice(max_len, time_step);
+      phi::funcs::SetConstant<Context, T> zero;
+      zero(dev_ctx, &padding_out, static_cast<T>(0));
+      input = &trimmed_x;
+      output = &trimmed_out;
+    }
+  }
+
   int gate_num = 4;
   dev_ctx.template Alloc<T>(state[0]);
   if (is_lstm(mode)) {
     dev_ctx.template Alloc<T>(state[1]);
     RnnFunc<LSTMCell<T>, Layer, SingleLayer, BidirLayer, T>(
         dev_ctx,
-        &x,
+        input,
         weight_list,
         pre_state[0],
         pre_state[1],
         sequence_length.get_ptr(),
         state[0],
         state[1],
-        out,
+        output,
         dropout_state,
         num_layers,
         gate_num,
@@ -877,14 +905,14 @@ void RnnKernel(const Context& dev_ctx,
             SingleLayer,
             BidirLayer,
             T>(dev_ctx,
-               &x,
+               input,
                weight_list,
                pre_state[0],
                nullptr,
                sequence_length.get_ptr(),
                state[0],
                nullptr,
-               out,
+               output,
                dropout_state,
                num_layers,
                gate_num,
@@ -905,14 +933,14 @@ void RnnKernel(const Context& dev_ctx,
             SingleLayer,
             BidirLayer,
             T>(dev_ctx,
-               &x,
+               input,
                weight_list,
                pre_state[0],
                nullptr,
                sequence_length.get_ptr(),
                state[0],
                nullptr,
-               out,
+               output,
                dropout_state,
                num_layers,
                gate_num,
@@ -928,14 +956,14 @@ void RnnKernel(const Context& dev_ctx,
     gate_num = 3;
     RnnFunc<GRUCell<T>, Layer, SingleLayer, BidirLayer, T>(
         dev_ctx,
-        &x,
+        input,
         weight_list,
         pre_state[0],
         nullptr,
         sequence_length.get_ptr(),
         state[0],
         nullptr,
-        out,
+        output,
         dropout_state,
         num_layers,
         gate_num,
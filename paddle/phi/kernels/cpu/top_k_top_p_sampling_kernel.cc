@@ -0,0 +1,147 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/top_k_top_p_sampling_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <random>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+namespace phi {
+
+template <typename T, typename Context>
+void TopKTopPSamplingKernel(const Context& dev_ctx,
+                            const DenseTensor& x,
+                            const DenseTensor& top_p,
+                            const paddle::optional<DenseTensor>& pre_ids,
+                            float temperature,
+                            int top_k,
+                            float min_p,
+                            float repetition_penalty,
+                            int seed,
+                            DenseTensor* out,
+                            DenseTensor* ids) {
+  const int bsz = static_cast<int>(x.dims()[0]);
+  const int vocab_size = static_cast<int>(x.dims()[1]);
+  const T* x_data = x.data<T>();
+  const float* top_p_data = top_p.data<float>();
+  T* out_data = dev_ctx.template Alloc<T>(out);
+  int64_t* ids_data = dev_ctx.template Alloc<int64_t>(ids);
+
+  std::shared_ptr<std::mt19937_64> engine;
+  if (seed >= 0) {
+    engine = std::make_shared<std::mt19937_64>(seed);
+  } else {
+    engine = dev_ctx.GetGenerator()->GetCPUEngine();
+  }
+
+  std::vector<float> logits(vocab_size);
+  std::vector<float> sorted;
+  for (int row = 0; row < bsz; ++row) {
+    const T* x_row = x_data + static_cast<int64_t>(row) * vocab_size;
+    for (int i = 0; i < vocab_size; ++i) {
+      logits[i] = static_cast<float>(x_row[i]) / temperature;
+    }
+    if (pre_ids && repetition_penalty != 1.f) {
+      int len = static_cast<int>(pre_ids->dims()[1]);
+      const int64_t* pre_ids_row = pre_ids->data<int64_t>() + row * len;
+      for (int j = 0; j < len; ++j) {
+        int64_t id = pre_ids_row[j];
+        if (id < 0 || id >= vocab_size) {
+          continue;
+        }
+        float value = static_cast<float>(x_row[id]);
+        value = value > 0 ? value / repetition_penalty
+                          : value * repetition_penalty;
+        logits[id] = value / temperature;
+      }
+    }
+    float max_logit = *std::max_element(logits.begin(), logits.end());
+
+    // the candidates are the logits no less than lower
+    float lower = -std::numeric_limits<float>::infinity();
+    if (top_k > 0 && top_k < vocab_size) {
+      sorted = logits;
+      std::nth_element(sorted.begin(),
+                       sorted.begin() + top_k - 1,
+                       sorted.end(),
+                       std::greater<float>());
+      lower = sorted[top_k - 1];
+    }
+    if (min_p > 0.f) {
+      lower = std::max(lower, max_logit + std::log(min_p));
+    }
+    float p = top_p_data[row];
+    if (p <= 0.f) {
+      lower = max_logit;
+    } else if (p < 1.f) {
+      sorted.clear();
+      float mass = 0.f;
+      for (float logit : logits) {
+        if (logit >= lower) {
+          sorted.push_back(logit);
+          mass += std::exp(logit - max_logit);
+        }
+      }
+      std::sort(sorted.begin(), sorted.end(), std::greater<float>());
+      float target = p * mass;
+      float sum = 0.f;
+      for (float logit : sorted) {
+        sum += std::exp(logit - max_logit);
+        lower = logit;
+        if (sum >= target) {
+          break;
+        }
+      }
+    }
+
+    float mass = 0.f;
+    for (float logit : logits) {
+      if (logit >= lower) {
+        mass += std::exp(logit - max_logit);
+      }
+    }
+    std::uniform_real_distribution<float> dist(0.f, mass);
+    float u = dist(*engine);
+    int id = -1;
+    float sum = 0.f;
+    for (int i = 0; i < vocab_size; ++i) {
+      if (logits[i] < lower) {
+        continue;
+      }
+      id = i;
+      sum += std::exp(logits[i] - max_logit);
+      if (sum >= u) {
+        break;
+      }
+    }
+    ids_data[row] = id;
+    out_data[row] = static_cast<T>(std::exp(logits[id] - max_logit) / mass);
+  }
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(top_k_top_p_sampling,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::TopKTopPSamplingKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
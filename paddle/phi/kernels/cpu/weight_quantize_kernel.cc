@@ -105,10 +105,37 @@ void WeightQuantizeKernel(const Context& dev_ctx,
                           const DenseTensor& x,
                           const std::string& algo,
                           const int32_t arch,
+                          const int32_t group_size,
                           DenseTensor* out,
                           DenseTensor* scale) {
   dev_ctx.template Alloc<int8_t>(out);
   dev_ctx.template Alloc<T>(scale);
+  if (group_size > 0) {
+    // The grouped weight isn't permuted for the CUTLASS mixed gemm.
+    size_t m = x.dims()[0];
+    size_t n = x.dims()[1];
+    if (algo == "weight_only_int8") {
+      group_wise_quant<T, 8>(out->data<int8_t>(),
+                             scale->data<T>(),
+                             x.data<T>(),
+                             m,
+                             n,
+                             group_size);
+    } else if (algo == "weight_only_int4") {
+      group_wise_quant<T, 4>(out->data<int8_t>(),
+                             scale->data<T>(),
+                             x.data<T>(),
+                             m,
+                             n,
+                             group_size);
+    } else {
+      PADDLE_THROW(phi::errors::Unimplemented(
+          "The grouped algo must be in ['weight_only_int8', "
+          "'weight_only_int4'], but got[%s]",
+          algo));
+    }
+    return;
+  }
   if (algo == "weight_only_int8" || algo == "llm.int8") {
     quant_compute<Context, T, int8_t, 8>(dev_ctx, x, out, scale, algo, arch);
   } else if (algo == "weight_only_int4") {
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "paddle/phi/core/dense_tensor.h"
+#include "paddle/utils/optional.h"
 
 namespace phi {
 
@@ -23,4 +24,22 @@ void DecodeJpegKernel(const Context& dev_ctx,
                       const DenseTensor& x,
                       const std::string& mode,
                       DenseTensor* out);
+
+// Decodes a batch of JPEG images, whose bytes are concatenated in x and end
+// at offsets, and crops, resizes, flips and normalizes them into the float
+// batch out of [batch_size, channels, size[0], size[1]]. boxes are the
+// crops (x0, y0, x1, y1) relative to the images, the whole images if not
+// given, and flip the images flipped horizontally after the crop.
+template <typename T, typename Context>
+void DecodeJpegBatchKernel(const Context& dev_ctx,
+                           const DenseTensor& x,
+                           const DenseTensor& offsets,
+                           const paddle::optional<DenseTensor>& boxes,
+                           const paddle::optional<DenseTensor>& flip,
+                           const std::vector<int>& size,
+                           const std::vector<float>& mean,
+                           const std::vector<float>& std,
+                           const std::string& mode,
+                           DenseTensor* out);
+
 }  // namespace phi
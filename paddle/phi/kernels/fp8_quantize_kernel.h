@@ -0,0 +1,31 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+
+// out = fp8(x * scale) in out_dtype, which is saturated to the max of the
+// fp8 format, and amax = max(|x|), which is recorded for the delayed scaling
+template <typename T, typename Context>
+void Fp8QuantizeKernel(const Context& dev_ctx,
+                       const DenseTensor& x,
+                       const DenseTensor& scale,
+                       DataType out_dtype,
+                       DenseTensor* out,
+                       DenseTensor* amax);
+
+}  // namespace phi
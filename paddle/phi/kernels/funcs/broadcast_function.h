@@ -36,6 +36,7 @@ struct BroadcastTypeClassifier {
   int64_t numel{0};
   int broadcast_num{0};              // Not used for XPU
   bool all_elementwise{true};        // Not used for XPU
+  bool has_strided_input{false};     // Not used for XPU
   Array<bool, Arity> use_broadcast;  // Not used for XPU
   Array<kps::details::BroadcastConfig, Arity> configs;
   Array<const _ptr_ char *__restrict__, Arity> ins_data;
@@ -49,7 +50,11 @@ struct BroadcastTypeClassifier {
 
 #ifndef PADDLE_WITH_XPU_KP
     for (size_t i = 0; i < ins.size(); ++i) {
-      bool is_same_dim = ins[i]->numel() == numel;
+      // the inputs not contiguous are read through their strides as the
+      // broadcast ones
+      bool is_contiguous = ins[i]->meta().is_contiguous();
+      has_strided_input |= !is_contiguous;
+      bool is_same_dim = ins[i]->numel() == numel && is_contiguous;
       if (is_same_dim) {
         use_broadcast[i] = false;
       } else {
@@ -90,7 +95,16 @@ struct BroadcastTypeClassifier {
                                                dims_simplifier.in_dims[0],
                                                dims_simplifier.rank);
 #else
-    if (!all_elementwise) {
+    if (has_strided_input) {
+      const auto dims_simplifier =
+          StridedBroadcastDimsSimplifier(ins, (*outs)[0]->dims(), axis);
+      for (int i = 0; i < Arity; ++i) {
+        configs[i] = kps::details::BroadcastConfig::FromStrides(
+            dims_simplifier.out_dims,
+            dims_simplifier.in_strides[i],
+            dims_simplifier.rank);
+      }
+    } else if (!all_elementwise) {
       const auto dims_simplifier =
           BroadcastDimsSimplifier(ins, (*outs)[0]->dims(), axis);
       if (VLOG_IS_ON(6)) {
@@ -566,6 +580,29 @@ BroadcastKernelForDifferentVecSize(const KPDevice &ctx,
   }
 }
 
+// Whether the broadcast kernel can read the inputs, some of which may not be
+// contiguous, through their strides, i.e. the offsets of all the elements fit
+// in its 32-bit index.
+static bool CanReadStridedInputs(const std::vector<const DenseTensor *> &ins,
+                                 const DenseTensor &out) {
+  bool has_strided_input = false;
+  for (auto *in : ins) {
+    if (in->meta().is_contiguous()) {
+      continue;
+    }
+    has_strided_input = true;
+    int64_t max_offset = 0;
+    for (int i = 0; i < in->dims().size(); ++i) {
+      max_offset += (in->dims()[i] - 1) * in->strides()[i];
+    }
+    if (max_offset >= std::numeric_limits<uint32_t>::max()) {
+      return false;
+    }
+  }
+  return !has_strided_input ||
+         out.numel() < std::numeric_limits<int32_t>::max();
+}
+
 static void updateStridesDims(std::vector<int64_t> *strides,
                               std::vector<int64_t> *dims) {
   for (int i = 1; i < strides->size(); i++) {
@@ -819,6 +856,14 @@ void BroadcastKernel(const KPDevice &ctx,
     max_rank = std::max(max_rank, (*outs)[0]->dims().size());
   }
   axis = axis == -1 ? max_rank - min_rank : axis;
+#ifndef PADDLE_WITH_XPU_KP
+  PADDLE_ENFORCE_EQ(
+      CanReadStridedInputs(ins, *(*outs)[0]),
+      true,
+      phi::errors::Unimplemented(
+          "The inputs not contiguous of BroadcastKernel should be indexed by "
+          "32 bits, please make them contiguous first."));
+#endif
   BroadcastKernelApply<OutT, Functor, kArity, NumOuts>(
       ctx, ins, outs, axis, func);
 }
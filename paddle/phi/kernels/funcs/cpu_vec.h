@@ -474,6 +474,58 @@ inline void vec_add_bias<float, backends::cpu::avx512f>(const int n,
   vec_add_bias<float, backends::cpu::avx2>(n, a, x, y);
 }
 
+template <typename T, backends::cpu::cpu_isa_t isa = backends::cpu::isa_any>
+inline void vec_axpy(const int n, const T a, const T* x, T* y) {
+  for (int i = 0; i < n; ++i) {
+    y[i] += a * x[i];
+  }
+}
+
+template <>
+inline void vec_axpy<float, backends::cpu::avx>(const int n,
+                                                const float a,
+                                                const float* x,
+                                                float* y) {
+#ifdef __AVX__
+  constexpr int block = YMM_FLOAT_BLOCK;
+  if (n < block) {
+    vec_axpy<float, backends::cpu::isa_any>(n, a, x, y);
+    return;
+  }
+  const int rest = n % block;
+  const int end = n - rest;
+  int i = 0;
+  __m256 scalar = _mm256_set1_ps(a);
+  for (i = 0; i < end; i += block) {
+    _mm256_storeu_ps(y + i,
+                     _mm256_add_ps(_mm256_loadu_ps(y + i),
+                                   _mm256_mul_ps(_mm256_loadu_ps(x + i),
+                                                 scalar)));
+  }
+  for (; i < n; ++i) {
+    y[i] += a * x[i];
+  }
+#else
+  vec_axpy<float, backends::cpu::isa_any>(n, a, x, y);
+#endif
+}
+
+template <>
+inline void vec_axpy<float, backends::cpu::avx2>(const int n,
+                                                 const float a,
+                                                 const float* x,
+                                                 float* y) {
+  vec_axpy<float, backends::cpu::avx>(n, a, x, y);
+}
+
+template <>
+inline void vec_axpy<float, backends::cpu::avx512f>(const int n,
+                                                    const float a,
+                                                    const float* x,
+                                                    float* y) {
+  vec_axpy<float, backends::cpu::avx2>(n, a, x, y);
+}
+
 template <typename T, backends::cpu::cpu_isa_t isa = backends::cpu::isa_any>
 inline void vec_identity(const int n UNUSED, const T* x UNUSED, T* y UNUSED) {
   // do nothing
@@ -16,9 +16,13 @@ limitations under the License. */
 
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include "paddle/phi/backends/dynload/cublasLt.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
 #include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
 
 namespace dyl = phi::dynload;
 
@@ -227,4 +231,146 @@ class CublasLtHelper {
   size_t workspace_size_ = 0;
 };
 
+
+#if CUDA_VERSION >= 11080
+// The fp8 gemm of cuBLASLt on sm89 and later,
+//   out [m, n] = x [m, k] * weight [n, k]^T * x_scale_inv * weight_scale_inv
+//                + bias [n],
+// where x and weight are float8_e4m3fn or float8_e5m2 (not both e5m2), and
+// out and bias are T, float16 or bfloat16. The fp8 gemm only supports the
+// TN layout, so that the weight is given transposed as in CublasLtHelper, and
+// k and n must be multiples of 16. The scales are device pointers, which are
+// computed on the device by the delayed scaling.
+template <typename T>
+class CublasLtFp8Helper {
+ public:
+  CublasLtFp8Helper(int m,
+                    int k,
+                    int n,
+                    cudaDataType_t x_type,
+                    cudaDataType_t weight_type,
+                    bool has_bias,
+                    size_t workspace_size,
+                    cublasLtHandle_t handle)
+      : handle_(handle), workspace_size_(workspace_size) {
+    constexpr cudaDataType_t out_type =
+        std::is_same<T, phi::dtype::float16>::value ? CUDA_R_16F
+                                                    : CUDA_R_16BF;
+    PADDLE_ENFORCE_GPU_SUCCESS(dyl::cublasLtMatmulDescCreate(
+        &matmul_desc_, CUBLAS_COMPUTE_32F, CUDA_R_32F));
+    cublasOperation_t op_transpose = CUBLAS_OP_T;
+    cublasOperation_t op_normal = CUBLAS_OP_N;
+    SetDescAttribute(CUBLASLT_MATMUL_DESC_TRANSA, &op_transpose);
+    SetDescAttribute(CUBLASLT_MATMUL_DESC_TRANSB, &op_normal);
+    // the fast accumulation of the tensor cores is used for the forward
+    int8_t fast_accum = 1;
+    SetDescAttribute(CUBLASLT_MATMUL_DESC_FAST_ACCUM, &fast_accum);
+    cublasLtEpilogue_t epilogue =
+        has_bias ? CUBLASLT_EPILOGUE_BIAS : CUBLASLT_EPILOGUE_DEFAULT;
+    SetDescAttribute(CUBLASLT_MATMUL_DESC_EPILOGUE, &epilogue);
+    if (has_bias) {
+      cudaDataType_t bias_type = out_type;
+      SetDescAttribute(CUBLASLT_MATMUL_DESC_BIAS_DATA_TYPE, &bias_type);
+    }
+
+    // the column major weight^T [k, n] is "A" and x^T [k, m] is "B"
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        dyl::cublasLtMatrixLayoutCreate(&w_desc_, weight_type, k, n, k));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        dyl::cublasLtMatrixLayoutCreate(&x_desc_, x_type, k, m, k));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        dyl::cublasLtMatrixLayoutCreate(&out_desc_, out_type, n, m, n));
+
+    cublasLtMatmulPreference_t preference;
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        dyl::cublasLtMatmulPreferenceCreate(&preference));
+    PADDLE_ENFORCE_GPU_SUCCESS(dyl::cublasLtMatmulPreferenceSetAttribute(
+        preference,
+        CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES,
+        &workspace_size_,
+        sizeof(workspace_size_)));
+    cublasLtMatmulHeuristicResult_t heuristic;
+    int returned_results = 0;
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        dyl::cublasLtMatmulAlgoGetHeuristic(handle_,
+                                            matmul_desc_,
+                                            w_desc_,
+                                            x_desc_,
+                                            out_desc_,
+                                            out_desc_,
+                                            preference,
+                                            1,
+                                            &heuristic,
+                                            &returned_results));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        dyl::cublasLtMatmulPreferenceDestroy(preference));
+    PADDLE_ENFORCE_GT(
+        returned_results,
+        0,
+        phi::errors::Unavailable("cuBLASLt has no fp8 gemm algorithm for "
+                                 "m = %d, k = %d and n = %d.",
+                                 m,
+                                 k,
+                                 n));
+    algo_ = heuristic.algo;
+  }
+
+  ~CublasLtFp8Helper() {
+    dyl::cublasLtMatrixLayoutDestroy(out_desc_);
+    dyl::cublasLtMatrixLayoutDestroy(x_desc_);
+    dyl::cublasLtMatrixLayoutDestroy(w_desc_);
+    dyl::cublasLtMatmulDescDestroy(matmul_desc_);
+  }
+
+  void GEMM(const void* x,
+            const void* weight,
+            const float* x_scale_inv,
+            const float* weight_scale_inv,
+            const T* bias,
+            T* out,
+            void* workspace,
+            cudaStream_t stream) {
+    SetDescAttribute(CUBLASLT_MATMUL_DESC_A_SCALE_POINTER, &weight_scale_inv);
+    SetDescAttribute(CUBLASLT_MATMUL_DESC_B_SCALE_POINTER, &x_scale_inv);
+    if (bias != nullptr) {
+      SetDescAttribute(CUBLASLT_MATMUL_DESC_BIAS_POINTER, &bias);
+    }
+    const float alpha = 1.f;
+    const float beta = 0.f;
+    PADDLE_ENFORCE_GPU_SUCCESS(dyl::cublasLtMatmul(handle_,
+                                                   matmul_desc_,
+                                                   &alpha,
+                                                   weight,
+                                                   w_desc_,
+                                                   x,
+                                                   x_desc_,
+                                                   &beta,
+                                                   out,
+                                                   out_desc_,
+                                                   out,
+                                                   out_desc_,
+                                                   &algo_,
+                                                   workspace,
+                                                   workspace_size_,
+                                                   stream));
+  }
+
+ private:
+  template <typename AttrT>
+  void SetDescAttribute(cublasLtMatmulDescAttributes_t attr,
+                        const AttrT* value) {
+    PADDLE_ENFORCE_GPU_SUCCESS(dyl::cublasLtMatmulDescSetAttribute(
+        matmul_desc_, attr, value, sizeof(AttrT)));
+  }
+
+  cublasLtHandle_t handle_;
+  cublasLtMatmulDesc_t matmul_desc_;
+  cublasLtMatrixLayout_t w_desc_;
+  cublasLtMatrixLayout_t x_desc_;
+  cublasLtMatrixLayout_t out_desc_;
+  cublasLtMatmulAlgo_t algo_;
+  size_t workspace_size_;
+};
+#endif
+
 }  // namespace phi
@@ -14,6 +14,8 @@ limitations under the License. */
 
 #pragma once
 
+#include <algorithm>
+
 #include "paddle/common/ddim.h"
 #include "paddle/phi/core/dense_tensor.h"
 
@@ -223,6 +225,127 @@ struct BroadcastDimsSimplifier {
   }
 };
 
+// Simplify the dims of the inputs of arbitrary strides, e.g. the views of
+// transpose or slice, broadcast to the output. Every input gets the strides of
+// its elements along the dims of the output, 0 on the broadcast ones, and two
+// adjacent dims are merged only if they are contiguous to each other in all
+// the inputs, so that the merged dim is still read in the order of the memory.
+// The dims are reversed as the ones of BroadcastDimsSimplifier, i.e.
+// out_dims[0] is the innermost one.
+struct StridedBroadcastDimsSimplifier {
+  using DimVector = std::vector<int64_t>;
+
+  int rank;
+  DimVector out_dims;
+  std::vector<DimVector> in_strides;
+
+ public:
+  StridedBroadcastDimsSimplifier(const std::vector<const DenseTensor *> &ins,
+                                 const phi::DDim &dims,
+                                 int axis) {
+    const int out_rank = dims.size();
+    const int num = ins.size();
+    std::vector<DimVector> origin_strides(num, DimVector(out_rank, 0));
+    for (int j = 0; j < num; ++j) {
+      const auto &in_dims = ins[j]->dims();
+      const auto strides = ins[j]->meta().is_contiguous()
+                               ? DenseTensorMeta::calc_strides(in_dims)
+                               : ins[j]->strides();
+      const int offset = in_dims.size() < out_rank ? axis : 0;
+      for (int in_idx = 0; in_idx < in_dims.size(); ++in_idx) {
+        const int out_idx = in_idx + offset;
+        PADDLE_ENFORCE_EQ(
+            in_dims[in_idx] == dims[out_idx] || in_dims[in_idx] == 1,
+            true,
+            phi::errors::InvalidArgument(
+                "The %d-th dimension of input tensor is expected to be equal "
+                "with the %d-th dimension of output tensor %d or 1, but "
+                "received %d.",
+                in_idx,
+                out_idx,
+                dims[out_idx],
+                in_dims[in_idx]));
+        origin_strides[j][out_idx] = in_dims[in_idx] == 1 ? 0 : strides[in_idx];
+      }
+    }
+
+    in_strides.resize(num);
+    for (int i = out_rank - 1; i >= 0; --i) {
+      if (dims[i] == 1) {
+        continue;
+      }
+      bool mergeable = !out_dims.empty();
+      for (int j = 0; j < num && mergeable; ++j) {
+        mergeable = origin_strides[j][i] ==
+                    in_strides[j].back() * out_dims.back();
+      }
+      if (mergeable) {
+        out_dims.back() *= dims[i];
+        continue;
+      }
+      out_dims.push_back(dims[i]);
+      for (int j = 0; j < num; ++j) {
+        in_strides[j].push_back(origin_strides[j][i]);
+      }
+    }
+    if (out_dims.empty()) {
+      out_dims.push_back(1);
+      for (auto &strides : in_strides) {
+        strides.push_back(0);
+      }
+    }
+    rank = out_dims.size();
+  }
+
+  // The max offset of the elements read from the i-th input.
+  int64_t MaxOffset(int i) const {
+    int64_t offset = 0;
+    for (int d = 0; d < rank; ++d) {
+      offset += (out_dims[d] - 1) * in_strides[i][d];
+    }
+    return offset;
+  }
+};
+
+// Views x of arbitrary strides without gaps or overlaps, e.g. the result of a
+// transpose, as the contiguous tensor of its dims permuted in the order of the
+// strides, dropping the dims of size 1. It returns false for the other
+// strides, e.g. the ones of a slice. perm[i] is the dim of x of the i-th dim
+// of the view.
+inline bool PermutedContiguousView(const DenseTensor &x,
+                                   DenseTensor *view,
+                                   std::vector<int> *perm) {
+  const auto &dims = x.dims();
+  const auto &strides = x.strides();
+  perm->clear();
+  for (int i = 0; i < dims.size(); ++i) {
+    if (dims[i] != 1) {
+      perm->push_back(i);
+    }
+  }
+  if (perm->empty()) {
+    return false;
+  }
+  std::stable_sort(perm->begin(), perm->end(), [&](int a, int b) {
+    return strides[a] > strides[b];
+  });
+  int64_t expected_stride = 1;
+  std::vector<int64_t> view_dims(perm->size());
+  for (int i = static_cast<int>(perm->size()) - 1; i >= 0; --i) {
+    if (strides[(*perm)[i]] != expected_stride) {
+      return false;
+    }
+    view_dims[i] = dims[(*perm)[i]];
+    expected_stride *= dims[(*perm)[i]];
+  }
+  view->ShareDataWith(x);
+  DenseTensorMeta meta(x.dtype(), common::make_ddim(view_dims));
+  meta.layout = x.layout();
+  meta.offset = x.offset();
+  view->set_meta(meta);
+  return true;
+}
+
 // Simplify the input dims and permute dims if possible.
 struct PermuteDimsSimplifier {
  public:
@@ -27,6 +27,7 @@ limitations under the License. */
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/generator.h"
 #include "paddle/phi/core/hostdevice.h"
+#include "paddle/phi/kernels/funcs/philox_state.h"
 
 #if defined(__NVCC__) || defined(__HIPCC__)
 #include "paddle/phi/kernels/funcs/index_impl.cu.h"
@@ -256,8 +257,7 @@ struct normal_distribution<double> {
 /******** Launch GPU function of distribution and transformation *********/
 template <typename T, typename DistOp, typename TransformOp>
 __global__ void DistributionKernel(size_t size,
-                                   uint64_t seed,
-                                   uint64_t offset,
+                                   PhiloxState philox,
                                    DistOp dist,
                                    TransformOp trans,
                                    T *out_data,
@@ -266,11 +266,11 @@ __global__ void DistributionKernel(size_t size,
   static constexpr int kCount = DistOp::kReturnsCount;
 #if defined(__NVCC__)
   curandStatePhilox4_32_10_t state;
-  curand_init(seed, idx + THREAD_ID_X, offset, &state);
+  curand_init(philox.Seed(), idx + THREAD_ID_X, philox.Offset(), &state);
   using SType = curandStatePhilox4_32_10_t;
 #else
   hiprandStatePhilox4_32_10_t state;
-  hiprand_init(seed, idx + THREAD_ID_X, offset, &state);
+  hiprand_init(philox.Seed(), idx + THREAD_ID_X, philox.Offset(), &state);
   using SType = hiprandStatePhilox4_32_10_t;
 #endif
   size_t total_thread = GRID_NUM_X * BLOCK_NUM_X;
@@ -295,7 +295,6 @@ void distribution_and_transform(const GPUContext &ctx,
   T *out_data = ctx.template Alloc<T>(out);
   auto size = out->numel();
   if (size == 0) return;
-  auto gen_cuda = ctx.GetGenerator();
 
   size_t block_size = 256;
   size_t expect_grid_size = (size + block_size - 1) / block_size;
@@ -314,13 +313,11 @@ void distribution_and_transform(const GPUContext &ctx,
   // 'increment' shoulde be multiple of 4
   uint64_t increment = curand4_loop_times * 4;
 
-  auto seed_offset = gen_cuda->IncrementOffset(increment);
-  uint64_t seed = seed_offset.first;
-  uint64_t offset = seed_offset.second;
+  PhiloxState philox = ReservePhiloxOffset(ctx, increment);
 
   DistributionKernel<T, DistOp, TransformOp>
       <<<grid_size, block_size, 0, ctx.stream()>>>(
-          size, seed, offset, dist, trans, out_data, total_thread);
+          size, philox, dist, trans, out_data, total_thread);
 }
 
 #endif
@@ -126,29 +126,25 @@ struct DstMaskFunctor {
 };
 
 template <typename T>
-__global__ void VectorizedRandomGenerator(
-    unsigned int
-        identifier, /* This is used to relate kernel to cudaGraph nodes*/
-    const size_t n,
-    uint64_t seed,
-    const float dropout_prob,
-    const T* src,
-    uint8_t* mask,
-    T* dst,
-    bool is_upscale_in_train,
-    uint64_t increment,
-    size_t main_offset) {
+__global__ void VectorizedRandomGenerator(const size_t n,
+                                          PhiloxState philox,
+                                          const float dropout_prob,
+                                          const T* src,
+                                          uint8_t* mask,
+                                          T* dst,
+                                          bool is_upscale_in_train,
+                                          size_t main_offset) {
   size_t idx = static_cast<size_t>(BLOCK_ID_X * BLOCK_NUM_X);
   static constexpr int kCount =
       phi::funcs::uniform_distribution<float>::kReturnsCount;
   size_t stride = BLOCK_NUM_X * GRID_NUM_X * kCount;
 #ifdef PADDLE_WITH_HIP
   hiprandStatePhilox4_32_10_t state;
-  hiprand_init(seed, idx + THREAD_ID_X, increment, &state);
+  hiprand_init(philox.Seed(), idx + THREAD_ID_X, philox.Offset(), &state);
   using SType = hiprandStatePhilox4_32_10_t;
 #else
   curandStatePhilox4_32_10_t state;
-  curand_init(seed, idx + THREAD_ID_X, increment, &state);
+  curand_init(philox.Seed(), idx + THREAD_ID_X, philox.Offset(), &state);
   using SType = curandStatePhilox4_32_10_t;
 #endif
   T dst_mask[kCount *
@@ -196,18 +192,17 @@ __global__ void VectorizedRandomGenerator(
 
 template <typename T>
 __global__ void VectorizedGeneratorMask(const size_t n,
-                                        uint64_t seed,
+                                        PhiloxState philox,
                                         const float dropout_prob,
                                         const T* src,
                                         uint8_t* mask,
-                                        uint64_t increment,
                                         size_t main_offset,
                                         MaskFunctor<T> mask_functor,
-
                                         const uint64_t* seed_ptr) {
   // Vectorized Generate Mask
   // kCount is 4 for curand_uniform4 is used
-  if (seed_ptr) seed = seed_ptr[0];
+  const uint64_t seed = seed_ptr ? seed_ptr[0] : philox.Seed();
+  const uint64_t increment = philox.Offset();
 
   constexpr int kCount = phi::funcs::uniform_distribution<float>::kReturnsCount;
   size_t idx = static_cast<size_t>(BLOCK_ID_X * BLOCK_NUM_X);
@@ -297,8 +292,7 @@ void DropoutFwGPUKernelDriver(
       return;
     }
 
-    uint64_t seed_data;
-    uint64_t increment;
+    PhiloxState philox;
     // VectorizedRandomGenerator use curand_uniform4, so kVecSize is 4;
     constexpr int kVecSize =
         phi::funcs::uniform_distribution<float>::kReturnsCount;
@@ -320,24 +314,17 @@ void DropoutFwGPUKernelDriver(
 
     if (is_dropout_nd) {
       auto mask_functor = MaskFunctor<T>(1.0f - dropout_prob);
-      bool copy_in_kernel = GetSeedDataAndIncrement(dev_ctx,
-                                                    seed,
-                                                    is_fix_seed,
-                                                    seed_val,
-                                                    offset,
-                                                    &seed_data,
-                                                    &increment,
-                                                    true);
+      bool copy_in_kernel = GetPhiloxState(
+          dev_ctx, seed, is_fix_seed, seed_val, offset, &philox, true);
       const uint64_t* seed_ptr =
           copy_in_kernel ? seed->data<uint64_t>() : nullptr;
 
       VectorizedGeneratorMask<T>
           <<<grid_size, block_size, 0, stream>>>(size,
-                                                 seed_data,
+                                                 philox,
                                                  dropout_prob,
                                                  x_data,
                                                  mask_data,
-                                                 increment,
                                                  main_offset,
                                                  mask_functor,
                                                  seed_ptr);
@@ -347,73 +334,16 @@ void DropoutFwGPUKernelDriver(
       std::vector<phi::DenseTensor*> outs = {y};
       phi::funcs::BroadcastKernel<T>(dev_ctx, ins, &outs, dst_functor);
     } else {
-      bool copy_in_kernel = GetSeedDataAndIncrement(
-          dev_ctx, seed, is_fix_seed, seed_val, offset, &seed_data, &increment);
-#ifdef PADDLE_WITH_HIP
+      GetPhiloxState(dev_ctx, seed, is_fix_seed, seed_val, offset, &philox);
       VectorizedRandomGenerator<T>
-          <<<grid_size, block_size, 0, stream>>>(0,
-                                                 size,
-                                                 seed_data,
+          <<<grid_size, block_size, 0, stream>>>(size,
+                                                 philox,
                                                  dropout_prob,
                                                  x_data,
                                                  mask_data,
                                                  y_data,
                                                  upscale_in_train,
-                                                 increment,
                                                  main_offset);
-#else
-      void* functionPtr =
-          reinterpret_cast<void*>(&(VectorizedRandomGenerator<T>));
-      cudaFunction_t cudaFunc;
-      PADDLE_ENFORCE_GPU_SUCCESS(cudaGetFuncBySymbol(&cudaFunc, functionPtr));
-
-      const phi::GPUContext* dev_ctx_p = &dev_ctx;
-      auto gen_cuda = dev_ctx.GetGenerator();
-      auto state_index = gen_cuda->GetStateIndex();
-
-      phi::backends::gpu::CUDAGraphNodeLauncher::parameterSetter_t
-          parameterSetter = [offset, dev_ctx_p, state_index, is_fix_seed](
-                                phi::backends::gpu::CUDAKernelParams& params) {
-            if (!is_fix_seed) {
-              // we assume seed is null pointer
-              // seed copy to cpu is meaningless here
-              assert(seed_tensor_ptr == nullptr);
-
-              auto gen_cuda = dev_ctx_p->GetGenerator();
-              // ensure the generator use correct state index
-              gen_cuda->SetStateIndex(state_index);
-
-              uint64_t seed, increment;
-              std::tie(seed, increment) = gen_cuda->IncrementOffset(offset);
-
-              params.As<uint64_t>(2) = seed;
-              params.As<uint64_t>(8) = increment;
-
-              VLOG(10) << "CUDA_GRAPH seed = " << seed
-                       << ", increment = " << increment;
-            }
-          };
-
-      phi::backends::gpu::CUDAGraphNodeLauncher::cudaKernelCallback_t
-          cudaKernelCallback = [=](unsigned int id) {
-            VectorizedRandomGenerator<T>
-                <<<grid_size, block_size, 0, stream>>>(id,
-                                                       size,
-                                                       seed_data,
-                                                       dropout_prob,
-                                                       x_data,
-                                                       mask_data,
-                                                       y_data,
-                                                       upscale_in_train,
-                                                       increment,
-                                                       main_offset);
-          };
-      phi::backends::gpu::CUDAGraphNodeLauncher::Instance().KernelNodeLaunch(
-          cudaFunc, parameterSetter, cudaKernelCallback);
-
-      VLOG(10) << "NON_CUDA_GRAPH seed = " << seed_data
-               << ", increment = " << increment;
-#endif
     }
   } else {
     if (upscale_in_train) {
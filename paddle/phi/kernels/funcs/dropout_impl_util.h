@@ -18,6 +18,7 @@ limitations under the License. */
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/generator.h"
 #include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/funcs/philox_state.h"
 
 namespace phi {
 namespace funcs {
@@ -52,5 +53,35 @@ inline bool GetSeedDataAndIncrement(const phi::GPUContext& dev_ctx,
   }
 }
 
+// The same as GetSeedDataAndIncrement, but reserves the offset from the
+// generator by ReservePhiloxOffset, which the kernels capture in a CUDA
+// Graph safely.
+inline bool GetPhiloxState(const phi::GPUContext& dev_ctx,
+                           const phi::DenseTensor* seed,
+                           const bool is_fix_seed,
+                           const int seed_val,
+                           const int offset,
+                           PhiloxState* philox,
+                           bool use_copy = true) {
+  if (seed == nullptr && !is_fix_seed) {
+    *philox = ReservePhiloxOffset(dev_ctx, offset);
+    return false;
+  }
+  uint64_t seed_data = 0;
+  uint64_t increment = 0;
+  bool copy_in_kernel = GetSeedDataAndIncrement(dev_ctx,
+                                                seed,
+                                                is_fix_seed,
+                                                seed_val,
+                                                offset,
+                                                &seed_data,
+                                                &increment,
+                                                use_copy);
+  philox->seed = seed_data;
+  philox->offset = increment;
+  philox->graph_state = nullptr;
+  return copy_in_kernel;
+}
+
 }  // namespace funcs
 }  // namespace phi
@@ -14,8 +14,22 @@
 
 #pragma once
 
+#ifdef __NVCC__
+#include "cub/cub.cuh"
+#endif
+#ifdef __HIPCC__
+#include <hipcub/hipcub.hpp>
+namespace cub = hipcub;
+#endif
+
+#include <algorithm>
+#include <vector>
+
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
 #include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/dense_tensor.h"
 
 namespace phi {
 namespace funcs {
@@ -163,5 +177,317 @@ void LaunchEmbeddingGradDeterministicKernel(const GPUContext& ctx,
   }
 }
 
+// The rows of d_out summed by one partial sum of the sort-reduce backward,
+// which bounds the serial work of the hot ids.
+constexpr int64_t kEmbeddingGradRowsPerPartial = 32;
+
+template <typename IdT>
+__global__ void EmbeddingGradInitKeysKernel(const IdT* ids,
+                                            const int64_t K,
+                                            int64_t* keys,
+                                            int64_t* positions) {
+  CUDA_KERNEL_LOOP_TYPE(i, K, int64_t) {
+    keys[i] = static_cast<int64_t>(ids[i]);
+    positions[i] = i;
+  }
+}
+
+static __global__ void EmbeddingGradPartialsKernel(
+    const int64_t* segment_offsets,
+    const int64_t* segment_lens,
+    const int64_t* partial_offsets,
+    const int64_t* partial_lens,
+    const int64_t unique_num,
+    int64_t* partial_begins,
+    int64_t* partial_ends,
+    int64_t* partial_num) {
+  CUDA_KERNEL_LOOP_TYPE(i, unique_num, int64_t) {
+    const int64_t segment_end = segment_offsets[i] + segment_lens[i];
+    for (int64_t j = 0; j < partial_lens[i]; ++j) {
+      const int64_t begin =
+          segment_offsets[i] + j * kEmbeddingGradRowsPerPartial;
+      partial_begins[partial_offsets[i] + j] = begin;
+      partial_ends[partial_offsets[i] + j] =
+          min(begin + kEmbeddingGradRowsPerPartial, segment_end);
+    }
+    if (i == unique_num - 1) {
+      *partial_num = partial_offsets[i] + partial_lens[i];
+    }
+  }
+}
+
+static __global__ void EmbeddingGradPartialLensKernel(
+    const int64_t* segment_lens,
+    const int64_t unique_num,
+    int64_t* partial_lens) {
+  CUDA_KERNEL_LOOP_TYPE(i, unique_num, int64_t) {
+    partial_lens[i] = (segment_lens[i] + kEmbeddingGradRowsPerPartial - 1) /
+                      kEmbeddingGradRowsPerPartial;
+  }
+}
+
+template <typename T, typename MT>
+__global__ void EmbeddingGradPartialSumKernel(const T* d_out,
+                                              const int64_t* positions,
+                                              const int64_t* partial_begins,
+                                              const int64_t* partial_ends,
+                                              const int64_t* partial_num,
+                                              const int64_t D,
+                                              MT* partial_sums) {
+  const int64_t feature = threadIdx.x + blockIdx.x * blockDim.x;
+  if (feature >= D) {
+    return;
+  }
+  const int64_t num = *partial_num;
+  for (int64_t p = threadIdx.y + blockIdx.y * blockDim.y; p < num;
+       p += blockDim.y * gridDim.y) {
+    MT sum = static_cast<MT>(0);
+    for (int64_t row = partial_begins[p]; row < partial_ends[p]; ++row) {
+      sum += static_cast<MT>(d_out[positions[row] * D + feature]);
+    }
+    partial_sums[p * D + feature] = sum;
+  }
+}
+
+template <typename T, typename MT>
+__global__ void EmbeddingGradSegmentSumKernel(const MT* partial_sums,
+                                              const int64_t* partial_offsets,
+                                              const int64_t* partial_lens,
+                                              const int64_t* unique_ids,
+                                              const int64_t unique_num,
+                                              const int64_t D,
+                                              const bool index_by_id,
+                                              T* out) {
+  const int64_t feature = threadIdx.x + blockIdx.x * blockDim.x;
+  if (feature >= D) {
+    return;
+  }
+  for (int64_t i = threadIdx.y + blockIdx.y * blockDim.y; i < unique_num;
+       i += blockDim.y * gridDim.y) {
+    MT sum = static_cast<MT>(0);
+    for (int64_t j = 0; j < partial_lens[i]; ++j) {
+      sum += partial_sums[(partial_offsets[i] + j) * D + feature];
+    }
+    const int64_t row = index_by_id ? unique_ids[i] : i;
+    out[row * D + feature] = static_cast<T>(sum);
+  }
+}
+
+// The deterministic backward of embedding which sums the rows of d_out of
+// the same ids without atomics: the ids are sorted stably with the positions
+// of their rows, and the rows of every id are summed in the order of the
+// positions, first in partial sums of kEmbeddingGradRowsPerPartial rows and
+// then over the partial sums. The result is bitwise reproducible, and the hot
+// ids are summed by many threads instead of contending on the same row.
+template <typename IdT>
+class EmbeddingGradSortReducer {
+ public:
+  // Sorts the K ids in [0, N), which waits for the number of the unique ids.
+  EmbeddingGradSortReducer(const GPUContext& ctx,
+                           const IdT* ids,
+                           int64_t N,
+                           int64_t K)
+      : ctx_(ctx) {
+    DenseTensor keys = Alloc({K});
+    DenseTensor positions = Alloc({K});
+    sorted_keys_ = Alloc({K});
+    sorted_positions_ = Alloc({K});
+    if (K == 0) {
+      return;
+    }
+    auto config = phi::backends::gpu::GetGpuLaunchConfig1D(ctx, K);
+    EmbeddingGradInitKeysKernel<IdT><<<config.block_per_grid,
+                                       config.thread_per_block,
+                                       0,
+                                       ctx.stream()>>>(
+        ids, K, keys.data<int64_t>(), positions.data<int64_t>());
+
+    // the radix sort is stable, which keeps the rows of the same id in the
+    // order of their positions
+    int end_bit = 1;
+    while (end_bit < 63 && (int64_t(1) << end_bit) < N) {
+      ++end_bit;
+    }
+    size_t temp_bytes = 0;
+    cub::DeviceRadixSort::SortPairs(nullptr,
+                                    temp_bytes,
+                                    keys.data<int64_t>(),
+                                    sorted_keys_.data<int64_t>(),
+                                    positions.data<int64_t>(),
+                                    sorted_positions_.data<int64_t>(),
+                                    static_cast<int>(K),
+                                    0,
+                                    end_bit,
+                                    ctx.stream());
+    auto temp = TempAlloc(temp_bytes);
+    cub::DeviceRadixSort::SortPairs(temp->ptr(),
+                                    temp_bytes,
+                                    keys.data<int64_t>(),
+                                    sorted_keys_.data<int64_t>(),
+                                    positions.data<int64_t>(),
+                                    sorted_positions_.data<int64_t>(),
+                                    static_cast<int>(K),
+                                    0,
+                                    end_bit,
+                                    ctx.stream());
+
+    unique_ids_ = Alloc({K});
+    segment_lens_ = Alloc({K});
+    DenseTensor unique_num = Alloc({1});
+    temp_bytes = 0;
+    cub::DeviceRunLengthEncode::Encode(nullptr,
+                                       temp_bytes,
+                                       sorted_keys_.data<int64_t>(),
+                                       unique_ids_.data<int64_t>(),
+                                       segment_lens_.data<int64_t>(),
+                                       unique_num.data<int64_t>(),
+                                       static_cast<int>(K),
+                                       ctx.stream());
+    temp = TempAlloc(temp_bytes);
+    cub::DeviceRunLengthEncode::Encode(temp->ptr(),
+                                       temp_bytes,
+                                       sorted_keys_.data<int64_t>(),
+                                       unique_ids_.data<int64_t>(),
+                                       segment_lens_.data<int64_t>(),
+                                       unique_num.data<int64_t>(),
+                                       static_cast<int>(K),
+                                       ctx.stream());
+    memory_utils::Copy(phi::CPUPlace(),
+                       &unique_num_,
+                       ctx.GetPlace(),
+                       unique_num.data<int64_t>(),
+                       sizeof(int64_t),
+                       ctx.stream());
+    ctx.Wait();
+
+    segment_offsets_ = Alloc({unique_num_});
+    partial_lens_ = Alloc({unique_num_});
+    partial_offsets_ = Alloc({unique_num_});
+    ExclusiveSum(segment_lens_.data<int64_t>(),
+                 segment_offsets_.data<int64_t>(),
+                 unique_num_);
+    config = phi::backends::gpu::GetGpuLaunchConfig1D(ctx, unique_num_);
+    EmbeddingGradPartialLensKernel<<<config.block_per_grid,
+                                     config.thread_per_block,
+                                     0,
+                                     ctx.stream()>>>(
+        segment_lens_.data<int64_t>(),
+        unique_num_,
+        partial_lens_.data<int64_t>());
+    ExclusiveSum(partial_lens_.data<int64_t>(),
+                 partial_offsets_.data<int64_t>(),
+                 unique_num_);
+
+    // every id has at least one partial and the ids of more than
+    // kEmbeddingGradRowsPerPartial rows have one more for every such rows
+    max_partial_num_ = unique_num_ + K / kEmbeddingGradRowsPerPartial;
+    partial_begins_ = Alloc({max_partial_num_});
+    partial_ends_ = Alloc({max_partial_num_});
+    partial_num_ = Alloc({1});
+    EmbeddingGradPartialsKernel<<<config.block_per_grid,
+                                  config.thread_per_block,
+                                  0,
+                                  ctx.stream()>>>(
+        segment_offsets_.data<int64_t>(),
+        segment_lens_.data<int64_t>(),
+        partial_offsets_.data<int64_t>(),
+        partial_lens_.data<int64_t>(),
+        unique_num_,
+        partial_begins_.data<int64_t>(),
+        partial_ends_.data<int64_t>(),
+        partial_num_.data<int64_t>());
+  }
+
+  int64_t UniqueNum() const { return unique_num_; }
+
+  // The unique ids in the ascending order on the device.
+  const int64_t* UniqueIds() const { return unique_ids_.data<int64_t>(); }
+
+  // Writes the sum of the rows of d_out of id UniqueIds()[i] to the row
+  // UniqueIds()[i] of out if index_by_id, or the row i of out otherwise. The
+  // other rows of out are left untouched.
+  template <typename T>
+  void Reduce(const T* d_out, int64_t D, bool index_by_id, T* out) const {
+    if (unique_num_ == 0 || D == 0) {
+      return;
+    }
+    using MT = typename dtype::MPTypeTrait<T>::Type;
+    auto partial_sums = TempAlloc(max_partial_num_ * D * sizeof(MT));
+    auto* partial_sums_data = reinterpret_cast<MT*>(partial_sums->ptr());
+
+    constexpr int kBlockDimX = 32;
+    constexpr int kBlockDimY = 8;
+    constexpr int64_t kMaxGridDimY = 65535;
+    dim3 threads(kBlockDimX, kBlockDimY);
+    dim3 grids((D + kBlockDimX - 1) / kBlockDimX,
+               std::min<int64_t>(
+                   (max_partial_num_ + kBlockDimY - 1) / kBlockDimY,
+                   kMaxGridDimY));
+    EmbeddingGradPartialSumKernel<T, MT>
+        <<<grids, threads, 0, ctx_.stream()>>>(
+            d_out,
+            sorted_positions_.data<int64_t>(),
+            partial_begins_.data<int64_t>(),
+            partial_ends_.data<int64_t>(),
+            partial_num_.data<int64_t>(),
+            D,
+            partial_sums_data);
+    grids.y = std::min<int64_t>((unique_num_ + kBlockDimY - 1) / kBlockDimY,
+                                kMaxGridDimY);
+    EmbeddingGradSegmentSumKernel<T, MT>
+        <<<grids, threads, 0, ctx_.stream()>>>(partial_sums_data,
+                                               partial_offsets_.data<int64_t>(),
+                                               partial_lens_.data<int64_t>(),
+                                               unique_ids_.data<int64_t>(),
+                                               unique_num_,
+                                               D,
+                                               index_by_id,
+                                               out);
+  }
+
+ private:
+  DenseTensor Alloc(const std::vector<int64_t>& dims) const {
+    DenseTensor tensor;
+    tensor.Resize(common::make_ddim(dims));
+    ctx_.Alloc<int64_t>(&tensor);
+    return tensor;
+  }
+
+  // the temporary buffers are released in the order of the stream
+  Allocator::AllocationPtr TempAlloc(size_t bytes) const {
+    return memory_utils::Alloc(
+        ctx_.GetPlace(),
+        bytes,
+        phi::Stream(reinterpret_cast<phi::StreamId>(ctx_.stream())));
+  }
+
+  void ExclusiveSum(const int64_t* in, int64_t* out, int64_t num) const {
+    size_t temp_bytes = 0;
+    cub::DeviceScan::ExclusiveSum(
+        nullptr, temp_bytes, in, out, static_cast<int>(num), ctx_.stream());
+    auto temp = TempAlloc(temp_bytes);
+    cub::DeviceScan::ExclusiveSum(temp->ptr(),
+                                  temp_bytes,
+                                  in,
+                                  out,
+                                  static_cast<int>(num),
+                                  ctx_.stream());
+  }
+
+  const GPUContext& ctx_;
+  int64_t unique_num_{0};
+  int64_t max_partial_num_{0};
+  DenseTensor sorted_keys_;
+  DenseTensor sorted_positions_;
+  DenseTensor unique_ids_;
+  DenseTensor segment_lens_;
+  DenseTensor segment_offsets_;
+  DenseTensor partial_lens_;
+  DenseTensor partial_offsets_;
+  DenseTensor partial_begins_;
+  DenseTensor partial_ends_;
+  DenseTensor partial_num_;
+};
+
 }  // namespace funcs
 }  // namespace phi
@@ -0,0 +1,384 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/fast_conv2d.h"
+
+#include <algorithm>
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/kernels/empty_kernel.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/cpu_vec.h"
+
+namespace phi {
+namespace funcs {
+
+namespace {
+
+// The transform matrices of Winograd F(m x m, 3 x 3), see "Fast Algorithms
+// for Convolutional Neural Networks" by Lavin and Gray. A tile of the output
+// is Y = At * [(G * g * Gt) .* (Bt * d * B)] * A, where d is an input tile of
+// kAlpha x kAlpha and g is a 3 x 3 filter.
+template <typename T, int M>
+struct WinogradMatrices;
+
+template <typename T>
+struct WinogradMatrices<T, 2> {
+  static constexpr int kAlpha = 4;
+  static constexpr T kBt[4][4] = {
+      {1, 0, -1, 0}, {0, 1, 1, 0}, {0, -1, 1, 0}, {0, 1, 0, -1}};
+  static constexpr T kG[4][3] = {
+      {1, 0, 0}, {0.5, 0.5, 0.5}, {0.5, -0.5, 0.5}, {0, 0, 1}};
+  static constexpr T kAt[2][4] = {{1, 1, 1, 0}, {0, 1, -1, -1}};
+};
+
+template <typename T>
+struct WinogradMatrices<T, 4> {
+  static constexpr int kAlpha = 6;
+  static constexpr T kBt[6][6] = {{4, 0, -5, 0, 1, 0},
+                                  {0, -4, -4, 1, 1, 0},
+                                  {0, 4, -4, -1, 1, 0},
+                                  {0, -2, -1, 2, 1, 0},
+                                  {0, 2, -1, -2, 1, 0},
+                                  {0, 4, 0, -5, 0, 1}};
+  static constexpr T kG[6][3] = {{1.0 / 4, 0, 0},
+                                 {-1.0 / 6, -1.0 / 6, -1.0 / 6},
+                                 {-1.0 / 6, 1.0 / 6, -1.0 / 6},
+                                 {1.0 / 24, 1.0 / 12, 1.0 / 6},
+                                 {1.0 / 24, -1.0 / 12, 1.0 / 6},
+                                 {0, 0, 1}};
+  static constexpr T kAt[4][6] = {{1, 1, 1, 1, 1, 0},
+                                  {0, 1, -1, 2, -2, 0},
+                                  {0, 1, 1, 4, 4, 0},
+                                  {0, 1, -1, 8, -8, 1}};
+};
+
+// out = left * in * right^T
+template <typename T, int R, int I, int J, int S>
+inline void MatSandwich(const T (&left)[R][I],
+                        const T (&in)[I][J],
+                        const T (&right)[S][J],
+                        T (&out)[R][S]) {
+  T tmp[R][J];
+  for (int r = 0; r < R; ++r) {
+    for (int j = 0; j < J; ++j) {
+      T sum = 0;
+      for (int i = 0; i < I; ++i) {
+        sum += left[r][i] * in[i][j];
+      }
+      tmp[r][j] = sum;
+    }
+  }
+  for (int r = 0; r < R; ++r) {
+    for (int s = 0; s < S; ++s) {
+      T sum = 0;
+      for (int j = 0; j < J; ++j) {
+        sum += tmp[r][j] * right[s][j];
+      }
+      out[r][s] = sum;
+    }
+  }
+}
+
+template <typename T, int M>
+void WinogradConv2dImpl(const CPUContext& dev_ctx,
+                        const DenseTensor& input,
+                        const DenseTensor& filter,
+                        const std::vector<int>& paddings,
+                        DenseTensor* output) {
+  using Mat = WinogradMatrices<T, M>;
+  constexpr int kAlpha = Mat::kAlpha;
+  constexpr int kTileElems = kAlpha * kAlpha;
+
+  const int batch_size = static_cast<int>(input.dims()[0]);
+  const int in_c = static_cast<int>(input.dims()[1]);
+  const int in_h = static_cast<int>(input.dims()[2]);
+  const int in_w = static_cast<int>(input.dims()[3]);
+  const int out_c = static_cast<int>(output->dims()[1]);
+  const int out_h = static_cast<int>(output->dims()[2]);
+  const int out_w = static_cast<int>(output->dims()[3]);
+  const int pad_top = paddings[0];
+  const int pad_left = paddings[2];
+  const int tiles_h = (out_h + M - 1) / M;
+  const int tiles_w = (out_w + M - 1) / M;
+  const int tiles = tiles_h * tiles_w;
+
+  // U of [kTileElems, out_c, in_c], the transformed filter
+  DenseTensor u = phi::Empty<T>(dev_ctx, {kTileElems, out_c, in_c});
+  // V of [kTileElems, in_c, tiles] and the product of [kTileElems, out_c,
+  // tiles], the transformed input and output of an image
+  DenseTensor v = phi::Empty<T>(dev_ctx, {kTileElems, in_c, tiles});
+  DenseTensor m = phi::Empty<T>(dev_ctx, {kTileElems, out_c, tiles});
+  T* u_data = u.data<T>();
+  T* v_data = v.data<T>();
+  T* m_data = m.data<T>();
+  const T* filter_data = filter.data<T>();
+  const T* in_data = input.data<T>();
+  T* out_data = output->data<T>();
+
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int oc = 0; oc < out_c; ++oc) {
+    for (int ic = 0; ic < in_c; ++ic) {
+      const T* g_data = filter_data + (oc * in_c + ic) * 9;
+      T g[3][3];
+      for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+          g[i][j] = g_data[i * 3 + j];
+        }
+      }
+      T res[kAlpha][kAlpha];
+      MatSandwich(Mat::kG, g, Mat::kG, res);
+      for (int xi = 0; xi < kTileElems; ++xi) {
+        u_data[(xi * out_c + oc) * in_c + ic] = res[xi / kAlpha][xi % kAlpha];
+      }
+    }
+  }
+
+  auto blas = GetBlas<CPUContext, T>(dev_ctx);
+  for (int n = 0; n < batch_size; ++n) {
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int ic = 0; ic < in_c; ++ic) {
+      const T* plane = in_data + (n * in_c + ic) * in_h * in_w;
+      for (int t = 0; t < tiles; ++t) {
+        const int h0 = (t / tiles_w) * M - pad_top;
+        const int w0 = (t % tiles_w) * M - pad_left;
+        T d[kAlpha][kAlpha];
+        for (int i = 0; i < kAlpha; ++i) {
+          const int h = h0 + i;
+          for (int j = 0; j < kAlpha; ++j) {
+            const int w = w0 + j;
+            d[i][j] = (h >= 0 && h < in_h && w >= 0 && w < in_w)
+                          ? plane[h * in_w + w]
+                          : static_cast<T>(0);
+          }
+        }
+        T res[kAlpha][kAlpha];
+        MatSandwich(Mat::kBt, d, Mat::kBt, res);
+        for (int xi = 0; xi < kTileElems; ++xi) {
+          v_data[(xi * in_c + ic) * tiles + t] = res[xi / kAlpha][xi % kAlpha];
+        }
+      }
+    }
+
+    // one gemm of [out_c, in_c] x [in_c, tiles] for every element of a tile
+    blas.BatchedGEMM(CblasNoTrans,
+                     CblasNoTrans,
+                     out_c,
+                     tiles,
+                     in_c,
+                     static_cast<T>(1),
+                     u_data,
+                     v_data,
+                     static_cast<T>(0),
+                     m_data,
+                     kTileElems,
+                     static_cast<int64_t>(out_c) * in_c,
+                     static_cast<int64_t>(in_c) * tiles);
+
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int oc = 0; oc < out_c; ++oc) {
+      T* plane = out_data + (n * out_c + oc) * out_h * out_w;
+      for (int t = 0; t < tiles; ++t) {
+        T prod[kAlpha][kAlpha];
+        for (int xi = 0; xi < kTileElems; ++xi) {
+          prod[xi / kAlpha][xi % kAlpha] =
+              m_data[(xi * out_c + oc) * tiles + t];
+        }
+        T y[M][M];
+        MatSandwich(Mat::kAt, prod, Mat::kAt, y);
+        const int h0 = (t / tiles_w) * M;
+        const int w0 = (t % tiles_w) * M;
+        const int rows = std::min(M, out_h - h0);
+        const int cols = std::min(M, out_w - w0);
+        for (int i = 0; i < rows; ++i) {
+          for (int j = 0; j < cols; ++j) {
+            plane[(h0 + i) * out_w + w0 + j] = y[i][j];
+          }
+        }
+      }
+    }
+  }
+}
+
+// y += a * x
+template <typename T>
+inline void RowAxpy(bool use_avx, int n, T a, const T* x, T* y) {
+  if (use_avx) {
+    vec_axpy<T, backends::cpu::avx>(n, a, x, y);
+  } else {
+    vec_axpy<T>(n, a, x, y);
+  }
+}
+
+}  // namespace
+
+CPUConv2dAlgo SelectCPUConv2dAlgo(const DDim& input_dims,
+                                  const DDim& filter_dims,
+                                  const DDim& output_dims,
+                                  const std::vector<int>& strides,
+                                  const std::vector<int>& dilations,
+                                  int groups) {
+  const int64_t in_c = input_dims[1];
+  const int64_t out_c = output_dims[1];
+  if (groups > 1 && groups == in_c && filter_dims[1] == 1 &&
+      out_c % in_c == 0) {
+    return CPUConv2dAlgo::kDepthwiseDirect;
+  }
+
+  const int64_t out_h = output_dims[2];
+  const int64_t out_w = output_dims[3];
+  if (groups == 1 && filter_dims[2] == 3 && filter_dims[3] == 3 &&
+      strides[0] == 1 && strides[1] == 1 && dilations[0] == 1 &&
+      dilations[1] == 1 && out_h >= 2 && out_w >= 2) {
+    // The bigger tiles save more multiplications, but waste more on the
+    // borders of the small outputs.
+    return (out_h >= 8 && out_w >= 8) ? CPUConv2dAlgo::kWinogradF4x4
+                                      : CPUConv2dAlgo::kWinogradF2x2;
+  }
+  return CPUConv2dAlgo::kIm2ColGemm;
+}
+
+template <typename T>
+void WinogradConv2d(const CPUContext& dev_ctx,
+                    const DenseTensor& input,
+                    const DenseTensor& filter,
+                    const std::vector<int>& paddings,
+                    int tile_size,
+                    DenseTensor* output) {
+  if (tile_size == 2) {
+    WinogradConv2dImpl<T, 2>(dev_ctx, input, filter, paddings, output);
+  } else if (tile_size == 4) {
+    WinogradConv2dImpl<T, 4>(dev_ctx, input, filter, paddings, output);
+  } else {
+    PADDLE_THROW(phi::errors::InvalidArgument(
+        "The tile size of Winograd conv2d should be 2 or 4, but got %d.",
+        tile_size));
+  }
+}
+
+template <typename T>
+void DepthwiseConv2dDirect(const CPUContext& dev_ctx UNUSED,
+                           const DenseTensor& input,
+                           const DenseTensor& filter,
+                           const std::vector<int>& strides,
+                           const std::vector<int>& paddings,
+                           const std::vector<int>& dilations,
+                           DenseTensor* output) {
+  const int batch_size = static_cast<int>(input.dims()[0]);
+  const int in_c = static_cast<int>(input.dims()[1]);
+  const int in_h = static_cast<int>(input.dims()[2]);
+  const int in_w = static_cast<int>(input.dims()[3]);
+  const int out_c = static_cast<int>(output->dims()[1]);
+  const int out_h = static_cast<int>(output->dims()[2]);
+  const int out_w = static_cast<int>(output->dims()[3]);
+  const int k_h = static_cast<int>(filter.dims()[2]);
+  const int k_w = static_cast<int>(filter.dims()[3]);
+  const int multiplier = out_c / in_c;
+  const int stride_h = strides[0];
+  const int stride_w = strides[1];
+  const int dilation_h = dilations[0];
+  const int dilation_w = dilations[1];
+  const int pad_top = paddings[0];
+  const int pad_left = paddings[2];
+  const bool use_avx = backends::cpu::MayIUse(backends::cpu::avx);
+
+  const T* in_data = input.data<T>();
+  const T* filter_data = filter.data<T>();
+  T* out_data = output->data<T>();
+
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int plane_id = 0; plane_id < batch_size * out_c; ++plane_id) {
+    const int n = plane_id / out_c;
+    const int oc = plane_id % out_c;
+    const T* in_plane = in_data + (n * in_c + oc / multiplier) * in_h * in_w;
+    const T* weights = filter_data + oc * k_h * k_w;
+    T* out_plane = out_data + plane_id * out_h * out_w;
+    std::fill(out_plane, out_plane + out_h * out_w, static_cast<T>(0));
+
+    for (int kw = 0; kw < k_w; ++kw) {
+      // the range of ow whose iw = ow * stride_w - pad_left + kw * dilation_w
+      // is inside the input
+      const int offset = kw * dilation_w - pad_left;
+      const int ow_begin =
+          offset >= 0 ? 0 : (-offset + stride_w - 1) / stride_w;
+      const int ow_end = std::min(
+          out_w,
+          in_w - offset > 0 ? (in_w - offset + stride_w - 1) / stride_w : 0);
+      if (ow_begin >= ow_end) {
+        continue;
+      }
+      for (int oh = 0; oh < out_h; ++oh) {
+        T* out_row = out_plane + oh * out_w;
+        for (int kh = 0; kh < k_h; ++kh) {
+          const int ih = oh * stride_h - pad_top + kh * dilation_h;
+          if (ih < 0 || ih >= in_h) {
+            continue;
+          }
+          const T weight = weights[kh * k_w + kw];
+          const T* in_row = in_plane + ih * in_w;
+          if (stride_w == 1) {
+            RowAxpy<T>(use_avx,
+                       ow_end - ow_begin,
+                       weight,
+                       in_row + ow_begin + offset,
+                       out_row + ow_begin);
+          } else {
+            for (int ow = ow_begin; ow < ow_end; ++ow) {
+              out_row[ow] += weight * in_row[ow * stride_w + offset];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+template void WinogradConv2d<float>(const CPUContext&,
+                                    const DenseTensor&,
+                                    const DenseTensor&,
+                                    const std::vector<int>&,
+                                    int,
+                                    DenseTensor*);
+template void WinogradConv2d<double>(const CPUContext&,
+                                     const DenseTensor&,
+                                     const DenseTensor&,
+                                     const std::vector<int>&,
+                                     int,
+                                     DenseTensor*);
+template void DepthwiseConv2dDirect<float>(const CPUContext&,
+                                           const DenseTensor&,
+                                           const DenseTensor&,
+                                           const std::vector<int>&,
+                                           const std::vector<int>&,
+                                           const std::vector<int>&,
+                                           DenseTensor*);
+template void DepthwiseConv2dDirect<double>(const CPUContext&,
+                                            const DenseTensor&,
+                                            const DenseTensor&,
+                                            const std::vector<int>&,
+                                            const std::vector<int>&,
+                                            const std::vector<int>&,
+                                            DenseTensor*);
+
+}  // namespace funcs
+}  // namespace phi
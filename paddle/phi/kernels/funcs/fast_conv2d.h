@@ -0,0 +1,68 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+namespace funcs {
+
+// The algorithms of conv2d on CPU besides im2col + gemm.
+enum class CPUConv2dAlgo {
+  kIm2ColGemm,
+  // Winograd F(2x2, 3x3) and F(4x4, 3x3) for the 3x3 convs of stride 1,
+  // which need much less workspace and multiplications than im2col.
+  kWinogradF2x2,
+  kWinogradF4x4,
+  // The direct conv of every channel for the depthwise convs, whose gemm of
+  // im2col is too small to be efficient.
+  kDepthwiseDirect,
+};
+
+// Selects the algorithm by the shapes, the dims are of NCHW.
+CPUConv2dAlgo SelectCPUConv2dAlgo(const DDim& input_dims,
+                                  const DDim& filter_dims,
+                                  const DDim& output_dims,
+                                  const std::vector<int>& strides,
+                                  const std::vector<int>& dilations,
+                                  int groups);
+
+// The input and output are of NCHW, the filter is of [K, C, 3, 3], and the
+// paddings are {top, bottom, left, right}. The tile_size is the size of the
+// output tile, 2 or 4.
+template <typename T>
+void WinogradConv2d(const CPUContext& dev_ctx,
+                    const DenseTensor& input,
+                    const DenseTensor& filter,
+                    const std::vector<int>& paddings,
+                    int tile_size,
+                    DenseTensor* output);
+
+// The input and output are of NCHW, the filter is of [C * multiplier, 1, KH,
+// KW], and the paddings are {top, bottom, left, right}.
+template <typename T>
+void DepthwiseConv2dDirect(const CPUContext& dev_ctx,
+                           const DenseTensor& input,
+                           const DenseTensor& filter,
+                           const std::vector<int>& strides,
+                           const std::vector<int>& paddings,
+                           const std::vector<int>& dilations,
+                           DenseTensor* output);
+
+}  // namespace funcs
+}  // namespace phi
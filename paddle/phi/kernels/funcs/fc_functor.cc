@@ -17,6 +17,7 @@ limitations under the License. */
 #include "paddle/phi/backends/all_context.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
 #include "paddle/phi/kernels/funcs/jit/kernels.h"
+#include "paddle/phi/kernels/funcs/packed_weights_cache.h"
 
 namespace phi {
 namespace funcs {
@@ -64,7 +65,28 @@ void FCFunctor<DeviceContext, T>::operator()(const DeviceContext& context,
               Y1_data,
               NN);
   } else {
+#ifdef PADDLE_WITH_MKLML
+    // the weight packed at load time by fc_weight_pack_pass
+    const T* packed_w = PackedWeightsCache<T>::Instance().Find(W, N, K);
+    if (packed_w != nullptr) {
+      blas.GEMM_COMPUTE(CblasNoTrans,
+                        CblasPacked,
+                        M,
+                        N,
+                        K,
+                        X,
+                        K,
+                        packed_w,
+                        N,
+                        static_cast<T>(0.0),
+                        Y,
+                        N);
+    } else {
+      blas.MatMul(M, N, K, X, W, Y);
+    }
+#else
     blas.MatMul(M, N, K, X, W, Y);
+#endif
   }
   if (B == nullptr) {
     if (padding_weights) {
@@ -173,11 +173,13 @@ void exec_fft(const phi::GPUContext& ctx,
   FFTConfig* config = nullptr;
   std::unique_ptr<FFTConfig> config_ = nullptr;
   bool using_cache = use_cache(key.sizes_);
+  // The cached plan is held until it is launched, so that it is neither
+  // evicted nor bound to another work area in the meantime.
+  std::unique_lock<std::mutex> guard;
 
   if (using_cache) {
-    FFTConfigCache& plan_cache = get_fft_plan_cache(device_id);
-    std::unique_lock<std::mutex> guard(plan_cache.mutex, std::defer_lock);
-    guard.lock();
+    FFTConfigCache& plan_cache = get_fft_plan_cache(device_id, ctx.stream());
+    guard = std::unique_lock<std::mutex>(plan_cache.mutex);
     config = &(plan_cache.lookup(key));
   } else {
     config_ = std::make_unique<FFTConfig>(key);
@@ -212,6 +214,9 @@ void exec_fft(const phi::GPUContext& ctx,
     exec_plan(
         *config, collapsed_input.data(), collapsed_output.data(), forward);
   }
+  if (guard.owns_lock()) {
+    guard.unlock();
+  }
 
   // resize for the collapsed output
   collapsed_output.Resize(transposed_output_shape);
@@ -13,20 +13,26 @@
 // limitations under the License.
 
 #pragma once
+#include <algorithm>
 #include <functional>
 #include <limits>
 #include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <utility>
 
+#include "paddle/phi/backends/gpu/gpu_decls.h"
+#include "paddle/phi/core/flags.h"
 #if defined(PADDLE_WITH_CUDA)
 #include "paddle/phi/kernels/funcs/cufft_util.h"
 #elif defined(PADDLE_WITH_HIP)
 #include "paddle/phi/kernels/funcs/hipfft_util.h"
 #endif
 
+PHI_DECLARE_int64(fft_plan_cache_max_size);
+
 namespace phi {
 namespace funcs {
 namespace detail {
@@ -40,7 +46,7 @@ constexpr size_t CUFFT_DEFAULT_CACHE_SIZE = CUFFT_MAX_PLAN_NUM;
 constexpr size_t CUFFT_MAX_PLAN_NUM = std::numeric_limits<size_t>::max();
 // The default max cache size chosen for CUDA version > 10 is arbitrary.
 // This number puts a limit on how big of a plan cache should we maintain by
-// default. Users can always configure it via cufft_set_plan_cache_max_size.
+// default. Users can always configure it via FLAGS_fft_plan_cache_max_size.
 constexpr size_t CUFFT_DEFAULT_CACHE_SIZE = 4096;
 #endif
 
@@ -168,21 +174,30 @@ class FFTConfigCache {
   size_t _max_size;
 };
 
-static std::vector<std::unique_ptr<FFTConfigCache>> plan_caches;
+// A cache for every device and stream, since a plan is bound to the stream
+// and the work area before an execution, and the concurrent predictors on
+// their own streams should not contend on the same plans.
+static std::map<std::pair<int64_t, gpuStream_t>,
+                std::unique_ptr<FFTConfigCache>>
+    plan_caches;
 static std::mutex plan_caches_mutex;
 
-static inline FFTConfigCache& get_fft_plan_cache(int64_t device_index) {
+static inline FFTConfigCache& get_fft_plan_cache(int64_t device_index,
+                                                 gpuStream_t stream) {
   std::lock_guard<std::mutex> guard(plan_caches_mutex);
 
-  if (device_index >= plan_caches.size()) {
-    plan_caches.resize(device_index + 1);
-  }
-
-  if (!plan_caches[device_index]) {
-    plan_caches[device_index] = std::make_unique<FFTConfigCache>();
+  const size_t max_size = std::min<size_t>(
+      std::max<int64_t>(FLAGS_fft_plan_cache_max_size, 1), CUFFT_MAX_PLAN_NUM);
+  auto& plan_cache = plan_caches[std::make_pair(device_index, stream)];
+  if (!plan_cache) {
+    plan_cache = std::make_unique<FFTConfigCache>(max_size);
+  } else if (plan_cache->max_size() != max_size) {
+    // the flag is changed at runtime
+    std::lock_guard<std::mutex> cache_guard(plan_cache->mutex);
+    plan_cache->resize(max_size);
   }
 
-  return *plan_caches[device_index];
+  return *plan_cache;
 }
 }  // namespace detail
 }  // namespace funcs
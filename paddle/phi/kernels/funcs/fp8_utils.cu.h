@@ -0,0 +1,243 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/common/float8.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+
+namespace phi {
+namespace funcs {
+
+// The per-tensor scaling of fp8: a tensor is quantized as fp8(x * scale) and
+// dequantized as fp8 * scale_inv, where the scale maps the amax of the tensor
+// to the max of the fp8 format, scale = fp8_max / amax / 2 ^ margin. The
+// delayed scaling takes the amax as the max of the history of the amaxes of
+// the former steps, so that the tensor is quantized in one pass and its amax
+// is recorded on the way.
+
+template <typename FP8>
+struct Fp8Max;
+
+template <>
+struct Fp8Max<phi::dtype::float8_e4m3fn> {
+  static constexpr float value = 448.f;
+};
+
+template <>
+struct Fp8Max<phi::dtype::float8_e5m2> {
+  static constexpr float value = 57344.f;
+};
+
+constexpr int kFp8BlockSize = 512;
+
+// scale[0] = fp8_max / max(history) / 2 ^ margin, scale_inv[0] = 1 / scale,
+// the scale is 1 while the history is all zeros. Launched by one block.
+static __global__ void Fp8ComputeScaleKernel(const float* history,
+                                             const int64_t history_len,
+                                             const float fp8_max,
+                                             const float margin,
+                                             float* scale,
+                                             float* scale_inv) {
+  float amax = 0.f;
+  for (int64_t i = threadIdx.x; i < history_len; i += blockDim.x) {
+    amax = max(amax, history[i]);
+  }
+  amax = BlockReduceMax<float>(amax, FINAL_MASK);
+  if (threadIdx.x == 0) {
+    float s = 1.f;
+    if (amax > 0.f && isfinite(amax)) {
+      s = fp8_max / amax / exp2f(margin);
+    }
+    scale[0] = s;
+    scale_inv[0] = 1.f / s;
+  }
+}
+
+// amax[0] = max(amax[0], max(|x|)), amax must be set to zeros before
+template <typename T>
+__global__ void Fp8AmaxKernel(const T* x, const int64_t numel, float* amax) {
+  float local = 0.f;
+  for (int64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < numel;
+       i += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    local = max(local, fabsf(static_cast<float>(x[i])));
+  }
+  local = BlockReduceMax<float>(local, FINAL_MASK);
+  if (threadIdx.x == 0) {
+    phi::CudaAtomicMax(amax, local);
+  }
+}
+
+// out = fp8(x * scale[0]), and the max(|x|) is recorded in amax unless it is
+// nullptr, amax must be set to zeros before
+template <typename T, typename FP8>
+__global__ void Fp8QuantizeKernel(const T* x,
+                                  const float* scale,
+                                  const int64_t numel,
+                                  FP8* out,
+                                  float* amax) {
+  const float s = scale[0];
+  float local = 0.f;
+  for (int64_t i = blockIdx.x * blockDim.x + threadIdx.x; i < numel;
+       i += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    const float v = static_cast<float>(x[i]);
+    local = max(local, fabsf(v));
+    out[i] = FP8(v * s);
+  }
+  if (amax != nullptr) {
+    local = BlockReduceMax<float>(local, FINAL_MASK);
+    if (threadIdx.x == 0) {
+      phi::CudaAtomicMax(amax, local);
+    }
+  }
+}
+
+// out [cols, rows] = fp8(transpose(x [rows, cols]) * scale[0]), which gives
+// the weight of the TN layout of the fp8 gemm, the tiles of 32 x 32 are
+// transposed in the shared memory by blocks of 32 x 8 threads.
+template <typename T, typename FP8>
+__global__ void Fp8QuantizeTransposeKernel(const T* x,
+                                           const float* scale,
+                                           const int rows,
+                                           const int cols,
+                                           FP8* out,
+                                           float* amax) {
+  constexpr int kTile = 32;
+  __shared__ float tile[kTile][kTile + 1];
+  const float s = scale[0];
+  float local = 0.f;
+  const int col = blockIdx.x * kTile + threadIdx.x;
+  for (int j = threadIdx.y; j < kTile; j += blockDim.y) {
+    const int row = blockIdx.y * kTile + j;
+    float v = 0.f;
+    if (row < rows && col < cols) {
+      v = static_cast<float>(x[static_cast<int64_t>(row) * cols + col]);
+    }
+    local = max(local, fabsf(v));
+    tile[j][threadIdx.x] = v;
+  }
+  __syncthreads();
+  const int out_col = blockIdx.y * kTile + threadIdx.x;
+  for (int j = threadIdx.y; j < kTile; j += blockDim.y) {
+    const int out_row = blockIdx.x * kTile + j;
+    if (out_row < cols && out_col < rows) {
+      out[static_cast<int64_t>(out_row) * rows + out_col] =
+          FP8(tile[threadIdx.x][j] * s);
+    }
+  }
+  if (amax != nullptr) {
+    // BlockReduceMax is for the 1D blocks, the warps are reduced here
+    __shared__ float block_amax;
+    if (threadIdx.x == 0 && threadIdx.y == 0) block_amax = 0.f;
+    __syncthreads();
+    local = WarpReduceMax<float>(local, FINAL_MASK);
+    if (threadIdx.x == 0) {
+      phi::CudaAtomicMax(&block_amax, local);
+    }
+    __syncthreads();
+    if (threadIdx.x == 0 && threadIdx.y == 0) {
+      phi::CudaAtomicMax(amax, block_amax);
+    }
+  }
+}
+
+// history = [amax, history[0], ..., history[len - 2]] in place, launched by
+// one block, the chunks are rolled from the last one so that the reads are
+// done before they are overwritten.
+static __global__ void Fp8UpdateAmaxHistoryKernel(float* history,
+                                                  const int64_t history_len,
+                                                  const float* amax) {
+  const int64_t num_chunks = (history_len + blockDim.x - 1) / blockDim.x;
+  for (int64_t c = num_chunks - 1; c >= 0; --c) {
+    const int64_t i = c * blockDim.x + threadIdx.x;
+    float v = 0.f;
+    if (i < history_len) {
+      v = i == 0 ? amax[0] : history[i - 1];
+    }
+    __syncthreads();
+    if (i < history_len) {
+      history[i] = v;
+    }
+  }
+}
+
+template <typename T>
+void Fp8Amax(const phi::GPUContext& dev_ctx,
+             const T* x,
+             const int64_t numel,
+             float* amax) {
+  const int64_t grid = std::min<int64_t>(
+      (numel + kFp8BlockSize - 1) / kFp8BlockSize,
+      static_cast<int64_t>(dev_ctx.GetCUDAMaxGridDimSize()[0]));
+  Fp8AmaxKernel<T><<<std::max<int64_t>(grid, 1),
+                     kFp8BlockSize,
+                     0,
+                     dev_ctx.stream()>>>(x, numel, amax);
+}
+
+template <typename T, typename FP8>
+void Fp8Quantize(const phi::GPUContext& dev_ctx,
+                 const T* x,
+                 const float* scale,
+                 const int64_t numel,
+                 FP8* out,
+                 float* amax) {
+  const int64_t grid = std::min<int64_t>(
+      (numel + kFp8BlockSize - 1) / kFp8BlockSize,
+      static_cast<int64_t>(dev_ctx.GetCUDAMaxGridDimSize()[0]));
+  Fp8QuantizeKernel<T, FP8><<<std::max<int64_t>(grid, 1),
+                              kFp8BlockSize,
+                              0,
+                              dev_ctx.stream()>>>(x, scale, numel, out, amax);
+}
+
+template <typename T, typename FP8>
+void Fp8QuantizeTranspose(const phi::GPUContext& dev_ctx,
+                          const T* x,
+                          const float* scale,
+                          const int rows,
+                          const int cols,
+                          FP8* out,
+                          float* amax) {
+  dim3 block(32, 8);
+  dim3 grid((cols + 31) / 32, (rows + 31) / 32);
+  Fp8QuantizeTransposeKernel<T, FP8><<<grid, block, 0, dev_ctx.stream()>>>(
+      x, scale, rows, cols, out, amax);
+}
+
+inline void Fp8ComputeScale(const phi::GPUContext& dev_ctx,
+                            const float* history,
+                            const int64_t history_len,
+                            const float fp8_max,
+                            const float margin,
+                            float* scale,
+                            float* scale_inv) {
+  Fp8ComputeScaleKernel<<<1, 256, 0, dev_ctx.stream()>>>(
+      history, history_len, fp8_max, margin, scale, scale_inv);
+}
+
+inline void Fp8UpdateAmaxHistory(const phi::GPUContext& dev_ctx,
+                                 float* history,
+                                 const int64_t history_len,
+                                 const float* amax) {
+  Fp8UpdateAmaxHistoryKernel<<<1, 256, 0, dev_ctx.stream()>>>(
+      history, history_len, amax);
+}
+
+}  // namespace funcs
+}  // namespace phi
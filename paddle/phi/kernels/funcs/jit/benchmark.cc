@@ -14,6 +14,9 @@
 
 #include <iostream>
 #include <random>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #include "glog/logging.h"
 #include "paddle/phi/api/profiler/device_tracer.h"
@@ -27,6 +30,10 @@ PD_DEFINE_int32(burning, 10, "Burning times.");
 PD_DEFINE_int32(repeat, 3000, "Repeat times.");
 PD_DEFINE_int32(max_size, 1000, "The Max size would be tested.");
 PD_DEFINE_string(filter, "", "The Benchmark name would be run.");  // NOLINT
+PD_DEFINE_string(isa,
+                 "",
+                 "The comma separated max isas the kernels would be compared "
+                 "on, such as avx,avx2,avx512f.");  // NOLINT
 
 class BenchJITKernel {
  public:
@@ -108,21 +115,42 @@ struct BenchFunc {
 
 namespace jit = phi::jit;
 
+// the max isas of FLAGS_isa, or the one of FLAGS_jit_max_isa if it is empty
+std::vector<std::string> MaxIsas() {
+  std::vector<std::string> isas;
+  std::stringstream ss(FLAGS_isa);
+  std::string isa;
+  while (std::getline(ss, isa, ',')) {
+    if (!isa.empty()) isas.push_back(isa);
+  }
+  if (isas.empty()) isas.push_back(FLAGS_jit_max_isa);
+  return isas;
+}
+
 template <typename KernelTuple, typename PlaceType, typename... Args>
 void BenchAllImpls(const typename KernelTuple::attr_type& attr, Args... args) {
   BenchFunc<KernelTuple, Args...> benchmark;
   std::vector<std::pair<std::string, double>> infos;
-  auto funcs = jit::GetAllCandidateFuncsWithTypes<KernelTuple, PlaceType>(attr);
-  for (auto const& f : funcs) {
-    infos.push_back(std::make_pair(f.first, benchmark(f.second, args...)));
-  }
+  const std::string max_isa = FLAGS_jit_max_isa;
+  for (auto const& isa : MaxIsas()) {
+    // the kernels are generated and cached again for each max isa
+    FLAGS_jit_max_isa = isa;
+    const std::string suffix = isa.empty() ? "" : "@" + isa;
+    auto funcs =
+        jit::GetAllCandidateFuncsWithTypes<KernelTuple, PlaceType>(attr);
+    for (auto const& f : funcs) {
+      infos.push_back(
+          std::make_pair(f.first + suffix, benchmark(f.second, args...)));
+    }
 
-  // Test result from Get function
-  auto tgt = jit::KernelFuncs<KernelTuple, PlaceType>::Cache().At(attr);
-  if (!tgt) {
-    PADDLE_THROW(phi::errors::Fatal("Benchmark target can not be empty."));
+    // Test result from Get function
+    auto tgt = jit::KernelFuncs<KernelTuple, PlaceType>::Cache().At(attr);
+    if (!tgt) {
+      PADDLE_THROW(phi::errors::Fatal("Benchmark target can not be empty."));
+    }
+    infos.push_back(std::make_pair("Target" + suffix, benchmark(tgt, args...)));
   }
-  infos.push_back(std::make_pair("Target", benchmark(tgt, args...)));
+  FLAGS_jit_max_isa = max_isa;
 
   // print
   std::ostringstream loginfos;
@@ -545,6 +573,7 @@ BENCH_FP32_CPU(VBroadcast);
 //     --repeat: the repeat times
 //     --max_size: the max size would be tested
 //     --filter: the bench name would be run
+//     --isa: the max isas the kernels would be compared on
 int main(int argc, char* argv[]) {
   paddle::flags::ParseCommandLineFlags(&argc, &argv);
   google::InitGoogleLogging(argv[0]);
@@ -99,27 +99,27 @@ DECLARE_ACT_CREATOR(VTanh);
 
 // TODO(TJ): tuning use me
 bool VReluCreator::CanBeUsed(const int& d) const {
-  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+  return jit::MayIUse(phi::backends::cpu::avx);
 }
 
 bool VSquareCreator::CanBeUsed(const int& d) const {
-  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+  return jit::MayIUse(phi::backends::cpu::avx);
 }
 
 bool VIdentityCreator::CanBeUsed(const int& d) const {
-  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+  return jit::MayIUse(phi::backends::cpu::avx);
 }
 
 bool VExpCreator::CanBeUsed(const int& d) const {
-  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx) && d < 32;
+  return jit::MayIUse(phi::backends::cpu::avx) && d < 32;
 }
 
 bool VSigmoidCreator::CanBeUsed(const int& d) const {
-  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+  return jit::MayIUse(phi::backends::cpu::avx);
 }
 
 bool VTanhCreator::CanBeUsed(const int& d) const {
-  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+  return jit::MayIUse(phi::backends::cpu::avx);
 }
 
 size_t VReluCreator::CodeSize(const int& d) const {
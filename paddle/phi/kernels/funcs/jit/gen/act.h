@@ -143,11 +143,11 @@ class VActFunc : public JitCode {
     vcvttps2dq(ymm_int, jmm_fx);
     mov(reg_ptr_global, reinterpret_cast<size_t>(exp_int_0x7f));
     vmovdqa(jmm_tmp, ptr[reg_ptr_global]);
-    if (phi::backends::cpu::MayIUse(phi::backends::cpu::avx2) ||
+    if (jit::MayIUse(phi::backends::cpu::avx2) ||
         std::is_same<JMM, xmm_t>::value) {
       vpaddd(ymm_int, ymm_int, jmm_tmp);
       vpslld(ymm_int, ymm_int, 23);
-    } else if (phi::backends::cpu::MayIUse(phi::backends::cpu::avx)) {
+    } else if (jit::MayIUse(phi::backends::cpu::avx)) {
       xmm_t xtmp1 = xmm_t(ymm_int.getIdx());
       xmm_t xtmp2 = xmm_t(jmm_tmp.getIdx());
       reg64_t reg_ptr_tmp = reg_ptr_global;
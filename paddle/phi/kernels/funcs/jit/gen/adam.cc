@@ -131,7 +131,7 @@ void AdamJitCode::genCode() {
 class AdamCreator : public JitCodeCreator<adam_attr_t> {
  public:
   bool CanBeUsed(const adam_attr_t& attr) const override {
-    return phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f);
+    return jit::MayIUse(phi::backends::cpu::avx512f);
   }
   size_t CodeSize(const adam_attr_t& attr) const override {
     return 96 + 32 * 8;
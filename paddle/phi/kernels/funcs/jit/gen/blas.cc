@@ -114,7 +114,7 @@ void VXXJitCode::genCode() {
   class name##Creator : public JitCodeCreator<int> {                         \
    public:                                                                   \
     bool CanBeUsed(const int& attr) const override {                         \
-      return phi::backends::cpu::MayIUse(phi::backends::cpu::avx) &&         \
+      return jit::MayIUse(phi::backends::cpu::avx) &&         \
              attr <= 1024;                                                   \
     }                                                                        \
     size_t CodeSize(const int& d) const override {                           \
@@ -26,8 +26,10 @@ namespace gen {
 
 void EmbSeqPoolJitCode::genCode() {
   preCode();
-  constexpr int block = YMM_FLOAT_BLOCK;
-  constexpr int max_num_regs = 8;
+  // the zmm of avx512 pools twice the width of ymm with 32 regs
+  const bool use_zmm = jit::MayIUse(phi::backends::cpu::avx512f);
+  const int block = use_zmm ? ZMM_FLOAT_BLOCK : YMM_FLOAT_BLOCK;
+  const int max_num_regs = use_zmm ? 16 : 8;
   const int num_block = tbl_w_ / block;
   const int num_groups = num_block / max_num_regs;
   const size_t block_size = sizeof(float) * block;
@@ -46,83 +48,26 @@ void EmbSeqPoolJitCode::genCode() {
   mov(rax, sizeof(int64_t));
   mul(reg_idx_width_in_byte);
   mov(reg_idx_width_in_byte, rax);
-  const size_t tbl_width_in_byte = sizeof(float) * tbl_w_;
-  int acc_num_regs = 0;
+  size_t dst_offset = 0;
   for (int num_regs : groups) {
-    Label l_next_idx_w, l_next_idx_h, l_save_now;
-    xor_(reg_idx_w_i_in_byte, reg_idx_w_i_in_byte);
-    mov(reg_ptr_dst_i, reg_ptr_param_dst);
-    add(reg_ptr_dst_i, acc_num_regs * block_size);
-
-    L(l_next_idx_w);
-    {
-      // h == 0
-      mov(reg_ptr_idx_i, param_idx);
-      add(reg_ptr_idx_i, reg_idx_w_i_in_byte);
-      mov(reg_idx, qword[reg_ptr_idx_i]);
-      mov(rax, tbl_width_in_byte);
-      mul(reg_idx);
-      mov(reg_ptr_tbl_i, rax);        // reg is offset now
-      add(reg_ptr_tbl_i, param_tbl);  // reg is ptr_i now
-      size_t w_offset = 0;
-      for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-        vmovups(ymm_t(reg_i + num_regs), ptr[reg_ptr_tbl_i + w_offset]);
-        w_offset += block_size;
-      }
-      add(reg_ptr_idx_i, reg_idx_width_in_byte);
-
-      // end condition of idx h
-      mov(reg_idx_h_end, reg_idx_height);
-      mov(rax, reg_idx_width_in_byte);
-      mul(reg_idx_h_end);
-      mov(reg_idx_h_end, rax);
-      add(reg_idx_h_end, reg_idx_w_i_in_byte);
-      add(reg_idx_h_end, param_idx);
-
-      cmp(reg_ptr_idx_i, reg_idx_h_end);
-      jge(l_save_now, T_NEAR);
-      L(l_next_idx_h);
-      {
-        mov(reg_idx, qword[reg_ptr_idx_i]);
-        mov(reg_ptr_tbl_i, reg_idx);
-        mov(rax, tbl_width_in_byte);
-        mul(reg_idx);
-        mov(reg_ptr_tbl_i, rax);
-        add(reg_ptr_tbl_i, param_tbl);
-        size_t w_offset = 0;
-        for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-          vmovups(ymm_t(reg_i), ptr[reg_ptr_tbl_i + w_offset]);
-          vaddps(
-              ymm_t(reg_i + num_regs), ymm_t(reg_i + num_regs), ymm_t(reg_i));
-          w_offset += block_size;
-        }
-        add(reg_ptr_idx_i, reg_idx_width_in_byte);
-        cmp(reg_ptr_idx_i, reg_idx_h_end);
-        jl(l_next_idx_h, T_NEAR);
-      }  // end of idx h
-      L(l_save_now);
-      // avg or sqrt here, if needed
-      w_offset = 0;
-      for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-        vmovups(ptr[reg_ptr_dst_i + w_offset], ymm_t(reg_i + num_regs));
-        w_offset += block_size;
-      }
-      add(reg_ptr_dst_i, tbl_width_in_byte);
-      add(reg_idx_w_i_in_byte, sizeof(int64_t));
-      cmp(reg_idx_w_i_in_byte, reg_idx_width_in_byte);
-      jl(l_next_idx_w, T_NEAR);
-    }  // end of idx w
-
-    acc_num_regs += num_regs;
-    add(param_tbl, num_regs * block_size);  // do not use acc_num_regs
-  }                                         // end of groups
+    if (use_zmm) {
+      pool_group<zmm_t>(num_regs, block_size, dst_offset);
+    } else {
+      pool_group<ymm_t>(num_regs, block_size, dst_offset);
+    }
+    dst_offset += num_regs * block_size;
+  }
+  if (tbl_w_ % block != 0) {
+    // the half block of zmm
+    pool_group<ymm_t>(1, sizeof(float) * YMM_FLOAT_BLOCK, dst_offset);
+  }
   postCode();
 }
 
 class EmbSeqPoolCreator : public JitCodeCreator<emb_seq_pool_attr_t> {
  public:
   bool CanBeUsed(const emb_seq_pool_attr_t& attr) const override {
-    return phi::backends::cpu::MayIUse(phi::backends::cpu::avx) &&
+    return jit::MayIUse(phi::backends::cpu::avx) &&
            attr.table_width % YMM_FLOAT_BLOCK == 0;
   }
   size_t CodeSize(const emb_seq_pool_attr_t& attr) const override {
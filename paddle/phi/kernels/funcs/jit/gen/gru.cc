@@ -89,7 +89,7 @@ void GRUJitCode::genCode() {
    public:                                                           \
     /* TODO(TJ): enable more */                                      \
     bool CanBeUsed(const gru_attr_t& attr) const override {          \
-      return phi::backends::cpu::MayIUse(phi::backends::cpu::avx) && \
+      return jit::MayIUse(phi::backends::cpu::avx) && \
              attr.d % 8 == 0;                                        \
     }                                                                \
     size_t CodeSize(const gru_attr_t& attr) const override {         \
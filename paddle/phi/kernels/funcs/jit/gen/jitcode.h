@@ -19,6 +19,7 @@
 
 #include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/kernels/funcs/jit/gen_base.h"
+#include "paddle/phi/kernels/funcs/jit/kernel_key.h"
 
 #define XBYAK_USE_MMAP_ALLOCATOR
 #include "xbyak/xbyak.h"
@@ -91,7 +92,7 @@ class JitCode : public GenBase, public Xbyak::CodeGenerator {
     for (int i = 0; i < num_g_abi_regs; ++i) {
       push(Xbyak::Reg64(g_abi_regs[i]));
     }
-    if (phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f)) {
+    if (jit::MayIUse(phi::backends::cpu::avx512f)) {
       mov(reg_EVEX_max_8b_offt, 2 * EVEX_max_8b_offt);
     }
   }
@@ -117,7 +117,7 @@ void LSTMJitCode::genCode() {
    public:                                                           \
     /* TODO(TJ): enable more */                                      \
     bool CanBeUsed(const lstm_attr_t& attr) const override {         \
-      return phi::backends::cpu::MayIUse(phi::backends::cpu::avx) && \
+      return jit::MayIUse(phi::backends::cpu::avx) && \
              attr.d % 8 == 0;                                        \
     }                                                                \
     size_t CodeSize(const lstm_attr_t& attr) const override {        \
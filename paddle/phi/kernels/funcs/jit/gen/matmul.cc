@@ -110,12 +110,12 @@ class MatMulCreator : public JitCodeCreator<matmul_attr_t> {
  public:
   bool CanBeUsed(const matmul_attr_t& attr) const override {
     return attr.m == 1 &&
-           phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f) &&
+           jit::MayIUse(phi::backends::cpu::avx512f) &&
            attr.n % ZMM_FLOAT_BLOCK == 0 && attr.k < 512;
   }
   size_t CodeSize(const matmul_attr_t& attr) const override {
     int block = YMM_FLOAT_BLOCK;
-    if (phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f)) {
+    if (jit::MayIUse(phi::backends::cpu::avx512f)) {
       block = ZMM_FLOAT_BLOCK;
     }
     return 96 + 4 * attr.k * (attr.n / block + 1) * 8;
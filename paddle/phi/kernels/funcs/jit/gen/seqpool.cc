@@ -23,8 +23,10 @@ namespace jit {
 namespace gen {
 
 void SeqPoolJitCode::genCode() {
-  constexpr int block = YMM_FLOAT_BLOCK;
-  constexpr int max_num_regs = 8;
+  // the zmm of avx512 pools twice the width of ymm with 32 regs
+  const bool use_zmm = jit::MayIUse(phi::backends::cpu::avx512f);
+  const int block = use_zmm ? ZMM_FLOAT_BLOCK : YMM_FLOAT_BLOCK;
+  const int max_num_regs = use_zmm ? 16 : 8;
   const int num_block = w_ / block;
   const int num_groups = num_block / max_num_regs;
   int rest_num_regs = num_block % max_num_regs;
@@ -44,21 +46,34 @@ void SeqPoolJitCode::genCode() {
   }
   const int group_len = max_num_regs * block * sizeof(float);
   for (int g = 0; g < num_groups; ++g) {
-    pool_height<ymm_t>(g * group_len, block, max_num_regs);
+    if (use_zmm) {
+      pool_height<zmm_t>(g * group_len, block, max_num_regs);
+    } else {
+      pool_height<ymm_t>(g * group_len, block, max_num_regs);
+    }
   }
   if (rest_num_regs > 0) {
-    pool_height<ymm_t>(num_groups * group_len, block, rest_num_regs);
+    if (use_zmm) {
+      pool_height<zmm_t>(num_groups * group_len, block, rest_num_regs);
+    } else {
+      pool_height<ymm_t>(num_groups * group_len, block, rest_num_regs);
+    }
+  }
+  int rest = w_ % block;
+  if (rest >= YMM_FLOAT_BLOCK) {
+    // the half block of zmm
+    pool_height<ymm_t>((w_ - rest) * sizeof(float), YMM_FLOAT_BLOCK, 1);
+    rest -= YMM_FLOAT_BLOCK;
   }
-  // part of rest_w * height
-  const int rest = w_ % block;
-  pool_height_of_rest_width(rest, (w_ - rest) * sizeof(float), max_num_regs);
+  // part of rest_w * height, which is less than 8
+  pool_height_of_rest_width(rest, (w_ - rest) * sizeof(float), 8);
   ret();
 }
 
 class SeqPoolCreator : public JitCodeCreator<seq_pool_attr_t> {
  public:
   bool CanBeUsed(const seq_pool_attr_t& attr) const override {
-    return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+    return jit::MayIUse(phi::backends::cpu::avx);
   }
   size_t CodeSize(const seq_pool_attr_t& attr) const override {
     return 96 + ((attr.w / YMM_FLOAT_BLOCK + 4 /* for rest */) *
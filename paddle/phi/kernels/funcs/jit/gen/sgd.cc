@@ -108,7 +108,7 @@ void SgdJitCode::genCode() {
 class SgdCreator : public JitCodeCreator<sgd_attr_t> {
  public:
   bool CanBeUsed(const sgd_attr_t& attr) const override {
-    return phi::backends::cpu::MayIUse(phi::backends::cpu::avx) &&
+    return jit::MayIUse(phi::backends::cpu::avx) &&
            attr.grad_width % YMM_FLOAT_BLOCK == 0;
   }
   size_t CodeSize(const sgd_attr_t& attr) const override { return 96 + 32 * 8; }
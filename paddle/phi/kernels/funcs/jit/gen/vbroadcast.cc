@@ -68,7 +68,7 @@ void VBroadcastJitCode::genCode() {
 class VBroadcastCreator : public JitCodeCreator<int64_t> {
  public:
   bool CanBeUsed(const int64_t& w) const override {
-    return phi::backends::cpu::MayIUse(phi::backends::cpu::avx) &&
+    return jit::MayIUse(phi::backends::cpu::avx) &&
            w % YMM_FLOAT_BLOCK == 0;
   }
   size_t CodeSize(const int64_t& w) const override {
@@ -18,6 +18,7 @@
 
 #include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/core/enforce.h"
+#include "paddle/phi/kernels/funcs/jit/kernel_key.h"
 
 #ifdef _WIN32
 #define posix_memalign_free _aligned_free
@@ -73,7 +74,7 @@ void GenBase::operator delete(void* ptr) {
 std::vector<int> packed_groups(int n, int k, int* block_out, int* rest_out) {
   int block = 0;
   int max_num_regs = 0;
-  if (phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f)) {
+  if (jit::MayIUse(phi::backends::cpu::avx512f)) {
     block = ZMM_FLOAT_BLOCK;
     max_num_regs = 32;
   } else {
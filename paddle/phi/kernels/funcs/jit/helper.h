@@ -41,7 +41,7 @@ inline typename std::enable_if<
     const Kernel*>::type
 GetJitCode(const typename KernelTuple::attr_type& attr) {
   using Attr = typename KernelTuple::attr_type;
-  int64_t key = JitCodeKey<Attr>(attr);
+  int64_t key = JitCodeIsaKey<Attr>(attr);
   auto& codes = JitCodePool<KernelTuple::kernel_type>::Instance();
   if (codes.Has(key)) {
     return codes.AllKernels().at(key).get();
@@ -219,7 +219,7 @@ class KernelFuncs {
   typename KernelTuple::func_type At(
       const typename KernelTuple::attr_type& attr) {
     // Maybe here is not good enough, not all kernels should have jitcode
-    int64_t key = JitCodeKey<typename KernelTuple::attr_type>(attr);
+    int64_t key = JitCodeIsaKey<typename KernelTuple::attr_type>(attr);
     if (Has(key)) {
       return funcs_.at(key);
     }
@@ -16,10 +16,75 @@
 
 #include <xxhash.h>  // XXH64: 13.8 GB/s
 #include <array>
+#include <string>
+
+#include "paddle/phi/core/enforce.h"
+
+PHI_DEFINE_string(jit_max_isa,
+                  "",
+                  "The max isa the jit kernels may use, one of sse42, avx, "
+                  "avx2, avx512f, avx512_core, avx512_core_vnni and "
+                  "avx512_bf16. It is the highest one of the cpu if empty.");
 
 namespace phi {
 namespace jit {
 
+int IsaLevel(const phi::backends::cpu::cpu_isa_t isa) {
+  using namespace phi::backends::cpu;  // NOLINT
+  switch (isa) {
+    case isa_any:
+      return 0;
+    case sse42:
+      return 1;
+    case avx:
+      return 2;
+    case avx2:
+      return 3;
+    case avx512f:
+    case avx512_mic:
+    case avx512_mic_4ops:
+      return 4;
+    case avx512_core:
+      return 5;
+    case avx512_core_vnni:
+      return 6;
+    case avx512_bf16:
+      return 7;
+  }
+  return kNumIsaLevels - 1;
+}
+
+static int ParseIsaLevel(const std::string& isa) {
+  using namespace phi::backends::cpu;  // NOLINT
+  if (isa.empty()) return kNumIsaLevels - 1;
+  if (isa == "sse42") return IsaLevel(sse42);
+  if (isa == "avx") return IsaLevel(avx);
+  if (isa == "avx2") return IsaLevel(avx2);
+  if (isa == "avx512f") return IsaLevel(avx512f);
+  if (isa == "avx512_core") return IsaLevel(avx512_core);
+  if (isa == "avx512_core_vnni") return IsaLevel(avx512_core_vnni);
+  if (isa == "avx512_bf16") return IsaLevel(avx512_bf16);
+  PADDLE_THROW(phi::errors::InvalidArgument(
+      "FLAGS_jit_max_isa should be one of sse42, avx, avx2, avx512f, "
+      "avx512_core, avx512_core_vnni and avx512_bf16, but got %s.",
+      isa));
+}
+
+int MaxIsaLevel() {
+  // the flag is parsed again only when it is changed
+  static thread_local std::string isa;
+  static thread_local int level = ParseIsaLevel(isa);
+  if (FLAGS_jit_max_isa != isa) {
+    level = ParseIsaLevel(FLAGS_jit_max_isa);
+    isa = FLAGS_jit_max_isa;
+  }
+  return level;
+}
+
+bool MayIUse(const phi::backends::cpu::cpu_isa_t isa) {
+  return IsaLevel(isa) <= MaxIsaLevel() && phi::backends::cpu::MayIUse(isa);
+}
+
 template <>
 int64_t JitCodeKey<int>(const int& d) {
   return d;
@@ -13,9 +13,13 @@
  * limitations under the License. */
 
 #pragma once
+#include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/common/place.h"
+#include "paddle/phi/core/flags.h"
 #include "paddle/phi/kernels/funcs/jit/kernel_base.h"
 
+PHI_DECLARE_string(jit_max_isa);
+
 namespace phi {
 namespace jit {
 
@@ -45,5 +49,25 @@ struct KernelKey {
 template <typename Attr>
 int64_t JitCodeKey(const Attr& attr);
 
+// The isa levels in order, the avx512 ones of the mic are taken as avx512f.
+constexpr int kNumIsaLevels = 8;
+int IsaLevel(const phi::backends::cpu::cpu_isa_t isa);
+
+// The level of the max isa the kernels may use, which is the one of
+// FLAGS_jit_max_isa, or the highest if the flag is empty.
+int MaxIsaLevel();
+
+// Whether the kernels may use the isa, which is supported by the cpu and
+// is not above FLAGS_jit_max_isa, so that the kernels of the lower isa can
+// be compared on the same cpu.
+bool MayIUse(const phi::backends::cpu::cpu_isa_t isa);
+
+// The codes and funcs of the same attr differ by the isa they may use, so
+// they are cached by the key of both.
+template <typename Attr>
+inline int64_t JitCodeIsaKey(const Attr& attr) {
+  return JitCodeKey<Attr>(attr) * kNumIsaLevels + MaxIsaLevel();
+}
+
 }  // namespace jit
 }  // namespace phi
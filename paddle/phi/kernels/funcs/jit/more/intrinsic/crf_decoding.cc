@@ -16,7 +16,7 @@
 
 #include <limits>
 
-#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/kernels/funcs/jit/kernel_key.h"
 #include "paddle/phi/kernels/funcs/jit/registry.h"
 
 namespace phi {
@@ -171,7 +171,7 @@ bool CRFDecodingKernel::CanBeUsed(const int& d) const {
 #else
   constexpr int block = YMM_FLOAT_BLOCK;
 #endif
-  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx) && d >= block;
+  return jit::MayIUse(phi::backends::cpu::avx) && d >= block;
 }
 
 }  // namespace intrinsic
@@ -16,7 +16,7 @@
 
 #include <limits>
 
-#include "paddle/phi/backends/cpu/cpu_info.h"
+#include "paddle/phi/kernels/funcs/jit/kernel_key.h"
 #include "paddle/phi/kernels/funcs/jit/registry.h"
 
 namespace phi {
@@ -179,7 +179,7 @@ void LayerNorm(float* x,
 }
 
 bool LayerNormKernel::CanBeUsed(const int& d) const {
-  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx) &&
+  return jit::MayIUse(phi::backends::cpu::avx) &&
          d >= YMM_FLOAT_BLOCK;
 }
 
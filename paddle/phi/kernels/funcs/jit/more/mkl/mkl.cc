@@ -16,6 +16,7 @@
 
 #include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/backends/dynload/mklml.h"
+#include "paddle/phi/kernels/funcs/jit/kernel_key.h"
 #include "paddle/phi/kernels/funcs/jit/refer/refer.h"
 #include "paddle/phi/kernels/funcs/jit/registry.h"
 
@@ -157,17 +158,17 @@ void ASum<double>(const double* x, double* res, int n) {
 // TODO(TJ): tuning me carefully on AVX, AVX2 and AVX512
 template <>
 bool VMulKernel<float>::CanBeUsed(const int& d) const {
-  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f) && d > 512;
+  return jit::MayIUse(phi::backends::cpu::avx512f) && d > 512;
 }
 
 template <>
 bool VAddKernel<float>::CanBeUsed(const int& d) const {
-  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx) && d > 512;
+  return jit::MayIUse(phi::backends::cpu::avx) && d > 512;
 }
 
 template <>
 bool VScalKernel<float>::CanBeUsed(const int& d) const {
-  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f) && d > 512;
+  return jit::MayIUse(phi::backends::cpu::avx512f) && d > 512;
 }
 
 template <>
@@ -238,7 +239,7 @@ bool SgdKernel<double>::CanBeUsed(const sgd_attr_t& attr) const {
 
 template <>
 bool MatMulKernel<float>::CanBeUsed(const matmul_attr_t& attr) const {
-  return phi::backends::cpu::MayIUse(phi::backends::cpu::avx);
+  return jit::MayIUse(phi::backends::cpu::avx);
 }
 
 template <>
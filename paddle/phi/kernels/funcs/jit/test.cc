@@ -15,6 +15,7 @@ limitations under the License. */
 #include <array>
 #include <iostream>
 #include <random>
+#include <string>
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
@@ -1404,6 +1405,22 @@ TEST(JITKernel_key, sgd) {
   EXPECT_TRUE(key4 != key5);
 }
 
+TEST(JITKernel_key, max_isa) {
+  const std::string max_isa = FLAGS_jit_max_isa;
+  jit::seq_pool_attr_t attr(16, jit::SeqPoolType::kSum, 3);
+  FLAGS_jit_max_isa = "avx2";
+  auto key1 = jit::JitCodeIsaKey<jit::seq_pool_attr_t>(attr);
+  EXPECT_FALSE(jit::MayIUse(phi::backends::cpu::avx512f));
+  FLAGS_jit_max_isa = "avx512f";
+  auto key2 = jit::JitCodeIsaKey<jit::seq_pool_attr_t>(attr);
+  EXPECT_TRUE(key1 != key2);
+  EXPECT_EQ(jit::MayIUse(phi::backends::cpu::avx512f),
+            phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f));
+  FLAGS_jit_max_isa = "avx1024";
+  EXPECT_ANY_THROW(jit::MaxIsaLevel());
+  FLAGS_jit_max_isa = max_isa;
+}
+
 // test kernels
 #define TestKernelVMul TestKernelXYZN
 #define TestKernelVAdd TestKernelXYZN
@@ -1467,3 +1484,12 @@ TEST_CPU_KERNEL(Adam);
 TEST_CPU_KERNEL(AdamW);
 TEST_CPU_KERNEL(Sgd);
 TEST_CPU_KERNEL(VBroadcast);
+
+// the ymm kernels are tested on the cpus of avx512 by the max isa of avx2
+TEST(JITKernel, max_isa_avx2) {
+  const std::string max_isa = FLAGS_jit_max_isa;
+  FLAGS_jit_max_isa = "avx2";
+  TestKernelSeqPool<jit::SeqPoolTuple<float>, CPUPlace>();
+  TestKernelEmbSeqPool<jit::EmbSeqPoolTuple<float>, CPUPlace>();
+  FLAGS_jit_max_isa = max_isa;
+}
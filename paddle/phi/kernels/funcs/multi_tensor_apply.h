@@ -24,15 +24,20 @@ namespace funcs {
 // This code is referenced from apex's multi_tensor_apply.cuh.
 // https://github.com/NVIDIA/apex
 
+// N is the number of the tensor lists including grads, N = 1 means only the
+// grads are read, e.g. by a reduction.
 template <int N, int MaxTensorSize, int MaxBlockSize>
 struct TensorAndBlockInfo {
-  void *tensor_addrs[N - 1][MaxTensorSize];
+  void *tensor_addrs[N > 1 ? N - 1 : 1][MaxTensorSize];
   const void *grads[MaxTensorSize];
   int sizes[MaxTensorSize];
   uint8_t tensor_ids[MaxBlockSize];
   // int16
   uint16_t chunk_ids[MaxBlockSize];
   int start_chunk_id;
+  // the number of blocks of the former launches, so that blockIdx.x +
+  // block_offset indexes the chunk among all the chunks of the tensors
+  int block_offset;
 
   DEVICE void GetChunkIdAndTensorId(int *chunk_id, int *tensor_id) const {
     int block_id = blockIdx.x;
@@ -77,12 +82,11 @@ void LaunchMultiTensorApplyKernel(
           "input_vector.size() != InputNum - 1, the input vector's size is "
           "unequal to InputNum - 1, please cheack grads, params, momemts1, "
           "moments2, and, master_params."));
-  size_t length = input_vector[0].size();
+  size_t length = grads.size();
   PADDLE_ENFORCE_GT(
       length,
       0,
-      errors::InvalidArgument(
-          "input_vector[0].size() is not > 0, please cheack params."));
+      errors::InvalidArgument("grads.size() is not > 0, please cheack grads."));
   auto ctx_place = dev_ctx.GetPlace();
   PADDLE_ENFORCE_EQ(
       ctx_place.GetType() == AllocationType::GPU,
@@ -90,7 +94,7 @@ void LaunchMultiTensorApplyKernel(
       errors::PreconditionNotMet(
           "Context place error, excepted GPUPlace, but actually %s.",
           ctx_place));
-  auto place = input_vector[0][0]->place();
+  auto place = grads[0]->place();
   for (size_t i = 0; i < input_vector.size(); i++) {
     PADDLE_ENFORCE_EQ(
         input_vector[i].size(),
@@ -104,29 +108,29 @@ void LaunchMultiTensorApplyKernel(
           errors::InvalidArgument(
               "A tensor was not on the same device as the first tensor"));
       PADDLE_ENFORCE_EQ(input_vector[i][j]->numel(),
-                        input_vector[0][j]->numel(),
+                        grads[j]->numel(),
                         errors::InvalidArgument(
                             "The number of elements of Inputs must be equal."));
     }
   }
 
-  size_t tensors_size = input_vector[0].size();
+  size_t tensors_size = grads.size();
 
   TensorAndBlockInfo<InputNum, MaxTensorSize, MaxBlockSize> t_info;
   t_info.start_chunk_id = 0;
+  t_info.block_offset = 0;
 
   auto stream = dev_ctx.stream();
   int block_id = 0;
   int tensor_id = 0;
   for (int t = 0; t < tensors_size; t++) {
-    t_info.sizes[tensor_id] = input_vector[0][t]->numel();
+    t_info.sizes[tensor_id] = grads[t]->numel();
     t_info.grads[tensor_id] = grads[t]->data();
     for (int d = 0; d < InputNum - 1; d++) {
       t_info.tensor_addrs[d][tensor_id] = input_vector[d][t]->data();
     }
     tensor_id++;
-    int chunks_this_tensor =
-        (input_vector[0][t]->numel() + chunk_size - 1) / chunk_size;
+    int chunks_this_tensor = (grads[t]->numel() + chunk_size - 1) / chunk_size;
 
     constexpr auto kMaxChunkId = std::numeric_limits<uint16_t>::max();
     for (int chunk = 0; chunk < chunks_this_tensor; chunk++) {
@@ -160,6 +164,7 @@ void LaunchMultiTensorApplyKernel(
             <<<block_id, block_size, 0, stream>>>(
                 chunk_size, t_info, functor, args...);
 
+        t_info.block_offset += block_id;
         block_id = 0;
         if (chunk == chunks_this_tensor - 1) {
           tensor_id = 0;
@@ -0,0 +1,109 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#ifdef PADDLE_WITH_MKLML
+
+#include "paddle/phi/kernels/funcs/packed_weights_cache.h"
+
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+
+namespace phi {
+namespace funcs {
+
+template <typename T>
+PackedWeightsCache<T>& PackedWeightsCache<T>::Instance() {
+  static PackedWeightsCache<T> cache;
+  return cache;
+}
+
+template <typename T>
+PackedWeightsCache<T>::~PackedWeightsCache() {
+  for (auto& item : entries_) {
+    CBlas<T>::GEMM_FREE(item.second.packed);
+  }
+}
+
+template <typename T>
+void PackedWeightsCache<T>::Pack(const CPUContext& ctx, const DenseTensor& w) {
+  PADDLE_ENFORCE_EQ(
+      w.dims().size(),
+      2,
+      errors::InvalidArgument("The weight to pack must be 2-D, but got %d-D.",
+                              w.dims().size()));
+  const int K = static_cast<int>(w.dims()[0]);
+  const int N = static_cast<int>(w.dims()[1]);
+  const T* data = w.data<T>();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Sweep();
+  auto it = entries_.find(data);
+  if (it != entries_.end() && it->second.N == N && it->second.K == K) {
+    return;
+  }
+
+  auto blas = GetBlas<CPUContext, T>(ctx);
+  T* packed = blas.GEMM_ALLOC(CblasBMatrix, 1, N, K);
+  PADDLE_ENFORCE_NOT_NULL(
+      packed,
+      errors::ResourceExhausted("GEMM_ALLOC failed to allocate the packed "
+                                "weight of %d x %d.",
+                                K,
+                                N));
+  blas.GEMM_PACK(
+      CblasBMatrix, CblasNoTrans, 1, N, K, static_cast<T>(1), data, N, packed);
+  if (it != entries_.end()) {
+    CBlas<T>::GEMM_FREE(it->second.packed);
+    entries_.erase(it);
+  }
+  entries_.emplace(data, Entry{w.Holder(), N, K, packed});
+}
+
+template <typename T>
+const T* PackedWeightsCache<T>::Find(const T* w, int N, int K) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entries_.empty()) {
+    return nullptr;
+  }
+  auto it = entries_.find(w);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  if (it->second.holder.expired()) {
+    CBlas<T>::GEMM_FREE(it->second.packed);
+    entries_.erase(it);
+    return nullptr;
+  }
+  return it->second.N == N && it->second.K == K ? it->second.packed : nullptr;
+}
+
+template <typename T>
+void PackedWeightsCache<T>::Sweep() {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.holder.expired()) {
+      CBlas<T>::GEMM_FREE(it->second.packed);
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+template class PackedWeightsCache<float>;
+template class PackedWeightsCache<double>;
+
+}  // namespace funcs
+}  // namespace phi
+
+#endif
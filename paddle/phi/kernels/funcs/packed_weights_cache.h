@@ -0,0 +1,71 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#ifdef PADDLE_WITH_MKLML
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+namespace funcs {
+
+/**
+ * The weights of the fc ops packed by the mkl gemm at load time, so that the
+ * fc kernels skip packing the weights on every run. A packed weight is found
+ * by the data of its tensor, and is freed once the tensor frees its holder,
+ * as a weight of an inference program is not written after it is loaded.
+ */
+template <typename T>
+class PackedWeightsCache {
+ public:
+  static PackedWeightsCache& Instance();
+
+  ~PackedWeightsCache();
+
+  // Packs the K x N weight w, a no-op if it is packed.
+  void Pack(const CPUContext& ctx, const DenseTensor& w);
+
+  // The packed weight of the K x N w, nullptr if it is not packed.
+  const T* Find(const T* w, int N, int K);
+
+ private:
+  struct Entry {
+    std::weak_ptr<Allocation> holder;
+    int N;
+    int K;
+    T* packed;
+  };
+
+  PackedWeightsCache() = default;
+
+  // Frees the packed weights whose tensors are freed.
+  void Sweep();
+
+  std::mutex mutex_;
+  std::unordered_map<const T*, Entry> entries_;
+};
+
+extern template class PackedWeightsCache<float>;
+extern template class PackedWeightsCache<double>;
+
+}  // namespace funcs
+}  // namespace phi
+
+#endif
@@ -0,0 +1,111 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/philox_state.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include "paddle/phi/core/generator.h"
+
+#ifdef PADDLE_WITH_CUDA
+#include "paddle/phi/backends/gpu/cuda/cuda_graph.h"
+#include "paddle/phi/common/memory_utils.h"
+#endif
+
+namespace phi {
+namespace funcs {
+
+#ifdef PADDLE_WITH_CUDA
+namespace {
+
+// The offsets a CUDA Graph reserves from a state of a generator. The kernels
+// captured read the seed and the base offset from buffer, which is refreshed
+// before every replay by reserving the offsets of all of them at once.
+struct GraphPhiloxState {
+  Allocator::AllocationPtr buffer;
+  uint64_t increment{0};
+  uint64_t host_state[2];
+};
+
+using GraphPhiloxKey =
+    std::tuple<phi::backends::gpu::CUDAGraphID, phi::Generator*, uint64_t>;
+
+std::mutex graph_philox_mutex;
+std::map<GraphPhiloxKey, std::shared_ptr<GraphPhiloxState>> graph_philox_states;
+
+PhiloxState ReserveGraphPhiloxOffset(const phi::GPUContext& dev_ctx,
+                                     uint64_t increment) {
+  using phi::backends::gpu::CUDAGraph;
+  auto* generator = dev_ctx.GetGenerator();
+  const uint64_t state_index = generator->GetStateIndex();
+  const GraphPhiloxKey key{CUDAGraph::CapturingID(), generator, state_index};
+
+  std::lock_guard<std::mutex> lock(graph_philox_mutex);
+  auto& state = graph_philox_states[key];
+  if (state == nullptr) {
+    state = std::make_shared<GraphPhiloxState>();
+    state->buffer = phi::memory_utils::Alloc(dev_ctx.GetPlace(),
+                                             sizeof(state->host_state));
+    CUDAGraph::AddPreReplayCallbackDuringCapturing(
+        [state, generator, state_index](cudaStream_t stream) {
+          const uint64_t current_index = generator->GetStateIndex();
+          generator->SetStateIndex(state_index);
+          auto seed_offset = generator->IncrementOffset(state->increment);
+          generator->SetStateIndex(current_index);
+          state->host_state[0] = seed_offset.first;
+          state->host_state[1] = seed_offset.second;
+          // the pageable source is staged before the copy returns
+          PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(state->buffer->ptr(),
+                                                     state->host_state,
+                                                     sizeof(state->host_state),
+                                                     cudaMemcpyHostToDevice,
+                                                     stream));
+        });
+    CUDAGraph::AddResetCallbackDuringCapturing([key] {
+      std::lock_guard<std::mutex> lock(graph_philox_mutex);
+      graph_philox_states.erase(key);
+    });
+  }
+
+  PhiloxState philox;
+  philox.offset = state->increment;
+  philox.graph_state = reinterpret_cast<const uint64_t*>(state->buffer->ptr());
+  state->increment += increment;
+  return philox;
+}
+
+}  // namespace
+#endif
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+PhiloxState ReservePhiloxOffset(const phi::GPUContext& dev_ctx,
+                                uint64_t increment) {
+#ifdef PADDLE_WITH_CUDA
+  if (phi::backends::gpu::CUDAGraph::IsThisThreadCapturing()) {
+    return ReserveGraphPhiloxOffset(dev_ctx, increment);
+  }
+#endif
+  auto seed_offset = dev_ctx.GetGenerator()->IncrementOffset(increment);
+  PhiloxState philox;
+  philox.seed = seed_offset.first;
+  philox.offset = seed_offset.second;
+  return philox;
+}
+#endif
+
+}  // namespace funcs
+}  // namespace phi
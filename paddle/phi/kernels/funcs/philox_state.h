@@ -0,0 +1,59 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "paddle/phi/core/hostdevice.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#endif
+
+namespace phi {
+namespace funcs {
+
+// The philox seed and offset a stochastic kernel initializes its curand
+// states with. Under the capture of a CUDA Graph, graph_state points to the
+// seed and the base offset the generator reserves for the graph on the
+// device before every replay, and offset is the offset of the kernel from
+// the base, so the replays draw new numbers without patching the kernel
+// nodes.
+struct PhiloxState {
+  uint64_t seed{0};
+  uint64_t offset{0};
+  const uint64_t* graph_state{nullptr};
+
+  // Reads graph_state, so call them on the device if it is set.
+  HOSTDEVICE inline uint64_t Seed() const {
+    return graph_state == nullptr ? seed : graph_state[0];
+  }
+  HOSTDEVICE inline uint64_t Offset() const {
+    return graph_state == nullptr ? offset : graph_state[1] + offset;
+  }
+};
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+// Reserves increment offsets of the generator of dev_ctx for a kernel, which
+// is the number of the philox counters a thread of the kernel consumes.
+// Since the offsets only depend on the order of the kernels and their
+// increments, a recompute with the generator state restored draws the same
+// numbers, and so does the replay of a CUDA Graph capturing the kernels.
+PhiloxState ReservePhiloxOffset(const phi::GPUContext& dev_ctx,
+                                uint64_t increment);
+#endif
+
+}  // namespace funcs
+}  // namespace phi
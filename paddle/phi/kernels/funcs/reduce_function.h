@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <numeric>
 #include <set>
 #include <vector>
@@ -37,6 +38,9 @@ namespace cub = hipcub;
 #include "paddle/phi/backends/gpu/gpu_device_function.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/kernels/autotune/gpu_timer.h"
+#include "paddle/phi/kernels/autotune/switch_autotune.h"
+#include "paddle/phi/kernels/funcs/broadcast_function.h"
 #endif
 
 #include "paddle/phi/kernels/cast_kernel.h"
@@ -49,6 +53,9 @@ namespace cub = hipcub;
 // Reduce split or not, Whether to use ReduceHigherDim
 #define REDUCE_SPLIT_BOUNDARY 512
 #define REDUCE_VEC_SIZE 4
+// The number of the split algos of ReduceAny and ReduceLastDim, see
+// ReduceConfig::SetSplitAlgo
+#define REDUCE_SPLIT_ALGO_NUM 5
 
 namespace kps = phi::kps;
 #ifdef PADDLE_WITH_XPU_KP
@@ -148,6 +155,39 @@ static inline std::vector<int> GetDimStrides(const std::vector<int>& dims,
   }
   return strides;
 }
+
+#ifndef PADDLE_WITH_XPU_KP
+// Maps the reduce dims of x, which is not contiguous, onto the contiguous view
+// of its permuted dims, if the left dims keep their order in the view so that
+// the output is laid out the same, e.g. reducing a transposed tensor.
+static inline bool GetReduceDimsOfPermutedView(
+    const phi::DenseTensor& x,
+    const std::vector<int>& reduce_dims,
+    phi::DenseTensor* view,
+    std::vector<int>* view_reduce_dims) {
+  std::vector<int> perm;
+  if (!phi::funcs::PermutedContiguousView(x, view, &perm)) {
+    return false;
+  }
+  const int rank = x.dims().size();
+  std::vector<bool> is_reduced(rank, false);
+  for (int dim : reduce_dims) {
+    is_reduced[dim < 0 ? dim + rank : dim] = true;
+  }
+  view_reduce_dims->clear();
+  int last_left_dim = -1;
+  for (int i = 0; i < static_cast<int>(perm.size()); ++i) {
+    if (is_reduced[perm[i]]) {
+      view_reduce_dims->push_back(i);
+    } else if (perm[i] < last_left_dim) {
+      return false;
+    } else {
+      last_left_dim = perm[i];
+    }
+  }
+  return !view_reduce_dims->empty();
+}
+#endif
 }  // namespace details
 
 enum ReduceType {
@@ -253,6 +293,10 @@ struct ReduceConfig {
   MPType* tmp_data;
   dim3 block;
   dim3 grid;
+  // set by SetBlockDimForReduceAny for the split algos
+  int heuristic_split_num = 1;
+  int max_split_num = 1;
+  int max_num_blocks = 0;
 
   // Get the parameters of reduceKernel
   void Run(const KPDevice& dev_ctx) {
@@ -294,6 +338,37 @@ struct ReduceConfig {
     }
   }
 
+#ifndef PADDLE_WITH_XPU_KP
+  // Whether the outputs of ReduceAny or ReduceLastDim are too few to fill the
+  // device, so that the split of the long rows decides the performance.
+  bool CanTuneSplit() const {
+    return reduce_type != ReduceType::kReduceHigherDim &&
+           static_cast<int>(grid.x) < max_num_blocks && max_split_num > 1;
+  }
+
+  // Set the number of blocks splitting the reduce dim, the partial results
+  // of the blocks are combined by a second pass. The split algos are
+  //   0: the split of SetBlockDimForReduceAny
+  //   1: no split, the reduction is done in a single pass
+  //   2, 3, 4: the grid is 1, 2, 4 waves of the device
+  // The split number set is returned.
+  int SetSplitAlgo(int64_t algo) {
+    int split_num = heuristic_split_num;
+    if (algo == 1) {
+      split_num = 1;
+    } else if (algo > 1) {
+      split_num = details::CeilingDiv(max_num_blocks << (algo - 2),
+                                      static_cast<int>(grid.x * grid.z));
+    }
+    int device_id = phi::backends::gpu::GetCurrentDeviceId();
+    int max_grid_y = phi::backends::gpu::GetGpuMaxGridDimSize(device_id)[1];
+    split_num = std::max(1, std::min({split_num, max_split_num, max_grid_y}));
+    grid.y = split_num;
+    should_reduce_again = split_num > 1;
+    return split_num;
+  }
+#endif
+
  private:
   // set reduce_dim, left_dim and update x_dim
   // eg: x_dim = [2, 4, 6] origin_reduce_dims = [0, 1]
@@ -471,7 +546,7 @@ struct ReduceConfig {
         phi::backends::gpu::GetGPUMaxThreadsPerMultiProcessor(device_id);
     int max_threads = max_threads_per_mp * max_mp;
     int num_threads = block_dim->x * block_dim->y;
-    int max_num_blocks = max_threads / num_threads;
+    max_num_blocks = max_threads / num_threads;
 
     // Set grid size.
     // Whether to set grid.y larger than 1, there are 3 following rules:
@@ -491,6 +566,8 @@ struct ReduceConfig {
     grid_dim->x = grid_num;
     grid_dim->y = std::max(std::min(input_split_num_1, input_split_num_3),
                            input_split_num_2);
+    heuristic_split_num = grid_dim->y;
+    max_split_num = reduce_num_per_thread;
     // if grid.y > 1, we need launch reduce kernel again.
     if (grid_dim->y > 1) {
       should_reduce_again = true;
@@ -926,6 +1003,88 @@ static void LaunchReduceKernel(const Tx* x_data,
 
 #if !defined(PADDLE_WITH_XPU_KP)
 
+// For the reductions of long rows into few outputs, e.g. the sum of a loss or
+// the global norm of the gradients, the split of the rows decides how many
+// SMs are busy and whether a second pass is needed. When autotune is on, the
+// split algos of ReduceConfig are timed once for the shape, and the fastest
+// one is cached in AutoTuneCache.
+template <typename Tx,
+          typename Ty,
+          typename MPType,
+          typename ReduceOp,
+          typename TransformOp>
+static void TuneReduceSplit(const KPDevice& dev_ctx,
+                            const Tx* x_data,
+                            Ty* y_data,
+                            const ReduceOp& reducer,
+                            const TransformOp& transform,
+                            MPType init,
+                            bool is_mean,
+                            ReduceConfig<Ty, MPType>* config) {
+  if (!config->CanTuneSplit()) {
+    return;
+  }
+  size_t key = autotune::GenKey(config->x_dim,
+                                config->reduce_dim,
+                                static_cast<int64_t>(sizeof(Tx)),
+                                static_cast<int64_t>(sizeof(MPType)));
+  auto& cache =
+      autotune::AutoTuneCache::Instance().Get(autotune::AlgorithmType::kReduce);
+  if (cache.Find(key)) {
+    config->SetSplitAlgo(cache.Get(key));
+    return;
+  }
+  if (!autotune::AutoTuneStatus::Instance().UseAutoTune()) {
+    return;
+  }
+
+  // Regard 1st run as warmup, judge the compare result by the time cost
+  // of rest cycles.
+  constexpr int repeats = 11;
+  auto stream = dev_ctx.stream();
+  phi::GpuTimer timer;
+  std::vector<int> tuned_split_nums;
+  int64_t best_algo = 0;
+  float min_time = std::numeric_limits<float>::max();
+  dev_ctx.Wait();
+  for (int64_t algo = 0; algo < REDUCE_SPLIT_ALGO_NUM; ++algo) {
+    auto tune_config = *config;
+    int split_num = tune_config.SetSplitAlgo(algo);
+    if (std::find(tuned_split_nums.begin(),
+                  tuned_split_nums.end(),
+                  split_num) != tuned_split_nums.end()) {
+      continue;
+    }
+    tuned_split_nums.push_back(split_num);
+    phi::DenseTensor tmp;
+    tune_config.SetOutputData(y_data, dev_ctx, &tmp);
+    float time_cost = 0;
+    for (int i = 0; i < repeats; ++i) {
+      timer.Start(stream);
+      LaunchReduceKernel<Tx, Ty, MPType, ReduceOp, TransformOp>(x_data,
+                                                                y_data,
+                                                                reducer,
+                                                                transform,
+                                                                init,
+                                                                stream,
+                                                                tune_config,
+                                                                is_mean);
+      timer.Stop(stream);
+      if (i > 0) {
+        time_cost += timer.ElapsedTime();
+      }
+    }
+    VLOG(3) << "reduce split algo " << algo << " with split_num " << split_num
+            << " time cost " << time_cost;
+    if (time_cost < min_time) {
+      min_time = time_cost;
+      best_algo = algo;
+    }
+  }
+  cache.Set(key, best_algo);
+  config->SetSplitAlgo(best_algo);
+}
+
 template <typename Tx,
           typename Ty,
           template <typename>
@@ -1057,6 +1216,26 @@ void ReduceKernel(const KPDevice& dev_ctx,
   auto stream = dev_ctx.x_context()->xpu_stream;
 #else
   auto stream = dev_ctx.stream();
+  // x not contiguous is reduced as the contiguous view of its permuted dims
+  // if possible, or else read once through its strides into a contiguous one.
+  if (!x.meta().is_contiguous()) {
+    phi::DenseTensor x_view;
+    std::vector<int> view_reduce_dims;
+    if (!details::GetReduceDimsOfPermutedView(
+            x, origin_reduce_dims, &x_view, &view_reduce_dims)) {
+      x_view = phi::DenseTensor();
+      x_view.Resize(x.dims());
+      dev_ctx.template Alloc<Tx>(&x_view);
+      std::vector<const DenseTensor*> inputs = {&x};
+      std::vector<DenseTensor*> outputs = {&x_view};
+      funcs::BroadcastKernel<Tx>(
+          dev_ctx, inputs, &outputs, kps::IdentityFunctor<Tx>());
+      view_reduce_dims = origin_reduce_dims;
+    }
+    ReduceKernel<Tx, Ty, ReduceOp, TransformOp, IsMean>(
+        dev_ctx, x_view, y, transform, view_reduce_dims);
+    return;
+  }
 #endif
   dev_ctx.Alloc<Ty>(y);
 
@@ -1091,7 +1270,6 @@ void ReduceKernel(const KPDevice& dev_ctx,
     return;
   }
 
-  config.SetOutputData(y_data, dev_ctx, &tmp);
   constexpr bool kIsTxFP16 = std::is_same<Tx, phi::dtype::float16>::value;
   constexpr bool kIsTxBF16 = std::is_same<Tx, phi::dtype::bfloat16>::value;
   bool use_cub_reduce = config.reduce_num == numel && !kIsTxFP16 && !kIsTxBF16;
@@ -1105,6 +1283,18 @@ void ReduceKernel(const KPDevice& dev_ctx,
 #endif
 
   auto reducer = ReduceOp<MPType>();
+#ifndef PADDLE_WITH_XPU_KP
+  TuneReduceSplit<Tx, Ty, MPType, ReduceOp<MPType>, TransformOp>(
+      dev_ctx,
+      x_data,
+      y_data,
+      reducer,
+      transform,
+      reducer.initial(),
+      IsMean,
+      &config);
+#endif
+  config.SetOutputData(y_data, dev_ctx, &tmp);
   // launch ReduceHigherDimKernel
   // when reduce_dim.size() == 1 and reduce_dim[0] != x_dim.size() - 1, this
   // function will be used
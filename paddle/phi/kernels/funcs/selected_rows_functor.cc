@@ -30,6 +30,10 @@ limitations under the License. */
 #include "paddle/phi/backends/onednn/axpy_handler.h"
 #endif
 
+#ifdef PADDLE_WITH_MKLML
+#include <omp.h>
+#endif
+
 #include "glog/logging.h"
 
 namespace phi {
@@ -438,13 +442,15 @@ typename std::enable_if<std::is_integral<T>::value>::type elementwise_add_to(
 template <typename T, typename DeviceContext>
 typename std::enable_if<std::is_same<T, phi::dtype::bfloat16>::value>::type
 add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
-                  const std::unordered_map<int64_t, size_t>& rows_to_id,
+                  const std::vector<size_t>& out_ids,
+                  size_t out_rows_size UNUSED,
                   int64_t input_width,
                   const DeviceContext& context,
                   T* out_data) {
 #ifndef PADDLE_WITH_DNNL
   auto blas = phi::funcs::GetBlas<DeviceContext, T>(context);
 #endif
+  size_t k = 0;
   for (auto* input : inputs) {
     if (input->rows().empty()) {
       continue;
@@ -457,13 +463,13 @@ add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
     funcs::OneDNNAXPYHandler<T> axpy_handler(
         input_width, T(1.f), onednn_context.GetEngine());
     for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
+      size_t out_i = out_ids[k++];
       axpy_handler(&input_data[i * input_width],
                    &out_data[out_i * input_width]);
     }
 #else
     for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
+      size_t out_i = out_ids[k++];
       elementwise_add_to<T, DeviceContext>(&blas,
                                            static_cast<size_t>(input_width),
                                            &input_data[i * input_width],
@@ -473,28 +479,49 @@ add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
   }
 }
 
+// The merged rows are split into a range for every thread, a thread adds
+// only the input rows of its range, so that every merged row is summed by
+// one thread in the order of the inputs as the sequential merge does.
 template <typename T, typename DeviceContext>
 typename std::enable_if<!std::is_same<T, phi::dtype::bfloat16>::value>::type
 add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
-                  const std::unordered_map<int64_t, size_t>& rows_to_id,
+                  const std::vector<size_t>& out_ids,
+                  size_t out_rows_size,
                   int64_t input_width,
                   const DeviceContext& context,
                   T* out_data) {
   VLOG(4) << "[CPU] add_sparse_inputs <" << typeid(T).name();
-  auto blas = phi::funcs::GetBlas<DeviceContext, T>(context);
-  for (auto* input : inputs) {
-    if (input->rows().empty()) {
-      continue;
-    }
-    auto* input_data = input->value().data<T>();
-    auto& input_rows = input->rows();
-
-    for (size_t i = 0; i < input_rows.size(); i++) {
-      size_t out_i = rows_to_id.at(input_rows[i]);
-      elementwise_add_to<T, DeviceContext>(&blas,
-                                           static_cast<size_t>(input_width),
-                                           &input_data[i * input_width],
-                                           &out_data[out_i * input_width]);
+  int num_partitions = 1;
+#ifdef PADDLE_WITH_MKLML
+  // a small merge is not worth the threads
+  if (out_ids.size() * input_width >= (1 << 16)) {
+    num_partitions = static_cast<int>(std::min<size_t>(
+        std::max(omp_get_max_threads(), 1), out_rows_size));
+  }
+#pragma omp parallel for num_threads(num_partitions)
+#endif
+  for (int p = 0; p < num_partitions; ++p) {
+    size_t begin = out_rows_size * p / num_partitions;
+    size_t end = out_rows_size * (p + 1) / num_partitions;
+    auto blas = phi::funcs::GetBlas<DeviceContext, T>(context);
+    size_t k = 0;
+    for (auto* input : inputs) {
+      if (input->rows().empty()) {
+        continue;
+      }
+      auto* input_data = input->value().data<T>();
+      size_t input_rows_size = input->rows().size();
+
+      for (size_t i = 0; i < input_rows_size; i++) {
+        size_t out_i = out_ids[k++];
+        if (out_i < begin || out_i >= end) {
+          continue;
+        }
+        elementwise_add_to<T, DeviceContext>(&blas,
+                                             static_cast<size_t>(input_width),
+                                             &input_data[i * input_width],
+                                             &out_data[out_i * input_width]);
+      }
     }
   }
 }
@@ -540,8 +567,7 @@ struct MergeAddImpl {
     auto input_width = has_value_input->value().dims()[1];
     auto input_height = has_value_input->height();
     phi::SelectedRows& out = *output;
-    std::set<int64_t> merged_row_set;
-    size_t row_num = 0;
+    std::vector<int64_t> all_rows;
     for (auto* input : inputs) {
       if (input->rows().empty()) {
         continue;
@@ -555,26 +581,25 @@ struct MergeAddImpl {
           input_height,
           input->height(),
           phi::errors::InvalidArgument("All inputs should have same height."));
-      row_num += input->rows().size();
-      merged_row_set.insert(input->rows().begin(), input->rows().end());
+      all_rows.insert(
+          all_rows.end(), input->rows().begin(), input->rows().end());
     }
+    size_t row_num = all_rows.size();
+    // the merged rows are sorted and unique
+    std::vector<int64_t> merge_rows(all_rows);
+    std::sort(merge_rows.begin(), merge_rows.end());
+    merge_rows.erase(std::unique(merge_rows.begin(), merge_rows.end()),
+                     merge_rows.end());
 
     out.set_height(input_height);
     DenseTensor* out_tensor = out.mutable_value();
     out_tensor->Resize(common::make_ddim(
-        {static_cast<int64_t>(merged_row_set.size()), input_width}));
+        {static_cast<int64_t>(merge_rows.size()), input_width}));
     auto* out_data = context.template Alloc<T>(out_tensor);
 
-    if (merged_row_set.size() == row_num && !sorted_result) {
+    if (merge_rows.size() == row_num && !sorted_result) {
       // no duplicated ids, just concat the result together
-      std::vector<int64_t> merge_rows;
-      merge_rows.reserve(row_num);
-      // concat rows
-      for (auto* in : inputs) {
-        merge_rows.insert(
-            merge_rows.end(), in->rows().begin(), in->rows().end());
-      }
-      out.set_rows(merge_rows);
+      out.set_rows(all_rows);
       auto in_place = inputs[0]->place();
       auto out_place = out.place();
       int64_t copied_numel = 0;
@@ -589,25 +614,23 @@ struct MergeAddImpl {
         copied_numel += static_cast<int64_t>(in_numel);
       }
     } else {
-      std::vector<int64_t> merge_rows(merged_row_set.begin(),
-                                      merged_row_set.end());
-
-      if (sorted_result) {
-        std::sort(merge_rows.begin(), merge_rows.end());
-      }
-
       out.set_rows(merge_rows);
 
       phi::funcs::SetConstant<DeviceContext, T> constant_functor;
       constant_functor(context, out.mutable_value(), static_cast<T>(0.f));
 
-      std::unordered_map<int64_t, size_t> rows_to_id;
-      for (size_t i = 0; i < merge_rows.size(); ++i) {
-        rows_to_id[merge_rows[i]] = i;
+      std::vector<size_t> out_ids(row_num);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+      for (int64_t i = 0; i < static_cast<int64_t>(row_num); ++i) {
+        out_ids[i] = std::lower_bound(
+                         merge_rows.begin(), merge_rows.end(), all_rows[i]) -
+                     merge_rows.begin();
       }
 
       add_sparse_inputs<T, DeviceContext>(
-          inputs, rows_to_id, input_width, context, out_data);
+          inputs, out_ids, merge_rows.size(), input_width, context, out_data);
     }
   }
 };
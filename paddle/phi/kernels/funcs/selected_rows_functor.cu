@@ -12,7 +12,7 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
-#include <set>
+#include <algorithm>
 #include <vector>
 
 #include "glog/logging.h"
@@ -342,29 +342,18 @@ template struct SelectedRowsAddToTensor<phi::GPUContext,
 
 namespace scatter {
 
+// out_ids are the indexes of the input rows in the merged rows, which are
+// looked up on the host, where the rows of SelectedRows live.
 template <typename T, int block_size>
 __global__ void MergeAddKernel(const T* input,
-                               const int64_t* input_rows,
+                               const int64_t* out_ids,
                                T* out,
-                               const int64_t* out_rows,
-                               size_t out_rows_size,
                                int64_t row_numel) {
   const int ty = blockIdx.x;
   int tid = threadIdx.x;
-  __shared__ size_t out_idx;
-
-  if (tid == 0) {
-    for (size_t i = 0; i < out_rows_size; i++) {
-      if (input_rows[ty] == out_rows[i]) {
-        out_idx = i;
-      }
-    }
-  }
-
-  __syncthreads();
 
   input += ty * row_numel;
-  out += out_idx * row_numel;
+  out += out_ids[ty] * row_numel;
   for (int index = tid; index < row_numel; index += block_size) {
     phi::CudaAtomicAdd(out + index, input[index]);
   }
@@ -384,45 +373,9 @@ struct MergeAddImpl {
                   const phi::SelectedRows& input,
                   phi::SelectedRows* output,
                   const bool sorted_result = false) {
-    phi::Vector<int64_t> input_rows(input.rows());
-    if (input_rows.size() == 0) {
-      return;
-    }
-
-    phi::SelectedRows& out = *output;
-    std::set<int64_t> row_set(input_rows.begin(), input_rows.end());
-    std::vector<int64_t> merge_rows_cpu(row_set.begin(), row_set.end());
-    phi::Vector<int64_t> merge_rows(merge_rows_cpu);
-
-    auto input_width = input.value().dims()[1];
-
-    out.set_rows(merge_rows);
-    out.set_height(input.height());
-    DenseTensor* out_tensor = out.mutable_value();
-    out_tensor->Resize(common::make_ddim(
-        {static_cast<int64_t>(merge_rows.size()), input_width}));
-    context.template Alloc<T>(out_tensor);
-
-    phi::funcs::SetConstant<DeviceContext, T> constant_functor;
-    constant_functor(context, out.mutable_value(), static_cast<T>(0));
-
-    auto* out_data = out.mutable_value()->data<T>();
-    auto* input_data = input.value().data<T>();
-
-    const int block_size = 256;
-    dim3 threads(block_size, 1);
-    dim3 grid1(input_rows.size(), 1);
-
-    phi::MixVector<int64_t> mix_vector_input(&input_rows);
-    phi::MixVector<int64_t> mix_vector_out(out.mutable_rows());
-    MergeAddKernel<T, 256><<<grid1, threads, 0, context.stream()>>>(
-        input_data,
-        mix_vector_input.CUDAData(context.GetPlace()),
-        out_data,
-        mix_vector_out.CUDAMutableData(context.GetPlace()),
-        out.rows().size(),
-        input_width);
-    mix_vector_out.CopyToCPU();
+    std::vector<const phi::SelectedRows*> inputs;
+    inputs.push_back(&input);
+    (*this)(context, inputs, output, sorted_result);
   }
 
   void operator()(const DeviceContext& context,
@@ -447,7 +400,7 @@ struct MergeAddImpl {
     auto input_width = has_value_input->value().dims()[1];
     auto input_height = has_value_input->height();
     phi::SelectedRows& out = *output;
-    std::set<int64_t> merged_row_set;
+    std::vector<int64_t> all_rows;
     for (auto* input : inputs) {
       if (input->rows().size() == 0) {
         continue;
@@ -461,11 +414,20 @@ struct MergeAddImpl {
           input_height,
           input->height(),
           phi::errors::InvalidArgument("All input should have same height."));
-      merged_row_set.insert(input->rows().begin(), input->rows().end());
+      all_rows.insert(
+          all_rows.end(), input->rows().begin(), input->rows().end());
+    }
+    // the merged rows are sorted and unique
+    std::vector<int64_t> merge_rows(all_rows);
+    std::sort(merge_rows.begin(), merge_rows.end());
+    merge_rows.erase(std::unique(merge_rows.begin(), merge_rows.end()),
+                     merge_rows.end());
+    std::vector<int64_t> out_ids(all_rows.size());
+    for (size_t i = 0; i < all_rows.size(); ++i) {
+      out_ids[i] = std::lower_bound(
+                       merge_rows.begin(), merge_rows.end(), all_rows[i]) -
+                   merge_rows.begin();
     }
-    std::vector<int64_t> merge_rows_cpu(merged_row_set.begin(),
-                                        merged_row_set.end());
-    phi::Vector<int64_t> merge_rows(merge_rows_cpu);
 
     out.set_rows(merge_rows);
     out.set_height(input_height);
@@ -483,24 +445,20 @@ struct MergeAddImpl {
     const int block_size = 256;
     dim3 threads(block_size, 1);
 
+    // the indexes of all inputs are copied to the device at once
+    phi::MixVector<int64_t> mix_vector_out_ids(&out_ids);
+    const int64_t* out_ids_data =
+        mix_vector_out_ids.CUDAData(context.GetPlace());
     for (auto* input : inputs) {
       if (input->rows().size() == 0) {
         continue;
       }
       auto* input_data = input->value().data<T>();
-      auto& input_rows = input->rows();
-      dim3 grid1(input_rows.size(), 1);
+      dim3 grid1(input->rows().size(), 1);
 
-      phi::MixVector<int64_t> mix_vector_input(&input_rows);
-      phi::MixVector<int64_t> mix_vector_out(out.mutable_rows());
       MergeAddKernel<T, 256><<<grid1, threads, 0, context.stream()>>>(
-          input_data,
-          mix_vector_input.CUDAData(context.GetPlace()),
-          out_data,
-          mix_vector_out.CUDAMutableData(context.GetPlace()),
-          out.rows().size(),
-          input_width);
-      mix_vector_out.CopyToCPU();
+          input_data, out_ids_data, out_data, input_width);
+      out_ids_data += input->rows().size();
     }
   }
 };
@@ -14,8 +14,13 @@ limitations under the License. */
 
 #pragma once
 
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include "paddle/common/ddim.h"
 #include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/empty_kernel.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
 
 namespace phi {
@@ -296,6 +301,85 @@ inline void SaveToTable(const Context& dev_ctx,
   }
 }
 
+// The rulebook of a conv without key is cached in the indices dict of out
+// under the key of its geometry, together with the indices of x it is built
+// from and the indices of out, so that the convs of the same geometry on the
+// same indices, e.g. the stacked subm convs of a backbone, build it once.
+inline std::string RulebookCacheKey(const DDim& x_dims,
+                                    const std::vector<int>& kernel_sizes,
+                                    const std::vector<int>& paddings,
+                                    const std::vector<int>& dilations,
+                                    const std::vector<int>& strides,
+                                    const bool subm) {
+  std::ostringstream key;
+  key << "@rulebook_cache:" << (subm ? "subm" : "conv") << x_dims;
+  for (const auto* attr : {&kernel_sizes, &paddings, &dilations, &strides}) {
+    key << ";";
+    for (int v : *attr) key << v << ",";
+  }
+  return key.str();
+}
+
+inline std::string RulebookCacheIndicesKey(const std::string& cache_key) {
+  return cache_key + ":indices";
+}
+
+// Returns the cached rulebook of cache_key and sets out by it, or nullptr if
+// it is not cached for the indices of x. The rulebook and counter are also
+// returned as the outputs like the ones which are built.
+template <typename T, typename IntT, typename Context>
+inline const IntT* PrepareCachedRulebook(const Context& dev_ctx,
+                                         const SparseCooTensor& x,
+                                         const std::string& cache_key,
+                                         const DDim& out_dims,
+                                         const int out_channels,
+                                         SparseCooTensor* out,
+                                         int* counter,
+                                         int* offsets,
+                                         int* rulebook_len,
+                                         bool* need_product_rulebook,
+                                         DenseTensor* out_rulebook,
+                                         DenseTensor* out_counter) {
+  const auto* indices_pairs = x.IndicesPairs(cache_key);
+  const auto* cached_indices =
+      x.IndicesPairs(RulebookCacheIndicesKey(cache_key));
+  if (indices_pairs == nullptr || cached_indices == nullptr) {
+    return nullptr;
+  }
+  // the cached indices of x hold their allocation, so the same data pointer
+  // means the same indices
+  const DenseTensor& x_indices = cached_indices->first;
+  if (x_indices.data() != x.indices().data() ||
+      x_indices.dims() != x.indices().dims()) {
+    return nullptr;
+  }
+  *need_product_rulebook = false;
+  const DenseTensor& rulebook = indices_pairs->first;
+  const DenseTensor& h_counter = indices_pairs->second;
+  const int counter_size = h_counter.numel();
+  memcpy(counter, h_counter.data<int>(), counter_size * sizeof(int));
+  PrefixSum<int>(counter, offsets, counter_size);
+  *rulebook_len = rulebook.dims()[1];
+
+  const DenseTensor& out_indices = cached_indices->second;
+  DenseTensor out_values =
+      phi::Empty<T>(dev_ctx, {out_indices.dims()[1], out_channels});
+  out->SetMember(out_indices, out_values, out_dims, false);
+  SaveToTable(
+      dev_ctx, x, "", rulebook, h_counter, out, out_rulebook, out_counter);
+  return rulebook.data<IntT>();
+}
+
+inline void SaveToRulebookCache(const SparseCooTensor& x,
+                                const std::string& cache_key,
+                                const DenseTensor& rulebook,
+                                const DenseTensor& h_counter,
+                                SparseCooTensor* out) {
+  out->SaveIndicesPairs(cache_key, std::make_pair(rulebook, h_counter));
+  out->SaveIndicesPairs(RulebookCacheIndicesKey(cache_key),
+                        std::make_pair(x.indices(), out->indices()));
+}
+
 }  // namespace sparse
 }  // namespace funcs
 }  // namespace phi
@@ -912,76 +912,181 @@ void LaunchGatherKthValue(const phi::GPUContext& dev_ctx,
       input_data, k, num_rows, num_cols, out_data, indices_data);
 }
 
+// The top k of the slices, each one selected by one block without sorting.
+// Every row of num_cols is split evenly into num_segments slices, each one of
+// no less than k elements, whose top k are written to the k elements of the
+// output at the slice. If src_indices, of the shape of the input, is not
+// null, the indices written are taken from it instead of the positions in the
+// row, by which the top k of the segments of a row are reduced.
 template <typename T, bool Largest>
 __global__ void RadixTopK(const T* input,
+                          const int64_t* src_indices,
                           int k,
-                          int slice_num,
-                          int slice_size,
+                          int64_t num_rows,
+                          int64_t num_cols,
+                          int num_segments,
                           T* output,
                           int64_t* indices) {
   __shared__ int shared_mem[32];
 
-  // 1. Find the k-th value
-  T kth_value = static_cast<T>(0);
-  RadixSearch<T, typename RadixTypeConfig<T>::RadixType, Largest>(
-      input, k, slice_size, shared_mem, &kth_value);
-  const auto converted_kth_value = RadixTypeConfig<T>::Convert(kth_value);
+  const int64_t num_slices = num_rows * num_segments;
+  for (int64_t slice = blockIdx.x; slice < num_slices; slice += gridDim.x) {
+    const int64_t row = slice / num_segments;
+    const int64_t segment = slice % num_segments;
+    const int64_t begin = segment * num_cols / num_segments;
+    const int slice_size =
+        static_cast<int>((segment + 1) * num_cols / num_segments - begin);
+    const T* slice_input = input + row * num_cols + begin;
+    const int64_t* slice_src_indices =
+        src_indices ? src_indices + row * num_cols + begin : nullptr;
+    T* slice_output = output + slice * k;
+    int64_t* slice_indices = indices + slice * k;
+    auto index_of = [&](int i) -> int64_t {
+      return slice_src_indices ? slice_src_indices[i] : begin + i;
+    };
 
-  // 2. Select the value strictly less/greater than kth_value and their indices
-  int block_dim = static_cast<int>(blockDim.x);
-  int loop = ((slice_size + block_dim - 1) / block_dim * block_dim);
-  int write_start = 0;
+    // 1. Find the k-th value
+    T kth_value = static_cast<T>(0);
+    RadixSearch<T, typename RadixTypeConfig<T>::RadixType, Largest>(
+        slice_input, k, slice_size, shared_mem, &kth_value);
+    const auto converted_kth_value = RadixTypeConfig<T>::Convert(kth_value);
+
+    // 2. Select the value strictly less/greater than kth_value and their
+    // indices
+    int block_dim = static_cast<int>(blockDim.x);
+    int loop = ((slice_size + block_dim - 1) / block_dim * block_dim);
+    int write_start = 0;
+
+    for (int i = threadIdx.x; i < loop; i += blockDim.x) {
+      bool valid = i < slice_size;
+      T v = valid ? slice_input[i] : static_cast<T>(0);
+      const auto convertd_v = RadixTypeConfig<T>::Convert(v);
+      bool is_top_k;
+      if (Largest) {
+        is_top_k = valid && (convertd_v > converted_kth_value);
+      } else {
+        is_top_k = valid && (convertd_v < converted_kth_value);
+      }
 
-  for (int i = threadIdx.x; i < loop; i += blockDim.x) {
-    bool valid = i < slice_size;
-    T v = valid ? input[i] : static_cast<T>(0);
-    const auto convertd_v = RadixTypeConfig<T>::Convert(v);
-    bool is_top_k;
-    if (Largest) {
-      is_top_k = valid && (convertd_v > converted_kth_value);
-    } else {
-      is_top_k = valid && (convertd_v < converted_kth_value);
+      int index;
+      int carry;
+      ExclusiveBinaryPrefixScan<int, true, kps::AddFunctor<int>>(
+          shared_mem, is_top_k, &index, &carry, kps::AddFunctor<int>());
+      if (is_top_k) {
+        int write_index = write_start + index;
+        slice_output[write_index] = v;
+        slice_indices[write_index] = index_of(i);
+      }
+      write_start += carry;
     }
 
-    int index;
-    int carry;
-    ExclusiveBinaryPrefixScan<int, true, kps::AddFunctor<int>>(
-        shared_mem, is_top_k, &index, &carry, kps::AddFunctor<int>());
-    if (is_top_k) {
-      int write_index = write_start + index;
-      output[write_index] = v;
-      indices[write_index] = i;
+    // 3. Fill the rest with value == kth_value
+    assert(k >= write_start);
+    int remain = k - write_start;
+    for (int i = threadIdx.x; i < loop; i += blockDim.x) {
+      bool valid = i < slice_size;
+      T v = valid ? slice_input[i] : static_cast<T>(0);
+      const auto convertd_v = RadixTypeConfig<T>::Convert(v);
+      bool is_top_k = valid && (convertd_v == converted_kth_value);
+
+      int index;
+      int carry;
+      ExclusiveBinaryPrefixScan<int, true, kps::AddFunctor<int>>(
+          shared_mem, is_top_k, &index, &carry, kps::AddFunctor<int>());
+      if (is_top_k && index < remain) {
+        int write_index = write_start + index;
+        assert(write_index < k);
+        slice_output[write_index] = v;
+        slice_indices[write_index] = index_of(i);
+      }
+
+      if (carry >= remain) {
+        break;
+      }
+
+      remain -= carry;
+      write_start += carry;
     }
-    write_start += carry;
+    // the shared memory is reused by the next slice
+    __syncthreads();
   }
+}
 
-  // 3. Fill the rest with value == kth_value
-  assert(k >= write_start);
-  int remain = k - write_start;
-  for (int i = threadIdx.x; i < loop; i += blockDim.x) {
-    bool valid = i < slice_size;
-    T v = valid ? input[i] : static_cast<T>(0);
-    const auto convertd_v = RadixTypeConfig<T>::Convert(v);
-    bool is_top_k = valid && (convertd_v == converted_kth_value);
-
-    int index;
-    int carry;
-    ExclusiveBinaryPrefixScan<int, true, kps::AddFunctor<int>>(
-        shared_mem, is_top_k, &index, &carry, kps::AddFunctor<int>());
-    if (is_top_k && index < remain) {
-      int write_index = write_start + index;
-      assert(write_index < k);
-      output[write_index] = v;
-      indices[write_index] = i;
-    }
+// the least elements of a segment when a row is split for multiple blocks
+constexpr int64_t kRadixTopKMinSegmentCols = 4096;
 
-    if (carry >= remain) {
-      break;
+// Selects the top k of every row of the input by the radix select, without
+// sorting them. Every row is selected by one block if the rows are enough to
+// occupy the device. Otherwise, the long rows are split into segments, whose
+// top k are selected by the blocks of the first pass and reduced to the top k
+// of the rows by the second pass, as long as the candidates are no more than
+// a quarter of the row.
+template <typename T>
+void LaunchRadixTopK(const phi::GPUContext& ctx,
+                     const T* input,
+                     int64_t num_rows,
+                     int64_t num_cols,
+                     int k,
+                     bool largest,
+                     T* output,
+                     int64_t* indices) {
+  const int64_t max_blocks = ctx.GetCUDAMaxGridDimSize()[0];
+  const int64_t occupied_blocks = static_cast<int64_t>(ctx.GetSMCount()) * 4;
+  const int64_t max_segments = std::min<int64_t>(
+      num_cols / kRadixTopKMinSegmentCols, num_cols / (4 * k));
+  int num_segments = 1;
+  if (num_rows < occupied_blocks && max_segments > 1) {
+    num_segments = static_cast<int>(std::min<int64_t>(
+        divide_round_up(occupied_blocks, num_rows), max_segments));
+  }
+
+  auto launch = [&](const T* in,
+                    const int64_t* src_indices,
+                    int64_t cols,
+                    int segments,
+                    T* out,
+                    int64_t* out_indices) {
+    const int64_t num_slices = num_rows * segments;
+    const int grid = static_cast<int>(std::min(num_slices, max_blocks));
+    const int threads = static_cast<int>(std::min<size_t>(
+        round_up(divide_round_up(cols, segments), WARP_SIZE),
+        MAX_NUM_THREADS));
+    if (largest) {
+      RadixTopK<T, true><<<grid, threads, 0, ctx.stream()>>>(
+          in, src_indices, k, num_rows, cols, segments, out, out_indices);
+    } else {
+      RadixTopK<T, false><<<grid, threads, 0, ctx.stream()>>>(
+          in, src_indices, k, num_rows, cols, segments, out, out_indices);
     }
+  };
 
-    remain -= carry;
-    write_start += carry;
+  if (num_segments == 1) {
+    launch(input, nullptr, num_cols, 1, output, indices);
+    return;
   }
+  VLOG(4) << "TopKOP: select the top " << k << " of " << num_rows
+          << " rows of " << num_cols << " by " << num_segments
+          << " segments of each row";
+  const int64_t candidate_cols = static_cast<int64_t>(num_segments) * k;
+  Tensor candidate_values;
+  Tensor candidate_indices;
+  candidate_values.Resize({num_rows, candidate_cols});
+  candidate_indices.Resize({num_rows, candidate_cols});
+  T* candidate_values_data = ctx.template Alloc<T>(&candidate_values);
+  int64_t* candidate_indices_data =
+      ctx.template Alloc<int64_t>(&candidate_indices);
+  launch(input,
+         nullptr,
+         num_cols,
+         num_segments,
+         candidate_values_data,
+         candidate_indices_data);
+  launch(candidate_values_data,
+         candidate_indices_data,
+         candidate_cols,
+         1,
+         output,
+         indices);
 }
 #endif
 /*---------------------------Radix TopK End------------------*/
@@ -1029,7 +1134,8 @@ __global__ void AssignGradWithAxis(const T* grad_out,
     }
   }
 }
-// use the radix sort for the topk
+// use the radix sort for the topk, the indices of the input are taken from
+// input_indices_tensor if it is not null, e.g. to sort the unsorted top k.
 template <typename T>
 bool SortTopk(const phi::GPUContext& ctx,
               const phi::DenseTensor* input_tensor,
@@ -1038,14 +1144,12 @@ bool SortTopk(const phi::GPUContext& ctx,
               const int k,
               phi::DenseTensor* out_tensor,
               phi::DenseTensor* indices_tensor,
-              bool largest = true) {
+              bool largest = true,
+              const phi::DenseTensor* input_indices_tensor = nullptr) {
   auto cu_stream = ctx.stream();
 
-  Tensor input_indices;
   const std::vector<int64_t> dims = {num_rows, num_cols};
   auto dim = common::make_ddim(dims);
-  input_indices.Resize(dim);
-  ctx.template Alloc<int64_t>(&input_indices);
   size_t temp_storage_bytes = -1;
 
   auto ComputeBlockSize = [](int col) {
@@ -1067,9 +1171,18 @@ bool SortTopk(const phi::GPUContext& ctx,
   unsigned int grid_size = num_rows < maxGridDimX
                                ? static_cast<unsigned int>(num_rows)
                                : maxGridDimX;
-  // Init a index array
-  InitIndex<int64_t><<<grid_size, block_size, 0, cu_stream>>>(
-      input_indices.data<int64_t>(), num_rows, num_cols);
+  Tensor input_indices;
+  const int64_t* input_indices_data = nullptr;
+  if (input_indices_tensor != nullptr) {
+    input_indices_data = input_indices_tensor->data<int64_t>();
+  } else {
+    // Init a index array
+    input_indices.Resize(dim);
+    int64_t* init_indices_data = ctx.template Alloc<int64_t>(&input_indices);
+    InitIndex<int64_t><<<grid_size, block_size, 0, cu_stream>>>(
+        init_indices_data, num_rows, num_cols);
+    input_indices_data = init_indices_data;
+  }
 
   // create iter for counting input
   cub::CountingInputIterator<int64_t> counting_iter(0);
@@ -1108,7 +1221,7 @@ bool SortTopk(const phi::GPUContext& ctx,
         temp_storage_bytes,
         input,
         sorted_values_ptr,
-        input_indices.data<int64_t>(),
+        input_indices_data,
         sorted_indices_ptr,
         num_cols * num_rows,
         num_rows,
@@ -1142,7 +1255,7 @@ bool SortTopk(const phi::GPUContext& ctx,
                                                  temp_storage_bytes,
                                                  input,
                                                  sorted_values_ptr,
-                                                 input_indices.data<int64_t>(),
+                                                 input_indices_data,
                                                  sorted_indices_ptr,
                                                  num_cols * num_rows,
                                                  num_rows,
@@ -1178,7 +1291,7 @@ bool SortTopk(const phi::GPUContext& ctx,
         temp_storage_bytes,
         input,
         sorted_values_ptr,
-        input_indices.data<int64_t>(),
+        input_indices_data,
         sorted_indices_ptr,
         num_cols * num_rows,
         num_rows,
@@ -1214,7 +1327,7 @@ bool SortTopk(const phi::GPUContext& ctx,
                                                  temp_storage_bytes,
                                                  input,
                                                  sorted_values_ptr,
-                                                 input_indices.data<int64_t>(),
+                                                 input_indices_data,
                                                  sorted_indices_ptr,
                                                  num_cols * num_rows,
                                                  num_rows,
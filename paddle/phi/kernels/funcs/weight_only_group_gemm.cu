@@ -0,0 +1,457 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/funcs/weight_only_group_gemm.h"
+
+#include <cmath>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_helper.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/phi/kernels/funcs/aligned_vector.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+
+namespace phi {
+
+namespace {
+
+constexpr int kWarpSize = 32;
+constexpr int kGemvWarpsPerBlock = 4;
+// the rows of x computed by a warp, which share the dequantized weight
+constexpr int kGemvTileM = 4;
+// the weight is dequantized to a temporary for cuBLAS beyond it, where the
+// gemm is no longer bound by the weight loading
+constexpr int kGemvMaxM = 16;
+
+template <WeightOnlyActivation kAct>
+__device__ __forceinline__ float ApplyActivation(float x) {
+  if (kAct == WeightOnlyActivation::kGelu) {
+    return 0.5f * x * (1.0f + erff(x * static_cast<float>(M_SQRT1_2)));
+  } else if (kAct == WeightOnlyActivation::kRelu) {
+    return x > 0.0f ? x : 0.0f;
+  } else if (kAct == WeightOnlyActivation::kSilu) {
+    return x / (1.0f + expf(-x));
+  }
+  return x;
+}
+
+template <int kBits>
+__device__ __forceinline__ int8_t GetQuantValue(const int8_t* row, int idx) {
+  if (kBits == 8) {
+    return row[idx];
+  }
+  int8_t packed = row[idx / 2];
+  // sign extend the nibble
+  return (idx & 1) ? static_cast<int8_t>(packed >> 4)
+                   : static_cast<int8_t>(static_cast<int8_t>(packed << 4) >> 4);
+}
+
+// A thread computes the scale of a group of a column and quantizes it.
+template <typename T, int kBits>
+__global__ void WeightOnlyGroupQuantizeKernel(const T* x,
+                                              int8_t* out,
+                                              T* scale,
+                                              const int k,
+                                              const int n,
+                                              const int group_size) {
+  const int num_groups = k / group_size;
+  const int64_t idx =
+      static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  if (idx >= static_cast<int64_t>(num_groups) * n) return;
+  const int group = idx / n;
+  const int col = idx % n;
+  const float bound = kBits == 8 ? 127.0f : 7.0f;
+  const int row_begin = group * group_size;
+
+  float abs_max = 0.0f;
+  for (int i = row_begin; i < row_begin + group_size; ++i) {
+    float value = static_cast<float>(x[static_cast<int64_t>(i) * n + col]);
+    abs_max = fmaxf(abs_max, fabsf(value));
+  }
+  const float group_scale = abs_max / bound;
+  scale[idx] = static_cast<T>(group_scale);
+  const float inv_scale = abs_max > 0.0f ? bound / abs_max : 0.0f;
+
+  int8_t* out_row = out + static_cast<int64_t>(col) * k * kBits / 8;
+  for (int i = row_begin; i < row_begin + group_size; i += 8 / kBits) {
+    float value = static_cast<float>(x[static_cast<int64_t>(i) * n + col]);
+    int quant = static_cast<int>(fminf(
+        bound, fmaxf(-bound, roundf(value * inv_scale))));
+    if (kBits == 8) {
+      out_row[i] = static_cast<int8_t>(quant);
+    } else {
+      float next = static_cast<float>(x[static_cast<int64_t>(i + 1) * n + col]);
+      int next_quant = static_cast<int>(fminf(
+          bound, fmaxf(-bound, roundf(next * inv_scale))));
+      out_row[i / 2] =
+          static_cast<int8_t>((quant & 0x0F) | ((next_quant & 0x0F) << 4));
+    }
+  }
+}
+
+template <typename T, int kBits>
+__global__ void WeightOnlyGroupDequantizeKernel(const int8_t* weight,
+                                                const T* scale,
+                                                T* out,
+                                                const int n,
+                                                const int k,
+                                                const int group_size) {
+  const int64_t idx =
+      static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  if (idx >= static_cast<int64_t>(k) * n) return;
+  const int row = idx / n;
+  const int col = idx % n;
+  const int8_t* weight_row = weight + static_cast<int64_t>(col) * k * kBits / 8;
+  float value = static_cast<float>(GetQuantValue<kBits>(weight_row, row)) *
+                static_cast<float>(scale[(row / group_size) * n + col]);
+  out[idx] = static_cast<T>(value);
+}
+
+// A warp computes a column of the out for kGemvTileM rows of x. Every lane
+// loads 16 bytes of the weight column, which are in a group since the group
+// size is a multiple of the elements of them, so that the dot of the quantized
+// values is scaled once.
+template <typename T, int kBits, int kGroupSize, WeightOnlyActivation kAct>
+__global__ void WeightOnlyGroupGemvKernel(const T* x,
+                                          const int8_t* weight,
+                                          const T* scale,
+                                          const T* bias,
+                                          T* out,
+                                          const int m,
+                                          const int n,
+                                          const int k) {
+  constexpr int kBytesPerLane = 16;
+  constexpr int kElemsPerLane = kBytesPerLane * 8 / kBits;
+  constexpr int kXVecSize = 8;
+  static_assert(kGroupSize % kElemsPerLane == 0,
+                "The group size must be a multiple of the elements of a lane.");
+
+  const int lane = threadIdx.x % kWarpSize;
+  const int col = blockIdx.x * kGemvWarpsPerBlock + threadIdx.x / kWarpSize;
+  const int row_begin = blockIdx.y * kGemvTileM;
+  if (col >= n) return;
+
+  const int8_t* weight_col = weight + static_cast<int64_t>(col) * k * kBits / 8;
+  float acc[kGemvTileM] = {0.0f};
+  for (int kk = lane * kElemsPerLane; kk < k;
+       kk += kWarpSize * kElemsPerLane) {
+    AlignedVector<int8_t, kBytesPerLane> w_vec;
+    Load<int8_t, kBytesPerLane>(weight_col + kk * kBits / 8, &w_vec);
+    float w[kElemsPerLane];
+#pragma unroll
+    for (int i = 0; i < kElemsPerLane; ++i) {
+      w[i] = static_cast<float>(GetQuantValue<kBits>(w_vec.val, i));
+    }
+    const float group_scale =
+        static_cast<float>(scale[(kk / kGroupSize) * n + col]);
+#pragma unroll
+    for (int r = 0; r < kGemvTileM; ++r) {
+      if (row_begin + r >= m) break;
+      const T* x_row = x + static_cast<int64_t>(row_begin + r) * k + kk;
+      float dot = 0.0f;
+#pragma unroll
+      for (int v = 0; v < kElemsPerLane; v += kXVecSize) {
+        AlignedVector<T, kXVecSize> x_vec;
+        Load<T, kXVecSize>(x_row + v, &x_vec);
+#pragma unroll
+        for (int i = 0; i < kXVecSize; ++i) {
+          dot += static_cast<float>(x_vec[i]) * w[v + i];
+        }
+      }
+      acc[r] += dot * group_scale;
+    }
+  }
+
+  const float bias_value = bias ? static_cast<float>(bias[col]) : 0.0f;
+#pragma unroll
+  for (int r = 0; r < kGemvTileM; ++r) {
+    float sum = funcs::WarpReduceSum<float>(acc[r], 0xffffffff);
+    if (lane == 0 && row_begin + r < m) {
+      out[static_cast<int64_t>(row_begin + r) * n + col] =
+          static_cast<T>(ApplyActivation<kAct>(sum + bias_value));
+    }
+  }
+}
+
+template <typename T, WeightOnlyActivation kAct>
+__global__ void WeightOnlyBiasActKernel(T* out,
+                                        const T* bias,
+                                        const int64_t numel,
+                                        const int n) {
+  CUDA_KERNEL_LOOP_TYPE(idx, numel, int64_t) {
+    float value = static_cast<float>(out[idx]);
+    if (bias) {
+      value += static_cast<float>(bias[idx % n]);
+    }
+    out[idx] = static_cast<T>(ApplyActivation<kAct>(value));
+  }
+}
+
+template <typename T, int kBits, int kGroupSize, WeightOnlyActivation kAct>
+void LaunchWeightOnlyGroupGemv(const phi::GPUContext& dev_ctx,
+                               const T* x,
+                               const int8_t* weight,
+                               const T* bias,
+                               const T* scale,
+                               T* out,
+                               const int m,
+                               const int n,
+                               const int k) {
+  dim3 grid((n + kGemvWarpsPerBlock - 1) / kGemvWarpsPerBlock,
+            (m + kGemvTileM - 1) / kGemvTileM);
+  dim3 block(kGemvWarpsPerBlock * kWarpSize);
+  WeightOnlyGroupGemvKernel<T, kBits, kGroupSize, kAct>
+      <<<grid, block, 0, dev_ctx.stream()>>>(
+          x, weight, scale, bias, out, m, n, k);
+}
+
+template <typename T, int kBits, int kGroupSize>
+void DispatchWeightOnlyGroupGemvAct(const phi::GPUContext& dev_ctx,
+                                    const T* x,
+                                    const int8_t* weight,
+                                    const T* bias,
+                                    const T* scale,
+                                    T* out,
+                                    const int m,
+                                    const int n,
+                                    const int k,
+                                    const WeightOnlyActivation activation) {
+  using Act = WeightOnlyActivation;
+  switch (activation) {
+    case Act::kGelu:
+      LaunchWeightOnlyGroupGemv<T, kBits, kGroupSize, Act::kGelu>(
+          dev_ctx, x, weight, bias, scale, out, m, n, k);
+      break;
+    case Act::kRelu:
+      LaunchWeightOnlyGroupGemv<T, kBits, kGroupSize, Act::kRelu>(
+          dev_ctx, x, weight, bias, scale, out, m, n, k);
+      break;
+    case Act::kSilu:
+      LaunchWeightOnlyGroupGemv<T, kBits, kGroupSize, Act::kSilu>(
+          dev_ctx, x, weight, bias, scale, out, m, n, k);
+      break;
+    default:
+      LaunchWeightOnlyGroupGemv<T, kBits, kGroupSize, Act::kNone>(
+          dev_ctx, x, weight, bias, scale, out, m, n, k);
+  }
+}
+
+template <typename T, int kBits>
+void DispatchWeightOnlyGroupGemv(const phi::GPUContext& dev_ctx,
+                                 const T* x,
+                                 const int8_t* weight,
+                                 const T* bias,
+                                 const T* scale,
+                                 T* out,
+                                 const int m,
+                                 const int n,
+                                 const int k,
+                                 const int group_size,
+                                 const WeightOnlyActivation activation) {
+  if (group_size == 64) {
+    DispatchWeightOnlyGroupGemvAct<T, kBits, 64>(
+        dev_ctx, x, weight, bias, scale, out, m, n, k, activation);
+  } else if (group_size == 128) {
+    DispatchWeightOnlyGroupGemvAct<T, kBits, 128>(
+        dev_ctx, x, weight, bias, scale, out, m, n, k, activation);
+  } else {
+    PADDLE_THROW(phi::errors::InvalidArgument(
+        "The group_size of weight_only_linear must be 64 or 128, but got "
+        "[%d].",
+        group_size));
+  }
+}
+
+}  // namespace
+
+template <typename T, typename Context>
+void WeightOnlyGroupQuantize(const Context& dev_ctx,
+                             const T* x,
+                             int8_t* out,
+                             T* scale,
+                             const int k,
+                             const int n,
+                             const int bits,
+                             const int group_size) {
+  const int64_t num_threads = static_cast<int64_t>(k / group_size) * n;
+  if (num_threads == 0) return;
+  auto config = backends::gpu::GetGpuLaunchConfig1D(dev_ctx, num_threads);
+  if (bits == 8) {
+    WeightOnlyGroupQuantizeKernel<T, 8><<<config.block_per_grid,
+                                          config.thread_per_block,
+                                          0,
+                                          dev_ctx.stream()>>>(
+        x, out, scale, k, n, group_size);
+  } else {
+    WeightOnlyGroupQuantizeKernel<T, 4><<<config.block_per_grid,
+                                          config.thread_per_block,
+                                          0,
+                                          dev_ctx.stream()>>>(
+        x, out, scale, k, n, group_size);
+  }
+}
+
+template <typename T, typename Context>
+void WeightOnlyGroupDequantize(const Context& dev_ctx,
+                               const int8_t* weight,
+                               const T* scale,
+                               T* out,
+                               const int n,
+                               const int k,
+                               const int bits,
+                               const int group_size) {
+  const int64_t numel = static_cast<int64_t>(k) * n;
+  if (numel == 0) return;
+  auto config = backends::gpu::GetGpuLaunchConfig1D(dev_ctx, numel);
+  if (bits == 8) {
+    WeightOnlyGroupDequantizeKernel<T, 8><<<config.block_per_grid,
+                                            config.thread_per_block,
+                                            0,
+                                            dev_ctx.stream()>>>(
+        weight, scale, out, n, k, group_size);
+  } else {
+    WeightOnlyGroupDequantizeKernel<T, 4><<<config.block_per_grid,
+                                            config.thread_per_block,
+                                            0,
+                                            dev_ctx.stream()>>>(
+        weight, scale, out, n, k, group_size);
+  }
+}
+
+template <typename T, typename Context>
+void WeightOnlyBiasAct(const Context& dev_ctx,
+                       T* out,
+                       const T* bias,
+                       const int m,
+                       const int n,
+                       const WeightOnlyActivation activation) {
+  const int64_t numel = static_cast<int64_t>(m) * n;
+  if (numel == 0 || (bias == nullptr &&
+                     activation == WeightOnlyActivation::kNone)) {
+    return;
+  }
+  auto config = backends::gpu::GetGpuLaunchConfig1D(dev_ctx, numel);
+  auto stream = dev_ctx.stream();
+  switch (activation) {
+    case WeightOnlyActivation::kGelu:
+      WeightOnlyBiasActKernel<T, WeightOnlyActivation::kGelu>
+          <<<config.block_per_grid, config.thread_per_block, 0, stream>>>(
+              out, bias, numel, n);
+      break;
+    case WeightOnlyActivation::kRelu:
+      WeightOnlyBiasActKernel<T, WeightOnlyActivation::kRelu>
+          <<<config.block_per_grid, config.thread_per_block, 0, stream>>>(
+              out, bias, numel, n);
+      break;
+    case WeightOnlyActivation::kSilu:
+      WeightOnlyBiasActKernel<T, WeightOnlyActivation::kSilu>
+          <<<config.block_per_grid, config.thread_per_block, 0, stream>>>(
+              out, bias, numel, n);
+      break;
+    default:
+      WeightOnlyBiasActKernel<T, WeightOnlyActivation::kNone>
+          <<<config.block_per_grid, config.thread_per_block, 0, stream>>>(
+              out, bias, numel, n);
+  }
+}
+
+template <typename T, typename Context>
+void WeightOnlyGroupGemm(const Context& dev_ctx,
+                         const T* x,
+                         const int8_t* weight,
+                         const T* bias,
+                         const T* scale,
+                         T* out,
+                         const int m,
+                         const int n,
+                         const int k,
+                         const int bits,
+                         const int group_size,
+                         const WeightOnlyActivation activation) {
+  if (m == 0 || n == 0) return;
+  if (m <= kGemvMaxM) {
+    if (bits == 8) {
+      DispatchWeightOnlyGroupGemv<T, 8>(dev_ctx,
+                                         x,
+                                         weight,
+                                         bias,
+                                         scale,
+                                         out,
+                                         m,
+                                         n,
+                                         k,
+                                         group_size,
+                                         activation);
+    } else {
+      DispatchWeightOnlyGroupGemv<T, 4>(dev_ctx,
+                                         x,
+                                         weight,
+                                         bias,
+                                         scale,
+                                         out,
+                                         m,
+                                         n,
+                                         k,
+                                         group_size,
+                                         activation);
+    }
+    return;
+  }
+
+  DenseTensor weight_dequantized;
+  weight_dequantized.Resize({k, n});
+  dev_ctx.template Alloc<T>(&weight_dequantized);
+  WeightOnlyGroupDequantize<T, Context>(dev_ctx,
+                                        weight,
+                                        scale,
+                                        weight_dequantized.data<T>(),
+                                        n,
+                                        k,
+                                        bits,
+                                        group_size);
+  auto blas = funcs::GetBlas<Context, T>(dev_ctx);
+  blas.GEMM(CblasNoTrans,
+            CblasNoTrans,
+            m,
+            n,
+            k,
+            static_cast<T>(1),
+            x,
+            weight_dequantized.data<T>(),
+            static_cast<T>(0),
+            out);
+  WeightOnlyBiasAct<T, Context>(dev_ctx, out, bias, m, n, activation);
+}
+
+#define INSTANTIATE_WEIGHT_ONLY_GROUP_FUNCTORS(T)                            \
+  template void WeightOnlyGroupQuantize<T, phi::GPUContext>(                 \
+      const phi::GPUContext&, const T*, int8_t*, T*, int, int, int, int);    \
+  template void WeightOnlyGroupDequantize<T, phi::GPUContext>(               \
+      const phi::GPUContext&, const int8_t*, const T*, T*, int, int, int,    \
+      int);                                                                  \
+  template void WeightOnlyGroupGemm<T, phi::GPUContext>(                     \
+      const phi::GPUContext&, const T*, const int8_t*, const T*, const T*,   \
+      T*, int, int, int, int, int, WeightOnlyActivation);                    \
+  template void WeightOnlyBiasAct<T, phi::GPUContext>(                       \
+      const phi::GPUContext&, T*, const T*, int, int, WeightOnlyActivation);
+
+INSTANTIATE_WEIGHT_ONLY_GROUP_FUNCTORS(phi::dtype::float16)
+INSTANTIATE_WEIGHT_ONLY_GROUP_FUNCTORS(phi::dtype::bfloat16)
+
+#undef INSTANTIATE_WEIGHT_ONLY_GROUP_FUNCTORS
+
+}  // namespace phi
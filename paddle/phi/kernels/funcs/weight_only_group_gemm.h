@@ -0,0 +1,98 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <string>
+
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+
+// The group-wise weight-only quantization of a [k, n] weight keeps a scale
+// for every group_size rows of every column, the scale is [k / group_size, n].
+// Unlike the per-channel layout, which is permuted for the CUTLASS mixed gemm,
+// the grouped weight is stored as n rows of k int8, or n rows of k / 2 bytes
+// packing two signed int4 (the even k in the low nibble), so that its shape is
+// the same as the per-channel one: [n, k] for int8 and [n / 2, k] for int4.
+
+enum class WeightOnlyActivation { kNone, kGelu, kRelu, kSilu };
+
+inline WeightOnlyActivation GetWeightOnlyActivation(
+    const std::string& activation) {
+  if (activation == "none") {
+    return WeightOnlyActivation::kNone;
+  } else if (activation == "gelu") {
+    return WeightOnlyActivation::kGelu;
+  } else if (activation == "relu") {
+    return WeightOnlyActivation::kRelu;
+  } else if (activation == "silu") {
+    return WeightOnlyActivation::kSilu;
+  }
+  PADDLE_THROW(phi::errors::InvalidArgument(
+      "The activation of weight_only_linear must be in ['none', 'gelu', "
+      "'relu', 'silu'], but got [%s].",
+      activation));
+}
+
+// x: [k, n], out: the grouped weight, scale: [k / group_size, n]
+template <typename T, typename Context>
+void WeightOnlyGroupQuantize(const Context& dev_ctx,
+                             const T* x,
+                             int8_t* out,
+                             T* scale,
+                             const int k,
+                             const int n,
+                             const int bits,
+                             const int group_size);
+
+// out: [k, n]
+template <typename T, typename Context>
+void WeightOnlyGroupDequantize(const Context& dev_ctx,
+                               const int8_t* weight,
+                               const T* scale,
+                               T* out,
+                               const int n,
+                               const int k,
+                               const int bits,
+                               const int group_size);
+
+// out = act(x * dequant(weight) + bias), x: [m, k], out: [m, n]. The weight is
+// dequantized in registers for a small m, which is bound by the weight
+// loading, and to a temporary for cuBLAS otherwise.
+template <typename T, typename Context>
+void WeightOnlyGroupGemm(const Context& dev_ctx,
+                         const T* x,
+                         const int8_t* weight,
+                         const T* bias,
+                         const T* scale,
+                         T* out,
+                         const int m,
+                         const int n,
+                         const int k,
+                         const int bits,
+                         const int group_size,
+                         const WeightOnlyActivation activation);
+
+// out = act(out + bias) in place, out: [m, n], bias may be nullptr
+template <typename T, typename Context>
+void WeightOnlyBiasAct(const Context& dev_ctx,
+                       T* out,
+                       const T* bias,
+                       const int m,
+                       const int n,
+                       const WeightOnlyActivation activation);
+
+}  // namespace phi
@@ -0,0 +1,169 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/activation_grad_kernel.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/fusion/cutlass/moe/moe_gemm_launcher.h"
+#include "paddle/phi/kernels/gelu_grad_kernel.h"
+#include "paddle/phi/kernels/transpose_kernel.h"
+
+namespace phi {
+namespace fusion {
+
+// bias_grad[e][j] = sum of the column j of the rows of expert e in dout
+template <typename T>
+__global__ void SegmentedColumnSumKernel(const T* dout,
+                                         const int64_t* expert_offsets,
+                                         int64_t n,
+                                         T* bias_grad) {
+  using MPType = typename phi::dtype::MPTypeTrait<T>::Type;
+  const int expert = blockIdx.y;
+  const int64_t col = static_cast<int64_t>(blockIdx.x) * blockDim.x +
+                      threadIdx.x;
+  if (col >= n) {
+    return;
+  }
+  const int64_t begin = expert == 0 ? 0 : expert_offsets[expert - 1];
+  const int64_t end = expert_offsets[expert];
+  MPType sum = static_cast<MPType>(0);
+  for (int64_t row = begin; row < end; ++row) {
+    sum += static_cast<MPType>(dout[row * n + col]);
+  }
+  bias_grad[expert * n + col] = static_cast<T>(sum);
+}
+
+template <typename T, typename Context>
+void FusedGroupedGemmGradKernel(const Context& dev_ctx,
+                                const DenseTensor& x,
+                                const DenseTensor& weight,
+                                const paddle::optional<DenseTensor>& bias,
+                                const DenseTensor& expert_offsets,
+                                const DenseTensor& out,
+                                const DenseTensor& out_grad,
+                                const std::string& act_type,
+                                DenseTensor* x_grad,
+                                DenseTensor* weight_grad,
+                                DenseTensor* bias_grad) {
+  using DataType = typename MoeGemmType<T>::Type;
+  const int num_experts = static_cast<int>(weight.dims()[0]);
+  const int64_t k = weight.dims()[1];
+  const int64_t n = weight.dims()[2];
+  int64_t* offsets_data = const_cast<int64_t*>(expert_offsets.data<int64_t>());
+
+  // the gradient of the gemm, before the activation
+  DenseTensor pre_grad;
+  if (act_type == "none") {
+    pre_grad = out_grad;
+  } else if (act_type == "relu") {
+    pre_grad.Resize(out_grad.dims());
+    ReluGradKernel<T, Context>(dev_ctx, out, out_grad, &pre_grad);
+  } else {
+    // gelu needs its input, which is recomputed by one more grouped gemm
+    // instead of being kept by the forward
+    DenseTensor pre;
+    pre.Resize(out.dims());
+    dev_ctx.template Alloc<T>(&pre);
+    if (x.numel() > 0) {
+      MoeGroupedGemm<DataType>(
+          reinterpret_cast<const DataType*>(x.data<T>()),
+          reinterpret_cast<const DataType*>(weight.data<T>()),
+          bias ? reinterpret_cast<const DataType*>(bias->data<T>()) : nullptr,
+          reinterpret_cast<DataType*>(pre.data<T>()),
+          offsets_data,
+          n,
+          k,
+          num_experts,
+          "none",
+          dev_ctx.stream());
+    }
+    pre_grad.Resize(out_grad.dims());
+    GeluGradKernel<T, Context>(
+        dev_ctx, pre, out_grad, /*approximate=*/true, &pre_grad);
+  }
+
+  if (x_grad) {
+    dev_ctx.template Alloc<T>(x_grad);
+    if (x.numel() > 0) {
+      // dgrad is the grouped gemm of the transposed weights
+      DenseTensor weight_t =
+          phi::Transpose<T, Context>(dev_ctx, weight, {0, 2, 1});
+      MoeGroupedGemm<DataType>(
+          reinterpret_cast<const DataType*>(pre_grad.data<T>()),
+          reinterpret_cast<const DataType*>(weight_t.data<T>()),
+          nullptr,
+          reinterpret_cast<DataType*>(x_grad->data<T>()),
+          offsets_data,
+          k,
+          n,
+          num_experts,
+          "none",
+          dev_ctx.stream());
+    }
+  }
+
+  if (bias_grad && n > 0) {
+    dev_ctx.template Alloc<T>(bias_grad);
+    const int threads = static_cast<int>(std::min<int64_t>(n, 256));
+    dim3 grid((n + threads - 1) / threads, num_experts);
+    SegmentedColumnSumKernel<T><<<grid, threads, 0, dev_ctx.stream()>>>(
+        pre_grad.data<T>(), offsets_data, n, bias_grad->data<T>());
+  }
+
+  if (weight_grad) {
+    dev_ctx.template Alloc<T>(weight_grad);
+    phi::funcs::SetConstant<Context, T> set_zero;
+    set_zero(dev_ctx, weight_grad, static_cast<T>(0));
+    // The reduction dim of wgrad is the rows of the experts, which the grouped
+    // gemm can not vary, so wgrad runs a gemm per non-empty expert.
+    DenseTensor cpu_offsets;
+    phi::Copy(dev_ctx, expert_offsets, phi::CPUPlace(), true, &cpu_offsets);
+    const int64_t* cpu_offsets_data = cpu_offsets.data<int64_t>();
+    auto blas = phi::funcs::GetBlas<Context, T>(dev_ctx);
+    int64_t begin = 0;
+    for (int e = 0; e < num_experts; ++e) {
+      const int64_t rows = cpu_offsets_data[e] - begin;
+      if (rows > 0) {
+        blas.GEMM(CblasTrans,
+                  CblasNoTrans,
+                  static_cast<int>(k),
+                  static_cast<int>(n),
+                  static_cast<int>(rows),
+                  static_cast<T>(1),
+                  x.data<T>() + begin * k,
+                  pre_grad.data<T>() + begin * n,
+                  static_cast<T>(0),
+                  weight_grad->data<T>() + e * k * n);
+      }
+      begin = cpu_offsets_data[e];
+    }
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_grouped_gemm_grad,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedGroupedGemmGradKernel,
+                   float,
+                   phi::dtype::float16) {
+  kernel->InputAt(3).SetDataType(phi::DataType::INT64);
+}
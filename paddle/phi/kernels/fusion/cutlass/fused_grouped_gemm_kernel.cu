@@ -0,0 +1,71 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/full_kernel.h"
+#include "paddle/phi/kernels/fusion/cutlass/moe/moe_gemm_launcher.h"
+
+namespace phi {
+namespace fusion {
+
+template <typename T, typename Context>
+void FusedGroupedGemmKernel(const Context& dev_ctx,
+                            const DenseTensor& x,
+                            const DenseTensor& weight,
+                            const paddle::optional<DenseTensor>& bias,
+                            const DenseTensor& expert_offsets,
+                            const std::string& act_type,
+                            DenseTensor* out) {
+  using DataType = typename MoeGemmType<T>::Type;
+  const int num_experts = static_cast<int>(weight.dims()[0]);
+  const int64_t k = weight.dims()[1];
+  const int64_t n = weight.dims()[2];
+  dev_ctx.template Alloc<T>(out);
+  if (x.numel() == 0) {
+    return;
+  }
+
+  // the epilogues of the activations add the biases
+  DenseTensor zero_bias;
+  const T* bias_data = bias ? bias->data<T>() : nullptr;
+  if (bias_data == nullptr && act_type != "none") {
+    zero_bias = phi::Full<T, Context>(dev_ctx, {num_experts, n}, 0);
+    bias_data = zero_bias.data<T>();
+  }
+  MoeGroupedGemm<DataType>(
+      reinterpret_cast<const DataType*>(x.data<T>()),
+      reinterpret_cast<const DataType*>(weight.data<T>()),
+      reinterpret_cast<const DataType*>(bias_data),
+      reinterpret_cast<DataType*>(out->data<T>()),
+      const_cast<int64_t*>(expert_offsets.data<int64_t>()),
+      n,
+      k,
+      num_experts,
+      act_type,
+      dev_ctx.stream());
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_grouped_gemm,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedGroupedGemmKernel,
+                   float,
+                   phi::dtype::float16) {
+  kernel->InputAt(3).SetDataType(phi::DataType::INT64);
+}
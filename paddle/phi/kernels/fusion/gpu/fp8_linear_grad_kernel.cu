@@ -0,0 +1,82 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/reduce_sum_kernel.h"
+
+namespace phi {
+namespace fusion {
+
+// The gradients of fp8_linear are computed in the precision of the inputs,
+// by the same gemms as the ones of matmul, so that the fp8 casts of the
+// forward do not bring their errors into the updates.
+template <typename T, typename Context>
+void Fp8LinearGradKernel(const Context& dev_ctx,
+                         const DenseTensor& x,
+                         const DenseTensor& weight,
+                         const paddle::optional<DenseTensor>& bias,
+                         const DenseTensor& out_grad,
+                         DenseTensor* x_grad,
+                         DenseTensor* weight_grad,
+                         DenseTensor* bias_grad) {
+  const int k = static_cast<int>(weight.dims()[0]);
+  const int n = static_cast<int>(weight.dims()[1]);
+  const int m = static_cast<int>(x.numel() / k);
+  auto blas = phi::funcs::GetBlas<Context, T>(dev_ctx);
+  if (x_grad) {
+    // x_grad [m, k] = out_grad [m, n] * weight^T
+    blas.GEMM(CblasNoTrans,
+              CblasTrans,
+              m,
+              k,
+              n,
+              static_cast<T>(1),
+              out_grad.data<T>(),
+              weight.data<T>(),
+              static_cast<T>(0),
+              dev_ctx.template Alloc<T>(x_grad));
+  }
+  if (weight_grad) {
+    // weight_grad [k, n] = x^T * out_grad
+    blas.GEMM(CblasTrans,
+              CblasNoTrans,
+              k,
+              n,
+              m,
+              static_cast<T>(1),
+              x.data<T>(),
+              out_grad.data<T>(),
+              static_cast<T>(0),
+              dev_ctx.template Alloc<T>(weight_grad));
+  }
+  if (bias_grad) {
+    DenseTensor out_grad_2d(out_grad);
+    out_grad_2d.Resize({m, n});
+    phi::SumKernel<T, Context>(
+        dev_ctx, out_grad_2d, {0}, out_grad.dtype(), false, bias_grad);
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fp8_linear_grad,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::Fp8LinearGradKernel,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
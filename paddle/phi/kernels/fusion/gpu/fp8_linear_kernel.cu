@@ -0,0 +1,199 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/tensor_utils.h"
+
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11080
+#include "paddle/phi/kernels/funcs/cublaslt.h"
+#include "paddle/phi/kernels/funcs/fp8_utils.cu.h"
+#endif
+
+namespace phi {
+namespace fusion {
+
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11080
+
+// Sets the scale of x or weight by their amax history for the delayed
+// scaling, or by the amax of themselves for the current scaling if there is
+// no history. The amax of this step is left in amax for the history.
+template <typename T>
+static void Fp8ComputeScaleOf(const GPUContext& dev_ctx,
+                              const T* x,
+                              const int64_t numel,
+                              const paddle::optional<DenseTensor>& history,
+                              const float margin,
+                              float* amax,
+                              float* scale,
+                              float* scale_inv) {
+  constexpr float kFp8Max = funcs::Fp8Max<phi::dtype::float8_e4m3fn>::value;
+  if (history) {
+    funcs::Fp8ComputeScale(dev_ctx,
+                           history->data<float>(),
+                           history->numel(),
+                           kFp8Max,
+                           margin,
+                           scale,
+                           scale_inv);
+  } else {
+    funcs::Fp8Amax<T>(dev_ctx, x, numel, amax);
+    funcs::Fp8ComputeScale(dev_ctx, amax, 1, kFp8Max, margin, scale, scale_inv);
+  }
+}
+
+// history_out = [amax, history[0], ..., history[len - 2]], which is in place
+// unless history_out is not history
+static void Fp8UpdateAmaxHistoryOf(const GPUContext& dev_ctx,
+                                   const DenseTensor& history,
+                                   const float* amax,
+                                   DenseTensor* history_out) {
+  float* history_out_data = dev_ctx.Alloc<float>(history_out);
+  if (history_out_data != history.data<float>()) {
+    phi::Copy(dev_ctx, history, dev_ctx.GetPlace(), false, history_out);
+    history_out_data = history_out->data<float>();
+  }
+  funcs::Fp8UpdateAmaxHistory(
+      dev_ctx, history_out_data, history_out->numel(), amax);
+}
+
+template <typename T, typename Context>
+void Fp8LinearKernel(const Context& dev_ctx,
+                     const DenseTensor& x,
+                     const DenseTensor& weight,
+                     const paddle::optional<DenseTensor>& bias,
+                     const paddle::optional<DenseTensor>& x_amax_history,
+                     const paddle::optional<DenseTensor>& weight_amax_history,
+                     float margin,
+                     DenseTensor* out,
+                     DenseTensor* x_amax_history_out,
+                     DenseTensor* weight_amax_history_out) {
+  PADDLE_ENFORCE_GE(
+      dev_ctx.GetComputeCapability(),
+      89,
+      phi::errors::Unimplemented(
+          "fp8_linear requires the fp8 tensor cores of sm89 and later, but "
+          "the compute capability is %d.",
+          dev_ctx.GetComputeCapability()));
+  using FP8 = phi::dtype::float8_e4m3fn;
+  const int k = static_cast<int>(weight.dims()[0]);
+  const int n = static_cast<int>(weight.dims()[1]);
+  const int m = static_cast<int>(x.numel() / k);
+  T* out_data = dev_ctx.template Alloc<T>(out);
+  if (m == 0) return;
+
+  // [x_amax, w_amax, x_scale, x_scale_inv, w_scale, w_scale_inv]
+  DenseTensor scales;
+  scales.Resize({6});
+  float* scales_data = dev_ctx.template Alloc<float>(&scales);
+  float* x_amax = scales_data;
+  float* w_amax = scales_data + 1;
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemsetAsync(scales_data, 0, 2 * sizeof(float), dev_ctx.stream()));
+
+  const bool delayed = static_cast<bool>(x_amax_history);
+  Fp8ComputeScaleOf<T>(dev_ctx,
+                       x.data<T>(),
+                       x.numel(),
+                       x_amax_history,
+                       margin,
+                       x_amax,
+                       scales_data + 2,
+                       scales_data + 3);
+  Fp8ComputeScaleOf<T>(dev_ctx,
+                       weight.data<T>(),
+                       weight.numel(),
+                       weight_amax_history,
+                       margin,
+                       w_amax,
+                       scales_data + 4,
+                       scales_data + 5);
+
+  // the amax is recorded by the casts for the delayed scaling
+  DenseTensor x_fp8, w_fp8;
+  x_fp8.Resize({m, k});
+  w_fp8.Resize({n, k});
+  funcs::Fp8Quantize<T, FP8>(dev_ctx,
+                             x.data<T>(),
+                             scales_data + 2,
+                             x.numel(),
+                             dev_ctx.template Alloc<FP8>(&x_fp8),
+                             delayed ? x_amax : nullptr);
+  funcs::Fp8QuantizeTranspose<T, FP8>(dev_ctx,
+                                      weight.data<T>(),
+                                      scales_data + 4,
+                                      k,
+                                      n,
+                                      dev_ctx.template Alloc<FP8>(&w_fp8),
+                                      delayed ? w_amax : nullptr);
+
+  constexpr size_t kWorkspaceSize = 4 * 1024 * 1024;
+  auto workspace = phi::memory_utils::Alloc(
+      dev_ctx.GetPlace(),
+      kWorkspaceSize,
+      phi::Stream(reinterpret_cast<phi::StreamId>(dev_ctx.stream())));
+  CublasLtFp8Helper<T> helper(m,
+                              k,
+                              n,
+                              CUDA_R_8F_E4M3,
+                              CUDA_R_8F_E4M3,
+                              static_cast<bool>(bias),
+                              kWorkspaceSize,
+                              dev_ctx.cublaslt_handle());
+  helper.GEMM(x_fp8.data<FP8>(),
+              w_fp8.data<FP8>(),
+              scales_data + 3,
+              scales_data + 5,
+              bias ? bias->data<T>() : nullptr,
+              out_data,
+              workspace->ptr(),
+              dev_ctx.stream());
+
+  if (delayed) {
+    // the histories are updated in place after their scales are taken
+    Fp8UpdateAmaxHistoryOf(
+        dev_ctx, *x_amax_history, x_amax, x_amax_history_out);
+    Fp8UpdateAmaxHistoryOf(
+        dev_ctx, *weight_amax_history, w_amax, weight_amax_history_out);
+  }
+}
+
+#else
+template <typename T, typename Context>
+void Fp8LinearKernel(const Context& dev_ctx,
+                     const DenseTensor& x,
+                     const DenseTensor& weight,
+                     const paddle::optional<DenseTensor>& bias,
+                     const paddle::optional<DenseTensor>& x_amax_history,
+                     const paddle::optional<DenseTensor>& weight_amax_history,
+                     float margin,
+                     DenseTensor* out,
+                     DenseTensor* x_amax_history_out,
+                     DenseTensor* weight_amax_history_out) {
+  PADDLE_THROW(phi::errors::Unimplemented(
+      "fp8_linear is only supported when CUDA_VERSION >= 11.8."));
+}
+#endif
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fp8_linear,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::Fp8LinearKernel,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
@@ -0,0 +1,235 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cfloat>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/top_k_function_cuda.h"
+
+namespace phi {
+namespace fusion {
+
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 9000
+
+// the length penalty of GNMT, ((5 + len) / 6) ^ alpha
+__device__ __forceinline__ float LengthPenalty(int len, float alpha) {
+  return alpha == 0.f ? 1.f : powf((5.f + len) / 6.f, alpha);
+}
+
+// log(sum(exp(logits))) of every row of a live beam
+template <typename T, int BlockSize>
+__global__ void BeamLogSumExpKernel(const T* logits,
+                                    const bool* finished,
+                                    int64_t vocab_size,
+                                    float* lse) {
+  typedef cub::BlockReduce<float, BlockSize> BlockReduce;
+  __shared__ typename BlockReduce::TempStorage temp_storage;
+  __shared__ float row_max;
+
+  const int64_t row = blockIdx.x;
+  if (finished[row]) {
+    return;
+  }
+  const T* row_logits = logits + row * vocab_size;
+  float thread_max = -FLT_MAX;
+  for (int64_t i = threadIdx.x; i < vocab_size; i += BlockSize) {
+    thread_max = max(thread_max, static_cast<float>(row_logits[i]));
+  }
+  float block_max = BlockReduce(temp_storage).Reduce(thread_max, cub::Max());
+  if (threadIdx.x == 0) {
+    row_max = block_max;
+  }
+  __syncthreads();
+
+  float thread_sum = 0.f;
+  for (int64_t i = threadIdx.x; i < vocab_size; i += BlockSize) {
+    thread_sum += __expf(static_cast<float>(row_logits[i]) - row_max);
+  }
+  float block_sum = BlockReduce(temp_storage).Sum(thread_sum);
+  if (threadIdx.x == 0) {
+    lse[row] = row_max + __logf(block_sum);
+  }
+}
+
+// Selects the next beams of a batch, one block per batch, from the top
+// beam_size tokens of each of its beams, which are the top beam_size
+// candidates of the beam since the length penalized score of a live beam
+// increases with the logit. A finished beam has the only candidate end_id
+// keeping its score.
+template <typename T>
+__global__ void BeamSelectKernel(const T* topk_logits,
+                                 const int64_t* topk_tokens,
+                                 const float* lse,
+                                 const float* cum_scores,
+                                 const int* seq_lens,
+                                 const bool* finished,
+                                 int beam_size,
+                                 int end_id,
+                                 float length_penalty,
+                                 int64_t* next_tokens,
+                                 int* parent_idx,
+                                 float* next_cum_scores,
+                                 int* next_seq_lens,
+                                 bool* next_finished) {
+  extern __shared__ float shared_scores[];
+
+  const int batch = blockIdx.x;
+  const int num_candidates = beam_size * beam_size;
+  const int i = threadIdx.x;
+  const int row = batch * beam_size + i / beam_size;
+  const bool valid = i < num_candidates;
+
+  float score = -FLT_MAX;
+  float cum_score = 0.f;
+  int64_t token = end_id;
+  if (valid) {
+    if (finished[row]) {
+      cum_score = cum_scores[row];
+      score = i % beam_size == 0
+                  ? cum_score / LengthPenalty(seq_lens[row], length_penalty)
+                  : -FLT_MAX;
+    } else {
+      token = topk_tokens[i + batch * num_candidates];
+      cum_score = cum_scores[row] +
+                  static_cast<float>(topk_logits[i + batch * num_candidates]) -
+                  lse[row];
+      score = cum_score / LengthPenalty(seq_lens[row] + 1, length_penalty);
+    }
+    shared_scores[i] = score;
+  }
+  __syncthreads();
+  if (!valid) {
+    return;
+  }
+
+  // the rank of the candidate, the earlier one first in a tie
+  int rank = 0;
+  for (int j = 0; j < num_candidates; ++j) {
+    float other = shared_scores[j];
+    rank += (other > score || (other == score && j < i)) ? 1 : 0;
+  }
+  if (rank < beam_size) {
+    const int out = batch * beam_size + rank;
+    const bool parent_finished = finished[row];
+    next_tokens[out] = token;
+    parent_idx[out] = row;
+    next_cum_scores[out] = cum_score;
+    next_seq_lens[out] = seq_lens[row] + (parent_finished ? 0 : 1);
+    next_finished[out] = parent_finished || token == end_id;
+  }
+}
+
+#endif
+
+template <typename T, typename Context>
+void FusedBeamSearchStepKernel(const Context& dev_ctx,
+                               const DenseTensor& logits,
+                               const DenseTensor& cum_scores,
+                               const DenseTensor& seq_lens,
+                               const DenseTensor& finished,
+                               int end_id,
+                               float length_penalty,
+                               DenseTensor* next_tokens,
+                               DenseTensor* parent_idx,
+                               DenseTensor* next_cum_scores,
+                               DenseTensor* next_seq_lens,
+                               DenseTensor* next_finished) {
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 9000
+  const int batch_size = static_cast<int>(cum_scores.dims()[0]);
+  const int beam_size = static_cast<int>(cum_scores.dims()[1]);
+  const int64_t vocab_size = logits.dims()[1];
+  const int64_t num_rows = logits.dims()[0];
+  dev_ctx.template Alloc<int64_t>(next_tokens);
+  dev_ctx.template Alloc<int>(parent_idx);
+  dev_ctx.template Alloc<float>(next_cum_scores);
+  dev_ctx.template Alloc<int>(next_seq_lens);
+  dev_ctx.template Alloc<bool>(next_finished);
+  if (num_rows == 0) {
+    return;
+  }
+
+  // 1. the top beam_size tokens of every beam by the radix select, unsorted
+  DenseTensor topk_logits;
+  DenseTensor topk_tokens;
+  topk_logits.Resize({num_rows, beam_size});
+  topk_tokens.Resize({num_rows, beam_size});
+  dev_ctx.template Alloc<T>(&topk_logits);
+  dev_ctx.template Alloc<int64_t>(&topk_tokens);
+  phi::funcs::LaunchRadixTopK<T>(dev_ctx,
+                                 logits.data<T>(),
+                                 num_rows,
+                                 vocab_size,
+                                 beam_size,
+                                 /*largest=*/true,
+                                 topk_logits.data<T>(),
+                                 topk_tokens.data<int64_t>());
+
+  // 2. the log softmax normalizers of the live beams
+  DenseTensor lse;
+  lse.Resize({num_rows});
+  dev_ctx.template Alloc<float>(&lse);
+  constexpr int kBlockSize = 512;
+  BeamLogSumExpKernel<T, kBlockSize>
+      <<<num_rows, kBlockSize, 0, dev_ctx.stream()>>>(
+          logits.data<T>(),
+          finished.data<bool>(),
+          vocab_size,
+          lse.data<float>());
+
+  // 3. the next beams among the beam_size * beam_size candidates of a batch
+  const int num_candidates = beam_size * beam_size;
+  const int threads = (num_candidates + WARP_SIZE - 1) / WARP_SIZE * WARP_SIZE;
+  const size_t shared_bytes = num_candidates * sizeof(float);
+  BeamSelectKernel<T><<<batch_size, threads, shared_bytes, dev_ctx.stream()>>>(
+          topk_logits.data<T>(),
+          topk_tokens.data<int64_t>(),
+          lse.data<float>(),
+          cum_scores.data<float>(),
+          seq_lens.data<int>(),
+          finished.data<bool>(),
+          beam_size,
+          end_id,
+          length_penalty,
+          next_tokens->data<int64_t>(),
+          parent_idx->data<int>(),
+          next_cum_scores->data<float>(),
+          next_seq_lens->data<int>(),
+          next_finished->data<bool>());
+#else
+  PADDLE_THROW(phi::errors::Unimplemented(
+      "fused_beam_search_step needs the radix select of CUDA 9.0 or later."));
+#endif
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_beam_search_step,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedBeamSearchStepKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->InputAt(1).SetDataType(phi::DataType::FLOAT32);
+  kernel->InputAt(2).SetDataType(phi::DataType::INT32);
+  kernel->InputAt(3).SetDataType(phi::DataType::BOOL);
+  kernel->OutputAt(0).SetDataType(phi::DataType::INT64);
+  kernel->OutputAt(1).SetDataType(phi::DataType::INT32);
+  kernel->OutputAt(2).SetDataType(phi::DataType::FLOAT32);
+  kernel->OutputAt(3).SetDataType(phi::DataType::INT32);
+  kernel->OutputAt(4).SetDataType(phi::DataType::BOOL);
+}
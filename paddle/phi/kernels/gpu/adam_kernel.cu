@@ -20,6 +20,7 @@
 
 #include "glog/logging.h"
 
+#include "paddle/phi/backends/gpu/cuda/cuda_graph_with_memory_pool.h"
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/common/amp_type_traits.h"
 #include "paddle/phi/common/float16.h"
@@ -46,13 +47,27 @@ __global__ void AdamKernelREG(MT beta1,
                               T* param_out,
                               const MT* master_param,
                               MT* master_param_out,
-                              int ndim) {
+                              int ndim,
+                              const bool* skip_update) {
   MT lr = *lr_;
   MT beta1_pow = beta1_pow_;
   MT beta2_pow = beta2_pow_;
 
   int id = blockIdx.x * blockDim.x + threadIdx.x;
 
+  // Keep the inputs if skip_update on the device, which needs no host sync.
+  if (skip_update && *skip_update) {
+    for (; id < ndim; id += gridDim.x * blockDim.x) {
+      moment1_out[id] = moment1[id];
+      moment2_out[id] = moment2[id];
+      param_out[id] = param[id];
+      if (master_param_out) {
+        master_param_out[id] = master_param[id];
+      }
+    }
+    return;
+  }
+
   for (; id < ndim; id += gridDim.x * blockDim.x) {
     MT p = master_param ? master_param[id] : static_cast<MT>(param[id]);
     MT g = static_cast<MT>(grad[id]);
@@ -89,13 +104,27 @@ __global__ void AdamKernelMEM(MT beta1,
                               T* param_out,
                               const MT* master_param,
                               MT* master_param_out,
-                              int ndim) {
+                              int ndim,
+                              const bool* skip_update) {
   MT lr = *lr_;
   MT beta1_pow = *beta1_pow_;
   MT beta2_pow = *beta2_pow_;
 
   int id = blockIdx.x * blockDim.x + threadIdx.x;
 
+  // Keep the inputs if skip_update on the device, which needs no host sync.
+  if (skip_update && *skip_update) {
+    for (; id < ndim; id += gridDim.x * blockDim.x) {
+      moment1_out[id] = moment1[id];
+      moment2_out[id] = moment2[id];
+      param_out[id] = param[id];
+      if (master_param_out) {
+        master_param_out[id] = master_param[id];
+      }
+    }
+    return;
+  }
+
   for (; id < ndim; id += gridDim.x * blockDim.x) {
     MT p = master_param ? master_param[id] : static_cast<MT>(param[id]);
     MT g = static_cast<MT>(grad[id]);
@@ -122,7 +151,13 @@ __global__ void UpdateBetaPow(T beta1,
                               const T* beta1_pow_,
                               const T* beta2_pow_,
                               T* beta1_pow_out,
-                              T* beta2_pow_out) {
+                              T* beta2_pow_out,
+                              const bool* skip_update) {
+  if (skip_update && *skip_update) {
+    *beta1_pow_out = beta1_pow_[0];
+    *beta2_pow_out = beta2_pow_[0];
+    return;
+  }
   *beta1_pow_out = beta1 * beta1_pow_[0];
   *beta2_pow_out = beta2 * beta2_pow_[0];
 }
@@ -157,15 +192,25 @@ void AdamDenseKernel(const Context& dev_ctx,
   VLOG(4) << "use_global_beta_pow:" << use_global_beta_pow;
 
   bool skip_update_ = false;
+  const bool* skip_update_data = nullptr;
   if (skip_update.is_initialized()) {
     PADDLE_ENFORCE_EQ(
         skip_update->numel(),
         1,
         errors::InvalidArgument("Input(SkipUpdate) size must be 1, but get %d",
                                 skip_update->numel()));
-    std::vector<bool> skip_update_vec;
-    phi::TensorToVector(*skip_update, dev_ctx, &skip_update_vec);
-    skip_update_ = skip_update_vec[0];
+    // The kernels read a gpu skip_update, so that the step can be captured
+    // by CUDA Graph, unless the beta pows are updated on the cpu.
+    bool is_beta_pow_on_cpu =
+        beta1_pow.place() == CPUPlace() && beta2_pow.place() == CPUPlace();
+    if (skip_update->place().GetType() == AllocationType::GPU &&
+        (use_global_beta_pow || !is_beta_pow_on_cpu)) {
+      skip_update_data = skip_update->data<bool>();
+    } else {
+      std::vector<bool> skip_update_vec;
+      phi::TensorToVector(*skip_update, dev_ctx, &skip_update_vec);
+      skip_update_ = skip_update_vec[0];
+    }
   }
   // skip_update=true, just copy input to output, and TensorCopy will call
   // mutable_data
@@ -212,6 +257,13 @@ void AdamDenseKernel(const Context& dev_ctx,
   int blocks = (param.numel() + threads - 1) / threads;
 
   if (beta1_pow.place() == CPUPlace() && beta2_pow.place() == CPUPlace()) {
+    PADDLE_ENFORCE_EQ(
+        backends::gpu::IsCUDAGraphCapturing(),
+        false,
+        errors::PreconditionNotMet(
+            "Adam can not be captured by CUDA Graph with the beta pows on the "
+            "cpu, turn on FLAGS_new_executor_use_cuda_graph before building "
+            "the program to put them on the gpu."));
     // Compute with betapow in REG
     if (grad_type == phi::DataType::FLOAT32) {
       AdamKernelREG<T, float, MPDType>
@@ -231,7 +283,8 @@ void AdamDenseKernel(const Context& dev_ctx,
               dev_ctx.template Alloc<T>(param_out),
               master_in_data,
               master_out_data,
-              param.numel());
+              param.numel(),
+              skip_update_data);
     } else {
       AdamKernelREG<T, T, MPDType><<<blocks, threads, 0, dev_ctx.stream()>>>(
           beta1_,
@@ -249,7 +302,8 @@ void AdamDenseKernel(const Context& dev_ctx,
           dev_ctx.template Alloc<T>(param_out),
           master_in_data,
           master_out_data,
-          param.numel());
+          param.numel(),
+          skip_update_data);
     }
     if (!use_global_beta_pow) {
       // Cpu update
@@ -277,7 +331,8 @@ void AdamDenseKernel(const Context& dev_ctx,
               dev_ctx.template Alloc<T>(param_out),
               master_in_data,
               master_out_data,
-              param.numel());
+              param.numel(),
+              skip_update_data);
     } else {
       AdamKernelMEM<T, T, MPDType><<<blocks, threads, 0, dev_ctx.stream()>>>(
           beta1_,
@@ -295,7 +350,8 @@ void AdamDenseKernel(const Context& dev_ctx,
           dev_ctx.template Alloc<T>(param_out),
           master_in_data,
           master_out_data,
-          param.numel());
+          param.numel(),
+          skip_update_data);
     }
     if (!use_global_beta_pow) {
       // Update with gpu
@@ -305,7 +361,8 @@ void AdamDenseKernel(const Context& dev_ctx,
           beta1_pow.data<MPDType>(),
           beta2_pow.data<MPDType>(),
           dev_ctx.template Alloc<MPDType>(beta1_pow_out),
-          dev_ctx.template Alloc<MPDType>(beta2_pow_out));
+          dev_ctx.template Alloc<MPDType>(beta2_pow_out),
+          skip_update_data);
     }
   }
 }
@@ -373,7 +430,8 @@ void MergedAdamKernel(
                 dev_ctx.template Alloc<T>(param_out[idx]),
                 master_in_data,
                 master_out_data,
-                param[idx]->numel());
+                param[idx]->numel(),
+                nullptr);
       } else {
         AdamKernelREG<T, T, MPDType><<<blocks, threads, 0, dev_ctx.stream()>>>(
             beta1_,
@@ -391,7 +449,8 @@ void MergedAdamKernel(
             dev_ctx.template Alloc<T>(param_out[idx]),
             master_in_data,
             master_out_data,
-            param[idx]->numel());
+            param[idx]->numel(),
+            nullptr);
       }
       if (!use_global_beta_pow) {
         // Cpu update
@@ -419,7 +478,8 @@ void MergedAdamKernel(
                 dev_ctx.template Alloc<T>(param_out[idx]),
                 master_in_data,
                 master_out_data,
-                param[idx]->numel());
+                param[idx]->numel(),
+                nullptr);
       } else {
         AdamKernelMEM<T, T, MPDType><<<blocks, threads, 0, dev_ctx.stream()>>>(
             beta1_,
@@ -437,7 +497,8 @@ void MergedAdamKernel(
             dev_ctx.template Alloc<T>(param_out[idx]),
             master_in_data,
             master_out_data,
-            param[idx]->numel());
+            param[idx]->numel(),
+            nullptr);
       }
       if (!use_global_beta_pow) {
         // Update with gpu
@@ -447,7 +508,8 @@ void MergedAdamKernel(
             beta1_pow[idx]->data<MPDType>(),
             beta2_pow[idx]->data<MPDType>(),
             dev_ctx.template Alloc<MPDType>(beta1_pow_out[idx]),
-            dev_ctx.template Alloc<MPDType>(beta2_pow_out[idx]));
+            dev_ctx.template Alloc<MPDType>(beta2_pow_out[idx]),
+            nullptr);
       }
     }
   }
@@ -20,6 +20,7 @@
 
 #include "glog/logging.h"
 
+#include "paddle/phi/backends/gpu/cuda/cuda_graph_with_memory_pool.h"
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/common/amp_type_traits.h"
 #include "paddle/phi/common/bfloat16.h"
@@ -49,13 +50,27 @@ __global__ void AdamWKernelREG(MT beta1,
                                T* param_out,
                                const MT* master_param,
                                MT* master_param_out,
-                               int ndim) {
+                               int ndim,
+                               const bool* skip_update) {
   MT lr = *lr_ * lr_ratio;
   MT beta1_pow = beta1_pow_;
   MT beta2_pow = beta2_pow_;
 
   int id = blockIdx.x * blockDim.x + threadIdx.x;
 
+  // Keep the inputs if skip_update on the device, which needs no host sync.
+  if (skip_update && *skip_update) {
+    for (; id < ndim; id += gridDim.x * blockDim.x) {
+      moment1_out[id] = moment1[id];
+      moment2_out[id] = moment2[id];
+      param_out[id] = param[id];
+      if (master_param_out) {
+        master_param_out[id] = master_param[id];
+      }
+    }
+    return;
+  }
+
   for (; id < ndim; id += gridDim.x * blockDim.x) {
     MT p = master_param ? master_param[id] : static_cast<MT>(param[id]);
     MT g = static_cast<MT>(grad[id]);
@@ -98,13 +113,27 @@ __global__ void AdamWKernelMEM(MT beta1,
                                T* param_out,
                                const MT* master_param,
                                MT* master_param_out,
-                               int ndim) {
+                               int ndim,
+                               const bool* skip_update) {
   MT lr = *lr_ * lr_ratio;
   MT beta1_pow = *beta1_pow_;
   MT beta2_pow = *beta2_pow_;
 
   int id = blockIdx.x * blockDim.x + threadIdx.x;
 
+  // Keep the inputs if skip_update on the device, which needs no host sync.
+  if (skip_update && *skip_update) {
+    for (; id < ndim; id += gridDim.x * blockDim.x) {
+      moment1_out[id] = moment1[id];
+      moment2_out[id] = moment2[id];
+      param_out[id] = param[id];
+      if (master_param_out) {
+        master_param_out[id] = master_param[id];
+      }
+    }
+    return;
+  }
+
   for (; id < ndim; id += gridDim.x * blockDim.x) {
     MT p = master_param ? master_param[id] : static_cast<MT>(param[id]);
     MT g = static_cast<MT>(grad[id]);
@@ -135,7 +164,13 @@ __global__ void UpdateAdamWBetaPow(T beta1,
                                    const T* beta1_pow_,
                                    const T* beta2_pow_,
                                    T* beta1_pow_out,
-                                   T* beta2_pow_out) {
+                                   T* beta2_pow_out,
+                                   const bool* skip_update) {
+  if (skip_update && *skip_update) {
+    *beta1_pow_out = beta1_pow_[0];
+    *beta2_pow_out = beta2_pow_[0];
+    return;
+  }
   *beta1_pow_out = beta1 * beta1_pow_[0];
   *beta2_pow_out = beta2 * beta2_pow_[0];
 }
@@ -177,15 +212,25 @@ void AdamwDenseKernel(const Context& dev_ctx,
   MPDType lr_ratio_ = static_cast<MPDType>(lr_ratio);
 
   bool skip_update_ = false;
+  const bool* skip_update_data = nullptr;
   if (skip_update.is_initialized()) {
     PADDLE_ENFORCE_EQ(
         skip_update->numel(),
         1,
         errors::InvalidArgument("Input(SkipUpdate) size must be 1, but get %d",
                                 skip_update->numel()));
-    std::vector<bool> skip_update_vec;
-    phi::TensorToVector(*skip_update, dev_ctx, &skip_update_vec);
-    skip_update_ = skip_update_vec[0];
+    // The kernels read a gpu skip_update, so that the step can be captured
+    // by CUDA Graph, unless the beta pows are updated on the cpu.
+    bool is_beta_pow_on_cpu =
+        beta1_pow.place() == CPUPlace() && beta2_pow.place() == CPUPlace();
+    if (skip_update->place().GetType() == AllocationType::GPU &&
+        (use_global_beta_pow || !is_beta_pow_on_cpu)) {
+      skip_update_data = skip_update->data<bool>();
+    } else {
+      std::vector<bool> skip_update_vec;
+      phi::TensorToVector(*skip_update, dev_ctx, &skip_update_vec);
+      skip_update_ = skip_update_vec[0];
+    }
   }
 
   // skip_update=true, just copy input to output, and TensorCopy will call
@@ -238,6 +283,13 @@ void AdamwDenseKernel(const Context& dev_ctx,
   int blocks = (param.numel() + threads - 1) / threads;
 
   if (beta1_pow.place() == CPUPlace() && beta2_pow.place() == CPUPlace()) {
+    PADDLE_ENFORCE_EQ(
+        backends::gpu::IsCUDAGraphCapturing(),
+        false,
+        errors::PreconditionNotMet(
+            "AdamW can not be captured by CUDA Graph with the beta pows on the "
+            "cpu, turn on FLAGS_new_executor_use_cuda_graph before building "
+            "the program to put them on the gpu."));
     // Compute with betapow in REG
     if (grad_type == phi::DataType::FLOAT32)
       AdamWKernelREG<T, float, MPDType>
@@ -259,7 +311,8 @@ void AdamwDenseKernel(const Context& dev_ctx,
               dev_ctx.template Alloc<T>(param_out),
               master_in_data,
               master_out_data,
-              param.numel());
+              param.numel(),
+              skip_update_data);
 
     else
 
@@ -281,7 +334,8 @@ void AdamwDenseKernel(const Context& dev_ctx,
           dev_ctx.template Alloc<T>(param_out),
           master_in_data,
           master_out_data,
-          param.numel());
+          param.numel(),
+          skip_update_data);
     if (!use_global_beta_pow) {
       // Cpu update
       dev_ctx.template HostAlloc<MPDType>(beta1_pow_out)[0] =
@@ -310,7 +364,8 @@ void AdamwDenseKernel(const Context& dev_ctx,
               dev_ctx.template Alloc<T>(param_out),
               master_in_data,
               master_out_data,
-              param.numel());
+              param.numel(),
+              skip_update_data);
     else
       AdamWKernelMEM<T, T, MPDType><<<blocks, threads, 0, dev_ctx.stream()>>>(
           beta1_,
@@ -330,7 +385,8 @@ void AdamwDenseKernel(const Context& dev_ctx,
           dev_ctx.template Alloc<T>(param_out),
           master_in_data,
           master_out_data,
-          param.numel());
+          param.numel(),
+          skip_update_data);
     if (!use_global_beta_pow) {
       // Update with gpu
       UpdateAdamWBetaPow<MPDType><<<1, 1, 0, dev_ctx.stream()>>>(
@@ -339,7 +395,8 @@ void AdamwDenseKernel(const Context& dev_ctx,
           beta1_pow.data<MPDType>(),
           beta2_pow.data<MPDType>(),
           dev_ctx.template Alloc<MPDType>(beta1_pow_out),
-          dev_ctx.template Alloc<MPDType>(beta2_pow_out));
+          dev_ctx.template Alloc<MPDType>(beta2_pow_out),
+          skip_update_data);
     }
   }
 }
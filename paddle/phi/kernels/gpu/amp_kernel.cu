@@ -14,6 +14,7 @@
 
 #include "paddle/phi/kernels/amp_kernel.h"
 
+#include "paddle/phi/backends/gpu/cuda/cuda_graph_with_memory_pool.h"
 #include "paddle/phi/common/amp_type_traits.h"
 #include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/core/kernel_registry.h"
@@ -174,10 +175,13 @@ class LazyZeros<phi::GPUContext, T> {
     for (int i = 0; i < xs_size; i++) {
       h_starts[i + 1] = h_starts[i] + outs[i]->numel();
     }
+    // The host memory of the copies is kept until the CUDA Graph is reset,
+    // so that the replays of a captured step read it.
     memory_utils::Copy(dev_ctx.GetPlace(),
                        d_starts,
                        cpu_place,
-                       h_starts,
+                       phi::backends::gpu::RestoreHostMemIfCapturingCUDAGraph(
+                           h_starts, xs_size + 1),
                        (xs_size + 1) * sizeof(int64_t),
                        dev_ctx.stream());
 
@@ -198,7 +202,8 @@ class LazyZeros<phi::GPUContext, T> {
     memory_utils::Copy(dev_ctx.GetPlace(),
                        d_out_addrs,
                        cpu_place,
-                       h_out_addrs,
+                       phi::backends::gpu::RestoreHostMemIfCapturingCUDAGraph(
+                           h_out_addrs, xs_size),
                        xs_size * sizeof(T*),
                        dev_ctx.stream());
 
@@ -304,10 +309,13 @@ void CheckFiniteAndUnscaleKernel(const Context& dev_ctx,
     h_starts[i] = h_starts[i - 1] + xs[i - 1]->numel();
   }
   int64_t total_num = h_starts[xs_size];
+  // The host memory of the copies is kept until the CUDA Graph is reset, so
+  // that the replays of a captured step read it.
   memory_utils::Copy(dev_ctx.GetPlace(),
                      d_starts,
                      cpu_place,
-                     h_starts,
+                     phi::backends::gpu::RestoreHostMemIfCapturingCUDAGraph(
+                         h_starts, xs_size + 1),
                      (xs_size + 1) * sizeof(int64_t),
                      dev_ctx.stream());
 
@@ -330,7 +338,8 @@ void CheckFiniteAndUnscaleKernel(const Context& dev_ctx,
   memory_utils::Copy(dev_ctx.GetPlace(),
                      d_xs,
                      cpu_place,
-                     h_xs,
+                     phi::backends::gpu::RestoreHostMemIfCapturingCUDAGraph(
+                         h_xs, 2 * xs_size),
                      2 * xs_size * sizeof(T*),
                      dev_ctx.stream());
 
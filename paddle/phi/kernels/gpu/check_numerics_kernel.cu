@@ -134,6 +134,19 @@ __global__ void CheckNanInfKernel(const T* value,
   PrintNanInfKernel(value, numel, print_num, debug_info);
 }
 
+template <typename T>
+__global__ void AccumulateNanInfCUDAKernel(const T* value,
+                                           const size_t numel,
+                                           bool* found_nan_inf) {
+  const size_t tid = threadIdx.x + blockIdx.x * blockDim.x;
+  T sum = static_cast<T>(0.0);
+  for (size_t i = tid; i < numel; i += blockDim.x * gridDim.x) {
+    sum += (value[i] - value[i]);
+  }
+  // All the threads write the same value, so no atomic is needed.
+  if (isnan(sum) || isinf(sum)) *found_nan_inf = true;
+}
+
 template <typename T, int ReduceType>
 __device__ T BlockReduce(T value) {
   __shared__ T shared_mem[1024];
@@ -589,6 +602,20 @@ void CheckNumericsKernel(const Context& ctx,
 #endif
 }
 
+template <typename T, typename Context>
+void AccumulateNanInfKernel(const Context& ctx,
+                            const DenseTensor& tensor,
+                            DenseTensor* found_nan_inf) {
+  if (tensor.numel() <= 0) return;
+
+  const size_t threads = 1024;
+  size_t blocks =
+      std::min(static_cast<size_t>(128),
+               static_cast<size_t>((tensor.numel() + threads - 1) / threads));
+  AccumulateNanInfCUDAKernel<T><<<blocks, threads, 0, ctx.stream()>>>(
+      tensor.data<T>(), tensor.numel(), found_nan_inf->data<bool>());
+}
+
 }  // namespace phi
 
 PD_REGISTER_KERNEL(check_numerics,
@@ -601,3 +628,14 @@ PD_REGISTER_KERNEL(check_numerics,
                    phi::dtype::bfloat16,
                    phi::dtype::complex<float>,
                    phi::dtype::complex<double>) {}
+
+PD_REGISTER_KERNEL(accumulate_nan_inf,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::AccumulateNanInfKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16,
+                   phi::dtype::complex<float>,
+                   phi::dtype::complex<double>) {}
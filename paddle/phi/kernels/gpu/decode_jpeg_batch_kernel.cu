@@ -0,0 +1,429 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#if !defined(WITH_NV_JETSON) && !defined(PADDLE_WITH_HIP)
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "paddle/phi/kernels/decode_jpeg_kernel.h"
+
+#include "paddle/phi/backends/dynload/nvjpeg.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+namespace phi {
+
+// a decoded image and the crop of it resized into the batch
+struct JpegBatchImage {
+  // the offset of the planes of the image in the decoded images
+  int64_t offset;
+  int height;
+  int width;
+  // the crop x0, y0, x1, y1 in pixels
+  float box[4];
+  bool flip;
+};
+
+// out = pixel * scale + shift, i.e. (pixel - mean) / std
+struct JpegBatchNormalize {
+  float scale[3];
+  float shift[3];
+};
+
+static void EnforceNvjpegSuccess(nvjpegStatus_t status, const char* api) {
+  PADDLE_ENFORCE_EQ(
+      status,
+      NVJPEG_STATUS_SUCCESS,
+      errors::External("%s failed with the nvjpeg status %d.",
+                       api,
+                       static_cast<int>(status)));
+}
+
+// The nvjpeg decoders of a device and the stream they decode on, so that the
+// decoding of a batch overlaps the kernels queued on the compute stream. The
+// hardware decoder of A100 and later, if there is one, decodes the images it
+// supports, and the hybrid decoder the others. The bytes of the batches are
+// staged in two pinned buffers by turns, since the decoders copy them to the
+// device asynchronously.
+class JpegBatchDecoder {
+ public:
+  struct Decoder {
+    nvjpegHandle_t handle{nullptr};
+    nvjpegJpegState_t state{nullptr};
+    // the batch size and the format the decoder is initialized with
+    int batch_size{0};
+    nvjpegOutputFormat_t format{NVJPEG_OUTPUT_FORMAT_MAX};
+  };
+
+  static JpegBatchDecoder* Get(int device_id) {
+    static std::mutex mutex;
+    static std::map<int, std::unique_ptr<JpegBatchDecoder>> decoders;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& decoder = decoders[device_id];
+    if (decoder == nullptr) {
+      decoder.reset(new JpegBatchDecoder(device_id));
+    }
+    return decoder.get();
+  }
+
+  // Returns the pinned copy of the bytes of a batch, once the decoding of
+  // the batch staged last in the same buffer is done.
+  const uint8_t* Stage(const uint8_t* data, size_t size) {
+    current_ = (current_ + 1) % kStagingNum;
+    auto& buffer = staging_[current_];
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(staged_events_[current_]));
+    if (buffer == nullptr || buffer->size() < size) {
+      buffer.reset();
+      buffer = phi::memory_utils::Alloc(phi::GPUPinnedPlace(), size * 2);
+    }
+    std::memcpy(buffer->ptr(), data, size);
+    return reinterpret_cast<const uint8_t*>(buffer->ptr());
+  }
+
+  // Decodes the images into the planes of images on the decoding stream.
+  void Decode(Decoder* decoder,
+              nvjpegOutputFormat_t format,
+              const std::vector<const unsigned char*>& data,
+              const std::vector<size_t>& lengths,
+              std::vector<nvjpegImage_t>* images) {
+    if (data.empty()) {
+      return;
+    }
+    const int batch_size = static_cast<int>(data.size());
+    if (decoder->batch_size != batch_size || decoder->format != format) {
+      EnforceNvjpegSuccess(
+          phi::dynload::nvjpegDecodeBatchedInitialize(
+              decoder->handle, decoder->state, batch_size, 1, format),
+          "nvjpegDecodeBatchedInitialize");
+      decoder->batch_size = batch_size;
+      decoder->format = format;
+    }
+    EnforceNvjpegSuccess(phi::dynload::nvjpegDecodeBatched(decoder->handle,
+                                                           decoder->state,
+                                                           data.data(),
+                                                           lengths.data(),
+                                                           images->data(),
+                                                           stream_),
+                         "nvjpegDecodeBatched");
+  }
+
+  // Makes the decoding wait for the work queued on the compute stream, e.g.
+  // the allocation of the planes.
+  void WaitCompute(const GPUContext& dev_ctx) {
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(ready_event_, dev_ctx.stream()));
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(stream_, ready_event_, 0));
+  }
+
+  // Makes the compute stream wait for the images decoded, and frees the
+  // staging buffer of the batch once they are.
+  void WaitDecoded(const GPUContext& dev_ctx) {
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(decoded_event_, stream_));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaStreamWaitEvent(dev_ctx.stream(), decoded_event_, 0));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaEventRecord(staged_events_[current_], stream_));
+  }
+
+  std::mutex* mutex() { return &mutex_; }
+  Decoder* hybrid() { return &hybrid_; }
+  // the hardware decoder, nullptr if the device has none
+  Decoder* hardware() {
+    return hardware_.handle == nullptr ? nullptr : &hardware_;
+  }
+  nvjpegJpegStream_t jpeg_stream() { return jpeg_stream_; }
+
+ private:
+  static constexpr int kStagingNum = 2;
+
+  explicit JpegBatchDecoder(int device_id) {
+    phi::backends::gpu::GPUDeviceGuard guard(device_id);
+    EnforceNvjpegSuccess(
+        phi::dynload::nvjpegCreateEx(
+            NVJPEG_BACKEND_DEFAULT, nullptr, nullptr, 0, &hybrid_.handle),
+        "nvjpegCreateEx");
+    EnforceNvjpegSuccess(
+        phi::dynload::nvjpegJpegStateCreate(hybrid_.handle, &hybrid_.state),
+        "nvjpegJpegStateCreate");
+    if (phi::dynload::nvjpegCreateEx(NVJPEG_BACKEND_HARDWARE,
+                                     nullptr,
+                                     nullptr,
+                                     0,
+                                     &hardware_.handle) ==
+        NVJPEG_STATUS_SUCCESS) {
+      EnforceNvjpegSuccess(phi::dynload::nvjpegJpegStateCreate(
+                               hardware_.handle, &hardware_.state),
+                           "nvjpegJpegStateCreate");
+      EnforceNvjpegSuccess(
+          phi::dynload::nvjpegJpegStreamCreate(hardware_.handle, &jpeg_stream_),
+          "nvjpegJpegStreamCreate");
+    } else {
+      hardware_.handle = nullptr;
+    }
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaStreamCreateWithFlags(&stream_, cudaStreamNonBlocking));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaEventCreateWithFlags(&ready_event_, cudaEventDisableTiming));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaEventCreateWithFlags(&decoded_event_, cudaEventDisableTiming));
+    for (auto& event : staged_events_) {
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    }
+  }
+
+  std::mutex mutex_;
+  Decoder hybrid_;
+  Decoder hardware_;
+  nvjpegJpegStream_t jpeg_stream_{nullptr};
+  cudaStream_t stream_{nullptr};
+  cudaEvent_t ready_event_{nullptr};
+  cudaEvent_t decoded_event_{nullptr};
+  std::array<Allocator::AllocationPtr, kStagingNum> staging_;
+  std::array<cudaEvent_t, kStagingNum> staged_events_;
+  int current_{0};
+};
+
+// Resizes the crops of the decoded images bilinearly, with the centers of
+// the pixels aligned, flips and normalizes them. The blocks of blockIdx.y
+// fill the image of it in the batch.
+__global__ void CropResizeNormalizeKernel(const uint8_t* images,
+                                          const JpegBatchImage* batch_images,
+                                          int channels,
+                                          int out_height,
+                                          int out_width,
+                                          JpegBatchNormalize normalize,
+                                          float* out) {
+  const JpegBatchImage image = batch_images[blockIdx.y];
+  const int out_size = out_height * out_width;
+  const int64_t plane_size = static_cast<int64_t>(image.height) * image.width;
+  const float scale_x = (image.box[2] - image.box[0]) / out_width;
+  const float scale_y = (image.box[3] - image.box[1]) / out_height;
+  float* image_out =
+      out + static_cast<int64_t>(blockIdx.y) * channels * out_size;
+
+  for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < out_size;
+       i += blockDim.x * gridDim.x) {
+    const int oy = i / out_width;
+    const int ox = image.flip ? out_width - 1 - i % out_width : i % out_width;
+    float sx = image.box[0] + (ox + 0.5f) * scale_x - 0.5f;
+    float sy = image.box[1] + (oy + 0.5f) * scale_y - 0.5f;
+    sx = min(max(sx, 0.f), image.width - 1.f);
+    sy = min(max(sy, 0.f), image.height - 1.f);
+    const int x0 = static_cast<int>(sx);
+    const int y0 = static_cast<int>(sy);
+    const int x1 = min(x0 + 1, image.width - 1);
+    const int y1 = min(y0 + 1, image.height - 1);
+    const float fx = sx - x0;
+    const float fy = sy - y0;
+    const int64_t row0 = static_cast<int64_t>(y0) * image.width;
+    const int64_t row1 = static_cast<int64_t>(y1) * image.width;
+
+    for (int c = 0; c < channels; ++c) {
+      const uint8_t* plane = images + image.offset + c * plane_size;
+      float top = plane[row0 + x0] + (plane[row0 + x1] - plane[row0 + x0]) * fx;
+      float bottom =
+          plane[row1 + x0] + (plane[row1 + x1] - plane[row1 + x0]) * fx;
+      float value = top + (bottom - top) * fy;
+      image_out[c * out_size + i] =
+          value * normalize.scale[c] + normalize.shift[c];
+    }
+  }
+}
+
+template <typename T, typename Context>
+void DecodeJpegBatchKernel(const Context& dev_ctx,
+                           const DenseTensor& x,
+                           const DenseTensor& offsets,
+                           const paddle::optional<DenseTensor>& boxes,
+                           const paddle::optional<DenseTensor>& flip,
+                           const std::vector<int>& size,
+                           const std::vector<float>& mean,
+                           const std::vector<float>& std,
+                           const std::string& mode,
+                           DenseTensor* out) {
+  for (const DenseTensor* tensor :
+       {&x, &offsets, boxes.get_ptr(), flip.get_ptr()}) {
+    PADDLE_ENFORCE_EQ(
+        tensor == nullptr || tensor->place().GetType() != AllocationType::GPU,
+        true,
+        errors::InvalidArgument("The inputs of decode_jpeg_batch should be on "
+                                "the host."));
+  }
+  const int batch_size = static_cast<int>(offsets.numel());
+  const int channels = mode == "rgb" ? 3 : 1;
+  const nvjpegOutputFormat_t format =
+      mode == "rgb" ? NVJPEG_OUTPUT_RGB : NVJPEG_OUTPUT_Y;
+  float* out_data = dev_ctx.template Alloc<float>(out);
+  if (batch_size == 0) {
+    return;
+  }
+
+  const int64_t* ends = offsets.data<int64_t>();
+  PADDLE_ENFORCE_LE(ends[batch_size - 1],
+                    x.numel(),
+                    errors::InvalidArgument(
+                        "The last offset (%d) of decode_jpeg_batch is beyond "
+                        "the %d bytes of the images.",
+                        ends[batch_size - 1],
+                        x.numel()));
+  const float* boxes_data = boxes ? boxes->data<float>() : nullptr;
+  const bool* flip_data = flip ? flip->data<bool>() : nullptr;
+
+  auto* batch_decoder =
+      JpegBatchDecoder::Get(dev_ctx.GetPlace().GetDeviceId());
+  std::lock_guard<std::mutex> lock(*batch_decoder->mutex());
+  const uint8_t* bytes = batch_decoder->Stage(x.data<uint8_t>(), x.numel());
+
+  // the shapes of the images and the decoder of each one
+  auto* hardware = format == NVJPEG_OUTPUT_RGB ? batch_decoder->hardware()
+                                               : nullptr;
+  std::vector<JpegBatchImage> batch_images(batch_size);
+  std::vector<bool> on_hardware(batch_size, false);
+  int64_t decoded_size = 0;
+  for (int i = 0; i < batch_size; ++i) {
+    const int64_t begin = i == 0 ? 0 : ends[i - 1];
+    PADDLE_ENFORCE_LT(begin,
+                      ends[i],
+                      errors::InvalidArgument(
+                          "The offsets of decode_jpeg_batch should be "
+                          "increasing, but image %d has no bytes.",
+                          i));
+    const unsigned char* data = bytes + begin;
+    const size_t length = ends[i] - begin;
+    int components;
+    nvjpegChromaSubsampling_t subsampling;
+    int widths[NVJPEG_MAX_COMPONENT];
+    int heights[NVJPEG_MAX_COMPONENT];
+    EnforceNvjpegSuccess(
+        phi::dynload::nvjpegGetImageInfo(batch_decoder->hybrid()->handle,
+                                         data,
+                                         length,
+                                         &components,
+                                         &subsampling,
+                                         widths,
+                                         heights),
+        "nvjpegGetImageInfo");
+    if (hardware != nullptr) {
+      int unsupported = 1;
+      if (phi::dynload::nvjpegJpegStreamParse(hardware->handle,
+                                              data,
+                                              length,
+                                              0,
+                                              0,
+                                              batch_decoder->jpeg_stream()) ==
+          NVJPEG_STATUS_SUCCESS) {
+        phi::dynload::nvjpegDecodeBatchedSupported(
+            hardware->handle, batch_decoder->jpeg_stream(), &unsupported);
+      }
+      on_hardware[i] = unsupported == 0;
+    }
+
+    auto& image = batch_images[i];
+    image.offset = decoded_size;
+    image.width = widths[0];
+    image.height = heights[0];
+    const float box[4] = {0.f, 0.f, 1.f, 1.f};
+    const float* image_box = boxes_data ? boxes_data + i * 4 : box;
+    image.box[0] = image_box[0] * image.width;
+    image.box[1] = image_box[1] * image.height;
+    image.box[2] = image_box[2] * image.width;
+    image.box[3] = image_box[3] * image.height;
+    image.flip = flip_data ? flip_data[i] : false;
+    decoded_size += static_cast<int64_t>(channels) * image.width * image.height;
+  }
+
+  DenseTensor decoded;
+  decoded.Resize({decoded_size});
+  uint8_t* decoded_data = dev_ctx.template Alloc<uint8_t>(&decoded);
+
+  // the images of the hardware decoder and of the hybrid one
+  std::array<std::vector<const unsigned char*>, 2> data;
+  std::array<std::vector<size_t>, 2> lengths;
+  std::array<std::vector<nvjpegImage_t>, 2> images;
+  for (int i = 0; i < batch_size; ++i) {
+    const int64_t begin = i == 0 ? 0 : ends[i - 1];
+    const int group = on_hardware[i] ? 0 : 1;
+    const auto& image = batch_images[i];
+    nvjpegImage_t planes;
+    for (int c = 0; c < NVJPEG_MAX_COMPONENT; ++c) {
+      planes.channel[c] = nullptr;
+      planes.pitch[c] = 0;
+    }
+    for (int c = 0; c < channels; ++c) {
+      planes.channel[c] = decoded_data + image.offset +
+                          static_cast<int64_t>(c) * image.width * image.height;
+      planes.pitch[c] = image.width;
+    }
+    data[group].push_back(bytes + begin);
+    lengths[group].push_back(ends[i] - begin);
+    images[group].push_back(planes);
+  }
+  batch_decoder->WaitCompute(dev_ctx);
+  batch_decoder->Decode(hardware, format, data[0], lengths[0], &images[0]);
+  batch_decoder->Decode(
+      batch_decoder->hybrid(), format, data[1], lengths[1], &images[1]);
+  batch_decoder->WaitDecoded(dev_ctx);
+
+  DenseTensor batch_images_tensor;
+  batch_images_tensor.Resize(
+      {static_cast<int64_t>(batch_size * sizeof(JpegBatchImage))});
+  uint8_t* batch_images_data =
+      dev_ctx.template Alloc<uint8_t>(&batch_images_tensor);
+  phi::memory_utils::Copy(dev_ctx.GetPlace(),
+                          batch_images_data,
+                          phi::CPUPlace(),
+                          batch_images.data(),
+                          batch_size * sizeof(JpegBatchImage),
+                          dev_ctx.stream());
+
+  JpegBatchNormalize normalize;
+  for (int c = 0; c < channels; ++c) {
+    normalize.scale[c] = mean.empty() ? 1.f : 1.f / std[c];
+    normalize.shift[c] = mean.empty() ? 0.f : -mean[c] / std[c];
+  }
+  const int out_size = size[0] * size[1];
+  const int threads = 256;
+  dim3 grid(std::min((out_size + threads - 1) / threads, 64), batch_size);
+  CropResizeNormalizeKernel<<<grid, threads, 0, dev_ctx.stream()>>>(
+      decoded_data,
+      reinterpret_cast<const JpegBatchImage*>(batch_images_data),
+      channels,
+      size[0],
+      size[1],
+      normalize,
+      out_data);
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(decode_jpeg_batch,  // cuda_only
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::DecodeJpegBatchKernel,
+                   uint8_t) {
+  kernel->InputAt(0).SetBackend(phi::Backend::ALL_BACKEND);
+  kernel->InputAt(1).SetBackend(phi::Backend::ALL_BACKEND);
+  kernel->InputAt(2).SetBackend(phi::Backend::ALL_BACKEND);
+  kernel->InputAt(3).SetBackend(phi::Backend::ALL_BACKEND);
+}
+
+#endif
@@ -107,6 +107,9 @@ struct EmbeddingGradCUDAFunctor {
       if (FLAGS_embedding_deterministic == 1) {
         phi::funcs::LaunchEmbeddingGradDeterministicKernel<T, IdT>(
             dev_ctx_, ids, d_output, d_table, N, D, K);
+      } else if (FLAGS_embedding_deterministic == 3) {
+        phi::funcs::EmbeddingGradSortReducer<IdT> reducer(dev_ctx_, ids, N, K);
+        reducer.Reduce(d_output, D, /*index_by_id=*/true, d_table);
       } else {
         const int gridx = 2 * dev_ctx_.GetSMCount();
         dim3 threads(128, 8);
@@ -178,6 +181,10 @@ struct EmbeddingSparseGradCUDAFunctor {
     auto* table = &weight_;
     auto* d_output = &out_grad_;
     int64_t ids_num = input_.numel();
+    if (FLAGS_embedding_deterministic == 3) {
+      MergedApply(ids_data, ids_num);
+      return;
+    }
     dim3 threads(128, 8);
     dim3 grids(8, 1);
     auto stream = dev_ctx_.stream();
@@ -228,6 +235,35 @@ struct EmbeddingSparseGradCUDAFunctor {
   }
 
  private:
+  // Produces the rows of the unique ids, each with the sum of the rows of
+  // out_grad of it, by the sort-reduce backward.
+  template <typename IdT>
+  void MergedApply(const IdT* ids_data, int64_t ids_num) {
+    const int64_t N = weight_.dims()[0];
+    const int64_t D = weight_.dims()[1];
+    phi::funcs::EmbeddingGradSortReducer<IdT> reducer(
+        dev_ctx_, ids_data, N, ids_num);
+    const int64_t unique_num = reducer.UniqueNum();
+
+    std::vector<int64_t> new_rows(unique_num);
+    memory_utils::Copy(phi::CPUPlace(),
+                       new_rows.data(),
+                       dev_ctx_.GetPlace(),
+                       reducer.UniqueIds(),
+                       unique_num * sizeof(int64_t),
+                       dev_ctx_.stream());
+    auto* d_table_value = weight_grad_->mutable_value();
+    d_table_value->Resize({unique_num, D});
+    T* d_table_data = dev_ctx_.template Alloc<T>(d_table_value);
+    reducer.Reduce(out_grad_.template data<T>(),
+                   D,
+                   /*index_by_id=*/false,
+                   d_table_data);
+    dev_ctx_.Wait();
+    weight_grad_->set_rows(new_rows);
+    weight_grad_->set_height(N);
+  }
+
   const phi::GPUContext& dev_ctx_;
   const DenseTensor& input_;
   const DenseTensor& weight_;
@@ -19,7 +19,9 @@
 #include "paddle/phi/core/flags.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/empty_kernel.h"
 #include "paddle/phi/kernels/gpu/flash_attn_utils.h"
+#include "paddle/phi/kernels/reduce_sum_kernel.h"
 
 PD_DECLARE_bool(cudnn_deterministic);
 
@@ -30,6 +32,57 @@ int get_num_split() {
   return FLAGS_cudnn_deterministic ? 1 : 0;
 }
 
+#ifdef PADDLE_WITH_FLASHATTN
+// Flash-attention computes the gradients of k and v for every head of q,
+// [..., num_heads, head_dim], which are allocated here as dkv_expanded for
+// GQA and MQA. Returns the pointer written by flash-attention.
+template <typename T, typename Context>
+void* AllocKVGrad(const Context& ctx,
+                  const DenseTensor& kv,
+                  int64_t num_heads,
+                  DenseTensor* dkv,
+                  DenseTensor* dkv_tmp,
+                  DenseTensor* dkv_expanded) {
+  const int64_t num_heads_k = kv.dims()[kv.dims().size() - 2];
+  if (num_heads_k != num_heads) {
+    auto dims = common::vectorize(kv.dims());
+    dims[dims.size() - 2] = num_heads;
+    *dkv_expanded = Empty<T, Context>(ctx, dims);
+    if (dkv) {
+      ctx.template Alloc<T>(dkv);
+    }
+    return dkv_expanded->data();
+  }
+  if (dkv) {
+    ctx.template Alloc<T>(dkv);
+    return dkv->data();
+  }
+  *dkv_tmp = EmptyLike<T, Context>(ctx, kv);
+  return dkv_tmp->data();
+}
+
+// Sums dkv_expanded over the heads of q sharing the same head of k and v.
+template <typename T, typename Context>
+void KVReduceForGQA(const Context& ctx,
+                    const DenseTensor& dkv_expanded,
+                    int64_t num_heads_k,
+                    DenseTensor* dkv) {
+  if (!dkv || !dkv_expanded.initialized()) {
+    return;
+  }
+  // [..., num_heads, head_dim] -> [..., num_heads_k, groups, head_dim]
+  auto dims = common::vectorize(dkv_expanded.dims());
+  const int64_t rank = dims.size();
+  const int64_t num_heads = dims[rank - 2];
+  dims[rank - 2] = num_heads_k;
+  dims.insert(dims.begin() + rank - 1, num_heads / num_heads_k);
+  DenseTensor grouped(dkv_expanded);
+  grouped.Resize(common::make_ddim(dims));
+  phi::SumKernel<T, Context>(
+      ctx, grouped, {rank - 1}, dkv->dtype(), false, dkv);
+}
+#endif
+
 template <typename T, typename Context>
 void FlashAttnUnpaddedGradKernel(const Context& ctx,
                                  const DenseTensor& q,
@@ -58,24 +111,6 @@ void FlashAttnUnpaddedGradKernel(const Context& ctx,
   ctx.template Alloc<T>(dq);
   dq_ptr = dq->data();
 
-  DenseTensor dk_tmp;
-  if (dk) {
-    ctx.template Alloc<T>(dk);
-    dk_ptr = dk->data();
-  } else {
-    dk_tmp = EmptyLike<T, Context>(ctx, k);
-    dk_ptr = dk_tmp.data();
-  }
-
-  DenseTensor dv_tmp;
-  if (dv) {
-    ctx.template Alloc<T>(dv);
-    dv_ptr = dv->data();
-  } else {
-    dv_tmp = EmptyLike<T, Context>(ctx, v);
-    dv_ptr = dv_tmp.data();
-  }
-
   const cudaStream_t stream = ctx.stream();
 
   // q,k,v [total_*, num_heads, head_dim]
@@ -87,6 +122,13 @@ void FlashAttnUnpaddedGradKernel(const Context& ctx,
   const int64_t head_size = dims[2];
   const int64_t num_heads_k = k.dims()[1];
 
+  DenseTensor dk_tmp, dk_expanded;
+  dk_ptr = AllocKVGrad<T, Context>(
+      ctx, k, num_heads, dk, &dk_tmp, &dk_expanded);
+  DenseTensor dv_tmp, dv_expanded;
+  dv_ptr = AllocKVGrad<T, Context>(
+      ctx, v, num_heads, dv, &dv_tmp, &dv_expanded);
+
   int num_splits = get_num_split();
 
   // TODO(umiswing): add shape check
@@ -150,6 +192,8 @@ void FlashAttnUnpaddedGradKernel(const Context& ctx,
       params.attn_mask_tensor ? params.attn_mask_tensor->data() : nullptr,
       params.attn_mask_tensor ? params.mask_dims.data() : nullptr);
   CheckFlashAttnStatus(succ);
+  KVReduceForGQA<T, Context>(ctx, dk_expanded, num_heads_k, dk);
+  KVReduceForGQA<T, Context>(ctx, dv_expanded, num_heads_k, dv);
 #else
   RaiseNotSupportedError();
 #endif
@@ -178,24 +222,6 @@ void FlashAttnGradKernel(const Context& ctx,
   ctx.template Alloc<T>(dq);
   dq_ptr = dq->data();
 
-  DenseTensor dk_tmp;
-  if (dk) {
-    ctx.template Alloc<T>(dk);
-    dk_ptr = dk->data();
-  } else {
-    dk_tmp = EmptyLike<T, Context>(ctx, k);
-    dk_ptr = dk_tmp.data();
-  }
-
-  DenseTensor dv_tmp;
-  if (dv) {
-    ctx.template Alloc<T>(dv);
-    dv_ptr = dv->data();
-  } else {
-    dv_tmp = EmptyLike<T, Context>(ctx, v);
-    dv_ptr = dv_tmp.data();
-  }
-
   const cudaStream_t stream = ctx.stream();
 
   // q, k, v [batch_size, seq_len, num_heads, head_dim]
@@ -209,6 +235,13 @@ void FlashAttnGradKernel(const Context& ctx,
   const int64_t seqlen_k = k.dims()[1];
   const int64_t num_heads_k = k.dims()[2];
 
+  DenseTensor dk_tmp, dk_expanded;
+  dk_ptr = AllocKVGrad<T, Context>(
+      ctx, k, num_heads, dk, &dk_tmp, &dk_expanded);
+  DenseTensor dv_tmp, dv_expanded;
+  dv_ptr = AllocKVGrad<T, Context>(
+      ctx, v, num_heads, dv, &dv_tmp, &dv_expanded);
+
   // TODO(umiswing): add shape check
   PADDLE_ENFORCE_EQ(
       head_size_og,
@@ -281,6 +314,8 @@ void FlashAttnGradKernel(const Context& ctx,
       params.attn_mask_tensor ? params.attn_mask_tensor->data() : nullptr,
       params.attn_mask_tensor ? params.mask_dims.data() : nullptr);
   CheckFlashAttnStatus(succ);
+  KVReduceForGQA<T, Context>(ctx, dk_expanded, num_heads_k, dk);
+  KVReduceForGQA<T, Context>(ctx, dv_expanded, num_heads_k, dv);
 #else
   RaiseNotSupportedError();
 #endif
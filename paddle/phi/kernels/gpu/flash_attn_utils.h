@@ -114,13 +114,24 @@ struct FlashAttnParamsBase {
         max_seqlen_q(_max_seqlen_q),
         max_seqlen_k(_max_seqlen_k),
         num_heads(_num_heads),
-        num_heads_k(_num_heads),
+        num_heads_k(_num_heads_k),
         head_size(_head_size),
         softmax_scale(_scale),
         causal(_causal),
         attn_mask_tensor(attn_mask.get_ptr()) {
     is_bf16 = q_dtype == DataType::BFLOAT16;
 
+    // k and v of num_heads_k heads are shared by the groups of
+    // num_heads / num_heads_k heads of q for GQA and MQA
+    PADDLE_ENFORCE_EQ(
+        num_heads_k > 0 && num_heads % num_heads_k == 0,
+        true,
+        phi::errors::InvalidArgument(
+            "The number of heads of q (%d) is expected to be a multiple of "
+            "the one of k and v (%d).",
+            num_heads,
+            num_heads_k));
+
     auto round_multiple = [](int x, int m) { return (x + m - 1) / m * m; };
     head_size_rounded = round_multiple(head_size, 32);
     seqlen_q_rounded = round_multiple(max_seqlen_q, 128);
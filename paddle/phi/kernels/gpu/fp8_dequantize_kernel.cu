@@ -0,0 +1,76 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/fp8_dequantize_kernel.h"
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_helper.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/fp8_utils.cu.h"
+
+namespace phi {
+
+template <typename T, typename OutT>
+__global__ void Fp8DequantizeCUDAKernel(const T* x,
+                                        const float* scale,
+                                        const int64_t numel,
+                                        OutT* out) {
+  const float scale_inv = 1.f / scale[0];
+  CUDA_KERNEL_LOOP_TYPE(i, numel, int64_t) {
+    out[i] = static_cast<OutT>(static_cast<float>(x[i]) * scale_inv);
+  }
+}
+
+template <typename T, typename OutT>
+static void Fp8DequantizeImpl(const GPUContext& dev_ctx,
+                              const DenseTensor& x,
+                              const DenseTensor& scale,
+                              DenseTensor* out) {
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, x.numel());
+  Fp8DequantizeCUDAKernel<T, OutT><<<config.block_per_grid,
+                                     config.thread_per_block,
+                                     0,
+                                     dev_ctx.stream()>>>(
+      x.data<T>(),
+      scale.data<float>(),
+      x.numel(),
+      dev_ctx.template Alloc<OutT>(out));
+}
+
+template <typename T, typename Context>
+void Fp8DequantizeKernel(const Context& dev_ctx,
+                         const DenseTensor& x,
+                         const DenseTensor& scale,
+                         DataType out_dtype,
+                         DenseTensor* out) {
+  if (out_dtype == DataType::FLOAT32) {
+    Fp8DequantizeImpl<T, float>(dev_ctx, x, scale, out);
+  } else if (out_dtype == DataType::FLOAT16) {
+    Fp8DequantizeImpl<T, phi::dtype::float16>(dev_ctx, x, scale, out);
+  } else {
+    Fp8DequantizeImpl<T, phi::dtype::bfloat16>(dev_ctx, x, scale, out);
+  }
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fp8_dequantize,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::Fp8DequantizeKernel,
+                   phi::dtype::float8_e4m3fn,
+                   phi::dtype::float8_e5m2) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::UNDEFINED);
+}
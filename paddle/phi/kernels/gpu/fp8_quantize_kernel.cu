@@ -0,0 +1,63 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/fp8_quantize_kernel.h"
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/fp8_utils.cu.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+
+namespace phi {
+
+template <typename T, typename Context>
+void Fp8QuantizeKernel(const Context& dev_ctx,
+                       const DenseTensor& x,
+                       const DenseTensor& scale,
+                       DataType out_dtype,
+                       DenseTensor* out,
+                       DenseTensor* amax) {
+  float* amax_data = dev_ctx.template Alloc<float>(amax);
+  phi::funcs::SetConstant<Context, float>()(dev_ctx, amax, 0.f);
+  if (out_dtype == DataType::FLOAT8_E4M3FN) {
+    funcs::Fp8Quantize<T, phi::dtype::float8_e4m3fn>(
+        dev_ctx,
+        x.data<T>(),
+        scale.data<float>(),
+        x.numel(),
+        dev_ctx.template Alloc<phi::dtype::float8_e4m3fn>(out),
+        amax_data);
+  } else {
+    funcs::Fp8Quantize<T, phi::dtype::float8_e5m2>(
+        dev_ctx,
+        x.data<T>(),
+        scale.data<float>(),
+        x.numel(),
+        dev_ctx.template Alloc<phi::dtype::float8_e5m2>(out),
+        amax_data);
+  }
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fp8_quantize,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::Fp8QuantizeKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::UNDEFINED);
+  kernel->OutputAt(1).SetDataType(phi::DataType::FLOAT32);
+}
@@ -82,7 +82,12 @@ struct FusedAdamFunctor {
       FusedAdamBetaPowInfo<T, IsCPUBetaPow> beta_pow,
       MT epsilon,
       const MT* learning_rate,
-      MT decay) const {
+      MT decay,
+      const bool* skip_update) const {
+    // The outputs are the inputs, so a skipped update on the device is a no-op.
+    if (skip_update && *skip_update) {
+      return;
+    }
     MT lr = *learning_rate;
     MT beta1_pow = beta_pow.GetBeta1PowValue();
     MT beta2_pow = beta_pow.GetBeta2PowValue();
@@ -228,8 +233,15 @@ struct FusedAdamFunctor {
 };
 
 template <typename T, int N>
-__global__ void UpdateBetaPowGroup(
-    Array<T*, N> beta1_pow, Array<T*, N> beta2_pow, T beta1, T beta2, int n) {
+__global__ void UpdateBetaPowGroup(Array<T*, N> beta1_pow,
+                                   Array<T*, N> beta2_pow,
+                                   T beta1,
+                                   T beta2,
+                                   int n,
+                                   const bool* skip_update) {
+  if (skip_update && *skip_update) {
+    return;
+  }
   auto idx = threadIdx.x;
   if (idx < n) {
     beta1_pow[idx][0] *= beta1;
@@ -323,17 +335,25 @@ void FusedAdamKernel(
   }
 
   bool skip_update_value = false;
+  const bool* skip_update_data = nullptr;
   if (skip_update.is_initialized()) {
     PADDLE_ENFORCE_EQ(
         skip_update->numel(),
         1,
         errors::InvalidArgument("Input(SkipUpdate) size must be 1, but get %d",
                                 skip_update->numel()));
-    DenseTensor skip_update_tensor;
-    phi::Copy(
-        dev_ctx, skip_update.get(), CPUPlace(), false, &skip_update_tensor);
-    skip_update_value = skip_update_tensor.data<bool>()[0];
-    VLOG(4) << "skip_update_value:" << skip_update_value;
+    // The kernels read a gpu skip_update without a host sync, unless the beta
+    // pows are updated on the cpu.
+    if (skip_update->place().GetType() == AllocationType::GPU &&
+        (use_global_beta_pow || !is_cpu_betapow)) {
+      skip_update_data = skip_update->data<bool>();
+    } else {
+      DenseTensor skip_update_tensor;
+      phi::Copy(
+          dev_ctx, skip_update.get(), CPUPlace(), false, &skip_update_tensor);
+      skip_update_value = skip_update_tensor.data<bool>()[0];
+      VLOG(4) << "skip_update_value:" << skip_update_value;
+    }
   }
 
   // skip_update=true
@@ -391,7 +411,8 @@ void FusedAdamKernel(
         beta_pow_info,                                                       \
         epsilon.to<MPDType>(),                                               \
         learning_rate.data<MPDType>(),                                       \
-        static_cast<MPDType>(weight_decay));                                 \
+        static_cast<MPDType>(weight_decay),                                  \
+        skip_update_data);                                                   \
   } while (0)
 
 #define PD_LAUNCH_MULTI_TENSOR_APPLY_ADAM_KERNEL(__vec_size) \
@@ -479,7 +500,12 @@ void FusedAdamKernel(
         }
         UpdateBetaPowGroup<MPDType, kGroupSize>
             <<<1, kGroupSize, 0, dev_ctx.stream()>>>(
-                beta1_ptrs, beta2_ptrs, beta1_tmp, beta2_tmp, end - start);
+                beta1_ptrs,
+                beta2_ptrs,
+                beta1_tmp,
+                beta2_tmp,
+                end - start,
+                skip_update_data);
       }
     }
   }
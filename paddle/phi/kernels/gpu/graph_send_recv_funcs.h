@@ -13,14 +13,23 @@
 // limitations under the License.
 
 #pragma once
+#include <thrust/binary_search.h>
+#include <thrust/copy.h>
 #include <thrust/device_vector.h>
+#include <thrust/execution_policy.h>
 #include <thrust/fill.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
 
 #include <algorithm>
+#include <string>
 #include <vector>
 
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/core/hostdevice.h"
 #include "paddle/phi/kernels/send_u_recv_kernel.h"
 
@@ -168,4 +177,223 @@ __global__ void ManipulateMinMaxGradCUDAKernel(const T* params,
   }
 }
 
+// The message of send_u_recv, the x of the src.
+template <typename T, typename IndexT>
+struct GraphSendRecvCopyMessageFunctor {
+  const T* x_data;
+  int64_t slice_size;
+
+  DEVICE inline T operator()(const IndexT& src,
+                             const IndexT& eid,
+                             const int64_t& out_i) const {
+    return x_data[src * slice_size + out_i];
+  }
+};
+
+template <typename T>
+struct GraphSendRecvSortedSumFunctor {
+  DEVICE inline T Init() const { return static_cast<T>(0); }
+  DEVICE inline T operator()(const T& a, const T& b) const { return a + b; }
+};
+
+template <typename T>
+struct GraphSendRecvSortedMaxFunctor {
+  DEVICE inline T Init() const { return std::numeric_limits<T>::lowest(); }
+  DEVICE inline T operator()(const T& a, const T& b) const {
+    return a > b ? a : b;
+  }
+};
+
+template <typename T>
+struct GraphSendRecvSortedMinFunctor {
+  DEVICE inline T Init() const { return std::numeric_limits<T>::max(); }
+  DEVICE inline T operator()(const T& a, const T& b) const {
+    return a < b ? a : b;
+  }
+};
+
+// The edges of the out row r are sorted_eids[row_offsets[r]:row_offsets[r+1]]
+// in their order, so every out element is reduced by a thread in a fixed
+// order. The lanes of a warp take the columns of a row, and the empty rows
+// are 0 as the atomic kernels leave them after the reset.
+template <typename T,
+          typename IndexT,
+          typename MessageFunctor,
+          typename ReduceFunctor>
+__global__ void GraphSendRecvSortedCUDAKernel(const IndexT* src_indices,
+                                              const IndexT* sorted_eids,
+                                              const int64_t* row_offsets,
+                                              int64_t out_rows,
+                                              int64_t out_len,
+                                              bool mean,
+                                              MessageFunctor mfunctor,
+                                              ReduceFunctor rfunctor,
+                                              T* output,
+                                              int32_t* dst_count) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  int64_t ty = blockIdx.y * blockDim.y + threadIdx.y;
+  const int64_t stride_y = blockDim.y * gridDim.y;
+
+  while (ty < out_rows) {
+    int64_t start = row_offsets[ty];
+    int64_t end = row_offsets[ty + 1];
+    int64_t tx = blockIdx.x * blockDim.x + threadIdx.x;
+    int64_t stride_x = blockDim.x * gridDim.x;
+
+    while (tx < out_len) {
+      MT val = rfunctor.Init();
+      for (int64_t k = start; k < end; ++k) {
+        IndexT eid = sorted_eids[k];
+        val = rfunctor(val,
+                       static_cast<MT>(mfunctor(src_indices[eid], eid, tx)));
+      }
+      if (start == end) {
+        val = static_cast<MT>(0);
+      } else if (mean) {
+        val = val / static_cast<MT>(end - start);
+      }
+      output[ty * out_len + tx] = static_cast<T>(val);
+      tx += stride_x;
+    }
+    if (dst_count != nullptr && blockIdx.x == 0 && threadIdx.x == 0) {
+      dst_count[ty] = static_cast<int32_t>(end - start);
+    }
+    ty += stride_y;
+  }
+}
+
+// Sorts the edges by dst once into the csr of the out rows, the edges of the
+// out row r being sorted_eids[row_offsets[r]:row_offsets[r + 1]].
+template <typename Context, typename IndexT>
+void SortEdgesByDst(const Context& ctx,
+                    const IndexT* dst_indices,
+                    int64_t index_size,
+                    int64_t out_rows,
+                    DenseTensor* sorted_eids,
+                    DenseTensor* row_offsets) {
+  DenseTensor sorted_dst;
+  sorted_dst.Resize({index_size});
+  IndexT* sorted_dst_data = ctx.template Alloc<IndexT>(&sorted_dst);
+  sorted_eids->Resize({index_size});
+  IndexT* sorted_eids_data = ctx.template Alloc<IndexT>(sorted_eids);
+  row_offsets->Resize({out_rows + 1});
+  int64_t* row_offsets_data = ctx.template Alloc<int64_t>(row_offsets);
+
+#ifdef PADDLE_WITH_CUDA
+  phi::memory_utils::ThrustAllocator<cudaStream_t> allocator(ctx.GetPlace(),
+                                                             ctx.stream());
+  const auto& exec_policy = thrust::cuda::par(allocator).on(ctx.stream());
+#else
+  const auto& exec_policy = thrust::hip::par.on(ctx.stream());
+#endif
+  thrust::copy(
+      exec_policy, dst_indices, dst_indices + index_size, sorted_dst_data);
+  thrust::sequence(
+      exec_policy, sorted_eids_data, sorted_eids_data + index_size);
+  // Stable, so the edges of a row keep their order for the determinism.
+  thrust::stable_sort_by_key(exec_policy,
+                             sorted_dst_data,
+                             sorted_dst_data + index_size,
+                             sorted_eids_data);
+  thrust::lower_bound(exec_policy,
+                      sorted_dst_data,
+                      sorted_dst_data + index_size,
+                      thrust::counting_iterator<int64_t>(0),
+                      thrust::counting_iterator<int64_t>(out_rows + 1),
+                      row_offsets_data);
+}
+
+// The reduction of the messages of FLAGS_graph_send_recv_sorted_reduce, which
+// sorts the edges by dst instead of the atomics adding to the out rows, so it
+// is deterministic and does not serialize on the hub rows of a skewed graph.
+// The dst_count of MEAN is the degree of the out rows.
+template <typename Context,
+          typename T,
+          typename IndexT,
+          typename MessageFunctor>
+void GraphSendRecvSortedReduce(const Context& ctx,
+                               const IndexT* src_indices,
+                               const IndexT* dst_indices,
+                               int64_t index_size,
+                               int64_t out_rows,
+                               int64_t out_len,
+                               const std::string& reduce_op,
+                               MessageFunctor mfunctor,
+                               T* output,
+                               DenseTensor* dst_count) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  DenseTensor sorted_eids;
+  DenseTensor row_offsets;
+  SortEdgesByDst<Context, IndexT>(
+      ctx, dst_indices, index_size, out_rows, &sorted_eids, &row_offsets);
+  const IndexT* sorted_eids_data = sorted_eids.data<IndexT>();
+  const int64_t* row_offsets_data = row_offsets.data<int64_t>();
+
+  int32_t* dst_count_data = nullptr;
+  if (reduce_op == "MEAN") {
+    dst_count->Resize({out_rows});
+    dst_count_data = ctx.template Alloc<int32_t>(dst_count);
+  }
+
+  const int ntx = 32;
+  const int nty = 8;
+  const int nbx =
+      std::min<int64_t>((out_len + ntx - 1) / ntx,
+                        ctx.GetCUDAMaxGridDimSize()[0]);
+  const int nby =
+      std::min<int64_t>((out_rows + nty - 1) / nty,
+                        ctx.GetCUDAMaxGridDimSize()[1]);
+  const dim3 grid(nbx, nby);
+  const dim3 block(ntx, nty);
+  if (reduce_op == "SUM" || reduce_op == "MEAN") {
+    GraphSendRecvSortedSumFunctor<MT> rfunctor;
+    GraphSendRecvSortedCUDAKernel<T,
+                                  IndexT,
+                                  MessageFunctor,
+                                  GraphSendRecvSortedSumFunctor<MT>>
+        <<<grid, block, 0, ctx.stream()>>>(src_indices,
+                                           sorted_eids_data,
+                                           row_offsets_data,
+                                           out_rows,
+                                           out_len,
+                                           reduce_op == "MEAN",
+                                           mfunctor,
+                                           rfunctor,
+                                           output,
+                                           dst_count_data);
+  } else if (reduce_op == "MAX") {
+    GraphSendRecvSortedMaxFunctor<MT> rfunctor;
+    GraphSendRecvSortedCUDAKernel<T,
+                                  IndexT,
+                                  MessageFunctor,
+                                  GraphSendRecvSortedMaxFunctor<MT>>
+        <<<grid, block, 0, ctx.stream()>>>(src_indices,
+                                           sorted_eids_data,
+                                           row_offsets_data,
+                                           out_rows,
+                                           out_len,
+                                           false,
+                                           mfunctor,
+                                           rfunctor,
+                                           output,
+                                           dst_count_data);
+  } else if (reduce_op == "MIN") {
+    GraphSendRecvSortedMinFunctor<MT> rfunctor;
+    GraphSendRecvSortedCUDAKernel<T,
+                                  IndexT,
+                                  MessageFunctor,
+                                  GraphSendRecvSortedMinFunctor<MT>>
+        <<<grid, block, 0, ctx.stream()>>>(src_indices,
+                                           sorted_eids_data,
+                                           row_offsets_data,
+                                           out_rows,
+                                           out_len,
+                                           false,
+                                           mfunctor,
+                                           rfunctor,
+                                           output,
+                                           dst_count_data);
+  }
+}
+
 }  // namespace phi
@@ -120,6 +120,28 @@ struct GraphSendUERecvMinCUDAFunctor {
   }
 };
 
+// The message of send_ue_recv, the x of the src computed with the e of the
+// edge, for GraphSendRecvSortedReduce.
+template <typename T, typename IndexT, typename ComputeFunctor>
+struct GraphSendUERecvMessageFunctor {
+  const T* x_data;
+  const T* e_data;
+  const int64_t* xbcast_off;
+  const int64_t* ebcast_off;
+  int64_t x_len;
+  int64_t e_len;
+  bool use_bcast;
+  ComputeFunctor cfunctor;
+
+  DEVICE inline T operator()(const IndexT& src,
+                             const IndexT& eid,
+                             const int64_t& out_i) const {
+    int64_t x_add = use_bcast ? xbcast_off[out_i] : out_i;
+    int64_t e_add = use_bcast ? ebcast_off[out_i] : out_i;
+    return cfunctor(x_data[src * x_len + x_add], e_data[eid * e_len + e_add]);
+  }
+};
+
 template <typename T,
           typename IndexT,
           typename ReduceFunctor,
@@ -0,0 +1,434 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#ifndef PADDLE_WITH_HIP
+
+#include "paddle/phi/kernels/matrix_nms_kernel.h"
+
+#include <cub/cub.cuh>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/tensor_utils.h"
+
+namespace phi {
+
+// The matrix nms of the whole batch, where the boxes of every (image, class)
+// are sorted and decayed by a block at once, instead of a loop over the images
+// and the classes on the cpu. The detections of an image are in the order of
+// their decayed scores, the same as the cpu kernel up to the ties.
+
+static constexpr int kMatrixNMSThreads = 256;
+
+template <typename T>
+__device__ inline T MatrixNMSBBoxArea(const T* box, const bool normalized) {
+  if (box[2] < box[0] || box[3] < box[1]) {
+    // If coordinate values are is invalid
+    // (e.g. xmax < xmin or ymax < ymin), return 0.
+    return static_cast<T>(0.);
+  }
+  const T w = box[2] - box[0];
+  const T h = box[3] - box[1];
+  // If coordinate values are not within range [0, 1].
+  return normalized ? w * h : (w + 1) * (h + 1);
+}
+
+template <typename T>
+__device__ inline T MatrixNMSJaccardOverlap(const T* box1,
+                                            const T* box2,
+                                            const bool normalized) {
+  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
+      box2[3] < box1[1]) {
+    return static_cast<T>(0.);
+  }
+  const T inter_xmin = box1[0] > box2[0] ? box1[0] : box2[0];
+  const T inter_ymin = box1[1] > box2[1] ? box1[1] : box2[1];
+  const T inter_xmax = box1[2] < box2[2] ? box1[2] : box2[2];
+  const T inter_ymax = box1[3] < box2[3] ? box1[3] : box2[3];
+  T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
+  const T inter_area =
+      (inter_xmax - inter_xmin + norm) * (inter_ymax - inter_ymin + norm);
+  const T bbox1_area = MatrixNMSBBoxArea<T>(box1, normalized);
+  const T bbox2_area = MatrixNMSBBoxArea<T>(box2, normalized);
+  return inter_area / (bbox1_area + bbox2_area - inter_area);
+}
+
+template <typename T>
+__device__ inline T MatrixNMSDecayScore(T iou,
+                                        T max_iou,
+                                        bool use_gaussian,
+                                        float sigma) {
+  if (use_gaussian) {
+    return exp((max_iou * max_iou - iou * iou) * sigma);
+  }
+  return (1. - iou) / (1. - max_iou);
+}
+
+__global__ void MatrixNMSSegmentIotaKernel(int* values,
+                                           int64_t num,
+                                           int segment_size) {
+  CUDA_KERNEL_LOOP_TYPE(i, num, int64_t) { values[i] = i % segment_size; }
+}
+
+__global__ void MatrixNMSSegmentOffsetsKernel(int* offsets,
+                                              int num_segments,
+                                              int segment_size) {
+  CUDA_KERNEL_LOOP_TYPE(i, num_segments + 1, int64_t) {
+    offsets[i] = i * segment_size;
+  }
+}
+
+// A block per (image, class), which decays the top_k sorted scores over the
+// score_threshold of the class, the scores under the post_threshold being the
+// lowest.
+template <typename T>
+__global__ void MatrixNMSDecayKernel(const T* bboxes,
+                                     const T* sorted_scores,
+                                     const int* sorted_indices,
+                                     int num_classes,
+                                     int num_boxes,
+                                     int box_dim,
+                                     int top_k,
+                                     int background_label,
+                                     T score_threshold,
+                                     T post_threshold,
+                                     bool use_gaussian,
+                                     float sigma,
+                                     bool normalized,
+                                     T* iou_max,
+                                     T* decayed_scores,
+                                     int* decayed_indices) {
+  const int seg = blockIdx.x;
+  const int n = seg / num_classes;
+  const int c = seg % num_classes;
+  const T* scores = sorted_scores + static_cast<int64_t>(seg) * num_boxes;
+  const int* perm = sorted_indices + static_cast<int64_t>(seg) * num_boxes;
+  const T* boxes = bboxes + static_cast<int64_t>(n) * num_boxes * box_dim;
+  T* seg_iou_max = iou_max + static_cast<int64_t>(seg) * top_k;
+  T* seg_decayed_scores = decayed_scores + static_cast<int64_t>(seg) * top_k;
+  int* seg_decayed_indices =
+      decayed_indices + static_cast<int64_t>(seg) * top_k;
+
+  // The scores are sorted, so the count of the top_k over the threshold is
+  // the number of the boxes to decay.
+  __shared__ int num_pre;
+  if (threadIdx.x == 0) num_pre = 0;
+  __syncthreads();
+  int count = 0;
+  if (c != background_label) {
+    for (int i = threadIdx.x; i < top_k; i += blockDim.x) {
+      if (scores[i] > score_threshold) ++count;
+    }
+  }
+  atomicAdd(&num_pre, count);
+  __syncthreads();
+
+  for (int i = threadIdx.x; i < num_pre; i += blockDim.x) {
+    T max_iou = 0.;
+    for (int j = 0; j < i; ++j) {
+      T iou = MatrixNMSJaccardOverlap<T>(
+          boxes + perm[i] * box_dim, boxes + perm[j] * box_dim, normalized);
+      max_iou = iou > max_iou ? iou : max_iou;
+    }
+    seg_iou_max[i] = max_iou;
+  }
+  __syncthreads();
+
+  for (int i = threadIdx.x; i < top_k; i += blockDim.x) {
+    T decayed_score = std::numeric_limits<T>::lowest();
+    if (i < num_pre) {
+      T min_decay = 1.;
+      for (int j = 0; j < i; ++j) {
+        T iou = MatrixNMSJaccardOverlap<T>(
+            boxes + perm[i] * box_dim, boxes + perm[j] * box_dim, normalized);
+        T decay =
+            MatrixNMSDecayScore<T>(iou, seg_iou_max[j], use_gaussian, sigma);
+        min_decay = decay < min_decay ? decay : min_decay;
+      }
+      T score = min_decay * scores[i];
+      if (score > post_threshold) decayed_score = score;
+    }
+    seg_decayed_scores[i] = decayed_score;
+    seg_decayed_indices[i] = perm[i];
+  }
+}
+
+// A block per image, the number of the kept detections of the image.
+template <typename T>
+__global__ void MatrixNMSKeepCountKernel(const T* sorted_scores,
+                                         int num_candidates,
+                                         int keep_top_k,
+                                         int* roisnum) {
+  const T* scores =
+      sorted_scores + static_cast<int64_t>(blockIdx.x) * num_candidates;
+  int num_keep = keep_top_k > -1 && keep_top_k < num_candidates
+                     ? keep_top_k
+                     : num_candidates;
+  __shared__ int num_det;
+  if (threadIdx.x == 0) num_det = 0;
+  __syncthreads();
+  int count = 0;
+  for (int i = threadIdx.x; i < num_keep; i += blockDim.x) {
+    if (scores[i] > std::numeric_limits<T>::lowest()) ++count;
+  }
+  atomicAdd(&num_det, count);
+  __syncthreads();
+  if (threadIdx.x == 0) roisnum[blockIdx.x] = num_det;
+}
+
+// A block per image, writes the [label, score, box] and the index of the
+// kept detections of the image from its offset.
+template <typename T>
+__global__ void MatrixNMSGatherKernel(const T* bboxes,
+                                      const T* sorted_scores,
+                                      const int* sorted_candidates,
+                                      const int* decayed_indices,
+                                      const int* roisnum,
+                                      const int* offsets,
+                                      int num_classes,
+                                      int num_boxes,
+                                      int box_dim,
+                                      int top_k,
+                                      T* out,
+                                      int* index) {
+  const int n = blockIdx.x;
+  const int64_t num_candidates = static_cast<int64_t>(num_classes) * top_k;
+  const T* scores = sorted_scores + n * num_candidates;
+  const int* candidates = sorted_candidates + n * num_candidates;
+  const int* indices = decayed_indices + n * num_candidates;
+  for (int k = threadIdx.x; k < roisnum[n]; k += blockDim.x) {
+    int candidate = candidates[k];
+    int box = indices[candidate];
+    int64_t row = offsets[n] + k;
+    T* out_row = out + row * (box_dim + 2);
+    out_row[0] = static_cast<T>(candidate / top_k);
+    out_row[1] = scores[k];
+    const T* bbox =
+        bboxes + (static_cast<int64_t>(n) * num_boxes + box) * box_dim;
+    for (int j = 0; j < box_dim; ++j) {
+      out_row[j + 2] = bbox[j];
+    }
+    index[row] = n * num_boxes + box;
+  }
+}
+
+template <typename T, typename Context>
+static void SortPairsDescendingBySegment(const Context& ctx,
+                                         const T* keys_in,
+                                         T* keys_out,
+                                         int num_segments,
+                                         int segment_size,
+                                         DenseTensor* values_out) {
+  const int64_t num_items =
+      static_cast<int64_t>(num_segments) * segment_size;
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(ctx, num_items);
+
+  DenseTensor values_in;
+  values_in.Resize({num_items});
+  int* values_in_data = ctx.template Alloc<int>(&values_in);
+  MatrixNMSSegmentIotaKernel<<<config.block_per_grid,
+                               config.thread_per_block,
+                               0,
+                               ctx.stream()>>>(
+      values_in_data, num_items, segment_size);
+  values_out->Resize({num_items});
+  int* values_out_data = ctx.template Alloc<int>(values_out);
+
+  DenseTensor offsets;
+  offsets.Resize({num_segments + 1});
+  int* offsets_data = ctx.template Alloc<int>(&offsets);
+  auto offsets_config =
+      phi::backends::gpu::GetGpuLaunchConfig1D(ctx, num_segments + 1);
+  MatrixNMSSegmentOffsetsKernel<<<offsets_config.block_per_grid,
+                                  offsets_config.thread_per_block,
+                                  0,
+                                  ctx.stream()>>>(
+      offsets_data, num_segments, segment_size);
+
+  size_t temp_storage_bytes = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cub::DeviceSegmentedRadixSort::SortPairsDescending(nullptr,
+                                                         temp_storage_bytes,
+                                                         keys_in,
+                                                         keys_out,
+                                                         values_in_data,
+                                                         values_out_data,
+                                                         num_items,
+                                                         num_segments,
+                                                         offsets_data,
+                                                         offsets_data + 1,
+                                                         0,
+                                                         sizeof(T) * 8,
+                                                         ctx.stream()));
+  DenseTensor temp_storage;
+  temp_storage.Resize({static_cast<int64_t>(temp_storage_bytes)});
+  uint8_t* temp_storage_data = ctx.template Alloc<uint8_t>(&temp_storage);
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cub::DeviceSegmentedRadixSort::SortPairsDescending(temp_storage_data,
+                                                         temp_storage_bytes,
+                                                         keys_in,
+                                                         keys_out,
+                                                         values_in_data,
+                                                         values_out_data,
+                                                         num_items,
+                                                         num_segments,
+                                                         offsets_data,
+                                                         offsets_data + 1,
+                                                         0,
+                                                         sizeof(T) * 8,
+                                                         ctx.stream()));
+}
+
+template <typename T, typename Context>
+void MatrixNMSKernel(const Context& ctx,
+                     const DenseTensor& bboxes,
+                     const DenseTensor& scores,
+                     float score_threshold,
+                     int nms_top_k,
+                     int keep_top_k,
+                     float post_threshold,
+                     bool use_gaussian,
+                     float gaussian_sigma,
+                     int background_label,
+                     bool normalized,
+                     DenseTensor* out,
+                     DenseTensor* index,
+                     DenseTensor* roisnum) {
+  const int batch_size = scores.dims()[0];
+  const int num_classes = scores.dims()[1];
+  const int num_boxes = scores.dims()[2];
+  const int box_dim = bboxes.dims()[2];
+  const int out_dim = box_dim + 2;
+  const int top_k =
+      nms_top_k > -1 && nms_top_k < num_boxes ? nms_top_k : num_boxes;
+  const int num_segments = batch_size * num_classes;
+  const int num_candidates = num_classes * top_k;
+
+  DenseTensor keep_count;
+  if (roisnum == nullptr) {
+    roisnum = &keep_count;
+  }
+  roisnum->Resize({batch_size});
+  int* roisnum_data = ctx.template Alloc<int>(roisnum);
+
+  if (batch_size == 0 || num_candidates == 0) {
+    std::vector<int> zeros(batch_size, 0);
+    phi::TensorFromVector(zeros, ctx, roisnum);
+    out->Resize({0, out_dim});
+    ctx.template Alloc<T>(out);
+    index->Resize({0, 1});
+    ctx.template Alloc<int>(index);
+    return;
+  }
+
+  // 1. Sort the scores of every (image, class).
+  DenseTensor sorted_scores;
+  sorted_scores.Resize({static_cast<int64_t>(num_segments) * num_boxes});
+  T* sorted_scores_data = ctx.template Alloc<T>(&sorted_scores);
+  DenseTensor sorted_indices;
+  SortPairsDescendingBySegment<T, Context>(ctx,
+                                           scores.data<T>(),
+                                           sorted_scores_data,
+                                           num_segments,
+                                           num_boxes,
+                                           &sorted_indices);
+
+  // 2. Decay the top_k scores of every (image, class).
+  DenseTensor iou_max, decayed_scores, decayed_indices;
+  iou_max.Resize({static_cast<int64_t>(num_segments) * top_k});
+  decayed_scores.Resize({static_cast<int64_t>(num_segments) * top_k});
+  decayed_indices.Resize({static_cast<int64_t>(num_segments) * top_k});
+  MatrixNMSDecayKernel<T>
+      <<<num_segments, kMatrixNMSThreads, 0, ctx.stream()>>>(
+          bboxes.data<T>(),
+          sorted_scores_data,
+          sorted_indices.data<int>(),
+          num_classes,
+          num_boxes,
+          box_dim,
+          top_k,
+          background_label,
+          static_cast<T>(score_threshold),
+          static_cast<T>(post_threshold),
+          use_gaussian,
+          gaussian_sigma,
+          normalized,
+          ctx.template Alloc<T>(&iou_max),
+          ctx.template Alloc<T>(&decayed_scores),
+          ctx.template Alloc<int>(&decayed_indices));
+
+  // 3. Sort the decayed scores of all the classes of every image, and keep
+  // the keep_top_k of them.
+  DenseTensor sorted_decayed_scores;
+  sorted_decayed_scores.Resize({static_cast<int64_t>(num_segments) * top_k});
+  T* sorted_decayed_scores_data =
+      ctx.template Alloc<T>(&sorted_decayed_scores);
+  DenseTensor sorted_candidates;
+  SortPairsDescendingBySegment<T, Context>(ctx,
+                                           decayed_scores.data<T>(),
+                                           sorted_decayed_scores_data,
+                                           batch_size,
+                                           num_candidates,
+                                           &sorted_candidates);
+  MatrixNMSKeepCountKernel<T>
+      <<<batch_size, kMatrixNMSThreads, 0, ctx.stream()>>>(
+          sorted_decayed_scores_data, num_candidates, keep_top_k, roisnum_data);
+
+  // 4. The number of the detections sizes the outputs, which is the only
+  // copy to the host.
+  std::vector<int> num_per_batch;
+  phi::TensorToVector(*roisnum, ctx, &num_per_batch);
+  std::vector<int> offsets(batch_size + 1, 0);
+  for (int i = 0; i < batch_size; ++i) {
+    offsets[i + 1] = offsets[i] + num_per_batch[i];
+  }
+  const int64_t num_kept = offsets.back();
+  out->Resize({num_kept, out_dim});
+  T* out_data = ctx.template Alloc<T>(out);
+  index->Resize({num_kept, 1});
+  int* index_data = ctx.template Alloc<int>(index);
+  if (num_kept == 0) return;
+
+  DenseTensor offsets_tensor;
+  phi::TensorFromVector(offsets, ctx, &offsets_tensor);
+  MatrixNMSGatherKernel<T><<<batch_size, kMatrixNMSThreads, 0, ctx.stream()>>>(
+      bboxes.data<T>(),
+      sorted_decayed_scores_data,
+      sorted_candidates.data<int>(),
+      decayed_indices.data<int>(),
+      roisnum_data,
+      offsets_tensor.data<int>(),
+      num_classes,
+      num_boxes,
+      box_dim,
+      top_k,
+      out_data,
+      index_data);
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(matrix_nms,  // cuda_only
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::MatrixNMSKernel,
+                   float,
+                   double) {
+  kernel->OutputAt(1).SetDataType(phi::DataType::INT32);
+  kernel->OutputAt(2).SetDataType(phi::DataType::INT32);
+}
+
+#endif
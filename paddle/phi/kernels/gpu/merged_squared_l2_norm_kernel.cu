@@ -0,0 +1,155 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/merged_squared_l2_norm_kernel.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/full_kernel.h"
+#include "paddle/phi/kernels/funcs/aligned_vector.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+#include "paddle/phi/kernels/funcs/multi_tensor_apply.h"
+#include "paddle/phi/kernels/funcs/reduce_function.h"
+
+namespace phi {
+
+// Each block sums the squares of a chunk of a tensor, and stores the partial
+// sum by the index of the chunk among all the chunks, so that the partial sums
+// are reduced in a deterministic order.
+template <typename T,
+          typename MT,
+          int VecSize,
+          int MaxTensorSize,
+          int MaxBlockSize>
+struct MergedSquaredL2NormFunctor {
+  __device__ __forceinline__ void operator()(
+      int chunk_size,
+      const funcs::TensorAndBlockInfo<1, MaxTensorSize, MaxBlockSize>& t_info,
+      MT* partial_sums) const {
+    int chunk_id, tensor_id;
+    t_info.GetChunkIdAndTensorId(&chunk_id, &tensor_id);
+    int offset = chunk_id * chunk_size;
+    const T* __restrict__ x_ptr =
+        static_cast<const T*>(t_info.grads[tensor_id]) + offset;
+    int n = min(t_info.sizes[tensor_id] - offset, chunk_size);
+
+    MT sum = static_cast<MT>(0);
+    int vec_n = n / VecSize * VecSize;
+    for (int idx = threadIdx.x * VecSize; idx < vec_n;
+         idx += blockDim.x * VecSize) {
+      phi::AlignedVector<T, VecSize> x_vec;
+      phi::Load<T, VecSize>(x_ptr + idx, &x_vec);
+#pragma unroll
+      for (int i = 0; i < VecSize; ++i) {
+        MT value = static_cast<MT>(x_vec[i]);
+        sum += value * value;
+      }
+    }
+    for (int idx = vec_n + threadIdx.x; idx < n; idx += blockDim.x) {
+      MT value = static_cast<MT>(x_ptr[idx]);
+      sum += value * value;
+    }
+    sum = phi::funcs::BlockReduceSum<MT>(sum, FINAL_MASK);
+    if (threadIdx.x == 0) {
+      partial_sums[t_info.block_offset + blockIdx.x] = sum;
+    }
+  }
+};
+
+template <typename T, typename Context>
+void MergedSquaredL2NormKernel(const Context& dev_ctx,
+                               const std::vector<const DenseTensor*>& x,
+                               DenseTensor* out) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  constexpr int kMaxTensorSize = 110;
+  constexpr int kMaxBlockSize = 320;
+  constexpr int kBlockSize = 512;
+  constexpr int kChunkSize = 65536;
+
+  // the launches do not handle the tensors without chunks
+  std::vector<const DenseTensor*> tensors;
+  tensors.reserve(x.size());
+  int64_t chunk_num = 0;
+  int vec_size = 4;
+  for (const auto* t : x) {
+    if (t->numel() > 0) {
+      tensors.push_back(t);
+      chunk_num += (t->numel() + kChunkSize - 1) / kChunkSize;
+      vec_size = std::min(vec_size, phi::GetVectorizedSize(t->data<T>()));
+    }
+  }
+  if (tensors.empty()) {
+    phi::FullKernel<MT, Context>(
+        dev_ctx, std::vector<int64_t>(), static_cast<MT>(0), out->dtype(), out);
+    return;
+  }
+
+  DenseTensor partial_sums;
+  partial_sums.Resize({chunk_num});
+  MT* partial_sums_ptr = dev_ctx.template Alloc<MT>(&partial_sums);
+  std::vector<std::vector<DenseTensor*>> input_vector;
+
+#define PD_LAUNCH_MERGED_SQUARED_L2_NORM_KERNEL(__vec_size)                   \
+  case __vec_size: {                                                          \
+    MergedSquaredL2NormFunctor<T,                                             \
+                               MT,                                            \
+                               __vec_size,                                    \
+                               kMaxTensorSize,                                \
+                               kMaxBlockSize>                                 \
+        functor;                                                              \
+    funcs::LaunchMultiTensorApplyKernel<1, kMaxTensorSize, kMaxBlockSize>(    \
+        dev_ctx,                                                              \
+        kBlockSize,                                                           \
+        kChunkSize,                                                           \
+        input_vector,                                                         \
+        tensors,                                                              \
+        functor,                                                              \
+        partial_sums_ptr);                                                    \
+  } break
+
+  switch (vec_size) {
+    PD_LAUNCH_MERGED_SQUARED_L2_NORM_KERNEL(4);
+    PD_LAUNCH_MERGED_SQUARED_L2_NORM_KERNEL(2);
+    PD_LAUNCH_MERGED_SQUARED_L2_NORM_KERNEL(1);
+    default:
+      PADDLE_THROW(
+          errors::InvalidArgument("Unsupported vectorized size %d", vec_size));
+      break;
+  }
+#undef PD_LAUNCH_MERGED_SQUARED_L2_NORM_KERNEL
+
+  out->Resize(common::make_ddim({}));
+  phi::funcs::ReduceKernel<MT, MT, kps::AddFunctor, kps::IdentityFunctor<MT>>(
+      dev_ctx, partial_sums, out, kps::IdentityFunctor<MT>(), {0});
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(merged_squared_l2_norm,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::MergedSquaredL2NormKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  if (kernel_key.dtype() == phi::DataType::FLOAT16 ||
+      kernel_key.dtype() == phi::DataType::BFLOAT16) {
+    kernel->OutputAt(0).SetDataType(phi::DataType::FLOAT32);
+  }
+}
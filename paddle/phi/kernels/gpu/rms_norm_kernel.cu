@@ -175,6 +175,15 @@ typename std::enable_if<HasCanPackAs<T>::value == false, bool>::type CanPackAs(
   return true;
 }
 
+// The stores quantizing every row by its abs max, which take the normalized
+// row twice, first by Affine to reduce the abs max and then by store.
+template <typename T, typename = void>
+struct IsPerTokenQuantStore : std::false_type {};
+
+template <typename T>
+struct IsPerTokenQuantStore<T, std::void_t<decltype(T::kPerTokenQuant)>>
+    : std::true_type {};
+
 template <typename T, int N>
 struct alignas(sizeof(T) * N) Pack {
   __device__ Pack() = default;
@@ -419,14 +428,46 @@ __global__ void __launch_bounds__(block_size)
     ComputeType row_rms = row_sum_square * col_divisor;
     ComputeType row_inv_rms =
         Rsqrt(row_rms + static_cast<ComputeType>(epsilon));
-    for (int pack_id = tid; pack_id < num_packs; pack_id += block_size) {
-      ComputeType pack[kPackSize];
+    if constexpr (IsPerTokenQuantStore<STORE>::value) {
+      // The row is scaled by its abs max after the affine, which is computed
+      // again in the store pass instead of taking more shared memory.
+      ComputeType thread_abs_max = 0;
+      for (int pack_id = tid; pack_id < num_packs; pack_id += block_size) {
+        ComputeType pack[kPackSize];
 #pragma unroll
-      for (int i = 0; i < kPackSize; ++i) {
-        pack[i] = static_cast<ComputeType>(buf[i * num_packs + pack_id]) *
-                  row_inv_rms;
+        for (int i = 0; i < kPackSize; ++i) {
+          pack[i] = static_cast<ComputeType>(buf[i * num_packs + pack_id]) *
+                    row_inv_rms;
+        }
+        store.template Affine<kPackSize>(pack, pack_id * kPackSize);
+#pragma unroll
+        for (int i = 0; i < kPackSize; ++i) {
+          thread_abs_max = max(thread_abs_max, abs(pack[i]));
+        }
+      }
+      const ComputeType row_abs_max =
+          BlockAllReduce<MaxOp, ComputeType, block_size>(thread_abs_max);
+      for (int pack_id = tid; pack_id < num_packs; pack_id += block_size) {
+        ComputeType pack[kPackSize];
+#pragma unroll
+        for (int i = 0; i < kPackSize; ++i) {
+          pack[i] = static_cast<ComputeType>(buf[i * num_packs + pack_id]) *
+                    row_inv_rms;
+        }
+        store.template Affine<kPackSize>(pack, pack_id * kPackSize);
+        store.template store<kPackSize>(
+            pack, row, pack_id * kPackSize, row_abs_max);
+      }
+    } else {
+      for (int pack_id = tid; pack_id < num_packs; pack_id += block_size) {
+        ComputeType pack[kPackSize];
+#pragma unroll
+        for (int i = 0; i < kPackSize; ++i) {
+          pack[i] = static_cast<ComputeType>(buf[i * num_packs + pack_id]) *
+                    row_inv_rms;
+        }
+        store.template store<kPackSize>(pack, row, pack_id * kPackSize);
       }
-      store.template store<kPackSize>(pack, row, pack_id * kPackSize);
     }
   }
 }
@@ -930,6 +971,87 @@ struct AffineQuantStore {
   const float quant_min_bound;
 };
 
+// ======== For Per Token Int8 Output ========
+// Quantizes every row by its abs max after the affine, and outputs the scale of
+// the row to dequantize it, i.e. abs_max / quant_max_bound.
+template <typename OutType, typename SRC, typename DST>
+struct AffinePerTokenQuantStore {
+  static constexpr bool kPerTokenQuant = true;
+
+  AffinePerTokenQuantStore(OutType* y,
+                           float* y_scale,
+                           const int64_t row_size,
+                           const DST* gamma,
+                           const DST* beta,
+                           const int quant_round_type = 1,
+                           const float quant_max_bound = 127.0,
+                           const float quant_min_bound = -127.0)
+      : y(y),
+        y_scale(y_scale),
+        row_size(row_size),
+        gamma(gamma),
+        beta(beta),
+        quant_round_type(quant_round_type),
+        quant_max_bound(quant_max_bound),
+        quant_min_bound(quant_min_bound) {}
+
+  template <int N>
+  __device__ void Affine(SRC* src, int64_t col) const {
+    Pack<DST, N> gamma_pack;
+    Pack<DST, N> beta_pack;
+    const int64_t gamma_offset = col / N;
+    gamma_pack = *(reinterpret_cast<const Pack<DST, N>*>(gamma) + gamma_offset);
+    if (beta) {
+      beta_pack = *(reinterpret_cast<const Pack<DST, N>*>(beta) + gamma_offset);
+    } else {
+#pragma unroll
+      for (int i = 0; i < N; i++) {
+        beta_pack.elem[i] = static_cast<DST>(0.0f);
+      }
+    }
+#pragma unroll
+    for (int i = 0; i < N; ++i) {
+      src[i] = static_cast<SRC>(static_cast<float>(src[i]) *
+                                    static_cast<float>(gamma_pack.elem[i]) +
+                                static_cast<float>(beta_pack.elem[i]));
+    }
+  }
+
+  template <int N>
+  __device__ void store(const SRC* src,
+                        int64_t row,
+                        int64_t col,
+                        SRC row_abs_max) {
+    Pack<OutType, N> y_pack;
+    const int64_t offset = (row * row_size + col) / N;
+    const float abs_max = static_cast<float>(row_abs_max);
+    // a row of zeros is quantized to zeros by the scale 0
+    const float quant_scale = abs_max > 0.0f ? 1.0f / abs_max : 0.0f;
+#pragma unroll
+    for (int i = 0; i < N; ++i) {
+      y_pack.elem[i] =
+          QuantHelperFunc<float, OutType>(static_cast<float>(src[i]),
+                                          quant_scale,
+                                          quant_round_type,
+                                          quant_max_bound,
+                                          quant_min_bound);
+    }
+    *(reinterpret_cast<Pack<OutType, N>*>(y) + offset) = y_pack;
+    if (col == 0) {
+      y_scale[row] = abs_max / quant_max_bound;
+    }
+  }
+
+  OutType* y;
+  float* y_scale;
+  int64_t row_size;
+  const DST* gamma;
+  const DST* beta;
+  const int quant_round_type;
+  const float quant_max_bound;
+  const float quant_min_bound;
+};
+
 #endif
 
 }  // namespace
@@ -1026,6 +1148,67 @@ void RmsNormKernel(const Context& dev_ctx,
 #endif
 }
 
+template <typename T, typename Context>
+void FusedRmsNormQuantKernel(const Context& dev_ctx,
+                             const DenseTensor& x,
+                             const paddle::optional<DenseTensor>& bias,
+                             const paddle::optional<DenseTensor>& residual,
+                             const DenseTensor& norm_weight,
+                             const paddle::optional<DenseTensor>& norm_bias,
+                             const float epsilon,
+                             const int begin_norm_axis,
+                             const int quant_round_type,
+                             const float quant_max_bound,
+                             const float quant_min_bound,
+                             DenseTensor* out,
+                             DenseTensor* residual_out,
+                             DenseTensor* out_scale) {
+#if defined(PADDLE_WITH_HIP)
+  LOG(ERROR) << "Please compile with CUDA, ROCM platform isn't support it";
+#else
+  using ComputeType = typename phi::dtype::MPTypeTrait<T>::Type;
+
+  const T* x_data = x.data<T>();
+  const T* norm_weight_data = norm_weight.data<T>();
+  const T* norm_bias_data = norm_bias ? norm_bias.get().data<T>() : nullptr;
+
+  int32_t rows = 1;
+  int32_t cols = 1;
+  for (int i = 0; i < begin_norm_axis; i++) {
+    rows *= x.dims()[i];
+  }
+
+  for (int i = begin_norm_axis; i < x.dims().size(); i++) {
+    cols *= x.dims()[i];
+  }
+
+  int8_t* out_data = dev_ctx.template Alloc<int8_t>(out);
+  float* out_scale_data = dev_ctx.template Alloc<float>(out_scale);
+  AffinePerTokenQuantStore<int8_t, ComputeType, T> store(out_data,
+                                                         out_scale_data,
+                                                         cols,
+                                                         norm_weight_data,
+                                                         norm_bias_data,
+                                                         quant_round_type,
+                                                         quant_max_bound,
+                                                         quant_min_bound);
+  if (residual) {
+    // Do RMSNorm(bias_add + residual + x)
+    T* residual_out_data = dev_ctx.template Alloc<T>(residual_out);
+    const T* residual_data = residual.get().data<T>();
+    const T* bias_data = bias ? bias.get().data<T>() : nullptr;
+    ResidualAddBiasLoad<T, ComputeType> load(
+        x_data, residual_data, bias_data, residual_out_data, cols);
+    DispatchRmsNorm<decltype(load), decltype(store), ComputeType>(
+        dev_ctx.stream(), load, store, rows, cols, epsilon);
+  } else {
+    DirectLoad<T, ComputeType> load(x_data, cols);
+    DispatchRmsNorm<decltype(load), decltype(store), ComputeType>(
+        dev_ctx.stream(), load, store, rows, cols, epsilon);
+  }
+#endif
+}
+
 }  // namespace phi
 
 PD_REGISTER_KERNEL(rms_norm,
@@ -1035,3 +1218,14 @@ PD_REGISTER_KERNEL(rms_norm,
                    float,
                    phi::dtype::float16,
                    phi::dtype::bfloat16) {}
+
+PD_REGISTER_KERNEL(fused_rms_norm_quant,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::FusedRmsNormQuantKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::INT8);
+  kernel->OutputAt(2).SetDataType(phi::DataType::FLOAT32);
+}
@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include "paddle/phi/backends/gpu/gpu_dnn.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/dense_tensor.h"
@@ -31,6 +34,11 @@ using gpuDnnHandle_t = cudnnHandle_t;
 using gpuDnnDataType_t = cudnnDataType_t;
 #endif
 
+#if defined(PADDLE_WITH_CUDA) && CUDNN_VERSION >= 6000
+// The max hidden size to try the persistent rnn of cudnn
+constexpr int kMaxPersistRNNHiddenSize = 512;
+#endif
+
 class RNNDescriptors {
  public:
   RNNDescriptors(int seq_length,
@@ -149,17 +157,45 @@ class RNNDescriptors {
         miopenRNNdefault,
         cudnn_type));
 #elif CUDNN_VERSION >= 6000
-    PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cudnnSetRNNDescriptor_v6(
-        handle,
-        rnn_desc_.desc(),
-        hidden_size_,
-        num_layers_,
-        dropout_desc_.desc(),
-        CUDNN_LINEAR_INPUT,
-        is_bidirec_ ? CUDNN_BIDIRECTIONAL : CUDNN_UNIDIRECTIONAL,
-        mode_,
-        CUDNN_RNN_ALGO_STANDARD,
-        cudnn_type));
+    auto set_rnn_descriptor = [&](cudnnRNNAlgo_t algo) {
+      PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cudnnSetRNNDescriptor_v6(
+          handle,
+          rnn_desc_.desc(),
+          hidden_size_,
+          num_layers_,
+          dropout_desc_.desc(),
+          CUDNN_LINEAR_INPUT,
+          is_bidirec_ ? CUDNN_BIDIRECTIONAL : CUDNN_UNIDIRECTIONAL,
+          mode_,
+          algo,
+          cudnn_type));
+    };
+    // The persistent kernels keep the recurrent weights on chip during all
+    // the steps, which are much faster for the small hidden sizes. They are
+    // only tried in the inference of the unpadded inputs, and cudnn reports
+    // the unsupported shapes when the workspace is queried.
+    bool use_persist_algo = is_test_ && sequence_length.empty() &&
+                            !std::is_same<T, double>::value &&
+                            hidden_size_ <= kMaxPersistRNNHiddenSize &&
+                            phi::backends::gpu::GetGPUComputeCapability(
+                                dev_ctx.GetPlace().GetDeviceId()) >= 60;
+    if (use_persist_algo) {
+      set_rnn_descriptor(CUDNN_RNN_ALGO_PERSIST_STATIC);
+      size_t probe_workspace_size;
+      if (phi::dynload::cudnnGetRNNWorkspaceSize(handle,
+                                                 rnn_desc_.desc(),
+                                                 seq_length_,
+                                                 x_descs_.data(),
+                                                 &probe_workspace_size) !=
+          CUDNN_STATUS_SUCCESS) {
+        VLOG(3) << "The persistent rnn is not supported, hidden_size: "
+                << hidden_size_ << ", batch_size: " << batch_size_;
+        use_persist_algo = false;
+      }
+    }
+    if (!use_persist_algo) {
+      set_rnn_descriptor(CUDNN_RNN_ALGO_STANDARD);
+    }
 #else
     PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cudnnSetRNNDescriptor(
         rnn_desc_.desc(),
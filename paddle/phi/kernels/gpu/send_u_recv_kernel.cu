@@ -22,11 +22,14 @@
 #include <vector>
 
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/flags.h"
 #include "paddle/phi/core/hostdevice.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 #include "paddle/phi/kernels/gpu/graph_send_recv_funcs.h"
 
+PHI_DECLARE_bool(graph_send_recv_sorted_reduce);
+
 namespace phi {
 
 template <typename Context, typename T, typename IndexT>
@@ -80,6 +83,22 @@ void GraphSendRecvOpCUDAKernelLaunchHelper(const Context& ctx,
   const IndexT* s_index = src_index.data<IndexT>();
   const IndexT* d_index = dst_index.data<IndexT>();
 
+  if (FLAGS_graph_send_recv_sorted_reduce) {
+    GraphSendRecvCopyMessageFunctor<T, IndexT> mfunctor{p_src, slice_size};
+    GraphSendRecvSortedReduce<Context, T, IndexT>(
+        ctx,
+        s_index,
+        d_index,
+        index_size,
+        out_size <= 0 ? src_dims[0] : out_size,
+        slice_size,
+        reduce_op,
+        mfunctor,
+        p_output,
+        dst_count);
+    return;
+  }
+
   int block = 1024;
   int64_t n = slice_size * index_size;
   int64_t max_grid_dimx = ctx.GetCUDAMaxGridDimSize()[0];
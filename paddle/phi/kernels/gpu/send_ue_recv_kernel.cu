@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/flags.h"
 #include "paddle/phi/core/hostdevice.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/elementwise_functor.h"
@@ -29,6 +30,8 @@
 #include "paddle/phi/kernels/gpu/graph_send_ue_recv_funcs.h"
 #include "paddle/phi/kernels/impl/graph_message_passing_impl.h"
 
+PHI_DECLARE_bool(graph_send_recv_sorted_reduce);
+
 namespace phi {
 
 template <typename Context, typename T, typename IndexT>
@@ -84,6 +87,55 @@ void GraphSendUERecvOpCUDAKernelLaunchHelper(const Context& ctx,
   }
 
   int64_t out_len = bcast_info.out_len;
+  if (FLAGS_graph_send_recv_sorted_reduce) {
+    const int64_t* x_bcastoff_data =
+        thrust::raw_pointer_cast(x_bcastoff.data());
+    const int64_t* e_bcastoff_data =
+        thrust::raw_pointer_cast(e_bcastoff.data());
+    if (message_op == "ADD") {
+      GraphSendUERecvMessageFunctor<T, IndexT, funcs::AddFunctor<T>> mfunctor{
+          x_data,
+          e_data,
+          x_bcastoff_data,
+          e_bcastoff_data,
+          bcast_info.l_len,
+          bcast_info.r_len,
+          bcast_info.use_bcast,
+          funcs::AddFunctor<T>()};
+      GraphSendRecvSortedReduce<Context, T, IndexT>(ctx,
+                                                    s_index,
+                                                    d_index,
+                                                    index_size,
+                                                    dims_[0],
+                                                    out_len,
+                                                    reduce_op,
+                                                    mfunctor,
+                                                    out_data,
+                                                    dst_count);
+    } else if (message_op == "MUL") {
+      GraphSendUERecvMessageFunctor<T, IndexT, funcs::MultiplyFunctor<T>>
+          mfunctor{x_data,
+                   e_data,
+                   x_bcastoff_data,
+                   e_bcastoff_data,
+                   bcast_info.l_len,
+                   bcast_info.r_len,
+                   bcast_info.use_bcast,
+                   funcs::MultiplyFunctor<T>()};
+      GraphSendRecvSortedReduce<Context, T, IndexT>(ctx,
+                                                    s_index,
+                                                    d_index,
+                                                    index_size,
+                                                    dims_[0],
+                                                    out_len,
+                                                    reduce_op,
+                                                    mfunctor,
+                                                    out_data,
+                                                    dst_count);
+    }
+    return;
+  }
+
   const int ntx = FindNumThreads(out_len, ctx.GetMaxThreadsPerBlock());
   const int nty = ctx.GetMaxThreadsPerBlock() / ntx;
   const int nbx = (out_len + ntx - 1) / ntx;
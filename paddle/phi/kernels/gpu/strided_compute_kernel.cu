@@ -0,0 +1,250 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The strided kernels of the binary elementwise and reduce ops, which read the
+// inputs not contiguous, e.g. the views by transpose or slice, through their
+// strides by the broadcast and reduce engines, instead of the contiguous copy
+// made by PrepareData before the kernels of ALL_LAYOUT.
+
+#include <limits>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/flags.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/visit_type.h"
+#include "paddle/phi/kernels/contiguous_kernel.h"
+#include "paddle/phi/kernels/elementwise_add_kernel.h"
+#include "paddle/phi/kernels/elementwise_divide_kernel.h"
+#include "paddle/phi/kernels/elementwise_multiply_kernel.h"
+#include "paddle/phi/kernels/elementwise_subtract_kernel.h"
+#include "paddle/phi/kernels/funcs/broadcast_function.h"
+#include "paddle/phi/kernels/reduce_max_kernel.h"
+#include "paddle/phi/kernels/reduce_mean_kernel.h"
+#include "paddle/phi/kernels/reduce_min_kernel.h"
+#include "paddle/phi/kernels/reduce_sum_kernel.h"
+
+PHI_DECLARE_bool(use_stride_kernel);
+
+namespace phi {
+
+namespace {
+
+void CheckStrideKernelEnabled(const char* op_type) {
+  PADDLE_ENFORCE_EQ(
+      FLAGS_use_stride_kernel,
+      true,
+      phi::errors::Fatal("FLAGS_use_stride_kernel is closed. Strided kernel "
+                         "be called, something wrong has happened in %s!",
+                         op_type));
+}
+
+// The output of a strided kernel keeps the strides set by the infer meta, so
+// it is reset to be contiguous.
+void SetContiguousMeta(DenseTensor* out) {
+  auto meta = out->meta();
+  meta.strides = meta.calc_strides(meta.dims);
+  meta.offset = 0;
+  out->set_meta(meta);
+}
+
+DenseTensor ContiguousOf(const GPUContext& dev_ctx, const DenseTensor& x) {
+  DenseTensor out;
+  out.set_meta(DenseTensorMeta(x.dtype(), x.dims(), x.layout()));
+  PD_VISIT_ALL_TYPES(x.dtype(), "ContiguousOf", ([&] {
+                       phi::ContiguousKernel<data_t, GPUContext>(
+                           dev_ctx, x, &out);
+                     }));
+  return out;
+}
+
+}  // namespace
+
+#define DEFINE_GPU_STRIDED_BINARY_KERNEL(name)                              \
+  template <typename T, typename Context>                                  \
+  void name##StridedKernel(const Context& dev_ctx,                         \
+                           const DenseTensor& x,                           \
+                           const DenseTensor& y,                           \
+                           DenseTensor* out) {                             \
+    CheckStrideKernelEnabled(#name);                                       \
+    SetContiguousMeta(out);                                                \
+    if (x.dtype() == y.dtype() &&                                          \
+        funcs::CanReadStridedInputs({&x, &y}, *out)) {                     \
+      phi::name##Kernel<T, Context>(dev_ctx, x, y, out);                   \
+      return;                                                              \
+    }                                                                      \
+    const DenseTensor& x_in =                                              \
+        x.meta().is_contiguous() ? x : ContiguousOf(dev_ctx, x);           \
+    const DenseTensor& y_in =                                              \
+        y.meta().is_contiguous() ? y : ContiguousOf(dev_ctx, y);           \
+    phi::name##Kernel<T, Context>(dev_ctx, x_in, y_in, out);               \
+  }
+
+DEFINE_GPU_STRIDED_BINARY_KERNEL(Add)
+DEFINE_GPU_STRIDED_BINARY_KERNEL(Subtract)
+DEFINE_GPU_STRIDED_BINARY_KERNEL(Multiply)
+DEFINE_GPU_STRIDED_BINARY_KERNEL(Divide)
+
+#undef DEFINE_GPU_STRIDED_BINARY_KERNEL
+
+template <typename T, typename Context>
+void SumStridedKernel(const Context& dev_ctx,
+                      const DenseTensor& x,
+                      const IntArray& dims,
+                      DataType out_dtype,
+                      bool keep_dim,
+                      DenseTensor* out) {
+  CheckStrideKernelEnabled("sum");
+  SetContiguousMeta(out);
+  // the cast to out_dtype and the eigen sum of the large tensors do not read
+  // the strides
+  if (x.meta().is_contiguous() ||
+      ((out_dtype == DataType::UNDEFINED || out_dtype == x.dtype()) &&
+       x.numel() <= std::numeric_limits<int32_t>::max())) {
+    phi::SumKernel<T, Context>(dev_ctx, x, dims, out_dtype, keep_dim, out);
+  } else {
+    phi::SumKernel<T, Context>(
+        dev_ctx, ContiguousOf(dev_ctx, x), dims, out_dtype, keep_dim, out);
+  }
+}
+
+#define DEFINE_GPU_STRIDED_REDUCE_KERNEL(name)                       \
+  template <typename T, typename Context>                           \
+  void name##StridedKernel(const Context& dev_ctx,                  \
+                           const DenseTensor& x,                    \
+                           const IntArray& dims,                    \
+                           bool keep_dim,                           \
+                           DenseTensor* out) {                      \
+    CheckStrideKernelEnabled(#name);                                \
+    SetContiguousMeta(out);                                         \
+    phi::name##Kernel<T, Context>(dev_ctx, x, dims, keep_dim, out); \
+  }
+
+DEFINE_GPU_STRIDED_REDUCE_KERNEL(Mean)
+DEFINE_GPU_STRIDED_REDUCE_KERNEL(Max)
+DEFINE_GPU_STRIDED_REDUCE_KERNEL(Min)
+
+#undef DEFINE_GPU_STRIDED_REDUCE_KERNEL
+
+}  // namespace phi
+
+using float16 = phi::dtype::float16;
+using bfloat16 = phi::dtype::bfloat16;
+using complex64 = ::phi::dtype::complex<float>;
+using complex128 = ::phi::dtype::complex<double>;
+
+PD_REGISTER_KERNEL(add,
+                   GPU,
+                   STRIDED,
+                   phi::AddStridedKernel,
+                   float,
+                   double,
+                   int16_t,
+                   int,
+                   int64_t,
+                   float16,
+                   bfloat16,
+                   complex64,
+                   complex128) {}
+
+PD_REGISTER_KERNEL(subtract,
+                   GPU,
+                   STRIDED,
+                   phi::SubtractStridedKernel,
+                   float,
+                   double,
+                   int16_t,
+                   int,
+                   int64_t,
+                   float16,
+                   bfloat16,
+                   complex64,
+                   complex128) {}
+
+PD_REGISTER_KERNEL(multiply,
+                   GPU,
+                   STRIDED,
+                   phi::MultiplyStridedKernel,
+                   float,
+                   double,
+                   int,
+                   int64_t,
+                   bool,
+                   float16,
+                   complex64,
+                   complex128,
+                   bfloat16) {}
+
+PD_REGISTER_KERNEL(divide,
+                   GPU,
+                   STRIDED,
+                   phi::DivideStridedKernel,
+                   float,
+                   double,
+                   int8_t,
+                   uint8_t,
+                   int16_t,
+                   int,
+                   int64_t,
+                   bool,
+                   float16,
+                   bfloat16,
+                   complex64,
+                   complex128) {}
+
+PD_REGISTER_KERNEL(sum,
+                   GPU,
+                   STRIDED,
+                   phi::SumStridedKernel,
+                   bool,
+                   float,
+                   double,
+                   float16,
+                   bfloat16,
+                   int16_t,
+                   int,
+                   int64_t,
+                   uint8_t,
+                   int8_t,
+                   complex64,
+                   complex128) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::UNDEFINED);
+}
+
+PD_REGISTER_KERNEL(mean,
+                   GPU,
+                   STRIDED,
+                   phi::MeanStridedKernel,
+                   float,
+                   double,
+                   bool,
+                   int,
+                   int64_t,
+                   float16,
+                   bfloat16,
+                   complex64,
+                   complex128) {}
+
+PD_REGISTER_KERNEL(max,
+                   GPU,
+                   STRIDED,
+                   phi::MaxStridedKernel,
+                   float,
+                   double,
+                   int,
+                   int64_t,
+                   float16,
+                   bfloat16) {}
+
+PD_REGISTER_KERNEL(
+    min, GPU, STRIDED, phi::MinStridedKernel, float, double, int, int64_t) {}
@@ -20,7 +20,6 @@
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
-#include "paddle/phi/kernels/funcs/gather.cu.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 #include "paddle/phi/kernels/funcs/top_k_function_cuda.h"
 
@@ -53,6 +52,10 @@ namespace phi {
   FIXED_MAXLENGTH_BASE(4, ##__VA_ARGS__); \
   FIXED_MAXLENGTH_BASE(5, ##__VA_ARGS__)
 
+// the least cols of the rows and k to select the top k by the radix select
+constexpr int64_t kRadixTopKMinCols = 1024;
+constexpr int kRadixTopKMinK = 16;
+
 template <typename T, typename Context>
 void TopkKernel(const Context& dev_ctx,
                 const DenseTensor& x,
@@ -126,40 +129,29 @@ void TopkKernel(const Context& dev_ctx,
     }
 
 #if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 9000
-    if (input_width >= 1024 && in_dims.size() == 1) {
+    // The radix select reads the rows a fixed number of passes by the bits of
+    // T, while the matrix kernel reads them k passes, so the latter is left
+    // for the small k of many rows.
+    if (input_width >= kRadixTopKMinCols && k > 0 &&
+        (input_height == 1 || k >= kRadixTopKMinK)) {
+      auto* ctx = reinterpret_cast<const phi::GPUContext*>(&dev_ctx);
       // 1. Gather TopK, but without sorting
-      constexpr int max_num_threads = 1024;
-      if (largest) {
-        phi::funcs::RadixTopK<T, true>
-            <<<input_height, max_num_threads, 0, dev_ctx.stream()>>>(
-                input_data,
-                k,
-                input_height,
-                input_width,
-                output_data,
-                indices_data);
-      } else {
-        phi::funcs::RadixTopK<T, false>
-            <<<input_height, max_num_threads, 0, dev_ctx.stream()>>>(
-                input_data,
-                k,
-                input_height,
-                input_width,
-                output_data,
-                indices_data);
-      }
+      phi::funcs::LaunchRadixTopK<T>(*ctx,
+                                     input_data,
+                                     input_height,
+                                     input_width,
+                                     k,
+                                     largest,
+                                     output_data,
+                                     indices_data);
       // 2. Sort if needed
       if (sorted) {
         DenseTensor sorted_output;
         DenseTensor sorted_indices;
-        DenseTensor gather_indices;
         sorted_output.Resize(out->dims());
         sorted_indices.Resize(indices->dims());
-        gather_indices.Resize(indices->dims());
         dev_ctx.template Alloc<T>(&sorted_output);
         dev_ctx.template Alloc<int64_t>(&sorted_indices);
-        dev_ctx.template Alloc<int64_t>(&gather_indices);
-        auto* ctx = reinterpret_cast<const phi::GPUContext*>(&dev_ctx);
         if (phi::funcs::SortTopk<T>(*ctx,
                                     out,
                                     k,
@@ -167,10 +159,9 @@ void TopkKernel(const Context& dev_ctx,
                                     k,
                                     &sorted_output,
                                     &sorted_indices,
-                                    largest)) {
-          funcs::GPUGather<int64_t, int64_t>(
-              dev_ctx, *indices, sorted_indices, &gather_indices);
-          Copy(dev_ctx, gather_indices, indices->place(), false, indices);
+                                    largest,
+                                    indices)) {
+          Copy(dev_ctx, sorted_indices, indices->place(), false, indices);
           Copy(dev_ctx, sorted_output, out->place(), false, out);
           return;
         } else {
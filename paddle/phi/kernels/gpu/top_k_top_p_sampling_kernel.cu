@@ -0,0 +1,301 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/top_k_top_p_sampling_kernel.h"
+
+#ifdef PADDLE_WITH_CUDA
+#include <curand_kernel.h>
+
+#include "cub/cub.cuh"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/block_radix_topk.cuh"
+
+namespace phi {
+
+constexpr int kSamplingBlockSize = 1024;
+
+// One block samples a row. The logits are read in a few passes over the
+// row in global memory, and the thresholds of top_k and top_p are found by
+// radix select, instead of sorting the row:
+//   top_k: the k-th largest logit by BlockRadixTopKGlobalMemory;
+//   top_p: the smallest logit whose candidates no less than it hold top_p
+//          of the mass, by a radix select on the masses of the digits.
+template <typename T, int BLOCK_SIZE>
+__global__ void TopKTopPSamplingCUDAKernel(const T* x,
+                                           const float* top_p,
+                                           const int64_t* pre_ids,
+                                           int pre_len,
+                                           int vocab_size,
+                                           float temperature,
+                                           int top_k,
+                                           float min_p,
+                                           float repetition_penalty,
+                                           uint64_t seed,
+                                           uint64_t offset,
+                                           float* logits,
+                                           T* out,
+                                           int64_t* ids) {
+  using Traits = cub::Traits<float>;
+  using UnsignedBits = typename Traits::UnsignedBits;
+  using BlockReduce = cub::BlockReduce<float, BLOCK_SIZE>;
+  using BlockScan = cub::BlockScan<float, BLOCK_SIZE>;
+  using RadixSelect =
+      paddle::framework::BlockRadixTopKGlobalMemory<float, BLOCK_SIZE, true>;
+  constexpr int kRadixBits = 8;
+  constexpr int kRadixSize = 1 << kRadixBits;
+
+  __shared__ union {
+    typename BlockReduce::TempStorage reduce;
+    typename BlockScan::TempStorage scan;
+    typename RadixSelect::TempStorage select;
+  } storage;
+  __shared__ float bins[kRadixSize];
+  __shared__ float share_value;
+  __shared__ float share_target;
+  __shared__ UnsignedBits share_pattern;
+  __shared__ int share_id;
+
+  const int tid = threadIdx.x;
+  const int64_t row = blockIdx.x;
+  const T* x_row = x + row * vocab_size;
+  float* l = logits + row * vocab_size;
+  const float inv_temperature = 1.f / temperature;
+
+  for (int i = tid; i < vocab_size; i += BLOCK_SIZE) {
+    l[i] = static_cast<float>(x_row[i]) * inv_temperature;
+  }
+  __syncthreads();
+  if (pre_ids != nullptr && repetition_penalty != 1.f) {
+    // computed from x, so that a repeated id is penalized once
+    for (int j = tid; j < pre_len; j += BLOCK_SIZE) {
+      int64_t id = pre_ids[row * pre_len + j];
+      if (id >= 0 && id < vocab_size) {
+        float value = static_cast<float>(x_row[id]);
+        value = value > 0 ? value / repetition_penalty
+                          : value * repetition_penalty;
+        l[id] = value * inv_temperature;
+      }
+    }
+    __syncthreads();
+  }
+
+  float thread_max = -INFINITY;
+  for (int i = tid; i < vocab_size; i += BLOCK_SIZE) {
+    thread_max = max(thread_max, l[i]);
+  }
+  float max_logit = BlockReduce(storage.reduce).Reduce(thread_max, cub::Max());
+  if (tid == 0) {
+    share_value = max_logit;
+  }
+  __syncthreads();
+  max_logit = share_value;
+
+  // the candidates are the logits no less than lower
+  float lower = -INFINITY;
+  if (top_k > 0 && top_k < vocab_size) {
+    bool topk_is_unique;
+    RadixSelect{storage.select}.radixTopKGetThreshold(
+        l, top_k, vocab_size, lower, topk_is_unique);
+    __syncthreads();
+  }
+  if (min_p > 0.f) {
+    lower = max(lower, max_logit + logf(min_p));
+  }
+
+  float p = top_p[row];
+  if (p <= 0.f) {
+    lower = max_logit;
+  } else if (p < 1.f) {
+    float thread_mass = 0.f;
+    for (int i = tid; i < vocab_size; i += BLOCK_SIZE) {
+      if (l[i] >= lower) {
+        thread_mass += __expf(l[i] - max_logit);
+      }
+    }
+    float mass = BlockReduce(storage.reduce).Sum(thread_mass);
+    if (tid == 0) {
+      share_target = p * mass;
+      share_pattern = 0;
+    }
+    __syncthreads();
+    // find the digits of the threshold from the highest ones, the mass of
+    // the candidates matching the digits found is binned by the next digit
+    UnsignedBits pattern = 0;
+    UnsignedBits mask = 0;
+    for (int pos = sizeof(float) * 8 - kRadixBits; pos >= 0;
+         pos -= kRadixBits) {
+      for (int b = tid; b < kRadixSize; b += BLOCK_SIZE) {
+        bins[b] = 0.f;
+      }
+      __syncthreads();
+      for (int i = tid; i < vocab_size; i += BLOCK_SIZE) {
+        float value = l[i];
+        if (value < lower) {
+          continue;
+        }
+        UnsignedBits bits =
+            Traits::TwiddleIn(reinterpret_cast<UnsignedBits&>(value));
+        if ((bits & mask) == pattern) {
+          atomicAdd(&bins[(bits >> pos) & (kRadixSize - 1)],
+                    __expf(value - max_logit));
+        }
+      }
+      __syncthreads();
+      if (tid == 0) {
+        float above = 0.f;
+        int b = kRadixSize - 1;
+        for (; b > 0; --b) {
+          if (above + bins[b] >= share_target) {
+            break;
+          }
+          above += bins[b];
+        }
+        share_target -= above;
+        share_pattern |= static_cast<UnsignedBits>(b) << pos;
+      }
+      __syncthreads();
+      pattern = share_pattern;
+      mask |= static_cast<UnsignedBits>(kRadixSize - 1) << pos;
+    }
+    UnsignedBits bits = Traits::TwiddleOut(pattern);
+    lower = max(lower, reinterpret_cast<float&>(bits));
+  }
+
+  float thread_mass = 0.f;
+  for (int i = tid; i < vocab_size; i += BLOCK_SIZE) {
+    if (l[i] >= lower) {
+      thread_mass += __expf(l[i] - max_logit);
+    }
+  }
+  float mass = BlockReduce(storage.reduce).Sum(thread_mass);
+  if (tid == 0) {
+    curandStatePhilox4_32_10_t state;
+    curand_init(seed, row, offset, &state);
+    share_value = curand_uniform(&state) * mass;
+    share_target = mass;
+    share_id = -1;
+  }
+  __syncthreads();
+  const float u = share_value;
+  mass = share_target;
+
+  // the token whose inclusive prefix mass first reaches u in the order of
+  // the vocab
+  float prefix = 0.f;
+  int last_candidate = -1;
+  for (int base = 0; base < vocab_size; base += BLOCK_SIZE) {
+    int i = base + tid;
+    float weight = 0.f;
+    if (i < vocab_size && l[i] >= lower) {
+      weight = __expf(l[i] - max_logit);
+      last_candidate = i;
+    }
+    float inclusive, tile_mass;
+    BlockScan(storage.scan).InclusiveSum(weight, inclusive, tile_mass);
+    inclusive += prefix;
+    if (weight > 0.f && inclusive >= u && inclusive - weight < u) {
+      share_id = i;
+    }
+    __syncthreads();
+    bool found = share_id >= 0;
+    // the scan storage is reused by the next tile
+    __syncthreads();
+    if (found) {
+      break;
+    }
+    prefix += tile_mass;
+  }
+  if (share_id < 0) {
+    // u is beyond the prefix mass by the rounding, take the last candidate
+    int id = BlockReduce(storage.reduce)
+                 .Reduce(static_cast<float>(last_candidate), cub::Max());
+    if (tid == 0) {
+      share_id = static_cast<int>(id);
+    }
+    __syncthreads();
+  }
+  if (tid == 0) {
+    ids[row] = share_id;
+    out[row] = static_cast<T>(__expf(l[share_id] - max_logit) / mass);
+  }
+}
+
+template <typename T, typename Context>
+void TopKTopPSamplingKernel(const Context& dev_ctx,
+                            const DenseTensor& x,
+                            const DenseTensor& top_p,
+                            const paddle::optional<DenseTensor>& pre_ids,
+                            float temperature,
+                            int top_k,
+                            float min_p,
+                            float repetition_penalty,
+                            int seed,
+                            DenseTensor* out,
+                            DenseTensor* ids) {
+  const int bsz = static_cast<int>(x.dims()[0]);
+  const int vocab_size = static_cast<int>(x.dims()[1]);
+  T* out_data = dev_ctx.template Alloc<T>(out);
+  int64_t* ids_data = dev_ctx.template Alloc<int64_t>(ids);
+  if (bsz == 0) {
+    return;
+  }
+
+  // the processed logits
+  DenseTensor logits;
+  logits.Resize(x.dims());
+  float* logits_data = dev_ctx.template Alloc<float>(&logits);
+
+  uint64_t seed_data = 0;
+  uint64_t offset = 0;
+  if (seed >= 0) {
+    seed_data = static_cast<uint64_t>(seed);
+  } else {
+    auto seed_offset = dev_ctx.GetGenerator()->IncrementOffset(4);
+    seed_data = seed_offset.first;
+    offset = seed_offset.second;
+  }
+  const int64_t* pre_ids_data = nullptr;
+  int pre_len = 0;
+  if (pre_ids) {
+    pre_ids_data = pre_ids->data<int64_t>();
+    pre_len = static_cast<int>(pre_ids->dims()[1]);
+  }
+  TopKTopPSamplingCUDAKernel<T, kSamplingBlockSize>
+      <<<bsz, kSamplingBlockSize, 0, dev_ctx.stream()>>>(x.data<T>(),
+                                                         top_p.data<float>(),
+                                                         pre_ids_data,
+                                                         pre_len,
+                                                         vocab_size,
+                                                         temperature,
+                                                         top_k,
+                                                         min_p,
+                                                         repetition_penalty,
+                                                         seed_data,
+                                                         offset,
+                                                         logits_data,
+                                                         out_data,
+                                                         ids_data);
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(top_k_top_p_sampling,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::TopKTopPSamplingKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
+#endif
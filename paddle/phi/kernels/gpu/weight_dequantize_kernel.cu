@@ -15,6 +15,7 @@ limitations under the License. */
 #include "paddle/phi/kernels/weight_dequantize_kernel.h"
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/weight_only_group_gemm.h"
 #include "paddle/phi/kernels/transpose_kernel.h"
 
 #if defined(PADDLE_WITH_CUTLASS)
@@ -29,7 +30,20 @@ void WeightDequantizeKernel(const Context& dev_ctx,
                             const DenseTensor& scale,
                             const std::string& algo,
                             DataType out_dtype,
+                            const int32_t group_size,
                             DenseTensor* out) {
+  if (group_size > 0) {
+    dev_ctx.template Alloc<T>(out);
+    WeightOnlyGroupDequantize<T, Context>(dev_ctx,
+                                          x.data<int8_t>(),
+                                          scale.data<T>(),
+                                          out->data<T>(),
+                                          scale.dims()[1],
+                                          x.dims()[1],
+                                          algo == "weight_only_int4" ? 4 : 8,
+                                          group_size);
+    return;
+  }
 #if defined(PADDLE_WITH_CUTLASS)
   auto out_dims = out->dims();
   dev_ctx.template Alloc<T>(out);
@@ -16,6 +16,7 @@ limitations under the License. */
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/common/datatype_traits.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/weight_only_group_gemm.h"
 #include "paddle/phi/kernels/matmul_kernel.h"
 
 #if defined(PADDLE_WITH_CUTLASS)
@@ -33,7 +34,35 @@ void WeightOnlyLinearGradKernel(const Context& dev_ctx,
                                 const DenseTensor& out_grad,
                                 const std::string& weight_dtype,
                                 const int32_t arch,
+                                const int32_t group_size,
+                                const std::string& activation,
                                 DenseTensor* x_grad) {
+  PADDLE_ENFORCE_EQ(
+      activation,
+      "none",
+      phi::errors::Unimplemented(
+          "Weightonly linear grad doesn't support the fused activation, but "
+          "got [%s].",
+          activation));
+  if (group_size > 0) {
+    int n = weight_scale.dims()[1];
+    int k = weight.dims()[1];
+    dev_ctx.template Alloc<T>(x_grad);
+    DenseTensor weight_dequantized;
+    weight_dequantized.Resize({{k, n}});
+    dev_ctx.template Alloc<T>(&weight_dequantized);
+    WeightOnlyGroupDequantize<T, Context>(dev_ctx,
+                                          weight.data<int8_t>(),
+                                          weight_scale.data<T>(),
+                                          weight_dequantized.data<T>(),
+                                          n,
+                                          k,
+                                          weight_dtype == "int8" ? 8 : 4,
+                                          group_size);
+    MatmulKernel<T, Context>(
+        dev_ctx, out_grad, weight_dequantized, false, true, x_grad);
+    return;
+  }
 #if defined(PADDLE_WITH_CUTLASS)
   PADDLE_ENFORCE_EQ(
       ((arch == 80) || (arch == 86)),
@@ -17,6 +17,7 @@ limitations under the License. */
 #include "paddle/phi/common/datatype_traits.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/weight_only_gemv.h"
+#include "paddle/phi/kernels/funcs/weight_only_group_gemm.h"
 #if defined(PADDLE_WITH_CUTLASS)
 #include "paddle/phi/kernels/fusion/cutlass/cutlass_kernels/fpA_intB_gemm/fpA_intB_gemm_template.h"
 #endif
@@ -31,7 +32,32 @@ void WeightOnlyLinearKernel(const Context& dev_ctx,
                             const DenseTensor& weight_scale,
                             const std::string& weight_dtype,
                             const int32_t arch,
+                            const int32_t group_size,
+                            const std::string& activation,
                             DenseTensor* out) {
+  const WeightOnlyActivation act = GetWeightOnlyActivation(activation);
+  if (group_size > 0) {
+    // The grouped weight is dequantized in registers with the scale of its
+    // group, and the bias and activation are fused into the epilogue.
+    int n = weight_scale.dims()[1];
+    int k = weight.dims()[1];
+    int m = x.numel() / k;
+    T* out_data = dev_ctx.template Alloc<T>(out);
+    WeightOnlyGroupGemm<T, Context>(
+        dev_ctx,
+        x.data<T>(),
+        weight.data<int8_t>(),
+        bias ? bias.get().data<T>() : nullptr,
+        weight_scale.data<T>(),
+        out_data,
+        m,
+        n,
+        k,
+        weight_dtype == "int8" ? 8 : 4,
+        group_size,
+        act);
+    return;
+  }
 #if defined(PADDLE_WITH_CUTLASS)
   PADDLE_ENFORCE_EQ(
       ((arch == 80) || (arch == 70) || (arch == 75) || (arch == 86)),
@@ -157,6 +183,8 @@ we havenot support sm70 weightonly gemv, because sm70 weight layout is RowMajor.
     PADDLE_THROW(phi::errors::Unimplemented(
         "Please compile with cutlass to make cutlass available"));
 #endif
+    // The per-channel gemm fuses the bias only.
+    WeightOnlyBiasAct<T, Context>(dev_ctx, out_data, nullptr, m, n, act);
   } else {  // m == 1: gemv
     if (weight_dtype == "int8") {
       GemvWeightonlyInt8Wrapper<T, Context>(dev_ctx,
@@ -169,6 +197,8 @@ we havenot support sm70 weightonly gemv, because sm70 weight layout is RowMajor.
                                             k,
                                             "None",
                                             out->data<T>());
+      // the gelu of the gemv is the tanh approximation
+      WeightOnlyBiasAct<T, Context>(dev_ctx, out_data, nullptr, m, n, act);
     }  // TODO(lizhenyun) support weight_only_gemv for int4.
   }
 }
@@ -17,6 +17,7 @@
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/common_shape.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/funcs/weight_only_group_gemm.h"
 #include "paddle/phi/kernels/impl/weight_quantize_kernel_gpu_impl.h"
 
 namespace phi {
@@ -26,6 +27,7 @@ void WeightQuantizeKernel(const Context& dev_ctx,
                           const DenseTensor& x,
                           const std::string& algo,
                           const int32_t arch,
+                          const int32_t group_size,
                           DenseTensor* out,
                           DenseTensor* scale) {
   DenseTensor quanted_x;
@@ -33,6 +35,24 @@ void WeightQuantizeKernel(const Context& dev_ctx,
   dev_ctx.template Alloc<T>(scale);
   size_t m = x.dims()[0];
   size_t n = x.dims()[1];
+  if (group_size > 0) {
+    PADDLE_ENFORCE_EQ(
+        algo == "weight_only_int8" || algo == "weight_only_int4",
+        true,
+        phi::errors::Unimplemented(
+            "The grouped algo must be in ['weight_only_int8', "
+            "'weight_only_int4'], but got[%s]",
+            algo));
+    WeightOnlyGroupQuantize<T, Context>(dev_ctx,
+                                        x.data<T>(),
+                                        out->data<int8_t>(),
+                                        scale->data<T>(),
+                                        m,
+                                        n,
+                                        algo == "weight_only_int8" ? 8 : 4,
+                                        group_size);
+    return;
+  }
   quanted_x.Resize({static_cast<int64_t>(m), static_cast<int64_t>(n)});
   dev_ctx.template Alloc<int8_t>(&quanted_x);
   std::vector<int> weight_shape{static_cast<int>(x.dims()[0]),
@@ -102,6 +102,45 @@ void per_channel_quant(int8_t* output,
   }
 }
 
+// input: [num_rows, num_cols], scale: [num_rows / group_size, num_cols],
+// output: num_cols rows of num_rows int8, or of num_rows / 2 bytes packing the
+// int4 of the even rows in the low nibble.
+template <typename T, int quant_bit = 8>
+void group_wise_quant(int8_t* output,
+                      T* scale,
+                      const T* input,
+                      size_t num_rows,
+                      size_t num_cols,
+                      size_t group_size) {
+  const float bound = quant_bit == 8 ? 127.0f : 7.0f;
+  const size_t bytes_per_out_row = num_rows * quant_bit / 8;
+  for (size_t g = 0; g < num_rows / group_size; ++g) {
+    for (size_t jj = 0; jj < num_cols; ++jj) {
+      float max = 0.0f;
+      for (size_t ii = g * group_size; ii < (g + 1) * group_size; ++ii) {
+        const float weight_elt = static_cast<float>(input[ii * num_cols + jj]);
+        max = std::max(max, std::abs(weight_elt));
+      }
+      scale[g * num_cols + jj] = static_cast<T>(max / bound);
+      const float inv_scale = max > 0.0f ? bound / max : 0.0f;
+      int8_t* current_quantized_weight_row = output + jj * bytes_per_out_row;
+      for (size_t ii = g * group_size; ii < (g + 1) * group_size; ++ii) {
+        const float scaled_weight =
+            round(static_cast<float>(input[ii * num_cols + jj]) * inv_scale);
+        const int8_t clipped_weight = static_cast<int8_t>(
+            std::max(-bound, std::min(bound, scaled_weight)));
+        if (quant_bit == 8) {
+          current_quantized_weight_row[ii] = clipped_weight;
+        } else if (ii % 2 == 0) {
+          current_quantized_weight_row[ii / 2] = clipped_weight & 0x0F;
+        } else {
+          current_quantized_weight_row[ii / 2] |= (clipped_weight & 0x0F) << 4;
+        }
+      }
+    }
+  }
+}
+
 template <int quant_bit = 8>
 void add_bias_and_interleave_inplace(int8_t* tensor_ptr, size_t num_elts) {
   const size_t num_bytes = num_elts * quant_bit / 8;
@@ -0,0 +1,30 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+
+// The sum of the squares of all the elements of x, e.g. the square of the
+// global norm of the grads. The sum of float16 and bfloat16 is float32.
+template <typename T, typename Context>
+void MergedSquaredL2NormKernel(const Context& dev_ctx,
+                               const std::vector<const DenseTensor*>& x,
+                               DenseTensor* out);
+
+}  // namespace phi
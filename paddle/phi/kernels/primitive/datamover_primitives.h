@@ -108,6 +108,20 @@ struct BroadcastConfig {
     }
     rank = dim_size;
   }
+
+  // For the inputs of arbitrary strides, whose strides of the elements along
+  // the out_dims are given directly, being 0 on the broadcast dims.
+  static BroadcastConfig FromStrides(const std::vector<int64_t>& out_dims,
+                                     const std::vector<int64_t>& in_strides,
+                                     int dim_size) {
+    BroadcastConfig config;
+    for (int i = 0; i < dim_size; ++i) {
+      config.divmoders[i] = FastDivMod(out_dims[i]);
+      config.strides[i] = static_cast<uint32_t>(in_strides[i]);
+    }
+    config.rank = dim_size;
+    return config;
+  }
 };
 
 template <typename T>
@@ -35,4 +35,24 @@ void RmsNormKernel(const Context& dev_ctx,
                    DenseTensor* out,
                    DenseTensor* residual_out);
 
+// RMSNorm(bias_add + residual + x) with the int8 output quantized per token,
+// i.e. every row by its abs max, whose dequantization scales, abs_max /
+// quant_max_bound, are output by out_scale of the shape of x reduced to 1 on
+// the normalized axes.
+template <typename T, typename Context>
+void FusedRmsNormQuantKernel(const Context& dev_ctx,
+                             const DenseTensor& x,
+                             const paddle::optional<DenseTensor>& bias,
+                             const paddle::optional<DenseTensor>& residual,
+                             const DenseTensor& norm_weight,
+                             const paddle::optional<DenseTensor>& norm_bias,
+                             const float epsilon,
+                             const int begin_norm_axis,
+                             const int quant_round_type,
+                             const float quant_max_bound,
+                             const float quant_min_bound,
+                             DenseTensor* out,
+                             DenseTensor* residual_out,
+                             DenseTensor* out_scale);
+
 }  // namespace phi
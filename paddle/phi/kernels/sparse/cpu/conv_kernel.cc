@@ -100,6 +100,27 @@ void Conv3dCooCPUKernel(const CPUContext& dev_ctx,
         &n,
         &need_product_rulebook);
   }
+  // the convs without key reuse the rulebook of the same geometry built on
+  // the same indices of x
+  std::string cache_key;
+  if (key.empty()) {
+    cache_key = phi::funcs::sparse::RulebookCacheKey(
+        x_dims, kernel_sizes, subm_paddings, dilations, subm_strides, subm);
+    rulebook_ptr =
+        phi::funcs::sparse::PrepareCachedRulebook<T, IntT, CPUContext>(
+            dev_ctx,
+            x,
+            cache_key,
+            out_dims,
+            out_channels,
+            out,
+            h_counter_ptr,
+            h_offsets_ptr,
+            &n,
+            &need_product_rulebook,
+            rulebook,
+            counter);
+  }
   if (need_product_rulebook) {
     DenseTensor tmp_rulebook;
     ProductRuleBook<T, CPUContext, IntT>(dev_ctx,
@@ -120,6 +141,10 @@ void Conv3dCooCPUKernel(const CPUContext& dev_ctx,
 
     phi::funcs::sparse::SaveToTable(
         dev_ctx, x, key, tmp_rulebook, h_counter, out, rulebook, counter);
+    if (key.empty()) {
+      phi::funcs::sparse::SaveToRulebookCache(
+          x, cache_key, tmp_rulebook, h_counter, out);
+    }
   }
 
   // 2. gather
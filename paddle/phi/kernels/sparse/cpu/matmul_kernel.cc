@@ -14,31 +14,202 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/sparse/matmul_kernel.h"
 
+#include <algorithm>
+#include <vector>
+
+#include "paddle/common/ddim.h"
 #include "paddle/phi/backends/cpu/cpu_context.h"
 #include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/visit_type.h"
+#include "paddle/phi/kernels/sparse/empty_kernel.h"
 
 namespace phi {
 namespace sparse {
 
-// TODO(zhouwei25): implement CPU kernel of " CSR @ DENSE -> DENSE"
+// the nnz one partition of the rows handles at least
+constexpr int64_t kMinNnzPerPartition = 4096;
+
+// Splits the rows [0, rows) of a CSR matrix into partitions of about the
+// same nnz, as the merge path does, so that the partitions take about the
+// same time however skewed the row lengths are. Returns the first row of
+// every partition and rows at the end.
+template <typename IntT>
+std::vector<int64_t> PartitionRowsByNnz(const IntT* crows, int64_t rows) {
+  int64_t nnz = static_cast<int64_t>(crows[rows] - crows[0]);
+  int64_t num_partitions =
+      std::max<int64_t>(1, std::min(rows, nnz / kMinNnzPerPartition));
+  std::vector<int64_t> row_splits(num_partitions + 1, rows);
+  row_splits[0] = 0;
+  for (int64_t i = 1; i < num_partitions; ++i) {
+    IntT target = crows[0] + static_cast<IntT>(nnz * i / num_partitions);
+    row_splits[i] = std::max(
+        row_splits[i - 1],
+        static_cast<int64_t>(std::upper_bound(crows, crows + rows + 1, target) -
+                             crows - 1));
+  }
+  return row_splits;
+}
+
+template <typename T, typename IntT>
+void MatmulCsrDenseCPUKernel(const CPUContext& dev_ctx,
+                             const SparseCsrTensor& x,
+                             const DenseTensor& y,
+                             DenseTensor* out) {
+  const auto& x_dims = x.dims();
+  const auto& y_dims = y.dims();
+  int x_rank = x_dims.size();
+  PADDLE_ENFORCE_EQ(
+      x_rank,
+      y_dims.size(),
+      phi::errors::PreconditionNotMet("The dims size of Input(x) and Input(y) "
+                                      "should be equal, But received X's "
+                                      "dimensions=%d, Y's dimensions=%d.",
+                                      x_rank,
+                                      y_dims.size()));
+  PADDLE_ENFORCE_EQ(
+      x_dims[x_rank - 1],
+      y_dims[x_rank - 2],
+      phi::errors::PreconditionNotMet(
+          "The shape of Input(x) and Input(y) is not suitable for matmul "
+          "opetation, x_dim[-1] must be eaqual to y_dim[-2]."));
+
+  int64_t batch_size = x_rank == 3 ? x_dims[0] : 1;
+  int64_t rows = x_dims[x_rank - 2];
+  int64_t k = x_dims[x_rank - 1];
+  int64_t n = y_dims[x_rank - 1];
+  std::vector<int64_t> out_dims = common::vectorize(y_dims);
+  out_dims[x_rank - 2] = rows;
+  out->Resize(common::make_ddim(out_dims));
+  T* out_data = dev_ctx.template Alloc<T>(out);
+  std::fill(out_data, out_data + out->numel(), static_cast<T>(0));
+
+  const IntT* crows_data = x.crows().data<IntT>();
+  const IntT* cols_data = x.cols().data<IntT>();
+  const T* values_data = x.values().data<T>();
+  const T* y_data = y.data<T>();
+  for (int64_t b = 0; b < batch_size; ++b) {
+    const IntT* crows = crows_data + b * (rows + 1);
+    const T* y_batch = y_data + b * k * n;
+    T* out_batch = out_data + b * rows * n;
+    std::vector<int64_t> row_splits = PartitionRowsByNnz(crows, rows);
+    int64_t num_partitions = static_cast<int64_t>(row_splits.size()) - 1;
+#pragma omp parallel for
+    for (int64_t p = 0; p < num_partitions; ++p) {
+      for (int64_t i = row_splits[p]; i < row_splits[p + 1]; ++i) {
+        T* out_row = out_batch + i * n;
+        for (IntT j = crows[i]; j < crows[i + 1]; ++j) {
+          const T value = values_data[j];
+          const T* y_row = y_batch + static_cast<int64_t>(cols_data[j]) * n;
+          for (int64_t c = 0; c < n; ++c) {
+            out_row[c] += value * y_row[c];
+          }
+        }
+      }
+    }
+    cols_data += crows[rows];
+    values_data += crows[rows];
+  }
+}
+
+/* CSR @ DENSE -> DENSE */
 template <typename T, typename Context>
-void MatmulCsrDenseKernel(const Context& dev_ctx UNUSED,
-                          const SparseCsrTensor& x UNUSED,
-                          const DenseTensor& y UNUSED,
-                          DenseTensor* out UNUSED) {
-  PADDLE_THROW(phi::errors::Unimplemented(
-      "Not support CPU kernel of 'sparse.matmul' now."));
+void MatmulCsrDenseKernel(const Context& dev_ctx,
+                          const SparseCsrTensor& x,
+                          const DenseTensor& y,
+                          DenseTensor* out) {
+  PD_VISIT_BASE_INTEGRAL_TYPES(
+      x.crows().dtype(), "MatmulCsrDenseCPUKernel", ([&] {
+        MatmulCsrDenseCPUKernel<T, data_t>(dev_ctx, x, y, out);
+      }));
+}
+
+// The sampled dense-dense matmul (SDDMM): out = (x @ y) * mask, computing only
+// the elements at the non-zeros of mask. Every row of mask walks along the
+// rows of y, so that the reads of y are contiguous.
+template <typename T, typename IntT>
+void MaskedMatmulCsrCPUKernel(const CPUContext& dev_ctx,
+                              const DenseTensor& x,
+                              const DenseTensor& y,
+                              const SparseCsrTensor& mask,
+                              SparseCsrTensor* out) {
+  const auto& x_dims = x.dims();
+  const auto& y_dims = y.dims();
+  const auto& mask_dims = mask.dims();
+  int x_rank = x_dims.size();
+  PADDLE_ENFORCE_EQ(
+      x_rank == y_dims.size() && x_rank == mask_dims.size(),
+      true,
+      phi::errors::PreconditionNotMet(
+          "The dims size of Input(x), Input(y) and Input(mask) should be "
+          "equal, But received X's dimensions=%d, Y's dimensions=%d, mask's "
+          "dimensions=%d.",
+          x_rank,
+          y_dims.size(),
+          mask_dims.size()));
+  PADDLE_ENFORCE_EQ(
+      x_dims[x_rank - 1],
+      y_dims[x_rank - 2],
+      phi::errors::PreconditionNotMet(
+          "The shape of Input(x) and Input(y) is not suitable for matmul "
+          "opetation, x_dim[-1] must be eaqual to y_dim[-2]."));
+  PADDLE_ENFORCE_EQ(
+      mask_dims[x_rank - 2] == x_dims[x_rank - 2] &&
+          mask_dims[x_rank - 1] == y_dims[x_rank - 1],
+      true,
+      phi::errors::PreconditionNotMet(
+          "The shape of Input(mask) must be [x_dim[-2], y_dim[-1]], but "
+          "received %s.",
+          mask_dims));
+
+  EmptyLikeCsrKernel<T, CPUContext>(dev_ctx, mask, out);
+
+  int64_t batch_size = x_rank == 3 ? x_dims[0] : 1;
+  int64_t rows = x_dims[x_rank - 2];
+  int64_t k = x_dims[x_rank - 1];
+  int64_t n = y_dims[x_rank - 1];
+  const IntT* crows_data = mask.crows().data<IntT>();
+  const IntT* cols_data = mask.cols().data<IntT>();
+  const T* x_data = x.data<T>();
+  const T* y_data = y.data<T>();
+  T* out_data = out->mutable_values()->data<T>();
+  for (int64_t b = 0; b < batch_size; ++b) {
+    const IntT* crows = crows_data + b * (rows + 1);
+    const T* x_batch = x_data + b * rows * k;
+    const T* y_batch = y_data + b * k * n;
+    std::vector<int64_t> row_splits = PartitionRowsByNnz(crows, rows);
+    int64_t num_partitions = static_cast<int64_t>(row_splits.size()) - 1;
+#pragma omp parallel for
+    for (int64_t p = 0; p < num_partitions; ++p) {
+      for (int64_t i = row_splits[p]; i < row_splits[p + 1]; ++i) {
+        T* out_row = out_data + crows[i];
+        const IntT* cols_row = cols_data + crows[i];
+        int64_t row_nnz = static_cast<int64_t>(crows[i + 1] - crows[i]);
+        std::fill(out_row, out_row + row_nnz, static_cast<T>(0));
+        for (int64_t l = 0; l < k; ++l) {
+          const T x_value = x_batch[i * k + l];
+          const T* y_row = y_batch + l * n;
+          for (int64_t j = 0; j < row_nnz; ++j) {
+            out_row[j] += x_value * y_row[cols_row[j]];
+          }
+        }
+      }
+    }
+    cols_data += crows[rows];
+    out_data += crows[rows];
+  }
 }
 
-// TODO(zhouwei25): implement CPU kernel of " DENSE @ DENSE * CSR_MASK -> CSR"
+/* DENSE @ DENSE * CSR_MASK -> CSR */
 template <typename T, typename Context>
-void MaskedMatmulCsrKernel(const Context& dev_ctx UNUSED,
-                           const DenseTensor& x UNUSED,
-                           const DenseTensor& y UNUSED,
-                           const SparseCsrTensor& mask UNUSED,
-                           SparseCsrTensor* out UNUSED) {
-  PADDLE_THROW(phi::errors::Unimplemented(
-      "Not support CPU kernel of 'sparse.masked_matmul' now."));
+void MaskedMatmulCsrKernel(const Context& dev_ctx,
+                           const DenseTensor& x,
+                           const DenseTensor& y,
+                           const SparseCsrTensor& mask,
+                           SparseCsrTensor* out) {
+  PD_VISIT_BASE_INTEGRAL_TYPES(
+      mask.crows().dtype(), "MaskedMatmulCsrCPUKernel", ([&] {
+        MaskedMatmulCsrCPUKernel<T, data_t>(dev_ctx, x, y, mask, out);
+      }));
 }
 
 }  // namespace sparse
@@ -28,6 +28,8 @@ namespace cub = hipcub;
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/common/amp_type_traits.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/core/tensor_utils.h"
 #include "paddle/phi/kernels/funcs/aligned_vector.h"
@@ -169,6 +171,113 @@ inline void GatherV2(const GPUContext& dev_ctx,
   }
 }
 
+// The implicit gemm of one kernel offset, which fuses the gather, the gemm
+// and the scatter of the rulebook:
+//   out[scatter[m], :] += x[gather[m], :] * kernel  (m < M)
+// x is [*, K], kernel is [K, N] and out is [*, N]. Each block computes a tile
+// of kTile rows and kTile cols of the gemm, the rows of x are gathered into
+// the shared memory by the rulebook, and the tile is added to out by atomics.
+template <typename T, typename IntT, int kTile, int kBlockRows>
+__global__ void ImplicitGemmConvKernel(const T* x,
+                                       const T* kernel,
+                                       const IntT* gather_indices,
+                                       const IntT* scatter_indices,
+                                       const int M,
+                                       const int N,
+                                       const int K,
+                                       T* out) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  constexpr int kRowsPerThread = kTile / kBlockRows;
+  __shared__ MT x_tile[kTile][kTile + 1];
+  __shared__ MT kernel_tile[kTile][kTile + 1];
+
+  const int tx = threadIdx.x;
+  const int ty = threadIdx.y;
+  const int64_t m_begin = static_cast<int64_t>(blockIdx.x) * kTile;
+  const int n = blockIdx.y * kTile + tx;
+
+  int64_t x_rows[kRowsPerThread];
+  MT acc[kRowsPerThread];
+#pragma unroll
+  for (int r = 0; r < kRowsPerThread; ++r) {
+    const int64_t m = m_begin + ty + r * kBlockRows;
+    x_rows[r] = m < M ? static_cast<int64_t>(gather_indices[m]) : -1;
+    acc[r] = static_cast<MT>(0);
+  }
+
+  for (int k_begin = 0; k_begin < K; k_begin += kTile) {
+#pragma unroll
+    for (int r = 0; r < kRowsPerThread; ++r) {
+      const int row = ty + r * kBlockRows;
+      const int k = k_begin + tx;
+      x_tile[row][tx] = x_rows[r] >= 0 && k < K
+                            ? static_cast<MT>(x[x_rows[r] * K + k])
+                            : static_cast<MT>(0);
+      kernel_tile[row][tx] =
+          k_begin + row < K && n < N
+              ? static_cast<MT>(kernel[static_cast<int64_t>(k_begin + row) * N +
+                                       n])
+              : static_cast<MT>(0);
+    }
+    __syncthreads();
+#pragma unroll
+    for (int k = 0; k < kTile; ++k) {
+      const MT w = kernel_tile[k][tx];
+#pragma unroll
+      for (int r = 0; r < kRowsPerThread; ++r) {
+        acc[r] += x_tile[ty + r * kBlockRows][k] * w;
+      }
+    }
+    __syncthreads();
+  }
+
+  if (n >= N) return;
+#pragma unroll
+  for (int r = 0; r < kRowsPerThread; ++r) {
+    const int64_t m = m_begin + ty + r * kBlockRows;
+    if (m < M) {
+      phi::CudaAtomicAdd(out + static_cast<int64_t>(scatter_indices[m]) * N + n,
+                         static_cast<T>(acc[r]));
+    }
+  }
+}
+
+// out must be set to zeros before, the kernel offsets are computed one by one.
+template <typename T, typename IntT>
+inline void ImplicitGemmConv(const GPUContext& dev_ctx,
+                             const T* x,
+                             const T* kernel,
+                             const IntT* rulebook,
+                             const int rulebook_len,
+                             const int* h_counter,
+                             const int* h_offsets,
+                             const int kernel_size,
+                             const int in_channels,
+                             const int out_channels,
+                             T* out) {
+  constexpr int kTile = 32;
+  constexpr int kBlockRows = 8;
+  const dim3 threads(kTile, kBlockRows);
+  for (int i = 0; i < kernel_size; i++) {
+    if (h_counter[i] <= 0) {
+      continue;
+    }
+    const int M = h_counter[i];
+    const dim3 blocks((M + kTile - 1) / kTile,
+                      (out_channels + kTile - 1) / kTile);
+    ImplicitGemmConvKernel<T, IntT, kTile, kBlockRows>
+        <<<blocks, threads, 0, dev_ctx.stream()>>>(
+            x,
+            kernel + static_cast<int64_t>(i) * in_channels * out_channels,
+            rulebook + h_offsets[i],
+            rulebook + rulebook_len + h_offsets[i],
+            M,
+            out_channels,
+            in_channels,
+            out);
+  }
+}
+
 // unique the out indexs in rulebook
 template <typename IntT>
 __global__ void UniqueKernel(const IntT* in_indexs,
@@ -15,6 +15,7 @@ limitations under the License. */
 #include "paddle/phi/kernels/sparse/conv_kernel.h"
 
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/flags.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_meta.h"
 #include "paddle/phi/core/visit_type.h"
@@ -29,6 +30,8 @@ limitations under the License. */
 
 #include "glog/logging.h"
 
+PHI_DECLARE_bool(sparse_conv_implicit_gemm);
+
 namespace phi {
 namespace sparse {
 
@@ -148,6 +151,28 @@ void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
         &need_product_rulebook);
   }
 
+  // the convs without key reuse the rulebook of the same geometry built on
+  // the same indices of x
+  std::string cache_key;
+  if (key.empty()) {
+    cache_key = phi::funcs::sparse::RulebookCacheKey(
+        x_dims, kernel_sizes, subm_paddings, dilations, subm_strides, subm);
+    rulebook_ptr =
+        phi::funcs::sparse::PrepareCachedRulebook<T, IntT, GPUContext>(
+            dev_ctx,
+            x,
+            cache_key,
+            out_dims,
+            out_channels,
+            out,
+            h_counter_ptr,
+            h_offsets_ptr,
+            &rulebook_len,
+            &need_product_rulebook,
+            rulebook,
+            counter);
+  }
+
   if (need_product_rulebook) {
     DenseTensor tmp_rulebook;
     rulebook_len = ProductRuleBook<T, GPUContext, IntT>(dev_ctx,
@@ -170,6 +195,15 @@ void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
 
     phi::funcs::sparse::SaveToTable(
         dev_ctx, x, key, tmp_rulebook, h_counter, out, rulebook, counter);
+    if (key.empty()) {
+      if (subm) {
+        // the out of subm has the indices of x in the same order, sharing
+        // them lets the next subm conv of the same geometry reuse the rulebook
+        *(out->mutable_indices()) = x.indices();
+      }
+      phi::funcs::sparse::SaveToRulebookCache(
+          x, cache_key, tmp_rulebook, h_counter, out);
+    }
   }
 
 #if defined(PADDLE_WITH_CUTLASS) && SPCONV_WITH_CUTLASS
@@ -206,9 +240,27 @@ void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
       else
         GATHER_GEMM_SCATTER(80, T, x.non_zero_elements(), kernel);
     }
-  } else {
+  } else if (FLAGS_sparse_conv_implicit_gemm) {
+#else
+  if (FLAGS_sparse_conv_implicit_gemm) {
 #endif
-    if (subm) {
+    auto* out_values = out->mutable_values();
+    phi::funcs::SetConstant<GPUContext, T> set_zero;
+    set_zero(dev_ctx, out_values, static_cast<T>(0.0f));
+    ImplicitGemmConv<T, IntT>(dev_ctx,
+                              x.values().data<T>(),
+                              kernel.data<T>(),
+                              rulebook_ptr,
+                              rulebook_len,
+                              h_counter_ptr,
+                              h_offsets_ptr,
+                              kernel_size,
+                              in_channels,
+                              out_channels,
+                              out_values->data<T>());
+  } else {
+    // the out indexs of a cached rulebook are grouped like the ones of subm
+    if (subm || !need_product_rulebook) {
       auto config =
           phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, rulebook_len, 1);
       unique_value.ResizeAndAllocate(
@@ -286,9 +338,7 @@ void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
                                      out_channels,
                                      1,
                                      out_values_ptr);
-#if defined(PADDLE_WITH_CUTLASS) && SPCONV_WITH_CUTLASS
   }
-#endif
 }
 
 /**
@@ -24,6 +24,7 @@ limitations under the License. */
 #include "paddle/phi/core/sparse_coo_tensor.h"
 #include "paddle/phi/core/sparse_csr_tensor.h"
 #include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/core/visit_type.h"
 #include "paddle/phi/kernels/empty_kernel.h"
 #include "paddle/phi/kernels/funcs/math_function_impl.h"
 #include "paddle/phi/kernels/funcs/sparse/sparse_blas.h"
@@ -118,13 +119,51 @@ void MatmulCsrDenseKernel(const Context& dev_ctx,
   MatmulKernelImpl<T>(dev_ctx, x, y, out);
 }
 
+// The sampled dense-dense matmul for the toolkits without cusparseSDDMM. The
+// threads in x of a block compute the non-zeros of a row of mask, and the
+// threads in y the rows.
+template <typename T, typename IntT>
+__global__ void MaskedMatmulCsrCudaKernel(const T* x,
+                                          const T* y,
+                                          const IntT* crows,
+                                          const IntT* cols,
+                                          int64_t batch_size,
+                                          int64_t rows,
+                                          int64_t k,
+                                          int64_t n,
+                                          T* out) {
+  int64_t row = static_cast<int64_t>(blockIdx.x) * blockDim.y + threadIdx.y;
+  if (row >= batch_size * rows) {
+    return;
+  }
+  int64_t b = row / rows;
+  int64_t i = row % rows;
+  // the crows of every batch start from 0
+  int64_t offset = 0;
+  for (int64_t prev = 0; prev < b; ++prev) {
+    offset += static_cast<int64_t>(crows[prev * (rows + 1) + rows]);
+  }
+  const IntT* batch_crows = crows + b * (rows + 1);
+  const T* x_row = x + row * k;
+  const T* y_batch = y + b * k * n;
+  for (int64_t j = offset + batch_crows[i] + threadIdx.x;
+       j < offset + batch_crows[i + 1];
+       j += blockDim.x) {
+    int64_t col = static_cast<int64_t>(cols[j]);
+    T sum = static_cast<T>(0);
+    for (int64_t l = 0; l < k; ++l) {
+      sum += x_row[l] * y_batch[l * n + col];
+    }
+    out[j] = sum;
+  }
+}
+
 template <typename T, typename Context>
 void MaskedMatmulCsrKernel(const Context& dev_ctx,
                            const DenseTensor& x,
                            const DenseTensor& y,
                            const SparseCsrTensor& mask,
                            SparseCsrTensor* out) {
-#if CUDA_VERSION >= 11030
   std::vector<int64_t> xdim_vec = common::vectorize(x.dims());
   std::vector<int64_t> ydim_vec = common::vectorize(y.dims());
   std::vector<int64_t> maskdim_vec = common::vectorize(mask.dims());
@@ -191,13 +230,35 @@ void MaskedMatmulCsrKernel(const Context& dev_ctx,
   // InferMeta of SparseCsrTensor 'out', CreateLikeInferMeta
   EmptyLikeCsrKernel<T, Context>(dev_ctx, mask, out);
 
+#if CUDA_VERSION >= 11030
   auto sparse_blas = phi::funcs::sparse::GetSparseBlas<Context, T>(dev_ctx);
   sparse_blas.SDDMM(
       false, false, static_cast<T>(1), x, y, static_cast<T>(0), out);
 #else
-  PADDLE_THROW(phi::errors::Unimplemented(
-      "forward of 'sparse.masked_matmul' use cusparseSDDMM, which is supported "
-      "from CUDA 11.3"));
+  int64_t batch_size = x_ndims == 3 ? xdim_vec[0] : 1;
+  int64_t rows = xdim_vec[x_ndims - 2];
+  int64_t k = xdim_vec[x_ndims - 1];
+  int64_t n = ydim_vec[y_ndims - 1];
+  if (batch_size * rows == 0) {
+    return;
+  }
+  constexpr int kRowsPerBlock = 8;
+  dim3 block(32, kRowsPerBlock);
+  dim3 grid((batch_size * rows + kRowsPerBlock - 1) / kRowsPerBlock);
+  PD_VISIT_BASE_INTEGRAL_TYPES(
+      mask.crows().dtype(), "MaskedMatmulCsrCudaKernel", ([&] {
+        MaskedMatmulCsrCudaKernel<T, data_t>
+            <<<grid, block, 0, dev_ctx.stream()>>>(
+                x.data<T>(),
+                y.data<T>(),
+                mask.crows().data<data_t>(),
+                mask.cols().data<data_t>(),
+                batch_size,
+                rows,
+                k,
+                n,
+                out->mutable_values()->data<T>());
+      }));
 #endif
 }
 
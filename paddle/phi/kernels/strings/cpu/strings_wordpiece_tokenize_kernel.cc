@@ -0,0 +1,88 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/strings/strings_wordpiece_tokenize_kernel.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/strings/wordpiece_utils.h"
+
+namespace phi {
+namespace strings {
+
+template <typename Context>
+void StringsWordpieceTokenizeKernel(const Context& dev_ctx,
+                                    const StringTensor& x,
+                                    const StringTensor& vocab,
+                                    bool do_lower_case,
+                                    int max_seq_len,
+                                    int unk_token_id,
+                                    int pad_token_id,
+                                    DenseTensor* input_ids,
+                                    DenseTensor* seq_lens) {
+  const int64_t vocab_size = vocab.numel();
+  PADDLE_ENFORCE_EQ(
+      unk_token_id >= 0 && unk_token_id < vocab_size,
+      true,
+      phi::errors::InvalidArgument(
+          "The unk_token_id should be in [0, %d), but received %d.",
+          vocab_size,
+          unk_token_id));
+  int64_t* ids_data = dev_ctx.template Alloc<int64_t>(input_ids);
+  int* lens_data = dev_ctx.template Alloc<int>(seq_lens);
+  const int64_t num = x.numel();
+  if (num == 0) {
+    return;
+  }
+
+  // the table is built per call, which costs much less than the tokenization
+  // of a batch
+  const pstring* vocab_data = vocab.data();
+  uint32_t capacity = VocabTableCapacity(vocab_size);
+  std::vector<int> slots(capacity, -1);
+  for (int64_t i = 0; i < vocab_size; ++i) {
+    InsertVocabToken(
+        vocab_data, static_cast<int>(i), slots.data(), capacity - 1);
+  }
+
+  WordpieceTokenizer tokenizer{{vocab_data, slots.data(), capacity - 1},
+                               GetUniFlagMap(),
+                               GetCharcasesMap(),
+                               GetTokenizeFlagMap(),
+                               do_lower_case,
+                               unk_token_id};
+  const pstring* x_data = x.data();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < num; ++i) {
+    int64_t* row = ids_data + i * max_seq_len;
+    int64_t len =
+        tokenizer(x_data[i].data(), x_data[i].size(), row, max_seq_len);
+    std::fill(row + len, row + max_seq_len, pad_token_id);
+    lens_data[i] = static_cast<int>(len);
+  }
+}
+
+}  // namespace strings
+}  // namespace phi
+
+PD_REGISTER_KERNEL_FOR_ALL_DTYPE(
+    strings_wordpiece_tokenize,
+    CPU,
+    ALL_LAYOUT,
+    phi::strings::StringsWordpieceTokenizeKernel<phi::CPUContext>) {}
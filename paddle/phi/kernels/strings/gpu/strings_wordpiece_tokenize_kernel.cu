@@ -0,0 +1,128 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/kernels/strings/strings_wordpiece_tokenize_kernel.h"
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/strings/wordpiece_utils.h"
+
+namespace phi {
+namespace strings {
+
+__global__ void BuildVocabTableCUDAKernel(const pstring* vocab,
+                                          int vocab_size,
+                                          int* slots,
+                                          uint32_t mask) {
+  CUDA_KERNEL_LOOP(i, vocab_size) {
+    const pstring& token = vocab[i];
+    uint32_t pos = Fnv1aHash(token.data(), token.size()) & mask;
+    while (true) {
+      int prev = atomicCAS(slots + pos, -1, i);
+      if (prev < 0) {
+        break;
+      }
+      if (vocab[prev] == token) {
+        // the first one of the duplicated tokens
+        atomicMin(slots + pos, i);
+        break;
+      }
+      pos = (pos + 1) & mask;
+    }
+  }
+}
+
+// One thread tokenizes a text
+__global__ void WordpieceTokenizeCUDAKernel(const pstring* x,
+                                            int64_t num,
+                                            WordpieceTokenizer tokenizer,
+                                            int max_seq_len,
+                                            int pad_token_id,
+                                            int64_t* ids,
+                                            int* lens) {
+  CUDA_KERNEL_LOOP_TYPE(i, num, int64_t) {
+    int64_t* row = ids + i * max_seq_len;
+    int64_t len = tokenizer(x[i].data(), x[i].size(), row, max_seq_len);
+    for (int64_t j = len; j < max_seq_len; ++j) {
+      row[j] = pad_token_id;
+    }
+    lens[i] = static_cast<int>(len);
+  }
+}
+
+template <typename Context>
+void StringsWordpieceTokenizeKernel(const Context& dev_ctx,
+                                    const StringTensor& x,
+                                    const StringTensor& vocab,
+                                    bool do_lower_case,
+                                    int max_seq_len,
+                                    int unk_token_id,
+                                    int pad_token_id,
+                                    DenseTensor* input_ids,
+                                    DenseTensor* seq_lens) {
+  const int64_t vocab_size = vocab.numel();
+  PADDLE_ENFORCE_EQ(
+      unk_token_id >= 0 && unk_token_id < vocab_size,
+      true,
+      phi::errors::InvalidArgument(
+          "The unk_token_id should be in [0, %d), but received %d.",
+          vocab_size,
+          unk_token_id));
+  int64_t* ids_data = dev_ctx.template Alloc<int64_t>(input_ids);
+  int* lens_data = dev_ctx.template Alloc<int>(seq_lens);
+  const int64_t num = x.numel();
+  if (num == 0) {
+    return;
+  }
+
+  // the table is built per call by a single launch
+  uint32_t capacity = VocabTableCapacity(vocab_size);
+  DenseTensor slots;
+  slots.Resize({static_cast<int64_t>(capacity)});
+  int* slots_data = dev_ctx.template Alloc<int>(&slots);
+  phi::funcs::SetConstant<Context, int>()(dev_ctx, &slots, -1);
+  auto table_config =
+      phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, vocab_size);
+  BuildVocabTableCUDAKernel<<<table_config.block_per_grid,
+                              table_config.thread_per_block,
+                              0,
+                              dev_ctx.stream()>>>(vocab.data(),
+                                                  static_cast<int>(vocab_size),
+                                                  slots_data,
+                                                  capacity - 1);
+
+  WordpieceTokenizer tokenizer{{vocab.data(), slots_data, capacity - 1},
+                               GetGPUUniflagMap(),
+                               GetGPUCharcasesMap(),
+                               GetGPUTokenizeFlagMap(),
+                               do_lower_case,
+                               unk_token_id};
+  // the word buffers of a thread take the local memory, a small block is
+  // enough
+  constexpr int kThreads = 128;
+  const int64_t blocks = (num + kThreads - 1) / kThreads;
+  WordpieceTokenizeCUDAKernel<<<blocks, kThreads, 0, dev_ctx.stream()>>>(
+      x.data(), num, tokenizer, max_seq_len, pad_token_id, ids_data, lens_data);
+}
+
+}  // namespace strings
+}  // namespace phi
+
+PD_REGISTER_KERNEL_FOR_ALL_DTYPE(
+    strings_wordpiece_tokenize,
+    GPU,
+    ALL_LAYOUT,
+    phi::strings::StringsWordpieceTokenizeKernel<phi::GPUContext>) {}
@@ -0,0 +1,38 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/string_tensor.h"
+
+namespace phi {
+namespace strings {
+
+// Tokenizes every text of x by the BERT tokenizer into the ids of the
+// tokens of vocab, truncated or padded by pad_token_id to max_seq_len.
+// seq_lens holds the numbers of the ids before the padding.
+template <typename Context>
+void StringsWordpieceTokenizeKernel(const Context& dev_ctx,
+                                    const StringTensor& x,
+                                    const StringTensor& vocab,
+                                    bool do_lower_case,
+                                    int max_seq_len,
+                                    int unk_token_id,
+                                    int pad_token_id,
+                                    DenseTensor* input_ids,
+                                    DenseTensor* seq_lens);
+
+}  // namespace strings
+}  // namespace phi
@@ -18,12 +18,14 @@ limitations under the License. */
 
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/kernels/strings/unicode_flag.h"
+#include "paddle/phi/kernels/strings/wordpiece_utils.h"
 
 namespace phi {
 namespace strings {
 
-static const void* utils_map[4] = {nullptr};  // NOLINT
-static uint16_t CHARCASES_MAP[65536] = {0};   // NOLINT
+static const void* utils_map[6] = {nullptr};    // NOLINT
+static uint16_t CHARCASES_MAP[65536] = {0};     // NOLINT
+static uint8_t TOKENIZE_FLAG_MAP[65536] = {0};  // NOLINT
 
 const uint8_t* GetUniFlagMap() {
   if (utils_map[1] == nullptr) {
@@ -46,6 +48,37 @@ const uint16_t* GetCharcasesMap() {
   return reinterpret_cast<const uint16_t*>(utils_map[0]);
 }
 
+const uint8_t* GetTokenizeFlagMap() {
+  if (utils_map[4] == nullptr) {
+    for (uint32_t i = 0; i < 65536; ++i) {
+      auto chr = static_cast<int32_t>(i);
+      auto cat = utf8proc_category(chr);
+      uint8_t flag = 0;
+      if (chr == ' ' || chr == '\t' || chr == '\n' || chr == '\r' ||
+          cat == UTF8PROC_CATEGORY_ZS) {
+        flag |= kTokenizeSpace;
+      } else if (cat == UTF8PROC_CATEGORY_CC || cat == UTF8PROC_CATEGORY_CF) {
+        flag |= kTokenizeControl;
+      }
+      if ((i >= 33 && i <= 47) || (i >= 58 && i <= 64) ||
+          (i >= 91 && i <= 96) || (i >= 123 && i <= 126) ||
+          cat == UTF8PROC_CATEGORY_PD || cat == UTF8PROC_CATEGORY_PS ||
+          cat == UTF8PROC_CATEGORY_PE || cat == UTF8PROC_CATEGORY_PC ||
+          cat == UTF8PROC_CATEGORY_PO || cat == UTF8PROC_CATEGORY_PI ||
+          cat == UTF8PROC_CATEGORY_PF) {
+        flag |= kTokenizePunct;
+      }
+      if ((i >= 0x4E00 && i <= 0x9FFF) || (i >= 0x3400 && i <= 0x4DBF) ||
+          (i >= 0xF900 && i <= 0xFAFF)) {
+        flag |= kTokenizeChinese;
+      }
+      TOKENIZE_FLAG_MAP[i] = flag;
+    }
+    utils_map[4] = TOKENIZE_FLAG_MAP;
+  }
+  return reinterpret_cast<const uint8_t*>(utils_map[4]);
+}
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 
 const uint8_t* GetGPUUniflagMap() {
@@ -85,6 +118,25 @@ const uint16_t* GetGPUCharcasesMap() {
   }
   return reinterpret_cast<const uint16_t*>(utils_map[2]);
 }
+
+const uint8_t* GetGPUTokenizeFlagMap() {
+  if (utils_map[5] == nullptr) {
+    const uint8_t* cpu_tokenize_flag = GetTokenizeFlagMap();
+    auto size = sizeof(TOKENIZE_FLAG_MAP);
+    uint8_t* gpu_tokenize_flag;
+#ifdef PADDLE_WITH_HIP
+    hipMalloc(reinterpret_cast<void**>(&gpu_tokenize_flag), size);
+    phi::backends::gpu::GpuMemcpySync(
+        gpu_tokenize_flag, cpu_tokenize_flag, size, hipMemcpyHostToDevice);
+#else
+    cudaMalloc(reinterpret_cast<void**>(&gpu_tokenize_flag), size);
+    phi::backends::gpu::GpuMemcpySync(
+        gpu_tokenize_flag, cpu_tokenize_flag, size, cudaMemcpyHostToDevice);
+#endif
+    utils_map[5] = gpu_tokenize_flag;
+  }
+  return reinterpret_cast<const uint8_t*>(utils_map[5]);
+}
 #endif
 
 }  // namespace strings
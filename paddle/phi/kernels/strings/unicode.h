@@ -187,11 +187,15 @@ HOSTDEVICE inline void GetUTF8Str(const uint32_t* unicode_str,
 
 const uint8_t* GetUniFlagMap();
 const uint16_t* GetCharcasesMap();
+// The flags of the BMP chars for the BERT basic tokenization, see
+// wordpiece_utils.h
+const uint8_t* GetTokenizeFlagMap();
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 
 const uint8_t* GetGPUUniflagMap();
 const uint16_t* GetGPUCharcasesMap();
+const uint8_t* GetGPUTokenizeFlagMap();
 #endif
 
 }  // namespace strings
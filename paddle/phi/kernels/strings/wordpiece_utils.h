@@ -0,0 +1,264 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cstdint>
+
+#include "paddle/phi/common/pstring.h"
+#include "paddle/phi/core/hostdevice.h"
+#include "paddle/phi/kernels/strings/unicode.h"
+
+namespace phi {
+namespace strings {
+
+using pstring = dtype::pstring;
+
+// The flags of GetTokenizeFlagMap
+constexpr uint8_t kTokenizeSpace = 1;
+constexpr uint8_t kTokenizePunct = 2;
+constexpr uint8_t kTokenizeControl = 4;
+constexpr uint8_t kTokenizeChinese = 8;
+
+// A longer word is the unknown token, as it is in the BERT tokenizer
+constexpr int kMaxWordpieceChars = 100;
+constexpr int kMaxWordpieceBytes = kMaxWordpieceChars * 4;
+
+HOSTDEVICE inline uint8_t GetTokenizeFlag(const uint8_t* tokenize_flag_map,
+                                          uint32_t chr) {
+  if (chr <= 0xFFFF) {
+    return tokenize_flag_map[chr];
+  }
+  bool is_chinese = (chr >= 0x20000 && chr <= 0x2A6DF) ||
+                    (chr >= 0x2A700 && chr <= 0x2B73F) ||
+                    (chr >= 0x2B740 && chr <= 0x2B81F) ||
+                    (chr >= 0x2B820 && chr <= 0x2CEAF) ||
+                    (chr >= 0x2F800 && chr <= 0x2FA1F);
+  return is_chinese ? kTokenizeChinese : 0;
+}
+
+HOSTDEVICE inline uint32_t Fnv1aHash(const char* str,
+                                     size_t len,
+                                     uint32_t hash = 2166136261u) {
+  for (size_t i = 0; i < len; ++i) {
+    hash ^= static_cast<uint8_t>(str[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Whether token is prefix + str
+HOSTDEVICE inline bool TokenEqual(const pstring& token,
+                                  const char* prefix,
+                                  size_t prefix_len,
+                                  const char* str,
+                                  size_t len) {
+  if (token.size() != prefix_len + len) {
+    return false;
+  }
+  const char* data = token.data();
+  for (size_t i = 0; i < prefix_len; ++i) {
+    if (data[i] != prefix[i]) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < len; ++i) {
+    if (data[prefix_len + i] != str[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// An open addressing hash table of the vocab, whose slots hold the indices
+// of the tokens and -1 when empty. The index is the token id, the first one
+// for a duplicated token.
+struct VocabTable {
+  const pstring* vocab;
+  const int* slots;
+  uint32_t mask;
+
+  HOSTDEVICE int Find(const char* prefix,
+                      size_t prefix_len,
+                      const char* str,
+                      size_t len) const {
+    uint32_t pos = Fnv1aHash(str, len, Fnv1aHash(prefix, prefix_len)) & mask;
+    while (slots[pos] >= 0) {
+      if (TokenEqual(vocab[slots[pos]], prefix, prefix_len, str, len)) {
+        return slots[pos];
+      }
+      pos = (pos + 1) & mask;
+    }
+    return -1;
+  }
+};
+
+// The slots of a vocab, at most half full
+inline uint32_t VocabTableCapacity(int64_t vocab_size) {
+  uint32_t capacity = 1;
+  while (capacity < 2 * vocab_size) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+inline void InsertVocabToken(const pstring* vocab,
+                             int index,
+                             int* slots,
+                             uint32_t mask) {
+  const pstring& token = vocab[index];
+  uint32_t pos = Fnv1aHash(token.data(), token.size()) & mask;
+  while (slots[pos] >= 0) {
+    if (vocab[slots[pos]] == token) {
+      return;
+    }
+    pos = (pos + 1) & mask;
+  }
+  slots[pos] = index;
+}
+
+// The BERT tokenization of a text, that is the basic tokenization, which
+// drops the control chars, lowers the case if needed and splits the text by
+// the spaces, punctuations and chinese chars, followed by the greedy longest
+// match first wordpiece tokenization of each word. Unlike the BERT tokenizer
+// the accents are kept.
+struct WordpieceTokenizer {
+  VocabTable table;
+  const uint8_t* unicode_flag_map;
+  const uint16_t* cases_map;
+  const uint8_t* tokenize_flag_map;
+  bool do_lower_case;
+  int unk_token_id;
+
+  // Tokenizes text into at most max_len ids, returns the number of the ids
+  HOSTDEVICE int64_t operator()(const char* text,
+                                size_t size,
+                                int64_t* ids,
+                                int64_t max_len) const {
+    char word[kMaxWordpieceBytes];
+    int offsets[kMaxWordpieceChars + 1];
+    int num_chars = 0;
+    int64_t num_ids = 0;
+    offsets[0] = 0;
+
+    size_t pos = 0;
+    while (pos < size && num_ids < max_len) {
+      uint32_t chr = static_cast<uint8_t>(text[pos]);
+      uint32_t width = 1;
+      // no decoding for the ascii chars
+      if (chr >= 0x80) {
+        width = BytesInUtf8Char(static_cast<uint8_t>(text[pos]));
+        if (pos + width > size) {
+          break;
+        }
+        UTF8ToUInt32(text + pos, &chr);
+        chr = UTF8ToUnicode(chr);
+      }
+      pos += width;
+
+      uint8_t flag = GetTokenizeFlag(tokenize_flag_map, chr);
+      if (chr == 0 || chr == 0xFFFD || (flag & kTokenizeControl)) {
+        continue;
+      }
+      if (do_lower_case) {
+        if (chr < 0x80) {
+          chr = ('A' <= chr && chr <= 'Z') ? chr + ('a' - 'A') : chr;
+        } else if (chr <= 0xFFFF && IsUpper(unicode_flag_map[chr])) {
+          chr = cases_map[chr];
+        }
+      }
+      if (flag & (kTokenizeChinese | kTokenizePunct)) {
+        num_ids = EmitWord(word, offsets, &num_chars, ids, num_ids, max_len);
+        AppendChar(chr, word, offsets, &num_chars);
+        num_ids = EmitWord(word, offsets, &num_chars, ids, num_ids, max_len);
+      } else if (flag & kTokenizeSpace) {
+        num_ids = EmitWord(word, offsets, &num_chars, ids, num_ids, max_len);
+      } else {
+        AppendChar(chr, word, offsets, &num_chars);
+      }
+    }
+    return EmitWord(word, offsets, &num_chars, ids, num_ids, max_len);
+  }
+
+ private:
+  // Appends the utf8 bytes of chr to word, only counts the chars after the
+  // kMaxWordpieceChars ones
+  HOSTDEVICE static void AppendChar(uint32_t chr,
+                                    char* word,
+                                    int* offsets,
+                                    int* num_chars) {
+    if (*num_chars < kMaxWordpieceChars) {
+      char* dst = word + offsets[*num_chars];
+      uint32_t width = 1;
+      if (chr < 0x80) {
+        *dst = static_cast<char>(chr);
+      } else {
+        width = UnicodeToUTF8Char(UnicodeToUTF8(chr), dst);
+      }
+      offsets[*num_chars + 1] = offsets[*num_chars] + width;
+    }
+    ++(*num_chars);
+  }
+
+  // Emits the wordpieces of word and clears it
+  HOSTDEVICE int64_t EmitWord(const char* word,
+                              const int* offsets,
+                              int* num_chars,
+                              int64_t* ids,
+                              int64_t num_ids,
+                              int64_t max_len) const {
+    const int len = *num_chars;
+    *num_chars = 0;
+    if (len == 0) {
+      return num_ids;
+    }
+
+    int pieces[kMaxWordpieceChars];
+    int num_pieces = 0;
+    if (len > kMaxWordpieceChars) {
+      pieces[num_pieces++] = unk_token_id;
+    } else {
+      int start = 0;
+      while (start < len) {
+        int end = len;
+        int id = -1;
+        while (start < end) {
+          id = table.Find(start > 0 ? "##" : "",
+                          start > 0 ? 2 : 0,
+                          word + offsets[start],
+                          offsets[end] - offsets[start]);
+          if (id >= 0) {
+            break;
+          }
+          --end;
+        }
+        if (id < 0) {
+          // the whole word is unknown once a piece is
+          num_pieces = 0;
+          pieces[num_pieces++] = unk_token_id;
+          break;
+        }
+        pieces[num_pieces++] = id;
+        start = end;
+      }
+    }
+    for (int i = 0; i < num_pieces && num_ids < max_len; ++i) {
+      ids[num_ids++] = pieces[i];
+    }
+    return num_ids;
+  }
+};
+
+}  // namespace strings
+}  // namespace phi
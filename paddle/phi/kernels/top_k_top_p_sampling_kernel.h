@@ -0,0 +1,44 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+
+// Sample a token of every row of the logits x [bsz, vocab_size] in one pass:
+//   1. the logits of the tokens in pre_ids are penalized by
+//      repetition_penalty, and all the logits are divided by temperature;
+//   2. the candidates are the top_k tokens (all if top_k <= 0) whose
+//      probabilities are at least min_p times the max one;
+//   3. of the candidates, the most probable ones whose probabilities sum up
+//      to top_p of the row are kept;
+//   4. a token is drawn from the kept ones.
+// out is the probability of the sampled token in the kept ones, and ids is
+// the token.
+template <typename T, typename Context>
+void TopKTopPSamplingKernel(const Context& dev_ctx,
+                            const DenseTensor& x,
+                            const DenseTensor& top_p,
+                            const paddle::optional<DenseTensor>& pre_ids,
+                            float temperature,
+                            int top_k,
+                            float min_p,
+                            float repetition_penalty,
+                            int seed,
+                            DenseTensor* out,
+                            DenseTensor* ids);
+
+}  // namespace phi
@@ -24,6 +24,7 @@ void WeightDequantizeKernel(const Context& dev_ctx,
                             const DenseTensor& scale,
                             const std::string& algo,
                             DataType out_dtype,
+                            const int32_t group_size,
                             DenseTensor* out);
 
 }  // namespace phi
@@ -26,5 +26,7 @@ void WeightOnlyLinearKernel(const Context& dev_ctx,
                             const DenseTensor& weight_scale,
                             const std::string& weight_dtype,
                             const int32_t arch,
+                            const int32_t group_size,
+                            const std::string& activation,
                             DenseTensor* out);
 }  // namespace phi
@@ -0,0 +1,319 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+// Replays the kernel calls of a kernel corpus, e.g. the one recorded from a
+// model program with FLAGS_kernel_corpus_path, on the registered phi kernels,
+// and reports the time, the achieved bandwidth and FLOPs against the peak of
+// the device of every call, failing on a regression against a baseline.
+
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_corpus.h"
+#include "paddle/phi/core/kernel_factory.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/declarations.h"
+#include "paddle/utils/flags.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/kernels/autotune/gpu_timer.h"
+#endif
+
+PD_DEFINE_string(corpus, "", "The kernel corpus to replay.");
+PD_DEFINE_string(filter, "", "The kernel to benchmark, all if empty.");
+PD_DEFINE_int32(burning, 10, "Burning times.");
+PD_DEFINE_int32(repeat, 100, "Repeat times.");
+PD_DEFINE_double(peak_bandwidth,
+                 0,
+                 "The peak bandwidth of the device in GB/s, which is queried "
+                 "from the gpu if 0.");
+PD_DEFINE_double(peak_gflops, 0, "The peak GFLOPs of the device.");
+PD_DEFINE_string(output,
+                 "kernel_benchmark.txt",
+                 "The results, which are a baseline of the later runs.");
+PD_DEFINE_string(baseline, "", "The results of a baseline run.");
+PD_DEFINE_double(regression_threshold,
+                 0.1,
+                 "The ratio of the baseline time a call may regress by.");
+
+namespace phi {
+namespace benchmark {
+
+struct BenchmarkResult {
+  double time_us{0};
+  double gbps{0};
+  double gflops{0};
+};
+
+int64_t Numel(const std::vector<int64_t>& dims) {
+  int64_t numel = 1;
+  for (auto dim : dims) {
+    numel *= dim;
+  }
+  return numel;
+}
+
+// The FLOPs of the compute bound kernels, 0 for the others.
+double EstimateFlops(const KernelCorpusEntry& entry) {
+  const auto& name = entry.kernel_name;
+  if (name == "matmul" && entry.inputs.size() == 2 &&
+      entry.outputs.size() == 1 && entry.attrs.size() >= 2) {
+    const auto& x = entry.inputs[0].dims;
+    if (x.empty()) {
+      return 0;
+    }
+    bool transpose_x = entry.attrs[0] == "true";
+    int64_t k = x.size() == 1 ? x[0]
+                : transpose_x ? x[x.size() - 2]
+                              : x.back();
+    return 2.0 * Numel(entry.outputs[0].dims) * k;
+  }
+  if ((name == "conv2d" || name == "conv3d" || name == "depthwise_conv2d") &&
+      entry.inputs.size() >= 2 && !entry.outputs.empty()) {
+    // the filter is [out_channels, in_channels / groups, kernel dims...]
+    const auto& filter = entry.inputs[1].dims;
+    if (filter.empty() || filter[0] == 0) {
+      return 0;
+    }
+    return 2.0 * Numel(entry.outputs[0].dims) * Numel(filter) / filter[0];
+  }
+  return 0;
+}
+
+double PeakBandwidth(const Place& place) {
+  if (FLAGS_peak_bandwidth > 0) {
+    return FLAGS_peak_bandwidth;
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (place.GetType() == AllocationType::GPU) {
+    const auto& prop =
+        phi::backends::gpu::GetDeviceProperties(place.GetDeviceId());
+    // double data rate, the clock in kHz and the bus width in bits
+    return 2.0 * prop.memoryClockRate * (prop.memoryBusWidth / 8) / 1.0e6;
+  }
+#endif
+  return 0;
+}
+
+void FillZeros(const Place& place, DenseTensor* tensor) {
+  const size_t bytes = tensor->numel() * SizeOf(tensor->dtype());
+  if (bytes == 0) {
+    return;
+  }
+#if defined(PADDLE_WITH_CUDA)
+  if (place.GetType() == AllocationType::GPU) {
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemset(tensor->data(), 0, bytes));
+    return;
+  }
+#elif defined(PADDLE_WITH_HIP)
+  if (place.GetType() == AllocationType::GPU) {
+    PADDLE_ENFORCE_GPU_SUCCESS(hipMemset(tensor->data(), 0, bytes));
+    return;
+  }
+#endif
+  std::memset(tensor->data(), 0, bytes);
+}
+
+// Runs a kernel call of the corpus, false if it can not run here.
+bool RunEntry(const KernelCorpusEntry& entry, BenchmarkResult* result) {
+  const auto& backend = entry.kernel_key.backend();
+  if (backend != Backend::CPU && backend != Backend::GPU &&
+      backend != Backend::GPUDNN) {
+    LOG(WARNING) << "Skip " << entry.kernel_name << " on " << backend;
+    return false;
+  }
+  if (!KernelFactory::Instance().HasKernel(entry.kernel_name,
+                                           entry.kernel_key)) {
+    LOG(WARNING) << "Skip " << entry.kernel_name << " without the kernel of "
+                 << entry.kernel_key;
+    return false;
+  }
+  const auto& kernel = KernelFactory::Instance().SelectKernel(
+      entry.kernel_name, entry.kernel_key);
+  const auto& args_def = kernel.args_def();
+  if (args_def.input_defs().size() != entry.inputs.size() ||
+      args_def.output_defs().size() != entry.outputs.size() ||
+      args_def.attribute_defs().size() != entry.attrs.size()) {
+    LOG(WARNING) << "Skip " << entry.kernel_name
+                 << " whose arguments mismatch the kernel";
+    return false;
+  }
+
+  auto place = TransToPhiPlace(backend);
+  auto* dev_ctx = DeviceContextPool::Instance().Get(place);
+  std::vector<DenseTensor> inputs(entry.inputs.size());
+  std::vector<DenseTensor> outputs(entry.outputs.size());
+  double bytes = 0;
+  KernelContext ctx(dev_ctx);
+  for (size_t i = 0; i < entry.inputs.size(); ++i) {
+    const auto& input = entry.inputs[i];
+    if (!input.defined) {
+      ctx.EmplaceBackInput(nullptr);
+      continue;
+    }
+    inputs[i].Resize(common::make_ddim(input.dims));
+    dev_ctx->Alloc(&inputs[i], input.dtype);
+    FillZeros(place, &inputs[i]);
+    bytes += inputs[i].numel() * SizeOf(input.dtype);
+    ctx.EmplaceBackInput(&inputs[i]);
+  }
+  for (size_t i = 0; i < entry.outputs.size(); ++i) {
+    const auto& output = entry.outputs[i];
+    if (!output.defined) {
+      ctx.EmplaceBackOutput(nullptr);
+      continue;
+    }
+    outputs[i].set_meta(
+        DenseTensorMeta(output.dtype, common::make_ddim(output.dims)));
+    bytes += Numel(output.dims) * SizeOf(output.dtype);
+    ctx.EmplaceBackOutput(&outputs[i]);
+  }
+  for (size_t i = 0; i < entry.attrs.size(); ++i) {
+    ctx.EmplaceBackAttr(ParseKernelCorpusAttribute(
+        entry.attrs[i], args_def.attribute_defs()[i].type_index, place));
+  }
+
+  for (int i = 0; i < FLAGS_burning; ++i) {
+    kernel(&ctx);
+  }
+  double elapsed_ms = 0;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (place.GetType() == AllocationType::GPU) {
+    auto stream = static_cast<GPUContext*>(dev_ctx)->stream();
+    GpuTimer timer;
+    timer.Start(stream);
+    for (int i = 0; i < FLAGS_repeat; ++i) {
+      kernel(&ctx);
+    }
+    timer.Stop(stream);
+    elapsed_ms = timer.ElapsedTime();
+  }
+#endif
+  if (place.GetType() != AllocationType::GPU) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < FLAGS_repeat; ++i) {
+      kernel(&ctx);
+    }
+    elapsed_ms = std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  }
+
+  result->time_us = elapsed_ms * 1000.0 / FLAGS_repeat;
+  result->gbps = bytes / (result->time_us * 1.0e3);
+  result->gflops = EstimateFlops(entry) / (result->time_us * 1.0e3);
+
+  std::stringstream ss;
+  ss << entry.kernel_name << ": " << result->time_us << " us, "
+     << result->gbps << " GB/s";
+  double peak_bandwidth = PeakBandwidth(place);
+  if (peak_bandwidth > 0) {
+    ss << " (" << result->gbps / peak_bandwidth * 100 << "% of peak)";
+  }
+  if (result->gflops > 0) {
+    ss << ", " << result->gflops << " GFLOPs";
+    if (FLAGS_peak_gflops > 0) {
+      ss << " (" << result->gflops / FLAGS_peak_gflops * 100 << "% of peak)";
+    }
+  }
+  LOG(INFO) << ss.str();
+  return true;
+}
+
+// The times of the calls of a results file, a call per line as
+// corpus_line \t time_us \t GB/s \t GFLOPs.
+std::map<std::string, double> LoadBaseline(const std::string& path) {
+  std::map<std::string, double> baseline;
+  std::ifstream file(path);
+  PADDLE_ENFORCE_EQ(
+      file.is_open(),
+      true,
+      phi::errors::Unavailable("Can not open the baseline %s.", path));
+  std::string line;
+  while (std::getline(file, line)) {
+    auto pos = line.find('\t');
+    if (pos != std::string::npos) {
+      baseline[line.substr(0, pos)] = std::stod(line.substr(pos + 1));
+    }
+  }
+  return baseline;
+}
+
+int RunAllBenchmark() {
+  std::ifstream corpus(FLAGS_corpus);
+  PADDLE_ENFORCE_EQ(
+      corpus.is_open(),
+      true,
+      phi::errors::Unavailable("Can not open the corpus %s.", FLAGS_corpus));
+  std::map<std::string, double> baseline;
+  if (!FLAGS_baseline.empty()) {
+    baseline = LoadBaseline(FLAGS_baseline);
+  }
+  std::ofstream output(FLAGS_output, std::ios::out | std::ios::trunc);
+
+  int num_regressions = 0;
+  std::string line;
+  while (std::getline(corpus, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    auto entry = ParseKernelCorpusEntry(line);
+    if (!FLAGS_filter.empty() && FLAGS_filter != entry.kernel_name) {
+      continue;
+    }
+    // the key of the baseline
+    line = SerializeKernelCorpusEntry(entry);
+    BenchmarkResult result;
+    if (!RunEntry(entry, &result)) {
+      continue;
+    }
+    output << line << '\t' << result.time_us << '\t' << result.gbps << '\t'
+           << result.gflops << '\n';
+
+    auto it = baseline.find(line);
+    if (it != baseline.end() &&
+        result.time_us > it->second * (1 + FLAGS_regression_threshold)) {
+      LOG(ERROR) << line << " regresses from " << it->second << " us to "
+                 << result.time_us << " us";
+      ++num_regressions;
+    }
+  }
+  if (num_regressions > 0) {
+    LOG(ERROR) << num_regressions << " kernel calls regress by more than "
+               << FLAGS_regression_threshold * 100 << "%";
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace benchmark
+}  // namespace phi
+
+int main(int argc, char* argv[]) {
+  paddle::flags::ParseCommandLineFlags(&argc, &argv);
+  google::InitGoogleLogging(argv[0]);
+  LOG(INFO) << "Burning " << FLAGS_burning << " times, Repeat " << FLAGS_repeat
+            << " times.";
+  return phi::benchmark::RunAllBenchmark();
+}
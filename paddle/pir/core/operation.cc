@@ -22,6 +22,7 @@
 #include "paddle/pir/core/op_info.h"
 #include "paddle/pir/core/op_result_impl.h"
 #include "paddle/pir/core/operation.h"
+#include "paddle/pir/core/operation_arena.h"
 #include "paddle/pir/core/program.h"
 #include "paddle/pir/core/region.h"
 #include "paddle/pir/core/utils.h"
@@ -75,7 +76,9 @@ Operation *Operation::Create(const std::vector<Value> &inputs,
   size_t base_size = result_mem_size + op_mem_size + operand_mem_size +
                      region_mem_size + block_operand_size;
   // 2. Malloc memory.
-  char *base_ptr = reinterpret_cast<char *>(aligned_malloc(base_size, 8));
+  OperationArena *arena = OperationArena::Current();
+  char *base_ptr = reinterpret_cast<char *>(
+      arena ? arena->Allocate(base_size) : aligned_malloc(base_size, 8));
 
   auto name = op_info ? op_info.name() : "";
   VLOG(6) << "Create Operation [" << name
@@ -99,6 +102,7 @@ Operation *Operation::Create(const std::vector<Value> &inputs,
                                            num_operands,
                                            num_regions,
                                            num_successors);
+  op->in_arena_ = arena != nullptr;
   base_ptr += sizeof(Operation);
   // 3.3. Construct OpOperands.
   if ((reinterpret_cast<uintptr_t>(base_ptr) & 0x7) != 0) {
@@ -143,6 +147,7 @@ Operation *Operation::Create(const std::vector<Value> &inputs,
 // sequence, and finally free memory.
 void Operation::Destroy() {
   VLOG(10) << "Destroy Operation [" << name() << "] ...";
+  bool in_arena = in_arena_;
   // 1. Deconstruct Regions.
   if (num_regions_ > 0) {
     for (size_t idx = 0; idx < num_regions_; idx++) {
@@ -190,7 +195,10 @@ void Operation::Destroy() {
 
   VLOG(6) << "Destroy Operation [" << name() << "]: {ptr = " << aligned_ptr
           << ", size = " << result_mem_size << "} done.";
-  aligned_free(aligned_ptr);
+  // The memory in an arena is released with the arena.
+  if (!in_arena) {
+    aligned_free(aligned_ptr);
+  }
 }
 
 IrContext *Operation::ir_context() const { return info_.ir_context(); }
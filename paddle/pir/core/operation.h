@@ -238,6 +238,9 @@ class IR_API alignas(8) Operation final
   Region *regions_{nullptr};
   Block *parent_{nullptr};
   Block::Iterator position_;
+
+  // Whether the memory is allocated in an OperationArena.
+  bool in_arena_{false};
 };
 
 }  // namespace pir
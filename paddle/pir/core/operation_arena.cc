@@ -0,0 +1,67 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/pir/core/operation_arena.h"
+
+#include <mutex>
+
+#include "paddle/common/enforce.h"
+#include "paddle/pir/core/utils.h"
+
+namespace pir {
+
+namespace {
+thread_local OperationArena *current_arena = nullptr;
+}  // namespace
+
+OperationArena::~OperationArena() {
+  for (auto *chunk : chunks_) {
+    aligned_free(chunk);
+  }
+}
+
+void *OperationArena::Allocate(size_t size) {
+  size = (size + 7) / 8 * 8;
+  std::lock_guard<pir::SpinLock> guard(lock_);
+  allocated_bytes_ += size;
+  if (size > kChunkSize / 4) {
+    // A large one takes a chunk of its own, so that the current chunk is not
+    // wasted.
+    void *mem = aligned_malloc(size, 8);
+    IR_ENFORCE(mem != nullptr, "Allocate %d bytes of the arena failed.", size);
+    chunks_.push_back(mem);
+    return mem;
+  }
+  if (cur_ == nullptr || static_cast<size_t>(end_ - cur_) < size) {
+    void *mem = aligned_malloc(kChunkSize, 8);
+    IR_ENFORCE(
+        mem != nullptr, "Allocate %d bytes of the arena failed.", kChunkSize);
+    chunks_.push_back(mem);
+    cur_ = static_cast<char *>(mem);
+    end_ = cur_ + kChunkSize;
+  }
+  void *mem = cur_;
+  cur_ += size;
+  return mem;
+}
+
+OperationArena *OperationArena::Current() { return current_arena; }
+
+OperationArena::Guard::Guard(OperationArena *arena) : prev_(current_arena) {
+  current_arena = arena;
+}
+
+OperationArena::Guard::~Guard() { current_arena = prev_; }
+
+}  // namespace pir
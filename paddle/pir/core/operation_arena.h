@@ -0,0 +1,82 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "paddle/pir/core/dll_decl.h"
+#include "paddle/pir/core/spin_lock.h"
+
+namespace pir {
+///
+/// \brief OperationArena is a bump pointer allocator of the memory of the
+/// operations, with their results, operands and regions, which is released
+/// in bulk when the arena is destroyed. The memory of an erased operation is
+/// not reused, so an arena fits the programs built once and destroyed as a
+/// whole.
+///
+/// The operations are created in the arena of the innermost
+/// OperationArena::Guard on the thread, and must be destroyed before the
+/// arena.
+///
+class IR_API OperationArena {
+ public:
+  OperationArena() = default;
+
+  ~OperationArena();
+
+  OperationArena(const OperationArena &) = delete;
+  OperationArena &operator=(const OperationArena &) = delete;
+
+  ///
+  /// \brief Allocate size bytes aligned to 8 bytes.
+  ///
+  void *Allocate(size_t size);
+
+  size_t allocated_bytes() const { return allocated_bytes_; }
+
+  ///
+  /// \brief The arena of the innermost guard on this thread, or nullptr.
+  ///
+  static OperationArena *Current();
+
+  ///
+  /// \brief Guard creates the operations in arena in its scope.
+  ///
+  class IR_API Guard {
+   public:
+    explicit Guard(OperationArena *arena);
+    ~Guard();
+
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+
+   private:
+    OperationArena *prev_;
+  };
+
+ private:
+  static constexpr size_t kChunkSize = 256 << 10;  // 256KB
+
+  std::vector<void *> chunks_;
+  char *cur_{nullptr};
+  char *end_{nullptr};
+  size_t allocated_bytes_{0};
+  // The passes may create operations on several threads.
+  pir::SpinLock lock_;
+};
+
+}  // namespace pir
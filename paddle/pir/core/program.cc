@@ -17,7 +17,11 @@
 
 namespace pir {
 
-Program::Program(IrContext* context) {
+Program::Program(IrContext* context, bool use_arena) {
+  if (use_arena) {
+    arena_ = std::make_unique<OperationArena>();
+  }
+  OperationArena::Guard guard(arena_.get());
   module_ = ModuleOp::Create(context, this);
 }
 
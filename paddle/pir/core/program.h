@@ -23,6 +23,7 @@
 #include "paddle/pir/core/builtin_attribute.h"
 #include "paddle/pir/core/builtin_op.h"
 #include "paddle/pir/core/operation.h"
+#include "paddle/pir/core/operation_arena.h"
 #include "paddle/pir/core/parameter.h"
 
 namespace pir {
@@ -40,7 +41,10 @@ class IR_API Program {
  public:
   using ParameterMap =
       std::unordered_map<std::string, std::unique_ptr<Parameter>>;
-  explicit Program(IrContext* context);
+  ///
+  /// \brief If use_arena, the program owns an OperationArena, see arena().
+  ///
+  explicit Program(IrContext* context, bool use_arena = false);
   Program(Program&&) = delete;
   Program(const Program& program) = delete;
   Program& operator=(const Program&) = delete;
@@ -61,12 +65,21 @@ class IR_API Program {
   void SetParameter(const std::string& name,
                     std::unique_ptr<Parameter>&& parameter);
 
+  ///
+  /// \brief The arena of the program, or nullptr. The operations built under
+  /// an OperationArena::Guard of it are released with the program, and must
+  /// not be moved to other programs.
+  ///
+  OperationArena* arena() const { return arena_.get(); }
+
   ParameterMap& parameters() { return parameters_; }
   void set_parameters(ParameterMap&& parameters) {
     parameters_ = std::move(parameters);
   }
 
  private:
+  // Declared first to be released after the operations in it.
+  std::unique_ptr<OperationArena> arena_;
   // computation graph
   ModuleOp module_;
   // weight
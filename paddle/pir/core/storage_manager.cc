@@ -14,7 +14,9 @@
 
 #include "paddle/pir/core/storage_manager.h"
 
+#include <array>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "paddle/common/enforce.h"
@@ -29,10 +31,12 @@ struct ParametricStorageManager {
       : destroy_(destroy) {}
 
   ~ParametricStorageManager() {  // NOLINT
-    for (const auto &instance : parametric_instances_) {
-      destroy_(instance.second);
+    for (auto &shard : shards_) {
+      for (const auto &instance : shard.parametric_instances) {
+        destroy_(instance.second);
+      }
+      shard.parametric_instances.clear();
     }
-    parametric_instances_.clear();
   }
 
   // Get the storage of parametric type, if not in the cache, create and
@@ -40,8 +44,11 @@ struct ParametricStorageManager {
   StorageBase *GetOrCreate(std::size_t hash_value,
                            std::function<bool(StorageBase *)> equal_func,
                            std::function<StorageBase *()> constructor) {
-    if (parametric_instances_.count(hash_value) != 0) {
-      auto pr = parametric_instances_.equal_range(hash_value);
+    auto &shard = shards_[hash_value % kNumShards];
+    std::lock_guard<pir::SpinLock> guard(shard.lock);
+    auto &parametric_instances = shard.parametric_instances;
+    if (parametric_instances.count(hash_value) != 0) {
+      auto pr = parametric_instances.equal_range(hash_value);
       while (pr.first != pr.second) {
         if (equal_func(pr.first->second)) {
           VLOG(6) << "Found a cached parametric storage of: [param_hash="
@@ -52,7 +59,7 @@ struct ParametricStorageManager {
       }
     }
     StorageBase *storage = constructor();
-    parametric_instances_.emplace(hash_value, storage);
+    parametric_instances.emplace(hash_value, storage);
     VLOG(6) << "No cache found, construct and cache a new parametric storage "
                "of: [param_hash="
             << hash_value << ", storage_ptr=" << storage << "].";
@@ -60,9 +67,18 @@ struct ParametricStorageManager {
   }
 
  private:
-  // In order to prevent hash conflicts, the unordered_multimap data structure
-  // is used for storage.
-  std::unordered_multimap<size_t, StorageBase *> parametric_instances_;
+  // The instances are sharded by their hashes, so that the types and the
+  // attributes created on different threads do not wait for the same lock.
+  static constexpr size_t kNumShards = 16;
+
+  struct Shard {
+    pir::SpinLock lock;
+    // In order to prevent hash conflicts, the unordered_multimap data
+    // structure is used for storage.
+    std::unordered_multimap<size_t, StorageBase *> parametric_instances;
+  };
+
+  std::array<Shard, kNumShards> shards_;
   std::function<void(StorageBase *)> destroy_;
 };
 
@@ -75,31 +91,35 @@ StorageManager::StorageBase *StorageManager::GetParametricStorageImpl(
     std::size_t hash_value,
     std::function<bool(const StorageBase *)> equal_func,
     std::function<StorageBase *()> constructor) {
-  std::lock_guard<pir::SpinLock> guard(parametric_instance_lock_);
   VLOG(6) << "Try to get a parametric storage of: [TypeId_hash="
           << std::hash<pir::TypeId>()(type_id) << ", param_hash=" << hash_value
           << "].";
-  if (parametric_instance_.find(type_id) == parametric_instance_.end()) {
-    IR_THROW("The input data pointer is null.");
+  ParametricStorageManager *parametric_storage = nullptr;
+  {
+    std::shared_lock<std::shared_mutex> guard(parametric_instance_lock_);
+    auto it = parametric_instance_.find(type_id);
+    if (it == parametric_instance_.end()) {
+      IR_THROW("The input data pointer is null.");
+    }
+    parametric_storage = it->second.get();
   }
-  ParametricStorageManager &parametric_storage = *parametric_instance_[type_id];
-  return parametric_storage.GetOrCreate(hash_value, equal_func, constructor);
+  return parametric_storage->GetOrCreate(hash_value, equal_func, constructor);
 }
 
 StorageManager::StorageBase *StorageManager::GetParameterlessStorageImpl(
     TypeId type_id) {
-  std::lock_guard<pir::SpinLock> guard(parameterless_instance_lock_);
+  std::shared_lock<std::shared_mutex> guard(parameterless_instance_lock_);
   VLOG(6) << "Try to get a parameterless storage of: [TypeId_hash="
           << std::hash<pir::TypeId>()(type_id) << "].";
-  if (parameterless_instance_.find(type_id) == parameterless_instance_.end())
+  auto it = parameterless_instance_.find(type_id);
+  if (it == parameterless_instance_.end())
     IR_THROW("TypeId not found in IrContext.");
-  StorageBase *parameterless_instance = parameterless_instance_[type_id];
-  return parameterless_instance;
+  return it->second;
 }
 
 void StorageManager::RegisterParametricStorageImpl(
     TypeId type_id, std::function<void(StorageBase *)> destroy) {
-  std::lock_guard<pir::SpinLock> guard(parametric_instance_lock_);
+  std::unique_lock<std::shared_mutex> guard(parametric_instance_lock_);
   VLOG(6) << "Register a parametric storage of: [TypeId_hash="
           << std::hash<pir::TypeId>()(type_id) << "].";
   parametric_instance_.emplace(
@@ -108,7 +128,7 @@ void StorageManager::RegisterParametricStorageImpl(
 
 void StorageManager::RegisterParameterlessStorageImpl(
     TypeId type_id, std::function<StorageBase *()> constructor) {
-  std::lock_guard<pir::SpinLock> guard(parameterless_instance_lock_);
+  std::unique_lock<std::shared_mutex> guard(parameterless_instance_lock_);
   VLOG(6) << "Register a parameterless storage of: [TypeId_hash="
           << std::hash<pir::TypeId>()(type_id) << "].";
   if (parameterless_instance_.find(type_id) != parameterless_instance_.end())
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <memory>
+#include <shared_mutex>
 #include <type_traits>
 #include <unordered_map>
 
@@ -141,12 +142,14 @@ class IR_API StorageManager {
   std::unordered_map<TypeId, std::unique_ptr<ParametricStorageManager>>
       parametric_instance_;
 
-  pir::SpinLock parametric_instance_lock_;
+  // The instances of a type are guarded by the shards in
+  // ParametricStorageManager, this lock only guards the map.
+  std::shared_mutex parametric_instance_lock_;
 
   // This map is a mapping between type id and parameterless type storage.
   std::unordered_map<TypeId, StorageBase *> parameterless_instance_;
 
-  pir::SpinLock parameterless_instance_lock_;
+  std::shared_mutex parameterless_instance_lock_;
 };
 
 }  // namespace pir
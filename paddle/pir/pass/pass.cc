@@ -14,7 +14,15 @@
 
 #include "paddle/pir/pass/pass.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <unordered_set>
+
 #include "paddle/common/enforce.h"
+#include "paddle/pir/core/block_argument.h"
 #include "paddle/pir/core/ir_context.h"
 #include "paddle/pir/core/operation.h"
 #include "paddle/pir/core/program.h"
@@ -48,8 +56,10 @@ void Pass::PrintStatistics(const std::string& custom_log) const {
 }
 
 detail::PassExecutionState& Pass::pass_state() {
-  IR_ENFORCE(pass_state_.has_value() == true, "pass state has no value");
-  return *pass_state_;
+  std::lock_guard<pir::SpinLock> guard(pass_states_lock_);
+  auto it = pass_states_.find(std::this_thread::get_id());
+  IR_ENFORCE(it != pass_states_.end(), "pass state has no value");
+  return it->second;
 }
 
 //===----------------------------------------------------------------------===//
@@ -79,6 +89,45 @@ void PatternRewritePass::Run(Operation* op) {
 //----------------------------------------------------------------------------------------------//
 // PassAdaptor
 //----------------------------------------------------------------------------------------------//
+namespace {
+
+// Whether the ops in the regions of op use no values defined outside op, so
+// that the passes on op do not change the use lists shared with other ops.
+bool IsIsolatedFromAbove(Operation* op) {
+  std::unordered_set<Operation*> inner_ops;
+  std::unordered_set<Block*> inner_blocks;
+  std::vector<Operation*> stack{op};
+  while (!stack.empty()) {
+    auto* cur = stack.back();
+    stack.pop_back();
+    inner_ops.insert(cur);
+    for (size_t i = 0; i < cur->num_regions(); ++i) {
+      for (auto& block : cur->region(i)) {
+        inner_blocks.insert(&block);
+        for (auto& inner_op : block) {
+          stack.push_back(&inner_op);
+        }
+      }
+    }
+  }
+  for (auto* inner_op : inner_ops) {
+    if (inner_op == op) continue;
+    for (uint32_t i = 0; i < inner_op->num_operands(); ++i) {
+      auto value = inner_op->operand_source(i);
+      if (!value) continue;
+      if (value.isa<OpResult>()) {
+        if (!inner_ops.count(value.dyn_cast<OpResult>().owner())) return false;
+      } else if (value.isa<BlockArgument>()) {
+        if (!inner_blocks.count(value.dyn_cast<BlockArgument>().owner()))
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 void detail::PassAdaptor::Run(Operation* op, uint8_t opt_level, bool verify) {
   RunImpl(op, opt_level, verify);
 }
@@ -88,19 +137,92 @@ void detail::PassAdaptor::RunImpl(Operation* op,
                                   bool verify) {
   auto last_am = analysis_manager();
 
+  bool parallel = pm_->num_threads_ > 1 && !last_am.GetPassInstrumentor() &&
+                  std::all_of(pm_->passes().begin(),
+                              pm_->passes().end(),
+                              [](const std::unique_ptr<Pass>& pass) {
+                                return pass->IsThreadSafe();
+                              });
+  std::vector<Operation*> concurrent_ops;
   for (size_t i = 0; i < op->num_regions(); ++i) {
     auto& region = op->region(i);
     for (auto& block : region) {
       for (auto& op : block) {
+        if (parallel && op.num_regions() > 0 && IsIsolatedFromAbove(&op)) {
+          concurrent_ops.push_back(&op);
+          continue;
+        }
         AnalysisManagerHolder am(&op, last_am.GetPassInstrumentor());
         if (!RunPipeline(*pm_, &op, am, opt_level, verify))
           return SignalPassFailure();
       }
     }
   }
+  if (!RunConcurrently(concurrent_ops, opt_level, verify)) {
+    return SignalPassFailure();
+  }
   return;
 }
 
+bool detail::PassAdaptor::RunConcurrently(const std::vector<Operation*>& ops,
+                                          uint8_t opt_level,
+                                          bool verify) {
+  int num_threads = std::min(pm_->num_threads_, static_cast<int>(ops.size()));
+  if (num_threads <= 1) {
+    for (auto* op : ops) {
+      AnalysisManagerHolder am(op, nullptr);
+      if (!RunPipeline(*pm_, op, am, opt_level, verify)) return false;
+    }
+    return true;
+  }
+
+  std::atomic<size_t> next{0};
+  std::atomic<bool> failed{false};
+  auto ClearPassStates = [this]() {
+    std::vector<Pass*> passes{pm_->pass_adaptor_.get()};
+    for (auto& pass : pm_->passes()) passes.push_back(pass.get());
+    for (auto* pass : passes) {
+      std::lock_guard<pir::SpinLock> guard(pass->pass_states_lock_);
+      pass->pass_states_.erase(std::this_thread::get_id());
+    }
+  };
+  auto worker = [&]() {
+    try {
+      for (size_t i = next.fetch_add(1); i < ops.size() && !failed;
+           i = next.fetch_add(1)) {
+        AnalysisManagerHolder am(ops[i], nullptr);
+        if (!RunPipeline(*pm_, ops[i], am, opt_level, verify)) {
+          failed = true;
+        }
+      }
+    } catch (...) {
+      failed = true;
+      ClearPassStates();
+      throw;
+    }
+    // The states of the passes on this thread are not used any more.
+    ClearPassStates();
+  };
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < num_threads; ++i) {
+    futures.emplace_back(std::async(std::launch::async, worker));
+  }
+  std::exception_ptr error;
+  for (auto& future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return !failed;
+}
+
 bool detail::PassAdaptor::RunPipeline(const PassManager& pm,
                                       Operation* op,
                                       AnalysisManager am,
@@ -138,7 +260,11 @@ bool detail::PassAdaptor::RunPass(Pass* pass,
                                   bool verify) {
   if (opt_level < pass->pass_info().opt_level) return true;
 
-  pass->pass_state_ = PassExecutionState(op, am);
+  {
+    std::lock_guard<pir::SpinLock> guard(pass->pass_states_lock_);
+    pass->pass_states_.insert_or_assign(std::this_thread::get_id(),
+                                        PassExecutionState(op, am));
+  }
 
   PassInstrumentor* instrumentor = am.GetPassInstrumentor();
 
@@ -16,9 +16,12 @@
 
 #include <cstdint>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "paddle/pir/core/builtin_op.h"
+#include "paddle/pir/core/spin_lock.h"
 #include "paddle/pir/pass/analysis_manager.h"
 #include "paddle/pir/pattern_rewrite/pattern_rewrite_driver.h"
 
@@ -89,6 +92,10 @@ class IR_API Pass {
 
   virtual bool Initialize(IrContext* context) { return true; }
 
+  /// Whether the pass can run on different ops concurrently, i.e. it keeps
+  /// no state across the runs and changes the IR inside the op only.
+  virtual bool IsThreadSafe() const { return false; }
+
   void PrintStatistics(int64_t match_count) const;
 
   void PrintStatistics(int64_t match_count, int64_t all_count) const;
@@ -104,7 +111,10 @@ class IR_API Pass {
  private:
   detail::PassInfo pass_info_;
 
-  std::optional<detail::PassExecutionState> pass_state_;
+  // The execution states of the pass on the threads running it.
+  std::unordered_map<std::thread::id, detail::PassExecutionState> pass_states_;
+
+  pir::SpinLock pass_states_lock_;
 
   friend class PassManager;
   friend class detail::PassAdaptor;
@@ -124,6 +134,8 @@ class PatternRewritePass : public Pass {
 
   void Run(Operation* op) override;
 
+  bool IsThreadSafe() const override { return true; }
+
  private:
   FrozenRewritePatternSet patterns_;
 };
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "paddle/pir/pass/pass.h"
 
 namespace pir {
@@ -34,6 +36,12 @@ class PassAdaptor final : public Pass {
  private:
   void RunImpl(Operation* op, uint8_t opt_level, bool verify);
 
+  // Run the pipeline on ops concurrently, return false if it fails on any of
+  // them.
+  bool RunConcurrently(const std::vector<Operation*>& ops,
+                       uint8_t opt_level,
+                       bool verify);
+
   static bool RunPass(Pass* pass,
                       Operation* op,
                       AnalysisManager am,
@@ -115,6 +115,12 @@ class IR_API PassManager {
 
   void EnablePassTiming(bool print_module = true);
 
+  /// Run the pipeline on the nested ops in the regions of an op with
+  /// num_threads threads, when all the passes are thread safe and no
+  /// instrumentation is added. Only the nested ops whose regions use no
+  /// values defined outside them are run concurrently.
+  void EnableParallelRun(int num_threads) { num_threads_ = num_threads; }
+
   void AddInstrumentation(std::unique_ptr<PassInstrumentation> pi);
 
  private:
@@ -129,6 +135,8 @@ class IR_API PassManager {
 
   bool verify_{true};
 
+  int num_threads_{1};
+
   std::vector<std::unique_ptr<Pass>> passes_;
 
   std::unique_ptr<Pass> pass_adaptor_;
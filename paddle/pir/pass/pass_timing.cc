@@ -64,10 +64,7 @@ class PassTimer : public PassInstrumentation {
   }
 
   void RunBeforePass(Pass* pass, Operation* op) override {
-    if (!pass_timers_.count(op)) {
-      pass_timers_[op] = {};
-    }
-    pass_timers_[op][pass->name()] = Timer();
+    // The time of a pass run more than once on op is accumulated.
     pass_timers_[op][pass->name()].Start();
   }
 
@@ -83,8 +83,14 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
 
       num_rewrites = ProcessWorklist();
       sum_num_rewrites += num_rewrites;
+      // The ops around the changed ops are visited in the worklist already.
+      if (!config_.scan_until_fixpoint && worklist_.empty()) {
+        num_rewrites = 0;
+      }
     } while (num_rewrites != 0);
     bool converged = num_rewrites == 0;
+    VLOG(4) << "PatternRewrite visits " << num_visits_ << " ops and rewrites "
+            << sum_num_rewrites << " times in " << iteration << " iterations";
     return std::make_pair(converged, sum_num_rewrites);
   }
 
@@ -99,6 +105,7 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
       auto* op = PopFromWorklist();
       if (op == nullptr) continue;
       VLOG(6) << "PopFromWorklist, get op: " << op->name();
+      ++num_visits_;
 
       // TODO(wilber): ir is dead.
       // ...
@@ -114,25 +121,25 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
     return num_rewrites;
   }
 
-  // TODO(wilber): OpResult support GetUsers method.
+  // The users of op will use the replacement, and may match now.
   void NotifyRootReplaced(pir::Operation* op,
                           const std::vector<pir::Value>& replacement) override {
-    //   for (uint32_t i = 0; i < op->num_results(); ++i) {
-    //     auto res = op->GetResultByIndex(i);
-    //   }
-    // }
+    AddUsersToWorklist(op);
   }
 
-  void FinalizeRootUpdate(pir::Operation* op) override { AddToWorklist(op); }
+  void FinalizeRootUpdate(pir::Operation* op) override {
+    AddToWorklist(op);
+    AddUsersToWorklist(op);
+    AddProducersToWorklist(op);
+  }
 
   void NotifyOperationRemoved(pir::Operation* op) override {
     for (uint32_t i = 0; i < op->num_operands(); ++i) {
       AddOperandToWorklist(op->operand_source(i));
     }
 
-    if (op->num_regions() == 0) {
-      RemoveFromWorklist(op);
-    } else {
+    RemoveFromWorklist(op);
+    if (op->num_regions() != 0) {
       for (uint32_t i = 0; i < op->num_regions(); ++i) {
         auto& region = op->region(i);
         for (auto& block : region) {
@@ -152,6 +159,7 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
     if (config_.strict_mode == pir::GreedyRewriteStrictness::ExistingAndNewOps)
       strict_mode_filtered_ops_.insert(op);
     AddToWorklist(op);
+    AddProducersToWorklist(op);
   }
 
   /// Add the given operation to the worklist.
@@ -182,6 +190,25 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
     }
   }
 
+  void AddUsersToWorklist(pir::Operation* op) {
+    for (uint32_t i = 0; i < op->num_results(); ++i) {
+      auto res = op->result(i);
+      for (auto it = res.use_begin(); it != res.use_end(); ++it) {
+        AddToWorklist(it.owner());
+      }
+    }
+  }
+
+  // The producers see the changed op as a new user.
+  void AddProducersToWorklist(pir::Operation* op) {
+    for (uint32_t i = 0; i < op->num_operands(); ++i) {
+      auto operand = op->operand_source(i);
+      if (!operand) continue;
+      if (auto* def_op = operand.dyn_cast<pir::OpResult>().owner())
+        AddToWorklist(def_op);
+    }
+  }
+
   /// Pop the next operation from the worklist
   pir::Operation* PopFromWorklist() {
     auto* op = worklist_.back();
@@ -206,6 +233,7 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
   std::unordered_set<pir::Operation*> strict_mode_filtered_ops_;
   pir::Region& region_;
   pir::PatternApplicator matcher_;
+  int64_t num_visits_{0};
 };
 
 }  // namespace
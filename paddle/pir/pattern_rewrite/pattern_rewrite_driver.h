@@ -42,6 +42,12 @@ class IR_API GreedyRewriteConfig {
   /// pattern, use `kNolimit` to represent unlimited.
   int64_t max_iterations = 10;
 
+  /// Whether to scan all the ops of the region again in a new iteration after
+  /// the worklist is drained, until no pattern is applied. Otherwise only the
+  /// users and producers of the changed ops are revisited in one iteration,
+  /// which is enough for the patterns changing the IR by the rewriter.
+  bool scan_until_fixpoint = false;
+
   /// Control the upper limit of rewrite times during each iteration, use
   /// kNoLimit to represent unlimited.
   int64_t max_num_rewrites = kNoLimit;
@@ -61,8 +67,9 @@ class IR_API GreedyRewriteConfig {
 };
 
 /// Perform the Match and Rewrite process in the specified region, greedily
-/// apply the Pattern with the highest benefit, and repeat this process until
-/// convergence or the upper limit of iterations.
+/// apply the Pattern with the highest benefit, and repeat this process on the
+/// ops around the changed ops until convergence or the upper limit of
+/// iterations.
 ///
 /// Returns pair<bool,int64_t>
 // the first is true if the iteration converges and no patterns can be applied.
@@ -63,6 +63,8 @@ from .framework.dtype import (
     float32,
     float64,
     bfloat16,
+    float8_e4m3fn,
+    float8_e5m2,
     bool,
     complex64,
     complex128,
@@ -572,6 +574,8 @@ __all__ = [
     'float32',
     'float64',
     'bfloat16',
+    'float8_e4m3fn',
+    'float8_e5m2',
     'bool',
     'complex64',
     'complex128',
@@ -467,6 +467,9 @@ def amp_guard(
             tracer._amp_dtype = original_amp_dtype
             if amp_level == AMP_LEVEL.O2:
                 tracer._use_promote = original_use_promote
+            # the casts reused in the region are released, since the
+            # parameters may be updated out of it
+            core.eager.clear_amp_cast_cache()
 
 
 class StateDictHook:
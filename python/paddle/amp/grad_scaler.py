@@ -128,6 +128,9 @@ class AmpScaler:
             self._decr_every_n_nan_or_inf = decr_every_n_nan_or_inf
             self._incr_count = 0
             self._decr_count = 0
+            # The counts on the device, see _update_on_device.
+            self._incr_count_tensor = None
+            self._decr_count_tensor = None
             self._use_dynamic_loss_scaling = use_dynamic_loss_scaling
 
             self._found_inf = to_variable(np.array([0]).astype(np.bool_))
@@ -381,6 +384,11 @@ class AmpScaler:
         if not self._enable:
             return
 
+        if isinstance(self._cache_founf_inf, core.eager.Tensor):
+            self._update_on_device()
+            return
+
+        self._sync_counts()
         if self._cache_founf_inf:
             self._incr_count = 0
             self._decr_count = self._decr_count + 1
@@ -403,6 +411,46 @@ class AmpScaler:
 
         return
 
+    def _update_on_device(self):
+        """
+        Updates the loss_scaling by the found_inf tensor the optimizer skipped
+        the update with, so that the step needs no host sync.
+        """
+        if self._incr_count_tensor is None:
+            self._incr_count_tensor = to_variable(
+                np.array([self._incr_count]).astype(np.int32)
+            )
+            self._decr_count_tensor = to_variable(
+                np.array([self._decr_count]).astype(np.int32)
+            )
+            # update_loss_scaling zeros its x when found_inf, but the grads
+            # are left to the optimizer, so a placeholder is passed.
+            self._update_placeholder = to_variable(
+                np.zeros([1]).astype(np.float32)
+            )
+        _C_ops.update_loss_scaling_(
+            [self._update_placeholder],
+            self._cache_founf_inf,
+            self._scale,
+            self._incr_count_tensor,
+            self._decr_count_tensor,
+            self._incr_every_n_steps,
+            self._decr_every_n_nan_or_inf,
+            self._incr_ratio,
+            self._decr_ratio,
+            False,
+        )
+
+    def _sync_counts(self):
+        """
+        Copies the counts on the device of _update_on_device to the host.
+        """
+        if self._incr_count_tensor is not None:
+            self._incr_count = int(self._incr_count_tensor)
+            self._decr_count = int(self._decr_count_tensor)
+            self._incr_count_tensor = None
+            self._decr_count_tensor = None
+
     def is_enable(self):
         """
         Enable loss scaling or not.
@@ -531,6 +579,8 @@ class AmpScaler:
             decr_count(int): The number of recent consecutive skipped steps.
             use_dynamic_loss_scaling(bool): Whether to use dynamic loss scaling. If False, fixed loss_scaling is used. If True, the loss scaling is updated dynamicly. Default is True.
         """
+        if self._enable:
+            self._sync_counts()
         return (
             {
                 "scale": self._scale.numpy(),
@@ -572,6 +622,8 @@ class AmpScaler:
         self._decr_every_n_nan_or_inf = state_dict["decr_every_n_nan_or_inf"]
         self._incr_count = state_dict["incr_count"]
         self._decr_count = state_dict["decr_count"]
+        self._incr_count_tensor = None
+        self._decr_count_tensor = None
         self._use_dynamic_loss_scaling = state_dict["use_dynamic_loss_scaling"]
 
 
@@ -27,6 +27,7 @@ from .autograd import hessian, jacobian
 from .backward_mode import backward
 from .py_layer import PyLayer, PyLayerContext
 from .saved_tensors_hooks import saved_tensors_hooks
+from .saved_tensors_offload import saved_tensors_offload
 
 __all__ = [
     'jacobian',
@@ -35,4 +36,5 @@ __all__ = [
     'PyLayer',
     'PyLayerContext',
     'saved_tensors_hooks',
+    'saved_tensors_offload',
 ]
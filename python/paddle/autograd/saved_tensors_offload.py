@@ -0,0 +1,81 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from paddle.base import core
+
+__all__ = []
+
+
+class saved_tensors_offload:
+    """
+    Dynamic graph, offloads the tensors saved for backward by the operations
+    in the context to the pinned host memory, and reloads them to the device
+    in backward, to trade the time of the copies for the device memory of
+    the activations.
+
+    The copies run on a side stream of the device. When a saved tensor is
+    reloaded, the tensors saved before it, which backward uses next, are
+    prefetched, so that the copies overlap the computation of backward.
+    Only the tensors on GPU are offloaded, and the tensors also saved by
+    `paddle.autograd.saved_tensors_hooks` are left to the hooks.
+
+    Parameters:
+        min_bytes (int, optional): The saved tensors smaller than it are kept
+            on the device. Default: 1048576.
+        prefetch_depth (int, optional): The number of saved tensors prefetched
+            ahead of use in backward. Default: 2.
+
+    Returns:
+            None
+
+    Examples:
+        .. code-block:: python
+
+        >>> import paddle
+
+        >>> linear1 = paddle.nn.Linear(1024, 1024)
+        >>> linear2 = paddle.nn.Linear(1024, 1024)
+        >>> x = paddle.randn([64, 1024])
+        >>> with paddle.autograd.saved_tensors_offload():
+        ...     y = linear1(x)
+        >>> y = linear2(y)
+        >>> y.sum().backward()
+        >>> stats = paddle.autograd.saved_tensors_offload.stats()
+    """
+
+    def __init__(self, min_bytes=1 << 20, prefetch_depth=2):
+        self.min_bytes = min_bytes
+        self.prefetch_depth = prefetch_depth
+
+    def __enter__(self):
+        core.eager.enable_saved_tensors_offload(
+            self.min_bytes, self.prefetch_depth
+        )
+
+    def __exit__(self, *args):
+        core.eager.disable_saved_tensors_offload()
+
+    @staticmethod
+    def stats():
+        """
+        Return the statistics of the saved tensors offloaded, as a dict of
+        the number and the bytes offloaded, the bytes on the host and the
+        peak of them, the bytes prefetched and the bytes reloaded on use without
+        prefetched, and the host time in milliseconds to offload and reload.
+        """
+        return core.eager.saved_tensors_offload_stats()
+
+    @staticmethod
+    def reset_stats():
+        core.eager.reset_saved_tensors_offload_stats()
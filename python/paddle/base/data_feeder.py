@@ -43,6 +43,10 @@ _PADDLE_DTYPE_2_NUMPY_DTYPE = {
     core.VarDesc.VarType.UINT8: 'uint8',
     core.VarDesc.VarType.COMPLEX64: 'complex64',
     core.VarDesc.VarType.COMPLEX128: 'complex128',
+    # numpy does not support fp8, its bits are kept in uint8 like the ones of
+    # bfloat16 in uint16
+    core.VarDesc.VarType.FP8_E4M3FN: 'uint8',
+    core.VarDesc.VarType.FP8_E5M2: 'uint8',
 }
 
 _NUMPY_DTYPE_2_PADDLE_DTYPE = {
@@ -73,6 +77,8 @@ _PADDLE_PIR_DTYPE_2_NUMPY_DTYPE = {
     core.DataType.UINT8: 'uint8',
     core.DataType.COMPLEX64: 'complex64',
     core.DataType.COMPLEX128: 'complex128',
+    core.DataType.FLOAT8_E4M3FN: 'uint8',
+    core.DataType.FLOAT8_E5M2: 'uint8',
 }
 
 
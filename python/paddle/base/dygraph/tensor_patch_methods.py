@@ -864,6 +864,54 @@ def monkey_patch_tensor():
             array = array.astype(dtype)
         return array
 
+    def __dlpack__(self, stream=None):
+        """
+        Encodes the Tensor to DLPack by the protocol of the Python array API,
+        which shares the memory of the Tensor.
+
+        Args:
+            stream (int|None, optional): The stream of the consumer on GPU,
+                which waits for the kernels writing the Tensor on the device
+                instead of synchronizing the device. It is the handle of the
+                stream, 1 or None for the legacy default stream, 2 for the
+                per-thread default stream, and -1 to skip the
+                synchronization. Default: None.
+
+        Returns:
+            PyCapsule: The DLPack of the Tensor.
+
+        Examples:
+            .. code-block:: python
+
+                >>> import paddle
+                >>> x = paddle.to_tensor([1.0, 2.0, 3.0])
+                >>> y = paddle.utils.dlpack.from_dlpack(x)
+                >>> print(y)
+                Tensor(shape=[3], dtype=float32, place=Place(cpu), stop_gradient=True,
+                [1., 2., 3.])
+        """
+        if stream is None:
+            stream = 1
+        return self.value().get_tensor()._to_dlpack(stream)
+
+    def __dlpack_device__(self):
+        """
+        Returns the DLPack device type and device id of the Tensor.
+
+        Returns:
+            tuple: The (device_type, device_id) of the Tensor.
+        """
+        from paddle.utils.dlpack import DLDeviceType
+
+        place = self.place
+        if place.is_gpu_place():
+            return (DLDeviceType.kDLGPU, place.gpu_device_id())
+        if place.is_cuda_pinned_place():
+            return (DLDeviceType.kDLCPUPinned, 0)
+        if place.is_cpu_place():
+            return (DLDeviceType.kDLCPU, 0)
+        raise ValueError(f"DLPack does not support the Tensor on {place}.")
+
     def pre_deal_index_and_value(self, item, value=None):
         # since in pybind there is no effiency way to transfer Py_Tuple/Py_List/Py_Range to Tensor
         # we call this function in python level.
@@ -1135,6 +1183,8 @@ def monkey_patch_tensor():
         ("__deepcopy__", __deepcopy__),
         ("__module__", "paddle"),
         ("__array__", __array__),
+        ("__dlpack__", __dlpack__),
+        ("__dlpack_device__", __dlpack_device__),
         ("__getitem__", __getitem__),
         ("item", item),
         ("__setitem__", __setitem__),
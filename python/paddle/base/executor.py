@@ -17,6 +17,7 @@ import logging
 import os
 import sys
 import warnings
+from collections import OrderedDict
 from functools import lru_cache
 
 import numpy as np
@@ -850,6 +851,44 @@ class _StandaloneExecutor:
         return new_exe
 
 
+def _get_executor_cache_capacity():
+    return get_flags('FLAGS_executor_cache_capacity')[
+        'FLAGS_executor_cache_capacity'
+    ]
+
+
+class _LRUCache:
+    """
+    A dict of at most capacity items, where the least recently used item is
+    dropped when a new one is added to the full cache.
+    """
+
+    def __init__(self, capacity):
+        self._capacity = capacity
+        self._items = OrderedDict()
+
+    def get(self, key, default=None):
+        if key not in self._items:
+            return default
+        self._items.move_to_end(key)
+        return self._items[key]
+
+    def __setitem__(self, key, value):
+        self._items[key] = value
+        self._items.move_to_end(key)
+        while len(self._items) > self._capacity:
+            self._items.popitem(last=False)
+
+    def __contains__(self, key):
+        return key in self._items
+
+    def __len__(self):
+        return len(self._items)
+
+    def clear(self):
+        self._items.clear()
+
+
 class _ExecutorCache:
     class _CachedData:
         def __init__(
@@ -903,19 +942,20 @@ class _ExecutorCache:
         def __hash__(self):
             return self.key
 
-    def __init__(self):
+    def __init__(self, capacity=8):
         # NOTE(Ruibiao): Wrap the lru_cache in constructor so that the cache is local to
         # the _ExecutorCache instance, otherwise a global cache may not be released after
         # the Executor instance deleted
-        self._get_cached_program_and_executor = lru_cache(maxsize=8)(
+        self._get_cached_program_and_executor = lru_cache(maxsize=capacity)(
             self._get_program_and_executor
         )
-        self._get_cached_program_and_executor_pir_mode = lru_cache(maxsize=8)(
-            self._get_pir_program_and_executor
-        )
+        self._get_cached_program_and_executor_pir_mode = lru_cache(
+            maxsize=capacity
+        )(self._get_pir_program_and_executor)
 
     def clear(self):
         self._get_cached_program_and_executor.cache_clear()
+        self._get_cached_program_and_executor_pir_mode.cache_clear()
 
     def get_program_and_executor(
         self,
@@ -1185,25 +1225,30 @@ class Executor:
             self.place = expected_place
         else:
             self.place = framework._get_paddle_place(place)
-        self.program_caches = {}
-        self.ctx_caches = {}
+        # NOTE: The prepared programs, contexts and scopes of the legacy
+        # executor share the capacity with the cache of the standalone
+        # executor, so that a job running many feed/fetch lists doesn't keep
+        # all of them.
+        cache_capacity = _get_executor_cache_capacity()
+        self.program_caches = _LRUCache(cache_capacity)
+        self.ctx_caches = _LRUCache(cache_capacity)
         self.trainer_caches = {}
-        self.scope_caches = {}
+        self.scope_caches = _LRUCache(cache_capacity)
         self.micro_scope_cache = {}
         self.var_caches = {}
-        self.pruned_program_caches = {}
+        self.pruned_program_caches = _LRUCache(cache_capacity)
         p = core.Place()
         p.set_place(self.place)
         self._default_executor = core.Executor(p)
         self._closed = False
-        self.pruned_program_scope_caches = {}
+        self.pruned_program_scope_caches = _LRUCache(cache_capacity)
         self._prepare_to_run_called = False
 
         self._auto_checkpoint_name = unique_name.generate(
             "__auto_checkpoint_executor__"
         )
 
-        self._executor_cache = _ExecutorCache()
+        self._executor_cache = _ExecutorCache(cache_capacity)
 
         self._fleet_executor = None
         # TODO(liyurui): This option will be removed and always true when the functionality
@@ -2651,7 +2696,7 @@ class Executor:
         nrank = len(trainer_endpoints)
 
         assert 'scheduler' in fleet_opt or 'tasks' in fleet_opt, (
-            "Fleet executor need configuration for scheduler, you can choose from 1F1B or Origin. "
+            "Fleet executor need configuration for scheduler, you can choose from 1F1B, VPP, ZBH1 or Origin. "
             "Or you can provide a list of task nodes to init fleet executor directly."
         )
         if 'tasks' in fleet_opt:
@@ -2683,6 +2728,20 @@ class Executor:
                     nrank,
                     with_standalone_executor,
                 )
+            elif scheduler in ['VPP', 'ZBH1']:
+                from paddle.distributed.fleet.fleet_executor_utils import (
+                    run_pipeline_schedule,
+                )
+
+                tasks, task_id_to_rank = run_pipeline_schedule(
+                    program,
+                    cur_rank,
+                    fleet_opt.get('num_micro_batches', 1),
+                    fleet_opt.get('dist_strategy', {}),
+                    nrank,
+                    scheduler,
+                    fleet_opt.get('num_model_chunks', 1),
+                )
             elif scheduler == 'Origin':
                 from paddle.distributed.fleet.fleet_executor_utils import origin
 
@@ -2699,7 +2758,7 @@ class Executor:
                     ), "For origin scheduler mode, the num micro batches should be 1."
                 tasks, task_id_to_rank = origin(program, cur_rank)
             else:
-                raise "Fleet_executor only supports 1F1B and Origin scheduler, " "but received " + str(
+                raise "Fleet_executor only supports 1F1B, VPP, ZBH1 and Origin scheduler, " "but received " + str(
                     scheduler
                 ) + "."
             # NOTE: have to hold these vars, otherwise will be destructed
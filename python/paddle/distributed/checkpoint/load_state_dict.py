@@ -316,6 +316,11 @@ def get_read_items(path, state_dict, process_group, use_dist):
             for storage_local_tensor_metadata in storage_state_dict_metadata[
                 tensor_key
             ]:
+                # Resharding only changes the distribution, not the shape.
+                global_shape = storage_local_tensor_metadata.global_shape
+                assert global_shape is None or tuple(global_shape) == tuple(
+                    val.shape
+                ), f"tensor_key:{tensor_key} is saved in global_shape:{global_shape}, but the global_shape to load is {val.shape}."
                 if not_overlap(
                     cur_chunk_metadata, storage_local_tensor_metadata
                 ):
@@ -422,83 +427,96 @@ def load_state_dict(
         if v.place.is_cpu_place():
             state_dict_in_cpu.append(k)
             state_dict[k] = v.cuda()
+    cur_rank = paddle.distributed.get_rank()
+
+    def get_storage_chunk_tensor(item, file_name):
+        if file_name not in storage_file_to_state_dict:
+            # The value in state_dict is not distributed tensor but a normal tensor.
+            storage_file_to_state_dict[file_name] = paddle.load(
+                os.path.join(path, file_name)
+            )
+        storage_state_dict = storage_file_to_state_dict[file_name]
+        assert item.local_tensor_index.tensor_key in storage_state_dict
+        storage_local_tensor = storage_state_dict[
+            item.local_tensor_index.tensor_key
+        ]
+        storage_offsets = item.storage_offset
+        storage_lengths = item.lengths
+        storage_ends = [
+            storage_offset + storage_length
+            for storage_offset, storage_length in zip(
+                storage_offsets, storage_lengths
+            )
+        ]
+        # The storage_chunk_tensor and storage_local_tensor share the same memory.
+        return paddle.slice(
+            storage_local_tensor,
+            list(range(len(storage_lengths))),
+            storage_offsets,
+            storage_ends,
+        )
+
+    def get_cur_chunk_tensor(item):
+        assert (
+            item.local_tensor_index.tensor_key in state_dict
+        ), f"item:{item}, state_dict:{state_dict}"
+        cur_local_tensor = (
+            state_dict[item.local_tensor_index.tensor_key]._local_value()
+            if use_dist
+            and state_dict[item.local_tensor_index.tensor_key].is_dist()
+            else state_dict[item.local_tensor_index.tensor_key]
+        )
+        cur_offsets = item.cur_offset
+        cur_lengths = item.lengths
+        cur_ends = [
+            cur_offset + cur_length
+            for cur_offset, cur_length in zip(cur_offsets, cur_lengths)
+        ]
+        # The cur_chunk_tensor and cur_local_tensor share the same memory.
+        return paddle.slice(
+            cur_local_tensor,
+            list(range(len(cur_lengths))),
+            cur_offsets,
+            cur_ends,
+        )
+
     for item in read_items:
         assert (
             item.local_tensor_index in load_infos
         ), f"item:{item}, load_infos:{load_infos}"
         src_rank, file_name = load_infos[item.local_tensor_index]
-        storage_chunk_tensor = None
-        cur_chunk_tensor = None
-        # The src rank need to load the state_dict.
-        if src_rank == paddle.distributed.get_rank():
-            if file_name not in storage_file_to_state_dict:
-                # The value in state_dict is not distributed tensor but a normal tensor.
-                storage_file_to_state_dict[file_name] = paddle.load(
-                    os.path.join(path, file_name)
-                )
-            storage_state_dict = storage_file_to_state_dict[file_name]
-            assert item.local_tensor_index.tensor_key in storage_state_dict
-            storage_local_tensor = storage_state_dict[
-                item.local_tensor_index.tensor_key
-            ]
-            storage_offsets = item.storage_offset
-            storage_lengths = item.lengths
-            storage_ends = [
-                storage_offset + storage_length
-                for storage_offset, storage_length in zip(
-                    storage_offsets, storage_lengths
-                )
-            ]
-            # The storage_chunk_tensor and storage_local_tensor share the same memory.
-            storage_chunk_tensor = paddle.slice(
-                storage_local_tensor,
-                list(range(len(storage_lengths))),
-                storage_offsets,
-                storage_ends,
-            )
-        # The read item rank need to be assigned
-        if item.rank == paddle.distributed.get_rank():
-            assert (
-                item.local_tensor_index.tensor_key in state_dict
-            ), f"item:{item}, state_dict:{state_dict}"
-            cur_local_tensor = (
-                state_dict[item.local_tensor_index.tensor_key]._local_value()
-                if use_dist
-                and state_dict[item.local_tensor_index.tensor_key].is_dist()
-                else state_dict[item.local_tensor_index.tensor_key]
-            )
-            cur_offsets = item.cur_offset
-            cur_lengths = item.lengths
-            cur_ends = [
-                cur_offset + cur_length
-                for cur_offset, cur_length in zip(cur_offsets, cur_lengths)
-            ]
-            # The cur_chunk_tensor and cur_local_tensor share the same memory.
-            cur_chunk_tensor = paddle.slice(
-                cur_local_tensor,
-                list(range(len(cur_lengths))),
-                cur_offsets,
-                cur_ends,
-            )
-        else:
-            cur_chunk_tensor = paddle.zeros(
-                item.lengths,
-                dtype=state_dict[item.local_tensor_index.tensor_key].dtype,
-            )
+        # The read item rank reads the file itself if it can access it, e.g.
+        # on a shared filesystem, so that the resharding of a checkpoint
+        # saved in other parallel degrees needs no broadcast. rank_to_files
+        # is the same in all ranks, so are the choices.
+        if file_name in rank_to_files.get(item.rank, []):
+            src_rank = item.rank
 
         if src_rank == item.rank:
-            # assign value locally
-            paddle.assign(storage_chunk_tensor, cur_chunk_tensor)
-        else:
-            # assign value remotely
-            if src_rank == paddle.distributed.get_rank():
-                paddle.distributed.broadcast(
-                    storage_chunk_tensor, src=src_rank, group=process_group
+            # assign value locally, the other ranks are not involved
+            if src_rank == cur_rank:
+                paddle.assign(
+                    get_storage_chunk_tensor(item, file_name),
+                    get_cur_chunk_tensor(item),
                 )
+        elif src_rank == cur_rank:
+            # assign value remotely
+            paddle.distributed.broadcast(
+                get_storage_chunk_tensor(item, file_name),
+                src=src_rank,
+                group=process_group,
+            )
+        else:
+            if item.rank == cur_rank:
+                cur_chunk_tensor = get_cur_chunk_tensor(item)
             else:
-                paddle.distributed.broadcast(
-                    cur_chunk_tensor, src=src_rank, group=process_group
+                cur_chunk_tensor = paddle.zeros(
+                    item.lengths,
+                    dtype=state_dict[item.local_tensor_index.tensor_key].dtype,
                 )
+            paddle.distributed.broadcast(
+                cur_chunk_tensor, src=src_rank, group=process_group
+            )
 
     for k, v in state_dict.items():
         if k in state_dict_in_cpu:
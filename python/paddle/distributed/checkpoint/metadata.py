@@ -19,11 +19,18 @@ from typing import Dict, List, Tuple
 @dataclass
 class LocalTensorMetadata:
     """
-    The location of a local tensor in the global tensor.
+    The location of a local tensor in the global tensor, with the
+    distribution it was saved under to reshard it on load. The global_shape,
+    process_mesh and dims_mapping are None for the metadata saved before them
+    or for a tensor not distributed.
     """
 
     global_offset: Tuple[int]
     local_shape: Tuple[int]
+    global_shape: Tuple[int] = None
+    # The (shape, process_ids) of the process mesh.
+    process_mesh: Tuple[Tuple[int], Tuple[int]] = None
+    dims_mapping: Tuple[int] = None
 
 
 @dataclass(frozen=True)
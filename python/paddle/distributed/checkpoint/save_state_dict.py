@@ -151,13 +151,24 @@ def save_state_dict(
                 if not local_shape or not global_offset:
                     continue
                 local_tensor = val._local_value()
+                process_mesh = (
+                    tuple(val.dist_attr.process_mesh.shape),
+                    tuple(val.dist_attr.process_mesh.process_ids),
+                )
+                dims_mapping = tuple(val.dist_attr.dims_mapping)
             else:
                 global_offset = [0] * len(val.shape)
                 local_shape = val.shape
                 local_tensor = val
+                process_mesh = None
+                dims_mapping = None
             local_state_dict[key] = local_tensor
             local_state_dict_metadata[key] = LocalTensorMetadata(
-                global_offset, local_shape
+                global_offset,
+                local_shape,
+                tuple(val.shape),
+                process_mesh,
+                dims_mapping,
             )
             local_storage_metadata[
                 LocalTensorIndex(key, tuple(global_offset))
@@ -177,6 +177,18 @@ def _set_custom_gid(gid):
     _custom_gid = gid
 
 
+def _split_from_default_group(backend, ranks, pg):
+    # The communicator of the new group is split from the one of the default
+    # group by ncclCommSplit, which all the ranks call together, instead of
+    # the rendezvous through the store. False if it is not supported.
+    if backend != 'nccl' or len(ranks) < 2:
+        return False
+    default_pg = _get_default_group().process_group
+    if not hasattr(default_pg, 'split_comm'):
+        return False
+    return default_pg.split_comm(ranks, pg)
+
+
 def new_group(ranks=None, backend=None, timeout=_default_timeout):
     """
 
@@ -243,7 +255,9 @@ def new_group(ranks=None, backend=None, timeout=_default_timeout):
         # three in the future.
         _add_new_group(group)
 
-        if int(os.getenv("FLAGS_eager_communication_connection", 0)) == 1:
+        if int(
+            os.getenv("FLAGS_eager_communication_connection", 0)
+        ) == 1 and not _split_from_default_group(backend, ranks, pg):
             paddle.distributed.all_reduce(
                 paddle.zeros([1], dtype=paddle.uint8), group=group, sync_op=True
             )
@@ -16,6 +16,7 @@ from .all_reduce import all_reduce  # noqa: F401
 from .all_to_all import alltoall, alltoall_single  # noqa: F401
 from .batch_isend_irecv import P2POp, batch_isend_irecv  # noqa: F401
 from .broadcast import broadcast, broadcast_object_list  # noqa: F401
+from .comm_stats import get_comm_stats  # noqa: F401
 from .gather import gather  # noqa: F401
 from .group import (  # noqa: F401
     barrier,
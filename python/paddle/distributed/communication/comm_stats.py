@@ -0,0 +1,57 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import json
+
+from paddle.framework import core
+
+
+def get_comm_stats():
+    """
+    Get the bus bandwidth stats of the communications of this rank.
+
+    The communications are timed on the device if both ``FLAGS_enable_async_trace``
+    and ``FLAGS_comm_stats_interval`` are set. Every ``FLAGS_comm_stats_interval``
+    seconds the ranks of a group exchange their bus bandwidth of the interval
+    through the store, a rank below ``FLAGS_comm_straggler_ratio`` of the
+    median of the group for ``FLAGS_comm_straggler_patience`` consecutive
+    intervals is a slow rank, and likewise a p2p link of this rank compared
+    with its other links is a slow link. They are also logged as warnings.
+
+    Returns:
+        dict: ``groups`` maps the group keys to their stats, of which
+        ``busbw_gbps`` is the bus bandwidth in GB/s of this rank in the last
+        interval, ``peer_busbw_gbps`` maps the global ranks of the group to
+        theirs, and ``slow_ranks`` and ``slow_link`` are the ranks and the
+        link found slow. ``records`` are the latest communications with their
+        bytes and device time. It is empty without NCCL.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env: DISTRIBUTED)
+            >>> import paddle
+            >>> import paddle.distributed as dist
+
+            >>> paddle.set_flags({'FLAGS_enable_async_trace': True,
+            ...                   'FLAGS_comm_stats_interval': 30})
+            >>> dist.init_parallel_env()
+            >>> # train for a while
+            >>> stats = dist.communication.get_comm_stats()
+            >>> for group_key, stat in stats['groups'].items():
+            ...     print(group_key, stat['busbw_gbps'], stat['slow_ranks'])
+    """
+    if not hasattr(core, 'get_comm_stats'):
+        return {'groups': {}, 'records': []}
+    return json.loads(core.get_comm_stats())
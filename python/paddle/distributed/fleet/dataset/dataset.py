@@ -378,6 +378,7 @@ class InMemoryDataset(DatasetBase):
         self.enable_pv_merge = False
         self.merge_by_lineid = False
         self.fleet_send_sleep_seconds = None
+        self.streaming_shuffle_fleet = None
 
     def _init_distributed_settings(self, **kwargs):
         """
@@ -392,6 +393,7 @@ class InMemoryDataset(DatasetBase):
                              you should parse line id in data generator. default is -1.
             parse_ins_id(bool): Set if Dataset need to parse ins_id. default is False.
             parse_content(bool): Set if Dataset need to parse content. default is False.
+            binary_slot_format(bool): Set if Dataset loads the columnar binary files. default is False.
             fleet_send_batch_size(int): Set fleet send batch size in one rpc, default is 1024
             fleet_send_sleep_seconds(int): Set fleet send sleep time, default is 0
             fea_eval(bool): Set if Dataset need to do feature importance evaluation using slots shuffle.
@@ -428,6 +430,9 @@ class InMemoryDataset(DatasetBase):
         parse_content = kwargs.get("parse_content", False)
         self._set_parse_content(parse_content)
 
+        binary_slot_format = kwargs.get("binary_slot_format", False)
+        self._set_binary_slot_format(binary_slot_format)
+
         fleet_send_batch_size = kwargs.get("fleet_send_batch_size", None)
         if fleet_send_batch_size:
             self._set_fleet_send_batch_size(fleet_send_batch_size)
@@ -466,6 +471,7 @@ class InMemoryDataset(DatasetBase):
                              you should parse line id in data generator. default is -1.
             parse_ins_id(bool): Set if Dataset need to parse ins_id. default is False.
             parse_content(bool): Set if Dataset need to parse content. default is False.
+            binary_slot_format(bool): Set if Dataset loads the columnar binary files. default is False.
             fleet_send_batch_size(int): Set fleet send batch size in one rpc, default is 1024
             fleet_send_sleep_seconds(int): Set fleet send sleep time, default is 0
             fea_eval(bool): Set if Dataset need to do feature importance evaluation using slots shuffle.
@@ -514,6 +520,8 @@ class InMemoryDataset(DatasetBase):
                 self._set_parse_ins_id(kwargs[key])
             elif key == "parse_content":
                 self._set_parse_content(kwargs[key])
+            elif key == "binary_slot_format":
+                self._set_binary_slot_format(kwargs[key])
             elif key == "fleet_send_batch_size":
                 self._set_fleet_send_batch_size(kwargs[key])
             elif key == "fleet_send_sleep_seconds":
@@ -714,6 +722,65 @@ class InMemoryDataset(DatasetBase):
         """
         self.parse_content = parse_content
 
+    def _set_binary_slot_format(self, binary_slot_format):
+        """
+        Set if Dataset loads the columnar binary files converted by
+        _convert_to_binary_slot_format, only for SlotRecordInMemoryDataFeed.
+
+        Args:
+            binary_slot_format(bool): if load binary files or not
+
+        Examples:
+            .. code-block:: python
+
+                >>> import paddle
+                >>> paddle.enable_static()
+                >>> dataset = paddle.distributed.InMemoryDataset()
+                >>> dataset._set_binary_slot_format(True)
+
+        """
+        self.proto_desc.binary_slot_format = binary_slot_format
+
+    def _convert_to_binary_slot_format(
+        self, src_path, dst_path, block_ins_num=4096
+    ):
+        """
+        Convert a text file of the used slots into a columnar binary file,
+        which is loaded without parsing. The ins_id and logkey are kept if
+        they are parsed by the Dataset.
+
+        Args:
+            src_path(str): the text file, read by the pipe command
+            dst_path(str): the binary file
+            block_ins_num(int): the number of instances in a compressed
+                                block. default is 4096.
+
+        Returns:
+            The number of the converted instances.
+
+        Examples:
+            .. code-block:: python
+
+                >>> # doctest: +SKIP('need to work with real dataset')
+                >>> import paddle
+                >>> paddle.enable_static()
+                >>> dataset = paddle.distributed.InMemoryDataset()
+                >>> dataset.init(use_var=slots_vars)
+                >>> dataset._convert_to_binary_slot_format("a.txt", "a.bin")
+
+        """
+        slots = self.proto_desc.multi_slot_desc.slots
+        return core.convert_slot_text_to_binary(
+            src_path,
+            dst_path,
+            [slot.name for slot in slots],
+            "".join(slot.type[0] for slot in slots),
+            self.parse_ins_id,
+            self.parse_logkey,
+            self.proto_desc.pipe_command,
+            block_ins_num,
+        )
+
     def _set_fleet_send_batch_size(self, fleet_send_batch_size=1024):
         """
         Set fleet send batch size, default is 1024
@@ -894,7 +961,10 @@ class InMemoryDataset(DatasetBase):
         """
         self._prepare_to_run()
         if not self.use_ps_gpu:
-            self.dataset.load_into_memory()
+            if self.streaming_shuffle_fleet is not None:
+                self._load_into_memory_with_global_shuffle()
+            else:
+                self.dataset.load_into_memory()
         elif core._is_compiled_with_heterps():
             self.psgpu.set_dataset(self.dataset)
             self.psgpu.load_into_memory(is_shuffle)
@@ -1010,6 +1080,51 @@ class InMemoryDataset(DatasetBase):
         """
         self.dataset.local_shuffle()
 
+    def _set_streaming_global_shuffle(self, fleet):
+        """
+        Set if Dataset shuffles the data to the trainers while loading it,
+        which takes the place of global_shuffle after load_into_memory.
+        The part of this trainer is kept without rpc, and the others are sent
+        by blocks of fleet_send_batch_size as the files are parsed.
+
+        Args:
+            fleet(Fleet): fleet singleton, None disables the streaming shuffle
+
+        Examples:
+            .. code-block:: python
+
+                >>> # doctest: +SKIP('need to work in distributed mode')
+                >>> import paddle
+                >>> from paddle.distributed import fleet
+                >>> paddle.enable_static()
+                >>> dataset = paddle.distributed.InMemoryDataset()
+                >>> dataset._set_streaming_global_shuffle(fleet)
+                >>> dataset.load_into_memory()
+
+        """
+        self.streaming_shuffle_fleet = fleet
+
+    def _load_into_memory_with_global_shuffle(self):
+        fleet = self.streaming_shuffle_fleet
+        fleet._role_maker.barrier_worker()
+        if self.fleet_send_batch_size is None:
+            self.fleet_send_batch_size = 1024
+        if self.fleet_send_sleep_seconds is None:
+            self.fleet_send_sleep_seconds = 0
+        self.dataset.register_client2client_msg_handler()
+        self.dataset.set_trainer_num(fleet.worker_num())
+        self.dataset.set_fleet_send_batch_size(self.fleet_send_batch_size)
+        self.dataset.set_fleet_send_sleep_seconds(self.fleet_send_sleep_seconds)
+        self.dataset.set_streaming_global_shuffle(fleet.worker_index())
+        fleet._role_maker.barrier_worker()
+        self.dataset.load_into_memory()
+        self.dataset.set_streaming_global_shuffle(-1)
+        # the data sent by the other trainers is received after the barrier
+        fleet._role_maker.barrier_worker()
+        if self.merge_by_lineid:
+            self.dataset.merge_by_lineid()
+            fleet._role_maker.barrier_worker()
+
     def global_shuffle(self, fleet=None, thread_num=12):
         """
         :api_attr: Static Graph
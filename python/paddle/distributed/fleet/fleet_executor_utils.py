@@ -160,6 +160,224 @@ class TaskNode:
         return self.id
 
 
+# The jobs of the pipeline schedules are (type, micro batch, chunk), the type
+# is the forward 'F', the backward 'B', or the weight-grad backward 'W' of the
+# zero-bubble schedules, whose 'B' computes the input grads only.
+_PIPELINE_SCHEDULE_MODES = ['1F1B', 'VPP', 'ZBH1']
+
+
+def _one_f_one_b_jobs(num_stages, num_micro_batches, stage):
+    warmup = min(num_stages - stage - 1, num_micro_batches)
+    jobs = [('F', i, 0) for i in range(warmup)]
+    for i in range(num_micro_batches - warmup):
+        jobs.append(('F', warmup + i, 0))
+        jobs.append(('B', i, 0))
+    for i in range(num_micro_batches - warmup, num_micro_batches):
+        jobs.append(('B', i, 0))
+    return jobs
+
+
+def _interleaved_jobs(num_stages, num_micro_batches, num_chunks, stage):
+    # the micro batches run the chunks in groups of num_stages, the forward
+    # from the first chunk and the backward from the last one
+    def job(job_type, k):
+        group, offset = divmod(k, num_stages * num_chunks)
+        chunk = offset // num_stages
+        if job_type == 'B':
+            chunk = num_chunks - 1 - chunk
+        return (job_type, group * num_stages + offset % num_stages, chunk)
+
+    total = num_micro_batches * num_chunks
+    warmup = (num_stages - stage - 1) * 2 + (num_chunks - 1) * num_stages
+    warmup = min(warmup, total)
+    jobs = [job('F', k) for k in range(warmup)]
+    for k in range(total - warmup):
+        jobs.append(job('F', warmup + k))
+        jobs.append(job('B', k))
+    for k in range(total - warmup, total):
+        jobs.append(job('B', k))
+    return jobs
+
+
+def _zero_bubble_h1_jobs(num_stages, num_micro_batches, stage):
+    # ZB-H1 keeps the Fs and Bs of 1F1B, and the stage defers its Ws by the
+    # stage id, which fill the bubbles of 1F1B within the peak activations of
+    # 1F1B, the ones of the first stage
+    jobs = []
+    next_w = 0
+    for job in _one_f_one_b_jobs(num_stages, num_micro_batches, stage):
+        jobs.append(job)
+        if job[0] == 'B' and job[1] - next_w >= stage:
+            jobs.append(('W', next_w, 0))
+            next_w += 1
+    for mb in range(next_w, num_micro_batches):
+        jobs.append(('W', mb, 0))
+    return jobs
+
+
+def create_pipeline_schedule(mode, num_stages, num_micro_batches, num_chunks=1):
+    """
+    Generate the order of the jobs of every stage of a pipeline schedule.
+    :param mode (str): 1F1B, VPP for the interleaved 1F1B of virtual stages,
+        or ZBH1 for the zero-bubble schedule which splits the backward into
+        the input-grad B and the weight-grad W.
+    :param num_stages (int): The number of the pipeline stages.
+    :param num_micro_batches (int): The number of the micro batches.
+    :param num_chunks (int): The model chunks (virtual stages) of every stage,
+        only VPP takes more than one, which needs num_micro_batches to be a
+        multiple of num_stages.
+    :return:
+        schedule (list): The jobs (type, micro batch, chunk) of every stage.
+    """
+    assert (
+        mode in _PIPELINE_SCHEDULE_MODES
+    ), f"The pipeline schedule should be one of {_PIPELINE_SCHEDULE_MODES}, but received {mode}."
+    assert num_stages >= 1 and num_micro_batches >= 1
+    if mode != 'VPP':
+        assert (
+            num_chunks == 1
+        ), f"The {mode} schedule doesn't support more than one chunk."
+    if mode == 'ZBH1':
+        return [
+            _zero_bubble_h1_jobs(num_stages, num_micro_batches, s)
+            for s in range(num_stages)
+        ]
+    if mode == 'VPP' and num_chunks > 1:
+        assert (
+            num_micro_batches % num_stages == 0
+        ), "The number of the micro batches of VPP should be a multiple of the number of the stages."
+        return [
+            _interleaved_jobs(num_stages, num_micro_batches, num_chunks, s)
+            for s in range(num_stages)
+        ]
+    return [
+        _one_f_one_b_jobs(num_stages, num_micro_batches, s)
+        for s in range(num_stages)
+    ]
+
+
+def _job_deps(job, stage, num_stages, num_chunks):
+    # the (stage, job) the job waits for
+    job_type, mb, chunk = job
+    if job_type == 'W':
+        return [(stage, ('B', mb, chunk))]
+    if job_type == 'F':
+        if stage > 0:
+            return [(stage - 1, ('F', mb, chunk))]
+        if chunk > 0:
+            return [(num_stages - 1, ('F', mb, chunk - 1))]
+        return []
+    deps = [(stage, ('F', mb, chunk))]
+    if stage < num_stages - 1:
+        deps.append((stage + 1, ('B', mb, chunk)))
+    elif chunk < num_chunks - 1:
+        deps.append((0, ('B', mb, chunk + 1)))
+    return deps
+
+
+def simulate_pipeline_schedule(
+    schedule,
+    forward_cost=1.0,
+    backward_cost=1.0,
+    weight_cost=1.0,
+    comm_cost=0.0,
+):
+    """
+    Predict the time of a pipeline schedule by running its jobs in order on
+    every stage, each job starts when the stage is free and the jobs it
+    depends on are done, plus comm_cost if they are on other stages.
+    :param schedule (list): The jobs of every stage by create_pipeline_schedule.
+    :param forward_cost, backward_cost, weight_cost (float): The time of F, B
+        and W of a micro batch on a stage, which are divided by the chunks.
+        A B of a schedule without W computes the weight grads too, so it
+        takes backward_cost + weight_cost.
+    :param comm_cost (float): The time to send a job to the next stage.
+    :return:
+        result (dict): makespan, bubble_ratio of all the stages,
+        stage_bubble_ratios, peak_activations, the max micro batch chunks a
+        stage holds the activations of, and timeline, the
+        (stage, job, start, end) of every job.
+    """
+    num_stages = len(schedule)
+    num_chunks = 1 + max(job[2] for jobs in schedule for job in jobs)
+    split_backward = any(job[0] == 'W' for jobs in schedule for job in jobs)
+    costs = {
+        'F': forward_cost / num_chunks,
+        'B': (
+            backward_cost if split_backward else backward_cost + weight_cost
+        )
+        / num_chunks,
+        'W': weight_cost / num_chunks,
+    }
+    # the job which frees the activations of the micro batch
+    release = 'W' if split_backward else 'B'
+
+    done = {}
+    positions = [0] * num_stages
+    times = [0.0] * num_stages
+    busy = [0.0] * num_stages
+    activations = [0] * num_stages
+    peak_activations = [0] * num_stages
+    timeline = []
+    while True:
+        progress = False
+        for s in range(num_stages):
+            while positions[s] < len(schedule[s]):
+                job = schedule[s][positions[s]]
+                deps = _job_deps(job, s, num_stages, num_chunks)
+                if any(dep not in done for dep in deps):
+                    break
+                start = times[s]
+                for dep in deps:
+                    delay = comm_cost if dep[0] != s else 0.0
+                    start = max(start, done[dep] + delay)
+                end = start + costs[job[0]]
+                done[(s, job)] = end
+                times[s] = end
+                busy[s] += costs[job[0]]
+                if job[0] == 'F':
+                    activations[s] += 1
+                    peak_activations[s] = max(
+                        peak_activations[s], activations[s]
+                    )
+                elif job[0] == release:
+                    activations[s] -= 1
+                timeline.append((s, job, start, end))
+                positions[s] += 1
+                progress = True
+        if not progress:
+            break
+    assert all(
+        positions[s] == len(schedule[s]) for s in range(num_stages)
+    ), "The pipeline schedule deadlocks, some jobs wait for the jobs after them."
+
+    makespan = max(times)
+    stage_bubble_ratios = [
+        1.0 - b / makespan if makespan > 0 else 0.0 for b in busy
+    ]
+    return {
+        'makespan': makespan,
+        'bubble_ratio': (
+            1.0 - sum(busy) / (num_stages * makespan) if makespan > 0 else 0.0
+        ),
+        'stage_bubble_ratios': stage_bubble_ratios,
+        'peak_activations': peak_activations,
+        'timeline': timeline,
+    }
+
+
+def _peak_in_flight(produce_times, consume_times):
+    # the max items produced and not consumed yet, a consume at the same time
+    # of a produce goes first
+    events = [(t, 1) for t in produce_times] + [(t, -1) for t in consume_times]
+    events.sort(key=lambda e: (e[0], e[1]))
+    peak, count = 0, 0
+    for _, delta in events:
+        count += delta
+        peak = max(peak, count)
+    return peak
+
+
 class CoordSys:
     """
     This class is used to mapping rank to (mp rank, sharding rank, pp rank, dp rank).
@@ -412,6 +630,228 @@ class FleetExecutorUtils:
             "opt": opt_task_node,
         }
 
+    def split_op_list_by_chunk(self, op_list_map, num_chunks):
+        # the chunk of the op is the chunk_id of its dist attr, the grad ops
+        # inherit it from the forward ones
+        chunk_op_list_map = {"lr": op_list_map["lr"], "opt": op_list_map["opt"]}
+        for key in ["fwd", "bwd"]:
+            for chunk in range(num_chunks):
+                chunk_op_list_map[f"{key}_{chunk}"] = []
+            for op in op_list_map[key]:
+                chunk = op.dist_attr.chunk_id if num_chunks > 1 else 0
+                assert (
+                    0 <= chunk < num_chunks
+                ), f"The chunk id {chunk} of op {op.type} isn't in [0, {num_chunks})."
+                chunk_op_list_map[f"{key}_{chunk}"].append(op)
+        return chunk_op_list_map
+
+    def split_backward_for_zero_bubble(self, op_list, param_names):
+        """
+        Split the backward ops into the ops of the input grads and the ops of
+        the weight grads for the zero-bubble schedules. An op computing both
+        is copied into the two, and each copy drops the outputs of the other.
+        :param op_list (list): The backward ops.
+        :param param_names (set): The names of the parameters.
+        :return:
+            input_grad_descs, weight_grad_descs (list): The op descs.
+        """
+
+        def is_weight_grad(name):
+            return (
+                core.grad_var_suffix() in name
+                and name.split(core.grad_var_suffix())[0] in param_names
+            )
+
+        input_grad_descs, weight_grad_descs = [], []
+        for op in op_list:
+            weight_slots, other_slots = [], []
+            for slot in op.desc.output_names():
+                names = op.desc.output(slot)
+                if not names:
+                    continue
+                if all(is_weight_grad(name) for name in names):
+                    weight_slots.append(slot)
+                else:
+                    other_slots.append(slot)
+            if not weight_slots:
+                input_grad_descs.append(op.desc)
+            elif not other_slots:
+                weight_grad_descs.append(op.desc)
+            else:
+                for descs, removed_slots in (
+                    (input_grad_descs, weight_slots),
+                    (weight_grad_descs, other_slots),
+                ):
+                    desc = core.OpDesc()
+                    desc.copy_from(op.desc)
+                    for slot in removed_slots:
+                        desc.set_output(slot, [])
+                    descs.append(desc)
+        return input_grad_descs, weight_grad_descs
+
+    def construct_task_nodes_schedule(self, op_list_map, schedule, program):
+        """
+        Create the task nodes of a pipeline schedule by create_pipeline_schedule
+        for current rank: lr, the forward and the backward of every chunk, the
+        weight grads of every chunk if the schedule splits the backward, and
+        opt.
+        """
+        num_chunks = 1 + max(job[2] for jobs in schedule for job in jobs)
+        split_backward = any(job[0] == 'W' for jobs in schedule for job in jobs)
+        chunk_op_list_map = self.split_op_list_by_chunk(op_list_map, num_chunks)
+        desc_list_map = {
+            key: [op.desc for op in ops]
+            for key, ops in chunk_op_list_map.items()
+        }
+        if split_backward:
+            param_names = {
+                param.name for param in program.global_block().all_parameters()
+            }
+            for chunk in range(num_chunks):
+                (
+                    desc_list_map[f"bwd_{chunk}"],
+                    desc_list_map[f"wgt_{chunk}"],
+                ) = self.split_backward_for_zero_bubble(
+                    chunk_op_list_map[f"bwd_{chunk}"], param_names
+                )
+
+        # the backward runs from the last chunk, and the weight grads after
+        # all the input grads, so the vars are gced after their last use
+        keys = ["lr"]
+        keys += [f"fwd_{chunk}" for chunk in range(num_chunks)]
+        keys += [f"bwd_{chunk}" for chunk in reversed(range(num_chunks))]
+        if split_backward:
+            keys += [f"wgt_{chunk}" for chunk in reversed(range(num_chunks))]
+        keys.append("opt")
+        self.num_of_functionality = len(keys)
+        self.schedule_task_offsets = {key: i for i, key in enumerate(keys)}
+
+        roles = {
+            "lr": int(OpRole.Optimize.LRSched),
+            "fwd": int(OpRole.Forward),
+            "bwd": int(OpRole.Backward),
+            "wgt": int(OpRole.Backward),
+            "opt": int(OpRole.Optimize),
+        }
+        cur_start_id = int(self.rank * self.num_of_functionality)
+        task_node_map = {}
+        for i, key in enumerate(keys):
+            is_amplifier = key in ("lr", "opt")
+            task_node = TaskNode(
+                rank=self.rank,
+                max_run_times=self.max_run_times,
+                role=roles[key.split('_')[0]],
+                ops=desc_list_map[key],
+                task_id=cur_start_id + i,
+                node_type="Amplifier" if is_amplifier else "Compute",
+            )
+            if is_amplifier:
+                task_node.set_run_pre_steps(self.max_run_times)
+            if key == "opt":
+                task_node.set_run_at_offset(self.max_run_times - 1)
+            task_node_map[key] = task_node
+        return task_node_map
+
+    def build_schedule_dependency(self, task_node_map, schedule):
+        """
+        Connect the task nodes of a pipeline schedule within the stage and
+        across the stages. The carrier runs a task once its upstreams are
+        ready and its downstreams have the buffers, so the buffers are sized
+        by the jobs in flight of the simulated schedule, which lets the
+        carrier follow it.
+        """
+        assert (
+            not self.is_auto_parallel
+        ), "Handly add dependency should not be invoked in auto parallel mode"
+        num_stages = len(schedule)
+        num_chunks = 1 + max(job[2] for jobs in schedule for job in jobs)
+        split_backward = "wgt_0" in task_node_map
+        stage = self.coord['pp_idx']
+        timeline = simulate_pipeline_schedule(schedule)['timeline']
+        job_ends = {(s, job): end for s, job, _, end in timeline}
+
+        def buffer_size(up, down, min_size=2):
+            # up and down are (stage, job type, chunk)
+            produces, consumes = [], []
+            for mb in range(self.max_run_times):
+                produces.append(job_ends[(up[0], (up[1], mb, up[2]))])
+                consumes.append(job_ends[(down[0], (down[1], mb, down[2]))])
+            return max(_peak_in_flight(produces, consumes), min_size)
+
+        def task_id(pp_idx, key):
+            coord = self.coord.copy()
+            coord['pp_idx'] = pp_idx
+            rank = self.coord_sys.coord_to_rank(coord)
+            return int(
+                rank * self.num_of_functionality
+                + self.schedule_task_offsets[key]
+            )
+
+        def connect(up, down, size):
+            # up and down are (stage, task key), one of them on this stage
+            if up[0] == stage:
+                task_node_map[up[1]].add_downstream_task(
+                    task_id(down[0], down[1]), size
+                )
+            if down[0] == stage:
+                task_node_map[down[1]].add_upstream_task(
+                    task_id(up[0], up[1]), size
+                )
+
+        last = num_stages - 1
+        connect((stage, "lr"), (stage, "fwd_0"), 2)
+        for chunk in range(num_chunks):
+            fwd, bwd = f"fwd_{chunk}", f"bwd_{chunk}"
+            connect(
+                (stage, fwd),
+                (stage, bwd),
+                buffer_size((stage, 'F', chunk), (stage, 'B', chunk), 1),
+            )
+            if split_backward:
+                wgt = f"wgt_{chunk}"
+                connect(
+                    (stage, bwd),
+                    (stage, wgt),
+                    buffer_size((stage, 'B', chunk), (stage, 'W', chunk), 1),
+                )
+                connect((stage, wgt), (stage, "opt"), 2)
+            else:
+                connect((stage, bwd), (stage, "opt"), 2)
+
+            # the forward of a chunk goes through the stages, and then to the
+            # next chunk from the first stage, the backward goes back
+            fwd_ups = []
+            if stage > 0:
+                fwd_ups.append((stage - 1, chunk))
+            elif chunk > 0:
+                fwd_ups.append((last, chunk - 1))
+            fwd_downs = []
+            if stage < last:
+                fwd_downs.append((stage + 1, chunk))
+            elif chunk < num_chunks - 1:
+                fwd_downs.append((0, chunk + 1))
+            for up_stage, up_chunk in fwd_ups:
+                up_fwd, up_bwd = f"fwd_{up_chunk}", f"bwd_{up_chunk}"
+                size = buffer_size(
+                    (up_stage, 'F', up_chunk), (stage, 'F', chunk)
+                )
+                connect((up_stage, up_fwd), (stage, fwd), size)
+                size = buffer_size(
+                    (stage, 'B', chunk), (up_stage, 'B', up_chunk)
+                )
+                connect((stage, bwd), (up_stage, up_bwd), size)
+            for down_stage, down_chunk in fwd_downs:
+                down_fwd, down_bwd = f"fwd_{down_chunk}", f"bwd_{down_chunk}"
+                size = buffer_size(
+                    (stage, 'F', chunk), (down_stage, 'F', down_chunk)
+                )
+                connect((stage, fwd), (down_stage, down_fwd), size)
+                size = buffer_size(
+                    (down_stage, 'B', down_chunk), (stage, 'B', chunk)
+                )
+                connect((down_stage, down_bwd), (stage, bwd), size)
+        return task_node_map
+
 
 def run1f1b(
     program,
@@ -466,6 +906,53 @@ def run1f1b(
     return task_node_list, task_id_to_rank
 
 
+def run_pipeline_schedule(
+    program,
+    rank,
+    max_run_times,
+    dist_opt,
+    nrank,
+    scheduler,
+    num_chunks=1,
+):
+    """
+    Split the program into the task nodes of a pipeline schedule, VPP for the
+    interleaved 1F1B of num_chunks virtual stages, or ZBH1 for the zero-bubble
+    schedule whose backward is split into the input grads and the weight
+    grads, and connect them to run the schedule in the carrier.
+    :param program: The origin program.
+    :param rank: Current rank (can be got from fleet.worker_index()).
+    :param max_run_times: Max run times for a micro batch. AKA number of micro steps.
+    :param dist_opt: The fleet_opt configured by user.
+    :param nrank: Number of workers (can be got from fleet.worker_num()).
+    :param scheduler: The pipeline schedule, one of 1F1B, VPP and ZBH1.
+    :param num_chunks: The model chunks of every stage for VPP.
+    :return:
+        task_nodes (list): task nodes for current rank
+        task_id_to_rank (dict): task nodes' ids to it's corresponding rank
+    """
+    print(f"fleet executor will use python side {scheduler} scheduler.")
+    fleet_executor_utils = FleetExecutorUtils(
+        dist_strategy=dist_opt,
+        rank=rank,
+        nrank=nrank,
+        max_run_times=max_run_times,
+    )
+    schedule = create_pipeline_schedule(
+        scheduler, dist_opt.get('pp_degree', 1), max_run_times, num_chunks
+    )
+    op_list_map = fleet_executor_utils.split_program_to_op_list(program)
+    task_node_map = fleet_executor_utils.construct_task_nodes_schedule(
+        op_list_map, schedule, program
+    )
+    task_node_map = fleet_executor_utils.build_schedule_dependency(
+        task_node_map, schedule
+    )
+    task_id_to_rank = fleet_executor_utils.task_id_to_rank()
+    task_node_list = [task_node_map[key].task_node() for key in task_node_map]
+    return task_node_list, task_id_to_rank
+
+
 def origin(program, rank):
     """
     Origin scheduler for fleet executor, supports non-pp mode
@@ -788,3 +788,57 @@ class ParallelCrossEntropy(paddle.nn.Layer):
             ignore_index=self.ignore_index,
         )
         return loss
+
+
+class ParallelLinearCrossEntropy(paddle.nn.Layer):
+    """The vocab projection and the CrossEntropy with mp parallelized, fused.
+    this class computes the loss of ParallelCrossEntropy on the logits
+    matmul(input, weight) chunk by chunk of the vocab, so that the
+    [tokens, vocab_size // mp_degree] logits are never materialized: the
+    forward keeps the running max and sum of exp of every token and reduces
+    them in the mp group, and the backward recomputes the logits of every chunk.
+
+    Args:
+        mp_group(Group): The tensor parallel group.
+        name(str, optional): Normally there is no need for user to set this parameter.
+            For detailed information, please refer to :ref:`api_guide_Name` .
+        ignore_index (long int, optional):  Specifies a target value that is ignored and
+            does not contribute to the loss. A negative value means that no label value
+            needs to be ignored. Default is -100 .
+        chunk_size (int, optional): The columns of the local weight whose logits are
+            computed at a time. Default is 8192 .
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +SKIP('No img to demonstrate')
+            >>> from paddle.distributed.fleet.layers.mpu import ParallelLinearCrossEntropy
+            >>> loss_func = ParallelLinearCrossEntropy()
+            >>> # lm_head is a ColumnParallelLinear without bias and gather_output=False
+            >>> loss = loss_func(hidden_states, lm_head.weight, label)
+
+    """
+
+    def __init__(
+        self, mp_group=None, name=None, ignore_index=-100, chunk_size=8192
+    ):
+        super().__init__()
+        self.name = name
+        self.model_parallel_group = (
+            tp._HYBRID_PARALLEL_GROUP.get_model_parallel_group()
+            if mp_group is None
+            else mp_group
+        )
+        self.ignore_index = ignore_index
+        self.chunk_size = chunk_size
+
+    def forward(self, input, weight, label):
+        loss = mp_ops._c_linear_softmax_with_cross_entropy(
+            input,
+            weight,
+            label,
+            group=self.model_parallel_group,
+            ignore_index=self.ignore_index,
+            chunk_size=self.chunk_size,
+        )
+        return loss
@@ -473,6 +473,154 @@ def _c_softmax_with_cross_entropy(
         return loss
 
 
+class c_linear_softmax_with_cross_entropy_eager(PyLayer):
+    """
+    The cross entropy of the logits input * weight over the vocab split in the
+    mp group, computed chunk by chunk of chunk_size columns of the local weight,
+    so that only a [tokens, chunk_size] slice of the logits lives at a time.
+    The forward keeps the running max and sum of exp of every token in
+    float32, like the online softmax, and reduces them across the ranks; the
+    backward recomputes the logits of every chunk from the saved input and
+    statistics.
+    """
+
+    @staticmethod
+    def forward(ctx, input, weight, label, group, ignore_index, chunk_size):
+        input_2d = input.reshape([-1, input.shape[-1]])
+        label = label.reshape([-1])
+        vocab_size = weight.shape[1]
+        rank = 0 if group is None else group.rank
+        local_label = label - rank * vocab_size
+        valid = (
+            (local_label >= 0)
+            & (local_label < vocab_size)
+            & (label != ignore_index)
+        )
+
+        num_tokens = input_2d.shape[0]
+        logits_max = paddle.full([num_tokens], float('-inf'), 'float32')
+        sum_exp = paddle.zeros([num_tokens], 'float32')
+        label_logit = paddle.zeros([num_tokens], 'float32')
+        for begin in range(0, vocab_size, chunk_size):
+            end = min(begin + chunk_size, vocab_size)
+            logits = paddle.matmul(input_2d, weight[:, begin:end]).astype(
+                'float32'
+            )
+            chunk_max = paddle.maximum(logits_max, logits.max(axis=1))
+            sum_exp = sum_exp * paddle.exp(logits_max - chunk_max) + paddle.exp(
+                logits - chunk_max.unsqueeze(1)
+            ).sum(axis=1)
+            logits_max = chunk_max
+
+            in_chunk = valid & (local_label >= begin) & (local_label < end)
+            index = paddle.clip(local_label - begin, 0, end - begin - 1)
+            picked = paddle.take_along_axis(
+                logits, index.unsqueeze(1), axis=1
+            ).squeeze(1)
+            label_logit += paddle.where(
+                in_chunk, picked, paddle.zeros_like(picked)
+            )
+
+        if group is not None and group.nranks > 1:
+            global_max = logits_max.clone()
+            group.process_group.all_reduce_on_calc_stream(
+                global_max,
+                _get_reduce_op(ReduceOp.MAX, "_c_linear_cross_entropy"),
+            )
+            sum_exp = sum_exp * paddle.exp(logits_max - global_max)
+            logits_max = global_max
+            sum_op = _get_reduce_op(ReduceOp.SUM, "_c_linear_cross_entropy")
+            group.process_group.all_reduce_on_calc_stream(sum_exp, sum_op)
+            group.process_group.all_reduce_on_calc_stream(label_logit, sum_op)
+
+        ignored = label == ignore_index
+        loss = paddle.log(sum_exp) + logits_max - label_logit
+        loss = paddle.where(ignored, paddle.zeros_like(loss), loss)
+
+        ctx.group = group
+        ctx.chunk_size = chunk_size
+        ctx.save_for_backward(
+            input, weight, local_label, valid, ignored, logits_max, sum_exp
+        )
+        return loss.astype(input.dtype).reshape([*input.shape[:-1], 1])
+
+    @staticmethod
+    def backward(ctx, dloss):
+        (
+            input,
+            weight,
+            local_label,
+            valid,
+            ignored,
+            logits_max,
+            sum_exp,
+        ) = ctx.saved_tensor()
+        input_2d = input.reshape([-1, input.shape[-1]])
+        vocab_size = weight.shape[1]
+        dloss = dloss.reshape([-1]).astype('float32')
+        dloss = paddle.where(ignored, paddle.zeros_like(dloss), dloss)
+
+        dinput = paddle.zeros(input_2d.shape, 'float32')
+        dweight = []
+        for begin in range(0, vocab_size, ctx.chunk_size):
+            end = min(begin + ctx.chunk_size, vocab_size)
+            chunk_weight = weight[:, begin:end]
+            logits = paddle.matmul(input_2d, chunk_weight).astype('float32')
+            dlogits = paddle.exp(
+                logits - logits_max.unsqueeze(1)
+            ) / sum_exp.unsqueeze(1)
+
+            in_chunk = valid & (local_label >= begin) & (local_label < end)
+            index = paddle.clip(local_label - begin, 0, end - begin - 1)
+            one_hot = paddle.nn.functional.one_hot(index, end - begin)
+            dlogits -= one_hot * in_chunk.astype('float32').unsqueeze(1)
+            dlogits = (dlogits * dloss.unsqueeze(1)).astype(input.dtype)
+
+            dinput += paddle.matmul(
+                dlogits, chunk_weight, transpose_y=True
+            ).astype('float32')
+            dweight.append(paddle.matmul(input_2d, dlogits, transpose_x=True))
+
+        # input is replicated on the ranks, which see their own part of vocab
+        if ctx.group is not None and ctx.group.nranks > 1:
+            ctx.group.process_group.all_reduce_on_calc_stream(
+                dinput,
+                _get_reduce_op(ReduceOp.SUM, "_c_linear_cross_entropy"),
+            )
+        dinput = dinput.astype(input.dtype).reshape(input.shape)
+        return dinput, paddle.concat(dweight, axis=1), None
+
+
+def _c_linear_softmax_with_cross_entropy(
+    input,
+    weight,
+    label,
+    group=None,
+    ignore_index=-100,
+    chunk_size=8192,
+):
+    """
+    The cross entropy of matmul(input, weight) over the vocab split in the mp
+    group, without materializing the logits. weight is the local
+    [hidden_size, vocab_size // nranks] column slice of the vocab projection of
+    this rank, and the loss is the one of _c_softmax_with_cross_entropy on the
+    logits of the projection. Only the dynamic graph is supported.
+    """
+    if group is not None and not group.is_member():
+        return
+    if not in_dynamic_mode():
+        raise NotImplementedError(
+            "_c_linear_softmax_with_cross_entropy only supports the dynamic "
+            "graph, please use _c_softmax_with_cross_entropy in the static "
+            "graph."
+        )
+    if len(label.shape) == len(input.shape):
+        label = paddle.squeeze(label, axis=-1)
+    return c_linear_softmax_with_cross_entropy_eager.apply(
+        input, weight, label, group, ignore_index, chunk_size
+    )
+
+
 def _linear(x, weight, bias=None, name=None):
     """
     Fuction Linear
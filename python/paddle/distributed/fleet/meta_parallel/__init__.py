@@ -16,6 +16,7 @@ from .parallel_layers import (  # noqa: F401
     ColumnParallelLinear,
     LayerDesc,
     ParallelCrossEntropy,
+    ParallelLinearCrossEntropy,
     PipelineLayer,
     RNGStatesTracker,
     RowParallelLinear,
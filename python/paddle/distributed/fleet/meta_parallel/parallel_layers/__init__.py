@@ -15,6 +15,7 @@
 from .mp_layers import (  # noqa: F401
     ColumnParallelLinear,
     ParallelCrossEntropy,
+    ParallelLinearCrossEntropy,
     RowParallelLinear,
     VocabParallelEmbedding,
 )
@@ -39,7 +39,8 @@ def _all_gather(tensor, buffer_size, group):
 
     assert group is not None
     if framework.in_dynamic_mode():
-        out = paddle.zeros([buffer_size], dtype=tensor.dtype)
+        # all of out is written by the all gather
+        out = paddle.empty([buffer_size], dtype=tensor.dtype)
         task = group.process_group.all_gather(tensor, out)
         return out, task
 
@@ -718,33 +719,38 @@ class GroupShardedStage3(nn.Layer):
             ), "the param must be trainable for grad allreduced"
             if param.name in self._task_flow.full_grad.keys():
                 full_grad = self._task_flow.full_grad[param.name]
-                # Only support sync allreduce current rank's layer now
-                full_grad.scale_(scale=self._world_size_scaling)
-                dist.all_reduce(tensor=full_grad, group=self._group)
+                # Only support sync reduce scatter current rank's layer now.
+                # The slice of a rank is its chunk of the full grad, so the
+                # grad is reduce scattered into the slice of current rank
+                # instead of all reduced and then sliced.
+                start, end = self._param2buffer[param.name][self._rank]
+                grad_slice = paddle.empty([end - start], dtype=full_grad.dtype)
+                dist.stream.reduce_scatter(
+                    grad_slice,
+                    full_grad,
+                    group=self._group,
+                    sync_op=True,
+                    use_calc_stream=True,
+                )
+                grad_slice.scale_(scale=self._world_size_scaling)
                 if self._dp_group is not None and self._dp_group.nranks > 1:
-                    full_grad.scale_(scale=1.0 / self._dp_group.nranks)
-                    dist.all_reduce(tensor=full_grad, group=self._dp_group)
+                    grad_slice.scale_(scale=1.0 / self._dp_group.nranks)
+                    dist.all_reduce(tensor=grad_slice, group=self._dp_group)
 
-                start, end = self._param2buffer[param.name][self._rank]
                 if param.bw_storage is None:
-                    param.bw_storage = (
-                        full_grad._slice(start, end).detach().clone()
-                    )
+                    param.bw_storage = grad_slice
                     if self._offload:
                         param.bw_storage = _device2cpu(param.bw_storage, True)
                 else:
                     if self._offload:
-                        cpu_grad = _device2cpu(
-                            full_grad._slice(start, end).detach().clone(), True
-                        )
+                        cpu_grad = _device2cpu(grad_slice, True)
                         with device_guard():
                             param.bw_storage = paddle.add(
                                 param.bw_storage, cpu_grad
                             )
                     else:
                         param.bw_storage = paddle.add(
-                            param.bw_storage,
-                            full_grad._slice(start, end).detach().clone(),
+                            param.bw_storage, grad_slice
                         )
 
                 if self.use_main_grad:
@@ -187,21 +187,19 @@ def auc(stat_pos, stat_neg, scope=None, util=None):
         stat_neg = np.array(scope.find_var(stat_neg.name).get_tensor())
     elif isinstance(stat_neg, str):
         stat_neg = np.array(scope.find_var(stat_neg).get_tensor())
-    # auc pos bucket shape
+    # auc pos and neg bucket shape
     old_pos_shape = np.array(stat_pos.shape)
+    old_neg_shape = np.array(stat_neg.shape)
     # reshape to one dim
     stat_pos = stat_pos.reshape(-1)
-    global_pos = np.copy(stat_pos) * 0
-    # mpi allreduce
-    global_pos = util.all_reduce(stat_pos, "sum")
-    global_pos = global_pos.reshape(old_pos_shape)
-
-    # auc neg bucket
-    old_neg_shape = np.array(stat_neg.shape)
     stat_neg = stat_neg.reshape(-1)
-    global_neg = np.copy(stat_neg) * 0
-    global_neg = util.all_reduce(stat_neg, "sum")
-    global_neg = global_neg.reshape(old_neg_shape)
+    # mpi allreduce of the two buckets in one collective
+    global_stat = util.all_reduce(
+        np.concatenate([stat_pos, stat_neg]), "sum"
+    )
+    global_stat = np.array(global_stat).reshape(-1)
+    global_pos = global_stat[: stat_pos.size].reshape(old_pos_shape)
+    global_neg = global_stat[stat_pos.size :].reshape(old_neg_shape)
 
     # calculate auc
     num_bucket = len(global_pos[0])
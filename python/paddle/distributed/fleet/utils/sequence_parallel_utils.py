@@ -82,6 +82,75 @@ def reduce_scatter(input):
     return output
 
 
+def _ring_exchange(input, group):
+    # sends input to the next rank of the ring and receives the one of the
+    # previous rank, on the comm stream
+    rank, nranks = group.rank, group.nranks
+    output = paddle.empty_like(input)
+    tasks = dist.batch_isend_irecv(
+        [
+            dist.P2POp(
+                dist.isend, input, group.ranks[(rank + 1) % nranks], group
+            ),
+            dist.P2POp(
+                dist.irecv,
+                output,
+                group.ranks[(rank - 1 + nranks) % nranks],
+                group,
+            ),
+        ]
+    )
+    return output, tasks
+
+
+def all_gather_compute(input, compute, group):
+    """
+    All gathers input along the first dim in a ring, calling compute(rank,
+    chunk) on the chunk of each rank of group while the next chunk is in
+    flight, so the communication is overlapped with the computation.
+    """
+    rank, nranks = group.rank, group.nranks
+    chunk = input
+    for step in range(nranks):
+        if step < nranks - 1:
+            next_chunk, tasks = _ring_exchange(chunk, group)
+        compute((rank - step + nranks) % nranks, chunk)
+        if step < nranks - 1:
+            for task in tasks:
+                task.wait()
+            chunk = next_chunk
+
+
+def compute_reduce_scatter(compute, group):
+    """
+    Reduce scatters the concat of compute(rank) of the ranks of group along
+    the first dim in a ring, where a step computes the partial of a chunk
+    while the sum of the previous chunk is in flight. Returns the sum of the
+    chunk of the current rank.
+    """
+    rank, nranks = group.rank, group.nranks
+    tasks = None
+    for step in range(nranks):
+        # the chunk reaches its rank after the partials of the other ranks
+        partial = compute((rank - step - 1 + nranks) % nranks)
+        if tasks is not None:
+            for task in tasks:
+                task.wait()
+            partial = partial + received
+        if step < nranks - 1:
+            received, tasks = _ring_exchange(partial, group)
+    return partial
+
+
+def _matmul_weight_grad(input, grad):
+    # the grad of the weight of matmul(input, weight), input flattened to 2D
+    return paddle.matmul(
+        input.reshape([-1, input.shape[-1]]),
+        grad.reshape([-1, grad.shape[-1]]),
+        transpose_x=True,
+    )
+
+
 class ScatterOp(PyLayer):
     # input shape: [s, b, h], n is mp parallelism
     # after forward shape: [s/n, b, h]
@@ -138,6 +207,73 @@ class ReduceScatterOp(PyLayer):
         return all_gather(grad)
 
 
+# matmul(all_gather(input), weight) with the all gather overlapped with the
+# matmul of the chunks, and so for the reduce scatter of the input grad and
+# the all gather of the weight grad during backward pass
+class AllGatherMatmulOp(PyLayer):
+    # input shape: [s/n, b, h], n is mp parallelism
+    # after forward shape: [s, b, o]
+    @staticmethod
+    def forward(ctx, input, weight, group):
+        outputs = [None] * group.nranks
+
+        def compute(rank, chunk):
+            outputs[rank] = paddle.matmul(chunk, weight)
+
+        all_gather_compute(input, compute, group)
+        ctx.save_for_backward(input, weight)
+        ctx.group = group
+        return paddle.concat(outputs, axis=0)
+
+    @staticmethod
+    def backward(ctx, grad):
+        input, weight = ctx.saved_tensor()
+        group = ctx.group
+        grads = paddle.split(grad, group.nranks, axis=0)
+        input_grad = compute_reduce_scatter(
+            lambda rank: paddle.matmul(grads[rank], weight, transpose_y=True),
+            group,
+        )
+        weight_grads = []
+
+        def compute(rank, chunk):
+            weight_grads.append(_matmul_weight_grad(chunk, grads[rank]))
+
+        all_gather_compute(input, compute, group)
+        return input_grad, paddle.add_n(weight_grads)
+
+
+# reduce_scatter(matmul(input, weight)) with the reduce scatter overlapped
+# with the matmul of the chunks, and the all gather of the grad overlapped
+# with the matmuls of the grads during backward pass
+class MatmulReduceScatterOp(PyLayer):
+    # input shape: [s, b, h], n is mp parallelism
+    # after forward shape: [s/n, b, o]
+    @staticmethod
+    def forward(ctx, input, weight, group):
+        inputs = paddle.split(input, group.nranks, axis=0)
+        ctx.save_for_backward(input, weight)
+        ctx.group = group
+        return compute_reduce_scatter(
+            lambda rank: paddle.matmul(inputs[rank], weight), group
+        )
+
+    @staticmethod
+    def backward(ctx, grad):
+        input, weight = ctx.saved_tensor()
+        group = ctx.group
+        inputs = paddle.split(input, group.nranks, axis=0)
+        input_grads = [None] * group.nranks
+        weight_grads = []
+
+        def compute(rank, chunk):
+            input_grads[rank] = paddle.matmul(chunk, weight, transpose_y=True)
+            weight_grads.append(_matmul_weight_grad(inputs[rank], chunk))
+
+        all_gather_compute(grad, compute, group)
+        return paddle.concat(input_grads, axis=0), paddle.add_n(weight_grads)
+
+
 ###################################################
 #                                                 #
 #        Modified Parallel Linear Operator        #
@@ -238,6 +374,7 @@ class ColumnSequenceParallelLinear(Layer):
         fuse_matmul_bias=False,
         mp_group=None,
         name=None,
+        overlap_matmul_comm=False,
     ):
         super().__init__()
 
@@ -312,10 +449,20 @@ class ColumnSequenceParallelLinear(Layer):
 
             self.linear = fused_linear
 
+        # pipelines the all gather of the input with the matmul of its chunks
+        self.overlap_matmul_comm = overlap_matmul_comm
+
     def forward(self, x):
         # sequence parallelism is same as model parallelism
         # if sequence parallel is true, input shape is [s, b, h]
         # else input shape is [b, s, h]
+        if self.is_mp and self.overlap_matmul_comm:
+            output = AllGatherMatmulOp.apply(
+                x, self.weight, self.model_parallel_group
+            )
+            if self.bias is not None:
+                output = output + self.bias
+            return output
         if self.is_mp:
             input_parallel = AllGatherOp.apply(x)
         else:
@@ -348,6 +495,7 @@ class RowSequenceParallelLinear(Layer):
         fuse_matmul_bias=False,
         mp_group=None,
         name=None,
+        overlap_matmul_comm=False,
     ):
         super().__init__()
 
@@ -435,8 +583,20 @@ class RowSequenceParallelLinear(Layer):
             if self.is_mp and has_bias:
                 self.mp_scale = MPScale.apply
 
+        # pipelines the reduce scatter of the output with the matmul of its
+        # chunks
+        self.overlap_matmul_comm = overlap_matmul_comm
+
     def forward(self, x):
         input_parallel = x
+        if self.is_mp and self.overlap_matmul_comm:
+            output = MatmulReduceScatterOp.apply(
+                input_parallel, self.weight, self.model_parallel_group
+            )
+            # the bias is all reduced by the sequence parallel hook
+            if self.bias is not None:
+                output = output + self.bias
+            return output
         if self.is_mp:
             if self.mp_scale is not None:
                 bias = self.mp_scale(self.bias, self.world_size)
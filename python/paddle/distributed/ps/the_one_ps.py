@@ -119,6 +119,7 @@ class Service:
         service_proto.service_class = "BrpcPsService"
         service_proto.start_server_port = 0
         service_proto.server_thread_num = 12
+        service_proto.use_rdma = bool(int(os.getenv("PSERVER_USE_RDMA", "0")))
 
 
 class GpuService(Service):
@@ -767,6 +768,22 @@ class SparseTable(Table):
             table_proto.enable_revert = usr_table_proto.enable_revert
         if usr_table_proto.HasField("shard_merge_rate"):
             table_proto.shard_merge_rate = usr_table_proto.shard_merge_rate
+        if usr_table_proto.HasField("hot_key_cache_param"):
+            table_proto.hot_key_cache_param.ParseFromString(
+                usr_table_proto.hot_key_cache_param.SerializeToString()
+            )
+        if usr_table_proto.HasField("push_compress_param"):
+            table_proto.push_compress_param.ParseFromString(
+                usr_table_proto.push_compress_param.SerializeToString()
+            )
+        if usr_table_proto.HasField("admission_param"):
+            table_proto.admission_param.ParseFromString(
+                usr_table_proto.admission_param.SerializeToString()
+            )
+        if usr_table_proto.HasField("eviction_param"):
+            table_proto.eviction_param.ParseFromString(
+                usr_table_proto.eviction_param.SerializeToString()
+            )
 
         if usr_table_proto.accessor.ByteSize() == 0:
             warnings.warn(
@@ -12,6 +12,8 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import copyreg
+import io
 import pickle
 from collections import namedtuple
 
@@ -19,8 +21,29 @@ PythonFunc = namedtuple("PythonFunc", ["func", "args", "kwargs"])
 """Some Python code interfaces called in C++"""
 
 
+def _rebuild_tensor(data):
+    import paddle
+
+    return paddle.to_tensor(data)
+
+
+def _reduce_tensor(tensor):
+    # NOTE: The tensor is pickled as the ndarray of its data, which is
+    # written into the payload by a single copy with pickle protocol 5,
+    # instead of being converted element by element.
+    return (_rebuild_tensor, (tensor.numpy(),))
+
+
 def _serialize(obj):
-    return pickle.dumps(obj)
+    from paddle.base import core, framework
+
+    f = io.BytesIO()
+    pickler = pickle.Pickler(f, pickle.HIGHEST_PROTOCOL)
+    pickler.dispatch_table = copyreg.dispatch_table.copy()
+    pickler.dispatch_table[core.eager.Tensor] = _reduce_tensor
+    pickler.dispatch_table[framework.EagerParamBase] = _reduce_tensor
+    pickler.dump(obj)
+    return f.getvalue()
 
 
 def _deserialize(obj):
@@ -39,6 +39,11 @@ def set_config(config=None):
     parameters are as follows:
 
     - enable(bool): Whether to enable layout tuning.
+    - by_cost(bool): Whether to choose the layout by the costs of the conv2d ops
+      measured in NCHW and NHWC in the first iteration, together with the
+      transposes between them, instead of the data type. The measured costs and
+      the transposes inserted are reported by
+      ``paddle.base.core.layout_autotune_report()``. Default: False.
 
     3. dataloader: When it is enabled, the best num_workers will be selected to replace
     the origin dataloader setting. Tuning parameters are as follows:
@@ -134,6 +139,16 @@ def set_config(config=None):
                     "The auto-tuning configuration of the layout is incorrect."
                     "The `enable` should be bool. Use default parameter instead."
                 )
+        if "by_cost" in layout_config:
+            if isinstance(layout_config['by_cost'], bool):
+                paddle.set_flags(
+                    {'FLAGS_layout_autotune_by_cost': layout_config['by_cost']}
+                )
+            else:
+                warnings.warn(
+                    "The auto-tuning configuration of the layout is incorrect."
+                    "The `by_cost` should be bool. Use default parameter instead."
+                )
     if "dataloader" in config_dict:
         dataloader_config = config_dict["dataloader"]
         use_autoune = False
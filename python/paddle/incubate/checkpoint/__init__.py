@@ -13,5 +13,6 @@
 # limitations under the License.
 
 from ...base.incubate.checkpoint import auto_checkpoint  # noqa: F401
+from .async_checkpoint import AsyncCheckpointer  # noqa: F401
 
 __all__ = []
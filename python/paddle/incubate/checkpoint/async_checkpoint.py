@@ -0,0 +1,88 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from paddle.base import core
+
+__all__ = []
+
+
+class AsyncCheckpointer:
+    """
+    Saves the checkpoints of state dicts in the background, so that the
+    training loop only waits for the copies of the tensors to the host.
+
+    `save` copies the tensors of a state dict, e.g. the parameters and the
+    optimizer states, to a snapshot in the pinned host memory on a side
+    stream of the device and returns, while the snapshot is written to the
+    path on the local disk or HDFS by a background thread. The next updates
+    of the tensors on the device wait for the copies. Two snapshots are held
+    in turn, so `save` only blocks when both of them are still being
+    written.
+
+    The tensors are written in the format of `save_combine`, with their
+    names in the file `path + '.names'`, and are loaded by `load`.
+
+    Examples:
+        .. code-block:: python
+
+            >>> import paddle
+            >>> from paddle.incubate.checkpoint import AsyncCheckpointer
+
+            >>> linear = paddle.nn.Linear(4, 4)
+            >>> checkpointer = AsyncCheckpointer()
+            >>> checkpointer.save(linear.state_dict(), './linear.pdckpt')
+            >>> checkpointer.wait()
+            >>> linear.set_state_dict(AsyncCheckpointer.load('./linear.pdckpt'))
+    """
+
+    def __init__(self):
+        self._checkpointer = core.AsyncCheckpointer()
+
+    def save(self, state_dict, path):
+        """
+        Takes a snapshot of the tensors of state_dict, and writes it to path
+        in the background.
+
+        Parameters:
+            state_dict (dict): The dict of names to the Tensors to be saved.
+            path (str): The path of the checkpoint, on HDFS if it starts with
+                'hdfs:' or 'afs:'.
+        """
+        names = []
+        tensors = []
+        for name, tensor in state_dict.items():
+            names.append(name)
+            tensors.append(tensor.value().get_tensor())
+        self._checkpointer.save(path, names, tensors)
+
+    def wait(self):
+        """
+        Waits for the checkpoints being written, and raises the error of the
+        first one failed since the last wait.
+        """
+        self._checkpointer.wait()
+
+    @staticmethod
+    def load(path):
+        """
+        Loads the checkpoint at path saved by `save` to a dict of names to
+        the Tensors on CPU.
+        """
+        names, dense_tensors = core.AsyncCheckpointer.load(path)
+        state_dict = {}
+        for name, dense_tensor in zip(names, dense_tensors):
+            state_dict[name] = core.eager.Tensor(
+                dense_tensor, dense_tensor._place()
+            )
+        return state_dict
@@ -115,7 +115,13 @@ def fused_embedding_seq_pool(
 
 
 def fused_seqpool_cvm(
-    input, pool_type, cvm, pad_value=0.0, use_cvm=True, cvm_offset=2
+    input,
+    pool_type,
+    cvm,
+    pad_value=0.0,
+    use_cvm=True,
+    cvm_offset=2,
+    quant_ratio=0,
 ):
     """
     :api_attr: Static Graph
@@ -131,6 +137,7 @@ def fused_seqpool_cvm(
         pad_value(float, optional): padding value of sequence pool. Default: 0.0.
         use_cvm(bool, optional): use cvm or not. Default: True.
         cvm_offset(int, optional): cvm offset. Default: 2, which means cvm contains show, click.
+        quant_ratio(int, optional): the ratio to quantize the embedx by before the pooling, as round(embedx * quant_ratio) / quant_ratio. Default: 0, which means no quantization.
 
     Returns:
         Tensor : The tensor storing sequence pool and cvm of input.
@@ -186,6 +193,7 @@ def fused_seqpool_cvm(
             "pad_value": pad_value,
             "use_cvm": use_cvm,
             "cvm_offset": cvm_offset,
+            "quant_ratio": quant_ratio,
         },
     )
 
@@ -12,6 +12,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+from .layer.fp8_linear import FP8Linear
 from .layer.fused_dropout_add import FusedDropoutAdd
 from .layer.fused_dropout_nd import FusedDropout  # noqa: F401
 from .layer.fused_ec_moe import FusedEcMoe
@@ -33,4 +34,5 @@ __all__ = [
     'FusedBiasDropoutResidualLayerNorm',
     'FusedEcMoe',
     'FusedDropoutAdd',
+    'FP8Linear',
 ]
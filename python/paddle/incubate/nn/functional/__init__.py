@@ -22,16 +22,19 @@ from .fused_matmul_bias import (
 )
 from .fused_transformer import fused_bias_dropout_residual_layer_norm
 from .fused_ec_moe import fused_ec_moe
+from .fused_grouped_gemm import fused_grouped_gemm
+from .fused_beam_search_step import fused_beam_search_step
 from .fused_dropout_add import fused_dropout_add
 from .fused_gate_attention import fused_gate_attention
 from .fused_rotary_position_embedding import fused_rotary_position_embedding
 from .variable_length_memory_efficient_attention import (
     variable_length_memory_efficient_attention,
 )
-from .fused_rms_norm import fused_rms_norm
+from .fused_rms_norm import fused_rms_norm, fused_rms_norm_quant
 from .fused_layer_norm import fused_layer_norm
 from .masked_multihead_attention import masked_multihead_attention
 from .block_multihead_attention import block_multihead_attention
+from .fp8 import fp8_quantize, fp8_dequantize, fp8_linear
 
 __all__ = [
     'fused_multi_head_attention',
@@ -42,11 +45,17 @@ __all__ = [
     'fused_linear_activation',
     'fused_bias_dropout_residual_layer_norm',
     'fused_ec_moe',
+    'fused_grouped_gemm',
+    'fused_beam_search_step',
     'fused_dropout_add',
     'fused_rotary_position_embedding',
     'variable_length_memory_efficient_attention',
     "fused_rms_norm",
+    "fused_rms_norm_quant",
     "fused_layer_norm",
     "masked_multihead_attention",
     "block_multihead_attention",
+    "fp8_quantize",
+    "fp8_dequantize",
+    "fp8_linear",
 ]
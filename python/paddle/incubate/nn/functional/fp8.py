@@ -0,0 +1,180 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import paddle
+from paddle import _C_ops
+from paddle.framework import LayerHelper, in_dynamic_mode, in_pir_mode
+
+
+def fp8_quantize(x, scale, dtype=paddle.float8_e4m3fn, name=None):
+    r"""
+    Casts x to fp8 by the per-tensor scale, :math:`out = fp8(x * scale)`, which
+    is saturated to the max of the fp8 format, 448 for float8_e4m3fn and 57344
+    for float8_e5m2. The amax of x, :math:`max(|x|)`, is returned to compute
+    the scale of the next steps.
+
+    Args:
+        x (Tensor): The input tensor, whose data type is float32, float16 or bfloat16.
+        scale (Tensor): The float32 scale with one element.
+        dtype (paddle.dtype, optional): paddle.float8_e4m3fn or paddle.float8_e5m2. Default: paddle.float8_e4m3fn.
+        name (str, optional): Name for the operation, Default: None. For more information, please refer to :ref:`api_guide_Name`.
+
+    Returns:
+        A tuple of the fp8 tensor of x and the float32 amax of x with shape [1].
+
+    Examples:
+
+        .. code-block:: python
+
+            >>> import paddle
+            >>> from paddle.incubate.nn.functional import fp8_quantize, fp8_dequantize
+
+            >>> x = paddle.to_tensor([0.5, -300.0, 1000.0])
+            >>> scale = paddle.to_tensor([1.0])
+            >>> out, amax = fp8_quantize(x, scale)
+            >>> print(fp8_dequantize(out, scale, paddle.float32))
+            Tensor(shape=[3], dtype=float32, place=Place(cpu), stop_gradient=True,
+            [ 0.50000000, -288.       ,  448.       ])
+            >>> print(amax)
+            Tensor(shape=[1], dtype=float32, place=Place(cpu), stop_gradient=True,
+            [1000.])
+    """
+    if in_dynamic_mode() or in_pir_mode():
+        return _C_ops.fp8_quantize(x, scale, dtype)
+
+    helper = LayerHelper('fp8_quantize', **locals())
+    out = helper.create_variable_for_type_inference(dtype)
+    amax = helper.create_variable_for_type_inference('float32')
+    helper.append_op(
+        type='fp8_quantize',
+        inputs={'x': x, 'scale': scale},
+        outputs={'out': out, 'amax': amax},
+        attrs={'out_dtype': dtype},
+    )
+    return out, amax
+
+
+def fp8_dequantize(x, scale, dtype=paddle.float16, name=None):
+    r"""
+    Casts the fp8 x back by its scale, :math:`out = x / scale`.
+
+    Args:
+        x (Tensor): The input tensor, whose data type is float8_e4m3fn or float8_e5m2.
+        scale (Tensor): The float32 scale with one element, which x is quantized by.
+        dtype (paddle.dtype, optional): paddle.float32, paddle.float16 or paddle.bfloat16. Default: paddle.float16.
+        name (str, optional): Name for the operation, Default: None. For more information, please refer to :ref:`api_guide_Name`.
+
+    Returns:
+        The tensor of dtype with the same shape as x.
+    """
+    if in_dynamic_mode() or in_pir_mode():
+        return _C_ops.fp8_dequantize(x, scale, dtype)
+
+    helper = LayerHelper('fp8_dequantize', **locals())
+    out = helper.create_variable_for_type_inference(dtype)
+    helper.append_op(
+        type='fp8_dequantize',
+        inputs={'x': x, 'scale': scale},
+        outputs={'out': out},
+        attrs={'out_dtype': dtype},
+    )
+    return out
+
+
+def fp8_linear(
+    x,
+    weight,
+    bias=None,
+    x_amax_history=None,
+    weight_amax_history=None,
+    margin=0.0,
+    name=None,
+):
+    r"""
+    The linear layer computed by the fp8 tensor cores of sm89 and later,
+    :math:`out = x * weight + bias`, where x and weight are cast to
+    float8_e4m3fn by their per-tensor scales, and out is accumulated in float32
+    and returned in the data type of x.
+
+    A scale maps the amax of its tensor to the max of float8_e4m3fn,
+    :math:`scale = 448 / amax / 2^{margin}`. With the amax histories, which is
+    the delayed scaling for training, the amax is the max of the history, and
+    the amax of this step is pushed to the front of the history in place;
+    without them, the amax of this step is computed before the cast.
+
+    The gradients are computed in the data type of x.
+
+    Args:
+        x (Tensor): The input tensor with shape [*, k], whose data type is float16 or bfloat16.
+        weight (Tensor): The weight with shape [k, n] and the data type of x, k and n must be multiples of 16.
+        bias (Tensor, optional): The bias with shape [n]. Default: None.
+        x_amax_history (Tensor, optional): The float32 amax history of x with shape [history_len]. Default: None.
+        weight_amax_history (Tensor, optional): The float32 amax history of weight with shape [history_len]. Default: None.
+        margin (float, optional): The margin of the scales in the power of 2. Default: 0.0.
+        name (str, optional): Name for the operation, Default: None. For more information, please refer to :ref:`api_guide_Name`.
+
+    Returns:
+        The output tensor with shape [*, n].
+
+    Examples:
+
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> from paddle.incubate.nn.functional import fp8_linear
+
+            >>> paddle.set_device('gpu')
+            >>> x = paddle.randn([4, 64], dtype="float16")
+            >>> weight = paddle.randn([64, 32], dtype="float16")
+            >>> x_amax_history = paddle.zeros([16], dtype="float32")
+            >>> weight_amax_history = paddle.zeros([16], dtype="float32")
+            >>> out = fp8_linear(x, weight, None, x_amax_history, weight_amax_history)
+            >>> print(out.shape)
+            [4, 32]
+    """
+    if in_dynamic_mode():
+        if x_amax_history is None:
+            out, _, _ = _C_ops.fp8_linear(
+                x, weight, bias, None, None, margin
+            )
+        else:
+            out, _, _ = _C_ops.fp8_linear_(
+                x, weight, bias, x_amax_history, weight_amax_history, margin
+            )
+        return out
+    if in_pir_mode():
+        out, _, _ = _C_ops.fp8_linear(
+            x, weight, bias, x_amax_history, weight_amax_history, margin
+        )
+        return out
+
+    helper = LayerHelper('fp8_linear', **locals())
+    out = helper.create_variable_for_type_inference(x.dtype)
+    inputs = {'x': x, 'weight': weight}
+    outputs = {'out': out}
+    if bias is not None:
+        inputs['bias'] = bias
+    if x_amax_history is not None:
+        inputs['x_amax_history'] = x_amax_history
+        inputs['weight_amax_history'] = weight_amax_history
+        outputs['x_amax_history_out'] = x_amax_history
+        outputs['weight_amax_history_out'] = weight_amax_history
+    helper.append_op(
+        type='fp8_linear',
+        inputs=inputs,
+        outputs=outputs,
+        attrs={'margin': margin},
+    )
+    return out
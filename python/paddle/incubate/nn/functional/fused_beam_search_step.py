@@ -0,0 +1,115 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from paddle import _C_ops
+from paddle.framework import LayerHelper, in_dynamic_or_pir_mode
+
+
+def fused_beam_search_step(
+    logits,
+    cum_scores,
+    seq_lens,
+    finished,
+    end_id,
+    length_penalty=0.0,
+    name=None,
+):
+    r"""
+    One decoding step of the beam search on the logits of all the beams in one
+    pass. The top beam_size tokens of every beam are selected by the radix
+    select without sorting the vocabulary, scored by the log softmax and the
+    length penalty of GNMT
+
+    .. math::
+
+        score = \frac{cum\_score + log\_softmax(logits)}{((5 + len + 1) / 6)^{\alpha}}
+
+    and the top beam_size of the beam_size * beam_size candidates of every
+    batch become the next beams. A finished beam stays one candidate, end_id,
+    with its score unchanged. For the first step, the cum_scores of the beams
+    but the first one of every batch should be -inf, so that the beams of a
+    batch do not start from the same token.
+
+    The KV caches of the next beams are the ones of the beams of parent_idx,
+    which reorder the block tables of a paged KV cache without copying the
+    caches, e.g. by ``KVCacheBlockManager::ReorderBeams`` of the inference.
+
+    Args:
+        logits (Tensor): The logits with shape [batch_size * beam_size, vocab_size], whose data type is float32, float16 or bfloat16.
+        cum_scores (Tensor): The float32 cumulative log probabilities of the beams with shape [batch_size, beam_size].
+        seq_lens (Tensor): The int32 generated lengths of the beams with shape [batch_size, beam_size].
+        finished (Tensor): The bool finished flags of the beams with shape [batch_size, beam_size].
+        end_id (int): The id of the end token.
+        length_penalty (float, optional): The exponent alpha of the length penalty, no penalty if 0. Default: 0.0.
+        name (str, optional): Name for the operation, Default: None. For more information, please refer to :ref:`api_guide_Name`.
+
+    Returns:
+        A tuple of the tensors of the next beams with shape [batch_size, beam_size], sorted by score in every batch: the int64 next tokens, the int32 rows of the parent beams in logits, the float32 cumulative log probabilities, the int32 lengths and the bool finished flags.
+
+    Examples:
+
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> from paddle.incubate.nn.functional import fused_beam_search_step
+
+            >>> paddle.set_device('gpu')
+            >>> batch_size, beam_size, vocab_size = 2, 4, 1000
+            >>> logits = paddle.randn([batch_size * beam_size, vocab_size])
+            >>> cum_scores = paddle.full([batch_size, beam_size], float('-inf'))
+            >>> cum_scores[:, 0] = 0.0
+            >>> seq_lens = paddle.zeros([batch_size, beam_size], dtype="int32")
+            >>> finished = paddle.zeros([batch_size, beam_size], dtype="bool")
+            >>> outs = fused_beam_search_step(
+            ...     logits, cum_scores, seq_lens, finished, end_id=2, length_penalty=0.6)
+            >>> tokens, parents, cum_scores, seq_lens, finished = outs
+            >>> print(tokens.shape)
+            [2, 4]
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.fused_beam_search_step(
+            logits, cum_scores, seq_lens, finished, end_id, length_penalty
+        )
+
+    helper = LayerHelper('fused_beam_search_step', **locals())
+    next_tokens = helper.create_variable_for_type_inference('int64')
+    parent_idx = helper.create_variable_for_type_inference('int32')
+    next_cum_scores = helper.create_variable_for_type_inference('float32')
+    next_seq_lens = helper.create_variable_for_type_inference('int32')
+    next_finished = helper.create_variable_for_type_inference('bool')
+    helper.append_op(
+        type='fused_beam_search_step',
+        inputs={
+            'logits': logits,
+            'cum_scores': cum_scores,
+            'seq_lens': seq_lens,
+            'finished': finished,
+        },
+        outputs={
+            'next_tokens': next_tokens,
+            'parent_idx': parent_idx,
+            'next_cum_scores': next_cum_scores,
+            'next_seq_lens': next_seq_lens,
+            'next_finished': next_finished,
+        },
+        attrs={'end_id': end_id, 'length_penalty': length_penalty},
+    )
+    return (
+        next_tokens,
+        parent_idx,
+        next_cum_scores,
+        next_seq_lens,
+        next_finished,
+    )
@@ -0,0 +1,80 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from paddle import _C_ops
+from paddle.framework import LayerHelper, in_dynamic_or_pir_mode
+
+
+def fused_grouped_gemm(
+    x, weight, expert_offsets, bias=None, act_type="none", name=None
+):
+    r"""
+    The feed forward of all the experts of a MoE layer in one grouped gemm
+    launch. The rows of x are sorted by expert, and the rows of expert e,
+    ``x[expert_offsets[e - 1]:expert_offsets[e]]``, are multiplied by the
+    weight of expert e:
+
+    .. math::
+
+        out_e = act(x_e * weight_e + bias_e)
+
+    where act is fused into the epilogue of the gemm. The experts may get
+    any number of rows, including none. This method requires SM_ARCH in
+    sm70 and later.
+
+    Args:
+        x (Tensor): The input tensor with shape [num_rows, k] sorted by expert, whose data type is float16 or float32.
+        weight (Tensor): The weights of the experts with shape [num_experts, k, n] and the data type of x.
+        expert_offsets (Tensor): The int64 end row of every expert in x with shape [num_experts], i.e. the cumulative sum of the rows of the experts, whose last value must be num_rows.
+        bias (Tensor, optional): The biases of the experts with shape [num_experts, n]. Default: None.
+        act_type (str, optional): The activation, one of "none", "relu" and "gelu" (the tanh approximation). Default: "none".
+        name (str, optional): Name for the operation, Default: None. For more information, please refer to :ref:`api_guide_Name`.
+
+    Returns:
+        The output tensor with shape [num_rows, n].
+
+    Examples:
+
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> from paddle.incubate.nn.functional import fused_grouped_gemm
+
+            >>> paddle.set_device('gpu')
+            >>> x = paddle.randn([10, 64], dtype="float16")
+            >>> weight = paddle.randn([4, 64, 128], dtype="float16")
+            >>> bias = paddle.randn([4, 128], dtype="float16")
+            >>> expert_offsets = paddle.to_tensor([3, 3, 7, 10], dtype="int64")
+            >>> out = fused_grouped_gemm(x, weight, expert_offsets, bias, "gelu")
+            >>> print(out.shape)
+            [10, 128]
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.fused_grouped_gemm(
+            x, weight, bias, expert_offsets, act_type
+        )
+
+    helper = LayerHelper('fused_grouped_gemm', **locals())
+    out = helper.create_variable_for_type_inference(x.dtype)
+    inputs = {'x': x, 'weight': weight, 'expert_offsets': expert_offsets}
+    if bias is not None:
+        inputs['bias'] = bias
+    helper.append_op(
+        type='fused_grouped_gemm',
+        inputs=inputs,
+        outputs={'out': out},
+        attrs={'act_type': act_type},
+    )
+    return out
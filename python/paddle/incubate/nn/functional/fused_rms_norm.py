@@ -127,3 +127,103 @@ def fused_rms_norm(
         outputs=outputs_dict,
     )
     return (out, residual_out) if residual is not None else out
+
+
+def fused_rms_norm_quant(
+    x,
+    norm_weight,
+    norm_bias,
+    epsilon,
+    begin_norm_axis,
+    bias=None,
+    residual=None,
+    quant_round_type=1,
+    quant_max_bound=127.0,
+    quant_min_bound=-127.0,
+):
+    r"""
+    Apply Fused RMSNorm kernel with the int8 output quantized per token, i.e.
+    every row is quantized by its abs max in the same pass of the
+    normalization. Also support RMSNorm(bias + residual + x) fused pattern.
+
+    Args:
+        x (Tensor): the input Tensor.
+        norm_weight (Tensor): the weight Tensor to affine output.
+        norm_bias (Tensor): the bias Tensor to affine output.
+        epsilon (float): a small float number to avoid divide 0.
+        begin_norm_axis (int): the begin axis to normalize.
+        bias (optional|Tensor): the previous layers's bias to fused.
+        residual (optional|Tensor): the residual input to fused.
+        quant_round_type (int): the quant round type, 0 to round half to even
+            and 1 to round half away from zero.
+        quant_max_bound (float): the quant max bound to clip.
+        quant_min_bound (float): the quant min bound to clip.
+
+    Returns:
+        Tensor: the int8 output Tensor, the residual output Tensor if
+        residual is not None, and the float32 dequantization scales of the
+        rows, abs_max / quant_max_bound, of the shape of x with the
+        normalized axes of 1.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> paddle.device.set_device('gpu')
+
+            >>> paddle_x = paddle.cast(paddle.randn(shape=[32, 256]), dtype=paddle.float16)
+            >>> paddle_weight = paddle.cast(paddle.randn(shape=[256]), dtype=paddle.float16)
+            >>> epsilon = 1e-6
+            >>> out, out_scale = paddle.incubate.nn.functional.fused_rms_norm_quant(paddle_x, paddle_weight, None, epsilon, 1)
+            >>> print(out.dtype, out_scale.shape)
+            paddle.int8 [32, 1]
+    """
+    if in_dynamic_mode() or in_pir_mode():
+        out, residual_out, out_scale = _C_ops.fused_rms_norm_quant(
+            x,
+            bias,
+            residual,
+            norm_weight,
+            norm_bias,
+            epsilon,
+            begin_norm_axis,
+            quant_round_type,
+            quant_max_bound,
+            quant_min_bound,
+        )
+        if residual is not None:
+            return out, residual_out, out_scale
+        return out, out_scale
+    helper = LayerHelper('fused_rms_norm_quant', **locals())
+    out = helper.create_variable_for_type_inference(dtype=paddle.int8)
+    residual_out = helper.create_variable_for_type_inference(dtype=x.dtype)
+    out_scale = helper.create_variable_for_type_inference(dtype=paddle.float32)
+
+    inputs = {'x': x, 'norm_weight': norm_weight}
+    if norm_bias is not None:
+        inputs['norm_bias'] = norm_bias
+    if residual is not None:
+        inputs['residual'] = residual
+    if bias is not None:
+        inputs['bias'] = bias
+
+    helper.append_op(
+        type='fused_rms_norm_quant',
+        inputs=inputs,
+        attrs={
+            "epsilon": epsilon,
+            "begin_norm_axis": begin_norm_axis,
+            "quant_round_type": quant_round_type,
+            "quant_max_bound": quant_max_bound,
+            "quant_min_bound": quant_min_bound,
+        },
+        outputs={
+            'out': out,
+            'residual_out': residual_out,
+            'out_scale': out_scale,
+        },
+    )
+    if residual is not None:
+        return out, residual_out, out_scale
+    return out, out_scale
@@ -0,0 +1,95 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import paddle
+from paddle.incubate.nn import functional as F
+from paddle.nn import Layer
+
+
+class FP8Linear(Layer):
+    r"""
+    Linear layer computed by the fp8 tensor cores of sm89 and later with the
+    delayed scaling, see :ref:`api_paddle_incubate_nn_functional_fp8_linear`.
+    The amax histories of the input and the weight are kept as the buffers of
+    the layer, and are updated by every forward.
+
+    Parameters:
+        in_features (int): The number of input units, which must be a multiple of 16.
+        out_features (int): The number of output units, which must be a multiple of 16.
+        weight_attr (ParamAttr, optional): The attribute for the learnable
+            weight of this layer. For detailed information, please refer to
+            paddle.ParamAttr.
+        bias_attr (ParamAttr|bool, optional): The attribute for the learnable bias
+            of this layer. If it is set to False, no bias will be added to the output.
+        amax_history_len (int, optional): The length of the amax histories. Default: 16.
+        margin (float, optional): The margin of the scales in the power of 2. Default: 0.0.
+        name (str, optional): Normally there is no need for user to set this parameter.
+            For detailed information, please refer to :ref:`api_guide_Name` .
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> paddle.device.set_device('gpu')
+            >>> from paddle.incubate.nn import FP8Linear
+
+            >>> paddle.set_default_dtype('float16')
+            >>> x = paddle.randn([8, 64])
+            >>> linear = FP8Linear(64, 32)
+            >>> y = linear(x)
+            >>> print(y.shape)
+            [8, 32]
+    """
+
+    def __init__(
+        self,
+        in_features,
+        out_features,
+        weight_attr=None,
+        bias_attr=None,
+        amax_history_len=16,
+        margin=0.0,
+        name=None,
+    ):
+        super().__init__()
+        dtype = self._helper.get_default_dtype()
+        self.weight = self.create_parameter(
+            shape=[in_features, out_features],
+            attr=weight_attr,
+            dtype=dtype,
+            is_bias=False,
+        )
+        self.bias = self.create_parameter(
+            shape=[out_features], attr=bias_attr, dtype=dtype, is_bias=True
+        )
+        self.register_buffer(
+            'x_amax_history', paddle.zeros([amax_history_len], 'float32')
+        )
+        self.register_buffer(
+            'weight_amax_history', paddle.zeros([amax_history_len], 'float32')
+        )
+        self.margin = margin
+        self.name = name
+
+    def forward(self, input):
+        return F.fp8_linear(
+            input,
+            self.weight,
+            self.bias,
+            self.x_amax_history,
+            self.weight_amax_history,
+            self.margin,
+            self.name,
+        )
@@ -26,7 +26,9 @@ from paddle.base.core import (
     PaddleInferPredictor,
     PaddleInferTensor,
     PaddlePlace,
+    PaddleTensor,
     convert_to_mixed_precision_bind,
+    convert_to_mixed_precision_by_profile_bind,
 )
 from paddle.base.log_helper import get_logger
 
@@ -99,8 +101,18 @@ def convert_to_mixed_precision(
         backend: The backend, e.g. PlaceType.GPU.
         keep_io_types: Whether the model input and output dtype remains unchanged.
         black_list: Operators that do not convert precision.
-        kwargs: Supported keys including 'white_list'.
+        kwargs: Supported keys including 'white_list', 'calibration_inputs'
+            and 'accuracy_tolerance'.
             - white_list: Operators that do convert precision.
+            - calibration_inputs: A list of the inputs of the model, each of
+              which is a dict from the input names to the numpy arrays. If
+              given, the operators are converted by their latencies measured
+              on the backend for the shapes of the first input, instead of
+              all the ones supporting the precision.
+            - accuracy_tolerance: The max error of the outputs on the
+              calibration inputs relative to the max magnitudes of the fp32
+              outputs, 1e-2 by default. The converted operators of the least
+              gains are kept at fp32 until the error is within it.
     '''
     if backend is PlaceType.GPU and not core.is_compiled_with_cuda():
         _logger.error(
@@ -119,6 +131,28 @@ def convert_to_mixed_precision(
     if not os.path.exists(mixed_params_dirname):
         os.makedirs(mixed_params_dirname)
     white_list = kwargs.get('white_list', set())
+    calibration_inputs = kwargs.get('calibration_inputs', None)
+    if calibration_inputs:
+        convert_to_mixed_precision_by_profile_bind(
+            model_file,
+            params_file,
+            mixed_model_file,
+            mixed_params_file,
+            mixed_precision,
+            backend,
+            [
+                [
+                    PaddleTensor(np.ascontiguousarray(value), name)
+                    for name, value in inputs.items()
+                ]
+                for inputs in calibration_inputs
+            ],
+            kwargs.get('accuracy_tolerance', 1e-2),
+            keep_io_types,
+            black_list,
+            white_list,
+        )
+        return
     convert_to_mixed_precision_bind(
         model_file,
         params_file,
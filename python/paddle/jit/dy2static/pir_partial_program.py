@@ -13,6 +13,7 @@
 # limitations under the License.
 
 import itertools
+from concurrent.futures import ThreadPoolExecutor
 
 import numpy as np
 
@@ -321,6 +322,22 @@ class RunableProgram:
         return self._forward_backward_program[0][1]
 
 
+_cinn_compile_pool = None
+
+
+def _cinn_compile_executor():
+    """
+    The thread compiling the programs by CINN in the background, one at a
+    time since the kernels of a program are compiled in parallel already.
+    """
+    global _cinn_compile_pool
+    if _cinn_compile_pool is None:
+        _cinn_compile_pool = ThreadPoolExecutor(
+            max_workers=1, thread_name_prefix="cinn_compile"
+        )
+    return _cinn_compile_pool
+
+
 class PirPassContext:
     """
     PirPassContext is a class that only has staticmethod currently.
@@ -446,11 +463,17 @@ class PartialProgramLayer:
         self._backend = kwargs.get('backend', None)
         self._grad_var_names = {}
         self._debug_name = None
+        # the infer program of the coming runs, and the one compiled on the
+        # background thread in the async compilation of CINN
+        self._current_infer_program = None
+        self._infer_program_future = None
 
     def __call__(self, inputs):
         """
         Execute static graph by Interpreter and Return dynamic Tensors.
         """
+        if not self.training:
+            self._update_infer_program()
         in_vars = self._prepare_inputs(inputs)
         out_vars = self._prepare_outputs()
         attrs = self._prepare_attributes()
@@ -534,15 +557,16 @@ class PartialProgramLayer:
 
     # whole
     @switch_to_static_graph
-    def _create_program(self, is_infer_mode=False):
+    def _create_program(self, is_infer_mode=False, apply_pass=True):
         if is_infer_mode:
             # TODO(xiongkun) who to transfer the pruning program?
             infer_program = self.origin_runable_program.clone()
             if self._hooker:
                 self._hooker.after_infer(infer_program)
-            infer_program = PirPassContext.apply(
-                infer_program, self._build_strategy
-            )
+            if apply_pass:
+                infer_program = PirPassContext.apply(
+                    infer_program, self._build_strategy
+                )
             return infer_program
         else:
             train_program: RunableProgram = self.origin_runable_program.clone()
@@ -579,7 +603,7 @@ class PartialProgramLayer:
         )
         return program_id
 
-    @cached_property
+    @property
     def _infer_program_id(self):
         return paddle.utils._hash_with_id(self.infer_program, self)
 
@@ -611,11 +635,48 @@ class PartialProgramLayer:
             raise NotImplementedError("not implement error.")
         return self._create_program()
 
-    @cached_property
+    @property
     def infer_program(self):
         if _in_amp_guard() or _in_pure_fp16_guard():
             raise NotImplementedError("not implement error.")
-        return self._create_program(is_infer_mode=True)
+        if self._current_infer_program is None:
+            self._update_infer_program()
+        return self._current_infer_program
+
+    def _compile_async(self):
+        return (
+            self._build_strategy.build_cinn_pass
+            and paddle.is_compiled_with_cinn()
+            and paddle.get_flags('FLAGS_cinn_compile_async')[
+                'FLAGS_cinn_compile_async'
+            ]
+        )
+
+    def _update_infer_program(self):
+        """
+        Picks the infer program of the coming run. In the async compilation
+        of CINN, the program without the CINN passes runs until the one with
+        them is compiled on the background thread, so that the compilation
+        does not block the runs. It is picked once before every run, so that
+        the program and its id do not change during the run.
+        """
+        if not self._compile_async():
+            if self._current_infer_program is None:
+                self._current_infer_program = self._create_program(
+                    is_infer_mode=True
+                )
+            return
+        if self._infer_program_future is None:
+            fallback_program = self._create_program(
+                is_infer_mode=True, apply_pass=False
+            )
+            self._current_infer_program = fallback_program
+            self._infer_program_future = _cinn_compile_executor().submit(
+                PirPassContext.apply, fallback_program, self._build_strategy
+            )
+        elif self._infer_program_future.done():
+            # raises the error of the compilation if any
+            self._current_infer_program = self._infer_program_future.result()
 
     def _verify_program(self, main_program):
         """
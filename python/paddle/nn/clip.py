@@ -250,6 +250,36 @@ def _squared_l2_norm(x):
     return out
 
 
+def _use_merged_squared_l2_norm(grads):
+    r"""
+    Whether the squared L2 norms of the grads are computed by
+    merged_squared_l2_norm, which reads the grads of the same dtype in a few
+    multi-tensor launches instead of a launch per grad.
+    """
+    if not in_dynamic_mode() or len(grads) < 2:
+        return False
+    for g in grads:
+        if not g.place.is_gpu_place() or g.dtype not in [
+            core.VarDesc.VarType.FP16,
+            core.VarDesc.VarType.BF16,
+            core.VarDesc.VarType.FP32,
+            core.VarDesc.VarType.FP64,
+        ]:
+            return False
+    return True
+
+
+def _merged_squared_l2_norm(grads):
+    r"""
+    Return the squared L2 norms of the grads of every dtype, the norms of
+    float16 and bfloat16 grads are float32.
+    """
+    grads_of_dtype = {}
+    for g in grads:
+        grads_of_dtype.setdefault(g.dtype, []).append(g)
+    return [_C_ops.merged_squared_l2_norm(v) for v in grads_of_dtype.values()]
+
+
 class BaseErrorClipAttr:
     def __str__(self):
         raise NotImplementedError()
@@ -671,6 +701,7 @@ class ClipGradByGlobalNorm(ClipGradBase):
         sum_square_list = []
         sum_square_list_fp16 = []
         sum_square_list_fp32 = []
+        merge_grads = []
         for p, g in params_grads:
             if g is None:
                 continue
@@ -686,7 +717,13 @@ class ClipGradByGlobalNorm(ClipGradBase):
                 merge_grad = merge_selected_rows(g)
                 merge_grad = get_tensor_from_selected_rows(merge_grad)
 
-            sum_square = _squared_l2_norm(merge_grad)
+            merge_grads.append(merge_grad)
+
+        if _use_merged_squared_l2_norm(merge_grads):
+            sum_squares = _merged_squared_l2_norm(merge_grads)
+        else:
+            sum_squares = [_squared_l2_norm(g) for g in merge_grads]
+        for sum_square in sum_squares:
             if (
                 sum_square.dtype == core.VarDesc.VarType.FP16
                 or sum_square.dtype == core.VarDesc.VarType.BF16
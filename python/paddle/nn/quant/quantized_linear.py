@@ -36,7 +36,7 @@ def _get_arch_info():
         )
 
 
-def weight_quantize(x, algo="weight_only_int8", arch=None):
+def weight_quantize(x, algo="weight_only_int8", arch=None, group_size=-1):
     """
     Quantization function for weight_only and llm.int8's weight.
 
@@ -45,10 +45,11 @@ def weight_quantize(x, algo="weight_only_int8", arch=None):
         algo (str): The algo that is x will be apply, must be one of 'weight_only_int8',
             'weight_only_int4' and 'llm.int8', default: 'weight_only_int8'.
         arch (int): The compute arch for target device. For example, A100 is 80, v100 is 70, if you do not assign arch, we will get arch from your device, default: None.
+        group_size (int): The rows of x sharing a scale, must be one of -1, 64 and 128. -1 means the per-channel quantization, otherwise the weight is quantized group-wise and is only supported by weight_only_linear with the same group_size, default: -1.
 
     Returns:
         out (Tensor): The Tensor which is the quantitative results, the data type is int8, the shape is transposition of x.
-        scale (Tensor): The scale Tensor which is the scale of pre-channel, the data type is float32.
+        scale (Tensor): The scale Tensor which is the scale of pre-channel, the data type is float32. Its shape is [k / group_size, n] for the group-wise quantization of x of shape [k, n].
     Examples:
         .. code-block:: python
 
@@ -71,8 +72,14 @@ def weight_quantize(x, algo="weight_only_int8", arch=None):
         arch == 70 or arch == 80 or arch == 86 or arch == 75
     ), f"Currently weight_quantize only support SM70/75/80/86. but got {arch} "
 
+    assert group_size in (
+        -1,
+        64,
+        128,
+    ), f"Currently group_size only support -1/64/128. but got {group_size} "
+
     if in_dynamic_mode():
-        return _C_ops.weight_quantize(x, algo, arch)
+        return _C_ops.weight_quantize(x, algo, arch, group_size)
     else:
         type = "weight_quantize"
         helper = LayerHelper(type, **locals())
@@ -83,12 +90,14 @@ def weight_quantize(x, algo="weight_only_int8", arch=None):
             type=type,
             inputs={"x": x},
             outputs={'out': out, "scale": scale},
-            attrs={"algo": algo, "arch": arch},
+            attrs={"algo": algo, "arch": arch, "group_size": group_size},
         )
         return (out, scale)
 
 
-def weight_dequantize(x, scale, algo="weight_only_int8", out_dtype='float16'):
+def weight_dequantize(
+    x, scale, algo="weight_only_int8", out_dtype='float16', group_size=-1
+):
     """
     Dequantization function for weight_only and llm.int8's weight.
 
@@ -98,6 +107,7 @@ def weight_dequantize(x, scale, algo="weight_only_int8", out_dtype='float16'):
         algo (str): The algo that is x will be apply, must be one of 'weight_only_int8',
             'weight_only_int4' and 'llm.int8', default: 'weight_only_int8'.
         out_dtype (str|np.dtype): The output Tensor's data type, must be one of 'float16' and 'bfloat16', default: 'float16'.
+        group_size (int): The group_size of weight_quantize which outputs x and scale, default: -1.
 
     Returns:
         out (Tensor): The Tensor which is the dequantitative results, the data type is float16 or bfloat16, the shape is transposition of x.
@@ -119,7 +129,7 @@ def weight_dequantize(x, scale, algo="weight_only_int8", out_dtype='float16'):
     )
     out_dtype = convert_np_dtype_to_dtype_(out_dtype)
     if in_dynamic_mode():
-        return _C_ops.weight_dequantize(x, scale, algo, out_dtype)
+        return _C_ops.weight_dequantize(x, scale, algo, out_dtype, group_size)
     else:
         type = "weight_dequantize"
         helper = LayerHelper(type, **locals())
@@ -129,13 +139,24 @@ def weight_dequantize(x, scale, algo="weight_only_int8", out_dtype='float16'):
             type=type,
             inputs={"x": x, "scale": scale},
             outputs={'out': out},
-            attrs={"algo": algo, "out_dtype": out_dtype},
+            attrs={
+                "algo": algo,
+                "out_dtype": out_dtype,
+                "group_size": group_size,
+            },
         )
         return out
 
 
 def weight_only_linear(
-    x, weight, bias=None, weight_scale=None, weight_dtype="int8", arch=None
+    x,
+    weight,
+    bias=None,
+    weight_scale=None,
+    weight_dtype="int8",
+    arch=None,
+    group_size=-1,
+    activation="none",
 ):
     """
     Applies matrix multiplication of two tensors and then bias addition if provided.
@@ -146,9 +167,11 @@ def weight_only_linear(
         weight (Tensor): The second input Tensor to be multiplied. Its rank must be 2.
         bias (Tensor|None): The input bias Tensor. If it is None, no bias addition would
             be performed. Otherwise, The bias is added to the matrix multiplication result.
-        weight_scale (Tensor|None): The input scale Tensor Provided to weight for dequantization. Its rank must be 1.
+        weight_scale (Tensor|None): The input scale Tensor Provided to weight for dequantization. Its rank must be 1, or 2 for the group-wise quantization.
         weight_dtype(str): The dtype of  weight Tensor, must be one of 'int8', 'int4', Defaulted to 'int8'.
         arch (int): The compute arch for target device. For example, A100 is 80, v100 is 70, if you do not assign arch, we will get arch from your device, default: None.
+        group_size (int): The group_size of weight_quantize which outputs weight and weight_scale, must be one of -1, 64 and 128, default: -1.
+        activation (str): The activation applied after the bias addition, must be one of 'none', 'gelu', 'relu' and 'silu'. It is fused into the epilogue of the group-wise gemm, default: 'none'.
     Returns:
         Tensor: the output Tensor, the data type is the same as that of x.
 
@@ -177,7 +200,14 @@ def weight_only_linear(
 
     if in_dynamic_mode():
         out = _C_ops.weight_only_linear(
-            x, weight, bias, weight_scale, weight_dtype, arch
+            x,
+            weight,
+            bias,
+            weight_scale,
+            weight_dtype,
+            arch,
+            group_size,
+            activation,
         )
         return out
     else:
@@ -195,7 +225,12 @@ def weight_only_linear(
         }
         if bias is not None:
             inputs["bias"] = [bias]
-        attrs = {'weight_dtype': weight_dtype, 'arch': arch}
+        attrs = {
+            'weight_dtype': weight_dtype,
+            'arch': arch,
+            'group_size': group_size,
+            'activation': activation,
+        }
 
         out = helper.create_variable_for_type_inference(dtype)
 
@@ -231,6 +231,10 @@ class Adam(Optimizer):
             self._master_weight_dict = self._create_multi_tensor_dict()
             self._master_weight_dict['FP32_LODTensor'] = None
 
+    def _skip_update_on_device(self):
+        # The merged adam of the multi tensor has no skip_update.
+        return not self._use_multi_tensor
+
     def _add_moments_pows(self, p):
         acc_dtype = p.dtype
         if self._is_dtype_fp16_or_bf16(acc_dtype):
@@ -249,7 +253,7 @@ class Adam(Optimizer):
             else self._beta1,
             shape=[1],
             type=core.VarDesc.VarType.LOD_TENSOR,
-            device='cpu',
+            device=self._get_beta_pow_device(),
         )
         self._add_accumulator(
             name=self._beta2_pow_acc_str,
@@ -260,7 +264,7 @@ class Adam(Optimizer):
             else self._beta2,
             shape=[1],
             type=core.VarDesc.VarType.LOD_TENSOR,
-            device='cpu',
+            device=self._get_beta_pow_device(),
         )
 
     def _create_accumulators(self, block, parameters):
@@ -328,6 +332,10 @@ class Adam(Optimizer):
                 else self._beta2.item(0)
             )
 
+            found_inf = self._get_auxiliary_var('found_inf')
+            skip_update = (
+                found_inf if isinstance(found_inf, core.eager.Tensor) else None
+            )
             _, _, _, _, _, _ = _C_ops.adam_(
                 param_and_grad[0],
                 param_and_grad[1],
@@ -337,7 +345,7 @@ class Adam(Optimizer):
                 beta1_pow_acc,
                 beta2_pow_acc,
                 master_weight,
-                None,
+                skip_update,
                 _beta1,
                 _beta2,
                 self._epsilon,
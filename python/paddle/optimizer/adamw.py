@@ -345,6 +345,9 @@ class AdamW(Optimizer):
 
         self._param_groups.append(param_group)
 
+    def _skip_update_on_device(self):
+        return True
+
     def _add_moments_pows(self, p):
         acc_dtype = p.dtype
         if self._is_dtype_fp16_or_bf16(acc_dtype):
@@ -379,7 +382,7 @@ class AdamW(Optimizer):
             else self._beta1,
             shape=[1],
             type=core.VarDesc.VarType.LOD_TENSOR,
-            device='cpu',
+            device=self._get_beta_pow_device(),
         )
         self._add_accumulator(
             name=self._beta2_pow_acc_str,
@@ -390,7 +393,7 @@ class AdamW(Optimizer):
             else self._beta2,
             shape=[1],
             type=core.VarDesc.VarType.LOD_TENSOR,
-            device='cpu',
+            device=self._get_beta_pow_device(),
         )
 
     def _create_accumulators(self, block, parameters):
@@ -473,6 +476,10 @@ class AdamW(Optimizer):
                 else self._beta2.item(0)
             )
 
+            found_inf = self._get_auxiliary_var('found_inf')
+            skip_update = (
+                found_inf if isinstance(found_inf, core.eager.Tensor) else None
+            )
             _, _, _, _, _, _ = _C_ops.adamw_(
                 param_and_grad[0],
                 param_and_grad[1],
@@ -482,7 +489,7 @@ class AdamW(Optimizer):
                 beta1_pow_acc,
                 beta2_pow_acc,
                 master_weight,
-                None,
+                skip_update,
                 _beta1,
                 _beta2,
                 self._epsilon,
@@ -174,6 +174,9 @@ class Lamb(Optimizer):
                 self._add_moments_pows(p)
                 self._already_create_accumulater.add(p.name)
 
+    def _skip_update_on_device(self):
+        return True
+
     def _add_moments_pows(self, p):
         acc_dtype = p.dtype
         if self._is_dtype_fp16_or_bf16(acc_dtype):
@@ -190,7 +193,7 @@ class Lamb(Optimizer):
             else self._beta1,
             shape=[1],
             type=core.VarDesc.VarType.LOD_TENSOR,
-            device='cpu',
+            device=self._get_beta_pow_device(),
         )
         self._add_accumulator(
             name=self._beta2_pow_acc_str,
@@ -201,7 +204,7 @@ class Lamb(Optimizer):
             else self._beta2,
             shape=[1],
             type=core.VarDesc.VarType.LOD_TENSOR,
-            device='cpu',
+            device=self._get_beta_pow_device(),
         )
 
     def _append_optimize_op(self, block, param_and_grad):
@@ -244,6 +247,10 @@ class Lamb(Optimizer):
             master_weight = None
 
         if framework.in_dygraph_mode():
+            found_inf = self._get_auxiliary_var('found_inf')
+            skip_update = (
+                found_inf if isinstance(found_inf, core.eager.Tensor) else None
+            )
             _C_ops.lamb_(
                 param_and_grad[0],
                 param_and_grad[1],
@@ -253,7 +260,7 @@ class Lamb(Optimizer):
                 beta1_pow_acc,
                 beta2_pow_acc,
                 master_weight,
-                None,
+                skip_update,
                 weight_decay,
                 self._beta1,
                 self._beta2,
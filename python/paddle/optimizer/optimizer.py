@@ -1056,6 +1056,31 @@ class Optimizer:
             device = self._param_device_map[param_name]
         return device
 
+    def _get_beta_pow_device(self):
+        # The beta pows are updated on the cpu, except in the CUDA Graph
+        # capture of the new executor, which can not capture the host updates,
+        # and with a gpu found_inf skipping the update on the device.
+        if paddle.get_flags('FLAGS_new_executor_use_cuda_graph')[
+            'FLAGS_new_executor_use_cuda_graph'
+        ]:
+            return None
+        found_inf = self._get_auxiliary_var('found_inf')
+        if (
+            self._skip_update_on_device()
+            and isinstance(found_inf, core.eager.Tensor)
+            and found_inf.place.is_gpu_place()
+        ):
+            return None
+        return 'cpu'
+
+    def _skip_update_on_device(self):
+        """
+        Whether the optimize ops take the found_inf of the loss scaling as
+        skip_update, which skips the update on the device instead of reading
+        found_inf on the host in every step.
+        """
+        return False
+
     def _create_optimization_pass(
         self, parameters_and_grads, param_group_idx=0
     ):
@@ -1193,11 +1218,18 @@ class Optimizer:
 
             if framework.in_dygraph_mode():
                 found_inf = self._get_auxiliary_var('found_inf')
-                if found_inf:
+                # A found_inf tensor stays the auxiliary var when the optimize
+                # ops skip the update on the device.
+                skip_update_on_device = isinstance(
+                    found_inf, core.eager.Tensor
+                ) and self._skip_update_on_device()
+                if not skip_update_on_device and found_inf:
                     if isinstance(found_inf, core.eager.Tensor):
                         self._set_auxiliary_var('found_inf', True)
                 else:
-                    if isinstance(found_inf, core.eager.Tensor):
+                    if not skip_update_on_device and isinstance(
+                        found_inf, core.eager.Tensor
+                    ):
                         self._set_auxiliary_var('found_inf', False)
                     if isinstance(parameters_and_grads, list):
                         for param_and_grad in parameters_and_grads:
@@ -15,9 +15,10 @@
 from .profiler import ProfilerState, ProfilerTarget
 from .profiler import make_scheduler, export_chrome_tracing, export_protobuf
 from .profiler import Profiler
+from .distributed_trace import merge_distributed_traces
 from .profiler import SummaryView
 from .profiler import TracerEventType
-from .utils import RecordEvent, load_profiler_result
+from .utils import RecordEvent, load_profiler_result, sampling_summary
 from .profiler_statistic import SortedKeys
 
 __all__ = [
@@ -27,8 +28,10 @@ __all__ = [
     'export_chrome_tracing',
     'export_protobuf',
     'Profiler',
+    'merge_distributed_traces',
     'RecordEvent',
     'load_profiler_result',
+    'sampling_summary',
     'SortedKeys',
     'SummaryView',
 ]
@@ -0,0 +1,289 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import bisect
+import json
+import re
+import time
+from collections import defaultdict
+
+# the host events of the communications are named by CommTraceName as
+# "<backend>::<op>#group_key:<key>,seq:<seq>", with the duration appended by
+# the chrome tracing logger
+_COMM_EVENT_PATTERN = re.compile(r'^([^#\[]+)#(group_key:[^\[]*,seq:\d+)')
+
+# the pids of the ranks are rank * _PID_STRIDE + pid in the merged trace
+_PID_STRIDE = 1 << 22
+_ID_STRIDE = 1 << 32
+
+_clock_sync_epoch_key = 'profiler/clock_sync/epoch'
+
+
+def sync_clock(store, rank, world_size, rounds=8):
+    r"""
+    Estimates the offset of the clock of this rank to the clock of rank 0
+    through the store, which is the global TCPStore in a distributed job.
+    Rank 0 answers the requests of the other ranks in turn with its time, and
+    every rank takes the offset of the round trip with the smallest latency,
+    as NTP does, so the error is within half of that latency.
+
+    All the ranks must call it together.
+
+    Args:
+        store (Store): The store shared by the ranks.
+        rank (int): The rank of this process.
+        world_size (int): The number of the ranks.
+        rounds (int, optional): The round trips of every rank. Default: 8.
+
+    Returns:
+        int: The nanoseconds to add to the timestamps of this rank to align
+        them to rank 0.
+    """
+    if world_size <= 1:
+        return 0
+    # the keys of every sync are unique, so that the profilers can be started
+    # many times in a job
+    epoch = (store.add(_clock_sync_epoch_key, 1) - 1) // world_size
+    prefix = f'profiler/clock_sync/{epoch}'
+    if rank == 0:
+        for peer in range(1, world_size):
+            for i in range(rounds):
+                store.wait(f'{prefix}/{peer}/{i}/req')
+                store.set(f'{prefix}/{peer}/{i}/resp', str(time.time_ns()))
+        return 0
+
+    best_rtt, offset = None, 0
+    for i in range(rounds):
+        t0 = time.time_ns()
+        store.set(f'{prefix}/{rank}/{i}/req', '1')
+        remote = int(store.get(f'{prefix}/{rank}/{i}/resp'))
+        t1 = time.time_ns()
+        if best_rtt is None or t1 - t0 < best_rtt:
+            best_rtt, offset = t1 - t0, remote - (t0 + t1) // 2
+    return offset
+
+
+def _load_trace(filename):
+    with open(filename, 'r') as f:
+        trace = json.load(f)
+    events = [e for e in trace.get('traceEvents', []) if e]
+    return trace, events
+
+
+class _CommRecord:
+    def __init__(self, op):
+        self.op = op
+        # rank -> (begin, end) in us on the clock of rank 0
+        self.spans = {}
+        # the host events of the communication in the merged trace
+        self.events = []
+
+    def add(self, rank, begin, end, event):
+        self.events.append(event)
+        # a tag repeated in a rank, e.g. by a group created again, keeps the
+        # first one
+        self.spans.setdefault(rank, (begin, end))
+
+    def skews(self):
+        begins = sorted((b, r) for r, (b, _) in self.spans.items())
+        ends = [e for (_, e) in self.spans.values()]
+        durations = [e - b for (b, e) in self.spans.values()]
+        return {
+            'begin_skew': begins[-1][0] - begins[0][0],
+            'end_skew': max(ends) - min(ends),
+            'straggler': begins[-1][1],
+            'min_duration': min(durations),
+            'max_duration': max(durations),
+        }
+
+
+def _collect_comms(rank, events, offset_us, records):
+    # the nccl kernels are found by the correlation ids of the runtime calls
+    # within the host events of the communications
+    kernels = {}
+    runtimes = defaultdict(list)
+    comms = []
+    for e in events:
+        if e.get('ph') != 'X':
+            continue
+        cat = e.get('cat')
+        if cat == 'Kernel':
+            corr = e.get('args', {}).get('correlation id')
+            if corr is not None:
+                kernels[corr] = e
+        elif cat == 'CudaRuntime':
+            runtimes[(e['pid'], e['tid'])].append(e)
+        elif cat == 'Communication':
+            match = _COMM_EVENT_PATTERN.match(e.get('name', ''))
+            if match:
+                comms.append((match.group(1), match.group(2), e))
+
+    for thread_runtimes in runtimes.values():
+        thread_runtimes.sort(key=lambda runtime: runtime['ts'])
+    runtime_ts = {k: [r['ts'] for r in v] for k, v in runtimes.items()}
+
+    for op, tag, e in comms:
+        begin, end = e['ts'], e['ts'] + e.get('dur', 0)
+        device_begin, device_end = None, None
+        thread = (e['pid'], e['tid'])
+        thread_runtimes = runtimes.get(thread, [])
+        lo = bisect.bisect_left(runtime_ts.get(thread, []), begin)
+        hi = bisect.bisect_right(runtime_ts.get(thread, []), end)
+        for runtime in thread_runtimes[lo:hi]:
+            kernel = kernels.get(runtime.get('args', {}).get('correlation id'))
+            if kernel is None:
+                continue
+            k_begin, k_end = kernel['ts'], kernel['ts'] + kernel.get('dur', 0)
+            device_begin = (
+                k_begin if device_begin is None else min(device_begin, k_begin)
+            )
+            device_end = k_end if device_end is None else max(device_end, k_end)
+        if device_begin is not None:
+            begin, end = device_begin, device_end
+        records.setdefault(tag, _CommRecord(op)).add(
+            rank, begin + offset_us, end + offset_us, e
+        )
+
+
+def _shift_event(e, rank, offset_us):
+    if 'ts' in e:
+        e['ts'] = e['ts'] + offset_us
+    if isinstance(e.get('pid'), int):
+        e['pid'] = rank * _PID_STRIDE + e['pid']
+    if isinstance(e.get('id'), int):
+        e['id'] = rank * _ID_STRIDE + e['id']
+    if e.get('ph') == 'M' and e.get('name') == 'process_name':
+        args = e.setdefault('args', {})
+        args['name'] = f"[rank {rank}] {args.get('name', '')}"
+    if e.get('ph') == 'M' and e.get('name') == 'process_sort_index':
+        args = e.setdefault('args', {})
+        args['sort_index'] = rank * _PID_STRIDE + args.get('sort_index', 0)
+
+
+def _format_report(records, top_k):
+    lines = []
+    stats = []
+    lateness = defaultdict(float)
+    straggle_count = defaultdict(int)
+    for tag, record in records.items():
+        if len(record.spans) < 2:
+            continue
+        skew = record.skews()
+        stats.append((tag, record, skew))
+        first_begin = min(b for (b, _) in record.spans.values())
+        for r, (b, _) in record.spans.items():
+            lateness[r] += b - first_begin
+        straggle_count[skew['straggler']] += 1
+
+    lines.append(f"{'-' * 30} Collective Skew {'-' * 30}")
+    lines.append(
+        f"Matched communications: {len(stats)}, "
+        f"total begin skew(us): {sum(s['begin_skew'] for _, _, s in stats):.3f}"
+    )
+    header = (
+        f"{'Op':<24}{'Tag':<48}{'Ranks':<7}{'Begin skew(us)':<16}"
+        f"{'End skew(us)':<14}{'Straggler':<11}{'Duration(us)':<16}"
+    )
+    lines.append(header)
+    stats.sort(key=lambda item: item[2]['begin_skew'], reverse=True)
+    for tag, record, skew in stats[:top_k]:
+        lines.append(
+            f"{record.op:<24}{tag:<48}{len(record.spans):<7}"
+            f"{skew['begin_skew']:<16.3f}{skew['end_skew']:<14.3f}"
+            f"{skew['straggler']:<11}"
+            f"{skew['min_duration']:.3f}~{skew['max_duration']:.3f}"
+        )
+
+    lines.append('')
+    lines.append(f"{'-' * 30} Straggler Ranks {'-' * 30}")
+    lines.append(f"{'Rank':<8}{'Last arrivals':<16}{'Total lateness(us)':<20}")
+    ranks = sorted(lateness, key=lambda r: lateness[r], reverse=True)
+    for r in ranks[:top_k]:
+        lines.append(f"{r:<8}{straggle_count[r]:<16}{lateness[r]:<20.3f}")
+    return '\n'.join(lines)
+
+
+def merge_distributed_traces(trace_files, output_file=None, top_k=20):
+    r"""
+    Merges the chrome traces of the ranks into one timeline, and reports the
+    skews of the communications across the ranks.
+
+    The traces are exported by a :ref:`Profiler <api_paddle_profiler_Profiler>`
+    with ``distributed=True``, whose extra info records the rank and the
+    offset of its clock to rank 0. The timestamps of every rank are shifted by
+    the offset, and the processes are prefixed by the rank. The host events of
+    the communications are tagged by their group and sequence ids, by which
+    they are matched across the ranks, and the nccl kernels they launched give
+    the device time of them.
+
+    For every communication, the begin skew is the spread of the times the
+    ranks begin it, and the straggler is the rank which begins it last, which
+    the other ranks wait for; a large duration with a small begin skew points
+    to a slow link instead.
+
+    Args:
+        trace_files (list[str]): The chrome trace files of the ranks.
+        output_file (str, optional): The file the merged trace is written to. Default: None, which does not write it.
+        top_k (int, optional): The number of the communications and the ranks in the report. Default: 20.
+
+    Returns:
+        str: The report of the skews of the communications and the stragglers.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +SKIP('the traces of a distributed job')
+            >>> import glob
+            >>> import paddle.profiler as profiler
+            >>> report = profiler.merge_distributed_traces(
+            ...     glob.glob('./profiler_log/*.json'), 'merged_trace.json')
+            >>> print(report)
+    """
+    merged_events = []
+    records = {}
+    offsets = {}
+    for index, filename in enumerate(trace_files):
+        trace, events = _load_trace(filename)
+        extra_info = trace.get('ExtraInfo', {})
+        rank = int(extra_info.get('rank', index))
+        offset_us = int(extra_info.get('clock_offset_ns', 0)) / 1000.0
+        offsets[rank] = offset_us
+        _collect_comms(rank, events, offset_us, records)
+        for e in events:
+            _shift_event(e, rank, offset_us)
+        merged_events.extend(events)
+
+    for record in records.values():
+        if len(record.spans) < 2:
+            continue
+        skew = record.skews()
+        for e in record.events:
+            args = e.setdefault('args', {})
+            args['begin_skew_us'] = round(skew['begin_skew'], 3)
+            args['straggler_rank'] = skew['straggler']
+
+    if output_file:
+        with open(output_file, 'w') as f:
+            json.dump(
+                {
+                    'traceEvents': merged_events,
+                    'ExtraInfo': {
+                        'clock_offset_us': {
+                            str(r): o for r, o in sorted(offsets.items())
+                        }
+                    },
+                },
+                f,
+            )
+    return _format_report(records, top_k)
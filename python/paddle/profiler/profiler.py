@@ -40,6 +40,7 @@ from .profiler_statistic import (
     gen_layer_flops,
 )
 from .timer import benchmark
+from .distributed_trace import sync_clock
 from .utils import RecordEvent, wrap_optimizers
 
 
@@ -360,6 +361,7 @@ class Profiler:
         profile_memory (bool, optional): If it is True, collect tensor memory allocation and release information. Default: False.
         custom_device_types (list, optional): If targets contain profiler.ProfilerTarget.CUSTOM_DEVICE, custom_device_types select the custom device type for profiling. The default value represents all custom devices will be selected.
         with_flops (bool, optional): If it is True, the flops of the op will be calculated. Default: False.
+        distributed (bool, optional): If it is True, the clocks of the ranks are synchronized through the global TCPStore when the profiler starts, and the rank and its clock offset to rank 0 are recorded in the exported traces, which are merged into one timeline by :ref:`merge_distributed_traces <api_paddle_profiler_merge_distributed_traces>` . All the ranks must start the profiler together. Default: False.
 
     Examples:
         1. profiling range [2, 5).
@@ -485,6 +487,7 @@ class Profiler:
         emit_nvtx: Optional[bool] = False,
         custom_device_types: Optional[list] = [],
         with_flops: Optional[bool] = False,
+        distributed: Optional[bool] = False,
     ):
         supported_targets = _get_supported_targets()
         if targets:
@@ -547,6 +550,9 @@ class Profiler:
         self.profile_memory = profile_memory
         self.with_flops = with_flops
         self.emit_nvtx = emit_nvtx
+        self.distributed = distributed
+        self._rank = 0
+        self._clock_offset_ns = 0
 
     def __enter__(self):
         self.start()
@@ -589,6 +595,8 @@ class Profiler:
             enable_op_info_recorder()
         if self.profile_memory:
             enable_memory_recorder()
+        if self.distributed:
+            self._sync_clock()
         # CLOSED -> self.current_state
         if self.current_state == ProfilerState.READY:
             self.profiler.prepare()
@@ -649,7 +657,7 @@ class Profiler:
             self.current_state == ProfilerState.RECORD
             or self.current_state == ProfilerState.RECORD_AND_RETURN
         ):
-            self.profiler_result = self.profiler.stop()
+            self.profiler_result = self._stop_profiler()
             if self.on_trace_ready:
                 self.on_trace_ready(self)
         utils._is_profiler_used = False
@@ -795,27 +803,43 @@ class Profiler:
             if (
                 self.current_state == ProfilerState.CLOSED
             ):  # RECORD_AND_RETURN -> CLOSED
-                self.profiler_result = self.profiler.stop()
+                self.profiler_result = self._stop_profiler()
             if (
                 self.current_state == ProfilerState.READY
             ):  # RECORD_AND_RETURN -> READY
-                self.profiler_result = self.profiler.stop()
+                self.profiler_result = self._stop_profiler()
                 self.profiler.prepare()
             if (
                 self.current_state == ProfilerState.RECORD
             ):  # RECORD_AND_RETURN -> RECORD
-                self.profiler_result = self.profiler.stop()
+                self.profiler_result = self._stop_profiler()
                 self.profiler.prepare()
                 self.profiler.start()
             if (
                 self.current_state == ProfilerState.RECORD_AND_RETURN
             ):  # RECORD_AND_RETURN -> RECORD_AND_RETURN
-                self.profiler_result = self.profiler.stop()
+                self.profiler_result = self._stop_profiler()
                 self.profiler.prepare()
                 self.profiler.start()
             if self.on_trace_ready:
                 self.on_trace_ready(self)
 
+    def _sync_clock(self):
+        world_size = paddle.distributed.get_world_size()
+        self._rank = paddle.distributed.get_rank()
+        if world_size > 1:
+            store = paddle.base.core.create_or_get_global_tcp_store()
+            self._clock_offset_ns = sync_clock(store, self._rank, world_size)
+
+    def _stop_profiler(self):
+        result = self.profiler.stop()
+        if self.distributed and result is not None:
+            result.add_extra_info('rank', str(self._rank))
+            result.add_extra_info(
+                'clock_offset_ns', str(self._clock_offset_ns)
+            )
+        return result
+
     def export(self, path="", format="json"):
         r"""
         Exports the tracing data to file.
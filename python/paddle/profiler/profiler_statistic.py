@@ -800,6 +800,28 @@ class MemorySummary:
         )  # for memory summary, device type: event
         self.peak_allocation_values = collections.defaultdict(int)
         self.peak_reserved_values = collections.defaultdict(int)
+        # for peak memory breakdown, device type: PeakBreakdown
+        self.peak_breakdowns = {}
+
+    class PeakBreakdown:
+        r"""
+        The allocations alive at the peak of the allocated memory of a place,
+        grouped by the ops allocating them.
+        """
+
+        def __init__(self, place, timestamp_ns, peak_size, untracked_size):
+            self.place = place
+            self.timestamp_ns = timestamp_ns
+            self.peak_size = peak_size
+            # allocated before the profiling range or not by paddle
+            self.untracked_size = untracked_size
+            # op: [count, size]
+            self.items = collections.defaultdict(lambda: [0, 0])
+
+        def add_allocation(self, op_name, size):
+            item = self.items[op_name]
+            item[0] += 1
+            item[1] += size
 
     def _analyse_node_memory(self, event_name, node):
         for memnode in node.mem_node:  # self mem node
@@ -850,6 +872,60 @@ class MemorySummary:
                     for child in host_node.children_node:
                         self._analyse_node_memory(host_node.name, child)
                 self._analyse_node_memory(host_node.name, host_node)
+        self._analyse_peak_memory(thread2hostnodes)
+
+    def _analyse_peak_memory(self, thread2hostnodes):
+        r"""
+        Replay the allocations and frees of every place in time to find the
+        peak of the memory allocated in the profiling range, and break the
+        allocations alive at the peak down by the ops allocating them.
+        """
+        place2memnodes = collections.defaultdict(list)
+        for threadid, host_nodes in thread2hostnodes.items():
+            for host_node in host_nodes:
+                for memnode in host_node.mem_node:
+                    if memnode.type in (
+                        TracerMemEventType.Allocate,
+                        TracerMemEventType.Free,
+                    ):
+                        place2memnodes[memnode.place].append(memnode)
+
+        for place, memnodes in place2memnodes.items():
+            memnodes.sort(key=lambda x: x.timestamp_ns)
+
+            def replay(memnodes):
+                live = {}  # addr: (op, size)
+                current_size = 0
+                for index, memnode in enumerate(memnodes):
+                    if memnode.type == TracerMemEventType.Allocate:
+                        live[memnode.addr] = (
+                            memnode.alloc_op,
+                            memnode.increase_bytes,
+                        )
+                        current_size += memnode.increase_bytes
+                    elif memnode.addr in live:
+                        current_size -= live.pop(memnode.addr)[1]
+                    yield index, live, current_size
+
+            peak_index, peak_size = -1, 0
+            for index, _, current_size in replay(memnodes):
+                if current_size > peak_size:
+                    peak_index, peak_size = index, current_size
+            if peak_index < 0:
+                continue
+            for index, live, _ in replay(memnodes):
+                if index == peak_index:
+                    break
+            peak_node = memnodes[peak_index]
+            breakdown = MemorySummary.PeakBreakdown(
+                place,
+                peak_node.timestamp_ns,
+                peak_size,
+                max(peak_node.current_allocated - peak_size, 0),
+            )
+            for op_name, size in live.values():
+                breakdown.add_allocation(op_name, size)
+            self.peak_breakdowns[place] = breakdown
 
 
 class StatisticData:
@@ -2058,4 +2134,62 @@ def _build_table(
                 append('')
                 append('')
 
+        # ----- Print Peak Memory Breakdown Report ----- #
+        for (
+            device_type,
+            breakdown,
+        ) in statistic_data.memory_summary.peak_breakdowns.items():
+            total_size = breakdown.peak_size + breakdown.untracked_size
+            all_row_values = []
+            sorted_items = sorted(
+                breakdown.items.items(), key=lambda x: x[1][1], reverse=True
+            )
+            for op_name, (count, size) in sorted_items:
+                all_row_values.append(
+                    [
+                        op_name if op_name else '[outside of ops]',
+                        count,
+                        size,
+                        format_ratio(float(size) / total_size),
+                    ]
+                )
+            if breakdown.untracked_size > 0:
+                all_row_values.append(
+                    [
+                        '[before profiling]',
+                        '-',
+                        breakdown.untracked_size,
+                        format_ratio(
+                            float(breakdown.untracked_size) / total_size
+                        ),
+                    ]
+                )
+
+            headers = ['Allocated By', 'Live Count', 'Live Size', 'Ratio(%)']
+            row_format_list = [""]
+            header_sep_list = [""]
+            line_length_list = [-SPACING_SIZE]
+            add_column(50)
+            add_column(15)
+            add_column(15)
+            add_column(15)
+
+            row_format = row_format_list[0]
+            header_sep = header_sep_list[0]
+            line_length = line_length_list[0]
+
+            append(
+                add_title(
+                    line_length, f"Peak Memory Breakdown - {device_type}"
+                )
+            )
+            append(f'Peak Allocated Memory: {total_size}')
+            append(header_sep)
+            append(row_format.format(*headers))
+            append(header_sep)
+            for row_values in all_row_values:
+                append(row_format.format(*row_values))
+            append('')
+            append('')
+
     return ''.join(result)
@@ -169,6 +169,43 @@ def load_profiler_result(filename: str):
     return core.load_profiler_result(filename)
 
 
+def sampling_summary(reset: bool = False) -> str:
+    r"""
+    Get the summary of the op latencies sampled by the always-on sampling
+    profiler in the Prometheus text format, which are the histograms of the
+    latencies of the ops with the buckets of 2^i us.
+
+    The sampling is enabled by ``FLAGS_sampling_profiler_rate``, one in the rate
+    ops of every thread is timed, and the summary is also exported to
+    ``FLAGS_sampling_profiler_export_path`` every
+    ``FLAGS_sampling_profiler_export_interval`` seconds if the path is set. The
+    full traces are still taken by :ref:`Profiler <api_paddle_profiler_Profiler>`
+    on demand.
+
+    Args:
+        reset(bool, optional): Whether to clear the histograms after the summary is taken. Default: False.
+
+    Returns:
+        str, the summary in the Prometheus text format.
+
+    Examples:
+        .. code-block:: python
+
+            >>> import paddle
+            >>> import paddle.profiler as profiler
+            >>> paddle.set_flags({'FLAGS_sampling_profiler_rate': 10})
+            >>> x = paddle.randn([4, 4])
+            >>> for i in range(100):
+            ...     y = paddle.matmul(x, x)
+            >>> summary = profiler.sampling_summary(reset=True)
+            >>> paddle.set_flags({'FLAGS_sampling_profiler_rate': 0})
+    """
+    summary = core.sampling_profiler_summary()
+    if reset:
+        core.reset_sampling_profiler()
+    return summary
+
+
 def in_profiler_mode():
     return _is_profiler_used
 
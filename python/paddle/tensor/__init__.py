@@ -398,6 +398,7 @@ from .search import (  # noqa: F401
     nonzero,
     searchsorted,
     sort,
+    top_k_top_p_sampling,
     top_p_sampling,
     topk,
     where,
@@ -630,6 +631,7 @@ tensor_method_func = [
     'argsort',
     'masked_select',
     'topk',
+    'top_k_top_p_sampling',
     'top_p_sampling',
     'where',
     'where_',
@@ -1297,3 +1297,88 @@ def top_p_sampling(x, ps, threshold=None, seed=None, name=None):
         attrs=attrs,
     )
     return out, ids
+
+
+def top_k_top_p_sampling(
+    x,
+    top_p,
+    pre_ids=None,
+    temperature=1.0,
+    top_k=0,
+    min_p=0.0,
+    repetition_penalty=1.0,
+    seed=None,
+    name=None,
+):
+    """
+    Sample a token of every row of the logits in one pass. The logits of the
+    tokens in `pre_ids` are penalized by `repetition_penalty`, and all logits
+    are divided by `temperature`. The candidates are the `top_k` tokens whose
+    probabilities are at least `min_p` times the max one, and the most
+    probable candidates whose probabilities sum up to `top_p` are kept, from
+    which a token is drawn.
+
+    Args:
+        x(Tensor): A 2-D Tensor of the logits [bsz, vocab_size] with type float32, float16 and bfloat16.
+        top_p(Tensor): A Tensor of shape [bsz, 1] with type float32, the cumulative probability threshold of every row.
+        pre_ids(Tensor, optional): A 2-D Tensor of shape [bsz, len] with type int64, the tokens penalized by `repetition_penalty`, the negative ones are ignored. Default: None.
+        temperature(float, optional): The temperature of the logits. Default: 1.0.
+        top_k(int, optional): The number of the candidates, all the tokens are candidates if it is not positive. Default: 0.
+        min_p(float, optional): The min probability of the candidates relative to the max one. Default: 0.0.
+        repetition_penalty(float, optional): The positive logits of `pre_ids` are divided by it, and the negative ones are multiplied by it. Default: 1.0.
+        seed(int, optional): The random seed, the global generator is used if it is None. Default: None.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        tuple(Tensor), return the probabilities of the sampled tokens in the kept ones and the tokens, both of shape [bsz, 1]. The probability data type is the same as the input `x`. The token data type is int64.
+
+    Examples:
+
+        .. code-block:: python
+
+            >>> import paddle
+
+            >>> paddle.seed(2023)
+            >>> x = paddle.randn([2, 8])
+            >>> top_p = paddle.full([2, 1], 0.8)
+            >>> prob, ids = paddle.tensor.top_k_top_p_sampling(x, top_p, top_k=4)
+            >>> print(ids.shape)
+            [2, 1]
+    """
+
+    if seed is None:
+        seed = -1
+
+    if in_dynamic_or_pir_mode():
+        return _C_ops.top_k_top_p_sampling(
+            x,
+            top_p,
+            pre_ids,
+            temperature,
+            top_k,
+            min_p,
+            repetition_penalty,
+            seed,
+        )
+
+    inputs = {"x": x, "top_p": top_p}
+    if pre_ids is not None:
+        inputs["pre_ids"] = pre_ids
+    attrs = {
+        "temperature": temperature,
+        "top_k": top_k,
+        "min_p": min_p,
+        "repetition_penalty": repetition_penalty,
+        "seed": seed,
+    }
+
+    helper = LayerHelper('top_k_top_p_sampling', **locals())
+    out = helper.create_variable_for_type_inference(dtype=x.dtype)
+    ids = helper.create_variable_for_type_inference(dtype="int64")
+    helper.append_op(
+        type='top_k_top_p_sampling',
+        inputs=inputs,
+        outputs={'out': out, 'ids': ids},
+        attrs=attrs,
+    )
+    return out, ids
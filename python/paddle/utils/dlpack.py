@@ -12,6 +12,8 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import enum
+
 import paddle
 
 from ..base.core import LoDTensor
@@ -24,6 +26,13 @@ __all__ = [
 ]
 
 
+class DLDeviceType(enum.IntEnum):
+    kDLCPU = 1
+    kDLGPU = 2
+    kDLCPUPinned = 3
+    kDLROCM = 10
+
+
 def to_dlpack(x):
     """
     Encodes a tensor to DLPack.
@@ -64,15 +73,18 @@ def to_dlpack(x):
 
 def from_dlpack(dlpack):
     """
-    Decodes a DLPack to a tensor.
+    Decodes a DLPack to a tensor, which shares the memory of the DLPack
+    without copying.
 
     Args:
-        dlpack (PyCapsule): a PyCapsule object with the dltensor.
+        dlpack (PyCapsule|object): a PyCapsule object with the dltensor, or an
+            object of the Python array API with `__dlpack__`, e.g. a tensor of
+            other frameworks, on which the current stream of Paddle waits for
+            the stream writing it on the device.
 
     Returns:
-        out (Tensor), a tensor decoded from DLPack. One thing to be noted, if we get
-                      an input dltensor with data type as `bool`, we return the decoded
-                      tensor as `uint8`.
+        out (Tensor), a tensor decoded from DLPack, on the device of the
+                      DLPack.
 
     Examples:
         .. code-block:: python
@@ -89,6 +101,14 @@ def from_dlpack(dlpack):
                     [0.10000000, 0.20000000, 0.60000002, 0.69999999]])
     """
 
+    if hasattr(dlpack, '__dlpack__'):
+        device_type, device_id = dlpack.__dlpack_device__()
+        if device_type in (DLDeviceType.kDLGPU, DLDeviceType.kDLROCM):
+            stream = paddle.device.cuda.current_stream(device_id)
+            dlpack = dlpack.__dlpack__(stream=stream.cuda_stream)
+        else:
+            dlpack = dlpack.__dlpack__()
+
     t = type(dlpack)
     dlpack_flag = t.__module__ == 'builtins' and t.__name__ == 'PyCapsule'
     if not dlpack_flag:
@@ -97,10 +117,8 @@ def from_dlpack(dlpack):
             f" but received {type(dlpack)}."
         )
 
-    if in_dygraph_mode():
-        out = paddle.base.core.from_dlpack(dlpack)
-        out = paddle.to_tensor(out)
-        return out
-
     out = paddle.base.core.from_dlpack(dlpack)
+    if in_dygraph_mode():
+        # shares the memory on the place of the DLPack
+        out = paddle.base.core.eager.Tensor(out, out._place())
     return out
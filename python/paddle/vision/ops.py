@@ -38,6 +38,7 @@ __all__ = [
     'generate_proposals',
     'read_file',
     'decode_jpeg',
+    'decode_jpeg_batch',
     'roi_pool',
     'RoIPool',
     'psroi_pool',
@@ -1383,6 +1384,107 @@ def decode_jpeg(x, mode='unchanged', name=None):
         return out
 
 
+def decode_jpeg_batch(
+    x,
+    offsets,
+    size,
+    boxes=None,
+    flip=None,
+    mean=None,
+    std=None,
+    mode='rgb',
+    name=None,
+):
+    """
+    Decodes a batch of JPEG images on GPU, and crops, resizes, flips and
+    normalizes them into one float32 Tensor, so that the data loader only
+    reads the bytes of the images, and the images never go through the host
+    once decoded. The images are decoded by nvJPEG on its own stream,
+    overlapping the kernels queued before, by the hardware decoder of A100
+    and later for the images it supports, and the hybrid decoder otherwise.
+
+    Args:
+        x (Tensor): A one dimensional uint8 tensor on CPU, the concatenated
+            bytes of the JPEG images.
+        offsets (Tensor): A one dimensional int64 tensor on CPU, the end of
+            the bytes of every image in x, i.e. the cumulative sum of the
+            numbers of the bytes of the images.
+        size (list|tuple): The height and width of the output images.
+        boxes (Tensor, optional): A float32 tensor on CPU with shape
+            [batch_size, 4], the crop (x0, y0, x1, y1) of every image relative
+            to its width and height, e.g. sampled for RandomResizedCrop.
+            Default: None, the whole images.
+        flip (Tensor, optional): A bool tensor on CPU with shape [batch_size],
+            whether to flip every image horizontally. Default: None.
+        mean (list|tuple, optional): The mean of every channel subtracted, in
+            [0, 255]. Default: None, no normalization.
+        std (list|tuple, optional): The standard deviation of every channel
+            divided by, in [0, 255]. Default: None, no normalization.
+        mode (str, optional): 'rgb' or 'gray'. Default: 'rgb'.
+        name (str, optional): The default value is None. Normally there is no
+            need for user to set this property. For more information, please
+            refer to :ref:`api_guide_Name`.
+    Returns:
+        Tensor: The float32 images with shape (batch_size, image_channels, size[0], size[1]).
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import cv2
+            >>> import numpy as np
+            >>> import paddle
+            >>> paddle.device.set_device('gpu')
+
+            >>> images = [
+            ...     cv2.imencode('.jpg', (np.random.random(shape) * 255).astype('uint8'))[1].reshape(-1)
+            ...     for shape in [(400, 300, 3), (256, 320, 3)]
+            ... ]
+            >>> x = paddle.to_tensor(np.concatenate(images), place=paddle.CPUPlace())
+            >>> offsets = paddle.to_tensor(
+            ...     np.cumsum([len(image) for image in images]), place=paddle.CPUPlace())
+            >>> flip = paddle.to_tensor([True, False], place=paddle.CPUPlace())
+            >>> out = paddle.vision.ops.decode_jpeg_batch(
+            ...     x, offsets, [224, 224], flip=flip,
+            ...     mean=[123.675, 116.28, 103.53], std=[58.395, 57.12, 57.375])
+            >>> print(out.shape)
+            [2, 3, 224, 224]
+    """
+    size = list(size)
+    mean = [] if mean is None else list(mean)
+    std = [] if std is None else list(std)
+    if in_dynamic_or_pir_mode():
+        return _C_ops.decode_jpeg_batch(
+            x,
+            offsets,
+            boxes,
+            flip,
+            size,
+            mean,
+            std,
+            mode,
+            _current_expected_place(),
+        )
+    else:
+        inputs = {'x': x, 'offsets': offsets}
+        if boxes is not None:
+            inputs['boxes'] = boxes
+        if flip is not None:
+            inputs['flip'] = flip
+        attrs = {'size': size, 'mean': mean, 'std': std, 'mode': mode}
+
+        helper = LayerHelper("decode_jpeg_batch", **locals())
+        out = helper.create_variable_for_type_inference('float32')
+        helper.append_op(
+            type="decode_jpeg_batch",
+            inputs=inputs,
+            attrs=attrs,
+            outputs={"out": out},
+        )
+
+        return out
+
+
 def psroi_pool(x, boxes, boxes_num, output_size, spatial_scale=1.0, name=None):
     """
     Position sensitive region of interest pooling (also known as PSROIPooling) is to perform
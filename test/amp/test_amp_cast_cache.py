@@ -0,0 +1,93 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+
+class SharedLinear(paddle.nn.Layer):
+    def __init__(self):
+        super().__init__()
+        self.linear = paddle.nn.Linear(16, 16)
+
+    def forward(self, x):
+        # the weight and bias are used three times in a step
+        for _ in range(3):
+            x = paddle.nn.functional.relu(self.linear(x))
+        return x
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or paddle.device.cuda.get_device_capability()[0] < 7.0,
+    "run test when gpu's compute capability is at least 7.0.",
+)
+class TestAmpCastCache(unittest.TestCase):
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_eager_amp_cast_cache': False})
+
+    def train(self, use_cache):
+        paddle.set_flags({'FLAGS_eager_amp_cast_cache': use_cache})
+        paddle.seed(2023)
+        model = SharedLinear()
+        optimizer = paddle.optimizer.SGD(
+            learning_rate=0.1, parameters=model.parameters()
+        )
+        x = paddle.rand([4, 16])
+        losses = []
+        for _ in range(3):
+            with paddle.amp.auto_cast(level='O1'):
+                loss = model(x).mean()
+                stats = core.eager.amp_cast_cache_stats()
+            loss.backward()
+            optimizer.step()
+            optimizer.clear_grad()
+            losses.append(loss.numpy())
+        return losses, stats
+
+    def test_reuse_casts(self):
+        core.eager.clear_amp_cast_cache()
+        before = core.eager.amp_cast_cache_stats()
+        losses, stats = self.train(use_cache=True)
+        # the weight is cast once and reused twice in a step
+        self.assertGreaterEqual(stats["size"], 1)
+        self.assertGreaterEqual(stats["hits"] - before["hits"], 3 * 2)
+        self.assertEqual(core.eager.amp_cast_cache_stats()["size"], 0)
+
+        expected, _ = self.train(use_cache=False)
+        np.testing.assert_array_equal(np.array(losses), np.array(expected))
+
+    def test_inplace_version(self):
+        paddle.set_flags({'FLAGS_eager_amp_cast_cache': True})
+        linear = paddle.nn.Linear(16, 16)
+        x = paddle.rand([4, 16])
+        with paddle.no_grad(), paddle.amp.auto_cast(level='O1'):
+            out = linear(x)
+            linear.weight.scale_(2.0)
+            # the weight is cast again after it is updated in place
+            out_scaled = linear(x)
+        np.testing.assert_allclose(
+            (out_scaled - linear.bias).numpy(),
+            (2.0 * (out - linear.bias)).numpy(),
+            rtol=1e-2,
+            atol=1e-2,
+        )
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -20,6 +20,7 @@ import numpy as np
 import paddle
 import paddle.distributed as dist
 from paddle.distributed import fleet
+from paddle.distributed.fleet.layers.mpu import mp_ops
 
 
 def set_random_seed(seed):
@@ -348,6 +349,67 @@ class TestDistTraining(unittest.TestCase):
                 rtol=1e-6,
             )
 
+    def test_parallel_linear_cross_entropy(self):
+        batch_size = 4
+        seq_length = 16
+        hidden_size = 32
+        class_size_per_card = 40
+        # smaller than class_size_per_card to run several chunks
+        chunk_size = 16
+        seed = 100
+
+        set_random_seed(seed)
+        rank_id = dist.get_rank()
+        vocab_size = class_size_per_card * self.model_parallel_size
+
+        model_a = fleet.meta_parallel.ParallelLinearCrossEntropy(
+            chunk_size=chunk_size
+        )
+        model_b = fleet.meta_parallel.ParallelCrossEntropy()
+
+        paddle.seed(rank_id * 10)
+        np.random.seed(seed)
+        for _ in range(3):
+            np_label = np.random.randint(
+                0, vocab_size, (batch_size, seq_length)
+            )
+            np_label[0, :4] = -100
+            label = paddle.to_tensor(np_label, dtype="int64")
+            np_input = np.random.randn(
+                batch_size, seq_length, hidden_size
+            ).astype("float32")
+
+            weight_a = paddle.randn([hidden_size, class_size_per_card])
+            weight_a.stop_gradient = False
+            weight_b = weight_a.detach().clone()
+            weight_b.stop_gradient = False
+            input_a = paddle.to_tensor(np_input, stop_gradient=False)
+            input_b = paddle.to_tensor(np_input, stop_gradient=False)
+
+            loss_a = model_a(input_a, weight_a, label)
+            logits_b = paddle.matmul(
+                mp_ops._c_identity(
+                    input_b, group=model_b.model_parallel_group
+                ),
+                weight_b,
+            )
+            loss_b = model_b(logits_b, label)
+            np.testing.assert_allclose(
+                loss_a.numpy(), loss_b.numpy(), rtol=1e-5, atol=1e-5
+            )
+
+            (loss_a.sum() / batch_size).backward()
+            (loss_b.sum() / batch_size).backward()
+            np.testing.assert_allclose(
+                input_a.grad.numpy(), input_b.grad.numpy(), rtol=1e-5, atol=1e-5
+            )
+            np.testing.assert_allclose(
+                weight_a.grad.numpy(),
+                weight_b.grad.numpy(),
+                rtol=1e-5,
+                atol=1e-5,
+            )
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -72,6 +72,7 @@ class SimpleSPNet(paddle.nn.Layer):
         np_fc1,
         np_fc2,
         mp_id,
+        overlap_matmul_comm=False,
     ):
         super().__init__()
 
@@ -96,6 +97,7 @@ class SimpleSPNet(paddle.nn.Layer):
             ),
             gather_output=False,
             has_bias=True,
+            overlap_matmul_comm=overlap_matmul_comm,
         )
 
         self.linear2 = spu.RowSequenceParallelLinear(
@@ -106,6 +108,7 @@ class SimpleSPNet(paddle.nn.Layer):
             ),
             input_is_parallel=True,
             has_bias=True,
+            overlap_matmul_comm=overlap_matmul_comm,
         )
 
         self.linear3 = paddle.nn.Linear(
@@ -391,6 +394,8 @@ class TestDistSPSyncModelTraining(TestDistSPSyncTraining):
 
 
 class TestDistSPTraining(unittest.TestCase):
+    overlap_matmul_comm = False
+
     def setUp(self):
         strategy = fleet.DistributedStrategy()
         self.model_parallel_size = 2
@@ -435,6 +440,7 @@ class TestDistSPTraining(unittest.TestCase):
             np_fc1,
             np_fc2,
             mp_id,
+            self.overlap_matmul_comm,
         )
         optimizer_a = self.build_optimizer(model_a)
         model_a = fleet.distributed_model(model_a)
@@ -473,5 +479,10 @@ class TestDistSPTraining(unittest.TestCase):
             )
 
 
+
+class TestDistSPOverlapTraining(TestDistSPTraining):
+    overlap_matmul_comm = True
+
+
 if __name__ == "__main__":
     unittest.main()
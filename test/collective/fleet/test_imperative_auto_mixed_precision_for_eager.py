@@ -355,6 +355,50 @@ class TestAmpScaler(unittest.TestCase):
             return
         self.nan_inf()
 
+    def nan_inf_on_device(self):
+        inp_np = np.random.random(size=[1, 3, 128, 128]).astype(np.float32)
+        inp_np[0][1][2][3] = np.nan
+        with base.dygraph.guard():
+            model = SimpleConv(
+                num_channels=3,
+                num_filters=64,
+                filter_size=7,
+                stride=2,
+                act='relu',
+            )
+            params_init = {}
+            for param in model.parameters():
+                params_init[param.name] = param.numpy()
+            # adam skips the update by the found_inf on the device
+            optimizer = paddle.optimizer.Adam(
+                learning_rate=0.01, parameters=model.parameters()
+            )
+            scaler = paddle.amp.GradScaler(
+                init_loss_scaling=1024, decr_every_n_nan_or_inf=1
+            )
+            data = base.dygraph.to_variable(inp_np)
+            with paddle.amp.auto_cast(dtype='float16'):
+                out = model(data)
+                loss = paddle.mean(out)
+            scaled_loss = scaler.scale(loss)
+            scaled_loss.backward()
+            scaler.step(optimizer)
+            scaler.update()
+            self.assertEqual(scaler._found_inf.numpy() >= 1, True)
+            np.testing.assert_array_equal(scaler._scale.numpy(), [512.0])
+            self.assertEqual(scaler.state_dict()["decr_count"], 0)
+
+            for param in model.parameters():
+                # param not update when tensor contains nan or inf
+                np.testing.assert_array_equal(
+                    param.numpy(), params_init[param.name]
+                )
+
+    def test_nan_inf_on_device(self):
+        if not paddle.amp.is_float16_supported():
+            return
+        self.nan_inf_on_device()
+
     def step_update_exception(self):
         def func1():
             model = paddle.nn.Conv2D(3, 2, 3, bias_attr=True)
@@ -29,6 +29,15 @@ class TestTCPStore(unittest.TestCase):
         ret2 = store.get('my')
         self.assertEqual(ret1[0] + 3, ret2[0])
 
+        keys = [f"multi/{i}" for i in range(2000)]
+        store.multi_set(keys, [str(i) for i in range(2000)])
+        values = store.multi_get(keys)
+        self.assertEqual(values, [str(i).encode() for i in range(2000)])
+        store.set("single", "value")
+        self.assertEqual(
+            store.multi_get(["single", "multi/7"]), [b"value", b"7"]
+        )
+
 
 if __name__ == "__main__":
     unittest.main()
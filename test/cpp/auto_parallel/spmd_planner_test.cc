@@ -0,0 +1,141 @@
+/* Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/core/distributed/auto_parallel/spmd_planner.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/infermeta/spmd_rules/matmul.h"
+
+namespace phi {
+namespace distributed {
+
+static ProcessMesh MakeMesh() {
+  return ProcessMesh({4}, {0, 1, 2, 3}, {"x"});
+}
+
+static TensorDistAttr MakeDistAttr(const std::vector<int64_t>& dims_mapping) {
+  TensorDistAttr dist_attr(std::vector<int64_t>(dims_mapping.size(), 1));
+  dist_attr.set_process_mesh(MakeMesh());
+  dist_attr.set_dims_mapping(dims_mapping);
+  return dist_attr;
+}
+
+static SpmdPlanner::InferFn MatmulFn() {
+  return [](const std::vector<DistMetaTensor>& inputs) {
+    return MatmulInferSpmd(inputs[0], inputs[1], false, false);
+  };
+}
+
+TEST(SpmdCostModel, ReshardCost) {
+  SpmdCostModel cost_model(MakeMesh(), {1e9}, {0.0}, 1e12);
+  std::vector<int64_t> shape = {64, 32};
+
+  auto replicated = MakeDistAttr({-1, -1});
+  auto partial = MakeDistAttr({-1, -1});
+  partial.set_partial_status(std::vector<int64_t>{0});
+  auto shard = MakeDistAttr({0, -1});
+  auto shard_col = MakeDistAttr({-1, 0});
+
+  // all_reduce 8192 bytes: 2 * 3 * 2048 bytes / 1e9 B/s
+  EXPECT_NEAR(cost_model.ReshardCost(shape, 4, partial, replicated),
+              12.288,
+              1e-6);
+  // reduce_scatter: 3 * 2048 bytes
+  EXPECT_NEAR(cost_model.ReshardCost(shape, 4, partial, shard), 6.144, 1e-6);
+  // all_gather the local 2048 bytes: 3 * 2048 bytes
+  EXPECT_NEAR(
+      cost_model.ReshardCost(shape, 4, shard, replicated), 6.144, 1e-6);
+  // all_to_all: 3 * 512 bytes
+  EXPECT_NEAR(cost_model.ReshardCost(shape, 4, shard, shard_col), 1.536, 1e-6);
+  // slicing the replicated tensor is local
+  EXPECT_EQ(cost_model.ReshardCost(shape, 4, replicated, shard), 0.0);
+  EXPECT_EQ(cost_model.ReshardCost(shape, 4, shard, shard), 0.0);
+
+  EXPECT_NEAR(cost_model.ComputeCost(1e6, {replicated}), 1.0, 1e-9);
+  EXPECT_NEAR(cost_model.ComputeCost(1e6, {shard}), 0.25, 1e-9);
+  EXPECT_NEAR(cost_model.ComputeCost(1e6, {partial}), 0.25, 1e-9);
+}
+
+TEST(SpmdPlanner, AvoidReshard) {
+  SpmdCostModel cost_model(MakeMesh(), {1e9}, {10.0}, 1e12);
+  SpmdPlanner planner(cost_model);
+
+  // x is sharded on k, w is placed freely
+  SpmdPlanner::Input x;
+  x.shape = {64, 32};
+  x.dist_attr = MakeDistAttr({-1, 0});
+  SpmdPlanner::Input w;
+  w.shape = {32, 128};
+  int64_t matmul = planner.AddNode(
+      "matmul", {x, w}, {{64, 128}}, 2.0 * 64 * 32 * 128, MatmulFn());
+  EXPECT_GT(planner.Candidates(matmul).size(), 1UL);
+
+  double cost = planner.Plan();
+  const auto& chosen = planner.Chosen(matmul);
+  // mk[-1, 0], kn[0, -1] = mn[-1, -1] partial[0] needs no reshard
+  EXPECT_EQ(chosen.inputs[0].dims_mapping(), std::vector<int64_t>({-1, 0}));
+  EXPECT_EQ(chosen.inputs[1].dims_mapping(), std::vector<int64_t>({0, -1}));
+  EXPECT_TRUE(chosen.outputs[0].is_partial(0));
+  EXPECT_NEAR(cost, chosen.compute_cost, 1e-9);
+}
+
+TEST(SpmdPlanner, ChainAndCalibrate) {
+  SpmdCostModel cost_model(MakeMesh(), {1e9}, {10.0}, 1e12);
+  SpmdPlanner planner(cost_model);
+
+  SpmdPlanner::Input x;
+  x.shape = {64, 32};
+  x.dist_attr = MakeDistAttr({-1, -1});
+  SpmdPlanner::Input w1;
+  w1.shape = {32, 128};
+  SpmdPlanner::Input w2;
+  w2.shape = {128, 32};
+  double flops = 2.0 * 64 * 32 * 128;
+  int64_t matmul1 =
+      planner.AddNode("matmul1", {x, w1}, {{64, 128}}, flops, MatmulFn());
+  SpmdPlanner::Input h;
+  h.producer = matmul1;
+  h.shape = {64, 128};
+  int64_t matmul2 =
+      planner.AddNode("matmul2", {h, w2}, {{64, 32}}, flops, MatmulFn());
+
+  double cost = planner.Plan();
+  // both matmuls are split on the 4 devices without any communication
+  double compute = planner.Chosen(matmul1).compute_cost +
+                   planner.Chosen(matmul2).compute_cost;
+  EXPECT_NEAR(compute, 2 * flops / 4 / 1e12 * 1e6, 1e-9);
+  EXPECT_NEAR(cost, compute, 1e-9);
+  const auto& out1 = planner.Chosen(matmul1).outputs[0];
+  const auto& in2 = planner.Chosen(matmul2).inputs[0];
+  EXPECT_EQ(out1.dims_mapping(), in2.dims_mapping());
+  EXPECT_EQ(out1.partial_status(), in2.partial_status());
+
+  // the measured time is twice the predicted one
+  double cost1 = planner.Chosen(matmul1).compute_cost;
+  double cost2 = planner.Chosen(matmul2).compute_cost;
+  planner.SetMeasuredTime(matmul1, 2 * cost1);
+  planner.SetMeasuredTime(matmul2, 2 * cost2);
+  EXPECT_NEAR(planner.Plan(), 2 * cost, 1e-9);
+
+  std::string explain = planner.Explain();
+  EXPECT_NE(explain.find("node 1 matmul2"), std::string::npos);
+  EXPECT_NE(explain.find("measured"), std::string::npos);
+  EXPECT_NE(explain.find("cost model scale 2"), std::string::npos);
+}
+
+}  // namespace distributed
+}  // namespace phi
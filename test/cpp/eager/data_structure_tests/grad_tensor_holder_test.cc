@@ -26,6 +26,7 @@
 
 PD_DECLARE_KERNEL(full_like, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(add_n, CPU, ALL_LAYOUT);
 
 // TODO(jiabin): remove nolint here!!!
 using namespace egr;  // NOLINT
@@ -106,6 +107,37 @@ TEST(GradTensorHolder, Interfaces) {
   CHECK_EQ(holder_et1_ptr[0], 30.0f);
 }
 
+TEST(GradTensorHolder, DeferredAdd) {
+  phi::DenseTensorMeta meta =
+      phi::DenseTensorMeta(phi::DataType::FLOAT32, common::make_ddim({2, 2}));
+  std::vector<GradSlotMeta> slot_meta(1);
+  GradTensorHolder grad_tensor_holder = GradTensorHolder({slot_meta});
+
+  // more grads than the deferred at most
+  float expected = 0.0f;
+  for (int i = 1; i <= 10; ++i) {
+    std::shared_ptr<phi::DenseTensor> dt = std::make_shared<phi::DenseTensor>(
+        std::make_unique<paddle::experimental::DefaultAllocator>(
+            paddle::platform::CPUPlace())
+            .get(),
+        meta);
+    auto* data = dt->mutable_data<float>(paddle::platform::CPUPlace());
+    for (int j = 0; j < 4; ++j) {
+      data[j] = static_cast<float>(i * j);
+    }
+    expected += static_cast<float>(i);
+    grad_tensor_holder.add(0, 0, paddle::Tensor(dt));
+  }
+
+  const auto& holder_et = grad_tensor_holder[0][0];
+  auto* holder_et_ptr =
+      std::dynamic_pointer_cast<phi::DenseTensor>(holder_et.impl())
+          ->data<float>();
+  for (int j = 0; j < 4; ++j) {
+    EXPECT_EQ(holder_et_ptr[j], expected * j);
+  }
+}
+
 TEST(GradTensorHolder, SelectedRowsMergeAdd) {
   phi::CPUPlace cpu;
 
@@ -125,6 +125,52 @@ TEST(Benchmark, EagerMatmulCPU) {
   }
 }
 
+TEST(Benchmark, EagerNoGradMatmulCPU) {
+  // Prepare Device Contexts
+  eager_test::InitEnv(paddle::platform::CPUPlace());
+
+  for (const std::string mode : {"Accuracy", "Performance"}) {
+    paddle::framework::DDim ddimX = common::make_ddim({2, 2});
+    paddle::Tensor X =
+        eager_test::CreateTensorWithValue(ddimX,
+                                          paddle::platform::CPUPlace(),
+                                          phi::DataType::FLOAT32,
+                                          phi::DataLayout::NCHW,
+                                          1.0,
+                                          true);
+
+    paddle::framework::DDim ddimY = common::make_ddim({2, 2});
+    paddle::Tensor Y =
+        eager_test::CreateTensorWithValue(ddimY,
+                                          paddle::platform::CPUPlace(),
+                                          phi::DataType::FLOAT32,
+                                          phi::DataLayout::NCHW,
+                                          2.0,
+                                          true);
+
+    if (mode == "Accuracy") {
+      benchmark_eager_matmul_forward(X, Y, true, true /* accuracy_check */);
+      benchmark_eager_matmul_forward(X, Y, false, true /* accuracy_check */);
+
+    } else if (mode == "Performance") {
+      // the per op dispatch overhead with and without the autograd
+      for (bool has_grad : {true, false}) {
+        auto t_start = std::chrono::high_resolution_clock::now();
+        size_t num_ops = benchmark_eager_matmul_forward(X, Y, has_grad);
+        auto t_end = std::chrono::high_resolution_clock::now();
+        double elapsed_time_us =
+            std::chrono::duration<double, std::micro>(t_end - t_start).count();
+        std::cout << (has_grad ? "Grad" : "No grad")
+                  << " duration: " << elapsed_time_us / 1000 << " ms, per op: "
+                  << elapsed_time_us / num_ops << " us" << std::endl;
+      }
+
+    } else {
+      PADDLE_THROW(paddle::platform::errors::Fatal("Unknown benchmark mode"));
+    }
+  }
+}
+
 TEST(Benchmark, EagerIntermediateMatmulCPU) {
   // Prepare Device Contexts
   eager_test::InitEnv(paddle::platform::CPUPlace());
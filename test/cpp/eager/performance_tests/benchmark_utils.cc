@@ -91,6 +91,37 @@ void benchmark_eager_matmul(const paddle::Tensor& X,
   }
 }
 
+size_t benchmark_eager_matmul_forward(const paddle::Tensor& X,
+                                      const paddle::Tensor& Y,
+                                      bool has_grad,
+                                      bool accuracy_check) {
+  paddle::Tensor input_tensor0 = X;
+  bool original_has_grad = egr::Controller::Instance().HasGrad();
+  egr::Controller::Instance().SetHasGrad(has_grad);
+
+  size_t max_num_runs = accuracy_check ? 2 : max_num_benchmark_runs;
+  for (size_t i = 0; i < max_num_runs; i++) {
+    input_tensor0 = matmul_ad_func(input_tensor0, Y, false, false);
+  }
+  egr::Controller::Instance().SetHasGrad(original_has_grad);
+
+  if (accuracy_check) {
+    // Examine Forward Output (w.r.t max_num_runs = 2)
+    eager_test::CompareTensorWithValue<float>(input_tensor0, 16);
+    // The no grad outputs carry no autograd meta at all
+    auto* meta = egr::EagerUtils::nullable_autograd_meta(input_tensor0);
+    PADDLE_ENFORCE_EQ(
+        has_grad ? meta != nullptr && meta->GetMutableGradNode() != nullptr
+                 : meta == nullptr,
+        true,
+        paddle::platform::errors::Fatal(
+            "The autograd meta of the output of matmul doesn't match the "
+            "grad mode, whose has_grad is %d.",
+            has_grad));
+  }
+  return max_num_runs;
+}
+
 /* ----------------------------------- */
 /* ---- Eager Intermediate Matmul ---- */
 /* ----------------------------------- */
@@ -56,6 +56,13 @@ void benchmark_eager_matmul(const paddle::Tensor& X,
                             const paddle::Tensor& Y,
                             bool accuracy_check = false);
 
+// Runs the matmul forward only, with the grad enabled or not, and returns
+// the number of the ops run
+size_t benchmark_eager_matmul_forward(const paddle::Tensor& X,
+                                      const paddle::Tensor& Y,
+                                      bool has_grad,
+                                      bool accuracy_check = false);
+
 void benchmark_eager_intermediate_matmul(const paddle::Tensor& X,
                                          const paddle::Tensor& Y,
                                          bool accuracy_check = false);
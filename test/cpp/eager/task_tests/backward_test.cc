@@ -24,6 +24,7 @@
 #include "paddle/fluid/eager/autograd_meta.h"
 #include "paddle/fluid/eager/grad_node_info.h"
 #include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/flags.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_meta.h"
 #include "test/cpp/eager/test_utils.h"
@@ -31,6 +32,8 @@
 PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
 
+PHI_DECLARE_int32(eager_backward_num_threads);
+
 namespace egr {
 
 TEST(Backward, SingleNodeEmptyGrad) {
@@ -232,7 +235,9 @@ Node0   Node1
   |      |
  inp0   inp1
 */
-TEST(Backward, WithAccumulation) {
+// node0 and node1 are run concurrently in the parallel backward, then the
+// grads of them are accumulated into the input of node2
+void RunBackwardWithAccumulation() {
   // Prepare Device Contexts
   eager_test::InitEnv(paddle::platform::CPUPlace());
 
@@ -342,4 +347,12 @@ TEST(Backward, WithAccumulation) {
   eager_test::CompareGradTensorWithValue<float>(leaf_tensor, 2500.0);
 }
 
+TEST(Backward, WithAccumulation) { RunBackwardWithAccumulation(); }
+
+TEST(Backward, WithAccumulationInParallel) {
+  FLAGS_eager_backward_num_threads = 4;
+  RunBackwardWithAccumulation();
+  FLAGS_eager_backward_num_threads = 0;
+}
+
 }  // namespace egr
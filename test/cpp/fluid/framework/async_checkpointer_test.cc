@@ -0,0 +1,74 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/async_checkpointer.h"
+
+#include <cstdio>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/lod_tensor.h"
+
+namespace paddle {
+namespace framework {
+
+TEST(AsyncCheckpointer, save_and_load) {
+  platform::CPUPlace place;
+  phi::DenseTensor weight, bias;
+  weight.Resize({4, 8});
+  float* weight_data = weight.mutable_data<float>(place);
+  bias.Resize({7});
+  bias.set_lod({{0, 3, 7}});
+  int64_t* bias_data = bias.mutable_data<int64_t>(place);
+
+  AsyncCheckpointer checkpointer;
+  std::vector<std::string> paths;
+  // more snapshots than the slots, and every one of them holds the values
+  // at the step it is taken
+  for (int step = 0; step < 4; ++step) {
+    for (int64_t i = 0; i < weight.numel(); ++i) {
+      weight_data[i] = static_cast<float>(step * 100 + i);
+    }
+    for (int i = 0; i < 7; ++i) {
+      bias_data[i] = step * 10 + i;
+    }
+    paths.push_back("async_checkpointer_test_" + std::to_string(step) +
+                    ".pdckpt");
+    checkpointer.Save(paths.back(), {"weight", "bias"}, {&weight, &bias});
+  }
+  checkpointer.Wait();
+
+  for (int step = 0; step < 4; ++step) {
+    std::vector<std::string> names;
+    std::vector<phi::DenseTensor> tensors;
+    AsyncCheckpointer::Load(paths[step], &names, &tensors);
+    ASSERT_EQ(names.size(), 2UL);
+    EXPECT_EQ(names[0], "weight");
+    EXPECT_EQ(names[1], "bias");
+    ASSERT_EQ(tensors.size(), 2UL);
+    EXPECT_EQ(tensors[0].dims(), weight.dims());
+    for (int64_t i = 0; i < weight.numel(); ++i) {
+      EXPECT_EQ(tensors[0].data<float>()[i],
+                static_cast<float>(step * 100 + i));
+    }
+    EXPECT_EQ(tensors[1].lod(), bias.lod());
+    for (int i = 0; i < 7; ++i) {
+      EXPECT_EQ(tensors[1].data<int64_t>()[i], step * 10 + i);
+    }
+    std::remove(paths[step].c_str());
+    std::remove((paths[step] + ".names").c_str());
+  }
+}
+
+}  // namespace framework
+}  // namespace paddle
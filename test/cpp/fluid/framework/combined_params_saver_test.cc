@@ -0,0 +1,71 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/combined_params_saver.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/combined_params_loader.h"
+#include "paddle/fluid/framework/lod_tensor.h"
+
+namespace paddle {
+namespace framework {
+
+TEST(CombinedParamsSaver, save_in_parallel) {
+  std::string path = "combined_params_saver_test.pdiparams";
+  platform::CPUPlace place;
+  if (!CanSaveCombinedParamsInParallel(place)) {
+    return;
+  }
+  // larger than a chunk, so that it is written by several threads
+  phi::DenseTensor weight, bias;
+  weight.Resize({5, 1 << 20});
+  float* weight_data = weight.mutable_data<float>(place);
+  for (int64_t i = 0; i < weight.numel(); ++i) {
+    weight_data[i] = static_cast<float>(i % 1000);
+  }
+  bias.Resize({7});
+  bias.set_lod({{0, 3, 7}});
+  int64_t* bias_data = bias.mutable_data<int64_t>(place);
+  for (int i = 0; i < 7; ++i) {
+    bias_data[i] = i * 10;
+  }
+  SaveCombinedParams(path, {&weight, &bias}, place, 4);
+
+  // the same as the file serialized one tensor after another
+  std::ostringstream expected;
+  SerializeToStream(expected, weight);
+  SerializeToStream(expected, bias);
+  {
+    std::ifstream fin(path, std::ios::binary);
+    std::stringstream saved;
+    saved << fin.rdbuf();
+    EXPECT_TRUE(saved.str() == expected.str());
+  }
+
+  phi::DenseTensor weight1, bias1;
+  LoadCombinedParams(path, {&weight1, &bias1}, place, 4);
+  EXPECT_EQ(weight1.dims(), weight.dims());
+  EXPECT_EQ(bias1.lod(), bias.lod());
+  for (int i = 0; i < 7; ++i) {
+    EXPECT_EQ(bias1.data<int64_t>()[i], bias_data[i]);
+  }
+  std::remove(path.c_str());
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -26,6 +26,11 @@ namespace framework {
 namespace {  // NOLINT
 template <typename T>
 constexpr uint8_t GetDLDataTypeCode() {
+  // kDLBool of the later versions of DLPack
+  if (std::is_same<T, bool>::value) {
+    return 6;
+  }
+
   if (std::is_same<T, platform::complex<float>>::value ||
       std::is_same<T, platform::complex<double>>::value) {
     return static_cast<uint8_t>(kDLComplex);
@@ -106,6 +111,24 @@ void TestToDLManagedTensor(const platform::Place &place, uint16_t lanes) {
   dl_managed_tensor->deleter(dl_managed_tensor);
 }
 
+template <typename T>
+void TestFromDLPack(const platform::Place &place) {
+  DDim dims{6, 7};
+  phi::DenseTensor tensor;
+  tensor.Resize(dims);
+  void *p = tensor.mutable_data<T>(place);
+
+  // the tensor shares the memory held by the capsule
+  phi::DenseTensor shared = FromDLPack(toDLPack(tensor));
+  CHECK_EQ(p, shared.data());
+  CHECK_EQ(dims, shared.dims());
+  CHECK_EQ(tensor.dtype(), shared.dtype());
+  CHECK_EQ(tensor.place(), shared.place());
+  CHECK_EQ(tensor.Holder().use_count(), 2);
+  shared = phi::DenseTensor();
+  CHECK_EQ(tensor.Holder().use_count(), 1);
+}
+
 template <typename T>
 void TestMainLoop() {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -124,6 +147,7 @@ void TestMainLoop() {
       TestMain<T>(p, l);
       TestToDLManagedTensor<T>(p, l);
     }
+    TestFromDLPack<T>(p);
   }
 }
 TEST(dlpack, test_all) {
@@ -132,5 +156,33 @@ TEST(dlpack, test_all) {
   _ForEachDataType_(TestCallback);
 }
 
+TEST(dlpack, from_dlpack_with_offset_and_strides) {
+  std::vector<float> data(13);
+  int64_t shape[2] = {3, 4};
+  int64_t strides[2] = {4, 1};
+  static bool deleted = false;
+  auto *src = new ::DLManagedTensor;
+  src->dl_tensor.data = data.data();
+  src->dl_tensor.device = {kDLCPU, 0};
+  src->dl_tensor.ndim = 2;
+  src->dl_tensor.dtype = {kDLFloat, 32, 1};
+  src->dl_tensor.shape = shape;
+  src->dl_tensor.strides = strides;
+  src->dl_tensor.byte_offset = sizeof(float);
+  src->manager_ctx = nullptr;
+  src->deleter = [](::DLManagedTensor *self) {
+    deleted = true;
+    delete self;
+  };
+  {
+    phi::DenseTensor tensor = FromDLPack(src);
+    CHECK_EQ(static_cast<void *>(data.data() + 1), tensor.data());
+    CHECK_EQ(phi::make_ddim({3, 4}), tensor.dims());
+    CHECK_EQ(phi::DataType::FLOAT32, tensor.dtype());
+    CHECK_EQ(deleted, false);
+  }
+  CHECK_EQ(deleted, true);
+}
+
 }  // namespace framework
 }  // namespace paddle
@@ -0,0 +1,71 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _WIN32
+
+#include "paddle/fluid/framework/mmap_params.h"
+
+#include <cstdint>
+#include <cstdio>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/platform/place.h"
+
+namespace paddle {
+namespace framework {
+
+TEST(MmapParams, save_and_load) {
+  std::string path = "mmap_params_test.pdiparams";
+  platform::CPUPlace place;
+  phi::DenseTensor weight, bias;
+  weight.Resize({3, 5});
+  float* weight_data = weight.mutable_data<float>(place);
+  for (int i = 0; i < 15; ++i) {
+    weight_data[i] = static_cast<float>(i);
+  }
+  bias.Resize({7});
+  int64_t* bias_data = bias.mutable_data<int64_t>(place);
+  for (int i = 0; i < 7; ++i) {
+    bias_data[i] = i * 10;
+  }
+  SaveMmapParams(path, {"bias", "weight"}, {&bias, &weight});
+  EXPECT_TRUE(IsMmapParamsFile(path));
+
+  phi::DenseTensor weight1, weight2, bias1;
+  LoadMmapParams(path, {"weight", "bias"}, {&weight1, &bias1});
+  LoadMmapParams(path, {"weight"}, {&weight2});
+  EXPECT_EQ(weight1.dims(), weight.dims());
+  EXPECT_EQ(bias1.dtype(), phi::DataType::INT64);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(weight1.data()) %
+                kMmapParamsAlignment,
+            0UL);
+  for (int i = 0; i < 15; ++i) {
+    EXPECT_EQ(weight1.data<float>()[i], weight_data[i]);
+  }
+  for (int i = 0; i < 7; ++i) {
+    EXPECT_EQ(bias1.data<int64_t>()[i], bias_data[i]);
+  }
+  // Every load maps the file copy-on-write, a write is not seen by others.
+  weight1.data<float>()[0] = 100;
+  EXPECT_EQ(weight2.data<float>()[0], 0);
+
+  phi::DenseTensor missing;
+  EXPECT_ANY_THROW(LoadMmapParams(path, {"missing"}, {&missing}));
+  std::remove(path.c_str());
+}
+
+}  // namespace framework
+}  // namespace paddle
+
+#endif
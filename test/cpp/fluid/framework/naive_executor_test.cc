@@ -20,6 +20,9 @@
 
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/program_desc.h"
+#include "paddle/phi/core/flags.h"
+
+PHI_DECLARE_bool(naive_executor_prepared_run);
 
 namespace paddle {
 namespace framework {
@@ -67,6 +70,51 @@ TEST(NaiveExecutor, Basic) {
   }
 }
 
+TEST(NaiveExecutor, PreparedRun) {
+  FLAGS_naive_executor_prepared_run = true;
+  ProgramDesc program;
+  auto* main_block = program.MutableBlock(0);
+  for (auto name : {"a", "b", "c"}) {
+    main_block->Var(name)->SetType(proto::VarType::LOD_TENSOR);
+  }
+  auto* add = main_block->AppendOp();
+  add->SetType("elementwise_add");
+  add->SetInput("X", {"a"});
+  add->SetInput("Y", {"b"});
+  add->SetOutput("Out", {"c"});
+
+  auto place = platform::CPUPlace();
+  Scope scope;
+  for (auto name : {"a", "b", "c"}) {
+    scope.Var(name)->GetMutable<phi::DenseTensor>();
+  }
+  NaiveExecutor exe(place);
+  exe.Prepare(&scope, program, 0);
+  auto* a_tensor = exe.FindTensor("a");
+  auto* b_tensor = exe.FindTensor("b");
+  auto* c_tensor = exe.FindTensor("c");
+
+  // the first run caches the kernel context, the next ones run prepared, and
+  // the last one infers the shape of the new dims
+  for (int numel : {4, 4, 8}) {
+    a_tensor->Resize({1, numel});
+    b_tensor->Resize({1, numel});
+    float* a_data = a_tensor->mutable_data<float>(place);
+    float* b_data = b_tensor->mutable_data<float>(place);
+    for (int i = 0; i < numel; i++) {
+      a_data[i] = static_cast<float>(i);
+      b_data[i] = 0.1f * static_cast<float>(i);
+    }
+    exe.Run();
+    ASSERT_EQ(c_tensor->numel(), numel);
+    const float* c_data = c_tensor->data<float>();
+    for (int i = 0; i < numel; i++) {
+      EXPECT_NEAR(c_data[i], 1.1 * i, 1e-3);
+    }
+  }
+  FLAGS_naive_executor_prepared_run = false;
+}
+
 }  // namespace framework
 }  // namespace paddle
 
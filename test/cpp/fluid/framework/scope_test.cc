@@ -77,3 +77,35 @@ TEST(Scope, GetAllNames) {
 
   EXPECT_STREQ("a", str.c_str());
 }
+
+TEST(VariableSlots, Resolve) {
+  Scope s;
+  Scope& ss = s.NewScope();
+  Variable* a = s.Var("a");
+
+  VariableSlots slots;
+  slots.Reset(&ss);
+  int slot_a = slots.AddSlot("a");
+  int slot_b = slots.AddSlot("b");
+  EXPECT_EQ(slot_a, slots.AddSlot("a"));
+  EXPECT_FALSE(slots.IsValid());
+
+  slots.Resolve();
+  EXPECT_TRUE(slots.IsValid());
+  EXPECT_EQ(a, slots.Get(slot_a));
+  EXPECT_EQ(nullptr, slots.Get(slot_b));
+
+  // the variable created later is looked up in the scope
+  Variable* b = ss.Var("b");
+  EXPECT_FALSE(slots.IsValid());
+  EXPECT_EQ(b, slots.Get(slot_b));
+
+  // a shadows the one in the parent scope
+  Variable* local_a = ss.Var("a");
+  slots.Resolve();
+  EXPECT_TRUE(slots.IsValid());
+  EXPECT_EQ(local_a, slots.Get(slot_a));
+
+  s.EraseVars({"a"});
+  EXPECT_FALSE(slots.IsValid());
+}
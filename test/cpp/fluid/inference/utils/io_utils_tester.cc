@@ -152,3 +152,38 @@ TEST(shape_info_io, read_and_write) {
                                                             &opt_value);
                , paddle::platform::EnforceNotMet);
 }
+
+TEST(infer_io_utils, int8_scale_table) {
+  const std::string path = "test_int8_scale_table";
+  std::map<std::string, float> thresholds{{"conv2d_0.tmp_0", 3.25f},
+                                          {"relu_0.tmp_0", 0.1f}};
+  paddle::inference::SerializeInt8ScaleTable(path, thresholds);
+  std::map<std::string, float> loaded;
+  paddle::inference::DeserializeInt8ScaleTable(path, &loaded);
+  ASSERT_EQ(loaded, thresholds);
+
+  ASSERT_THROW(
+      paddle::inference::DeserializeInt8ScaleTable("no_exists_file", &loaded),
+      paddle::platform::EnforceNotMet);
+}
+
+TEST(infer_io_utils, ipc_params) {
+  const std::string path = "test_ipc_params";
+  paddle::inference::IpcParamInfo info;
+  info.handle = std::string("\x00\x7f\x80\xff ipc", 8);
+  info.device_id = 1;
+  info.offset = 512;
+  info.size = 24;
+  info.dtype = 10;
+  info.dims = {2, 3};
+  std::map<std::string, paddle::inference::IpcParamInfo> params{
+      {"conv2d_0.w_0", info}};
+  paddle::inference::SerializeIpcParams(path, params);
+  std::map<std::string, paddle::inference::IpcParamInfo> loaded;
+  paddle::inference::DeserializeIpcParams(path, &loaded);
+  ASSERT_EQ(loaded, params);
+
+  ASSERT_THROW(
+      paddle::inference::DeserializeIpcParams("no_exists_file", &loaded),
+      paddle::platform::EnforceNotMet);
+}
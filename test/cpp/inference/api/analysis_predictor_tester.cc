@@ -20,6 +20,8 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <fstream>
 #include <thread>  // NOLINT
 
 #include "paddle/fluid/framework/ir/pass.h"
@@ -141,6 +143,37 @@ TEST(AnalysisPredictor, save_optimized_model_on) {
 }
 #endif
 
+TEST(AnalysisPredictor, load_optimized_model) {
+  std::string cache_dir = "./optimized_model_cache";
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname);
+  config.SwitchIrOptim(true);
+  config.EnableSaveOptimModel(true);
+  config.SetOptimCacheDir(cache_dir);
+  auto predictor = CreatePaddlePredictor<AnalysisConfig>(config);
+  std::ifstream fingerprint(cache_dir + "/_optimized.fingerprint");
+  ASSERT_TRUE(fingerprint.good());
+
+  AnalysisConfig load_config;
+  load_config.SetModel(FLAGS_dirname);
+  load_config.SwitchIrOptim(true);
+  load_config.EnableLoadOptimModel(true);
+  load_config.SetOptimCacheDir(cache_dir);
+  auto load_predictor = CreatePaddlePredictor<AnalysisConfig>(load_config);
+
+  int64_t data[4] = {1, 2, 3, 4};
+  PaddleTensor tensor;
+  tensor.shape = std::vector<int>({4, 1});
+  tensor.data.Reset(data, sizeof(data));
+  tensor.dtype = PaddleDType::INT64;
+  std::vector<PaddleTensor> inputs(4, tensor);
+  std::vector<PaddleTensor> outputs, load_outputs;
+  ASSERT_TRUE(predictor->Run(inputs, &outputs));
+  ASSERT_TRUE(load_predictor->Run(inputs, &load_outputs));
+  ASSERT_EQ(load_outputs.size(), 1UL);
+  inference::CompareTensor(outputs.front(), load_outputs.front());
+}
+
 TEST(AnalysisPredictor, ZeroCopy) {
   AnalysisConfig config;
   config.SetModel(FLAGS_dirname);
@@ -220,6 +253,56 @@ TEST(AnalysisPredictor, CollectShapeRangeInfo) {
   // ASSERT_EQ(min_shape.size(), 14u);
 }
 
+TEST(AnalysisPredictor, CollectInt8Calibration) {
+  const std::string table_path = FLAGS_dirname + "/int8_scale_table.txt";
+  AnalysisConfig config;
+  config.SetModel(FLAGS_dirname);
+  config.CollectInt8Calibration(table_path, "percentile", 99.9f);
+  ASSERT_TRUE(config.int8_calibration_collected());
+  {
+    auto predictor = CreatePaddlePredictor<AnalysisConfig>(config);
+    std::vector<int64_t> input_data{0, 1, 2, 3};
+    for (int i = 0; i < 3; ++i) {
+      for (const auto& name : {"firstw", "secondw", "thirdw", "forthw"}) {
+        auto input = predictor->GetInputTensor(name);
+        input->Reshape({4, 1});
+        input->copy_from_cpu(input_data.data());
+      }
+      ASSERT_TRUE(predictor->ZeroCopyRun());
+    }
+  }
+
+  std::map<std::string, float> thresholds;
+  inference::DeserializeInt8ScaleTable(table_path, &thresholds);
+  ASSERT_FALSE(thresholds.empty());
+  for (const auto& item : thresholds) {
+    ASSERT_GT(item.second, 0.f) << item.first;
+  }
+}
+
+TEST(Int8CalibrationCollector, ComputeThreshold) {
+  // the half normal values of the standard deviation 200 in 2048 bins over
+  // [0, 2048], and an outlier at the range
+  std::vector<int64_t> bins(2048, 0);
+  for (int i = 0; i < 2048; ++i) {
+    bins[i] = std::llround(1e6 * std::exp(-(i / 200.0) * (i / 200.0)));
+  }
+  bins[2047] = 1;
+  const float range = 2048.f;
+  float percentile = inference::Int8CalibrationCollector::ComputeThreshold(
+      bins, range, "percentile", 50.f);
+  ASSERT_LT(percentile, 200.f);
+  for (const std::string method : {"entropy", "mse"}) {
+    float threshold = inference::Int8CalibrationCollector::ComputeThreshold(
+        bins, range, method, 99.99f);
+    ASSERT_GT(threshold, 0.f) << method;
+    ASSERT_LT(threshold, range) << method;
+  }
+  ASSERT_EQ(inference::Int8CalibrationCollector::ComputeThreshold(
+                std::vector<int64_t>(2048, 0), 0.f, "entropy", 99.99f),
+            0.f);
+}
+
 TEST(AnalysisPredictor, Clone) {
   AnalysisConfig config;
   config.SetModel(FLAGS_dirname);
@@ -659,6 +742,30 @@ TEST(Predictor, Streams) {
 
     CHECK_NE(stream, stream2);
   }
+
+  // private streams, clone
+  {
+    Config config;
+    config.SetModel(FLAGS_dirname);
+    config.EnableUseGpu(100, 0);
+    config.EnablePrivateStream(/*priority=*/-1);
+    CHECK_EQ(config.private_stream_enabled(), true);
+    auto predictor = CreatePredictor(config);
+    gpuStream_t stream =
+        reinterpret_cast<gpuStream_t>(predictor->GetExecStream());
+    CHECK_NOTNULL(paddle::ResourceManager::Instance().GetGPUResource(stream));
+    CHECK_EQ(paddle::ResourceManager::Instance().RefCount(stream), 1);
+    unsigned int flags = 0;
+    cudaStreamGetFlags(stream, &flags);
+    CHECK_EQ(flags, cudaStreamNonBlocking);
+
+    auto predictor2 = predictor->Clone();
+    gpuStream_t stream2 =
+        reinterpret_cast<gpuStream_t>(predictor2->GetExecStream());
+    CHECK_NOTNULL(paddle::ResourceManager::Instance().GetGPUResource(stream2));
+    CHECK_EQ(paddle::ResourceManager::Instance().RefCount(stream2), 1);
+    CHECK_NE(stream, stream2);
+  }
 }
 
 TEST(Tensor, RunWithExternalStream) {
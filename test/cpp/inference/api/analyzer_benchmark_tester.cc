@@ -0,0 +1,260 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The standard benchmark of an inference model, which replays the recorded
+// input shapes on num_threads clones of the predictor, back to back or at the
+// arrival rate of qps, and reports the latency percentiles, the throughput,
+// the peak gpu memory and the per op breakdown of the profiler as a json,
+// failing on a regression against a baseline json.
+
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <sstream>
+
+#include "paddle/fluid/memory/stats.h"
+#include "paddle/fluid/platform/profiler.h"
+#include "test/cpp/inference/api/tester_helper.h"
+
+PD_DEFINE_string(shape_file,
+                 "",
+                 "The recorded input shapes, a request per line as "
+                 "name0:d0,d1,...;name1:d0,d1,...");
+PD_DEFINE_bool(use_gpu, false, "Run the benchmark on the gpu.");
+PD_DEFINE_int32(gpu_device_id, 0, "The gpu of the benchmark.");
+PD_DEFINE_double(qps,
+                 0,
+                 "The arrival rate of the open loop load, 0 to run the "
+                 "requests back to back.");
+PD_DEFINE_string(profile_path,
+                 "benchmark_profile.txt",
+                 "The per op breakdown with enable_profile.");
+PD_DEFINE_string(benchmark_json,
+                 "benchmark.json",
+                 "The json of the benchmark metrics.");
+PD_DEFINE_string(baseline_json, "", "The baseline json to check against.");
+PD_DEFINE_double(regression_threshold,
+                 0.1,
+                 "The ratio of the baseline a metric may regress by.");
+PD_DEFINE_double(p99_regression_threshold,
+                 -1,
+                 "The threshold of latency_p99, regression_threshold if < 0.");
+
+namespace paddle {
+namespace inference {
+
+using InputShapes = std::map<std::string, std::vector<int>>;
+
+// The requests of shape_file, or a request of the model shapes with the
+// dynamic dims of batch_size.
+std::vector<InputShapes> LoadInputShapes(paddle_infer::Predictor *predictor) {
+  std::vector<InputShapes> requests;
+  if (!FLAGS_shape_file.empty()) {
+    std::ifstream file(FLAGS_shape_file);
+    PADDLE_ENFORCE_EQ(file.is_open(),
+                      true,
+                      platform::errors::Unavailable(
+                          "Can not open the shape file %s.", FLAGS_shape_file));
+    std::string line;
+    while (std::getline(file, line)) {
+      InputShapes request;
+      std::vector<std::string> inputs;
+      split(line, ';', &inputs);
+      for (auto &input : inputs) {
+        auto pos = input.find(':');
+        if (pos == std::string::npos) {
+          continue;
+        }
+        std::vector<int> shape;
+        split_to_int(input.substr(pos + 1), ',', &shape);
+        request[input.substr(0, pos)] = shape;
+      }
+      if (!request.empty()) {
+        requests.push_back(request);
+      }
+    }
+  }
+  if (requests.empty()) {
+    InputShapes request;
+    for (auto &item : predictor->GetInputTensorShape()) {
+      std::vector<int> shape;
+      for (auto dim : item.second) {
+        shape.push_back(dim < 0 ? FLAGS_batch_size : static_cast<int>(dim));
+      }
+      request[item.first] = shape;
+    }
+    requests.push_back(request);
+  }
+  return requests;
+}
+
+// Fills the inputs of a request with constants, for the same runs of a
+// benchmark.
+void SetInputs(paddle_infer::Predictor *predictor,
+               const InputShapes &request) {
+  auto types = predictor->GetInputTypes();
+  for (auto &item : request) {
+    auto tensor = predictor->GetInputHandle(item.first);
+    tensor->Reshape(item.second);
+    size_t numel = std::accumulate(item.second.begin(),
+                                   item.second.end(),
+                                   size_t{1},
+                                   std::multiplies<size_t>());
+    switch (types[item.first]) {
+      case paddle_infer::DataType::INT64:
+        tensor->CopyFromCpu(std::vector<int64_t>(numel, 0).data());
+        break;
+      case paddle_infer::DataType::INT32:
+        tensor->CopyFromCpu(std::vector<int32_t>(numel, 0).data());
+        break;
+      case paddle_infer::DataType::UINT8:
+        tensor->CopyFromCpu(std::vector<uint8_t>(numel, 0).data());
+        break;
+      case paddle_infer::DataType::INT8:
+        tensor->CopyFromCpu(std::vector<int8_t>(numel, 0).data());
+        break;
+      default:
+        tensor->CopyFromCpu(std::vector<float>(numel, 0.5f).data());
+        break;
+    }
+  }
+}
+
+// Runs the requests round robin from the offset of tid on a clone, returns
+// the latencies in ms. At an arrival rate the latency of a request is since
+// its arrival, so it includes the queueing behind a slow one.
+std::vector<float> RunClone(paddle_infer::Predictor *predictor,
+                            const std::vector<InputShapes> &requests,
+                            int num_threads,
+                            int tid) {
+  using Clock = std::chrono::steady_clock;
+  for (int i = 0; i < FLAGS_warmup_iters; ++i) {
+    SetInputs(predictor, requests[(tid + i) % requests.size()]);
+    predictor->Run();
+  }
+
+  const int iterations = FLAGS_iterations > 0 ? FLAGS_iterations : 100;
+  const auto interval = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(FLAGS_qps > 0 ? num_threads / FLAGS_qps
+                                                  : 0));
+  std::vector<float> latencies;
+  latencies.reserve(iterations);
+  auto arrival = Clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    if (FLAGS_qps > 0) {
+      std::this_thread::sleep_until(arrival);
+    } else {
+      arrival = Clock::now();
+    }
+    SetInputs(predictor, requests[(tid + i) % requests.size()]);
+    predictor->Run();
+    latencies.push_back(
+        std::chrono::duration<float, std::milli>(Clock::now() - arrival)
+            .count());
+    arrival += interval;
+  }
+  return latencies;
+}
+
+TEST(Analyzer_benchmark, benchmark) {
+  paddle_infer::Config config;
+  config.SetModel(FLAGS_infer_model + "/__model__",
+                  FLAGS_infer_model + "/__params__");
+  if (FLAGS_use_gpu) {
+    config.EnableUseGpu(100, FLAGS_gpu_device_id);
+  } else {
+    config.SetCpuMathLibraryNumThreads(FLAGS_cpu_num_threads);
+  }
+  auto predictor = paddle_infer::CreatePredictor(config);
+  auto requests = LoadInputShapes(predictor.get());
+
+  std::vector<std::unique_ptr<paddle_infer::Predictor>> clones;
+  for (int tid = 1; tid < FLAGS_num_threads; ++tid) {
+    clones.emplace_back(predictor->Clone());
+  }
+
+  if (FLAGS_enable_profile) {
+    platform::EnableProfiler(FLAGS_use_gpu ? platform::ProfilerState::kAll
+                                           : platform::ProfilerState::kCPU);
+  }
+  std::vector<std::vector<float>> latencies(FLAGS_num_threads);
+  std::vector<std::thread> threads;
+  Timer timer;
+  timer.tic();
+  for (int tid = 0; tid < FLAGS_num_threads; ++tid) {
+    threads.emplace_back([&, tid]() {
+      auto *clone = tid == 0 ? predictor.get() : clones[tid - 1].get();
+      latencies[tid] = RunClone(clone, requests, FLAGS_num_threads, tid);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  double elapsed = timer.toc();
+  if (FLAGS_enable_profile) {
+    platform::DisableProfiler(platform::EventSortingKey::kTotal,
+                              FLAGS_profile_path);
+  }
+
+  Benchmark benchmark;
+  benchmark.SetName(FLAGS_model_name);
+  benchmark.SetBatchSize(FLAGS_batch_size);
+  benchmark.SetNumThreads(FLAGS_num_threads);
+  if (FLAGS_use_gpu) {
+    benchmark.SetUseGpu();
+  }
+  double sum = 0;
+  size_t num_requests = 0;
+  for (auto &thread_latencies : latencies) {
+    for (auto latency : thread_latencies) {
+      benchmark.AddLatency(latency);
+      sum += latency;
+    }
+    num_requests += thread_latencies.size();
+  }
+  benchmark.SetLatency(sum / num_requests);
+  benchmark.SetThroughput(num_requests * 1000.0 / elapsed);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (FLAGS_use_gpu) {
+    benchmark.SetGpuMemory(
+        memory::DeviceMemoryStatPeakValue("Allocated", FLAGS_gpu_device_id));
+  }
+#endif
+  if (FLAGS_enable_profile) {
+    benchmark.SetProfilePath(FLAGS_profile_path);
+  }
+  LOG(INFO) << "benchmark:\n" << benchmark.SerializeToJson();
+  benchmark.PersistToJsonFile(FLAGS_benchmark_json);
+
+  if (!FLAGS_baseline_json.empty()) {
+    std::ifstream file(FLAGS_baseline_json);
+    ASSERT_TRUE(file.is_open()) << "Can not open " << FLAGS_baseline_json;
+    std::stringstream baseline;
+    baseline << file.rdbuf();
+    std::map<std::string, float> thresholds;
+    if (FLAGS_p99_regression_threshold >= 0) {
+      thresholds["latency_p99"] = FLAGS_p99_regression_threshold;
+    }
+    auto regressions = benchmark.CheckRegression(
+        baseline.str(), FLAGS_regression_threshold, thresholds);
+    for (auto &regression : regressions) {
+      LOG(ERROR) << regression;
+    }
+    ASSERT_TRUE(regressions.empty());
+  }
+}
+
+}  // namespace inference
+}  // namespace paddle
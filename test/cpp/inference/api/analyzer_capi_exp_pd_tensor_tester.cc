@@ -18,8 +18,10 @@ limitations under the License. */
 #include <stdint.h>
 #include <stdio.h>
 
+#include <condition_variable>  // NOLINT
 #include <fstream>
 #include <iostream>
+#include <mutex>  // NOLINT
 #include <numeric>
 #include <sstream>
 #include <string>
@@ -206,6 +208,65 @@ TEST(PD_Tensor, from_buffer) {
   PD_ConfigDestroy(config);
 }
 
+struct RunAsyncResult {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done{false};
+  PD_Bool success{FALSE};
+};
+
+void RunAsyncCallback(PD_Bool success, void* user_data) {
+  auto* result = static_cast<RunAsyncResult*>(user_data);
+  std::lock_guard<std::mutex> guard(result->mutex);
+  result->success = success;
+  result->done = true;
+  result->cv.notify_one();
+}
+
+TEST(PD_Tensor, share_external_data_and_run_async) {
+  auto model_dir = FLAGS_infer_model;
+  PD_Config* config = PD_ConfigCreate();
+  PD_ConfigSetModel(config,
+                    (model_dir + "/__model__").c_str(),
+                    (model_dir + "/__params__").c_str());
+  PD_Predictor* predictor = PD_PredictorCreate(config);
+  PD_OneDimArrayCstr* input_names = PD_PredictorGetInputNames(predictor);
+  PD_Tensor* tensor =
+      PD_PredictorGetInputHandle(predictor, input_names->data[0]);
+
+  int32_t shapes[4] = {1, 3, 300, 300};
+  std::vector<float> input(1 * 3 * 300 * 300, 0);
+  PD_TensorShareExternalData(
+      tensor, input.data(), 4, shapes, PD_DATA_FLOAT32, PD_PLACE_CPU);
+  int32_t size;
+  PD_PlaceType place;
+  float* data_ptr = PD_TensorDataFloat(tensor, &place, &size);
+  EXPECT_EQ(data_ptr, input.data());
+  EXPECT_EQ(place, PD_PLACE_CPU);
+  EXPECT_EQ(size, 1 * 3 * 300 * 300);
+
+  RunAsyncResult result;
+  PD_PredictorRunAsync(predictor, nullptr, RunAsyncCallback, &result);
+  {
+    std::unique_lock<std::mutex> lock(result.mutex);
+    result.cv.wait(lock, [&result] { return result.done; });
+  }
+  EXPECT_TRUE(result.success);
+
+  PD_OneDimArrayCstr* output_names = PD_PredictorGetOutputNames(predictor);
+  PD_Tensor* output_tensor =
+      PD_PredictorGetOutputHandle(predictor, output_names->data[0]);
+  PD_OneDimArrayInt32* output_shape = PD_TensorGetShape(output_tensor);
+  EXPECT_GT(output_shape->size, 0u);
+
+  PD_OneDimArrayInt32Destroy(output_shape);
+  PD_TensorDestroy(output_tensor);
+  PD_OneDimArrayCstrDestroy(output_names);
+  PD_TensorDestroy(tensor);
+  PD_OneDimArrayCstrDestroy(input_names);
+  PD_PredictorDestroy(predictor);
+}
+
 }  // namespace analysis
 }  // namespace inference
 }  // namespace paddle
@@ -0,0 +1,165 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <numeric>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/inference/api/paddle_infer_contrib.h"
+
+namespace paddle_infer {
+namespace contrib {
+
+std::vector<int64_t> Tokens(int begin, int num) {
+  std::vector<int64_t> tokens(num);
+  std::iota(tokens.begin(), tokens.end(), begin);
+  return tokens;
+}
+
+TEST(KVCacheBlockManager, allocate_and_free) {
+  KVCacheBlockManager manager(4, 4);
+  int num_cached_tokens = -1;
+  ASSERT_TRUE(manager.AddSequence(0, Tokens(0, 6), &num_cached_tokens));
+  EXPECT_EQ(num_cached_tokens, 0);
+  EXPECT_EQ(manager.BlockTable(0), std::vector<int>({0, 1}));
+  EXPECT_EQ(manager.NumFreeBlocks(), 2);
+
+  std::vector<std::pair<int, int>> copies;
+  ASSERT_TRUE(manager.AppendTokens(0, 2, &copies));
+  EXPECT_EQ(manager.BlockTable(0).size(), 2UL);
+  ASSERT_TRUE(manager.AppendTokens(0, 1, &copies));
+  EXPECT_EQ(manager.BlockTable(0).size(), 3UL);
+  EXPECT_EQ(manager.NumTokens(0), 9);
+  EXPECT_TRUE(copies.empty());
+
+  // not enough blocks, nothing is allocated
+  EXPECT_FALSE(manager.AddSequence(1, Tokens(0, 8)));
+  EXPECT_FALSE(manager.HasSequence(1));
+  EXPECT_EQ(manager.NumFreeBlocks(), 1);
+
+  std::vector<int> block_tables(2 * 4);
+  ASSERT_TRUE(manager.AddSequence(1, Tokens(100, 3)));
+  manager.GetBlockTables({0, 1}, 4, block_tables.data());
+  EXPECT_EQ(block_tables, std::vector<int>({0, 1, 2, -1, 3, -1, -1, -1}));
+
+  manager.FreeSequence(0);
+  manager.FreeSequence(1);
+  EXPECT_EQ(manager.NumFreeBlocks(), 4);
+}
+
+TEST(KVCacheBlockManager, fork_copy_on_write) {
+  KVCacheBlockManager manager(4, 4);
+  ASSERT_TRUE(manager.AddSequence(0, Tokens(0, 6)));
+  manager.ForkSequence(0, 1);
+  EXPECT_EQ(manager.BlockTable(1), manager.BlockTable(0));
+  EXPECT_EQ(manager.NumFreeBlocks(), 2);
+
+  std::vector<std::pair<int, int>> copies;
+  ASSERT_TRUE(manager.AppendTokens(1, 1, &copies));
+  ASSERT_EQ(copies.size(), 1UL);
+  EXPECT_EQ(copies[0], std::make_pair(1, 2));
+  EXPECT_EQ(manager.BlockTable(1), std::vector<int>({0, 2}));
+  // the last block of the parent is not shared any more
+  copies.clear();
+  ASSERT_TRUE(manager.AppendTokens(0, 1, &copies));
+  EXPECT_TRUE(copies.empty());
+  EXPECT_EQ(manager.BlockTable(0), std::vector<int>({0, 1}));
+
+  // the first block is still used by the child
+  manager.FreeSequence(0);
+  EXPECT_EQ(manager.NumFreeBlocks(), 2);
+  manager.FreeSequence(1);
+  EXPECT_EQ(manager.NumFreeBlocks(), 4);
+}
+
+TEST(KVCacheBlockManager, reorder_beams) {
+  KVCacheBlockManager manager(8, 4);
+  ASSERT_TRUE(manager.AddSequence(0, Tokens(0, 6)));
+  manager.ForkSequence(0, 1);
+  manager.ForkSequence(0, 2);
+  std::vector<std::pair<int, int>> copies;
+  for (int64_t seq_id : {0, 1, 2}) {
+    ASSERT_TRUE(manager.AppendTokens(seq_id, 1, &copies));
+  }
+  // beams 0 and 1 took a copy of the last block, beam 2 kept it
+  EXPECT_EQ(copies.size(), 2UL);
+  std::vector<int> table0 = manager.BlockTable(0);
+  std::vector<int> table2 = manager.BlockTable(2);
+  EXPECT_EQ(manager.NumFreeBlocks(), 4);
+
+  // beam 1 is dropped, and beam 0 continues twice
+  manager.ReorderBeams({0, 1, 2}, {0, 0, 2});
+  EXPECT_EQ(manager.BlockTable(0), table0);
+  EXPECT_EQ(manager.BlockTable(1), table0);
+  EXPECT_EQ(manager.BlockTable(2), table2);
+  EXPECT_EQ(manager.NumTokens(1), 7);
+  EXPECT_EQ(manager.NumFreeBlocks(), 5);
+
+  // the shared last block is copied on write again
+  copies.clear();
+  ASSERT_TRUE(manager.AppendTokens(1, 1, &copies));
+  ASSERT_EQ(copies.size(), 1UL);
+  EXPECT_EQ(copies[0].first, table0.back());
+
+  for (int64_t seq_id : {0, 1, 2}) {
+    manager.FreeSequence(seq_id);
+  }
+  EXPECT_EQ(manager.NumFreeBlocks(), 8);
+}
+
+TEST(KVCacheBlockManager, prefix_cache) {
+  KVCacheBlockManager manager(6, 4);
+  ASSERT_TRUE(manager.AddSequence(0, Tokens(0, 10)));
+  // the blocks are shared only after they are computed
+  int num_cached_tokens = -1;
+  ASSERT_TRUE(manager.AddSequence(1, Tokens(0, 10), &num_cached_tokens));
+  EXPECT_EQ(num_cached_tokens, 0);
+  manager.FreeSequence(1);
+
+  manager.MarkComputed(0);
+  ASSERT_TRUE(manager.AddSequence(2, Tokens(0, 9), &num_cached_tokens));
+  EXPECT_EQ(num_cached_tokens, 8);
+  EXPECT_EQ(manager.BlockTable(2)[0], manager.BlockTable(0)[0]);
+  EXPECT_EQ(manager.BlockTable(2)[1], manager.BlockTable(0)[1]);
+  // the last token is never cached
+  ASSERT_TRUE(manager.AddSequence(3, Tokens(0, 8), &num_cached_tokens));
+  EXPECT_EQ(num_cached_tokens, 4);
+  // a different second block
+  std::vector<int64_t> tokens = Tokens(0, 9);
+  tokens[5] = 100;
+  manager.FreeSequence(3);
+  ASSERT_TRUE(manager.AddSequence(3, tokens, &num_cached_tokens));
+  EXPECT_EQ(num_cached_tokens, 4);
+
+  // the cached blocks are kept after their sequences are freed
+  std::vector<int> prefix(manager.BlockTable(0).begin(),
+                          manager.BlockTable(0).begin() + 2);
+  manager.FreeSequence(0);
+  manager.FreeSequence(2);
+  manager.FreeSequence(3);
+  EXPECT_EQ(manager.NumFreeBlocks(), 6);
+  ASSERT_TRUE(manager.AddSequence(4, Tokens(0, 12), &num_cached_tokens));
+  EXPECT_EQ(num_cached_tokens, 8);
+  EXPECT_EQ(manager.BlockTable(4)[0], prefix[0]);
+  EXPECT_EQ(manager.BlockTable(4)[1], prefix[1]);
+  manager.FreeSequence(4);
+
+  // the cached blocks are evicted when no free block is left
+  ASSERT_TRUE(manager.AddSequence(5, Tokens(1000, 24)));
+  manager.FreeSequence(5);
+  ASSERT_TRUE(manager.AddSequence(6, Tokens(0, 12), &num_cached_tokens));
+  EXPECT_EQ(num_cached_tokens, 0);
+}
+
+}  // namespace contrib
+}  // namespace paddle_infer
@@ -159,6 +159,22 @@ TEST(CpuLayerTest, Clone) {
   EXPECT_NEAR(out_data[0], pow(1.41562390, 2.0), 1e-6);
 }
 
+TEST(CpuLayerTest, SharedParams) {
+  auto place = phi::CPUPlace();
+  std::string path = "./multi_program_load/export";
+  auto layer = jit::Load(path, place);
+  auto inputs = PrepareInputs(place);
+
+  // the functions share the params and are prepared on the first call
+  auto func = layer.Function("infer");
+  for (int i = 0; i < 2; ++i) {
+    auto outs = func(inputs);
+    EXPECT_NEAR(outs[0].data<float>()[0], 1.41562390, 1e-6);
+    outs = layer.forward(inputs);
+    EXPECT_NEAR(outs[0].data<float>()[0], 0.02194316, 1e-6);
+  }
+}
+
 #if defined(PADDLE_WITH_CUDA)
 TEST(GpuLayerTest, Construct) {
   auto place = phi::GPUPlace();
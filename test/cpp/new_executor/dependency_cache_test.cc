@@ -0,0 +1,77 @@
+// Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/dependency_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+#include "paddle/fluid/framework/new_executor/interpreter/dependency_builder.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+// 0 -> 1 -> 3
+// 0 -> 2 -> 3 -> 4
+static std::map<size_t, std::set<size_t>> TestDownstreamMap() {
+  return {{0, {1, 2}}, {1, {3}}, {2, {3}}, {3, {4}}};
+}
+
+TEST(DependencyCache, SaveAndLoad) {
+  std::map<size_t, std::set<size_t>> downstream_map = TestDownstreamMap();
+  std::string path = "./dependency_cache_test.deps";
+  SaveDependencyCache(path, /*fingerprint=*/123, /*op_num=*/5, downstream_map);
+
+  std::map<size_t, std::set<size_t>> loaded_map;
+  EXPECT_TRUE(LoadDependencyCache(path, 123, 5, &loaded_map));
+  EXPECT_EQ(loaded_map, downstream_map);
+
+  // mismatched fingerprint or op number should be rejected
+  std::map<size_t, std::set<size_t>> untouched_map;
+  EXPECT_FALSE(LoadDependencyCache(path, 456, 5, &untouched_map));
+  EXPECT_FALSE(LoadDependencyCache(path, 123, 6, &untouched_map));
+  EXPECT_TRUE(untouched_map.empty());
+
+  std::remove(path.c_str());
+  EXPECT_FALSE(LoadDependencyCache(path, 123, 5, &untouched_map));
+}
+
+TEST(DependencyCache, BuildOpHappensBefore) {
+  std::vector<std::vector<bool>> op_happens_before;
+  BuildOpHappensBefore(TestDownstreamMap(), 5, &op_happens_before);
+
+  EXPECT_TRUE(op_happens_before[0][1]);
+  EXPECT_TRUE(op_happens_before[0][3]);
+  EXPECT_TRUE(op_happens_before[0][4]);
+  EXPECT_TRUE(op_happens_before[2][4]);
+  EXPECT_FALSE(op_happens_before[1][2]);
+  EXPECT_FALSE(op_happens_before[2][1]);
+  EXPECT_FALSE(op_happens_before[4][0]);
+}
+
+TEST(DependencyBuilder, GetCriticalPathLength) {
+  std::vector<size_t> critical_path_length =
+      GetCriticalPathLength(TestDownstreamMap(), 5);
+  EXPECT_EQ(critical_path_length, std::vector<size_t>({4, 3, 3, 2, 1}));
+
+  std::vector<size_t> ranked_ops =
+      RankDownstreamOps({1, 2, 4}, critical_path_length);
+  EXPECT_EQ(ranked_ops, std::vector<size_t>({1, 2, 4}));
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
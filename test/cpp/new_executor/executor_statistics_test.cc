@@ -0,0 +1,145 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/executor_statistics.h"
+
+#include <gtest/gtest.h>
+
+#include <list>
+#include <string>
+
+namespace paddle {
+namespace framework {
+
+using platform::DeviceTraceEvent;
+using platform::HostTraceEvent;
+using platform::KernelEventInfo;
+using platform::MemTraceEvent;
+using platform::OperatorSupplementEvent;
+using platform::RuntimeTraceEvent;
+using platform::TracerEventType;
+
+// thread 10: op1 [0, 10]   op2 [12, 14]   op3 [15, 40]   op4 [41, 50]
+// stream 7:     k1 [4, 20]   k2 [20, 30]                   k3 [45, 48]
+// stream 8:  nccl [2, 10]
+// in us, where op3 synchronizes the streams in [15.5, 39].
+TEST(ExecutorStatistics, AnalyzeCriticalPath) {
+  std::list<HostTraceEvent> host_events;
+  std::list<RuntimeTraceEvent> runtime_events;
+  std::list<DeviceTraceEvent> device_events;
+  std::list<MemTraceEvent> mem_events;
+  std::list<OperatorSupplementEvent> op_supplement_events;
+  host_events.emplace_back(
+      std::string("op1"), TracerEventType::Operator, 0, 10000, 10, 10);
+  host_events.emplace_back(
+      std::string("op2"), TracerEventType::Operator, 12000, 14000, 10, 10);
+  host_events.emplace_back(
+      std::string("op3"), TracerEventType::Operator, 15000, 40000, 10, 10);
+  host_events.emplace_back(
+      std::string("op4"), TracerEventType::Operator, 41000, 50000, 10, 10);
+  runtime_events.emplace_back(
+      std::string("cudaLaunchKernel"), 500, 900, 10, 10, 1, 0);
+  runtime_events.emplace_back(
+      std::string("cudaLaunchKernel"), 2000, 3000, 10, 10, 2, 0);
+  runtime_events.emplace_back(
+      std::string("cudaLaunchKernel"), 12500, 13000, 10, 10, 3, 0);
+  runtime_events.emplace_back(
+      std::string("cudaStreamSynchronize"), 15500, 39000, 10, 10, 4, 0);
+  runtime_events.emplace_back(
+      std::string("cudaLaunchKernel"), 42000, 43000, 10, 10, 5, 0);
+  device_events.emplace_back(std::string("ncclKernel_AllReduce"),
+                             TracerEventType::Kernel,
+                             2000,
+                             10000,
+                             0,
+                             0,
+                             8,
+                             1,
+                             KernelEventInfo());
+  device_events.emplace_back(std::string("k1"),
+                             TracerEventType::Kernel,
+                             4000,
+                             20000,
+                             0,
+                             0,
+                             7,
+                             2,
+                             KernelEventInfo());
+  device_events.emplace_back(std::string("k2"),
+                             TracerEventType::Kernel,
+                             20000,
+                             30000,
+                             0,
+                             0,
+                             7,
+                             3,
+                             KernelEventInfo());
+  device_events.emplace_back(std::string("k3"),
+                             TracerEventType::Kernel,
+                             45000,
+                             48000,
+                             0,
+                             0,
+                             7,
+                             5,
+                             KernelEventInfo());
+  platform::NodeTrees trees(host_events,
+                            runtime_events,
+                            device_events,
+                            mem_events,
+                            op_supplement_events);
+  std::string report = AnalyzeCriticalPath(trees);
+
+  // op4 <- op3 waiting for k2 <- k1 <- op1, with the idle [40, 41]
+  EXPECT_NE(report.find("Critical path(ms): 0.050, idle on the path(ms): "
+                        "0.001"),
+            std::string::npos)
+      << report;
+  EXPECT_NE(report.find("1     op1                                     "
+                        "0.020       40.00     0.004       0.016"),
+            std::string::npos)
+      << report;
+  EXPECT_NE(report.find("op2                                     0.010       "
+                        "20.00     0.000       0.010"),
+            std::string::npos)
+      << report;
+  EXPECT_NE(report.find("op3                                     0.010       "
+                        "20.00     0.010       0.000"),
+            std::string::npos)
+      << report;
+
+  // in the device window [2, 48]
+  EXPECT_NE(report.find("0       7         0.029       0.017       36.96     "
+                        "2       0.015"),
+            std::string::npos)
+      << report;
+  EXPECT_NE(report.find("0       8         0.008       0.038       82.61     "
+                        "1       0.038"),
+            std::string::npos)
+      << report;
+  EXPECT_NE(report.find("communication(%): 75.00"), std::string::npos)
+      << report;
+
+  // the devices idle in [30, 45] while op3 and op4 run
+  EXPECT_NE(report.find("(ms): 0.014 (30.43% of the device window) in 2 "
+                        "intervals"),
+            std::string::npos)
+      << report;
+  EXPECT_NE(report.find("1     op3                                     0.010"),
+            std::string::npos)
+      << report;
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,72 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/static_memory_planner.h"
+
+#include <gtest/gtest.h>
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+static PlannedTensor MakeTensor(size_t var_id,
+                                size_t bytes,
+                                size_t first_op,
+                                size_t last_op) {
+  PlannedTensor tensor;
+  tensor.var_id = var_id;
+  tensor.bytes = bytes;
+  tensor.first_ops = {first_op};
+  tensor.last_ops = {last_op};
+  return tensor;
+}
+
+// the ops run in a chain, op i happens before op j if i < j
+static bool ChainHappensBefore(size_t a, size_t b) { return a < b; }
+
+TEST(StaticMemoryPlanner, PackChain) {
+  std::vector<PlannedTensor> tensors = {MakeTensor(0, 100, 0, 1),
+                                        MakeTensor(1, 200, 1, 2),
+                                        MakeTensor(2, 300, 2, 3),
+                                        MakeTensor(3, 100, 3, 4)};
+  size_t size = PackTensorOffsets(&tensors, ChainHappensBefore, 256);
+  // 2 is placed first, 1 after it, and 0 and 3 reuse the memory of 2 and 1
+  EXPECT_EQ(tensors[2].offset, 0UL);
+  EXPECT_EQ(tensors[1].offset, 512UL);
+  EXPECT_EQ(tensors[0].offset, 0UL);
+  EXPECT_EQ(tensors[3].offset, 512UL);
+  EXPECT_EQ(size, 768UL);
+}
+
+TEST(StaticMemoryPlanner, PackConcurrent) {
+  // 0 -> {1, 2} -> 3, the ops 1 and 2 may run in any order
+  auto happens_before = [](size_t a, size_t b) {
+    return (a == 0 && b != 0) || (a != 3 && b == 3);
+  };
+  std::vector<PlannedTensor> tensors = {
+      MakeTensor(0, 256, 1, 1), MakeTensor(1, 256, 2, 2)};
+  size_t size = PackTensorOffsets(&tensors, happens_before, 256);
+  EXPECT_NE(tensors[0].offset, tensors[1].offset);
+  EXPECT_EQ(size, 512UL);
+
+  tensors.push_back(MakeTensor(2, 512, 3, 3));
+  size = PackTensorOffsets(&tensors, happens_before, 256);
+  // the output of op 3 reuses the memory of both of its inputs
+  EXPECT_EQ(tensors[2].offset, 0UL);
+  EXPECT_EQ(size, 512UL);
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
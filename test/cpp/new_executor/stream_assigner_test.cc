@@ -0,0 +1,97 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/stream_assigner.h"
+
+#include <gtest/gtest.h>
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+static BranchOp MakeOp(const std::vector<int>& inputs,
+                       const std::vector<int>& outputs,
+                       bool movable = true) {
+  BranchOp op;
+  op.inputs = inputs;
+  op.outputs = outputs;
+  op.movable = movable;
+  return op;
+}
+
+TEST(StreamAssigner, TwoTowers) {
+  // x -> a0 -> a1 -> a2 \
+  //                      concat -> out
+  // y -> b0 -> b1 -> b2 /
+  std::vector<BranchOp> ops = {MakeOp({0}, {10}),
+                               MakeOp({10}, {11}),
+                               MakeOp({11}, {12}),
+                               MakeOp({1}, {20}),
+                               MakeOp({20}, {21}),
+                               MakeOp({21}, {22}),
+                               MakeOp({12, 22}, {30}),
+                               MakeOp({30}, {31})};
+  StreamAssignment assignment = PlanBranchStreams(ops, 2);
+  EXPECT_EQ(assignment.stream_of_op,
+            std::vector<int>({0, 0, 0, 1, 1, 1, 0, 0}));
+  EXPECT_EQ(assignment.num_branches, 1UL);
+  EXPECT_EQ(assignment.num_ops, 8UL);
+  EXPECT_EQ(assignment.critical_path_ops, 5UL);
+
+  // a single stream keeps all the ops on the default stream
+  assignment = PlanBranchStreams(ops, 1);
+  EXPECT_EQ(assignment.stream_of_op, std::vector<int>(8, 0));
+  EXPECT_EQ(assignment.num_branches, 0UL);
+}
+
+TEST(StreamAssigner, ForkAndShortBranches) {
+  // x -> op0 forks into three heads of 2, 2 and 1 ops
+  std::vector<BranchOp> ops = {MakeOp({0}, {1}),
+                               MakeOp({1}, {10}),
+                               MakeOp({10}, {11}),
+                               MakeOp({1}, {20}),
+                               MakeOp({20}, {21}),
+                               MakeOp({1}, {30}),
+                               MakeOp({1}, {40}),
+                               MakeOp({40}, {41})};
+  StreamAssignment assignment = PlanBranchStreams(ops, 3);
+  // the single op head stays on the default stream, and the other two heads
+  // take the streams round robin
+  EXPECT_EQ(assignment.stream_of_op,
+            std::vector<int>({0, 0, 0, 1, 1, 0, 2, 2}));
+  EXPECT_EQ(assignment.num_branches, 2UL);
+  EXPECT_EQ(assignment.critical_path_ops, 3UL);
+}
+
+TEST(StreamAssigner, UnmovableOps) {
+  // the memcpy like ops 1 and 4 stay on the default stream, but carry the
+  // branches of their producers
+  std::vector<BranchOp> ops = {MakeOp({0}, {1}),
+                               MakeOp({1}, {2}, /*movable=*/false),
+                               MakeOp({2}, {3}),
+                               MakeOp({3}, {4}),
+                               MakeOp({5}, {6}, /*movable=*/false),
+                               MakeOp({6}, {7}),
+                               MakeOp({7}, {8})};
+  StreamAssignment assignment = PlanBranchStreams(ops, 2);
+  EXPECT_EQ(assignment.stream_of_op,
+            std::vector<int>({0, 0, 0, 0, 0, 1, 1}));
+  EXPECT_EQ(assignment.num_branches, 1UL);
+  EXPECT_EQ(assignment.num_ops, 5UL);
+  EXPECT_EQ(assignment.critical_path_ops, 3UL);
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,101 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_corpus.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+PD_DECLARE_KERNEL(scale, CPU, ALL_LAYOUT);
+
+namespace phi {
+namespace tests {
+
+TEST(KernelCorpus, SerializeAndParse) {
+  std::string line =
+      "sum GPU NCHW float32 | float32[32,1024] - | float32[32] | [1] float32 "
+      "false \"mean\"";
+  auto entry = phi::ParseKernelCorpusEntry(line);
+  EXPECT_EQ(entry.kernel_name, "sum");
+  EXPECT_EQ(entry.kernel_key.backend(), phi::Backend::GPU);
+  EXPECT_EQ(entry.kernel_key.layout(), phi::DataLayout::NCHW);
+  EXPECT_EQ(entry.kernel_key.dtype(), phi::DataType::FLOAT32);
+  ASSERT_EQ(entry.inputs.size(), 2UL);
+  EXPECT_TRUE(entry.inputs[0].defined);
+  EXPECT_EQ(entry.inputs[0].dims, std::vector<int64_t>({32, 1024}));
+  EXPECT_FALSE(entry.inputs[1].defined);
+  ASSERT_EQ(entry.outputs.size(), 1UL);
+  EXPECT_EQ(entry.attrs.size(), 4UL);
+  EXPECT_EQ(phi::SerializeKernelCorpusEntry(entry), line);
+
+  auto place = phi::CPUPlace();
+  auto axis = phi::ParseKernelCorpusAttribute(
+      entry.attrs[0], phi::AttributeType::INT_ARRAY, place);
+  EXPECT_EQ(paddle::get<phi::IntArray>(axis).GetData(),
+            std::vector<int64_t>({1}));
+  auto dtype = phi::ParseKernelCorpusAttribute(
+      entry.attrs[1], phi::AttributeType::DATA_TYPE, place);
+  EXPECT_EQ(paddle::get<phi::DataType>(dtype), phi::DataType::FLOAT32);
+  auto keep_dim = phi::ParseKernelCorpusAttribute(
+      entry.attrs[2], phi::AttributeType::BOOL, place);
+  EXPECT_FALSE(paddle::get<bool>(keep_dim));
+  auto mode = phi::ParseKernelCorpusAttribute(
+      entry.attrs[3], phi::AttributeType::STRING, place);
+  EXPECT_EQ(paddle::get<std::string>(mode), "mean");
+}
+
+TEST(KernelCorpus, MakeEntry) {
+  phi::KernelKey kernel_key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT32);
+  const auto& kernel =
+      phi::KernelFactory::Instance().SelectKernel("scale", kernel_key);
+  ASSERT_TRUE(kernel.IsValid());
+
+  auto* dev_ctx = phi::DeviceContextPool::Instance().Get(phi::CPUPlace());
+  phi::DenseTensor x;
+  x.Resize({2, 3});
+  float* x_data = dev_ctx->template Alloc<float>(&x);
+  for (int i = 0; i < 6; ++i) {
+    x_data[i] = i;
+  }
+  phi::DenseTensor out;
+  out.set_meta(phi::DenseTensorMeta(phi::DataType::FLOAT32, x.dims()));
+
+  phi::KernelContext ctx(dev_ctx);
+  ctx.EmplaceBackInput(&x);
+  ctx.EmplaceBackAttr(phi::Scalar(2.0f));
+  ctx.EmplaceBackAttr(0.5f);
+  ctx.EmplaceBackAttr(true);
+  ctx.EmplaceBackOutput(&out);
+  kernel(&ctx);
+
+  phi::KernelCorpusEntry entry;
+  ASSERT_TRUE(
+      phi::MakeKernelCorpusEntry("scale", kernel_key, kernel, ctx, &entry));
+  EXPECT_EQ(phi::SerializeKernelCorpusEntry(entry),
+            "scale CPU ANYLAYOUT float32 | float32[2,3] | float32[2,3] | 2 "
+            "0.5 true");
+
+  // the kernel of the entry replays the call
+  auto replayed = phi::ParseKernelCorpusEntry(
+      phi::SerializeKernelCorpusEntry(entry));
+  EXPECT_TRUE(phi::KernelFactory::Instance().HasKernel(replayed.kernel_name,
+                                                       replayed.kernel_key));
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -12,6 +12,7 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <chrono>
 #include <iostream>
 #include <sstream>
 
@@ -133,6 +134,88 @@ TEST(AttributeType, OStream) {
   oss.str("");
 }
 
+TEST(KernelSelectionCache, SelectKernel) {
+  phi::KernelSelectionCache cache("scale");
+  for (auto dtype : {phi::DataType::FLOAT32,
+                     phi::DataType::FLOAT64,
+                     phi::DataType::FLOAT32}) {
+    phi::KernelKey kernel_key(phi::Backend::CPU, phi::DataLayout::NCHW, dtype);
+    auto expected = phi::KernelFactory::Instance().SelectKernelOrThrowError(
+        "scale", kernel_key, true);
+    auto result = cache.SelectKernelOrThrowError(kernel_key, true);
+    EXPECT_EQ(&result.kernel, &expected.kernel);
+    EXPECT_EQ(result.has_fallback_cpu, expected.has_fallback_cpu);
+    EXPECT_EQ(result.is_stride_kernel, expected.is_stride_kernel);
+  }
+
+  // the results are selected again after the kernels may be changed
+  phi::KernelKey kernel_key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT16);
+  auto& test_kernels = phi::KernelFactory::Instance().kernels()["test"];
+  phi::KernelSelectionCache test_cache("test");
+  EXPECT_EQ(&test_cache.SelectKernelOrThrowError(kernel_key).kernel,
+            &test_kernels[kernel_key]);
+  auto generation = phi::KernelFactory::Instance().generation();
+  phi::KernelFactory::Instance().kernels();
+  EXPECT_GT(phi::KernelFactory::Instance().generation(), generation);
+  EXPECT_EQ(&test_cache.SelectKernelOrThrowError(kernel_key).kernel,
+            &test_kernels[kernel_key]);
+}
+
+TEST(KernelFactory, RegisterAfterLookup) {
+  // the registered kernels are constructed at the first lookup
+  phi::KernelKey kernel_key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT32);
+  EXPECT_TRUE(phi::KernelFactory::Instance().HasKernel("test", kernel_key));
+
+  // and the later ones at their registrations
+  auto generation = phi::KernelFactory::Instance().generation();
+  static const phi::KernelRegistrar registrar(
+      phi::RegType::INNER,
+      "test_after_lookup",
+      "CPU",
+      phi::DataLayout::ALL_LAYOUT,
+      phi::DataType::FLOAT32,
+      ::phi::KernelArgsParseFunctor<
+          decltype(&TestKernel<float, phi::CPUContext>)>::Parse,
+      [](const phi::KernelKey& kernel_key, phi::Kernel* kernel) {},
+      PHI_KERNEL(TestKernel<float, phi::CPUContext>),
+      PHI_VARIADIC_KERNEL(TestKernel<float, phi::CPUContext>));
+  EXPECT_GT(phi::KernelFactory::Instance().generation(), generation);
+  auto kernel = phi::KernelFactory::Instance().SelectKernel(
+      "test_after_lookup", kernel_key);
+  EXPECT_TRUE(kernel.IsValid());
+  EXPECT_EQ(kernel.args_def().input_defs().size(), 2UL);
+}
+
+TEST(KernelSelectionCache, DispatchOverhead) {
+  constexpr int kRepeat = 100000;
+  phi::KernelKey kernel_key(
+      phi::Backend::CPU, phi::DataLayout::NCHW, phi::DataType::FLOAT32);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRepeat; ++i) {
+    auto result = phi::KernelFactory::Instance().SelectKernelOrThrowError(
+        "scale", kernel_key, true);
+    EXPECT_TRUE(result.kernel.IsValid());
+  }
+  auto factory_ns = std::chrono::duration<double, std::nano>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+
+  phi::KernelSelectionCache cache("scale");
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRepeat; ++i) {
+    auto result = cache.SelectKernelOrThrowError(kernel_key, true);
+    EXPECT_TRUE(result.kernel.IsValid());
+  }
+  auto cache_ns = std::chrono::duration<double, std::nano>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  std::cout << "Select a kernel by KernelFactory: " << factory_ns / kRepeat
+            << " ns, by KernelSelectionCache: " << cache_ns / kRepeat
+            << " ns" << std::endl;
+}
+
 }  // namespace tests
 }  // namespace phi
 
@@ -15,7 +15,9 @@
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <cstdio>
 #include <functional>
+#include <string>
 
 #include "paddle/phi/kernels/autotune/cache.h"
 
@@ -66,3 +68,46 @@ TEST(AlgosCache, AlgosCache) {
   EXPECT_EQ(autotune_cache.CacheMisses(), 2);
   EXPECT_LT(std::abs(cache_hit_rate - autotune_cache.CacheHitRate()), 1e-5);
 }
+
+TEST(AlgosCache, SaveAndLoad) {
+  auto& autotune_cache = phi::autotune::AutoTuneCache::Instance();
+  std::string path = "./test_autotune_cache_file";
+  std::remove(path.c_str());
+
+  std::vector<int64_t> x_shape = {4, 224, 224, 3};
+  std::vector<int64_t> w_shape = {32, 3, 3, 3};
+  phi::DataType dtype = phi::CppTypeToDataType<float>::Type();
+  phi::autotune::ConvCacheKey key(
+      x_shape, w_shape, {2, 2}, {0, 0}, {}, dtype, 1, 1);
+  autotune_cache.Clean();
+  autotune_cache.GetConv(phi::autotune::AlgorithmType::kConvBackwardData)
+      .Set(key, phi::autotune::ConvAutoTuneResult(2, 1024, true));
+  autotune_cache.Get(phi::autotune::AlgorithmType::kTranspose).Set(123, 1);
+  autotune_cache.Save(path);
+
+  // the file is merged with the algorithms saved before
+  autotune_cache.Clean();
+  autotune_cache.GetMatmul().Set(456, 3);
+  autotune_cache.Save(path);
+
+  autotune_cache.Clean();
+  EXPECT_EQ(autotune_cache.Load(path), 3);
+  auto& conv_cache =
+      autotune_cache.GetConv(phi::autotune::AlgorithmType::kConvBackwardData);
+  EXPECT_EQ(conv_cache.Size(), 1);
+  EXPECT_EQ(conv_cache.Find(key), true);
+  auto result = conv_cache.Get(key);
+  EXPECT_EQ(result.algo, 2);
+  EXPECT_EQ(result.workspace_size, 1024UL);
+  EXPECT_EQ(result.exhaustive_search, true);
+  auto& transpose_cache =
+      autotune_cache.Get(phi::autotune::AlgorithmType::kTranspose);
+  EXPECT_EQ(transpose_cache.Find(123), true);
+  EXPECT_EQ(transpose_cache.Get(123), 1);
+  EXPECT_EQ(autotune_cache.GetMatmul().Find(456), true);
+  EXPECT_EQ(autotune_cache.GetMatmul().Get(456), 3);
+
+  autotune_cache.Clean();
+  std::remove(path.c_str());
+  std::remove((path + ".lock").c_str());
+}
@@ -0,0 +1,66 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/kernels/funcs/fc_functor.h"
+#include "paddle/phi/kernels/funcs/packed_weights_cache.h"
+
+namespace phi {
+namespace tests {
+
+#ifdef PADDLE_WITH_MKLML
+TEST(PackedWeightsCache, fc_packed_weights) {
+  auto* dev_ctx =
+      phi::DeviceContextPool::Instance().GetByPlace(phi::CPUPlace());
+  const int M = 3, N = 5, K = 7;
+  phi::DenseTensor x, w;
+  x.Resize({M, K});
+  w.Resize({K, N});
+  float* x_data = dev_ctx->template Alloc<float>(&x);
+  float* w_data = dev_ctx->template Alloc<float>(&w);
+  for (int i = 0; i < M * K; ++i) {
+    x_data[i] = static_cast<float>(i % 5) - 2.f;
+  }
+  for (int i = 0; i < K * N; ++i) {
+    w_data[i] = static_cast<float>(i % 3) * 0.5f;
+  }
+  std::vector<float> bias(N, 1.f);
+
+  phi::funcs::FCFunctor<phi::CPUContext, float> fc;
+  std::vector<float> expected(M * N);
+  fc(*dev_ctx, M, N, K, x_data, w_data, expected.data(), bias.data(), true);
+
+  auto& cache = phi::funcs::PackedWeightsCache<float>::Instance();
+  EXPECT_EQ(cache.Find(w_data, N, K), nullptr);
+  cache.Pack(*dev_ctx, w);
+  EXPECT_NE(cache.Find(w_data, N, K), nullptr);
+  EXPECT_EQ(cache.Find(w_data, K, N), nullptr);
+
+  std::vector<float> out(M * N);
+  fc(*dev_ctx, M, N, K, x_data, w_data, out.data(), bias.data(), true);
+  for (int i = 0; i < M * N; ++i) {
+    EXPECT_NEAR(out[i], expected[i], 1e-5);
+  }
+
+  // the packed weight goes with the tensor
+  w = phi::DenseTensor();
+  EXPECT_EQ(cache.Find(w_data, N, K), nullptr);
+}
+#endif
+
+}  // namespace tests
+}  // namespace phi
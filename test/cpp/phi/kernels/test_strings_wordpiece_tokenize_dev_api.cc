@@ -0,0 +1,101 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/api/lib/utils/allocator.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/pstring.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/string_tensor.h"
+#include "paddle/phi/infermeta/strings/binary.h"
+#include "paddle/phi/kernels/strings/strings_wordpiece_tokenize_kernel.h"
+
+namespace phi {
+namespace tests {
+
+using DDim = phi::DDim;
+using pstring = ::phi::dtype::pstring;
+
+TEST(DEV_API, strings_wordpiece_tokenize) {
+  phi::DeviceContextPool& pool = phi::DeviceContextPool::Instance();
+  auto* dev_ctx = static_cast<phi::CPUContext*>(pool.Get(phi::CPUPlace()));
+  const auto string_allocator =
+      std::make_unique<paddle::experimental::DefaultAllocator>(phi::CPUPlace());
+  const auto alloc = string_allocator.get();
+
+  // 1. create tensors
+  std::vector<std::string> tokens = {"[PAD]",
+                                     "[UNK]",
+                                     "hello",
+                                     "world",
+                                     "##s",
+                                     "un",
+                                     "##aff",
+                                     "##able",
+                                     "!",
+                                     "中",
+                                     "wor",
+                                     "##ld",
+                                     "ó"};
+  StringTensor vocab(alloc,
+                     StringTensorMeta({static_cast<int64_t>(tokens.size())}));
+  pstring* vocab_data = dev_ctx->template Alloc<pstring>(&vocab);
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    vocab_data[i] = tokens[i];
+  }
+
+  StringTensor x(alloc, StringTensorMeta({3}));
+  pstring* x_data = dev_ctx->template Alloc<pstring>(&x);
+  x_data[0] = "Hello  worlds!\tUnaffable";
+  x_data[1] = "中中 Ó worldld xyz";
+  x_data[2] = "hello world world world world world world world world";
+
+  // 2. tokenize
+  const int max_seq_len = 8;
+  DenseTensor input_ids;
+  DenseTensor seq_lens;
+  MetaTensor meta_ids(&input_ids);
+  MetaTensor meta_lens(&seq_lens);
+  phi::strings::WordpieceTokenizeInferMeta(
+      MetaTensor(x), MetaTensor(vocab), max_seq_len, &meta_ids, &meta_lens);
+  phi::strings::StringsWordpieceTokenizeKernel(
+      *dev_ctx, x, vocab, true, max_seq_len, 1, 0, &input_ids, &seq_lens);
+
+  // 3. check results
+  ASSERT_EQ(input_ids.dims(), common::make_ddim({3, max_seq_len}));
+  ASSERT_EQ(seq_lens.dims(), common::make_ddim({3}));
+  // the punctuations and the chinese chars are single words, xyz is unknown
+  // and the last text is truncated
+  std::vector<std::vector<int64_t>> expected_ids = {
+      {2, 3, 4, 8, 5, 6, 7, 0},
+      {9, 9, 12, 3, 11, 1, 0, 0},
+      {2, 3, 3, 3, 3, 3, 3, 3},
+  };
+  std::vector<int> expected_lens = {7, 6, 8};
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(seq_lens.data<int>()[i], expected_lens[i]);
+    for (int j = 0; j < max_seq_len; ++j) {
+      ASSERT_EQ(input_ids.data<int64_t>()[i * max_seq_len + j],
+                expected_ids[i][j]);
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
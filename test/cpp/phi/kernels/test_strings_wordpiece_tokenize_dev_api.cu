@@ -0,0 +1,117 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/pstring.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/string_tensor.h"
+#include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/infermeta/strings/binary.h"
+#include "paddle/phi/kernels/strings/strings_copy_kernel.h"
+#include "paddle/phi/kernels/strings/strings_empty_kernel.h"
+#include "paddle/phi/kernels/strings/strings_wordpiece_tokenize_kernel.h"
+
+namespace phi {
+namespace tests {
+
+using pstring = ::phi::dtype::pstring;
+using phi::CPUPlace;
+using phi::GPUPlace;
+
+TEST(DEV_API, strings_wordpiece_tokenize) {
+  phi::DeviceContextPool& pool = phi::DeviceContextPool::Instance();
+  GPUContext* dev_ctx = reinterpret_cast<GPUContext*>(pool.Get(GPUPlace()));
+  CPUContext* cpu_ctx = reinterpret_cast<CPUContext*>(pool.Get(CPUPlace()));
+
+  // 1. create tensors
+  std::vector<std::string> tokens = {"[PAD]",
+                                     "[UNK]",
+                                     "hello",
+                                     "world",
+                                     "##s",
+                                     "un",
+                                     "##aff",
+                                     "##able",
+                                     "!",
+                                     "中",
+                                     "wor",
+                                     "##ld",
+                                     "ó"};
+  StringTensorMeta vocab_meta({static_cast<int64_t>(tokens.size())});
+  StringTensor cpu_vocab = phi::strings::Empty(*cpu_ctx, std::move(vocab_meta));
+  StringTensor gpu_vocab = phi::strings::Empty(*dev_ctx, std::move(vocab_meta));
+  pstring* vocab_data = cpu_ctx->template Alloc<pstring>(&cpu_vocab);
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    vocab_data[i] = tokens[i];
+  }
+  phi::strings::Copy(*dev_ctx, cpu_vocab, false, &gpu_vocab);
+
+  StringTensorMeta x_meta({3});
+  StringTensor cpu_x = phi::strings::Empty(*cpu_ctx, std::move(x_meta));
+  StringTensor gpu_x = phi::strings::Empty(*dev_ctx, std::move(x_meta));
+  pstring* x_data = cpu_ctx->template Alloc<pstring>(&cpu_x);
+  x_data[0] = "Hello  worlds!\tUnaffable";
+  x_data[1] = "中中 Ó worldld xyz";
+  x_data[2] = "hello world world world world world world world world";
+  phi::strings::Copy(*dev_ctx, cpu_x, false, &gpu_x);
+
+  // 2. tokenize
+  const int max_seq_len = 8;
+  DenseTensor input_ids;
+  DenseTensor seq_lens;
+  MetaTensor meta_ids(&input_ids);
+  MetaTensor meta_lens(&seq_lens);
+  phi::strings::WordpieceTokenizeInferMeta(MetaTensor(gpu_x),
+                                           MetaTensor(gpu_vocab),
+                                           max_seq_len,
+                                           &meta_ids,
+                                           &meta_lens);
+  phi::strings::StringsWordpieceTokenizeKernel(*dev_ctx,
+                                               gpu_x,
+                                               gpu_vocab,
+                                               true,
+                                               max_seq_len,
+                                               1,
+                                               0,
+                                               &input_ids,
+                                               &seq_lens);
+  DenseTensor cpu_ids;
+  DenseTensor cpu_lens;
+  phi::Copy(*dev_ctx, input_ids, CPUPlace(), true, &cpu_ids);
+  phi::Copy(*dev_ctx, seq_lens, CPUPlace(), true, &cpu_lens);
+
+  // 3. check results, the same as the ones of the cpu kernel
+  std::vector<std::vector<int64_t>> expected_ids = {
+      {2, 3, 4, 8, 5, 6, 7, 0},
+      {9, 9, 12, 3, 11, 1, 0, 0},
+      {2, 3, 3, 3, 3, 3, 3, 3},
+  };
+  std::vector<int> expected_lens = {7, 6, 8};
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(cpu_lens.data<int>()[i], expected_lens[i]);
+    for (int j = 0; j < max_seq_len; ++j) {
+      ASSERT_EQ(cpu_ids.data<int64_t>()[i * max_seq_len + j],
+                expected_ids[i][j]);
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
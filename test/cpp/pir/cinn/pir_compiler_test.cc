@@ -26,6 +26,7 @@
 #include "paddle/cinn/hlir/dialect/runtime/ir/jit_kernel_op.h"
 #include "paddle/cinn/hlir/dialect/runtime/ir/runtime_dialect.h"
 #include "paddle/cinn/hlir/framework/pir_compiler.h"
+#include "paddle/cinn/runtime/flags.h"
 #include "paddle/cinn/utils/data_util.h"
 #include "paddle/fluid/framework/new_executor/interpretercore.h"
 #include "paddle/fluid/pir/dialect/kernel/ir/kernel_dialect.h"
@@ -37,6 +38,8 @@
 #include "paddle/pir/core/ir_context.h"
 #include "paddle/pir/core/program.h"
 
+PD_DECLARE_int32(cinn_compile_batch_size);
+
 using cinn::hlir::framework::pir::Group;
 using cinn::hlir::framework::pir::GroupPtr;
 
@@ -274,6 +277,26 @@ TEST(PirCompier, CompileGroupOps) {
   }
 }
 
+TEST(PirCompier, CompileGroupOpsInBatches) {
+  auto prog_info = BuildProgram();
+  std::shared_ptr<::pir::Program> program = std::get<0>(prog_info);
+  std::vector<GroupPtr> groups = std::get<1>(prog_info);
+  ASSERT_GT(groups.size(), 1u);
+
+  auto target = cinn::common::DefaultNVGPUTarget();
+  auto scope = cinn::hlir::framework::BuildScope(target, *program);
+
+  // every group is compiled in its own module
+  const int batch_size = FLAGS_cinn_compile_batch_size;
+  FLAGS_cinn_compile_batch_size = 1;
+  cinn::hlir::framework::PirCompiler ir_compiler(*program, target, scope);
+  auto runtime_program = ir_compiler.Build(groups);
+  FLAGS_cinn_compile_batch_size = batch_size;
+
+  ASSERT_EQ(runtime_program->size(), groups.size());
+  ASSERT_NO_THROW(runtime_program->Execute());
+}
+
 TEST(RuntimeDialect, CompilerAndRun) {
   // Step 1: Construct pir::Program
   auto prog_info = BuildProgram();
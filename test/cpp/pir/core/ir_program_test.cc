@@ -14,7 +14,9 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <sstream>
+#include <unordered_map>
 
 #include "paddle/fluid/pir/dialect/operator/interface/op_yaml_info.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
@@ -289,3 +291,77 @@ TEST(program_test, builder) {
   EXPECT_EQ(program.block()->size() == 2, true);
   EXPECT_EQ(constant.value().dyn_cast<pir::Int32Attribute>().data() == 2, true);
 }
+
+// Build a chain of num_ops ops in program, i.e. the slices of the combines of
+// the last value and a constant, and return the time in seconds.
+double BuildChainProgram(pir::Program *program, int num_ops) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  auto start = std::chrono::steady_clock::now();
+  pir::OperationArena::Guard guard(program->arena());
+  pir::Builder builder(ctx, program->block());
+  pir::Type fp32_dtype = pir::Float32Type::get(ctx);
+  pir::Value last = builder
+                        .Build<pir::ConstantOp>(
+                            pir::FloatAttribute::get(ctx, 1.0), fp32_dtype)
+                        .out();
+  for (int i = 1; i < num_ops; i += 2) {
+    auto combine = builder.Build<pir::CombineOp>(std::vector<pir::Value>{last});
+    last = builder.Build<pir::SliceOp>(combine.out(), 0).result(0);
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Recreate the ops of src in dst, and return the time in seconds.
+double CloneChainProgram(pir::Program *src, pir::Program *dst) {
+  auto start = std::chrono::steady_clock::now();
+  pir::OperationArena::Guard guard(dst->arena());
+  std::unordered_map<pir::Value, pir::Value> value_map;
+  for (auto &op : *src->block()) {
+    std::vector<pir::Value> inputs;
+    for (uint32_t i = 0; i < op.num_operands(); ++i) {
+      inputs.push_back(value_map.at(op.operand_source(i)));
+    }
+    std::vector<pir::Type> output_types;
+    for (uint32_t i = 0; i < op.num_results(); ++i) {
+      output_types.push_back(op.result(i).type());
+    }
+    auto *new_op = pir::Operation::Create(
+        inputs, op.attributes(), output_types, op.info());
+    dst->block()->push_back(new_op);
+    for (uint32_t i = 0; i < op.num_results(); ++i) {
+      value_map[op.result(i)] = new_op->result(i);
+    }
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+TEST(program_test, arena_benchmark) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  const int kNumOps = 100000;
+  for (bool use_arena : {false, true}) {
+    double build_time = 0, clone_time = 0, destroy_time = 0;
+    {
+      auto program = std::make_unique<pir::Program>(ctx, use_arena);
+      auto cloned = std::make_unique<pir::Program>(ctx, use_arena);
+      EXPECT_EQ(program->arena() != nullptr, use_arena);
+      build_time = BuildChainProgram(program.get(), kNumOps);
+      clone_time = CloneChainProgram(program.get(), cloned.get());
+      EXPECT_EQ(program->block()->size(), cloned->block()->size());
+      EXPECT_EQ(program->block()->size(), static_cast<size_t>(kNumOps));
+
+      auto start = std::chrono::steady_clock::now();
+      cloned.reset();
+      program.reset();
+      destroy_time = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    }
+    LOG(INFO) << "Build, clone and destroy a program of " << kNumOps
+              << " ops " << (use_arena ? "with" : "without")
+              << " arena in " << build_time << ", " << clone_time << " and "
+              << destroy_time << " seconds";
+  }
+}
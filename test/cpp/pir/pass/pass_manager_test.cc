@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include "glog/logging.h"
 
 // NOTE(zhangbo9674): File pd_op.h is generated by op_gen.py, see details in
@@ -20,6 +21,7 @@
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
 
 #include "paddle/fluid/pir/dialect/operator/interface/op_yaml_info.h"
+#include "paddle/fluid/pir/dialect/operator/ir/control_flow_op.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
 #include "paddle/fluid/pir/dialect/operator/utils/utils.h"
@@ -31,6 +33,8 @@
 #include "paddle/pir/core/ir_context.h"
 #include "paddle/pir/core/op_base.h"
 #include "paddle/pir/core/operation.h"
+#include "paddle/pir/dialect/control_flow/ir/cf_dialect.h"
+#include "paddle/pir/dialect/control_flow/ir/cf_op.h"
 #include "paddle/pir/pass/pass.h"
 #include "paddle/pir/pass/pass_manager.h"
 
@@ -230,3 +234,52 @@ TEST(pass_manager, PassManager) {
 
   CHECK_EQ(pm.Run(&program), true);
 }
+
+class TestCountIfOpPass : public pir::Pass {
+ public:
+  TestCountIfOpPass() : pir::Pass("TestCountIfOpPass", 1) {}
+
+  void Run(pir::Operation *op) override {
+    auto if_op = op->dyn_cast<paddle::dialect::IfOp>();
+    num_ops += if_op.true_block().size() + if_op.false_block().size();
+  }
+
+  bool CanApplyOn(pir::Operation *op) const override {
+    return op->isa<paddle::dialect::IfOp>();
+  }
+
+  bool IsThreadSafe() const override { return true; }
+
+  static std::atomic<int> num_ops;
+};
+
+std::atomic<int> TestCountIfOpPass::num_ops{0};
+
+TEST(pass_manager, ParallelRun) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::ControlFlowDialect>();
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+
+  auto cond = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{1}, true, phi::DataType::BOOL);
+  const int kNumIfOps = 16;
+  for (int i = 0; i < kNumIfOps; ++i) {
+    builder.SetInsertionPointToEnd(program.block());
+    auto if_op = builder.Build<paddle::dialect::IfOp>(
+        cond.out(), std::vector<pir::Type>{builder.bool_type()});
+    for (auto *block : {&if_op.true_block(), &if_op.false_block()}) {
+      builder.SetInsertionPointToStart(block);
+      auto full_op = builder.Build<paddle::dialect::FullOp>(
+          std::vector<int64_t>{2}, true, phi::DataType::BOOL);
+      builder.Build<pir::YieldOp>(std::vector<pir::Value>{full_op.out()});
+    }
+  }
+
+  pir::PassManager pm(ctx);
+  pm.AddPass(std::make_unique<TestCountIfOpPass>());
+  pm.EnableParallelRun(4);
+  CHECK_EQ(pm.Run(&program), true);
+  EXPECT_EQ(TestCountIfOpPass::num_ops, kNumIfOps * 4);
+}
@@ -152,3 +152,57 @@ TEST(DrrTest, AttentionFuse) {
   CHECK_EQ(pm.Run(&program), true);
   EXPECT_EQ(program.block()->size(), 20u);
 }
+
+void BuildFlashAttnProgram(pir::Builder &builder) {  // NOLINT
+  std::vector<pir::Value> qkv;
+  for (int i = 0; i < 3; ++i) {
+    paddle::dialect::FullOp full = builder.Build<paddle::dialect::FullOp>(
+        std::vector<int64_t>{2, 128, 8, 64},
+        1.0,
+        phi::DataType::FLOAT16,
+        phi::CPUPlace());
+    paddle::dialect::TransposeOp transpose =
+        builder.Build<paddle::dialect::TransposeOp>(
+            full.out(), std::vector<int>{0, 2, 1, 3});
+    qkv.push_back(transpose.out());
+  }
+
+  paddle::dialect::ScaleOp scale_op =
+      builder.Build<paddle::dialect::ScaleOp>(qkv[0], 0.125, 0.0, true);
+  paddle::dialect::MatmulOp matmul_qk =
+      builder.Build<paddle::dialect::MatmulOp>(
+          scale_op.out(), qkv[1], false, true);
+  paddle::dialect::SoftmaxOp softmax_op =
+      builder.Build<paddle::dialect::SoftmaxOp>(matmul_qk.out(), -1);
+  paddle::dialect::MatmulOp matmul_pv =
+      builder.Build<paddle::dialect::MatmulOp>(
+          softmax_op.out(), qkv[2], false, false);
+  paddle::dialect::TransposeOp transpose_out =
+      builder.Build<paddle::dialect::TransposeOp>(matmul_pv.out(),
+                                                  std::vector<int>{0, 2, 1, 3});
+
+  builder.Build<paddle::dialect::FetchOp>(transpose_out.out(), "out", 0);
+}
+
+TEST(DrrTest, FlashAttnFuse) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+  BuildFlashAttnProgram(builder);
+  EXPECT_EQ(program.block()->size(), 13u);
+
+  pir::PassManager pm(ctx);
+  pm.AddPass(pir::CreateAttentionFusePass());
+  pm.EnableIRPrinting();
+
+  CHECK_EQ(pm.Run(&program), true);
+  // the fulls of q, k and v, flash_attn and fetch
+  EXPECT_EQ(program.block()->size(), 5u);
+  size_t flash_attn_num = 0;
+  for (auto &op : *program.block()) {
+    flash_attn_num += op.isa<paddle::dialect::FlashAttnOp>() ? 1 : 0;
+  }
+  EXPECT_EQ(flash_attn_num, 1u);
+}
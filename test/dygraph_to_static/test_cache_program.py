@@ -185,5 +185,26 @@ class TestToOutputWithCache(Dy2StTestBase):
         self.assertEqual(ret.numpy(), 5050)
 
 
+
+class TestInterpreterCoreCacheCapacity(Dy2StTestBase):
+    def setUp(self):
+        paddle.set_flags({'FLAGS_dy2st_interpretercore_cache_capacity': 1})
+
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_dy2st_interpretercore_cache_capacity': 0})
+
+    def test_alternate_shapes(self):
+        def func(x):
+            return paddle.nn.functional.relu(x) * 2.0
+
+        static_func = paddle.jit.to_static(func)
+        # every shape has a program, whose interpretercore evicts the others
+        for _ in range(3):
+            for shape in [[2, 3], [4, 5]]:
+                x = paddle.randn(shape)
+                np.testing.assert_allclose(
+                    static_func(x).numpy(), func(x).numpy(), rtol=1e-6
+                )
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,57 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+
+
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda(), "only support the plans of cufft"
+)
+class TestFFTPlanCache(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        paddle.set_device('gpu')
+        # Less plans than the sizes, so that the plans are evicted and
+        # created again.
+        paddle.set_flags({'FLAGS_fft_plan_cache_max_size': 2})
+
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_fft_plan_cache_max_size': 1024})
+        paddle.enable_static()
+
+    def check_ffts(self):
+        for n in [16, 24, 31, 64, 100, 16, 31]:
+            x = np.random.random([3, n]).astype('float32')
+            out = paddle.fft.rfft(paddle.to_tensor(x))
+            np.testing.assert_allclose(
+                out.numpy(), np.fft.rfft(x), rtol=1e-4, atol=1e-4
+            )
+
+    def test_evict(self):
+        self.check_ffts()
+
+    def test_streams(self):
+        self.check_ffts()
+        stream = paddle.device.cuda.Stream()
+        with paddle.device.cuda.stream_guard(stream):
+            self.check_ffts()
+        stream.synchronize()
+
+
+if __name__ == '__main__':
+    unittest.main()
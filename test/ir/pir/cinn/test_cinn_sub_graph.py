@@ -17,6 +17,7 @@ import unittest
 import numpy as np
 
 import paddle
+from paddle.jit.dy2static import pir_partial_program
 
 
 def apply_to_static(net, use_cinn):
@@ -153,6 +154,32 @@ class TestCinnSubGraphBase(unittest.TestCase):
         np.testing.assert_allclose(cinn_out.numpy(), dy_out.numpy(), atol=1e-8)
 
 
+class TestCinnCompileAsync(TestCinnSubGraphBase):
+    def setUp(self):
+        super().setUp()
+        paddle.set_flags({'FLAGS_cinn_compile_async': True})
+
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_cinn_compile_async': False})
+
+    def test_eval(self):
+        dy_out = self.eval(use_cinn=False)
+        paddle.seed(2022)
+        net = apply_to_static(CINNSubGraphNet(), use_cinn=True)
+        net.eval()
+        # the runs before the compilation finishes fall back to the program
+        # without CINN
+        for _ in range(3):
+            out = net(self.x)
+            np.testing.assert_allclose(out.numpy(), dy_out.numpy(), atol=1e-8)
+        # the compilations are done in order on the background thread
+        pir_partial_program._cinn_compile_executor().submit(
+            lambda: None
+        ).result()
+        out = net(self.x)
+        np.testing.assert_allclose(out.numpy(), dy_out.numpy(), atol=1e-8)
+
+
 class TestCinnSoftmax(TestCinnSubGraphBase):
     def train(self, use_cinn):
         paddle.seed(2022)
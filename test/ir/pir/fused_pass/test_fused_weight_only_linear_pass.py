@@ -98,5 +98,62 @@ class TestFusedWeightOnlyLinearPass_Fp16(TestFusedWeightOnlyLinearPass_Fp32):
         self.dtype = 'float16'
 
 
+class TestFusedWeightOnlyLinearGeluPass_Fp16(
+    TestFusedWeightOnlyLinearPass_Fp32
+):
+    def build_ir_progam(self):
+        pir_program = None
+        with paddle.pir_utils.IrGuard():
+            pir_program = paddle.static.Program()
+            with paddle.pir.core.program_guard(pir_program):
+                x = paddle.static.data(
+                    name='x', shape=[3, 64, 128], dtype=self.dtype
+                )
+                w = paddle.static.data(
+                    name="w", shape=[128, 64], dtype=self.dtype
+                )
+                bias_ = paddle.static.data(
+                    name="bias", shape=[64], dtype=self.dtype
+                )
+                bias = paddle.assign(bias_)
+                res1 = paddle.matmul(x=x, y=w)
+                res2 = paddle.add(res1, bias)
+                out = paddle.nn.functional.gelu(res2)
+
+        self.pass_list = ['fused_weight_only_linear_pass']
+        self.feeds = {
+            "x": np.random.random((3, 64, 128)).astype(self.dtype),
+            "w": np.random.random((128, 64)).astype(self.dtype),
+            "bias": np.random.random(64).astype(self.dtype),
+        }
+        self.fetch_list = [out]
+        self.valid_op_map = {
+            "pd_op.weight_only_linear": 1,
+            "pd_op.weight_quantize": 1,
+            "pd_op.matmul": 0,
+            "pd_op.add": 0,
+            "pd_op.gelu": 0,
+        }
+        return pir_program
+
+    def setUp(self):
+        self.place_runtime = "gpu"
+        self.dtype = 'float16'
+        paddle.set_flags(
+            {
+                'FLAGS_fused_weight_only_linear_weight_dtype': 'int4',
+                'FLAGS_fused_weight_only_linear_group_size': 64,
+            }
+        )
+
+    def tearDown(self):
+        paddle.set_flags(
+            {
+                'FLAGS_fused_weight_only_linear_weight_dtype': 'int8',
+                'FLAGS_fused_weight_only_linear_group_size': -1,
+            }
+        )
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,150 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+from pass_test import PassTest
+
+import paddle
+from paddle.base import core
+
+np.random.seed(2024)
+
+
+def static_quant(x, scale):
+    return paddle.cast(paddle.clip(paddle.round(x * scale), -127, 127), 'int8')
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestRmsNormStaticQuantFusePass(PassTest):
+    def is_program_valid(self, program):
+        return True
+
+    def build_ir_progam(self):
+        with paddle.pir_utils.IrGuard():
+            pir_program = paddle.static.Program()
+            with paddle.pir.core.program_guard(pir_program):
+                x = paddle.static.data(
+                    name='x', shape=[8, 256], dtype='float16'
+                )
+                residual = paddle.static.data(
+                    name='residual', shape=[8, 256], dtype='float16'
+                )
+                w = paddle.static.data(name='w', shape=[256], dtype='float16')
+                (
+                    out,
+                    residual_out,
+                ) = paddle.incubate.nn.functional.fused_rms_norm(
+                    x, w, None, 1e-6, 1, residual=residual
+                )
+                quant_out = static_quant(out, 20.0)
+
+        self.pass_list = ['norm_quant_fuse_pass']
+        self.fetch_list = [quant_out, residual_out]
+        self.valid_op_map = {
+            "pd_op.rms_norm": 1,
+            "pd_op.scale": 0,
+            "pd_op.round": 0,
+            "pd_op.clip": 0,
+            "pd_op.cast": 0,
+        }
+        return pir_program
+
+    def setUp(self):
+        self.place_runtime = "gpu"
+
+    def sample_program(self):
+        yield self.build_ir_progam(), False
+
+    def test_check_output(self):
+        self.check_pass_correct()
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestLayerNormStaticQuantFusePass(TestRmsNormStaticQuantFusePass):
+    def build_ir_progam(self):
+        with paddle.pir_utils.IrGuard():
+            pir_program = paddle.static.Program()
+            with paddle.pir.core.program_guard(pir_program):
+                x = paddle.static.data(
+                    name='x', shape=[8, 256], dtype='float16'
+                )
+                residual = paddle.static.data(
+                    name='residual', shape=[8, 256], dtype='float16'
+                )
+                w = paddle.static.data(name='w', shape=[256], dtype='float16')
+                b = paddle.static.data(name='b', shape=[256], dtype='float16')
+                (
+                    out,
+                    residual_out,
+                ) = paddle.incubate.nn.functional.fused_layer_norm(
+                    x, w, b, 1e-5, begin_norm_axis=1, residual=residual
+                )
+                quant_out = static_quant(out, 20.0)
+
+        self.pass_list = ['norm_quant_fuse_pass']
+        self.fetch_list = [quant_out, residual_out]
+        self.valid_op_map = {
+            "pd_op.fused_bias_residual_layernorm": 1,
+            "pd_op.scale": 0,
+            "pd_op.round": 0,
+            "pd_op.clip": 0,
+            "pd_op.cast": 0,
+        }
+        return pir_program
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestRmsNormPerTokenQuantFusePass(TestRmsNormStaticQuantFusePass):
+    def build_ir_progam(self):
+        with paddle.pir_utils.IrGuard():
+            pir_program = paddle.static.Program()
+            with paddle.pir.core.program_guard(pir_program):
+                x = paddle.static.data(
+                    name='x', shape=[2, 8, 256], dtype='float16'
+                )
+                w = paddle.static.data(name='w', shape=[256], dtype='float16')
+                out = paddle.incubate.nn.functional.fused_rms_norm(
+                    x, w, None, 1e-6, 2
+                )
+                abs_max = paddle.max(paddle.abs(out), axis=-1, keepdim=True)
+                quant_out = paddle.cast(
+                    paddle.clip(
+                        paddle.round(out * 127.0 / abs_max), -127, 127
+                    ),
+                    'int8',
+                )
+                dequant_scale = abs_max / 127.0
+
+        self.pass_list = ['norm_quant_fuse_pass']
+        self.fetch_list = [quant_out, dequant_scale]
+        self.valid_op_map = {
+            "pd_op.fused_rms_norm_quant": 1,
+            "pd_op.rms_norm": 0,
+            "pd_op.max": 0,
+            "pd_op.divide": 0,
+            "pd_op.cast": 0,
+        }
+        return pir_program
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,68 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+
+paddle.enable_static()
+
+
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda(), "only support the cond on gpu"
+)
+class TestIfSelectOnDevice(unittest.TestCase):
+    def setUp(self):
+        paddle.set_flags({'FLAGS_pir_if_select_on_device_max_ops': 8})
+
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_pir_if_select_on_device_max_ops': 0})
+
+    def run_cond(self, x_feed, y_feed):
+        new_scope = paddle.static.Scope()
+        main_program = paddle.static.Program()
+        with paddle.static.scope_guard(new_scope):
+            with paddle.static.program_guard(main_program):
+                x = paddle.static.data('x', [2, 3], dtype='float32')
+                y = paddle.static.data('y', [2, 3], dtype='float32')
+                pred = paddle.sum(x) > paddle.sum(y)
+                out = paddle.static.nn.cond(
+                    pred,
+                    lambda: paddle.scale(x, scale=2.0) + y,
+                    lambda: paddle.nn.functional.relu(y - x),
+                )
+
+                exe = paddle.static.Executor(paddle.CUDAPlace(0))
+                (out_value,) = exe.run(
+                    feed={'x': x_feed, 'y': y_feed}, fetch_list=[out]
+                )
+                return out_value
+
+    def test_select(self):
+        x_feed = np.random.random([2, 3]).astype('float32')
+        y_feed = np.random.random([2, 3]).astype('float32')
+        for x_value, y_value in [(x_feed + 1, y_feed), (x_feed, y_feed + 1)]:
+            if x_value.sum() > y_value.sum():
+                expected = x_value * 2.0 + y_value
+            else:
+                expected = np.maximum(y_value - x_value, 0)
+            np.testing.assert_allclose(
+                self.run_cond(x_value, y_value), expected, rtol=1e-6
+            )
+
+
+if __name__ == "__main__":
+    unittest.main()
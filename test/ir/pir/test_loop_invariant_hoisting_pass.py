@@ -0,0 +1,81 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+
+paddle.enable_static()
+
+
+class TestLoopInvariantHoistingPass(unittest.TestCase):
+    def setUp(self):
+        paddle.set_flags({'FLAGS_pir_apply_loop_invariant_hoisting_pass': True})
+
+    def tearDown(self):
+        paddle.set_flags(
+            {'FLAGS_pir_apply_loop_invariant_hoisting_pass': False}
+        )
+
+    def run_while_loop(self, x_feed, w_feed, loop_num):
+        new_scope = paddle.static.Scope()
+        main_program = paddle.static.Program()
+        with paddle.static.scope_guard(new_scope):
+            with paddle.static.program_guard(main_program):
+                x = paddle.static.data('x', [2, 2], dtype='float32')
+                w = paddle.static.data('w', [2, 2], dtype='float32')
+                i = paddle.full([1], 0, dtype='int64')
+                n = paddle.full([1], loop_num, dtype='int64')
+
+                def cond(i, state):
+                    return i < n
+
+                def body(i, state):
+                    # The scaled weight is the same in every iteration, and
+                    # the state of the matmul is passed to the next iteration.
+                    scaled_w = paddle.scale(w, scale=0.5)
+                    state = paddle.matmul(state, scaled_w)
+                    return i + 1, state
+
+                _, state = paddle.static.nn.while_loop(cond, body, [i, x])
+
+                exe = paddle.static.Executor()
+                outs = []
+                for _ in range(2):
+                    (state_value,) = exe.run(
+                        feed={'x': x_feed, 'w': w_feed}, fetch_list=[state]
+                    )
+                    outs.append(state_value)
+                return outs
+
+    def test_while_loop(self):
+        x_feed = np.random.random([2, 2]).astype('float32')
+        w_feed = np.random.random([2, 2]).astype('float32')
+        expected = x_feed
+        for _ in range(5):
+            expected = np.matmul(expected, w_feed * 0.5)
+        for state_value in self.run_while_loop(x_feed, w_feed, 5):
+            np.testing.assert_allclose(state_value, expected, rtol=1e-5)
+
+    def test_while_loop_no_iteration(self):
+        x_feed = np.random.random([2, 2]).astype('float32')
+        w_feed = np.random.random([2, 2]).astype('float32')
+        for state_value in self.run_while_loop(x_feed, w_feed, 0):
+            np.testing.assert_allclose(state_value, x_feed)
+
+
+if __name__ == "__main__":
+    unittest.main()
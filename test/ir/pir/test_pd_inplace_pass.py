@@ -42,6 +42,38 @@ class TestPdInplacePass(unittest.TestCase):
                     True,
                 )
 
+    def test_while_loop_inplace(self):
+        new_scope = paddle.static.Scope()
+        main_program = paddle.static.Program()
+        with paddle.static.scope_guard(new_scope):
+            with paddle.static.program_guard(main_program):
+                x = paddle.static.data('x', [2, 2], dtype='float32')
+                y = paddle.scale(x, scale=1.0)
+                i = paddle.full([1], 0, dtype='int64')
+                n = paddle.full([1], 3, dtype='int64')
+
+                def cond(i, state):
+                    return i < n
+
+                def body(i, state):
+                    state = paddle.scale(state, scale=2.0)
+                    state = paddle.nn.functional.relu(state)
+                    return i + 1, state
+
+                _, state = paddle.static.nn.while_loop(cond, body, [i, y])
+                # y is used after the loop, so that the loop can't update it
+                # in place
+                out = paddle.add(y, state)
+
+                exe = paddle.static.Executor()
+                x_feed = np.ones([2, 2], dtype=np.float32)
+                for _ in range(2):
+                    state_value, out_value = exe.run(
+                        feed={'x': x_feed}, fetch_list=[state, out]
+                    )
+                    np.testing.assert_allclose(state_value, x_feed * 8)
+                    np.testing.assert_allclose(out_value, x_feed * 9)
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -16,6 +16,8 @@ import os
 import tempfile
 import unittest
 
+import numpy as np
+
 import paddle
 from paddle.inference import (
     PlaceType,
@@ -84,6 +86,27 @@ class TestConvertToMixedPrecision(unittest.TestCase):
                     black_list=black_list,
                 )
 
+    def test_convert_to_mixed_precision_by_profile(self):
+        calibration_inputs = [
+            {'x': np.random.random([1, 3, 224, 224]).astype('float32')}
+            for _ in range(2)
+        ]
+        convert_to_mixed_precision(
+            os.path.join(self.temp_dir.name, 'resnet50/inference.pdmodel'),
+            os.path.join(self.temp_dir.name, 'resnet50/inference.pdiparams'),
+            os.path.join(self.temp_dir.name, 'profiled/inference.pdmodel'),
+            os.path.join(self.temp_dir.name, 'profiled/inference.pdiparams'),
+            backend=PlaceType.GPU,
+            mixed_precision=PrecisionType.Half,
+            calibration_inputs=calibration_inputs,
+            accuracy_tolerance=1e-2,
+        )
+        self.assertTrue(
+            os.path.exists(
+                os.path.join(self.temp_dir.name, 'profiled/inference.pdmodel')
+            )
+        )
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,88 @@
+#   Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import time
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+# Benchmark of the reduce_sum kernel over the common shapes of long-row
+# reductions, the time costs with the heuristic split and with the split
+# tuned by the kernel autotune are printed, e.g.
+# >>> reduce_sum global_norm [67108864] axis=None float16:
+# ...     heuristic 0.512 ms, tuned 0.431 ms
+
+# name, shape, axis, dtype
+REDUCE_SHAPES = [
+    ("loss_sum", [64, 1 << 20], None, "float16"),
+    ("global_norm", [1 << 26], None, "float16"),
+    ("few_rows", [8, 1 << 22], -1, "float32"),
+    ("few_rows_fp16", [32, 1 << 20], -1, "float16"),
+    ("reduce_any", [4, 1 << 12, 1024], [1, 2], "float32"),
+    ("first_dim", [1 << 22, 16], 0, "float32"),
+]
+
+
+def timeit_reduce_sum(x, axis, iters):
+    for _ in range(5):
+        paddle.sum(x, axis=axis)
+    paddle.device.synchronize()
+    start = time.time()
+    for _ in range(iters):
+        paddle.sum(x, axis=axis)
+    paddle.device.synchronize()
+    return (time.time() - start) / iters * 1000
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestReduceSumBenchmark(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        self.iters = 100
+
+    def tearDown(self):
+        paddle.incubate.autotune.set_config({"kernel": {"enable": False}})
+
+    def test_timeit_reduce_sum(self):
+        for name, shape, axis, dtype in REDUCE_SHAPES:
+            x = paddle.uniform(shape, min=-1.0, max=1.0).astype(dtype)
+            paddle.incubate.autotune.set_config({"kernel": {"enable": False}})
+            expect = paddle.sum(x, axis=axis).astype("float32").numpy()
+            heuristic = timeit_reduce_sum(x, axis, self.iters)
+
+            paddle.incubate.autotune.set_config(
+                {"kernel": {"enable": True, "tuning_range": [1, 3]}}
+            )
+            # the forward of dygraph does not step the autotune status
+            for _ in range(3):
+                paddle.sum(x, axis=axis)
+                core.update_autotune_status()
+            actual = paddle.sum(x, axis=axis).astype("float32").numpy()
+            tuned = timeit_reduce_sum(x, axis, self.iters)
+
+            print(
+                f"reduce_sum {name} {shape} axis={axis} {dtype}: "
+                f"heuristic {heuristic:.3f} ms, tuned {tuned:.3f} ms"
+            )
+            atol = 1.0 if dtype == "float16" else 1e-2
+            np.testing.assert_allclose(actual, expect, rtol=1e-2, atol=atol)
+
+
+if __name__ == "__main__":
+    unittest.main()
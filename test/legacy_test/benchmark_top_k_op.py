@@ -0,0 +1,74 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import itertools
+import time
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+# Benchmark of the topk kernel over the matrix of (rows, cols, k, dtype),
+# from the batched short rows to the few long rows of the retrieval, the time
+# costs of topk and of the full sort by argsort are printed, e.g.
+# >>> topk rows=4 cols=1048576 k=1000 float32:
+# ...     topk 0.215 ms, argsort 1.873 ms
+
+ROWS_COLS = [(1, 1 << 20), (4, 1 << 20), (64, 1 << 16), (4096, 4096)]
+KS = [16, 128, 1000]
+DTYPES = ["float32", "float16"]
+
+
+def timeit(func, iters):
+    for _ in range(5):
+        func()
+    paddle.device.synchronize()
+    start = time.time()
+    for _ in range(iters):
+        func()
+    paddle.device.synchronize()
+    return (time.time() - start) / iters * 1000
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestTopkBenchmark(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        self.iters = 50
+
+    def test_timeit_topk(self):
+        for (rows, cols), k, dtype in itertools.product(ROWS_COLS, KS, DTYPES):
+            x = paddle.uniform([rows, cols], min=-1.0, max=1.0).astype(dtype)
+            values, _ = paddle.topk(x, k=k)
+            topk = timeit(lambda: paddle.topk(x, k=k), self.iters)
+            argsort = timeit(
+                lambda: paddle.argsort(x, descending=True), self.iters
+            )
+            print(
+                f"topk rows={rows} cols={cols} k={k} {dtype}: "
+                f"topk {topk:.3f} ms, argsort {argsort:.3f} ms"
+            )
+            expect = paddle.sort(x, descending=True)[:, :k]
+            np.testing.assert_array_equal(
+                values.astype("float32").numpy(),
+                expect.astype("float32").numpy(),
+            )
+
+
+if __name__ == "__main__":
+    unittest.main()
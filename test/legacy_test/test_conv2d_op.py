@@ -579,6 +579,17 @@ class TestWithPad(TestConv2DOp):
         self.filter_size = [6, f_c, 3, 3]
 
 
+class TestWithPadPartialTiles(TestConv2DOp):
+    def init_test_case(self):
+        # The output of 11x10 has partial tiles of Winograd F(4x4, 3x3).
+        self.pad = [1, 1]
+        self.stride = [1, 1]
+        self.input_size = [2, 3, 11, 10]  # NCHW
+        assert np.mod(self.input_size[1], self.groups) == 0
+        f_c = self.input_size[1] // self.groups
+        self.filter_size = [6, f_c, 3, 3]
+
+
 class TestWithStride(TestConv2DOp):
     def init_test_case(self):
         self.pad = [1, 1]
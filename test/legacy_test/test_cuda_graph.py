@@ -157,6 +157,33 @@ class TestCUDAGraphInDygraphMode(unittest.TestCase):
             np.testing.assert_array_equal(actual_x, x.numpy())
             np.testing.assert_array_equal(actual_y, y.numpy())
 
+    def test_random_replay(self):
+        if not can_use_cuda_graph():
+            return
+
+        x = paddle.ones([64, 256], dtype='float32')
+
+        def run():
+            noise = paddle.rand([64, 256])
+            out = paddle.nn.functional.dropout(x + noise, p=0.5)
+            return noise, out
+
+        state = paddle.get_cuda_rng_state()
+        expects = [[t.numpy() for t in run()] for _ in range(3)]
+
+        paddle.set_cuda_rng_state(state)
+        graph = CUDAGraph()
+        graph.capture_begin()
+        outs = run()
+        graph.capture_end()
+        paddle.set_cuda_rng_state(state)
+        # the replays draw the numbers of the eager runs one after another
+        for expect in expects:
+            graph.replay()
+            for out, expect_out in zip(outs, expect):
+                np.testing.assert_array_equal(out.numpy(), expect_out)
+        graph.reset()
+
     def test_dev_ctx_alloc(self):
         if not can_use_cuda_graph():
             return
@@ -0,0 +1,82 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import tempfile
+import unittest
+
+import paddle
+from paddle import base
+
+
+class TestDatasetBinarySlot(unittest.TestCase):
+    def setUp(self):
+        paddle.enable_static()
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.text_path = os.path.join(self.temp_dir.name, "slot_a.txt")
+        self.binary_path = os.path.join(self.temp_dir.name, "slot_a.bin")
+        with open(self.text_path, "w") as f:
+            data = ""
+            for i in range(100):
+                data += f"1 id{i} 1 {i + 1} 2 {i + 2} {i + 3} 1 {i % 7 + 1} "
+                data += f"3 {i + 4} {i + 5} {i + 6}\n"
+            f.write(data)
+
+    def tearDown(self):
+        self.temp_dir.cleanup()
+
+    def create_dataset(self, binary_slot_format):
+        slots = ["slot1", "slot2", "slot3", "slot4"]
+        slots_vars = []
+        for slot in slots:
+            var = paddle.static.data(
+                name=slot, shape=[-1, 1], dtype="int64", lod_level=1
+            )
+            slots_vars.append(var)
+        dataset = paddle.distributed.InMemoryDataset()
+        dataset._set_feed_type("SlotRecordInMemoryDataFeed")
+        dataset.init(
+            batch_size=32, thread_num=2, pipe_command="cat", use_var=slots_vars
+        )
+        dataset._init_distributed_settings(
+            parse_ins_id=True, binary_slot_format=binary_slot_format
+        )
+        return dataset, slots_vars
+
+    def test_load_binary(self):
+        main_program = base.Program()
+        with base.program_guard(main_program, base.Program()):
+            text_dataset, slots_vars = self.create_dataset(False)
+            text_dataset.set_filelist([self.text_path])
+            text_dataset.load_into_memory()
+
+            binary_dataset, _ = self.create_dataset(True)
+            ins_num = binary_dataset._convert_to_binary_slot_format(
+                self.text_path, self.binary_path, block_ins_num=16
+            )
+            self.assertEqual(ins_num, 100)
+            binary_dataset.set_filelist([self.binary_path])
+            binary_dataset.load_into_memory()
+            self.assertEqual(
+                binary_dataset.get_memory_data_size(),
+                text_dataset.get_memory_data_size(),
+            )
+
+            exe = base.Executor(base.CPUPlace())
+            exe.run(base.default_startup_program())
+            exe.train_from_dataset(main_program, binary_dataset)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,77 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import gzip
+import os
+import tempfile
+import unittest
+
+import paddle
+from paddle import base
+
+
+class TestDatasetLoadPipeline(unittest.TestCase):
+    def setUp(self):
+        paddle.enable_static()
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.filelist = []
+        for i in range(4):
+            data = ""
+            for j in range(50 * (i + 1)):
+                data += f"1 {j + 1} 2 {j + 2} {j + 3} 1 {i + 1} 1 {j % 5}\n"
+            if i % 2 == 0:
+                path = os.path.join(self.temp_dir.name, f"part-{i}.gz")
+                with gzip.open(path, "wt") as f:
+                    f.write(data)
+            else:
+                path = os.path.join(self.temp_dir.name, f"part-{i}")
+                with open(path, "w") as f:
+                    f.write(data)
+            self.filelist.append(path)
+
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_dataset_load_read_threads': 0})
+        self.temp_dir.cleanup()
+
+    def load(self, read_threads):
+        paddle.set_flags({'FLAGS_dataset_load_read_threads': read_threads})
+        main_program = base.Program()
+        with base.program_guard(main_program, base.Program()):
+            slots_vars = []
+            for slot in ["slot1", "slot2", "slot3", "slot4"]:
+                var = paddle.static.data(
+                    name=slot, shape=[-1, 1], dtype="int64", lod_level=1
+                )
+                slots_vars.append(var)
+            dataset = paddle.distributed.InMemoryDataset()
+            dataset.init(
+                batch_size=32,
+                thread_num=3,
+                pipe_command="cat",
+                use_var=slots_vars,
+            )
+            dataset.set_filelist(self.filelist)
+            dataset.load_into_memory()
+            size = dataset.get_memory_data_size()
+            dataset.release_memory()
+        return size
+
+    def test_load(self):
+        expected = self.load(0)
+        self.assertEqual(expected, 500)
+        self.assertEqual(self.load(2), expected)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,100 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import cv2
+import numpy as np
+
+import paddle
+from paddle.vision.ops import decode_jpeg_batch
+
+
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda(), "decode_jpeg_batch requires CUDA"
+)
+class TestDecodeJpegBatch(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2024)
+        self.shapes = [(400, 300), (256, 320), (128, 128)]
+        self.size = [96, 112]
+        self.images = []
+        self.encoded = []
+        for height, width in self.shapes:
+            # the smooth images keep the jpeg decoders close to each other
+            y, x = np.mgrid[0:height, 0:width]
+            image = np.stack(
+                [x * 255 // width, y * 255 // height, (x + y) % 256], axis=-1
+            ).astype('uint8')
+            encoded = cv2.imencode('.jpg', image)[1].reshape(-1)
+            self.encoded.append(encoded)
+            self.images.append(cv2.imdecode(encoded, cv2.IMREAD_COLOR))
+        cpu = paddle.CPUPlace()
+        self.x = paddle.to_tensor(np.concatenate(self.encoded), place=cpu)
+        self.offsets = paddle.to_tensor(
+            np.cumsum([len(e) for e in self.encoded]), place=cpu
+        )
+
+    def expect(self, boxes):
+        outs = []
+        for image, box in zip(self.images, boxes):
+            height, width = image.shape[:2]
+            x0, y0, x1, y1 = np.array(box) * [width, height, width, height]
+            crop = image[int(y0) : int(y1), int(x0) : int(x1)]
+            out = cv2.resize(crop, (self.size[1], self.size[0]))
+            outs.append(out[..., ::-1].transpose(2, 0, 1))
+        return np.stack(outs).astype('float32')
+
+    def test_crop_resize(self):
+        boxes = [[0.0, 0.0, 1.0, 1.0], [0.25, 0.5, 0.75, 1.0], [0, 0, 0.5, 0.5]]
+        cpu = paddle.CPUPlace()
+        out = decode_jpeg_batch(
+            self.x,
+            self.offsets,
+            self.size,
+            boxes=paddle.to_tensor(boxes, dtype='float32', place=cpu),
+        )
+        self.assertEqual(out.shape, [3, 3, *self.size])
+        # the decoders and the borders of the crops differ a little
+        error = np.abs(out.numpy() - self.expect(boxes))
+        self.assertLess(error.mean(), 3.0)
+
+    def test_flip_normalize(self):
+        cpu = paddle.CPUPlace()
+        mean = [123.675, 116.28, 103.53]
+        std = [58.395, 57.12, 57.375]
+        out = decode_jpeg_batch(
+            self.x, self.offsets, self.size, mean=mean, std=std
+        ).numpy()
+        flip = paddle.to_tensor([True, False, True], place=cpu)
+        flipped = decode_jpeg_batch(
+            self.x, self.offsets, self.size, flip=flip, mean=mean, std=std
+        ).numpy()
+        np.testing.assert_allclose(flipped[0], out[0, ..., ::-1], atol=1e-5)
+        np.testing.assert_allclose(flipped[1], out[1], atol=1e-5)
+        np.testing.assert_allclose(flipped[2], out[2, ..., ::-1], atol=1e-5)
+
+        pixels = decode_jpeg_batch(self.x, self.offsets, self.size).numpy()
+        expect = (pixels - np.reshape(mean, [3, 1, 1])) / np.reshape(
+            std, [3, 1, 1]
+        )
+        np.testing.assert_allclose(out, expect, rtol=1e-4, atol=1e-4)
+
+    def test_gray(self):
+        out = decode_jpeg_batch(self.x, self.offsets, self.size, mode='gray')
+        self.assertEqual(out.shape, [3, 1, *self.size])
+
+
+if __name__ == '__main__':
+    unittest.main()
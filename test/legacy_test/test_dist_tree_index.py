@@ -110,6 +110,40 @@ class TestTreeIndex(unittest.TestCase):
         children_ids = [node.id() for node in tree.get_nodes(children_codes)]
         self.assertIn(all_leaf_ids[0], children_ids)
 
+    def test_layerwise_sample(self):
+        path = download(
+            "https://paddlerec.bj.bcebos.com/tree-based/data/mini_tree.pb",
+            "tree_index_unittest",
+            "e2ba4561c2e9432b532df40546390efa",
+        )
+        tree = TreeIndex("demo_layerwise", path)
+        height = tree.height()
+        layer_node_ids = [
+            [node.id() for node in tree.get_nodes(tree.get_layer_codes(i))]
+            for i in range(height)
+        ]
+        all_leaf_ids = [node.id() for node in tree.get_all_leafs()]
+
+        tree.init_layerwise_sampler([1] * (height - 1), 1, 10)
+        # A batch large enough to be sampled by several threads.
+        target_ids = [all_leaf_ids[i % len(all_leaf_ids)] for i in range(1024)]
+        user_inputs = [[target_id] for target_id in target_ids]
+        outputs = tree.layerwise_sample(user_inputs, target_ids)
+        self.assertEqual(len(outputs), len(target_ids) * (height - 1) * 2)
+
+        rows_per_instance = (height - 1) * 2
+        for i, target_id in enumerate(target_ids):
+            travel_codes = tree.get_travel_codes(target_id, 1)
+            travel_ids = [node.id() for node in tree.get_nodes(travel_codes)]
+            rows = outputs[i * rows_per_instance : (i + 1) * rows_per_instance]
+            for j, travel_id in enumerate(travel_ids):
+                positive, negative = rows[2 * j], rows[2 * j + 1]
+                self.assertEqual(positive, [target_id, travel_id, 1])
+                self.assertEqual(negative[0], target_id)
+                self.assertEqual(negative[2], 0)
+                self.assertNotEqual(negative[1], travel_id)
+                self.assertIn(negative[1], layer_node_ids[height - 1 - j])
+
 
 class TestIndexSampler(unittest.TestCase):
     def setUp(self):
@@ -108,6 +108,56 @@ class TestDLPack(unittest.TestCase):
             self.assertEqual(x.dtype, o.dtype)
             np.testing.assert_allclose(x.numpy(), o.numpy(), rtol=1e-05)
 
+    def test_dlpack_bool_and_bfloat16(self):
+        paddle.disable_static()
+        for dtype in ["bool", "bfloat16"]:
+            x = paddle.ones([2, 3], dtype=dtype)
+            o = paddle.utils.dlpack.from_dlpack(x)
+            self.assertEqual(x.dtype, o.dtype)
+            np.testing.assert_array_equal(
+                x.astype("float32").numpy(), o.astype("float32").numpy()
+            )
+
+    def test_dlpack_protocol_zero_copy(self):
+        paddle.disable_static()
+        places = [base.CPUPlace()]
+        if core.is_compiled_with_cuda():
+            places.append(base.CUDAPlace(0))
+        for place in places:
+            x = paddle.to_tensor(np.arange(12).reshape(3, 4), place=place)
+            device = x.__dlpack_device__()
+            o = paddle.utils.dlpack.from_dlpack(x)
+            self.assertEqual(x.data_ptr(), o.data_ptr())
+            self.assertTrue(o.place._equals(x.place))
+            self.assertEqual(o.__dlpack_device__(), device)
+            # writes through the consumer are seen by the producer
+            o[0, 0] = 100
+            self.assertEqual(x[0, 0].item(), 100)
+
+    def test_dlpack_protocol_stream(self):
+        if not core.is_compiled_with_cuda():
+            return
+        paddle.disable_static()
+        x = paddle.rand([1024, 1024])
+        stream = paddle.device.cuda.Stream()
+        capsule = x.__dlpack__(stream=stream.cuda_stream)
+        with paddle.device.cuda.stream_guard(stream):
+            y = paddle.utils.dlpack.from_dlpack(capsule) * 2
+        stream.synchronize()
+        np.testing.assert_allclose(y.numpy(), x.numpy() * 2, rtol=1e-05)
+
+    @unittest.skipIf(
+        not hasattr(np, 'from_dlpack'), "numpy does not support DLPack"
+    )
+    def test_dlpack_numpy(self):
+        paddle.disable_static()
+        data = np.random.randn(3, 4).astype("float32")
+        x = paddle.utils.dlpack.from_dlpack(data)
+        data[0, 0] = 100
+        self.assertEqual(x[0, 0].item(), 100)
+        y = np.from_dlpack(paddle.to_tensor(data, place=base.CPUPlace()))
+        np.testing.assert_array_equal(y, data)
+
     def test_dlpack_deletion(self):
         # See Paddle issue 47171
         if paddle.is_compiled_with_cuda():
@@ -126,7 +176,7 @@ class TestDLPack(unittest.TestCase):
 class TestRaiseError(unittest.TestCase):
     def test_from_dlpack_raise_type_error(self):
         self.assertRaises(
-            TypeError, paddle.utils.dlpack.from_dlpack, np.zeros(5)
+            TypeError, paddle.utils.dlpack.from_dlpack, [0.0] * 5
         )
 
     def test_to_dlpack_raise_type_error(self):
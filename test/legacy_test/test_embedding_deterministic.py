@@ -174,7 +174,7 @@ class TestEmbeddingBase(unittest.TestCase):
     def test_main(self):
         weight_dtypes = get_all_dtypes()
         ids_dtypes = [paddle.int64, paddle.int32]
-        deterministic_levels = [0, 1]
+        deterministic_levels = [0, 1, 3]
         ranks = [None, 0, 2, 4, 8]
         allow_duplicate_ids = [False, True]
         allow_pure_randoms = [False, True]
@@ -209,5 +209,35 @@ class TestEmbeddingDeterministic(unittest.TestCase):
         self.hidden_size = 1024
 
 
+class TestEmbeddingSortReduce(unittest.TestCase):
+    def setUp(self):
+        self.ids_shape = [64, 128]
+        self.vocab_size = 1000
+        self.hidden_size = 256
+
+    def test_skewed_ids(self):
+        for weight_dtype in get_all_dtypes():
+            # most of the ids hit the same hot token
+            ids = np.random.randint(0, self.vocab_size, size=self.ids_shape)
+            ids[np.random.random(self.ids_shape) < 0.9] = 7
+            ids = paddle.to_tensor(ids).astype(paddle.int64)
+            weight = paddle.randn([self.vocab_size, self.hidden_size]).astype(
+                weight_dtype
+            )
+            out_grad = paddle.randn(
+                self.ids_shape + [self.hidden_size]
+            ).astype(weight_dtype)
+
+            _, weight_grad_1 = embedding(ids, weight, out_grad, 3)
+            _, weight_grad_2 = embedding(ids, weight, out_grad, 3)
+            # bitwise reproducible across the runs
+            np.testing.assert_equal(weight_grad_1, weight_grad_2)
+
+            _, weight_grad_ref = embedding_ground_truth(ids, weight, out_grad)
+            np.testing.assert_allclose(
+                weight_grad_1, weight_grad_ref, rtol=1e-2, atol=1e-1
+            )
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,72 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base.executor import _LRUCache
+
+paddle.enable_static()
+
+
+class TestLRUCache(unittest.TestCase):
+    def test_evict_least_recently_used(self):
+        cache = _LRUCache(2)
+        cache['a'] = 1
+        cache['b'] = 2
+        self.assertEqual(cache.get('a'), 1)
+        cache['c'] = 3
+        self.assertEqual(len(cache), 2)
+        self.assertIn('a', cache)
+        self.assertIn('c', cache)
+        self.assertIsNone(cache.get('b'))
+        cache.clear()
+        self.assertEqual(len(cache), 0)
+
+
+class TestExecutorCacheCapacity(unittest.TestCase):
+    def setUp(self):
+        paddle.set_flags({'FLAGS_executor_cache_capacity': 2})
+
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_executor_cache_capacity': 8})
+
+    def test_many_fetch_lists(self):
+        main_program = paddle.static.Program()
+        startup_program = paddle.static.Program()
+        with paddle.static.program_guard(main_program, startup_program):
+            x = paddle.static.data('x', [2, 3], dtype='float32')
+            outs = [paddle.scale(x, scale=float(i)) for i in range(4)]
+
+        exe = paddle.static.Executor(paddle.CPUPlace())
+        exe.run(startup_program)
+        x_feed = np.random.random([2, 3]).astype('float32')
+        for i, out in enumerate(outs):
+            (out_value,) = exe.run(
+                main_program, feed={'x': x_feed}, fetch_list=[out]
+            )
+            np.testing.assert_allclose(out_value, x_feed * i, rtol=1e-6)
+        cache = exe._executor_cache
+        for cached_func in [
+            cache._get_cached_program_and_executor,
+            cache._get_cached_program_and_executor_pir_mode,
+        ]:
+            self.assertLessEqual(cached_func.cache_info().currsize, 2)
+        self.assertLessEqual(len(exe.program_caches), 2)
+
+
+if __name__ == "__main__":
+    unittest.main()
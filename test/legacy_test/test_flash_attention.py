@@ -536,5 +536,68 @@ class TestFlashAttentionNoKVGrad(unittest.TestCase):
         )
 
 
+@unittest.skipIf(
+    not is_flashattn_supported(),
+    "core is not compiled with CUDA and cuda version need larger than or equal to 11.4"
+    "and device's compute capability must be 8.x or 90",
+)
+class TestFlashAttentionGQA(unittest.TestCase):
+    def setUp(self):
+        self.place = paddle.CUDAPlace(0)
+        self.shape = (2, 128, 8, 16)
+        self.kv_shape = (2, 128, 2, 16)
+        self.dtype = 'float16'
+        self.causal = False
+
+    def _init_tensor_from_numpy(self, array):
+        return paddle.to_tensor(
+            array, place=self.place, dtype=self.dtype, stop_gradient=False
+        )
+
+    def test_all(self):
+        paddle.disable_static()
+        query = np.random.random(self.shape)
+        key = np.random.random(self.kv_shape)
+        value = np.random.random(self.kv_shape)
+        q = self._init_tensor_from_numpy(query)
+        k = self._init_tensor_from_numpy(key)
+        v = self._init_tensor_from_numpy(value)
+        q_ = self._init_tensor_from_numpy(query)
+        k_ = self._init_tensor_from_numpy(key)
+        v_ = self._init_tensor_from_numpy(value)
+
+        out, _ = flash_attention(q, k, v, causal=self.causal)
+        groups = self.shape[2] // self.kv_shape[2]
+        out_ = attention_naive(
+            q_,
+            paddle.repeat_interleave(k_, groups, axis=2),
+            paddle.repeat_interleave(v_, groups, axis=2),
+            self.causal,
+        )
+        np.testing.assert_allclose(out.numpy(), out_, rtol=5e-03, atol=1e-03)
+
+        out.backward()
+        out_.backward()
+        self.assertEqual(k.grad.shape, k.shape)
+        self.assertEqual(v.grad.shape, v.shape)
+        for grad, grad_ in [
+            (q.grad, q_.grad),
+            (k.grad, k_.grad),
+            (v.grad, v_.grad),
+        ]:
+            np.testing.assert_allclose(
+                grad.numpy(), grad_.numpy(), rtol=5e-03, atol=1e-03
+            )
+
+
+class TestFlashAttentionMQACausal(TestFlashAttentionGQA):
+    def setUp(self):
+        self.place = paddle.CUDAPlace(0)
+        self.shape = (2, 128, 8, 32)
+        self.kv_shape = (2, 128, 1, 32)
+        self.dtype = 'float16'
+        self.causal = True
+
+
 if __name__ == '__main__':
     unittest.main()
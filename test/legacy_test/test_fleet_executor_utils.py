@@ -15,7 +15,11 @@
 import unittest
 
 import paddle
-from paddle.distributed.fleet.fleet_executor_utils import FleetExecutorUtils
+from paddle.distributed.fleet.fleet_executor_utils import (
+    FleetExecutorUtils,
+    create_pipeline_schedule,
+    simulate_pipeline_schedule,
+)
 
 paddle.enable_static()
 
@@ -44,5 +48,58 @@ class TestFleetExecutorUtils(unittest.TestCase):
         )
 
 
+class TestPipelineSchedule(unittest.TestCase):
+    def check_jobs(self, schedule, job_types, num_micro_batches, num_chunks):
+        for jobs in schedule:
+            expected = {
+                (job_type, mb, chunk)
+                for job_type in job_types
+                for mb in range(num_micro_batches)
+                for chunk in range(num_chunks)
+            }
+            self.assertEqual(len(jobs), len(expected))
+            self.assertEqual(set(jobs), expected)
+
+    def test_1f1b(self):
+        schedule = create_pipeline_schedule('1F1B', 4, 8)
+        self.check_jobs(schedule, 'FB', 8, 1)
+        self.assertEqual(
+            schedule[3][:4],
+            [('F', 0, 0), ('B', 0, 0), ('F', 1, 0), ('B', 1, 0)],
+        )
+        # the bubbles of 1F1B are (S - 1) * (F + B)
+        result = simulate_pipeline_schedule(
+            schedule, forward_cost=1.0, backward_cost=1.0, weight_cost=1.0
+        )
+        self.assertAlmostEqual(result['makespan'], 8 * 3 + 3 * 3)
+        self.assertEqual(result['peak_activations'], [4, 3, 2, 1])
+
+    def test_interleaved(self):
+        schedule = create_pipeline_schedule('VPP', 4, 8, num_chunks=2)
+        self.check_jobs(schedule, 'FB', 8, 2)
+        base = simulate_pipeline_schedule(
+            create_pipeline_schedule('1F1B', 4, 8)
+        )
+        result = simulate_pipeline_schedule(schedule)
+        self.assertLess(result['makespan'], base['makespan'])
+        self.assertLess(result['bubble_ratio'], base['bubble_ratio'])
+        with self.assertRaises(AssertionError):
+            create_pipeline_schedule('VPP', 4, 6, num_chunks=2)
+
+    def test_zero_bubble(self):
+        schedule = create_pipeline_schedule('ZBH1', 4, 8)
+        self.check_jobs(schedule, 'FBW', 8, 1)
+        # the bubbles of ZB-H1 are (S - 1) * (F + B - W), within the peak
+        # activations of 1F1B
+        result = simulate_pipeline_schedule(schedule)
+        self.assertAlmostEqual(result['makespan'], 8 * 3 + 3 * 1)
+        self.assertLessEqual(max(result['peak_activations']), 4)
+
+    def test_deadlock(self):
+        schedule = [[('B', 0, 0), ('F', 0, 0)]]
+        with self.assertRaises(AssertionError):
+            simulate_pipeline_schedule(schedule)
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,165 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+from paddle.incubate.nn import FP8Linear
+from paddle.incubate.nn.functional import (
+    fp8_dequantize,
+    fp8_linear,
+    fp8_quantize,
+)
+
+E4M3_MAX = 448.0
+
+
+def fp8_e4m3_round(x):
+    # rounds to the nearest even of e4m3, whose mantissa has 3 bits and whose
+    # min normal exponent is -6, and saturates to the max
+    x = np.clip(x.astype(np.float64), -E4M3_MAX, E4M3_MAX)
+    exp = np.floor(np.log2(np.maximum(np.abs(x), 2.0**-6)))
+    step = 2.0 ** (exp - 3)
+    return (np.round(x / step) * step).astype(np.float32)
+
+
+def get_cuda_version():
+    result = paddle.version.cuda()
+    if result == 'False':
+        return -1
+    major, minor = result.split('.')[:2]
+    return int(major) * 1000 + int(minor) * 10
+
+
+def fp8_gemm_supported():
+    return (
+        core.is_compiled_with_cuda()
+        and get_cuda_version() >= 11080
+        and paddle.device.cuda.get_device_capability() >= (8, 9)
+    )
+
+
+class TestFp8QuantizeOp(unittest.TestCase):
+    def test_quantize_dequantize(self):
+        paddle.disable_static()
+        paddle.set_device('cpu')
+        np.random.seed(2024)
+        x_np = np.random.uniform(-600, 600, [4, 64]).astype('float32')
+        scale_np = np.array([0.5], dtype='float32')
+        x = paddle.to_tensor(x_np)
+        scale = paddle.to_tensor(scale_np)
+
+        out, amax = fp8_quantize(x, scale)
+        self.assertEqual(out.dtype, paddle.float8_e4m3fn)
+        np.testing.assert_allclose(amax.numpy(), [np.abs(x_np).max()])
+
+        dequant = fp8_dequantize(out, scale, paddle.float32)
+        expect = fp8_e4m3_round(x_np * scale_np[0]) / scale_np[0]
+        np.testing.assert_allclose(dequant.numpy(), expect, rtol=0, atol=0)
+
+    def test_saturate(self):
+        paddle.disable_static()
+        paddle.set_device('cpu')
+        x = paddle.to_tensor([1000.0, -1e6, 0.0], dtype='float32')
+        scale = paddle.to_tensor([1.0], dtype='float32')
+
+        out, _ = fp8_quantize(x, scale)
+        dequant = fp8_dequantize(out, scale, paddle.float32)
+        np.testing.assert_allclose(dequant.numpy(), [448.0, -448.0, 0.0])
+
+        out, _ = fp8_quantize(x, scale, paddle.float8_e5m2)
+        dequant = fp8_dequantize(out, scale, paddle.float32)
+        np.testing.assert_allclose(dequant.numpy(), [1024.0, -57344.0, 0.0])
+
+
+@unittest.skipIf(
+    not fp8_gemm_supported(),
+    "fp8_linear requires CUDA >= 11.8 and the compute capability >= 8.9",
+)
+class TestFp8Linear(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        paddle.set_device('gpu')
+        np.random.seed(2024)
+        self.x_np = np.random.uniform(-1, 1, [8, 64]).astype('float16')
+        self.w_np = np.random.uniform(-1, 1, [64, 32]).astype('float16')
+        self.b_np = np.random.uniform(-1, 1, [32]).astype('float16')
+
+    def reference(self):
+        x = self.x_np.astype('float32')
+        w = self.w_np.astype('float32')
+        x_scale = E4M3_MAX / np.abs(x).max()
+        w_scale = E4M3_MAX / np.abs(w).max()
+        x_fp8 = fp8_e4m3_round(x * x_scale) / x_scale
+        w_fp8 = fp8_e4m3_round(w * w_scale) / w_scale
+        return x_fp8 @ w_fp8 + self.b_np.astype('float32')
+
+    def test_current_scaling(self):
+        out = fp8_linear(
+            paddle.to_tensor(self.x_np),
+            paddle.to_tensor(self.w_np),
+            paddle.to_tensor(self.b_np),
+        )
+        np.testing.assert_allclose(
+            out.numpy().astype('float32'),
+            self.reference(),
+            rtol=1e-2,
+            atol=5e-2,
+        )
+
+    def test_delayed_scaling(self):
+        x = paddle.to_tensor(self.x_np)
+        w = paddle.to_tensor(self.w_np)
+        b = paddle.to_tensor(self.b_np)
+        x_amax_history = paddle.zeros([4], dtype='float32')
+        w_amax_history = paddle.zeros([4], dtype='float32')
+        # the first step is scaled by 1 and records the amax
+        fp8_linear(x, w, b, x_amax_history, w_amax_history)
+        x_amax = np.abs(self.x_np.astype('float32')).max()
+        w_amax = np.abs(self.w_np.astype('float32')).max()
+        np.testing.assert_allclose(x_amax_history.numpy(), [x_amax, 0, 0, 0])
+        np.testing.assert_allclose(w_amax_history.numpy(), [w_amax, 0, 0, 0])
+
+        # the second step is scaled by the history as the current scaling
+        out = fp8_linear(x, w, b, x_amax_history, w_amax_history)
+        np.testing.assert_allclose(
+            out.numpy().astype('float32'),
+            self.reference(),
+            rtol=1e-2,
+            atol=5e-2,
+        )
+        np.testing.assert_allclose(
+            x_amax_history.numpy(), [x_amax, x_amax, 0, 0]
+        )
+
+    def test_layer_backward(self):
+        paddle.set_default_dtype('float16')
+        linear = FP8Linear(64, 32)
+        paddle.set_default_dtype('float32')
+        x = paddle.to_tensor(self.x_np, stop_gradient=False)
+        out = linear(x)
+        out.sum().backward()
+        self.assertEqual(x.grad.shape, [8, 64])
+        self.assertEqual(linear.weight.grad.shape, [64, 32])
+        np.testing.assert_allclose(
+            linear.bias.grad.numpy().astype('float32'),
+            np.full([32], 8.0, dtype='float32'),
+        )
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,145 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+from paddle.incubate.nn.functional import fused_beam_search_step
+
+
+def length_penalty(length, alpha):
+    return ((5.0 + length) / 6.0) ** alpha
+
+
+def ref_beam_search_step(logits, cum_scores, seq_lens, finished, end_id, alpha):
+    batch_size, beam_size = cum_scores.shape
+    vocab_size = logits.shape[-1]
+    logits = logits.astype("float64").reshape(batch_size, beam_size, -1)
+    shifted = logits - logits.max(axis=-1, keepdims=True)
+    log_probs = shifted - np.log(np.exp(shifted).sum(axis=-1, keepdims=True))
+
+    outs = [[] for _ in range(5)]
+    for b in range(batch_size):
+        candidates = []
+        for k in range(beam_size):
+            cum, length = cum_scores[b, k], seq_lens[b, k]
+            if finished[b, k]:
+                score = cum / length_penalty(length, alpha)
+                candidates.append((score, k, end_id, cum, length, True))
+                continue
+            for v in range(vocab_size):
+                next_cum = cum + log_probs[b, k, v]
+                score = next_cum / length_penalty(length + 1, alpha)
+                candidates.append(
+                    (score, k, v, next_cum, length + 1, v == end_id)
+                )
+        candidates.sort(key=lambda c: -c[0])
+        for score, k, v, cum, length, done in candidates[:beam_size]:
+            for out, value in zip(
+                outs, [v, b * beam_size + k, cum, length, done]
+            ):
+                out.append(value)
+    shape = [batch_size, beam_size]
+    return [np.array(out).reshape(shape) for out in outs]
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(),
+    "fused_beam_search_step requires CUDA",
+)
+class TestFusedBeamSearchStep(unittest.TestCase):
+    def setUp(self):
+        self.dtype = "float32"
+        self.batch_size = 3
+        self.beam_size = 4
+        self.vocab_size = 5000
+        self.end_id = 2
+        self.alpha = 0.6
+        # the logits are the distinct multiples of 1 / scale
+        self.scale = self.batch_size * self.beam_size * self.vocab_size / 4.0
+        np.random.seed(2024)
+
+    def run_case(self, cum_scores, seq_lens, finished):
+        shape = [self.batch_size * self.beam_size, self.vocab_size]
+        # the distinct logits keep the order of the candidates unique
+        logits = np.random.permutation(np.prod(shape)).reshape(shape)
+        logits = (logits / self.scale).astype(self.dtype)
+        # the end token is a likely candidate, to finish some beams
+        logits[:, self.end_id] = np.prod(shape) / self.scale
+
+        results = fused_beam_search_step(
+            paddle.to_tensor(logits),
+            paddle.to_tensor(cum_scores, dtype="float32"),
+            paddle.to_tensor(seq_lens, dtype="int32"),
+            paddle.to_tensor(finished),
+            self.end_id,
+            self.alpha,
+        )
+        expects = ref_beam_search_step(
+            logits.astype("float32"),
+            cum_scores,
+            seq_lens,
+            finished,
+            self.end_id,
+            self.alpha,
+        )
+        names = ["tokens", "parents", "cum_scores", "seq_lens", "finished"]
+        for name, result, expect in zip(names, results, expects):
+            if name == "cum_scores":
+                np.testing.assert_allclose(
+                    result.numpy(), expect, rtol=1e-4, atol=1e-4
+                )
+            else:
+                np.testing.assert_array_equal(
+                    result.numpy(), expect, err_msg=name
+                )
+
+    def test_first_step(self):
+        shape = [self.batch_size, self.beam_size]
+        cum_scores = np.full(shape, -np.inf, dtype="float32")
+        cum_scores[:, 0] = 0.0
+        self.run_case(
+            cum_scores,
+            np.zeros(shape, dtype="int32"),
+            np.zeros(shape, dtype="bool"),
+        )
+
+    def test_finished_beams(self):
+        shape = [self.batch_size, self.beam_size]
+        cum_scores = -np.random.rand(*shape).astype("float32") * 10
+        seq_lens = np.random.randint(1, 20, shape).astype("int32")
+        finished = np.zeros(shape, dtype="bool")
+        finished[0, 1] = True
+        finished[1, :] = True
+        self.run_case(cum_scores, seq_lens, finished)
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(),
+    "fused_beam_search_step requires CUDA",
+)
+class TestFusedBeamSearchStepFP16(TestFusedBeamSearchStep):
+    def setUp(self):
+        super().setUp()
+        self.dtype = "float16"
+        # the multiples of 1 / 8 below 256 are exact in float16
+        self.vocab_size = 64
+        self.scale = 8.0
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,122 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+import paddle.nn.functional as F
+from paddle.base import core
+from paddle.incubate.nn.functional import fused_grouped_gemm
+
+
+def grouped_gemm_supported():
+    if not core.is_compiled_with_cuda():
+        return False
+    return paddle.device.cuda.get_device_capability()[0] >= 7
+
+
+def ref_grouped_gemm(x, weight, rows, bias, act_type):
+    outs = []
+    begin = 0
+    for e, num in enumerate(rows):
+        out = paddle.matmul(x[begin : begin + num], weight[e])
+        if bias is not None:
+            out = out + bias[e]
+        outs.append(out)
+        begin += num
+    out = paddle.concat(outs, axis=0)
+    if act_type == "relu":
+        out = F.relu(out)
+    elif act_type == "gelu":
+        out = F.gelu(out, approximate=True)
+    return out
+
+
+@unittest.skipIf(
+    not grouped_gemm_supported(),
+    "fused_grouped_gemm requires CUDA and sm70 or later",
+)
+class TestFusedGroupedGemm(unittest.TestCase):
+    def setUp(self):
+        self.dtype = "float32"
+        self.atol = 1e-3
+        # uneven and empty experts, as after the dispatch of a MoE layer
+        self.rows = [5, 0, 17, 1, 9, 0, 32, 3]
+        self.k = 64
+        self.n = 96
+        np.random.seed(2024)
+
+    def run_case(self, act_type, with_bias):
+        num_experts = len(self.rows)
+        num_rows = sum(self.rows)
+        x_np = np.random.randn(num_rows, self.k).astype(self.dtype)
+        w_np = (np.random.randn(num_experts, self.k, self.n) * 0.1).astype(
+            self.dtype
+        )
+        b_np = np.random.randn(num_experts, self.n).astype(self.dtype)
+        dout_np = np.random.randn(num_rows, self.n).astype(self.dtype)
+        offsets = paddle.to_tensor(np.cumsum(self.rows), dtype="int64")
+
+        def run(func):
+            x = paddle.to_tensor(x_np, stop_gradient=False)
+            w = paddle.to_tensor(w_np, stop_gradient=False)
+            b = paddle.to_tensor(b_np, stop_gradient=False)
+            out = func(x, w, b if with_bias else None)
+            out.backward(paddle.to_tensor(dout_np))
+            grads = [x.grad.numpy(), w.grad.numpy()]
+            if with_bias:
+                grads.append(b.grad.numpy())
+            return [out.numpy(), *grads]
+
+        results = run(
+            lambda x, w, b: fused_grouped_gemm(x, w, offsets, b, act_type)
+        )
+        expects = run(
+            lambda x, w, b: ref_grouped_gemm(x, w, self.rows, b, act_type)
+        )
+        for result, expect in zip(results, expects):
+            np.testing.assert_allclose(
+                result.astype("float32"),
+                expect.astype("float32"),
+                rtol=self.atol,
+                atol=self.atol,
+            )
+
+    def test_none(self):
+        self.run_case("none", False)
+        self.run_case("none", True)
+
+    def test_relu(self):
+        self.run_case("relu", True)
+
+    def test_gelu(self):
+        self.run_case("gelu", True)
+        self.run_case("gelu", False)
+
+
+@unittest.skipIf(
+    not grouped_gemm_supported(),
+    "fused_grouped_gemm requires CUDA and sm70 or later",
+)
+class TestFusedGroupedGemmFP16(TestFusedGroupedGemm):
+    def setUp(self):
+        super().setUp()
+        self.dtype = "float16"
+        self.atol = 5e-2
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -532,5 +532,58 @@ class API_GeometricSendURecvTest(unittest.TestCase):
         np.testing.assert_allclose(np_sum, ret[0], rtol=1e-05, atol=1e-06)
 
 
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda(), "only the gpu sorts the edges by dst"
+)
+class TestSendRecvSortedReduce(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        np.random.seed(2024)
+        x = np.random.random((100, 33)).astype("float32")
+        e = np.random.random((2000, 33)).astype("float32")
+        src_index = np.random.randint(0, 100, (2000,)).astype(np.int64)
+        # A skewed graph, half of the edges go to the hub node 0.
+        dst_index = np.random.randint(0, 80, (2000,)).astype(np.int64)
+        dst_index[::2] = 0
+        self.x = paddle.to_tensor(x)
+        self.e = paddle.to_tensor(e)
+        self.src_index = paddle.to_tensor(src_index)
+        self.dst_index = paddle.to_tensor(dst_index)
+
+    def tearDown(self):
+        paddle.set_flags({"FLAGS_graph_send_recv_sorted_reduce": False})
+
+    def run_send_recv(self, sorted_reduce):
+        paddle.set_flags({"FLAGS_graph_send_recv_sorted_reduce": sorted_reduce})
+        res = []
+        for reduce_op in ["sum", "mean", "max", "min"]:
+            out = paddle.geometric.send_u_recv(
+                self.x, self.src_index, self.dst_index, reduce_op
+            )
+            res.append(out.numpy())
+            for message_op in ["add", "mul"]:
+                out = paddle.geometric.send_ue_recv(
+                    self.x,
+                    self.e,
+                    self.src_index,
+                    self.dst_index,
+                    message_op,
+                    reduce_op,
+                )
+                res.append(out.numpy())
+        return res
+
+    def test_sorted_reduce(self):
+        expected = self.run_send_recv(sorted_reduce=False)
+        actual = self.run_send_recv(sorted_reduce=True)
+        for expected_res, actual_res in zip(expected, actual):
+            np.testing.assert_allclose(
+                expected_res, actual_res, rtol=1e-05, atol=1e-05
+            )
+        # The edges of an out row are reduced in a fixed order.
+        for actual_res, res in zip(actual, self.run_send_recv(True)):
+            np.testing.assert_array_equal(actual_res, res)
+
+
 if __name__ == '__main__':
     unittest.main()
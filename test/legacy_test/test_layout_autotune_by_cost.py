@@ -0,0 +1,74 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import paddle
+from paddle.base import core
+
+
+class SimpleNet(paddle.nn.Layer):
+    def __init__(self):
+        super().__init__()
+        self.stem = paddle.nn.Conv2D(3, 16, (3, 3), padding=1)
+        self.bn = paddle.nn.BatchNorm(num_channels=16)
+        self.conv = paddle.nn.Conv2D(16, 16, (3, 3), padding=1)
+        self.pool = paddle.nn.AdaptiveAvgPool2D(1)
+        self.flatten = paddle.nn.Flatten()
+        self.fc = paddle.nn.Linear(16, 2)
+
+    def forward(self, image):
+        out = paddle.nn.functional.relu(self.bn(self.stem(image)))
+        out = self.conv(out)
+        out = self.flatten(self.pool(out))
+        return self.fc(out)
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "layout autotune requires CUDA"
+)
+class TestLayoutAutoTuneByCost(unittest.TestCase):
+    def setUp(self):
+        paddle.incubate.autotune.set_config(
+            config={"layout": {"enable": True, "by_cost": True}}
+        )
+        core.clear_layout_autotune_report()
+
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_layout_autotune_by_cost': False})
+
+    def test_measure_first_step(self):
+        model = SimpleNet()
+        data = paddle.rand([2, 3, 32, 32])
+        for _ in range(3):
+            with paddle.amp.auto_cast(level="O2"):
+                out = model(data)
+            self.assertEqual(out.shape, [2, 2])
+
+        report = core.layout_autotune_report()
+        costs = report["measured_costs"]["conv2d"]
+        self.assertEqual(costs["count"], 2)
+        self.assertGreater(costs["default_ms"], 0)
+        self.assertGreater(costs["desired_ms"], 0)
+        if core.use_layout_autotune():
+            # the layout is tuned, since the other layout costs less
+            self.assertEqual(report["default_layout"], "NCHW")
+            self.assertEqual(report["desired_layout"], "NHWC")
+            self.assertIn("conv2d", report["transposes"])
+        else:
+            self.assertEqual(report["transposes"], {})
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -391,6 +391,49 @@ class TestMatrixNMSError(unittest.TestCase):
             test_coverage()
 
 
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda() or paddle.is_compiled_with_rocm(),
+    "only support cuda",
+)
+class TestMatrixNMSGPU(unittest.TestCase):
+    def run_matrix_nms(self, place, boxes, scores, use_gaussian):
+        paddle.disable_static(place)
+        out, rois_num, index = paddle.vision.ops.matrix_nms(
+            bboxes=paddle.to_tensor(boxes),
+            scores=paddle.to_tensor(scores),
+            score_threshold=0.01,
+            post_threshold=0.1,
+            nms_top_k=400,
+            keep_top_k=200,
+            use_gaussian=use_gaussian,
+            return_index=True,
+        )
+        outs = [out.numpy(), rois_num.numpy(), index.numpy()]
+        paddle.enable_static()
+        return outs
+
+    def test_gpu_vs_cpu(self):
+        N, M, C = 4, 600, 21
+        scores = np.random.random((N * M, C)).astype('float32')
+        scores = np.apply_along_axis(softmax, 1, scores)
+        scores = np.transpose(np.reshape(scores, (N, M, C)), (0, 2, 1))
+        boxes = np.random.random((N, M, 4)).astype('float32')
+        boxes[:, :, 0:2] = boxes[:, :, 0:2] * 0.5
+        boxes[:, :, 2:4] = boxes[:, :, 2:4] * 0.5 + 0.5
+        for use_gaussian in [False, True]:
+            expected = self.run_matrix_nms(
+                paddle.CPUPlace(), boxes, scores, use_gaussian
+            )
+            actual = self.run_matrix_nms(
+                paddle.CUDAPlace(0), boxes, scores, use_gaussian
+            )
+            np.testing.assert_array_equal(expected[1], actual[1])
+            np.testing.assert_array_equal(expected[2], actual[2])
+            np.testing.assert_allclose(
+                expected[0], actual[0], rtol=1e-5, atol=1e-6
+            )
+
+
 if __name__ == '__main__':
     paddle.enable_static()
     unittest.main()
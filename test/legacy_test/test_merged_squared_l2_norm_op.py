@@ -0,0 +1,90 @@
+#   Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle import _C_ops
+from paddle.base import core
+
+
+class TestMergedSquaredL2NormOp(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        # the large tensor is split into chunks, and the tensors are more
+        # than the tensors of a launch
+        self.shapes = [[3], [0], [17, 33], [1 << 20, 3], [7, 1], [2, 3, 4]]
+        self.shapes += [[5]] * 120
+        self.places = ['cpu']
+        if core.is_compiled_with_cuda():
+            self.places.append('gpu')
+
+    def check_with_dtype(self, dtype, rtol):
+        xs_np = [
+            np.random.uniform(-1.0, 1.0, shape).astype('float32')
+            for shape in self.shapes
+        ]
+        expect = sum((x.astype('float64') ** 2).sum() for x in xs_np)
+        for place in self.places:
+            paddle.set_device(place)
+            xs = [paddle.to_tensor(x).astype(dtype) for x in xs_np]
+            out = _C_ops.merged_squared_l2_norm(xs)
+            self.assertEqual(out.shape, [])
+            if dtype in ['float16', 'bfloat16']:
+                self.assertEqual(out.dtype, paddle.float32)
+            np.testing.assert_allclose(
+                out.astype('float64').numpy(), expect, rtol=rtol
+            )
+
+    def test_float32(self):
+        self.check_with_dtype('float32', 1e-5)
+
+    def test_float64(self):
+        self.check_with_dtype('float64', 1e-10)
+
+    def test_float16(self):
+        self.check_with_dtype('float16', 1e-2)
+
+    def test_bfloat16(self):
+        self.check_with_dtype('bfloat16', 2e-2)
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestClipGradByGlobalNormMerged(unittest.TestCase):
+    def test_clip(self):
+        paddle.disable_static()
+        paddle.set_device('gpu')
+        clip_norm = 1.0
+        params_grads = []
+        grads_np = []
+        for shape in [[64, 32], [32], [128, 16, 3]]:
+            p = paddle.create_parameter(shape, dtype='float32')
+            g_np = np.random.uniform(-1.0, 1.0, shape).astype('float32')
+            params_grads.append((p, paddle.to_tensor(g_np)))
+            grads_np.append(g_np)
+
+        clip = paddle.nn.ClipGradByGlobalNorm(clip_norm)
+        params_grads = clip(params_grads)
+        global_norm = np.sqrt(sum((g**2).sum() for g in grads_np))
+        scale = clip_norm / max(global_norm, clip_norm)
+        for (_, g), g_np in zip(params_grads, grads_np):
+            np.testing.assert_allclose(g.numpy(), g_np * scale, rtol=1e-5)
+
+
+if __name__ == "__main__":
+    unittest.main()
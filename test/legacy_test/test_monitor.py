@@ -23,6 +23,8 @@ import os
 import tempfile
 import unittest
 
+import numpy as np
+
 from paddle import base
 from paddle.base import core
 
@@ -107,5 +109,30 @@ class TestDatasetWithStat(unittest.TestCase):
         temp_dir.cleanup()
 
 
+class TestHistogramStat(unittest.TestCase):
+    def test_executor_run_latency(self):
+        main_program = paddle.static.Program()
+        startup_program = paddle.static.Program()
+        with paddle.static.program_guard(main_program, startup_program):
+            x = paddle.static.data(name="x", shape=[2, 3], dtype="float32")
+            out = paddle.scale(x, scale=2.0)
+
+        exe = base.Executor(base.CPUPlace())
+        exe.run(startup_program)
+        core.get_histogram_stats(reset=True)
+        run_num = 3
+        for _ in range(run_num):
+            exe.run(
+                main_program,
+                feed={"x": np.ones([2, 3], dtype="float32")},
+                fetch_list=[out],
+            )
+
+        stat = core.get_histogram_stats()["STAT_executor_run_us"]
+        self.assertEqual(stat["count"], run_num)
+        self.assertEqual(sum(stat["buckets"]), run_num)
+        self.assertGreaterEqual(stat["sum"], 0)
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -165,6 +165,31 @@ class TestNanInfEnv(TestNanInf):
         self.dygraph_expected_op_count = None
 
 
+class TestNanInfAsync(TestNanInf):
+    def setUp(self):
+        super().setUp()
+        self.env["FLAGS_check_nan_inf_async"] = "1"
+
+        self.check_static = True
+        self.check_dygraph = False
+        self.check_nan_inf_level = 0
+        self.dygraph_expected_op_count = None
+
+    def run_check_nan_inf(self, cmd, expected_op_count=None):
+        returncode, out, err = self.run_command(cmd)
+        # The step found NAN/INF is followed by a step checking every op.
+        self.assertNotEqual(
+            (out + err).find(b'Found NAN/INF in the outputs of the ops'),
+            -1,
+            f"Cannot find the NAN / INF of the step in:\n{out + err}",
+        )
+        self.assertNotEqual(
+            (out + err).find(b'There are NAN or INF'),
+            -1,
+            f"Cannot find NAN / INF keyword in:\n{out + err}",
+        )
+
+
 class TestNanInfStack(TestNanInfBase):
     def check_stack(self, file_name):
         cmd = self._python_interp + file_name
@@ -0,0 +1,180 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import json
+import os
+import tempfile
+import threading
+import unittest
+
+from paddle import profiler
+from paddle.profiler.distributed_trace import sync_clock
+
+
+class FakeStore:
+    def __init__(self):
+        self.data = {}
+        self.cv = threading.Condition()
+
+    def set(self, key, value):
+        with self.cv:
+            self.data[key] = value
+            self.cv.notify_all()
+
+    def get(self, key):
+        self.wait(key)
+        with self.cv:
+            return self.data[key].encode()
+
+    def add(self, key, value):
+        with self.cv:
+            self.data[key] = str(int(self.data.get(key, '0')) + value)
+            self.cv.notify_all()
+            return int(self.data[key])
+
+    def wait(self, key):
+        with self.cv:
+            self.cv.wait_for(lambda: key in self.data)
+
+
+def _trace(rank, offset_ns, comm_ts, kernel_ts):
+    # one allreduce of seq 1 launched at comm_ts, whose kernel runs at
+    # kernel_ts for 100 us
+    events = [
+        {
+            "name": "process_name",
+            "pid": 100,
+            "tid": "1(C++)",
+            "ph": "M",
+            "args": {"name": "Process 100 (CPU)"},
+        },
+        {
+            "name": "NCCL::AllReduce#group_key:nccl_ids/0/0,seq:1[10.000 us]",
+            "pid": 100,
+            "tid": "1(C++)",
+            "ts": comm_ts,
+            "dur": 10.0,
+            "ph": "X",
+            "cat": "Communication",
+            "args": {},
+        },
+        {
+            "name": "cudaLaunchKernel[2.000 us]",
+            "pid": 100,
+            "tid": "1(C++)",
+            "ts": comm_ts + 2,
+            "dur": 2.0,
+            "ph": "X",
+            "cat": "CudaRuntime",
+            "args": {"correlation id": 7},
+        },
+        {
+            "name": "ncclKernel_AllReduce[100.000 us]",
+            "pid": 0,
+            "tid": 7,
+            "ts": kernel_ts,
+            "dur": 100.0,
+            "ph": "X",
+            "cat": "Kernel",
+            "args": {"correlation id": 7},
+        },
+        {"name": "launch", "id": 7, "pid": 0, "tid": 7, "ph": "f"},
+        {},
+    ]
+    return {
+        "schemaVersion": "1.0.2",
+        "traceEvents": events,
+        "ExtraInfo": {"rank": str(rank), "clock_offset_ns": str(offset_ns)},
+    }
+
+
+class TestSyncClock(unittest.TestCase):
+    def test_sync_clock(self):
+        store = FakeStore()
+        world_size = 4
+        offsets = [None] * world_size
+
+        def run(rank):
+            offsets[rank] = sync_clock(store, rank, world_size, rounds=4)
+
+        for _ in range(2):
+            threads = [
+                threading.Thread(target=run, args=(r,))
+                for r in range(world_size)
+            ]
+            for t in threads:
+                t.start()
+            for t in threads:
+                t.join()
+            # the threads share one clock
+            self.assertEqual(offsets[0], 0)
+            for offset in offsets[1:]:
+                self.assertLess(abs(offset), 50 * 1000 * 1000)
+
+    def test_single_rank(self):
+        self.assertEqual(sync_clock(FakeStore(), 0, 1), 0)
+
+
+class TestMergeDistributedTraces(unittest.TestCase):
+    def test_merge(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            # rank 1 runs 1000 us behind on its clock, and launches the
+            # allreduce 500 us after rank 0 on the clock of rank 0
+            traces = [
+                _trace(0, 0, comm_ts=1000, kernel_ts=1005),
+                _trace(1, 1000 * 1000, comm_ts=500, kernel_ts=505),
+            ]
+            files = []
+            for rank, trace in enumerate(traces):
+                files.append(os.path.join(tmp, f'rank{rank}.json'))
+                with open(files[-1], 'w') as f:
+                    json.dump(trace, f)
+            output = os.path.join(tmp, 'merged.json')
+            report = profiler.merge_distributed_traces(files, output)
+
+            self.assertIn('Matched communications: 1', report)
+            row = [
+                line
+                for line in report.splitlines()
+                if line.startswith('NCCL::AllReduce')
+            ][0].split()
+            # op, tag, ranks, begin skew, end skew, straggler, durations
+            self.assertEqual(row[2], '2')
+            self.assertAlmostEqual(float(row[3]), 500.0)
+            self.assertAlmostEqual(float(row[4]), 500.0)
+            self.assertEqual(row[5], '1')
+
+            with open(output) as f:
+                merged = json.load(f)
+            events = merged['traceEvents']
+            names = [
+                e['args']['name']
+                for e in events
+                if e.get('name') == 'process_name'
+            ]
+            self.assertIn('[rank 0] Process 100 (CPU)', names)
+            self.assertIn('[rank 1] Process 100 (CPU)', names)
+            kernels = sorted(
+                (e['pid'], e['ts']) for e in events if e.get('cat') == 'Kernel'
+            )
+            self.assertEqual(kernels[0], (0, 1005))
+            self.assertEqual(kernels[1][1], 1505)
+            self.assertNotEqual(kernels[0][0], kernels[1][0])
+            comms = [e for e in events if e.get('cat') == 'Communication']
+            for e in comms:
+                self.assertEqual(e['args']['straggler_rank'], 1)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -59,6 +59,8 @@ class MemPythonNode:
         current_reserved,
         peak_allocated,
         peak_reserved,
+        alloc_op='',
+        free_ns=0,
     ):
         self.timestamp_ns = timestamp_ns
         self.addr = addr
@@ -71,6 +73,8 @@ class MemPythonNode:
         self.current_reserved = current_reserved
         self.peak_allocated = peak_allocated
         self.peak_reserved = peak_reserved
+        self.alloc_op = alloc_op
+        self.free_ns = free_ns
 
 
 class TestProfilerStatistic(unittest.TestCase):
@@ -1045,5 +1049,88 @@ class TestProfilerStatistic(unittest.TestCase):
             )
 
 
+class TestPeakMemoryBreakdown(unittest.TestCase):
+    def mem_node(self, ts, addr, type, size, current, alloc_op):
+        return MemPythonNode(
+            ts,
+            addr,
+            type,
+            1000,
+            1001,
+            size,
+            'place(gpu:0)',
+            current,
+            current,
+            current,
+            current,
+            alloc_op,
+        )
+
+    def test_peak_breakdown(self):
+        Allocate = profiler_statistic.TracerMemEventType.Allocate
+        Free = profiler_statistic.TracerMemEventType.Free
+        root_node = HostPythonNode(
+            'Root Node',
+            profiler.TracerEventType.UserDefined,
+            0,
+            float('inf'),
+            1000,
+            1001,
+        )
+        matmul = HostPythonNode(
+            'matmul', profiler.TracerEventType.Operator, 10, 20, 1000, 1001
+        )
+        relu = HostPythonNode(
+            'relu', profiler.TracerEventType.Operator, 20, 30, 1000, 1001
+        )
+        add = HostPythonNode(
+            'add', profiler.TracerEventType.Operator, 30, 40, 1000, 1001
+        )
+        profilerstep_node = HostPythonNode(
+            'ProfileStep#1',
+            profiler.TracerEventType.ProfileStep,
+            0,
+            50,
+            1000,
+            1001,
+        )
+        root_node.children_node.append(profilerstep_node)
+        profilerstep_node.children_node.extend([matmul, relu, add])
+        # 1000 bytes are allocated before the profiling range
+        matmul.mem_node.append(
+            self.mem_node(11, 1, Allocate, 100, 1100, 'matmul')
+        )
+        matmul.mem_node.append(
+            self.mem_node(12, 2, Allocate, 200, 1300, 'matmul')
+        )
+        relu.mem_node.append(self.mem_node(21, 3, Allocate, 50, 1350, 'relu'))
+        # the peak of 350 bytes is before the free
+        add.mem_node.append(self.mem_node(31, 2, Free, -200, 1150, 'matmul'))
+        add.mem_node.append(self.mem_node(32, 4, Allocate, 120, 1270, 'add'))
+
+        statistic_data = profiler.profiler_statistic.StatisticData(
+            {'thread1001': root_node}, {}
+        )
+        breakdown = statistic_data.memory_summary.peak_breakdowns[
+            'place(gpu:0)'
+        ]
+        self.assertEqual(breakdown.peak_size, 350)
+        self.assertEqual(breakdown.timestamp_ns, 21)
+        self.assertEqual(breakdown.untracked_size, 1000)
+        self.assertEqual(breakdown.items['matmul'], [2, 300])
+        self.assertEqual(breakdown.items['relu'], [1, 50])
+        self.assertNotIn('add', breakdown.items)
+        table = profiler.profiler_statistic._build_table(
+            statistic_data,
+            sorted_by=profiler.SortedKeys.CPUTotal,
+            op_detail=True,
+            thread_sep=False,
+            time_unit='ms',
+            views=[profiler.SummaryView.MemoryView],
+        )
+        self.assertIn('Peak Memory Breakdown - place(gpu:0)', table)
+        self.assertIn('[before profiling]', table)
+
+
 if __name__ == '__main__':
     unittest.main()
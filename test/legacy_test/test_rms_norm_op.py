@@ -286,6 +286,95 @@ class TestRMSNormOp(unittest.TestCase):
         )
 
 
+def naive_per_token_quant(x, quant_max_bound, quant_min_bound):
+    abs_max = paddle.max(paddle.abs(x), axis=-1, keepdim=True)
+    quant_value = paddle.round(x * quant_max_bound / abs_max)
+    out = paddle.cast(
+        paddle.clip(quant_value, quant_min_bound, quant_max_bound),
+        paddle.int8,
+    )
+    return out, abs_max / quant_max_bound
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA "
+)
+class TestRMSNormPerTokenQuantOp(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(20)
+        batch = 32
+        cols = 256
+        self.x_np = np.random.uniform(-1, 1, [batch, cols])
+        self.residual_np = np.random.uniform(-1, 1, [batch, cols])
+        self.bias_np = np.random.random([cols])
+        self.norm_weight_np = np.random.random([cols])
+        self.norm_bias_np = np.random.random([cols])
+        self.epsilon = 1e-6
+        self.quant_max_bound = 127
+        self.quant_min_bound = -127
+
+    def check_per_token_quant(self, dtype, with_residual):
+        paddle.disable_static()
+        x = paddle.to_tensor(self.x_np.astype(dtype))
+        gamma = paddle.to_tensor(self.norm_weight_np.astype(dtype))
+        beta = paddle.to_tensor(self.norm_bias_np.astype(dtype))
+        residual = None
+        bias = None
+        if with_residual:
+            residual = paddle.to_tensor(self.residual_np.astype(dtype))
+            bias = paddle.to_tensor(self.bias_np.astype(dtype))
+            out, residual_out, out_scale = (
+                paddle.incubate.nn.functional.fused_rms_norm_quant(
+                    x,
+                    gamma,
+                    beta,
+                    self.epsilon,
+                    begin_norm_axis=1,
+                    bias=bias,
+                    residual=residual,
+                )
+            )
+            naive_out = naive_residual_biasadd_rms_norm(
+                x, residual, bias, gamma, beta, self.epsilon
+            )
+            np.testing.assert_allclose(
+                residual_out.numpy(),
+                (x + residual + bias).numpy(),
+                rtol=1e-3,
+                atol=1e-3,
+            )
+        else:
+            out, out_scale = paddle.incubate.nn.functional.fused_rms_norm_quant(
+                x, gamma, beta, self.epsilon, begin_norm_axis=1
+            )
+            naive_out = naive_rms_norm(x, gamma, beta, self.epsilon)
+        naive_quant_out, naive_scale = naive_per_token_quant(
+            naive_out.astype('float32'),
+            self.quant_max_bound,
+            self.quant_min_bound,
+        )
+        paddle.enable_static()
+
+        self.assertEqual(out.dtype, paddle.int8)
+        self.assertEqual(out_scale.shape, [self.x_np.shape[0], 1])
+        np.testing.assert_allclose(
+            out.numpy(), naive_quant_out.numpy(), rtol=0, atol=1
+        )
+        np.testing.assert_allclose(
+            out_scale.numpy(), naive_scale.numpy(), rtol=1e-2, atol=1e-3
+        )
+
+    def test_per_token_quant_fp16(self):
+        if not paddle.is_compiled_with_cuda():
+            return
+        self.check_per_token_quant('float16', with_residual=False)
+
+    def test_residual_bias_add_per_token_quant_fp16(self):
+        if not paddle.is_compiled_with_cuda():
+            return
+        self.check_per_token_quant('float16', with_residual=True)
+
+
 @unittest.skipIf(
     not core.is_compiled_with_cuda(), "core is not compiled with CUDA "
 )
@@ -264,5 +264,18 @@ class TestRNNOp9(TestRNNOp):
         self.num_layers = 3
 
 
+class TestRNNOp10(TestRNNOp):
+    def set_attrs(self):
+        # The steps after the longest sequence are skipped in the inference.
+        self.num_layers = 2
+        self.is_bidirec = True
+        self.is_test = True
+        self.sequence_length = (
+            None
+            if core.is_compiled_with_rocm()
+            else np.array([10, 9, 8, 7, 6], dtype=np.int32)
+        )
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,68 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import re
+import unittest
+
+import paddle
+from paddle import profiler
+
+
+def _counts(summary, op):
+    pattern = r'paddle_op_latency_seconds_count\{op="%s[^"]*"\} (\d+)' % op
+    return sum(int(c) for c in re.findall(pattern, summary))
+
+
+class TestSamplingProfiler(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        profiler.sampling_summary(reset=True)
+
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_sampling_profiler_rate': 0})
+        profiler.sampling_summary(reset=True)
+
+    def test_disabled(self):
+        paddle.set_flags({'FLAGS_sampling_profiler_rate': 0})
+        x = paddle.randn([4, 4])
+        for _ in range(10):
+            paddle.matmul(x, x)
+        summary = profiler.sampling_summary()
+        self.assertEqual(_counts(summary, 'matmul'), 0)
+
+    def test_sampling(self):
+        paddle.set_flags({'FLAGS_sampling_profiler_rate': 1})
+        x = paddle.randn([4, 4])
+        for _ in range(10):
+            paddle.matmul(x, x)
+        paddle.set_flags({'FLAGS_sampling_profiler_rate': 0})
+        summary = profiler.sampling_summary()
+        self.assertGreaterEqual(_counts(summary, 'matmul'), 10)
+        self.assertIn('# TYPE paddle_op_latency_seconds histogram', summary)
+        self.assertIn('le="+Inf"', summary)
+
+        # the histograms are cleared by the reset
+        profiler.sampling_summary(reset=True)
+        self.assertEqual(_counts(profiler.sampling_summary(), 'matmul'), 0)
+
+    def test_rate(self):
+        paddle.set_flags({'FLAGS_sampling_profiler_rate': 1000000})
+        x = paddle.randn([4, 4])
+        for _ in range(10):
+            paddle.matmul(x, x)
+        self.assertEqual(_counts(profiler.sampling_summary(), 'matmul'), 0)
+
+
+if __name__ == '__main__':
+    unittest.main()
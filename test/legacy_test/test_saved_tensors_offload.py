@@ -0,0 +1,70 @@
+# Copyright (c) 2023 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestSavedTensorsOffload(unittest.TestCase):
+    def run_mlp(self, offload):
+        paddle.seed(2023)
+        linears = [paddle.nn.Linear(256, 256) for _ in range(4)]
+        x = paddle.randn([128, 256])
+        x.stop_gradient = False
+        y = x
+        for i, linear in enumerate(linears):
+            if offload and i % 2 == 0:
+                with paddle.autograd.saved_tensors_offload(min_bytes=0):
+                    y = paddle.tanh(linear(y))
+            else:
+                y = paddle.tanh(linear(y))
+        y.sum().backward()
+        return [x.grad.numpy()] + [
+            linear.weight.grad.numpy() for linear in linears
+        ]
+
+    def test_grads(self):
+        paddle.autograd.saved_tensors_offload.reset_stats()
+        expected = self.run_mlp(offload=False)
+        results = self.run_mlp(offload=True)
+        for result, grad in zip(results, expected):
+            np.testing.assert_allclose(result, grad, rtol=1e-6)
+
+        stats = paddle.autograd.saved_tensors_offload.stats()
+        self.assertGreater(stats["offloaded_tensors"], 0)
+        self.assertGreater(
+            stats["prefetched_bytes"] + stats["reloaded_on_demand_bytes"], 0
+        )
+        self.assertEqual(stats["host_bytes"], 0)
+
+    def test_min_bytes(self):
+        paddle.autograd.saved_tensors_offload.reset_stats()
+        x = paddle.randn([4, 4])
+        x.stop_gradient = False
+        with paddle.autograd.saved_tensors_offload(min_bytes=1 << 20):
+            y = paddle.tanh(x)
+        y.sum().backward()
+        stats = paddle.autograd.saved_tensors_offload.stats()
+        self.assertEqual(stats["offloaded_tensors"], 0)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -312,6 +312,65 @@ class TestSparseConv(unittest.TestCase):
             rtol=1e-5,
         )
 
+    def test_Conv3D_rulebook_cache(self):
+        paddle.seed(0)
+        shape = [1, 6, 6, 6, 4]
+        x = paddle.randn(shape)
+        sp_x = x.to_sparse_coo(4)
+        conv3d = paddle.nn.Conv3D(4, 8, 3, stride=2, data_format='NDHWC')
+        # the convs of the same geometry on sp_x reuse the rulebook of the first
+        for _ in range(2):
+            sp_conv3d = paddle.sparse.nn.Conv3D(
+                4, 8, 3, stride=2, data_format='NDHWC'
+            )
+            sp_conv3d.weight.set_value(
+                paddle.to_tensor(conv3d.weight.numpy().transpose(2, 3, 4, 1, 0))
+            )
+            sp_conv3d.bias.set_value(paddle.to_tensor(conv3d.bias.numpy()))
+            np.testing.assert_allclose(
+                conv3d(x).numpy(),
+                sp_conv3d(sp_x).to_dense().numpy(),
+                atol=1e-3,
+                rtol=1e-3,
+            )
+
+    def test_SubmConv3D_rulebook_cache(self):
+        paddle.seed(0)
+        sp_x = paddle.randn([1, 6, 6, 6, 4]).to_sparse_coo(4)
+        conv1 = paddle.sparse.nn.SubmConv3D(4, 4, 3, data_format='NDHWC')
+        conv2 = paddle.sparse.nn.SubmConv3D(4, 4, 3, data_format='NDHWC')
+        y = conv1(sp_x)
+        # conv2 reuses the rulebook of conv1 on y, which the copy of y does not
+        y_copy = paddle.sparse.sparse_coo_tensor(
+            y.indices().clone(), y.values().clone(), y.shape
+        )
+        np.testing.assert_array_equal(
+            sp_x.indices().numpy(), y.indices().numpy()
+        )
+        np.testing.assert_allclose(
+            conv2(y).values().numpy(),
+            conv2(y_copy).values().numpy(),
+            atol=1e-5,
+            rtol=1e-5,
+        )
+
+    def test_Conv3D_implicit_gemm(self):
+        if not paddle.is_compiled_with_cuda():
+            return
+        paddle.seed(0)
+        sp_x = paddle.randn([2, 6, 6, 6, 5]).to_sparse_coo(4)
+        sp_conv3d = paddle.sparse.nn.Conv3D(5, 35, 3, data_format='NDHWC')
+        out = sp_conv3d(sp_x)
+        paddle.set_flags({'FLAGS_sparse_conv_implicit_gemm': False})
+        expect = sp_conv3d(sp_x)
+        paddle.set_flags({'FLAGS_sparse_conv_implicit_gemm': True})
+        np.testing.assert_allclose(
+            out.to_dense().numpy(),
+            expect.to_dense().numpy(),
+            atol=1e-4,
+            rtol=1e-4,
+        )
+
 
 class TestStatic(unittest.TestCase):
     def test(self):
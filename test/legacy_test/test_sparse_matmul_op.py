@@ -170,5 +170,56 @@ class TestMaskedMatmul(unittest.TestCase):
         )
 
 
+class TestMatmulCPU(unittest.TestCase):
+    def setUp(self):
+        self.origin_device = paddle.get_device()
+        paddle.set_device('cpu')
+
+    def tearDown(self):
+        paddle.set_device(self.origin_device)
+
+    def power_law_mask(self, shape):
+        # the rows get fewer non-zeros the later they are, so that the rows
+        # are split unevenly across the partitions
+        rows = shape[-2]
+        density = np.minimum(1.0, 32.0 / (np.arange(rows) + 1.0))
+        density = density.reshape([rows, 1])
+        return np.random.rand(*shape) < density
+
+    def check_matmul(self, x_shape, y_shape):
+        np_x = np.random.rand(*x_shape) * self.power_law_mask(x_shape)
+        np_y = np.random.rand(*y_shape)
+        sp_x = paddle.to_tensor(np_x).to_sparse_csr()
+        out = paddle.sparse.matmul(sp_x, paddle.to_tensor(np_y))
+        np.testing.assert_allclose(
+            out.numpy(), np.matmul(np_x, np_y), rtol=1e-05
+        )
+
+    def check_masked_matmul(self, x_shape, y_shape):
+        mask_shape = x_shape[:-1] + y_shape[-1:]
+        np_mask = self.power_law_mask(mask_shape)
+        np_x = np.random.rand(*x_shape)
+        np_y = np.random.rand(*y_shape)
+        mask = paddle.to_tensor(np_mask.astype('float64')).to_sparse_csr()
+        out = paddle.sparse.masked_matmul(
+            paddle.to_tensor(np_x), paddle.to_tensor(np_y), mask
+        )
+        np.testing.assert_allclose(
+            out.to_dense().numpy(),
+            np.matmul(np_x, np_y) * np_mask,
+            rtol=1e-05,
+        )
+
+    def test_matmul(self):
+        self.check_matmul([16, 12], [12, 10])
+        self.check_matmul([4, 16, 12], [4, 12, 10])
+        self.check_matmul([1024, 256], [256, 8])
+
+    def test_masked_matmul(self):
+        self.check_masked_matmul([10, 12], [12, 6])
+        self.check_masked_matmul([4, 16, 12], [4, 12, 10])
+        self.check_masked_matmul([1024, 8], [8, 256])
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -595,6 +595,50 @@ class TestStride(unittest.TestCase):
 
         self.assertTrue(np.allclose(out_c.numpy(), np_out))
 
+    def call_strided_compute(self):
+        x_np = np.random.random(size=[4, 6, 8]).astype('float32')
+        y_np = np.random.random(size=[6, 4, 8]).astype('float32')
+        x = paddle.to_tensor(x_np)
+        y = paddle.to_tensor(y_np)
+
+        x_transposed = paddle.transpose(x, perm=[1, 0, 2])
+        x_np_transposed = x_np.transpose(1, 0, 2)
+        self.assertFalse(x_transposed.is_contiguous())
+        y_sliced = y[:, 1:3, ::2]
+        y_np_sliced = y_np[:, 1:3, ::2]
+        self.assertFalse(y_sliced.is_contiguous())
+
+        for out, np_out in [
+            (x_transposed + y, x_np_transposed + y_np),
+            (x_transposed - y, x_np_transposed - y_np),
+            (
+                x_transposed[:, :, ::2] * y_sliced[:, :1],
+                x_np_transposed[:, :, ::2] * y_np_sliced[:, :1],
+            ),
+            (y / x_transposed, y_np / x_np_transposed),
+        ]:
+            self.assertTrue(out.is_contiguous())
+            np.testing.assert_allclose(out.numpy(), np_out, rtol=1e-05)
+
+        for axis in [0, 1, 2, [0, 2], None]:
+            np_axis = tuple(axis) if isinstance(axis, list) else axis
+            for out, np_out in [
+                (
+                    paddle.sum(x_transposed, axis=axis),
+                    np.sum(x_np_transposed, axis=np_axis),
+                ),
+                (
+                    paddle.mean(y_sliced, axis=axis),
+                    np.mean(y_np_sliced, axis=np_axis),
+                ),
+                (
+                    paddle.max(x_transposed, axis=axis),
+                    np.max(x_np_transposed, axis=np_axis),
+                ),
+            ]:
+                self.assertTrue(out.is_contiguous())
+                np.testing.assert_allclose(out.numpy(), np_out, rtol=1e-05)
+
     def call_stride(self):
         self.call_transpose()
         self.call_diagonal()
@@ -620,6 +664,7 @@ class TestStride(unittest.TestCase):
         self.call_view2()
         self.call_view_as()
         self.call_unfold()
+        self.call_strided_compute()
 
 
 class TestStrideCPU(TestStride):
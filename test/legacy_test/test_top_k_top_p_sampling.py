@@ -0,0 +1,103 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+
+def get_places():
+    places = [paddle.CPUPlace()]
+    if core.is_compiled_with_cuda():
+        places.append(paddle.CUDAPlace(0))
+    return places
+
+
+class TestTopKTopPSampling(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2024)
+        self.batch_size = 4
+        self.vocab_size = 5000
+        self.logits = np.random.randn(
+            self.batch_size, self.vocab_size
+        ).astype("float32")
+
+    def sample(self, place, logits, top_p, **kwargs):
+        with paddle.base.dygraph.guard(place):
+            x = paddle.to_tensor(logits)
+            ps = paddle.full([logits.shape[0], 1], top_p, "float32")
+            if kwargs.get("pre_ids") is not None:
+                kwargs["pre_ids"] = paddle.to_tensor(kwargs["pre_ids"])
+            prob, ids = paddle.tensor.top_k_top_p_sampling(x, ps, **kwargs)
+            return prob.numpy(), ids.numpy()
+
+    def test_greedy(self):
+        expected = np.argmax(self.logits, axis=-1).reshape([-1, 1])
+        for place in get_places():
+            prob, ids = self.sample(place, self.logits, 1.0, top_k=1)
+            np.testing.assert_array_equal(ids, expected)
+            np.testing.assert_allclose(prob, np.ones_like(prob), rtol=1e-5)
+            _, ids = self.sample(place, self.logits, 0.0)
+            np.testing.assert_array_equal(ids, expected)
+
+    def test_repetition_penalty(self):
+        order = np.argsort(-self.logits, axis=-1)
+        logits = self.logits - self.logits.min() + 1.0
+        pre_ids = np.stack([order[:, 0], -np.ones_like(order[:, 0])], axis=1)
+        for place in get_places():
+            _, ids = self.sample(
+                place,
+                logits,
+                1.0,
+                top_k=1,
+                pre_ids=pre_ids,
+                repetition_penalty=100.0,
+            )
+            np.testing.assert_array_equal(ids.flatten(), order[:, 1])
+
+    def test_top_k(self):
+        top_k = np.argsort(-self.logits, axis=-1)[:, :3]
+        for place in get_places():
+            for seed in range(5):
+                _, ids = self.sample(
+                    place, self.logits, 1.0, top_k=3, seed=seed
+                )
+                for row in range(self.batch_size):
+                    self.assertIn(ids[row, 0], top_k[row])
+
+    def test_top_p_and_min_p(self):
+        probs = np.array([0.45, 0.3, 0.15, 0.1], "float32")
+        logits = np.tile(np.log(probs), [2000, 1])
+        for place in get_places():
+            prob, ids = self.sample(place, logits, 0.7, seed=1)
+            self.assertTrue(np.all(ids < 2))
+            # the kept probabilities are renormalized
+            np.testing.assert_allclose(
+                prob[ids == 0], np.full([np.sum(ids == 0)], 0.6), rtol=1e-4
+            )
+            self.assertAlmostEqual(np.mean(ids == 0), 0.6, delta=0.05)
+
+            _, ids = self.sample(place, logits, 1.0, min_p=0.5, seed=2)
+            self.assertTrue(np.all(ids < 2))
+
+            # the temperature flattens the distribution
+            _, ids = self.sample(place, logits, 1.0, temperature=100.0, seed=3)
+            self.assertAlmostEqual(np.mean(ids == 3), 0.25, delta=0.05)
+
+
+if __name__ == "__main__":
+    unittest.main()
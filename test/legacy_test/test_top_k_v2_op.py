@@ -489,6 +489,48 @@ class TestTopKAPI(unittest.TestCase):
                 paddle.topk(x, k=0)
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestTopkRadixSelect(unittest.TestCase):
+    # the batched rows and the long rows split into segments
+    def setUp(self):
+        self.shapes = [
+            ([4096, 2048], 64),
+            ([2, 1 << 20], 1000),
+            ([3, 5000], 20),
+        ]
+
+    def check_topk(self, x, k, largest, sorted):
+        values, indices = paddle.topk(
+            paddle.to_tensor(x), k=k, largest=largest, sorted=sorted
+        )
+        values = values.numpy()
+        indices = indices.numpy()
+        expect_values, expect_indices = numpy_topk(x, k=k, largest=largest)
+        np.testing.assert_array_equal(
+            np.take_along_axis(x, indices, axis=-1), values
+        )
+        if not sorted:
+            order = np.argsort(-values if largest else values, axis=-1)
+            values = np.take_along_axis(values, order, axis=-1)
+            indices = np.take_along_axis(indices, order, axis=-1)
+        np.testing.assert_array_equal(values, expect_values)
+        np.testing.assert_array_equal(indices, expect_indices)
+
+    def test_radix_select(self):
+        paddle.disable_static()
+        for shape, k in self.shapes:
+            # the values are distinct so that the indices are unique
+            x = np.stack(
+                [np.random.permutation(shape[-1]) for _ in range(shape[0])]
+            ).astype("float32")
+            for largest in [True, False]:
+                for sorted in [True, False]:
+                    self.check_topk(x, k, largest, sorted)
+        paddle.enable_static()
+
+
 if __name__ == "__main__":
     paddle.enable_static()
     unittest.main()
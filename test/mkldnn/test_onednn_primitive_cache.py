@@ -0,0 +1,101 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle import base
+from paddle.base import core
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_mkldnn(), "core is not compiled with oneDNN"
+)
+class TestOneDNNPrimitiveCache(unittest.TestCase):
+    def setUp(self):
+        paddle.enable_static()
+        np.random.seed(2024)
+        self.k = 64
+        self.n = 32
+        self.y_np = np.random.random([self.k, self.n]).astype('float32')
+
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_onednn_matmul_runtime_m': False})
+        core.clear_onednn_primitive_cache()
+        paddle.disable_static()
+
+    def build_program(self):
+        program = base.Program()
+        with base.program_guard(program):
+            block = program.global_block()
+            x = block.create_var(name='x', dtype='float32', shape=[-1, self.k])
+            y = block.create_var(
+                name='y', dtype='float32', shape=[self.k, self.n]
+            )
+            out = block.create_var(name='out', dtype='float32')
+            block.append_op(
+                type='matmul_v2',
+                inputs={'X': x, 'Y': y},
+                outputs={'Out': out},
+                attrs={'trans_x': False, 'trans_y': False, 'use_mkldnn': True},
+            )
+        return program
+
+    def run_batches(self, batches):
+        program = self.build_program()
+        exe = base.Executor(core.CPUPlace())
+        for batch in batches:
+            x_np = np.random.random([batch, self.k]).astype('float32')
+            (out,) = exe.run(
+                program,
+                feed={'x': x_np, 'y': self.y_np},
+                fetch_list=['out'],
+            )
+            np.testing.assert_allclose(
+                out, np.matmul(x_np, self.y_np), rtol=1e-5, atol=1e-5
+            )
+
+    def test_reuse_across_steps(self):
+        core.clear_onednn_primitive_cache()
+        self.run_batches([4, 4, 4])
+        stats = core.get_onednn_primitive_cache_stats()
+        self.assertEqual(stats['misses'], 1)
+        self.assertEqual(stats['hits'], 2)
+        self.assertEqual(stats['size'], 1)
+
+    def test_runtime_m_bucket(self):
+        paddle.set_flags({'FLAGS_onednn_matmul_runtime_m': True})
+        core.clear_onednn_primitive_cache()
+        self.run_batches([1, 3, 8, 17])
+        stats = core.get_onednn_primitive_cache_stats()
+        self.assertEqual(stats['misses'], 1)
+        self.assertEqual(stats['hits'], 3)
+
+    def test_capacity(self):
+        paddle.set_flags({'FLAGS_onednn_primitive_cache_capacity': 2})
+        try:
+            core.clear_onednn_primitive_cache()
+            self.run_batches([1, 2, 3, 1])
+            stats = core.get_onednn_primitive_cache_stats()
+            self.assertEqual(stats['size'], 2)
+            self.assertEqual(stats['misses'], 4)
+            self.assertEqual(stats['evictions'], 2)
+        finally:
+            paddle.set_flags({'FLAGS_onednn_primitive_cache_capacity': 1024})
+
+
+if __name__ == "__main__":
+    unittest.main()
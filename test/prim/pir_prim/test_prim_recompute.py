@@ -0,0 +1,56 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.framework import core
+
+
+def func(x):
+    x1 = paddle.nn.functional.gelu(x, False)
+    out = paddle.nn.functional.softmax(x1 * 2)
+    return out
+
+
+class TestPrimRecomputeIntermediates(unittest.TestCase):
+    def run_static(self, recompute):
+        paddle.set_flags({'FLAGS_prim_recompute_intermediates': recompute})
+        core._set_prim_all_enabled(True)
+        static_func = paddle.jit.to_static(func, full_graph=True)
+        paddle.seed(2024)
+        x = paddle.randn((8, 16, 64))
+        x.stop_gradient = False
+        out = static_func(x)
+        out.backward()
+        core._set_prim_all_enabled(False)
+        paddle.set_flags({'FLAGS_prim_recompute_intermediates': False})
+
+        train_program = static_func.program_cache.last()[-1][-1].train_program
+        saved_values = train_program.program_name_attr['fm']
+        return out.numpy(), x.grad.numpy(), len(saved_values)
+
+    def test_recompute(self):
+        ref_out, ref_grad, ref_saved = self.run_static(False)
+        out, grad, saved = self.run_static(True)
+
+        self.assertLess(saved, ref_saved)
+        np.testing.assert_allclose(ref_out, out, atol=1e-6, rtol=1e-6)
+        np.testing.assert_allclose(ref_grad, grad, atol=1e-6, rtol=1e-6)
+
+
+if __name__ == "__main__":
+    unittest.main()
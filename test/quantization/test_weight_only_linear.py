@@ -399,5 +399,107 @@ class WeightOnlyLinearBackwardAndWeightDequantizeTestCase(unittest.TestCase):
         np.testing.assert_allclose(quant_x.grad, x.grad, rtol=1e-3, atol=1e-3)
 
 
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda() or get_cuda_version() < 11020,
+    "quantized_matmul requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class WeightOnlyLinearGroupwiseTestCase(unittest.TestCase):
+    def config(self):
+        self.weight_dtype = "int8"
+        self.group_size = 64
+        self.activation = "none"
+        self.token = 32
+        self.in_features = 256
+        self.out_features = 128
+
+    def setUp(self):
+        self.config()
+        self.algo = "weight_only_" + self.weight_dtype
+        self.x = paddle.rand(
+            [2, self.token, self.in_features], dtype='float16'
+        ) / math.sqrt(self.in_features)
+        self.weight = paddle.randn(
+            [self.in_features, self.out_features], dtype='float16'
+        ) / math.sqrt(self.in_features)
+        self.bias = paddle.randn([self.out_features], dtype='float16')
+
+    def test_weight_quantize(self):
+        weight_gpu, scale_gpu = Q.weight_quantize(
+            self.weight.cuda(), algo=self.algo, group_size=self.group_size
+        )
+        weight_cpu, scale_cpu = Q.weight_quantize(
+            self.weight.cpu(), algo=self.algo, group_size=self.group_size
+        )
+        self.assertEqual(
+            scale_gpu.shape,
+            [self.in_features // self.group_size, self.out_features],
+        )
+        np.testing.assert_allclose(
+            weight_gpu.numpy(), weight_cpu.numpy(), atol=1.5
+        )
+        np.testing.assert_allclose(
+            scale_gpu.numpy(), scale_cpu.numpy(), atol=1e-5, rtol=1e-3
+        )
+        dequant_weight = Q.weight_dequantize(
+            weight_gpu, scale_gpu, algo=self.algo, group_size=self.group_size
+        )
+        atol = 1e-2 if self.weight_dtype == "int8" else 1e-1
+        np.testing.assert_allclose(
+            dequant_weight.numpy(), self.weight.numpy(), atol=atol
+        )
+
+    def test_weight_only_linear(self):
+        weight, scale = Q.weight_quantize(
+            self.weight.cuda(), algo=self.algo, group_size=self.group_size
+        )
+        out = Q.weight_only_linear(
+            self.x,
+            weight,
+            bias=self.bias,
+            weight_scale=scale,
+            weight_dtype=self.weight_dtype,
+            group_size=self.group_size,
+            activation=self.activation,
+        )
+        dequant_weight = Q.weight_dequantize(
+            weight, scale, algo=self.algo, group_size=self.group_size
+        )
+        out_expect = paddle.matmul(self.x, dequant_weight) + self.bias
+        if self.activation == "gelu":
+            out_expect = paddle.nn.functional.gelu(out_expect)
+        elif self.activation == "relu":
+            out_expect = paddle.nn.functional.relu(out_expect)
+        elif self.activation == "silu":
+            out_expect = paddle.nn.functional.silu(out_expect)
+        np.testing.assert_allclose(
+            out.numpy(), out_expect.numpy(), rtol=1e-2, atol=1e-2
+        )
+
+
+class WeightOnlyLinearGroupwiseTestCase1(WeightOnlyLinearGroupwiseTestCase):
+    def config(self):
+        super().config()
+        self.weight_dtype = "int4"
+        self.group_size = 128
+        self.activation = "gelu"
+
+
+class WeightOnlyLinearGroupwiseTestCase2(WeightOnlyLinearGroupwiseTestCase):
+    def config(self):
+        super().config()
+        self.weight_dtype = "int4"
+        self.activation = "silu"
+        self.token = 1
+
+
+class WeightOnlyLinearGroupwiseTestCase3(WeightOnlyLinearGroupwiseTestCase):
+    def config(self):
+        super().config()
+        self.group_size = 128
+        self.activation = "relu"
+        self.token = 3
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -121,6 +121,50 @@ class TestSingleProcessRpc(RpcTestBase):
         self.assertEqual(info.rank, 0)
 
 
+class TestSingleProcessBatchRpc(RpcTestBase):
+    def setUp(self):
+        self._port_set = set()
+        paddle.set_flags(
+            {
+                'FLAGS_rpc_batch_max_size': 4,
+                'FLAGS_rpc_server_thread_num': 2,
+            }
+        )
+        master_endpoint = f"127.0.0.1:{self._find_free_port()}"
+        dist.rpc.init_rpc(worker_name(0), 0, 1, master_endpoint)
+
+    def tearDown(self):
+        dist.rpc.shutdown()
+        paddle.set_flags(
+            {
+                'FLAGS_rpc_batch_max_size': 1,
+                'FLAGS_rpc_server_thread_num': 1,
+            }
+        )
+
+    def test_async_rpc_batch_paddle_add(self):
+        # 10 requests are sent in 2 full batches and 1 flushed batch.
+        args = [
+            (np.random.random((10, 100)), np.random.random((10, 100)))
+            for _ in range(10)
+        ]
+        futs = [
+            dist.rpc.rpc_async(worker_name(0), paddle_add, args=arg)
+            for arg in args
+        ]
+        for (a, b), fut in zip(args, futs):
+            np.testing.assert_allclose(fut.wait(), np.add(a, b), rtol=1e-05)
+
+    def test_sync_rpc_tensor(self):
+        a = paddle.rand([10, 100])
+        b = paddle.rand([10, 100])
+        out = dist.rpc.rpc_sync(worker_name(0), paddle.add, args=(a, b))
+        self.assertIsInstance(out, paddle.Tensor)
+        np.testing.assert_allclose(
+            out.numpy(), np.add(a.numpy(), b.numpy()), rtol=1e-05
+        )
+
+
 class RpcLaunchTest(RpcLaunchTestBase):
     def test_sync_rpc_paddle_add1(self):
         nnodes = 2